@@ -241,6 +241,11 @@ void IRAM_ATTR uart_isr(smg_uart_instance_t* inst)
 				uart_ll_write_txfifo(dev, buf, count);
 			}
 
+			if(uart->tx_threshold != 0 && uart->tx_buffer != nullptr &&
+			   uart->tx_buffer->getFreeSpace() >= uart->tx_threshold) {
+				status |= UART_STATUS_TX_THRESHOLD;
+			}
+
 			// If TX FIFO remains empty then we must disable TX FIFO EMPTY interrupt to stop it recurring.
 			if(uart_txfifo_count(dev) == 0) {
 				// The interrupt gets re-enabled by uart_write()
@@ -335,6 +340,37 @@ size_t smg_uart_read(smg_uart_t* uart, void* buffer, size_t size)
 	return read;
 }
 
+size_t smg_uart_rx_peek_region(smg_uart_t* uart, const void*& data)
+{
+	data = nullptr;
+	if(!smg_uart_rx_enabled(uart) || uart->rx_buffer == nullptr) {
+		return 0;
+	}
+
+	notify(uart, UART_NOTIFY_BEFORE_READ);
+
+	void* buf;
+	auto len = uart->rx_buffer->getReadData(buf);
+	data = buf;
+	return len;
+}
+
+void smg_uart_rx_consume(smg_uart_t* uart, size_t length)
+{
+	if(!smg_uart_rx_enabled(uart) || uart->rx_buffer == nullptr || length == 0) {
+		return;
+	}
+
+	uart->rx_buffer->skipRead(length);
+
+	if(is_physical(uart)) {
+		// FIFO full may have been disabled if buffer overflowed, re-enabled it now
+		auto dev = getDevice(uart->uart_nr);
+		uart_ll_clr_intsts_mask(dev, UART_INTR_RXFIFO_FULL | UART_INTR_RXFIFO_TOUT | UART_INTR_RXFIFO_OVF);
+		uart_ll_ena_intr_mask(dev, UART_INTR_RXFIFO_FULL | UART_INTR_RXFIFO_TOUT | UART_INTR_RXFIFO_OVF);
+	}
+}
+
 size_t smg_uart_rx_available(smg_uart_t* uart)
 {
 	if(!smg_uart_rx_enabled(uart)) {
@@ -430,9 +466,7 @@ size_t smg_uart_write(smg_uart_t* uart, const void* buffer, size_t size)
 
 		// Write any remaining data into transmit buffer
 		if(uart->tx_buffer != nullptr) {
-			while(written < size && uart->tx_buffer->writeChar(buf[written])) {
-				++written;
-			}
+			written += uart->tx_buffer->write(&buf[written], size - written);
 		}
 
 		notify(uart, UART_NOTIFY_AFTER_WRITE);
@@ -8,6 +8,18 @@ COMPONENT_INCDIRS := src/include include
 # Applications can provide file with custom SDK configuration settings
 CACHE_VARS += SDK_CUSTOM_CONFIG
 
+# Ethernet MAC DMA buffers, blank to use SDK defaults
+CONFIG_VARS += ETH_DMA_RX_BUFFER_NUM ETH_DMA_TX_BUFFER_NUM ETH_DMA_BUFFER_SIZE
+
+# FreeRTOS task placement, blank to use defaults
+CONFIG_VARS += SMING_TASK_CORE SMING_TASK_PRIORITY WORKER_TASK_CORE WORKER_TASK_PRIORITY LWIP_TCPIP_TASK_CORE
+GLOBAL_CFLAGS += $(foreach v,SMING_TASK_CORE SMING_TASK_PRIORITY WORKER_TASK_CORE WORKER_TASK_PRIORITY,$(if $($v),-D$v=$($v)))
+
+COMPONENT_VARS += LWIP_TCPIP_TASK_PRIORITY
+ifneq (,$(LWIP_TCPIP_TASK_PRIORITY))
+COMPONENT_CPPFLAGS += -DLWIP_TCPIP_TASK_PRIORITY=$(LWIP_TCPIP_TASK_PRIORITY)
+endif
+
 COMPONENT_RELINK_VARS += DISABLE_NETWORK DISABLE_WIFI CREATE_EVENT_TASK
 
 ifeq ($(CREATE_EVENT_TASK),1)
@@ -156,6 +168,7 @@ FREERTOS_PORTABLE := freertos/FreeRTOS-Kernel/portable
 ifeq (v5.2,$(IDF_VERSION))
 SDK_INCDIRS += \
 	driver/gpio/include \
+	driver/i2c/include \
 	driver/ledc/include \
 	driver/spi/include \
 	lwip/port/include \
@@ -489,6 +502,12 @@ $(SDK_CONFIG_DEFAULTS): $(SDK_CUSTOM_CONFIG_PATH)
 ifeq ($(ENABLE_GDB), 1)
 	$(Q) echo "CONFIG_ESP_SYSTEM_PANIC_GDBSTUB=$(if $(ENABLE_GDB),y,n)" >> $@
 endif
+	$(Q) $(foreach v,ETH_DMA_RX_BUFFER_NUM ETH_DMA_TX_BUFFER_NUM ETH_DMA_BUFFER_SIZE,\
+		$(if $($v),echo "CONFIG_$v=$($v)" >> $@;) \
+	)
+ifneq (,$(LWIP_TCPIP_TASK_CORE))
+	$(Q) echo "CONFIG_LWIP_TCPIP_TASK_AFFINITY_$(if $(filter -1,$(LWIP_TCPIP_TASK_CORE)),NO_AFFINITY,CPU$(LWIP_TCPIP_TASK_CORE))=y" >> $@
+endif
 
 ##@Configuration
 
@@ -1,5 +1,47 @@
 #pragma once
 #include <c_types.h>
+#include <sdkconfig.h>
+#include <esp_task.h>
+
+/*
+ * FreeRTOS task placement, see README for the build variables which set these.
+ * Applications can use these when creating their own tasks.
+ */
+
+/**
+ * @brief Core running the Sming event loop
+ */
+#ifndef SMING_TASK_CORE
+#if defined(SOC_ESP32) && !CONFIG_FREERTOS_UNICORE
+#define SMING_TASK_CORE 1
+#else
+#define SMING_TASK_CORE 0
+#endif
+#endif
+
+/**
+ * @brief Priority of Sming event loop task
+ */
+#ifndef SMING_TASK_PRIORITY
+#define SMING_TASK_PRIORITY ESP_TASKD_EVENT_PRIO
+#endif
+
+/**
+ * @brief Core running the Worker task
+ * @note Ignored with CONFIG_FREERTOS_UNICORE
+ */
+#ifndef WORKER_TASK_CORE
+#define WORKER_TASK_CORE (SMING_TASK_CORE ^ 1)
+#endif
+
+/**
+ * @brief Priority of Worker task
+ *
+ * Lowest priority above idle so network and system tasks are not delayed
+ */
+#ifndef WORKER_TASK_PRIORITY
+#define WORKER_TASK_PRIORITY (tskIDLE_PRIORITY + 1)
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -14,12 +56,20 @@ typedef struct {
 } os_event_t;
 
 enum {
+	USER_TASK_PRIO_0,
 	USER_TASK_PRIO_1,
+	USER_TASK_PRIO_2,
+	USER_TASK_PRIO_MAX,
 };
 
 typedef void (*os_task_t)(os_event_t* e);
 
 bool system_os_task(os_task_t task, uint8_t prio, os_event_t* queue, uint8_t qlen);
+/**
+ * @brief Post an event to a task queue
+ * @note May be called from interrupt context or from any FreeRTOS task, on either core.
+ * Events are always serviced by the Sming task.
+ */
 bool system_os_post(uint8_t prio, os_signal_t sig, os_param_t par);
 
 #ifdef __cplusplus
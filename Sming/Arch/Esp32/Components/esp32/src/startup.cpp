@@ -18,6 +18,7 @@
 #include <driver/hw_timer.h>
 #include <driver/uart.h>
 #include <Storage.h>
+#include <esp_tasks.h>
 
 extern void init();
 extern esp_event_loop_handle_t sming_create_event_loop();
@@ -54,6 +55,14 @@ void main(void*)
 	esp_network_initialise();
 #endif
 
+#ifdef LWIP_TCPIP_TASK_PRIORITY
+	// Created by network initialisation, IDF doesn't provide a setting for this
+	auto tcpipTask = xTaskGetHandle("tiT");
+	if(tcpipTask != nullptr) {
+		vTaskPrioritySet(tcpipTask, LWIP_TCPIP_TASK_PRIORITY);
+	}
+#endif
+
 	System.initialize();
 	Storage::initialize();
 	init();
@@ -75,14 +84,11 @@ extern void sming_create_task(TaskFunction_t);
 
 extern "C" void app_main(void)
 {
-#if defined(SOC_ESP32) && !CONFIG_FREERTOS_UNICORE
-	constexpr unsigned core_id{1};
-#else
-	constexpr unsigned core_id{0};
-#endif
+	constexpr unsigned core_id{SMING_TASK_CORE};
+	static_assert(core_id < portNUM_PROCESSORS, "SMING_TASK_CORE invalid");
 
 #if ESP_IDF_VERSION_MAJOR < 5
 	esp_task_wdt_delete(xTaskGetIdleTaskHandleForCPU(core_id));
 #endif
-	xTaskCreatePinnedToCore(main, "Sming", ESP_TASKD_EVENT_STACK, nullptr, ESP_TASKD_EVENT_PRIO, nullptr, core_id);
+	xTaskCreatePinnedToCore(main, "Sming", ESP_TASKD_EVENT_STACK, nullptr, SMING_TASK_PRIORITY, nullptr, core_id);
 }
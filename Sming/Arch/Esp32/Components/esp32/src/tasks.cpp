@@ -1,66 +1,136 @@
 #include "include/esp_tasks.h"
 #include <esp_event.h>
+#include <freertos/queue.h>
 #include <debug_progmem.h>
 
 namespace
 {
 ESP_EVENT_DEFINE_BASE(TaskEvt);
 
-os_task_t taskCallback;
+/*
+ * Events are held in a separate queue for each priority.
+ * Posting also sends an event to the default event loop, whose handler invokes
+ * queued events in priority order.
+ */
+struct TaskQueue {
+	os_task_t callback;
+	QueueHandle_t handle;
+};
 
-} // namespace
+TaskQueue task_queues[USER_TASK_PRIO_MAX];
+bool handlerRegistered;
 
-bool system_os_task(os_task_t callback, uint8_t prio, os_event_t* events, uint8_t qlen)
+// Invoke highest priority event
+bool serviceNext()
 {
-	auto handler = [](void* arg, esp_event_base_t event_base, int32_t event_id, void* event_data) {
-		assert(taskCallback != nullptr);
+	for(int prio = USER_TASK_PRIO_MAX - 1; prio >= 0; --prio) {
+		auto& queue = task_queues[prio];
+		os_event_t ev;
+		if(queue.handle != nullptr && xQueueReceive(queue.handle, &ev, 0) == pdTRUE) {
+			queue.callback(&ev);
+			return true;
+		}
+	}
+	return false;
+}
 
-		os_event_t ev{os_signal_t(event_id), 0};
-		if(event_data != nullptr) {
-			ev.par = *static_cast<os_param_t*>(event_data);
+bool registerHandler()
+{
+	if(handlerRegistered) {
+		return true;
+	}
+
+	auto handler = [](void* arg, esp_event_base_t event_base, int32_t event_id, void* event_data) {
+		// Don't service any newly queued events
+		unsigned count{0};
+		for(auto& queue : task_queues) {
+			if(queue.handle != nullptr) {
+				count += uxQueueMessagesWaiting(queue.handle);
+			}
 		}
 
-		taskCallback(&ev);
+		while(count-- != 0 && serviceNext()) {
+		}
 	};
 
+	auto err = esp_event_handler_instance_register(TaskEvt, ESP_EVENT_ANY_ID, handler, nullptr, nullptr);
+	if(err != ESP_OK) {
+		debug_e("TQ: Failed to register handler");
+		return false;
+	}
+
+	handlerRegistered = true;
+	debug_i("TQ: Registered %s", TaskEvt);
+	return true;
+}
+
+} // namespace
+
+bool system_os_task(os_task_t callback, uint8_t prio, os_event_t* events, uint8_t qlen)
+{
 	if(callback == nullptr) {
 		debug_e("TQ: Callback missing");
 		return false;
 	}
 
-	if(prio != USER_TASK_PRIO_1) {
+	if(qlen == 0) {
+		debug_e("TQ: Invalid queue length");
+		return false;
+	}
+
+	if(prio >= USER_TASK_PRIO_MAX) {
 		debug_e("TQ: Invalid priority %u", prio);
 		return false;
 	}
 
-	if(taskCallback != nullptr) {
+	auto& queue = task_queues[prio];
+	if(queue.handle != nullptr) {
 		debug_w("TQ: Queue %u already initialised", prio);
 		return false;
 	}
 
-	auto err = esp_event_handler_instance_register(TaskEvt, ESP_EVENT_ANY_ID, handler, nullptr, nullptr);
-	if(err != ESP_OK) {
-		debug_e("TQ: Failed to register handler");
+	if(!registerHandler()) {
 		return false;
 	}
 
-	taskCallback = callback;
-
-	debug_i("TQ: Registered %s", TaskEvt);
+	// Event storage is allocated by FreeRTOS
+	(void)events;
+	queue.handle = xQueueCreate(qlen, sizeof(os_event_t));
+	if(queue.handle == nullptr) {
+		debug_e("TQ: Failed to create queue %u", prio);
+		return false;
+	}
+	queue.callback = callback;
 
 	return true;
 }
 
 bool IRAM_ATTR system_os_post(uint8_t prio, os_signal_t sig, os_param_t par)
 {
-	if(prio != USER_TASK_PRIO_1) {
+	if(prio >= USER_TASK_PRIO_MAX) {
+		return false;
+	}
+	auto& queue = task_queues[prio];
+	if(queue.handle == nullptr) {
 		return false;
 	}
-	esp_err_t err;
-	if(par == 0) {
-		err = esp_event_isr_post(TaskEvt, sig, nullptr, 0, nullptr);
-	} else {
-		err = esp_event_isr_post(TaskEvt, sig, &par, sizeof(par), nullptr);
+
+	os_event_t ev{sig, par};
+	if(xPortInIsrContext()) {
+		if(xQueueSendToBackFromISR(queue.handle, &ev, nullptr) != pdTRUE) {
+			return false;
+		}
+
+		// If the event loop is full, this event gets serviced following a subsequent post
+		esp_event_isr_post(TaskEvt, 0, nullptr, 0, nullptr);
+		return true;
 	}
-	return (err == ESP_OK);
+
+	// Posted from a task, possibly on the other core, so Sming task gets scheduled immediately if waiting
+	if(xQueueSendToBack(queue.handle, &ev, 0) != pdTRUE) {
+		return false;
+	}
+
+	esp_event_post(TaskEvt, 0, nullptr, 0, 0);
+	return true;
 }
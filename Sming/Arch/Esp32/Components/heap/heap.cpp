@@ -1,8 +1,55 @@
 
 #include "include/heap.h"
 #include "esp_system.h"
+#include <esp_heap_caps.h>
+#include <heap_info.h>
+#include <heap_region.h>
 
 uint32_t system_get_free_heap_size(void)
 {
 	return esp_get_free_heap_size();
 }
+
+bool system_get_heap_info(heap_info_t* info)
+{
+	multi_heap_info_t heapInfo;
+	heap_caps_get_info(&heapInfo, MALLOC_CAP_8BIT);
+	info->free_size = heapInfo.total_free_bytes;
+	info->largest_free_block = heapInfo.largest_free_block;
+	info->free_blocks = heapInfo.free_blocks;
+	info->fragmentation = system_calc_heap_fragmentation(info->free_size, info->largest_free_block);
+	return true;
+}
+
+namespace
+{
+uint32_t getRegionCaps(heap_region_t region)
+{
+	switch(region) {
+	case HEAP_REGION_SECONDARY:
+		return MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT;
+	case HEAP_REGION_IRAM:
+		return MALLOC_CAP_EXEC | MALLOC_CAP_32BIT;
+	case HEAP_REGION_DEFAULT:
+	default:
+		return MALLOC_CAP_DEFAULT;
+	}
+}
+
+} // namespace
+
+void* heap_region_malloc(heap_region_t region, size_t size)
+{
+	if(region != HEAP_REGION_DEFAULT) {
+		auto ptr = heap_caps_malloc(size, getRegionCaps(region));
+		if(ptr != nullptr) {
+			return ptr;
+		}
+	}
+	return malloc(size);
+}
+
+bool heap_region_available(heap_region_t region)
+{
+	return region == HEAP_REGION_DEFAULT || heap_caps_get_total_size(getRegionCaps(region)) != 0;
+}
@@ -16,6 +16,66 @@
 #include <rom/cache.h>
 #include <esp_systemapi.h>
 
+/**
+ * @brief Maximum number of regions which may be mapped using `flashmem_map()` at any one time
+ */
+#ifndef FLASHMEM_MAX_MAPPINGS
+#define FLASHMEM_MAX_MAPPINGS 4
+#endif
+
+namespace
+{
+struct Mapping {
+	const void* ptr;
+	spi_flash_mmap_handle_t handle;
+};
+
+Mapping mappings[FLASHMEM_MAX_MAPPINGS];
+
+} // namespace
+
+const void* flashmem_map(uint32_t addr, uint32_t size)
+{
+	if(size == 0 || addr + size > flashmem_get_size_bytes()) {
+		return nullptr;
+	}
+
+	// Region may already be mapped, e.g. as part of application image
+	auto ptr = static_cast<const uint8_t*>(spi_flash_phys2cache(addr, SPI_FLASH_MMAP_DATA));
+	if(ptr != nullptr && spi_flash_phys2cache(addr + size - 1, SPI_FLASH_MMAP_DATA) == ptr + size - 1) {
+		return ptr;
+	}
+
+	for(auto& m : mappings) {
+		if(m.ptr != nullptr) {
+			continue;
+		}
+		auto offset = addr % SPI_FLASH_MMU_PAGE_SIZE;
+		const void* base;
+		esp_err_t r = spi_flash_mmap(addr - offset, size + offset, SPI_FLASH_MMAP_DATA, &base, &m.handle);
+		if(r != ESP_OK) {
+			debug_e("[FLASH] mmap(0x%08x, 0x%08x) failed: %d", addr, size, r);
+			return nullptr;
+		}
+		m.ptr = static_cast<const uint8_t*>(base) + offset;
+		return m.ptr;
+	}
+
+	debug_e("[FLASH] No free mappings");
+	return nullptr;
+}
+
+void flashmem_unmap(const void* ptr)
+{
+	for(auto& m : mappings) {
+		if(ptr != nullptr && m.ptr == ptr) {
+			spi_flash_munmap(m.handle);
+			m.ptr = nullptr;
+			return;
+		}
+	}
+}
+
 uint32_t flashmem_write(const void* from, uint32_t toaddr, uint32_t size)
 {
 	esp_err_t r = esp_flash_write(esp_flash_default_chip, from, toaddr, size);
@@ -93,6 +93,19 @@ static inline uint32_t flashmem_get_address(const void* memptr)
 	return (phys == SPI_FLASH_CACHE2PHYS_FAIL) ? 0 : phys;
 }
 
+/** @brief Obtain a pointer for reading flash memory directly via the cache
+ *  @param addr Flash location
+ *  @param size Number of bytes to be accessed
+ *  @retval const void* nullptr if the region cannot be mapped
+ *  @note Release the mapping using `flashmem_unmap()` when finished.
+ */
+const void* flashmem_map(uint32_t addr, uint32_t size);
+
+/** @brief Release a mapping obtained via `flashmem_map()`
+ *  @param ptr
+ */
+void flashmem_unmap(const void* ptr);
+
 /** @brief Write a block of data to flash
  *  @param from Buffer to obtain data from
  *  @param toaddr Flash location to start writing
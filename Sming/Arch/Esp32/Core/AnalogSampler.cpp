@@ -0,0 +1,133 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * AnalogSampler.cpp - Continuous sampling using the IDF ADC DMA (continuous mode) driver
+ *
+ * Conversion frames are processed directly from the driver's conversion-done interrupt callback,
+ * so the driver's own frame pool is only used as the DMA target and `adc_continuous_read()` is not needed.
+ *
+ ****/
+
+#include <AnalogSampler.h>
+#include <driver/adc.h>
+#include <soc/adc_periph.h>
+#include <debug_progmem.h>
+#include <Digital.h>
+
+#if ESP_IDF_VERSION_MAJOR < 5
+
+bool AnalogSampler::startSampling()
+{
+	debug_e("[ADC] Continuous sampling requires IDF 5 or later");
+	return false;
+}
+
+void AnalogSampler::stopSampling()
+{
+}
+
+#else
+
+namespace
+{
+constexpr size_t frameSize{ADC_SAMPLER_DMA_BLOCK_SIZE * SOC_ADC_DIGI_RESULT_BYTES};
+
+#if CONFIG_IDF_TARGET_ESP32 || CONFIG_IDF_TARGET_ESP32S2
+constexpr adc_digi_output_format_t outputFormat{ADC_DIGI_OUTPUT_FORMAT_TYPE1};
+#define ADC_SAMPLE_DATA(p) (p)->type1.data
+#else
+constexpr adc_digi_output_format_t outputFormat{ADC_DIGI_OUTPUT_FORMAT_TYPE2};
+#define ADC_SAMPLE_DATA(p) (p)->type2.data
+#endif
+
+// Continuous mode is only supported on ADC1 for all variants
+bool lookupChannel(uint16_t pin, adc_channel_t& channel)
+{
+	for(unsigned ch = 0; ch < SOC_ADC_MAX_CHANNEL_NUM; ++ch) {
+		if(adc_channel_io_map[0][ch] == pin) {
+			channel = adc_channel_t(ch);
+			return true;
+		}
+	}
+	return false;
+}
+
+} // namespace
+
+bool AnalogSampler::startSampling()
+{
+	adc_channel_t channel;
+	if(!lookupChannel(config.pin, channel)) {
+		debug_e("[ADC] Pin %u not supported", config.pin);
+		return false;
+	}
+	if(config.sampleRate < SOC_ADC_SAMPLE_FREQ_THRES_LOW || config.sampleRate > SOC_ADC_SAMPLE_FREQ_THRES_HIGH) {
+		debug_e("[ADC] Sample rate %u out of range", config.sampleRate);
+		return false;
+	}
+
+	pinMode(config.pin, ANALOG);
+
+	adc_continuous_handle_cfg_t handleConfig{
+		.max_store_buf_size = 2 * frameSize,
+		.conv_frame_size = frameSize,
+	};
+	adc_continuous_handle_t adcHandle;
+	auto err = adc_continuous_new_handle(&handleConfig, &adcHandle);
+	if(err != ESP_OK) {
+		debug_e("[ADC] Driver init failed: %s", esp_err_to_name(err));
+		return false;
+	}
+
+	adc_digi_pattern_config_t pattern{
+		.atten = ADC_ATTEN_DB_0,
+		.channel = uint8_t(channel),
+		.unit = ADC_UNIT_1,
+		.bit_width = SOC_ADC_DIGI_MAX_BITWIDTH,
+	};
+	adc_continuous_config_t adcConfig{
+		.pattern_num = 1,
+		.adc_pattern = &pattern,
+		.sample_freq_hz = config.sampleRate,
+		.conv_mode = ADC_CONV_SINGLE_UNIT_1,
+		.format = outputFormat,
+	};
+	adc_continuous_evt_cbs_t callbacks{
+		.on_conv_done = [](adc_continuous_handle_t, const adc_continuous_evt_data_t* edata, void* user_data) -> bool {
+			auto self = static_cast<AnalogSampler*>(user_data);
+			for(uint32_t i = 0; i < edata->size; i += SOC_ADC_DIGI_RESULT_BYTES) {
+				auto p = reinterpret_cast<const adc_digi_output_data_t*>(&edata->conv_frame_buffer[i]);
+				self->addSample(ADC_SAMPLE_DATA(p));
+			}
+			return false;
+		},
+	};
+	err = adc_continuous_config(adcHandle, &adcConfig);
+	if(err == ESP_OK) {
+		err = adc_continuous_register_event_callbacks(adcHandle, &callbacks, this);
+	}
+	if(err == ESP_OK) {
+		err = adc_continuous_start(adcHandle);
+	}
+	if(err != ESP_OK) {
+		debug_e("[ADC] Start failed: %s", esp_err_to_name(err));
+		adc_continuous_deinit(adcHandle);
+		return false;
+	}
+
+	handle = adcHandle;
+	return true;
+}
+
+void AnalogSampler::stopSampling()
+{
+	auto adcHandle = static_cast<adc_continuous_handle_t>(handle);
+	adc_continuous_stop(adcHandle);
+	adc_continuous_deinit(adcHandle);
+	handle = nullptr;
+}
+
+#endif
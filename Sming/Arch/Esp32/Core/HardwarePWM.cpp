@@ -269,6 +269,31 @@ void HardwarePWM::update()
 	// ledc_update_duty();
 }
 
+bool HardwarePWM::apply(const Batch& batch)
+{
+	for(uint8_t i = 0; i < channel_count; i++) {
+		if(batch.duty[i] > maxduty) {
+			debug_d("Duty cycle value too high for current period, max duty cycle is %d", maxduty);
+			return false;
+		}
+	}
+
+	if(batch.period != 0) {
+		for(uint8_t i = 0; i < channel_count; i++) {
+			ESP_ERROR_CHECK(ledc_set_freq(pinToGroup(i), pinToTimer(i), periodToFrequency(batch.period)));
+		}
+	}
+
+	// Stage all duties first: each channel latches its new value at the end of its current period
+	for(uint8_t i = 0; i < channel_count; i++) {
+		ESP_ERROR_CHECK(ledc_set_duty(pinToGroup(i), pinToChannel(i), batch.duty[i]));
+	}
+	for(uint8_t i = 0; i < channel_count; i++) {
+		ESP_ERROR_CHECK(ledc_update_duty(pinToGroup(i), pinToChannel(i)));
+	}
+	return true;
+}
+
 uint32_t HardwarePWM::getFrequency(uint8_t pin)
 {
 	return ledc_get_freq(pinToGroup(pin), pinToTimer(pin));
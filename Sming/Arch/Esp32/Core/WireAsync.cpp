@@ -0,0 +1,126 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * WireAsync.cpp - Asynchronous I2C transactions using the hardware controller
+ *
+ * The IDF driver is interrupt-driven but its API blocks the caller until the command
+ * sequence has completed, so transactions are run from a dedicated FreeRTOS task.
+ *
+ ****/
+
+#include <Wire.h>
+#include <Digital.h>
+#include <driver/i2c.h>
+#include <hal/gpio_ll.h>
+#include <esp_systemapi.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <debug_progmem.h>
+
+/**
+ * @brief Hardware controller to use for asynchronous transactions
+ */
+#ifndef TWI_ASYNC_PORT
+#define TWI_ASYNC_PORT I2C_NUM_0
+#endif
+
+#ifndef TWI_ASYNC_TASK_STACK_SIZE
+#define TWI_ASYNC_TASK_STACK_SIZE 2048
+#endif
+
+namespace
+{
+// Generous limit: clock stretching is also bounded by the controller
+constexpr TickType_t transactionTimeout{pdMS_TO_TICKS(100)};
+
+} // namespace
+
+bool TwoWire::startTransaction(Transaction&)
+{
+	if(asyncHandle == nullptr) {
+		auto err = i2c_driver_install(TWI_ASYNC_PORT, I2C_MODE_MASTER, 0, 0, 0);
+		if(err != ESP_OK) {
+			debug_e("[TWI] Driver install failed: %d", err);
+			return false;
+		}
+		auto res = xTaskCreate(asyncTask, "TWI", TWI_ASYNC_TASK_STACK_SIZE, this, tskIDLE_PRIORITY + 2,
+							   reinterpret_cast<TaskHandle_t*>(&asyncHandle));
+		if(res != pdPASS) {
+			i2c_driver_delete(TWI_ASYNC_PORT);
+			return false;
+		}
+	}
+
+	if(asyncFrequency != clockFrequency) {
+		i2c_config_t config{};
+		config.mode = I2C_MODE_MASTER;
+		config.sda_io_num = twi_sda;
+		config.scl_io_num = twi_scl;
+		config.sda_pullup_en = GPIO_PULLUP_ENABLE;
+		config.scl_pullup_en = GPIO_PULLUP_ENABLE;
+		config.master.clk_speed = clockFrequency;
+		if(i2c_param_config(TWI_ASYNC_PORT, &config) != ESP_OK) {
+			return false;
+		}
+		asyncFrequency = clockFrequency;
+	}
+
+	// Pins are returned to GPIO matrix by endTransaction()
+	if(i2c_set_pin(TWI_ASYNC_PORT, twi_sda, twi_scl, true, true, I2C_MODE_MASTER) != ESP_OK) {
+		return false;
+	}
+
+	xTaskNotifyGive(static_cast<TaskHandle_t>(asyncHandle));
+	return true;
+}
+
+void TwoWire::endTransaction(Transaction&)
+{
+	for(auto pin : {twi_sda, twi_scl}) {
+		gpio_matrix_out(pin, SIG_GPIO_OUT_IDX, false, false);
+		pinMode(pin, INPUT_PULLUP);
+	}
+}
+
+void TwoWire::asyncTask(void* param)
+{
+	auto wire = static_cast<TwoWire*>(param);
+	for(;;) {
+		ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+		auto& trans = *wire->queueHead;
+
+		auto cmd = i2c_cmd_link_create();
+		i2c_master_start(cmd);
+		if(trans.txLength != 0) {
+			i2c_master_write_byte(cmd, (trans.address << 1) | I2C_MASTER_WRITE, true);
+			i2c_master_write(cmd, trans.txData, trans.txLength, true);
+		}
+		if(trans.rxLength != 0) {
+			if(trans.txLength != 0) {
+				i2c_master_start(cmd);
+			}
+			i2c_master_write_byte(cmd, (trans.address << 1) | I2C_MASTER_READ, true);
+			i2c_master_read(cmd, trans.rxData, trans.rxLength, I2C_MASTER_LAST_NACK);
+		}
+		i2c_master_stop(cmd);
+		auto err = i2c_master_cmd_begin(TWI_ASYNC_PORT, cmd, transactionTimeout);
+		i2c_cmd_link_delete(cmd);
+
+		// Driver does not distinguish address and data NACK
+		Error error;
+		switch(err) {
+		case ESP_OK:
+			error = I2C_ERR_SUCCESS;
+			break;
+		case ESP_FAIL:
+			error = I2C_ERR_ADDR_NACK;
+			break;
+		default:
+			error = I2C_ERR_LINE_BUSY;
+		}
+		wire->transactionComplete(error);
+	}
+}
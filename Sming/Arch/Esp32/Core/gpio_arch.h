@@ -0,0 +1,95 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * gpio_arch.h - Direct GPIO register access for Esp32
+ *
+ * See Sming/Core/FastGpio.h
+ *
+ * Pins 32 and above are in a second register bank.
+ *
+ ****/
+
+#pragma once
+
+#include <esp_attr.h>
+#include <sming_attr.h>
+#include <soc/soc.h>
+#include <soc/gpio_reg.h>
+#include <soc/soc_caps.h>
+
+namespace FastGpio
+{
+constexpr unsigned maxPins{SOC_GPIO_PIN_COUNT};
+
+template <unsigned bank> struct Port;
+
+template <> struct Port<0> {
+	__forceinline static void IRAM_ATTR set(uint32_t mask)
+	{
+		REG_WRITE(GPIO_OUT_W1TS_REG, mask);
+	}
+
+	__forceinline static void IRAM_ATTR clear(uint32_t mask)
+	{
+		REG_WRITE(GPIO_OUT_W1TC_REG, mask);
+	}
+
+	__forceinline static uint32_t IRAM_ATTR read(uint32_t mask)
+	{
+		return REG_READ(GPIO_IN_REG) & mask;
+	}
+
+	__forceinline static uint32_t IRAM_ATTR readOutput()
+	{
+		return REG_READ(GPIO_OUT_REG);
+	}
+
+	__forceinline static void IRAM_ATTR enableOutput(uint32_t mask)
+	{
+		REG_WRITE(GPIO_ENABLE_W1TS_REG, mask);
+	}
+
+	__forceinline static void IRAM_ATTR disableOutput(uint32_t mask)
+	{
+		REG_WRITE(GPIO_ENABLE_W1TC_REG, mask);
+	}
+};
+
+#if SOC_GPIO_PIN_COUNT > 32
+template <> struct Port<1> {
+	__forceinline static void IRAM_ATTR set(uint32_t mask)
+	{
+		REG_WRITE(GPIO_OUT1_W1TS_REG, mask);
+	}
+
+	__forceinline static void IRAM_ATTR clear(uint32_t mask)
+	{
+		REG_WRITE(GPIO_OUT1_W1TC_REG, mask);
+	}
+
+	__forceinline static uint32_t IRAM_ATTR read(uint32_t mask)
+	{
+		return REG_READ(GPIO_IN1_REG) & mask;
+	}
+
+	__forceinline static uint32_t IRAM_ATTR readOutput()
+	{
+		return REG_READ(GPIO_OUT1_REG);
+	}
+
+	__forceinline static void IRAM_ATTR enableOutput(uint32_t mask)
+	{
+		REG_WRITE(GPIO_ENABLE1_W1TS_REG, mask);
+	}
+
+	__forceinline static void IRAM_ATTR disableOutput(uint32_t mask)
+	{
+		REG_WRITE(GPIO_ENABLE1_W1TC_REG, mask);
+	}
+};
+#endif
+
+} // namespace FastGpio
@@ -9,6 +9,8 @@
  ****/
 
 #include <Platform/RTC.h>
+#include <esp_attr.h>
+#include <cstring>
 
 // #include <ESP_VARIANT/clk.h>
 extern "C" uint64_t esp_clk_rtc_time(void);
@@ -21,6 +23,9 @@ constexpr uint64_t US_PER_SECOND{1000000};
 constexpr uint64_t NS_PER_SECOND{US_PER_SECOND * 1000};
 uint64_t clockOffset;
 
+// Retained through deep sleep and software restarts
+RTC_NOINIT_ATTR uint32_t rtcMemory[RTC_MEMORY_BLOCK_END - RTC_MEMORY_BLOCK_START];
+
 } // namespace
 
 RtcClass::RtcClass()
@@ -47,3 +52,21 @@ bool RtcClass::setRtcSeconds(uint32_t seconds)
 {
 	return setRtcNanoseconds(uint64_t(seconds) * NS_PER_SECOND);
 }
+
+bool RtcClass::readMemory(uint8_t block, void* data, uint16_t size)
+{
+	if(block < RTC_MEMORY_BLOCK_START || block + (size + 3) / 4 > RTC_MEMORY_BLOCK_END) {
+		return false;
+	}
+	memcpy(data, &rtcMemory[block - RTC_MEMORY_BLOCK_START], size);
+	return true;
+}
+
+bool RtcClass::writeMemory(uint8_t block, const void* data, uint16_t size)
+{
+	if(block < RTC_MEMORY_BLOCK_START || block + (size + 3) / 4 > RTC_MEMORY_BLOCK_END) {
+		return false;
+	}
+	memcpy(&rtcMemory[block - RTC_MEMORY_BLOCK_START], data, size);
+	return true;
+}
@@ -0,0 +1,82 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * Worker.cpp - Execute jobs in a FreeRTOS task, by default on the other core
+ *
+ ****/
+
+#include <Platform/Worker.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <esp_event.h>
+#include <esp_tasks.h>
+#include <debug_progmem.h>
+
+#ifndef WORKER_TASK_STACK_SIZE
+#define WORKER_TASK_STACK_SIZE 4096
+#endif
+
+namespace
+{
+ESP_EVENT_DEFINE_BASE(WorkerEvt);
+
+TaskHandle_t workerTask;
+
+} // namespace
+
+bool WorkerClass::isParallel()
+{
+#if CONFIG_FREERTOS_UNICORE
+	return false;
+#else
+	return WORKER_TASK_CORE != SMING_TASK_CORE;
+#endif
+}
+
+bool WorkerClass::startWorker()
+{
+	// Completions are delivered via the event loop run by the Sming task
+	auto handler = [](void*, esp_event_base_t, int32_t, void*) { serviceCompletions(); };
+	auto err = esp_event_handler_instance_register(WorkerEvt, ESP_EVENT_ANY_ID, handler, nullptr, nullptr);
+	if(err != ESP_OK) {
+		return false;
+	}
+
+	auto taskFunc = [](void*) {
+		for(;;) {
+			ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+			while(runNext()) {
+			}
+		}
+	};
+
+	constexpr UBaseType_t priority{WORKER_TASK_PRIORITY};
+#if CONFIG_FREERTOS_UNICORE
+	auto res = xTaskCreate(taskFunc, "Worker", WORKER_TASK_STACK_SIZE, nullptr, priority, &workerTask);
+#else
+	constexpr BaseType_t core{WORKER_TASK_CORE};
+	static_assert(core < portNUM_PROCESSORS, "WORKER_TASK_CORE invalid");
+	auto res = xTaskCreatePinnedToCore(taskFunc, "Worker", WORKER_TASK_STACK_SIZE, nullptr, priority, &workerTask,
+									   core);
+#endif
+	if(res != pdPASS) {
+		debug_e("[WORKER] Task creation failed");
+		return false;
+	}
+
+	return true;
+}
+
+void WorkerClass::kickWorker()
+{
+	xTaskNotifyGive(workerTask);
+}
+
+void WorkerClass::notifyComplete()
+{
+	// If the event loop is full, completion is picked up following a subsequent post
+	esp_event_post(WorkerEvt, 0, nullptr, 0, 0);
+}
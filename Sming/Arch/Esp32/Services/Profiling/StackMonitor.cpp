@@ -0,0 +1,26 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * StackMonitor.cpp
+ *
+ */
+
+#include <Services/Profiling/StackMonitor.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <esp_task.h>
+
+namespace Profiling
+{
+bool StackMonitor::getBounds(uintptr_t& bottom, uintptr_t& top)
+{
+	// Sming task is created with this stack size, see startup.cpp
+	bottom = uintptr_t(pxTaskGetStackStart(nullptr));
+	top = bottom + ESP_TASKD_EVENT_STACK;
+	return true;
+}
+
+} // namespace Profiling
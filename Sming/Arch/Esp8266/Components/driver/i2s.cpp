@@ -23,6 +23,8 @@
  * 	  or with regular pinMode() calls.
  * 	- Add `i2s_dma_write()` and `i2s_dma_read()` for zero-copy transfers
  * 	  without double-buffering.
+ *	- Add optional buffer callbacks to fill/drain DMA buffers directly from the ISR,
+ *	  so streaming applications need no per-sample loop.
  *	- Add `i2s_start()` and `is2_stop()` functions.
  *	- Add `i2s_zero_dma_buffer` to keep link active but muted. More efficient than
  *	  clearing buffer after every TX (though this can be enabled using a config flag).
@@ -124,15 +126,15 @@ public:
  *
  */
 struct i2s_state_t {
-	uint32_t* buffers;				   ///< Buffers allocated in single block
-	dma_descriptor_t* slc_items;	   ///< DMA buffer descriptors
-	volatile uint8_t buffers_used = 0; ///< Number of queued buffers
-	volatile uint8_t buffer_index = 0; ///< Current buffer for user read/write
-	uint16_t buffer_pos = 0;		   ///< Position in the current buffer for read/write
-	uint16_t buffer_size = 0;		   ///< Size of each buffer (in bytes)
-	uint8_t buffer_count = 0;		   ///< Number of buffers
-	uint8_t callback_threshold = 0;	///< TX: callback when available buffers > threshold
-									   ///< RX: Callback when buffers_used > threshold
+	uint32_t* buffers = nullptr;		   ///< Buffers allocated in single block
+	dma_descriptor_t* slc_items = nullptr; ///< DMA buffer descriptors
+	volatile uint8_t buffers_used = 0;	   ///< Number of queued buffers
+	volatile uint8_t buffer_index = 0;	   ///< Current buffer for user read/write
+	uint16_t buffer_pos = 0;			   ///< Position in the current buffer for read/write
+	uint16_t buffer_size = 0;			   ///< Size of each buffer (in bytes)
+	uint8_t buffer_count = 0;			   ///< Number of buffers
+	uint8_t callback_threshold = 0;		   ///< TX: callback when available buffers > threshold
+										   ///< RX: Callback when buffers_used > threshold
 
 	~i2s_state_t();
 
@@ -168,6 +170,8 @@ struct i2s_object_t {
 	i2s_state_t* rx_state = nullptr;
 	i2s_state_t* tx_state = nullptr;
 	i2s_callback_t callback = nullptr;
+	i2s_buffer_callback_t tx_buffer_callback = nullptr;
+	i2s_buffer_callback_t rx_buffer_callback = nullptr;
 	void* param = nullptr;
 	uint32_t sample_rate = 0;
 	bool tx_desc_auto_clear = false; ///< I2S auto clear tx descriptor on underflow
@@ -298,15 +302,25 @@ void i2s_object_t::isr(uint32_t status)
 {
 	if(status & SLC_RX_EOF_INT_ST) {
 		auto desc = reinterpret_cast<dma_descriptor_t*>(dma.rx_eof_des_addr);
-		if(tx_state->tx_done(desc) && callback != nullptr) {
-			callback(param, I2S_EVENT_TX_DONE);
+		if(tx_state->tx_done(desc)) {
+			if(tx_buffer_callback != nullptr) {
+				i2s_service_buffers(tx_buffer_callback, nullptr, param);
+			}
+			if(callback != nullptr) {
+				callback(param, I2S_EVENT_TX_DONE);
+			}
 		}
 	}
 
 	if(status & SLC_TX_EOF_INT_ST) {
 		auto desc = reinterpret_cast<dma_descriptor_t*>(dma.tx_eof_des_addr);
-		if(rx_state->rx_done(desc) && callback != nullptr) {
-			callback(param, I2S_EVENT_RX_DONE);
+		if(rx_state->rx_done(desc)) {
+			if(rx_buffer_callback != nullptr) {
+				i2s_service_buffers(nullptr, rx_buffer_callback, param);
+			}
+			if(callback != nullptr) {
+				callback(param, I2S_EVENT_RX_DONE);
+			}
 		}
 	}
 }
@@ -318,6 +332,10 @@ bool i2s_state_t::initialise(const i2s_module_config_t& config)
 	uint8_t sample_size = bytes_per_sample * channel_num;
 	buffer_size = ALIGNUP4(config.dma_buf_len * sample_size);
 	buffer_count = config.dma_buf_count;
+	// One buffer is always owned by DMA; descriptor length field is 12 bits
+	if(buffer_count < 2 || buffer_size == 0 || buffer_size > 4092) {
+		return false;
+	}
 	buffers = new uint32_t[buffer_count * buffer_size / sizeof(uint32_t)];
 	slc_items = new dma_descriptor_t[buffer_count];
 	if(buffers == nullptr || slc_items == nullptr) {
@@ -325,7 +343,7 @@ bool i2s_state_t::initialise(const i2s_module_config_t& config)
 	}
 
 	memset(buffers, 0, buffer_count * buffer_size);
-	memset(slc_items, 0, buffer_count);
+	memset(slc_items, 0, buffer_count * sizeof(dma_descriptor_t));
 
 	for(unsigned i = 0; i < buffer_count; ++i) {
 		auto& item = slc_items[i];
@@ -344,8 +362,8 @@ bool i2s_state_t::initialise(const i2s_module_config_t& config)
 
 i2s_state_t::~i2s_state_t()
 {
-	delete slc_items;
-	delete buffers;
+	delete[] slc_items;
+	delete[] buffers;
 }
 
 bool i2s_dma_write(i2s_buffer_info_t* info, size_t max_bytes)
@@ -407,7 +425,7 @@ size_t i2s_state_t::write(const void* src, size_t size, TickType_t ticks_to_wait
 	auto buf = static_cast<const uint8_t*>(src);
 	while(size > 0) {
 		if(dma_write(info, size)) {
-			memcpy(info.buffer, src, info.size);
+			memcpy(info.buffer, buf, info.size);
 			buf += info.size;
 			size -= info.size;
 			count += info.size;
@@ -618,6 +636,8 @@ bool i2s_driver_install(const i2s_config_t* config)
 bool i2s_object_t::initialise(const i2s_config_t& config)
 {
 	callback = config.callback;
+	tx_buffer_callback = config.tx_buffer_callback;
+	rx_buffer_callback = config.rx_buffer_callback;
 	param = config.param;
 
 	if(config.tx.mode != I2S_MODE_DISABLED) {
@@ -832,9 +852,8 @@ void i2s_object_t::stop()
 
 void i2s_driver_uninstall()
 {
-	if(i2s_obj != nullptr) {
-		delete i2s_obj;
-	}
+	delete i2s_obj;
+	i2s_obj = nullptr;
 }
 
 i2s_object_t::~i2s_object_t()
@@ -221,6 +221,11 @@ void IRAM_ATTR handle_uart_interrupt(uint8_t uart_nr, smg_uart_t* uart)
 				}
 			}
 
+			if(uart->tx_threshold != 0 && uart->tx_buffer != nullptr &&
+			   uart->tx_buffer->getFreeSpace() >= uart->tx_threshold) {
+				status |= UART_STATUS_TX_THRESHOLD;
+			}
+
 			// If TX FIFO remains empty then we must disable TX FIFO EMPTY interrupt to stop it recurring.
 			if(uart_txfifo_count(uart_nr) == 0) {
 				// The interrupt gets re-enabled by uart_write()
@@ -386,6 +391,38 @@ size_t smg_uart_read(smg_uart_t* uart, void* buffer, size_t size)
 	return read;
 }
 
+size_t smg_uart_rx_peek_region(smg_uart_t* uart, const void*& data)
+{
+	data = nullptr;
+	if(!smg_uart_rx_enabled(uart) || uart->rx_buffer == nullptr) {
+		return 0;
+	}
+
+	notify(uart, UART_NOTIFY_BEFORE_READ);
+
+	void* buf;
+	auto len = uart->rx_buffer->getReadData(buf);
+	data = buf;
+	return len;
+}
+
+void smg_uart_rx_consume(smg_uart_t* uart, size_t length)
+{
+	if(!smg_uart_rx_enabled(uart) || uart->rx_buffer == nullptr || length == 0) {
+		return;
+	}
+
+	uart->rx_buffer->skipRead(length);
+
+	if(is_physical(uart)) {
+		// FIFO full may have been disabled if buffer overflowed, re-enabled it now
+		WRITE_PERI_REG(UART_INT_CLR(uart->uart_nr),
+					   UART_RXFIFO_FULL_INT_CLR | UART_RXFIFO_TOUT_INT_CLR | UART_RXFIFO_OVF_INT_CLR);
+		SET_PERI_REG_MASK(UART_INT_ENA(uart->uart_nr),
+						  UART_RXFIFO_FULL_INT_ENA | UART_RXFIFO_TOUT_INT_ENA | UART_RXFIFO_OVF_INT_ENA);
+	}
+}
+
 size_t smg_uart_rx_available(smg_uart_t* uart)
 {
 	if(!smg_uart_rx_enabled(uart)) {
@@ -481,9 +518,7 @@ size_t smg_uart_write(smg_uart_t* uart, const void* buffer, size_t size)
 
 		// Write any remaining data into transmit buffer
 		if(uart->tx_buffer != nullptr) {
-			while(written < size && uart->tx_buffer->writeChar(buf[written])) {
-				++written;
-			}
+			written += uart->tx_buffer->write(&buf[written], size - written);
 		}
 
 		notify(uart, UART_NOTIFY_AFTER_WRITE);
@@ -1,6 +1,12 @@
-COMPONENT_VARS			:= ENABLE_LWIPDEBUG ENABLE_ESPCONN
+COMPONENT_VARS			:= ENABLE_LWIPDEBUG ENABLE_ESPCONN LWIP_PROFILE
 ENABLE_LWIPDEBUG		?= 0
 ENABLE_ESPCONN			?= 0
+include $(SMING_HOME)/Components/Network/lwip-profile/lwip-profile.mk
+
+# Profile must also apply to application code using lwIP headers
+ifneq ($(LWIP_PROFILE),default)
+GLOBAL_CFLAGS			+= -include $(LWIP_PROFILE_DIR)/lwip_profile.h
+endif
 
 COMPONENT_DEPENDS		:= esp8266
 
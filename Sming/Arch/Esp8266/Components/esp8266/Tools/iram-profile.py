@@ -0,0 +1,121 @@
+#!/usr/bin/env python
+########################################################
+#
+#  Profile-guided IRAM placement
+#
+#  Reads call counts written by Profiling::IramProfiler::dump() and
+#  generates a linker fragment moving the most frequently called
+#  flash functions into spare IRAM.
+#
+########################################################
+import argparse
+import bisect
+import subprocess
+import sys
+
+IRAM_START = 0x40100000
+IRAM_SIZE = 0x8000
+FLASH_START = 0x40200000
+
+
+def read_symbols(nm, elf):
+    """Return sorted list of (addr, size, name) for flash-resident functions, plus IRAM end address"""
+    output = subprocess.check_output([nm, '--print-size', '--defined-only', elf]).decode()
+    symbols = []
+    text_end = None
+    for line in output.splitlines():
+        fields = line.split()
+        if len(fields) == 3 and fields[2] == '_text_end':
+            text_end = int(fields[0], 16)
+            continue
+        if len(fields) != 4 or fields[2] not in 'tTwW':
+            continue
+        addr, size, name = int(fields[0], 16), int(fields[1], 16), fields[3]
+        if addr >= FLASH_START and size != 0:
+            symbols.append((addr, size, name))
+    symbols.sort()
+    return symbols, text_end
+
+
+def read_dump(filename):
+    counts = {}
+    with open(filename) as f:
+        for line in f:
+            line = line.strip()
+            if not line or line.startswith('#'):
+                if line.startswith('# iram-profile'):
+                    fields = line.split()
+                    if len(fields) > 3 and int(fields[3]) != 0:
+                        print("Warning: %s calls not recorded, increase IRAM_PROFILE_SLOTS" % fields[3])
+                continue
+            fields = line.split()
+            if len(fields) != 2:
+                continue
+            try:
+                addr, count = int(fields[0], 16), int(fields[1])
+            except ValueError:
+                # Ignore any other serial output captured with the dump
+                continue
+            counts[addr] = counts.get(addr, 0) + count
+    return counts
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Generate IRAM placement linker fragment from call counts')
+    parser.add_argument('--nm', default='xtensa-lx106-elf-nm', help='Path to nm tool')
+    parser.add_argument('--margin', type=int, default=512, help='IRAM to leave free, in bytes')
+    parser.add_argument('--budget', type=int, help='IRAM to use, in bytes (default is all free space less margin)')
+    parser.add_argument('--list', action='store_true', help='Print selected functions')
+    parser.add_argument('elf', help='Firmware which produced the dump')
+    parser.add_argument('dump', help='Output from IramProfiler::dump()')
+    parser.add_argument('output', help='Linker fragment to write')
+    args = parser.parse_args()
+
+    symbols, text_end = read_symbols(args.nm, args.elf)
+    counts = read_dump(args.dump)
+
+    budget = args.budget
+    if budget is None:
+        if text_end is None:
+            sys.exit("_text_end not found in %s, use --budget" % args.elf)
+        budget = IRAM_START + IRAM_SIZE - text_end - args.margin
+
+    # Map each recorded address to its function
+    addrs = [s[0] for s in symbols]
+    funcs = {}
+    for addr, count in counts.items():
+        i = bisect.bisect_right(addrs, addr) - 1
+        if i < 0:
+            continue
+        sym = symbols[i]
+        if addr >= sym[0] + sym[1]:
+            continue
+        funcs[sym] = funcs.get(sym, 0) + count
+
+    # Calls per byte approximates cache misses avoided per byte of IRAM used
+    ranked = sorted(funcs.items(), key=lambda item: item[1] / float(item[0][1]), reverse=True)
+
+    selected = []
+    used = 0
+    for sym, count in ranked:
+        # Allow for alignment and literals
+        size = (sym[1] + 3) & ~3
+        if used + size > budget:
+            continue
+        selected.append((sym, count))
+        used += size
+
+    with open(args.output, 'w') as f:
+        f.write("/* Generated by iram-profile.py from %s: %u functions, %u bytes */\n" %
+                (args.dump, len(selected), used))
+        for (addr, size, name), count in selected:
+            f.write("*(.literal.%s .text.%s) /* %u calls, %u bytes */\n" % (name, name, count, size))
+
+    print("IRAM profile: %u of %u functions selected, %u of %u bytes" % (len(selected), len(funcs), used, max(budget, 0)))
+    if args.list:
+        for (addr, size, name), count in selected:
+            print("  %8u %6u %s" % (count, size, name))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,105 @@
+#!/usr/bin/env python
+########################################################
+#
+#  PC sample analyser
+#
+#  Reads program counter samples written by Profiling::PcSampler::dump()
+#  and reports where time is spent, by function and memory region.
+#
+########################################################
+import argparse
+import bisect
+import re
+import subprocess
+
+REGIONS = [
+    (0x40000000, 0x40010000, 'rom'),
+    (0x40100000, 0x40108000, 'iram'),
+    (0x40200000, 0x40300000, 'flash'),
+]
+
+
+def region_of(addr):
+    for start, end, name in REGIONS:
+        if start <= addr < end:
+            return name
+    return '?'
+
+
+def read_symbols(nm, elf):
+    output = subprocess.check_output([nm, '--print-size', '--defined-only', '-C', elf]).decode()
+    symbols = []
+    for line in output.splitlines():
+        fields = line.split(None, 3)
+        if len(fields) != 4 or fields[2] not in 'tTwW':
+            continue
+        size = int(fields[1], 16)
+        if size != 0:
+            symbols.append((int(fields[0], 16), size, fields[3]))
+    symbols.sort()
+    return symbols
+
+
+def read_samples(filenames):
+    samples = []
+    dropped = 0
+    for filename in filenames:
+        with open(filename) as f:
+            for line in f:
+                if line.startswith('# pc-sampler'):
+                    # Counts are cumulative, so the last header wins
+                    fields = line.split()
+                    if len(fields) > 4:
+                        dropped = int(fields[4])
+                    continue
+                if re.match(r'^([0-9a-f]{8}\s*)+$', line.strip()):
+                    samples += [int(word, 16) for word in line.split()]
+    return samples, dropped
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Analyse program counter samples')
+    parser.add_argument('--nm', default='xtensa-lx106-elf-nm', help='Path to nm tool')
+    parser.add_argument('--top', type=int, default=30, help='Number of functions to list')
+    parser.add_argument('elf', help='Firmware which produced the samples')
+    parser.add_argument('dump', nargs='+', help='Output from PcSampler::dump()')
+    args = parser.parse_args()
+
+    symbols = read_symbols(args.nm, args.elf)
+    samples, dropped = read_samples(args.dump)
+    if not samples:
+        print("No samples found")
+        return
+
+    addrs = [s[0] for s in symbols]
+    funcs = {}
+    regions = {}
+    for pc in samples:
+        region = region_of(pc)
+        regions[region] = regions.get(region, 0) + 1
+        i = bisect.bisect_right(addrs, pc) - 1
+        if i >= 0 and pc < symbols[i][0] + symbols[i][1]:
+            key = symbols[i]
+        else:
+            key = (pc & ~0xff, 0, '%s @ 0x%08x' % (region, pc & ~0xff))
+        funcs[key] = funcs.get(key, 0) + 1
+
+    total = len(samples)
+    print("%u samples, %u dropped" % (total, dropped))
+    for name in ['flash', 'iram', 'rom', '?']:
+        if name in regions:
+            print("  %-6s %5.1f%%" % (name, 100.0 * regions[name] / total))
+    print()
+    print("   Samples   Share  Region    Size  Function")
+    ranked = sorted(funcs.items(), key=lambda item: item[1], reverse=True)
+    for (addr, size, name), count in ranked[:args.top]:
+        region = region_of(addr)
+        # Flash functions are candidates for IRAM_ATTR or iram-profile.py
+        flag = '*' if region == 'flash' else ' '
+        print("%10u  %5.1f%%  %-6s %6u %s %s" % (count, 100.0 * count / total, region, size, flag, name))
+    print()
+    print("* Executing from flash: includes time stalled on cache misses")
+
+
+if __name__ == "__main__":
+    main()
@@ -41,8 +41,52 @@ EXTRA_LIBS := \
 	crypto \
 	hal
 
+# Profile-guided IRAM placement: common.ld includes `iram-profile.ld` from the first directory
+# in the search path, so a generated file takes precedence over the empty default
+COMPONENT_RELINK_VARS += IRAM_PROFILE_DIR
+ifneq (,$(IRAM_PROFILE_DIR))
+LIBDIRS += $(abspath $(IRAM_PROFILE_DIR))
+endif
+
 LIBDIRS += $(COMPONENT_PATH)/ld $(SDK_LIBDIR)
 
+# Instrument all code to count calls to each function, see Services/Profiling/IramProfiler.h
+COMPONENT_VARS += ENABLE_IRAM_PROFILE
+ifeq ($(ENABLE_IRAM_PROFILE),1)
+GLOBAL_CFLAGS += \
+	-DENABLE_IRAM_PROFILE=1 \
+	-finstrument-functions \
+	-finstrument-functions-exclude-file-list=IramProfiler,/gdbstub/
+endif
+
+IRAM_PROFILE_TOOL		:= $(COMPONENT_PATH)/Tools/iram-profile.py
+IRAM_PROFILE_DUMP		?=
+IRAM_PROFILE_MARGIN		?= 512
+
+##@Building
+
+.PHONY: iram-profile
+iram-profile: ##Generate iram-profile.ld in IRAM_PROFILE_DIR from IRAM_PROFILE_DUMP
+ifeq (,$(and $(IRAM_PROFILE_DUMP),$(IRAM_PROFILE_DIR)))
+	$(error IRAM_PROFILE_DUMP and IRAM_PROFILE_DIR must be set)
+endif
+ifneq ($(ENABLE_IRAM_PROFILE),1)
+	$(error Requires ENABLE_IRAM_PROFILE=1 to match the firmware which produced the dump)
+endif
+	$(Q) mkdir -p $(IRAM_PROFILE_DIR)
+	$(Q) $(PYTHON) $(IRAM_PROFILE_TOOL) --nm $(NM) --margin $(IRAM_PROFILE_MARGIN) \
+		$(TARGET_OUT_0) $(IRAM_PROFILE_DUMP) $(IRAM_PROFILE_DIR)/iram-profile.ld
+
+PC_SAMPLER_TOOL			:= $(COMPONENT_PATH)/Tools/pc-sampler.py
+PC_SAMPLER_DUMP			?=
+
+.PHONY: pc-sampler
+pc-sampler: ##Report where time is spent from PC_SAMPLER_DUMP (output from Profiling::PcSampler)
+ifeq (,$(PC_SAMPLER_DUMP))
+	$(error PC_SAMPLER_DUMP must be set)
+endif
+	$(Q) $(PYTHON) $(PC_SAMPLER_TOOL) --nm $(NM) $(TARGET_OUT_0) $(PC_SAMPLER_DUMP)
+
 # SDK-provided crypto library
 # Some routines are available in ROM so strip them out
 LIBCRYPTO := $(SDK_LIBDIR)/libcrypto.a
@@ -31,6 +31,8 @@
 
 #define SYSTEM_ERROR(fmt, ...) debug_e("ERROR: " fmt "\r\n", ##__VA_ARGS__)
 
+#ifndef ENABLE_IRQ_LATENCY
+
 /** @brief  Disable interrupts
  *  @retval Current interrupt level
  *  @note Hardware timer is unaffected if operating in non-maskable mode
@@ -44,3 +46,34 @@
 /** @brief Restore interrupts to level saved from previous noInterrupts() call
  */
 #define restoreInterrupts(level) XTOS_RESTORE_INTLEVEL(level)
+
+#else
+
+// Instrumented versions, see irq_latency.h
+#include <irq_latency.h>
+
+#define noInterrupts()                                                                                                 \
+	({                                                                                                                 \
+		uint32_t level_ = XTOS_SET_INTLEVEL(15);                                                                       \
+		if((level_ & 0x0f) == 0) {                                                                                     \
+			irq_latency_lock(NULL);                                                                                    \
+		}                                                                                                              \
+		level_;                                                                                                        \
+	})
+
+#define interrupts()                                                                                                   \
+	({                                                                                                                 \
+		irq_latency_unlock();                                                                                          \
+		XTOS_SET_INTLEVEL(0);                                                                                          \
+	})
+
+#define restoreInterrupts(level)                                                                                       \
+	({                                                                                                                 \
+		uint32_t level_ = (level);                                                                                     \
+		if((level_ & 0x0f) == 0) {                                                                                     \
+			irq_latency_unlock();                                                                                      \
+		}                                                                                                              \
+		XTOS_RESTORE_INTLEVEL(level_);                                                                                 \
+	})
+
+#endif
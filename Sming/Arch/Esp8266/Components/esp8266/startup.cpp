@@ -21,6 +21,8 @@ extern void cpp_core_initialize();
 // Normal entry point for user application code from SDK
 extern "C" void user_init(void)
 {
+	System.setBootPhase(BootPhase::userInit);
+
 	// Initialise hardware timers
 	hw_timer_init();
 
@@ -40,21 +42,29 @@ extern "C" void user_init(void)
 
 	gdb_init();
 
+#ifndef ENABLE_FAST_BOOT
 	/*
 	 * Load partition information.
 	 * Normally this is done in user_pre_init() but if building without WiFi
 	 * (via esp_no_wifi Component) then user_pre_init() is not called as none of the
 	 * SDK-related partitions are required.
 	 * Calling this a second time is a no-op.
+	 *
+	 * With fast boot the partition table is instead loaded on first use.
 	 */
 	Storage::initialize();
+#endif
 
+	System.setBootPhase(BootPhase::appInit);
 	init(); // User code init
 }
 
 // SDK 3+ calls this method to configure partitions
 extern "C" void user_pre_init(void)
 {
+	System.setBootPhase(BootPhase::sdkPreInit);
+
+	// SDK requires partition information now, so this can't be deferred
 	Storage::initialize();
 
 	using PartType = Storage::Partition::SubType::Data;
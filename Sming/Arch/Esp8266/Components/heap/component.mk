@@ -32,3 +32,13 @@ $(Q) $(AR) -d $@ mem_manager.o
 endef
 LIBMAIN_COMMANDS += $(HEAP_LIBMAIN_COMMANDS)
 endif
+
+# => IRAM heap
+COMPONENT_RELINK_VARS	+= ENABLE_IRAM_HEAP
+ENABLE_IRAM_HEAP		?= 0
+ifeq ($(ENABLE_IRAM_HEAP),1)
+ifeq ($(ENABLE_CUSTOM_HEAP),1)
+$(error ENABLE_IRAM_HEAP requires the SDK heap, set ENABLE_CUSTOM_HEAP=0)
+endif
+GLOBAL_CFLAGS			+= -DENABLE_IRAM_HEAP
+endif
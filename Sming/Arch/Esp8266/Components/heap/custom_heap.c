@@ -7,6 +7,7 @@
 #include <c_types.h>
 #include "umm_malloc_cfg.h"
 #include "umm_malloc.h"
+#include <heap_info.h>
 
 #undef IRAM_ATTR
 #define IRAM_ATTR __attribute__((section(".iram.text")))
@@ -79,3 +80,17 @@ void system_show_malloc(void)
 {
     umm_info(NULL, 1);
 }
+
+// Size of umm_block
+#define UMM_BLOCK_SIZE 8
+
+bool system_get_heap_info(heap_info_t* info)
+{
+    // Take all values from the same walk
+    umm_info(NULL, 0);
+    info->free_size = ummHeapInfo.freeBlocks * UMM_BLOCK_SIZE;
+    info->largest_free_block = ummHeapInfo.maxFreeContiguousBlocks * UMM_BLOCK_SIZE;
+    info->free_blocks = ummHeapInfo.freeEntries;
+    info->fragmentation = system_calc_heap_fragmentation(info->free_size, info->largest_free_block);
+    return true;
+}
@@ -1,6 +1,9 @@
 #include <stdlib.h>
 #include <stddef.h>
 #include <sys/reent.h>
+#include <esp_system.h>
+#include <heap_info.h>
+#include <heap_region.h>
 
 void* _malloc_r(struct _reent* unused, size_t size)
 {
@@ -26,3 +29,55 @@ void* _calloc_r(struct _reent* unused, size_t count, size_t size)
     return calloc(count, size);
 }
 
+
+/*
+ * The SDK heap provides no fragmentation information.
+ * Overridden by custom_heap.c when ENABLE_CUSTOM_HEAP=1.
+ */
+bool __attribute__((weak)) system_get_heap_info(heap_info_t* info)
+{
+    info->free_size = system_get_free_heap_size();
+    info->largest_free_block = info->free_size;
+    info->free_blocks = 0;
+    info->fragmentation = 0;
+    return false;
+}
+
+#ifdef ENABLE_IRAM_HEAP
+
+void* pvPortZallocIram(size_t size, const char* file, int line);
+
+/*
+ * SDK hook: reduces flash cache to 16K and adds the released IRAM as a separate heap.
+ */
+bool user_iram_memory_is_enabled(void)
+{
+    return true;
+}
+
+#endif
+
+void* heap_region_malloc(heap_region_t region, size_t size)
+{
+#ifdef ENABLE_IRAM_HEAP
+    if(region == HEAP_REGION_IRAM) {
+        void* ptr = pvPortZallocIram(size, "", __LINE__);
+        if(ptr != NULL) {
+            return ptr;
+        }
+    }
+#else
+    (void) region;
+#endif
+    return malloc(size);
+}
+
+bool heap_region_available(heap_region_t region)
+{
+#ifdef ENABLE_IRAM_HEAP
+    if(region == HEAP_REGION_IRAM) {
+        return true;
+    }
+#endif
+    return region == HEAP_REGION_DEFAULT;
+}
@@ -10,18 +10,51 @@
 
 #include <FakePgmSpace.h>
 #include <ctype.h>
+#include <stdint.h>
+
+/*
+ * Flash is only readable as aligned 32-bit words, so pgm_read_byte() costs a load and a shift per byte.
+ * These routines read whole words where they can, extracting bytes in little-endian order.
+ * Reading the remainder of the word containing the last byte is always safe.
+ */
+
+#define HAS_ZERO_BYTE(w) ((((w)-0x01010101U) & ~(w)&0x80808080U) != 0)
+
+static inline uint32_t read_word(const void* addr)
+{
+	return *(const uint32_t*)addr;
+}
 
 void* memcpy_P(void* dest, const void* src_P, size_t length)
 {
-	// Yes, it seems dest must also be aligned
-	if(IS_ALIGNED(dest) && IS_ALIGNED(src_P) && IS_ALIGNED(length)) {
-		return memcpy(dest, src_P, length);
+	uint8_t* d = (uint8_t*)dest;
+	const uint8_t* s = (const uint8_t*)src_P;
+
+	while(length != 0 && !IS_ALIGNED(s)) {
+		*d++ = pgm_read_byte(s++);
+		--length;
 	}
 
-	char* dest0 = (char*)dest;
-	const char* src0 = (const char*)src_P;
-	while(length-- != 0) {
-		*dest0++ = pgm_read_byte(src0++);
+	if(IS_ALIGNED(d)) {
+		for(; length >= 4; length -= 4, d += 4, s += 4) {
+			*(uint32_t*)d = read_word(s);
+		}
+	} else {
+		for(; length >= 4; length -= 4, d += 4, s += 4) {
+			uint32_t w = read_word(s);
+			d[0] = w;
+			d[1] = w >> 8;
+			d[2] = w >> 16;
+			d[3] = w >> 24;
+		}
+	}
+
+	if(length != 0) {
+		uint32_t w = read_word(s);
+		do {
+			*d++ = w;
+			w >>= 8;
+		} while(--length != 0);
 	}
 
 	return dest;
@@ -31,8 +64,15 @@ int memcmp_P(const void* a1, const void* b1, size_t len)
 {
 	const uint8_t* a = (const uint8_t*)a1;
 	const uint8_t* b = (const uint8_t*)b1;
-	for(size_t i = 0; i < len; i++, ++a, ++b) {
-		uint8_t d = pgm_read_byte(a) - pgm_read_byte(b);
+
+	// Compare words while both are aligned, then locate any difference byte-by-byte
+	if(IS_ALIGNED(a) && IS_ALIGNED(b)) {
+		for(; len >= 4 && read_word(a) == read_word(b); len -= 4, a += 4, b += 4) {
+		}
+	}
+
+	for(; len != 0; --len, ++a, ++b) {
+		int d = (int)pgm_read_byte(a) - (int)pgm_read_byte(b);
 		if(d != 0) {
 			return d;
 		}
@@ -42,20 +82,29 @@ int memcmp_P(const void* a1, const void* b1, size_t len)
 
 size_t strlen_P(const char* src_P)
 {
-	char val;
-	size_t len = 0;
-	while((val = pgm_read_byte(src_P)) != 0) {
-		++len;
-		++src_P;
+	const char* p = src_P;
+
+	while(!IS_ALIGNED(p)) {
+		if(pgm_read_byte(p) == 0) {
+			return p - src_P;
+		}
+		++p;
+	}
+
+	while(!HAS_ZERO_BYTE(read_word(p))) {
+		p += 4;
+	}
+
+	while(pgm_read_byte(p) != 0) {
+		++p;
 	}
 
-	return len;
+	return p - src_P;
 }
 
 char* strcpy_P(char* dest, const char* src_P)
 {
-	for(char* p = dest; (*p = pgm_read_byte(src_P++)); p++)
-		;
+	memcpy_P(dest, src_P, strlen_P(src_P) + 1);
 	return dest;
 }
 
@@ -71,23 +120,50 @@ char* strncpy_P(char* dest, const char* src_P, size_t max_len)
 	return dest;
 }
 
-int strcmp_P(const char* str1, const char* str2_P)
+/*
+ * Compare a RAM string against one in flash, up to `size` characters.
+ * Flash is read a word at a time once aligned.
+ */
+static int compare_P(const char* str1, const char* str2_P, size_t size, int ignoreCase)
 {
-	for(; *str1 == pgm_read_byte(str2_P); str1++, str2_P++) {
-		if(*str1 == '\0')
-			return 0;
+	const uint8_t* s1 = (const uint8_t*)str1;
+	unsigned offset = (uint32_t)str2_P & 3;
+	const uint32_t* wp = (const uint32_t*)(str2_P - offset);
+	uint32_t w = *wp++ >> (offset * 8);
+	unsigned avail = 4 - offset;
+
+	for(; size != 0; --size, ++s1) {
+		if(avail == 0) {
+			w = *wp++;
+			avail = 4;
+		}
+		int c1 = *s1;
+		int c2 = (uint8_t)w;
+		w >>= 8;
+		--avail;
+		if(ignoreCase) {
+			c1 = tolower(c1);
+			c2 = tolower(c2);
+		}
+		if(c1 != c2) {
+			return c1 < c2 ? -1 : 1;
+		}
+		if(c1 == '\0') {
+			break;
+		}
 	}
-	return *(unsigned char*)str1 < (unsigned char)pgm_read_byte(str2_P) ? -1 : 1;
+
+	return 0;
+}
+
+int strcmp_P(const char* str1, const char* str2_P)
+{
+	return compare_P(str1, str2_P, SIZE_MAX, 0);
 }
 
 int strncmp_P(const char* str1, const char* str2_P, const size_t size)
 {
-	for(unsigned i = 0; *str1 == pgm_read_byte(str2_P); str1++, str2_P++, i++) {
-		if(i == size) {
-			return 0;
-		}
-	}
-	return *(unsigned char*)str1 < (unsigned char)pgm_read_byte(str2_P) ? -1 : 1;
+	return compare_P(str1, str2_P, size, 0);
 }
 
 char* strstr_P(char* haystack, const char* needle_P)
@@ -124,11 +200,7 @@ char* strstr_P(char* haystack, const char* needle_P)
 
 int strcasecmp_P(const char* str1, const char* str2_P)
 {
-	for(; tolower((unsigned char)*str1) == tolower(pgm_read_byte(str2_P)); str1++, str2_P++) {
-		if(*str1 == '\0')
-			return 0;
-	}
-	return tolower(*(unsigned char*)str1) < tolower(pgm_read_byte(str2_P)) ? -1 : 1;
+	return compare_P(str1, str2_P, SIZE_MAX, 1);
 }
 
 char* strcat_P(char* dest, const char* src_P)
@@ -9,14 +9,21 @@ ifeq ($(SMING_RELEASE),1)
 		-Wno-implicit-function-declaration
 endif
 
-COMPONENT_VARS		:= ENABLE_LWIPDEBUG ENABLE_ESPCONN
+COMPONENT_VARS		:= ENABLE_LWIPDEBUG ENABLE_ESPCONN LWIP_PROFILE
 ENABLE_LWIPDEBUG	?= 0
 ENABLE_ESPCONN		?= 0
+include $(SMING_HOME)/Components/Network/lwip-profile/lwip-profile.mk
+
+# Profile must also apply to application code using lwIP headers
+ifneq ($(LWIP_PROFILE),default)
+GLOBAL_CFLAGS		+= -include $(LWIP_PROFILE_DIR)/lwip_profile.h
+endif
 
 EXTRA_CFLAGS_LWIP  := \
 	-I$(SMING_HOME)/System/include \
 	-I$(ARCH_COMPONENTS)/esp8266/include \
-	-I$(ARCH_COMPONENTS)/libc/include
+	-I$(ARCH_COMPONENTS)/libc/include \
+	$(LWIP_PROFILE_CFLAGS)
 
 ifeq ($(ENABLE_LWIPDEBUG), 1)
 	EXTRA_CFLAGS_LWIP += -DLWIP_DEBUG
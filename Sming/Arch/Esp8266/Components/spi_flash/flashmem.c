@@ -21,16 +21,23 @@
 extern char _flash_code_end[];
 
 /*
- * To ensure memory alignment a temporary buffer is used by flashmem_read and flashmem_write functions.
+ * Where the caller's buffer is word-aligned relative to the flash address, the aligned span
+ * is transferred directly and only the unaligned head and tail go via a temporary buffer.
+ * If the buffer is misaligned the whole transfer is bounced, in chunks of this many units.
  *
  * The buffer must be an integer multiple of INTERNAL_FLASH_WRITE_UNIT_SIZE.
  */
-#define FLASH_BUFFERS 32
+#ifndef FLASH_BUFFERS
+#define FLASH_BUFFERS 64
+#endif
 
 /** @brief determines if the given value is aligned to a word (4-byte) boundary */
 #undef IS_ALIGNED
 #define IS_ALIGNED(x) (((uint32_t)(x)&0x00000003) == 0)
 
+/** @brief determines if the given buffer is in RAM. Data in mapped flash can't be read whilst writing to flash. */
+#define IS_RAM(x) ((uint32_t)(x) < INTERNAL_FLASH_START_ADDRESS)
+
 // Buffers need to be word aligned for flash access
 #define ATTR_ALIGNED __attribute__((aligned(4)))
 
@@ -54,9 +61,23 @@ uint32_t flashmem_get_address(const void* memptr)
 	return addr;
 }
 
+const void* flashmem_map(uint32_t addr, uint32_t size)
+{
+	uint32_t bankStart = flashmem_get_address((const void*)INTERNAL_FLASH_START_ADDRESS);
+	if(addr < bankStart || addr + size > bankStart + 0x100000U) {
+		return NULL;
+	}
+	return (const void*)(INTERNAL_FLASH_START_ADDRESS + addr - bankStart);
+}
+
+void flashmem_unmap(const void* ptr)
+{
+	(void)ptr;
+}
+
 uint32_t flashmem_write(const void* from, uint32_t toaddr, uint32_t size)
 {
-	if(IS_ALIGNED(from) && IS_ALIGNED(toaddr) && IS_ALIGNED(size))
+	if(IS_ALIGNED(from) && IS_ALIGNED(toaddr) && IS_ALIGNED(size) && IS_RAM(from))
 		return flashmem_write_internal(from, toaddr, size);
 
 	const uint32_t blksize = INTERNAL_FLASH_WRITE_UNIT_SIZE;
@@ -75,16 +96,15 @@ uint32_t flashmem_write(const void* from, uint32_t toaddr, uint32_t size)
 		// Read existing unit and overlay with new data
 		if(flashmem_read_internal(tmpdata, addr_aligned, blksize) != blksize)
 			return 0;
-		while(remain && rest < blksize)
-		{
-			tmpdata[rest++] = *pfrom++;
-			--remain;
-		}
+		uint32_t count = min(blksize - rest, remain);
+		memcpy(&tmpdata[rest], pfrom, count);
+		pfrom += count;
+		remain -= count;
 
 		// Write the unit
 		uint32_t written = flashmem_write_internal(tmpdata, addr_aligned, blksize);
 		if(written != blksize)
-			return written;
+			return 0;
 
 		if (remain == 0)
 			return size;
@@ -95,16 +115,30 @@ uint32_t flashmem_write(const void* from, uint32_t toaddr, uint32_t size)
 	// The start address is now a multiple of blksize
 	// Compute how many bytes we can write as multiples of blksize
 	uint32_t rest = remain & blkmask;
-	remain &= ~blkmask;
-	// Program the blocks now
-	while(remain)
+	uint32_t aligned_size = remain & ~blkmask;
+
+	if(aligned_size != 0 && IS_ALIGNED(pfrom) && IS_RAM(pfrom))
 	{
-		unsigned count = min(remain, sizeof(tmpdata));
+		// Source is also aligned, so write the whole span without copying
+		uint32_t written = flashmem_write_internal(pfrom, toaddr, aligned_size);
+		if(written != aligned_size)
+			return size - remain;
+		remain -= aligned_size;
+		toaddr += aligned_size;
+		pfrom += aligned_size;
+		aligned_size = 0;
+	}
+
+	// Program the blocks through the bounce buffer
+	while(aligned_size)
+	{
+		unsigned count = min(aligned_size, sizeof(tmpdata));
 		memcpy(tmpdata, pfrom, count);
 		uint32_t written = flashmem_write_internal(tmpdata, toaddr, count);
-		remain -= written;
 		if(written != count)
 			return size - remain;
+		aligned_size -= count;
+		remain -= count;
 		toaddr += count;
 		pfrom += count;
 	}
@@ -114,12 +148,8 @@ uint32_t flashmem_write(const void* from, uint32_t toaddr, uint32_t size)
 	{
 		if(flashmem_read_internal(tmpdata, toaddr, blksize) != blksize)
 			return size - remain;
-		unsigned i;
-		for(i = 0; i < rest; ++i)
-			tmpdata[i] = *pfrom++;
-		uint32_t written = flashmem_write_internal(tmpdata, toaddr, blksize);
-		remain -= written;
-		if(written != blksize)
+		memcpy(tmpdata, pfrom, rest);
+		if(flashmem_write_internal(tmpdata, toaddr, blksize) != blksize)
 			return size - remain;
 	}
 
@@ -145,12 +175,10 @@ uint32_t flashmem_read(void* to, uint32_t fromaddr, uint32_t size)
 		uint32_t addr_aligned = fromaddr & ~blkmask; // this is the actual aligned address
 		if (flashmem_read_internal(tmpdata, addr_aligned, blksize) != blksize)
 			return 0;
-		// memcpy(pto, &tmpdata[rest], std::min(blksize - rest, remain))
-		while(remain && rest < blksize)
-		{
-			*pto++ = tmpdata[rest++];
-			--remain;
-		}
+		uint32_t count = min(blksize - rest, remain);
+		memcpy(pto, &tmpdata[rest], count);
+		pto += count;
+		remain -= count;
 		if (remain == 0)
 			return size;
 		fromaddr = addr_aligned + blksize;
@@ -159,16 +187,30 @@ uint32_t flashmem_read(void* to, uint32_t fromaddr, uint32_t size)
 	// The start address is now a multiple of blksize
 	// Compute how many bytes we can read as multiples of blksize
 	uint32_t rest = remain & blkmask;
-	remain &= ~blkmask;
-	// Read the blocks now
-	while(remain)
+	uint32_t aligned_size = remain & ~blkmask;
+
+	if(aligned_size != 0 && IS_ALIGNED(pto))
+	{
+		// Destination is also aligned, so read the whole span in place
+		uint32_t read = flashmem_read_internal(pto, fromaddr, aligned_size);
+		if(read != aligned_size)
+			return size - remain;
+		remain -= aligned_size;
+		fromaddr += aligned_size;
+		pto += aligned_size;
+		aligned_size = 0;
+	}
+
+	// Read the blocks through the bounce buffer
+	while(aligned_size)
 	{
-		unsigned count = min(remain, sizeof(tmpdata));
+		unsigned count = min(aligned_size, sizeof(tmpdata));
 		uint32_t read = flashmem_read_internal(tmpdata, fromaddr, count);
-		memcpy(pto, tmpdata, read);
-		remain -= read;
 		if(read != count)
 			return size - remain;
+		memcpy(pto, tmpdata, count);
+		aligned_size -= count;
+		remain -= count;
 		fromaddr += count;
 		pto += count;
 	}
@@ -178,9 +220,7 @@ uint32_t flashmem_read(void* to, uint32_t fromaddr, uint32_t size)
 	{
 		if(flashmem_read_internal(tmpdata, fromaddr, blksize) != blksize)
 			return size - remain;
-		unsigned i;
-		for(i = 0; i < rest; ++i)
-			*pto++ = tmpdata[i];
+		memcpy(pto, tmpdata, rest);
 	}
 
 	return size;
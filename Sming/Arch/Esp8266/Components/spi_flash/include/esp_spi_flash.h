@@ -84,6 +84,21 @@ typedef struct {
  */
 uint32_t flashmem_get_address(const void* memptr);
 
+/** @brief Obtain a pointer for reading flash memory directly via the cache
+ *  @param addr Flash location
+ *  @param size Number of bytes to be accessed
+ *  @retval const void* nullptr if the region cannot be mapped
+ *  @note Release the mapping using `flashmem_unmap()` when finished.
+ *  Only the 1MB bank containing the running firmware is mapped.
+ *  Mapped flash must be read using aligned 32-bit accesses, e.g. via `memcpy_P`.
+ */
+const void* flashmem_map(uint32_t addr, uint32_t size);
+
+/** @brief Release a mapping obtained via `flashmem_map()`
+ *  @param ptr
+ */
+void flashmem_unmap(const void* ptr);
+
 /** @brief Write a block of data to flash
  *  @param from Buffer to obtain data from
  *  @param toaddr Flash location to start writing
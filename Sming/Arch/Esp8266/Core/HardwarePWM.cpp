@@ -118,6 +118,29 @@ void HardwarePWM::update()
 	pwm_start();
 }
 
+bool HardwarePWM::apply(const Batch& batch)
+{
+	// Phase table is only rebuilt by pwm_start(), then swapped in by the ISR at the start of the next period
+	uint32_t period = (batch.period == 0) ? pwm_get_period() : batch.period;
+	uint32_t max = PERIOD_TO_MAX_DUTY(period);
+	for(unsigned i = 0; i < channel_count; ++i) {
+		if(batch.duty[i] > max) {
+			debug_e("Duty cycle value too high for period. max duty is %u.", max);
+			return false;
+		}
+	}
+
+	if(batch.period != 0) {
+		pwm_set_period(period);
+		maxduty = max;
+	}
+	for(unsigned i = 0; i < channel_count; ++i) {
+		pwm_set_duty(batch.duty[i], i);
+	}
+	update();
+	return true;
+}
+
 uint32_t HardwarePWM::getFrequency(uint8_t pin)
 {
 	(void)pin;
@@ -0,0 +1,60 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * gpio_arch.h - Direct GPIO register access for Esp8266
+ *
+ * See Sming/Core/FastGpio.h
+ *
+ * GPIO16 is in the RTC domain and is not supported.
+ *
+ ****/
+
+#pragma once
+
+#include <esp_attr.h>
+#include <sming_attr.h>
+#include <espinc/eagle_soc.h>
+#include <espinc/gpio_register.h>
+
+namespace FastGpio
+{
+constexpr unsigned maxPins{16};
+
+template <unsigned bank> struct Port;
+
+template <> struct Port<0> {
+	__forceinline static void IRAM_ATTR set(uint32_t mask)
+	{
+		GPIO_REG_WRITE(GPIO_OUT_W1TS_ADDRESS, mask);
+	}
+
+	__forceinline static void IRAM_ATTR clear(uint32_t mask)
+	{
+		GPIO_REG_WRITE(GPIO_OUT_W1TC_ADDRESS, mask);
+	}
+
+	__forceinline static uint32_t IRAM_ATTR read(uint32_t mask)
+	{
+		return GPIO_REG_READ(GPIO_IN_ADDRESS) & mask;
+	}
+
+	__forceinline static uint32_t IRAM_ATTR readOutput()
+	{
+		return GPIO_REG_READ(GPIO_OUT_ADDRESS);
+	}
+
+	__forceinline static void IRAM_ATTR enableOutput(uint32_t mask)
+	{
+		GPIO_REG_WRITE(GPIO_ENABLE_W1TS_ADDRESS, mask);
+	}
+
+	__forceinline static void IRAM_ATTR disableOutput(uint32_t mask)
+	{
+		GPIO_REG_WRITE(GPIO_ENABLE_W1TC_ADDRESS, mask);
+	}
+};
+
+} // namespace FastGpio
@@ -27,7 +27,17 @@ struct RtcData {
 };
 
 static bool hardwareReset;
-static bool saveTime(RtcData& data);
+static bool RtcClass::readMemory(uint8_t block, void* data, uint16_t size)
+{
+	return block >= RTC_MEMORY_BLOCK_START && system_rtc_mem_read(block, data, size);
+}
+
+bool RtcClass::writeMemory(uint8_t block, const void* data, uint16_t size)
+{
+	return block >= RTC_MEMORY_BLOCK_START && system_rtc_mem_write(block, data, size);
+}
+
+bool saveTime(RtcData& data);
 static void updateTime(RtcData& data);
 static void loadTime(RtcData& data);
 
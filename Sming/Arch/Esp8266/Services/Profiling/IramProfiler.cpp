@@ -0,0 +1,144 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * IramProfiler.cpp
+ *
+ * Everything here which runs from the instrumentation hooks must be in IRAM and must
+ * not call any other function: inlined code is instrumented as well, so would recurse.
+ *
+ */
+
+#include <Services/Profiling/IramProfiler.h>
+#include <esp_systemapi.h>
+
+#define NOINSTR __attribute__((no_instrument_function))
+
+namespace Profiling
+{
+#ifdef ENABLE_IRAM_PROFILE
+
+namespace
+{
+static_assert((IRAM_PROFILE_SLOTS & (IRAM_PROFILE_SLOTS - 1)) == 0, "IRAM_PROFILE_SLOTS must be a power of 2");
+
+// Only code executing from flash is of interest
+constexpr uint32_t flashStart{0x40200000};
+constexpr uint32_t flashEnd{0x40300000};
+
+struct Slot {
+	uint32_t addr;
+	uint32_t count;
+};
+
+Slot slots[IRAM_PROFILE_SLOTS];
+volatile uint32_t overflowCount;
+bool reentry;
+
+} // namespace
+
+extern "C" {
+void __cyg_profile_func_enter(void* this_fn, void* call_site) IRAM_ATTR NOINSTR;
+void __cyg_profile_func_exit(void* this_fn, void* call_site) IRAM_ATTR NOINSTR;
+}
+
+void IRAM_ATTR __cyg_profile_func_enter(void* this_fn, void*)
+{
+	auto addr = uint32_t(this_fn);
+	if(addr < flashStart || addr >= flashEnd) {
+		return;
+	}
+
+	// Interrupts may call instrumented code, so guard the table.
+	// Not noInterrupts() as that may be instrumented (ENABLE_IRQ_LATENCY).
+	uint32_t level = XTOS_SET_INTLEVEL(15);
+
+	if(!reentry) {
+		reentry = true;
+		// Functions are at least 4-byte aligned
+		unsigned index = (addr >> 2) * 2654435761U;
+		unsigned probes;
+		for(probes = 0; probes < IRAM_PROFILE_SLOTS; ++probes) {
+			index &= IRAM_PROFILE_SLOTS - 1;
+			auto& slot = slots[index];
+			if(slot.addr == addr) {
+				++slot.count;
+				break;
+			}
+			if(slot.addr == 0) {
+				slot.addr = addr;
+				slot.count = 1;
+				break;
+			}
+			++index;
+		}
+		if(probes == IRAM_PROFILE_SLOTS) {
+			++overflowCount;
+		}
+		reentry = false;
+	}
+
+	XTOS_RESTORE_INTLEVEL(level);
+}
+
+void IRAM_ATTR __cyg_profile_func_exit(void*, void*)
+{
+}
+
+size_t NOINSTR IramProfiler::dump(Print& out)
+{
+	unsigned used{0};
+	for(auto& slot : slots) {
+		if(slot.addr != 0) {
+			++used;
+		}
+	}
+
+	out.printf("# iram-profile %u %u\r\n", used, getOverflowCount());
+
+	size_t count{0};
+	for(unsigned i = 0; i < IRAM_PROFILE_SLOTS; ++i) {
+		// Copy as printing updates counts
+		Slot slot = slots[i];
+		if(slot.addr != 0) {
+			out.printf("%08x %u\r\n", slot.addr, slot.count);
+			++count;
+		}
+	}
+	return count;
+}
+
+void NOINSTR IramProfiler::reset()
+{
+	auto level = noInterrupts();
+	memset(slots, 0, sizeof(slots));
+	overflowCount = 0;
+	restoreInterrupts(level);
+}
+
+uint32_t NOINSTR IramProfiler::getOverflowCount()
+{
+	return overflowCount;
+}
+
+#else
+
+size_t IramProfiler::dump(Print&)
+{
+	return 0;
+}
+
+void IramProfiler::reset()
+{
+}
+
+uint32_t IramProfiler::getOverflowCount()
+{
+	return 0;
+}
+
+#endif // ENABLE_IRAM_PROFILE
+
+} // namespace Profiling
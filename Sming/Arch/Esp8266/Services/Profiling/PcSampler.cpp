@@ -0,0 +1,106 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * PcSampler.cpp
+ *
+ ****/
+
+#include <Services/Profiling/PcSampler.h>
+#include <HardwareTimer.h>
+
+namespace Profiling
+{
+namespace
+{
+static_assert((PC_SAMPLER_BUFFER_SIZE & (PC_SAMPLER_BUFFER_SIZE - 1)) == 0,
+			  "PC_SAMPLER_BUFFER_SIZE must be a power of 2");
+
+constexpr unsigned indexMask{PC_SAMPLER_BUFFER_SIZE - 1};
+
+HardwareTimer* timer;
+unsigned interval;
+uint32_t buffer[PC_SAMPLER_BUFFER_SIZE];
+// Written only by the NMI
+volatile unsigned head;
+volatile uint32_t sampleCount;
+volatile uint32_t droppedCount;
+// Written only by dump()
+volatile unsigned tail;
+
+void IRAM_ATTR sample(void*)
+{
+	// NMI is level 3 so EPC3 holds the interrupted program counter
+	uint32_t pc;
+	__asm__ volatile("rsr %0, epc3" : "=a"(pc));
+
+	++sampleCount;
+	unsigned next = (head + 1) & indexMask;
+	if(next == tail) {
+		++droppedCount;
+		return;
+	}
+	buffer[head] = pc;
+	head = next;
+}
+
+} // namespace
+
+bool PcSampler::start(unsigned intervalUs)
+{
+	if(timer != nullptr || intervalUs < MIN_HW_TIMER1_INTERVAL_US) {
+		return false;
+	}
+
+	head = tail = 0;
+	sampleCount = droppedCount = 0;
+	interval = intervalUs;
+	timer = new HardwareTimer;
+	if(!timer->setIntervalUs(intervalUs)) {
+		stop();
+		return false;
+	}
+	timer->setCallback(sample);
+	timer->start();
+	return true;
+}
+
+void PcSampler::stop()
+{
+	delete timer;
+	timer = nullptr;
+}
+
+bool PcSampler::isRunning()
+{
+	return timer != nullptr;
+}
+
+size_t PcSampler::dump(Print& out)
+{
+	out.printf("# pc-sampler %u %u %u\r\n", interval, sampleCount, droppedCount);
+
+	size_t count{0};
+	unsigned end = head;
+	while(tail != end) {
+		out.printf("%08x", buffer[tail]);
+		tail = (tail + 1) & indexMask;
+		++count;
+		out.print((count % 8) == 0 || tail == end ? "\r\n" : " ");
+	}
+	return count;
+}
+
+uint32_t PcSampler::getSampleCount()
+{
+	return sampleCount;
+}
+
+uint32_t PcSampler::getDroppedCount()
+{
+	return droppedCount;
+}
+
+} // namespace Profiling
@@ -25,8 +25,7 @@ TaskStat::~TaskStat()
 
 bool TaskStat::update()
 {
-	out.println("[TaskStat] Not Implemented");
-	return false;
+	return printQueueStats();
 }
 
 } // namespace Profiling
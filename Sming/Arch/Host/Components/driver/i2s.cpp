@@ -4,68 +4,459 @@
  * http://github.com/SmingHub/Sming
  * All files of the Sming Core are provided under the LGPL v3 license.
  *
- * i2s.cpp - Hardware I2S driver stub
+ * i2s.cpp - Emulated I2S driver
+ *
+ * A timer stands in for DMA, consuming TX buffers and producing RX buffers at the configured
+ * sample rate. Buffer management follows the Esp8266 driver so applications behave the same.
+ * With loopback enabled, transmitted data is copied into RX buffers; otherwise RX buffers
+ * contain silence.
  *
  ****/
 
 #include <driver/i2s.h>
+#include <driver/os_timer.h>
+#include <esp_system.h>
+#include <FakePgmSpace.h>
+#include <algorithm>
+#include <memory>
+#include <cstring>
+#include <climits>
 
-bool i2s_driver_install(const i2s_config_t* config)
+namespace
 {
+struct i2s_state_t {
+	std::unique_ptr<uint8_t[]> buffers;
+	uint8_t buffers_used{0};
+	uint8_t buffer_index{0};
+	uint16_t buffer_pos{0};
+	uint16_t buffer_size{0};
+	uint8_t buffer_count{0};
+	uint8_t callback_threshold{0};
+	uint8_t dma_index{0};	 ///< Buffer being transferred by emulated DMA
+	uint16_t dma_samples{0}; ///< Samples per buffer
+	uint32_t dma_due{0};	 ///< system_get_time() value when current DMA buffer completes
+
+	bool initialise(const i2s_module_config_t& config);
+
+	uint8_t* buffer(unsigned index)
+	{
+		return &buffers[index * buffer_size];
+	}
+
+	size_t user_size()
+	{
+		return (buffer_count - 1) * buffer_size;
+	}
+
+	size_t tx_used()
+	{
+		return (buffers_used * buffer_size) + buffer_pos;
+	}
+
+	size_t rx_available()
+	{
+		return (buffers_used * buffer_size) - buffer_pos;
+	}
+
+	bool tx_done(bool auto_clear);
+	bool rx_done();
+
+	bool dma_write(i2s_buffer_info_t& info, size_t max_bytes);
+	bool dma_read(i2s_buffer_info_t& info, size_t max_bytes);
+};
+
+struct i2s_object_t {
+	i2s_state_t* tx_state{nullptr};
+	i2s_state_t* rx_state{nullptr};
+	i2s_callback_t callback{nullptr};
+	i2s_buffer_callback_t tx_buffer_callback{nullptr};
+	i2s_buffer_callback_t rx_buffer_callback{nullptr};
+	void* param{nullptr};
+	uint32_t sample_rate{0};
+	bool tx_desc_auto_clear{false};
+	bool loopback{false};
+	bool running{false};
+	os_timer_t timer;
+
+	~i2s_object_t();
+
+	bool initialise(const i2s_config_t& config);
+	void start();
+	void stop();
+	void service();
+	void set_timing(i2s_state_t* state, uint32_t now);
+};
+
+i2s_object_t* i2s_obj;
+
+bool tx_enabled()
+{
+	return i2s_obj != nullptr && i2s_obj->tx_state != nullptr;
+}
+
+bool rx_enabled()
+{
+	return i2s_obj != nullptr && i2s_obj->rx_state != nullptr;
+}
+
+bool i2s_state_t::initialise(const i2s_module_config_t& config)
+{
+	uint8_t bytes_per_sample = config.bits_per_sample / 8;
+	uint8_t channel_num = (config.channel_format < I2S_CHANNEL_FMT_ONLY_RIGHT) ? 2 : 1;
+	uint8_t sample_size = bytes_per_sample * channel_num;
+	buffer_size = ALIGNUP4(config.dma_buf_len * sample_size);
+	buffer_count = config.dma_buf_count;
+	if(buffer_count < 2 || buffer_size == 0 || buffer_size > 4092) {
+		return false;
+	}
+	dma_samples = config.dma_buf_len;
+	callback_threshold = config.callback_threshold;
+	buffers.reset(new uint8_t[buffer_count * buffer_size]{});
 	return true;
 }
 
+bool i2s_state_t::tx_done(bool auto_clear)
+{
+	if(auto_clear) {
+		memset(buffer(dma_index), 0, buffer_size);
+	}
+	if(buffers_used == 0) {
+		// Underflow
+		buffer_index = dma_index;
+	} else {
+		--buffers_used;
+	}
+	dma_index = (dma_index + 1) % buffer_count;
+
+	return (buffer_count - buffers_used) > callback_threshold;
+}
+
+bool i2s_state_t::rx_done()
+{
+	dma_index = (dma_index + 1) % buffer_count;
+	if(buffers_used < (buffer_count - 1)) {
+		++buffers_used;
+	}
+
+	return buffers_used > callback_threshold;
+}
+
+bool i2s_state_t::dma_write(i2s_buffer_info_t& info, size_t max_bytes)
+{
+	if(buffer_pos >= buffer_size) {
+		if(buffers_used >= (buffer_count - 1)) {
+			return false;
+		}
+		buffer_index = (buffer_index + 1) % buffer_count;
+		++buffers_used;
+		buffer_pos = 0;
+	}
+
+	info.buf = buffer_index;
+	info.pos = buffer_pos;
+	info.buffer = buffer(buffer_index) + buffer_pos;
+	info.size = std::min(size_t(buffer_size - buffer_pos), max_bytes);
+	buffer_pos += info.size;
+	return true;
+}
+
+bool i2s_state_t::dma_read(i2s_buffer_info_t& info, size_t max_bytes)
+{
+	if(buffer_pos == buffer_size) {
+		if(buffers_used == 0) {
+			return false;
+		}
+		buffer_index = (buffer_index + 1) % buffer_count;
+		--buffers_used;
+		buffer_pos = 0;
+	}
+
+	info.buf = buffer_index;
+	info.pos = buffer_pos;
+	info.buffer = buffer(buffer_index) + buffer_pos;
+	info.size = std::min(size_t(buffer_size - buffer_pos), max_bytes);
+	buffer_pos += info.size;
+	return true;
+}
+
+i2s_state_t* alloc_state(const i2s_module_config_t& config)
+{
+	auto state = new i2s_state_t;
+	if(!state->initialise(config)) {
+		delete state;
+		return nullptr;
+	}
+	return state;
+}
+
+bool i2s_object_t::initialise(const i2s_config_t& config)
+{
+	callback = config.callback;
+	tx_buffer_callback = config.tx_buffer_callback;
+	rx_buffer_callback = config.rx_buffer_callback;
+	param = config.param;
+	tx_desc_auto_clear = config.tx_desc_auto_clear;
+	sample_rate = config.sample_rate;
+	if(sample_rate == 0) {
+		return false;
+	}
+
+	if(config.tx.mode != I2S_MODE_DISABLED) {
+		tx_state = alloc_state(config.tx);
+		if(tx_state == nullptr) {
+			return false;
+		}
+	}
+
+	if(config.rx.mode != I2S_MODE_DISABLED) {
+		rx_state = alloc_state(config.rx);
+		if(rx_state == nullptr) {
+			return false;
+		}
+		// First read must wait for a completed buffer
+		rx_state->buffer_index = rx_state->buffer_count - 1;
+		rx_state->buffer_pos = rx_state->buffer_size;
+	}
+
+	os_timer_setfn(
+		&timer, [](void* arg) { static_cast<i2s_object_t*>(arg)->service(); }, this);
+
+	if(config.auto_start) {
+		start();
+	}
+
+	return true;
+}
+
+i2s_object_t::~i2s_object_t()
+{
+	stop();
+	delete tx_state;
+	delete rx_state;
+}
+
+void i2s_object_t::set_timing(i2s_state_t* state, uint32_t now)
+{
+	if(state != nullptr) {
+		state->dma_due = now + uint64_t(state->dma_samples) * 1000000U / sample_rate;
+	}
+}
+
+void i2s_object_t::start()
+{
+	if(running) {
+		return;
+	}
+
+	auto now = system_get_time();
+	set_timing(tx_state, now);
+	set_timing(rx_state, now);
+
+	// Poll often enough for the shorter of the two buffer periods
+	unsigned samples = UINT16_MAX;
+	for(auto state : {tx_state, rx_state}) {
+		if(state != nullptr) {
+			samples = std::min(samples, unsigned(state->dma_samples));
+		}
+	}
+	auto interval = std::max(uint64_t(samples) * 1000000U / sample_rate / 2, uint64_t(100));
+	os_timer_arm_us(&timer, interval, true);
+	running = true;
+}
+
+void i2s_object_t::stop()
+{
+	if(running) {
+		os_timer_disarm(&timer);
+		running = false;
+	}
+}
+
+void i2s_object_t::service()
+{
+	auto now = system_get_time();
+	bool tx_event{false};
+	bool rx_event{false};
+
+	auto due = [now](i2s_state_t* state) { return state != nullptr && int32_t(now - state->dma_due) >= 0; };
+	auto advance = [this](i2s_state_t* state) {
+		state->dma_due += uint64_t(state->dma_samples) * 1000000U / sample_rate;
+	};
+
+	while(due(tx_state) || due(rx_state)) {
+		if(due(tx_state)) {
+			if(loopback && rx_state != nullptr) {
+				auto len = std::min(tx_state->buffer_size, rx_state->buffer_size);
+				memcpy(rx_state->buffer(rx_state->dma_index), tx_state->buffer(tx_state->dma_index), len);
+			}
+			tx_event |= tx_state->tx_done(tx_desc_auto_clear);
+			advance(tx_state);
+		}
+		if(due(rx_state)) {
+			if(!loopback) {
+				memset(rx_state->buffer(rx_state->dma_index), 0, rx_state->buffer_size);
+			}
+			rx_event |= rx_state->rx_done();
+			advance(rx_state);
+		}
+
+		if(tx_event) {
+			if(tx_buffer_callback != nullptr) {
+				i2s_service_buffers(tx_buffer_callback, nullptr, param);
+			}
+			if(callback != nullptr) {
+				callback(param, I2S_EVENT_TX_DONE);
+			}
+			tx_event = false;
+			// Callbacks may stop or uninstall the driver
+			if(i2s_obj != this || !running) {
+				return;
+			}
+		}
+		if(rx_event) {
+			if(rx_buffer_callback != nullptr) {
+				i2s_service_buffers(nullptr, rx_buffer_callback, param);
+			}
+			if(callback != nullptr) {
+				callback(param, I2S_EVENT_RX_DONE);
+			}
+			rx_event = false;
+			if(i2s_obj != this || !running) {
+				return;
+			}
+		}
+	}
+}
+
+} // namespace
+
+bool i2s_driver_install(const i2s_config_t* config)
+{
+	if(i2s_obj != nullptr || config == nullptr) {
+		return false;
+	}
+
+	i2s_obj = new i2s_object_t;
+	if(!i2s_obj->initialise(*config)) {
+		delete i2s_obj;
+		i2s_obj = nullptr;
+	}
+
+	return i2s_obj != nullptr;
+}
+
 void i2s_driver_uninstall()
 {
+	delete i2s_obj;
+	i2s_obj = nullptr;
 }
 
 bool i2s_start()
 {
+	if(i2s_obj == nullptr) {
+		return false;
+	}
+
+	i2s_obj->start();
 	return true;
 }
 
 bool i2s_stop()
 {
-	return false;
+	if(i2s_obj == nullptr) {
+		return false;
+	}
+
+	i2s_obj->stop();
+	return true;
 }
 
 bool i2s_set_sample_rates(uint32_t rate)
 {
+	if(i2s_obj == nullptr || rate == 0) {
+		return false;
+	}
+
+	i2s_obj->sample_rate = rate;
 	return true;
 }
 
 bool i2s_set_dividers(uint8_t bck_div, uint8_t mclk_div)
 {
-	return true;
+	return bck_div != 0 && mclk_div != 0;
 }
 
 float i2s_get_real_rate()
 {
-	return 0.0;
+	return (i2s_obj == nullptr) ? 0.0 : i2s_obj->sample_rate;
 }
 
 bool i2s_dma_read(i2s_buffer_info_t* info, size_t max_bytes)
 {
-	return false;
+	if(info == nullptr || !rx_enabled()) {
+		return false;
+	}
+
+	return i2s_obj->rx_state->dma_read(*info, max_bytes);
 }
 
 bool i2s_dma_write(i2s_buffer_info_t* info, size_t max_bytes)
 {
-	return false;
+	if(info == nullptr || !tx_enabled()) {
+		return false;
+	}
+
+	return i2s_obj->tx_state->dma_write(*info, max_bytes);
 }
 
 size_t i2s_write(const void* src, size_t size, TickType_t ticks_to_wait)
 {
-	return 0;
+	if(src == nullptr || !tx_enabled()) {
+		return 0;
+	}
+
+	// There is no concurrent DMA so waiting would never free a buffer
+	(void)ticks_to_wait;
+	size_t count = 0;
+	auto buf = static_cast<const uint8_t*>(src);
+	i2s_buffer_info_t info;
+	while(count < size && i2s_obj->tx_state->dma_write(info, size - count)) {
+		memcpy(info.buffer, buf + count, info.size);
+		count += info.size;
+	}
+
+	return count;
 }
 
 size_t i2s_read(void* dest, size_t size, TickType_t ticks_to_wait)
 {
-	return 0;
+	if(dest == nullptr || !rx_enabled()) {
+		return 0;
+	}
+
+	(void)ticks_to_wait;
+	size_t count = 0;
+	auto buf = static_cast<uint8_t*>(dest);
+	i2s_buffer_info_t info;
+	while(count < size && i2s_obj->rx_state->dma_read(info, size - count)) {
+		memcpy(buf + count, info.buffer, info.size);
+		count += info.size;
+	}
+
+	return count;
 }
 
 bool i2s_zero_dma_buffer()
 {
+	if(!tx_enabled()) {
+		return false;
+	}
+
+	i2s_buffer_info_t info;
+	while(i2s_obj->tx_state->dma_write(info, UINT_MAX)) {
+		memset(info.buffer, 0, info.size);
+	}
+
 	return true;
 }
 
@@ -75,15 +466,32 @@ void i2s_set_pins(i2s_pin_set_t pins, bool enable)
 
 bool i2s_enable_loopback(bool enable)
 {
-	return false;
+	if(i2s_obj == nullptr) {
+		return false;
+	}
+
+	i2s_obj->loopback = enable;
+	return true;
 }
 
 bool i2s_stat_tx(i2s_buffer_stat_t* stat)
 {
-	return false;
+	if(!tx_enabled() || stat == nullptr) {
+		return false;
+	}
+
+	stat->size = i2s_obj->tx_state->user_size();
+	stat->used = i2s_obj->tx_state->tx_used();
+	return true;
 }
 
 bool i2s_stat_rx(i2s_buffer_stat_t* stat)
 {
-	return false;
+	if(!rx_enabled() || stat == nullptr) {
+		return false;
+	}
+
+	stat->size = i2s_obj->rx_state->user_size();
+	stat->used = i2s_obj->rx_state->rx_available();
+	return true;
 }
@@ -66,6 +66,13 @@ void os_timer_done(os_timer_t* ptimer);
  */
 int host_service_timers();
 
+/**
+ * @brief Get expiry time of the next queued timer
+ * @param expire On success, the Timer2 count value when it will expire
+ * @retval bool false if no timers are queued
+ */
+bool os_timer_next_expiry(uint32_t* expire);
+
 #ifdef __cplusplus
 }
 #endif
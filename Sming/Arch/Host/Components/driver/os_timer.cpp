@@ -1,5 +1,6 @@
 #include <driver/os_timer.h>
 #include <hostlib/threads.h>
+#include <hostlib/profiler.h>
 #include <driver/hw_timer.h>
 #include <muldiv.h>
 #include <cassert>
@@ -101,6 +102,17 @@ void os_timer_setfn(struct os_timer_t* ptimer, os_timer_func_t* pfunction, void*
 	ptimer->timer_arg = parg;
 }
 
+bool os_timer_next_expiry(uint32_t* expire)
+{
+	mutex.lock();
+	auto t = timer_list;
+	if(t != nullptr) {
+		*expire = t->timer_expire;
+	}
+	mutex.unlock();
+	return t != nullptr;
+}
+
 void os_timer_done(struct os_timer_t* ptimer)
 {
 	os_timer_disarm(ptimer);
@@ -132,6 +144,7 @@ int host_service_timers()
 	mutex.unlock();
 
 	if(t->timer_func != nullptr) {
+		HostProfileScope scope(host_profile_timer, reinterpret_cast<const void*>(t->timer_func));
 		t->timer_func(t->timer_arg);
 	}
 
@@ -129,6 +129,30 @@ size_t smg_uart_read(smg_uart_t* uart, void* buffer, size_t size)
 	return read;
 }
 
+size_t smg_uart_rx_peek_region(smg_uart_t* uart, const void*& data)
+{
+	data = nullptr;
+	if(!smg_uart_rx_enabled(uart) || uart->rx_buffer == nullptr) {
+		return 0;
+	}
+
+	notify(uart, UART_NOTIFY_BEFORE_READ);
+
+	void* buf;
+	auto len = uart->rx_buffer->getReadData(buf);
+	data = buf;
+	return len;
+}
+
+void smg_uart_rx_consume(smg_uart_t* uart, size_t length)
+{
+	if(!smg_uart_rx_enabled(uart) || uart->rx_buffer == nullptr || length == 0) {
+		return;
+	}
+
+	uart->rx_buffer->skipRead(length);
+}
+
 size_t smg_uart_rx_available(smg_uart_t* uart)
 {
 	if(!smg_uart_rx_enabled(uart)) {
@@ -167,9 +191,7 @@ size_t smg_uart_write(smg_uart_t* uart, const void* buffer, size_t size)
 
 	while(written < size) {
 		if(uart->tx_buffer != nullptr) {
-			while(written < size && uart->tx_buffer->writeChar(buf[written])) {
-				++written;
-			}
+			written += uart->tx_buffer->write(&buf[written], size - written);
 		}
 
 		notify(uart, UART_NOTIFY_AFTER_WRITE);
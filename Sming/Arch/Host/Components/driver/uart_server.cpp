@@ -305,6 +305,9 @@ int CUart::serviceWrite()
 		result += sent;
 	} while((avail = txbuf->getReadData(data)) != 0);
 
+	if(uart->tx_threshold != 0 && txbuf->getFreeSpace() >= uart->tx_threshold) {
+		uart->status |= UART_STATUS_TX_THRESHOLD;
+	}
 	if(txbuf->isEmpty()) {
 		uart->status |= UART_TXFIFO_EMPTY_INT_ST;
 	} else {
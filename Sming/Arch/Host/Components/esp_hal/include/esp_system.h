@@ -51,6 +51,12 @@ uint32_t system_get_time(void);
 /* Use nanosecond count as base for hardware and CPU cycle counting */
 uint64_t os_get_nanoseconds(void);
 
+/* Virtual time support: move system clock forward, e.g. to skip idle periods */
+void os_advance_nanoseconds(uint64_t nanoseconds);
+
+/* Total time by which system clock has been advanced */
+uint64_t os_get_advanced_nanoseconds(void);
+
 #define APB_CLK_FREQ 80000000U
 
 void os_delay_us(uint32_t us);
@@ -3,6 +3,7 @@
 #include <hostlib/threads.h>
 #include <sys/time.h>
 #include <Platform/Timers.h>
+#include <atomic>
 
 /* System time */
 
@@ -34,16 +35,28 @@ static uint64_t initTime()
 
 uint64_t host_system_start_time = initTime();
 
+static std::atomic<uint64_t> advancedNanoseconds;
+
+void os_advance_nanoseconds(uint64_t nanoseconds)
+{
+	advancedNanoseconds += nanoseconds;
+}
+
+uint64_t os_get_advanced_nanoseconds()
+{
+	return advancedNanoseconds;
+}
+
 uint64_t os_get_nanoseconds()
 {
 #ifdef __WIN32
 	LARGE_INTEGER count;
 	QueryPerformanceCounter(&count);
-	return timeref.countsPerNanosecond * uint64_t(count.QuadPart - timeref.startCount.QuadPart);
+	return timeref.countsPerNanosecond * uint64_t(count.QuadPart - timeref.startCount.QuadPart) + advancedNanoseconds;
 #else
 	timespec ts{};
 	clock_gettime(CLOCK_MONOTONIC, &ts);
-	return (1000000000ULL * ts.tv_sec) + ts.tv_nsec - timeref.startTicks;
+	return (1000000000ULL * ts.tv_sec) + ts.tv_nsec - timeref.startTicks + advancedNanoseconds;
 #endif
 }
 
@@ -2,6 +2,7 @@
 #include <hostlib/hostmsg.h>
 #include <stringutil.h>
 #include <hostlib/threads.h>
+#include <hostlib/profiler.h>
 
 namespace
 {
@@ -25,6 +26,11 @@ public:
 		return !full;
 	}
 
+	bool isEmpty() const
+	{
+		return count == 0;
+	}
+
 	void process()
 	{
 		// Don't service any newly queued events
@@ -34,6 +40,9 @@ public:
 			read = (read + 1) % length;
 			--count;
 			mutex.unlock();
+			// Sming and host queues pass the actual callback as the signal
+			HostProfileScope scope(host_profile_task, reinterpret_cast<const void*>(callback),
+								   reinterpret_cast<const void*>(evt.sig));
 			callback(&evt);
 		}
 	}
@@ -114,6 +123,16 @@ void host_service_tasks()
 	}
 }
 
+bool host_tasks_pending()
+{
+	for(auto queue : task_queues) {
+		if(queue != nullptr && !queue->isEmpty()) {
+			return true;
+		}
+	}
+	return false;
+}
+
 bool host_queue_callback(host_task_callback_t callback, uint32_t param)
 {
 	return task_queues[HOST_TASK_PRIO]->post(os_signal_t(callback), param);
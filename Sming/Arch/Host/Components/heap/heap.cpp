@@ -1,5 +1,7 @@
 
 #include "include/heap.h"
+#include <heap_info.h>
+#include <heap_region.h>
 #ifdef ENABLE_MALLOC_COUNT
 #include <malloc_count.h>
 #endif
@@ -16,3 +18,23 @@ uint32_t system_get_free_heap_size(void)
 	return memorySize;
 #endif
 }
+
+bool system_get_heap_info(heap_info_t* info)
+{
+	// Host allocations never fail through fragmentation
+	info->free_size = system_get_free_heap_size();
+	info->largest_free_block = info->free_size;
+	info->free_blocks = 1;
+	info->fragmentation = 0;
+	return false;
+}
+
+void* heap_region_malloc(heap_region_t, size_t size)
+{
+	return malloc(size);
+}
+
+bool heap_region_available(heap_region_t region)
+{
+	return region == HEAP_REGION_DEFAULT;
+}
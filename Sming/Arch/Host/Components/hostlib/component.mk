@@ -23,5 +23,15 @@ COMPONENT_INCDIRS		:= include
 COMPONENT_SRCDIRS		:= .
 COMPONENT_DOXYGEN_INPUT := include/hostlib
 
+# Sampling profiler, see profiler.h
+COMPONENT_VARS			+= ENABLE_HOST_PROFILER
+ifeq ($(ENABLE_HOST_PROFILER),1)
+GLOBAL_CFLAGS			+= -DENABLE_HOST_PROFILER=1
+ifneq ($(UNAME),Windows)
+# Export symbols so samples can be resolved at runtime
+EXTRA_LDFLAGS			+= -rdynamic
+endif
+endif
+
 # Optional command line parameters passed to host application
 CACHE_VARS				+= HOST_PARAMETERS
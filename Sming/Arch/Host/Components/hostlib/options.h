@@ -57,9 +57,15 @@
 	XX(loopcount, required_argument, "Run Sming loop a fixed number of times then exit", nullptr, nullptr,             \
 	   "Useful for running samples in CI\0")                                                                           \
 	XX(nonet, no_argument, "Skip network initialisation", nullptr, nullptr, nullptr)                                   \
+	XX(virtualtime, no_argument, "Advance clock to next timer when idle", nullptr, nullptr,                            \
+	   "Runs timer-driven code faster than real time\0")                                                               \
 	XX(debug, required_argument, "Set debug verbosity", "LEVEL", "Maximum debug message level to print",               \
 	   "0 = errors only, 1 = +warnings, 2 = +info\0")                                                                  \
-	XX(cpulimit, required_argument, "Set CPU limit", "COUNT", "0 = no limit", nullptr)
+	XX(cpulimit, required_argument, "Set CPU limit", "COUNT", "0 = no limit", nullptr)                                 \
+	XX(profile, required_argument, "Write folded stacks for flamegraph", "FILENAME",                                   \
+	   "Requires ENABLE_HOST_PROFILER=1", "e.g. flamegraph.pl out.folded > profile.svg\0")                              \
+	XX(profilerate, required_argument, "Set profiler sample rate", "HZ", "Samples per second of CPU time (default 1000)", \
+	   nullptr)
 
 enum option_tag_t {
 #define XX(tag, has_arg, desc, argname, arghelp, examples) opt_##tag,
@@ -0,0 +1,262 @@
+/**
+ * profiler.cpp
+ *
+ * Copyright 2019 mikee47 <mike@sillyhouse.net>
+ *
+ * This file is part of the Sming Framework Project
+ *
+ * This library is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3 or later.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with SHEM.
+ * If not, see <https://www.gnu.org/licenses/>.
+ *
+ ****/
+
+#ifdef ENABLE_HOST_PROFILER
+
+#include "profiler.h"
+#include <hostlib/hostmsg.h>
+
+volatile host_profile_context_t host_profile_context;
+const void* volatile host_profile_function;
+const void* volatile host_profile_target;
+
+#ifdef __WIN32
+
+bool host_profiler_start(const char*, unsigned)
+{
+	host_debug_e("Profiler not supported on Windows");
+	return false;
+}
+
+void host_profiler_stop()
+{
+}
+
+void host_profiler_service()
+{
+}
+
+#else
+
+#include <atomic>
+#include <map>
+#include <string>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <csignal>
+#include <ctime>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+
+#ifndef sigev_notify_thread_id
+#define sigev_notify_thread_id _sigev_un._tid
+#endif
+
+namespace
+{
+constexpr unsigned maxDepth{64};
+// Handler and trampoline
+constexpr unsigned skipFrames{2};
+// Samples held until the main loop next runs
+constexpr unsigned bufferSize{1024};
+
+const char* contextNames[] = {
+#define XX(tag, desc) #tag,
+	HOST_PROFILE_CONTEXT_MAP(XX)
+#undef XX
+};
+
+struct Sample {
+	host_profile_context_t context;
+	const void* function;
+	const void* target;
+	unsigned depth;
+	void* frames[maxDepth];
+};
+
+Sample samples[bufferSize];
+// head is only written by the signal handler, tail by the main thread
+std::atomic<unsigned> head;
+std::atomic<unsigned> tail;
+volatile unsigned sampleCount;
+volatile unsigned droppedCount;
+
+bool running;
+timer_t timerId;
+std::string outputFilename;
+std::map<std::string, unsigned> stacks;
+
+struct Symbol {
+	std::string name;
+	const void* start;
+};
+std::map<const void*, Symbol> symbols;
+
+void signalHandler(int, siginfo_t*, void*)
+{
+	++sampleCount;
+	auto h = head.load(std::memory_order_relaxed);
+	auto next = (h + 1) % bufferSize;
+	if(next == tail.load(std::memory_order_acquire)) {
+		++droppedCount;
+		return;
+	}
+	auto& sample = samples[h];
+	sample.context = host_profile_context;
+	sample.function = host_profile_function;
+	sample.target = host_profile_target;
+	sample.depth = backtrace(sample.frames, maxDepth);
+	head.store(next, std::memory_order_release);
+}
+
+const Symbol& lookup(const void* addr)
+{
+	auto it = symbols.find(addr);
+	if(it != symbols.end()) {
+		return it->second;
+	}
+
+	Symbol sym{};
+	Dl_info info;
+	bool found = dladdr(addr, &info) != 0;
+	if(found && info.dli_sname != nullptr) {
+		int status;
+		char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+		sym.name = (status == 0) ? demangled : info.dli_sname;
+		free(demangled);
+		sym.start = info.dli_saddr;
+	} else {
+		// Not exported, so give offset into module for use with addr2line
+		char buf[32];
+		auto base = found ? uintptr_t(info.dli_fbase) : 0;
+		snprintf(buf, sizeof(buf), "0x%" PRIxPTR, uintptr_t(addr) - base);
+		sym.name = buf;
+	}
+	// Frames are separated by ';'
+	for(auto& c : sym.name) {
+		if(c == ';') {
+			c = ',';
+		}
+	}
+	return symbols[addr] = sym;
+}
+
+void fold(const Sample& sample)
+{
+	std::string root = "[";
+	root += contextNames[sample.context];
+	const void* function = sample.function;
+	if(sample.target != nullptr && lookup(sample.target).start == sample.target) {
+		function = sample.target;
+	}
+	if(function != nullptr) {
+		root += ' ';
+		root += lookup(function).name;
+	}
+	root += ']';
+
+	// Outermost frame first; return addresses point after the call so step back into it
+	std::string key = root;
+	for(unsigned i = sample.depth; i > skipFrames; --i) {
+		auto addr = static_cast<const char*>(sample.frames[i - 1]);
+		key += ';';
+		key += lookup(i - 1 == skipFrames ? addr : addr - 1).name;
+	}
+	++stacks[key];
+}
+
+} // namespace
+
+bool host_profiler_start(const char* filename, unsigned rate)
+{
+	if(running || rate == 0) {
+		return false;
+	}
+
+	// Ensure backtrace() has loaded its support library before it's used in the signal handler
+	void* frame;
+	backtrace(&frame, 1);
+
+	struct sigaction sa {
+	};
+	sa.sa_sigaction = signalHandler;
+	sa.sa_flags = SA_SIGINFO | SA_RESTART;
+	sigemptyset(&sa.sa_mask);
+	if(sigaction(SIGPROF, &sa, nullptr) != 0) {
+		host_debug_e("sigaction failed");
+		return false;
+	}
+
+	// Only sample the main thread, measuring the CPU time it uses
+	clockid_t clock;
+	pthread_getcpuclockid(pthread_self(), &clock);
+	struct sigevent sev {
+	};
+	sev.sigev_notify = SIGEV_THREAD_ID;
+	sev.sigev_signo = SIGPROF;
+	sev.sigev_notify_thread_id = syscall(SYS_gettid);
+	if(timer_create(clock, &sev, &timerId) != 0) {
+		host_debug_e("timer_create failed");
+		return false;
+	}
+
+	uint64_t ns = 1000000000ULL / rate;
+	struct itimerspec its {
+	};
+	its.it_interval.tv_sec = ns / 1000000000ULL;
+	its.it_interval.tv_nsec = ns % 1000000000ULL;
+	its.it_value = its.it_interval;
+	timer_settime(timerId, 0, &its, nullptr);
+
+	outputFilename = filename;
+	running = true;
+	host_debug_i("Profiling at %u Hz to '%s'", rate, filename);
+	return true;
+}
+
+void host_profiler_service()
+{
+	auto t = tail.load(std::memory_order_relaxed);
+	while(t != head.load(std::memory_order_acquire)) {
+		fold(samples[t]);
+		t = (t + 1) % bufferSize;
+		tail.store(t, std::memory_order_release);
+	}
+}
+
+void host_profiler_stop()
+{
+	if(!running) {
+		return;
+	}
+	timer_delete(timerId);
+	running = false;
+	host_profiler_service();
+
+	auto fp = fopen(outputFilename.c_str(), "w");
+	if(fp == nullptr) {
+		host_debug_e("Failed to create '%s'", outputFilename.c_str());
+		return;
+	}
+	for(auto& stack : stacks) {
+		fprintf(fp, "%s %u\n", stack.first.c_str(), stack.second);
+	}
+	fclose(fp);
+
+	host_debug_i("Profiler wrote %u stacks, %u samples (%u dropped) to '%s'", unsigned(stacks.size()), sampleCount,
+				 droppedCount, outputFilename.c_str());
+}
+
+#endif // __WIN32
+
+#endif // ENABLE_HOST_PROFILER
@@ -0,0 +1,112 @@
+/**
+ * profiler.h - Sampling profiler producing folded stacks for flamegraphs
+ *
+ * Copyright 2019 mikee47 <mike@sillyhouse.net>
+ *
+ * This file is part of the Sming Framework Project
+ *
+ * This library is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3 or later.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with SHEM.
+ * If not, see <https://www.gnu.org/licenses/>.
+ *
+ ****/
+
+#pragma once
+
+/**
+ * @brief What the main thread is doing when a sample is taken
+ */
+#define HOST_PROFILE_CONTEXT_MAP(XX)                                                                                   \
+	XX(main, "Main loop, startup or init()")                                                                           \
+	XX(task, "Task queue callback")                                                                                    \
+	XX(timer, "Software timer callback")                                                                               \
+	XX(io, "File descriptor watch callback")                                                                           \
+	XX(lwip, "LWIP stack servicing")
+
+enum host_profile_context_t {
+#define XX(tag, desc) host_profile_##tag,
+	HOST_PROFILE_CONTEXT_MAP(XX)
+#undef XX
+};
+
+#ifdef ENABLE_HOST_PROFILER
+
+/**
+ * @brief Start sampling the main thread
+ * @param filename Folded stacks are written here by `host_profiler_stop()`
+ * @param rate Samples per second of CPU time
+ * @retval bool
+ */
+bool host_profiler_start(const char* filename, unsigned rate);
+
+/**
+ * @brief Stop sampling and write results
+ */
+void host_profiler_stop();
+
+/**
+ * @brief Move samples out of the signal buffer, called from main loop
+ */
+void host_profiler_service();
+
+extern volatile host_profile_context_t host_profile_context;
+extern const void* volatile host_profile_function;
+extern const void* volatile host_profile_target;
+
+/**
+ * @brief Attribute samples taken within this scope to a callback
+ *
+ * Scopes may be nested, e.g. LWIP servicing from a timer callback.
+ *
+ * Dispatchers which pass the real callback as a parameter, such as task queues, provide it as `target`.
+ * This is used in preference to `function` if it's the start address of a known function.
+ */
+class HostProfileScope
+{
+public:
+	HostProfileScope(host_profile_context_t context, const void* function, const void* target = nullptr)
+		: prevContext(host_profile_context), prevFunction(host_profile_function), prevTarget(host_profile_target)
+	{
+		host_profile_function = function;
+		host_profile_target = target;
+		host_profile_context = context;
+	}
+
+	~HostProfileScope()
+	{
+		host_profile_context = prevContext;
+		host_profile_function = prevFunction;
+		host_profile_target = prevTarget;
+	}
+
+private:
+	host_profile_context_t prevContext;
+	const void* prevFunction;
+	const void* prevTarget;
+};
+
+#else
+
+static inline void host_profiler_stop()
+{
+}
+
+static inline void host_profiler_service()
+{
+}
+
+class HostProfileScope
+{
+public:
+	HostProfileScope(host_profile_context_t, const void*, const void* = nullptr)
+	{
+	}
+};
+
+#endif
@@ -24,6 +24,7 @@
 #include "threads.h"
 #include "except.h"
 #include "options.h"
+#include "profiler.h"
 #include <host_rboot.h>
 #include <spi_flash/flashmem.h>
 #include <driver/uart_server.h>
@@ -31,6 +32,7 @@
 #include <driver/os_timer.h>
 #include <driver/hw_timer.h>
 #include <esp_tasks.h>
+#include <esp_system.h>
 #include <stdlib.h>
 #include "include/hostlib/emu.h"
 #include "include/hostlib/hostlib.h"
@@ -51,6 +53,7 @@ static bool done;
 
 void cleanup()
 {
+	host_profiler_stop();
 	hw_timer_cleanup();
 	host_flashmem_cleanup();
 	UartServer::shutdown();
@@ -114,6 +117,21 @@ static void pause(int secs)
 	}
 }
 
+/*
+ * Virtual time: advance clock so the next timer is due immediately
+ */
+static void skip_to_next_timer()
+{
+	uint32_t expire;
+	if(!os_timer_next_expiry(&expire)) {
+		return;
+	}
+	int ticks = expire - hw_timer2_read();
+	if(ticks > 0) {
+		os_advance_nanoseconds((uint64_t(ticks) * 1000000000ULL + HW_TIMER2_CLK - 1) / HW_TIMER2_CLK);
+	}
+}
+
 /*
  * When there is no work being done we should wait efficiently.
  * Tasks and timers can be set from an interrupt (i.e. hardware thread),
@@ -123,7 +141,9 @@ int host_main_loop()
 {
 	system_soft_wdt_feed();
 	host_service_tasks();
-	return host_service_timers();
+	int due = host_service_timers();
+	host_profiler_service();
+	return due;
 }
 
 int main(int argc, char* argv[])
@@ -135,7 +155,10 @@ int main(int argc, char* argv[])
 		int exitpause{-1};
 		int loopcount{};
 		uint8_t cpulimit{};
+		const char* profile{};
+		unsigned profilerate{1000};
 		bool initonly{};
+		bool virtualtime{};
 		bool enable_network{true};
 		UartServer::Config uart{};
 		FlashmemConfig flash{};
@@ -233,6 +256,10 @@ int main(int argc, char* argv[])
 			config.enable_network = false;
 			break;
 
+		case opt_virtualtime:
+			config.virtualtime = true;
+			break;
+
 		case opt_debug:
 			host_debug_level = atoi(arg);
 			break;
@@ -241,6 +268,18 @@ int main(int argc, char* argv[])
 			config.cpulimit = atoi(arg);
 			break;
 
+		case opt_profile:
+#ifdef ENABLE_HOST_PROFILER
+			config.profile = arg;
+#else
+			host_debug_w("Profiler requires ENABLE_HOST_PROFILER=1");
+#endif
+			break;
+
+		case opt_profilerate:
+			config.profilerate = atoi(arg);
+			break;
+
 		case opt_none:
 			break;
 		}
@@ -288,6 +327,12 @@ int main(int argc, char* argv[])
 
 		System.initialize();
 
+#ifdef ENABLE_HOST_PROFILER
+		if(config.profile != nullptr) {
+			host_profiler_start(config.profile, config.profilerate);
+		}
+#endif
+
 		init();
 
 		while(!done) {
@@ -300,9 +345,20 @@ int main(int argc, char* argv[])
 				}
 			}
 
+			if(config.virtualtime && due >= 0) {
+				// Pick up any pending I/O before deciding we're idle
+				host_thread_wait(0);
+				if(!host_tasks_pending()) {
+					skip_to_next_timer();
+				}
+				continue;
+			}
+
 			host_thread_wait(due);
 		}
 
+		host_profiler_stop();
+
 		host_debug_i(">> Normal Exit <<\n");
 	}
 
@@ -18,10 +18,18 @@
  ****/
 
 #include "threads.h"
+#include "profiler.h"
 #include <cstring>
 #include <cstdarg>
+#include <cerrno>
 #include <signal.h>
 #include <sys/time.h>
+#ifndef __WIN32
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <map>
+#endif
 
 unsigned CThread::interrupt_mask;
 
@@ -42,7 +50,19 @@ HANDLE host_thread_semaphore;
 
 #else
 
-CSemaphore host_thread_semaphore;
+/*
+ * Main thread waits on an epoll set containing an eventfd, used to kick the thread,
+ * plus any file descriptors registered via `host_thread_watch()`.
+ */
+int epollFd{-1};
+int kickFd{-1};
+
+struct FdWatch {
+	host_fd_callback_t callback;
+	void* param;
+};
+std::map<int, FdWatch> fdWatches;
+
 volatile bool mainThreadSignalled;
 timer_t signalTimer;
 int pauseSignal;
@@ -172,6 +192,16 @@ void CThread::startup(unsigned cpulimit)
 	signal(resumeSignal, signal_handler);
 	signal(SIGALRM, signal_handler);
 	timer_create(CLOCK_MONOTONIC, nullptr, &signalTimer);
+
+	epollFd = epoll_create1(EPOLL_CLOEXEC);
+	kickFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	struct epoll_event ev {
+	};
+	ev.events = EPOLLIN;
+	ev.data.fd = kickFd;
+	if(epollFd < 0 || kickFd < 0 || epoll_ctl(epollFd, EPOLL_CTL_ADD, kickFd, &ev) != 0) {
+		host_debug_e("ERROR! Failed to initialise main thread event loop");
+	}
 #endif
 }
 
@@ -237,16 +267,32 @@ void CThread::interrupt_end()
 void host_thread_wait(int ms)
 {
 	constexpr int SCHED_WAIT{2};
+#ifdef __WIN32
 	if(ms >= 0 && ms <= SCHED_WAIT) {
 		return;
 	}
-#ifdef __WIN32
 	WaitForSingleObject(host_thread_semaphore, (ms < 0) ? INFINITE : ms - SCHED_WAIT);
 #else
-	if(ms < 0) {
-		host_thread_semaphore.wait();
-	} else if(ms > SCHED_WAIT) {
-		host_thread_semaphore.timedwait((ms - SCHED_WAIT) * 1000);
+	// Timer due very soon, but still check for pending I/O
+	int timeout = (ms < 0) ? -1 : (ms <= SCHED_WAIT) ? 0 : ms - SCHED_WAIT;
+
+	struct epoll_event events[16];
+	int count = epoll_wait(epollFd, events, ARRAY_SIZE(events), timeout);
+	// count < 0 indicates EINTR, i.e. main thread was interrupted
+	for(int i = 0; i < count; ++i) {
+		int fd = events[i].data.fd;
+		if(fd == kickFd) {
+			eventfd_t value;
+			(void)eventfd_read(kickFd, &value);
+			continue;
+		}
+		// Callbacks may remove watches, so look up each time
+		auto it = fdWatches.find(fd);
+		if(it != fdWatches.end()) {
+			auto watch = it->second;
+			HostProfileScope scope(host_profile_io, reinterpret_cast<const void*>(watch.callback));
+			watch.callback(fd, watch.param);
+		}
 	}
 #endif
 }
@@ -256,6 +302,46 @@ void host_thread_kick()
 #ifdef __WIN32
 	ReleaseSemaphore(host_thread_semaphore, 1, nullptr);
 #else
-	host_thread_semaphore.post();
+	(void)eventfd_write(kickFd, 1);
+#endif
+}
+
+bool host_thread_watch(int fd, host_fd_callback_t callback, void* param)
+{
+#ifdef __WIN32
+	(void)fd;
+	(void)callback;
+	(void)param;
+	return false;
+#else
+	assert(isMainThread());
+	if(fd < 0 || callback == nullptr || epollFd < 0) {
+		return false;
+	}
+
+	struct epoll_event ev {
+	};
+	ev.events = EPOLLIN;
+	ev.data.fd = fd;
+	int op = fdWatches.count(fd) ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+	if(epoll_ctl(epollFd, op, fd, &ev) != 0) {
+		host_debug_e("epoll_ctl(%d): %s", fd, strerror(errno));
+		return false;
+	}
+
+	fdWatches[fd] = FdWatch{callback, param};
+	return true;
+#endif
+}
+
+void host_thread_unwatch(int fd)
+{
+#ifndef __WIN32
+	assert(isMainThread());
+	if(fdWatches.erase(fd) != 0) {
+		epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+	}
+#else
+	(void)fd;
 #endif
 }
@@ -248,3 +248,21 @@ void host_thread_wait(int ms);
  * Cancels wait, e.g. when new event is posted to queue
  */
 void host_thread_kick();
+
+/*
+ * Called from `host_thread_wait()` in main thread context when a watched file descriptor is readable
+ */
+using host_fd_callback_t = void (*)(int fd, void* param);
+
+/*
+ * Have the main loop wake up and invoke a callback when a file descriptor becomes readable.
+ * This avoids having to poll the descriptor.
+ * Call from main thread only.
+ * @retval bool false if not supported (Windows) or the descriptor could not be added
+ */
+bool host_thread_watch(int fd, host_fd_callback_t callback, void* param);
+
+/*
+ * Stop watching a file descriptor. Must be called before it is closed.
+ */
+void host_thread_unwatch(int fd);
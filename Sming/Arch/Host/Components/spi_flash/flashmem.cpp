@@ -226,3 +226,13 @@ uint32_t flashmem_get_address(const void* memptr)
 {
 	return reinterpret_cast<uint32_t>(memptr) | FLASHMEM_REAL_BIT;
 }
+
+const void* flashmem_map(uint32_t, uint32_t)
+{
+	// Flash is file-backed
+	return nullptr;
+}
+
+void flashmem_unmap(const void*)
+{
+}
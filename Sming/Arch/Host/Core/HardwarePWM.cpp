@@ -60,3 +60,8 @@ void HardwarePWM::setPeriod(uint32_t period)
 void HardwarePWM::update()
 {
 }
+
+bool HardwarePWM::apply(const Batch& batch)
+{
+	return false;
+}
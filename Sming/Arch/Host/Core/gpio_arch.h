@@ -0,0 +1,85 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * gpio_arch.h - GPIO port emulation for Host
+ *
+ * See Sming/Core/FastGpio.h
+ *
+ * Operations are passed to the regular digital functions, and hence to any DigitalHooks, one pin at a time.
+ *
+ ****/
+
+#pragma once
+
+#include <Digital.h>
+
+namespace FastGpio
+{
+constexpr unsigned maxPins{17};
+
+template <unsigned bank> struct Port;
+
+template <> struct Port<0> {
+	static void set(uint32_t mask)
+	{
+		write(mask, HIGH);
+	}
+
+	static void clear(uint32_t mask)
+	{
+		write(mask, LOW);
+	}
+
+	static uint32_t read(uint32_t mask)
+	{
+		uint32_t value{0};
+		for(unsigned pin = 0; pin < maxPins; ++pin) {
+			if((mask & BIT(pin)) && digitalRead(pin)) {
+				value |= BIT(pin);
+			}
+		}
+		return value;
+	}
+
+	static uint32_t readOutput()
+	{
+		return outputState;
+	}
+
+	static void enableOutput(uint32_t mask)
+	{
+		setMode(mask, OUTPUT);
+	}
+
+	static void disableOutput(uint32_t mask)
+	{
+		setMode(mask, INPUT);
+	}
+
+private:
+	static void write(uint32_t mask, uint8_t val)
+	{
+		for(unsigned pin = 0; pin < maxPins; ++pin) {
+			if(mask & BIT(pin)) {
+				digitalWrite(pin, val);
+			}
+		}
+		outputState = val ? (outputState | mask) : (outputState & ~mask);
+	}
+
+	static void setMode(uint32_t mask, uint8_t mode)
+	{
+		for(unsigned pin = 0; pin < maxPins; ++pin) {
+			if(mask & BIT(pin)) {
+				pinMode(pin, mode);
+			}
+		}
+	}
+
+	static inline uint32_t outputState{0};
+};
+
+} // namespace FastGpio
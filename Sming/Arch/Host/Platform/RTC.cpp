@@ -10,14 +10,19 @@
 
 #include <Platform/RTC.h>
 
+#include <esp_system.h>
 #include <sys/time.h>
+#include <cstring>
 
 RtcClass RTC;
 
 namespace
 {
 int timeDiff; // Difference between set time and system time
-}
+
+// Emulated, only retained whilst the application is running
+uint32_t rtcMemory[RTC_MEMORY_BLOCK_END - RTC_MEMORY_BLOCK_START];
+} // namespace
 
 RtcClass::RtcClass()
 {
@@ -29,7 +34,7 @@ uint64_t RtcClass::getRtcNanoseconds()
 	};
 	gettimeofday(&tv, nullptr);
 	uint64_t usecs = (tv.tv_sec * 1000000ULL) + (uint32_t)tv.tv_usec;
-	return usecs * 1000;
+	return usecs * 1000 + os_get_advanced_nanoseconds();
 }
 
 uint32_t RtcClass::getRtcSeconds()
@@ -37,7 +42,7 @@ uint32_t RtcClass::getRtcSeconds()
 	struct timeval tv {
 	};
 	gettimeofday(&tv, nullptr);
-	return tv.tv_sec + timeDiff;
+	return tv.tv_sec + os_get_advanced_nanoseconds() / 1000000000ULL + timeDiff;
 }
 
 bool RtcClass::setRtcNanoseconds(uint64_t nanoseconds)
@@ -51,3 +56,21 @@ bool RtcClass::setRtcSeconds(uint32_t seconds)
 	timeDiff = seconds - getRtcSeconds();
 	return true;
 }
+
+bool RtcClass::readMemory(uint8_t block, void* data, uint16_t size)
+{
+	if(block < RTC_MEMORY_BLOCK_START || block + (size + 3) / 4 > RTC_MEMORY_BLOCK_END) {
+		return false;
+	}
+	memcpy(data, &rtcMemory[block - RTC_MEMORY_BLOCK_START], size);
+	return true;
+}
+
+bool RtcClass::writeMemory(uint8_t block, const void* data, uint16_t size)
+{
+	if(block < RTC_MEMORY_BLOCK_START || block + (size + 3) / 4 > RTC_MEMORY_BLOCK_END) {
+		return false;
+	}
+	memcpy(&rtcMemory[block - RTC_MEMORY_BLOCK_START], data, size);
+	return true;
+}
@@ -0,0 +1,39 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * Worker.cpp - Jobs are executed via the task queue
+ *
+ ****/
+
+#include <Platform/Worker.h>
+#include <Platform/System.h>
+
+bool WorkerClass::isParallel()
+{
+	return false;
+}
+
+bool WorkerClass::startWorker()
+{
+	return true;
+}
+
+void WorkerClass::kickWorker()
+{
+	// One job per callback so other tasks get a look in
+	System.queueCallback(
+		[](void*) {
+			if(runNext()) {
+				kickWorker();
+			}
+		},
+		nullptr, TaskPriority::Low);
+}
+
+void WorkerClass::notifyComplete()
+{
+	serviceCompletions();
+}
@@ -0,0 +1,20 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * StackMonitor.cpp
+ *
+ */
+
+#include <Services/Profiling/StackMonitor.h>
+
+namespace Profiling
+{
+bool StackMonitor::getBounds(uintptr_t&, uintptr_t&)
+{
+	return false;
+}
+
+} // namespace Profiling
@@ -55,3 +55,10 @@ static inline uint64_t os_timer_expire(const os_timer_t* ptimer)
 }
 
 void os_timer_done(os_timer_t* ptimer);
+
+/**
+ * @brief Get expiry time of the next timer due
+ * @param expire On success, receives the Timer2 count value
+ * @retval bool false if no timers are armed
+ */
+bool os_timer_next_expiry(uint32_t* expire);
@@ -186,6 +186,18 @@ void os_timer_done(struct os_timer_t* ptimer)
 	os_timer_disarm(ptimer);
 }
 
+bool os_timer_next_expiry(uint32_t* expire)
+{
+	CriticalLock lock;
+
+	if(timer_list == nullptr) {
+		return false;
+	}
+
+	*expire = timer_list->timer_expire;
+	return true;
+}
+
 void system_init_timers()
 {
 	// hardware_alarm_claim(1);
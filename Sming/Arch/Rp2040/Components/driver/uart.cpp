@@ -159,6 +159,8 @@ void IRAM_ATTR handleInterrupt(smg_uart_t* uart, uart_dev_t* dev)
 			}
 		}
 	}
+	bool tx_threshold = (mis & UART_UARTMIS_TXMIS_BITS) && uart->tx_threshold != 0 && uart->tx_buffer != nullptr &&
+						uart->tx_buffer->getFreeSpace() >= uart->tx_threshold;
 
 	// Translate interrupt status flag bits into API values
 	uint32_t status{0};
@@ -174,6 +176,9 @@ void IRAM_ATTR handleInterrupt(smg_uart_t* uart, uart_dev_t* dev)
 	if(user_is & UART_UARTMIS_TXMIS_BITS) {
 		status |= UART_STATUS_TXFIFO_EMPTY;
 	}
+	if(tx_threshold) {
+		status |= UART_STATUS_TX_THRESHOLD;
+	}
 	if(user_is & UART_UARTMIS_BEMIS_BITS) {
 		status |= UART_STATUS_BRK_DET;
 	}
@@ -281,6 +286,35 @@ size_t smg_uart_read(smg_uart_t* uart, void* buffer, size_t size)
 	return read;
 }
 
+size_t smg_uart_rx_peek_region(smg_uart_t* uart, const void*& data)
+{
+	data = nullptr;
+	if(!smg_uart_rx_enabled(uart) || uart->rx_buffer == nullptr) {
+		return 0;
+	}
+
+	notify(uart, UART_NOTIFY_BEFORE_READ);
+
+	void* buf;
+	auto len = uart->rx_buffer->getReadData(buf);
+	data = buf;
+	return len;
+}
+
+void smg_uart_rx_consume(smg_uart_t* uart, size_t length)
+{
+	if(!smg_uart_rx_enabled(uart) || uart->rx_buffer == nullptr || length == 0) {
+		return;
+	}
+
+	uart->rx_buffer->skipRead(length);
+
+	// FIFO full may have been disabled if buffer overflowed, re-enabled it now
+	auto dev = getDevice(uart->uart_nr);
+	dev->icr = UART_UARTMIS_RXMIS_BITS | UART_UARTMIS_RTMIS_BITS | UART_UARTMIS_OEMIS_BITS;
+	hw_set_bits(&dev->imsc, UART_UARTIMSC_RXIM_BITS | UART_UARTIMSC_RTIM_BITS | UART_UARTIMSC_OEIM_BITS);
+}
+
 size_t smg_uart_rx_available(smg_uart_t* uart)
 {
 	return uart->rx_buffer ? uart->rx_buffer->available() : 0;
@@ -362,9 +396,7 @@ size_t smg_uart_write(smg_uart_t* uart, const void* buffer, size_t size)
 
 		// Write any remaining data into transmit buffer
 		if(uart->tx_buffer != nullptr) {
-			while(written < size && uart->tx_buffer->writeChar(buf[written])) {
-				++written;
-			}
+			written += uart->tx_buffer->write(&buf[written], size - written);
 		}
 
 		notify(uart, UART_NOTIFY_AFTER_WRITE);
@@ -3,14 +3,47 @@
  */
 
 #include "include/heap.h"
+#include <heap_info.h>
+#include <heap_region.h>
 #include <malloc.h>
 
+// These are set by linker
+extern char __end__;
+extern char __StackLimit;
+
+static uint32_t get_max_heap(void)
+{
+	return (uint32_t)&__StackLimit - (uint32_t)&__end__;
+}
+
 uint32_t system_get_free_heap_size(void)
 {
-	// These are set by linker
-	extern char __end__;
-	extern char __StackLimit;
-	uint32_t maxHeap = (uint32_t)&__StackLimit - (uint32_t)&__end__;
 	struct mallinfo m = mallinfo();
-	return maxHeap - m.uordblks;
+	return get_max_heap() - m.uordblks;
+}
+
+/*
+ * newlib doesn't report the largest free chunk, so use the top chunk plus the
+ * region not yet claimed via sbrk(). This is contiguous so is a safe lower bound.
+ */
+bool system_get_heap_info(heap_info_t* info)
+{
+	struct mallinfo m = mallinfo();
+	info->free_size = get_max_heap() - m.uordblks;
+	info->largest_free_block = m.keepcost + (get_max_heap() - m.arena);
+	info->free_blocks = m.ordblks;
+	info->fragmentation = system_calc_heap_fragmentation(info->free_size, info->largest_free_block);
+	return true;
+}
+
+// Single heap: SRAM is uniformly byte-addressable
+void* heap_region_malloc(heap_region_t region, size_t size)
+{
+	(void)region;
+	return malloc(size);
+}
+
+bool heap_region_available(heap_region_t region)
+{
+	return region == HEAP_REGION_DEFAULT;
 }
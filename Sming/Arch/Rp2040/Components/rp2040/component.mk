@@ -18,7 +18,10 @@ PICO_DEBUG ?= 0
 
 COMPONENT_VARS := PICO_BOARD DISABLE_WIFI DISABLE_NETWORK
 
-PICO_SDK_VARS := PICO_BOARD=$(PICO_BOARD)
+COMPONENT_VARS += LWIP_PROFILE
+include $(SMING_HOME)/Components/Network/lwip-profile/lwip-profile.mk
+
+PICO_SDK_VARS := PICO_BOARD=$(PICO_BOARD) LWIP_PROFILE=$(LWIP_PROFILE)
 PICO_SDK_LIBHASH := $(call CalculateVariantHash,PICO_SDK_VARS)
 
 GLOBAL_CFLAGS += \
@@ -35,6 +38,17 @@ ifeq ($(ENABLE_BOOTSEL),1)
 COMPONENT_CXXFLAGS += -DENABLE_BOOTSEL=1
 endif
 
+# Sleep until next timer or interrupt when there is no work to do
+COMPONENT_VARS += ENABLE_TICKLESS_IDLE
+ENABLE_TICKLESS_IDLE ?= 0
+ifeq ($(ENABLE_TICKLESS_IDLE),1)
+GLOBAL_CFLAGS += -DENABLE_TICKLESS_IDLE=1
+endif
+
+COMPONENT_VARS += TICKLESS_IDLE_MAX_MS
+TICKLESS_IDLE_MAX_MS ?= 50
+COMPONENT_CXXFLAGS += -DTICKLESS_IDLE_MAX_MS=$(TICKLESS_IDLE_MAX_MS)
+
 WRAPPED_FUNCTIONS :=
 
 $(foreach c,$(wildcard $(COMPONENT_PATH)/sdk/*.mk),$(eval include $c))
@@ -116,7 +130,9 @@ EXTRA_LIBS += \
 RP2040_CMAKE_OPTIONS := \
 	-G Ninja \
 	-DCMAKE_MAKE_PROGRAM=$(NINJA) \
-	-DCMAKE_BUILD_TYPE=$(if $(subst 1,,$(PICO_DEBUG)),RelWithDebInfo,Debug)
+	-DCMAKE_BUILD_TYPE=$(if $(subst 1,,$(PICO_DEBUG)),RelWithDebInfo,Debug) \
+	-DLWIP_PROFILE_DEFINE=$(LWIP_PROFILE_DEFINE) \
+	-DLWIP_PROFILE_DIR=$(LWIP_PROFILE_DIR)
 
 COMPONENT_PREREQUISITES := $(PICO_CONFIG)
 
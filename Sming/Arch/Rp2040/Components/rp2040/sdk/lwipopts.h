@@ -1,6 +1,8 @@
 #ifndef _LWIPOPTS_H
 #define _LWIPOPTS_H
 
+#include <lwip_profile.h>
+
 // Common settings used in most of the pico_w examples
 // (see https://www.nongnu.org/lwip/2_1_x/group__lwip__opts.html for details)
 
@@ -19,19 +21,31 @@
 #define MEM_LIBC_MALLOC             0
 #endif
 #define MEM_ALIGNMENT               4
+#ifndef MEM_SIZE
 #define MEM_SIZE                    16000
+#endif
+#ifndef MEMP_NUM_TCP_SEG
 #define MEMP_NUM_TCP_SEG            32
+#endif
 #define MEMP_NUM_ARP_QUEUE          10
 #define MEMP_NUM_UDP_PCB            8
+#ifndef PBUF_POOL_SIZE
 #define PBUF_POOL_SIZE              24
+#endif
 #define LWIP_ARP                    1
 #define LWIP_ETHERNET               1
 #define LWIP_ICMP                   1
 #define LWIP_RAW                    1
+#ifndef TCP_WND
 #define TCP_WND                     (8 * TCP_MSS)
+#endif
 #define TCP_MSS                     1460
+#ifndef TCP_SND_BUF
 #define TCP_SND_BUF                 (8 * TCP_MSS)
+#endif
+#ifndef TCP_SND_QUEUELEN
 #define TCP_SND_QUEUELEN            ((4 * (TCP_SND_BUF) + (TCP_MSS - 1)) / (TCP_MSS))
+#endif
 #define LWIP_NETIF_STATUS_CALLBACK  1
 #define LWIP_NETIF_LINK_CALLBACK    1
 #define LWIP_NETIF_HOSTNAME         1
@@ -0,0 +1,100 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * idle.cpp - Sleep until next scheduled work
+ *
+ * With ENABLE_TICKLESS_IDLE, the main loop executes WFE instead of spinning when
+ * the task queues are empty. Hardware alarm 2 is set to wake the core at the next
+ * software timer expiry, bounded by TICKLESS_IDLE_MAX_MS so the watchdog,
+ * network stack and BOOTSEL checks continue to be serviced.
+ *
+ * SEVONPEND is set so any other interrupt (hardware timer, UART, GPIO, USB, etc.) also
+ * wakes the core, as does an event signalled by core 1 when it posts to a task queue.
+ *
+ ****/
+
+#include "include/esp_system.h"
+#include "include/esp_tasks_ll.h"
+#include <driver/os_timer.h>
+#include <driver/hw_timer.h>
+#include <hardware/irq.h>
+#include <hardware/sync.h>
+#include <hardware/timer.h>
+#include <hardware/structs/scb.h>
+
+#ifdef ENABLE_TICKLESS_IDLE
+
+#ifndef TICKLESS_IDLE_MAX_MS
+#define TICKLESS_IDLE_MAX_MS 50
+#endif
+
+namespace
+{
+constexpr unsigned IDLE_ALARM{2};
+constexpr uint32_t IDLE_MAX_TICKS{TICKLESS_IDLE_MAX_MS * (HW_TIMER2_CLK / 1000)};
+// Not worth sleeping for less than this
+constexpr int IDLE_MIN_TICKS{HW_TIMER2_CLK / 10000};
+
+uint32_t idleTicks;
+
+void IRAM_ATTR idleAlarmHandler()
+{
+	timer_hw->intr = BIT(IDLE_ALARM);
+}
+
+} // namespace
+
+void system_init_idle()
+{
+	hardware_alarm_claim(IDLE_ALARM);
+	irq_set_exclusive_handler(TIMER_IRQ_2, idleAlarmHandler);
+	hw_set_bits(&timer_hw->inte, BIT(IDLE_ALARM));
+	irq_set_enabled(TIMER_IRQ_2, true);
+	hw_set_bits(&scb_hw->scr, M0PLUS_SCR_SEVONPEND_BITS);
+}
+
+void system_idle()
+{
+	/*
+	 * Interrupts are disabled so any event arriving after the check still wakes WFE.
+	 * Its handler runs once interrupts are restored.
+	 */
+	auto level = save_and_disable_interrupts();
+
+	if(!system_tasks_pending()) {
+		auto now = hw_timer2_read();
+		uint32_t deadline = now + IDLE_MAX_TICKS;
+		uint32_t expire;
+		if(os_timer_next_expiry(&expire) && int(expire - deadline) < 0) {
+			deadline = expire;
+		}
+
+		if(int(deadline - now) >= IDLE_MIN_TICKS) {
+			timer_hw->alarm[IDLE_ALARM] = deadline;
+			__wfe();
+			timer_hw->armed = BIT(IDLE_ALARM);
+			timer_hw->intr = BIT(IDLE_ALARM);
+			idleTicks += hw_timer2_read() - now;
+		}
+	}
+
+	restore_interrupts(level);
+}
+
+uint32_t system_get_idle_time()
+{
+	static_assert(HW_TIMER2_CLK == 1000000U, "Timer2 expected to tick in microseconds");
+	return idleTicks;
+}
+
+#else
+
+uint32_t system_get_idle_time()
+{
+	return 0;
+}
+
+#endif
@@ -44,6 +44,13 @@ const char* system_get_sdk_version(void);
 
 uint32_t system_get_chip_id(void);
 
+/**
+ * @brief Get total time spent sleeping whilst idle
+ * @retval uint32_t Time in microseconds, wraps
+ * @note Always 0 unless ENABLE_TICKLESS_IDLE is set
+ */
+uint32_t system_get_idle_time(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -11,6 +11,9 @@ void system_init_tasks();
 // Hook function to process task queues
 void system_service_tasks();
 
+// Determine whether any task queue contains events
+bool system_tasks_pending();
+
 typedef void (*system_task_callback_t)(os_param_t param);
 
 bool system_queue_callback(system_task_callback_t callback, os_param_t param);
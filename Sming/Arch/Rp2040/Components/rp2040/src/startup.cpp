@@ -23,6 +23,8 @@ extern void system_init_timers();
 extern void system_service_timers();
 extern void rp2040_network_initialise();
 extern void rp2040_network_service();
+extern void system_init_idle();
+extern void system_idle();
 
 namespace
 {
@@ -128,6 +130,10 @@ extern "C" int main(void)
 
 	init(); // User code init
 
+#ifdef ENABLE_TICKLESS_IDLE
+	system_init_idle();
+#endif
+
 	while(true) {
 		system_soft_wdt_feed();
 		system_service_tasks();
@@ -137,6 +143,9 @@ extern "C" int main(void)
 #endif
 #ifdef ENABLE_BOOTSEL
 		check_bootsel();
+#endif
+#ifdef ENABLE_TICKLESS_IDLE
+		system_idle();
 #endif
 	}
 
@@ -5,6 +5,7 @@
 #include <hardware/structs/watchdog.h>
 #include <pico/unique_id.h>
 #include <hardware/structs/rosc.h>
+#include <irq_latency.h>
 
 namespace
 {
@@ -13,6 +14,15 @@ constexpr uint32_t SYSTEM_RESTART_DELAY{250};
 
 uint32_t savedIrqLevels[2];
 
+#ifdef ENABLE_IRQ_LATENCY
+void trackIrqUnlock(uint32_t level)
+{
+	if(level == 0 && get_core_num() == 0) {
+		irq_latency_unlock();
+	}
+}
+#endif
+
 }; // namespace
 
 void system_soft_wdt_stop()
@@ -35,18 +45,31 @@ void system_soft_wdt_feed()
 
 void interrupts()
 {
-	restore_interrupts(savedIrqLevels[get_core_num()]);
+	auto level = savedIrqLevels[get_core_num()];
+#ifdef ENABLE_IRQ_LATENCY
+	trackIrqUnlock(level);
+#endif
+	restore_interrupts(level);
 }
 
 uint32_t noInterrupts()
 {
 	auto level = save_and_disable_interrupts();
 	savedIrqLevels[get_core_num()] = level;
+#ifdef ENABLE_IRQ_LATENCY
+	// PRIMASK is 0 when interrupts were enabled. Only core 0 (the Sming task) is measured.
+	if(level == 0 && get_core_num() == 0) {
+		irq_latency_lock(__builtin_return_address(0));
+	}
+#endif
 	return level;
 }
 
 void restoreInterrupts(uint32_t level)
 {
+#ifdef ENABLE_IRQ_LATENCY
+	trackIrqUnlock(level);
+#endif
 	restore_interrupts(level);
 }
 
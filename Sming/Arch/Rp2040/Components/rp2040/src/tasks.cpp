@@ -30,6 +30,11 @@ public:
 		return queue_try_add(&queue, &event);
 	}
 
+	bool isEmpty()
+	{
+		return queue_is_empty(&queue);
+	}
+
 	void process()
 	{
 		// Don't service any newly queued events
@@ -115,6 +120,16 @@ void system_service_tasks()
 	}
 }
 
+bool system_tasks_pending()
+{
+	for(auto queue : task_queues) {
+		if(queue != nullptr && !queue->isEmpty()) {
+			return true;
+		}
+	}
+	return false;
+}
+
 bool system_queue_callback(system_task_callback_t callback, uint32_t param)
 {
 	return task_queues[SYSTEM_TASK_PRIO]->post(os_signal_t(callback), param);
@@ -15,6 +15,8 @@
 #include <hardware/structs/xip_ctrl.h>
 #include <hardware/structs/ssi.h>
 #include <hardware/regs/ssi.h>
+#include <hardware/sync.h>
+#include <pico/multicore.h>
 #include <debug_progmem.h>
 
 #define FLASHCMD_READ_SFDP 0x5a
@@ -87,6 +89,34 @@ void initFlashInfo()
 	sfdp_flash_size_bytes = sfdp_read_size();
 }
 
+/*
+ * Flash is unavailable for execution whilst being erased or programmed,
+ * so interrupts are disabled and core 1 is paused if it is running.
+ */
+class FlashLock
+{
+public:
+	FlashLock() : lockout(multicore_lockout_victim_is_initialized(1))
+	{
+		if(lockout) {
+			multicore_lockout_start_blocking();
+		}
+		level = save_and_disable_interrupts();
+	}
+
+	~FlashLock()
+	{
+		restore_interrupts(level);
+		if(lockout) {
+			multicore_lockout_end_blocking();
+		}
+	}
+
+private:
+	uint32_t level;
+	bool lockout;
+};
+
 uint32_t writeAligned(const void* from, uint32_t toaddr, uint32_t size)
 {
 	auto flashaddr = XIP_BASE + toaddr;
@@ -97,6 +127,7 @@ uint32_t writeAligned(const void* from, uint32_t toaddr, uint32_t size)
 
 	debug_d("[FLSH] write(%p, 0x%08x, 0x%08x)", from, toaddr, size);
 
+	FlashLock lock;
 	flash_range_program(toaddr, static_cast<const uint8_t*>(from), size);
 
 	return size;
@@ -301,6 +332,7 @@ bool flashmem_erase_sector(uint32_t sector_id)
 {
 	debug_d("flashmem_erase_sector(0x%08x)", sector_id);
 	system_soft_wdt_feed();
+	FlashLock lock;
 	flash_range_erase(sector_id * FLASH_SECTOR_SIZE, FLASH_SECTOR_SIZE);
 	return true;
 }
@@ -392,6 +424,19 @@ uint32_t flashmem_get_sector_of_address(uint32_t addr)
 	return flashmem_find_sector(addr, NULL, NULL);
 }
 
+const void* flashmem_map(uint32_t addr, uint32_t size)
+{
+	if(addr + size > flashmem_get_size_bytes()) {
+		return nullptr;
+	}
+	return reinterpret_cast<const void*>(XIP_BASE + addr);
+}
+
+void flashmem_unmap(const void*)
+{
+	// Entire flash is permanently mapped via XIP
+}
+
 uint32_t spi_flash_get_id(void)
 {
 	initFlashInfo();
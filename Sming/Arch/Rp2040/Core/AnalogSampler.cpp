@@ -0,0 +1,128 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * AnalogSampler.cpp - Continuous sampling using the ADC free-running mode
+ *
+ * Conversions are paced by the ADC clock divider and moved from the ADC FIFO by DMA,
+ * alternating between two blocks. The interrupt at the end of each block starts the
+ * other one before processing the samples: the 4-entry FIFO covers the gap.
+ *
+ ****/
+
+#include <AnalogSampler.h>
+#include <hardware/adc.h>
+#include <hardware/dma.h>
+#include <hardware/irq.h>
+#include <hardware/clocks.h>
+#include <debug_progmem.h>
+
+#define PIN_ADC0 26
+#define PIN_TEMP 30 // Not a GPIO
+#define ADC_TEMP 4
+
+namespace
+{
+// Each conversion takes 96 ADC clock cycles
+constexpr unsigned minCyclesPerSample{96};
+
+AnalogSampler* instance;
+bool dmaIrqInstalled;
+
+} // namespace
+
+bool AnalogSampler::startSampling()
+{
+	if(instance != nullptr) {
+		return false;
+	}
+	if(config.pin < PIN_ADC0 || config.pin > PIN_TEMP) {
+		debug_e("[ADC] Pin %u not supported", config.pin);
+		return false;
+	}
+
+	uint32_t cycles = clock_get_hz(clk_adc) / config.sampleRate;
+	if(cycles < minCyclesPerSample) {
+		debug_e("[ADC] Sample rate %u out of range", config.sampleRate);
+		return false;
+	}
+
+	int ch = dma_claim_unused_channel(false);
+	if(ch < 0) {
+		debug_e("[ADC] No DMA channel");
+		return false;
+	}
+	dmaChannel = ch;
+	instance = this;
+
+	uint8_t input = config.pin - PIN_ADC0;
+	if((adc_hw->cs & ADC_CS_EN_BITS) == 0) {
+		adc_init();
+	}
+	if(input == ADC_TEMP) {
+		adc_set_temp_sensor_enabled(true);
+	} else {
+		adc_gpio_init(config.pin);
+	}
+	adc_select_input(input);
+	adc_fifo_setup(true, true, 1, false, false);
+	adc_set_clkdiv(cycles - 1);
+
+	auto dc = dma_channel_get_default_config(ch);
+	channel_config_set_transfer_data_size(&dc, DMA_SIZE_16);
+	channel_config_set_read_increment(&dc, false);
+	channel_config_set_write_increment(&dc, true);
+	channel_config_set_dreq(&dc, DREQ_ADC);
+	dma_channel_set_config(ch, &dc, false);
+	dma_channel_set_read_addr(ch, &adc_hw->fifo, false);
+
+	if(!dmaIrqInstalled) {
+		irq_add_shared_handler(DMA_IRQ_0, dmaInterruptHandler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+		irq_set_enabled(DMA_IRQ_0, true);
+		dmaIrqInstalled = true;
+	}
+	dma_channel_set_irq0_enabled(ch, true);
+
+	dmaIndex = 0;
+	startDma();
+	adc_fifo_drain();
+	adc_run(true);
+	return true;
+}
+
+void AnalogSampler::startDma()
+{
+	dma_channel_transfer_to_buffer_now(dmaChannel, dmaBuffer[dmaIndex], ADC_SAMPLER_DMA_BLOCK_SIZE);
+}
+
+void AnalogSampler::stopSampling()
+{
+	adc_run(false);
+	dma_channel_set_irq0_enabled(dmaChannel, false);
+	dma_channel_abort(dmaChannel);
+	dma_channel_acknowledge_irq0(dmaChannel);
+	dma_channel_unclaim(dmaChannel);
+	adc_fifo_drain();
+	adc_fifo_setup(false, false, 0, false, false);
+	dmaChannel = -1;
+	instance = nullptr;
+}
+
+void __not_in_flash_func(AnalogSampler::dmaInterruptHandler)()
+{
+	auto self = instance;
+	if(self == nullptr || !dma_channel_get_irq0_status(self->dmaChannel)) {
+		return;
+	}
+	dma_channel_acknowledge_irq0(self->dmaChannel);
+
+	auto block = self->dmaBuffer[self->dmaIndex];
+	self->dmaIndex ^= 1;
+	self->startDma();
+
+	for(unsigned i = 0; i < ADC_SAMPLER_DMA_BLOCK_SIZE; ++i) {
+		self->addSample(block[i]);
+	}
+}
@@ -0,0 +1,199 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * Waveform.cpp - Waveform generator using PIO
+ *
+ * Steps are fed directly from the application buffer to a PIO state machine by DMA.
+ * The state machine writes levels to all pins, but only those assigned to PIO are affected.
+ * The interrupt at the end of each buffer starts DMA for the next one: with the TX FIFO joined
+ * the state machine holds up to four steps, so there is no gap provided the interrupt is
+ * serviced within that time.
+ *
+ * When the last buffer has been consumed the state machine stalls waiting for data,
+ * so the final levels are held.
+ *
+ ****/
+
+#include <Waveform.h>
+#include <hardware/pio.h>
+#include <hardware/gpio.h>
+#include <hardware/dma.h>
+#include <hardware/irq.h>
+#include <hardware/clocks.h>
+#include <debug_progmem.h>
+
+/**
+ * @brief PIO block to use for waveform generation
+ * @note The state machine drives all pins assigned to its PIO block,
+ * so any other programs running on the same block must not have pins in common.
+ */
+#ifndef WAVEFORM_PIO
+#define WAVEFORM_PIO pio1
+#endif
+
+namespace
+{
+/*
+ * Each step takes 32 PIO cycles per tick:
+ *
+ *	.wrap_target
+ *	0:	out pins, 32
+ *	1:	out x, 32
+ *	2:	jmp x--, 3		; x = ticks - 1
+ *	3:	jmp x--, 5
+ *	4:	nop [27]		; Pad overhead to one tick
+ *	.wrap
+ *	5:	jmp 3 [30]
+ *
+ * Data is autopulled, so a stalled state machine simply waits for the next step.
+ */
+constexpr unsigned cyclesPerTick{32};
+
+const uint16_t programInstructions[]{
+	0x6000, // out pins, 32
+	0x6020, // out x, 32
+	0x0043, // jmp x--, 3
+	0x0045, // jmp x--, 5
+	0xbb42, // nop [27]
+	0x1e03, // jmp 3 [30]
+};
+
+const pio_program_t program{
+	.instructions = programInstructions,
+	.length = ARRAY_SIZE(programInstructions),
+	.origin = -1,
+};
+constexpr unsigned programWrap{4};
+
+int programOffset{-1};
+bool dmaIrqInstalled;
+Waveform* instances[NUM_PIO_STATE_MACHINES];
+
+} // namespace
+
+bool Waveform::startPlayback()
+{
+	auto pio = WAVEFORM_PIO;
+
+	if(stateMachine < 0) {
+		if(programOffset < 0) {
+			if(!pio_can_add_program(pio, &program)) {
+				debug_e("[WAVE] No space for PIO program");
+				return false;
+			}
+			programOffset = pio_add_program(pio, &program);
+		}
+
+		int sm = pio_claim_unused_sm(pio, false);
+		if(sm < 0) {
+			debug_e("[WAVE] No PIO state machine");
+			return false;
+		}
+		int ch = dma_claim_unused_channel(false);
+		if(ch < 0) {
+			debug_e("[WAVE] No DMA channel");
+			pio_sm_unclaim(pio, sm);
+			return false;
+		}
+		stateMachine = sm;
+		dmaChannel = ch;
+		instances[sm] = this;
+
+		for(unsigned pin = 0; pin < NUM_BANK0_GPIOS; ++pin) {
+			if(pinMask & BIT(pin)) {
+				pio_gpio_init(pio, pin);
+			}
+		}
+		pio_sm_set_pindirs_with_mask(pio, sm, pinMask, pinMask);
+
+		auto c = pio_get_default_sm_config();
+		sm_config_set_wrap(&c, programOffset, programOffset + programWrap);
+		sm_config_set_out_pins(&c, 0, NUM_BANK0_GPIOS);
+		sm_config_set_out_shift(&c, true, true, 32);
+		sm_config_set_fifo_join(&c, PIO_FIFO_JOIN_TX);
+		sm_config_set_clkdiv(&c, float(clock_get_hz(clk_sys)) / (Clock::frequency() * cyclesPerTick));
+		pio_sm_init(pio, sm, programOffset, &c);
+		pio_sm_set_enabled(pio, sm, true);
+
+		auto dc = dma_channel_get_default_config(ch);
+		channel_config_set_transfer_data_size(&dc, DMA_SIZE_32);
+		channel_config_set_read_increment(&dc, true);
+		channel_config_set_write_increment(&dc, false);
+		channel_config_set_dreq(&dc, pio_get_dreq(pio, sm, true));
+		dma_channel_set_config(ch, &dc, false);
+		dma_channel_set_write_addr(ch, &pio->txf[sm], false);
+
+		if(!dmaIrqInstalled) {
+			irq_add_shared_handler(DMA_IRQ_0, dmaInterruptHandler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+			irq_set_enabled(DMA_IRQ_0, true);
+			dmaIrqInstalled = true;
+		}
+		dma_channel_set_irq0_enabled(ch, true);
+	}
+
+	startDma();
+	return true;
+}
+
+void Waveform::startDma()
+{
+	auto& buf = buffers[bufferHead];
+	static_assert(sizeof(Step) == 2 * sizeof(uint32_t), "Step layout must match PIO data");
+	dma_channel_transfer_from_buffer_now(dmaChannel, buf.steps, buf.count * 2);
+}
+
+void Waveform::stopPlayback()
+{
+	if(dmaChannel < 0) {
+		return;
+	}
+
+	// Abort may raise a spurious completion interrupt
+	dma_channel_set_irq0_enabled(dmaChannel, false);
+	dma_channel_abort(dmaChannel);
+	dma_channel_acknowledge_irq0(dmaChannel);
+	dma_channel_set_irq0_enabled(dmaChannel, true);
+	pio_sm_clear_fifos(WAVEFORM_PIO, stateMachine);
+}
+
+void Waveform::releaseHardware()
+{
+	if(stateMachine < 0) {
+		return;
+	}
+
+	auto pio = WAVEFORM_PIO;
+	dma_channel_set_irq0_enabled(dmaChannel, false);
+	dma_channel_unclaim(dmaChannel);
+	pio_sm_set_enabled(pio, stateMachine, false);
+	pio_sm_unclaim(pio, stateMachine);
+	instances[stateMachine] = nullptr;
+	dmaChannel = -1;
+	stateMachine = -1;
+
+	// Return pins to regular GPIO without changing levels
+	gpio_put_masked(pinMask, gpio_get_all());
+	gpio_set_dir_out_masked(pinMask);
+	for(unsigned pin = 0; pin < NUM_BANK0_GPIOS; ++pin) {
+		if(pinMask & BIT(pin)) {
+			gpio_set_function(pin, GPIO_FUNC_SIO);
+		}
+	}
+}
+
+void __not_in_flash_func(Waveform::dmaInterruptHandler)()
+{
+	for(auto wave : instances) {
+		if(wave == nullptr || !dma_channel_get_irq0_status(wave->dmaChannel)) {
+			continue;
+		}
+		dma_channel_acknowledge_irq0(wave->dmaChannel);
+		wave->bufferComplete();
+		if(wave->active) {
+			wave->startDma();
+		}
+	}
+}
@@ -0,0 +1,139 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * WireAsync.cpp - Asynchronous I2C transactions using the hardware controller
+ *
+ * Commands are fed to the TX FIFO from the interrupt handler, with restart and stop flags
+ * set on the appropriate entries. Completion is signalled by STOP_DET, which the controller
+ * also generates following an abort (e.g. NACK).
+ *
+ ****/
+
+#include <Wire.h>
+#include <Digital.h>
+#include <hardware/i2c.h>
+#include <hardware/irq.h>
+#include <hardware/gpio.h>
+#include <debug_progmem.h>
+
+namespace
+{
+constexpr size_t RX_FIFO_DEPTH{16};
+
+TwoWire* asyncInstances[NUM_I2CS];
+
+} // namespace
+
+bool TwoWire::startTransaction(Transaction& transaction)
+{
+	// GPIO pins are assigned to I2C0 and I2C1 in groups of four: SDA0, SCL0, SDA1, SCL1
+	if((twi_sda & 1) != 0 || (twi_scl & 1) != 1 || ((twi_sda >> 1) & 1) != ((twi_scl >> 1) & 1)) {
+		debug_e("[TWI] Pins (%u, %u) not valid for hardware I2C", twi_sda, twi_scl);
+		return false;
+	}
+
+	unsigned index = (twi_sda >> 1) & 1;
+	auto inst = i2c_get_instance(index);
+	if(asyncHandle != inst || asyncFrequency != clockFrequency) {
+		i2c_init(inst, clockFrequency);
+		asyncHandle = inst;
+		asyncFrequency = clockFrequency;
+		asyncInstances[index] = this;
+		auto irq = I2C0_IRQ + index;
+		if(irq_get_exclusive_handler(irq) == nullptr) {
+			irq_set_exclusive_handler(irq, asyncInterruptHandler);
+		}
+		irq_set_enabled(irq, true);
+	}
+
+	gpio_set_function(twi_sda, GPIO_FUNC_I2C);
+	gpio_set_function(twi_scl, GPIO_FUNC_I2C);
+
+	auto hw = i2c_get_hw(inst);
+	hw->enable = 0;
+	hw->tar = transaction.address;
+	hw->tx_tl = 0;
+	hw->rx_tl = 0;
+	hw->enable = 1;
+
+	// Clear any stale status then let the interrupt handler fill the FIFO
+	(void)hw->clr_intr;
+	hw->intr_mask = I2C_IC_INTR_MASK_M_TX_EMPTY_BITS | I2C_IC_INTR_MASK_M_RX_FULL_BITS |
+					I2C_IC_INTR_MASK_M_STOP_DET_BITS | I2C_IC_INTR_MASK_M_TX_ABRT_BITS;
+	return true;
+}
+
+void TwoWire::endTransaction(Transaction&)
+{
+	auto hw = i2c_get_hw(static_cast<i2c_inst_t*>(asyncHandle));
+	hw->intr_mask = 0;
+	hw->enable = 0;
+
+	// Return pins for use by blocking methods
+	pinMode(twi_sda, INPUT_PULLUP);
+	pinMode(twi_scl, INPUT_PULLUP);
+}
+
+void __not_in_flash_func(TwoWire::asyncInterruptHandler)()
+{
+	unsigned index = __get_current_exception() - VTABLE_FIRST_IRQ - I2C0_IRQ;
+	auto wire = asyncInstances[index];
+	auto hw = i2c_get_hw(i2c_get_instance(index));
+	if(wire == nullptr || !wire->asyncActive) {
+		hw->intr_mask = 0;
+		return;
+	}
+
+	auto& trans = *wire->queueHead;
+	auto stat = hw->intr_stat;
+
+	if(stat & I2C_IC_INTR_STAT_R_TX_ABRT_BITS) {
+		auto source = hw->tx_abrt_source;
+		(void)hw->clr_tx_abrt;
+		trans.error = (source & I2C_IC_TX_ABRT_SOURCE_ABRT_7B_ADDR_NOACK_BITS) ? I2C_ERR_ADDR_NACK : I2C_ERR_DATA_NACK;
+		// Controller flushes the FIFO and sends stop
+		wire->asyncCmdOffset = trans.txLength + trans.rxLength;
+	}
+
+	while(hw->rxflr != 0 && wire->asyncRxOffset < trans.rxLength) {
+		trans.rxData[wire->asyncRxOffset++] = hw->data_cmd;
+	}
+
+	if(stat & I2C_IC_INTR_STAT_R_TX_EMPTY_BITS) {
+		auto inst = i2c_get_instance(index);
+		auto total = trans.txLength + trans.rxLength;
+		while(wire->asyncCmdOffset < total && i2c_get_write_available(inst) != 0) {
+			auto offset = wire->asyncCmdOffset;
+			uint32_t cmd;
+			if(offset < trans.txLength) {
+				cmd = trans.txData[offset];
+			} else {
+				// Don't issue more reads than the RX FIFO can hold
+				if(offset - trans.txLength - wire->asyncRxOffset >= RX_FIFO_DEPTH) {
+					break;
+				}
+				cmd = I2C_IC_DATA_CMD_CMD_BITS;
+				if(offset == trans.txLength && trans.txLength != 0) {
+					cmd |= I2C_IC_DATA_CMD_RESTART_BITS;
+				}
+			}
+			++wire->asyncCmdOffset;
+			if(wire->asyncCmdOffset == total) {
+				cmd |= I2C_IC_DATA_CMD_STOP_BITS;
+			}
+			hw->data_cmd = cmd;
+		}
+		if(wire->asyncCmdOffset == total) {
+			hw_clear_bits(&hw->intr_mask, I2C_IC_INTR_MASK_M_TX_EMPTY_BITS);
+		}
+	}
+
+	if(stat & I2C_IC_INTR_STAT_R_STOP_DET_BITS) {
+		(void)hw->clr_stop_det;
+		hw->intr_mask = 0;
+		wire->transactionComplete(trans.error);
+	}
+}
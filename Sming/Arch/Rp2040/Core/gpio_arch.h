@@ -0,0 +1,58 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * gpio_arch.h - Direct GPIO register access for Rp2040
+ *
+ * See Sming/Core/FastGpio.h
+ *
+ * Uses the single-cycle IO block, so pins must be assigned to SIO (e.g. by pinMode).
+ *
+ ****/
+
+#pragma once
+
+#include <sming_attr.h>
+#include <hardware/structs/sio.h>
+
+namespace FastGpio
+{
+constexpr unsigned maxPins{NUM_BANK0_GPIOS};
+
+template <unsigned bank> struct Port;
+
+template <> struct Port<0> {
+	__forceinline static void set(uint32_t mask)
+	{
+		sio_hw->gpio_set = mask;
+	}
+
+	__forceinline static void clear(uint32_t mask)
+	{
+		sio_hw->gpio_clr = mask;
+	}
+
+	__forceinline static uint32_t read(uint32_t mask)
+	{
+		return sio_hw->gpio_in & mask;
+	}
+
+	__forceinline static uint32_t readOutput()
+	{
+		return sio_hw->gpio_out;
+	}
+
+	__forceinline static void enableOutput(uint32_t mask)
+	{
+		sio_hw->gpio_oe_set = mask;
+	}
+
+	__forceinline static void disableOutput(uint32_t mask)
+	{
+		sio_hw->gpio_oe_clr = mask;
+	}
+};
+
+} // namespace FastGpio
@@ -66,3 +66,14 @@ bool RtcClass::setRtcSeconds(uint32_t seconds)
 
 	return rtc_set_datetime(&t);
 }
+
+bool RtcClass::readMemory(uint8_t block, void* data, uint16_t size)
+{
+	// No memory is retained through dormant mode or reset
+	return false;
+}
+
+bool RtcClass::writeMemory(uint8_t block, const void* data, uint16_t size)
+{
+	return false;
+}
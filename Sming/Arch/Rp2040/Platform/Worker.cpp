@@ -0,0 +1,44 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * Worker.cpp - Execute jobs on core 1
+ *
+ ****/
+
+#include <Platform/Worker.h>
+#include <esp_tasks_ll.h>
+#include <pico/multicore.h>
+#include <hardware/sync.h>
+
+bool WorkerClass::isParallel()
+{
+	return true;
+}
+
+bool WorkerClass::startWorker()
+{
+	multicore_launch_core1([]() {
+		// Allow core 0 to pause this core whilst writing to flash
+		multicore_lockout_victim_init();
+		for(;;) {
+			while(runNext()) {
+			}
+			__wfe();
+		}
+	});
+	return true;
+}
+
+void WorkerClass::kickWorker()
+{
+	__sev();
+}
+
+void WorkerClass::notifyComplete()
+{
+	// System queue is multicore-safe. If full, completion is picked up following the next post.
+	system_queue_callback([](os_param_t) { serviceCompletions(); }, 0);
+}
@@ -0,0 +1,26 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * StackMonitor.cpp
+ *
+ */
+
+#include <Services/Profiling/StackMonitor.h>
+
+extern char __StackBottom;
+extern char __StackTop;
+
+namespace Profiling
+{
+bool StackMonitor::getBounds(uintptr_t& bottom, uintptr_t& top)
+{
+	// Core 0 stack, defined by the linker script
+	bottom = uintptr_t(&__StackBottom);
+	top = uintptr_t(&__StackTop);
+	return true;
+}
+
+} // namespace Profiling
@@ -20,21 +20,70 @@
 #include <Stream.h>
 #include <WHashMap.h>
 #include <WString.h>
+#include <Data/Stream/MemoryDataStream.h>
 #include <simpleRPC.h>
 #include <simpleRPC/parser.h>
 #include <hostlib/emu.h>
 #include <hostlib/hostmsg.h>
 #include "Util.h"
+#include <deque>
+#include <unordered_map>
 
 namespace Hosted
 {
 constexpr int COMMAND_NOT_FOUND = -1;
 
+/**
+ * @brief RPC client
+ *
+ * The server handles calls in order and only responds to those which return a value,
+ * so calls may be pipelined: issue several using `call()` then collect results with `wait(id)`.
+ *
+ * Calls made within a `Batch` scope are sent in a single transport write.
+ */
 class Client : private simpleRPC::ParserCallbacks
 {
 public:
 	using RemoteCommands = HashMap<String, uint8_t>;
 
+	/**
+	 * @brief Identifies a pipelined call, 0 is invalid
+	 */
+	using CallId = uint32_t;
+
+	/**
+	 * @brief Scope within which calls are not transmitted until the outermost scope ends,
+	 * or a result is waited for
+	 *
+	 * Example:
+	 *
+	 * 		{
+	 * 			Hosted::Client::Batch batch(*hostedClient);
+	 * 			for(unsigned i = 0; i < 100; ++i) {
+	 * 				hostedClient->send("digitalWrite", pin, i & 1);
+	 * 			}
+	 * 		}
+	 */
+	class Batch
+	{
+	public:
+		Batch(Client& client) : client(client)
+		{
+			client.beginBatch();
+		}
+
+		~Batch()
+		{
+			client.endBatch();
+		}
+
+		Batch(const Batch&) = delete;
+		Batch& operator=(const Batch&) = delete;
+
+	private:
+		Client& client;
+	};
+
 	Client(Stream& stream, char methodEndsWith = ':') : stream(stream), methodEndsWith(methodEndsWith)
 	{
 	}
@@ -54,38 +103,124 @@ public:
 	 * @param variable arguments
 	 *
 	 * @retval true on success, false if the command is not available
+	 *
+	 * @note Returns without waiting for the call to complete, so for void functions this is all that's required.
+	 * For functions which return a value, follow with `wait()`.
 	 */
 	template <typename... Args> bool send(const String& functionName, Args... args)
 	{
-		int functionId = getFunctionId(functionName);
-		if(functionId == COMMAND_NOT_FOUND) {
-			return false;
+		return sendById(getFunctionId(functionName), args...);
+	}
+
+	/**
+	 * @brief Send a command identified by a static string
+	 * @param functionName Must remain valid and unchanged for the lifetime of the client,
+	 * such as a string literal, `__func__` or `__PRETTY_FUNCTION__`
+	 * @note The function id is looked up once and cached against the string address,
+	 * which avoids name conversion and lookup on every call
+	 */
+	template <typename... Args> bool send(const char* functionName, Args... args)
+	{
+		return sendById(getFunctionId(functionName), args...);
+	}
+
+	/**
+	 * @brief Send a function call whose result is collected later
+	 * @tparam R Return type of the remote function
+	 * @param functionName See `send()`
+	 * @param variable arguments
+	 * @retval CallId Pass to `wait()` to obtain the result, 0 if the command is not available
+	 */
+	template <typename R, typename Name, typename... Args> CallId call(const Name& functionName, Args... args)
+	{
+		if(!send(functionName, args...)) {
+			return 0;
 		}
 
-		simpleRPC::rpcPrint(stream, uint8_t(functionId), args...);
-		stream.flush();
+		if(++lastCallId == 0) {
+			++lastCallId;
+		}
+		pending.push_back({lastCallId, sizeof(R)});
+		return lastCallId;
+	}
 
-		return true;
+	/**
+	 * @brief Block until the result of a call made using `call()` is available
+	 * @param id Identifies the call
+	 * @retval R The result, default-constructed if id is not recognised
+	 * @note Results may be collected in any order
+	 */
+	template <typename R> R wait(CallId id)
+	{
+		flush();
+
+		while(!completed.contains(id)) {
+			if(pending.empty()) {
+				host_debug_e("Unknown call id %u", id);
+				return R{};
+			}
+			readPending();
+		}
+
+		R result{};
+		auto& data = completed[id];
+		memcpy(&result, data.c_str(), std::min(sizeof(result), size_t(data.length())));
+		completed.remove(id);
+		return result;
 	}
 
 	/**
 	 * @brief This method will block the execution until a message is detected
 	 * @retval HostedCommand
+	 * @note Any outstanding pipelined results are received first, so don't use `call()`
+	 * between `send()` and the corresponding `wait()`.
 	 */
 	template <typename R> R wait()
 	{
-		size_t neededBytes = sizeof(R);
+		flush();
 
-		while(stream.available() < int(neededBytes)) {
-			stream.flush();
-			host_main_loop();
+		while(!pending.empty()) {
+			readPending();
 		}
 
 		R result{};
-		stream.readBytes(reinterpret_cast<char*>(&result), sizeof(result));
+		readResponse(reinterpret_cast<char*>(&result), sizeof(result));
 		return result;
 	}
 
+	/**
+	 * @brief Transmit any buffered calls
+	 */
+	void flush()
+	{
+		auto length = output.available();
+		if(length > 0) {
+			stream.write(reinterpret_cast<const uint8_t*>(output.getStreamPointer()), length);
+			output.clear();
+		}
+		stream.flush();
+	}
+
+	/**
+	 * @brief Defer transmission of calls until a matching `endBatch()`
+	 * @note Batches may be nested
+	 * @see `Batch`
+	 */
+	void beginBatch()
+	{
+		++batchLevel;
+	}
+
+	/**
+	 * @brief End a batch, transmitting calls if this is the outermost one
+	 */
+	void endBatch()
+	{
+		if(batchLevel != 0 && --batchLevel == 0) {
+			flush();
+		}
+	}
+
 	/**
 	 * @brief Fetches a list of commands supported on the RPC server and gives back the id of the desired command
 	 * @param name command name to query
@@ -110,6 +245,26 @@ public:
 		return commands[name];
 	}
 
+	/**
+	 * @brief Get function id using a cached value for a static name string
+	 * @see `send(const char*, Args...)`
+	 */
+	int getFunctionId(const char* name)
+	{
+		if(fetchCommands) {
+			getRemoteCommands();
+		}
+
+		auto it = idCache.find(name);
+		if(it != idCache.end()) {
+			return it->second;
+		}
+
+		int id = getFunctionId(String(name));
+		idCache[name] = id;
+		return id;
+	}
+
 	/**
 	 * @brief Gets list of remote command names and their ids
 	 * @retval true on success, false otherwise
@@ -120,6 +275,7 @@ public:
 
 		using namespace simpleRPC;
 
+		flush();
 		uint8_t head = 0xff;
 		stream.write(&head, 1);
 		char buffer[512];
@@ -157,18 +313,67 @@ public:
 	}
 
 private:
+	// Buffered output is sent when it reaches this size, even within a batch
+	static constexpr int maxBatchSize{1024};
+
+	struct PendingCall {
+		CallId id;
+		size_t size;
+	};
+
 	Stream& stream;
+	MemoryDataStream output;
+	std::deque<PendingCall> pending;
+	HashMap<CallId, String> completed;
+	CallId lastCallId{0};
+	unsigned batchLevel{0};
 	bool fetchCommands{true};
 	RemoteCommands commands;
+	std::unordered_map<const char*, int> idCache;
 	uint8_t methodPosition = 0;
 	String name;
 	String signature;
 	char methodEndsWith;
 
+	template <typename... Args> bool sendById(int functionId, Args... args)
+	{
+		if(functionId == COMMAND_NOT_FOUND) {
+			return false;
+		}
+
+		simpleRPC::rpcPrint(output, uint8_t(functionId), args...);
+		if(batchLevel == 0 || output.available() >= maxBatchSize) {
+			flush();
+		}
+
+		return true;
+	}
+
+	void readResponse(char* buffer, size_t size)
+	{
+		while(stream.available() < int(size)) {
+			stream.flush();
+			host_main_loop();
+		}
+		stream.readBytes(buffer, size);
+	}
+
+	// Responses arrive in the order calls were made
+	void readPending()
+	{
+		auto call = pending.front();
+		pending.pop_front();
+		String data;
+		data.setLength(call.size);
+		readResponse(data.begin(), call.size);
+		completed[call.id] = std::move(data);
+	}
+
 	void startMethods() override
 	{
 		methodPosition = 0;
 		commands.clear();
+		idCache.clear();
 	}
 
 	void startMethod() override
@@ -76,10 +76,10 @@ public:
 
 	int read() override
 	{
-		int ch;
-		int result = transport.readChar(reinterpret_cast<char*>(&ch), 1);
+		char ch;
+		int result = transport.readChar(&ch, 1);
 		if(result == 1) {
-			return ch;
+			return uint8_t(ch);
 		}
 
 		return -1;
@@ -95,7 +95,9 @@ public:
 		return 0;
 	}
 
-	size_t write(const uint8_t* buffer, size_t size)
+	using Stream::write;
+
+	size_t write(const uint8_t* buffer, size_t size) override
 	{
 		char result = transport.writeBytes(buffer, size);
 		if(result == 1) {
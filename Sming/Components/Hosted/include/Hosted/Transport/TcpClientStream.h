@@ -59,7 +59,7 @@ public:
 
 	size_t write(uint8_t c) override
 	{
-		return cBuffer.write(c);
+		return write(&c, 1);
 	}
 
 	int available() override
@@ -79,14 +79,34 @@ public:
 
 	void flush() override
 	{
+		if(flushHeld) {
+			flushPending = true;
+			return;
+		}
+		pendingBytes = 0;
 		client.commit();
 	}
 
+	/**
+	 * @brief Defer flush requests whilst a batch of requests is processed
+	 * @param hold true to start batch, false to end it and send any deferred output
+	 */
+	void holdFlush(bool hold)
+	{
+		flushHeld = hold;
+		if(!hold && flushPending) {
+			flushPending = false;
+			flush();
+		}
+	}
+
 private:
 	CircularBuffer cBuffer;
 	TcpClient& client;
 	size_t pendingBytes{0};
 	size_t threshold;
+	bool flushHeld{false};
+	bool flushPending{false};
 
 	bool store(TcpClient& client, char* data, int size)
 	{
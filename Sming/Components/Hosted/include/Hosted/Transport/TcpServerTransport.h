@@ -20,12 +20,30 @@
 
 namespace Hosted::Transport
 {
+/**
+ * @brief Serve requests from any number of connected clients
+ *
+ * Each connection has its own stream, so partial requests from one client
+ * do not affect another. All requests in the received data are handled in turn
+ * and their responses sent together.
+ *
+ * @note Handles client completion for the server, replacing any existing complete handler
+ */
 class TcpServerTransport : public TcpTransport
 {
 public:
 	TcpServerTransport(TcpServer& server)
 	{
 		server.setClientReceiveHandler(TcpClientDataDelegate(&TcpServerTransport::process, this));
+		server.setClientCompleteHandler(TcpClientCompleteDelegate(&TcpServerTransport::complete, this));
+	}
+
+	/**
+	 * @brief Get number of clients with an active stream
+	 */
+	unsigned getClientCount() const
+	{
+		return map.count();
 	}
 
 protected:
@@ -43,7 +61,25 @@ protected:
 			return false;
 		}
 
-		return handler(*stream);
+		// Several requests may arrive together, e.g. from Client::Batch
+		stream->holdFlush(true);
+		bool success{true};
+		int avail;
+		while(success && (avail = stream->available()) > 0) {
+			success = handler(*stream);
+			if(stream->available() >= avail) {
+				// Nothing consumed: wait for more data
+				break;
+			}
+		}
+		stream->holdFlush(false);
+
+		return success;
+	}
+
+	void complete(TcpClient& client, bool successful)
+	{
+		map.remove(&client);
 	}
 
 private:
@@ -16,6 +16,15 @@
 
 using namespace Ethernet;
 
+EmbeddedEthernet::DmaConfig EmbeddedEthernet::getDmaConfig()
+{
+#if CONFIG_ETH_USE_ESP32_EMAC
+	return DmaConfig{CONFIG_ETH_DMA_RX_BUFFER_NUM, CONFIG_ETH_DMA_TX_BUFFER_NUM, CONFIG_ETH_DMA_BUFFER_SIZE};
+#else
+	return DmaConfig{};
+#endif
+}
+
 bool EmbeddedEthernet::begin(const Config& config)
 {
 #if !CONFIG_ETH_USE_ESP32_EMAC
@@ -39,6 +48,15 @@ bool EmbeddedEthernet::begin(const Config& config)
 	enableGotIpCallback(true);
 
 	eth_mac_config_t mac_config = ETH_MAC_DEFAULT_CONFIG();
+	// Received frames are handed to the stack from this task, so it limits receive throughput
+	if(config.rxTaskStackSize != 0) {
+		mac_config.rx_task_stack_size = config.rxTaskStackSize;
+	}
+	if(config.rxTaskPriority >= 0) {
+		mac_config.rx_task_prio = config.rxTaskPriority;
+	}
+	debug_i("[ETH] DMA rx %u, tx %u, size %u", CONFIG_ETH_DMA_RX_BUFFER_NUM, CONFIG_ETH_DMA_TX_BUFFER_NUM,
+			CONFIG_ETH_DMA_BUFFER_SIZE);
 #if ESP_IDF_VERSION_MAJOR < 5
 	if(config.smiMdcPin != PIN_DEFAULT) {
 		mac_config.smi_mdc_gpio_num = config.smiMdcPin;
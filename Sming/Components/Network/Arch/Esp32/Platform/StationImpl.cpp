@@ -10,6 +10,7 @@
 
 #include "StationImpl.h"
 #include <nvs.h>
+#include <esp_attr.h>
 
 #ifdef ENABLE_WPS
 #include <esp_wps.h>
@@ -27,6 +28,12 @@ namespace Network
 {
 StationImpl station;
 
+namespace
+{
+// Retained through deep sleep and software restarts
+RTC_NOINIT_ATTR StationFastConnect fastConnectData;
+} // namespace
+
 #ifdef ENABLE_WPS
 /*
  * Information only required during WPS negotiation
@@ -94,11 +101,20 @@ void StationImpl::eventHandler(esp_event_base_t base, int32_t id, void* data)
 		case WIFI_EVENT_STA_START:
 			if(allowAutoConnect && getAutoConnect()) {
 				connectionStatus = eSCS_Connecting;
+				applyFastConnect();
 				esp_wifi_connect();
 			}
 			break;
 		case WIFI_EVENT_STA_DISCONNECTED: {
 			connectionStatus = eSCS_ConnectionFailed;
+			if(fastConnecting) {
+				// Access point or address no longer valid, so do a full scan
+				auto event = static_cast<wifi_event_sta_disconnected_t*>(data);
+				debug_w("[STA] Fast connect failed, reason %u", event->reason);
+				clearFastConnect();
+				connectionStatus = eSCS_Connecting;
+				esp_wifi_connect();
+			}
 			break;
 		}
 		default:;
@@ -107,6 +123,10 @@ void StationImpl::eventHandler(esp_event_base_t base, int32_t id, void* data)
 		switch(id) {
 		case IP_EVENT_STA_GOT_IP:
 			connectionStatus = eSCS_GotIP;
+			if(fastConnect) {
+				fastConnecting = false;
+				saveFastConnect();
+			}
 			break;
 		case IP_EVENT_STA_LOST_IP:
 			connectionStatus = eSCS_Connecting;
@@ -207,6 +227,7 @@ bool StationImpl::config(const Config& cfg)
 bool StationImpl::connect()
 {
 	disconnect();
+	applyFastConnect();
 	return esp_wifi_connect() == ESP_OK;
 }
 
@@ -686,5 +707,115 @@ void StationImpl::wpsConfigStop()
 
 #endif // ENABLE_WPS
 
+bool StationImpl::setFastConnect(bool enable)
+{
+	fastConnect = enable;
+	if(!enable) {
+		abandonFastConnect();
+	}
+	return true;
+}
+
+void StationImpl::clearFastConnect()
+{
+	fastConnectData.invalidate();
+	abandonFastConnect();
+}
+
+void StationImpl::applyFastConnect()
+{
+	if(!fastConnect || fastConnecting || !fastConnectData.isValid(getSSID())) {
+		return;
+	}
+
+	wifi_config_t config{};
+	if(esp_wifi_get_config(WIFI_IF_STA, &config) != ESP_OK) {
+		return;
+	}
+
+	configuredChannel = config.sta.channel;
+	configuredBssidSet = config.sta.bssid_set;
+	configuredScanMethod = config.sta.scan_method;
+	configuredDhcp = isEnabledDHCP();
+
+	// Join the known access point directly, without scanning
+	config.sta.bssid_set = true;
+	memcpy(config.sta.bssid, fastConnectData.bssid, sizeof(config.sta.bssid));
+	config.sta.channel = fastConnectData.channel;
+	config.sta.scan_method = WIFI_FAST_SCAN;
+	// Avoid writing flash on every connection
+	esp_wifi_set_storage(WIFI_STORAGE_RAM);
+	if(esp_wifi_set_config(WIFI_IF_STA, &config) != ESP_OK) {
+		return;
+	}
+
+	if(configuredDhcp && fastConnectData.isLeaseValid()) {
+		esp_netif_ip_info_t info{};
+		info.ip.addr = fastConnectData.ip;
+		info.netmask.addr = fastConnectData.netmask;
+		info.gw.addr = fastConnectData.gateway;
+		esp_netif_dhcpc_stop(stationNetworkInterface);
+		esp_netif_set_ip_info(stationNetworkInterface, &info);
+		esp_netif_dns_info_t dns{};
+		dns.ip.type = ESP_IPADDR_TYPE_V4;
+		dns.ip.u_addr.ip4.addr = fastConnectData.dns;
+		esp_netif_set_dns_info(stationNetworkInterface, ESP_NETIF_DNS_MAIN, &dns);
+	}
+
+	fastConnecting = true;
+	debug_i("[STA] Fast connect to channel %u", fastConnectData.channel);
+}
+
+void StationImpl::saveFastConnect()
+{
+	wifi_ap_record_t ap;
+	if(esp_wifi_sta_get_ap_info(&ap) != ESP_OK) {
+		return;
+	}
+
+	auto ssid = getSSID();
+	bool reusedLease = fastConnectData.isValid(ssid) && fastConnectData.isLeaseValid() && !isEnabledDHCP();
+
+	auto& data = fastConnectData;
+	data.setSsid(ssid);
+	memcpy(data.bssid, ap.bssid, sizeof(data.bssid));
+	data.channel = ap.primary;
+
+	if(!reusedLease) {
+		// Keep the original lease time when re-using an address, otherwise it never expires
+		esp_netif_ip_info_t info{};
+		esp_netif_get_ip_info(stationNetworkInterface, &info);
+		data.ip = info.ip.addr;
+		data.netmask = info.netmask.addr;
+		data.gateway = info.gw.addr;
+		esp_netif_dns_info_t dns{};
+		esp_netif_get_dns_info(stationNetworkInterface, ESP_NETIF_DNS_MAIN, &dns);
+		data.dns = dns.ip.u_addr.ip4.addr;
+		data.hasLease = isEnabledDHCP();
+		data.leaseStart = RTC.getRtcSeconds();
+	}
+
+	data.seal();
+}
+
+void StationImpl::abandonFastConnect()
+{
+	if(!fastConnecting) {
+		return;
+	}
+	fastConnecting = false;
+
+	wifi_config_t config{};
+	if(esp_wifi_get_config(WIFI_IF_STA, &config) == ESP_OK) {
+		config.sta.bssid_set = configuredBssidSet;
+		config.sta.channel = configuredChannel;
+		config.sta.scan_method = configuredScanMethod;
+		esp_wifi_set_config(WIFI_IF_STA, &config);
+	}
+	if(configuredDhcp && !isEnabledDHCP()) {
+		esp_netif_dhcpc_start(stationNetworkInterface);
+	}
+}
+
 }; // namespace Network
 }; // namespace SmingInternal
@@ -12,6 +12,7 @@
 
 #include <Platform/Station.h>
 #include <Platform/System.h>
+#include <Platform/StationFastConnect.h>
 #include <esp_wifi.h>
 
 #ifdef ENABLE_SMART_CONFIG
@@ -56,6 +57,12 @@ public:
 	int8_t getRssi() const override;
 	uint8_t getChannel() const override;
 	bool startScan(ScanCompletedDelegate scanCompleted) override;
+	bool setFastConnect(bool enable) override;
+	bool isFastConnect() const override
+	{
+		return fastConnect;
+	}
+	void clearFastConnect() override;
 
 #ifdef ENABLE_SMART_CONFIG
 	bool smartConfigStart(SmartConfigType sctype, SmartConfigDelegate callback) override;
@@ -75,6 +82,9 @@ protected:
 
 private:
 	static void staticScanCompleted(wifi_event_sta_scan_done_t* event, uint8_t status);
+	void applyFastConnect();
+	void saveFastConnect();
+	void abandonFastConnect();
 #ifdef ENABLE_WPS
 	void wpsEventHandler(int32_t event_id, void* event_data);
 	bool wpsCallback(WpsStatus status);
@@ -88,6 +98,13 @@ private:
 private:
 	StationConnectionStatus connectionStatus{eSCS_Idle};
 	bool runScan{false};
+	bool fastConnect{false};
+	bool fastConnecting{false}; ///< Attempt using saved details in progress
+	// Settings replaced during a fast connection attempt
+	uint8_t configuredChannel{0};
+	bool configuredBssidSet{false};
+	wifi_scan_method_t configuredScanMethod{WIFI_ALL_CHANNEL_SCAN};
+	bool configuredDhcp{true};
 #ifdef ENABLE_WPS
 	struct WpsConfig;
 	WpsConfig* wpsConfig;
@@ -53,8 +53,27 @@ public:
 		Ethernet::PhyConfig phy;
 		int8_t smiMdcPin = Ethernet::PIN_DEFAULT;  //< SMI MDC GPIO number
 		int8_t smiMdioPin = Ethernet::PIN_DEFAULT; //< SMI MDIO GPIO number
+		uint32_t rxTaskStackSize = 0;			   //< Stack size for MAC receive task, 0 for default
+		int8_t rxTaskPriority = -1;				   //< Priority of MAC receive task, -1 for default
 	};
 
+	/**
+	 * @brief MAC DMA buffer configuration
+	 *
+	 * These are fixed when the SDK is built, see ETH_DMA_RX_BUFFER_NUM, ETH_DMA_TX_BUFFER_NUM
+	 * and ETH_DMA_BUFFER_SIZE.
+	 */
+	struct DmaConfig {
+		uint16_t rxBufferCount;
+		uint16_t txBufferCount;
+		uint16_t bufferSize;
+	};
+
+	/**
+	 * @brief Get the DMA buffer configuration
+	 */
+	static DmaConfig getDmaConfig();
+
 	using IdfService::IdfService;
 
 	/**
@@ -10,10 +10,35 @@
 
 #include "StationImpl.h"
 #include <Interrupts.h>
+#include <lwip/dns.h>
 
-static StationImpl station;
+/**
+ * @brief Location in RTC user memory (4-byte blocks) of fast reconnection information
+ * @note Blocks 64-70 are used by rBoot and RTC
+ */
+#ifndef STATION_FAST_CONNECT_RTC_BLOCK
+#define STATION_FAST_CONNECT_RTC_BLOCK 72
+#endif
+
+using SmingInternal::Network::StationFastConnect;
+
+StationImpl station;
 StationClass& WifiStation = station;
 
+namespace
+{
+bool loadFastConnect(StationFastConnect& data)
+{
+	return system_rtc_mem_read(STATION_FAST_CONNECT_RTC_BLOCK, &data, sizeof(data));
+}
+
+bool storeFastConnect(const StationFastConnect& data)
+{
+	return system_rtc_mem_write(STATION_FAST_CONNECT_RTC_BLOCK, &data, sizeof(data));
+}
+
+} // namespace
+
 class BssInfoImpl : public BssInfo
 {
 public:
@@ -129,6 +154,7 @@ bool StationImpl::config(const Config& cfg)
 
 bool StationImpl::connect()
 {
+	applyFastConnect();
 	return wifi_station_connect();
 }
 
@@ -506,3 +532,143 @@ void StationImpl::wpsConfigStop()
 }
 
 #endif // ENABLE_WPS
+
+bool StationImpl::setFastConnect(bool enable)
+{
+	fastConnect = enable;
+	if(enable) {
+		// Prepare for the connection made automatically at startup
+		applyFastConnect();
+	} else {
+		abandonFastConnect();
+	}
+	return true;
+}
+
+void StationImpl::clearFastConnect()
+{
+	StationFastConnect data{};
+	storeFastConnect(data);
+	abandonFastConnect();
+}
+
+void StationImpl::applyFastConnect()
+{
+	if(!fastConnect || fastConnecting) {
+		return;
+	}
+
+	station_config config{};
+	if(!wifi_station_get_config(&config)) {
+		return;
+	}
+
+	StationFastConnect data;
+	if(!loadFastConnect(data) || !data.isValid(getSSID())) {
+		return;
+	}
+
+	configuredChannel = config.channel;
+	configuredBssidSet = config.bssid_set;
+	configuredAllChannelScan = config.all_channel_scan;
+	configuredDhcp = isEnabledDHCP();
+
+	// Join the known access point directly, without scanning
+	config.bssid_set = true;
+	memcpy(config.bssid, data.bssid, sizeof(config.bssid));
+	config.channel = data.channel;
+	config.all_channel_scan = false;
+	wifi_set_channel(data.channel);
+	if(!wifi_station_set_config_current(&config)) {
+		return;
+	}
+
+	if(configuredDhcp && data.isLeaseValid()) {
+		ip_info info{};
+		info.ip.addr = data.ip;
+		info.netmask.addr = data.netmask;
+		info.gw.addr = data.gateway;
+		wifi_station_dhcpc_stop();
+		wifi_set_ip_info(STATION_IF, &info);
+		ip_addr_t dns;
+		dns.addr = data.dns;
+		dns_setserver(0, &dns);
+	}
+
+	fastConnecting = true;
+	debug_i("[STA] Fast connect to channel %u", data.channel);
+}
+
+void StationImpl::saveFastConnect()
+{
+	StationFastConnect data;
+	bool reusedLease = loadFastConnect(data) && data.isValid(getSSID()) && data.isLeaseValid() && !isEnabledDHCP();
+
+	data.setSsid(getSSID());
+	getBSSID().getOctets(data.bssid);
+	data.channel = getChannel();
+
+	if(!reusedLease) {
+		// Keep the original lease time when re-using an address, otherwise it never expires
+		ip_info info{};
+		wifi_get_ip_info(STATION_IF, &info);
+		data.ip = info.ip.addr;
+		data.netmask = info.netmask.addr;
+		data.gateway = info.gw.addr;
+#if LWIP_VERSION_MAJOR >= 2
+		data.dns = ip_2_ip4(dns_getserver(0))->addr;
+#else
+		data.dns = dns_getserver(0).addr;
+#endif
+		data.hasLease = isEnabledDHCP();
+		data.leaseStart = RTC.getRtcSeconds();
+	}
+
+	data.seal();
+	storeFastConnect(data);
+}
+
+void StationImpl::abandonFastConnect()
+{
+	if(!fastConnecting) {
+		return;
+	}
+	fastConnecting = false;
+
+	station_config config{};
+	if(wifi_station_get_config(&config)) {
+		config.bssid_set = configuredBssidSet;
+		config.channel = configuredChannel;
+		config.all_channel_scan = configuredAllChannelScan;
+		wifi_station_set_config_current(&config);
+	}
+	if(configuredDhcp && !isEnabledDHCP()) {
+		wifi_station_dhcpc_start();
+	}
+}
+
+void StationImpl::eventHandler(System_Event_t* evt)
+{
+	if(!fastConnect) {
+		return;
+	}
+
+	switch(evt->event) {
+	case EVENT_STAMODE_GOT_IP:
+		fastConnecting = false;
+		saveFastConnect();
+		break;
+
+	case EVENT_STAMODE_DISCONNECTED:
+		if(fastConnecting) {
+			// Access point or address no longer valid, so do a full scan
+			debug_w("[STA] Fast connect failed, reason %u", evt->event_info.disconnected.reason);
+			clearFastConnect();
+			wifi_station_disconnect();
+			wifi_station_connect();
+		}
+		break;
+
+	default:;
+	}
+}
@@ -12,6 +12,7 @@
 
 #include <Platform/Station.h>
 #include <Platform/System.h>
+#include <Platform/StationFastConnect.h>
 #include <esp_wifi.h>
 
 #ifdef ENABLE_SMART_CONFIG
@@ -49,6 +50,12 @@ public:
 	int8_t getRssi() const override;
 	uint8_t getChannel() const override;
 	bool startScan(ScanCompletedDelegate scanCompleted) override;
+	bool setFastConnect(bool enable) override;
+	bool isFastConnect() const override
+	{
+		return fastConnect;
+	}
+	void clearFastConnect() override;
 
 #ifdef ENABLE_SMART_CONFIG
 	bool smartConfigStart(SmartConfigType sctype, SmartConfigDelegate callback) override;
@@ -60,11 +67,17 @@ public:
 	void wpsConfigStop() override;
 #endif
 
+	// Called from WifiEventsImpl
+	void eventHandler(System_Event_t* evt);
+
 protected:
 	void onSystemReady() override;
 
 private:
 	static void staticScanCompleted(void* arg, STATUS status);
+	void applyFastConnect();
+	void saveFastConnect();
+	void abandonFastConnect();
 #ifdef ENABLE_SMART_CONFIG
 	void internalSmartConfig(sc_status status, void* pdata);
 #endif
@@ -74,7 +87,16 @@ private:
 
 private:
 	bool runScan = false;
+	bool fastConnect = false;
+	bool fastConnecting = false; ///< Attempt using saved details in progress
+	// Settings replaced during a fast connection attempt
+	uint8_t configuredChannel = 0;
+	bool configuredBssidSet = false;
+	bool configuredAllChannelScan = false;
+	bool configuredDhcp = true;
 #ifdef ENABLE_SMART_CONFIG
 	SmartConfigEventInfo* smartConfigEventInfo = nullptr; ///< Set during smart handling
 #endif
 };
+
+extern StationImpl station;
@@ -11,7 +11,7 @@
  */
 
 #include "WifiEventsImpl.h"
-#include <Platform/Station.h>
+#include "StationImpl.h"
 #include <esp_wifi.h>
 
 static WifiEventsImpl events;
@@ -25,6 +25,8 @@ WifiEventsImpl::WifiEventsImpl()
 void WifiEventsImpl::WifiEventHandler(System_Event_t* evt)
 {
 	//	debugf("event %x\n", evt->event);
+	station.eventHandler(evt);
+
 
 	switch(evt->event) {
 	case EVENT_STAMODE_CONNECTED:
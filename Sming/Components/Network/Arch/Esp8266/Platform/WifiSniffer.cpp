@@ -14,10 +14,18 @@
 
 #include "Platform/WifiSniffer.h"
 #include "esp_wifi_sniffer.h"
+#include <algorithm>
 
 WifiSnifferCallback WifiSniffer::snifferCallback;
 WifiBeaconCallback WifiSniffer::beaconCallback;
 WifiClientCallback WifiSniffer::clientCallback;
+WifiFramesCallback WifiSniffer::framesCallback;
+WifiSnifferFilter WifiSniffer::filter;
+std::unique_ptr<WifiSnifferFrame[]> WifiSniffer::frames;
+volatile uint16_t WifiSniffer::head;
+volatile uint16_t WifiSniffer::tail;
+volatile bool WifiSniffer::deliveryQueued;
+volatile uint32_t WifiSniffer::droppedFrames;
 
 static const uint8_t broadcast1[3] = {0x01, 0x00, 0x5e};
 static const uint8_t broadcast2[6] = {0xff, 0xff, 0xff, 0xff, 0xff, 0xff};
@@ -124,15 +132,116 @@ static void parseBeaconInfo(BeaconInfo& bi, uint8_t* frame, uint16_t framelen, i
 	memcpy(&bi.bssid[0], frame + 10, ETH_MAC_LEN);
 }
 
+/*
+ * Check address fields 1-3, present in all management and data frames
+ */
+static bool matchAddress(const uint8_t* frame, const MacAddress& addr)
+{
+	for(unsigned offset : {4, 10, 16}) {
+		if(memcmp(frame + offset, &addr[0], ETH_MAC_LEN) == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool WifiSniffer::queueFrame(const uint8_t* frame, uint16_t length, int8_t rssi, uint8_t channel)
+{
+	uint16_t next = (head + 1) % WIFI_SNIFFER_QUEUE_SIZE;
+	if(next == tail) {
+		++droppedFrames;
+		return false;
+	}
+
+	auto& f = frames[head];
+	f.length = std::min(length, uint16_t(WIFI_SNIFFER_HEADER_SIZE));
+	memcpy(f.header, frame, f.length);
+	f.rssi = rssi;
+	f.channel = channel;
+	head = next;
+
+	// Wake the consumer once per batch, not for every frame
+	if(!deliveryQueued) {
+		deliveryQueued = System.queueCallback(deliverFrames);
+	}
+	return true;
+}
+
+void WifiSniffer::deliverFrames()
+{
+	deliveryQueued = false;
+	if(!framesCallback || !frames) {
+		return;
+	}
+
+	// Frames are contiguous up to the end of the buffer, so a wrapped batch is passed in two parts
+	uint16_t end = head;
+	while(tail != end) {
+		uint16_t count = (end > tail) ? (end - tail) : (WIFI_SNIFFER_QUEUE_SIZE - tail);
+		framesCallback(&frames[tail], count);
+		tail = (tail + count) % WIFI_SNIFFER_QUEUE_SIZE;
+	}
+}
+
+void WifiSniffer::onFrames(WifiFramesCallback callback)
+{
+	if(callback) {
+		if(!frames) {
+			head = tail = 0;
+			frames.reset(new WifiSnifferFrame[WIFI_SNIFFER_QUEUE_SIZE]);
+		}
+		framesCallback = callback;
+	} else {
+		framesCallback = nullptr;
+		frames.reset();
+	}
+}
+
 void WifiSniffer::parseData(uint8_t* buf, uint16_t len)
 {
+	if(len == 12) {
+		// Only RxControl, no frame data available
+		if(snifferCallback && filter.types == WifiSnifferFilter::All) {
+			snifferCallback(buf, len);
+		}
+		return;
+	}
+
+	// Filter using information available before any parsing
+	auto rxControl = reinterpret_cast<const RxControl*>(buf);
+	int8_t rssi = rxControl->rssi;
+	if(rssi < filter.minRssi) {
+		return;
+	}
+
+	bool isManagement = (len == 128);
+	if(!(filter.types & (isManagement ? WifiSnifferFilter::Management : WifiSnifferFilter::Data))) {
+		return;
+	}
+
+	uint8_t* frame;
+	uint16_t frameLength;
+	if(isManagement) {
+		frame = reinterpret_cast<sniffer_buf2*>(buf)->buf;
+		frameLength = sizeof(sniffer_buf2::buf);
+	} else {
+		frame = reinterpret_cast<sniffer_buf*>(buf)->buf;
+		frameLength = sizeof(sniffer_buf::buf);
+	}
+
+	if(filter.address && !matchAddress(frame, filter.address)) {
+		return;
+	}
+
 	if(snifferCallback) {
 		snifferCallback(buf, len);
 	}
 
-	if(len == 12) {
-		//auto data = reinterpret_cast<RxControl*>(buf);
-	} else if(len == 128) {
+	if(frames) {
+		queueFrame(frame, frameLength, rssi, rxControl->channel);
+	}
+
+	if(isManagement) {
 		if(beaconCallback) {
 			auto data = reinterpret_cast<sniffer_buf2*>(buf);
 			BeaconInfo beacon;
@@ -5,6 +5,7 @@ COMPONENT_SRCDIRS := \
 
 COMPONENT_INCDIRS := \
 	src \
+	lwip-profile \
 	Arch/$(SMING_ARCH)/include
 
 COMPONENT_DOXYGEN_INPUT := \
@@ -15,12 +16,14 @@ COMPONENT_DOCFILES := \
 	docs/http/*
 
 COMPONENT_DEPENDS := \
+	crypto \
 	ssl \
 	http-parser \
 	libb64 \
 	ws_parser \
 	mqtt-codec \
-	libyuarel
+	libyuarel \
+	uzlib
 
 # WiFi settings may be provide via Environment variables
 CONFIG_VARS				+= WIFI_SSID WIFI_PWD
@@ -50,19 +53,41 @@ COMPONENT_VARS			+= HTTP_SERVER_EXPOSE_VERSION
 HTTP_SERVER_EXPOSE_VERSION ?= 0
 GLOBAL_CFLAGS			+= -DHTTP_SERVER_EXPOSE_VERSION=$(HTTP_SERVER_EXPOSE_VERSION)
 
+COMPONENT_VARS			+= HTTP_SERVER_PIPELINE_BUFSIZE
+HTTP_SERVER_PIPELINE_BUFSIZE ?= 2048
+GLOBAL_CFLAGS			+= -DHTTP_SERVER_PIPELINE_BUFSIZE=$(HTTP_SERVER_PIPELINE_BUFSIZE)
+
+# => TCP
+COMPONENT_VARS			+= TCP_SEND_QUANTUM
+TCP_SEND_QUANTUM		?= 1460
+GLOBAL_CFLAGS			+= -DTCP_SEND_QUANTUM=$(TCP_SEND_QUANTUM)
+
 # => LWIP
+COMPONENT_VARS			+= LWIP_PROFILE
+include $(COMPONENT_PATH)/lwip-profile/lwip-profile.mk
+GLOBAL_CFLAGS			+= -D$(LWIP_PROFILE_DEFINE)
+
 COMPONENT_VARS			+= ENABLE_CUSTOM_LWIP
 ifeq ($(SMING_ARCH),Esp8266)
 
 ENABLE_CUSTOM_LWIP		?= 1
 ifeq ($(ENABLE_CUSTOM_LWIP), 0)
 	COMPONENT_DEPENDS	+= esp-lwip
+ifneq ($(LWIP_PROFILE),default)
+$(error LWIP_PROFILE requires ENABLE_CUSTOM_LWIP=1 or 2 as the SDK library is precompiled)
+endif
 else ifeq ($(ENABLE_CUSTOM_LWIP), 1)
 	COMPONENT_DEPENDS	+= esp-open-lwip
 else ifeq ($(ENABLE_CUSTOM_LWIP), 2)
 	COMPONENT_DEPENDS	+= lwip2
 endif
 
+else ifeq ($(SMING_ARCH),Esp32)
+
+ifneq ($(LWIP_PROFILE),default)
+$(error LWIP_PROFILE is not supported for Esp32, configure lwIP using SDK_CUSTOM_CONFIG instead)
+endif
+
 else ifeq ($(SMING_ARCH),Host)
 
 COMPONENT_DEPENDS += \
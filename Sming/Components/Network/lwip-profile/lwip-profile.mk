@@ -0,0 +1,14 @@
+# lwIP memory profile settings, shared by Network and the Components which build lwIP.
+# See lwip_profile.h.
+
+LWIP_PROFILE			?= default
+LWIP_PROFILES			:= default connections throughput lowmem
+ifeq (,$(filter $(LWIP_PROFILES),$(LWIP_PROFILE)))
+$(error LWIP_PROFILE must be one of: $(LWIP_PROFILES))
+endif
+
+LWIP_PROFILE_DIR		:= $(SMING_HOME)/Components/Network/lwip-profile
+LWIP_PROFILE_DEFINE		:= LWIP_PROFILE=LWIP_PROFILE_$(call ToUpper,$(LWIP_PROFILE))
+
+# For stacks whose lwipopts.h cannot include the profile itself
+LWIP_PROFILE_CFLAGS		:= -D$(LWIP_PROFILE_DEFINE) -include $(LWIP_PROFILE_DIR)/lwip_profile.h
@@ -0,0 +1,143 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * lwip_profile.h - Preset lwIP memory configurations
+ *
+ * Included ahead of `lwipopts.h` so that a profile takes precedence over the stack defaults.
+ * Every value is guarded so individual options may still be set on the command line.
+ *
+ * The profile is selected using the LWIP_PROFILE build variable.
+ * See the Network component documentation for details.
+ *
+ ****/
+
+#pragma once
+
+#define LWIP_PROFILE_DEFAULT 0
+#define LWIP_PROFILE_CONNECTIONS 1
+#define LWIP_PROFILE_THROUGHPUT 2
+#define LWIP_PROFILE_LOWMEM 3
+
+#ifndef LWIP_PROFILE
+#define LWIP_PROFILE LWIP_PROFILE_DEFAULT
+#endif
+
+#if LWIP_PROFILE == LWIP_PROFILE_CONNECTIONS
+
+/*
+ * Many concurrent connections exchanging small messages.
+ * Window and send buffer are kept at the minimum lwIP accepts so each connection stays cheap.
+ */
+#ifndef MEMP_NUM_TCP_PCB
+#define MEMP_NUM_TCP_PCB 16
+#endif
+#ifndef MEMP_NUM_TCP_PCB_LISTEN
+#define MEMP_NUM_TCP_PCB_LISTEN 4
+#endif
+#ifndef TCP_WND
+#define TCP_WND (2 * TCP_MSS)
+#endif
+#ifndef TCP_SND_BUF
+#define TCP_SND_BUF (2 * TCP_MSS)
+#endif
+#ifndef TCP_SND_QUEUELEN
+#define TCP_SND_QUEUELEN ((4 * (TCP_SND_BUF) + (TCP_MSS - 1)) / (TCP_MSS))
+#endif
+#ifndef MEMP_NUM_TCP_SEG
+#define MEMP_NUM_TCP_SEG 48
+#endif
+#ifndef MEMP_NUM_PBUF
+#define MEMP_NUM_PBUF 24
+#endif
+#ifndef PBUF_POOL_SIZE
+#define PBUF_POOL_SIZE 16
+#endif
+#ifndef MEM_SIZE
+#define MEM_SIZE 32000
+#endif
+
+#elif LWIP_PROFILE == LWIP_PROFILE_THROUGHPUT
+
+/*
+ * A few connections moving bulk data, such as file transfers.
+ * Larger windows keep more segments in flight per round trip.
+ */
+#ifndef MEMP_NUM_TCP_PCB
+#define MEMP_NUM_TCP_PCB 5
+#endif
+#ifndef MEMP_NUM_TCP_PCB_LISTEN
+#define MEMP_NUM_TCP_PCB_LISTEN 2
+#endif
+#ifndef TCP_WND
+#define TCP_WND (8 * TCP_MSS)
+#endif
+#ifndef TCP_SND_BUF
+#define TCP_SND_BUF (8 * TCP_MSS)
+#endif
+#ifndef TCP_SND_QUEUELEN
+#define TCP_SND_QUEUELEN ((4 * (TCP_SND_BUF) + (TCP_MSS - 1)) / (TCP_MSS))
+#endif
+#ifndef MEMP_NUM_TCP_SEG
+#define MEMP_NUM_TCP_SEG 64
+#endif
+#ifndef MEMP_NUM_PBUF
+#define MEMP_NUM_PBUF 32
+#endif
+#ifndef PBUF_POOL_SIZE
+#define PBUF_POOL_SIZE 32
+#endif
+#ifndef MEM_SIZE
+#define MEM_SIZE 48000
+#endif
+
+#elif LWIP_PROFILE == LWIP_PROFILE_LOWMEM
+
+/*
+ * Smallest usable footprint, for applications with one or two connections.
+ */
+#ifndef MEMP_NUM_TCP_PCB
+#define MEMP_NUM_TCP_PCB 4
+#endif
+#ifndef MEMP_NUM_TCP_PCB_LISTEN
+#define MEMP_NUM_TCP_PCB_LISTEN 2
+#endif
+#ifndef TCP_WND
+#define TCP_WND (2 * TCP_MSS)
+#endif
+#ifndef TCP_SND_BUF
+#define TCP_SND_BUF (2 * TCP_MSS)
+#endif
+#ifndef TCP_SND_QUEUELEN
+#define TCP_SND_QUEUELEN ((4 * (TCP_SND_BUF) + (TCP_MSS - 1)) / (TCP_MSS))
+#endif
+#ifndef MEMP_NUM_TCP_SEG
+#define MEMP_NUM_TCP_SEG 16
+#endif
+#ifndef MEMP_NUM_PBUF
+#define MEMP_NUM_PBUF 8
+#endif
+#ifndef PBUF_POOL_SIZE
+#define PBUF_POOL_SIZE 8
+#endif
+#ifndef MEM_SIZE
+#define MEM_SIZE 8000
+#endif
+
+#elif LWIP_PROFILE != LWIP_PROFILE_DEFAULT
+#error "Unknown LWIP_PROFILE"
+#endif
+
+/**
+ * @brief Check a profile produces a usable configuration
+ * @note Use after all lwIP options have been defined, i.e. after including `lwip/opt.h`
+ */
+#define LWIP_PROFILE_CHECK()                                                                                           \
+	static_assert(TCP_WND >= 2 * TCP_MSS, "TCP_WND must be at least 2 * TCP_MSS");                                    \
+	static_assert(LWIP_WND_SCALE || TCP_WND <= 0xffff, "TCP_WND requires window scaling");                            \
+	static_assert(TCP_SND_BUF >= 2 * TCP_MSS, "TCP_SND_BUF must be at least 2 * TCP_MSS");                            \
+	static_assert(TCP_SND_QUEUELEN >= 2 * (TCP_SND_BUF / TCP_MSS), "TCP_SND_QUEUELEN too small for TCP_SND_BUF");     \
+	static_assert(MEMP_NUM_TCP_SEG >= TCP_SND_QUEUELEN, "MEMP_NUM_TCP_SEG must be at least TCP_SND_QUEUELEN");        \
+	static_assert(MEM_LIBC_MALLOC || MEM_SIZE >= 2 * TCP_SND_BUF, "MEM_SIZE cannot hold two full send buffers")
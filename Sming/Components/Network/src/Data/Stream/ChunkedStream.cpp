@@ -11,29 +11,99 @@
  ****/
 
 #include "ChunkedStream.h"
+#include <algorithm>
 
-ChunkedStream::ChunkedStream(IDataSourceStream* stream, size_t resultSize)
-	: StreamTransformer(stream, resultSize, resultSize - 12)
+namespace
 {
+constexpr char lastChunk[]{"0\r\n\r\n"};
+
+// Chunk size is at most 4 hex digits, "FFFF\r\n"
+constexpr size_t headerSpace{6};
+
+// Chunk data is followed by "\r\n", then the last chunk if source is finished
+constexpr size_t trailerSpace{2 + sizeof(lastChunk) - 1};
+
+} // namespace
+
+ChunkedStream::ChunkedStream(IDataSourceStream* stream, size_t bufferSize)
+	: sourceStream(stream), bufferSize(std::min(std::max(bufferSize, headerSpace + trailerSpace + 16), size_t(0xffff)))
+{
+}
+
+bool ChunkedStream::fill()
+{
+	readPos = endPos = 0;
+	if(finished || !isValid()) {
+		return false;
+	}
+
+	if(!buffer) {
+		buffer.reset(new char[bufferSize]);
+		if(!buffer) {
+			return false;
+		}
+	}
+
+	// Source data goes straight into place after the header
+	char* data = &buffer[headerSpace];
+	size_t length = sourceStream->readMemoryBlock(data, bufferSize - headerSpace - trailerSpace);
+	if(length != 0 && !sourceStream->seek(length)) {
+		length = 0;
+	}
+
+	size_t pos = headerSpace;
+	if(length != 0) {
+		// Header immediately precedes data, so write hex length backwards
+		readPos = headerSpace - 2;
+		memcpy(&buffer[readPos], "\r\n", 2);
+		for(auto n = length; n != 0; n >>= 4) {
+			buffer[--readPos] = "0123456789ABCDEF"[n & 0x0f];
+		}
+		pos += length;
+		memcpy(&buffer[pos], "\r\n", 2);
+		pos += 2;
+	} else {
+		readPos = pos;
+	}
+
+	if(sourceStream->isFinished()) {
+		memcpy(&buffer[pos], lastChunk, sizeof(lastChunk) - 1);
+		pos += sizeof(lastChunk) - 1;
+		finished = true;
+	}
+
+	endPos = pos;
+	return endPos > readPos;
 }
 
-size_t ChunkedStream::transform(const uint8_t* source, size_t sourceLength, uint8_t* target, size_t targetLength)
+size_t ChunkedStream::peekRegion(const char*& data)
 {
-	if(sourceLength == 0) {
-		memcpy(target, _F("0\r\n\r\n"), 5);
-		return 5;
+	if(readPos >= endPos && !fill()) {
+		return 0;
 	}
 
-	// Header
-	unsigned offset = m_snprintf(reinterpret_cast<char*>(target), targetLength, "%X\r\n", sourceLength);
+	data = &buffer[readPos];
+	return endPos - readPos;
+}
 
-	// Content
-	memcpy(target + offset, source, sourceLength);
-	offset += sourceLength;
+uint16_t ChunkedStream::readMemoryBlock(char* data, int bufSize)
+{
+	const char* ptr;
+	size_t count = peekRegion(ptr);
+	if(count == 0) {
+		return 0;
+	}
+	count = std::min(count, size_t(bufSize));
+	memcpy(data, ptr, count);
+	return count;
+}
 
-	// Footer
-	memcpy(target + offset, "\r\n", 2);
-	offset += 2;
+bool ChunkedStream::seek(int len)
+{
+	if(len < 0 || size_t(len) > size_t(endPos - readPos)) {
+		return false;
+	}
 
-	return offset;
+	readPos += len;
+	return true;
 }
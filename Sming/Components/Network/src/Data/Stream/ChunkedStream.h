@@ -12,20 +12,64 @@
 
 #pragma once
 
-#include <Data/StreamTransformer.h>
+#include <Data/Stream/DataSourceStream.h>
+#include <memory>
 
 /**
  * @brief Read-only stream to obtain data using HTTP chunked encoding
  *
  * Used where total length of stream is not known in advance
  *
+ * Source data is read directly into a buffer after space reserved for the chunk header,
+ * which is written in once the length is known. Each chunk, including header and trailer,
+ * is then available as a single contiguous block via `peekRegion()`.
+ * The terminating zero-length chunk is appended to the final block.
+ *
  * @ingroup  stream data
  */
-class ChunkedStream : public StreamTransformer
+class ChunkedStream : public IDataSourceStream
 {
 public:
-	ChunkedStream(IDataSourceStream* stream, size_t resultSize = 512);
+	/**
+	 * @brief Constructor
+	 * @param stream Source data. Will be deleted after use.
+	 * @param bufferSize Size of encoding buffer, which limits the chunk size
+	 */
+	ChunkedStream(IDataSourceStream* stream, size_t bufferSize = 1024);
+
+	StreamType getStreamType() const override
+	{
+		return sourceStream ? sourceStream->getStreamType() : eSST_Invalid;
+	}
+
+	bool isValid() const override
+	{
+		return sourceStream && sourceStream->isValid();
+	}
+
+	uint16_t readMemoryBlock(char* data, int bufSize) override;
+
+	size_t peekRegion(const char*& data) override;
+
+	bool seek(int len) override;
+
+	bool isFinished() override
+	{
+		return (finished || !sourceStream) && readPos >= endPos;
+	}
+
+	String getName() const override
+	{
+		return sourceStream ? sourceStream->getName() : String::nullstr;
+	}
+
+private:
+	bool fill();
 
-protected:
-	size_t transform(const uint8_t* source, size_t sourceLength, uint8_t* target, size_t targetLength) override;
+	std::unique_ptr<IDataSourceStream> sourceStream;
+	std::unique_ptr<char[]> buffer;
+	uint16_t bufferSize;
+	uint16_t readPos{0};
+	uint16_t endPos{0};
+	bool finished{false}; ///< Terminating chunk has been produced
 };
@@ -0,0 +1,157 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * DeflateOutputStream.cpp
+ *
+ ****/
+
+#include "DeflateOutputStream.h"
+#include <Crypto/Crc.h>
+
+namespace
+{
+// Hash table has 2^HASH_BITS entries
+constexpr unsigned HASH_BITS{8};
+// Window must hold at least one source block, and compressed output must fit into the transformer buffer
+constexpr size_t BLOCK_SIZE{64};
+constexpr size_t MAX_WINDOW_SIZE{768};
+
+constexpr size_t clampWindowSize(size_t size)
+{
+	return (size < BLOCK_SIZE) ? BLOCK_SIZE : (size > MAX_WINDOW_SIZE) ? MAX_WINDOW_SIZE : size;
+}
+
+// Each static Huffman code is at most 9 bits for literals, plus block header and end code
+constexpr size_t maxCompressedSize(size_t length)
+{
+	return length + (length / 8) + 4;
+}
+
+} // namespace
+
+DeflateOutputStream::DeflateOutputStream(IDataSourceStream* stream, Format format, size_t windowSize)
+	: StreamTransformer(stream, maxCompressedSize(clampWindowSize(windowSize)) + 24, BLOCK_SIZE), format(format),
+	  windowSize(clampWindowSize(windowSize))
+{
+	buffer.reset(new uint8_t[this->windowSize * 2]);
+	comp.hash_bits = HASH_BITS;
+	comp.dict_size = this->windowSize;
+	comp.hash_table = new uzlib_hash_entry_t[1U << HASH_BITS];
+	state.checksum = (format == Format::Gzip) ? 0U : 1U;
+}
+
+size_t DeflateOutputStream::transform(const uint8_t* source, size_t sourceLength, uint8_t* target,
+									  size_t targetLength)
+{
+	(void)targetLength;
+
+	if(!buffer || !comp.hash_table || state.finished) {
+		return 0;
+	}
+
+	size_t outLength{0};
+	if(!state.started) {
+		outLength += writeHeader(target);
+		state.started = true;
+	}
+
+	if(sourceLength == 0) {
+		outLength += compressWindow(true, &target[outLength]);
+		outLength += writeTrailer(&target[outLength]);
+		state.finished = true;
+		return outLength;
+	}
+
+	if(format == Format::Gzip) {
+		state.checksum = Crypto::crc32(source, sourceLength, state.checksum);
+	} else if(format == Format::Zlib) {
+		state.checksum = Crypto::adler32(source, sourceLength, state.checksum);
+	}
+	state.totalLength += sourceLength;
+
+	// Whole of source must be consumed: compress the current window first if it won't fit
+	auto space = windowSize - state.windowLength;
+	if(sourceLength > space) {
+		outLength += compressWindow(false, &target[outLength]);
+	}
+
+	memcpy(&window()[state.windowLength], source, sourceLength);
+	state.windowLength += sourceLength;
+
+	return outLength;
+}
+
+size_t DeflateOutputStream::compressWindow(bool final, uint8_t* target)
+{
+	auto& out = comp.out;
+
+	// Block header: BFINAL, then BTYPE=01 (static Huffman)
+	outbits(&out, final ? 1 : 0, 1);
+	outbits(&out, 1, 2);
+
+	if(state.windowLength != 0) {
+		// Matches must not refer to the other half of the buffer
+		memset(comp.hash_table, 0, sizeof(uzlib_hash_entry_t) << comp.hash_bits);
+		uzlib_compress(&comp, window(), state.windowLength);
+	}
+
+	// End of block code
+	outbits(&out, 0, 7);
+	if(final) {
+		// Flush remaining bits
+		outbits(&out, 0, 7);
+	}
+
+	// New data goes into the other half, leaving this one intact for restoreState()
+	state.windowIndex ^= 1;
+	state.windowLength = 0;
+
+	auto length = size_t(out.outlen);
+	memcpy(target, out.outbuf, length);
+	out.outlen = 0;
+	return length;
+}
+
+size_t DeflateOutputStream::writeHeader(uint8_t* target)
+{
+	if(format == Format::Raw) {
+		return 0;
+	}
+
+	if(format == Format::Zlib) {
+		// CM=8 (deflate), CINFO=7 (32K window), FLEVEL=0
+		target[0] = 0x78;
+		target[1] = 0x01;
+		return 2;
+	}
+
+	// ID1, ID2, CM=deflate, FLG=0, MTIME=0, XFL=0, OS=unknown
+	const uint8_t header[]{0x1f, 0x8b, 0x08, 0, 0, 0, 0, 0, 0, 0xff};
+	memcpy(target, header, sizeof(header));
+	return sizeof(header);
+}
+
+size_t DeflateOutputStream::writeTrailer(uint8_t* target)
+{
+	auto put = [&](unsigned offset, uint32_t value, bool bigEndian) {
+		for(unsigned i = 0; i < 4; ++i) {
+			target[offset + i] = value >> (bigEndian ? (24 - i * 8) : (i * 8));
+		}
+	};
+
+	if(format == Format::Raw) {
+		return 0;
+	}
+
+	if(format == Format::Zlib) {
+		put(0, state.checksum, true);
+		return 4;
+	}
+
+	put(0, state.checksum, false);
+	put(4, state.totalLength, false);
+	return 8;
+}
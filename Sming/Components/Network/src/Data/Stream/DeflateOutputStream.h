@@ -0,0 +1,102 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * DeflateOutputStream.h
+ *
+ ****/
+
+#pragma once
+
+#include <Data/StreamTransformer.h>
+#include <uzlib.h>
+
+/**
+ * @brief Default size of compression window
+ * @note Memory usage is around twice this, plus the hash table
+ */
+#ifndef DEFLATE_STREAM_WINDOW_SIZE
+#define DEFLATE_STREAM_WINDOW_SIZE 512
+#endif
+
+/**
+ * @brief Read-only stream to emit compressed content from source stream
+ *
+ * Source data is gathered into fixed-size windows, each of which is compressed
+ * independently using LZ77 matching and static Huffman codes. Compression ratio
+ * is therefore somewhat less than a desktop implementation, in exchange for
+ * small, bounded memory use.
+ *
+ * @ingroup stream data
+ */
+class DeflateOutputStream : public StreamTransformer
+{
+public:
+	enum class Format {
+		Gzip, ///< RFC 1952, for `Content-Encoding: gzip`
+		Zlib, ///< RFC 1950, for `Content-Encoding: deflate`
+		Raw,  ///< RFC 1951 data only, e.g. for websocket permessage-deflate
+	};
+
+	/**
+	 * @brief Stream that compresses data from another stream
+	 * @param stream Source stream
+	 * @param format Container format for the compressed data
+	 * @param windowSize Size of compression window, from 64 to 768 bytes
+	 */
+	DeflateOutputStream(IDataSourceStream* stream, Format format = Format::Gzip,
+						size_t windowSize = DEFLATE_STREAM_WINDOW_SIZE);
+
+	~DeflateOutputStream()
+	{
+		free(comp.out.outbuf);
+		delete[] comp.hash_table;
+	}
+
+	size_t transform(const uint8_t* source, size_t sourceLength, uint8_t* target, size_t targetLength) override;
+
+	void saveState() override
+	{
+		savedState = state;
+		savedState.outbits = comp.out.outbits;
+		savedState.noutbits = comp.out.noutbits;
+	}
+
+	void restoreState() override
+	{
+		state = savedState;
+		comp.out.outbits = state.outbits;
+		comp.out.noutbits = state.noutbits;
+		comp.out.outlen = 0;
+	}
+
+private:
+	size_t writeHeader(uint8_t* target);
+	size_t writeTrailer(uint8_t* target);
+	size_t compressWindow(bool final, uint8_t* target);
+
+	uint8_t* window()
+	{
+		return buffer.get() + (state.windowIndex * windowSize);
+	}
+
+	struct State {
+		size_t windowLength;  ///< Bytes of source data in current window
+		uint32_t checksum;	///< CRC32 or Adler32 of all source data
+		uint32_t totalLength; ///< Total source bytes
+		unsigned long outbits;
+		int noutbits;
+		uint8_t windowIndex; ///< Which half of the buffer is in use
+		bool started;
+		bool finished;
+	};
+
+	Format format;
+	size_t windowSize;
+	std::unique_ptr<uint8_t[]> buffer; ///< Double-buffered so a window survives restoreState()
+	uzlib_comp comp{};
+	State state{};
+	State savedState{};
+};
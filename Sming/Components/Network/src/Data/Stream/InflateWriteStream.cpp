@@ -0,0 +1,149 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * InflateWriteStream.cpp
+ *
+ ****/
+
+#include "InflateWriteStream.h"
+#include <debug_progmem.h>
+
+namespace
+{
+/*
+ * Input held back so a decode step cannot run out of data part way through.
+ * A dynamic block header needs up to ~290 bytes, and each output byte at most 6 bytes
+ * (15-bit length code plus 5 extra bits, 15-bit distance code plus 13 extra bits).
+ */
+constexpr size_t LOOKAHEAD_SIZE{320};
+constexpr size_t MAX_INPUT_PER_OUTPUT{6};
+constexpr size_t INPUT_BUFFER_SIZE{LOOKAHEAD_SIZE + 512};
+constexpr size_t OUTPUT_CHUNK_SIZE{128};
+
+} // namespace
+
+InflateWriteStream::InflateWriteStream(ReadWriteStream* target, Format format, size_t windowSize)
+	: StreamWrapper(target), windowSize(windowSize), format(format)
+{
+	buffer.reset(new uint8_t[windowSize + INPUT_BUFFER_SIZE]);
+	if(!buffer) {
+		status = TINF_DATA_ERROR;
+		return;
+	}
+	uzlib_init();
+	uzlib_uncompress_init(&state, buffer.get(), windowSize);
+	state.source = state.source_limit = &buffer[windowSize];
+	state.source_read_cb = nullptr;
+	headerDone = (format == Format::Raw);
+}
+
+size_t InflateWriteStream::write(const uint8_t* data, size_t size)
+{
+	if(status < 0) {
+		return 0;
+	}
+	if(status > 0) {
+		// Discard anything following end of compressed data
+		return size;
+	}
+
+	auto input = &buffer[windowSize];
+	size_t written{0};
+	while(written < size) {
+		// Discard consumed input
+		auto consumed = state.source - input;
+		inputLength -= consumed;
+		memmove(input, state.source, inputLength);
+
+		auto len = std::min(size - written, INPUT_BUFFER_SIZE - inputLength);
+		if(len == 0) {
+			// Decoder stalled with a full buffer
+			status = TINF_DATA_ERROR;
+			return 0;
+		}
+		memcpy(&input[inputLength], &data[written], len);
+		inputLength += len;
+		written += len;
+		state.source = input;
+		state.source_limit = input + inputLength;
+
+		if(!decode(false)) {
+			return 0;
+		}
+		if(status > 0) {
+			break;
+		}
+	}
+
+	return size;
+}
+
+bool InflateWriteStream::finish()
+{
+	if(status == 0) {
+		decode(true);
+	}
+	if(status == 0) {
+		// Stream ended early
+		status = TINF_DATA_ERROR;
+	}
+	return status > 0;
+}
+
+bool InflateWriteStream::decode(bool final)
+{
+	uint8_t output[OUTPUT_CHUNK_SIZE];
+
+	while(status == 0) {
+		size_t available = state.source_limit - state.source;
+		if(!final && available <= LOOKAHEAD_SIZE) {
+			break;
+		}
+
+		if(!headerDone) {
+			int res = (format == Format::Gzip) ? uzlib_gzip_parse_header(&state) : uzlib_zlib_parse_header(&state);
+			if(res < 0) {
+				debug_w("[INFLATE] Bad header %d", res);
+				status = res;
+				break;
+			}
+			if(format == Format::Zlib && (1U << (res + 8)) > windowSize) {
+				debug_w("[INFLATE] Compression window %u exceeds dictionary %u", 1U << (res + 8), windowSize);
+			}
+			headerDone = true;
+			continue;
+		}
+
+		// Limit output so input consumed stays within the lookahead
+		size_t outputLength = final ? sizeof(output)
+									: std::min(std::max((available - LOOKAHEAD_SIZE) / MAX_INPUT_PER_OUTPUT, size_t(1)),
+											   sizeof(output));
+		auto source = state.source;
+		state.dest_start = state.dest = output;
+		state.dest_limit = output + outputLength;
+		int res = (format == Format::Raw) ? uzlib_uncompress(&state) : uzlib_uncompress_chksum(&state);
+		size_t produced = state.dest - output;
+		if(produced != 0 && getSource()->write(output, produced) != produced) {
+			status = TINF_DATA_ERROR;
+			break;
+		}
+		if(res == TINF_DONE) {
+			status = 1;
+			break;
+		}
+		if(res != TINF_OK) {
+			debug_w("[INFLATE] Error %d", res);
+			status = res;
+			break;
+		}
+		if(produced == 0 && state.source == source) {
+			// No progress, input exhausted
+			break;
+		}
+	}
+
+	return status >= 0;
+}
@@ -0,0 +1,98 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * InflateWriteStream.h
+ *
+ ****/
+
+#pragma once
+
+#include <Data/Stream/StreamWrapper.h>
+#include <uzlib.h>
+#include <memory>
+
+/**
+ * @brief Size of decompression dictionary
+ *
+ * Must be at least as large as the window used by the compressor, or decoding fails.
+ * zlib and gzip default to 32K; servers may be configured to use less
+ * (e.g. `windowBits` for zlib, `gzip_window` for nginx).
+ */
+#ifndef INFLATE_STREAM_WINDOW_SIZE
+#ifdef ARCH_ESP8266
+#define INFLATE_STREAM_WINDOW_SIZE 8192
+#else
+#define INFLATE_STREAM_WINDOW_SIZE 32768
+#endif
+#endif
+
+/**
+ * @brief Write-only stream which decompresses data into another stream
+ *
+ * Compressed data is decoded as it is written so may be arriving in slices of any size,
+ * such as from the network. Memory used is the dictionary window plus about 1K of buffers.
+ * Reading is passed through to the target stream.
+ *
+ * uzlib cannot suspend decoding part way through a symbol, so a small amount of compressed
+ * input is held back until more arrives. Call `finish()` once all data has been written.
+ *
+ * @ingroup stream data
+ */
+class InflateWriteStream : public StreamWrapper
+{
+public:
+	enum class Format {
+		Gzip, ///< RFC 1952, for `Content-Encoding: gzip`
+		Zlib, ///< RFC 1950, for `Content-Encoding: deflate`
+		Raw,  ///< RFC 1951 data only
+	};
+
+	/**
+	 * @brief Construct an inflating stream
+	 * @param target Receives decompressed data, owned by this stream
+	 * @param format Container format of the compressed data
+	 * @param windowSize Size of dictionary, see INFLATE_STREAM_WINDOW_SIZE
+	 */
+	InflateWriteStream(ReadWriteStream* target, Format format = Format::Gzip,
+					   size_t windowSize = INFLATE_STREAM_WINDOW_SIZE);
+
+	size_t write(const uint8_t* buffer, size_t size) override;
+
+	/**
+	 * @brief Decode any remaining input
+	 * @retval bool true if the compressed stream was complete and valid
+	 */
+	bool finish();
+
+	/**
+	 * @brief Determine if decoding has failed
+	 */
+	bool hasError() const
+	{
+		return status < 0;
+	}
+
+	bool isValid() const override
+	{
+		return buffer && !hasError();
+	}
+
+	bool moveString(String& s) override
+	{
+		return getSource() ? getSource()->moveString(s) : false;
+	}
+
+private:
+	bool decode(bool final);
+
+	std::unique_ptr<uint8_t[]> buffer; ///< Dictionary followed by input
+	uzlib_uncomp state{};
+	size_t windowSize;
+	size_t inputLength{0}; ///< Bytes in input buffer
+	Format format;
+	int8_t status{0}; ///< 0 while in progress, 1 when done, negative on error
+	bool headerDone{false};
+};
@@ -0,0 +1,360 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * DnsResolver.cpp
+ *
+ ****/
+
+#include "DnsResolver.h"
+#include "UdpConnection.h"
+#include <Clock.h>
+#include <debug_progmem.h>
+#include <lwip/dns.h>
+
+DnsResolverClass DnsResolver;
+
+namespace
+{
+constexpr uint16_t MDNS_PORT{5353};
+constexpr uint16_t DNS_TYPE_A{1};
+constexpr uint16_t DNS_CLASS_IN{1};
+constexpr uint16_t DNS_FLAG_RESPONSE{0x8000};
+constexpr uint16_t MDNS_CLASS_MASK{0x7fff}; // Top bit is the cache-flush flag
+constexpr size_t DNS_HEADER_SIZE{12};
+
+bool isExpired(uint32_t expiry, uint32_t now)
+{
+	return int32_t(expiry - now) <= 0;
+}
+
+bool isLocalName(const String& name)
+{
+	constexpr char suffix[]{".local"};
+	constexpr size_t suffixLength{sizeof(suffix) - 1};
+	return name.length() > suffixLength && strcasecmp(name.c_str() + name.length() - suffixLength, suffix) == 0;
+}
+
+void appendUint16(String& s, uint16_t value)
+{
+	s += char(value >> 8);
+	s += char(value);
+}
+
+uint16_t readUint16(const uint8_t* data)
+{
+	return (data[0] << 8) | data[1];
+}
+
+/*
+ * Return the offset following an encoded, possibly compressed, name
+ */
+size_t skipName(const uint8_t* data, size_t size, size_t pos)
+{
+	while(pos < size) {
+		uint8_t len = data[pos];
+		if(len == 0) {
+			return pos + 1;
+		}
+		if((len & 0xc0) == 0xc0) {
+			return pos + 2;
+		}
+		pos += 1 + len;
+	}
+	return size + 1;
+}
+
+} // namespace
+
+err_t DnsResolverClass::resolve(const String& name, IpAddress& addr, Callback callback)
+{
+	// Numeric addresses need no lookup
+	ip_addr_t ip;
+	if(ipaddr_aton(name.c_str(), &ip)) {
+		addr = ip;
+		return ERR_OK;
+	}
+
+	auto now = millis();
+	auto entry = find(name);
+	if(entry == nullptr) {
+		entry = allocate(name);
+		if(entry == nullptr) {
+			debug_w("[DNS] Cache full");
+			return ERR_MEM;
+		}
+	} else {
+		entry->lastUsed = now;
+		bool expired = isExpired(entry->expiry, now);
+		if(entry->state == State::Resolved && !expired) {
+			addr = entry->addr;
+			// Refresh a frequently used name before it expires
+			if(!entry->pending && isExpired(entry->expiry, now + DNS_PREFETCH_TIME * 1000U)) {
+				debug_d("[DNS] Prefetch '%s'", name.c_str());
+				startLookup(*entry);
+			}
+			return ERR_OK;
+		}
+		if(entry->state == State::Failed && !expired) {
+			return ERR_VAL;
+		}
+	}
+
+	if(!entry->pending) {
+		startLookup(*entry);
+		if(!entry->pending) {
+			// Answered from lwIP's table
+			if(entry->state != State::Resolved) {
+				return ERR_VAL;
+			}
+			addr = entry->addr;
+			return ERR_OK;
+		}
+	}
+
+	if(callback) {
+		entry->waiters.add(new Waiter(callback));
+	}
+	return ERR_INPROGRESS;
+}
+
+void DnsResolverClass::clear()
+{
+	for(auto& entry : entries) {
+		if(!entry.pending) {
+			entry.state = State::Empty;
+			entry.name = nullptr;
+		}
+	}
+}
+
+DnsResolverClass::Entry* DnsResolverClass::find(const String& name)
+{
+	for(auto& entry : entries) {
+		if(entry.name.equalsIgnoreCase(name) && (entry.pending || entry.state != State::Empty)) {
+			return &entry;
+		}
+	}
+	return nullptr;
+}
+
+DnsResolverClass::Entry* DnsResolverClass::allocate(const String& name)
+{
+	// Prefer an unused entry, otherwise replace the least recently used one
+	auto now = millis();
+	Entry* oldest{nullptr};
+	for(auto& entry : entries) {
+		if(entry.pending) {
+			continue;
+		}
+		if(entry.state == State::Empty) {
+			oldest = &entry;
+			break;
+		}
+		if(oldest == nullptr || (now - entry.lastUsed) > (now - oldest->lastUsed)) {
+			oldest = &entry;
+		}
+	}
+
+	if(oldest != nullptr) {
+		oldest->name = name;
+		oldest->state = State::Empty;
+		oldest->lastUsed = now;
+	}
+	return oldest;
+}
+
+void DnsResolverClass::startLookup(Entry& entry)
+{
+	if(isLocalName(entry.name)) {
+		entry.pending = startMdnsLookup(entry);
+		if(!entry.pending) {
+			complete(entry, nullptr);
+		}
+		return;
+	}
+
+	ip_addr_t addr;
+	entry.pending = true;
+	err_t err = dns_gethostbyname(entry.name.c_str(), &addr, staticDnsCallback, &entry);
+	if(err != ERR_INPROGRESS) {
+		complete(entry, (err == ERR_OK) ? &addr : nullptr);
+	}
+}
+
+void DnsResolverClass::staticDnsCallback(const char* name, LWIP_IP_ADDR_T* ipaddr, void* arg)
+{
+	auto entry = static_cast<Entry*>(arg);
+	if(entry != nullptr && entry->pending) {
+		DnsResolver.complete(*entry, ipaddr);
+	}
+}
+
+void DnsResolverClass::complete(Entry& entry, const ip_addr_t* ipaddr, uint32_t recordTtl)
+{
+	entry.pending = false;
+	entry.mdnsAttempts = 0;
+	auto now = millis();
+
+	if(ipaddr != nullptr) {
+		entry.addr = *ipaddr;
+		entry.state = State::Resolved;
+		entry.expiry = now + ((recordTtl != 0 && recordTtl < ttl) ? recordTtl : ttl) * 1000U;
+		debug_d("[DNS] '%s' = %s", entry.name.c_str(), entry.addr.toString().c_str());
+	} else if(entry.state == State::Resolved && !isExpired(entry.expiry, now)) {
+		// Background refresh failed: keep using the current address until it expires
+		debug_w("[DNS] Refresh of '%s' failed", entry.name.c_str());
+	} else {
+		entry.state = State::Failed;
+		entry.expiry = now + negativeTtl * 1000U;
+		debug_w("[DNS] '%s' not found", entry.name.c_str());
+	}
+
+	/*
+	 * Callbacks may make further requests, which could re-use this entry,
+	 * so detach the waiters and take copies of the result first.
+	 */
+	auto waiters = entry.waiters;
+	entry.waiters.clear();
+	String name = entry.name;
+	IpAddress addr = entry.addr;
+	bool resolved = (entry.state == State::Resolved);
+
+	Waiter* waiter;
+	while((waiter = waiters.pop()) != nullptr) {
+		waiter->callback(name, resolved ? &addr : nullptr);
+		delete waiter;
+	}
+}
+
+bool DnsResolverClass::startMdnsLookup(Entry& entry)
+{
+	if(!mdnsConnection) {
+		mdnsConnection.reset(new UdpConnection(
+			[this](UdpConnection&, char* data, int size, IpAddress, uint16_t) {
+				mdnsReceive(reinterpret_cast<const uint8_t*>(data), size);
+			}));
+		// Any port other than 5353 makes this a one-shot query, answered by unicast
+		if(!mdnsConnection->listen(0)) {
+			debug_e("[DNS] mDNS socket failed");
+			mdnsConnection.reset();
+			return false;
+		}
+		mdnsTimer.initializeMs<DNS_MDNS_TIMEOUT>([](void* arg) { static_cast<DnsResolverClass*>(arg)->mdnsTimeout(); },
+												 this);
+	}
+
+	if(++mdnsLastId == 0) {
+		++mdnsLastId;
+	}
+	entry.mdnsId = mdnsLastId;
+	entry.mdnsAttempts = 0;
+	sendMdnsQuery(entry);
+	if(!mdnsTimer.isStarted()) {
+		mdnsTimer.start();
+	}
+	return true;
+}
+
+void DnsResolverClass::sendMdnsQuery(Entry& entry)
+{
+	++entry.mdnsAttempts;
+
+	String query;
+	query.reserve(DNS_HEADER_SIZE + entry.name.length() + 6);
+	appendUint16(query, entry.mdnsId);
+	appendUint16(query, 0); // Standard query
+	appendUint16(query, 1); // One question
+	appendUint16(query, 0);
+	appendUint16(query, 0);
+	appendUint16(query, 0);
+	// Name in wire format: "a.local" becomes "\1a\5local\0"
+	const char* ptr = entry.name.c_str();
+	const char* end = ptr + entry.name.length();
+	while(ptr < end) {
+		auto sep = static_cast<const char*>(memchr(ptr, '.', end - ptr));
+		auto labelEnd = sep ? sep : end;
+		query += char(labelEnd - ptr);
+		query.concat(ptr, labelEnd - ptr);
+		ptr = labelEnd + 1;
+	}
+	query += '\0';
+	appendUint16(query, DNS_TYPE_A);
+	appendUint16(query, DNS_CLASS_IN);
+
+	debug_d("[DNS] mDNS query '%s' #%u", entry.name.c_str(), entry.mdnsAttempts);
+	mdnsConnection->sendTo(IpAddress(224, 0, 0, 251), MDNS_PORT, query.c_str(), query.length());
+}
+
+void DnsResolverClass::mdnsReceive(const uint8_t* data, size_t size)
+{
+	if(size < DNS_HEADER_SIZE || (readUint16(&data[2]) & DNS_FLAG_RESPONSE) == 0) {
+		return;
+	}
+
+	auto id = readUint16(&data[0]);
+	Entry* entry{nullptr};
+	for(auto& e : entries) {
+		if(e.mdnsAttempts != 0 && e.mdnsId == id) {
+			entry = &e;
+			break;
+		}
+	}
+	if(entry == nullptr) {
+		// Late or duplicate answer, already dealt with
+		return;
+	}
+
+	auto questionCount = readUint16(&data[4]);
+	auto answerCount = readUint16(&data[6]);
+	size_t pos = DNS_HEADER_SIZE;
+	for(unsigned i = 0; i < questionCount; ++i) {
+		pos = skipName(data, size, pos) + 4;
+	}
+	for(unsigned i = 0; i < answerCount; ++i) {
+		pos = skipName(data, size, pos);
+		if(pos + 10 > size) {
+			return;
+		}
+		auto type = readUint16(&data[pos]);
+		auto cls = readUint16(&data[pos + 2]) & MDNS_CLASS_MASK;
+		uint32_t recordTtl = (readUint16(&data[pos + 4]) << 16) | readUint16(&data[pos + 6]);
+		auto dataLength = readUint16(&data[pos + 8]);
+		pos += 10;
+		if(pos + dataLength > size) {
+			return;
+		}
+		// A TTL of 0 announces the record is being withdrawn
+		if(type == DNS_TYPE_A && cls == DNS_CLASS_IN && dataLength == 4 && recordTtl != 0) {
+			IpAddress addr(data[pos], data[pos + 1], data[pos + 2], data[pos + 3]);
+			ip_addr_t ip = addr;
+			complete(*entry, &ip, recordTtl);
+			return;
+		}
+		pos += dataLength;
+	}
+}
+
+void DnsResolverClass::mdnsTimeout()
+{
+	for(auto& entry : entries) {
+		if(entry.mdnsAttempts == 0) {
+			continue;
+		}
+		if(entry.mdnsAttempts >= DNS_MDNS_ATTEMPTS) {
+			complete(entry, nullptr);
+		} else {
+			sendMdnsQuery(entry);
+		}
+	}
+
+	// Callbacks may have started further queries
+	for(auto& entry : entries) {
+		if(entry.mdnsAttempts != 0) {
+			return;
+		}
+	}
+	mdnsTimer.stop();
+}
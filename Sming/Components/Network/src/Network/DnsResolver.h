@@ -0,0 +1,177 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * DnsResolver.h - Caching host name resolver
+ *
+ ****/
+
+#pragma once
+
+#include <IpAddress.h>
+#include <WString.h>
+#include <Delegate.h>
+#include <Data/LinkedObjectList.h>
+#include <SimpleTimer.h>
+#include <lwip/err.h>
+#include <memory>
+
+class UdpConnection;
+
+/** @defgroup   dnsresolver DNS resolver
+ *  @brief      Caches host name lookups made via lwIP
+ *  @ingroup    networking
+ *  @{
+ */
+
+/**
+ * @brief Number of host names held in the cache
+ */
+#ifndef DNS_CACHE_SIZE
+#define DNS_CACHE_SIZE 8
+#endif
+
+/**
+ * @brief Default time in seconds a resolved address is kept
+ */
+#ifndef DNS_CACHE_TTL
+#define DNS_CACHE_TTL 300
+#endif
+
+/**
+ * @brief Default time in seconds a failed lookup is remembered
+ */
+#ifndef DNS_NEGATIVE_CACHE_TTL
+#define DNS_NEGATIVE_CACHE_TTL 10
+#endif
+
+/**
+ * @brief A name used within this many seconds of expiry is refreshed in the background
+ */
+#ifndef DNS_PREFETCH_TIME
+#define DNS_PREFETCH_TIME 30
+#endif
+
+/**
+ * @brief Time in milliseconds to wait for each multicast DNS query
+ */
+#ifndef DNS_MDNS_TIMEOUT
+#define DNS_MDNS_TIMEOUT 1000
+#endif
+
+/**
+ * @brief Number of times a multicast DNS query is sent before the lookup fails
+ */
+#ifndef DNS_MDNS_ATTEMPTS
+#define DNS_MDNS_ATTEMPTS 3
+#endif
+
+/**
+ * @brief Resolves host names with a cache in front of lwIP's own small table
+ *
+ * Addresses are kept for a fixed time, as lwIP does not report record TTLs.
+ * Failed lookups are also remembered for a short time. A name used shortly before
+ * its entry expires is looked up again in the background, so regular users never wait.
+ * Concurrent requests for the same name share a single query.
+ *
+ * Names ending in `.local` are resolved using one-shot multicast DNS queries (RFC 6762 section 5.1)
+ * and kept for the TTL given in the answer, up to the configured limit.
+ */
+class DnsResolverClass
+{
+public:
+	/**
+	 * @brief Callback invoked when a lookup completes
+	 * @param name Host name requested
+	 * @param addr The resolved address, or nullptr if the lookup failed
+	 */
+	using Callback = Delegate<void(const String& name, const IpAddress* addr)>;
+
+	/**
+	 * @brief Resolve a host name
+	 * @param name Host name, or IP address in dotted decimal form
+	 * @param addr Set to the address if immediately available
+	 * @param callback Invoked on completion, but only if ERR_INPROGRESS is returned
+	 * @retval err_t ERR_OK if `addr` has been set, ERR_INPROGRESS if a query is pending,
+	 * otherwise the lookup failed
+	 */
+	err_t resolve(const String& name, IpAddress& addr, Callback callback);
+
+	/**
+	 * @brief Set how long resolved addresses are kept
+	 * @param seconds
+	 */
+	void setTtl(uint16_t seconds)
+	{
+		ttl = seconds;
+	}
+
+	/**
+	 * @brief Set how long failed lookups are remembered
+	 * @param seconds Use 0 to disable negative caching
+	 */
+	void setNegativeTtl(uint16_t seconds)
+	{
+		negativeTtl = seconds;
+	}
+
+	/**
+	 * @brief Discard all cached results
+	 * @note Queries in progress are unaffected
+	 */
+	void clear();
+
+private:
+	class Waiter : public LinkedObjectTemplate<Waiter>
+	{
+	public:
+		Waiter(Callback callback) : callback(callback)
+		{
+		}
+
+		Callback callback;
+	};
+
+	enum class State {
+		Empty,
+		Resolved,
+		Failed,
+	};
+
+	struct Entry {
+		String name;
+		IpAddress addr;
+		// Times are millis() values
+		uint32_t expiry{0};
+		uint32_t lastUsed{0};
+		State state{State::Empty};
+		bool pending{false};
+		uint8_t mdnsAttempts{0}; ///< Non-zero whilst a multicast query is outstanding
+		uint16_t mdnsId{0};
+		LinkedObjectListTemplate<Waiter> waiters;
+	};
+
+	Entry* find(const String& name);
+	Entry* allocate(const String& name);
+	void startLookup(Entry& entry);
+	void complete(Entry& entry, const ip_addr_t* ipaddr, uint32_t recordTtl = 0);
+	static void staticDnsCallback(const char* name, LWIP_IP_ADDR_T* ipaddr, void* arg);
+
+	bool startMdnsLookup(Entry& entry);
+	void sendMdnsQuery(Entry& entry);
+	void mdnsReceive(const uint8_t* data, size_t size);
+	void mdnsTimeout();
+
+	Entry entries[DNS_CACHE_SIZE];
+	std::unique_ptr<UdpConnection> mdnsConnection;
+	SimpleTimer mdnsTimer;
+	uint16_t mdnsLastId{0};
+	uint16_t ttl{DNS_CACHE_TTL};
+	uint16_t negativeTtl{DNS_NEGATIVE_CACHE_TTL};
+};
+
+extern DnsResolverClass DnsResolver;
+
+/** @} */
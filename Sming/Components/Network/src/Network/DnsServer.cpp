@@ -21,120 +21,421 @@
 #include <lwip_includes.h>
 #include <debug_progmem.h>
 
-bool DnsServer::start(uint16_t port, const String& domainName, const IpAddress& resolvedIP)
+namespace
+{
+constexpr size_t DNS_MAX_NAME_LENGTH{253};
+constexpr size_t DNS_MAX_LABEL_LENGTH{63};
+constexpr size_t DNS_MAX_PACKET_SIZE{512};
+constexpr uint16_t DNS_CLASS_IN{1};
+
+/*
+ * Convert "a.b.c" into wire format, "\1a\1b\1c\0"
+ */
+String encodeName(const String& name)
+{
+	String encoded;
+	encoded.reserve(name.length() + 2);
+	const char* ptr = name.c_str();
+	const char* end = ptr + name.length();
+	while(ptr < end) {
+		auto sep = static_cast<const char*>(memchr(ptr, '.', end - ptr));
+		auto labelEnd = sep ? sep : end;
+		encoded += char(labelEnd - ptr);
+		encoded.concat(ptr, labelEnd - ptr);
+		ptr = labelEnd + 1;
+	}
+	encoded += '\0';
+	return encoded;
+}
+
+void appendUint16(String& s, uint16_t value)
+{
+	s += char(value >> 8);
+	s += char(value);
+}
+
+void appendUint32(String& s, uint32_t value)
+{
+	appendUint16(s, value >> 16);
+	appendUint16(s, value);
+}
+
+} // namespace
+
+bool DnsServer::start(uint16_t port)
 {
 	this->port = port;
-	buffer = nullptr;
-	this->domainName = domainName;
-	this->resolvedIP = resolvedIP;
-	downcaseAndRemoveWwwPrefix(this->domainName);
 	return listen(this->port) == 1;
 }
 
+bool DnsServer::start(uint16_t port, const String& domainName, const IpAddress& resolvedIP)
+{
+	clearRecords();
+	String name = domainName;
+	name.toLowerCase();
+	if(name.startsWith(F("www."))) {
+		name.remove(0, 4);
+	}
+	if(!addRecord(name, resolvedIP)) {
+		return false;
+	}
+	return start(port);
+}
+
 void DnsServer::stop()
 {
 	close();
-	delete[] buffer;
-	buffer = nullptr;
 }
 
-void DnsServer::downcaseAndRemoveWwwPrefix(String& domainName)
+bool DnsServer::normaliseName(const String& name, String& result)
 {
-	domainName.toLowerCase();
-	domainName.replace(F("www."), String::empty);
+	result = name;
+	result.toLowerCase();
+	if(result.endsWith(".")) {
+		result.remove(result.length() - 1);
+	}
+	if(result.length() == 0 || result.length() > DNS_MAX_NAME_LENGTH) {
+		return false;
+	}
+
+	// Check label lengths, and that any wildcard is a complete first label
+	unsigned labelLength{0};
+	for(unsigned i = 0; i < result.length(); ++i) {
+		char c = result[i];
+		if(c == '.') {
+			if(labelLength == 0) {
+				return false;
+			}
+			labelLength = 0;
+			continue;
+		}
+		if(c == '*' && (i != 0 || (result.length() > 1 && result[1] != '.'))) {
+			return false;
+		}
+		if(++labelLength > DNS_MAX_LABEL_LENGTH) {
+			return false;
+		}
+	}
+	return labelLength != 0;
 }
 
-bool DnsServer::requestIncludesOnlyOneQuestion()
+uint32_t DnsServer::getHash(const char* name, size_t length)
 {
-	return ntohs(dnsHeader->QDCount) == 1 && dnsHeader->ANCount == 0 && dnsHeader->NSCount == 0 &&
-		   dnsHeader->ARCount == 0;
+	// FNV-1a
+	uint32_t hash{2166136261U};
+	for(size_t i = 0; i < length; ++i) {
+		hash = (hash ^ uint8_t(name[i])) * 16777619U;
+	}
+	return hash;
 }
 
-void DnsServer::onReceive(pbuf* buf, IpAddress remoteIP, uint16_t remotePort)
+DnsServer::Entry* DnsServer::findEntry(const char* name, size_t length)
 {
-	delete[] buffer;
-	buffer = new char[buf->tot_len];
-	if(buffer == nullptr) {
-		return;
+	return findEntry(name, length, getHash(name, length));
+}
+
+DnsServer::Entry* DnsServer::findEntry(const char* name, size_t length, uint32_t hash)
+{
+	for(auto& entry : buckets[hash % DNS_SERVER_HASH_SIZE]) {
+		if(entry.hash == hash && entry.name.length() == length && memcmp(entry.name.c_str(), name, length) == 0) {
+			return &entry;
+		}
 	}
+	return nullptr;
+}
 
-	pbuf_copy_partial(buf, buffer, buf->tot_len, 0);
-	debug_d("DNS REQ for %s from %s:%d", getDomainNameWithoutWwwPrefix().c_str(), remoteIP.toString().c_str(),
-			remotePort);
-	dnsHeader = reinterpret_cast<DnsHeader*>(buffer);
-	if(dnsHeader->QR == DNS_QR_QUERY && dnsHeader->OPCode == DNS_OPCODE_QUERY && requestIncludesOnlyOneQuestion() &&
-	   (domainName == "*" || getDomainNameWithoutWwwPrefix() == domainName)) {
-		char response[buf->tot_len + 16];
-		int idx = buf->tot_len;
-		dnsHeader->QR = DNS_QR_RESPONSE;
-		dnsHeader->ANCount = dnsHeader->QDCount;
-		memcpy(response, buffer, idx);
-		//Set a pointer to the domain name in the question section
-		response[idx] = 0xC0;
-		response[idx + 1] = 0x0C;
-
-		//Type: "Host Address"
-		response[idx + 2] = 0x00;
-		response[idx + 3] = 0x01;
-
-		//Set the response class to IN
-		response[idx + 4] = 0x00;
-		response[idx + 5] = 0x01;
-
-		//TTL
-		auto ttln = htonl(ttl);
-		response[idx + 6] = ttln >> 24;
-		response[idx + 7] = ttln >> 16;
-		response[idx + 8] = ttln >> 8;
-		response[idx + 9] = ttln;
-
-		//RDATA length
-		response[idx + 10] = 0x00;
-		response[idx + 11] = 0x04; //4 byte IP address
-
-		//The IP address
-		for(unsigned int i = 0; i < 4; i++) {
-			response[idx + 12 + i] = resolvedIP[i];
-		}
-
-		sendTo(remoteIP, remotePort, response, idx + 16);
-	} else if(dnsHeader->QR == DNS_QR_QUERY) {
-		dnsHeader->QR = DNS_QR_RESPONSE;
-		dnsHeader->RCode = char(errorReplyCode);
-		dnsHeader->QDCount = 0;
-		sendTo(remoteIP, remotePort, buffer, sizeof(DnsHeader));
-	}
-
-	delete[] buffer;
-	buffer = nullptr;
+DnsServer::Entry* DnsServer::getEntry(const String& name)
+{
+	String normalised;
+	if(!normaliseName(name, normalised)) {
+		debug_w("[DNS] Invalid name '%s'", name.c_str());
+		return nullptr;
+	}
 
-	UdpConnection::onReceive(buf, remoteIP, remotePort);
+	auto hash = getHash(normalised.c_str(), normalised.length());
+	auto entry = findEntry(normalised.c_str(), normalised.length(), hash);
+	if(entry == nullptr) {
+		entry = new Entry(normalised, hash);
+		if(entry == nullptr) {
+			return nullptr;
+		}
+		buckets[hash % DNS_SERVER_HASH_SIZE].add(entry);
+	}
+	return entry;
+}
+
+bool DnsServer::addRecord(const String& name, const IpAddress& addr)
+{
+	auto entry = getEntry(name);
+	if(entry == nullptr) {
+		return false;
+	}
+	for(unsigned i = 0; i < 4; ++i) {
+		entry->addr4 += char(addr[i]);
+	}
+	invalidateAnswers();
+	return true;
+}
+
+bool DnsServer::addRecordV6(const String& name, const uint8_t addr[16])
+{
+	auto entry = getEntry(name);
+	if(entry == nullptr) {
+		return false;
+	}
+	entry->addr6.concat(reinterpret_cast<const char*>(addr), 16);
+	invalidateAnswers();
+	return true;
+}
+
+bool DnsServer::addAlias(const String& name, const String& target)
+{
+	String normalisedTarget;
+	if(!normaliseName(target, normalisedTarget) || normalisedTarget[0] == '*') {
+		return false;
+	}
+	auto entry = getEntry(name);
+	if(entry == nullptr) {
+		return false;
+	}
+	entry->target = normalisedTarget;
+	invalidateAnswers();
+	return true;
+}
+
+bool DnsServer::removeRecords(const String& name)
+{
+	String normalised;
+	if(!normaliseName(name, normalised)) {
+		return false;
+	}
+	auto hash = getHash(normalised.c_str(), normalised.length());
+	auto entry = findEntry(normalised.c_str(), normalised.length(), hash);
+	if(entry == nullptr) {
+		return false;
+	}
+	buckets[hash % DNS_SERVER_HASH_SIZE].remove(entry);
+	// Aliases may have referred to this entry
+	invalidateAnswers();
+	return true;
+}
+
+void DnsServer::clearRecords()
+{
+	for(auto& bucket : buckets) {
+		bucket.clear();
+	}
+}
+
+void DnsServer::invalidateAnswers()
+{
+	for(auto& bucket : buckets) {
+		for(auto& entry : bucket) {
+			for(auto& answer : entry.answers) {
+				answer.data = nullptr;
+				answer.count = 0;
+				answer.valid = false;
+			}
+		}
+	}
+}
+
+DnsServer::Entry* DnsServer::lookup(const char* name, size_t length)
+{
+	auto entry = findEntry(name, length);
+	if(entry != nullptr) {
+		return entry;
+	}
+
+	if(length > 4 && memcmp(name, "www.", 4) == 0) {
+		entry = findEntry(name + 4, length - 4);
+		if(entry != nullptr) {
+			return entry;
+		}
+	}
+
+	// Try wildcards, most specific first
+	char wildcard[DNS_MAX_NAME_LENGTH + 2];
+	wildcard[0] = '*';
+	for(size_t i = 0; i < length; ++i) {
+		if(name[i] != '.') {
+			continue;
+		}
+		size_t suffixLength = length - i;
+		memcpy(&wildcard[1], &name[i], suffixLength);
+		entry = findEntry(wildcard, 1 + suffixLength);
+		if(entry != nullptr) {
+			return entry;
+		}
+	}
+
+	return findEntry("*", 1);
+}
+
+void DnsServer::appendRecord(Answer& answer, const String& encodedName, DnsRecordType type, const void* data,
+							 size_t length)
+{
+	if(encodedName) {
+		answer.data += encodedName;
+	} else {
+		// Pointer to the name in the question, which immediately follows the header
+		appendUint16(answer.data, 0xC000 | sizeof(DnsHeader));
+	}
+	appendUint16(answer.data, uint16_t(type));
+	appendUint16(answer.data, DNS_CLASS_IN);
+	appendUint32(answer.data, ttl);
+	appendUint16(answer.data, length);
+	answer.data.concat(static_cast<const char*>(data), length);
+	++answer.count;
+}
+
+void DnsServer::appendRecords(Answer& answer, const Entry& entry, AnswerKind kind, const String& encodedName)
+{
+	if(kind == ANSWER_A || kind == ANSWER_ANY) {
+		for(unsigned i = 0; i < entry.addr4.length(); i += 4) {
+			appendRecord(answer, encodedName, DnsRecordType::A, entry.addr4.c_str() + i, 4);
+		}
+	}
+	if(kind == ANSWER_AAAA || kind == ANSWER_ANY) {
+		for(unsigned i = 0; i < entry.addr6.length(); i += 16) {
+			appendRecord(answer, encodedName, DnsRecordType::AAAA, entry.addr6.c_str() + i, 16);
+		}
+	}
 }
 
-String DnsServer::getDomainNameWithoutWwwPrefix()
+const DnsServer::Answer& DnsServer::getAnswer(Entry& entry, AnswerKind kind)
 {
-	String parsedDomainName;
-	if(buffer == nullptr) {
-		return parsedDomainName;
+	auto& answer = entry.answers[kind];
+	if(answer.valid) {
+		return answer;
+	}
+
+	if(entry.target) {
+		String target = encodeName(entry.target);
+		appendRecord(answer, nullptr, DnsRecordType::CNAME, target.c_str(), target.length());
+		// Save the client a further query if we know the target
+		auto targetEntry = findEntry(entry.target.c_str(), entry.target.length());
+		if(targetEntry != nullptr && kind != ANSWER_ANY) {
+			appendRecords(answer, *targetEntry, kind, target);
+		}
+	} else {
+		appendRecords(answer, entry, kind, nullptr);
 	}
-	char* start = buffer + 12;
-	if(*start == 0) {
-		return parsedDomainName;
+
+	answer.valid = true;
+	return answer;
+}
+
+void DnsServer::sendError(const uint8_t* request, size_t length, IpAddress remoteIP, uint16_t remotePort)
+{
+	auto buf = allocateBuffer(sizeof(DnsHeader));
+	if(buf == nullptr) {
+		return;
+	}
+	auto header = static_cast<DnsHeader*>(buf->payload);
+	memcpy(header, request, sizeof(DnsHeader));
+	header->QR = DNS_QR_RESPONSE;
+	header->RCode = char(errorReplyCode);
+	header->QDCount = 0;
+	header->ANCount = 0;
+	header->NSCount = 0;
+	header->ARCount = 0;
+	sendTo(remoteIP, remotePort, buf);
+}
+
+void DnsServer::onReceive(pbuf* buf, IpAddress remoteIP, uint16_t remotePort)
+{
+	// We only need the header and question; anything following (e.g. EDNS options) is ignored
+	uint8_t request[sizeof(DnsHeader) + DNS_MAX_NAME_LENGTH + 2 + 4];
+	size_t length = pbuf_copy_partial(buf, request, sizeof(request), 0);
+	auto header = reinterpret_cast<DnsHeader*>(request);
+	if(length < sizeof(DnsHeader) || header->QR != DNS_QR_QUERY) {
+		UdpConnection::onReceive(buf, remoteIP, remotePort);
+		return;
 	}
 
-	unsigned pos = 0;
-	while(true) {
-		unsigned labelLength = *(start + pos);
-		for(unsigned i = 0; i < labelLength; i++) {
-			pos++;
-			parsedDomainName += start[pos];
+	// Decode the question name, in lower case
+	char name[DNS_MAX_NAME_LENGTH + 1];
+	size_t nameLength{0};
+	size_t pos = sizeof(DnsHeader);
+	bool valid = header->OPCode == DNS_OPCODE_QUERY && ntohs(header->QDCount) == 1;
+	while(valid) {
+		if(pos >= length) {
+			valid = false;
+			break;
 		}
-		pos++;
-		if(start[pos] == 0) {
-			downcaseAndRemoveWwwPrefix(parsedDomainName);
-			return parsedDomainName;
-		} else {
-			parsedDomainName += '.';
+		unsigned labelLength = request[pos++];
+		if(labelLength == 0) {
+			break;
 		}
+		// Compression is not expected in a question
+		if(labelLength > DNS_MAX_LABEL_LENGTH || pos + labelLength > length ||
+		   nameLength + labelLength + 1 > DNS_MAX_NAME_LENGTH + 1) {
+			valid = false;
+			break;
+		}
+		if(nameLength != 0) {
+			name[nameLength++] = '.';
+		}
+		for(unsigned i = 0; i < labelLength; ++i) {
+			name[nameLength++] = tolower(request[pos++]);
+		}
+	}
+	size_t questionEnd = pos + 4; // QTYPE, QCLASS
+	if(!valid || nameLength == 0 || questionEnd > length) {
+		sendError(request, length, remoteIP, remotePort);
+		UdpConnection::onReceive(buf, remoteIP, remotePort);
+		return;
 	}
+	name[nameLength] = '\0';
+
+	auto type = DnsRecordType((request[pos] << 8) | request[pos + 1]);
+	debug_d("DNS REQ for %s (%u) from %s:%d", name, unsigned(type), remoteIP.toString().c_str(), remotePort);
+
+	auto entry = lookup(name, nameLength);
+	if(entry == nullptr) {
+		sendError(request, length, remoteIP, remotePort);
+		UdpConnection::onReceive(buf, remoteIP, remotePort);
+		return;
+	}
+
+	AnswerKind kind;
+	switch(type) {
+	case DnsRecordType::A:
+		kind = ANSWER_A;
+		break;
+	case DnsRecordType::AAAA:
+		kind = ANSWER_AAAA;
+		break;
+	case DnsRecordType::ANY:
+	case DnsRecordType::CNAME:
+		kind = ANSWER_ANY;
+		break;
+	default:
+		kind = ANSWER_NONE;
+	}
+	auto& answer = getAnswer(*entry, kind);
+
+	// Echo the query header and question, then append the prepared answers
+	bool truncated = (questionEnd + answer.data.length() > DNS_MAX_PACKET_SIZE);
+	size_t answerLength = truncated ? 0 : answer.data.length();
+	auto response = allocateBuffer(questionEnd + answerLength);
+	if(response != nullptr) {
+		auto data = static_cast<uint8_t*>(response->payload);
+		memcpy(data, request, questionEnd);
+		memcpy(&data[questionEnd], answer.data.c_str(), answerLength);
+		header = reinterpret_cast<DnsHeader*>(data);
+		header->QR = DNS_QR_RESPONSE;
+		header->AA = 1;
+		header->TC = truncated;
+		header->RA = 0;
+		header->Z = 0;
+		header->RCode = char(DnsReplyCode::NoError);
+		header->ANCount = htons(truncated ? 0 : answer.count);
+		header->NSCount = 0;
+		header->ARCount = 0;
+		sendTo(remoteIP, remotePort, response);
+	}
+
+	UdpConnection::onReceive(buf, remoteIP, remotePort);
 }
@@ -25,6 +25,14 @@
 #include "UdpConnection.h"
 #include <WString.h>
 #include <IpAddress.h>
+#include <Data/LinkedObjectList.h>
+
+/**
+ * @brief Number of hash buckets used to index records
+ */
+#ifndef DNS_SERVER_HASH_SIZE
+#define DNS_SERVER_HASH_SIZE 16
+#endif
 
 #define DNS_QR_QUERY 0
 #define DNS_QR_RESPONSE 1
@@ -42,6 +50,13 @@ enum class DnsReplyCode {
 	NXRRSet = 8
 };
 
+enum class DnsRecordType : uint16_t {
+	A = 1,
+	CNAME = 5,
+	AAAA = 28,
+	ANY = 255,
+};
+
 struct DnsHeader {
 	uint16_t ID;	  // identification number
 	char RD : 1;	  // recursion desired
@@ -60,6 +75,13 @@ struct DnsHeader {
 
 /**
  * @brief DNS server class
+ *
+ * Answers queries from a table of A, AAAA and CNAME records.
+ * A name of `*` matches every query, and `*.example.com` matches any name ending in `.example.com`.
+ * The most specific match is used. Queries for `www.` names fall back to the name without that prefix.
+ *
+ * Records are indexed by a hash of the name, and the answer section for each name and query type
+ * is built once then re-used, so replying only requires echoing the query header and question.
  */
 class DnsServer : public UdpConnection
 {
@@ -82,14 +104,60 @@ public:
 	void setTTL(uint32_t ttl)
 	{
 		this->ttl = ttl;
+		invalidateAnswers();
 	}
 
 	/**
-	 * @brief Start the DNS server
+	 * @brief Add an IPv4 address for a name
+	 * @param name Domain name, `*` or `*.domain`
+	 * @param addr
+	 * @retval bool false if out of memory or name is invalid
+	 * @note A name may have several addresses, all of which are returned
+	 */
+	bool addRecord(const String& name, const IpAddress& addr);
+
+	/**
+	 * @brief Add an IPv6 address for a name
+	 * @param name Domain name, `*` or `*.domain`
+	 * @param addr Address in network byte order
+	 * @retval bool false if out of memory or name is invalid
+	 */
+	bool addRecordV6(const String& name, const uint8_t addr[16]);
+
+	/**
+	 * @brief Make a name an alias for another
+	 * @param name Domain name, `*` or `*.domain`
+	 * @param target Canonical name. Its addresses are included in answers if it is also in this table.
+	 * @retval bool false if out of memory or either name is invalid
+	 * @note A name with an alias should have no other records
+	 */
+	bool addAlias(const String& name, const String& target);
+
+	/**
+	 * @brief Remove all records for a name
+	 * @retval bool true if records were found
+	 */
+	bool removeRecords(const String& name);
+
+	/**
+	 * @brief Remove all records
+	 */
+	void clearRecords();
+
+	/**
+	 * @brief Start the DNS server using records already added
+	 * @param port
+	 * @retval bool true if successful, false if there are no sockets available.
+	 */
+	bool start(uint16_t port = 53);
+
+	/**
+	 * @brief Start the DNS server answering for a single name
 	 * @param port
-	 * @param domainName
+	 * @param domainName Name to answer for, or `*` for all names
 	 * @param resolvedIP
 	 * @retval bool true if successful, false if there are no sockets available.
+	 * @note Any existing records are removed
 	 */
 	bool start(uint16_t port, const String& domainName, const IpAddress& resolvedIP);
 
@@ -102,17 +170,55 @@ protected:
 	void onReceive(pbuf* buf, IpAddress remoteIP, uint16_t remotePort) override;
 
 private:
+	// Answer sections are cached for each of these
+	enum AnswerKind {
+		ANSWER_A,
+		ANSWER_AAAA,
+		ANSWER_ANY,
+		ANSWER_NONE, ///< Unsupported query type, only an alias is returned
+		ANSWER_KIND_COUNT,
+	};
+
+	struct Answer {
+		String data; ///< Resource records, all names compressed to point at the question
+		uint8_t count{0};
+		bool valid{false};
+	};
+
+	class Entry : public LinkedObjectTemplate<Entry>
+	{
+	public:
+		Entry(const String& name, uint32_t hash) : name(name), hash(hash)
+		{
+		}
+
+		String name;
+		uint32_t hash;
+		String addr4;  ///< Packed 4-byte addresses
+		String addr6;  ///< Packed 16-byte addresses
+		String target; ///< Canonical name, if this is an alias
+		Answer answers[ANSWER_KIND_COUNT];
+	};
+
+	using EntryList = OwnedLinkedObjectListTemplate<Entry>;
+
+	static bool normaliseName(const String& name, String& result);
+	static uint32_t getHash(const char* name, size_t length);
+	Entry* findEntry(const char* name, size_t length);
+	Entry* findEntry(const char* name, size_t length, uint32_t hash);
+	Entry* getEntry(const String& name);
+	Entry* lookup(const char* name, size_t length);
+	const Answer& getAnswer(Entry& entry, AnswerKind kind);
+	void appendRecords(Answer& answer, const Entry& entry, AnswerKind kind, const String& encodedName);
+	void appendRecord(Answer& answer, const String& encodedName, DnsRecordType type, const void* data,
+					  size_t length);
+	void invalidateAnswers();
+	void sendError(const uint8_t* request, size_t length, IpAddress remoteIP, uint16_t remotePort);
+
+	EntryList buckets[DNS_SERVER_HASH_SIZE];
 	uint16_t port = 0;
-	String domainName;
-	IpAddress resolvedIP;
-	char* buffer = nullptr;
-	DnsHeader* dnsHeader = nullptr;
 	uint32_t ttl = 60;
 	DnsReplyCode errorReplyCode = DnsReplyCode::NonExistentDomain;
-
-	static void downcaseAndRemoveWwwPrefix(String& domainName);
-	String getDomainNameWithoutWwwPrefix();
-	bool requestIncludesOnlyOneQuestion();
 };
 
 /** @} */
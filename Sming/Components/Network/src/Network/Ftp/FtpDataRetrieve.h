@@ -11,19 +11,15 @@
 #pragma once
 
 #include "FtpDataStream.h"
-#include "FileSystem.h"
+#include <Data/Stream/IFS/FileStream.h>
 
 class FtpDataRetrieve : public FtpDataStream
 {
 public:
 	FtpDataRetrieve(FtpServerConnection& connection, const String& fileName)
-		: FtpDataStream(connection), file(fileOpen(fileName, File::ReadOnly))
+		: FtpDataStream(connection), stream(connection.getFileSystem())
 	{
-	}
-
-	~FtpDataRetrieve()
-	{
-		fileClose(file);
+		stream.open(fileName, File::ReadOnly);
 	}
 
 	void transferData(TcpConnectionEvent sourceEvent) override
@@ -31,15 +27,14 @@ public:
 		if(completed) {
 			return;
 		}
-		char buf[1024];
-		int len = fileRead(file, buf, sizeof(buf));
-		write(buf, len, TCP_WRITE_FLAG_COPY);
-		if(fileIsEOF(file)) {
+		// Fill the available TCP window, data is only consumed from the file once accepted
+		write(&stream);
+		if(stream.isFinished()) {
 			completed = true;
 			finishTransfer();
 		}
 	}
 
 private:
-	FileHandle file;
+	IFS::FileStream stream;
 };
@@ -13,6 +13,15 @@
 #include "FtpDataStream.h"
 #include "FileSystem.h"
 
+/**
+ * @brief Received data is collected into blocks of this size before writing to the file
+ *
+ * Use a multiple of the filesystem page size to avoid partial page updates.
+ */
+#ifndef FTP_STORE_BUFFER_SIZE
+#define FTP_STORE_BUFFER_SIZE 512
+#endif
+
 class FtpDataStore : public FtpDataStream
 {
 public:
@@ -23,6 +32,7 @@ public:
 
 	~FtpDataStore()
 	{
+		writeBuffer();
 		fileClose(file);
 	}
 
@@ -34,19 +44,68 @@ public:
 
 		if(buf == nullptr) {
 			completed = true;
-			response(226, "Transfer completed");
+			if(writeBuffer()) {
+				response(226, "Transfer completed");
+			}
 			return TcpConnection::onReceive(buf);
 		}
 
-		pbuf* cur = buf;
-		while(cur != nullptr && cur->len > 0) {
-			fileWrite(file, (uint8_t*)cur->payload, cur->len);
-			cur = cur->next;
+		for(pbuf* cur = buf; cur != nullptr && cur->len > 0; cur = cur->next) {
+			if(!store(static_cast<const uint8_t*>(cur->payload), cur->len)) {
+				completed = true;
+				close();
+				break;
+			}
 		}
 
 		return TcpConnection::onReceive(buf);
 	}
 
 private:
+	bool store(const uint8_t* data, size_t len)
+	{
+		while(len != 0) {
+			// Whole blocks can be written directly
+			if(bufferLength == 0 && len >= FTP_STORE_BUFFER_SIZE) {
+				size_t blockLen = len - (len % FTP_STORE_BUFFER_SIZE);
+				if(!writeFile(data, blockLen)) {
+					return false;
+				}
+				data += blockLen;
+				len -= blockLen;
+				continue;
+			}
+
+			size_t n = std::min(len, FTP_STORE_BUFFER_SIZE - bufferLength);
+			memcpy(&buffer[bufferLength], data, n);
+			bufferLength += n;
+			data += n;
+			len -= n;
+			if(bufferLength == FTP_STORE_BUFFER_SIZE && !writeBuffer()) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool writeBuffer()
+	{
+		auto len = bufferLength;
+		bufferLength = 0;
+		return len == 0 || writeFile(buffer, len);
+	}
+
+	bool writeFile(const uint8_t* data, size_t len)
+	{
+		int res = fileWrite(file, data, len);
+		if(res == int(len)) {
+			return true;
+		}
+		response(451, fileGetErrorString(res < 0 ? res : int(IFS::Error::NoSpace)));
+		return false;
+	}
+
 	FileHandle file;
+	uint8_t buffer[FTP_STORE_BUFFER_SIZE];
+	uint16_t bufferLength{0};
 };
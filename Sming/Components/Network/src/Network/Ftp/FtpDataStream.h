@@ -49,6 +49,16 @@ public:
 		control.dataStreamDestroyed(this);
 	}
 
+	/**
+	 * @brief Start transfer using a connection accepted in passive mode
+	 * @note Transfer may complete, and this object be destroyed, before returning
+	 */
+	void attach(tcp_pcb* pcb)
+	{
+		initialize(pcb);
+		onConnected(ERR_OK);
+	}
+
 	err_t onConnected(err_t err) override
 	{
 		setTimeOut(300);
@@ -0,0 +1,146 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * FtpPassiveListener.h
+ *
+ ****/
+
+#pragma once
+
+#include <lwip/tcp.h>
+#include <IpAddress.h>
+#include <Delegate.h>
+
+/**
+ * @brief Listens for a single passive mode data connection
+ *
+ * Only a connection from the expected client address is accepted.
+ * The listening socket is closed as soon as this happens, so the port may be re-used.
+ * The accepted connection is held until a transfer command claims it by calling `take()`.
+ */
+class FtpPassiveListener
+{
+public:
+	using AcceptDelegate = Delegate<void()>;
+
+	FtpPassiveListener(uint16_t port, IpAddress clientIp, AcceptDelegate onAccept)
+		: clientIp(clientIp), onAccept(onAccept), port(port)
+	{
+	}
+
+	~FtpPassiveListener()
+	{
+		stopListening();
+		if(accepted != nullptr) {
+			tcp_arg(accepted, nullptr);
+			tcp_recv(accepted, nullptr);
+			tcp_err(accepted, nullptr);
+			tcp_abort(accepted);
+		}
+	}
+
+	bool listen()
+	{
+		auto pcb = tcp_new();
+		if(pcb == nullptr) {
+			return false;
+		}
+		if(tcp_bind(pcb, IP_ADDR_ANY, port) != ERR_OK) {
+			tcp_close(pcb);
+			return false;
+		}
+		listener = tcp_listen(pcb);
+		if(listener == nullptr) {
+			tcp_close(pcb);
+			return false;
+		}
+		tcp_arg(listener, this);
+		tcp_accept(listener, staticAccept);
+		return true;
+	}
+
+	uint16_t getPort() const
+	{
+		return port;
+	}
+
+	/**
+	 * @brief Claim the accepted connection
+	 * @retval tcp_pcb* nullptr if client hasn't connected yet
+	 */
+	tcp_pcb* take()
+	{
+		auto pcb = accepted;
+		if(pcb != nullptr) {
+			tcp_arg(pcb, nullptr);
+			tcp_recv(pcb, nullptr);
+			tcp_err(pcb, nullptr);
+			accepted = nullptr;
+		}
+		return pcb;
+	}
+
+private:
+	void stopListening()
+	{
+		if(listener != nullptr) {
+			tcp_arg(listener, nullptr);
+			tcp_close(listener);
+			listener = nullptr;
+		}
+	}
+
+	static err_t staticAccept(void* arg, tcp_pcb* pcb, err_t err)
+	{
+		auto self = static_cast<FtpPassiveListener*>(arg);
+		if(self == nullptr || err != ERR_OK || pcb == nullptr || self->accepted != nullptr ||
+		   IpAddress(pcb->remote_ip) != self->clientIp) {
+			if(pcb != nullptr) {
+				tcp_abort(pcb);
+			}
+			return ERR_ABRT;
+		}
+
+		self->accepted = pcb;
+		self->stopListening();
+
+		tcp_arg(pcb, self);
+		// Until claimed, refuse any data so the stack holds on to it
+		tcp_recv(pcb, [](void* arg, tcp_pcb* pcb, pbuf* p, err_t err) -> err_t {
+			auto self = static_cast<FtpPassiveListener*>(arg);
+			if(p != nullptr) {
+				return ERR_MEM;
+			}
+			// Client closed connection
+			if(self != nullptr) {
+				self->accepted = nullptr;
+			}
+			tcp_arg(pcb, nullptr);
+			tcp_recv(pcb, nullptr);
+			tcp_err(pcb, nullptr);
+			tcp_close(pcb);
+			return ERR_OK;
+		});
+		tcp_err(pcb, [](void* arg, err_t err) {
+			// pcb has already been freed
+			auto self = static_cast<FtpPassiveListener*>(arg);
+			if(self != nullptr) {
+				self->accepted = nullptr;
+			}
+		});
+
+		if(self->onAccept) {
+			self->onAccept();
+		}
+		return ERR_OK;
+	}
+
+	IpAddress clientIp;
+	AcceptDelegate onAccept;
+	tcp_pcb* listener{nullptr};
+	tcp_pcb* accepted{nullptr};
+	uint16_t port;
+};
@@ -12,8 +12,9 @@
 #include "FtpDataStore.h"
 #include "FtpDataRetrieve.h"
 #include "FtpDataFileList.h"
+#include "FtpPassiveListener.h"
 #include "../FtpServer.h"
-#include "Network/NetUtils.h"
+#include "Network/PbufCursor.h"
 #include <Data/CStringArray.h>
 
 // Name, Comment
@@ -28,7 +29,7 @@
 	XX(NOOP, "")                                                                                                       \
 	XX(PWD, "Get current working directory")                                                                           \
 	XX(PASS, "Must follow user")                                                                                       \
-	XX(PASV, "")                                                                                                       \
+	XX(PASV, "Enter passive mode")                                                                                     \
 	XX(PORT, "")                                                                                                       \
 	XX(QUIT, "")                                                                                                       \
 	XX(RNFR, "Rename file: FROM")                                                                                      \
@@ -97,31 +98,41 @@ FtpServerConnection::FtpServerConnection(CustomFtpServer& parentServer, tcp_pcb*
 	writeString(_F("220 Welcome to Sming FTP\r\n"));
 }
 
+FtpServerConnection::~FtpServerConnection()
+{
+	closePassive();
+	if(dataWaiting) {
+		// Never connected, so won't be freed otherwise
+		delete dataConnection;
+	}
+}
+
 err_t FtpServerConnection::onReceive(pbuf* buf)
 {
 	if(buf == nullptr) {
 		return ERR_OK;
 	}
-	int prev = 0;
+	debug_hex(DBG, "CTRL < ", buf->payload, buf->len);
 
+	NetUtils::PbufCursor cursor(buf);
 	while(true) {
-		debug_hex(DBG, "CTRL < ", buf->payload, buf->len);
-		int p = NetUtils::pbufFindStr(buf, "\r\n", prev);
-		if(p < 0 || size_t(p - prev) > MAX_FTP_CMD) {
+		int p = cursor.find("\r\n", 2, MAX_FTP_CMD + 2);
+		if(p < 0) {
 			break;
 		}
-		int split = NetUtils::pbufFindChar(buf, ' ', prev);
+		size_t lineLength = p - cursor.position();
+		int split = cursor.find(' ', lineLength);
 		String cmd, data;
-		if(split >= 0 && split < p) {
-			cmd = NetUtils::pbufStrCopy(buf, prev, split - prev);
-			split++;
-			data = NetUtils::pbufStrCopy(buf, split, p - split);
+		if(split >= 0) {
+			cmd = cursor.readString(split - cursor.position());
+			cursor.advance(1);
+			data = cursor.readString(p - cursor.position());
 		} else {
-			cmd = NetUtils::pbufStrCopy(buf, prev, p - prev);
+			cmd = cursor.readString(lineLength);
 		}
+		cursor.advance(2);
 		debug_d("%s: '%s'", cmd.c_str(), data.c_str());
 		onCommand(cmd, data);
-		prev = p + 1;
 	}
 
 	return ERR_OK;
@@ -144,9 +155,66 @@ void FtpServerConnection::cmdPort(const String& data)
 	int p2 = ps2.toInt();
 	port = (p1 << 8) | p2;
 	debug_d("connection to: %s, %d", ip.toString().c_str(), port);
+	closePassive();
+	passiveMode = false;
 	response(200);
 }
 
+void FtpServerConnection::cmdPasv()
+{
+	closePassive();
+
+	int passivePort = server.allocatePassivePort();
+	if(passivePort < 0) {
+		response(425, F("No passive ports available"));
+		return;
+	}
+
+	passive = new FtpPassiveListener(passivePort, getRemoteIp(),
+									 FtpPassiveListener::AcceptDelegate(&FtpServerConnection::onPassiveAccept, this));
+	if(passive == nullptr || !passive->listen()) {
+		delete passive;
+		passive = nullptr;
+		server.releasePassivePort(passivePort);
+		response(425, F("Can't open passive connection"));
+		return;
+	}
+	passiveMode = true;
+
+	IpAddress localIp(tcp->local_ip);
+	String s = F("Entering Passive Mode (");
+	for(unsigned i = 0; i < 4; ++i) {
+		s += localIp[i];
+		s += ',';
+	}
+	s += passivePort >> 8;
+	s += ',';
+	s += passivePort & 0xff;
+	s += ')';
+	response(227, s);
+}
+
+void FtpServerConnection::closePassive()
+{
+	if(passive != nullptr) {
+		server.releasePassivePort(passive->getPort());
+		delete passive;
+		passive = nullptr;
+	}
+}
+
+void FtpServerConnection::onPassiveAccept()
+{
+	if(!dataWaiting) {
+		// Connection is held until a transfer command is received
+		return;
+	}
+	auto pcb = passive->take();
+	closePassive();
+	dataWaiting = false;
+	dataConnection->attach(pcb);
+}
+
 IFS::FileSystem* FtpServerConnection::getFileSystem()
 {
 	auto fs = server.getFileSystem();
@@ -371,10 +439,9 @@ void FtpServerConnection::onCommand(String cmd, String data)
 		break;
 	}
 
-	case Command::PASV: {
-		response(500, F("Passive mode not supported"));
+	case Command::PASV:
+		cmdPasv();
 		break;
-	}
 
 	case Command::NOOP: {
 		response(200);
@@ -416,8 +483,30 @@ void FtpServerConnection::setDataConnection(FtpDataStream* connection)
 		SYSTEM_ERROR("[FTP] Data connection already exists!");
 	}
 	dataConnection = connection;
-	dataConnection->connect(ip, port);
-	response(150, F("Connecting"));
+
+	if(!passiveMode) {
+		dataConnection->connect(ip, port);
+		response(150, F("Connecting"));
+		return;
+	}
+
+	if(passive == nullptr) {
+		// Each passive transfer needs a new PASV command
+		dataConnection = nullptr;
+		delete connection;
+		response(425, F("Use PORT or PASV first"));
+		return;
+	}
+
+	response(150, F("Opening data connection"));
+	auto pcb = passive->take();
+	if(pcb == nullptr) {
+		// Transfer starts when client connects
+		dataWaiting = true;
+		return;
+	}
+	closePassive();
+	connection->attach(pcb);
 }
 
 void FtpServerConnection::dataStreamDestroyed(TcpConnection* connection)
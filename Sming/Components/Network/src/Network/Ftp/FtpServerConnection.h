@@ -23,6 +23,7 @@
 
 class CustomFtpServer;
 class FtpDataStream;
+class FtpPassiveListener;
 
 class FtpServerConnection : public TcpConnection
 {
@@ -43,6 +44,7 @@ public:
 	static constexpr size_t MAX_FTP_CMD{255};
 
 	FtpServerConnection(CustomFtpServer& parentServer, tcp_pcb* clientTcp);
+	~FtpServerConnection();
 
 	err_t onReceive(pbuf* buf) override;
 	err_t onSent(uint16_t len) override;
@@ -64,6 +66,9 @@ protected:
 	virtual void onCommand(String cmd, String data);
 
 	void cmdPort(const String& data);
+	void cmdPasv();
+	void closePassive();
+	void onPassiveAccept();
 	void setDataConnection(FtpDataStream* connection);
 	String resolvePath(const char* name);
 	bool checkFileAccess(const char* filename, IFS::OpenFlags flags);
@@ -76,8 +81,11 @@ private:
 	IpAddress ip;
 	uint16_t port{20};
 	bool readyForData{false};
+	bool passiveMode{false};
+	bool dataWaiting{false}; ///< Passive data connection hasn't been made yet
 	CString cwd;
 	FtpDataStream* dataConnection{nullptr};
+	FtpPassiveListener* passive{nullptr};
 };
 
 /** @} */
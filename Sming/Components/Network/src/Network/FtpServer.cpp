@@ -16,6 +16,25 @@ TcpConnection* CustomFtpServer::createClient(tcp_pcb* clientTcp)
 	return new FtpServerConnection(*this, clientTcp);
 }
 
+int CustomFtpServer::allocatePassivePort()
+{
+	for(unsigned i = 0; i < passivePortCount; ++i) {
+		if(!bitRead(passivePortsInUse, i)) {
+			bitSet(passivePortsInUse, i);
+			return passivePortFirst + i;
+		}
+	}
+	return -1;
+}
+
+void CustomFtpServer::releasePassivePort(uint16_t port)
+{
+	unsigned i = port - passivePortFirst;
+	if(port >= passivePortFirst && i < 32) {
+		bitClear(passivePortsInUse, i);
+	}
+}
+
 void FtpServer::addUser(const String& login, const String& pass, IFS::UserRole role)
 {
 	debug_d("addUser: %s %s (%s)", login.c_str(), pass.c_str(), toString(role).c_str());
@@ -14,6 +14,20 @@
 #include "WHashMap.h"
 #include <FileSystem.h>
 
+/**
+ * @brief First port used for passive mode data connections
+ */
+#ifndef FTP_PASSIVE_PORT_FIRST
+#define FTP_PASSIVE_PORT_FIRST 50000
+#endif
+
+/**
+ * @brief Number of ports available for passive mode, which limits concurrent passive transfers
+ */
+#ifndef FTP_PASSIVE_PORT_COUNT
+#define FTP_PASSIVE_PORT_COUNT 4
+#endif
+
 class FtpServerConnection;
 
 /** @defgroup   ftpserver FTP server
@@ -38,6 +52,18 @@ public:
 	 */
 	virtual IFS::UserRole validateUser(const char* login, const char* pass) = 0;
 
+	/**
+	 * @brief Set range of ports to be used for passive mode data connections
+	 * @param first The first port number
+	 * @param count Number of ports available (up to 32), 0 to disable passive mode
+	 * @note Only affects subsequent PASV commands
+	 */
+	void setPassivePorts(uint16_t first, uint8_t count)
+	{
+		passivePortFirst = first;
+		passivePortCount = std::min(count, uint8_t(32));
+	}
+
 protected:
 	TcpConnection* createClient(tcp_pcb* clientTcp) override;
 
@@ -59,7 +85,13 @@ protected:
 	}
 
 private:
+	int allocatePassivePort();
+	void releasePassivePort(uint16_t port);
+
 	IFS::FileSystem* fileSystem;
+	uint32_t passivePortsInUse{0};
+	uint16_t passivePortFirst{FTP_PASSIVE_PORT_FIRST};
+	uint8_t passivePortCount{FTP_PASSIVE_PORT_COUNT};
 };
 
 /**
@@ -16,6 +16,7 @@
 
 #include "HttpBodyParser.h"
 #include <Data/WebHelpers/escape.h>
+#include <stringutil.h>
 
 /*
  * Content is received in chunks which we need to reassemble into name=value pairs.
@@ -27,6 +28,26 @@ struct FormUrlParserState {
 	String postValue;
 };
 
+namespace
+{
+/*
+ * Parser state uses the request arena if available, otherwise the heap.
+ * Arena objects are destroyed when the next request begins.
+ */
+template <typename T> T* createState(HttpRequest& request)
+{
+	return request.arena ? request.arena->create<T>() : new T;
+}
+
+template <typename T> void destroyState(HttpRequest& request, T* state)
+{
+	if(request.arena == nullptr) {
+		delete state;
+	}
+}
+
+} // namespace
+
 /*
  * The incoming URL is parsed
  */
@@ -35,8 +56,8 @@ size_t formUrlParser(HttpRequest& request, const char* at, int length)
 	auto state = static_cast<FormUrlParserState*>(request.args);
 
 	if(length == PARSE_DATASTART) {
-		delete state;
-		request.args = new FormUrlParserState;
+		destroyState(request, state);
+		request.args = createState<FormUrlParserState>(request);
 		return 0;
 	}
 
@@ -53,7 +74,7 @@ size_t formUrlParser(HttpRequest& request, const char* at, int length)
 			params[state->postName] = state->postValue;
 		}
 
-		delete state;
+		destroyState(request, state);
 		request.args = nullptr;
 
 		return 0;
@@ -101,14 +122,191 @@ size_t formUrlParser(HttpRequest& request, const char* at, int length)
 	return consumed;
 }
 
+/*
+ * Streaming parser state. Only the field name and any incomplete escape are held between chunks.
+ */
+struct FormUrlStreamParser::State {
+	String name;
+	String value; ///< Used only when storing into postParams
+	ReadWriteStream* stream{nullptr};
+	bool inValue{false};
+	bool failed{false};
+	uint8_t escapeLength{0}; ///< Characters of a '%XX' sequence received so far
+	char escapeChar{'\0'};
+};
+
+bool FormUrlStreamParser::writeValue(HttpRequest& request, State& state, const char* data, size_t length,
+									 bool complete)
+{
+	if(state.stream != nullptr) {
+		return length == 0 || state.stream->write(reinterpret_cast<const uint8_t*>(data), length) == length;
+	}
+
+	if(callback) {
+		return callback(request, state.name, data, length, complete);
+	}
+
+	if(!state.value.concat(data, length)) {
+		return false;
+	}
+	if(complete) {
+		request.postParams[state.name] = state.value;
+		state.value.setLength(0);
+	}
+	return true;
+}
+
+bool FormUrlStreamParser::decodeValue(HttpRequest& request, State& state, const char* at, size_t length)
+{
+	char buffer[64];
+	unsigned count{0};
+	bool ok{true};
+
+	auto emit = [&](char c) {
+		buffer[count++] = c;
+		if(count == sizeof(buffer)) {
+			ok = writeValue(request, state, buffer, count, false);
+			count = 0;
+		}
+	};
+
+	for(unsigned i = 0; ok && i < length;) {
+		char c = at[i];
+		if(state.escapeLength == 0) {
+			if(c == '%') {
+				state.escapeLength = 1;
+			} else {
+				emit((c == '+') ? ' ' : c);
+			}
+			++i;
+			continue;
+		}
+
+		if(unhex(c) < 0) {
+			// Invalid escape: pass it through and re-examine this character
+			emit('%');
+			if(state.escapeLength == 2) {
+				emit(state.escapeChar);
+			}
+			state.escapeLength = 0;
+			continue;
+		}
+
+		if(state.escapeLength == 1) {
+			state.escapeChar = c;
+			state.escapeLength = 2;
+		} else {
+			emit(char((unhex(state.escapeChar) << 4) | unhex(c)));
+			state.escapeLength = 0;
+		}
+		++i;
+	}
+
+	if(ok && count != 0) {
+		ok = writeValue(request, state, buffer, count, false);
+	}
+	return ok;
+}
+
+size_t FormUrlStreamParser::parse(HttpRequest& request, const char* at, int length)
+{
+	auto state = static_cast<State*>(request.args);
+
+	auto beginValue = [&]() {
+		uri_unescape_inplace(state->name);
+		state->stream = request.files.find(state->name);
+		state->inValue = true;
+	};
+
+	auto endValue = [&]() -> bool {
+		// Any incomplete escape sequence is passed through unchanged
+		char tail[2]{'%', state->escapeChar};
+		bool ok = writeValue(request, *state, tail, state->escapeLength, true);
+		state->escapeLength = 0;
+		state->inValue = false;
+		state->stream = nullptr;
+		state->name.setLength(0);
+		return ok;
+	};
+
+	if(length == PARSE_DATASTART) {
+		destroyState(request, state);
+		request.args = createState<State>(request);
+		return 0;
+	}
+
+	if(length == PARSE_DATAEND) {
+		if(state == nullptr) {
+			return 0;
+		}
+
+		// Complete last field, if there is one
+		if(!state->failed && (state->inValue || state->name.length() != 0)) {
+			if(!state->inValue) {
+				beginValue();
+			}
+			endValue();
+		}
+
+		destroyState(request, state);
+		request.args = nullptr;
+
+		return 0;
+	}
+
+	if(state == nullptr) {
+		debug_e("Invalid request argument");
+		return 0;
+	}
+
+	if(state->failed) {
+		return 0;
+	}
+
+	size_t consumed = length;
+	while(length > 0) {
+		// Look for '=' after name, or '&' after value
+		char searchChar = state->inValue ? '&' : '=';
+		auto found = static_cast<const char*>(memchr(at, searchChar, length));
+		unsigned foundLength = (found == nullptr) ? length : (found - at);
+
+		bool ok;
+		if(state->inValue) {
+			ok = decodeValue(request, *state, at, foundLength);
+			if(ok && found != nullptr) {
+				ok = endValue();
+			}
+		} else {
+			ok = state->name.concat(at, foundLength);
+			if(ok && found != nullptr) {
+				beginValue();
+			}
+		}
+
+		if(!ok) {
+			state->failed = true;
+			return 0;
+		}
+
+		if(found == nullptr) {
+			break;
+		}
+
+		++foundLength; // Skip the '=' or '&'
+		at += foundLength;
+		length -= foundLength;
+	}
+
+	return consumed;
+}
+
 size_t bodyToStringParser(HttpRequest& request, const char* at, int length)
 {
 	auto data = static_cast<String*>(request.args);
 
 	if(length == PARSE_DATASTART) {
-		delete data;
-		data = new String();
-		request.args = data;
+		destroyState(request, data);
+		request.args = createState<String>(request);
 		return 0;
 	}
 
@@ -119,7 +317,7 @@ size_t bodyToStringParser(HttpRequest& request, const char* at, int length)
 
 	if(length == PARSE_DATAEND || length < 0) {
 		request.setBody(std::move(*data));
-		delete data;
+		destroyState(request, data);
 		request.args = nullptr;
 		return 0;
 	}
@@ -33,7 +33,7 @@ const int PARSE_DATAEND = -2;   ///< End of incoming data
  * @see `PARSE_DATAEND`
  * @return parsed bytes
  */
-using HttpBodyParserDelegate = Delegate<size_t(HttpRequest& request, const char* at, int length)>;
+using HttpBodyParserDelegate = InplaceDelegate<size_t(HttpRequest& request, const char* at, int length)>;
 
 /**
  * @brief Maps body parsers to a specific content type
@@ -46,6 +46,71 @@ using BodyParsers = HashMap<String, HttpBodyParserDelegate>;
  */
 size_t formUrlParser(HttpRequest& request, const char* at, int length);
 
+/**
+ * @brief Parses application/x-www-form-urlencoded body data incrementally
+ *
+ * Values are decoded as they arrive so the body never needs to be buffered.
+ * For each field, in order of preference:
+ *
+ * - If a stream has been set in `request.files` for the field name, the value is written to it.
+ *   Do this in the resource `onHeadersComplete` handler.
+ * - If a field callback has been provided, it receives the value in fragments.
+ * - Otherwise the value is stored in `request.postParams`, as for `formUrlParser()`.
+ *
+ * Example:
+ *
+ * 		bool onField(HttpRequest& request, const String& name, const char* data, size_t length, bool complete)
+ * 		{
+ * 			// Handle value fragment
+ * 			return true;
+ * 		}
+ *
+ * 		FormUrlStreamParser formParser(onField);
+ * 		server.setBodyParser(MIME_FORM_URL_ENCODED, formParser.getDelegate());
+ *
+ * @note The parser object must remain valid whilst the server is running
+ */
+class FormUrlStreamParser
+{
+public:
+	/**
+	 * @brief Called with each fragment of a decoded field value
+	 * @param request
+	 * @param name Decoded field name
+	 * @param data Value fragment
+	 * @param length Number of characters in fragment, may be 0
+	 * @param complete true for the final fragment of this value
+	 * @retval bool Return false to abort parsing, which fails the request
+	 */
+	using FieldDelegate =
+		Delegate<bool(HttpRequest& request, const String& name, const char* data, size_t length, bool complete)>;
+
+	FormUrlStreamParser(FieldDelegate callback = nullptr) : callback(callback)
+	{
+	}
+
+	/**
+	 * @brief Get delegate for use with `HttpServer::setBodyParser()`
+	 */
+	HttpBodyParserDelegate getDelegate()
+	{
+		return HttpBodyParserDelegate(&FormUrlStreamParser::parse, this);
+	}
+
+	/**
+	 * @see `HttpBodyParserDelegate`
+	 */
+	size_t parse(HttpRequest& request, const char* at, int length);
+
+private:
+	struct State;
+
+	bool writeValue(HttpRequest& request, State& state, const char* data, size_t length, bool complete);
+	bool decodeValue(HttpRequest& request, State& state, const char* at, size_t length);
+
+	FieldDelegate callback;
+};
+
 /**
  * @brief Stores the complete body into memory
  * @see `HttpBodyParserDelegate`
@@ -16,6 +16,8 @@
 #include "Data/Stream/LimitedMemoryStream.h"
 #include "Data/Stream/ChunkedStream.h"
 #include "Data/Stream/UrlencodedOutputStream.h"
+#include "Data/Stream/InflateWriteStream.h"
+#include "HttpRange.h"
 
 bool HttpClientConnection::connect(const String& host, int port, bool useSsl)
 {
@@ -55,6 +57,7 @@ bool HttpClientConnection::send(HttpRequest* request)
 void HttpClientConnection::reset()
 {
 	incomingRequest = nullptr;
+	inflater = nullptr;
 
 	response.reset();
 
@@ -115,11 +118,16 @@ int HttpClientConnection::onMessageComplete(http_parser* parser)
 	debug_d("HCC::onMessageComplete: executionQueue: %d, %s", executionQueue.count(),
 			incomingRequest->uri.toString().c_str());
 
+	// Decode remaining compressed content
+	bool inflated = (inflater == nullptr) || inflater->finish();
+	inflater = nullptr;
+
 	// we are finished with this request
 	int hasError = 0;
 	if(incomingRequest->requestCompletedDelegate) {
 		bool success = (HTTP_PARSER_ERRNO(parser) == HPE_OK) && // false when the parsing has failed
-					   (response.isSuccess());					// false when the HTTP status code is not ok
+					   (response.isSuccess()) &&				// false when the HTTP status code is not ok
+					   inflated;								// false if compressed content was invalid
 		hasError = incomingRequest->requestCompletedDelegate(*this, success);
 	}
 
@@ -133,7 +141,10 @@ int HttpClientConnection::onMessageComplete(http_parser* parser)
 	delete incomingRequest;
 	incomingRequest = nullptr;
 
-	state = eHCS_Ready;
+	// Don't interrupt sending of a pipelined request
+	if(executionQueue.count() == 0 || state == eHCS_WaitResponse) {
+		state = eHCS_Ready;
+	}
 
 	auto response = getResponse();
 
@@ -149,7 +160,8 @@ int HttpClientConnection::onMessageComplete(http_parser* parser)
 		return hasError;
 	}
 
-	allowPipe = true; // if the server supports keep-alive then it would most probably support also pipelining...
+	// A persistent HTTP/1.1 connection must support pipelining (RFC 7230 6.3.2)
+	allowPipe = (parser->http_major > 1 || (parser->http_major == 1 && parser->http_minor >= 1));
 
 	if(executionQueue.count() == 0) {
 		onConnected(ERR_OK);
@@ -188,7 +200,11 @@ int HttpClientConnection::onHeadersComplete(const HttpHeaders& headers)
 	}
 
 	int error = 0;
-	if(incomingRequest->headersCompletedDelegate) {
+	if(incomingRequest->resumable) {
+		error = resumeResponse();
+	}
+
+	if(!error && incomingRequest->headersCompletedDelegate) {
 		error = incomingRequest->headersCompletedDelegate(*this, response);
 	}
 
@@ -196,13 +212,33 @@ int HttpClientConnection::onHeadersComplete(const HttpHeaders& headers)
 		error = 1;
 	}
 
+	inflater = nullptr;
 	if(!error) {
 		// set the response stream
-		if(incomingRequest->responseStream != nullptr) {
-			response.setBuffer(incomingRequest->responseStream);
+		ReadWriteStream* buffer = incomingRequest->responseStream;
+		if(buffer != nullptr) {
 			incomingRequest->responseStream = nullptr; // the response object will release that stream
+		} else if(!incomingRequest->requestBodyDelegate) {
+			buffer = new LimitedMemoryStream(NETWORK_SEND_BUFFER_SIZE);
+		}
+
+		if(buffer != nullptr && incomingRequest->inflateResponse) {
+			auto& encoding = static_cast<const HttpHeaders&>(response.headers)[HTTP_HEADER_CONTENT_ENCODING];
+			if(encoding.equalsIgnoreCase(F("gzip"))) {
+				inflater = new InflateWriteStream(buffer, InflateWriteStream::Format::Gzip);
+			} else if(encoding.equalsIgnoreCase(F("deflate"))) {
+				inflater = new InflateWriteStream(buffer, InflateWriteStream::Format::Zlib);
+			}
+			if(inflater != nullptr) {
+				buffer = inflater;
+			}
+		}
+
+		if(buffer != nullptr) {
+			response.setBuffer(buffer);
 		} else {
-			response.setBuffer(new LimitedMemoryStream(NETWORK_SEND_BUFFER_SIZE));
+			// Body goes to callback, so discard any previous response content
+			response.freeStreams();
 		}
 	}
 
@@ -224,9 +260,49 @@ int HttpClientConnection::onBody(const char* at, size_t length)
 		auto res = response.buffer->write((const uint8_t*)at, length);
 		if(res != length) {
 			// unable to write the requested bytes - stop here...
+			inflater = nullptr;
 			response.freeStreams();
 			return 1;
 		}
+		incomingRequest->receivedLength += length;
+	}
+
+	return 0;
+}
+
+int HttpClientConnection::resumeResponse()
+{
+	auto request = incomingRequest;
+	auto& headers = static_cast<const HttpHeaders&>(response.headers);
+
+	if(request->receivedLength != 0) {
+		HttpRange range;
+		if(response.code == HTTP_STATUS_PARTIAL_CONTENT && range.parseContentRange(headers[HTTP_HEADER_CONTENT_RANGE]) &&
+		   range.start == request->receivedLength) {
+			debug_d("HCC: Resuming response at %u", range.start);
+			return 0;
+		}
+
+		// Start again with complete representation
+		auto file = static_cast<FileStream*>(request->responseStream);
+		request->receivedLength = 0;
+		if(file == nullptr || file->seekFrom(0, SeekOrigin::Start) != 0 || !file->truncate()) {
+			debug_e("HCC: Failed to rewind response stream");
+			return -1;
+		}
+
+		if(response.code == HTTP_STATUS_PARTIAL_CONTENT) {
+			// Not the range we asked for, so re-send without one
+			debug_w("HCC: Unexpected Content-Range '%s'", headers[HTTP_HEADER_CONTENT_RANGE].c_str());
+			request->resumeValidator = nullptr;
+			return -1;
+		}
+	}
+
+	request->resumeValidator = nullptr;
+	if(response.code == HTTP_STATUS_OK) {
+		auto& etag = headers[HTTP_HEADER_ETAG];
+		request->resumeValidator = etag.startsWith("\"") ? etag : headers[HTTP_HEADER_LAST_MODIFIED];
 	}
 
 	return 0;
@@ -254,6 +330,11 @@ REENTER:
 				break;
 			}
 
+			if(executionQueue.count() >= HTTP_CLIENT_PIPELINE_DEPTH) {
+				// wait for a response before sending more
+				break;
+			}
+
 			// if we have previous request
 			if(outgoingRequest != nullptr) {
 				if(!(outgoingRequest->method == HTTP_GET || outgoingRequest->method == HTTP_HEAD)) {
@@ -333,6 +414,27 @@ void HttpClientConnection::sendRequestHeaders(HttpRequest* request)
 		request->headers[HTTP_HEADER_HOST] = request->uri.getHostWithPort();
 	}
 
+	if(request->auth != nullptr) {
+		request->auth->prepareRequest(request);
+	}
+
+	if(request->resumable) {
+		if(request->receivedLength != 0 && request->resumeValidator) {
+			String range = F("bytes=");
+			range += request->receivedLength;
+			range += '-';
+			request->headers[HTTP_HEADER_RANGE] = range;
+			request->headers[HTTP_HEADER_IF_RANGE] = request->resumeValidator;
+		} else {
+			request->headers.remove(HTTP_HEADER_RANGE);
+			request->headers.remove(HTTP_HEADER_IF_RANGE);
+		}
+	}
+
+	if(request->inflateResponse && !request->headers.contains(HTTP_HEADER_ACCEPT_ENCODING)) {
+		request->headers[HTTP_HEADER_ACCEPT_ENCODING] = F("gzip, deflate");
+	}
+
 	request->headers[HTTP_HEADER_CONTENT_LENGTH] = "0";
 	if(request->files.count()) {
 		auto mStream = new MultipartStream(MultipartStream::Producer(&HttpClientConnection::multipartProducer, this));
@@ -409,10 +511,34 @@ bool HttpClientConnection::sendRequestBody(HttpRequest* request)
 
 void HttpClientConnection::cleanup()
 {
+	auto request = incomingRequest;
+	if(request != nullptr && request->resumable) {
+		auto buffer = response.buffer;
+		if(inflater == nullptr && buffer != nullptr && buffer->getStreamType() == eSST_File) {
+			// Keep partial content so the response can be resumed after re-sending
+			request->responseStream = buffer;
+			response.buffer = nullptr;
+			response.stream = nullptr;
+		} else {
+			request->receivedLength = 0;
+		}
+	}
+
 	reset();
 
-	// if there are requests in the executionQueue -> move them back to the waiting queue
+	// Don't pipeline on a new connection until it's known to be persistent
+	allowPipe = false;
+
+	// if there are requests in the executionQueue -> move them back to the front of the waiting queue
+	unsigned waitingCount = waitingQueue.count();
 	while(executionQueue.count() != 0) {
-		waitingQueue.enqueue(executionQueue.dequeue());
+		auto request = executionQueue.dequeue();
+		if(!waitingQueue.enqueue(request)) {
+			debug_e("HCC::cleanup: Request queue full, dropping %s", request->uri.toString().c_str());
+			delete request;
+		}
+	}
+	while(waitingCount-- != 0) {
+		waitingQueue.enqueue(waitingQueue.dequeue());
 	}
 }
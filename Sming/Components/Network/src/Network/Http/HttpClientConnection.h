@@ -17,6 +17,18 @@
 #include "Data/ObjectQueue.h"
 #include <Data/Stream/MultipartStream.h>
 
+class InflateWriteStream;
+
+/**
+ * @brief Maximum number of requests awaiting a response on one connection
+ *
+ * Once a server has shown that the connection is persistent, further GET and HEAD requests
+ * are sent without waiting for earlier responses. Set to 1 to disable pipelining.
+ */
+#ifndef HTTP_CLIENT_PIPELINE_DEPTH
+#define HTTP_CLIENT_PIPELINE_DEPTH 4
+#endif
+
 /**
  *  @brief      Provides http client connection
  *  @ingroup    httpclient
@@ -55,7 +67,15 @@ public:
 
 	bool isFinished()
 	{
-		return (waitingQueue.count() + executionQueue.count() == 0);
+		return getRequestCount() == 0;
+	}
+
+	/**
+	 * @brief Get number of requests queued or in progress on this connection
+	 */
+	unsigned getRequestCount() const
+	{
+		return waitingQueue.count() + executionQueue.count();
 	}
 
 protected:
@@ -95,6 +115,7 @@ protected:
 private:
 	void sendRequestHeaders(HttpRequest* request);
 	bool sendRequestBody(HttpRequest* request);
+	int resumeResponse();
 	MultipartStream::BodyPart multipartProducer();
 
 private:
@@ -103,6 +124,7 @@ private:
 
 	HttpRequest* incomingRequest = nullptr;
 	HttpRequest* outgoingRequest = nullptr;
+	InflateWriteStream* inflater = nullptr; ///< Decompressing response buffer, owned by response
 
 	bool allowPipe = false; /// < Flag to specify if HTTP pipelining is allowed for this connection
 };
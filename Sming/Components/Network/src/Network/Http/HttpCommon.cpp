@@ -11,6 +11,8 @@
 #include "HttpCommon.h"
 #include <FlashString/Vector.hpp>
 #include <FlashString/Map.hpp>
+#include <SystemClock.h>
+#include <DateTime.h>
 
 // Define flash strings and lookup table for HTTP error names
 #define XX(name, string) DEFINE_FSTR_LOCAL(hpename_##name, "HPE_" #name);
@@ -56,3 +58,20 @@ String toString(HttpStatus code)
 	auto s = String(httpStatusMap[code]);
 	return s ?: F("<unknown_") + String(unsigned(code)) + '>';
 }
+
+String httpGetCurrentDate()
+{
+	static time_t cachedTime;
+	static String cachedDate;
+
+	if(!SystemClock.isSet()) {
+		return nullptr;
+	}
+
+	auto now = SystemClock.now(eTZ_UTC);
+	if(now != cachedTime || !cachedDate) {
+		cachedDate = DateTime(now).toHTTPDate();
+		cachedTime = now;
+	}
+	return cachedDate;
+}
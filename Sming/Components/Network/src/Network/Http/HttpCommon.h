@@ -29,6 +29,26 @@
 #define HTTP_REQUEST_POOL_SIZE 20
 #endif
 
+/**
+ * @brief Number of HttpRequest objects allocated from a dedicated pool instead of the heap
+ *
+ * Reduces heap fragmentation for applications which create many requests over time.
+ * Set to 0 to disable.
+ */
+#ifndef HTTP_REQUEST_OBJECT_POOL_SIZE
+#define HTTP_REQUEST_OBJECT_POOL_SIZE 0
+#endif
+
+/**
+ * @brief Size of per-connection arena for temporary request data, such as body parser state
+ *
+ * Memory is allocated once for each server connection and re-used for every request.
+ * If 0, or the arena is full, temporary data is allocated from the heap.
+ */
+#ifndef HTTP_REQUEST_ARENA_SIZE
+#define HTTP_REQUEST_ARENA_SIZE 0
+#endif
+
 #include "http-parser/http_parser.h"
 
 /**
@@ -125,4 +145,11 @@ inline String toString(HttpMethod method)
 	return String(fstr);
 }
 
+/**
+ * @brief Get the current time formatted for a `Date` header
+ * @retval String Empty if the system clock has not been set
+ * @note The text is only regenerated when the time changes, so it is cheap to call for every message
+ */
+String httpGetCurrentDate();
+
 /** @} */
@@ -177,6 +177,11 @@ bool HttpConnection::onTcpReceive(TcpClient& client, char* data, int size)
 	}
 
 	int parsedBytes = http_parser_execute(&parser, &parserSettings, data, size);
+	if(HTTP_PARSER_ERRNO(&parser) == HPE_PAUSED) {
+		// Parsing suspended by a callback: pass the remaining data back so it can be queued
+		return onTcpReceive(client, data + parsedBytes, size - parsedBytes);
+	}
+
 	if(HTTP_PARSER_ERRNO(&parser) != HPE_OK) {
 		bool isRecoverable = onHttpError(HTTP_PARSER_ERRNO(&parser));
 		if(isRecoverable) {
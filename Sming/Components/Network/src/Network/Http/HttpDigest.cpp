@@ -0,0 +1,139 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * HttpDigest.cpp
+ *
+ ****/
+
+#include "HttpDigest.h"
+#include <Crypto/Md5.h>
+#include <Data/HexString.h>
+
+namespace HttpDigest
+{
+namespace
+{
+String md5(const String& text)
+{
+	return Crypto::toString(Crypto::Md5().calculate(text));
+}
+
+} // namespace
+
+bool parseParams(const String& header, HttpParams& params)
+{
+	params.clear();
+
+	const char* p = header.c_str();
+	while(*p == ' ') {
+		++p;
+	}
+	if(strncasecmp(p, _F("Digest "), 7) != 0) {
+		return false;
+	}
+	p += 7;
+
+	for(;;) {
+		while(*p == ' ' || *p == ',') {
+			++p;
+		}
+		if(*p == '\0') {
+			break;
+		}
+
+		auto nameStart = p;
+		while(*p != '\0' && *p != '=' && *p != ',' && *p != ' ') {
+			++p;
+		}
+		String name(nameStart, p - nameStart);
+		name.toLowerCase();
+		while(*p == ' ') {
+			++p;
+		}
+		if(*p != '=') {
+			params[name] = "";
+			continue;
+		}
+		++p;
+		while(*p == ' ') {
+			++p;
+		}
+
+		String value;
+		if(*p == '"') {
+			// Quoted string, may contain escapes
+			++p;
+			while(*p != '\0' && *p != '"') {
+				if(*p == '\\' && p[1] != '\0') {
+					++p;
+				}
+				value += *p++;
+			}
+			if(*p == '"') {
+				++p;
+			}
+		} else {
+			auto valueStart = p;
+			while(*p != '\0' && *p != ',' && *p != ' ') {
+				++p;
+			}
+			value.setString(valueStart, p - valueStart);
+		}
+		params[name] = value;
+	}
+
+	return true;
+}
+
+String calculateHa1(const String& username, const String& realm, const String& password)
+{
+	return md5(username + ':' + realm + ':' + password);
+}
+
+String calculateResponse(const String& ha1, const String& nonce, const String& nc, const String& cnonce,
+						 const String& qop, HttpMethod method, const String& uri)
+{
+	String ha2 = md5(toString(method) + ':' + uri);
+	String text = ha1;
+	text += ':';
+	text += nonce;
+	text += ':';
+	if(qop) {
+		text += nc;
+		text += ':';
+		text += cnonce;
+		text += ':';
+		text += qop;
+		text += ':';
+	}
+	text += ha2;
+	return md5(text);
+}
+
+String createNonce(size_t length)
+{
+	uint8_t buffer[32];
+	length = std::min(length, sizeof(buffer));
+	os_get_random(buffer, length);
+	return makeHexString(buffer, length);
+}
+
+bool hasQopAuth(const String& qop)
+{
+	int pos = 0;
+	while(pos >= 0 && unsigned(pos) < qop.length()) {
+		int end = qop.indexOf(',', pos);
+		String token = qop.substring(pos, (end < 0) ? qop.length() : end);
+		token.trim();
+		if(token == "auth") {
+			return true;
+		}
+		pos = (end < 0) ? end : end + 1;
+	}
+	return false;
+}
+
+} // namespace HttpDigest
@@ -0,0 +1,59 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * HttpDigest.h - Support functions for HTTP Digest access authentication
+ *
+ * See RFC 7616. Only the MD5 algorithm is supported, with or without `qop=auth`.
+ *
+ ****/
+
+#pragma once
+
+#include "HttpCommon.h"
+#include "HttpParams.h"
+
+namespace HttpDigest
+{
+/**
+ * @brief Parse parameters from a `WWW-Authenticate` or `Authorization` header value
+ * @param header Value such as `Digest realm="x", nonce="y", qop=auth`
+ * @param params On return, contains parameters. Names are converted to lower case, quotes removed.
+ * @retval bool false if the scheme isn't `Digest`
+ */
+bool parseParams(const String& header, HttpParams& params);
+
+/**
+ * @brief Calculate HA1 = MD5(username:realm:password)
+ * @note This only changes with the realm, so callers should calculate it once and keep it
+ */
+String calculateHa1(const String& username, const String& realm, const String& password);
+
+/**
+ * @brief Calculate request digest
+ * @param ha1 Result from `calculateHa1()`
+ * @param nonce Server nonce
+ * @param nc Nonce count, 8 hex digits. Ignored if qop is empty.
+ * @param cnonce Client nonce. Ignored if qop is empty.
+ * @param qop "auth" or empty for RFC 2069 compatibility
+ * @param method Request method
+ * @param uri Request URI, exactly as given in the `uri` parameter
+ * @retval String Lower-case hex digest
+ */
+String calculateResponse(const String& ha1, const String& nonce, const String& nc, const String& cnonce,
+						 const String& qop, HttpMethod method, const String& uri);
+
+/**
+ * @brief Create a random nonce
+ * @param length Number of random bytes, output is twice this in hex characters
+ */
+String createNonce(size_t length = 16);
+
+/**
+ * @brief Determine if a comma-separated `qop` parameter value contains "auth"
+ */
+bool hasQopAuth(const String& qop);
+
+} // namespace HttpDigest
@@ -34,7 +34,8 @@ public:
 	int onHeaderValue(HttpHeaders& headers, const char* at, size_t length)
 	{
 		if(!lastWasValue) {
-			currentField = lastData;
+			// Field name is only copied if it's a custom header not already seen
+			currentField = headers.findOrCreate(lastData);
 			headers[currentField] = nullptr;
 			lastWasValue = true;
 		}
@@ -46,11 +47,11 @@ public:
 	{
 		lastWasValue = true;
 		lastData = nullptr;
-		currentField = nullptr;
+		currentField = HTTP_HEADER_UNKNOWN;
 	}
 
 private:
 	bool lastWasValue = true; ///< Indicates whether last callback was Field or Value
 	String lastData;		  ///< Content of field or value, may be constructed over several callbacks
-	String currentField;	  ///< Header field name
+	HttpHeaderFieldName currentField{}; ///< Header field name
 };
@@ -22,6 +22,86 @@ HTTP_HEADER_FIELDNAME_MAP(XX)
 DEFINE_FSTR_VECTOR_LOCAL(fieldNameStrings, FlashString, HTTP_HEADER_FIELDNAME_MAP(XX));
 #undef XX
 
+namespace
+{
+/*
+ * FNV-1a hash, case-insensitive for field name characters.
+ * Folding bit 5 maps ASCII letters to lower case and leaves digits and '-' unchanged.
+ */
+constexpr uint32_t fieldNameHash(const char* name, size_t length, uint32_t seed)
+{
+	for(size_t i = 0; i < length; ++i) {
+		seed = (seed ^ (uint8_t(name[i]) | 0x20)) * 16777619U;
+	}
+	return seed;
+}
+
+/*
+ * Perfect hash table mapping standard field names to (HttpHeaderFieldName - 1).
+ * Byte slots are packed into words so the table can be read directly from flash.
+ */
+struct FieldNameTable {
+	static constexpr unsigned slotBits{8};
+	static constexpr uint8_t unused{0xff};
+
+	uint32_t seed;
+	uint32_t slots[(1U << slotBits) / 4];
+
+	static constexpr unsigned getSlot(uint32_t hash)
+	{
+		return hash >> (32 - slotBits);
+	}
+
+	constexpr uint8_t operator[](unsigned slot) const
+	{
+		return slots[slot / 4] >> ((slot % 4) * 8);
+	}
+};
+
+/*
+ * Search for a seed which gives each standard field name its own slot
+ */
+constexpr FieldNameTable createFieldNameTable()
+{
+	struct Name {
+		const char* str;
+		size_t length;
+	};
+	constexpr Name names[]{
+#define XX(tag, str, flags, comment) {str, sizeof(str) - 1},
+		HTTP_HEADER_FIELDNAME_MAP(XX)
+#undef XX
+	};
+	static_assert(ARRAY_SIZE(names) < FieldNameTable::unused, "Too many field names");
+
+	constexpr uint32_t firstSeed{2166136261U};
+	for(uint32_t seed = firstSeed; seed < firstSeed + 10000; ++seed) {
+		FieldNameTable table{seed, {}};
+		for(auto& word : table.slots) {
+			word = 0xffffffff;
+		}
+		unsigned i = 0;
+		for(; i < ARRAY_SIZE(names); ++i) {
+			auto slot = FieldNameTable::getSlot(fieldNameHash(names[i].str, names[i].length, seed));
+			if(table[slot] != FieldNameTable::unused) {
+				break;
+			}
+			auto shift = (slot % 4) * 8;
+			table.slots[slot / 4] = (table.slots[slot / 4] & ~(0xffU << shift)) | (i << shift);
+		}
+		if(i == ARRAY_SIZE(names)) {
+			return table;
+		}
+	}
+
+	return FieldNameTable{0, {}};
+}
+
+constexpr FieldNameTable fieldNameTable PROGMEM = createFieldNameTable();
+static_assert(fieldNameTable.seed != 0, "No perfect hash found for field names");
+
+} // namespace
+
 HttpHeaderFields::Flags HttpHeaderFields::getFlags(HttpHeaderFieldName name) const
 {
 	switch(name) {
@@ -72,25 +152,22 @@ String HttpHeaderFields::toString(HttpHeaderFieldName name, const String& value)
 String HttpHeaderFields::toString(const String& name, const String& value)
 {
 	String s;
-	s.reserve(name.length() + 2 + value.length() + 2);
-	s += name;
-	s += ": ";
-	s += value;
-	s += "\r\n";
+	s.concatAll(name, ": ", value, "\r\n");
 	return s;
 }
 
-HttpHeaderFieldName HttpHeaderFields::fromString(const String& name) const
+HttpHeaderFieldName HttpHeaderFields::fromString(const StringView& name) const
 {
-	auto index = fieldNameStrings.indexOf(name);
-	if(index >= 0) {
+	auto hash = fieldNameHash(name.data(), name.length(), fieldNameTable.seed);
+	unsigned index = fieldNameTable[FieldNameTable::getSlot(hash)];
+	if(index != FieldNameTable::unused && name.equalsIgnoreCase(fieldNameStrings[index])) {
 		return static_cast<HttpHeaderFieldName>(index + 1);
 	}
 
 	return findCustomFieldName(name);
 }
 
-HttpHeaderFieldName HttpHeaderFields::findCustomFieldName(const String& name) const
+HttpHeaderFieldName HttpHeaderFields::findCustomFieldName(const StringView& name) const
 {
 	auto index = customFieldNames.indexOf(name);
 	if(index >= 0) {
@@ -14,6 +14,7 @@
 
 #include "Data/CStringArray.h"
 #include "WString.h"
+#include "StringView.h"
 #include <Data/BitSet.h>
 
 /*
@@ -35,6 +36,7 @@
 #define HTTP_HEADER_FIELDNAME_MAP(XX)                                                                                  \
 	XX(ACCEPT, "Accept", 0, "Limit acceptable response types")                                                         \
 	XX(ACCEPT_ENCODING, "Accept-Encoding", 0, "Limit acceptable content encoding types")                               \
+	XX(ACCEPT_RANGES, "Accept-Ranges", 0, "Range units supported by server for a resource, e.g. bytes")                \
 	XX(ACCESS_CONTROL_ALLOW_ORIGIN, "Access-Control-Allow-Origin", 0, "")                                              \
 	XX(AUTHORIZATION, "Authorization", 0, "Basic user agent authentication")                                           \
 	XX(CC, "Cc", 0, "email field")                                                                                     \
@@ -42,6 +44,7 @@
 	XX(CONTENT_DISPOSITION, "Content-Disposition", 0, "Additional information about how to process response payload")  \
 	XX(CONTENT_ENCODING, "Content-Encoding", 0, "Applied encodings in addition to content type")                       \
 	XX(CONTENT_LENGTH, "Content-Length", 0, "Anticipated size for payload when not using transfer encoding")           \
+	XX(CONTENT_RANGE, "Content-Range", 0, "Location of partial content within the complete representation")            \
 	XX(CONTENT_TYPE, "Content-Type", 0,                                                                                \
 	   "Payload media type indicating both data format and intended manner of processing by recipient")                \
 	XX(CONTENT_TRANSFER_ENCODING, "Content-Transfer-Encoding", 0, "Coding method used in a MIME message body part")    \
@@ -59,14 +62,21 @@
 	   "Precondition check using ETag to avoid accidental overwrites when servicing multiple user requests. Ensures "  \
 	   "resource entity tag matches before proceeding.")                                                               \
 	XX(IF_MODIFIED_SINCE, "If-Modified-Since", 0, "Precondition check using Date")                                     \
+	XX(IF_NONE_MATCH, "If-None-Match", 0,                                                                              \
+	   "Conditional request using ETag, server responds with 304 (Not Modified) if resource entity tag matches")      \
+	XX(IF_RANGE, "If-Range", 0, "Only send the requested range if representation is unchanged (by ETag or Date)")      \
 	XX(LAST_MODIFIED, "Last-Modified", 0, "Server timestamp indicating date and time resource was last modified")      \
 	XX(LOCATION, "Location", 0, "Used in redirect responses, amongst other places")                                    \
+	XX(RANGE, "Range", 0, "Request only part of a representation, as one or more byte ranges")                         \
+	XX(RETRY_AFTER, "Retry-After", 0, "How long the user agent should wait before making a follow-up request")          \
 	XX(SEC_WEBSOCKET_ACCEPT, "Sec-WebSocket-Accept", 0, "Server response to opening Websocket handshake")              \
 	XX(SEC_WEBSOCKET_VERSION, "Sec-WebSocket-Version", 0,                                                              \
 	   "Websocket opening request indicates acceptable protocol version. Can appear more than once.")                  \
 	XX(SEC_WEBSOCKET_KEY, "Sec-WebSocket-Key", 0, "Websocket opening request validation key")                          \
 	XX(SEC_WEBSOCKET_PROTOCOL, "Sec-WebSocket-Protocol", 0,                                                            \
 	   "Websocket opening request indicates supported protocol(s), response contains negotiated protocol(s)")          \
+	XX(SEC_WEBSOCKET_EXTENSIONS, "Sec-WebSocket-Extensions", 0,                                                        \
+	   "Websocket opening request offers protocol extension(s), response contains those accepted")                    \
 	XX(SERVER, "Server", 0, "Identifies software handling requests")                                                   \
 	XX(SET_COOKIE, "Set-Cookie", Flag::Multi,                                                                          \
 	   "Server may pass name/value pairs and associated metadata to user agent (client)")                              \
@@ -76,6 +86,7 @@
 	XX(UPGRADE, "Upgrade", 0,                                                                                          \
 	   "Used to transition from HTTP to some other protocol on the same connection. e.g. Websocket")                   \
 	XX(USER_AGENT, "User-Agent", 0, "Information about the user agent originating the request")                        \
+	XX(VARY, "Vary", 0, "Request headers used to select the response representation, e.g. Accept-Encoding")         \
 	XX(WWW_AUTHENTICATE, "WWW-Authenticate", Flag::Multi,                                                              \
 	   "Indicates HTTP authentication scheme(s) and applicable parameters")                                            \
 	XX(PROXY_AUTHENTICATE, "Proxy-Authenticate", Flag::Multi,                                                          \
@@ -124,11 +135,11 @@ public:
 	String toString(HttpHeaderFieldName name, const String& value) const;
 
 	/** @brief Find the enumerated value for the given field name string
-	 *  @param name
+	 *  @param name May refer directly into a receive buffer as no copy is made
 	 *  @retval HttpHeaderFieldName field name code, HTTP_HEADER_UNKNOWN if not recognised
 	 *  @note comparison is not case-sensitive
 	 */
-	HttpHeaderFieldName fromString(const String& name) const;
+	HttpHeaderFieldName fromString(const StringView& name) const;
 
 	/** @brief Find the enumerated value for the given field name string, create a custom entry if not found
 	 *  @param name
@@ -155,7 +166,7 @@ private:
 	 *  @param name
 	 *  @retval HttpHeaderFieldName HTTP_HEADER_UNKNOWN if not found
 	 */
-	HttpHeaderFieldName findCustomFieldName(const String& name) const;
+	HttpHeaderFieldName findCustomFieldName(const StringView& name) const;
 
 	CStringArray customFieldNames;
 };
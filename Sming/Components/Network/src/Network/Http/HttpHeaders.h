@@ -26,6 +26,7 @@
 /** @brief Encapsulates a set of HTTP header information
  *  @note fields are stored as a map of field names vs. values.
  *  Standard fields may be accessed using enumeration tags.
+ *  Lookups use a hashed index so cost does not grow with the number of headers.
  *  Behaviour is as for HashMap, with the addition of methods to support enumerated field names.
  *
  *  @todo add name and/or value escaping
@@ -72,9 +73,11 @@ public:
 		const HttpHeaderFields& fields;
 	};
 
-	HttpHeaders() = default;
+	HttpHeaders() : HashMap(nullptr, hashFieldName)
+	{
+	}
 
-	HttpHeaders(const HttpHeaders& headers)
+	HttpHeaders(const HttpHeaders& headers) : HttpHeaders()
 	{
 		*this = headers;
 	}
@@ -178,4 +181,13 @@ public:
 		String strSD = operator[](HTTP_HEADER_DATE);
 		return dt.fromHttpDate(strSD) ? dt : DateTime();
 	}
+
+private:
+	/*
+	 * Field names are small sequential integers so make an ideal hash
+	 */
+	static uint32_t hashFieldName(const HttpHeaderFieldName& name)
+	{
+		return unsigned(name);
+	}
 };
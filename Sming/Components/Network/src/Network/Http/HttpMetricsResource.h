@@ -0,0 +1,44 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * HttpMetricsResource.h
+ *
+ ****/
+
+#pragma once
+
+#include "HttpResource.h"
+#include "HttpServerConnection.h"
+#include <Data/Stream/MemoryDataStream.h>
+#include <Services/Profiling/Metrics.h>
+
+/**
+ * @brief Serves all registered metrics in Prometheus text exposition format
+ * @ingroup httpserver
+ *
+ * Example:
+ *
+ * 		server.paths.set("/metrics", new HttpMetricsResource);
+ *
+ * @note Requires ENABLE_METRICS=1, otherwise the response is empty
+ */
+class HttpMetricsResource : public HttpResource
+{
+public:
+	HttpMetricsResource()
+	{
+		onRequestComplete = HttpResourceDelegate(&HttpMetricsResource::requestComplete, this);
+	}
+
+private:
+	int requestComplete(HttpServerConnection&, HttpRequest&, HttpResponse& response)
+	{
+		auto stream = new MemoryDataStream;
+		Profiling::Metrics::printAll(*stream);
+		response.sendDataStream(stream, F("text/plain; version=0.0.4"));
+		return 0;
+	}
+};
@@ -0,0 +1,79 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * HttpNetworkStatsResource.cpp
+ *
+ ****/
+
+#include "HttpNetworkStatsResource.h"
+#include "HttpServerConnection.h"
+#include <Network/LwipStats.h>
+#include <Data/Stream/MemoryDataStream.h>
+
+namespace
+{
+void printConnection(Print& p, const TcpConnection& connection)
+{
+	auto& stats = connection.getStats();
+	TcpConnection::StackInfo info;
+	connection.getStackInfo(info);
+
+	p.print(_F("{\"remote\":\""));
+	p.print(connection.getRemoteIp());
+	p.print(':');
+	p.print(connection.getRemotePort());
+	p.print(_F("\",\"bytesReceived\":"));
+	p.print(stats.bytesReceived);
+	p.print(_F(",\"bytesAcked\":"));
+	p.print(stats.bytesAcked);
+	p.print(_F(",\"receiveCount\":"));
+	p.print(stats.receiveCount);
+	p.print(_F(",\"writeCount\":"));
+	p.print(stats.writeCount);
+	p.print(_F(",\"writeRefusals\":"));
+	p.print(stats.writeRefusals);
+	p.print(_F(",\"retransmitCount\":"));
+	p.print(stats.retransmitCount);
+	p.print(_F(",\"rtt\":"));
+	p.print(info.rtt);
+	p.print(_F(",\"rto\":"));
+	p.print(info.rto);
+	p.print(_F(",\"cwnd\":"));
+	p.print(info.cwnd);
+	p.print(_F(",\"sendWindow\":"));
+	p.print(info.sendWindow);
+	p.print(_F(",\"sendQueue\":"));
+	p.print(info.sendQueue);
+	p.print('}');
+}
+
+} // namespace
+
+int HttpNetworkStatsResource::requestComplete(HttpServerConnection&, HttpRequest&, HttpResponse& response)
+{
+	auto stream = new MemoryDataStream;
+
+	Network::LwipStats::Snapshot snapshot;
+	Network::LwipStats::getSnapshot(snapshot);
+	stream->print(_F("{\"lwip\":"));
+	snapshot.printTo(*stream);
+
+	stream->print(_F(",\"connections\":["));
+	if(server != nullptr) {
+		bool first{true};
+		for(auto& connection : server->getConnections()) {
+			if(!first) {
+				stream->print(',');
+			}
+			first = false;
+			printConnection(*stream, connection);
+		}
+	}
+	stream->print(_F("]}"));
+
+	response.sendDataStream(stream, MIME_JSON);
+	return 0;
+}
@@ -0,0 +1,45 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * HttpNetworkStatsResource.h
+ *
+ ****/
+
+#pragma once
+
+#include "HttpResource.h"
+#include <Network/TcpServer.h>
+
+/**
+ * @brief Serves lwIP statistics and per-connection counters as JSON
+ * @ingroup httpserver
+ *
+ * Example:
+ *
+ * 		server.paths.set("/netstats", new HttpNetworkStatsResource(&server));
+ *
+ * The response contains an `lwip` object, see Network::LwipStats::Snapshot, and
+ * a `connections` array describing each connection to the given server.
+ *
+ * @note lwIP statistics are zero unless the stack is built with LWIP_STATS=1
+ */
+class HttpNetworkStatsResource : public HttpResource
+{
+public:
+	/**
+	 * @brief Constructor
+	 * @param server If provided, list connections to this server
+	 */
+	HttpNetworkStatsResource(TcpServer* server = nullptr) : server(server)
+	{
+		onRequestComplete = HttpResourceDelegate(&HttpNetworkStatsResource::requestComplete, this);
+	}
+
+private:
+	int requestComplete(HttpServerConnection& connection, HttpRequest& request, HttpResponse& response);
+
+	TcpServer* server;
+};
@@ -14,6 +14,7 @@
 #include <Data/WebHelpers/escape.h>
 #include "Print.h"
 #include "libyuarel/yuarel.h"
+#include <stringutil.h>
 
 // Set a reasonable limit on the number of expected parameters in a query string
 static const unsigned MAX_PARAMS = 16;
@@ -47,8 +48,109 @@ void HttpParams::parseQuery(char* query)
 	}
 }
 
+void HttpParams::setQuery(const char* query)
+{
+	clear();
+
+	if(query != nullptr && *query == '?') {
+		++query;
+	}
+	if(query != nullptr && *query != '\0') {
+		pending = query;
+	}
+}
+
+void HttpParams::parsePendingQuery()
+{
+	String query = std::move(pending);
+	parseQuery(query.begin());
+}
+
+namespace
+{
+/*
+ * Decode next character from escaped query text.
+ * Stops at end of text or at any of the given terminators (which are never escaped).
+ */
+bool nextChar(const char*& src, const char* end, const char* terminators, char& c)
+{
+	if(src == end || strchr(terminators, *src) != nullptr) {
+		return false;
+	}
+	c = *src++;
+	if(c == '+') {
+		c = ' ';
+	} else if(c == '%' && end - src >= 2) {
+		auto hi = unhex(src[0]);
+		auto lo = unhex(src[1]);
+		if(hi >= 0 && lo >= 0) {
+			c = (hi << 4) | lo;
+			src += 2;
+		}
+	}
+	return true;
+}
+
+// Compare escaped key at src against unescaped name, leaving src at the end of the key
+bool keyMatches(const char*& src, const char* end, const String& name)
+{
+	const char* np = name.c_str();
+	const char* nend = np + name.length();
+	bool match = true;
+	char c;
+	while(nextChar(src, end, "=&", c)) {
+		if(np == nend || c != *np) {
+			match = false;
+		} else {
+			++np;
+		}
+	}
+	return match && np == nend;
+}
+
+} // namespace
+
+String HttpParams::get(const String& name) const
+{
+	if(pending.length() == 0) {
+		return HashMap::operator[](name);
+	}
+
+	// If a name appears more than once the last value wins, as for parseQuery()
+	String result;
+	const char* src = pending.c_str();
+	const char* end = src + pending.length();
+	while(src < end) {
+		bool match = keyMatches(src, end, name);
+		if(src == end || *src == '&') {
+			// No value
+			if(match) {
+				result = nullptr;
+			}
+		} else {
+			++src; // Skip '='
+			const char* value = src;
+			while(src < end && *src != '&') {
+				++src;
+			}
+			if(match) {
+				result.setString(value, src - value);
+				uri_unescape_inplace(result);
+			}
+		}
+		if(src < end) {
+			++src; // Skip '&'
+		}
+	}
+	return result;
+}
+
 String HttpParams::toString() const
 {
+	if(pending.length() != 0) {
+		return String('?') + pending;
+	}
+
 	if(count() == 0) {
 		return nullptr;
 	}
@@ -108,6 +210,10 @@ String HttpParams::toString() const
 
 size_t HttpParams::printTo(Print& p) const
 {
+	if(pending.length() != 0) {
+		return p.print(pending);
+	}
+
 	size_t charsPrinted = 0;
 	for(unsigned i = 0; i < count(); i++) {
 		if(i > 0) {
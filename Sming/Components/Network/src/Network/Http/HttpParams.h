@@ -25,6 +25,8 @@
 /**
  * @brief Handles the query portion of a URI
  *
+ *  A query set using `setQuery()` is kept in escaped form until the map content is accessed.
+ *
  *  @todo values stored in escaped form, unescape return value and escape provided values.
  *  Revise HttpBodyParser.cpp as it will no longer do this job.
  *
@@ -53,6 +55,26 @@ public:
 	 */
 	void parseQuery(char* query);
 
+	/**
+	 * @brief Store query for parsing on first access
+	 * @param query Escaped query string, with or without '?' prefix
+	 *
+	 * Many request handlers never look at the query, so this avoids allocating and
+	 * unescaping every key and value up front.
+	 * The query is parsed when map content is first accessed.
+	 * Use `get()` to look up single values without parsing.
+	 */
+	void setQuery(const char* query);
+
+	/**
+	 * @brief Look up a value, without parsing a pending query
+	 * @param name Unescaped parameter name
+	 * @retval String Unescaped value, invalid String if not found
+	 *
+	 * The escaped query is scanned in-place, so only the result is allocated.
+	 */
+	String get(const String& name) const;
+
 	/** @brief Return full escaped content for incorporation into a URI */
 	String toString() const;
 
@@ -64,10 +86,123 @@ public:
 	HttpParams& operator=(const HttpParams& params)
 	{
 		clear();
-		setMultiple(params);
+		pending = params.pending;
+		HashMap::setMultiple(params);
 		return *this;
 	}
 
+	/*
+	 * Map accessors.
+	 * These parse any pending query first.
+	 */
+
+	unsigned int count() const
+	{
+		parsePending();
+		return HashMap::count();
+	}
+
+	const String& keyAt(unsigned int idx) const
+	{
+		parsePending();
+		return HashMap::keyAt(idx);
+	}
+
+	String& keyAt(unsigned int idx)
+	{
+		parsePending();
+		return HashMap::keyAt(idx);
+	}
+
+	const String& valueAt(unsigned int idx) const
+	{
+		parsePending();
+		return HashMap::valueAt(idx);
+	}
+
+	String& valueAt(unsigned int idx)
+	{
+		parsePending();
+		return HashMap::valueAt(idx);
+	}
+
+	const String& operator[](const String& key) const
+	{
+		parsePending();
+		return HashMap::operator[](key);
+	}
+
+	String& operator[](const String& key)
+	{
+		parsePending();
+		return HashMap::operator[](key);
+	}
+
+	int indexOf(const String& key) const
+	{
+		parsePending();
+		return HashMap::indexOf(key);
+	}
+
+	bool contains(const String& key) const
+	{
+		return indexOf(key) >= 0;
+	}
+
+	void removeAt(unsigned index)
+	{
+		parsePending();
+		HashMap::removeAt(index);
+	}
+
+	void remove(const String& key)
+	{
+		parsePending();
+		HashMap::remove(key);
+	}
+
+	void clear()
+	{
+		pending = nullptr;
+		HashMap::clear();
+	}
+
+	void setMultiple(const HashMap<String, String>& map)
+	{
+		parsePending();
+		HashMap::setMultiple(map);
+	}
+
+	template <typename Compare> void sort(Compare compare)
+	{
+		parsePending();
+		HashMap::sort(compare);
+	}
+
+	Iterator<false> begin()
+	{
+		parsePending();
+		return HashMap::begin();
+	}
+
+	Iterator<false> end()
+	{
+		parsePending();
+		return HashMap::end();
+	}
+
+	Iterator<true> begin() const
+	{
+		parsePending();
+		return HashMap::begin();
+	}
+
+	Iterator<true> end() const
+	{
+		parsePending();
+		return HashMap::end();
+	}
+
 	// Printable
 	size_t printTo(Print& p) const;
 
@@ -76,4 +211,16 @@ public:
 	 * @param p
 	 */
 	void debugPrintTo(Print& p) const;
+
+private:
+	void parsePending() const
+	{
+		if(pending.length() != 0) {
+			const_cast<HttpParams*>(this)->parsePendingQuery();
+		}
+	}
+
+	void parsePendingQuery();
+
+	String pending; ///< Escaped query, without '?'. Non-empty only if map is empty.
 };
@@ -0,0 +1,127 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * HttpRange.cpp
+ *
+ ****/
+
+#include "HttpRange.h"
+#include <algorithm>
+#include <cctype>
+
+namespace
+{
+void skipSpace(const char*& p)
+{
+	while(*p == ' ' || *p == '\t') {
+		++p;
+	}
+}
+
+/*
+ * Read a decimal value, failing on overflow or if there are no digits
+ */
+bool parseNumber(const char*& p, uint32_t& value)
+{
+	if(!isdigit(*p)) {
+		return false;
+	}
+	uint64_t n{0};
+	while(isdigit(*p)) {
+		n = (n * 10) + (*p++ - '0');
+		if(n > UINT32_MAX) {
+			return false;
+		}
+	}
+	value = n;
+	return true;
+}
+
+bool skipUnit(const char*& p, char separator)
+{
+	skipSpace(p);
+	if(strncasecmp(p, "bytes", 5) != 0 || p[5] != separator) {
+		return false;
+	}
+	p += 6;
+	skipSpace(p);
+	return true;
+}
+
+} // namespace
+
+HttpRange::Result HttpRange::parseRange(const String& value, uint32_t size)
+{
+	auto p = value.c_str();
+	if(!skipUnit(p, '=') || strchr(p, ',') != nullptr) {
+		return Result::Ignore;
+	}
+
+	uint32_t first{0};
+	uint32_t last{UINT32_MAX};
+	bool haveFirst = parseNumber(p, first);
+	if(*p++ != '-') {
+		return Result::Ignore;
+	}
+	bool haveLast = parseNumber(p, last);
+	skipSpace(p);
+	if(*p != '\0' || !(haveFirst || haveLast) || (haveFirst && last < first)) {
+		return Result::Ignore;
+	}
+
+	if(!haveFirst) {
+		// Suffix range: final `last` bytes
+		if(last == 0 || size == 0) {
+			return Result::Unsatisfiable;
+		}
+		start = (last < size) ? size - last : 0;
+		end = size - 1;
+		return Result::Ok;
+	}
+
+	if(first >= size) {
+		return Result::Unsatisfiable;
+	}
+	start = first;
+	end = std::min(last, size - 1);
+	return Result::Ok;
+}
+
+bool HttpRange::parseContentRange(const String& value, uint32_t* total)
+{
+	auto p = value.c_str();
+	uint32_t first;
+	uint32_t last;
+	if(!skipUnit(p, ' ') || !parseNumber(p, first) || *p++ != '-' || !parseNumber(p, last) || *p++ != '/' ||
+	   last < first) {
+		return false;
+	}
+
+	uint32_t size{0};
+	if(*p == '*') {
+		++p;
+	} else if(!parseNumber(p, size) || last >= size) {
+		return false;
+	}
+	skipSpace(p);
+	if(*p != '\0') {
+		return false;
+	}
+
+	start = first;
+	end = last;
+	if(total != nullptr) {
+		*total = size;
+	}
+	return true;
+}
+
+String HttpRange::toString(uint32_t size) const
+{
+	String s;
+	s.concatAll(F("bytes "), start, '-', end, '/', size);
+	return s;
+}
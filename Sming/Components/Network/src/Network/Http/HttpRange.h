@@ -0,0 +1,57 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * HttpRange.h - Byte ranges for partial content requests
+ *
+ * See RFC 9110 section 14. Only single byte ranges are supported.
+ *
+ ****/
+
+#pragma once
+
+#include <WString.h>
+
+/**
+ * @brief A byte range within a representation, as used in `Range` and `Content-Range` headers
+ */
+struct HttpRange {
+	enum class Result {
+		Ignore,		   ///< No usable range, send the complete representation
+		Ok,			   ///< Range is valid
+		Unsatisfiable, ///< No part of the range lies within the content
+	};
+
+	uint32_t start{0};
+	uint32_t end{0}; ///< Position of last byte, inclusive
+
+	uint32_t length() const
+	{
+		return end + 1 - start;
+	}
+
+	/**
+	 * @brief Parse a `Range` request header
+	 * @param value Header value such as `bytes=100-199`, `bytes=100-` or `bytes=-100`
+	 * @param size Length of the complete content
+	 * @retval Result On success, range is limited to the content
+	 * @note Requests for multiple ranges are ignored, as permitted by the standard
+	 */
+	Result parseRange(const String& value, uint32_t size);
+
+	/**
+	 * @brief Parse a `Content-Range` response header
+	 * @param value Header value such as `bytes 100-199/1000`
+	 * @param total If provided, receives length of complete content or 0 if not known
+	 * @retval bool false if the value doesn't describe a range
+	 */
+	bool parseContentRange(const String& value, uint32_t* total = nullptr);
+
+	/**
+	 * @brief Get value for `Content-Range` header
+	 * @param size Length of the complete content
+	 */
+	String toString(uint32_t size) const;
+};
@@ -63,10 +63,45 @@ void HttpRequest::reset()
 	responseStream = nullptr;
 
 	postParams.clear();
+	pathParams.clear();
 	files.clear();
 	headers.clear();
 }
 
+bool HttpRequest::acceptsEncoding(const String& acceptEncoding, const String& coding)
+{
+	bool wildcard{false};
+	unsigned offset{0};
+	while(offset < acceptEncoding.length()) {
+		int end = acceptEncoding.indexOf(',', offset);
+		if(end < 0) {
+			end = acceptEncoding.length();
+		}
+		String item = acceptEncoding.substring(offset, end);
+		offset = end + 1;
+
+		// Only quality parameter is relevant, where "q=0" means "not acceptable"
+		bool rejected{false};
+		int sep = item.indexOf(';');
+		if(sep >= 0) {
+			int q = item.indexOf(F("q="), sep);
+			rejected = (q > 0) && (strtof(item.c_str() + q + 2, nullptr) == 0);
+			item.setLength(sep);
+		}
+		item.trim();
+
+		if(item.equalsIgnoreCase(coding)) {
+			// An explicit entry overrides any wildcard
+			return !rejected;
+		}
+		if(item == "*") {
+			wildcard = !rejected;
+		}
+	}
+
+	return wildcard;
+}
+
 String HttpRequest::toString() const
 {
 	String content;
@@ -21,19 +21,21 @@
 #include "HttpHeaders.h"
 #include "HttpParams.h"
 #include "Data/ObjectMap.h"
+#include "Data/ObjectPool.h"
+#include "Data/Arena.h"
 
 class HttpConnection;
 
-using RequestHeadersCompletedDelegate = Delegate<int(HttpConnection& client, HttpResponse& response)>;
-using RequestBodyDelegate = Delegate<int(HttpConnection& client, const char* at, size_t length)>;
-using RequestCompletedDelegate = Delegate<int(HttpConnection& client, bool successful)>;
+using RequestHeadersCompletedDelegate = InplaceDelegate<int(HttpConnection& client, HttpResponse& response)>;
+using RequestBodyDelegate = InplaceDelegate<int(HttpConnection& client, const char* at, size_t length)>;
+using RequestCompletedDelegate = InplaceDelegate<int(HttpConnection& client, bool successful)>;
 
 /**
  * @brief Encapsulates an incoming or outgoing request
  * @ingroup http
  *
  */
-class HttpRequest
+class HttpRequest : public PoolAllocated<HttpRequest, HTTP_REQUEST_OBJECT_POOL_SIZE>
 {
 	friend class HttpClientConnection;
 	friend class HttpServerConnection;
@@ -54,7 +56,8 @@ public:
 	HttpRequest(const HttpRequest& value)
 		: uri(value.uri), method(value.method), headers(value.headers), postParams(value.postParams),
 		  headersCompletedDelegate(value.headersCompletedDelegate), requestBodyDelegate(value.requestBodyDelegate),
-		  requestCompletedDelegate(value.requestCompletedDelegate), sslInitDelegate(value.sslInitDelegate)
+		  requestCompletedDelegate(value.requestCompletedDelegate), sslInitDelegate(value.sslInitDelegate),
+		  inflateResponse(value.inflateResponse), resumable(value.resumable)
 	{
 	}
 
@@ -138,6 +141,23 @@ public:
 		return static_cast<const HttpHeaders&>(headers)[name];
 	}
 
+	/**
+	 * @brief Determine if client accepts a content encoding
+	 * @param coding Name of encoding, e.g. "gzip"
+	 * @retval bool true if listed in the `Accept-Encoding` header, directly or via "*", with non-zero quality
+	 */
+	bool acceptsEncoding(const String& coding) const
+	{
+		return acceptsEncoding(headers[HTTP_HEADER_ACCEPT_ENCODING], coding);
+	}
+
+	/**
+	 * @brief Determine if an `Accept-Encoding` header value permits a content encoding
+	 * @param acceptEncoding Header value
+	 * @param coding Name of encoding
+	 */
+	static bool acceptsEncoding(const String& acceptEncoding, const String& coding);
+
 	/**
 	 * @brief Get POST parameter value
 	 * @param name Name of parameter
@@ -155,7 +175,18 @@ public:
 	 */
 	String getQueryParameter(const String& name, const String& defaultValue = nullptr) const
 	{
-		return static_cast<const HttpParams&>(uri.Query)[name] ?: defaultValue;
+		return uri.Query.get(name) ?: defaultValue;
+	}
+
+	/**
+	 * @brief Get parameter captured from resource path
+	 * @param name Name of parameter, as given in resource path pattern
+	 * @param defaultValue Optional default value to use if requested parameter not present
+	 * @see See HttpResourceTree for details of path patterns
+	 */
+	String getPathParameter(const String& name, const String& defaultValue = nullptr) const
+	{
+		return static_cast<const HttpParams&>(pathParams)[name] ?: defaultValue;
 	}
 
 	/**
@@ -219,6 +250,42 @@ public:
 	 */
 	HttpRequest* setResponseStream(ReadWriteStream* stream);
 
+	/**
+	 * @brief Request a compressed response, to be decompressed on arrival
+	 * @param enable
+	 * @retval HttpRequest*
+	 *
+	 * Sends `Accept-Encoding: gzip, deflate` unless the header has already been set.
+	 * Responses with a matching `Content-Encoding` are inflated before being written to the
+	 * response stream. This doesn't apply to `onBody()` callbacks, which receive data as sent.
+	 *
+	 * @see INFLATE_STREAM_WINDOW_SIZE for memory requirements
+	 */
+	HttpRequest* setInflateResponse(bool enable = true)
+	{
+		inflateResponse = enable;
+		return this;
+	}
+
+	/**
+	 * @brief Continue an interrupted response from where it left off
+	 * @param enable
+	 * @retval HttpRequest*
+	 *
+	 * If the connection fails part-way through the response body, the request is re-sent with
+	 * `Range` and `If-Range` headers so only the remaining content is transferred.
+	 * This requires the server to provide a strong `ETag` or a `Last-Modified` date.
+	 * If the server sends the complete representation instead, the file is truncated and written again.
+	 *
+	 * @note Only FileStream responses can be resumed, and not if decoded by `setInflateResponse()`.
+	 * The status of a resumed response is `HTTP_STATUS_PARTIAL_CONTENT`.
+	 */
+	HttpRequest* setResumable(bool enable = true)
+	{
+		resumable = enable;
+		return this;
+	}
+
 	/**
 	 * @brief Get the response stream (if any)
 	 */
@@ -233,6 +300,17 @@ public:
 		return this;
 	}
 
+	/**
+	 * @brief Receive the response body in slices, as it arrives
+	 * @param delegateFunction Called with each slice, after any chunked transfer encoding is removed.
+	 * Return non-zero to abort the response.
+	 * @retval HttpRequest*
+	 *
+	 * Data is passed straight from the received TCP buffers, and no response buffer is allocated,
+	 * so memory use is independent of the response size.
+	 * If the consumer can't keep up, it may call `HttpConnection::holdReceive()` from the callback
+	 * so the server stops sending, then `HttpConnection::releaseReceive()` once it has caught up.
+	 */
 	HttpRequest* onBody(RequestBodyDelegate delegateFunction)
 	{
 		requestBodyDelegate = delegateFunction;
@@ -285,12 +363,19 @@ public:
 	HttpMethod method = HTTP_GET; ///< Request method
 	HttpHeaders headers;		  ///< Request headers
 	HttpParams postParams;		  ///< POST parameters
+	HttpParams pathParams;		  ///< Parameters captured from resource path
 	HttpFiles files;			  ///< Attached files
 
 	int retries = 0; ///< how many times the request should be send again...
 
 	void* args = nullptr; ///< Used to store data that should be valid during a single request
 
+	/**
+	 * @brief Memory for temporary data which is released when the next request begins
+	 * @note Only server connections provide an arena, will be nullptr otherwise
+	 */
+	Arena* arena = nullptr;
+
 protected:
 	RequestHeadersCompletedDelegate headersCompletedDelegate;
 	RequestBodyDelegate requestBodyDelegate;
@@ -299,6 +384,10 @@ protected:
 
 	IDataSourceStream* bodyStream = nullptr;
 	ReadWriteStream* responseStream = nullptr; ///< User-requested stream to store response
+	bool inflateResponse = false;
+	bool resumable = false;
+	uint32_t receivedLength = 0; ///< Response content written so far, for resuming
+	String resumeValidator;		 ///< Strong ETag or Last-Modified value from response
 
 #ifdef ENABLE_HTTP_REQUEST_AUTH
 	AuthAdapter* auth = nullptr;
@@ -12,6 +12,7 @@
 
 #include "HttpRequestAuth.h"
 #include "HttpRequest.h"
+#include "HttpDigest.h"
 #include <Data/WebHelpers/base64.h>
 
 // Basic Auth
@@ -28,35 +29,110 @@ void HttpDigestAuth::setResponse(HttpResponse* response)
 		return;
 	}
 
+	/*
+	 * Example (see: https://tools.ietf.org/html/rfc7616#section-3.3):
+	 *
+	 * WWW-Authenticate: Digest realm="http-auth@example.org",
+	 *		qop="auth, auth-int",
+	 *		algorithm=MD5,
+	 *		nonce="7ypf/xlj9XXwfDPEoM4URrv/xwf94BcCAzFZH4GiTo0v",
+	 *		opaque="FQhe/qaU925kfnzjCev0ciny7QMkPqMAFRtzCUYo5tdS"
+	 */
 	const String& authHeader = reinterpret_cast<const HttpHeaders&>(response->headers)[HTTP_HEADER_WWW_AUTHENTICATE];
-	if(authHeader.indexOf(F("Digest")) >= 0) {
-		/*
-		 * Example (see: https://tools.ietf.org/html/rfc2069#page-4):
-		 *
-		 * WWW-Authenticate: Digest    realm="testrealm@host.com",
-                            nonce="dcd98b7102dd2f0e8b11d0f600bfb0c093",
-                            opaque="5ccc069c403ebaf9f0171e9517f40e41"
-		 *
-		 */
-
-		// TODO: process WWW-Authenticate header
-
-		String authResponse = F("Digest username=\"");
-		authResponse += username;
+	HttpParams params;
+	if(!HttpDigest::parseParams(authHeader, params)) {
+		return;
+	}
+
+	String algorithm = params.get("algorithm");
+	if(algorithm && !algorithm.equalsIgnoreCase(F("MD5"))) {
+		debug_w("[HTTP] Digest algorithm '%s' not supported", algorithm.c_str());
+		return;
+	}
+
+	String newNonce = params.get("nonce");
+	String newRealm = params.get("realm");
+	if(!newNonce || !newRealm) {
+		return;
+	}
+	bool stale = params.get("stale").equalsIgnoreCase(F("true"));
+	if(newNonce == nonce && nonceCount != 0 && !stale) {
+		// Credentials were sent using this nonce and rejected, so no point retrying
+		debug_w("[HTTP] Digest authentication rejected");
+		return;
+	}
+
+	if(newRealm != realm || !ha1) {
+		realm = newRealm;
+		ha1 = HttpDigest::calculateHa1(username, realm, password);
+	}
+	nonce = newNonce;
+	opaque = params.get("opaque");
+	qopAuth = HttpDigest::hasQopAuth(params.get("qop"));
+	nonceCount = 0;
+
+	// Authorization gets added by prepareRequest()
+	request->retries = 1;
+}
+
+void HttpDigestAuth::prepareRequest(HttpRequest* request)
+{
+	if(!nonce) {
+		// No challenge received yet
+		return;
+	}
+
+	/*
+	 * Example (see: https://tools.ietf.org/html/rfc7616#section-3.9.1):
+	 *
+	 * Authorization: Digest username="Mufasa",
+	 *		realm="http-auth@example.org",
+	 *		uri="/dir/index.html",
+	 *		algorithm=MD5,
+	 *		nonce="7ypf/xlj9XXwfDPEoM4URrv/xwf94BcCAzFZH4GiTo0v",
+	 *		nc=00000001,
+	 *		cnonce="f2/wE4q74E6zIJEtWaHKaf5wv/H5QzzpXusqGemxURZJ",
+	 *		qop=auth,
+	 *		response="8ca523f5e9506fed4657c9700eebdbec",
+	 *		opaque="FQhe/qaU925kfnzjCev0ciny7QMkPqMAFRtzCUYo5tdS"
+	 */
+	String uri = request->uri.getPathWithQuery();
+	String qop;
+	String nc;
+	String cnonce;
+	if(qopAuth) {
+		qop = F("auth");
+		char buf[9];
+		m_snprintf(buf, sizeof(buf), _F("%08x"), ++nonceCount);
+		nc = buf;
+		cnonce = HttpDigest::createNonce(8);
+	} else {
+		++nonceCount;
+	}
+
+	String authResponse = F("Digest username=\"");
+	authResponse += username;
+	authResponse += F("\", realm=\"");
+	authResponse += realm;
+	authResponse += F("\", nonce=\"");
+	authResponse += nonce;
+	authResponse += F("\", uri=\"");
+	authResponse += uri;
+	authResponse += F("\", algorithm=MD5");
+	if(qopAuth) {
+		authResponse += F(", qop=auth, nc=");
+		authResponse += nc;
+		authResponse += F(", cnonce=\"");
+		authResponse += cnonce;
+		authResponse += '"';
+	}
+	authResponse += F(", response=\"");
+	authResponse += HttpDigest::calculateResponse(ha1, nonce, nc, cnonce, qop, request->method, uri);
+	authResponse += '"';
+	if(opaque) {
+		authResponse += F(", opaque=\"");
+		authResponse += opaque;
 		authResponse += '"';
-		/*
-		 * Example (see: https://tools.ietf.org/html/rfc2069#page-4):
-		 *
-		 * Authorization: Digest       username="Mufasa",
-                            realm="testrealm@host.com",
-                            nonce="dcd98b7102dd2f0e8b11d0f600bfb0c093",
-                            uri="/dir/index.html",
-                            response="e966c932a9242554e42c8ee200cec7f6",
-                            opaque="5ccc069c403ebaf9f0171e9517f40e41"
-		 */
-
-		// TODO: calculate the response...
-		request->headers[HTTP_HEADER_AUTHORIZATION] = authResponse;
-		request->retries = 1;
 	}
+	request->headers[HTTP_HEADER_AUTHORIZATION] = authResponse;
 }
@@ -28,6 +28,15 @@ public:
 	virtual void setResponse(HttpResponse* response)
 	{
 	}
+
+	/**
+	 * @brief Called just before request headers are sent
+	 *
+	 * Credentials which depend on the final request method and URI may be calculated here.
+	 */
+	virtual void prepareRequest(HttpRequest* request)
+	{
+	}
 };
 
 class HttpBasicAuth : public AuthAdapter
@@ -44,6 +53,16 @@ private:
 	String password;
 };
 
+/**
+ * @brief Client HTTP Digest authentication, as described in RFC 7616
+ *
+ * The server challenge and HA1 hash are retained after the first 401 response.
+ * If the same adapter is passed to subsequent requests they are sent with credentials
+ * up front, using an incrementing nonce count, so only one round trip is needed.
+ * A fresh challenge is only taken when the server rejects the nonce.
+ *
+ * @note Requests don't take ownership of adapters, so this one may be re-used.
+ */
 class HttpDigestAuth : public AuthAdapter
 {
 public:
@@ -58,8 +77,16 @@ public:
 
 	void setResponse(HttpResponse* response) override;
 
+	void prepareRequest(HttpRequest* request) override;
+
 private:
 	String username;
 	String password;
+	String realm;
+	String nonce;
+	String opaque;
+	String ha1; ///< Cached for current realm
+	uint32_t nonceCount{0};
+	bool qopAuth{false};
 	HttpRequest* request = nullptr;
 };
@@ -16,15 +16,26 @@
 #include <Data/ObjectMap.h>
 
 #include "Resource/HttpResourcePlugin.h"
+#include <memory>
 
 class HttpServerConnection;
 
+/**
+ * @brief Pre-rendered response headers for an immutable resource
+ * @ingroup httpserver
+ */
+struct HttpCachedResponse {
+	String path;	///< Request path the headers were rendered for
+	String etag;	///< Entity tag of the content
+	String headers; ///< Status line and headers, excluding per-request fields (Connection, Date)
+};
+
 using HttpServerConnectionBodyDelegate =
-	Delegate<int(HttpServerConnection& connection, HttpRequest&, const char* at, int length)>;
+	InplaceDelegate<int(HttpServerConnection& connection, HttpRequest&, const char* at, int length)>;
 using HttpServerConnectionUpgradeDelegate =
-	Delegate<int(HttpServerConnection& connection, HttpRequest&, char* at, int length)>;
+	InplaceDelegate<int(HttpServerConnection& connection, HttpRequest&, char* at, int length)>;
 using HttpResourceDelegate =
-	Delegate<int(HttpServerConnection& connection, HttpRequest& request, HttpResponse& response)>;
+	InplaceDelegate<int(HttpServerConnection& connection, HttpRequest& request, HttpResponse& response)>;
 
 /**
  * @brief Instances of this class are registered with an HttpServer for a specific URL
@@ -71,6 +82,22 @@ public:
 
 	void addPlugin(HttpResourcePlugin* plugin);
 
+	/**
+	 * @brief Cache the rendered response headers for this resource
+	 * @param enable
+	 * @note Only use for resources whose content never changes, such as flash-resident assets.
+	 * Responses are tagged using the stream `id()` if available, otherwise by hashing the content.
+	 * Conditional requests with a matching `If-None-Match` are answered with `304 Not Modified`.
+	 */
+	void enableResponseCache(bool enable = true)
+	{
+		if(!enable) {
+			responseCache.reset();
+		} else if(!responseCache) {
+			responseCache.reset(new HttpCachedResponse);
+		}
+	}
+
 	template <class... Tail> void addPlugin(HttpResourcePlugin* plugin, Tail... plugins)
 	{
 		addPlugin(plugin);
@@ -81,6 +108,7 @@ private:
 	friend class HttpServerConnection;
 
 	PluginRef::OwnedList plugins;
+	std::unique_ptr<HttpCachedResponse> responseCache;
 
 	int handleUrl(HttpServerConnection& connection, HttpRequest& request, HttpResponse& response);
 	int handleHeaders(HttpServerConnection& connection, HttpRequest& request, HttpResponse& response);
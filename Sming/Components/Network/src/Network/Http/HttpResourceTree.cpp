@@ -53,3 +53,241 @@ HttpResource* HttpResourceTree::set(String path, const HttpPathDelegate& callbac
 	set(path, res);
 	return res;
 }
+
+/* Router */
+
+#ifndef HTTP_RESOURCE_MAX_PARAMS
+#define HTTP_RESOURCE_MAX_PARAMS 8
+#endif
+
+struct HttpResourceTree::Node {
+	enum class Kind : uint8_t {
+		Static, ///< Matches text exactly
+		Param,  ///< Matches a single path segment
+	};
+
+	Node(Kind kind, const char* text, unsigned length) : text(text, length), kind(kind)
+	{
+	}
+
+	~Node()
+	{
+		delete child;
+		delete next;
+	}
+
+	Node* findChild(Kind kind, char c) const
+	{
+		for(auto node = child; node != nullptr; node = node->next) {
+			if(node->kind == kind && (kind == Kind::Param || node->text[0] == c)) {
+				return node;
+			}
+		}
+		return nullptr;
+	}
+
+	Node* addChild(Kind kind, const char* text, unsigned length)
+	{
+		auto node = new Node(kind, text, length);
+		// Keep parameter node at end of list, so static nodes are tried first
+		if(kind == Kind::Static || child == nullptr) {
+			node->next = child;
+			child = node;
+		} else {
+			auto last = child;
+			while(last->next != nullptr) {
+				last = last->next;
+			}
+			last->next = node;
+		}
+		return node;
+	}
+
+	/*
+	 * Split this static node so it matches only the first `length` characters
+	 */
+	void split(unsigned length)
+	{
+		auto tail = new Node(Kind::Static, text.c_str() + length, text.length() - length);
+		tail->resource = resource;
+		tail->catchAll = catchAll;
+		tail->child = child;
+		text.setLength(length);
+		resource = -1;
+		catchAll = -1;
+		child = tail;
+	}
+
+	void add(const char* pattern, int index);
+
+	String text; ///< Static text, or parameter name
+	Node* child{nullptr};
+	Node* next{nullptr};
+	int16_t resource{-1}; ///< Index of resource whose path ends here
+	int16_t catchAll{-1}; ///< Index of resource with '*' following here
+	Kind kind;
+};
+
+void HttpResourceTree::Node::add(const char* pattern, int index)
+{
+	if(*pattern == '\0') {
+		resource = index;
+		return;
+	}
+
+	if(pattern[0] == '*' && pattern[1] == '\0') {
+		catchAll = index;
+		return;
+	}
+
+	if(*pattern == '{') {
+		auto end = strchr(pattern, '}');
+		if(end != nullptr) {
+			++pattern;
+			auto node = findChild(Kind::Param, 0);
+			if(node == nullptr) {
+				node = addChild(Kind::Param, pattern, end - pattern);
+			} else if(node->text.length() != unsigned(end - pattern) ||
+					  memcmp(node->text.c_str(), pattern, node->text.length()) != 0) {
+				debug_w("[HTTP] Path parameter '%s' already registered as '%s'", String(pattern, end - pattern).c_str(),
+						node->text.c_str());
+			}
+			node->add(end + 1, index);
+			return;
+		}
+		// No closing brace, treat as literal text
+	}
+
+	// Static text extends to next pattern, excluding any leading brace already handled above
+	unsigned length = 1;
+	while(pattern[length] != '\0' && pattern[length] != '{' && !(pattern[length] == '*' && pattern[length + 1] == '\0')) {
+		++length;
+	}
+
+	auto node = findChild(Kind::Static, *pattern);
+	if(node == nullptr) {
+		node = addChild(Kind::Static, pattern, length);
+		node->add(pattern + length, index);
+		return;
+	}
+
+	unsigned common = 1;
+	while(common < length && common < node->text.length() && node->text[common] == pattern[common]) {
+		++common;
+	}
+	if(common < node->text.length()) {
+		node->split(common);
+	}
+	node->add(pattern + common, index);
+}
+
+/*
+ * Walks the tree and records parameter captures, backtracking where a branch fails to match
+ */
+class HttpResourceTree::Matcher
+{
+public:
+	int match(const Node& node, const char* path)
+	{
+		if(*path == '\0' && node.resource >= 0) {
+			return node.resource;
+		}
+
+		for(auto child = node.child; child != nullptr; child = child->next) {
+			if(child->kind == Node::Kind::Static) {
+				if(strncmp(path, child->text.c_str(), child->text.length()) != 0) {
+					continue;
+				}
+				int index = match(*child, path + child->text.length());
+				if(index >= 0) {
+					return index;
+				}
+				continue;
+			}
+
+			// Parameter
+			auto end = path;
+			while(*end != '\0' && *end != '/') {
+				++end;
+			}
+			if(end == path) {
+				continue;
+			}
+			unsigned n = count;
+			capture(child->text, path, end - path);
+			int index = match(*child, end);
+			if(index >= 0) {
+				return index;
+			}
+			count = n;
+		}
+
+		if(node.catchAll >= 0) {
+			static const String wildcard{'*'};
+			capture(wildcard, path, strlen(path));
+			return node.catchAll;
+		}
+
+		return -1;
+	}
+
+	void getParams(HttpParams& params) const
+	{
+		for(unsigned i = 0; i < count; ++i) {
+			auto& c = captures[i];
+			params[*c.name] = String(c.value, c.length);
+		}
+	}
+
+private:
+	void capture(const String& name, const char* value, unsigned length)
+	{
+		if(count < HTTP_RESOURCE_MAX_PARAMS) {
+			captures[count++] = {&name, value, uint16_t(length)};
+		}
+	}
+
+	struct Capture {
+		const String* name;
+		const char* value;
+		uint16_t length;
+	};
+	Capture captures[HTTP_RESOURCE_MAX_PARAMS];
+	unsigned count{0};
+};
+
+HttpResourceTree::HttpResourceTree() = default;
+
+HttpResourceTree::~HttpResourceTree() = default;
+
+void HttpResourceTree::buildRouter()
+{
+	router.reset(new Node(Node::Kind::Static, "", 0));
+	for(unsigned i = 0; i < count(); ++i) {
+		auto& path = keyAt(i);
+		if(path != RESOURCE_PATH_DEFAULT) {
+			router->add(path.c_str(), i);
+		}
+	}
+	routerCount = count();
+	routerValid = true;
+}
+
+HttpResource* HttpResourceTree::route(const String& path, HttpParams* params)
+{
+	if(!routerValid || routerCount != count()) {
+		buildRouter();
+	}
+
+	Matcher matcher;
+	int index = matcher.match(*router, path.c_str());
+	if(index < 0) {
+		return nullptr;
+	}
+
+	if(params != nullptr) {
+		matcher.getParams(*params);
+	}
+
+	return entries[index].value.get();
+}
@@ -13,8 +13,9 @@
 #pragma once
 
 #include "HttpResource.h"
+#include "HttpParams.h"
 
-using HttpPathDelegate = Delegate<void(HttpRequest& request, HttpResponse& response)>;
+using HttpPathDelegate = InplaceDelegate<void(HttpRequest& request, HttpResponse& response)>;
 
 /** @brief Identifies the default resource path */
 #define RESOURCE_PATH_DEFAULT String('*')
@@ -22,10 +23,23 @@ using HttpPathDelegate = Delegate<void(HttpRequest& request, HttpResponse& respo
 /**
  * @brief Class to map URL paths to classes which handle them
  * @ingroup httpserver
+ *
+ * Paths may contain patterns which are matched by `route()`:
+ *
+ * - `{name}` matches a single path segment, captured as parameter 'name'
+ * - `*` as the final character of a path matches anything following, captured as parameter '*'
+ *
+ * For example, `/api/devices/{id}/status`.
+ * Where more than one path matches, literal text takes priority over `{name}`, then `*`.
+ *
+ * Lookups use a radix tree built from the registered paths, so cost depends on
+ * the length of the path being matched rather than the number of resources.
  */
 class HttpResourceTree : public ObjectMap<String, HttpResource>
 {
 public:
+	HttpResourceTree();
+	~HttpResourceTree();
 	/** @brief Set the default resource handler
 	 *  @param resource The default resource handler
 	 */
@@ -57,7 +71,32 @@ public:
 		return find(RESOURCE_PATH_DEFAULT);
 	}
 
-	using ObjectMap::set;
+	/**
+	 * @brief Find resource matching given request path
+	 * @param path Request path, excluding query
+	 * @param params If provided, receives any parameters captured from the path
+	 * @retval HttpResource* The matching resource, nullptr if not found
+	 * @note The default resource is not returned by this method
+	 */
+	HttpResource* route(const String& path, HttpParams* params = nullptr);
+
+	/**
+	 * @brief Set resource for given path
+	 * @param path URL path, may contain patterns
+	 * @param resource
+	 * @note Any existing handler for this path is replaced
+	 */
+	void set(const String& path, HttpResource* resource)
+	{
+		ObjectMap::set(path, resource);
+		routerValid = false;
+	}
+
+	void clear()
+	{
+		ObjectMap::clear();
+		routerValid = false;
+	}
 
 	template <class... Tail>
 	HttpResource* set(const String& path, HttpResource* resource, HttpResourcePlugin* plugin, Tail... plugins)
@@ -136,5 +175,13 @@ private:
 		registerPlugin(plugins...);
 	}
 
+	struct Node;
+	class Matcher;
+
+	void buildRouter();
+
 	HttpResourcePlugin::OwnedList loadedPlugins;
+	std::unique_ptr<Node> router;
+	unsigned routerCount{0}; ///< Entry count when router was built, detects use of ObjectMap methods
+	bool routerValid{false};
 };
@@ -14,6 +14,7 @@
 #include <Data/WebConstants.h>
 #include "Data/Stream/MemoryDataStream.h"
 #include "Data/Stream/FileStream.h"
+#include "Data/Stream/FlashMemoryStream.h"
 #include <esp_systemapi.h>
 
 HttpResponse* HttpResponse::setCookie(const String& name, const String& value, bool append)
@@ -66,11 +67,13 @@ bool HttpResponse::sendFile(const String& fileName, bool allowGzipFileCheck)
 {
 	auto fs = new FileStream;
 
-	if(allowGzipFileCheck) {
+	// Compressed file is preferred, but if client can't accept it only use it as a fallback
+	if(allowGzipFileCheck && (gzipAccepted || !fileExist(fileName))) {
 		String fnCompressed = fileName + _F(".gz");
 		if(fs->open(fnCompressed)) {
 			debug_d("found %s", fnCompressed.c_str());
 			headers[HTTP_HEADER_CONTENT_ENCODING] = F("gzip");
+			headers[HTTP_HEADER_VARY] = F("Accept-Encoding");
 			return sendDataStream(fs, ContentType::fromFullFileName(fileName));
 		}
 	}
@@ -92,6 +95,39 @@ bool HttpResponse::sendFile(const String& fileName, bool allowGzipFileCheck)
 	return false;
 }
 
+template <class Files> bool HttpResponse::sendFlashFile(const Files& files, const String& fileName, bool allowGzipFileCheck)
+{
+	auto file = files[fileName];
+	if(allowGzipFileCheck && (gzipAccepted || !file)) {
+		String fnCompressed = fileName + _F(".gz");
+		auto compressed = files[fnCompressed];
+		if(compressed) {
+			debug_d("found %s", fnCompressed.c_str());
+			headers[HTTP_HEADER_CONTENT_ENCODING] = F("gzip");
+			headers[HTTP_HEADER_VARY] = F("Accept-Encoding");
+			return sendDataStream(new FSTR::Stream(compressed.content()), ContentType::fromFullFileName(fileName));
+		}
+	}
+
+	if(file) {
+		debug_d("found %s", fileName.c_str());
+		return sendDataStream(new FSTR::Stream(file.content()), ContentType::fromFullFileName(fileName));
+	}
+
+	code = HTTP_STATUS_NOT_FOUND;
+	return false;
+}
+
+bool HttpResponse::sendFile(const FlashFileMap& files, const String& fileName, bool allowGzipFileCheck)
+{
+	return sendFlashFile(files, fileName, allowGzipFileCheck);
+}
+
+bool HttpResponse::sendFile(const FlashFileIndex& files, const String& fileName, bool allowGzipFileCheck)
+{
+	return sendFlashFile(files, fileName, allowGzipFileCheck);
+}
+
 bool HttpResponse::sendNamedStream(IDataSourceStream* newDataStream)
 {
 	String contentType;
@@ -126,6 +162,7 @@ void HttpResponse::reset()
 {
 	code = HTTP_STATUS_OK;
 	headers.clear();
+	compress = false;
 	freeStreams();
 }
 
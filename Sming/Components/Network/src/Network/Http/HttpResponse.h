@@ -16,6 +16,8 @@
 #include "Data/Stream/ReadWriteStream.h"
 #include "HttpHeaders.h"
 #include "FileSystem.h"
+#include <FlashString/Map.hpp>
+#include <Data/FlashMapIndex.h>
 
 /**
  * @brief Represents either an incoming or outgoing response to a HTTP request
@@ -55,6 +57,18 @@ public:
 
 	HttpResponse* setCache(int maxAgeSeconds = 3600, bool isPublic = false);
 
+	/**
+	 * @brief Compress the response body if the client supports it
+	 * @param enable
+	 * @note Encoding is negotiated against the request `Accept-Encoding` header when
+	 * the response is sent. Content which already has a `Content-Encoding` is left unchanged.
+	 */
+	HttpResponse* setCompression(bool enable = true)
+	{
+		compress = enable;
+		return this;
+	}
+
 	// Access-Control-Allow-Origin for AJAX from a different domain
 	HttpResponse* setAllowCrossDomainOrigin(const String& controlAllowOrigin)
 	{
@@ -65,11 +79,42 @@ public:
 	/**
 	 * @brief Send file by name
 	 * @param fileName
-	 * @param allowGzipFileCheck If true, check file extension to see if content compressed
+	 * @param allowGzipFileCheck If true, serve a compressed `.gz` version of the file if one exists.
+	 * This is preferred if the client accepts gzip encoding, otherwise it's used only if the
+	 * uncompressed file is absent.
 	 * @retval bool
 	 */
 	bool sendFile(const String& fileName, bool allowGzipFileCheck = true);
 
+	/**
+	 * @brief Map of file names to content, stored in flash
+	 */
+	using FlashFileMap = FSTR::Map<FSTR::String, FSTR::String>;
+
+	/**
+	 * @brief Send file from a map stored in flash
+	 * @param files Files, keyed by name
+	 * @param fileName
+	 * @param allowGzipFileCheck If true, look for a compressed `.gz` entry
+	 * @retval bool
+	 */
+	bool sendFile(const FlashFileMap& files, const String& fileName, bool allowGzipFileCheck = true);
+
+	/**
+	 * @brief Hashed index for a FlashFileMap
+	 * @note Use this when serving many files, as lookups in FlashFileMap are linear
+	 */
+	using FlashFileIndex = FlashMapIndex<FlashFileMap>;
+
+	/**
+	 * @brief Send file from a map stored in flash, using an index to locate it
+	 * @param files Index for map of files, keyed by name
+	 * @param fileName
+	 * @param allowGzipFileCheck If true, look for a compressed `.gz` entry
+	 * @retval bool
+	 */
+	bool sendFile(const FlashFileIndex& files, const String& fileName, bool allowGzipFileCheck = true);
+
 	/**
 	 * @brief Parse and send stream, using the name to determine the content type
 	 * @param newDataStream If not set already, the contentType will be obtained from the name of this stream
@@ -144,12 +189,15 @@ public:
 
 private:
 	void setStream(IDataSourceStream* stream);
+	template <class Files> bool sendFlashFile(const Files& files, const String& fileName, bool allowGzipFileCheck);
 
 public:
 	HttpStatus code = HTTP_STATUS_OK;	///< The HTTP status response code
 	HttpHeaders headers;				 ///< Response headers
 	ReadWriteStream* buffer = nullptr;   ///< Internal stream for storing strings and receiving responses
 	IDataSourceStream* stream = nullptr; ///< The body stream
+	bool compress = false;				 ///< Compress body stream if client supports it
+	bool gzipAccepted = true;			 ///< Set by server from request `Accept-Encoding` header
 };
 
 inline String toString(const HttpResponse& res)
@@ -16,12 +16,20 @@
 #include "Network/TcpServer.h"
 #include <Data/WebConstants.h>
 #include "Data/Stream/ChunkedStream.h"
-#include <SystemClock.h>
+#include "Data/Stream/DeflateOutputStream.h"
+#include "Data/Stream/RangeStream.h"
+#include "HttpRange.h"
 
 #if HTTP_SERVER_EXPOSE_VERSION == 1
 #include <SmingVersion.h>
 #endif
 
+namespace
+{
+METRIC_HISTOGRAM(requestTime, "sming_http_request_duration_us",
+				 "Time from start of HTTP request until response is sent");
+} // namespace
+
 int HttpServerConnection::onMessageBegin(http_parser* parser)
 {
 	// Reset Response ...
@@ -30,11 +38,13 @@ int HttpServerConnection::onMessageBegin(http_parser* parser)
 	// ... and Request
 	request.reset();
 	request.setMethod((const HttpMethod)parser->method);
+	arena.reset();
 
 	// and temp data...
 	reset();
 	bodyParser = nullptr;
 	hasContentError = false;
+	requestTimer.start();
 
 	return 0;
 }
@@ -49,7 +59,7 @@ int HttpServerConnection::onPath(const Url& uri)
 
 	request.setURL(uri);
 
-	resource = resourceTree->find(request.uri.Path);
+	resource = resourceTree->route(request.uri.Path, &request.pathParams);
 	if(resource == nullptr) {
 		resource = resourceTree->getDefault();
 	}
@@ -81,6 +91,10 @@ int HttpServerConnection::onMessageComplete(http_parser* parser)
 
 	if(!hasError) {
 		send();
+		// Response still in progress: hold off parsing any pipelined requests until it's sent
+		if(parser != nullptr && !parser->upgrade && state != eHCS_Ready) {
+			http_parser_pause(parser, 1);
+		}
 	}
 
 	return hasError;
@@ -104,6 +118,7 @@ int HttpServerConnection::onHeadersComplete(const HttpHeaders& headers)
 	 */
 	int error = 0;
 	request.setHeaders(headers);
+	response.gzipAccepted = request.acceptsEncoding(F("gzip"));
 
 	if(resource != nullptr) {
 		error = resource->handleHeaders(*this, request, response);
@@ -232,8 +247,11 @@ void HttpServerConnection::onReadyToSendData(TcpConnectionEvent sourceEvent)
 	}
 
 	case eHCS_Sent: {
-		if(response.headers[HTTP_HEADER_CONNECTION] == F("close")) {
+		requestTimer.stop(requestTime);
+		bool closing = (response.headers[HTTP_HEADER_CONNECTION] == F("close"));
+		if(closing) {
 			setTimeOut(1); // decrease the timeout to 1 tick
+			pipelineData = nullptr;
 		}
 
 		response.reset();
@@ -241,6 +259,10 @@ void HttpServerConnection::onReadyToSendData(TcpConnectionEvent sourceEvent)
 
 		state = eHCS_Ready;
 
+		if(HTTP_PARSER_ERRNO(&parser) == HPE_PAUSED && !closing) {
+			resumeParser();
+		}
+
 		break;
 	}
 
@@ -251,43 +273,173 @@ void HttpServerConnection::onReadyToSendData(TcpConnectionEvent sourceEvent)
 	TcpClient::onReadyToSendData(sourceEvent);
 }
 
+bool HttpServerConnection::onTcpReceive(TcpClient& client, char* data, int size)
+{
+	if(HTTP_PARSER_ERRNO(&parser) == HPE_PAUSED) {
+		return queueRequestData(data, size);
+	}
+
+	return HttpConnection::onTcpReceive(client, data, size);
+}
+
+bool HttpServerConnection::queueRequestData(const char* data, size_t length)
+{
+	if(length == 0) {
+		return true;
+	}
+
+	if(pipelineData.length() + length > HTTP_SERVER_PIPELINE_BUFSIZE) {
+		debug_w("HttpServerConnection: Pipeline limit exceeded, dropping connection");
+		return false;
+	}
+
+	return pipelineData.concat(data, length);
+}
+
+void HttpServerConnection::resumeParser()
+{
+	http_parser_pause(&parser, 0);
+
+	if(!pipelineData) {
+		return;
+	}
+
+	// Take the data: parsing may pause again and queue whatever remains
+	String data = std::move(pipelineData);
+	if(!onTcpReceive(*this, data.begin(), data.length())) {
+		setTimeOut(1);
+	}
+}
+
+namespace
+{
+/*
+ * Tag stream content using a FNV-1a hash, restoring the read position afterwards.
+ * Used for cached resources whose stream doesn't provide an id()
+ */
+String getContentTag(IDataSourceStream& stream)
+{
+	int start = stream.seekFrom(0, SeekOrigin::Current);
+	if(start < 0) {
+		return nullptr;
+	}
+
+	uint32_t hash{2166136261U};
+	size_t length{0};
+	char buffer[64];
+	size_t count;
+	while((count = stream.readMemoryBlock(buffer, sizeof(buffer))) != 0) {
+		for(unsigned i = 0; i < count; ++i) {
+			hash = (hash ^ uint8_t(buffer[i])) * 16777619U;
+		}
+		length += count;
+		stream.seek(count);
+	}
+
+	if(stream.seekFrom(start, SeekOrigin::Start) != start) {
+		debug_e("HttpServerConnection: Failed to rewind stream");
+		return nullptr;
+	}
+
+	String tag(length, HEX);
+	tag += '-';
+	tag += String(hash, HEX);
+	return tag;
+}
+
+/*
+ * Choose a content encoding from the request Accept-Encoding header, preferring gzip.
+ * Returns false if neither gzip or deflate are acceptable.
+ */
+bool getAcceptedEncoding(const String& acceptEncoding, DeflateOutputStream::Format& format)
+{
+	if(HttpRequest::acceptsEncoding(acceptEncoding, F("gzip"))) {
+		format = DeflateOutputStream::Format::Gzip;
+		return true;
+	}
+
+	if(HttpRequest::acceptsEncoding(acceptEncoding, F("deflate"))) {
+		format = DeflateOutputStream::Format::Zlib;
+		return true;
+	}
+
+	return false;
+}
+
+/*
+ * Compare ETag values using weak comparison, as for If-None-Match
+ */
+bool etagMatches(const String& value, const String& etag)
+{
+	auto strip = [](const String& s) { return s.startsWith("W/") ? s.substring(2) : s; };
+	return value.length() != 0 && strip(value) == strip(etag);
+}
+
+/*
+ * If-Range requires strong comparison, or an exact match with the modification date
+ */
+bool ifRangeMatches(const String& value, const HttpHeaders& headers)
+{
+	if(value.startsWith("\"")) {
+		return !headers[HTTP_HEADER_ETAG].startsWith("W/") && value == headers[HTTP_HEADER_ETAG];
+	}
+	return value.length() != 0 && value == headers[HTTP_HEADER_LAST_MODIFIED];
+}
+
+} // namespace
+
 void HttpServerConnection::sendResponseHeaders(HttpResponse* response)
 {
+	HttpCachedResponse* cache{nullptr};
 #ifndef DISABLE_HTTPSRV_ETAG
+	if(resource != nullptr && response->code == HTTP_STATUS_OK && response->stream != nullptr) {
+		cache = resource->responseCache.get();
+	}
+	bool cacheHit = (cache != nullptr && cache->path == request.uri.Path);
+
 	if(response->stream != nullptr && !response->headers.contains(HTTP_HEADER_ETAG)) {
 		String tag = response->stream->id();
+		if(tag.length() == 0 && cache != nullptr) {
+			tag = cacheHit ? cache->etag.substring(1, cache->etag.length() - 1) : getContentTag(*response->stream);
+		}
 		if(tag.length() > 0) {
 			String s;
-			s += '"';
-			s += tag;
-			s += '"';
+			s.concatAll('"', tag, '"');
 			response->headers[HTTP_HEADER_ETAG] = s;
 		}
 	}
 
-	if(request.headers.contains(HTTP_HEADER_IF_MATCH) && response->headers.contains(HTTP_HEADER_ETAG) &&
-	   request.headers[HTTP_HEADER_IF_MATCH] == response->headers[HTTP_HEADER_ETAG]) {
-		if(request.method == HTTP_GET || request.method == HTTP_HEAD) {
+	if(response->headers.contains(HTTP_HEADER_ETAG) && (request.method == HTTP_GET || request.method == HTTP_HEAD)) {
+		auto& etag = response->headers[HTTP_HEADER_ETAG];
+		if(etagMatches(request.headers[HTTP_HEADER_IF_NONE_MATCH], etag) || request.headers[HTTP_HEADER_IF_MATCH] == etag) {
 			response->code = HTTP_STATUS_NOT_MODIFIED;
 			response->headers[HTTP_HEADER_CONTENT_LENGTH] = "0";
+			response->headers.remove(HTTP_HEADER_TRANSFER_ENCODING);
 			delete response->stream;
 			response->stream = nullptr;
+			cache = nullptr;
 		}
 	}
-#endif /* DISABLE_HTTPSRV_ETAG */
 
-	String statusLine = F("HTTP/1.1 ");
-	statusLine += unsigned(response->code);
-	statusLine += ' ';
-	statusLine += toString(response->code);
-	statusLine += "\r\n";
-	sendString(statusLine);
-	if(response->stream != nullptr && response->stream->available() >= 0) {
-		response->headers[HTTP_HEADER_CONTENT_LENGTH] = String(response->stream->available());
+	if(applyRange(response) || compressResponse(response)) {
+		// Cached headers are for the complete, uncompressed representation
+		cache = nullptr;
+		cacheHit = false;
+	}
+
+	if(cache != nullptr && (!cacheHit || cache->etag != response->headers[HTTP_HEADER_ETAG])) {
+		// Content has changed or resource is serving another path
+		cacheHit = false;
+		cache->path = request.uri.Path;
+		cache->etag = response->headers[HTTP_HEADER_ETAG];
+		cache->headers = nullptr;
 	}
-	if(!response->headers.contains(HTTP_HEADER_CONTENT_LENGTH) && response->stream == nullptr) {
-		response->headers[HTTP_HEADER_CONTENT_LENGTH] = "0";
+#else
+	bool cacheHit = false;
+	if(!applyRange(response)) {
+		compressResponse(response);
 	}
+#endif /* DISABLE_HTTPSRV_ETAG */
 
 	if(!response->headers.contains(HTTP_HEADER_CONNECTION)) {
 		if(request.headers[HTTP_HEADER_CONNECTION] == F("close")) {
@@ -298,26 +450,139 @@ void HttpServerConnection::sendResponseHeaders(HttpResponse* response)
 		}
 	}
 
+	String date = httpGetCurrentDate();
+	if(date) {
+		response->headers[HTTP_HEADER_DATE] = date;
+	}
+
+	if(cacheHit && cache->headers) {
+		sendString(cache->headers);
+	} else {
+		String content;
+		content.concatAll(F("HTTP/1.1 "), unsigned(response->code), ' ', toString(response->code), "\r\n");
+
+		if(response->stream != nullptr && response->stream->available() >= 0) {
+			response->headers[HTTP_HEADER_CONTENT_LENGTH] = String(response->stream->available());
+		}
+		if(!response->headers.contains(HTTP_HEADER_CONTENT_LENGTH) && response->stream == nullptr) {
+			response->headers[HTTP_HEADER_CONTENT_LENGTH] = "0";
+		}
+
 #if HTTP_SERVER_EXPOSE_NAME == 1
-	if(!response->headers.contains(HTTP_HEADER_SERVER)) {
-		String s = F("HttpServer/Sming");
+		if(!response->headers.contains(HTTP_HEADER_SERVER)) {
+			String s = F("HttpServer/Sming");
 #if HTTP_SERVER_EXPOSE_VERSION == 1
-		s += F(" Sming/" SMING_VERSION);
+			s += F(" Sming/" SMING_VERSION);
 #endif
-		response->headers[HTTP_HEADER_SERVER] = s;
-	}
+			response->headers[HTTP_HEADER_SERVER] = s;
+		}
 #endif
 
-	if(SystemClock.isSet()) {
-		response->headers[HTTP_HEADER_DATE] = DateTime(SystemClock.now(eTZ_UTC)).toHTTPDate();
+		for(auto hdr : response->headers) {
+			if(cache == nullptr || (hdr.key() != HTTP_HEADER_CONNECTION && hdr.key() != HTTP_HEADER_DATE)) {
+				content += hdr;
+			}
+		}
+
+		if(cache != nullptr) {
+			cache->headers = content;
+		}
+		sendString(content);
 	}
 
-	for(auto hdr : response->headers) {
-		sendString(hdr);
+	if(cache != nullptr) {
+		// Per-request fields are never cached
+		auto& headers = response->headers;
+		sendString(headers.toString(HTTP_HEADER_CONNECTION, headers[HTTP_HEADER_CONNECTION]));
+		if(headers.contains(HTTP_HEADER_DATE)) {
+			sendString(headers.toString(HTTP_HEADER_DATE, headers[HTTP_HEADER_DATE]));
+		}
 	}
+
 	sendString("\r\n");
 }
 
+bool HttpServerConnection::applyRange(HttpResponse* response)
+{
+	auto& headers = response->headers;
+	auto stream = response->stream;
+	if(response->code != HTTP_STATUS_OK || stream == nullptr) {
+		return false;
+	}
+
+	// Content must be of known size and seekable
+	int size = stream->available();
+	if(size < 0 || stream->seekFrom(0, SeekOrigin::Current) != 0) {
+		return false;
+	}
+	headers[HTTP_HEADER_ACCEPT_RANGES] = F("bytes");
+
+	if(request.method != HTTP_GET || !request.headers.contains(HTTP_HEADER_RANGE)) {
+		return false;
+	}
+
+	if(request.headers.contains(HTTP_HEADER_IF_RANGE) &&
+	   !ifRangeMatches(request.headers[HTTP_HEADER_IF_RANGE], headers)) {
+		// Representation has changed, send all of it
+		return false;
+	}
+
+	HttpRange range;
+	switch(range.parseRange(request.headers[HTTP_HEADER_RANGE], size)) {
+	case HttpRange::Result::Ok:
+		debug_d("HttpServerConnection: Sending range %u-%u of %d", range.start, range.end, size);
+		response->code = HTTP_STATUS_PARTIAL_CONTENT;
+		headers[HTTP_HEADER_CONTENT_RANGE] = range.toString(size);
+		response->stream = new RangeStream(stream, range.start, range.length());
+		return true;
+
+	case HttpRange::Result::Unsatisfiable: {
+		response->code = HTTP_STATUS_RANGE_NOT_SATISFIABLE;
+		String s = F("bytes */");
+		s += size;
+		headers[HTTP_HEADER_CONTENT_RANGE] = s;
+		headers[HTTP_HEADER_CONTENT_LENGTH] = "0";
+		delete response->stream;
+		response->stream = nullptr;
+		return true;
+	}
+
+	case HttpRange::Result::Ignore:
+	default:
+		return false;
+	}
+}
+
+bool HttpServerConnection::compressResponse(HttpResponse* response)
+{
+	auto& headers = response->headers;
+	if(!response->compress || response->stream == nullptr || request.method == HTTP_HEAD ||
+	   headers.contains(HTTP_HEADER_CONTENT_ENCODING)) {
+		return false;
+	}
+
+	DeflateOutputStream::Format format;
+	if(!getAcceptedEncoding(request.headers[HTTP_HEADER_ACCEPT_ENCODING], format)) {
+		return false;
+	}
+
+	response->stream = new DeflateOutputStream(response->stream, format);
+	headers[HTTP_HEADER_CONTENT_ENCODING] = (format == DeflateOutputStream::Format::Gzip) ? F("gzip") : F("deflate");
+	headers[HTTP_HEADER_VARY] = headers.toString(HTTP_HEADER_ACCEPT_ENCODING);
+	headers.remove(HTTP_HEADER_CONTENT_LENGTH);
+	headers.remove(HTTP_HEADER_ACCEPT_RANGES);
+	headers[HTTP_HEADER_TRANSFER_ENCODING] = F("chunked");
+
+	// Representation differs from the source content, so any ETag is only weakly valid
+	if(headers.contains(HTTP_HEADER_ETAG) && !headers[HTTP_HEADER_ETAG].startsWith("W/")) {
+		String tag = F("W/");
+		tag += headers[HTTP_HEADER_ETAG];
+		headers[HTTP_HEADER_ETAG] = tag;
+	}
+
+	return true;
+}
+
 bool HttpServerConnection::sendResponseBody(HttpResponse* response)
 {
 	if(state == eHCS_StartBody) {
@@ -15,9 +15,20 @@
 #include "HttpConnection.h"
 #include "HttpResource.h"
 #include "HttpBodyParser.h"
+#include <Services/Profiling/Metrics.h>
 
 #include <functional>
 
+/**
+ * @brief Maximum number of bytes of pipelined request data held per connection
+ *
+ * Requests received whilst a response is still being sent are queued and parsed
+ * once it completes. If the limit is exceeded the connection is dropped.
+ */
+#ifndef HTTP_SERVER_PIPELINE_BUFSIZE
+#define HTTP_SERVER_PIPELINE_BUFSIZE 2048
+#endif
+
 /** @ingroup   	httpserver
  *  @brief      Provides http server connection
  *  @{
@@ -35,6 +46,7 @@ class HttpServerConnection : public HttpConnection
 public:
 	HttpServerConnection(tcp_pcb* clientTcp) : HttpConnection(clientTcp, HTTP_REQUEST)
 	{
+		request.arena = &arena;
 	}
 
 	~HttpServerConnection()
@@ -111,12 +123,17 @@ protected:
 	bool onHttpError(HttpError error) override;
 
 	// TCP methods
+	bool onTcpReceive(TcpClient& client, char* data, int size) override;
 	void onReadyToSendData(TcpConnectionEvent sourceEvent) override;
 	virtual void sendError(const String& message = nullptr, HttpStatus code = HTTP_STATUS_BAD_REQUEST);
 
 private:
 	void sendResponseHeaders(HttpResponse* response);
+	bool applyRange(HttpResponse* response);
+	bool compressResponse(HttpResponse* response);
 	bool sendResponseBody(HttpResponse* response);
+	bool queueRequestData(const char* data, size_t length);
+	void resumeParser();
 
 public:
 	void* userData = nullptr; ///< use to pass user data between requests
@@ -125,6 +142,7 @@ private:
 	HttpResourceTree* resourceTree = nullptr; ///< A reference to the current resource tree - we don't own it
 	HttpResource* resource = nullptr;		  ///< Resource for currently executing path
 
+	Arena arena{HTTP_REQUEST_ARENA_SIZE}; ///< Temporary data for current request
 	HttpRequest request;
 
 	HttpResourceDelegate headersCompleteDelegate = nullptr;
@@ -136,6 +154,8 @@ private:
 	HttpBodyParserDelegate bodyParser = nullptr; ///< Active body parser for this message, if any
 	bool closeOnContentError = false;
 	bool hasContentError = false;
+	String pipelineData; ///< Pipelined requests waiting for the current response to complete
+	Profiling::Metrics::Stopwatch requestTimer;
 };
 
 /** @} */
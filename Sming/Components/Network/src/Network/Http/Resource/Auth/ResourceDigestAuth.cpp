@@ -0,0 +1,90 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * ResourceDigestAuth.cpp
+ *
+ ****/
+
+#include "ResourceDigestAuth.h"
+#include "../../HttpDigest.h"
+#include <Network/Url.h>
+#include <Platform/Timers.h>
+
+ResourceDigestAuth::ResourceDigestAuth(const String& realm, const String& username, const String& password,
+									   unsigned nonceLifetime)
+	: realm(realm), username(username), ha1(HttpDigest::calculateHa1(username, realm, password)),
+	  nonceLifetime(nonceLifetime)
+{
+}
+
+bool ResourceDigestAuth::headersComplete(HttpServerConnection&, HttpRequest& request, HttpResponse& response)
+{
+	bool stale{false};
+	if(checkAuthorization(request, stale)) {
+		return true;
+	}
+
+	// specify that the resource is protected...
+	String challenge = F("Digest realm=\"");
+	challenge += realm;
+	challenge += F("\", qop=\"auth\", algorithm=MD5, nonce=\"");
+	challenge += getNonce();
+	challenge += '"';
+	if(stale) {
+		challenge += F(", stale=true");
+	}
+	response.code = HTTP_STATUS_UNAUTHORIZED;
+	response.headers[HTTP_HEADER_WWW_AUTHENTICATE] = challenge;
+
+	return false;
+}
+
+const String& ResourceDigestAuth::getNonce()
+{
+	auto now = millis();
+	if(!nonce || now - nonceTime >= nonceLifetime * 1000U) {
+		nonce = HttpDigest::createNonce();
+		nonceTime = now;
+	}
+	return nonce;
+}
+
+bool ResourceDigestAuth::checkAuthorization(const HttpRequest& request, bool& stale)
+{
+	HttpParams params;
+	if(!HttpDigest::parseParams(request.headers[HTTP_HEADER_AUTHORIZATION], params)) {
+		return false;
+	}
+
+	if(params.get("username") != username || params.get("realm") != realm) {
+		return false;
+	}
+
+	String uri = params.get("uri");
+	if(Url(uri).Path != request.uri.Path) {
+		debug_w("[HTTP] Digest uri mismatch");
+		return false;
+	}
+
+	String qop = params.get("qop");
+	if(qop && qop != "auth") {
+		return false;
+	}
+
+	String expected = HttpDigest::calculateResponse(ha1, params.get("nonce"), params.get("nc"), params.get("cnonce"),
+													qop, request.method, uri);
+	if(params.get("response") != expected) {
+		return false;
+	}
+
+	// Credentials are good, but must be using a current nonce
+	if(params.get("nonce") != getNonce()) {
+		stale = true;
+		return false;
+	}
+
+	return true;
+}
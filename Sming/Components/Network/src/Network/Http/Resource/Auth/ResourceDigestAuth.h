@@ -0,0 +1,50 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * ResourceDigestAuth.h
+ *
+ ****/
+
+#pragma once
+
+#include "../HttpResourcePlugin.h"
+
+/**
+ * @brief HTTP Digest authentication filter, as described in RFC 7616
+ *
+ * HA1 is calculated once on construction so the password isn't retained.
+ * A single server nonce is issued to all clients and may be re-used for any number
+ * of requests until it expires. Clients which cache the challenge therefore need
+ * only one round trip per request. An expired nonce is reported as `stale` so clients
+ * can retry transparently.
+ *
+ * Nonce counts are not tracked, so protection against replay is limited to the nonce lifetime.
+ */
+class ResourceDigestAuth : public HttpPreFilter
+{
+public:
+	/**
+	 * @param realm
+	 * @param username
+	 * @param password
+	 * @param nonceLifetime Time in seconds after which a new nonce is issued
+	 */
+	ResourceDigestAuth(const String& realm, const String& username, const String& password,
+					   unsigned nonceLifetime = 300);
+
+	bool headersComplete(HttpServerConnection& connection, HttpRequest& request, HttpResponse& response) override;
+
+private:
+	const String& getNonce();
+	bool checkAuthorization(const HttpRequest& request, bool& stale);
+
+	String realm;
+	String username;
+	String ha1;
+	String nonce;
+	uint32_t nonceTime{0}; ///< millis() when nonce was created
+	unsigned nonceLifetime;
+};
@@ -12,4 +12,5 @@
 #pragma once
 
 #include "Auth/ResourceBasicAuth.h"
+#include "Auth/ResourceDigestAuth.h"
 #include "Auth/ResourceIpAuth.h"
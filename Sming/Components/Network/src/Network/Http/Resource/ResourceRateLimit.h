@@ -0,0 +1,56 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * ResourceRateLimit.h
+ *
+ ****/
+
+#pragma once
+
+#include "HttpResourcePlugin.h"
+#include "../HttpServerConnection.h"
+#include <Network/RateLimiter.h>
+
+/**
+ * @brief Refuse requests from clients exceeding a rate limit
+ *
+ * Runs as soon as the request URL has been received, before the headers or body are parsed.
+ * Refused requests get `429 Too Many Requests` with a `Retry-After` header.
+ *
+ * The limiter is not owned by the plugin so may be shared between resources, giving each client
+ * one allowance for all of them:
+ *
+ * @code
+ * Network::RateLimiter limiter(10, 1000); // Bursts of 10 requests, then one per second
+ *
+ * server.paths.set("/", onIndex, new ResourceRateLimit(limiter));
+ * server.paths.set("/api", onApi, new ResourceRateLimit(limiter));
+ * @endcode
+ */
+class ResourceRateLimit : public HttpPreFilter
+{
+public:
+	ResourceRateLimit(Network::RateLimiter& limiter) : limiter(limiter)
+	{
+	}
+
+	bool urlComplete(HttpServerConnection& connection, HttpRequest& request, HttpResponse& response) override
+	{
+		auto remoteIp = connection.getRemoteIp();
+		if(limiter.allow(remoteIp)) {
+			return true;
+		}
+
+		debug_w("[HTTP] Rate limit exceeded by %s", remoteIp.toString().c_str());
+		response.code = HTTP_STATUS_TOO_MANY_REQUESTS;
+		auto seconds = (limiter.getRetryTime(remoteIp) + 999) / 1000;
+		response.headers[HTTP_HEADER_RETRY_AFTER] = String(std::max(seconds, uint32_t(1)));
+		return false;
+	}
+
+private:
+	Network::RateLimiter& limiter;
+};
@@ -14,6 +14,8 @@
 #include <Data/Stream/MemoryDataStream.h>
 #include <Data/Stream/XorOutputStream.h>
 #include <Data/Stream/SharedMemoryStream.h>
+#include <Data/Stream/DeflateOutputStream.h>
+#include <uzlib.h>
 
 DEFINE_FSTR(WSSTR_CONNECTION, "connection")
 DEFINE_FSTR(WSSTR_UPGRADE, "upgrade")
@@ -24,6 +26,66 @@ DEFINE_FSTR(WSSTR_KEY, "Sec-WebSocket-Key")
 DEFINE_FSTR(WSSTR_PROTOCOL, "Sec-WebSocket-Protocol")
 DEFINE_FSTR(WSSTR_VERSION, "Sec-WebSocket-Version")
 DEFINE_FSTR(WSSTR_SECRET, "258EAFA5-E914-47DA-95CA-C5AB0DC85B11")
+DEFINE_FSTR(WSSTR_PERMESSAGE_DEFLATE, "permessage-deflate")
+
+namespace
+{
+// RSV1 bit in first header byte indicates message is compressed
+constexpr uint8_t WS_RSV1{0x40};
+
+DEFINE_FSTR_LOCAL(WSSTR_DEFLATE_PARAMS, "permessage-deflate; server_no_context_takeover; client_no_context_takeover")
+
+/*
+ * Decompress a permessage-deflate message in-place, returns false on error
+ */
+bool inflateMessage(String& message)
+{
+	// Restore the sync marker removed by the sender (RFC 7692 7.2.2), then terminate with an empty final block
+	if(!message.concat("\x00\x00\xff\xff\x03\x00", 6)) {
+		return false;
+	}
+
+	uzlib_uncomp d;
+	uzlib_uncompress_init(&d, nullptr, 0);
+	d.source = reinterpret_cast<const uint8_t*>(message.c_str());
+	d.source_limit = d.source + message.length();
+	d.source_read_cb = nullptr;
+
+	// Whole message is decompressed into one buffer as it serves as the dictionary
+	String output;
+	size_t capacity = std::min(size_t(message.length() * 4), size_t(WEBSOCKET_INFLATE_MAX_SIZE));
+	size_t used = 0;
+	for(;;) {
+		if(!output.setLength(capacity)) {
+			return false;
+		}
+		d.dest_start = reinterpret_cast<uint8_t*>(output.begin());
+		d.dest = d.dest_start + used;
+		d.dest_limit = d.dest_start + capacity;
+
+		int res = uzlib_uncompress(&d);
+		used = d.dest - d.dest_start;
+		if(res == TINF_DONE) {
+			break;
+		}
+		if(res != TINF_OK) {
+			debug_w("WS: Inflate error %d", res);
+			return false;
+		}
+		// Output buffer is full
+		if(capacity >= WEBSOCKET_INFLATE_MAX_SIZE) {
+			debug_w("WS: Inflated message too large");
+			return false;
+		}
+		capacity = std::min(capacity * 2, size_t(WEBSOCKET_INFLATE_MAX_SIZE));
+	}
+
+	output.setLength(used);
+	message = std::move(output);
+	return true;
+}
+
+} // namespace
 
 WebsocketList WebsocketConnection::websocketList;
 
@@ -81,6 +143,11 @@ bool WebsocketConnection::bind(HttpRequest& request, HttpResponse& response)
 	response.headers[HTTP_HEADER_UPGRADE] = WSSTR_WEBSOCKET;
 	response.headers[HTTP_HEADER_SEC_WEBSOCKET_ACCEPT] = base64_encode(hash.data(), hash.size());
 
+	deflate = compressionEnabled && hasDeflateExtension(request.headers[HTTP_HEADER_SEC_WEBSOCKET_EXTENSIONS]);
+	if(deflate) {
+		response.headers[HTTP_HEADER_SEC_WEBSOCKET_EXTENSIONS] = WSSTR_DEFLATE_PARAMS;
+	}
+
 	isClientConnection = false;
 
 	return true;
@@ -89,8 +156,8 @@ bool WebsocketConnection::bind(HttpRequest& request, HttpResponse& response)
 bool WebsocketConnection::onConnected()
 {
 	activate();
-	if(!websocketList.contains(this)) {
-		websocketList.addElement(this);
+	if(!isLinked()) {
+		websocketList.add(*this);
 	}
 
 	if(wsConnect) {
@@ -103,25 +170,116 @@ bool WebsocketConnection::onConnected()
 void WebsocketConnection::activate()
 {
 	activated = true;
+	// Frames are typically small and interactive
+	connection->setNoDelay(true);
+	connection->setQuickAck(true);
 	connection->setReceiveDelegate(TcpClientDataDelegate(&WebsocketConnection::processFrame, this));
+	connection->setReadyToSendDelegate(TcpClientEventDelegate(&WebsocketConnection::onReadyToSend, this));
+}
+
+void WebsocketConnection::offerExtensions(HttpHeaders& headers)
+{
+	if(compressionEnabled) {
+		headers[HTTP_HEADER_SEC_WEBSOCKET_EXTENSIONS] = WSSTR_DEFLATE_PARAMS;
+	}
+}
+
+void WebsocketConnection::acceptExtensions(const HttpHeaders& headers)
+{
+	deflate = compressionEnabled && hasDeflateExtension(headers[HTTP_HEADER_SEC_WEBSOCKET_EXTENSIONS]);
+}
+
+bool WebsocketConnection::hasDeflateExtension(const String& extensions)
+{
+	unsigned offset = 0;
+	while(offset < extensions.length()) {
+		int end = extensions.indexOf(',', offset);
+		if(end < 0) {
+			end = extensions.length();
+		}
+		String name = extensions.substring(offset, end);
+		offset = end + 1;
+
+		// Parameters are either those we require or window sizes, which ours will never exceed
+		int sep = name.indexOf(';');
+		if(sep >= 0) {
+			name.setLength(sep);
+		}
+		name.trim();
+		if(WSSTR_PERMESSAGE_DEFLATE.equalsIgnoreCase(name)) {
+			return true;
+		}
+	}
+
+	return false;
 }
 
 bool WebsocketConnection::processFrame(TcpClient& client, char* at, int size)
 {
-	int rc = ws_parser_execute(&parser, &parserSettings, this, at, size);
-	if(rc != WS_OK) {
-		debug_e("WebsocketResource error: %d %s\n", rc, ws_parser_error(rc));
-		return false;
+	while(size > 0) {
+		// Parser doesn't support extensions so process one frame at a time
+		size_t len = deflate ? scanFrame(at, size) : size;
+		int rc = ws_parser_execute(&parser, &parserSettings, this, at, len);
+		if(rc != WS_OK) {
+			debug_e("WebsocketResource error: %d %s\n", rc, ws_parser_error(rc));
+			return false;
+		}
+		at += len;
+		size -= len;
 	}
 
 	return true;
 }
 
+size_t WebsocketConnection::scanFrame(char* data, size_t size)
+{
+	auto& rx = rxFrame;
+	size_t pos = 0;
+	while(pos < size && rx.headerPos < rx.headerLength) {
+		uint8_t c = data[pos];
+		if(rx.headerPos == 0) {
+			// RSV1 is only valid on the first frame of a data message
+			uint8_t opcode = c & 0x0f;
+			rx.compressed = (c & WS_RSV1) && (opcode == WS_FRAME_TEXT || opcode == WS_FRAME_BINARY);
+			if(rx.compressed) {
+				data[pos] = c & ~WS_RSV1;
+			}
+		} else if(rx.headerPos == 1) {
+			uint8_t len = c & 0x7f;
+			rx.lengthBytes = (len == 127) ? 8 : (len == 126) ? 2 : 0;
+			rx.headerLength = 2 + rx.lengthBytes + ((c & 0x80) ? 4 : 0);
+			rx.remaining = (rx.lengthBytes == 0) ? len : 0;
+		} else if(rx.headerPos < 2 + rx.lengthBytes) {
+			rx.remaining = (rx.remaining << 8) | c;
+		}
+		++pos;
+		++rx.headerPos;
+	}
+
+	if(rx.headerPos < rx.headerLength) {
+		// Header incomplete
+		return pos;
+	}
+
+	auto count = std::min(uint64_t(size - pos), rx.remaining);
+	rx.remaining -= count;
+	pos += count;
+	if(rx.remaining == 0) {
+		// Ready for next frame
+		rx.headerPos = 0;
+		rx.headerLength = 2;
+	}
+
+	return pos;
+}
+
 int WebsocketConnection::staticOnDataBegin(void* userData, ws_frame_type_t type)
 {
 	GET_CONNECTION();
 
 	connection->frameType = type;
+	connection->rxCompressed = connection->rxFrame.compressed;
+	connection->rxMessage = nullptr;
 
 	debug_d("data_begin: %s\n", type == WS_FRAME_TEXT ? _F("text") : type == WS_FRAME_BINARY ? _F("binary") : "?");
 
@@ -132,15 +290,53 @@ int WebsocketConnection::staticOnDataPayload(void* userData, const char* at, siz
 {
 	GET_CONNECTION();
 
-	switch(connection->frameType) {
+	if(connection->rxCompressed) {
+		// Compressed messages must be received in full before they can be delivered
+		if(connection->rxMessage.length() + length > WEBSOCKET_INFLATE_MAX_SIZE) {
+			debug_w("WS: Compressed message too large");
+			return -1;
+		}
+		if(!connection->rxMessage.concat(at, length)) {
+			return -1;
+		}
+		return WS_OK;
+	}
+
+	connection->deliverMessage(const_cast<char*>(at), length);
+
+	return WS_OK;
+}
+
+int WebsocketConnection::staticOnDataEnd(void* userData)
+{
+	GET_CONNECTION();
+
+	if(!connection->rxCompressed) {
+		return WS_OK;
+	}
+
+	connection->rxCompressed = false;
+	String message = std::move(connection->rxMessage);
+	if(!inflateMessage(message)) {
+		return -1;
+	}
+
+	connection->deliverMessage(message.begin(), message.length());
+
+	return WS_OK;
+}
+
+void WebsocketConnection::deliverMessage(char* data, size_t length)
+{
+	switch(frameType) {
 	case WS_FRAME_TEXT:
-		if(connection->wsMessage) {
-			connection->wsMessage(*connection, String(at, length));
+		if(wsMessage) {
+			wsMessage(*this, String(data, length));
 		}
 		break;
 	case WS_FRAME_BINARY:
-		if(connection->wsBinary) {
-			connection->wsBinary(*connection, reinterpret_cast<uint8_t*>(const_cast<char*>(at)), length);
+		if(wsBinary) {
+			wsBinary(*this, reinterpret_cast<uint8_t*>(data), length);
 		}
 		break;
 	case WS_FRAME_CLOSE:
@@ -148,13 +344,6 @@ int WebsocketConnection::staticOnDataPayload(void* userData, const char* at, siz
 	case WS_FRAME_PONG:
 		break;
 	}
-
-	return WS_OK;
-}
-
-int WebsocketConnection::staticOnDataEnd(void* userData)
-{
-	return WS_OK;
 }
 
 int WebsocketConnection::staticOnControlBegin(void* userData, ws_frame_type_t type)
@@ -249,30 +438,29 @@ bool WebsocketConnection::send(IDataSourceStream* source, ws_frame_type_t type,
 
 	debug_d("WS: Sending %d bytes, type %d", available, type);
 
-	// Construct packet
-	uint8_t packet[16]{};
-	unsigned len = 0;
-	if(isFin) {
-		packet[len] |= _BV(7); // set Fin
+	// Complete messages can be discarded if the queue is full, fragments cannot
+	bool droppable = isFin && (type == WS_FRAME_TEXT || type == WS_FRAME_BINARY);
+
+	// Only unfragmented messages are compressed
+	bool compress = deflate && droppable && available >= WEBSOCKET_DEFLATE_MIN_SIZE;
+	if(compress) {
+		source = compressMessage(sourceRef.release());
+		if(source == nullptr) {
+			return false;
+		}
+		sourceRef.reset(source);
+		available = source->available();
 	}
-	packet[len++] |= type; // set opcode
-	if(useMask) {
-		packet[len] |= _BV(7); // set mask
+	auto frame = new OutgoingFrame(nullptr, 0, droppable);
+	if(frame == nullptr) {
+		return false;
 	}
-	// length
-	if(available <= 125) {
-		packet[len++] |= available;
-	} else if(available <= 0xffff) {
-		packet[len++] |= 126;
-		packet[len++] = available >> 8;
-		packet[len++] = available;
-	} else {
-		packet[len++] |= 127;
-		len += 4; // All 0
-		packet[len++] = available >> 24;
-		packet[len++] = available >> 16;
-		packet[len++] = available >> 8;
-		packet[len++] = available;
+
+	// Construct packet
+	auto packet = frame->header;
+	unsigned len = createFrameHeader(packet, available, type, useMask, isFin);
+	if(compress) {
+		packet[0] |= WS_RSV1;
 	}
 	if(useMask) {
 		uint8_t maskKey[4];
@@ -282,32 +470,219 @@ bool WebsocketConnection::send(IDataSourceStream* source, ws_frame_type_t type,
 
 		auto xorStream = new XorOutputStream(source, maskKey, sizeof(maskKey));
 		if(xorStream == nullptr) {
+			delete frame;
 			return false;
 		}
 		sourceRef.release();
 		sourceRef.reset(xorStream);
 	}
 
-	// send the header
-	if(!connection->send(reinterpret_cast<const char*>(packet), len)) {
-		return false;
+	frame->headerLength = len;
+	frame->length = len + available;
+	frame->stream = std::move(sourceRef);
+
+	// Control frames are never refused
+	bool isControl = (type & 0x08) != 0;
+	return queueFrame(frame, !isControl);
+}
+
+bool WebsocketConnection::queueFrame(OutgoingFrame* frame, bool limited)
+{
+	if(limited && highWaterMark != 0 && queuedBytes + frame->length > highWaterMark) {
+		if(queuePolicy == WsQueuePolicy::DropOldest && frame->droppable) {
+			auto it = txQueue.head();
+			while(it != nullptr && queuedBytes + frame->length > highWaterMark) {
+				auto next = it->getNext();
+				if(it->droppable) {
+					debug_d("WS: Dropping %u byte message", it->length);
+					queuedBytes -= it->length;
+					++droppedCount;
+					txQueue.remove(it);
+				}
+				it = next;
+			}
+		}
+
+		if(queuedBytes != 0 && queuedBytes + frame->length > highWaterMark) {
+			congested = true;
+			if(queuePolicy == WsQueuePolicy::DropOldest && frame->droppable) {
+				// Nothing older to drop so discard this one
+				++droppedCount;
+			} else {
+				debug_w("WS: Queue full, %u bytes pending", queuedBytes);
+			}
+			delete frame;
+			return false;
+		}
 	}
 
-	// Pass stream to connection
-	return connection->send(sourceRef.release());
+	txQueue.add(frame);
+	queuedBytes += frame->length;
+	sendQueued();
+	return true;
 }
 
-void WebsocketConnection::broadcast(const char* message, size_t length, ws_frame_type_t type)
+void WebsocketConnection::sendQueued()
 {
-	std::shared_ptr<char[]> data(new char[length]);
-	if(!data) {
+	if(connection == nullptr) {
 		return;
 	}
-	memcpy(data.get(), message, length);
 
-	for(auto skt : websocketList) {
-		auto stream = new SharedMemoryStream<const char[]>(data, length);
-		skt->send(stream, type);
+	/*
+	 * Frames are only passed on once previous ones have been written out, so they remain
+	 * in our queue (and can be dropped) whilst the connection is stalled.
+	 * Hand over enough to fill the TCP send buffer.
+	 */
+	if(!connection->isSending()) {
+		size_t budget = connection->getAvailableWriteSize();
+		size_t handed = 0;
+		OutgoingFrame* frame;
+		while((handed == 0 || handed < budget) && (frame = txQueue.pop()) != nullptr) {
+			queuedBytes -= frame->length;
+			handed += frame->length;
+			sendFrame(frame);
+		}
+	}
+
+	if(congested && queuedBytes <= highWaterMark / 2) {
+		congested = false;
+		if(wsWritable) {
+			wsWritable(*this);
+		}
+	}
+}
+
+void WebsocketConnection::sendFrame(OutgoingFrame* frame)
+{
+	if(frame->headerLength != 0) {
+		connection->send(reinterpret_cast<const char*>(frame->header), frame->headerLength);
+	}
+	connection->send(frame->stream.release());
+	delete frame;
+}
+
+void WebsocketConnection::onReadyToSend(TcpClient&, TcpConnectionEvent)
+{
+	sendQueued();
+}
+
+IDataSourceStream* WebsocketConnection::compressMessage(IDataSourceStream* source)
+{
+	DeflateOutputStream deflater(source, DeflateOutputStream::Format::Raw);
+	auto output = new MemoryDataStream;
+	if(output == nullptr) {
+		return nullptr;
+	}
+	output->copyFrom(&deflater);
+	if(!deflater.isFinished()) {
+		debug_e("WS: Compression failed");
+		delete output;
+		return nullptr;
+	}
+
+	/*
+	 * Append empty stored block (`00 00 00 ff ff`) and remove the last four octets (RFC 7692 7.2.1).
+	 * This is required because the deflate stream ends with a final block rather than a sync flush.
+	 */
+	output->write(uint8_t(0));
+	return output;
+}
+
+unsigned WebsocketConnection::createFrameHeader(uint8_t* packet, size_t length, ws_frame_type_t type, bool useMask,
+											   bool isFin)
+{
+	unsigned len = 0;
+	// Fin and opcode
+	packet[len++] = (isFin ? _BV(7) : 0) | type;
+	// Mask flag
+	packet[len] = useMask ? _BV(7) : 0;
+	// length
+	if(length <= 125) {
+		packet[len++] |= length;
+	} else if(length <= 0xffff) {
+		packet[len++] |= 126;
+		packet[len++] = length >> 8;
+		packet[len++] = length;
+	} else {
+		packet[len++] |= 127;
+		memset(&packet[len], 0, 4);
+		len += 4;
+		packet[len++] = length >> 24;
+		packet[len++] = length >> 16;
+		packet[len++] = length >> 8;
+		packet[len++] = length;
+	}
+	return len;
+}
+
+void WebsocketConnection::broadcast(const char* message, size_t length, ws_frame_type_t type)
+{
+	/*
+	 * Server frames are unmasked so are identical for every connection.
+	 * Build each complete frame once and share it.
+	 * Connections using permessage-deflate get a compressed version.
+	 */
+	struct SharedFrame {
+		std::shared_ptr<char[]> data;
+		size_t length;
+	};
+	SharedFrame frames[2]{};
+
+	bool isData = (type == WS_FRAME_TEXT || type == WS_FRAME_BINARY);
+	bool canCompress = isData && length >= WEBSOCKET_DEFLATE_MIN_SIZE;
+
+	auto makeFrame = [&](SharedFrame& frame, bool compress) -> bool {
+		std::unique_ptr<IDataSourceStream> compressed;
+		const char* payload = message;
+		size_t payloadLength = length;
+		if(compress) {
+			auto mem = new MemoryDataStream;
+			if(mem == nullptr || mem->write(message, length) != length) {
+				delete mem;
+				return false;
+			}
+			compressed.reset(compressMessage(mem));
+			if(!compressed || compressed->peekRegion(payload) != size_t(compressed->available())) {
+				return false;
+			}
+			payloadLength = compressed->available();
+		}
+
+		uint8_t header[16];
+		unsigned headerLength = createFrameHeader(header, payloadLength, type, false, true);
+		if(compress) {
+			header[0] |= WS_RSV1;
+		}
+		frame.length = headerLength + payloadLength;
+		frame.data.reset(new char[frame.length]);
+		if(!frame.data) {
+			return false;
+		}
+		memcpy(frame.data.get(), header, headerLength);
+		memcpy(&frame.data[headerLength], payload, payloadLength);
+		return true;
+	};
+
+	for(auto& skt : websocketList) {
+		if(skt.isClientConnection) {
+			// Client frames must be individually masked
+			skt.send(message, length, type);
+			continue;
+		}
+
+		if(skt.connection == nullptr || !skt.activated) {
+			continue;
+		}
+
+		bool compress = canCompress && skt.deflate;
+		auto& frame = frames[compress];
+		if(!frame.data && !makeFrame(frame, compress)) {
+			debug_e("WS: Unable to create broadcast frame");
+			return;
+		}
+
+		auto stream = new SharedMemoryStream<const char[]>(frame.data, frame.length);
+		skt.queueFrame(new OutgoingFrame(stream, frame.length, isData), isData);
 	}
 }
 
@@ -318,7 +693,7 @@ void WebsocketConnection::close()
 	}
 
 	debug_d("WS: Terminating connection %p, state %u", connection, state);
-	websocketList.removeElement(this);
+	unlink();
 	if(state != eWSCS_Closed) {
 		state = eWSCS_Closed;
 		if(controlFrame.type == WS_FRAME_CLOSE) {
@@ -333,6 +708,15 @@ void WebsocketConnection::close()
 		}
 	}
 
+	// Pass on anything still queued
+	OutgoingFrame* frame;
+	while((frame = txQueue.pop()) != nullptr) {
+		sendFrame(frame);
+	}
+	queuedBytes = 0;
+	congested = false;
+
+	connection->setReadyToSendDelegate(nullptr);
 	connection->setTimeOut(2);
 	connection->setAutoSelfDestruct(true);
 	connection = nullptr;
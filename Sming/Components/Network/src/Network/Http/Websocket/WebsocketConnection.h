@@ -12,6 +12,8 @@
 
 #include "Network/TcpServer.h"
 #include "../HttpConnection.h"
+#include <Data/LinkedObjectList.h>
+#include <Data/IntrusiveList.h>
 
 extern "C" {
 #include "ws_parser/ws_parser.h"
@@ -25,6 +27,14 @@ extern "C" {
 
 #define WEBSOCKET_VERSION 13 // 1.3
 
+/**
+ * @brief Default limit on outgoing data queued per connection
+ * @note A value of 0 means no limit
+ */
+#ifndef WEBSOCKET_TX_HIGH_WATER
+#define WEBSOCKET_TX_HIGH_WATER 0
+#endif
+
 DECLARE_FSTR(WSSTR_CONNECTION)
 DECLARE_FSTR(WSSTR_UPGRADE)
 DECLARE_FSTR(WSSTR_WEBSOCKET)
@@ -34,10 +44,11 @@ DECLARE_FSTR(WSSTR_KEY)
 DECLARE_FSTR(WSSTR_PROTOCOL)
 DECLARE_FSTR(WSSTR_VERSION)
 DECLARE_FSTR(WSSTR_SECRET)
+DECLARE_FSTR(WSSTR_PERMESSAGE_DEFLATE)
 
 class WebsocketConnection;
 
-using WebsocketList = Vector<WebsocketConnection*>;
+using WebsocketList = IntrusiveList<WebsocketConnection>;
 
 using WebsocketDelegate = Delegate<void(WebsocketConnection&)>;
 using WebsocketMessageDelegate = Delegate<void(WebsocketConnection&, const String&)>;
@@ -52,13 +63,35 @@ enum WsConnectionState {
 	eWSCS_Closed,
 };
 
+/**
+ * @brief Messages smaller than this are sent uncompressed when permessage-deflate is in use
+ */
+#ifndef WEBSOCKET_DEFLATE_MIN_SIZE
+#define WEBSOCKET_DEFLATE_MIN_SIZE 64
+#endif
+
+/**
+ * @brief Largest compressed message which will be accepted, before and after decompression
+ */
+#ifndef WEBSOCKET_INFLATE_MAX_SIZE
+#define WEBSOCKET_INFLATE_MAX_SIZE 8192
+#endif
+
+/**
+ * @brief What to do when a message would take the outgoing queue past its high-water mark
+ */
+enum class WsQueuePolicy {
+	Reject,		///< send() fails
+	DropOldest, ///< Discard oldest unsent complete data messages to make room
+};
+
 struct WsFrameInfo {
 	ws_frame_type_t type = WS_FRAME_TEXT;
 	char* payload = nullptr;
 	size_t payloadLength = 0;
 };
 
-class WebsocketConnection
+class WebsocketConnection : public IntrusiveListHook<>
 {
 public:
 	/**
@@ -73,6 +106,62 @@ public:
 		close();
 	}
 
+	/**
+	 * @brief Allow use of the RFC 7692 permessage-deflate extension
+	 * @param enable
+	 * @note Must be called before the connection is established.
+	 * No compression context is kept between messages, to bound memory use.
+	 */
+	void setCompression(bool enable = true)
+	{
+		compressionEnabled = enable;
+	}
+
+	/**
+	 * @brief Determine if permessage-deflate has been negotiated for this connection
+	 */
+	bool isCompressed() const
+	{
+		return deflate;
+	}
+
+	/**
+	 * @brief Set limit for outgoing data queued on this connection
+	 * @param size Number of bytes, 0 for no limit
+	 * @param policy Action to take when limit would be exceeded
+	 * @note Once the limit has been reached the writable handler is called when
+	 * the queue has drained to half the limit.
+	 */
+	void setHighWaterMark(size_t size, WsQueuePolicy policy = WsQueuePolicy::Reject)
+	{
+		highWaterMark = size;
+		queuePolicy = policy;
+	}
+
+	/**
+	 * @brief Get number of outgoing bytes waiting to be passed to the TCP connection
+	 */
+	size_t getQueuedBytes() const
+	{
+		return queuedBytes;
+	}
+
+	/**
+	 * @brief Get total number of messages dropped due to queue limit
+	 */
+	unsigned getDroppedCount() const
+	{
+		return droppedCount;
+	}
+
+	/**
+	 * @brief Determine if outgoing queue is above its high-water mark
+	 */
+	bool isCongested() const
+	{
+		return congested;
+	}
+
 	/**
 	 * @brief Binds websocket connection to an http server connection
 	 * @param request
@@ -116,6 +205,7 @@ public:
 	 * @param message
 	 * @param length
 	 * @param type
+	 * @note A single copy of the framed message is shared by all server connections
 	 */
 	static void broadcast(const char* message, size_t length, ws_frame_type_t type = WS_FRAME_TEXT);
 
@@ -229,6 +319,16 @@ public:
 	{
 		wsPong = handler;
 	}
+	/**
+	 * @brief Sets the callback handler to be called when a congested connection has drained
+	 * @param handler
+	 * @see setHighWaterMark()
+	 */
+	void setWritableHandler(WebsocketDelegate handler)
+	{
+		wsWritable = handler;
+	}
+
 	/**
 	 * @brief Sets the callback handler to be called before closing a websocket connection
 	 * @param handler
@@ -291,20 +391,97 @@ protected:
 	 */
 	bool processFrame(TcpClient& client, char* at, int size);
 
+	/** @brief Build a frame header
+	 *  @param packet Buffer for header, must have room for 16 bytes
+	 *  @param length Size of payload
+	 *  @param type
+	 *  @param useMask Set the mask bit, caller must append the 4-byte key
+	 *  @param isFin
+	 *  @retval unsigned Length of header
+	 */
+	static unsigned createFrameHeader(uint8_t* packet, size_t length, ws_frame_type_t type, bool useMask, bool isFin);
+
+	/**
+	 * @brief Determine if a `Sec-WebSocket-Extensions` header value includes permessage-deflate
+	 */
+	static bool hasDeflateExtension(const String& extensions);
+
+	/**
+	 * @brief Add supported extensions to opening request (client)
+	 */
+	void offerExtensions(HttpHeaders& headers);
+
+	/**
+	 * @brief Check extensions accepted in opening response (client)
+	 */
+	void acceptExtensions(const HttpHeaders& headers);
+
+	/**
+	 * @brief Compress message for permessage-deflate
+	 * @param source Message content, will be destroyed
+	 * @retval IDataSourceStream* Compressed content, nullptr on error
+	 */
+	static IDataSourceStream* compressMessage(IDataSourceStream* source);
+
 protected:
 	WebsocketDelegate wsConnect = nullptr;
 	WebsocketMessageDelegate wsMessage = nullptr;
 	WebsocketBinaryDelegate wsBinary = nullptr;
 	WebsocketDelegate wsPong = nullptr;
 	WebsocketDelegate wsDisconnect = nullptr;
+	WebsocketDelegate wsWritable = nullptr;
 
 	void* userData = nullptr;
 
 	WsConnectionState state;
 
 private:
+	/**
+	 * @brief Outgoing frame waiting to be passed to the TCP connection
+	 */
+	class OutgoingFrame : public LinkedObjectTemplate<OutgoingFrame>
+	{
+	public:
+		OutgoingFrame(IDataSourceStream* stream, size_t length, bool droppable)
+			: stream(stream), length(length), droppable(droppable)
+		{
+		}
+
+		std::unique_ptr<IDataSourceStream> stream;
+		size_t length; ///< Total frame size including header
+		uint8_t header[16];
+		uint8_t headerLength{0};
+		bool droppable;
+	};
+
+	/**
+	 * @brief Track frame headers in incoming data to intercept the RSV1 (compressed) flag
+	 * @retval size_t Number of bytes, up to the end of the current frame
+	 */
+	size_t scanFrame(char* data, size_t size);
+
+	/**
+	 * @brief State of frame being received
+	 */
+	struct RxFrame {
+		uint64_t remaining;	///< Payload bytes still to come
+		uint8_t headerPos;	 ///< Header bytes seen so far
+		uint8_t headerLength; ///< Total header size, known after second byte
+		uint8_t lengthBytes;  ///< Size of extended length field
+		bool compressed;	  ///< RSV1 set in header
+	};
+
+	void deliverMessage(char* data, size_t length);
+	bool queueFrame(OutgoingFrame* frame, bool limited);
+	void sendFrame(OutgoingFrame* frame);
+	void sendQueued();
+	void onReadyToSend(TcpClient& client, TcpConnectionEvent sourceEvent);
+
 	ws_frame_type_t frameType = WS_FRAME_TEXT;
 	WsFrameInfo controlFrame;
+	RxFrame rxFrame{0, 0, 2};
+	String rxMessage;		   ///< Compressed message being received
+	bool rxCompressed = false; ///< Current message is compressed
 
 	ws_parser_t parser;
 	static const ws_parser_callbacks_t parserSettings;
@@ -312,8 +489,16 @@ private:
 	static WebsocketList websocketList;
 
 	HttpConnection* connection = nullptr;
+	OwnedLinkedObjectListTemplate<OutgoingFrame> txQueue;
+	size_t queuedBytes = 0;
+	size_t highWaterMark = WEBSOCKET_TX_HIGH_WATER;
+	unsigned droppedCount = 0;
+	WsQueuePolicy queuePolicy = WsQueuePolicy::Reject;
 	bool isClientConnection;
 	bool activated = false;
+	bool congested = false;
+	bool compressionEnabled = false;
+	bool deflate = false; ///< permessage-deflate has been negotiated
 };
 
 /** @} */
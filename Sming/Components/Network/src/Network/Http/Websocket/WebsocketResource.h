@@ -58,6 +58,15 @@ public:
 		wsDisconnect = handler;
 	}
 
+	/**
+	 * @brief Accept permessage-deflate for connections to this resource
+	 * @param enable Compression is only used if the client also offers it
+	 */
+	void setCompression(bool enable = true)
+	{
+		compression = enable;
+	}
+
 protected:
 	bool onConnect();
 
@@ -67,4 +76,5 @@ protected:
 	WebsocketBinaryDelegate wsBinary = nullptr;
 	WebsocketDelegate wsPong = nullptr;
 	WebsocketDelegate wsDisconnect = nullptr;
+	bool compression{false};
 };
@@ -14,36 +14,126 @@
 #include "Data/Stream/FileStream.h"
 
 HttpClient::HttpConnectionPool HttpClient::httpConnectionPool;
+HttpClient::SslSessionCache HttpClient::sslSessionCache;
 SimpleTimer HttpClient::cleanUpTimer;
 
 bool HttpClient::send(HttpRequest* request)
 {
 	String cacheKey = getCacheKey(request->uri);
 
-	HttpClientConnection* connection = nullptr;
+	HttpClientConnection* connection = getConnection(cacheKey);
+	if(connection == nullptr) {
+		debug_e("Cannot send request. No connection available");
+		delete request;
+		return false;
+	}
 
-	int i = httpConnectionPool.indexOf(cacheKey);
-	if(i >= 0) {
-		// Check existing connection
-		connection = httpConnectionPool.valueAt(i);
+	if(!cleanUpTimer.isStarted()) {
+		cleanUpTimer.initializeMs<10000>(HttpClient::cleanInactive).start();
 	}
+	return connection->send(request);
+}
 
+HttpClientConnection* HttpClient::getConnection(const String& cacheKey)
+{
+	// Connections to the same host are keyed "host:port", "host:port#1", etc.
+	HttpClientConnection* best = nullptr;
+	String freeKey;
+	for(unsigned n = 0; n < HTTP_CLIENT_MAX_HOST_CONNECTIONS; ++n) {
+		String key = cacheKey;
+		if(n != 0) {
+			key += '#';
+			key += n;
+		}
+		int i = httpConnectionPool.indexOf(key);
+		if(i < 0) {
+			if(!freeKey) {
+				freeKey = key;
+			}
+			continue;
+		}
+		auto connection = httpConnectionPool.valueAt(i);
+		saveSslSession(key, *connection);
+		if(best == nullptr || connection->getRequestCount() < best->getRequestCount()) {
+			best = connection;
+		}
+	}
+
+	if(best != nullptr && (best->isFinished() || !freeKey)) {
+		return best;
+	}
+
+	if(httpConnectionPool.count() >= HTTP_CLIENT_MAX_CONNECTIONS && !evictIdleConnection()) {
+		// Pool is full, share an existing connection if there is one
+		return best;
+	}
+
+	debug_d("Creating new HttpClientConnection");
+	auto connection = new HttpClientConnection();
 	if(connection == nullptr) {
-		debug_d("Creating new HttpClientConnection");
-		connection = new HttpClientConnection();
-		if(connection == nullptr) {
-			debug_e("Cannot send request. Out of memory");
-			// Out of memory
-			delete request;
-			return false;
+		// Out of memory
+		return best;
+	}
+	connection->setSslInitHandler([cacheKey](Ssl::Session& session) { initSslSession(cacheKey, session); });
+	httpConnectionPool[freeKey] = connection;
+	return connection;
+}
+
+bool HttpClient::evictIdleConnection()
+{
+	// Prefer closed connections, then longest idle
+	int lru = -1;
+	unsigned lruIdleTime = 0;
+	for(unsigned i = 0; i < httpConnectionPool.count(); ++i) {
+		auto connection = httpConnectionPool.valueAt(i);
+		if(!connection->isFinished()) {
+			continue;
+		}
+		unsigned idleTime = connection->isActive() ? connection->getIdleTime() : UINT16_MAX + 1;
+		if(lru < 0 || idleTime > lruIdleTime) {
+			lru = i;
+			lruIdleTime = idleTime;
 		}
-		httpConnectionPool[cacheKey] = connection;
 	}
 
-	if(!cleanUpTimer.isStarted()) {
-		cleanUpTimer.initializeMs<60000>(HttpClient::cleanInactive).start(); // run every minute
+	if(lru < 0) {
+		return false;
+	}
+
+	debug_d("Evicting connection '%s'", httpConnectionPool.keyAt(lru).c_str());
+	saveSslSession(httpConnectionPool.keyAt(lru), *httpConnectionPool.valueAt(lru));
+	httpConnectionPool.removeAt(lru);
+	return true;
+}
+
+void HttpClient::saveSslSession(const String& poolKey, HttpClientConnection& connection)
+{
+	auto ssl = connection.getSsl();
+	auto id = (ssl != nullptr) ? ssl->getSessionId() : nullptr;
+	if(id == nullptr || !id->isValid()) {
+		return;
+	}
+
+	String cacheKey = poolKey;
+	int i = cacheKey.indexOf('#');
+	if(i >= 0) {
+		cacheKey.setLength(i);
+	}
+
+	if(!sslSessionCache.contains(cacheKey) && sslSessionCache.count() >= HTTP_CLIENT_MAX_CONNECTIONS) {
+		// Drop the oldest entry
+		sslSessionCache.removeAt(0);
+	}
+	sslSessionCache[cacheKey] = *id;
+}
+
+void HttpClient::initSslSession(const String& cacheKey, Ssl::Session& session)
+{
+	session.options.sessionResume = true;
+	int i = sslSessionCache.indexOf(cacheKey);
+	if(i >= 0) {
+		session.setSessionId(sslSessionCache.valueAt(i));
 	}
-	return connection->send(request);
 }
 
 bool HttpClient::downloadFile(const Url& url, const String& saveFileName, RequestCompletedDelegate requestComplete)
@@ -60,8 +150,8 @@ bool HttpClient::downloadFile(const Url& url, const String& saveFileName, Reques
 		return false;
 	}
 
-	return send(
-		createRequest(url)->setResponseStream(fileStream)->setMethod(HTTP_GET)->onRequestComplete(requestComplete));
+	auto request = createRequest(url)->setResponseStream(fileStream)->setMethod(HTTP_GET)->setResumable();
+	return send(request->onRequestComplete(requestComplete));
 }
 
 void HttpClient::cleanInactive()
@@ -72,9 +162,12 @@ void HttpClient::cleanInactive()
 	while(i < httpConnectionPool.count()) {
 		auto connection = httpConnectionPool.valueAt(i);
 
-		if(connection->getConnectionState() > eTCS_Connecting && !connection->isActive()) {
-			debug_d("Removing stale connection: State: %d, Active: %d, Finished: %d", connection->getConnectionState(),
-					connection->isActive(), connection->isFinished());
+		bool stale = (connection->getConnectionState() > eTCS_Connecting && !connection->isActive());
+		bool expired = (connection->isFinished() && connection->getIdleTime() >= HTTP_CLIENT_IDLE_TIMEOUT);
+		if(stale || expired) {
+			debug_d("Removing %s connection: State: %d, Active: %d, Finished: %d", stale ? "stale" : "idle",
+					connection->getConnectionState(), connection->isActive(), connection->isFinished());
+			saveSslSession(httpConnectionPool.keyAt(i), *connection);
 			httpConnectionPool.removeAt(i);
 		} else {
 			++i;
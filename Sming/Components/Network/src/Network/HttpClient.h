@@ -24,6 +24,29 @@
 #include "Http/HttpClientConnection.h"
 #include "Data/Stream/LimitedMemoryStream.h"
 #include <SimpleTimer.h>
+#include <WHashMap.h>
+
+/**
+ * @brief Maximum number of pooled connections across all hosts
+ */
+#ifndef HTTP_CLIENT_MAX_CONNECTIONS
+#define HTTP_CLIENT_MAX_CONNECTIONS 4
+#endif
+
+/**
+ * @brief Maximum number of pooled connections to any one host
+ * @note Requests beyond this are queued on the least busy connection
+ */
+#ifndef HTTP_CLIENT_MAX_HOST_CONNECTIONS
+#define HTTP_CLIENT_MAX_HOST_CONNECTIONS 1
+#endif
+
+/**
+ * @brief Idle connections are released after this many TCP poll intervals (2 seconds each)
+ */
+#ifndef HTTP_CLIENT_IDLE_TIMEOUT
+#define HTTP_CLIENT_IDLE_TIMEOUT 30
+#endif
 
 class HttpClient
 {
@@ -96,6 +119,8 @@ public:
 	 * @param url Source of file data
 	 * @param saveFileName Path to save file to. Optional: specify nullptr to use name from url
 	 * @param requestComplete Completion callback
+	 * @note If the connection drops, the download continues from where it left off if the server permits.
+	 * See `HttpRequest::setResumable()`.
 	 */
 	bool downloadFile(const Url& url, const String& saveFileName, RequestCompletedDelegate requestComplete = nullptr);
 
@@ -126,6 +151,7 @@ public:
 	static void cleanup()
 	{
 		httpConnectionPool.clear();
+		sslSessionCache.clear();
 	}
 
 protected:
@@ -139,8 +165,16 @@ protected:
 	static HttpConnectionPool httpConnectionPool;
 
 private:
+	static HttpClientConnection* getConnection(const String& cacheKey);
+	static bool evictIdleConnection();
+	static void saveSslSession(const String& poolKey, HttpClientConnection& connection);
+	static void initSslSession(const String& cacheKey, Ssl::Session& session);
+
 	static SimpleTimer cleanUpTimer;
 	static void cleanInactive();
+
+	using SslSessionCache = HashMap<String, Ssl::SessionId>;
+	static SslSessionCache sslSessionCache; ///< Session IDs for resuming TLS connections, by cache key
 };
 
 /** @} */
@@ -0,0 +1,272 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * LwipStats.cpp
+ *
+ ****/
+
+#include "LwipStats.h"
+#include <lwip/init.h>
+#include <lwip/stats.h>
+#include <lwip/memp.h>
+#include <Services/Profiling/Metrics.h>
+#include <initializer_list>
+
+namespace Network::LwipStats
+{
+namespace
+{
+#if LWIP_STATS
+
+void copy(Protocol& dst, const stats_proto& src)
+{
+	dst.xmit = src.xmit;
+	dst.recv = src.recv;
+	dst.drop = src.drop;
+	dst.memerr = src.memerr;
+	dst.err = src.chkerr + src.lenerr + src.rterr + src.proterr + src.opterr + src.err;
+}
+
+void copy(Memory& dst, const stats_mem& src)
+{
+	dst.avail = src.avail;
+	dst.used = src.used;
+	dst.max = src.max;
+	dst.err = src.err;
+}
+
+#if MEMP_STATS
+void copyPool(Memory& dst, memp_t type)
+{
+#if LWIP_VERSION_MAJOR >= 2
+	// Pool statistics are referenced by pointer
+	if(lwip_stats.memp[type] != nullptr) {
+		copy(dst, *lwip_stats.memp[type]);
+	}
+#else
+	copy(dst, lwip_stats.memp[type]);
+#endif
+}
+#endif
+
+#endif // LWIP_STATS
+
+size_t printJson(Print& p, const Protocol& proto)
+{
+	size_t n = p.print(_F("{\"xmit\":"));
+	n += p.print(proto.xmit);
+	n += p.print(_F(",\"recv\":"));
+	n += p.print(proto.recv);
+	n += p.print(_F(",\"drop\":"));
+	n += p.print(proto.drop);
+	n += p.print(_F(",\"memerr\":"));
+	n += p.print(proto.memerr);
+	n += p.print(_F(",\"err\":"));
+	n += p.print(proto.err);
+	n += p.print('}');
+	return n;
+}
+
+size_t printJson(Print& p, const Memory& mem)
+{
+	size_t n = p.print(_F("{\"avail\":"));
+	n += p.print(mem.avail);
+	n += p.print(_F(",\"used\":"));
+	n += p.print(mem.used);
+	n += p.print(_F(",\"max\":"));
+	n += p.print(mem.max);
+	n += p.print(_F(",\"err\":"));
+	n += p.print(mem.err);
+	n += p.print('}');
+	return n;
+}
+
+template <typename T> size_t printJsonField(Print& p, const char* name, const T& value, bool first = false)
+{
+	size_t n = first ? 0 : p.print(',');
+	n += p.print('"');
+	n += p.print(name);
+	n += p.print(_F("\":"));
+	n += printJson(p, value);
+	return n;
+}
+
+} // namespace
+
+bool isAvailable()
+{
+	return LWIP_STATS != 0;
+}
+
+bool getSnapshot(Snapshot& snapshot)
+{
+	snapshot = Snapshot{};
+
+#if LWIP_STATS
+#if LINK_STATS
+	copy(snapshot.link, lwip_stats.link);
+#endif
+#if IP_STATS
+	copy(snapshot.ip, lwip_stats.ip);
+#endif
+#if TCP_STATS
+	copy(snapshot.tcp, lwip_stats.tcp);
+#endif
+#if UDP_STATS
+	copy(snapshot.udp, lwip_stats.udp);
+#endif
+#if MEM_STATS
+	copy(snapshot.heap, lwip_stats.mem);
+#endif
+#if MEMP_STATS
+	copyPool(snapshot.pbufPool, MEMP_PBUF_POOL);
+	copyPool(snapshot.tcpSeg, MEMP_TCP_SEG);
+	copyPool(snapshot.tcpPcb, MEMP_TCP_PCB);
+#endif
+	return true;
+#else
+	return false;
+#endif
+}
+
+size_t Snapshot::printTo(Print& p) const
+{
+	size_t n = p.print('{');
+	n += printJsonField(p, _F("link"), link, true);
+	n += printJsonField(p, _F("ip"), ip);
+	n += printJsonField(p, _F("tcp"), tcp);
+	n += printJsonField(p, _F("udp"), udp);
+	n += printJsonField(p, _F("heap"), heap);
+	n += printJsonField(p, _F("pbufPool"), pbufPool);
+	n += printJsonField(p, _F("tcpSeg"), tcpSeg);
+	n += printJsonField(p, _F("tcpPcb"), tcpPcb);
+	n += p.print('}');
+	return n;
+}
+
+#if defined(ENABLE_METRICS) && LWIP_STATS
+
+namespace
+{
+using namespace Profiling::Metrics;
+
+/*
+ * Output `name{label="value",...} sample`, labels given as name/value pairs
+ */
+size_t printSample(Print& p, const FlashString& name, std::initializer_list<const char*> labels, uint32_t value)
+{
+	size_t n = p.print(name);
+	char sep = '{';
+	for(auto it = labels.begin(); it != labels.end(); it += 2) {
+		n += p.print(sep);
+		n += p.print(it[0]);
+		n += p.print(_F("=\""));
+		n += p.print(it[1]);
+		n += p.print('"');
+		sep = ',';
+	}
+	n += p.print(_F("} "));
+	n += p.print(value);
+	n += p.print('\n');
+	return n;
+}
+
+/*
+ * Each metric reads a fresh snapshot when printed, so lwIP remains the only copy of the data
+ */
+class PacketMetric : public Metric
+{
+public:
+	using Metric::Metric;
+
+protected:
+	const char* getTypeName() const override
+	{
+		return "counter";
+	}
+
+	size_t printValue(Print& p) const override
+	{
+		Snapshot s;
+		getSnapshot(s);
+		const struct {
+			const char* proto;
+			const Protocol& value;
+		} layers[]{
+			{"link", s.link},
+			{"ip", s.ip},
+			{"tcp", s.tcp},
+			{"udp", s.udp},
+		};
+		size_t n{0};
+		for(auto& layer : layers) {
+			auto print = [&](const char* event, uint32_t value) {
+				n += printSample(p, getName(), {"proto", layer.proto, "event", event}, value);
+			};
+			print("xmit", layer.value.xmit);
+			print("recv", layer.value.recv);
+			print("drop", layer.value.drop);
+			print("memerr", layer.value.memerr);
+			print("err", layer.value.err);
+		}
+		return n;
+	}
+};
+
+class MemoryMetric : public Metric
+{
+public:
+	MemoryMetric(const FlashString& name, const FlashString& help, bool errors)
+		: Metric(name, help), errors(errors)
+	{
+	}
+
+protected:
+	const char* getTypeName() const override
+	{
+		return errors ? "counter" : "gauge";
+	}
+
+	size_t printValue(Print& p) const override
+	{
+		Snapshot s;
+		getSnapshot(s);
+		const struct {
+			const char* name;
+			const Memory& value;
+		} pools[]{
+			{"heap", s.heap},
+			{"pbuf_pool", s.pbufPool},
+			{"tcp_seg", s.tcpSeg},
+			{"tcp_pcb", s.tcpPcb},
+		};
+		size_t n{0};
+		for(auto& pool : pools) {
+			n += printSample(p, getName(), {"pool", pool.name}, errors ? pool.value.err : pool.value.used);
+		}
+		return n;
+	}
+
+private:
+	bool errors;
+};
+
+DEFINE_FSTR_LOCAL(packets_name, "sming_lwip_packets_total")
+DEFINE_FSTR_LOCAL(packets_help, "Packets handled by each lwIP protocol layer")
+DEFINE_FSTR_LOCAL(memoryUsed_name, "sming_lwip_memory_used")
+DEFINE_FSTR_LOCAL(memoryUsed_help, "Allocations currently held from lwIP memory pools")
+DEFINE_FSTR_LOCAL(memoryErrors_name, "sming_lwip_memory_errors_total")
+DEFINE_FSTR_LOCAL(memoryErrors_help, "Failed allocations from lwIP memory pools")
+
+PacketMetric packets(packets_name, packets_help);
+MemoryMetric memoryUsed(memoryUsed_name, memoryUsed_help, false);
+MemoryMetric memoryErrors(memoryErrors_name, memoryErrors_help, true);
+
+} // namespace
+
+#endif
+
+} // namespace Network::LwipStats
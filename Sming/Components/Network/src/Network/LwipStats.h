@@ -0,0 +1,76 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * LwipStats.h - Snapshot of lwIP statistics
+ *
+ * Counters are only maintained if the stack is built with LWIP_STATS=1.
+ * When metrics are enabled (ENABLE_METRICS=1) they are also published as
+ * `sming_lwip_*` metrics, so are served by HttpMetricsResource.
+ *
+ ****/
+
+#pragma once
+
+#include <Print.h>
+
+namespace Network::LwipStats
+{
+/**
+ * @brief Packet counters for one protocol layer
+ */
+struct Protocol {
+	uint32_t xmit;   ///< Packets transmitted
+	uint32_t recv;   ///< Packets received
+	uint32_t drop;   ///< Packets dropped
+	uint32_t memerr; ///< Failures to allocate memory
+	uint32_t err;	///< All other errors: checksum, length, routing, protocol, options or miscellaneous
+};
+
+/**
+ * @brief Usage of a memory pool or heap
+ */
+struct Memory {
+	uint32_t avail; ///< Capacity
+	uint32_t used;  ///< Currently allocated
+	uint32_t max;   ///< Highest allocation seen
+	uint32_t err;   ///< Failed allocations
+};
+
+/**
+ * @brief The statistics most useful for diagnosing throughput problems
+ *
+ * Link or TCP drops with no memory errors suggest losses on the network (e.g. poor Wi-Fi),
+ * whereas errors on `pbufPool` or `tcpSeg` indicate the stack has run out of buffers.
+ */
+struct Snapshot {
+	Protocol link;
+	Protocol ip;
+	Protocol tcp;
+	Protocol udp;
+	Memory heap;	 ///< lwIP heap, unused if stack allocates from system heap
+	Memory pbufPool; ///< Receive buffers
+	Memory tcpSeg;   ///< Queued TCP segments
+	Memory tcpPcb;   ///< Active TCP connections
+
+	/**
+	 * @brief Print as a JSON object
+	 */
+	size_t printTo(Print& p) const;
+};
+
+/**
+ * @brief Determine if the stack maintains statistics
+ */
+bool isAvailable();
+
+/**
+ * @brief Take a copy of the current statistics
+ * @retval bool false if not available, all values are zero
+ * @note Fields are also zero if the stack does not collect that category
+ */
+bool getSnapshot(Snapshot& snapshot);
+
+} // namespace Network::LwipStats
@@ -0,0 +1,199 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * MqttPartitionStore.cpp
+ *
+ ****/
+
+#include "MqttPartitionStore.h"
+#include <debug_progmem.h>
+#include <algorithm>
+#include <memory>
+
+namespace
+{
+constexpr uint32_t SLOT_MAGIC{0x5154514d}; // "MQTQ"
+constexpr uint32_t SLOT_REMOVED{0};
+constexpr uint8_t SLOT_RELEASED{0};
+
+} // namespace
+
+/*
+ * Written last so a partially written slot is never seen as valid.
+ * `magic` and `released` are updated in place by clearing bits.
+ */
+struct MqttPartitionStore::SlotHeader {
+	uint32_t magic;
+	uint32_t sequence;
+	uint16_t id;
+	uint16_t topicLength;
+	uint16_t contentLength;
+	uint8_t flags;
+	uint8_t released;
+};
+
+unsigned MqttPartitionStore::getSlotCount() const
+{
+	if(!partition) {
+		return 0;
+	}
+	return partition.size() / partition.getBlockSize();
+}
+
+int MqttPartitionStore::findSlot(uint16_t id, SlotHeader& header)
+{
+	auto slotSize = partition.getBlockSize();
+	auto slotCount = getSlotCount();
+	for(unsigned slot = 0; slot < slotCount; ++slot) {
+		if(!partition.read(slot * slotSize, &header, sizeof(header))) {
+			return -1;
+		}
+		if(header.magic == SLOT_MAGIC && header.id == id) {
+			return slot;
+		}
+	}
+	return -1;
+}
+
+bool MqttPartitionStore::load(LoadCallback callback)
+{
+	struct SlotInfo {
+		uint32_t sequence;
+		unsigned slot;
+	};
+
+	auto slotSize = partition.getBlockSize();
+	auto slotCount = getSlotCount();
+	if(slotCount == 0) {
+		debug_e("[MQTT] Invalid session partition");
+		return false;
+	}
+
+	std::unique_ptr<SlotInfo[]> slots(new SlotInfo[slotCount]);
+	if(!slots) {
+		return false;
+	}
+
+	unsigned count{0};
+	for(unsigned slot = 0; slot < slotCount; ++slot) {
+		SlotHeader header;
+		if(!partition.read(slot * slotSize, &header, sizeof(header))) {
+			return false;
+		}
+		if(header.magic == SLOT_MAGIC) {
+			slots[count++] = {header.sequence, slot};
+		}
+	}
+
+	// Messages must be re-sent in their original order
+	std::sort(&slots[0], &slots[count], [](const SlotInfo& a, const SlotInfo& b) { return a.sequence < b.sequence; });
+
+	nextSequence = 0;
+	nextSlot = 0;
+	for(unsigned i = 0; i < count; ++i) {
+		auto slot = slots[i].slot;
+		auto offset = slot * slotSize;
+		SlotHeader header;
+		if(!partition.read(offset, &header, sizeof(header))) {
+			return false;
+		}
+		size_t dataLength = header.topicLength + header.contentLength;
+		if(sizeof(header) + dataLength > slotSize) {
+			debug_w("[MQTT] Corrupt session slot #%u", slot);
+			continue;
+		}
+		std::unique_ptr<uint8_t[]> data(new uint8_t[dataLength]);
+		if(!data || !partition.read(offset + sizeof(header), data.get(), dataLength)) {
+			return false;
+		}
+
+		nextSequence = header.sequence + 1;
+		nextSlot = (slot + 1) % slotCount;
+
+		if(callback) {
+			Entry entry{
+				.id = header.id,
+				.flags = header.flags,
+				.released = (header.released == SLOT_RELEASED),
+				.topic = {header.topicLength, data.get()},
+				.content = {header.contentLength, data.get() + header.topicLength},
+			};
+			callback(entry);
+		}
+	}
+
+	debug_d("[MQTT] Loaded %u stored messages", count);
+	return true;
+}
+
+bool MqttPartitionStore::save(const Entry& entry)
+{
+	auto slotSize = partition.getBlockSize();
+	auto slotCount = getSlotCount();
+	if(sizeof(SlotHeader) + entry.topic.length + entry.content.length > slotSize) {
+		debug_w("[MQTT] Message too large to store");
+		return false;
+	}
+
+	// Start search after the most recently used slot to spread wear
+	for(unsigned i = 0; i < slotCount; ++i) {
+		auto slot = (nextSlot + i) % slotCount;
+		auto offset = slot * slotSize;
+		SlotHeader header;
+		if(!partition.read(offset, &header, sizeof(header))) {
+			return false;
+		}
+		if(header.magic == SLOT_MAGIC) {
+			continue;
+		}
+
+		header = SlotHeader{
+			.magic = SLOT_MAGIC,
+			.sequence = nextSequence,
+			.id = entry.id,
+			.topicLength = uint16_t(entry.topic.length),
+			.contentLength = uint16_t(entry.content.length),
+			.flags = entry.flags,
+			.released = entry.released ? SLOT_RELEASED : uint8_t(0xff),
+		};
+		offset += sizeof(header);
+		if(!partition.erase_range(slot * slotSize, slotSize) ||
+		   !partition.write(offset, entry.topic.data, entry.topic.length) ||
+		   !partition.write(offset + entry.topic.length, entry.content.data, entry.content.length) ||
+		   !partition.write(slot * slotSize, &header, sizeof(header))) {
+			return false;
+		}
+
+		++nextSequence;
+		nextSlot = (slot + 1) % slotCount;
+		return true;
+	}
+
+	debug_w("[MQTT] Session store full");
+	return false;
+}
+
+bool MqttPartitionStore::setReleased(uint16_t id)
+{
+	SlotHeader header;
+	int slot = findSlot(id, header);
+	if(slot < 0) {
+		return false;
+	}
+	auto offset = slot * partition.getBlockSize() + offsetof(SlotHeader, released);
+	return partition.write(offset, &SLOT_RELEASED, sizeof(SLOT_RELEASED));
+}
+
+bool MqttPartitionStore::remove(uint16_t id)
+{
+	SlotHeader header;
+	int slot = findSlot(id, header);
+	if(slot < 0) {
+		return false;
+	}
+	auto offset = slot * partition.getBlockSize() + offsetof(SlotHeader, magic);
+	return partition.write(offset, &SLOT_REMOVED, sizeof(SLOT_REMOVED));
+}
@@ -0,0 +1,56 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * MqttPartitionStore.h
+ *
+ ****/
+
+#pragma once
+
+#include "MqttSessionStore.h"
+#include <Storage/Partition.h>
+
+/**
+ * @brief Session store using a dedicated flash partition
+ *
+ * The partition is divided into slots, one per erase block, each holding a single message.
+ * A message larger than one slot cannot be stored.
+ *
+ * Saving a message erases its slot first. Marking a message as released or removed only clears
+ * bits, so the slot need not be erased again.
+ *
+ * @ingroup mqttclient
+ */
+class MqttPartitionStore : public MqttSessionStore
+{
+public:
+	MqttPartitionStore(Storage::Partition partition) : partition(partition)
+	{
+	}
+
+	bool load(LoadCallback callback) override;
+	bool save(const Entry& entry) override;
+	bool setReleased(uint16_t id) override;
+	bool remove(uint16_t id) override;
+
+	/**
+	 * @brief Erase all stored messages
+	 */
+	bool clear()
+	{
+		return partition.erase_range(0, partition.size());
+	}
+
+private:
+	struct SlotHeader;
+
+	unsigned getSlotCount() const;
+	int findSlot(uint16_t id, SlotHeader& header);
+
+	Storage::Partition partition;
+	uint32_t nextSequence{0};
+	unsigned nextSlot{0};
+};
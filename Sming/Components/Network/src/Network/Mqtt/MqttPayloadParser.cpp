@@ -45,3 +45,29 @@ int defaultPayloadParser(MqttPayloadParserState& state, mqtt_message_t* message,
 
 	return 0;
 }
+
+MqttPayloadParser streamPayloadParser(MqttPayloadStreamDelegate callback)
+{
+	return [callback](MqttPayloadParserState& state, mqtt_message_t* message, const char* buffer, int length) -> int {
+		if(!message) {
+			return -1; // invalid message
+		}
+
+		if(length == MQTT_PAYLOAD_PARSER_START) {
+			state.offset = 0;
+			return 0;
+		}
+
+		if(!callback) {
+			return 0;
+		}
+
+		if(length == MQTT_PAYLOAD_PARSER_END) {
+			return callback(*message, nullptr, 0, state.offset);
+		}
+
+		int res = callback(*message, buffer, length, state.offset);
+		state.offset += length;
+		return res;
+	};
+}
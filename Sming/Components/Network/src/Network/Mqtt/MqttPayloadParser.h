@@ -39,4 +39,23 @@ using MqttPayloadParser =
 
 int defaultPayloadParser(MqttPayloadParserState& state, mqtt_message_t* message, const char* buffer, int length);
 
+/**
+ * @brief Receives PUBLISH payload fragments as they arrive, without buffering the message
+ * @param message The incoming message. The topic name is valid, but content data is not allocated.
+ * @param data Payload fragment, or nullptr when the message is complete
+ * @param length Fragment length
+ * @param offset Position of the fragment within the payload. At completion, the total payload length.
+ * @retval int 0 on success, any other value aborts the connection
+ */
+using MqttPayloadStreamDelegate =
+	Delegate<int(const mqtt_message_t& message, const char* data, size_t length, size_t offset)>;
+
+/**
+ * @brief Create a payload parser which passes fragments to a streaming callback
+ *
+ * Use this with `MqttClient::subscribe()` to process large messages, such as configuration blobs,
+ * directly from network buffers.
+ */
+MqttPayloadParser streamPayloadParser(MqttPayloadStreamDelegate callback);
+
 /** @} */
@@ -0,0 +1,66 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * MqttSessionStore.h - Persistent storage for unacknowledged MQTT messages
+ *
+ ****/
+
+#pragma once
+
+#include <mqtt-codec/src/message.h>
+#include <Delegate.h>
+
+/**
+ * @brief Interface for storing QoS 1/2 messages until the broker acknowledges them
+ *
+ * Messages are saved when first queued for transmission and removed once the final acknowledgement
+ * (PUBACK or PUBCOMP) arrives. After a restart, the stored messages are loaded and re-sent.
+ *
+ * @ingroup mqttclient
+ */
+class MqttSessionStore
+{
+public:
+	struct Entry {
+		uint16_t id;		   ///< Message (packet) identifier
+		uint8_t flags;		   ///< Publish flags, as passed to `MqttClient::publish()`
+		bool released;		   ///< QoS 2: PUBREC received, only PUBREL/PUBCOMP outstanding
+		mqtt_buffer_t topic;   ///< Topic name
+		mqtt_buffer_t content; ///< Message payload
+	};
+
+	/**
+	 * @brief Callback invoked for each stored message, in the order they were saved
+	 * @note Buffers referred to by Entry are only valid for the duration of the call
+	 */
+	using LoadCallback = Delegate<void(const Entry& entry)>;
+
+	virtual ~MqttSessionStore()
+	{
+	}
+
+	/**
+	 * @brief Enumerate all stored messages
+	 * @retval bool false on storage error
+	 */
+	virtual bool load(LoadCallback callback) = 0;
+
+	/**
+	 * @brief Store a new message
+	 * @retval bool false if message could not be stored
+	 */
+	virtual bool save(const Entry& entry) = 0;
+
+	/**
+	 * @brief Record that PUBREC has been received for a message
+	 */
+	virtual bool setReleased(uint16_t id) = 0;
+
+	/**
+	 * @brief Discard a message which has been acknowledged
+	 */
+	virtual bool remove(uint16_t id) = 0;
+};
@@ -0,0 +1,237 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * MqttTopicTree.h - Match topics against subscription filters
+ *
+ ****/
+
+#pragma once
+
+#include <WString.h>
+#include <Data/LinkedObjectList.h>
+
+/**
+ * @brief Associates values with MQTT topic filters, which may contain `+` and `#` wildcards
+ *
+ * Filters are stored as a tree with one node per topic level. Matching a topic therefore
+ * takes time proportional to the number of levels, not the number of filters.
+ *
+ * @tparam T Type of value stored with each filter
+ * @ingroup mqttclient
+ */
+template <typename T> class MqttTopicTree
+{
+public:
+	/**
+	 * @brief Store a value for a topic filter, replacing any existing value
+	 * @param filter Topic filter, e.g. "home/+/temperature" or "home/#"
+	 * @param value
+	 * @retval bool false if filter is invalid or out of memory
+	 */
+	bool add(const String& filter, const T& value)
+	{
+		if(!isValidFilter(filter)) {
+			return false;
+		}
+
+		Node* node = &root;
+		const char* ptr = filter.c_str();
+		const char* end = ptr + filter.length();
+		for(;;) {
+			auto sep = static_cast<const char*>(memchr(ptr, '/', end - ptr));
+			auto levelEnd = sep ? sep : end;
+			auto child = node->find(ptr, levelEnd - ptr);
+			if(child == nullptr) {
+				child = new Node(ptr, levelEnd - ptr);
+				if(child == nullptr || child->name.length() != size_t(levelEnd - ptr)) {
+					delete child;
+					return false;
+				}
+				node->children.add(child);
+			}
+			node = child;
+			if(sep == nullptr) {
+				break;
+			}
+			ptr = sep + 1;
+		}
+
+		node->value = value;
+		node->isSet = true;
+		return true;
+	}
+
+	/**
+	 * @brief Remove a topic filter
+	 * @param filter Must be exactly as passed to `add()`
+	 * @retval bool true if filter was found
+	 */
+	bool remove(const String& filter)
+	{
+		return remove(root, filter.c_str(), filter.c_str() + filter.length());
+	}
+
+	/**
+	 * @brief Remove all filters
+	 */
+	void clear()
+	{
+		root.children.clear();
+	}
+
+	bool isEmpty() const
+	{
+		return root.children.isEmpty();
+	}
+
+	/**
+	 * @brief Find all filters which match a topic
+	 * @param topic Topic name, need not be NUL-terminated
+	 * @param length Length of topic name
+	 * @param callback Invoked as `callback(T& value)` for each match.
+	 * Exact levels are tried before `+`, and `+` before `#`.
+	 * @retval unsigned Number of matching filters
+	 *
+	 * As the MQTT specification requires, no wildcard matches a first topic level which starts with `$`.
+	 */
+	template <typename Callback> unsigned match(const char* topic, size_t length, Callback callback)
+	{
+		return match(root, topic, topic + length, true, callback);
+	}
+
+	template <typename Callback> unsigned match(const String& topic, Callback callback)
+	{
+		return match(topic.c_str(), topic.length(), callback);
+	}
+
+	/**
+	 * @brief Check a topic filter is well-formed
+	 *
+	 * A filter must not be empty. Any `+` must occupy a whole level, and any `#` must be the whole final level.
+	 */
+	static bool isValidFilter(const String& filter)
+	{
+		if(filter.length() == 0) {
+			return false;
+		}
+		const char* ptr = filter.c_str();
+		for(unsigned i = 0; i < filter.length(); ++i) {
+			char c = ptr[i];
+			if(c != '+' && c != '#') {
+				continue;
+			}
+			bool levelStart = (i == 0) || ptr[i - 1] == '/';
+			bool levelEnd = (i + 1 == filter.length()) || ptr[i + 1] == '/';
+			if(!levelStart || !levelEnd) {
+				return false;
+			}
+			if(c == '#' && i + 1 != filter.length()) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+private:
+	class Node : public LinkedObjectTemplate<Node>
+	{
+	public:
+		Node() = default;
+
+		Node(const char* name, size_t length) : name(name, length)
+		{
+		}
+
+		Node* find(const char* level, size_t length)
+		{
+			for(auto& child : children) {
+				if(child.name.length() == length && memcmp(child.name.c_str(), level, length) == 0) {
+					return &child;
+				}
+			}
+			return nullptr;
+		}
+
+		bool isUnused() const
+		{
+			return !isSet && children.isEmpty();
+		}
+
+		String name;
+		OwnedLinkedObjectListTemplate<Node> children;
+		T value{};
+		bool isSet{false};
+	};
+
+	bool remove(Node& node, const char* ptr, const char* end)
+	{
+		auto sep = static_cast<const char*>(memchr(ptr, '/', end - ptr));
+		auto levelEnd = sep ? sep : end;
+		auto child = node.find(ptr, levelEnd - ptr);
+		if(child == nullptr) {
+			return false;
+		}
+
+		bool found;
+		if(sep == nullptr) {
+			found = child->isSet;
+			child->isSet = false;
+			child->value = T{};
+		} else {
+			found = remove(*child, sep + 1, end);
+		}
+
+		// Prune branches which no longer lead to a filter
+		if(child->isUnused()) {
+			node.children.remove(child);
+		}
+
+		return found;
+	}
+
+	template <typename Callback>
+	unsigned match(Node& node, const char* ptr, const char* end, bool firstLevel, Callback& callback)
+	{
+		auto sep = static_cast<const char*>(memchr(ptr, '/', end - ptr));
+		auto levelEnd = sep ? sep : end;
+		bool wildcardAllowed = !(firstLevel && ptr < end && *ptr == '$');
+
+		unsigned count{0};
+		auto visit = [&](Node* child) {
+			if(child == nullptr) {
+				return;
+			}
+			if(sep != nullptr) {
+				count += match(*child, sep + 1, end, false, callback);
+				return;
+			}
+			if(child->isSet) {
+				callback(child->value);
+				++count;
+			}
+			// "a/#" also matches "a"
+			auto multi = child->find("#", 1);
+			if(multi != nullptr && multi->isSet) {
+				callback(multi->value);
+				++count;
+			}
+		};
+
+		visit(node.find(ptr, levelEnd - ptr));
+		if(wildcardAllowed) {
+			visit(node.find("+", 1));
+			auto multi = node.find("#", 1);
+			if(multi != nullptr && multi->isSet) {
+				callback(multi->value);
+				++count;
+			}
+		}
+
+		return count;
+	}
+
+	Node root;
+};
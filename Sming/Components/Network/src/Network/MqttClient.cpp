@@ -11,6 +11,7 @@
 #include "MqttClient.h"
 
 #include "Data/Stream/DataSourceStream.h"
+#include "Data/ObjectPool.h"
 
 const mqtt_parser_callbacks_t MqttClient::callbacks PROGMEM = {
 	.on_message_begin = staticOnMessageBegin,
@@ -33,9 +34,17 @@ constexpr uint8_t MQTT_CONNECT_PROTOCOL{4}; // version 3.1.1
 		return -1;                                                                                                     \
 	}
 
+#if MQTT_MESSAGE_POOL_SIZE
+ObjectPool<mqtt_message_t, MQTT_MESSAGE_POOL_SIZE> messagePool;
+#endif
+
 mqtt_message_t* createMessage(mqtt_type_t messageType)
 {
+#if MQTT_MESSAGE_POOL_SIZE
+	auto message = messagePool.create();
+#else
 	auto message = new mqtt_message_t;
+#endif
 	if(message != nullptr) {
 		mqtt_message_init(message);
 		message->common.type = messageType;
@@ -45,8 +54,15 @@ mqtt_message_t* createMessage(mqtt_type_t messageType)
 
 void deleteMessage(mqtt_message_t* message)
 {
+	if(message == nullptr) {
+		return;
+	}
 	mqtt_message_clear(message, 0);
+#if MQTT_MESSAGE_POOL_SIZE
+	messagePool.destroy(message);
+#else
 	delete message;
+#endif
 }
 
 void clearMessage(mqtt_message_t& message)
@@ -54,21 +70,36 @@ void clearMessage(mqtt_message_t& message)
 	mqtt_message_clear(&message, 0);
 }
 
-bool copyString(mqtt_buffer_t& destBuffer, const String& sourceString)
+bool copyBuffer(mqtt_buffer_t& destBuffer, const void* data, size_t length)
 {
-	destBuffer.length = sourceString.length();
+	destBuffer.length = length;
 	MQTT_FREE(destBuffer.data); // Avoid memory leaks
-	destBuffer.data = (uint8_t*)MQTT_MALLOC(sourceString.length());
+	if(length == 0) {
+		// Empty content must not be mistaken for a stream
+		destBuffer.data = nullptr;
+		return true;
+	}
+	destBuffer.data = (uint8_t*)MQTT_MALLOC(length);
 	if(destBuffer.data == nullptr) {
 		debug_e("Not enough memory");
 		return false;
 	}
-	memcpy(destBuffer.data, sourceString.c_str(), sourceString.length());
+	memcpy(destBuffer.data, data, length);
 	return true;
 }
 
+bool copyString(mqtt_buffer_t& destBuffer, const String& sourceString)
+{
+	return copyBuffer(destBuffer, sourceString.c_str(), sourceString.length());
+}
+
 } // namespace
 
+MqttClient::InflightMessage::~InflightMessage()
+{
+	deleteMessage(message);
+}
+
 MqttClient::MqttClient(bool withDefaultPayloadParser, bool autoDestruct)
 	: TcpClient(autoDestruct), pingTimer(pingRepeatTime)
 {
@@ -86,6 +117,20 @@ MqttClient::MqttClient(bool withDefaultPayloadParser, bool autoDestruct)
 	}
 
 	TcpClient::setReceiveDelegate(TcpClientDataDelegate(&MqttClient::onTcpReceive, this));
+
+	// Control packets are small, so avoid delays from Nagle's algorithm and delayed ACKs
+	setNoDelay(true);
+	setQuickAck(true);
+
+	flushTimer.initializeMs<1>([](void* arg) { static_cast<MqttClient*>(arg)->commit(); }, this);
+}
+
+void MqttClient::scheduleFlush()
+{
+	// Defer sending so further messages queued by the caller can be coalesced
+	if(!flushTimer.isStarted()) {
+		flushTimer.startOnce();
+	}
 }
 
 MqttClient::~MqttClient()
@@ -93,9 +138,12 @@ MqttClient::~MqttClient()
 	while(requestQueue.count() != 0) {
 		deleteMessage(requestQueue.dequeue());
 	}
+	while(responseQueue.count() != 0) {
+		deleteMessage(responseQueue.dequeue());
+	}
 
 	clearMessage(connectMessage);
-	if(outgoingMessage != &connectMessage) {
+	if(outgoingOwned) {
 		deleteMessage(outgoingMessage);
 	}
 	outgoingMessage = nullptr;
@@ -124,9 +172,23 @@ int MqttClient::staticOnDataBegin(void* userData, mqtt_message_t* message)
 {
 	GET_CLIENT();
 
-	if(client->payloadParser) {
+	client->activePayloadParser = client->payloadParser;
+	if(message->common.type == MQTT_TYPE_PUBLISH && !client->subscriptions.isEmpty()) {
+		// Exact matches are visited first, so the first parser found is the most specific
+		bool found{false};
+		auto findParser = [&](Subscription& sub) {
+			if(!found && sub.payloadParser) {
+				client->activePayloadParser = sub.payloadParser;
+				found = true;
+			}
+		};
+		auto& topic = message->publish.topic_name;
+		client->subscriptions.match(reinterpret_cast<const char*>(topic.data), topic.length, findParser);
+	}
+
+	if(client->activePayloadParser) {
 		client->payloadState.offset = 0;
-		return client->payloadParser(client->payloadState, message, nullptr, MQTT_PAYLOAD_PARSER_START);
+		return client->activePayloadParser(client->payloadState, message, nullptr, MQTT_PAYLOAD_PARSER_START);
 	}
 
 	return 0;
@@ -136,8 +198,8 @@ int MqttClient::staticOnDataPayload(void* userData, mqtt_message_t* message, con
 {
 	GET_CLIENT();
 
-	if(client->payloadParser) {
-		return client->payloadParser(client->payloadState, message, data, length);
+	if(client->activePayloadParser) {
+		return client->activePayloadParser(client->payloadState, message, data, length);
 	}
 
 	return 0;
@@ -147,8 +209,8 @@ int MqttClient::staticOnDataEnd(void* userData, mqtt_message_t* message)
 {
 	GET_CLIENT();
 
-	if(client->payloadParser) {
-		return client->payloadParser(client->payloadState, message, nullptr, MQTT_PAYLOAD_PARSER_END);
+	if(client->activePayloadParser) {
+		return client->activePayloadParser(client->payloadState, message, nullptr, MQTT_PAYLOAD_PARSER_END);
 	}
 
 	return 0;
@@ -174,6 +236,24 @@ int MqttClient::onMessageEnd(mqtt_message_t* message)
 		}
 	}
 
+	acknowledge(message);
+
+	if(message->common.type == MQTT_TYPE_PUBLISH && !subscriptions.isEmpty()) {
+		int result{0};
+		auto dispatch = [&](Subscription& sub) {
+			if(sub.handler) {
+				int res = sub.handler(*this, message);
+				if(res != 0) {
+					result = res;
+				}
+			}
+		};
+		auto& topic = message->publish.topic_name;
+		if(subscriptions.match(reinterpret_cast<const char*>(topic.data), topic.length, dispatch) != 0) {
+			return result;
+		}
+	}
+
 	auto& handler = static_cast<const HandlerMap&>(eventHandlers)[message->common.type];
 	if(handler) {
 		return handler(*this, message);
@@ -182,6 +262,133 @@ int MqttClient::onMessageEnd(mqtt_message_t* message)
 	return 0;
 }
 
+void MqttClient::acknowledge(const mqtt_message_t* message)
+{
+	switch(message->common.type) {
+	case MQTT_TYPE_PUBLISH:
+		if(message->common.qos == MQTT_QOS_AT_LEAST_ONCE) {
+			queueResponse(MQTT_TYPE_PUBACK, message->publish.message_id);
+		} else if(message->common.qos == MQTT_QOS_EXACTLY_ONCE) {
+			queueResponse(MQTT_TYPE_PUBREC, message->publish.message_id);
+		}
+		break;
+
+	case MQTT_TYPE_PUBREL:
+		queueResponse(MQTT_TYPE_PUBCOMP, message->pubrel.message_id);
+		break;
+
+	case MQTT_TYPE_PUBACK:
+		completeInflight(message->puback.message_id);
+		break;
+
+	case MQTT_TYPE_PUBREC: {
+		auto msg = findInflight(message->pubrec.message_id);
+		if(msg == nullptr) {
+			break;
+		}
+		if(!msg->released) {
+			msg->released = true;
+			if(sessionStore != nullptr) {
+				sessionStore->setReleased(message->pubrec.message_id);
+			}
+		}
+		// Send PUBREL, and again for any duplicate PUBREC
+		msg->pending = true;
+		break;
+	}
+
+	case MQTT_TYPE_PUBCOMP:
+		completeInflight(message->pubcomp.message_id);
+		break;
+
+	default:
+		break;
+	}
+}
+
+bool MqttClient::queueResponse(mqtt_type_t type, uint16_t id)
+{
+	if(responseQueue.full()) {
+		debug_w("[MQTT] Response queue full");
+		return false;
+	}
+
+	auto message = createMessage(type);
+	if(message == nullptr) {
+		return false;
+	}
+	// All acknowledgement types share the same layout
+	message->puback.message_id = id;
+	if(type == MQTT_TYPE_PUBREL) {
+		message->common.qos = MQTT_QOS_AT_LEAST_ONCE;
+	}
+
+	return responseQueue.enqueue(message);
+}
+
+MqttClient::InflightMessage* MqttClient::findInflight(uint16_t id)
+{
+	auto it = std::find_if(inflight.begin(), inflight.end(),
+						   [id](const InflightMessage& msg) { return msg.message->publish.message_id == id; });
+	return it == inflight.end() ? nullptr : &*it;
+}
+
+void MqttClient::completeInflight(uint16_t id)
+{
+	auto msg = findInflight(id);
+	if(msg == nullptr) {
+		debug_w("[MQTT] Unexpected acknowledgement for message #%u", id);
+		return;
+	}
+
+	if(outgoingMessage == msg->message) {
+		outgoingMessage = nullptr;
+	}
+	if(sessionStore != nullptr) {
+		sessionStore->remove(id);
+	}
+	inflight.remove(msg);
+}
+
+uint16_t MqttClient::getNextMessageId()
+{
+	do {
+		++lastMessageId;
+	} while(lastMessageId == 0 || findInflight(lastMessageId) != nullptr);
+	return lastMessageId;
+}
+
+bool MqttClient::setSessionStore(MqttSessionStore* store)
+{
+	sessionStore = store;
+	if(store == nullptr) {
+		return true;
+	}
+
+	return store->load([this](const MqttSessionStore::Entry& entry) {
+		if(findInflight(entry.id) != nullptr) {
+			return;
+		}
+
+		auto message = createMessage(MQTT_TYPE_PUBLISH);
+		if(message == nullptr) {
+			return;
+		}
+		message->common.retain = static_cast<mqtt_retain_t>((entry.flags >> 0) & 0x01);
+		message->common.qos = static_cast<mqtt_qos_t>((entry.flags >> 1) & 0x03);
+		message->publish.message_id = entry.id;
+		if(!copyBuffer(message->publish.topic_name, entry.topic.data, entry.topic.length) ||
+		   !copyBuffer(message->publish.content, entry.content.data, entry.content.length)) {
+			deleteMessage(message);
+			return;
+		}
+
+		auto msg = new InflightMessage(message);
+		msg->released = entry.released;
+		inflight.add(msg);
+	});
+}
+
 bool MqttClient::setWill(const String& topic, const String& message, uint8_t flags)
 {
 	if(bitsSet(this->flags, MQTT_CLIENT_CONNECTED)) {
@@ -239,6 +446,19 @@ bool MqttClient::connect(const Url& url, const String& clientName)
 	}
 	connectQueued = true;
 
+	// Unacknowledged messages are re-sent once reconnected
+	auto msg = inflight.head();
+	while(msg != nullptr) {
+		auto next = msg->getNext();
+		if(msg->resendable || msg->released) {
+			msg->pending = true;
+		} else {
+			debug_w("[MQTT] Dropping unacknowledged stream message #%u", msg->message->publish.message_id);
+			inflight.remove(msg);
+		}
+		msg = next;
+	}
+
 	return TcpClient::connect(url.Host, url.getPort(), useSsl);
 }
 
@@ -255,15 +475,13 @@ bool MqttClient::publish(const String& topic, const String& content, uint8_t fla
 	message->common.dup = static_cast<mqtt_dup_t>((flags >> 3) & 0x01);
 
 	if(!copyString(message->publish.topic_name, topic) || !copyString(message->publish.content, content)) {
-		delete message;
+		deleteMessage(message);
 		return false;
 	}
 
 	bool success = requestQueue.enqueue(message);
 	if(success) {
-		// Try to force-send message to decrease latency.
-		// Should work for small size messages but there is no guarantee.
-		commit();
+		scheduleFlush();
 	}
 
 	return success;
@@ -287,7 +505,7 @@ bool MqttClient::publish(const String& topic, IDataSourceStream* stream, uint8_t
 	message->common.dup = static_cast<mqtt_dup_t>((flags >> 3) & 0x01);
 
 	if(!copyString(message->publish.topic_name, topic)) {
-		delete message;
+		deleteMessage(message);
 		delete stream;
 		return false;
 	}
@@ -297,9 +515,7 @@ bool MqttClient::publish(const String& topic, IDataSourceStream* stream, uint8_t
 
 	bool success = requestQueue.enqueue(message);
 	if(success) {
-		// Try to force-send message to decrease latency.
-		// Should work for small size messages but there is no guarantee.
-		commit();
+		scheduleFlush();
 	}
 
 	return success;
@@ -318,17 +534,30 @@ bool MqttClient::subscribe(const String& topic)
 	message->subscribe.topics = (mqtt_topicpair_t*)MQTT_MALLOC(sizeof(mqtt_topicpair_t));
 	memset(message->subscribe.topics, 0, sizeof(mqtt_topicpair_t));
 	if(!copyString(message->subscribe.topics->name, topic)) {
-		delete message;
+		deleteMessage(message);
 		return false;
 	}
+	message->subscribe.message_id = getNextMessageId();
 
 	return requestQueue.enqueue(message);
 }
 
+bool MqttClient::subscribe(const String& topic, MqttDelegate handler, MqttPayloadParser payloadParser)
+{
+	if(!subscriptions.add(topic, Subscription{handler, payloadParser})) {
+		debug_e("[MQTT] Invalid topic filter '%s'", topic.c_str());
+		return false;
+	}
+
+	return subscribe(topic);
+}
+
 bool MqttClient::unsubscribe(const String& topic)
 {
 	debug_d("unsubscribing from '%s'", topic.c_str());
 
+	subscriptions.remove(topic);
+
 	if(requestQueue.full()) {
 		return false;
 	}
@@ -338,26 +567,104 @@ bool MqttClient::unsubscribe(const String& topic)
 	message->unsubscribe.topics = (mqtt_topic_t*)MQTT_MALLOC(sizeof(mqtt_topic_t));
 	memset(message->unsubscribe.topics, 0, sizeof(mqtt_topic_t));
 	if(!copyString(message->unsubscribe.topics->name, topic)) {
-		delete message;
+		deleteMessage(message);
 		return false;
 	}
 
 	return requestQueue.enqueue(message);
 }
 
+mqtt_message_t* MqttClient::getNextMessage()
+{
+	outgoingOwned = false;
+	if(connectQueued) {
+		connectQueued = false;
+		return &connectMessage;
+	}
+
+	auto message = responseQueue.dequeue();
+	if(message != nullptr) {
+		outgoingOwned = true;
+		return message;
+	}
+
+	// Re-send anything which hasn't been acknowledged in time
+	for(auto& msg : inflight) {
+		if(!msg.pending && !msg.timer.expired()) {
+			continue;
+		}
+		msg.pending = false;
+		msg.timer.reset(retransmitTimeout);
+		if(msg.released) {
+			message = createMessage(MQTT_TYPE_PUBREL);
+			if(message == nullptr) {
+				return nullptr;
+			}
+			message->common.qos = MQTT_QOS_AT_LEAST_ONCE;
+			message->pubrel.message_id = msg.message->publish.message_id;
+			outgoingOwned = true;
+			return message;
+		}
+		if(!msg.resendable) {
+			// Stream content has gone, keep waiting for acknowledgement
+			continue;
+		}
+		debug_d("[MQTT] Re-sending message #%u", msg.message->publish.message_id);
+		msg.message->common.dup = MQTT_DUP_TRUE;
+		return msg.message;
+	}
+
+	message = requestQueue.peek();
+	if(message == nullptr) {
+		return nullptr;
+	}
+
+	if(message->common.type != MQTT_TYPE_PUBLISH || message->common.qos == MQTT_QOS_AT_MOST_ONCE) {
+		outgoingOwned = true;
+		return requestQueue.dequeue();
+	}
+
+	// QoS 1/2 messages are retained until acknowledged
+	if(inflight.count() >= inflightWindow) {
+		return nullptr;
+	}
+
+	requestQueue.dequeue();
+	message->publish.message_id = getNextMessageId();
+	auto msg = new InflightMessage(message);
+	msg->pending = false;
+	msg->timer.reset(retransmitTimeout);
+	if(message->publish.content.length == MQTT_PUBLISH_STREAM && message->publish.content.data != nullptr) {
+		msg->resendable = false;
+	} else if(sessionStore != nullptr) {
+		MqttSessionStore::Entry entry{
+			.id = message->publish.message_id,
+			.flags = uint8_t(message->common.retain | (message->common.qos << 1)),
+			.released = false,
+			.topic = message->publish.topic_name,
+			.content = message->publish.content,
+		};
+		sessionStore->save(entry);
+	}
+	inflight.add(msg);
+
+	return message;
+}
+
 void MqttClient::onReadyToSendData(TcpConnectionEvent sourceEvent)
 {
+	size_t coalescedLength{0};
+
 	switch(state) {
 	REENTER:
 	case eMCS_Ready: {
-		if(outgoingMessage != &connectMessage) {
+		if(outgoingOwned) {
 			deleteMessage(outgoingMessage);
 		}
-		if(connectQueued) {
-			outgoingMessage = &connectMessage;
-			connectQueued = false;
-		} else {
-			outgoingMessage = requestQueue.dequeue();
+		outgoingMessage = getNextMessage();
+		if(!outgoingMessage && coalescedLength != 0) {
+			pingTimer.start();
+			break;
 		}
 		if(!outgoingMessage) {
 			// Send PINGREQ every PingRepeatTime time, if there is no outgoing traffic
@@ -366,6 +673,7 @@ void MqttClient::onReadyToSendData(TcpConnectionEvent sourceEvent)
 			}
 
 			outgoingMessage = createMessage(MQTT_TYPE_PINGREQ);
+			outgoingOwned = true;
 		}
 
 		debug_d("[MQTT] Sending message type %u", outgoingMessage->common.type);
@@ -401,6 +709,12 @@ void MqttClient::onReadyToSendData(TcpConnectionEvent sourceEvent)
 		}
 
 		state = eMCS_SendingData;
+
+		// Append further small messages to the same output buffer
+		coalescedLength += packetLength;
+		if(payloadStream == nullptr && coalescedLength < MQTT_COALESCE_SIZE) {
+			goto REENTER;
+		}
 	}
 
 	case eMCS_SendingData:
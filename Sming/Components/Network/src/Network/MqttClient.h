@@ -16,8 +16,12 @@
 #include <WString.h>
 #include <WHashMap.h>
 #include <Data/ObjectQueue.h>
+#include <Data/LinkedObjectList.h>
 #include <Platform/Timers.h>
+#include <SimpleTimer.h>
 #include "Mqtt/MqttPayloadParser.h"
+#include "Mqtt/MqttSessionStore.h"
+#include "Mqtt/MqttTopicTree.h"
 #include "mqtt-codec/src/message.h"
 #include "mqtt-codec/src/serialiser.h"
 #include "mqtt-codec/src/parser.h"
@@ -34,6 +38,36 @@ enum MqttClientState { eMCS_Ready = 0, eMCS_SendingData };
 #define MQTT_REQUEST_POOL_SIZE 10
 #endif
 
+/**
+ * @brief Default maximum number of QoS 1/2 messages awaiting acknowledgement
+ */
+#ifndef MQTT_INFLIGHT_WINDOW
+#define MQTT_INFLIGHT_WINDOW 4
+#endif
+
+/**
+ * @brief Small messages are combined into a single TCP write up to this many bytes
+ */
+#ifndef MQTT_COALESCE_SIZE
+#define MQTT_COALESCE_SIZE 1024
+#endif
+
+/**
+ * @brief Default time in seconds to wait for an acknowledgement before re-sending
+ */
+#ifndef MQTT_RETRANSMIT_TIMEOUT
+#define MQTT_RETRANSMIT_TIMEOUT 10
+#endif
+
+/**
+ * @brief Number of message structures allocated from a dedicated pool instead of the heap
+ *
+ * The pool is shared by all clients. Set to 0 to disable.
+ */
+#ifndef MQTT_MESSAGE_POOL_SIZE
+#define MQTT_MESSAGE_POOL_SIZE 0
+#endif
+
 #define MQTT_CLIENT_CONNECTED bit(1)
 
 #define MQTT_FLAG_RETAINED 1
@@ -116,10 +150,26 @@ public:
 	 */
 	bool subscribe(const String& topic);
 
+	/**
+	 * @brief Subscribe to a topic filter and handle matching messages separately
+	 * @param topic Topic filter, may contain `+` and `#` wildcards
+	 * @param handler Called for each PUBLISH message matching the filter
+	 * @param payloadParser Optional parser for matching messages, instead of the one set by `setPayloadParser()`
+	 * @retval bool
+	 *
+	 * A message which matches any subscription handler is not passed to the handler set by `setMessageHandler()`.
+	 * If several filters with a payload parser match, the most specific one is used.
+	 *
+	 * For large messages, use `streamPayloadParser()` to process content as it arrives.
+	 * The handler is then called once the message is complete, without any content data.
+	 */
+	bool subscribe(const String& topic, MqttDelegate handler, MqttPayloadParser payloadParser = nullptr);
+
 	/**
 	 * @brief Unsubscribe from a topic
 	 * @param topic
 	 * @retval bool
+	 * @note Removes any handler registered for this topic filter
 	 */
 	bool unsubscribe(const String& topic);
 
@@ -144,6 +194,43 @@ public:
 		this->payloadParser = payloadParser;
 	}
 
+	/**
+	 * @brief Set maximum number of QoS 1/2 publish messages awaiting acknowledgement
+	 * @param size Further messages stay in the request queue until a slot is free
+	 */
+	void setInflightWindow(uint8_t size)
+	{
+		inflightWindow = std::max(size, uint8_t(1));
+	}
+
+	/**
+	 * @brief Set how long to wait for PUBACK, PUBREC or PUBCOMP before re-sending a message
+	 * @param seconds
+	 */
+	void setRetransmitTimeout(uint16_t seconds)
+	{
+		retransmitTimeout = seconds;
+	}
+
+	/**
+	 * @brief Get number of QoS 1/2 messages awaiting acknowledgement
+	 */
+	size_t getInflightCount() const
+	{
+		return inflight.count();
+	}
+
+	/**
+	 * @brief Keep unacknowledged QoS 1/2 messages in persistent storage
+	 * @param store Must remain valid for the lifetime of the client, or until replaced.
+	 * Pass nullptr to stop using the store.
+	 * @retval bool false if stored messages could not be loaded
+	 *
+	 * Stored messages are loaded immediately and re-sent with the DUP flag once connected.
+	 * Only messages published with String content are stored.
+	 */
+	bool setSessionStore(MqttSessionStore* store);
+
 	/* [ Convenience methods ] */
 
 	/**
@@ -230,6 +317,17 @@ private:
 	static int staticOnMessageEnd(void* user_data, mqtt_message_t* message);
 	int onMessageEnd(mqtt_message_t* message);
 
+	// QoS 1/2 handling
+	class InflightMessage;
+	mqtt_message_t* getNextMessage();
+	uint16_t getNextMessageId();
+	InflightMessage* findInflight(uint16_t id);
+	void acknowledge(const mqtt_message_t* message);
+	bool queueResponse(mqtt_type_t type, uint16_t id);
+	void completeInflight(uint16_t id);
+
+	void scheduleFlush();
+
 private:
 	Url url;
 
@@ -237,6 +335,13 @@ private:
 	using HandlerMap = HashMap<mqtt_type_t, MqttDelegate>;
 	HandlerMap eventHandlers;
 	MqttPayloadParser payloadParser = nullptr;
+	MqttPayloadParser activePayloadParser = nullptr; ///< Parser for the incoming message
+
+	struct Subscription {
+		MqttDelegate handler;
+		MqttPayloadParser payloadParser;
+	};
+	MqttTopicTree<Subscription> subscriptions;
 
 	// states
 	MqttClientState state = eMCS_Ready;
@@ -247,13 +352,43 @@ private:
 	uint16_t pingRepeatTime = 20; ///< pingRepeatTime should be <= keepAlive
 	OneShotElapseTimer<NanoTime::Seconds> pingTimer;
 
+	// Publishes made within the same task cycle are sent together
+	SimpleTimer flushTimer;
+
 	// messages
 	MqttRequestQueue requestQueue;
 	mqtt_message_t connectMessage;
 	bool connectQueued = false; ///< True if our connect message needs to be sent
 	mqtt_message_t* outgoingMessage = nullptr;
+	bool outgoingOwned = false; ///< True if outgoingMessage must be deleted once sent
 	mqtt_message_t incomingMessage;
 
+	// QoS 1/2 messages awaiting acknowledgement
+	class InflightMessage : public LinkedObjectTemplate<InflightMessage>
+	{
+	public:
+		InflightMessage(mqtt_message_t* message) : message(message)
+		{
+		}
+
+		~InflightMessage();
+
+		mqtt_message_t* message; ///< Owned PUBLISH message
+		OneShotElapseTimer<NanoTime::Seconds> timer;
+		// Needs (re)sending at next opportunity
+		bool pending{true};
+		// QoS 2: PUBREC received, PUBREL to be sent
+		bool released{false};
+		// Set to false once stream content has been consumed
+		bool resendable{true};
+	};
+	OwnedLinkedObjectListTemplate<InflightMessage> inflight;
+	MqttRequestQueue responseQueue; ///< Acknowledgements for incoming messages, sent ahead of requests
+	MqttSessionStore* sessionStore{nullptr};
+	uint16_t lastMessageId{0};
+	uint16_t retransmitTimeout{MQTT_RETRANSMIT_TIMEOUT};
+	uint8_t inflightWindow{MQTT_INFLIGHT_WINDOW};
+
 	// parsers and serializers
 	mqtt_serialiser_t serialiser;
 	static const mqtt_parser_callbacks_t callbacks;
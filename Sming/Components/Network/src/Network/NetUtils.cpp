@@ -9,6 +9,7 @@
  ****/
 
 #include "NetUtils.h"
+#include "PbufCursor.h"
 #include <Data/CStringArray.h>
 #include <WString.h>
 #include <debug_progmem.h>
@@ -25,83 +26,20 @@ namespace NetUtils
 {
 int pbufFindChar(const pbuf* buf, char wtf, unsigned startPos)
 {
-	unsigned ofs = 0;
-
-	while(buf->len <= startPos) {
-		ofs += buf->len;
-		startPos -= buf->len;
-		buf = buf->next;
-		if(buf == nullptr) {
-			return -1;
-		}
-	}
-
-	do {
-		for(unsigned i = startPos; i < buf->len; i++) {
-			char* sbuf = (char*)buf->payload;
-			if(sbuf[i] == wtf) {
-				//debug_d("%d %d", ofs, i);
-				return ofs + i;
-			}
-		}
-		ofs += buf->len;
-		buf = buf->next;
-		startPos = 0;
-	} while(buf != nullptr);
-
-	return -1;
+	PbufCursor cursor(buf);
+	return cursor.seek(startPos) ? cursor.find(wtf) : -1;
 }
 
 bool pbufIsStrEqual(const pbuf* buf, const char* compared, unsigned startPos)
 {
-	unsigned cur = startPos;
-
-	while(buf->len <= cur) {
-		cur -= buf->len;
-		buf = buf->next;
-		if(buf == nullptr) {
-			return false;
-		}
-	}
-
-	for(const char* cmp = compared; *cmp; cmp++) {
-		if(buf == nullptr)
-			return false;
-
-		char& target = ((char*)buf->payload)[cur];
-		if(target != *cmp)
-			return false;
-
-		cur++;
-		if(cur >= buf->len) {
-			cur = 0;
-			buf = buf->next;
-		}
-	}
-
-	return true;
+	PbufCursor cursor(buf);
+	return cursor.seek(startPos) && cursor.startsWith(compared);
 }
 
 int pbufFindStr(const pbuf* buf, const char* wtf, unsigned startPos)
 {
-	if(wtf == nullptr) {
-		return -1;
-	}
-
-	int cur = startPos;
-	while(true) {
-		cur = pbufFindChar(buf, wtf[0], cur);
-		if(cur < 0) {
-			return -1;
-		}
-
-		if(pbufIsStrEqual(buf, wtf, cur)) {
-			return cur;
-		}
-		cur++;
-	}
-
-	return -1;
+	PbufCursor cursor(buf);
+	return cursor.seek(startPos) ? cursor.find(wtf) : -1;
 }
 
 char* pbufAllocateStrCopy(const pbuf* buf, unsigned startPos, unsigned length)
@@ -117,15 +55,8 @@ char* pbufAllocateStrCopy(const pbuf* buf, unsigned startPos, unsigned length)
 
 String pbufStrCopy(const pbuf* buf, unsigned startPos, unsigned length)
 {
-	char* stringPtr = new char[length + 1];
-	if(stringPtr == nullptr) {
-		return nullptr;
-	}
-	stringPtr[length] = '\0';
-	pbuf_copy_partial(const_cast<pbuf*>(buf), stringPtr, length, startPos);
-	String res = String(stringPtr);
-	delete[] stringPtr;
-	return res;
+	PbufCursor cursor(buf);
+	return cursor.seek(startPos) ? cursor.readString(length) : nullptr;
 }
 
 #ifdef FIX_NETWORK_ROUTING
@@ -11,6 +11,7 @@
 #pragma once
 
 #include <lwip/init.h>
+#include <sming_attr.h>
 
 #if LWIP_VERSION_MAJOR == 2
 #include "lwip/priv/tcp_priv.h"
@@ -28,10 +29,14 @@ class String;
 namespace NetUtils
 {
 // Helpers
+// Each call scans from the start of the chain. To parse a buffer use `PbufCursor` instead.
 bool pbufIsStrEqual(const pbuf* buf, const char* compared, unsigned startPos);
 int pbufFindChar(const pbuf* buf, char wtf, unsigned startPos = 0);
 int pbufFindStr(const pbuf* buf, const char* wtf, unsigned startPos = 0);
-char* pbufAllocateStrCopy(const pbuf* buf, unsigned startPos, unsigned length);
+/**
+ * @deprecated Use `pbufStrCopy()` or `PbufCursor::readString()`
+ */
+char* pbufAllocateStrCopy(const pbuf* buf, unsigned startPos, unsigned length) SMING_DEPRECATED;
 String pbufStrCopy(const pbuf* buf, unsigned startPos, unsigned length);
 
 #ifdef FIX_NETWORK_ROUTING
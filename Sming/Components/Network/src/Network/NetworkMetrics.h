@@ -0,0 +1,20 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * NetworkMetrics.h - Metrics shared between network modules
+ *
+ ****/
+
+#pragma once
+
+#include <Services/Profiling/Metrics.h>
+
+namespace Network::Metrics
+{
+extern Profiling::Metrics::Counter tcpBytesReceived;
+extern Profiling::Metrics::Counter tcpBytesSent;
+
+} // namespace Network::Metrics
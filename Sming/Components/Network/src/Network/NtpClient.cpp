@@ -11,15 +11,62 @@
 #include "NtpClient.h"
 #include "Platform/Station.h"
 #include "SystemClock.h"
+#include "DnsResolver.h"
+#include <Platform/RtcState.h>
 #include <lwip_includes.h>
 
+namespace
+{
+constexpr uint32_t NTP_UNIX_EPOCH_OFFSET{0x83AA7E80}; // Seconds from 1900 to 1970
+constexpr uint64_t NS_PER_SECOND{1000000000ULL};
+constexpr size_t NTP_ORIGINATE_TIMESTAMP_OFFSET{24};
+constexpr size_t NTP_RECEIVE_TIMESTAMP_OFFSET{32};
+constexpr size_t NTP_TRANSMIT_TIMESTAMP_OFFSET{40};
+
+RtcState<int32_t> driftRtcState(NTP_DRIFT_RTC_BLOCK);
+
+/*
+ * NTP timestamps are 32-bit seconds since 1900 with a 32-bit binary fraction, big-endian
+ */
+void writeTimestamp(uint8_t* buf, uint64_t ns)
+{
+	uint32_t secs = (ns / NS_PER_SECOND) + NTP_UNIX_EPOCH_OFFSET;
+	uint32_t fraction = ((ns % NS_PER_SECOND) << 32) / NS_PER_SECOND;
+	for(unsigned i = 0; i < 4; ++i) {
+		buf[i] = secs >> (24 - i * 8);
+		buf[4 + i] = fraction >> (24 - i * 8);
+	}
+}
+
+int64_t readTimestamp(pbuf* buf, size_t offset)
+{
+	uint8_t value[8];
+	pbuf_copy_partial(buf, value, sizeof(value), offset);
+	uint32_t secs{0};
+	uint32_t fraction{0};
+	for(unsigned i = 0; i < 4; ++i) {
+		secs = (secs << 8) | value[i];
+		fraction = (fraction << 8) | value[4 + i];
+	}
+	secs -= NTP_UNIX_EPOCH_OFFSET;
+	return int64_t(secs) * NS_PER_SECOND + ((uint64_t(fraction) * NS_PER_SECOND) >> 32);
+}
+
+} // namespace
+
 NtpClient::NtpClient(const String& reqServer, unsigned reqIntervalSeconds, NtpTimeResultDelegate delegateFunction)
 	: delegateCompleted(delegateFunction)
 {
 	// Setup timer, but don't start it
-	timer.setCallback(TimerDelegate(&NtpClient::requestTime, this));
+	timer.setCallback(TimerDelegate(&NtpClient::timerExpired, this));
+
+	// Drift learned before deep sleep still applies, so don't wait to learn it again
+	int32_t drift;
+	if(SystemClock.getDriftCorrection() == 0 && driftRtcState.load(drift)) {
+		SystemClock.setDriftCorrection(drift);
+	}
 
-	this->server = reqServer ?: NTP_DEFAULT_SERVER;
+	setNtpServer(reqServer ?: NTP_DEFAULT_SERVER);
 	if(!delegateFunction) {
 		autoUpdateSystemClock = true;
 	}
@@ -33,10 +80,40 @@ NtpClient::NtpClient(const String& reqServer, unsigned reqIntervalSeconds, NtpTi
 	}
 }
 
+void NtpClient::timerExpired()
+{
+	if(!burstActive) {
+		// Periodic query
+		requestTime();
+		return;
+	}
+
+	if(awaitingResponse) {
+		// No response, move on to next sample
+		awaitingResponse = false;
+		++sampleIndex;
+	}
+
+	if(sampleIndex < burstSize) {
+		requestSample();
+	} else {
+		completeBurst();
+	}
+}
+
 void NtpClient::requestTime()
 {
 	debug_d("NtpClient::requestTime()");
 
+	burstActive = true;
+	awaitingResponse = false;
+	sampleIndex = 0;
+	sampleCount = 0;
+	requestSample();
+}
+
+void NtpClient::requestSample()
+{
 	// Schedule a retry in anticipation of failure
 	startTimer(NTP_CONNECTION_TIMEOUT_MS);
 
@@ -45,26 +122,25 @@ void NtpClient::requestTime()
 		return;
 	}
 
-	ip_addr_t resolvedIp;
-	int result = dns_gethostbyname(
-		server.c_str(), &resolvedIp,
-		[](const char* name, LWIP_IP_ADDR_T* ip, void* arg) {
-			// We do a new request since the last one was never done.
-			if(ip)
-				reinterpret_cast<NtpClient*>(arg)->internalRequestTime(*ip);
-		},
-		this);
+	if(servers.count() == 0) {
+		debug_w("NtpClient has no servers");
+		return;
+	}
 
-	debug_d("dns_gethostbyname() returned %d", result);
+	String server = servers[sampleIndex % servers.count()];
+	IpAddress resolvedIp;
+	int result = DnsResolver.resolve(server, resolvedIp, [this](const String& name, const IpAddress* ip) {
+		// We do a new request since the last one was never done.
+		if(ip && burstActive && !awaitingResponse) {
+			internalRequestTime(*ip);
+		}
+	});
+
+	debug_d("DnsResolver.resolve() returned %d", result);
 
 	switch(result) {
 	case ERR_OK:
-		// Documentation says this will be the result if the string is already
-		// an ip address in dotted decimal form or if the host is found in dns cache.
-		// however I'm not sure if the dns cache is working since this never seems to
-		// be called for a host lookup other than an ip address.
-		// Doesn't really matter since the lookup will be fast anyways, the host
-		// is most likely found in the dns cache of the next node the query is sent to.
+		// Address given in dotted decimal form, or found in the cache
 		internalRequestTime(resolvedIp);
 		break;
 	case ERR_INPROGRESS:
@@ -85,7 +161,7 @@ void NtpClient::internalRequestTime(IpAddress serverIp)
 	connect(serverIp, NTP_PORT);
 
 	// Setup the NTP request packet
-	char packet[NTP_PACKET_SIZE] = {0};
+	uint8_t packet[NTP_PACKET_SIZE] = {0};
 
 	// These are the only required values for a SNTP request. See page 14:
 	// https://tools.ietf.org/html/rfc4330
@@ -93,11 +169,16 @@ void NtpClient::internalRequestTime(IpAddress serverIp)
 	packet[0] = (NTP_VERSION << 3 | 0x03); // LI (0 = no warning), Protocol version (4), Client mode (3)
 	packet[1] = 0;						   // Stratum, or type of clock, unspecified.
 
+	// The server returns our transmit time as its originate time, used to measure the round trip
+	writeTimestamp(requestTimestamp, SystemClock.getTimeNs());
+	memcpy(&packet[NTP_TRANSMIT_TIMESTAMP_OFFSET], requestTimestamp, sizeof(requestTimestamp));
+
 	// Start timer to retry if no response received
+	awaitingResponse = true;
 	startTimer(NTP_RESPONSE_TIMEOUT_MS);
 
 	// Send to server, serverAddress & port is set in connect
-	NtpClient::send(packet, NTP_PACKET_SIZE);
+	NtpClient::send(reinterpret_cast<const char*>(packet), NTP_PACKET_SIZE);
 }
 
 void NtpClient::setAutoQuery(bool autoQuery)
@@ -120,44 +201,104 @@ void NtpClient::setAutoQueryInterval(unsigned seconds)
 
 void NtpClient::onReceive(pbuf* buf, IpAddress remoteIP, uint16_t remotePort)
 {
+	auto receiveTime = SystemClock.getTimeNs();
+
 	debug_d("NtpClient::onReceive(%s:%u)", remoteIP.toString().c_str(), remotePort);
 
-	stopTimer();
-	auto retry = [this]() { startTimer(NTP_RESPONSE_TIMEOUT_MS); };
+	if(!awaitingResponse || buf->tot_len < NTP_PACKET_SIZE) {
+		return;
+	}
 
 	// We do some basic check to see if it really is a ntp packet we receive.
 	// NTP version should be set to same as we used to send, NTP_VERSION
 	// NTP_VERSION 3 has time in same location so accept that too
 	// Mode should be set to NTP_MODE_SERVER
+	// Anything else is ignored, and the response timeout remains in effect
 
 	uint8_t versionMode = pbuf_get_at(buf, 0);
 	uint8_t ver = (versionMode & 0b00111000) >> 3;
 	uint8_t mode = (versionMode & 0x07);
 
 	if(mode != NTP_MODE_SERVER) {
-		// Received response from another client - retry
-		return retry();
+		// Received response from another client
+		return;
 	}
 
 	if(ver != NTP_VERSION && ver != (NTP_VERSION - 1)) {
-		// Received an unsupported version - retry
-		return retry();
+		// Received an unsupported version
+		return;
 	}
 
-	uint32_t timestamp;
-	pbuf_copy_partial(buf, &timestamp, sizeof(timestamp), 40); // Copy only timestamp.
-	timestamp = ntohl(timestamp);
+	if(pbuf_memcmp(buf, NTP_ORIGINATE_TIMESTAMP_OFFSET, requestTimestamp, sizeof(requestTimestamp)) != 0) {
+		// Not a reply to our latest query
+		return;
+	}
 
-	if(timestamp == 0) {
+	if(pbuf_get_at(buf, NTP_TRANSMIT_TIMESTAMP_OFFSET) == 0) {
 		// Timestamp is not valid
-		return retry();
+		return;
 	}
 
-	// Unix time starts on Jan 1 1970, subtract 70 years:
-	uint32_t epoch = timestamp - 0x83AA7E80;
+	/*
+	 * Standard NTP calculation, see RFC 5905:
+	 *   offset = ((t2 - t1) + (t3 - t4)) / 2
+	 *   delay = (t4 - t1) - (t3 - t2)
+	 */
+	auto t1 = readTimestamp(buf, NTP_ORIGINATE_TIMESTAMP_OFFSET);
+	auto t2 = readTimestamp(buf, NTP_RECEIVE_TIMESTAMP_OFFSET);
+	auto t3 = readTimestamp(buf, NTP_TRANSMIT_TIMESTAMP_OFFSET);
+	auto t4 = int64_t(receiveTime);
+	Sample sample{((t2 - t1) + (t3 - t4)) / 2, (t4 - t1) - (t3 - t2)};
+	debug_d("NtpClient sample %u offset %lld delay %lld", sampleIndex, sample.offset, sample.delay);
+
+	// Keep the sample with the shortest round trip, as that has the least uncertainty
+	if(sampleCount == 0 || sample.delay < best.delay) {
+		best = sample;
+	}
+	++sampleCount;
+
+	awaitingResponse = false;
+	++sampleIndex;
+	if(sampleIndex < burstSize) {
+		startTimer(NTP_BURST_INTERVAL_MS);
+	} else {
+		stopTimer();
+		completeBurst();
+	}
+}
+
+void NtpClient::completeBurst()
+{
+	burstActive = false;
+
+	if(sampleCount == 0) {
+		// No server responded, try again
+		requestTime();
+		return;
+	}
+
+	lastOffset = best.offset;
+	lastDelay = best.delay;
+
+	auto now = SystemClock.getTimeNs();
+	time_t epoch = (int64_t(now) + best.offset) / int64_t(NS_PER_SECOND);
 
 	if(autoUpdateSystemClock) {
-		SystemClock.setTime(epoch, eTZ_UTC); // update systemclock utc value
+		/*
+		 * Remaining error after the previous correction completed is due to drift.
+		 * Only half of it is applied so noise in the measurements is smoothed out.
+		 */
+		uint64_t elapsed = now - lastSyncTime;
+		if(driftTracking && lastSyncTime != 0 && !SystemClock.isSlewing() &&
+		   elapsed >= NTP_DRIFT_MIN_INTERVAL_SECONDS * NS_PER_SECOND &&
+		   std::abs(best.offset) < SYSTEM_CLOCK_STEP_THRESHOLD_MS * 1000000LL) {
+			int32_t drift = best.offset * int64_t(NS_PER_SECOND) / int64_t(elapsed);
+			SystemClock.setDriftCorrection(SystemClock.getDriftCorrection() + drift / 2);
+			driftRtcState.save(SystemClock.getDriftCorrection());
+			debug_d("NtpClient drift correction %d ppb", SystemClock.getDriftCorrection());
+		}
+		SystemClock.adjustTime(best.offset);
+		lastSyncTime = SystemClock.getTimeNs();
 	}
 
 	if(delegateCompleted) {
@@ -20,6 +20,7 @@
 #include "Platform/System.h"
 #include "Timer.h"
 #include "DateTime.h"
+#include <Data/CStringArray.h>
 
 #define NTP_PORT 123
 #define NTP_PACKET_SIZE 48
@@ -32,13 +33,29 @@
 #define NTP_MIN_AUTOQUERY_SECONDS 10U	 ///< Minimum autoquery interval
 #define NTP_CONNECTION_TIMEOUT_MS 1666U   ///< Time to retry query when network connection unavailable
 #define NTP_RESPONSE_TIMEOUT_MS 20000U	///< Time to wait before retrying NTP query
+#define NTP_BURST_INTERVAL_MS 2000U		  ///< Time between queries within a burst
+#define NTP_DRIFT_MIN_INTERVAL_SECONDS 600U ///< Shortest sync interval used to estimate clock drift
+
+/**
+ * @brief Location in RTC memory (4-byte blocks) where learned drift correction is kept through deep sleep
+ */
+#ifndef NTP_DRIFT_RTC_BLOCK
+#define NTP_DRIFT_RTC_BLOCK 90
+#endif
 
 class NtpClient;
 
 // Delegate constructor usage: (&YourClass::method, this)
 using NtpTimeResultDelegate = Delegate<void(NtpClient& client, time_t ntpTime)>;
 
-/** @brief  NTP client class */
+/** @brief  NTP client class
+ *
+ *  Each request is a burst of one or more queries, sent in turn to each configured server.
+ *  The sample with the shortest round trip is used, as it has the least uncertainty in its offset.
+ *  On completion the system clock is slewed towards the server time, or stepped if the error
+ *  is large. The drift seen between syncs is learned and applied via SystemClock::setDriftCorrection(),
+ *  so longer intervals between requests may be used once the clock has settled.
+ */
 class NtpClient : protected UdpConnection
 {
 public:
@@ -70,10 +87,52 @@ public:
 
 	/** @brief  Set the NTP server
      *  @param  server IP address or hostname of NTP server
+     *  @note   Replaces any servers previously set
      */
 	void setNtpServer(const String& server)
 	{
-		this->server = server;
+		servers.clear();
+		servers.add(server);
+	}
+
+	/** @brief  Add another server to query
+     *  @param  server IP address or hostname of NTP server
+     */
+	void addNtpServer(const String& server)
+	{
+		servers.add(server);
+	}
+
+	/** @brief  Set the number of queries made for each request
+     *  @param  samples Queries are spread across the servers in turn (default 1)
+     */
+	void setBurstSize(uint8_t samples)
+	{
+		burstSize = std::max(samples, uint8_t(1));
+	}
+
+	/** @brief  Enable / disable learning of clock drift between requests
+     *  @param  enable Applies only when the system clock is updated automatically (default true)
+     */
+	void setDriftTracking(bool enable)
+	{
+		driftTracking = enable;
+	}
+
+	/** @brief  Get the clock offset measured by the most recent request
+     *  @retval int64_t Nanoseconds, positive if the local clock was behind
+     */
+	int64_t getLastOffset() const
+	{
+		return lastOffset;
+	}
+
+	/** @brief  Get the round trip time of the sample used by the most recent request
+     *  @retval int64_t Nanoseconds
+     */
+	int64_t getLastDelay() const
+	{
+		return lastDelay;
 	}
 
 	/** @brief  Enable / disable periodic query
@@ -107,6 +166,14 @@ protected:
      */
 	void internalRequestTime(IpAddress serverIp);
 
+	/** @brief  Send the next query of a burst
+     */
+	void requestSample();
+
+	/** @brief  Apply the best sample from a burst
+     */
+	void completeBurst();
+
 	/** @brief Start the timer running
 	 *  @param milliseconds Time to run in milliseconds
 	 */
@@ -123,14 +190,35 @@ protected:
 		timer.stop();
 	}
 
+private:
+	void timerExpired();
+
 protected:
-	String server; ///< IP address or Hostname of NTP server
+	CStringArray servers; ///< IP addresses or Hostnames of NTP servers
 
 	NtpTimeResultDelegate delegateCompleted = nullptr; ///< NTP result handler delegate
 	bool autoUpdateSystemClock = false;				   ///< True to update system clock with NTP time
 	bool autoQueryEnabled = false;
 	unsigned autoQuerySeconds = NTP_DEFAULT_AUTOQUERY_SECONDS;
 	Timer timer; ///< Deals with timeouts, retries and autoquery updates
+
+private:
+	struct Sample {
+		int64_t offset;
+		int64_t delay;
+	};
+
+	Sample best{};
+	int64_t lastOffset = 0;
+	int64_t lastDelay = 0;
+	uint64_t lastSyncTime = 0;		   ///< SystemClock time of last adjustment
+	uint8_t requestTimestamp[8]{};	 ///< Transmit timestamp of query, echoed by the server
+	uint8_t burstSize = 1;
+	uint8_t sampleIndex = 0;
+	uint8_t sampleCount = 0; ///< Valid samples received in current burst
+	bool burstActive = false;
+	bool awaitingResponse = false;
+	bool driftTracking = true;
 };
 
 /** @} */
@@ -0,0 +1,133 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * PbufCursor.cpp
+ *
+ ****/
+
+#include "PbufCursor.h"
+#include <algorithm>
+
+namespace NetUtils
+{
+bool PbufCursor::seek(size_t pos)
+{
+	if(pos > length()) {
+		return false;
+	}
+
+	if(pos < segStart) {
+		seg = head;
+		segStart = 0;
+	}
+	index = pos - segStart;
+	skipEmpty();
+	return true;
+}
+
+int PbufCursor::find(char c, size_t maxLength) const
+{
+	auto s = seg;
+	size_t start = segStart;
+	size_t i = index;
+	while(s != nullptr && maxLength != 0) {
+		auto payload = static_cast<const char*>(s->payload);
+		size_t n = std::min(size_t(s->len - i), maxLength);
+		auto p = static_cast<const char*>(memchr(payload + i, c, n));
+		if(p != nullptr) {
+			return start + (p - payload);
+		}
+		maxLength -= n;
+		start += s->len;
+		s = s->next;
+		i = 0;
+	}
+
+	return -1;
+}
+
+int PbufCursor::find(const char* str, size_t len, size_t maxLength) const
+{
+	if(str == nullptr) {
+		return -1;
+	}
+	if(len == 0) {
+		return position();
+	}
+
+	// Match must lie entirely within search range
+	size_t end = position() + std::min(maxLength, remaining());
+	PbufCursor cursor(*this);
+	while(cursor.position() + len <= end) {
+		int pos = cursor.find(str[0], end - len + 1 - cursor.position());
+		if(pos < 0) {
+			break;
+		}
+		cursor.seek(pos);
+		if(cursor.startsWith(str, len)) {
+			return pos;
+		}
+		cursor.step(1);
+	}
+
+	return -1;
+}
+
+bool PbufCursor::startsWith(const char* str, size_t len) const
+{
+	if(len > remaining()) {
+		return false;
+	}
+
+	auto s = seg;
+	size_t i = index;
+	while(len != 0) {
+		size_t n = std::min(size_t(s->len - i), len);
+		if(memcmp(static_cast<const char*>(s->payload) + i, str, n) != 0) {
+			return false;
+		}
+		str += n;
+		len -= n;
+		s = s->next;
+		i = 0;
+	}
+
+	return true;
+}
+
+size_t PbufCursor::read(void* buffer, size_t len)
+{
+	auto dst = static_cast<uint8_t*>(buffer);
+	size_t count = 0;
+	while(seg != nullptr && count < len) {
+		size_t n = std::min(size_t(seg->len - index), len - count);
+		memcpy(dst + count, static_cast<const uint8_t*>(seg->payload) + index, n);
+		count += n;
+		step(n);
+	}
+	return count;
+}
+
+String PbufCursor::readString(size_t len)
+{
+	len = std::min(len, remaining());
+
+	auto data = view(len);
+	if(data != nullptr) {
+		String s(data, len);
+		step(len);
+		return s;
+	}
+
+	String s;
+	if(!s.setLength(len)) {
+		return nullptr;
+	}
+	read(s.begin(), len);
+	return s;
+}
+
+} // namespace NetUtils
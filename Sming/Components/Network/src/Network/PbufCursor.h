@@ -0,0 +1,214 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * PbufCursor.h - Sequential access to data in a pbuf chain
+ *
+ ****/
+
+#pragma once
+
+#include <lwip/pbuf.h>
+#include <cstring>
+#include <cstdint>
+#include <WString.h>
+
+namespace NetUtils
+{
+/**
+ * @ingroup networking
+ * @brief Read and search data held in a chain of pbufs
+ *
+ * The cursor remembers which segment it is in, so moving forward or searching from the current
+ * position never rescans earlier segments. Parsing a buffer line by line is therefore linear in its size.
+ * Searching uses `memchr` within each segment.
+ *
+ * Positions are absolute offsets from the start of the chain, as used by `pbuf_copy_partial()`
+ * and `NetUtils::pbufFindStr()`.
+ *
+ * @code
+ * err_t MyConnection::onReceive(pbuf* buf)
+ * {
+ * 	NetUtils::PbufCursor cursor(buf);
+ * 	int eol;
+ * 	while((eol = cursor.find("\r\n")) >= 0) {
+ * 		String line = cursor.readString(eol - cursor.position());
+ * 		cursor.advance(2);
+ * 		processLine(line);
+ * 	}
+ * 	...
+ * }
+ * @endcode
+ */
+class PbufCursor
+{
+public:
+	PbufCursor(const pbuf* buf) : head(buf), seg(buf)
+	{
+		skipEmpty();
+	}
+
+	/**
+	 * @brief Current offset from start of chain
+	 */
+	size_t position() const
+	{
+		return segStart + index;
+	}
+
+	/**
+	 * @brief Total length of chain
+	 */
+	size_t length() const
+	{
+		return head ? head->tot_len : 0;
+	}
+
+	/**
+	 * @brief Number of bytes from current position to end of chain
+	 */
+	size_t remaining() const
+	{
+		return length() - position();
+	}
+
+	bool atEnd() const
+	{
+		return seg == nullptr;
+	}
+
+	/**
+	 * @brief Move to an absolute position
+	 * @retval bool false if position is beyond end of chain
+	 *
+	 * Moving forward continues from the current segment.
+	 * Moving back restarts from the head of the chain.
+	 */
+	bool seek(size_t pos);
+
+	/**
+	 * @brief Move forward by a number of bytes
+	 * @retval bool false if this goes beyond end of chain
+	 */
+	bool advance(size_t count)
+	{
+		return seek(position() + count);
+	}
+
+	/**
+	 * @brief Get character at current position without consuming it
+	 * @retval int -1 at end of chain
+	 */
+	int peek() const
+	{
+		return seg ? static_cast<const uint8_t*>(seg->payload)[index] : -1;
+	}
+
+	/**
+	 * @brief Get character at current position and advance
+	 * @retval int -1 at end of chain
+	 */
+	int read()
+	{
+		int c = peek();
+		if(c >= 0) {
+			step(1);
+		}
+		return c;
+	}
+
+	/**
+	 * @brief Find a character, starting at the current position
+	 * @param c Character to find
+	 * @param maxLength Search no further than this many bytes
+	 * @retval int Absolute position of character, -1 if not found
+	 * @note Cursor position is unchanged
+	 */
+	int find(char c, size_t maxLength = SIZE_MAX) const;
+
+	/**
+	 * @brief Find a string, starting at the current position
+	 * @param str String to find, may span segments
+	 * @param len Length of string
+	 * @param maxLength Search no further than this many bytes
+	 * @retval int Absolute position of start of string, -1 if not found
+	 * @note Cursor position is unchanged
+	 */
+	int find(const char* str, size_t len, size_t maxLength = SIZE_MAX) const;
+
+	int find(const char* str) const
+	{
+		return str ? find(str, strlen(str)) : -1;
+	}
+
+	/**
+	 * @brief Determine if data at current position matches a string
+	 */
+	bool startsWith(const char* str, size_t len) const;
+
+	bool startsWith(const char* str) const
+	{
+		return str && startsWith(str, strlen(str));
+	}
+
+	/**
+	 * @brief Get direct access to data at the current position
+	 * @param len Number of bytes required
+	 * @retval const char* nullptr if data is not contiguous, i.e. spans a segment boundary
+	 */
+	const char* view(size_t len) const
+	{
+		return (seg && index + len <= seg->len) ? static_cast<const char*>(seg->payload) + index : nullptr;
+	}
+
+	/**
+	 * @brief Get all contiguous data from current position to end of segment
+	 * @param data On return, points to data
+	 * @retval size_t Number of bytes available at `data`
+	 */
+	size_t view(const char*& data) const
+	{
+		if(seg == nullptr) {
+			return 0;
+		}
+		data = static_cast<const char*>(seg->payload) + index;
+		return seg->len - index;
+	}
+
+	/**
+	 * @brief Copy data and advance
+	 * @retval size_t Number of bytes copied, less than `len` if end of chain is reached
+	 */
+	size_t read(void* buffer, size_t len);
+
+	/**
+	 * @brief Copy data into a String and advance
+	 * @retval String Invalid if allocation fails
+	 */
+	String readString(size_t len);
+
+private:
+	void skipEmpty()
+	{
+		while(seg != nullptr && index >= seg->len) {
+			index -= seg->len;
+			segStart += seg->len;
+			seg = seg->next;
+		}
+	}
+
+	void step(size_t count)
+	{
+		index += count;
+		skipEmpty();
+	}
+
+	const pbuf* head;
+	const pbuf* seg;	 ///< Current segment, nullptr at end of chain
+	size_t segStart{0}; ///< Absolute offset of current segment
+	size_t index{0};	 ///< Offset within current segment
+};
+
+} // namespace NetUtils
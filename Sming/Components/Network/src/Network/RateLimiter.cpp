@@ -0,0 +1,106 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * RateLimiter.cpp
+ *
+ ****/
+
+#include "RateLimiter.h"
+
+namespace Network
+{
+const RateLimiter::Bucket* RateLimiter::find(uint32_t addr) const
+{
+	for(auto& bucket : buckets) {
+		if(bucket.addr == addr) {
+			return &bucket;
+		}
+	}
+	return nullptr;
+}
+
+RateLimiter::Bucket& RateLimiter::get(uint32_t addr, uint32_t now)
+{
+	auto bucket = const_cast<Bucket*>(find(addr));
+	if(bucket != nullptr) {
+		return *bucket;
+	}
+
+	// Take an unused entry, otherwise the least recently seen
+	Bucket* oldest = &buckets[0];
+	for(auto& b : buckets) {
+		if(b.addr == 0) {
+			oldest = &b;
+			break;
+		}
+		if(now - b.lastSeen > now - oldest->lastSeen) {
+			oldest = &b;
+		}
+	}
+
+	if(oldest->addr != 0) {
+		++stats.evictions;
+	}
+
+	*oldest = Bucket{addr, now, now, burst};
+	return *oldest;
+}
+
+void RateLimiter::refill(Bucket& bucket, uint32_t now) const
+{
+	if(bucket.tokens >= burst || interval == 0) {
+		// Time spent full doesn't count towards the next token
+		bucket.tokens = burst;
+		bucket.refillTime = now;
+		return;
+	}
+
+	uint32_t count = (now - bucket.refillTime) / interval;
+	if(count == 0) {
+		return;
+	}
+	if(count >= uint32_t(burst - bucket.tokens)) {
+		bucket.tokens = burst;
+		bucket.refillTime = now;
+	} else {
+		bucket.tokens += count;
+		bucket.refillTime += count * interval;
+	}
+}
+
+bool RateLimiter::allow(IpAddress ip, uint32_t now)
+{
+	auto& bucket = get(uint32_t(ip), now);
+	bucket.lastSeen = now;
+	refill(bucket, now);
+
+	if(bucket.tokens == 0) {
+		++stats.rejected;
+		return false;
+	}
+
+	--bucket.tokens;
+	++stats.allowed;
+	return true;
+}
+
+uint32_t RateLimiter::getRetryTime(IpAddress ip, uint32_t now) const
+{
+	auto bucket = find(uint32_t(ip));
+	if(bucket == nullptr) {
+		return 0;
+	}
+
+	Bucket b = *bucket;
+	refill(b, now);
+	if(b.tokens != 0) {
+		return 0;
+	}
+
+	return interval - (now - b.refillTime);
+}
+
+} // namespace Network
@@ -0,0 +1,119 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * RateLimiter.h - Per-client token bucket rate limiting
+ *
+ ****/
+
+#pragma once
+
+#include <IpAddress.h>
+#include <Clock.h>
+#include <array>
+
+/**
+ * @brief Number of clients tracked by a RateLimiter
+ * @note Each entry requires 16 bytes
+ */
+#ifndef RATE_LIMITER_TABLE_SIZE
+#define RATE_LIMITER_TABLE_SIZE 8
+#endif
+
+namespace Network
+{
+/**
+ * @ingroup tcp
+ * @brief Limit the rate of connections or requests from each remote IP address
+ *
+ * Each client has a bucket holding up to `burst` tokens, with one token restored every `interval`
+ * milliseconds. Each request takes a token, and is refused if the bucket is empty.
+ *
+ * Clients are tracked in a small fixed-size table. When it is full, the least recently seen client
+ * is evicted and starts again with a full bucket if it returns.
+ *
+ * A single limiter may be shared, e.g. by a TcpServer and a ResourceRateLimit plugin,
+ * although each check then consumes a token.
+ */
+class RateLimiter
+{
+public:
+	struct Stats {
+		uint32_t allowed;   ///< Requests permitted
+		uint32_t rejected;  ///< Requests refused
+		uint32_t evictions; ///< Clients dropped from the table to make room for another
+	};
+
+	/**
+	 * @brief Constructor
+	 * @param burst Maximum number of requests a client may make in quick succession
+	 * @param interval Time in milliseconds to restore one token
+	 */
+	RateLimiter(uint16_t burst, uint32_t interval) : burst(burst), interval(interval)
+	{
+	}
+
+	/**
+	 * @brief Check whether a client may proceed, consuming a token if so
+	 * @param ip Remote address
+	 * @retval bool true if request is permitted
+	 */
+	bool allow(IpAddress ip)
+	{
+		return allow(ip, millis());
+	}
+
+	/**
+	 * @brief Check whether a client may proceed at a given time
+	 * @param ip Remote address
+	 * @param now Current time in milliseconds
+	 * @retval bool true if request is permitted
+	 */
+	bool allow(IpAddress ip, uint32_t now);
+
+	/**
+	 * @brief Get time until a client may next proceed
+	 * @param ip Remote address
+	 * @retval uint32_t Milliseconds, 0 if a request would be allowed now
+	 */
+	uint32_t getRetryTime(IpAddress ip) const
+	{
+		return getRetryTime(ip, millis());
+	}
+
+	uint32_t getRetryTime(IpAddress ip, uint32_t now) const;
+
+	/**
+	 * @brief Forget all clients
+	 */
+	void reset()
+	{
+		buckets = {};
+	}
+
+	const Stats& getStats() const
+	{
+		return stats;
+	}
+
+private:
+	struct Bucket {
+		uint32_t addr;		 ///< 0 if unused
+		uint32_t refillTime; ///< When the last token was restored
+		uint32_t lastSeen;
+		uint16_t tokens;
+	};
+
+	const Bucket* find(uint32_t addr) const;
+	Bucket& get(uint32_t addr, uint32_t now);
+	void refill(Bucket& bucket, uint32_t now) const;
+
+	std::array<Bucket, RATE_LIMITER_TABLE_SIZE> buckets{};
+	Stats stats{};
+	uint16_t burst;
+	uint32_t interval;
+};
+
+} // namespace Network
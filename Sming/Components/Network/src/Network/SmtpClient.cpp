@@ -17,6 +17,7 @@
  */
 
 #include "SmtpClient.h"
+#include "Http/HttpCommon.h"
 #include <Data/WebHelpers/base64.h>
 #include <Data/Stream/QuotedPrintableOutputStream.h>
 #include <Data/Stream/Base64OutputStream.h>
@@ -65,6 +66,8 @@ SmtpClient::~SmtpClient()
 {
 	delete outgoingMail;
 	outgoingMail = nullptr;
+	delete sentMail;
+	sentMail = nullptr;
 
 	while(mailQ.count() != 0) {
 		delete mailQ.dequeue();
@@ -108,7 +111,7 @@ bool SmtpClient::send(const String& from, const String& to, const String& subjec
 
 MailMessage* SmtpClient::getCurrentMessage()
 {
-	return outgoingMail;
+	return sentMail ?: outgoingMail;
 }
 
 bool SmtpClient::send(MailMessage* mail)
@@ -119,6 +122,11 @@ bool SmtpClient::send(MailMessage* mail)
 		return false;
 	}
 
+	if(state == eSMTP_Ready && getConnectionState() == eTCS_Connected) {
+		// Don't wait for the next poll
+		trySend(eTCE_Poll);
+	}
+
 	return true;
 }
 
@@ -200,19 +208,12 @@ void SmtpClient::onReadyToSendData(TcpConnectionEvent sourceEvent)
 	}
 
 	case eSMTP_SendMail: {
-		sendString(F("MAIL FROM:") + outgoingMail->from + "\r\n");
-		if(options & SMTP_OPT_PIPELINE) {
-			sendString(F("RCPT TO:") + outgoingMail->to + "\r\n");
-			sendString(F("DATA\r\n"));
-		}
-
-		state = eSMTP_SendingMail;
+		sendMailCommands();
 		break;
 	}
 
 	case eSMTP_SendRcpt: {
-		sendString(F("RCPT TO:") + outgoingMail->to + "\r\n");
-		state = eSMTP_SendingRcpt;
+		sendRecipient();
 		break;
 	}
 
@@ -249,7 +250,15 @@ void SmtpClient::onReadyToSendData(TcpConnectionEvent sourceEvent)
 		delete stream;
 		stream = nullptr;
 
-		sendString(F("\r\n.\r\n"));
+		String dot = F("\r\n.\r\n");
+		if((options & SMTP_OPT_PIPELINE) && mailQ.count() != 0) {
+			// Start the next message without waiting for this one to be accepted (RFC 2920)
+			sentMail = outgoingMail;
+			outgoingMail = mailQ.dequeue();
+			sendMailCommands(dot);
+		} else {
+			sendString(dot);
+		}
 		break;
 	}
 
@@ -265,6 +274,56 @@ void SmtpClient::onReadyToSendData(TcpConnectionEvent sourceEvent)
 	TcpClient::onReadyToSendData(sourceEvent);
 }
 
+void SmtpClient::sendMailCommands(const String& prefix)
+{
+	String list = outgoingMail->to;
+	if(outgoingMail->cc) {
+		list += ',';
+		list += outgoingMail->cc;
+	}
+	splitString(list, ',', recipients);
+	for(unsigned i = 0; i < recipients.count();) {
+		recipients[i].trim();
+		if(recipients[i]) {
+			++i;
+		} else {
+			recipients.remove(i);
+		}
+	}
+	rcptCount = 0;
+
+	String cmd = prefix;
+	cmd += F("MAIL FROM:");
+	cmd += outgoingMail->from;
+	cmd += "\r\n";
+	if(options & SMTP_OPT_PIPELINE) {
+		for(auto& rcpt : recipients) {
+			cmd += F("RCPT TO:");
+			cmd += rcpt;
+			cmd += "\r\n";
+		}
+		cmd += F("DATA\r\n");
+	}
+	sendString(cmd);
+
+	state = eSMTP_SendingMail;
+}
+
+void SmtpClient::sendRecipient()
+{
+	sendString(F("RCPT TO:") + recipients[rcptCount] + "\r\n");
+	state = eSMTP_SendingRcpt;
+}
+
+void SmtpClient::messageSent()
+{
+	if(messageSentCallback) {
+		messageSentCallback(*this, codeValue, message);
+	}
+	delete sentMail;
+	sentMail = nullptr;
+}
+
 MultipartStream::BodyPart SmtpClient::multipartProducer()
 {
 	MultipartStream::BodyPart result;
@@ -286,6 +345,13 @@ void SmtpClient::sendMailHeaders(MailMessage* mail)
 {
 	mail->getHeaders();
 
+	if(!mail->headers.contains(HTTP_HEADER_DATE)) {
+		String date = httpGetCurrentDate();
+		if(date) {
+			mail->headers[HTTP_HEADER_DATE] = date;
+		}
+	}
+
 	if(!mail->headers.contains(HTTP_HEADER_CONTENT_TRANSFER_ENCODING)) {
 		mail->headers[HTTP_HEADER_CONTENT_TRANSFER_ENCODING] = _F("quoted-printable");
 		mail->stream = new QuotedPrintableOutputStream(mail->stream);
@@ -385,6 +451,13 @@ int SmtpClient::smtpParse(char* buffer, size_t len)
 		codeLength = 0;
 		int lineLength = (buffer - line) - 2;
 
+		if(sentMail != nullptr) {
+			// Pipelined reply for the previous message, ahead of those for the current one
+			RETURN_ON_ERROR(SMTP_CODE_REQUEST_OK);
+			messageSent();
+			continue;
+		}
+
 		switch(state) {
 		case eSMTP_Banner: {
 			RETURN_ON_ERROR(SMTP_CODE_SERVICE_READY);
@@ -447,18 +520,20 @@ int SmtpClient::smtpParse(char* buffer, size_t len)
 			break;
 		}
 
-		case eSMTP_SendingMail: {
-			RETURN_ON_ERROR(SMTP_CODE_REQUEST_OK);
-
-			state = ((options & SMTP_OPT_PIPELINE) ? eSMTP_SendingRcpt : eSMTP_SendRcpt);
-
-			break;
-		}
-
+		case eSMTP_SendingMail:
 		case eSMTP_SendingRcpt: {
 			RETURN_ON_ERROR(SMTP_CODE_REQUEST_OK);
 
-			state = ((options & SMTP_OPT_PIPELINE) ? eSMTP_SendingData : eSMTP_SendData);
+			if(state == eSMTP_SendingRcpt) {
+				++rcptCount;
+			}
+
+			bool pipeline = (options & SMTP_OPT_PIPELINE);
+			if(rcptCount < recipients.count()) {
+				state = pipeline ? eSMTP_SendingRcpt : eSMTP_SendRcpt;
+			} else {
+				state = pipeline ? eSMTP_SendingData : eSMTP_SendData;
+			}
 
 			break;
 		}
@@ -474,11 +549,10 @@ int SmtpClient::smtpParse(char* buffer, size_t len)
 
 			state = eSMTP_Ready;
 
-			if(messageSentCallback) {
-				messageSentCallback(*this, codeValue, message);
-			}
-			delete outgoingMail;
+			// Callback may queue another message
+			sentMail = outgoingMail;
 			outgoingMail = nullptr;
+			messageSent();
 
 			break;
 		}
@@ -7,7 +7,7 @@
  * SmtpClient.h - Asynchronous SmtpClient that supports the following features:
  *
  * - extended HELO command set
- * - support for PIPELINING
+ * - support for PIPELINING, including the start of the next queued message
  * - support for STARTTLS (if the directive ENABLE_SSL=1 is set)
  * - support for smtp connection over SSL (if the directive ENABLE_SSL=1 is set)
  * - support for PLAIN and CRAM-MD5 authentication
@@ -108,6 +108,9 @@ public:
 	/**
 	 * @brief Queues a single message before it is sent later to the SMTP server
 	 *
+	 * Messages are sent one after another over the same connection.
+	 * Recipients are taken from both the `to` and `cc` fields, which may contain comma-separated lists.
+	 *
 	 * @param from
 	 * @param to
 	 * @param subject
@@ -132,6 +135,7 @@ public:
 	 * @brief Gets the current message
 	 *
 	 * @retval MailMessage* The message, or NULL if none is scheduled
+	 * @note Within the `onMessageSent` callback this is the message which has just been accepted
 	 */
 	MailMessage* getCurrentMessage();
 
@@ -182,6 +186,16 @@ protected:
 	void sendMailHeaders(MailMessage* mail);
 	bool sendMailBody(MailMessage* mail);
 
+	/**
+	 * @brief Start sending the outgoing message
+	 * @param prefix Data to send ahead of the commands
+	 *
+	 * With PIPELINING, the MAIL, RCPT and DATA commands are all sent together.
+	 */
+	void sendMailCommands(const String& prefix = nullptr);
+	void sendRecipient();
+	void messageSent();
+
 private:
 	Url url;
 	Vector<String> authMethods;
@@ -194,6 +208,9 @@ private:
 	uint8_t codeLength{0};
 	int options{0};
 	MailMessage* outgoingMail{nullptr};
+	MailMessage* sentMail{nullptr}; ///< Waiting for acceptance whilst the next message is started
+	Vector<String> recipients;
+	uint8_t rcptCount{0}; ///< Number of RCPT TO replies received
 	SmtpState state{eSMTP_Banner};
 
 	SmtpClientCallback errorCallback;
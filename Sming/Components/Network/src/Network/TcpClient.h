@@ -23,7 +23,7 @@ class IpAddress;
 
 using TcpClientEventDelegate = Delegate<void(TcpClient& client, TcpConnectionEvent sourceEvent)>;
 using TcpClientCompleteDelegate = Delegate<void(TcpClient& client, bool successful)>;
-using TcpClientDataDelegate = Delegate<bool(TcpClient& client, char* data, int size)>;
+using TcpClientDataDelegate = InplaceDelegate<bool(TcpClient& client, char* data, int size)>;
 
 enum TcpClientState {
 	eTCS_Ready,
@@ -47,31 +47,31 @@ class TcpClient : public TcpConnection
 public:
 	TcpClient(bool autoDestruct) : TcpConnection(autoDestruct)
 	{
-		TcpConnection::timeOut = TCP_CLIENT_TIMEOUT;
+		setTimeOut(TCP_CLIENT_TIMEOUT);
 	}
 
 	TcpClient(tcp_pcb* clientTcp, TcpClientDataDelegate clientReceive, TcpClientCompleteDelegate onCompleted)
 		: TcpConnection(clientTcp, true), state(eTCS_Connected), completed(onCompleted), receive(clientReceive)
 	{
-		TcpConnection::timeOut = TCP_CLIENT_TIMEOUT;
+		setTimeOut(TCP_CLIENT_TIMEOUT);
 	}
 
 	TcpClient(TcpClientCompleteDelegate onCompleted, TcpClientEventDelegate onReadyToSend,
 			  TcpClientDataDelegate onReceive = nullptr)
 		: TcpConnection(false), completed(onCompleted), ready(onReadyToSend), receive(onReceive)
 	{
-		TcpConnection::timeOut = TCP_CLIENT_TIMEOUT;
+		setTimeOut(TCP_CLIENT_TIMEOUT);
 	}
 
 	TcpClient(TcpClientCompleteDelegate onCompleted, TcpClientDataDelegate onReceive = nullptr)
 		: TcpConnection(false), completed(onCompleted), receive(onReceive)
 	{
-		TcpConnection::timeOut = TCP_CLIENT_TIMEOUT;
+		setTimeOut(TCP_CLIENT_TIMEOUT);
 	}
 
 	explicit TcpClient(TcpClientDataDelegate onReceive) : TcpConnection(false), receive(onReceive)
 	{
-		TcpConnection::timeOut = TCP_CLIENT_TIMEOUT;
+		setTimeOut(TCP_CLIENT_TIMEOUT);
 	}
 
 	~TcpClient()
@@ -91,6 +91,14 @@ public:
 		receive = receiveCb;
 	}
 
+	/**	@brief	Set or clear the callback for when connection is ready to send more data
+	 *	@param	readyCb callback delegate or nullptr
+	 */
+	void setReadyToSendDelegate(TcpClientEventDelegate readyCb = nullptr)
+	{
+		ready = readyCb;
+	}
+
 	/**	@brief	Set or clear the callback for connection close
 	 *	@param	completeCb callback delegate or nullptr
 	 */
@@ -118,6 +126,14 @@ public:
 	 */
 	bool send(IDataSourceStream* source, bool forceCloseAfterSent = false);
 
+	/**
+	 * @brief Determine if there is outgoing data which has not yet been written to the connection
+	 */
+	bool isSending() const
+	{
+		return stream != nullptr;
+	}
+
 	bool isProcessing()
 	{
 		return state == eTCS_Connected || state == eTCS_Connecting;
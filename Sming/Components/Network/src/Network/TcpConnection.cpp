@@ -12,7 +12,10 @@
 #include <Network/Ssl/Factory.h>
 #include <Data/Stream/DataSourceStream.h>
 #include "NetUtils.h"
+#include "DnsResolver.h"
+#include "NetworkMetrics.h"
 #include <WString.h>
+#include <Platform/System.h>
 #include <lwip/dns.h>
 
 #define debug_tcp_e(fmt, ...) debug_e("TCP %p " fmt, this, ##__VA_ARGS__)
@@ -20,12 +23,33 @@
 #define debug_tcp_i(fmt, ...) debug_i("TCP %p " fmt, this, ##__VA_ARGS__)
 #define debug_tcp_d(fmt, ...) debug_d("TCP %p " fmt, this, ##__VA_ARGS__)
 
+#ifndef TCP_SLOW_INTERVAL
+// Defined in private lwIP headers, the value is the same in all versions
+#define TCP_SLOW_INTERVAL 500
+#endif
+
+#if LWIP_PROFILE != LWIP_PROFILE_DEFAULT
+LWIP_PROFILE_CHECK();
+#endif
+
+namespace Network::Metrics
+{
+METRIC_COUNTER(tcpBytesReceived, "sming_tcp_received_bytes_total", "Bytes received over TCP connections");
+METRIC_COUNTER(tcpBytesSent, "sming_tcp_sent_bytes_total", "Bytes passed to the TCP stack for sending");
+} // namespace Network::Metrics
+
 #ifdef DEBUG_TCP_EXTENDED
 #define debug_tcp_ext(fmt, ...) debug_tcp_d(fmt, ##__VA_ARGS__)
 #else
 #define debug_tcp_ext(fmt, ...) debug_none(fmt, ##__VA_ARGS__)
 #endif
 
+struct TcpConnection::SslDeferredInput {
+	TcpConnection* connection; ///< nullptr if connection has gone
+	pbuf* buf;
+	Ssl::InputBuffer input;
+};
+
 TcpConnection::~TcpConnection()
 {
 	autoSelfDestruct = false;
@@ -71,8 +95,6 @@ bool TcpConnection::connect(const String& server, int port, bool useSsl)
 		initialize(tcpNew);
 	}
 
-	ip_addr_t addr;
-
 	this->useSsl = useSsl;
 	if(useSsl) {
 		if(!sslCreateSession()) {
@@ -84,26 +106,14 @@ bool TcpConnection::connect(const String& server, int port, bool useSsl)
 	debug_tcp_d("connect to \"%s:%d\"", server.c_str(), port);
 	canSend = false; // Wait for connection
 
-	struct DnsLookup {
-		TcpConnection* con;
-		int port;
-	};
-	DnsLookup* look = new DnsLookup{this, port};
-	err_t dnslook = dns_gethostbyname(
-		server.c_str(), &addr,
-		[](const char* name, LWIP_IP_ADDR_T* ipaddr, void* arg) {
-			auto dlook = static_cast<DnsLookup*>(arg);
-			if(dlook != nullptr) {
-				dlook->con->internalOnDnsResponse(name, ipaddr, dlook->port);
-				delete dlook;
-			}
-		},
-		look);
+	IpAddress addr;
+	err_t dnslook = DnsResolver.resolve(server, addr, [this, port](const String& name, const IpAddress* ipaddr) {
+		internalOnDnsResponse(name.c_str(), ipaddr, port);
+	});
 	if(dnslook == ERR_INPROGRESS) {
 		// Operation pending - see internalOnDnsResponse()
 		return true;
 	}
-	delete look;
 
 	return (dnslook == ERR_OK) ? internalConnect(addr, port) : false;
 }
@@ -126,6 +136,37 @@ void TcpConnection::setTimeOut(uint16_t waitTimeOut)
 {
 	debug_tcp_d("timeout updating: %d -> %d", timeOut, waitTimeOut);
 	timeOut = waitTimeOut;
+	startIdleTimer();
+}
+
+void TcpConnection::startIdleTimer()
+{
+	if(tcp == nullptr || timeOut == USHRT_MAX) {
+		idleTimer.stop();
+		return;
+	}
+
+	// Activity only updates the timestamp, so timer is re-armed for the remainder on expiry
+	uint32_t limit = uint32_t(timeOut) * TCP_POLL_INTERVAL_MS;
+	uint32_t idle = getIdleMillis();
+	idleTimer.initializeMs(limit > idle ? limit - idle : 0, staticOnIdleTimeout, this);
+	idleTimer.startOnce();
+}
+
+void TcpConnection::staticOnIdleTimeout(void* arg)
+{
+	auto con = static_cast<TcpConnection*>(arg);
+	if(con->tcp == nullptr) {
+		return;
+	}
+
+	if(con->getIdleMillis() < uint32_t(con->timeOut) * TCP_POLL_INTERVAL_MS) {
+		con->startIdleTimer();
+		return;
+	}
+
+	debug_d("TCP %p connection closed by timeout: %u (from %u)", con, con->getIdleTime(), con->timeOut);
+	con->close();
 }
 
 err_t TcpConnection::onReceive(pbuf* buf)
@@ -140,6 +181,37 @@ err_t TcpConnection::onReceive(pbuf* buf)
 	return ERR_OK;
 }
 
+void TcpConnection::releaseReceive()
+{
+	receiveHeld = false;
+	if(!manualReceiveAck) {
+		acknowledgeReceive(heldReceiveBytes);
+	}
+}
+
+void TcpConnection::setManualReceiveAck(bool enable)
+{
+	manualReceiveAck = enable;
+	if(!enable && !receiveHeld) {
+		acknowledgeReceive(heldReceiveBytes);
+	}
+}
+
+void TcpConnection::acknowledgeReceive(size_t length)
+{
+	if(tcp == nullptr) {
+		heldReceiveBytes = 0;
+		return;
+	}
+	length = std::min(length, size_t(heldReceiveBytes));
+	heldReceiveBytes -= length;
+	while(length != 0) {
+		auto len = std::min(length, size_t(UINT16_MAX));
+		tcp_recved(tcp, len);
+		length -= len;
+	}
+}
+
 err_t TcpConnection::onSent(uint16_t len)
 {
 	debug_tcp_d("sent: %u", len);
@@ -154,13 +226,6 @@ err_t TcpConnection::onSent(uint16_t len)
 
 err_t TcpConnection::onPoll()
 {
-	if(sleep >= timeOut && timeOut != USHRT_MAX) {
-		debug_tcp_d("connection closed by timeout: %d (from %d)", sleep, timeOut);
-
-		close();
-		return ERR_TIMEOUT;
-	}
-
 	trySend(eTCE_Poll);
 
 	return ERR_OK;
@@ -210,13 +275,20 @@ int TcpConnection::write(const char* data, int len, uint8_t apiflags)
 		u16_t available = getAvailableWriteSize();
 		if(available < len) {
 			if(available == 0) {
+				++stats.writeRefusals;
 				return ERR_MEM;
 			}
 
 			len = available;
 		}
 
+		if(corked) {
+			apiflags |= TCP_WRITE_FLAG_MORE;
+		}
 		err = tcp_write(tcp, data, len, apiflags);
+		if(err == ERR_OK) {
+			Network::Metrics::tcpBytesSent.add(len);
+		}
 	}
 
 	if(err < 0) {
@@ -224,6 +296,9 @@ int TcpConnection::write(const char* data, int len, uint8_t apiflags)
 		return err;
 	}
 
+	if(len > 0) {
+		++stats.writeCount;
+	}
 	debug_tcp_ext("connection send: %d", len);
 	return len;
 }
@@ -235,39 +310,46 @@ int TcpConnection::write(IDataSourceStream* stream)
 		return 0;
 	}
 
-	// Send data from DataStream
+	// Send data from DataStream, limited to our share when other connections are also sending
+	size_t quota = TcpSendScheduler::getQuota(*this);
 	size_t total = 0;
 	unsigned pushCount = 0;
 	while((tcp_sndqueuelen(tcp) < TCP_SND_QUEUELEN) && !stream->isFinished() && (pushCount < 25)) {
-		size_t available = getAvailableWriteSize();
+		size_t available = std::min(size_t(getAvailableWriteSize()), quota - total);
 		if(available == 0) {
 			break;
 		}
 
-		char buffer[NETWORK_SEND_BUFFER_SIZE];
-		auto bytesRead = stream->readMemoryBlock(buffer, std::min(sizeof(buffer), available));
-		if(bytesRead == 0) {
-			break;
+		// Memory-based streams give us their content directly, otherwise read into a local buffer
+		const char* data;
+		size_t len = stream->peekRegion(data);
+		int bytesWritten;
+		if(len != 0) {
+			// Only the final part of a stream should be pushed immediately
+			len = std::min(len, available);
+			uint8_t apiflags = TCP_WRITE_FLAG_COPY;
+			if(stream->available() != int(len)) {
+				apiflags |= TCP_WRITE_FLAG_MORE;
+			}
+			bytesWritten = write(data, len, apiflags);
+		} else {
+			bytesWritten = writeBuffered(stream, available);
 		}
-
 		++pushCount;
 
-		int bytesWritten = write(buffer, bytesRead, TCP_WRITE_FLAG_COPY | TCP_WRITE_FLAG_MORE);
 		debug_tcp_d("Written: %d, Available: %u, isFinished: %d, PushCount: %u", bytesWritten, available,
 					stream->isFinished(), pushCount);
 
-		if(bytesWritten < 0) {
+		if(bytesWritten <= 0) {
 			break;
 		}
 
-		if(bytesWritten == 0) {
-			continue;
-		}
-
 		total += size_t(bytesWritten);
 		stream->seek(bytesWritten);
 	}
 
+	TcpSendScheduler::update(*this, total, stream->isFinished());
+
 	if(pushCount == 0) {
 		debug_tcp_d("WAIT FOR FREE SPACE");
 	} else {
@@ -277,8 +359,22 @@ int TcpConnection::write(IDataSourceStream* stream)
 	return total;
 }
 
+int TcpConnection::writeBuffered(IDataSourceStream* stream, size_t maxLen)
+{
+	char buffer[NETWORK_SEND_BUFFER_SIZE];
+	auto bytesRead = stream->readMemoryBlock(buffer, std::min(sizeof(buffer), maxLen));
+	if(bytesRead == 0) {
+		return 0;
+	}
+
+	return write(buffer, bytesRead, TCP_WRITE_FLAG_COPY | TCP_WRITE_FLAG_MORE);
+}
+
 void TcpConnection::close()
 {
+	sslCancelDeferred();
+	TcpSendScheduler::remove(*this);
+
 	if(ssl != nullptr) {
 		ssl->close();
 	}
@@ -288,6 +384,8 @@ void TcpConnection::close()
 	}
 	debug_tcp_d("connection closing");
 
+	idleTimer.stop();
+
 	tcp_poll(tcp, staticOnPoll, 1);
 	tcp_arg(tcp, nullptr); // reset pointer to close connection on next callback
 	tcp = nullptr;
@@ -297,15 +395,35 @@ void TcpConnection::close()
 	checkSelfFree();
 }
 
+bool TcpConnection::getStackInfo(StackInfo& info) const
+{
+	info = StackInfo{};
+	if(tcp == nullptr) {
+		return false;
+	}
+
+	// lwIP keeps the smoothed RTT scaled by 8, in slow timer ticks
+	info.rtt = uint32_t(std::max(tcp->sa, s16_t(0)) >> 3) * TCP_SLOW_INTERVAL;
+	info.rto = uint32_t(std::max(tcp->rto, s16_t(0))) * TCP_SLOW_INTERVAL;
+	info.cwnd = tcp->cwnd;
+	info.sendWindow = tcp->snd_wnd;
+	info.sendQueue = tcp_sndqueuelen(tcp);
+	info.retransmits = tcp->nrtx;
+	return true;
+}
+
 void TcpConnection::initialize(tcp_pcb* pcb)
 {
 	assert(pcb != nullptr);
 
 	tcp = pcb;
-	sleep = 0;
+	touch();
 	canSend = true;
+	receiveHeld = false;
+	heldReceiveBytes = 0;
+	lastRetransmits = 0;
 
-	tcp_nagle_disable(tcp);
+	updateNagle();
 	tcp_arg(tcp, this);
 
 	tcp_sent(tcp, [](void* arg, tcp_pcb* tcp, uint16_t len) -> err_t {
@@ -338,6 +456,7 @@ void TcpConnection::initialize(tcp_pcb* pcb)
 	});
 
 	tcp_poll(tcp, staticOnPoll, 4);
+	startIdleTimer();
 
 #ifdef NETWORK_DEBUG
 	debug_tcp_d("+connection");
@@ -376,12 +495,49 @@ void TcpConnection::closeTcpConnection(tcp_pcb* tpcb)
 
 void TcpConnection::flush()
 {
+	if(corked) {
+		return;
+	}
 	if(tcp && tcp->state == ESTABLISHED) {
 		debug_tcp_ext("flush()");
 		tcp_output(tcp);
 	}
 }
 
+void TcpConnection::setNoDelay(bool enable)
+{
+	noDelay = enable;
+	updateNagle();
+}
+
+void TcpConnection::cork()
+{
+	corked = true;
+	updateNagle();
+}
+
+void TcpConnection::uncork()
+{
+	if(!corked) {
+		return;
+	}
+	corked = false;
+	updateNagle();
+	flush();
+}
+
+void TcpConnection::updateNagle()
+{
+	if(tcp == nullptr) {
+		return;
+	}
+	if(noDelay && !corked) {
+		tcp_nagle_disable(tcp);
+	} else {
+		tcp_nagle_enable(tcp);
+	}
+}
+
 bool TcpConnection::internalConnect(IpAddress addr, uint16_t port)
 {
 	NetUtils::FixNetworkRouting();
@@ -425,7 +581,7 @@ err_t TcpConnection::internalOnConnected(err_t err)
 
 err_t TcpConnection::internalOnReceive(pbuf* p, err_t err)
 {
-	sleep = 0;
+	touch();
 
 	if(err != ERR_OK /*&& err != ERR_CLSD && err != ERR_RST*/) {
 		debug_tcp_d("receive ERROR %d", err);
@@ -445,41 +601,38 @@ err_t TcpConnection::internalOnReceive(pbuf* p, err_t err)
 	//if (tcp != nullptr && tcp->state == ESTABLISHED) // If active
 	/* We have taken the data. */
 	if(p != nullptr) {
-		tcp_recved(tcp, p->tot_len);
+		if(receiveHeld || manualReceiveAck) {
+			heldReceiveBytes += p->tot_len;
+		} else {
+			tcp_recved(tcp, p->tot_len);
+		}
+		if(quickAck) {
+			// Equivalent to private tcp_ack_now(), ACK is sent when the stack processes output after this callback
+			tcp->flags |= TF_ACK_NOW;
+		}
+		Network::Metrics::tcpBytesReceived.add(p->tot_len);
+		stats.bytesReceived += p->tot_len;
+		++stats.receiveCount;
 	} else {
 		debug_tcp_d("receive: pbuf is NULL");
 	}
 
 	if(ssl != nullptr && p != nullptr) {
-		bool isConnecting = !ssl->isConnected();
+		if(sslDeferred != nullptr) {
+			// Earlier data is still being processed, so queue behind it
+			pbuf_cat(sslDeferred->buf, p);
+			return ERR_OK;
+		}
 
 		Ssl::InputBuffer input(p);
-
-		pbuf pbufOut = {};
-		while(input.available() > 0) {
-			uint8_t* output;
-			int len = ssl->read(input, output);
-			if(len < 0) {
-				close();
-				closeTcpConnection(tcp);
-				return ERR_ABRT;
-			}
-
-			if(isConnecting && ssl->isConnected()) {
-				err = onConnected(ERR_OK);
-			} else if(len != 0) {
-				// Proceed with received decrypted data
-				pbufOut.payload = output;
-				pbufOut.tot_len = len;
-				pbufOut.len = len;
-				err = onReceive(&pbufOut);
-			}
-
-			if(err < 0) {
-				break;
-			}
+		bool retained;
+		err = sslReceive(p, input, retained);
+		if(err == ERR_ABRT) {
+			return ERR_ABRT;
+		}
+		if(retained) {
+			return err;
 		}
-
 	} else {
 		err = onReceive(p);
 	}
@@ -495,9 +648,123 @@ err_t TcpConnection::internalOnReceive(pbuf* p, err_t err)
 	return err;
 }
 
+/*
+ * Pass received data through the SSL session.
+ * If the handshake yields part way through then processing continues from the task queue,
+ * in which case `retained` is set and `p` must not be freed.
+ */
+err_t TcpConnection::sslReceive(pbuf* p, Ssl::InputBuffer& input, bool& retained)
+{
+	retained = false;
+	err_t err;
+	bool deferred;
+	do {
+		err = sslProcessInput(input, deferred);
+		if(err == ERR_ABRT) {
+			return err;
+		}
+		if(deferred && sslDefer(p, input)) {
+			retained = true;
+			break;
+		}
+		// If the callback couldn't be queued just carry on
+	} while(deferred);
+
+	return err;
+}
+
+err_t TcpConnection::sslProcessInput(Ssl::InputBuffer& input, bool& deferred)
+{
+	deferred = false;
+	bool isConnecting = !ssl->isConnected();
+	err_t err = ERR_OK;
+
+	pbuf pbufOut = {};
+	while(input.available() > 0) {
+		uint8_t* output;
+		int len = ssl->read(input, output);
+		if(len < 0) {
+			close();
+			closeTcpConnection(tcp);
+			return ERR_ABRT;
+		}
+
+		if(isConnecting && ssl->isConnected()) {
+			isConnecting = false;
+			err = onConnected(ERR_OK);
+		} else if(len != 0) {
+			// Decrypted data is passed on in place, from the SSL engine's buffer
+			pbufOut.payload = output;
+			pbufOut.tot_len = len;
+			pbufOut.len = len;
+			err = onReceive(&pbufOut);
+		} else if(isConnecting && input.available() > 0) {
+			// Handshake has yielded to let other tasks run
+			deferred = true;
+			break;
+		}
+
+		if(err < 0) {
+			break;
+		}
+	}
+
+	return err;
+}
+
+bool TcpConnection::sslDefer(pbuf* p, const Ssl::InputBuffer& input)
+{
+	auto deferred = new SslDeferredInput{this, p, input};
+	if(deferred == nullptr) {
+		return false;
+	}
+	if(!System.queueCallback(staticOnSslResume, deferred)) {
+		delete deferred;
+		return false;
+	}
+	sslDeferred = deferred;
+	return true;
+}
+
+void TcpConnection::sslCancelDeferred()
+{
+	// Pending callback will release the data
+	if(sslDeferred != nullptr) {
+		sslDeferred->connection = nullptr;
+		sslDeferred = nullptr;
+	}
+}
+
+void TcpConnection::staticOnSslResume(void* param)
+{
+	auto deferred = static_cast<SslDeferredInput*>(param);
+	auto con = deferred->connection;
+	auto p = deferred->buf;
+	auto input = deferred->input;
+	delete deferred;
+
+	if(con == nullptr) {
+		pbuf_free(p);
+		return;
+	}
+
+	con->sslDeferred = nullptr;
+	con->touch();
+	bool retained;
+	err_t err = con->sslReceive(p, input, retained);
+	if(retained) {
+		return;
+	}
+	pbuf_free(p);
+	if(err != ERR_ABRT) {
+		con->checkSelfFree();
+	}
+}
+
 err_t TcpConnection::internalOnSent(uint16_t len)
 {
-	sleep = 0;
+	touch();
+	stats.bytesAcked += len;
 	err_t res = onSent(len);
 	checkSelfFree();
 	debug_tcp_ext("<sent");
@@ -518,7 +785,14 @@ err_t TcpConnection::staticOnPoll(void* arg, tcp_pcb* tcp)
 
 err_t TcpConnection::internalOnPoll()
 {
-	sleep++;
+	if(tcp != nullptr) {
+		// Sampled, so retransmissions may be missed if the segment is acknowledged between polls
+		if(tcp->nrtx > lastRetransmits) {
+			stats.retransmitCount += tcp->nrtx - lastRetransmits;
+		}
+		lastRetransmits = tcp->nrtx;
+	}
+
 	err_t res = onPoll();
 	if(res == ERR_OK) {
 		checkSelfFree();
@@ -530,18 +804,18 @@ err_t TcpConnection::internalOnPoll()
 void TcpConnection::internalOnError(err_t err)
 {
 	tcp = nullptr; // IMPORTANT. No available connection after error!
+	idleTimer.stop();
 	onError(err);
 	checkSelfFree();
 	debug_tcp_ext("<error");
 }
 
-void TcpConnection::internalOnDnsResponse(const char* name, LWIP_IP_ADDR_T* ipaddr, int port)
+void TcpConnection::internalOnDnsResponse(const char* name, const IpAddress* ipaddr, int port)
 {
 	if(ipaddr != nullptr) {
-		IpAddress ip = *ipaddr;
-		debug_tcp_d("DNS record found: %s = %s", name, ip.toString().c_str());
+		debug_tcp_d("DNS record found: %s = %s", name, ipaddr->toString().c_str());
 
-		internalConnect(ip, port);
+		internalConnect(*ipaddr, port);
 	} else {
 #ifdef NETWORK_DEBUG
 		debug_tcp_d("DNS record _not_ found: %s", name);
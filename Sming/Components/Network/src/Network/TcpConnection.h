@@ -17,12 +17,22 @@
 
 #include <Network/IpConnection.h>
 #include <Network/Ssl/Session.h>
+#include <Network/TcpSendScheduler.h>
+#include <WheelTimer.h>
+#include <Clock.h>
 #include <lwip/tcp.h>
+#include <Data/IntrusiveList.h>
 
 #define NETWORK_DEBUG
 
 #define NETWORK_SEND_BUFFER_SIZE 1024
 
+/**
+ * @brief Interval between TCP poll callbacks, in milliseconds
+ * @note Connection timeouts and idle times are expressed in these units
+ */
+#define TCP_POLL_INTERVAL_MS 2000
+
 enum TcpConnectionEvent {
 	eTCE_Connected = 0, ///< Occurs after connection establishment
 	eTCE_Received,		///< Occurs on data receive
@@ -33,12 +43,37 @@ enum TcpConnectionEvent {
 class String;
 class IDataSourceStream;
 class TcpConnection;
+class TcpServer;
 
 using TcpConnectionDestroyedDelegate = Delegate<void(TcpConnection&)>;
 
-class TcpConnection : public IpConnection
+class TcpConnection : public IpConnection, public IntrusiveListHook<TcpServer>
 {
 public:
+	/**
+	 * @brief Traffic counters, maintained for the lifetime of the connection object
+	 */
+	struct Stats {
+		uint32_t bytesReceived;   ///< TCP payload received, including any SSL overhead
+		uint32_t bytesAcked;	  ///< TCP payload sent and acknowledged by the peer
+		uint32_t receiveCount;	///< Number of received packet buffers passed up by the stack
+		uint32_t writeCount;	  ///< Number of successful write() calls
+		uint32_t writeRefusals;   ///< Writes refused because the send buffer was full
+		uint32_t retransmitCount; ///< Retransmissions, sampled at each poll interval
+	};
+
+	/**
+	 * @brief Current state of the connection as estimated by the TCP stack
+	 */
+	struct StackInfo {
+		uint32_t rtt;		  ///< Smoothed round-trip time in milliseconds, 0 if not yet measured
+		uint32_t rto;		  ///< Retransmission timeout in milliseconds
+		uint32_t cwnd;		  ///< Congestion window in bytes
+		uint32_t sendWindow;  ///< Window advertised by the peer
+		uint16_t sendQueue;   ///< Segments queued for sending or awaiting acknowledgement
+		uint8_t retransmits; ///< Retransmissions of the current unacknowledged segment
+	};
+
 	TcpConnection(bool autoDestruct) : autoSelfDestruct(autoDestruct)
 	{
 	}
@@ -99,10 +134,134 @@ public:
 		return (canSend && tcp) ? tcp_sndbuf(tcp) : 0;
 	}
 
+	/**
+	 * @brief Send any queued data now
+	 * @note Has no effect whilst corked
+	 */
 	void flush();
 
+	/**
+	 * @brief Control Nagle's algorithm
+	 * @param enable true (the default) sends small segments immediately.
+	 * false lets the stack coalesce small writes whilst earlier data is unacknowledged.
+	 */
+	void setNoDelay(bool enable);
+
+	bool getNoDelay() const
+	{
+		return noDelay;
+	}
+
+	/**
+	 * @brief Acknowledge received data immediately rather than delaying the ACK
+	 *
+	 * Reduces latency for small request/response exchanges, where a delayed ACK
+	 * can hold up the peer's next transmission, at the cost of additional packets.
+	 */
+	void setQuickAck(bool enable)
+	{
+		quickAck = enable;
+	}
+
+	bool getQuickAck() const
+	{
+		return quickAck;
+	}
+
+	/**
+	 * @brief Hold back output so a sequence of writes is sent as full segments
+	 *
+	 * Whilst corked, writes are queued as if TCP_WRITE_FLAG_MORE were given and flush() has no effect,
+	 * including for stream sends. Nagle's algorithm is also applied so the stack does not send
+	 * partial segments when acknowledgements arrive.
+	 *
+	 * @note SSL records are still sent as they are produced
+	 */
+	void cork();
+
+	/**
+	 * @brief Restore normal operation after cork() and send any queued data
+	 */
+	void uncork();
+
+	bool isCorked() const
+	{
+		return corked;
+	}
+
+	/**
+	 * @brief Set the idle timeout
+	 * @param waitTimeOut Number of poll intervals without activity before the connection is closed.
+	 * Use USHRT_MAX to disable.
+	 * @note Timeouts are serviced by a shared WheelTimer so idle connections cost nothing until they expire
+	 */
 	void setTimeOut(uint16_t waitTimeOut);
 
+	/**
+	 * @brief Get time since data was last sent or received
+	 * @retval uint16_t Number of elapsed poll intervals
+	 */
+	uint16_t getIdleTime() const
+	{
+		return std::min(getIdleMillis() / TCP_POLL_INTERVAL_MS, uint32_t(USHRT_MAX));
+	}
+
+	/**
+	 * @brief Stop acknowledging received data to the TCP stack
+	 *
+	 * Received data is still delivered, but the advertised receive window closes as it arrives
+	 * so the peer stops sending once the window is full. Use this to apply back-pressure when
+	 * a consumer is busy, such as writing a download to flash.
+	 *
+	 * @note Up to one TCP window of data already in flight may still be received.
+	 */
+	void holdReceive()
+	{
+		receiveHeld = true;
+	}
+
+	/**
+	 * @brief Acknowledge any data received whilst held and resume normal operation
+	 * @note In manual acknowledgement mode data remains unacknowledged until acknowledgeReceive() is called
+	 */
+	void releaseReceive();
+
+	bool isReceiveHeld() const
+	{
+		return receiveHeld;
+	}
+
+	/**
+	 * @brief Leave acknowledgement of received data to the application
+	 *
+	 * Received data is delivered as normal, but the receive window only reopens as the application
+	 * calls acknowledgeReceive(). If a downstream stage is busy, e.g. writing to flash, the window
+	 * closes and the peer stops sending. Memory use is therefore bounded by the TCP window
+	 * regardless of how quickly the data is consumed.
+	 *
+	 * @param enable false to revert to automatic acknowledgement, which also acknowledges any outstanding data
+	 */
+	void setManualReceiveAck(bool enable);
+
+	bool isManualReceiveAck() const
+	{
+		return manualReceiveAck;
+	}
+
+	/**
+	 * @brief Report received data as consumed, re-opening the receive window
+	 * @param length Number of bytes, limited to getUnacknowledgedReceive()
+	 */
+	void acknowledgeReceive(size_t length);
+
+	/**
+	 * @brief Get number of bytes received but not yet acknowledged to the stack
+	 */
+	size_t getUnacknowledgedReceive() const
+	{
+		return heldReceiveBytes;
+	}
+
 	IpAddress getRemoteIp() const
 	{
 		return (tcp == nullptr) ? INADDR_NONE : IpAddress(tcp->remote_ip);
@@ -113,6 +272,17 @@ public:
 		return (tcp == nullptr) ? 0 : tcp->remote_port;
 	}
 
+	const Stats& getStats() const
+	{
+		return stats;
+	}
+
+	/**
+	 * @brief Read round-trip and window estimates from the TCP stack
+	 * @retval bool false if there is no active connection
+	 */
+	bool getStackInfo(StackInfo& info) const;
+
 	/**
 	 * @brief Sets a callback to be called when the object instance is destroyed
 	 * @param destroyedDelegate
@@ -160,6 +330,22 @@ protected:
 
 	bool sslCreateSession();
 
+	/**
+	 * @brief Record activity on the connection, restarting the idle period
+	 */
+	void touch()
+	{
+		lastActivity = millis();
+	}
+
+	/**
+	 * @brief Stop timeout processing, e.g. for listening connections
+	 */
+	void stopIdleTimer()
+	{
+		idleTimer.stop();
+	}
+
 	/**
 	 * @brief Override in inherited classes to perform custom session initialisation
 	 *
@@ -205,10 +391,38 @@ protected:
 	err_t internalOnSent(uint16_t len);
 	err_t internalOnPoll();
 	void internalOnError(err_t err);
-	void internalOnDnsResponse(const char* name, LWIP_IP_ADDR_T* ipaddr, int port);
+	void internalOnDnsResponse(const char* name, const IpAddress* ipaddr, int port);
 
 private:
+	friend class TcpSendScheduler;
+
+	/*
+	 * Fallback for streams which don't support peekRegion(), reads data via stack buffer.
+	 * Kept separate so the buffer only occupies stack space when required.
+	 */
+	__noinline int writeBuffered(IDataSourceStream* stream, size_t maxLen);
+
+	/*
+	 * SSL handshake processing may be split across task queue callbacks,
+	 * so received data is retained until it has all been consumed.
+	 */
+	struct SslDeferredInput;
+	err_t sslReceive(pbuf* p, Ssl::InputBuffer& input, bool& retained);
+	err_t sslProcessInput(Ssl::InputBuffer& input, bool& deferred);
+	bool sslDefer(pbuf* p, const Ssl::InputBuffer& input);
+	void sslCancelDeferred();
+	static void staticOnSslResume(void* param);
+
 	static err_t staticOnPoll(void* arg, tcp_pcb* tcp);
+	static void staticOnIdleTimeout(void* arg);
+	void startIdleTimer();
+
+	void updateNagle();
+
+	uint32_t getIdleMillis() const
+	{
+		return millis() - lastActivity;
+	}
 	static void closeTcpConnection(tcp_pcb* tpcb);
 
 	void checkSelfFree()
@@ -220,7 +434,7 @@ private:
 
 protected:
 	tcp_pcb* tcp = nullptr;
-	uint16_t sleep = 0;
+	uint32_t lastActivity = 0; ///< millis() timestamp of last send or receive
 	uint16_t timeOut = USHRT_MAX; ///< By default a TCP connection does not have a time out
 	bool canSend = true;
 	bool autoSelfDestruct = true;
@@ -230,6 +444,17 @@ protected:
 
 private:
 	TcpConnectionDestroyedDelegate destroyedDelegate = nullptr;
+	SslDeferredInput* sslDeferred = nullptr;
+	WheelTimer idleTimer;
+	TcpSendScheduler::Entry sendEntry{};
+	uint32_t heldReceiveBytes{0}; ///< Data received but not yet passed to tcp_recved()
+	Stats stats{};
+	uint8_t lastRetransmits{0};
+	bool receiveHeld{false};
+	bool manualReceiveAck{false};
+	bool noDelay{true};
+	bool quickAck{false};
+	bool corked{false};
 };
 
 /** @} */
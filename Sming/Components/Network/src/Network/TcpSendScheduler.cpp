@@ -0,0 +1,188 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * TcpSendScheduler.cpp
+ *
+ ****/
+
+#include "TcpSendScheduler.h"
+#include "TcpConnection.h"
+#include <Platform/System.h>
+#include <SimpleTimer.h>
+#include <algorithm>
+
+TcpConnection* TcpSendScheduler::waitList;
+TcpConnection* TcpSendScheduler::wakeList;
+unsigned TcpSendScheduler::activeCount;
+unsigned TcpSendScheduler::waitingCount;
+uint16_t TcpSendScheduler::round{1};
+bool TcpSendScheduler::wakeQueued;
+TcpSendScheduler::Stats TcpSendScheduler::stats;
+
+namespace
+{
+SimpleTimer roundTimer;
+
+// Remove connection from a singly-linked list
+bool unlink(TcpConnection*& list, TcpConnection& connection)
+{
+	for(auto p = &list; *p != nullptr; p = &(*p)->sendEntry.next) {
+		if(*p == &connection) {
+			*p = connection.sendEntry.next;
+			connection.sendEntry.next = nullptr;
+			return true;
+		}
+	}
+	return false;
+}
+
+} // namespace
+
+size_t TcpSendScheduler::getQuota(TcpConnection& connection)
+{
+	if(TCP_SEND_QUANTUM == 0) {
+		return SIZE_MAX;
+	}
+
+	auto& entry = connection.sendEntry;
+	if(entry.waiting || entry.waking) {
+		// Resumed by staticWake() once the round ends
+		return 0;
+	}
+
+	if(!entry.active) {
+		entry.active = true;
+		++activeCount;
+		if(entry.round != round) {
+			// Idle since an earlier round: spare quota is discarded, and a full quantum credited below
+			entry.deficit = 0;
+		}
+	}
+
+	if(entry.round != round) {
+		entry.round = round;
+		entry.deficit = std::min(entry.deficit + int32_t(TCP_SEND_QUANTUM), int32_t(TCP_SEND_QUANTUM * 2));
+	}
+
+	if(activeCount == 1) {
+		return SIZE_MAX;
+	}
+
+	return std::max(entry.deficit, int32_t(0));
+}
+
+void TcpSendScheduler::update(TcpConnection& connection, size_t written, bool finished)
+{
+	if(TCP_SEND_QUANTUM == 0) {
+		return;
+	}
+
+	auto& entry = connection.sendEntry;
+	if(!entry.active || entry.waiting || entry.waking) {
+		return;
+	}
+
+	if(activeCount > 1) {
+		entry.deficit -= int32_t(written);
+	}
+
+	if(activeCount > 1 && entry.deficit <= 0 && !finished) {
+		entry.waiting = true;
+		entry.next = waitList;
+		waitList = &connection;
+		++waitingCount;
+		++stats.deferrals;
+	} else if(finished || written == 0) {
+		// Nothing more to send for now, e.g. stack buffers full or stream waiting for data
+		deactivate(entry);
+	} else {
+		return;
+	}
+
+	if(waitingCount != 0 && waitingCount == activeCount) {
+		advanceRound();
+	} else if(waitingCount != 0 && !roundTimer.isStarted()) {
+		roundTimer.initializeMs<TCP_SEND_ROUND_TIMEOUT_MS>(staticOnTimeout).startOnce();
+	}
+}
+
+void TcpSendScheduler::remove(TcpConnection& connection)
+{
+	auto& entry = connection.sendEntry;
+	if(entry.waiting) {
+		unlink(waitList, connection);
+		entry.waiting = false;
+		--waitingCount;
+	} else if(entry.waking) {
+		unlink(wakeList, connection);
+		entry.waking = false;
+	}
+	if(entry.active) {
+		deactivate(entry);
+		if(waitingCount != 0 && waitingCount == activeCount) {
+			advanceRound();
+		}
+	}
+}
+
+void TcpSendScheduler::deactivate(Entry& entry)
+{
+	// Deficit is kept in case the connection resumes sending during this round
+	entry.active = false;
+	--activeCount;
+}
+
+void TcpSendScheduler::advanceRound()
+{
+	roundTimer.stop();
+	++round;
+	++stats.rounds;
+
+	// Waiting connections are resumed from the task queue, not from within a TCP callback
+	while(waitList != nullptr) {
+		auto connection = waitList;
+		auto& entry = connection->sendEntry;
+		waitList = entry.next;
+		entry.waiting = false;
+		entry.waking = true;
+		entry.next = wakeList;
+		wakeList = connection;
+	}
+	waitingCount = 0;
+
+	if(wakeList != nullptr && !wakeQueued) {
+		wakeQueued = System.queueCallback(staticWake);
+		if(!wakeQueued) {
+			// Task queue full, try again shortly
+			roundTimer.initializeMs<TCP_SEND_ROUND_TIMEOUT_MS>(staticOnTimeout).startOnce();
+		}
+	}
+}
+
+void TcpSendScheduler::staticWake(void*)
+{
+	wakeQueued = false;
+	while(wakeList != nullptr) {
+		// Unlink first as connection may be destroyed during the callback
+		auto connection = wakeList;
+		auto& entry = connection->sendEntry;
+		wakeList = entry.next;
+		entry.next = nullptr;
+		entry.waking = false;
+		connection->trySend(eTCE_Poll);
+	}
+}
+
+void TcpSendScheduler::staticOnTimeout(void*)
+{
+	if(wakeList != nullptr && !wakeQueued) {
+		staticWake(nullptr);
+	}
+	if(waitList != nullptr) {
+		++stats.timeouts;
+		advanceRound();
+	}
+}
@@ -0,0 +1,117 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * TcpSendScheduler.h - Share TCP output fairly between connections
+ *
+ ****/
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief Bytes each connection may send per scheduling round
+ * @note 0 disables scheduling
+ */
+#ifndef TCP_SEND_QUANTUM
+#define TCP_SEND_QUANTUM 1460
+#endif
+
+/**
+ * @brief Start a new round after this time even if some connections have not used their quota
+ *
+ * Stops a connection with a slow peer from holding up the others.
+ */
+#define TCP_SEND_ROUND_TIMEOUT_MS 100
+
+class TcpConnection;
+
+/**
+ * @ingroup tcp
+ * @brief Deficit round robin scheduling of stream output
+ *
+ * Applies to all connections sending from a stream via `TcpConnection::write(IDataSourceStream*)`,
+ * which covers HTTP responses, WebSocket messages and other TcpClient output.
+ *
+ * Whilst only one connection has data pending its output is not limited.
+ * Once there are several, each is given TCP_SEND_QUANTUM bytes per round. A connection which
+ * uses its quota waits until all others have used theirs, or TCP_SEND_ROUND_TIMEOUT_MS elapses,
+ * and is then resumed from the task queue.
+ *
+ * A connection which starts sending is credited a quantum immediately, so short responses
+ * and WebSocket control frames are not queued behind bulk transfers.
+ * A connection which sends nothing, because its stream has finished or has no data available
+ * or the stack's buffers are full, no longer counts as sending. Quota left over is discarded if
+ * it stays idle beyond the current round, and otherwise carries forward by at most one quantum.
+ */
+class TcpSendScheduler
+{
+public:
+	/**
+	 * @brief Per-connection state, a member of TcpConnection
+	 */
+	struct Entry {
+		TcpConnection* next;
+		int32_t deficit;
+		uint16_t round;
+		bool active;
+		bool waiting;
+		bool waking;
+	};
+
+	struct Stats {
+		uint32_t rounds;	///< Number of rounds completed
+		uint32_t timeouts;  ///< Rounds ended by TCP_SEND_ROUND_TIMEOUT_MS
+		uint32_t deferrals; ///< Number of times a connection had to wait for the next round
+	};
+
+	/**
+	 * @brief Get number of bytes a connection may send now
+	 * @retval size_t SIZE_MAX if unlimited
+	 */
+	static size_t getQuota(TcpConnection& connection);
+
+	/**
+	 * @brief Account for data sent following a call to getQuota()
+	 * @param connection
+	 * @param written Bytes passed to the stack
+	 * @param finished true if there is no more data pending
+	 */
+	static void update(TcpConnection& connection, size_t written, bool finished);
+
+	/**
+	 * @brief Called when a connection closes or is destroyed
+	 */
+	static void remove(TcpConnection& connection);
+
+	/**
+	 * @brief Get number of connections with output pending
+	 */
+	static unsigned getActiveCount()
+	{
+		return activeCount;
+	}
+
+	static const Stats& getStats()
+	{
+		return stats;
+	}
+
+private:
+	static void deactivate(Entry& entry);
+	static void advanceRound();
+	static void staticWake(void* param);
+	static void staticOnTimeout(void* param);
+
+	static TcpConnection* waitList;
+	static TcpConnection* wakeList;
+	static unsigned activeCount;
+	static unsigned waitingCount;
+	static uint16_t round;
+	static bool wakeQueued;
+	static Stats stats;
+};
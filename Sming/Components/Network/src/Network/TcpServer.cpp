@@ -9,6 +9,16 @@
  ****/
 
 #include "TcpServer.h"
+#include <heap_info.h>
+
+TcpServer::~TcpServer()
+{
+	for(auto& pending : acceptQueue) {
+		removePending(pending, true);
+	}
+
+	debug_i("TcpServer destroyed");
+}
 
 TcpConnection* TcpServer::createClient(tcp_pcb* clientTcp)
 {
@@ -47,23 +57,47 @@ bool TcpServer::listen(int port, bool useSsl)
 	tcp = tcp_listen(tcp);
 	tcp_accept(tcp, staticAccept);
 
+	// Server timeout applies to pending clients, not the listening connection
+	stopIdleTimer();
+
 	return true;
 }
 
-err_t TcpServer::onAccept(tcp_pcb* clientTcp, err_t err)
+bool TcpServer::hasCapacity()
 {
-	// Anti DDoS :-)
 	if(system_get_free_heap_size() < minHeapSize) {
-		debug_w("\r\n\r\nCONNECTION DROPPED\r\n\t(free heap: %u)\r\n\r\n", system_get_free_heap_size());
-		return ERR_MEM;
+		return false;
+	}
+
+	if(minFreeBlockSize != 0 && system_get_max_free_block_size() < minFreeBlockSize) {
+		return false;
 	}
 
 	// Obey any requested connection limit
-	if(maxConnections != 0 && connections.count() >= maxConnections) {
-		debug_w("\r\n\r\nCONNECTION DROPPED\r\n\t(Existing connections: %u)\r\n\r\n", connections.count());
-		return ERR_ABRT;
+	return maxConnections == 0 || connections.count() < maxConnections;
+}
+
+bool TcpServer::closeIdleConnection()
+{
+	// Least recently used connection is the one idle for longest
+	TcpConnection* idlest{nullptr};
+	for(auto& connection : connections) {
+		if(connection.getIdleTime() != 0 && (idlest == nullptr || connection.getIdleTime() > idlest->getIdleTime())) {
+			idlest = &connection;
+		}
+	}
+
+	if(idlest == nullptr) {
+		return false;
 	}
 
+	debug_w("Closing idle connection (%u intervals) to accept new client", idlest->getIdleTime());
+	idlest->close();
+	return true;
+}
+
+err_t TcpServer::onAccept(tcp_pcb* clientTcp, err_t err)
+{
 #ifdef NETWORK_DEBUG
 	debug_d("onAccept, tcp: %p, state: %d K=%d, Free heap size=%u", clientTcp, err, connections.count(),
 			system_get_free_heap_size());
@@ -74,6 +108,39 @@ err_t TcpServer::onAccept(tcp_pcb* clientTcp, err_t err)
 		return err;
 	}
 
+	if(!active) {
+		debug_w("Refusing new connections. The server is shutting down");
+		return ERR_MEM;
+	}
+
+	IpAddress remoteIp(clientTcp->remote_ip);
+	if(rateLimiter != nullptr && !rateLimiter->allow(remoteIp)) {
+		debug_w("Connection from %s refused, rate limit exceeded", remoteIp.toString().c_str());
+		// lwip aborts the connection for us
+		return ERR_MEM;
+	}
+
+	// Earlier connections take priority
+	processAcceptQueue();
+
+	if(getPendingCount() == 0 && (hasCapacity() || (closeIdleConnection() && hasCapacity()))) {
+		return acceptClient(clientTcp);
+	}
+
+	if(deferClient(clientTcp)) {
+		debug_d("Connection deferred. Pending connections: %u", getPendingCount());
+		return ERR_OK;
+	}
+
+	// Anti DDoS :-)
+	debug_w("\r\n\r\nCONNECTION DROPPED\r\n\t(connections: %u, free heap: %u)\r\n\r\n", connections.count(),
+			system_get_free_heap_size());
+	// lwip aborts the connection for us
+	return ERR_MEM;
+}
+
+err_t TcpServer::acceptClient(tcp_pcb* clientTcp)
+{
 	TcpConnection* client = createClient(clientTcp);
 	if(client == nullptr) {
 		return ERR_MEM;
@@ -93,7 +160,7 @@ err_t TcpServer::onAccept(tcp_pcb* clientTcp, err_t err)
 
 	client->setDestroyedDelegate(TcpConnectionDestroyedDelegate(&TcpServer::onClientDestroy, this));
 
-	connections.add(client);
+	connections.add(*client);
 	debug_d("Opening connection. Total connections: %d", connections.count());
 
 	onClient(reinterpret_cast<TcpClient*>(client));
@@ -101,6 +168,123 @@ err_t TcpServer::onAccept(tcp_pcb* clientTcp, err_t err)
 	return ERR_OK;
 }
 
+unsigned TcpServer::getPendingCount() const
+{
+	unsigned count{0};
+	for(auto& pending : acceptQueue) {
+		if(pending.pcb != nullptr) {
+			++count;
+		}
+	}
+	return count;
+}
+
+bool TcpServer::deferClient(tcp_pcb* clientTcp, uint16_t age)
+{
+	for(auto& pending : acceptQueue) {
+		if(pending.pcb != nullptr) {
+			continue;
+		}
+
+		pending = PendingClient{this, clientTcp, age};
+		// Any data received is refused, and so held by lwip, until the connection is accepted
+		tcp_arg(clientTcp, &pending);
+		tcp_recv(clientTcp, staticPendingReceive);
+		tcp_err(clientTcp, staticPendingError);
+		tcp_poll(clientTcp, staticPendingPoll, 4);
+		return true;
+	}
+
+	return false;
+}
+
+void TcpServer::processAcceptQueue()
+{
+	while(hasCapacity() || (closeIdleConnection() && hasCapacity())) {
+		// Oldest first
+		PendingClient* oldest{nullptr};
+		for(auto& pending : acceptQueue) {
+			if(pending.pcb != nullptr && (oldest == nullptr || pending.age > oldest->age)) {
+				oldest = &pending;
+			}
+		}
+		if(oldest == nullptr) {
+			break;
+		}
+
+		auto pcb = oldest->pcb;
+		auto age = oldest->age;
+		removePending(*oldest, false);
+		if(acceptClient(pcb) == ERR_MEM) {
+			// Couldn't create client, try again later
+			deferClient(pcb, age);
+			break;
+		}
+	}
+}
+
+void TcpServer::removePending(PendingClient& pending, bool abort)
+{
+	auto pcb = pending.pcb;
+	if(pcb == nullptr) {
+		return;
+	}
+
+	pending.pcb = nullptr;
+	tcp_arg(pcb, nullptr);
+	tcp_recv(pcb, nullptr);
+	tcp_err(pcb, nullptr);
+	tcp_poll(pcb, nullptr, 0);
+	if(abort) {
+		tcp_abort(pcb);
+	}
+}
+
+err_t TcpServer::staticPendingReceive(void* arg, tcp_pcb* tcp, pbuf* p, err_t err)
+{
+	auto pending = static_cast<PendingClient*>(arg);
+	if(pending == nullptr || p == nullptr) {
+		// Remote end closed before we got around to it
+		if(pending != nullptr) {
+			pending->server->removePending(*pending, true);
+		} else {
+			tcp_abort(tcp);
+		}
+		return ERR_ABRT;
+	}
+
+	return ERR_MEM;
+}
+
+err_t TcpServer::staticPendingPoll(void* arg, tcp_pcb* tcp)
+{
+	auto pending = static_cast<PendingClient*>(arg);
+	if(pending == nullptr) {
+		return ERR_OK;
+	}
+
+	auto server = pending->server;
+	++pending->age;
+	server->processAcceptQueue();
+
+	if(pending->pcb == tcp && pending->age >= server->timeOut) {
+		debug_w("Pending connection timed out");
+		server->removePending(*pending, true);
+		return ERR_ABRT;
+	}
+
+	return ERR_OK;
+}
+
+void TcpServer::staticPendingError(void* arg, err_t err)
+{
+	auto pending = static_cast<PendingClient*>(arg);
+	if(pending != nullptr) {
+		// Connection has already been freed by lwip
+		pending->pcb = nullptr;
+	}
+}
+
 void TcpServer::onClient(TcpClient* client)
 {
 	activeClients++;
@@ -138,7 +322,7 @@ err_t TcpServer::staticAccept(void* arg, tcp_pcb* new_tcp, err_t err)
 		tcp_abort(new_tcp);
 		return ERR_ABRT;
 	} else {
-		con->sleep = 0;
+		con->touch();
 	}
 
 	err_t res = con->onAccept(new_tcp, err);
@@ -159,24 +343,27 @@ void TcpServer::shutdown()
 		tcp = nullptr;
 	}
 
+	for(auto& pending : acceptQueue) {
+		removePending(pending, true);
+	}
+
 	if(connections.count() == 0) {
 		delete this;
 		return;
 	}
 
 	for(auto& connection : connections) {
-		if(connection != nullptr) {
-			connection->setTimeOut(1);
-		}
+		connection.setTimeOut(1);
 	}
 }
 
 void TcpServer::onClientDestroy(TcpConnection& connection)
 {
-	connections.removeElement(&connection);
+	connections.remove(connection);
 	debug_d("Destroying connection. Total connections: %d", connections.count());
 
 	if(active) {
+		processAcceptQueue();
 		return;
 	}
 
@@ -19,6 +19,8 @@
 
 #include "TcpConnection.h"
 #include "TcpClient.h"
+#include "RateLimiter.h"
+#include <array>
 
 using TcpClientConnectDelegate = Delegate<void(TcpClient* client)>;
 
@@ -27,6 +29,14 @@ using TcpClientConnectDelegate = Delegate<void(TcpClient* client)>;
 #define TCP_SERVER_TIMEOUT 20
 #endif
 
+/*
+ * Number of accepted connections which may be held pending when the server is at capacity.
+ * Pending connections are serviced as resources become available, or dropped on timeout.
+ */
+#ifndef TCP_SERVER_ACCEPT_QUEUE_SIZE
+#define TCP_SERVER_ACCEPT_QUEUE_SIZE 4
+#endif
+
 class TcpServer : public TcpConnection
 {
 public:
@@ -61,22 +71,72 @@ public:
 		clientReceiveDelegate = clientReceiveDataHandler;
 	}
 
-	~TcpServer()
+	void setClientCompleteHandler(TcpClientCompleteDelegate clientCompleteHandler)
 	{
-		debug_i("TcpServer destroyed");
+		clientCompleteDelegate = clientCompleteHandler;
 	}
 
+	~TcpServer();
+
 	virtual bool listen(int port, bool useSsl = false);
 
 	void setKeepAlive(uint16_t seconds);
 
 	void shutdown();
 
-	const Vector<TcpConnection*>& getConnections() const
+	using ConnectionList = IntrusiveList<TcpConnection, TcpServer>;
+
+	const ConnectionList& getConnections() const
 	{
 		return connections;
 	}
 
+	/**
+	 * @brief Limit the number of concurrent client connections
+	 * @param count 0 for no limit
+	 * @note Connections accepted beyond this limit are held in the accept queue,
+	 * and the longest idle connection is closed to make room.
+	 */
+	void setMaxConnections(uint16_t count)
+	{
+		maxConnections = count;
+	}
+
+	/**
+	 * @brief Set the minimum free heap required to accept a new connection
+	 */
+	void setMinHeapSize(size_t size)
+	{
+		minHeapSize = size;
+	}
+
+	/**
+	 * @brief Set the largest free heap block required to accept a new connection
+	 * @param size 0 to disable check
+	 * @note Free heap may be adequate but too fragmented to hold connection buffers,
+	 * especially with SSL. Checking this requires a walk of the heap on some architectures.
+	 * @see `system_get_heap_info()`
+	 */
+	void setMinFreeBlockSize(size_t size)
+	{
+		minFreeBlockSize = size;
+	}
+
+	/**
+	 * @brief Refuse connections from clients which connect too often
+	 * @param limiter Checked for each incoming connection, nullptr to disable. Not owned by the server.
+	 * @note Refused connections are reset before any data is received
+	 */
+	void setRateLimiter(Network::RateLimiter* limiter)
+	{
+		rateLimiter = limiter;
+	}
+
+	/**
+	 * @brief Get number of connections waiting in the accept queue
+	 */
+	unsigned getPendingCount() const;
+
 protected:
 	// Overload this method in your derived class!
 	virtual TcpConnection* createClient(tcp_pcb* clientTcp);
@@ -88,17 +148,34 @@ protected:
 	virtual void onClientDestroy(TcpConnection& connection);
 
 private:
+	struct PendingClient {
+		TcpServer* server;
+		tcp_pcb* pcb;
+		uint16_t age; ///< Poll intervals spent waiting
+	};
+
+	bool hasCapacity();
+	bool closeIdleConnection();
+	err_t acceptClient(tcp_pcb* clientTcp);
+	bool deferClient(tcp_pcb* clientTcp, uint16_t age = 0);
+	void processAcceptQueue();
+	void removePending(PendingClient& pending, bool abort);
+
 	static err_t staticAccept(void* arg, tcp_pcb* new_tcp, err_t err);
+	static err_t staticPendingReceive(void* arg, tcp_pcb* tcp, pbuf* p, err_t err);
+	static err_t staticPendingPoll(void* arg, tcp_pcb* tcp);
+	static void staticPendingError(void* arg, err_t err);
 
 public:
 	uint16_t activeClients = 0;
 
 protected:
 	size_t minHeapSize = 16384;
+	size_t minFreeBlockSize = 0;
 	uint16_t maxConnections = 0; ///< By default, don't limit connection count
 
 	bool active = true;
-	Vector<TcpConnection*> connections;
+	ConnectionList connections;
 
 private:
 	uint16_t keepAlive = 70; ///< The time to wait after the connection is established. If there is no data
@@ -106,6 +183,8 @@ private:
 	TcpClientConnectDelegate clientConnectDelegate = nullptr;
 	TcpClientDataDelegate clientReceiveDelegate = nullptr;
 	TcpClientCompleteDelegate clientCompleteDelegate = nullptr;
+	Network::RateLimiter* rateLimiter{nullptr};
+	std::array<PendingClient, TCP_SERVER_ACCEPT_QUEUE_SIZE> acceptQueue{};
 };
 
 /** @} */
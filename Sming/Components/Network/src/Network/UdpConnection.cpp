@@ -32,6 +32,11 @@ void UdpConnection::close()
 	udp_recv(udp, nullptr, nullptr);
 	udp_remove(udp);
 	udp = nullptr;
+
+	if(receiveBatch) {
+		receiveBatch->timer.stop();
+		deliverBatch();
+	}
 }
 
 bool UdpConnection::listen(int port)
@@ -93,6 +98,83 @@ bool UdpConnection::sendTo(IpAddress remoteIP, uint16_t remotePort, const char*
 	}
 }
 
+bool UdpConnection::send(pbuf* buf)
+{
+	if(buf == nullptr) {
+		return false;
+	}
+	err_t res = udp_send(udp, buf);
+	pbuf_free(buf);
+	return res == ERR_OK;
+}
+
+bool UdpConnection::sendTo(IpAddress remoteIP, uint16_t remotePort, pbuf* buf)
+{
+	if(buf == nullptr) {
+		return false;
+	}
+	err_t res = udp_sendto(udp, buf, remoteIP, remotePort);
+	pbuf_free(buf);
+	return res == ERR_OK;
+}
+
+void UdpConnection::setPacketHandler(UdpConnectionPacketDelegate handler, bool batch)
+{
+	if(receiveBatch) {
+		receiveBatch->timer.stop();
+		deliverBatch();
+	}
+
+	onPacketCallback = handler;
+
+	if(batch && handler) {
+		receiveBatch.reset(new ReceiveBatch);
+		receiveBatch->timer.initializeMs<1>([](void* arg) { static_cast<UdpConnection*>(arg)->deliverBatch(); }, this);
+	} else {
+		receiveBatch.reset();
+	}
+}
+
+void UdpConnection::receivePacket(pbuf* buf, IpAddress remoteIP, uint16_t remotePort)
+{
+	if(!receiveBatch) {
+		UdpPacket packet{buf, remoteIP, remotePort};
+		onPacketCallback(*this, &packet, 1);
+		if(packet.buf != nullptr) {
+			pbuf_free(packet.buf);
+		}
+		return;
+	}
+
+	auto& batch = *receiveBatch;
+	if(batch.count == UDP_RECEIVE_BATCH_SIZE) {
+		deliverBatch();
+	}
+	batch.packets[batch.count++] = UdpPacket{buf, remoteIP, remotePort};
+	if(!batch.timer.isStarted()) {
+		batch.timer.startOnce();
+	}
+}
+
+void UdpConnection::deliverBatch()
+{
+	auto& batch = *receiveBatch;
+	if(batch.count == 0) {
+		return;
+	}
+
+	auto count = batch.count;
+	batch.count = 0;
+	if(onPacketCallback) {
+		onPacketCallback(*this, batch.packets, count);
+	}
+	for(unsigned i = 0; i < count; ++i) {
+		if(batch.packets[i].buf != nullptr) {
+			pbuf_free(batch.packets[i].buf);
+		}
+	}
+}
+
 void UdpConnection::onReceive(pbuf* buf, IpAddress remoteIP, uint16_t remotePort)
 {
 	debug_d("UDP received: %d bytes", buf->tot_len);
@@ -112,6 +194,11 @@ void UdpConnection::staticOnReceive(void* arg, struct udp_pcb* pcb, struct pbuf*
 	auto conn = static_cast<UdpConnection*>(arg);
 	if(conn != nullptr) {
 		IpAddress reip = addr != nullptr ? IpAddress(*addr) : IpAddress();
+		if(conn->onPacketCallback) {
+			// Buffer is passed on without copying
+			conn->receivePacket(p, reip, port);
+			return;
+		}
 		conn->onReceive(p, reip, port);
 	}
 	pbuf_free(p);
@@ -11,7 +11,9 @@
 #pragma once
 
 #include <Network/IpConnection.h>
+#include <SimpleTimer.h>
 #include <lwip/udp.h>
+#include <memory>
 
 /** @defgroup   udp UDP
  *  @brief      Provides base for UDP clients or services
@@ -19,11 +21,29 @@
  *  @{
  */
 
+/**
+ * @brief Maximum number of datagrams passed to a batched packet handler in one call
+ */
+#ifndef UDP_RECEIVE_BATCH_SIZE
+#define UDP_RECEIVE_BATCH_SIZE 8
+#endif
+
 class UdpConnection;
 
 using UdpConnectionDataDelegate =
 	Delegate<void(UdpConnection& connection, char* data, int size, IpAddress remoteIP, uint16_t remotePort)>;
 
+/**
+ * @brief A received datagram
+ */
+struct UdpPacket {
+	pbuf* buf; ///< Set to nullptr to take ownership, then call `pbuf_free()` when done
+	IpAddress remoteIP;
+	uint16_t remotePort;
+};
+
+using UdpConnectionPacketDelegate = Delegate<void(UdpConnection& connection, UdpPacket* packets, unsigned count)>;
+
 class UdpConnection : public IpConnection
 {
 public:
@@ -71,6 +91,43 @@ public:
 		return sendTo(remoteIP, remotePort, data.c_str(), data.length());
 	}
 
+	/**
+	 * @brief Allocate a buffer suitable for sending without copying
+	 * @param length Size of datagram payload
+	 * @retval pbuf* nullptr if out of memory
+	 */
+	static pbuf* allocateBuffer(size_t length)
+	{
+		return pbuf_alloc(PBUF_TRANSPORT, length, PBUF_RAM);
+	}
+
+	/**
+	 * @brief Send a datagram from a buffer, after connect(..)
+	 * @param buf Buffer to send, typically from allocateBuffer(). It is always freed.
+	 * @retval bool
+	 */
+	bool send(pbuf* buf);
+
+	/**
+	 * @brief Send a datagram from a buffer
+	 * @param remoteIP
+	 * @param remotePort
+	 * @param buf Buffer to send, typically from allocateBuffer(). It is always freed.
+	 * @retval bool
+	 */
+	bool sendTo(IpAddress remoteIP, uint16_t remotePort, pbuf* buf);
+
+	/**
+	 * @brief Receive datagrams without copying
+	 * @param handler Called with received packets. Buffers are freed afterwards unless the handler takes ownership.
+	 * @param batch If true, datagrams received during one task cycle are passed together, up to
+	 * UDP_RECEIVE_BATCH_SIZE at a time
+	 *
+	 * When set, the handler replaces any data delegate and `onReceive()`.
+	 * Received buffers may belong to the network driver, so handlers should not hold on to them for long.
+	 */
+	void setPacketHandler(UdpConnectionPacketDelegate handler, bool batch = false);
+
 	/**
 	 * @brief Sets the UDP multicast IP.
 	 * @param ip
@@ -99,9 +156,23 @@ protected:
 	bool initialize(udp_pcb* pcb = nullptr);
 	static void staticOnReceive(void* arg, struct udp_pcb* pcb, struct pbuf* p, LWIP_IP_ADDR_T* addr, u16_t port);
 
+private:
+	void receivePacket(pbuf* buf, IpAddress remoteIP, uint16_t remotePort);
+	void deliverBatch();
+
+	struct ReceiveBatch {
+		UdpPacket packets[UDP_RECEIVE_BATCH_SIZE];
+		unsigned count{0};
+		SimpleTimer timer;
+	};
+
 protected:
 	udp_pcb* udp = nullptr;
 	UdpConnectionDataDelegate onDataCallback = nullptr;
+
+private:
+	UdpConnectionPacketDelegate onPacketCallback;
+	std::unique_ptr<ReceiveBatch> receiveBatch;
 };
 
 /** @} */
@@ -45,7 +45,7 @@ Url& Url::operator=(String urlString)
 	Host = url.host;
 	Port = url.port ?: getDefaultPort(Scheme);
 	Path = String('/') + uri_unescape_inplace(url.path);
-	Query.parseQuery(url.query);
+	Query.setQuery(url.query);
 	Fragment = uri_unescape_inplace(url.fragment);
 
 	return *this;
@@ -73,6 +73,7 @@ bool WebsocketClient::connect(const Url& url)
 	request->headers[HTTP_HEADER_SEC_WEBSOCKET_KEY] = key;
 	request->headers[HTTP_HEADER_SEC_WEBSOCKET_PROTOCOL] = F("chat");
 	request->headers[HTTP_HEADER_SEC_WEBSOCKET_VERSION] = String(WEBSOCKET_VERSION);
+	offerExtensions(request->headers);
 	request->onHeadersComplete(RequestHeadersCompletedDelegate(&WebsocketClient::verifyKey, this));
 
 	if(!httpConnection->send(request)) {
@@ -103,6 +104,7 @@ int WebsocketClient::verifyKey(HttpConnection& connection, HttpResponse& respons
 		return -3;
 	}
 
+	acceptExtensions(response.headers);
 	response.headers.clear();
 
 	state = eWSCS_Open;
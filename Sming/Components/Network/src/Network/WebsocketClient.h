@@ -39,6 +39,8 @@ public:
 	using WebsocketConnection::setConnectionHandler;
 	using WebsocketConnection::setDisconnectionHandler;
 	using WebsocketConnection::setMessageHandler;
+	using WebsocketConnection::isCompressed;
+	using WebsocketConnection::setCompression;
 
 	HttpConnection* getHttpConnection();
 
@@ -308,6 +308,39 @@ public:
 	 */
 	virtual bool startScan(ScanCompletedDelegate scanCompleted) = 0;
 
+	/**	@brief	Enable fast reconnection
+	 *	@param	enable
+	 *	@retval	bool false if not supported on this platform
+	 *
+	 *  Once connected, the BSSID and channel of the access point and the address assigned by DHCP
+	 *  are kept in RTC memory, which survives a restart or deep sleep. Subsequent connections,
+	 *  including the automatic one made at startup, go straight to that access point without scanning.
+	 *  The address is re-used without DHCP for up to STATION_FAST_CONNECT_LEASE_SECONDS after it was assigned.
+	 *  If the connection fails the saved information is discarded and a full scan is done.
+	 *
+	 *  @note Call after config(). Saved information is only used if the SSID matches the current configuration.
+	 *  Supported on Esp8266 and Esp32.
+	 */
+	virtual bool setFastConnect(bool enable)
+	{
+		(void)enable;
+		return false;
+	}
+
+	/**	@brief	Determine if fast reconnection is enabled
+	 */
+	virtual bool isFastConnect() const
+	{
+		return false;
+	}
+
+	/**	@brief	Discard any information saved for fast reconnection
+	 *  @note Use, for example, when the network configuration is known to have changed
+	 */
+	virtual void clearFastConnect()
+	{
+	}
+
 #ifdef ENABLE_SMART_CONFIG
 	/**	@brief	Start WiFi station smart configuration
 	 *	@param	sctype Smart configuration type
@@ -0,0 +1,93 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * StationFastConnect.h - Connection details kept in RTC memory for fast reconnection
+ *
+ * Used by platform station implementations, see StationClass::setFastConnect().
+ *
+ ****/
+
+#pragma once
+
+#include <WString.h>
+#include <Platform/RTC.h>
+#include <algorithm>
+#include <cstddef>
+
+/**
+ * @brief Time in seconds an address from DHCP is re-used without renewing it
+ * @note Should be less than the lease time given by the DHCP server
+ */
+#ifndef STATION_FAST_CONNECT_LEASE_SECONDS
+#define STATION_FAST_CONNECT_LEASE_SECONDS 3600
+#endif
+
+namespace SmingInternal
+{
+namespace Network
+{
+struct StationFastConnect {
+	static constexpr uint32_t magicValue{0x46434e31};
+
+	uint32_t magic;
+	uint8_t ssid[32];
+	uint8_t bssid[6];
+	uint8_t channel;
+	uint8_t hasLease;
+	uint32_t ip;
+	uint32_t netmask;
+	uint32_t gateway;
+	uint32_t dns;
+	uint32_t leaseStart; ///< RTC seconds when address was assigned
+	uint32_t check;
+
+	/*
+	 * RTC memory holds garbage after power-on, so a checksum is required as well as the magic value
+	 */
+	uint32_t checksum() const
+	{
+		auto words = reinterpret_cast<const uint32_t*>(this);
+		constexpr size_t count{offsetof(StationFastConnect, check) / sizeof(uint32_t)};
+		uint32_t sum{0x5a5a5a5a};
+		for(size_t i = 0; i < count; ++i) {
+			sum = ((sum << 5) | (sum >> 27)) ^ words[i];
+		}
+		return sum;
+	}
+
+	void seal()
+	{
+		magic = magicValue;
+		check = checksum();
+	}
+
+	void invalidate()
+	{
+		magic = 0;
+	}
+
+	bool isValid(const String& currentSsid) const
+	{
+		return magic == magicValue && check == checksum() && channel != 0 &&
+			   strncmp(currentSsid.c_str(), reinterpret_cast<const char*>(ssid), sizeof(ssid)) == 0;
+	}
+
+	bool isLeaseValid() const
+	{
+		return hasLease && (RTC.getRtcSeconds() - leaseStart) < STATION_FAST_CONNECT_LEASE_SECONDS;
+	}
+
+	void setSsid(const String& value)
+	{
+		memset(ssid, 0, sizeof(ssid));
+		memcpy(ssid, value.c_str(), std::min(value.length(), sizeof(ssid)));
+	}
+};
+
+static_assert(sizeof(StationFastConnect) % 4 == 0, "StationFastConnect must be a whole number of words");
+
+} // namespace Network
+} // namespace SmingInternal
@@ -19,6 +19,7 @@
 #include <Platform/System.h>
 #include <MacAddress.h>
 #include "WVector.h"
+#include <memory>
 
 /**	@defgroup wifi_sniffer WiFi Sniffer
  *  @ingroup wifi
@@ -28,6 +29,21 @@
 
 #define ETH_MAC_LEN 6
 
+/**
+ * @brief Number of frame headers buffered for delivery via WifiSniffer::onFrames()
+ */
+#ifndef WIFI_SNIFFER_QUEUE_SIZE
+#define WIFI_SNIFFER_QUEUE_SIZE 32
+#endif
+
+/**
+ * @brief Number of bytes captured from the start of each frame
+ * @note The SDK provides at most 36 bytes for data frames and 112 for management frames
+ */
+#ifndef WIFI_SNIFFER_HEADER_SIZE
+#define WIFI_SNIFFER_HEADER_SIZE 36
+#endif
+
 /**
  * @brief Decoded Wifi beacon (Access Point) information
  */
@@ -54,19 +70,124 @@ struct ClientInfo {
 	uint16_t seq_n;
 };
 
+/**
+ * @brief List of beacons or clients indexed by a hash of the BSSID
+ *
+ * Lookups take constant time, so a list may hold hundreds of entries
+ * without slowing frame processing.
+ * @note The index is maintained by add(), remove() and clear(). After changing
+ * elements by other means, such as via the Vector base, call reindex().
+ */
 template <class T> class BeaconOrClientListTemplate : public Vector<T>
 {
 public:
 	int indexOf(const MacAddress& bssid)
 	{
-		for(unsigned i = 0; i < this->count(); ++i) {
-			if(this->elementAt(i).bssid == bssid) {
+		if(indexedCount != this->count()) {
+			reindex();
+		}
+		if(!slots) {
+			return -1;
+		}
+		for(unsigned slot = getHash(bssid) & slotMask;; slot = (slot + 1) & slotMask) {
+			unsigned value = slots[slot];
+			if(value == 0) {
+				return -1;
+			}
+			unsigned i = value - 1;
+			if(i < this->count() && this->elementAt(i).bssid == bssid) {
 				return i;
 			}
 		}
+	}
+
+	/**
+	 * @brief Add an entry
+	 * @retval bool false if out of memory
+	 */
+	bool add(const T& info)
+	{
+		if(indexedCount != this->count()) {
+			reindex();
+		}
+		if(!Vector<T>::add(info)) {
+			return false;
+		}
+		if(2 * this->count() > slotMask) {
+			reindex();
+		} else {
+			insert(this->count() - 1);
+			++indexedCount;
+		}
+		return true;
+	}
+
+	/**
+	 * @brief Add an entry unless one with the same BSSID is present
+	 * @retval bool true if a new entry was added
+	 */
+	bool addUnique(const T& info)
+	{
+		return indexOf(info.bssid) < 0 && add(info);
+	}
 
-		return -1;
+	bool remove(unsigned index)
+	{
+		if(!Vector<T>::remove(index)) {
+			return false;
+		}
+		reindex();
+		return true;
 	}
+
+	void clear()
+	{
+		Vector<T>::clear();
+		slots.reset();
+		slotMask = 0;
+		indexedCount = 0;
+	}
+
+	/**
+	 * @brief Rebuild the hash index
+	 */
+	void reindex()
+	{
+		unsigned size{16};
+		while(size < 4 * this->count()) {
+			size <<= 1;
+		}
+		slots.reset(new uint16_t[size]{});
+		slotMask = size - 1;
+		for(unsigned i = 0; i < this->count(); ++i) {
+			insert(i);
+		}
+		indexedCount = this->count();
+	}
+
+private:
+	static unsigned getHash(const MacAddress& addr)
+	{
+		// FNV-1a
+		uint32_t hash{2166136261U};
+		for(unsigned i = 0; i < 6; ++i) {
+			hash = (hash ^ addr[i]) * 16777619U;
+		}
+		return hash;
+	}
+
+	void insert(unsigned index)
+	{
+		unsigned slot = getHash(this->elementAt(index).bssid) & slotMask;
+		while(slots[slot] != 0) {
+			slot = (slot + 1) & slotMask;
+		}
+		slots[slot] = index + 1;
+	}
+
+	std::unique_ptr<uint16_t[]> slots; ///< Element index + 1, 0 if unused
+	unsigned slotMask{0};
+	unsigned indexedCount{0};
 };
 
 /**
@@ -79,10 +200,44 @@ using BeaconInfoList = BeaconOrClientListTemplate<BeaconInfo>;
  */
 using ClientInfoList = BeaconOrClientListTemplate<ClientInfo>;
 
+/**
+ * @brief Start of a received frame, as passed to WifiSniffer::onFrames()
+ */
+struct WifiSnifferFrame {
+	uint8_t header[WIFI_SNIFFER_HEADER_SIZE]; ///< 802.11 MAC header and start of body
+	uint16_t length;						  ///< Bytes captured, up to WIFI_SNIFFER_HEADER_SIZE
+	int8_t rssi;
+	uint8_t channel;
+};
+
+/**
+ * @brief Selects which frames are passed on by WifiSniffer
+ *
+ * Applied as each frame is received, before any parsing or copying.
+ */
+struct WifiSnifferFilter {
+	enum Type {
+		Management = 0x01, ///< Includes beacons
+		Data = 0x02,
+		All = 0xff,
+	};
+
+	uint8_t types{All};	///< Combination of Type values
+	int8_t minRssi{-128}; ///< Ignore frames with weaker signals than this
+	MacAddress address{};  ///< If set, only frames with this in one of the first three address fields
+};
+
 using WifiSnifferCallback = Delegate<void(uint8_t* data, uint16_t length)>;
 using WifiBeaconCallback = Delegate<void(const BeaconInfo& beacon)>;
 using WifiClientCallback = Delegate<void(const ClientInfo& client)>;
 
+/**
+ * @brief Receives a batch of buffered frames in task context
+ * @param frames
+ * @param count Number of frames
+ */
+using WifiFramesCallback = Delegate<void(const WifiSnifferFrame* frames, unsigned count)>;
+
 class WifiSniffer : public ISystemReadyHandler
 {
 public:
@@ -112,6 +267,30 @@ public:
 		snifferCallback = callback;
 	}
 
+	/** @brief Receive frame headers in batches
+	 *  @param callback Invoked from the task queue with frames received since the previous call
+	 *
+	 *  The radio callback only copies each frame into a ring buffer of WIFI_SNIFFER_QUEUE_SIZE entries,
+	 *  so heavy traffic can be handled without blocking the WiFi stack.
+	 *  Frames arriving when the buffer is full are counted by getDroppedFrames().
+	 *  Pass nullptr to stop buffering and release the memory.
+	 */
+	void onFrames(WifiFramesCallback callback);
+
+	/** @brief Set the filter applied to all received frames
+	 */
+	void setFilter(const WifiSnifferFilter& filter)
+	{
+		this->filter = filter;
+	}
+
+	/** @brief Get number of frames discarded as the ring buffer was full
+	 */
+	uint32_t getDroppedFrames() const
+	{
+		return droppedFrames;
+	}
+
 	/** @brief Set the channel to listen on
 	 *  @param channel
 	 */
@@ -133,9 +312,24 @@ private:
 	/** @brief Parse received Wifi data */
 	static void parseData(uint8_t* buf, uint16_t len);
 
+	static bool queueFrame(const uint8_t* frame, uint16_t length, int8_t rssi, uint8_t channel);
+	static void deliverFrames();
+
 	static WifiSnifferCallback snifferCallback;
 	static WifiBeaconCallback beaconCallback;
 	static WifiClientCallback clientCallback;
+	static WifiFramesCallback framesCallback;
+	static WifiSnifferFilter filter;
+
+	/*
+	 * Single producer (radio callback) and single consumer (task), so no locking needed:
+	 * only the producer writes `head` and only the consumer writes `tail`.
+	 */
+	static std::unique_ptr<WifiSnifferFrame[]> frames;
+	static volatile uint16_t head;
+	static volatile uint16_t tail;
+	static volatile bool deliveryQueued;
+	static volatile uint32_t droppedFrames;
 };
 
 /** @} */
@@ -103,6 +103,7 @@ SUBTYPES = {
         "spiffs": 0x82,
         "fwfs": 0xf1,
         "littlefs": 0xf2,
+        "archivefs": 0xf3,
     },
     STORAGE_TYPE: storage.TYPES,
     INTERNAL_TYPE: {
@@ -1,6 +1,7 @@
 COMPONENT_INCDIRS	:= src/include
 COMPONENT_SRCDIRS	:= src
 COMPONENT_DOXYGEN_INPUT := src/include
+COMPONENT_DEPENDS	:= crypto
 
 COMPONENT_VARS := ENABLE_STORAGE_SIZE64
 ifeq ($(ENABLE_STORAGE_SIZE64),1)
@@ -0,0 +1,203 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * CachedDevice.cpp
+ *
+ ****/
+
+#include "include/Storage/CachedDevice.h"
+#include <debug_progmem.h>
+
+namespace Storage
+{
+CachedDevice::CachedDevice(Device& device, uint16_t sectorCount, Policy policy, uint16_t sectorSize)
+	: device(device), lineSize(sectorSize ?: device.getSectorSize()), policy(policy)
+{
+	lines.reset(new Line[sectorCount]{});
+	buffer.reset(new uint8_t[sectorCount * lineSize]);
+	if(lines && buffer) {
+		lineCount = sectorCount;
+	} else {
+		debug_e("[CACHE] Out of memory, caching disabled for '%s'", device.getName().c_str());
+		lineCount = 0;
+	}
+}
+
+CachedDevice::~CachedDevice()
+{
+	sync();
+}
+
+CachedDevice::Line* CachedDevice::find(storage_size_t address)
+{
+	for(unsigned i = 0; i < lineCount; ++i) {
+		auto& line = lines[i];
+		if(line.valid && line.address == address) {
+			return &line;
+		}
+	}
+	return nullptr;
+}
+
+CachedDevice::Line* CachedDevice::load(storage_size_t address, bool fill)
+{
+	// Use an empty line if available, otherwise the least recently used one
+	Line* victim{nullptr};
+	for(unsigned i = 0; i < lineCount; ++i) {
+		auto& line = lines[i];
+		if(!line.valid) {
+			victim = &line;
+			break;
+		}
+		if(victim == nullptr || int32_t(line.lastUse - victim->lastUse) < 0) {
+			victim = &line;
+		}
+	}
+	if(victim == nullptr || !flush(*victim)) {
+		return nullptr;
+	}
+
+	victim->valid = false;
+	if(fill && !device.read(address, getData(*victim), lineSize)) {
+		return nullptr;
+	}
+	victim->address = address;
+	victim->valid = true;
+	victim->dirty = false;
+	return victim;
+}
+
+bool CachedDevice::flush(Line& line)
+{
+	if(!line.valid || !line.dirty) {
+		return true;
+	}
+	if(!device.write(line.address, getData(line), lineSize)) {
+		debug_e("[CACHE] Write failed @ 0x%08llx", uint64_t(line.address));
+		return false;
+	}
+	line.dirty = false;
+	return true;
+}
+
+bool CachedDevice::read(storage_size_t address, void* dst, size_t size)
+{
+	if(lineCount == 0) {
+		return device.read(address, dst, size);
+	}
+
+	auto ptr = static_cast<uint8_t*>(dst);
+	while(size != 0) {
+		auto offset = address % lineSize;
+		auto lineAddress = address - offset;
+		auto len = std::min(size, size_t(lineSize - offset));
+		auto line = find(lineAddress);
+		if(line == nullptr) {
+			++missCount;
+			line = load(lineAddress, true);
+			if(line == nullptr) {
+				return false;
+			}
+		} else {
+			++hitCount;
+		}
+		line->lastUse = ++useCounter;
+		memcpy(ptr, getData(*line) + offset, len);
+		ptr += len;
+		address += len;
+		size -= len;
+	}
+
+	return true;
+}
+
+bool CachedDevice::write(storage_size_t address, const void* src, size_t size)
+{
+	if(lineCount == 0) {
+		return device.write(address, src, size);
+	}
+
+	if(policy == Policy::writeThrough && !device.write(address, src, size)) {
+		return false;
+	}
+
+	// Flash writes can only clear bits, so cached data must be combined with existing content
+	bool isFlash = (getType() == Type::flash);
+
+	auto ptr = static_cast<const uint8_t*>(src);
+	while(size != 0) {
+		auto offset = address % lineSize;
+		auto lineAddress = address - offset;
+		auto len = std::min(size, size_t(lineSize - offset));
+		auto line = find(lineAddress);
+		if(line != nullptr) {
+			++hitCount;
+		} else if(policy == Policy::writeBack) {
+			++missCount;
+			line = load(lineAddress, isFlash || len < lineSize);
+			if(line == nullptr) {
+				return false;
+			}
+		}
+		if(line != nullptr) {
+			line->lastUse = ++useCounter;
+			auto data = getData(*line) + offset;
+			if(isFlash) {
+				for(unsigned i = 0; i < len; ++i) {
+					data[i] &= ptr[i];
+				}
+			} else {
+				memcpy(data, ptr, len);
+			}
+			if(policy == Policy::writeBack) {
+				line->dirty = true;
+			}
+		}
+		ptr += len;
+		address += len;
+		size -= len;
+	}
+
+	return true;
+}
+
+bool CachedDevice::erase_range(storage_size_t address, storage_size_t size)
+{
+	auto endAddress = address + size;
+	for(unsigned i = 0; i < lineCount; ++i) {
+		auto& line = lines[i];
+		if(!line.valid || line.address + lineSize <= address || line.address >= endAddress) {
+			continue;
+		}
+		// Preserve modified data outside the erased region
+		if(line.address < address || line.address + lineSize > endAddress) {
+			if(!flush(line)) {
+				return false;
+			}
+		}
+		line.valid = false;
+	}
+
+	return device.erase_range(address, size);
+}
+
+bool CachedDevice::sync()
+{
+	bool res{true};
+	for(unsigned i = 0; i < lineCount; ++i) {
+		res &= flush(lines[i]);
+	}
+	return device.sync() && res;
+}
+
+void CachedDevice::invalidate()
+{
+	for(unsigned i = 0; i < lineCount; ++i) {
+		lines[i].valid = false;
+	}
+}
+
+} // namespace Storage
@@ -49,6 +49,7 @@ namespace Storage
 {
 Device::~Device()
 {
+	cancelAsync();
 	unRegisterDevice(this);
 }
 
@@ -0,0 +1,168 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * DeviceAsync.cpp - Queued erase and write operations for storage devices
+ *
+ ****/
+
+#include "include/Storage/Device.h"
+#include <Platform/System.h>
+#include <debug_progmem.h>
+
+namespace Storage
+{
+namespace
+{
+struct Operation : public LinkedObjectTemplate<Operation> {
+	using OwnedList = OwnedLinkedObjectListTemplate<Operation>;
+
+	Operation(Device& device, storage_size_t address, storage_size_t size, const uint8_t* data,
+			  Device::Callback callback)
+		: device(device), address(address), remaining(size), data(data), callback(callback)
+	{
+	}
+
+	// Perform next slice of operation
+	bool step()
+	{
+		storage_size_t len;
+		bool ok;
+		if(data == nullptr) {
+			len = device.getBlockSize();
+			ok = device.erase_range(address, len);
+		} else {
+			len = std::min(remaining, storage_size_t(STORAGE_ASYNC_WRITE_CHUNK));
+			ok = device.write(address, data, len);
+			data += len;
+		}
+		if(!ok) {
+			debug_e("[STORAGE] Async %s failed @ 0x%08llx", data ? "write" : "erase", uint64_t(address));
+			return false;
+		}
+		address += len;
+		remaining -= len;
+		return true;
+	}
+
+	Device& device;
+	storage_size_t address;
+	storage_size_t remaining;
+	const uint8_t* data; ///< nullptr for erase
+	Device::Callback callback;
+};
+
+Operation::OwnedList queue;
+bool scheduled;
+
+void schedule();
+
+// Run operation to completion, or until it fails
+bool run(Operation* op, bool once)
+{
+	bool ok{true};
+	while(ok && op->remaining != 0) {
+		ok = op->step();
+		if(once) {
+			break;
+		}
+	}
+
+	if(ok && op->remaining != 0) {
+		return true;
+	}
+
+	// Detach before invoking callback as it may queue further operations
+	auto callback = op->callback;
+	queue.remove(op);
+	if(callback) {
+		callback(ok);
+	}
+	return ok;
+}
+
+Operation* findFirst(const Device& device)
+{
+	for(auto& op : queue) {
+		if(&op.device == &device) {
+			return &op;
+		}
+	}
+	return nullptr;
+}
+
+void process()
+{
+	scheduled = false;
+	auto op = queue.head();
+	if(op != nullptr) {
+		run(op, true);
+	}
+	schedule();
+}
+
+void schedule()
+{
+	if(scheduled || queue.isEmpty()) {
+		return;
+	}
+	scheduled = System.queueCallback(process);
+	if(!scheduled) {
+		debug_w("[STORAGE] Task queue full, operation deferred");
+	}
+}
+
+bool enqueue(Operation* op)
+{
+	if(op == nullptr || !queue.add(op)) {
+		delete op;
+		return false;
+	}
+	schedule();
+	return true;
+}
+
+} // namespace
+
+bool Device::erase_range_async(storage_size_t address, storage_size_t size, Callback callback)
+{
+	auto blockSize = getBlockSize();
+	if(address % blockSize != 0 || size % blockSize != 0) {
+		debug_e("[STORAGE] erase address/size misaligned: 0x%08llx / 0x%08llx", uint64_t(address), uint64_t(size));
+		return false;
+	}
+	return enqueue(new Operation(*this, address, size, nullptr, callback));
+}
+
+bool Device::write_async(storage_size_t address, const void* src, size_t size, Callback callback)
+{
+	if(src == nullptr) {
+		return false;
+	}
+	return enqueue(new Operation(*this, address, size, static_cast<const uint8_t*>(src), callback));
+}
+
+bool Device::isBusy() const
+{
+	return findFirst(*this) != nullptr;
+}
+
+bool Device::completeAsync()
+{
+	bool res{true};
+	while(auto op = findFirst(*this)) {
+		res &= run(op, false);
+	}
+	return res;
+}
+
+void Device::cancelAsync()
+{
+	while(auto op = findFirst(*this)) {
+		queue.remove(op);
+	}
+}
+
+} // namespace Storage
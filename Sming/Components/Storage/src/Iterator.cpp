@@ -9,17 +9,28 @@
  ****/
 
 #include "include/Storage/Iterator.h"
+#include "include/Storage.h"
 #include "include/Storage/SpiFlash.h"
+#include "include/Storage/PartitionIndex.h"
 
 namespace Storage
 {
-Iterator::Iterator(Partition::Type type, uint8_t subtype) : mSearch{nullptr, type, subtype}, mDevice(spiFlash)
+Iterator::Iterator(Partition::Type type, uint8_t subtype) : mSearch{nullptr, type, subtype}
 {
+	initialize();
+	mDevice = spiFlash;
 	next();
 }
 
 void Iterator::next()
 {
+	if(mSearch.device == nullptr) {
+		auto entry = PartitionIndex::find(mPos, mSearch.type, mSearch.subType);
+		mDevice = entry ? entry->device : nullptr;
+		mInfo = entry ? entry->info : nullptr;
+		return;
+	}
+
 	while(mDevice != nullptr) {
 		mInfo = mInfo ? mInfo->getNext() : mDevice->partitions().mEntries.head();
 		if(mInfo == nullptr) {
@@ -0,0 +1,61 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * MappedPartitionStream.cpp
+ *
+ ****/
+
+#include "include/Storage/MappedPartitionStream.h"
+
+namespace Storage
+{
+uint16_t MappedPartitionStream::readMemoryBlock(char* buffer, int bufSize)
+{
+	auto len = std::min(size_t(std::max(bufSize, 0)), size_t(available()));
+	if(len != 0) {
+		memcpy_P(buffer, data + readPos, len);
+	}
+	return len;
+}
+
+size_t MappedPartitionStream::peekRegion(const char*& ptr)
+{
+#ifdef ARCH_ESP8266
+	// Mapped flash requires aligned access so cannot be passed to general code
+	if(isFlashPtr(data)) {
+		return 0;
+	}
+#endif
+	ptr = data + readPos;
+	return available();
+}
+
+int MappedPartitionStream::seekFrom(int offset, SeekOrigin origin)
+{
+	size_t newPos;
+	switch(origin) {
+	case SeekOrigin::Start:
+		newPos = offset;
+		break;
+	case SeekOrigin::Current:
+		newPos = readPos + offset;
+		break;
+	case SeekOrigin::End:
+		newPos = size + offset;
+		break;
+	default:
+		return -1;
+	}
+
+	if(newPos > size) {
+		return -1;
+	}
+
+	readPos = newPos;
+	return int(readPos);
+}
+
+} // namespace Storage
@@ -254,6 +254,46 @@ bool Partition::erase_range(storage_size_t offset, storage_size_t size)
 	return mDevice->erase_range(addr, size);
 }
 
+const void* Partition::map(storage_size_t offset, size_t size)
+{
+	if(!allowRead()) {
+		return nullptr;
+	}
+
+	auto addr = offset;
+	if(!getDeviceAddress(addr, size)) {
+		return nullptr;
+	}
+
+	return mDevice->map(addr, size);
+}
+
+void Partition::unmap(const void* ptr)
+{
+	if(mDevice != nullptr && ptr != nullptr) {
+		mDevice->unmap(ptr);
+	}
+}
+
+bool Partition::erase_range_async(storage_size_t offset, storage_size_t size, Delegate<void(bool success)> callback)
+{
+	if(!allowWrite()) {
+		return false;
+	}
+
+	auto addr = offset;
+	if(!getDeviceAddress(addr, size)) {
+		return false;
+	}
+
+	return mDevice->erase_range_async(addr, size, callback);
+}
+
+bool Partition::completeAsync()
+{
+	return mDevice ? mDevice->completeAsync() : false;
+}
+
 uint16_t Partition::getSectorSize() const
 {
 	return mDevice ? mDevice->getSectorSize() : Device::defaultSectorSize;
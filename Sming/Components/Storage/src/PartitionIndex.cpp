@@ -0,0 +1,109 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * PartitionIndex.cpp
+ *
+ ****/
+
+#include "include/Storage/PartitionIndex.h"
+#include "include/Storage.h"
+#include "include/Storage/SpiFlash.h"
+#include <memory>
+
+namespace Storage
+{
+namespace
+{
+std::unique_ptr<PartitionIndex::Entry[]> entries;
+uint16_t entryCount;
+bool valid;
+
+// FNV-1a
+uint32_t nameHash(const char* name, size_t length)
+{
+	uint32_t hash{2166136261U};
+	while(length-- != 0) {
+		hash = (hash ^ uint8_t(*name++)) * 16777619U;
+	}
+	return hash;
+}
+
+} // namespace
+
+uint16_t PartitionIndex::revision;
+
+void PartitionIndex::invalidate()
+{
+	entries.reset();
+	entryCount = 0;
+	valid = false;
+	++revision;
+}
+
+bool PartitionIndex::build()
+{
+	if(valid) {
+		return true;
+	}
+
+	initialize();
+	Device::List devices(spiFlash);
+	unsigned count{0};
+	for(auto& dev : devices) {
+		count += dev.partitions().mEntries.count();
+	}
+
+	entries.reset(new Entry[count]);
+	if(!entries) {
+		entryCount = 0;
+		return false;
+	}
+
+	auto entry = entries.get();
+	for(auto& dev : devices) {
+		for(auto& info : dev.partitions().mEntries) {
+			*entry++ = Entry{&dev, &info, nameHash(info.name.c_str(), info.name.length()), info.fullType()};
+		}
+	}
+	entryCount = count;
+	valid = true;
+	return true;
+}
+
+Partition PartitionIndex::find(const String& name)
+{
+	if(!build()) {
+		return Partition{};
+	}
+
+	auto hash = nameHash(name.c_str(), name.length());
+	for(unsigned i = 0; i < entryCount; ++i) {
+		auto& entry = entries[i];
+		if(entry.nameHash == hash && entry.info->name.equals(name)) {
+			return Partition(*entry.device, *entry.info);
+		}
+	}
+
+	return Partition{};
+}
+
+const PartitionIndex::Entry* PartitionIndex::find(uint16_t& pos, Partition::Type type, uint8_t subType)
+{
+	if(!build()) {
+		return nullptr;
+	}
+
+	while(pos < entryCount) {
+		auto& entry = entries[pos++];
+		if(entry.match(type, subType)) {
+			return &entry;
+		}
+	}
+
+	return nullptr;
+}
+
+} // namespace Storage
@@ -0,0 +1,89 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * PartitionSelector.cpp
+ *
+ ****/
+
+#include "include/Storage/PartitionSelector.h"
+#include <debug_progmem.h>
+
+namespace Storage
+{
+namespace
+{
+constexpr uint32_t selectionMagic{0x4c455350}; // "PSEL"
+}
+
+bool PartitionSelector::begin()
+{
+	activeSlot = 0;
+	imageSize = 0;
+
+	if(!slots[0] || !slots[1] || slots[0] == slots[1]) {
+		debug_e("[PSEL] Invalid slots");
+		return false;
+	}
+
+	if(!log.begin()) {
+		return false;
+	}
+
+	// Most recent valid record wins
+	log.forEach([this](uint32_t, const void* data, uint16_t length) {
+		Selection sel;
+		if(length == sizeof(sel)) {
+			memcpy(&sel, data, sizeof(sel));
+			if(sel.magic == selectionMagic && sel.slot < 2) {
+				activeSlot = sel.slot;
+				imageSize = sel.imageSize;
+			}
+		}
+		return true;
+	});
+
+	debug_i("[PSEL] Active '%s'", getActive().name().c_str());
+	return true;
+}
+
+PartitionStream* PartitionSelector::createUpdateStream(size_t size)
+{
+	auto part = getSpare();
+	if(size > part.size()) {
+		debug_e("[PSEL] Image size %u exceeds '%s'", size, part.name().c_str());
+		return nullptr;
+	}
+
+	auto stream = new PartitionStream(part, Mode::BlockErase);
+	if(stream != nullptr && size != 0) {
+		stream->reserve(size);
+	}
+	return stream;
+}
+
+bool PartitionSelector::commit(size_t size)
+{
+	uint8_t slot = activeSlot ^ 1;
+	if(size > slots[slot].size()) {
+		return false;
+	}
+
+	Selection sel{};
+	sel.magic = selectionMagic;
+	sel.imageSize = size;
+	sel.slot = slot;
+	if(!log.append(&sel, sizeof(sel))) {
+		debug_e("[PSEL] Commit failed");
+		return false;
+	}
+
+	activeSlot = slot;
+	imageSize = size;
+	debug_i("[PSEL] Switched to '%s'", getActive().name().c_str());
+	return true;
+}
+
+} // namespace Storage
@@ -57,6 +57,12 @@ size_t PartitionStream::write(const uint8_t* data, size_t length)
 
 	if(mode == Mode::BlockErase) {
 		auto endPos = writePos + len;
+		if(endPos > erasePos && erasePending) {
+			// Background erase has not caught up: finish the current block only
+			eraseChainPaused = true;
+			partition.completeAsync();
+			eraseChainPaused = false;
+		}
 		if(endPos > erasePos) {
 			size_t blockSize = partition.getBlockSize();
 			size_t eraseLen = endPos - erasePos + blockSize - 1;
@@ -74,7 +80,45 @@ size_t PartitionStream::write(const uint8_t* data, size_t length)
 	}
 
 	writePos += len;
+
+	if(mode == Mode::BlockErase) {
+		eraseAhead();
+	}
+
 	return len;
 }
 
+bool PartitionStream::reserve(size_t length)
+{
+	if(mode != Mode::BlockErase || length > size) {
+		return false;
+	}
+
+	eraseLimit = length;
+	eraseAhead();
+	return true;
+}
+
+void PartitionStream::eraseAhead()
+{
+	if(erasePending || eraseChainPaused) {
+		return;
+	}
+
+	size_t blockSize = partition.getBlockSize();
+	auto limit = std::min(std::max<size_t>(writePos + blockSize, eraseLimit), size);
+	if(erasePos >= limit) {
+		return;
+	}
+
+	erasePending = partition.erase_range_async(startOffset + erasePos, blockSize, [this, blockSize](bool success) {
+		erasePending = false;
+		if(success) {
+			erasePos += blockSize;
+			// Continue through any reserved region
+			eraseAhead();
+		}
+	});
+}
+
 } // namespace Storage
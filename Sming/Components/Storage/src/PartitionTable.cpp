@@ -16,7 +16,7 @@ namespace Storage
 {
 void PartitionTable::load(const esp_partition_info_t* entry, unsigned count)
 {
-	mEntries.clear();
+	clear();
 	for(; count != 0; --count, ++entry) {
 		// name may not be zero-terminated
 		char name[Partition::nameSize + 1];
@@ -0,0 +1,274 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * RecordLog.cpp
+ *
+ ****/
+
+#include "include/Storage/RecordLog.h"
+#include <debug_progmem.h>
+#include <Crypto/Crc.h>
+
+namespace Storage
+{
+namespace
+{
+constexpr uint32_t sectorMagic{0x474f4c52}; // "RLOG"
+
+// Records start on word boundaries
+constexpr uint32_t align(uint32_t size)
+{
+	return (size + 3) & ~3U;
+}
+
+// CRC-16/CCITT
+uint16_t checksum(uint16_t length, const void* data)
+{
+	return Crypto::crc16Ccitt(data, length, Crypto::crc16Ccitt(&length, sizeof(length)));
+}
+
+} // namespace
+
+uint16_t RecordLog::getMaxRecordLength() const
+{
+	auto len = sectorSize - sizeof(SectorHeader) - sizeof(RecordHeader);
+	return std::min(uint32_t(len), uint32_t(RECORD_LOG_MAX_RECORD_SIZE));
+}
+
+bool RecordLog::begin()
+{
+	index.reset();
+	if(!partition) {
+		return false;
+	}
+
+	sectorSize = partition.getBlockSize();
+	auto count = partition.size() / sectorSize;
+	if(count < 2 || count > UINT16_MAX || sectorSize <= sizeof(SectorHeader) + sizeof(RecordHeader)) {
+		debug_e("[RLOG] Partition '%s' unsuitable", partition.name().c_str());
+		return false;
+	}
+	sectorCount = count;
+
+	index.reset(new uint32_t[sectorCount]);
+	if(!index) {
+		return false;
+	}
+
+	// Most recently written sector has highest ID
+	int head{-1};
+	for(unsigned i = 0; i < sectorCount; ++i) {
+		SectorHeader hdr;
+		if(!partition.read(sectorAddress(i), &hdr, sizeof(hdr))) {
+			index.reset();
+			return false;
+		}
+		index[i] = (hdr.magic == sectorMagic) ? hdr.firstId : invalidId;
+		if(index[i] != invalidId && (head < 0 || index[i] > index[head])) {
+			head = i;
+		}
+	}
+
+	if(head < 0) {
+		// Empty, start writing at sector 0
+		headSector = sectorCount - 1;
+		writeOffset = sectorSize;
+		nextId = 0;
+		return true;
+	}
+
+	// Find end of head sector
+	headSector = head;
+	nextId = index[head];
+	writeOffset = sizeof(SectorHeader);
+	uint8_t buffer[RECORD_LOG_MAX_RECORD_SIZE];
+	uint16_t length;
+	while(readRecord(headSector, writeOffset, length, buffer)) {
+		++nextId;
+	}
+
+	// Discard remainder of sector if last write was incomplete
+	if(writeOffset + sizeof(RecordHeader) <= sectorSize) {
+		RecordHeader hdr;
+		if(!partition.read(sectorAddress(headSector) + writeOffset, &hdr, sizeof(hdr)) || hdr.length != 0xffff ||
+		   hdr.check != 0xffff) {
+			debug_w("[RLOG] Invalid record %u @ 0x%08x", nextId, writeOffset);
+			writeOffset = sectorSize;
+		}
+	}
+
+	debug_i("[RLOG] %u records, next ID %u", getCount(), nextId);
+	return true;
+}
+
+bool RecordLog::format()
+{
+	if(!index) {
+		return false;
+	}
+	for(unsigned i = 0; i < sectorCount; ++i) {
+		index[i] = invalidId;
+	}
+	headSector = sectorCount - 1;
+	writeOffset = sectorSize;
+	nextId = 0;
+	return partition.erase_range(0, sectorAddress(sectorCount));
+}
+
+uint32_t RecordLog::getFirstId() const
+{
+	uint32_t id = nextId;
+	if(index) {
+		for(unsigned i = 0; i < sectorCount; ++i) {
+			id = std::min(id, index[i]);
+		}
+	}
+	return id;
+}
+
+int RecordLog::findSector(uint32_t id) const
+{
+	int sector{-1};
+	for(unsigned i = 0; i < sectorCount; ++i) {
+		if(index[i] != invalidId && index[i] <= id && (sector < 0 || index[i] > index[sector])) {
+			sector = i;
+		}
+	}
+	return sector;
+}
+
+bool RecordLog::readRecord(uint16_t sector, uint32_t& offset, uint16_t& length, uint8_t* buffer)
+{
+	RecordHeader hdr;
+	if(offset + sizeof(hdr) > sectorSize ||
+	   !partition.read(sectorAddress(sector) + offset, &hdr, sizeof(hdr))) {
+		return false;
+	}
+	if(hdr.length > getMaxRecordLength() || offset + sizeof(hdr) + hdr.length > sectorSize) {
+		return false;
+	}
+	if(buffer != nullptr) {
+		if(!partition.read(sectorAddress(sector) + offset + sizeof(hdr), buffer, hdr.length)) {
+			return false;
+		}
+		if(checksum(hdr.length, buffer) != hdr.check) {
+			return false;
+		}
+	}
+	length = hdr.length;
+	offset += align(sizeof(hdr) + hdr.length);
+	return true;
+}
+
+bool RecordLog::startSector(uint16_t sector)
+{
+	index[sector] = invalidId;
+	if(!partition.erase_range(sectorAddress(sector), sectorSize)) {
+		return false;
+	}
+	SectorHeader hdr{sectorMagic, nextId};
+	if(!partition.write(sectorAddress(sector), &hdr, sizeof(hdr))) {
+		return false;
+	}
+	index[sector] = nextId;
+	headSector = sector;
+	writeOffset = sizeof(hdr);
+	return true;
+}
+
+bool RecordLog::append(const void* data, uint16_t length)
+{
+	if(!index || length > getMaxRecordLength()) {
+		return false;
+	}
+
+	size_t recordSize = sizeof(RecordHeader) + length;
+	if(writeOffset + recordSize > sectorSize) {
+		if(!startSector((headSector + 1) % sectorCount)) {
+			return false;
+		}
+	}
+
+	// Write header and content together
+	uint8_t buffer[sizeof(RecordHeader) + RECORD_LOG_MAX_RECORD_SIZE];
+	auto hdr = reinterpret_cast<RecordHeader*>(buffer);
+	hdr->length = length;
+	hdr->check = checksum(length, data);
+	memcpy(&buffer[sizeof(RecordHeader)], data, length);
+	if(!partition.write(sectorAddress(headSector) + writeOffset, buffer, recordSize)) {
+		// Don't write any more to this sector
+		writeOffset = sectorSize;
+		return false;
+	}
+
+	writeOffset += align(recordSize);
+	++nextId;
+	return true;
+}
+
+int RecordLog::read(uint32_t id, void* buffer, uint16_t bufSize)
+{
+	if(!index || id >= nextId) {
+		return -1;
+	}
+	int sector = findSector(id);
+	if(sector < 0) {
+		return -1;
+	}
+
+	// Skip preceding records
+	uint32_t offset = sizeof(SectorHeader);
+	uint16_t length;
+	for(auto n = id - index[sector]; n != 0; --n) {
+		if(!readRecord(sector, offset, length, nullptr)) {
+			return -1;
+		}
+	}
+
+	uint8_t tmp[RECORD_LOG_MAX_RECORD_SIZE];
+	if(!readRecord(sector, offset, length, tmp) || length > bufSize) {
+		return -1;
+	}
+	memcpy(buffer, tmp, length);
+	return length;
+}
+
+bool RecordLog::forEach(Callback callback, uint32_t startId)
+{
+	if(!index || !callback) {
+		return false;
+	}
+
+	startId = std::max(startId, getFirstId());
+	if(startId >= nextId) {
+		return true;
+	}
+	int sector = findSector(startId);
+	if(sector < 0) {
+		return false;
+	}
+
+	uint8_t buffer[RECORD_LOG_MAX_RECORD_SIZE];
+	for(;;) {
+		auto next = (sector + 1) % sectorCount;
+		uint32_t endId = (sector == headSector) ? nextId : index[next];
+		uint32_t id = index[sector];
+		uint32_t offset = sizeof(SectorHeader);
+		uint16_t length;
+		while(id < endId && readRecord(sector, offset, length, buffer)) {
+			if(id >= startId && !callback(id, buffer, length)) {
+				return true;
+			}
+			++id;
+		}
+		if(sector == headSector) {
+			return true;
+		}
+		sector = next;
+	}
+}
+
+} // namespace Storage
@@ -12,12 +12,18 @@
 #include "include/Storage/partition_info.h"
 #include <esp_spi_flash.h>
 #include <debug_progmem.h>
+#include <Services/Profiling/Metrics.h>
 
 namespace Storage
 {
 DEFINE_FSTR(FS_SPIFLASH, "spiFlash")
 SpiFlash* spiFlash;
 
+namespace
+{
+METRIC_HISTOGRAM(flashWriteTime, "sming_flash_write_duration_us", "Time taken by flash write operations");
+} // namespace
+
 String SpiFlash::getName() const
 {
 	return FS_SPIFLASH;
@@ -46,7 +52,10 @@ bool SpiFlash::read(storage_size_t address, void* dst, size_t size)
 
 bool SpiFlash::write(storage_size_t address, const void* src, size_t size)
 {
+	Profiling::Metrics::Stopwatch timer;
+	timer.start();
 	size_t writeCount = flashmem_write(src, address, size);
+	timer.stop(flashWriteTime);
 	return writeCount == size;
 }
 
@@ -69,4 +78,14 @@ bool SpiFlash::erase_range(storage_size_t address, storage_size_t size)
 	return true;
 }
 
+const void* SpiFlash::map(storage_size_t address, size_t size)
+{
+	return flashmem_map(address, size);
+}
+
+void SpiFlash::unmap(const void* ptr)
+{
+	flashmem_unmap(ptr);
+}
+
 } // namespace Storage
@@ -10,6 +10,7 @@
 
 #include "include/Storage.h"
 #include "include/Storage/SpiFlash.h"
+#include "include/Storage/PartitionIndex.h"
 #include <debug_progmem.h>
 
 namespace Storage
@@ -25,6 +26,7 @@ void initialize()
 
 const Device::List getDevices()
 {
+	initialize();
 	return Device::List(spiFlash);
 }
 
@@ -33,12 +35,14 @@ bool registerDevice(Device* device)
 	if(device == nullptr) {
 		return false;
 	}
+	initialize();
 	auto devname = device->getName();
 
 	Device::List devices(spiFlash);
 	auto it = std::find(devices.begin(), devices.end(), devname);
 	if(!it) {
 		devices.add(device);
+		PartitionIndex::invalidate();
 		device->loadPartitions(*spiFlash, PARTITION_TABLE_OFFSET);
 		debug_i("[Storage] Device '%s' registered", devname.c_str());
 	} else if(*it != *device) {
@@ -51,25 +55,23 @@ bool registerDevice(Device* device)
 
 bool unRegisterDevice(Device* device)
 {
-	return Device::List(spiFlash).remove(device);
+	if(!Device::List(spiFlash).remove(device)) {
+		return false;
+	}
+	PartitionIndex::invalidate();
+	return true;
 }
 
 Device* findDevice(const String& name)
 {
+	initialize();
 	Device::List devices(spiFlash);
 	return std::find(devices.begin(), devices.end(), name);
 }
 
 Partition findPartition(const String& name)
 {
-	for(auto& dev : getDevices()) {
-		auto part = dev.partitions().find(name);
-		if(part) {
-			return part;
-		}
-	}
-
-	return Partition{};
+	return PartitionIndex::find(name);
 }
 
 } // namespace Storage
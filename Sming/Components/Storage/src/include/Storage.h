@@ -14,7 +14,9 @@
 namespace Storage
 {
 /**
- * @brief Called early in the startup phase
+ * @brief Load the partition table from flash
+ * @note Called early in the startup phase, or on first use of the Storage API if ENABLE_FAST_BOOT is set.
+ * Calling it again is a no-op.
  */
 void initialize();
 
@@ -0,0 +1,169 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * CachedDevice.h
+ *
+ ****/
+#pragma once
+
+#include "Device.h"
+#include <memory>
+
+namespace Storage
+{
+/**
+ * @brief Sector cache layered over another storage device
+ *
+ * Holds a fixed number of sectors in RAM, replaced on a least-recently-used basis.
+ * Filesystems which issue many small reads to the same regions (e.g. SPIFFS lookups, FAT table walks)
+ * are then serviced from RAM instead of the physical device.
+ *
+ * To use, construct over the physical device and add the required partitions:
+ *
+ * ```
+ * auto cache = new Storage::CachedDevice(*Storage::spiFlash, 8);
+ * Storage::registerDevice(cache);
+ * auto part = cache->addPartition(*Storage::findPartition("spiffs0"));
+ * ```
+ *
+ * @note For flash devices, writes can only clear bits so cached data is updated accordingly.
+ * The underlying device must not be written directly while cached data is in use.
+ */
+class CachedDevice : public Device
+{
+public:
+	enum class Policy {
+		writeThrough, ///< Writes go directly to device, cached data updated
+		writeBack,	///< Writes update the cache only, device written on eviction or `sync()`
+	};
+
+	/**
+	 * @brief Constructor
+	 * @param device The physical device to cache
+	 * @param sectorCount Number of sectors to hold in RAM
+	 * @param policy Write policy
+	 * @param sectorSize Size of each cached sector, a power of 2. If 0, use the device sector size.
+	 */
+	CachedDevice(Device& device, uint16_t sectorCount, Policy policy = Policy::writeBack, uint16_t sectorSize = 0);
+
+	~CachedDevice();
+
+	/**
+	 * @brief Add a partition for this device, taken from the underlying device
+	 */
+	Partition addPartition(const Partition& part)
+	{
+		return mPartitions.add(part.name(), part.fullType(), part.address(), part.size(), part.flags());
+	}
+
+	String getName() const override
+	{
+		return device.getName() + F("_cache");
+	}
+
+	uint32_t getId() const override
+	{
+		return device.getId();
+	}
+
+	size_t getBlockSize() const override
+	{
+		return device.getBlockSize();
+	}
+
+	storage_size_t getSize() const override
+	{
+		return device.getSize();
+	}
+
+	Type getType() const override
+	{
+		return device.getType();
+	}
+
+	uint16_t getSectorSize() const override
+	{
+		return device.getSectorSize();
+	}
+
+	storage_size_t getSectorCount() const override
+	{
+		return device.getSectorCount();
+	}
+
+	bool read(storage_size_t address, void* dst, size_t size) override;
+	bool write(storage_size_t address, const void* src, size_t size) override;
+	bool erase_range(storage_size_t address, storage_size_t size) override;
+
+	/**
+	 * @brief Write all modified sectors to the device
+	 */
+	bool sync() override;
+
+	/**
+	 * @brief Discard all cached data, without writing modified sectors
+	 */
+	void invalidate();
+
+	Device& getDevice() const
+	{
+		return device;
+	}
+
+	Policy getPolicy() const
+	{
+		return policy;
+	}
+
+	/**
+	 * @name Cache statistics
+	 * @{
+	 */
+	uint32_t getHitCount() const
+	{
+		return hitCount;
+	}
+
+	uint32_t getMissCount() const
+	{
+		return missCount;
+	}
+
+	void resetStats()
+	{
+		hitCount = missCount = 0;
+	}
+	/** @} */
+
+private:
+	struct Line {
+		storage_size_t address;
+		uint32_t lastUse;
+		bool valid;
+		bool dirty;
+	};
+
+	uint8_t* getData(const Line& line)
+	{
+		return &buffer[(&line - lines.get()) * lineSize];
+	}
+
+	Line* find(storage_size_t address);
+	Line* load(storage_size_t address, bool fill);
+	bool flush(Line& line);
+
+	Device& device;
+	std::unique_ptr<Line[]> lines;
+	std::unique_ptr<uint8_t[]> buffer;
+	uint16_t lineCount;
+	uint16_t lineSize;
+	Policy policy;
+	uint32_t useCounter{0};
+	uint32_t hitCount{0};
+	uint32_t missCount{0};
+};
+
+} // namespace Storage
@@ -12,8 +12,16 @@
 #include <WString.h>
 #include <Printable.h>
 #include <Data/LinkedObjectList.h>
+#include <Delegate.h>
 #include "PartitionTable.h"
 
+/**
+ * @brief Maximum number of bytes written for each slice of an asynchronous write
+ */
+#ifndef STORAGE_ASYNC_WRITE_CHUNK
+#define STORAGE_ASYNC_WRITE_CHUNK 256
+#endif
+
 #define STORAGE_TYPE_MAP(XX)                                                                                           \
 	XX(unknown, 0x00, "Other storage device")                                                                          \
 	XX(flash, 0x01, "SPI flash")                                                                                       \
@@ -152,6 +160,30 @@ public:
 	 */
 	virtual bool erase_range(storage_size_t address, storage_size_t size) = 0;
 
+	/**
+	 * @brief Obtain a pointer for reading device content directly
+	 * @param address Start of region
+	 * @param size Size of region, in bytes
+	 * @retval const void* nullptr if the device does not support memory-mapped access
+	 * @note Release the mapping using `unmap()` when finished.
+	 * On some architectures (e.g. Esp8266) mapped flash must be read using aligned 32-bit accesses:
+	 * use `memcpy_P` or similar.
+	 */
+	virtual const void* map(storage_size_t address, size_t size)
+	{
+		(void)address;
+		(void)size;
+		return nullptr;
+	}
+
+	/**
+	 * @brief Release a mapping obtained via `map()`
+	 */
+	virtual void unmap(const void* ptr)
+	{
+		(void)ptr;
+	}
+
 	/**
 	 * @brief Get sector size, the unit of allocation for block-access devices
 	 *
@@ -182,6 +214,66 @@ public:
 		return true;
 	}
 
+	/**
+	 * @name Asynchronous operations
+	 *
+	 * Erasing and writing large regions of flash can take a long time, during which
+	 * networking and other tasks are unable to run. These methods queue the operation and perform
+	 * it in slices from the task queue: erasure is done one block at a time, writes in chunks of
+	 * `STORAGE_ASYNC_WRITE_CHUNK` bytes.
+	 *
+	 * Operations are performed in the order they are queued.
+	 * Pending operations are cancelled, without invoking callbacks, if the device is destroyed.
+	 *
+	 * @{
+	 */
+
+	/**
+	 * @brief Invoked when an asynchronous operation has completed
+	 * @param success false if the operation failed
+	 */
+	using Callback = Delegate<void(bool success)>;
+
+	/**
+	 * @brief Queue a region for erasure
+	 * @param address Where to start erasing, must be a multiple of the block size
+	 * @param size Size of region to erase, must be a multiple of the block size
+	 * @param callback Invoked when erasure has completed
+	 * @retval bool false if parameters are invalid or out of memory
+	 */
+	bool erase_range_async(storage_size_t address, storage_size_t size, Callback callback = nullptr);
+
+	/**
+	 * @brief Queue data for writing
+	 * @param address Where to start writing
+	 * @param src Data to write, must remain valid until the callback is invoked
+	 * @param size Size of data to be written, in bytes
+	 * @param callback Invoked when writing has completed
+	 * @retval bool false if out of memory
+	 */
+	bool write_async(storage_size_t address, const void* src, size_t size, Callback callback = nullptr);
+
+	/**
+	 * @brief Determine if any asynchronous operations are pending for this device
+	 */
+	bool isBusy() const;
+
+	/**
+	 * @brief Perform all pending asynchronous operations for this device immediately
+	 * @retval bool false if any operation failed
+	 *
+	 * Use this when data is required without further delay. Callbacks are invoked as normal.
+	 */
+	bool completeAsync();
+
+	/**
+	 * @brief Discard all pending asynchronous operations for this device
+	 * @note Callbacks are not invoked
+	 */
+	void cancelAsync();
+
+	/** @} */
+
 	/**
 	 * @name Default sector size for block-based devices
 	 */
@@ -94,6 +94,7 @@ private:
 	Search mSearch{};
 	Device* mDevice{nullptr};
 	const Partition::Info* mInfo{nullptr};
+	uint16_t mPos{0}; ///< Position in PartitionIndex for global search
 };
 
 } // namespace Storage
@@ -0,0 +1,98 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * MappedPartitionStream.h
+ *
+ ****/
+
+#pragma once
+
+#include <Data/Stream/DataSourceStream.h>
+#include "Partition.h"
+
+namespace Storage
+{
+/**
+ * @brief Read-only stream accessing partition content via memory-mapping
+ *
+ * Suitable for serving large read-only assets such as web content or fonts.
+ * Where the architecture permits byte access to the mapped region, `peekRegion()` provides direct
+ * access so TcpConnection can send data without an intermediate copy.
+ *
+ * Check `isValid()` after construction: if the device does not support mapping then use
+ * a regular `PartitionStream` instead.
+ *
+ * @ingroup stream
+ */
+class MappedPartitionStream : public IDataSourceStream
+{
+public:
+	/**
+	 * @brief Access part of a partition
+	 * @param partition
+	 * @param offset Start of region within partition
+	 * @param size Size of region
+	 */
+	MappedPartitionStream(Partition partition, storage_size_t offset, size_t size)
+		: partition(partition), data(static_cast<const char*>(this->partition.map(offset, size))), size(size)
+	{
+	}
+
+	/**
+	 * @brief Access entire partition
+	 */
+	MappedPartitionStream(Partition partition) : MappedPartitionStream(partition, 0, partition.size())
+	{
+	}
+
+	~MappedPartitionStream()
+	{
+		partition.unmap(data);
+	}
+
+	StreamType getStreamType() const override
+	{
+		return eSST_Memory;
+	}
+
+	bool isValid() const override
+	{
+		return data != nullptr;
+	}
+
+	int available() override
+	{
+		return data ? size - readPos : 0;
+	}
+
+	uint16_t readMemoryBlock(char* buffer, int bufSize) override;
+
+	size_t peekRegion(const char*& ptr) override;
+
+	int seekFrom(int offset, SeekOrigin origin) override;
+
+	bool isFinished() override
+	{
+		return available() <= 0;
+	}
+
+	/**
+	 * @brief Get pointer to start of mapped region
+	 * @retval const char* nullptr if mapping failed
+	 */
+	const char* getData() const
+	{
+		return data;
+	}
+
+private:
+	Partition partition;
+	const char* data;
+	size_t size;
+	size_t readPos{0};
+};
+
+} // namespace Storage
@@ -30,6 +30,7 @@
 #include <Data/BitSet.h>
 #include <Data/CString.h>
 #include <Data/LinkedObjectList.h>
+#include <Delegate.h>
 #include <cassert>
 #include "Types.h"
 
@@ -66,7 +67,8 @@
 	XX(fat, 0x81, "FAT")                                                                                               \
 	XX(spiffs, 0x82, "SPIFFS")                                                                                         \
 	XX(fwfs, 0xF1, "FWFS")                                                                                             \
-	XX(littlefs, 0xF2, "LittleFS")
+	XX(littlefs, 0xF2, "LittleFS")                                                                                     \
+	XX(archivefs, 0xF3, "ArchiveFS")
 
 namespace Storage
 {
@@ -313,6 +315,36 @@ public:
 	 */
 	bool erase_range(storage_size_t offset, storage_size_t size);
 
+	/**
+	 * @brief Obtain a pointer for reading partition content directly
+	 * @param offset Start of region, relative to start of partition
+	 * @param size Size of region, in bytes
+	 * @retval const void* nullptr if region is out of range or device does not support mapping
+	 * @see See `Storage::Device::map`
+	 */
+	const void* map(storage_size_t offset, size_t size);
+
+	/**
+	 * @brief Release a mapping obtained via `map()`
+	 */
+	void unmap(const void* ptr);
+
+	/**
+	 * @brief Queue part of the partition for erasure in the background
+	 * @param offset Where to start erasing, relative to start of partition
+	 * @param size Size of region to erase, in bytes
+	 * @param callback Invoked when erasure has completed
+	 * @retval bool false if parameters are invalid
+	 * @see See `Storage::Device::erase_range_async`
+	 */
+	bool erase_range_async(storage_size_t offset, storage_size_t size, Delegate<void(bool success)> callback = nullptr);
+
+	/**
+	 * @brief Perform any pending asynchronous operations for the storage device immediately
+	 * @see See `Storage::Device::completeAsync`
+	 */
+	bool completeAsync();
+
 	/**
 	 * @brief Obtain partition type
 	 */
@@ -0,0 +1,78 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * PartitionIndex.h - Lookup table for partitions on all registered devices
+ *
+ ****/
+#pragma once
+
+#include "Partition.h"
+
+namespace Storage
+{
+/**
+ * @brief Flat table of partitions across all registered devices
+ *
+ * Built on first use and discarded whenever a device is registered or a partition table changes.
+ * Global partition searches then scan a compact array instead of walking the partition list
+ * of every device, and name lookups compare hashes rather than strings.
+ *
+ * Entries are in device registration order, then partition table order,
+ * so searches return the same results as walking the tables directly.
+ */
+class PartitionIndex
+{
+public:
+	struct Entry {
+		Device* device;
+		const Partition::Info* info;
+		uint32_t nameHash;
+		Partition::FullType type;
+
+		bool match(Partition::Type type, uint8_t subType) const
+		{
+			return (type == Partition::Type::any || type == this->type.type) &&
+				   (subType == Partition::SubType::any || subType == this->type.subtype);
+		}
+	};
+
+	/**
+	 * @brief Discard index so it gets rebuilt on next use
+	 */
+	static void invalidate();
+
+	/**
+	 * @brief Find partition by name
+	 */
+	static Partition find(const String& name);
+
+	/**
+	 * @brief Find next entry of the given type
+	 * @param pos Position to start searching, updated to follow any matching entry
+	 * @param type
+	 * @param subType
+	 * @retval const Entry* nullptr if there are no more matches
+	 */
+	static const Entry* find(uint16_t& pos, Partition::Type type, uint8_t subType);
+
+	/**
+	 * @brief Get revision number
+	 *
+	 * Changes whenever the index is invalidated.
+	 * Code caching a `Partition` handle may compare this value to determine whether it needs refreshing.
+	 */
+	static uint16_t getRevision()
+	{
+		return revision;
+	}
+
+private:
+	static bool build();
+
+	static uint16_t revision;
+};
+
+} // namespace Storage
@@ -0,0 +1,122 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * PartitionSelector.h - Persistent choice between two image partitions
+ *
+ ****/
+
+#pragma once
+
+#include "RecordLog.h"
+#include "PartitionStream.h"
+
+namespace Storage
+{
+/**
+ * @brief Switch between two partitions holding complete filesystem images
+ *
+ * A new image, such as one built by `spiffsgen.py`, is streamed into the spare partition
+ * with one sequential write whilst the active filesystem remains mounted and unchanged.
+ * Calling `commit()` then makes the spare partition active.
+ *
+ * The selection is recorded in a small dedicated partition, at least two sectors, using a RecordLog.
+ * A single checksummed record is written for each switch, so an interrupted commit leaves
+ * the previous image selected.
+ *
+ * ```
+ * Storage::PartitionSelector fsSelector(*Storage::findPartition("fsselect"),
+ *                                       *Storage::findPartition("spiffs0"),
+ *                                       *Storage::findPartition("spiffs1"));
+ * fsSelector.begin();
+ * spiffs_mount(fsSelector.getActive());
+ * ```
+ */
+class PartitionSelector
+{
+public:
+	/**
+	 * @brief Constructor
+	 * @param selector Partition to record the selection
+	 * @param slot0 Selected when no selection has been recorded
+	 * @param slot1
+	 */
+	PartitionSelector(Partition selector, Partition slot0, Partition slot1) : log(selector), slots{slot0, slot1}
+	{
+	}
+
+	/**
+	 * @brief Read the current selection
+	 * @retval bool false if any partition is unsuitable
+	 */
+	bool begin();
+
+	/**
+	 * @brief Get partition containing the image in use
+	 */
+	Partition getActive() const
+	{
+		return slots[activeSlot];
+	}
+
+	/**
+	 * @brief Get partition which may be overwritten with a new image
+	 */
+	Partition getSpare() const
+	{
+		return slots[activeSlot ^ 1];
+	}
+
+	/**
+	 * @brief Get index of active partition, 0 or 1
+	 */
+	uint8_t getActiveSlot() const
+	{
+		return activeSlot;
+	}
+
+	/**
+	 * @brief Get size of active image as given to `commit()`
+	 * @retval size_t 0 if not known
+	 */
+	size_t getImageSize() const
+	{
+		return imageSize;
+	}
+
+	/**
+	 * @brief Create a stream to write a new image into the spare partition
+	 * @param size Expected size of image, if known, so erasure can proceed ahead of writing
+	 * @retval PartitionStream* nullptr if size exceeds spare partition
+	 *
+	 * Blocks are erased as they are reached, so only the space actually written is erased.
+	 */
+	PartitionStream* createUpdateStream(size_t size = 0);
+
+	/**
+	 * @brief Make the spare partition active
+	 * @param size Size of image written, for information
+	 * @retval bool true on success, false leaves selection unchanged
+	 *
+	 * The new image should be fully written and verified first. Any filesystem mounted
+	 * from the previously active partition must then be unmounted and re-mounted
+	 * from `getActive()`.
+	 */
+	bool commit(size_t size = 0);
+
+private:
+	struct Selection {
+		uint32_t magic;
+		uint32_t imageSize;
+		uint8_t slot;
+	};
+
+	RecordLog log;
+	Partition slots[2];
+	uint32_t imageSize{0};
+	uint8_t activeSlot{0};
+};
+
+} // namespace Storage
@@ -18,7 +18,7 @@ namespace Storage
 enum class Mode {
 	ReadOnly,
 	Write,		///< Write but do not erase, region should be pre-erased
-	BlockErase, ///< Erase blocks as required before writing
+	BlockErase, ///< Erase blocks as required before writing, the next block is erased in the background
 };
 
 /**
@@ -70,6 +70,8 @@ public:
 	 * @note When writing in Mode::BlockErase, block erasure is only performed at the
 	 * start of each block. Therefore if `offset` is not a block boundary then the corresponding
 	 * block will *not* be erased first.
+	 * The block following the current write position is queued for erasure in the background,
+	 * so may be erased even if no data is subsequently written to it.
 	 */
 	PartitionStream(Partition partition, storage_size_t offset, size_t size, Mode mode = Mode::ReadOnly)
 		: partition(partition), startOffset(offset), size(size), mode(mode)
@@ -88,6 +90,14 @@ public:
 	{
 	}
 
+	~PartitionStream()
+	{
+		// Erase callback refers to this stream
+		if(erasePending) {
+			partition.completeAsync();
+		}
+	}
+
 	int available() override
 	{
 		return size - readPos;
@@ -104,14 +114,30 @@ public:
 		return available() <= 0;
 	}
 
+	/**
+	 * @brief Erase ahead of the write position in the background
+	 * @param length Expected number of bytes to be written, from start of stream
+	 * @retval bool false if stream isn't in Mode::BlockErase or length exceeds stream size
+	 *
+	 * Where the total size is known in advance, such as from a `Content-Length` header,
+	 * this allows erasure to proceed whilst waiting for data so writes don't stall.
+	 * Blocks are erased one at a time via the task queue.
+	 */
+	bool reserve(size_t length);
+
 private:
+	void eraseAhead();
+
 	Partition partition;
 	storage_size_t startOffset;
 	size_t size;
 	uint32_t writePos{0};
 	uint32_t readPos{0};
 	uint32_t erasePos{0};
+	uint32_t eraseLimit{0};
 	Mode mode;
+	bool erasePending{false};
+	bool eraseChainPaused{false};
 };
 
 } // namespace Storage
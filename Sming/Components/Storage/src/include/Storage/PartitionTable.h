@@ -11,6 +11,7 @@
 
 #include "Partition.h"
 #include "Iterator.h"
+#include "PartitionIndex.h"
 
 namespace Storage
 {
@@ -105,7 +106,11 @@ public:
 	 */
 	Partition add(const Partition::Info* info)
 	{
-		return mEntries.add(info) ? Partition(mDevice, *info) : Partition{};
+		if(!mEntries.add(info)) {
+			return Partition{};
+		}
+		PartitionIndex::invalidate();
+		return Partition(mDevice, *info);
 	}
 
 	template <typename... Args> Partition add(const String& name, Partition::FullType type, Args... args)
@@ -116,11 +121,13 @@ public:
 	void clear()
 	{
 		mEntries.clear();
+		PartitionIndex::invalidate();
 	}
 
 protected:
 	friend Device;
 	friend Iterator;
+	friend PartitionIndex;
 
 	void load(const esp_partition_info_t* entry, unsigned count);
 
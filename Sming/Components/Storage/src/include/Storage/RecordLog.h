@@ -0,0 +1,161 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * RecordLog.h - Append-only record store on a raw partition
+ *
+ ****/
+
+#pragma once
+
+#include "Partition.h"
+#include <memory>
+
+/**
+ * @brief Maximum size of a single record in a RecordLog
+ * @note Records are read into a stack buffer of this size during iteration
+ */
+#ifndef RECORD_LOG_MAX_RECORD_SIZE
+#define RECORD_LOG_MAX_RECORD_SIZE 256
+#endif
+
+namespace Storage
+{
+/**
+ * @brief Append-only store for small records, such as sensor readings or event logs
+ *
+ * Records are written sequentially to a raw partition, one flash write per record.
+ * Each erase block (sector) starts with a header giving the ID of its first record.
+ * When the partition is full the oldest sector is erased and re-used, so all sectors wear evenly.
+ *
+ * The only RAM required is one ID per sector, which is rebuilt by `begin()`.
+ * Each record carries a checksum so incomplete writes (e.g. on power failure) are detected and discarded.
+ *
+ * ```
+ * Storage::RecordLog log(*Storage::findPartition("datalog"));
+ * log.begin();
+ * log.append(&reading, sizeof(reading));
+ * ...
+ * log.forEach([](uint32_t id, const void* data, uint16_t length) {
+ *     ...
+ *     return true;
+ * });
+ * ```
+ */
+class RecordLog
+{
+public:
+	/**
+	 * @brief Invoked for each record
+	 * @param id Record identifier, increases by one for each record appended
+	 * @param data Content of record
+	 * @param length Size of record
+	 * @retval bool Return false to stop iteration
+	 */
+	using Callback = Delegate<bool(uint32_t id, const void* data, uint16_t length)>;
+
+	RecordLog(Partition partition) : partition(partition)
+	{
+	}
+
+	/**
+	 * @brief Scan partition and prepare for use
+	 * @retval bool false if partition is unsuitable
+	 */
+	bool begin();
+
+	/**
+	 * @brief Erase all records
+	 */
+	bool format();
+
+	/**
+	 * @brief Add a record
+	 * @param data
+	 * @param length Must not exceed `getMaxRecordLength()`
+	 * @retval bool true on success
+	 */
+	bool append(const void* data, uint16_t length);
+
+	/**
+	 * @brief Read a record
+	 * @param id Identifies record to read
+	 * @param buffer
+	 * @param bufSize
+	 * @retval int Size of record, -1 if not found or buffer too small
+	 */
+	int read(uint32_t id, void* buffer, uint16_t bufSize);
+
+	/**
+	 * @brief Read records in order
+	 * @param callback Invoked for each record
+	 * @param startId First record to read. If older than the first available record, starts from that.
+	 * @retval bool false if records could not be read
+	 */
+	bool forEach(Callback callback, uint32_t startId = 0);
+
+	/**
+	 * @brief Get ID of oldest stored record
+	 */
+	uint32_t getFirstId() const;
+
+	/**
+	 * @brief Get ID which will be assigned to the next record
+	 */
+	uint32_t getNextId() const
+	{
+		return nextId;
+	}
+
+	/**
+	 * @brief Get number of stored records
+	 */
+	uint32_t getCount() const
+	{
+		return nextId - getFirstId();
+	}
+
+	/**
+	 * @brief Get largest record which may be stored
+	 */
+	uint16_t getMaxRecordLength() const;
+
+	uint16_t getSectorCount() const
+	{
+		return sectorCount;
+	}
+
+private:
+	struct SectorHeader {
+		uint32_t magic;
+		uint32_t firstId;
+	};
+
+	struct RecordHeader {
+		uint16_t length;
+		uint16_t check;
+	};
+
+	static constexpr uint32_t invalidId{0xFFFFFFFF};
+
+	storage_size_t sectorAddress(uint16_t sector) const
+	{
+		return storage_size_t(sector) * sectorSize;
+	}
+
+	int findSector(uint32_t id) const;
+	bool readRecord(uint16_t sector, uint32_t& offset, uint16_t& length, uint8_t* buffer);
+	bool startSector(uint16_t sector);
+
+	Partition partition;
+	std::unique_ptr<uint32_t[]> index; ///< First record ID in each sector
+	uint32_t sectorSize{0};
+	uint32_t writeOffset{0};
+	uint32_t nextId{0};
+	uint16_t sectorCount{0};
+	uint16_t headSector{0};
+};
+
+} // namespace Storage
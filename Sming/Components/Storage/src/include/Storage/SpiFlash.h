@@ -35,6 +35,8 @@ public:
 	bool read(storage_size_t address, void* dst, size_t size) override;
 	bool write(storage_size_t address, const void* src, size_t size) override;
 	bool erase_range(storage_size_t address, storage_size_t size) override;
+	const void* map(storage_size_t address, size_t size) override;
+	void unmap(const void* ptr) override;
 };
 
 } // namespace Storage
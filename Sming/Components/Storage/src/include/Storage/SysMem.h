@@ -70,6 +70,11 @@ public:
 		return true;
 	}
 
+	const void* map(storage_size_t address, size_t) override
+	{
+		return reinterpret_cast<const void*>(address);
+	}
+
 	class SysMemPartitionTable : public PartitionTable
 	{
 	public:
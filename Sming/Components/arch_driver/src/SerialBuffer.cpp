@@ -11,6 +11,8 @@
  ****/
 
 #include "include/driver/SerialBuffer.h"
+#include <cstring>
+#include <algorithm>
 
 #ifdef ARCH_ESP32
 #include <esp_heap_caps.h>
@@ -43,6 +45,33 @@ int SerialBuffer::find(uint8_t c)
 	return -1;
 }
 
+size_t SerialBuffer::write(const void* data, size_t length)
+{
+	if(buffer == nullptr) {
+		return 0;
+	}
+
+	auto src = static_cast<const char*>(data);
+	size_t written = 0;
+	while(written < length) {
+		auto rp = readPos; // Guard against ISR changing value
+		// One slot always remains unused so that a full buffer can be distinguished from empty
+		size_t space = (rp > writePos) ? rp - writePos - 1 : size - writePos - (rp == 0 ? 1 : 0);
+		if(space == 0) {
+			break;
+		}
+		auto count = std::min(space, length - written);
+		memcpy(buffer + writePos, src + written, count);
+		written += count;
+		writePos += count;
+		if(writePos == size) {
+			writePos = 0;
+		}
+	}
+
+	return written;
+}
+
 // Must be called with interrupts disabled
 size_t SerialBuffer::resize(size_t newSize)
 {
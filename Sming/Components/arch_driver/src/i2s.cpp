@@ -0,0 +1,38 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * i2s.cpp - Buffer-level servicing common to all I2S drivers
+ *
+ ****/
+
+#include "include/driver/i2s.h"
+#include <cstdint>
+
+size_t i2s_service_buffers(i2s_buffer_callback_t tx_callback, i2s_buffer_callback_t rx_callback, void* param)
+{
+	size_t count = 0;
+	i2s_buffer_info_t info;
+
+	if(tx_callback != nullptr) {
+		while(i2s_dma_write(&info, SIZE_MAX)) {
+			count += info.size;
+			if(!tx_callback(param, &info)) {
+				break;
+			}
+		}
+	}
+
+	if(rx_callback != nullptr) {
+		while(i2s_dma_read(&info, SIZE_MAX)) {
+			count += info.size;
+			if(!rx_callback(param, &info)) {
+				break;
+			}
+		}
+	}
+
+	return count;
+}
@@ -109,6 +109,14 @@ public:
 		return 1;
 	}
 
+	/** @brief Copy a block of data into the buffer
+	 *  @param data
+	 *  @param length
+	 *  @retval size_t number of bytes written, limited by free space
+	 *  @note Not for use in interrupt context
+	 */
+	size_t write(const void* data, size_t length);
+
 	/** @brief find a character in the buffer
 	 *  @param c
 	 *  @retval int position relative to current read pointer, -1 if character not found
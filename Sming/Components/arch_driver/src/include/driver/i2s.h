@@ -118,6 +118,32 @@ typedef enum {
  */
 typedef void (*i2s_callback_t)(void* param, i2s_event_type_t event);
 
+/**
+ * @brief Defines a buffer with available content
+ */
+typedef struct {
+	union {
+		void* buffer;
+		i2s_sample_t* samples;
+	};
+	size_t size; ///< Available space (TX) or data (RX) in bytes
+	// debugging
+	uint16_t buf;
+	uint16_t pos;
+} i2s_buffer_info_t;
+
+/**
+ * @brief Buffer callback function type
+ * @param param Callback parameter from `i2s_config_t`
+ * @param info TX: Space which must be filled completely (pad with silence if required).
+ * RX: Received data. Content is only valid for the duration of the call.
+ * @retval bool Return false to stop servicing further buffers until the next DMA event
+ * @note The buffer is always considered consumed on return.
+ * When set in `i2s_config_t` this is called from interrupt context, so place in IRAM and keep it brief.
+ * See `i2s_service_buffers()` for handling buffers in task context.
+ */
+typedef bool (*i2s_buffer_callback_t)(void* param, const i2s_buffer_info_t* info);
+
 /**
  * @brief I2S module configuration (TX or RX)
  */
@@ -127,7 +153,7 @@ typedef struct {
 	i2s_channel_fmt_t channel_format;		///< I2S channel format
 	i2s_comm_format_t communication_format; ///< I2S communication format
 	uint16_t dma_buf_len;					///< I2S DMA Buffer Length (in samples)
-	uint8_t dma_buf_count;					///< I2S DMA Buffer Count
+	uint8_t dma_buf_count;					///< I2S DMA Buffer Count (minimum 2)
 	uint8_t callback_threshold;				///< TX: callback when available buffers > threshold
 											///< RX: Callback when slc_queue_len > threshold
 } i2s_module_config_t;
@@ -136,14 +162,16 @@ typedef struct {
  * @brief I2S configuration parameters
  */
 typedef struct {
-	i2s_module_config_t tx;  ///< TX module configuration
-	i2s_module_config_t rx;  ///< RX module configuration
-	unsigned sample_rate;	///< I2S sample rate
-	bool tx_desc_auto_clear; ///< I2S auto clear tx descriptor if there is underflow condition (Mutes output)
-	bool auto_start;		 ///< Start immediately on successful initialisation
-	i2s_callback_t callback; ///< Callback handler
-	void* param;			 ///< Callback parameter
-	uint8_t bits_mod;		 ///< Evaluate what this does (4 bits)
+	i2s_module_config_t tx;					  ///< TX module configuration
+	i2s_module_config_t rx;					  ///< RX module configuration
+	unsigned sample_rate;					  ///< I2S sample rate
+	bool tx_desc_auto_clear;				  ///< I2S auto clear tx descriptor if there is underflow condition (Mutes output)
+	bool auto_start;						  ///< Start immediately on successful initialisation
+	i2s_callback_t callback;				  ///< Callback handler
+	void* param;							  ///< Callback parameter
+	uint8_t bits_mod;						  ///< Evaluate what this does (4 bits)
+	i2s_buffer_callback_t tx_buffer_callback; ///< Optional: Fill TX buffers from interrupt on TX_DONE
+	i2s_buffer_callback_t rx_buffer_callback; ///< Optional: Drain RX buffers from interrupt on RX_DONE
 } i2s_config_t;
 
 /**
@@ -189,20 +217,6 @@ bool i2s_set_dividers(uint8_t bck_div, uint8_t mclk_div);
  */
 float i2s_get_real_rate();
 
-/**
- * @brief Defines a buffer with available content
- */
-typedef struct {
-	union {
-		void* buffer;
-		i2s_sample_t* samples;
-	};
-	size_t size; ///< Available space (TX) or data (RX) in bytes
-	// debugging
-	uint16_t buf;
-	uint16_t pos;
-} i2s_buffer_info_t;
-
 /**
  * @brief Defines the wait interval (presently milliseconds)
  */
@@ -230,6 +244,19 @@ bool IRAM_ATTR i2s_dma_read(i2s_buffer_info_t* info, size_t max_bytes);
  */
 bool IRAM_ATTR i2s_dma_write(i2s_buffer_info_t* info, size_t max_bytes);
 
+/**
+ * @brief Pass all available DMA buffers to callback functions (zero-copy)
+ * @param tx_callback Called to fill each free TX buffer, may be null
+ * @param rx_callback Called with each buffer of received data, may be null
+ * @param param Parameter passed to callbacks
+ * @retval size_t Total number of bytes serviced
+ *
+ * Used by the driver when buffer callbacks are set in `i2s_config_t`.
+ * To run callbacks in task context instead, leave those unset and call this function
+ * from a task queued by the event callback.
+ */
+size_t IRAM_ATTR i2s_service_buffers(i2s_buffer_callback_t tx_callback, i2s_buffer_callback_t rx_callback, void* param);
+
 /**
  * @brief writes a buffer of frames into the DMA memory, returns the amount of frames written.
  * @param src Data to write
@@ -149,7 +149,8 @@ enum smg_uart_format_t {
 
 // Status values
 enum smg_uart_status_t {
-	UART_STATUS_TX_DONE = BIT(14), ///< All data transmitted (ESP32 only)
+	UART_STATUS_TX_THRESHOLD = BIT(15), ///< TX buffer free space has reached `tx_threshold`
+	UART_STATUS_TX_DONE = BIT(14),		///< All data transmitted (ESP32 only)
 	UART_STATUS_RXFIFO_TOUT = BIT(8),
 	UART_STATUS_BRK_DET = BIT(7),
 	UART_STATUS_CTS_CHG = BIT(6),
@@ -243,6 +244,7 @@ struct smg_uart_t {
 	uint8_t tx_pin;
 	uint8_t rx_headroom;			///< Callback when rx_buffer free space <= headroom
 	uint16_t status;				///< All status flags reported to callback since last uart_get_status() call
+	uint16_t tx_threshold;			///< Report UART_STATUS_TX_THRESHOLD when tx_buffer free space >= threshold
 	struct SerialBuffer* rx_buffer; ///< Optional receive buffer
 	struct SerialBuffer* tx_buffer; ///< Optional transmit buffer
 	smg_uart_callback_t callback;   ///< Optional User callback routine
@@ -335,6 +337,18 @@ static inline void smg_uart_set_options(smg_uart_t* uart, uart_options_t options
 		uart->options = options;
 }
 
+/** @brief Request notification when transmit buffer space becomes available
+ *  @param uart
+ *  @param threshold Callback receives UART_STATUS_TX_THRESHOLD when the ISR has moved data
+ *  out of the transmit buffer and free space is at least this value. Set to 0 to disable.
+ *  @note Requires a transmit buffer
+ */
+static inline void smg_uart_set_tx_threshold(smg_uart_t* uart, uint16_t threshold)
+{
+	if(uart)
+		uart->tx_threshold = threshold;
+}
+
 /** @brief Get error flags and clear them
  *  @param uart
  *  @retval Status error bits:
@@ -428,6 +442,23 @@ static inline int smg_uart_read_char(smg_uart_t* uart)
 	return smg_uart_read(uart, &c, 1) ? c : -1;
 }
 
+/** @brief Get direct access to received data without copying
+ *  @param uart
+ *  @param data OUT: start of readable data within the receive buffer
+ *  @retval size_t number of contiguous bytes available at `data`
+ *  @note Data remains in the buffer until `smg_uart_rx_consume()` is called.
+ *  The buffer is circular, so after consuming call again to obtain any data which has
+ *  wrapped around to the start. Data still in the hardware FIFO is not included:
+ *  the driver moves it into the buffer when the FIFO fills or the line goes idle.
+ */
+size_t smg_uart_rx_peek_region(smg_uart_t* uart, const void*& data);
+
+/** @brief Remove data from the receive buffer
+ *  @param uart
+ *  @param length MUST be <= value returned from `smg_uart_rx_peek_region()`
+ */
+void smg_uart_rx_consume(smg_uart_t* uart, size_t length);
+
 /** @brief see what the next character in the rx buffer is
  *  @param uart
  *  @retval int returns -1 if buffer is empty or not allocated
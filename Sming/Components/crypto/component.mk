@@ -1,3 +1,21 @@
 COMPONENT_SRCDIRS := src
 COMPONENT_INCDIRS := include
 COMPONENT_DOXYGEN_INPUT := include
+
+ifeq ($(SMING_ARCH),Esp32)
+# Use SHA peripheral via IDF mbedtls port (only linked with the network stack)
+COMPONENT_VARS += ENABLE_CRYPTO_HW
+ifeq ($(DISABLE_NETWORK),1)
+ENABLE_CRYPTO_HW ?= 0
+else
+ENABLE_CRYPTO_HW ?= 1
+endif
+ifeq ($(ENABLE_CRYPTO_HW),1)
+GLOBAL_CFLAGS += \
+	-DCRYPTO_HW_SHA=1 \
+	-DMBEDTLS_CONFIG_FILE=\"mbedtls/esp_config.h\"
+COMPONENT_INCDIRS += \
+	$(IDF_PATH)/components/mbedtls/mbedtls/include \
+	$(IDF_PATH)/components/mbedtls/port/include
+endif
+endif
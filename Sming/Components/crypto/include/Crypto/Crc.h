@@ -0,0 +1,76 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * Crc.h - CRC and checksum functions
+ *
+ ****/
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace Crypto
+{
+/**
+ * @name CRC and checksum functions
+ *
+ * All functions accept a previous result so a calculation may be continued across multiple blocks.
+ * Data may be in RAM or flash memory, with any alignment.
+ *
+ * @{
+ */
+
+/**
+ * @brief Compute CRC-32 as used by zlib, gzip, PNG, etc.
+ * @param data
+ * @param length
+ * @param crc Result from a previous call to continue a calculation
+ * @retval uint32_t CRC value
+ * @note Uses ROM code on ESP32, the DMA sniffer on RP2040, slicing-by-4 otherwise
+ */
+uint32_t crc32(const void* data, size_t length, uint32_t crc = 0);
+
+/**
+ * @brief Compute CRC-16/CCITT-FALSE (polynomial 0x1021, MSB first, no final inversion)
+ * @param data
+ * @param length
+ * @param crc Initial value, or result from a previous call to continue a calculation
+ * @retval uint16_t CRC value
+ */
+uint16_t crc16Ccitt(const void* data, size_t length, uint16_t crc = 0xFFFF);
+
+/**
+ * @brief Compute CRC-16/MODBUS (reflected polynomial 0xA001)
+ * @param data
+ * @param length
+ * @param crc Initial value, or result from a previous call to continue a calculation
+ * @retval uint16_t CRC value, transmitted low byte first
+ * @note With an initial value of 0 this gives CRC-16/ARC, as used by 1-Wire devices
+ */
+uint16_t crc16Modbus(const void* data, size_t length, uint16_t crc = 0xFFFF);
+
+/**
+ * @brief Compute CRC-8/MAXIM as used by 1-Wire devices (reflected polynomial 0x8C)
+ * @param data
+ * @param length
+ * @param crc Initial value, or result from a previous call to continue a calculation
+ * @retval uint8_t CRC value
+ */
+uint8_t crc8Maxim(const void* data, size_t length, uint8_t crc = 0);
+
+/**
+ * @brief Compute Adler-32 checksum as used by zlib
+ * @param data
+ * @param length
+ * @param adler Result from a previous call to continue a calculation
+ * @retval uint32_t Checksum value
+ */
+uint32_t adler32(const void* data, size_t length, uint32_t adler = 1);
+
+/** @} */
+
+} // namespace Crypto
@@ -12,6 +12,7 @@
 
 #include "Blob.h"
 #include "ByteArray.h"
+#include <Data/Stream/DataSourceStream.h>
 
 namespace Crypto
 {
@@ -79,6 +80,17 @@ public:
 		return *this;
 	}
 
+	/// Data from stream, read until exhausted
+	HashContext& update(IDataSourceStream& stream)
+	{
+		uint8_t buf[256];
+		size_t len;
+		while((len = stream.readBytes(reinterpret_cast<char*>(buf), sizeof(buf))) > 0) {
+			engine.update(buf, len);
+		}
+		return *this;
+	}
+
 	/**
 	 * @brief Pointer to data + size
 	 * @param data Data block
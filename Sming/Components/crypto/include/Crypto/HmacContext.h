@@ -17,49 +17,52 @@
 namespace Crypto
 {
 /**
- * @brief HMAC class template
+ * @brief HMAC key with pre-computed pad state
  *
- * Implements the HMAC algorithm using any defined hash context
+ * Absorbing the key pads costs two hash blocks for every message.
+ * Where a key is used for many messages, construct one of these and pass it to HmacContext instead.
+ *
+ * 		Crypto::HmacSha256::Key key(mySecret);
+ * 		auto hash1 = Crypto::HmacSha256(key).calculate(message1);
+ * 		auto hash2 = Crypto::HmacSha256(key).calculate(message2);
+ *
+ * @note This object holds hash state derived from the key so should be treated as secret
  */
-template <class HashContext> class HmacContext
+template <class HashContext> class HmacKey
 {
 public:
 	using Engine = typename HashContext::Engine;
-	using Hash = typename HashContext::Hash;
 	static constexpr size_t blocksize = Engine::blocksize;
 
 	/**
-	 * @brief Default HMAC constructor
+	 * @brief Default constructor
 	 *
 	 * Must call init() first.
 	 */
-	HmacContext() = default;
+	HmacKey() = default;
 
-	/**
-	 * @brief Initialise HMAC context with key
-	 */
-	HmacContext(const Secret& key)
+	HmacKey(const Secret& key)
 	{
 		init(key);
 	}
 
 	/**
-	 * @brief Initialise HMAC with key
+	 * @brief Compute pad state for a key
 	 * @retval Reference to enable method chaining
 	 */
-	HmacContext& init(const Secret& key)
+	HmacKey& init(const Secret& key)
 	{
 		ByteArray<blocksize> inputPad{};
 		if(key.size() <= blocksize) {
 			memcpy(inputPad.data(), key.data(), key.size());
 		} else {
-			ctx.reset();
-			ctx.update(key);
-			auto hash = ctx.getHash();
+			inner.reset();
+			inner.update(key);
+			auto hash = inner.getHash();
 			memcpy(inputPad.data(), hash.data(), hash.size());
 		}
 
-		outputPad = inputPad;
+		auto outputPad = inputPad;
 
 		for(auto& c : inputPad) {
 			c ^= 0x36;
@@ -68,9 +71,88 @@ public:
 			c ^= 0x5c;
 		}
 
-		ctx.reset();
-		ctx.update(inputPad);
+		inner.reset();
+		inner.update(inputPad);
+		outer.reset();
+		outer.update(outputPad);
+
+		return *this;
+	}
+
+	/**
+	 * @brief Get hash context with inner pad absorbed
+	 */
+	const HashContext& getInner() const
+	{
+		return inner;
+	}
+
+	/**
+	 * @brief Get hash context with outer pad absorbed
+	 */
+	const HashContext& getOuter() const
+	{
+		return outer;
+	}
 
+private:
+	HashContext inner;
+	HashContext outer;
+};
+
+/**
+ * @brief HMAC class template
+ *
+ * Implements the HMAC algorithm using any defined hash context
+ */
+template <class HashContext> class HmacContext
+{
+public:
+	using Engine = typename HashContext::Engine;
+	using Hash = typename HashContext::Hash;
+	using Key = HmacKey<HashContext>;
+	static constexpr size_t blocksize = Engine::blocksize;
+
+	/**
+	 * @brief Default HMAC constructor
+	 *
+	 * Must call init() first.
+	 */
+	HmacContext() = default;
+
+	/**
+	 * @brief Initialise HMAC context with key
+	 */
+	HmacContext(const Secret& key)
+	{
+		init(key);
+	}
+
+	/**
+	 * @brief Initialise HMAC context with pre-computed key
+	 */
+	HmacContext(const Key& key)
+	{
+		init(key);
+	}
+
+	/**
+	 * @brief Initialise HMAC with key
+	 * @retval Reference to enable method chaining
+	 */
+	HmacContext& init(const Secret& key)
+	{
+		return init(Key(key));
+	}
+
+	/**
+	 * @brief Initialise HMAC with pre-computed key
+	 * @retval Reference to enable method chaining
+	 */
+	HmacContext& init(const Key& key)
+	{
+		ctx = key.getInner();
+		outer = key.getOuter();
 		return *this;
 	}
 
@@ -89,8 +171,7 @@ public:
 	{
 		auto tmp = ctx.getHash();
 
-		ctx.reset();
-		ctx.update(outputPad);
+		ctx = outer;
 		ctx.update(tmp);
 		return ctx.getHash();
 	}
@@ -112,8 +193,8 @@ public:
 	}
 
 private:
-	ByteArray<blocksize> outputPad;
 	HashContext ctx;
+	HashContext outer;
 };
 
 } // namespace Crypto
@@ -0,0 +1,97 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * HwHashEngine.h - Hash engines using hardware acceleration
+ *
+ * The ESP-IDF mbedtls port drives the SHA peripheral, falling back to software
+ * where the hardware is busy or doesn't support an algorithm.
+ *
+ ****/
+
+#pragma once
+
+#ifdef CRYPTO_HW_SHA
+
+#include <mbedtls/version.h>
+#include <mbedtls/sha1.h>
+#include <mbedtls/sha256.h>
+#include <mbedtls/sha512.h>
+
+#if MBEDTLS_VERSION_NUMBER < 0x03000000
+#define CRYPTO_MBEDTLS_FUNC(func) func##_ret
+#else
+#define CRYPTO_MBEDTLS_FUNC(func) func
+#endif
+
+/**
+ * @brief Macro template to construct Engine class wrapper for an mbedtls hash
+ * @param class_ Name for the class type, upper-case camel
+ * @param name_ Name of the hash, lower-case
+ * @param hashsize_ Size of hash in bytes
+ * @param statesize_ Size of state in bytes
+ * @param blocksize_ Size of block buffer in bytes
+ * @param mbed_ Name of mbedtls API
+ * @param ... Additional parameters for mbedtls `starts` function, selecting variant
+ *
+ * Intermediate state cannot be read from the hardware, so `get_state` and `set_state` are not provided.
+ * The hardware is reserved between the first `update()` and `final()`, so contexts should not be
+ * kept open longer than necessary.
+ */
+#define CRYPTO_HW_HASH_ENGINE(class_, name_, hashsize_, statesize_, blocksize_, mbed_, ...)                            \
+	class class_##HwEngine                                                                                             \
+	{                                                                                                                  \
+	public:                                                                                                            \
+		static constexpr const char* name = #name_;                                                                    \
+		static constexpr size_t hashsize = hashsize_;                                                                  \
+		static constexpr size_t statesize = statesize_;                                                                \
+		static constexpr size_t blocksize = blocksize_;                                                                \
+                                                                                                                       \
+		class_##HwEngine()                                                                                             \
+		{                                                                                                              \
+			mbedtls_##mbed_##_init(&ctx);                                                                              \
+		}                                                                                                              \
+                                                                                                                       \
+		class_##HwEngine(const class_##HwEngine& other)                                                                \
+		{                                                                                                              \
+			mbedtls_##mbed_##_init(&ctx);                                                                              \
+			mbedtls_##mbed_##_clone(&ctx, &other.ctx);                                                                 \
+		}                                                                                                              \
+                                                                                                                       \
+		class_##HwEngine& operator=(const class_##HwEngine& other)                                                     \
+		{                                                                                                              \
+			if(this != &other) {                                                                                       \
+				mbedtls_##mbed_##_clone(&ctx, &other.ctx);                                                             \
+			}                                                                                                          \
+			return *this;                                                                                              \
+		}                                                                                                              \
+                                                                                                                       \
+		~class_##HwEngine()                                                                                            \
+		{                                                                                                              \
+			mbedtls_##mbed_##_free(&ctx);                                                                              \
+		}                                                                                                              \
+                                                                                                                       \
+		void init()                                                                                                    \
+		{                                                                                                              \
+			mbedtls_##mbed_##_free(&ctx);                                                                              \
+			mbedtls_##mbed_##_init(&ctx);                                                                              \
+			CRYPTO_MBEDTLS_FUNC(mbedtls_##mbed_##_starts)(&ctx, ##__VA_ARGS__);                                        \
+		}                                                                                                              \
+                                                                                                                       \
+		void update(const void* data, size_t size)                                                                     \
+		{                                                                                                              \
+			CRYPTO_MBEDTLS_FUNC(mbedtls_##mbed_##_update)(&ctx, static_cast<const uint8_t*>(data), size);              \
+		}                                                                                                              \
+                                                                                                                       \
+		void final(uint8_t* hash)                                                                                      \
+		{                                                                                                              \
+			CRYPTO_MBEDTLS_FUNC(mbedtls_##mbed_##_finish)(&ctx, hash);                                                 \
+		}                                                                                                              \
+                                                                                                                       \
+	private:                                                                                                           \
+		mbedtls_##mbed_##_context ctx;                                                                                 \
+	};
+
+#endif // CRYPTO_HW_SHA
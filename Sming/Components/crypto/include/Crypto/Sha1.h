@@ -14,12 +14,18 @@
 #include "HashEngine.h"
 #include "HashContext.h"
 #include "HmacContext.h"
+#include "HwHashEngine.h"
 
 namespace Crypto
 {
 CRYPTO_HASH_ENGINE_STD(Sha1, sha1, SHA1_SIZE, SHA1_STATESIZE, SHA1_BLOCKSIZE);
 
+#ifdef CRYPTO_HW_SHA
+CRYPTO_HW_HASH_ENGINE(Sha1, sha1, SHA1_SIZE, SHA1_STATESIZE, SHA1_BLOCKSIZE, sha1);
+using Sha1 = HashContext<Sha1HwEngine>;
+#else
 using Sha1 = HashContext<Sha1Engine>;
+#endif
 
 using HmacSha1 = HmacContext<Sha1>;
 
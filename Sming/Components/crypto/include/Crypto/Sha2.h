@@ -14,6 +14,7 @@
 #include "HashEngine.h"
 #include "HashContext.h"
 #include "HmacContext.h"
+#include "HwHashEngine.h"
 
 namespace Crypto
 {
@@ -24,12 +25,27 @@ CRYPTO_HASH_ENGINE_STD(Sha512, sha512, SHA512_SIZE, SHA512_STATESIZE, SHA512_BLO
 
 /*
  * Hash contexts
+ *
+ * Where hardware acceleration is available it is used for these contexts.
+ * Use the software engines directly if `getState()` or `setState()` are required.
  */
 
+#ifdef CRYPTO_HW_SHA
+CRYPTO_HW_HASH_ENGINE(Sha224, sha224, SHA224_SIZE, SHA224_STATESIZE, SHA224_BLOCKSIZE, sha256, 1);
+CRYPTO_HW_HASH_ENGINE(Sha256, sha256, SHA256_SIZE, SHA256_STATESIZE, SHA256_BLOCKSIZE, sha256, 0);
+CRYPTO_HW_HASH_ENGINE(Sha384, sha384, SHA384_SIZE, SHA384_STATESIZE, SHA384_BLOCKSIZE, sha512, 1);
+CRYPTO_HW_HASH_ENGINE(Sha512, sha512, SHA512_SIZE, SHA512_STATESIZE, SHA512_BLOCKSIZE, sha512, 0);
+
+using Sha224 = HashContext<Sha224HwEngine>;
+using Sha256 = HashContext<Sha256HwEngine>;
+using Sha384 = HashContext<Sha384HwEngine>;
+using Sha512 = HashContext<Sha512HwEngine>;
+#else
 using Sha224 = HashContext<Sha224Engine>;
 using Sha256 = HashContext<Sha256Engine>;
 using Sha384 = HashContext<Sha384Engine>;
 using Sha512 = HashContext<Sha512Engine>;
+#endif
 
 /*
  * HMAC contexts
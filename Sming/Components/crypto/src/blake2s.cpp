@@ -4,7 +4,7 @@
  * http://github.com/SmingHub/Sming
  * All files of the Sming Core are provided under the LGPL v3 license.
  *
- * blake2s.cpp - Blake2s implementation, partially unrolled
+ * blake2s.cpp - Blake2s implementation, fully unrolled
  *
  ****/
 
@@ -21,11 +21,23 @@ static const uint32_t initVectors[8] PROGMEM = {0x6A09E667U, 0xBB67AE85U, 0x3C6E
 
 constexpr size_t blocksize = BLAKE2S_BLOCKSIZE;
 
+// Allows message block to be read as words directly from a byte buffer
+using message_word_t = uint32_t __attribute__((__may_alias__));
+
 struct CompressionContext {
 	void compress(crypto_blake2s_context_t& context, const uint8_t* block, uint32_t increment, bool isFinal = false)
 	{
 		context.count += increment;
-		memcpy(m, block, sizeof(m));
+
+		// All supported architectures are little-endian, so aligned blocks need no copying
+		const message_word_t* m;
+		if(uintptr_t(block) % sizeof(uint32_t) == 0) {
+			m = reinterpret_cast<const message_word_t*>(block);
+		} else {
+			memcpy(buffer, block, sizeof(buffer));
+			m = buffer;
+		}
+
 		std::copy_n(context.state, 8, v);
 		v[8] = initVectors[0];
 		v[9] = initVectors[1];
@@ -36,76 +48,53 @@ struct CompressionContext {
 		v[14] = initVectors[6] ^ (isFinal ? 0xFFFFFFFFU : 0U);
 		v[15] = initVectors[7];
 
-		// Full loop unrolling would increase code size by approx. 3kB, but only reduce
-		// runtime by about 30%.
-		shuffleRound<0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15>();
-		shuffleRound<14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3>();
-		shuffleRound<11, 8, 12, 0, 5, 2, 15, 13, 10, 14, 3, 6, 7, 1, 9, 4>();
-		shuffleRound<7, 9, 3, 1, 13, 12, 11, 14, 2, 6, 5, 10, 4, 0, 15, 8>();
-		shuffleRound<9, 0, 5, 7, 2, 4, 10, 15, 14, 1, 11, 12, 6, 8, 3, 13>();
-		shuffleRound<2, 12, 6, 10, 0, 11, 8, 3, 4, 13, 7, 5, 15, 14, 1, 9>();
-		shuffleRound<12, 5, 1, 15, 14, 13, 4, 10, 0, 7, 6, 3, 9, 2, 8, 11>();
-		shuffleRound<13, 11, 7, 14, 12, 1, 3, 9, 5, 0, 15, 4, 8, 6, 2, 10>();
-		shuffleRound<6, 15, 14, 9, 11, 3, 0, 8, 12, 2, 13, 7, 1, 4, 10, 5>();
-		shuffleRound<10, 2, 8, 4, 7, 6, 1, 5, 15, 11, 9, 14, 3, 12, 13, 0>();
+		// Message permutation is resolved at compile time, so words are passed straight to each mix
+		round<0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15>(m);
+		round<14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3>(m);
+		round<11, 8, 12, 0, 5, 2, 15, 13, 10, 14, 3, 6, 7, 1, 9, 4>(m);
+		round<7, 9, 3, 1, 13, 12, 11, 14, 2, 6, 5, 10, 4, 0, 15, 8>(m);
+		round<9, 0, 5, 7, 2, 4, 10, 15, 14, 1, 11, 12, 6, 8, 3, 13>(m);
+		round<2, 12, 6, 10, 0, 11, 8, 3, 4, 13, 7, 5, 15, 14, 1, 9>(m);
+		round<12, 5, 1, 15, 14, 13, 4, 10, 0, 7, 6, 3, 9, 2, 8, 11>(m);
+		round<13, 11, 7, 14, 12, 1, 3, 9, 5, 0, 15, 4, 8, 6, 2, 10>(m);
+		round<6, 15, 14, 9, 11, 3, 0, 8, 12, 2, 13, 7, 1, 4, 10, 5>(m);
+		round<10, 2, 8, 4, 7, 6, 1, 5, 15, 11, 9, 14, 3, 12, 13, 0>(m);
 
 		for(auto i = 0; i < 8; ++i) {
 			context.state[i] ^= v[i] ^ v[i + 8];
 		}
 	}
 
-	template <size_t m0, size_t m1, size_t m2, size_t m3, size_t m4, size_t m5, size_t m6, size_t m7, size_t m8,
-			  size_t m9, size_t m10, size_t m11, size_t m12, size_t m13, size_t m14, size_t m15>
-	void shuffleRound()
-	{
-		mPerm[0] = m[m0];
-		mPerm[1] = m[m1];
-		mPerm[2] = m[m2];
-		mPerm[3] = m[m3];
-		mPerm[4] = m[m4];
-		mPerm[5] = m[m5];
-		mPerm[6] = m[m6];
-		mPerm[7] = m[m7];
-		mPerm[8] = m[m8];
-		mPerm[9] = m[m9];
-		mPerm[10] = m[m10];
-		mPerm[11] = m[m11];
-		mPerm[12] = m[m12];
-		mPerm[13] = m[m13];
-		mPerm[14] = m[m14];
-		mPerm[15] = m[m15];
-		round();
-	}
-
-	void round()
+	template <size_t s0, size_t s1, size_t s2, size_t s3, size_t s4, size_t s5, size_t s6, size_t s7, size_t s8,
+			  size_t s9, size_t s10, size_t s11, size_t s12, size_t s13, size_t s14, size_t s15>
+	__forceinline void round(const message_word_t* m)
 	{
-		roundPart<0>(v[0], v[4], v[8], v[12]);
-		roundPart<1>(v[1], v[5], v[9], v[13]);
-		roundPart<2>(v[2], v[6], v[10], v[14]);
-		roundPart<3>(v[3], v[7], v[11], v[15]);
-		roundPart<4>(v[0], v[5], v[10], v[15]);
-		roundPart<5>(v[1], v[6], v[11], v[12]);
-		roundPart<6>(v[2], v[7], v[8], v[13]);
-		roundPart<7>(v[3], v[4], v[9], v[14]);
+		mix(v[0], v[4], v[8], v[12], m[s0], m[s1]);
+		mix(v[1], v[5], v[9], v[13], m[s2], m[s3]);
+		mix(v[2], v[6], v[10], v[14], m[s4], m[s5]);
+		mix(v[3], v[7], v[11], v[15], m[s6], m[s7]);
+		mix(v[0], v[5], v[10], v[15], m[s8], m[s9]);
+		mix(v[1], v[6], v[11], v[12], m[s10], m[s11]);
+		mix(v[2], v[7], v[8], v[13], m[s12], m[s13]);
+		mix(v[3], v[4], v[9], v[14], m[s14], m[s15]);
 	}
 
-	template <size_t ix> void roundPart(uint32_t& a, uint32_t& b, uint32_t& c, uint32_t& d)
+	static __forceinline void mix(uint32_t& a, uint32_t& b, uint32_t& c, uint32_t& d, uint32_t x, uint32_t y)
 	{
 		using namespace Crypto::Internal;
 
-		a += b + mPerm[2 * ix];
+		a += b + x;
 		d = ROTR(d ^ a, 16);
 		c += d;
 		b = ROTR(b ^ c, 12);
-		a += b + mPerm[2 * ix + 1];
+		a += b + y;
 		d = ROTR(d ^ a, 8);
 		c += d;
 		b = ROTR(b ^ c, 7);
 	}
 
-	uint32_t mPerm[16]; // Permutated (mixed) message
-	uint32_t v[16];		// State vector
-	uint32_t m[16];		// Input message
+	uint32_t v[16];		 // State vector
+	uint32_t buffer[16]; // Copy of unaligned message block
 };
 
 void init(crypto_blake2s_context_t* ctx, size_t hashSize, size_t keySize)
@@ -0,0 +1,245 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * crc.cpp
+ *
+ ****/
+
+#include "../include/Crypto/Crc.h"
+#include <sys/pgmspace.h>
+#include <algorithm>
+
+#if defined(ARCH_ESP32)
+#include <esp_rom_crc.h>
+#elif defined(ARCH_RP2040)
+#include <hardware/dma.h>
+#endif
+
+#ifndef CRYPTO_CRC_DMA_THRESHOLD
+#define CRYPTO_CRC_DMA_THRESHOLD 128
+#endif
+
+namespace
+{
+/*
+ * Tables are generated at compile time and stored in flash.
+ * 32-bit entries may be read directly, smaller ones require pgm_read_xxx().
+ */
+struct Crc32Table {
+	// Slicing-by-4: entries[n][i] is CRC of byte i followed by n zero bytes
+	uint32_t entries[4][256];
+
+	constexpr Crc32Table() : entries{}
+	{
+		for(unsigned i = 0; i < 256; ++i) {
+			uint32_t c = i;
+			for(unsigned j = 0; j < 8; ++j) {
+				c = (c & 1) ? (c >> 1) ^ 0xEDB88320 : c >> 1;
+			}
+			entries[0][i] = c;
+		}
+		for(unsigned i = 0; i < 256; ++i) {
+			for(unsigned n = 1; n < 4; ++n) {
+				auto c = entries[n - 1][i];
+				entries[n][i] = (c >> 8) ^ entries[0][c & 0xff];
+			}
+		}
+	}
+};
+
+struct Crc16CcittTable {
+	uint16_t entries[256];
+
+	constexpr Crc16CcittTable() : entries{}
+	{
+		for(unsigned i = 0; i < 256; ++i) {
+			uint16_t c = i << 8;
+			for(unsigned j = 0; j < 8; ++j) {
+				c = (c & 0x8000) ? (c << 1) ^ 0x1021 : c << 1;
+			}
+			entries[i] = c;
+		}
+	}
+};
+
+// Reflected polynomials
+template <typename T, T poly> struct ReflectedTable {
+	T entries[256];
+
+	constexpr ReflectedTable() : entries{}
+	{
+		for(unsigned i = 0; i < 256; ++i) {
+			T c = i;
+			for(unsigned j = 0; j < 8; ++j) {
+				c = (c & 1) ? (c >> 1) ^ poly : c >> 1;
+			}
+			entries[i] = c;
+		}
+	}
+};
+
+constexpr Crc32Table crc32Table PROGMEM;
+constexpr Crc16CcittTable crc16CcittTable PROGMEM;
+constexpr ReflectedTable<uint16_t, 0xA001> crc16ModbusTable PROGMEM;
+constexpr ReflectedTable<uint8_t, 0x8C> crc8MaximTable PROGMEM;
+
+/*
+ * Data may be in flash so read aligned words where possible, bytes otherwise.
+ * Words are little-endian, so the first byte in memory is in the low 8 bits.
+ */
+template <typename ByteFunc, typename WordFunc>
+void scan(const void* data, size_t length, ByteFunc byteFunc, WordFunc wordFunc)
+{
+	auto p = static_cast<const uint8_t*>(data);
+	while(length != 0 && (uintptr_t(p) & 3) != 0) {
+		byteFunc(pgm_read_byte(p++));
+		--length;
+	}
+	auto wp = reinterpret_cast<const uint32_t*>(p);
+	for(; length >= 4; length -= 4) {
+		wordFunc(*wp++);
+	}
+	p = reinterpret_cast<const uint8_t*>(wp);
+	while(length-- != 0) {
+		byteFunc(pgm_read_byte(p++));
+	}
+}
+
+template <typename ByteFunc> void scan(const void* data, size_t length, ByteFunc byteFunc)
+{
+	scan(data, length, byteFunc, [&](uint32_t w) {
+		byteFunc(w);
+		byteFunc(w >> 8);
+		byteFunc(w >> 16);
+		byteFunc(w >> 24);
+	});
+}
+
+#ifdef ARCH_RP2040
+
+uint32_t bitReverse(uint32_t x)
+{
+	x = ((x >> 1) & 0x55555555) | ((x & 0x55555555) << 1);
+	x = ((x >> 2) & 0x33333333) | ((x & 0x33333333) << 2);
+	x = ((x >> 4) & 0x0f0f0f0f) | ((x & 0x0f0f0f0f) << 4);
+	return __builtin_bswap32(x);
+}
+
+/*
+ * The sniffer calculates CRC-32 MSB-first. Feeding it bit-reversed data gives a bit-reversed
+ * version of the zlib state, which we seed accordingly and have reversed and inverted on read.
+ * Falls back to software if the sniffer or a DMA channel is not available.
+ */
+bool dmaCrc32(const void* data, size_t length, uint32_t& crc)
+{
+	constexpr unsigned modeCrc32Reversed{0x1};
+
+	if(length < CRYPTO_CRC_DMA_THRESHOLD || (dma_hw->sniff_ctrl & DMA_SNIFF_CTRL_EN_BITS)) {
+		return false;
+	}
+	int ch = dma_claim_unused_channel(false);
+	if(ch < 0) {
+		return false;
+	}
+
+	static uint32_t sink;
+	auto cfg = dma_channel_get_default_config(ch);
+	channel_config_set_transfer_data_size(&cfg, DMA_SIZE_8);
+	channel_config_set_read_increment(&cfg, true);
+	channel_config_set_write_increment(&cfg, false);
+	channel_config_set_sniff_enable(&cfg, true);
+
+	dma_sniffer_enable(ch, modeCrc32Reversed, false);
+	hw_set_bits(&dma_hw->sniff_ctrl, DMA_SNIFF_CTRL_OUT_REV_BITS | DMA_SNIFF_CTRL_OUT_INV_BITS);
+	dma_hw->sniff_data = bitReverse(~crc);
+
+	dma_channel_configure(ch, &cfg, &sink, data, length, true);
+	dma_channel_wait_for_finish_blocking(ch);
+
+	crc = dma_hw->sniff_data;
+	dma_sniffer_disable();
+	dma_channel_unclaim(ch);
+	return true;
+}
+
+#endif
+
+} // namespace
+
+namespace Crypto
+{
+uint32_t crc32(const void* data, size_t length, uint32_t crc)
+{
+#if defined(ARCH_ESP32)
+	return esp_rom_crc32_le(crc, static_cast<const uint8_t*>(data), length);
+#else
+#ifdef ARCH_RP2040
+	if(dmaCrc32(data, length, crc)) {
+		return crc;
+	}
+#endif
+	auto& tab = crc32Table.entries;
+	crc = ~crc;
+	scan(
+		data, length, [&](uint8_t b) { crc = (crc >> 8) ^ tab[0][uint8_t(crc ^ b)]; },
+		[&](uint32_t w) {
+			crc ^= w;
+			crc = tab[3][crc & 0xff] ^ tab[2][(crc >> 8) & 0xff] ^ tab[1][(crc >> 16) & 0xff] ^ tab[0][crc >> 24];
+		});
+	return ~crc;
+#endif
+}
+
+uint16_t crc16Ccitt(const void* data, size_t length, uint16_t crc)
+{
+#ifdef ARCH_ESP32
+	// ROM function inverts initial and final values
+	return ~esp_rom_crc16_be(~crc, static_cast<const uint8_t*>(data), length);
+#else
+	auto& tab = crc16CcittTable.entries;
+	scan(data, length, [&](uint8_t b) { crc = (crc << 8) ^ pgm_read_word(&tab[uint8_t(crc >> 8) ^ b]); });
+	return crc;
+#endif
+}
+
+uint16_t crc16Modbus(const void* data, size_t length, uint16_t crc)
+{
+	auto& tab = crc16ModbusTable.entries;
+	scan(data, length, [&](uint8_t b) { crc = (crc >> 8) ^ pgm_read_word(&tab[uint8_t(crc ^ b)]); });
+	return crc;
+}
+
+uint8_t crc8Maxim(const void* data, size_t length, uint8_t crc)
+{
+	auto& tab = crc8MaximTable.entries;
+	scan(data, length, [&](uint8_t b) { crc = pgm_read_byte(&tab[crc ^ b]); });
+	return crc;
+}
+
+uint32_t adler32(const void* data, size_t length, uint32_t adler)
+{
+	constexpr uint32_t base{65521};
+	// Largest n such that 255n(n+1)/2 + (n+1)(base-1) fits in 32 bits
+	constexpr size_t nmax{5552};
+
+	uint32_t a = adler & 0xffff;
+	uint32_t b = adler >> 16;
+	auto p = static_cast<const uint8_t*>(data);
+	while(length != 0) {
+		auto n = std::min(length, nmax);
+		scan(p, n, [&](uint8_t c) {
+			a += c;
+			b += a;
+		});
+		a %= base;
+		b %= base;
+		p += n;
+		length -= n;
+	}
+	return (b << 16) | a;
+}
+
+} // namespace Crypto
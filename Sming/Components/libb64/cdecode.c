@@ -37,6 +37,24 @@ unsigned base64_decode_block(const char* code_in, const int length_in, char* pla
 		while (1)
 		{
 	case step_a:
+			/* Fast path: decode complete groups as 24-bit words, stopping at padding or whitespace */
+			while (code_in + length_in - codechar >= 4)
+			{
+				int8_t a = base64_decode_value(codechar[0]);
+				int8_t b = base64_decode_value(codechar[1]);
+				int8_t c = base64_decode_value(codechar[2]);
+				int8_t d = base64_decode_value(codechar[3]);
+				if ((a | b | c | d) < 0)
+				{
+					break;
+				}
+				uint32_t group = ((uint32_t)a << 18) | ((uint32_t)b << 12) | ((uint32_t)c << 6) | (uint32_t)d;
+				plainchar[0] = (char)(group >> 16);
+				plainchar[1] = (char)(group >> 8);
+				plainchar[2] = (char)group;
+				plainchar += 3;
+				codechar += 4;
+			}
 			do {
 				if (codechar == code_in+length_in)
 				{
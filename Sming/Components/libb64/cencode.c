@@ -11,6 +11,9 @@ are returned in a single line of text. Anything longer is still wrapped.
 */
 
 #include "cencode.h"
+#include <stdint.h>
+
+static const char encoding[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
 
 void base64_init_encodestate(base64_encodestate* state_in, unsigned chars_per_line)
 {
@@ -22,7 +25,6 @@ void base64_init_encodestate(base64_encodestate* state_in, unsigned chars_per_li
 
 char base64_encode_value(char value_in)
 {
-	static const char* encoding = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
 	if (value_in > 63) return '=';
 	return encoding[(int)value_in];
 }
@@ -42,6 +44,25 @@ unsigned base64_encode_block(const char* plaintext_in, int length_in, char* code
 		while (1)
 		{
 	case step_A:
+			/* Fast path: encode complete groups as 24-bit words */
+			while (plaintextend - plainchar >= 3)
+			{
+				const uint8_t* p = (const uint8_t*)plainchar;
+				uint32_t group = ((uint32_t)p[0] << 16) | ((uint32_t)p[1] << 8) | p[2];
+				plainchar += 3;
+				codechar[0] = encoding[group >> 18];
+				codechar[1] = encoding[(group >> 12) & 0x3f];
+				codechar[2] = encoding[(group >> 6) & 0x3f];
+				codechar[3] = encoding[group & 0x3f];
+				codechar += 4;
+
+				++(state_in->stepcount);
+				if (state_in->stepcount == state_in->steps_per_line)
+				{
+					*codechar++ = '\n';
+					state_in->stepcount = 0;
+				}
+			}
 			if (plainchar == plaintextend)
 			{
 				state_in->result = result;
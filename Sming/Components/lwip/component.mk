@@ -22,13 +22,18 @@ COMPONENT_SRCDIRS := \
 
 COMPONENT_VARS		+= ENABLE_LWIPDEBUG
 ENABLE_LWIPDEBUG	?= 0
+
+COMPONENT_VARS		+= LWIP_PROFILE
+include $(SMING_HOME)/Components/Network/lwip-profile/lwip-profile.mk
 LWIP_LIBNAME		:= clwip
 
 LWIP_CMAKE_OPTIONS		:= \
 	-G Ninja \
 	-DLWIP_LIBNAME=$(LWIP_LIBNAME) \
 	-DLWIP_DIR=$(COMPONENT_PATH)/lwip \
-	-DCMAKE_MAKE_PROGRAM="$(NINJA)"
+	-DCMAKE_MAKE_PROGRAM="$(NINJA)" \
+	-DLWIP_PROFILE_DEFINE=$(LWIP_PROFILE_DEFINE) \
+	-DLWIP_PROFILE_DIR=$(LWIP_PROFILE_DIR)
 
 ifeq ($(ENABLE_LWIPDEBUG), 1)
 LWIP_CMAKE_OPTIONS		+= -DCMAKE_BUILD_TYPE=Debug
@@ -39,6 +39,11 @@ namespace
 {
 struct netif net_if;
 
+// Mirrors private definition in contrib/ports/unix/port/netif/tapif.c
+struct tapif {
+	int fd;
+};
+
 void getMacAddress(const char* ifname, uint8_t hwaddr[6])
 {
 	if(ifname == nullptr) {
@@ -141,6 +146,12 @@ bool lwip_arch_service()
 	return res > 0;
 }
 
+int lwip_arch_get_fd()
+{
+	auto tap = static_cast<struct tapif*>(net_if.state);
+	return tap ? tap->fd : -1;
+}
+
 void lwip_arch_shutdown()
 {
 }
@@ -19,7 +19,11 @@
 
 #include "lwip_arch.h"
 #include "lwip/netif.h"
+#include "lwip/timeouts.h"
+#include <hostlib/threads.h>
+#include <hostlib/profiler.h>
 #include <SimpleTimer.h>
+#include <algorithm>
 
 namespace
 {
@@ -30,6 +34,48 @@ host_lwip_init_callback_t init_callback;
 constexpr unsigned activeInterval{2};
 constexpr unsigned inactiveInterval{100};
 
+int netFd{-1};
+
+/*
+ * Incoming packets are signalled via the main loop so the interface doesn't need polling.
+ * The timer just services LWIP timeouts, capped as new timeouts may be added by the stack.
+ */
+void scheduleTimeouts()
+{
+	auto ms = std::min(sys_timeouts_sleeptime(), u32_t(inactiveInterval));
+	lwipServiceTimer.setIntervalMs(std::max(ms, u32_t(1)));
+	lwipServiceTimer.startOnce();
+}
+
+void onPacketReady(int, void*)
+{
+	HostProfileScope scope(host_profile_lwip, reinterpret_cast<const void*>(lwip_arch_service));
+	lwip_arch_service();
+	scheduleTimeouts();
+}
+
+void startEventService()
+{
+	lwipServiceTimer.initializeMs(inactiveInterval, []() {
+		HostProfileScope scope(host_profile_lwip, reinterpret_cast<const void*>(sys_check_timeouts));
+		sys_check_timeouts();
+		netif_poll_all();
+		scheduleTimeouts();
+	});
+	scheduleTimeouts();
+}
+
+void startPolledService()
+{
+	lwipServiceTimer.initializeMs(activeInterval, []() {
+		HostProfileScope scope(host_profile_lwip, reinterpret_cast<const void*>(lwip_arch_service));
+		bool active = lwip_arch_service();
+		lwipServiceTimer.setIntervalMs(active ? activeInterval : inactiveInterval);
+		lwipServiceTimer.startOnce();
+	});
+	lwipServiceTimer.startOnce();
+}
+
 } // namespace
 
 bool host_lwip_init(const struct lwip_param& param)
@@ -80,12 +126,13 @@ bool host_lwip_init(const struct lwip_param& param)
 		init_callback();
 	}
 
-	lwipServiceTimer.initializeMs(activeInterval, []() {
-		bool active = lwip_arch_service();
-		lwipServiceTimer.setIntervalMs(active ? activeInterval : inactiveInterval);
-		lwipServiceTimer.startOnce();
-	});
-	lwipServiceTimer.startOnce();
+	int fd = lwip_arch_get_fd();
+	if(fd >= 0 && host_thread_watch(fd, onPacketReady, nullptr)) {
+		netFd = fd;
+		startEventService();
+	} else {
+		startPolledService();
+	}
 
 	return true;
 }
@@ -93,6 +140,10 @@ bool host_lwip_init(const struct lwip_param& param)
 void host_lwip_shutdown()
 {
 	lwipServiceTimer.stop();
+	if(netFd >= 0) {
+		host_thread_unwatch(netFd);
+		netFd = -1;
+	}
 	lwip_arch_shutdown();
 }
 
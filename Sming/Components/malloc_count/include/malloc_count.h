@@ -93,4 +93,62 @@ void enableLogging(bool enable);
  */
 void setLogThreshold(size_t threshold);
 
+/**
+ * @brief Allocation statistics for one call site
+ */
+struct Site {
+	const void* caller; ///< Return address in the code which made the allocation, nullptr for untracked
+	size_t count;		///< Number of allocations currently live
+	size_t bytes;		///< Bytes currently allocated
+	size_t totalCount;	///< Cumulative number of allocations
+	size_t totalBytes;	///< Cumulative bytes allocated
+};
+
+/**
+ * @brief Sort order for site reports
+ */
+enum class SiteOrder {
+	bytes,
+	count,
+	totalBytes,
+	totalCount,
+};
+
+/**
+ * @brief Get allocation sites with the highest usage
+ * @param sites Buffer to receive site information
+ * @param maxSites Number of entries in buffer
+ * @param order Determines which sites are returned, and their order
+ * @retval size_t Number of sites returned
+ * @note Requires MALLOC_COUNT_SITES. Allocations made once the site table is full are reported
+ * against a single site with a null caller.
+ *
+ * To find leaks, take a snapshot before and after an operation which should leave the heap unchanged
+ * and compare live counts for each caller.
+ */
+size_t getSites(Site* sites, size_t maxSites, SiteOrder order = SiteOrder::bytes);
+
+/**
+ * @brief Print a table of allocation sites with the highest usage to debug output
+ * @param maxSites Maximum number of sites to print
+ * @param order
+ * @note Caller addresses can be resolved using `addr2line`
+ */
+void printSites(size_t maxSites = 10, SiteOrder order = SiteOrder::bytes);
+
+/**
+ * @brief Reset cumulative site counters to current values
+ */
+void resetSiteTotals();
+
+/**
+ * @brief Get distribution of live allocation sizes
+ * @param counts Entry N receives the number of live allocations of size 2^N to 2^(N+1)-1 bytes.
+ * The final entry includes all larger allocations.
+ * @param maxBuckets Number of entries in counts
+ * @retval size_t Number of entries written
+ * @note Requires MALLOC_COUNT_SITES. Many live small allocations are an indicator of fragmentation.
+ */
+size_t getSizeHistogram(size_t* counts, size_t maxBuckets);
+
 }; // namespace MallocCount
@@ -39,8 +39,13 @@
 
 #include "include/malloc_count.h"
 #include <debug_progmem.h>
+#include <algorithm>
 #include <esp_attr.h>
 
+#ifndef MALLOC_COUNT_SITES
+#define MALLOC_COUNT_SITES 0
+#endif
+
 // Names for the actual implementations
 #ifdef ARCH_ESP8266
 
@@ -76,8 +81,9 @@ bool logEnabled{false};
 size_t logThreshold{256};
 
 /* to each allocation additional data is added for bookkeeping. due to
- * alignment requirements, we can optionally add more than just one integer. */
-constexpr size_t alignment{16}; /* bytes (>= 2*sizeof(size_t)) */
+ * alignment requirements, we can optionally add more than just one integer.
+ * With site tracking the caller address follows the size. */
+constexpr size_t alignment{(MALLOC_COUNT_SITES != 0 && sizeof(size_t) > 4) ? 32 : 16}; /* bytes */
 
 /* a sentinel value prefixed to each allocation */
 constexpr size_t sentinel{0xDEADC0DE};
@@ -85,6 +91,9 @@ constexpr size_t sentinel{0xDEADC0DE};
 /* Macro to get pointer to sentinel */
 #define GET_SENTINEL(ptr) (size_t*)((char*)ptr - sizeof(size_t))
 
+/* Macro to get caller address from start of block */
+#define GET_CALLER(block) (*(const void**)((char*)(block) + sizeof(size_t)))
+
 /* output */
 #define PPREFIX "MC## "
 
@@ -112,6 +121,88 @@ MallocCount::Callback userCallback;
 
 #ifdef ENABLE_MALLOC_COUNT
 
+#if MALLOC_COUNT_SITES
+
+static_assert((MALLOC_COUNT_SITES & (MALLOC_COUNT_SITES - 1)) == 0, "MALLOC_COUNT_SITES must be a power of 2");
+
+/* Open-addressed hash table keyed on caller. Entries are never removed. */
+MallocCount::Site sites[MALLOC_COUNT_SITES];
+MallocCount::Site untrackedSite{};
+constexpr unsigned maxProbes{8};
+
+constexpr unsigned histogramBuckets{16};
+size_t sizeHistogram[histogramBuckets];
+
+MallocCount::Site& findSite(const void* caller)
+{
+	if(caller == nullptr) {
+		return untrackedSite;
+	}
+	uint32_t hash = uint32_t(uintptr_t(caller) >> 1) * 2654435761U;
+	for(unsigned i = 0; i < maxProbes; ++i) {
+		auto& site = sites[(hash + i) & (MALLOC_COUNT_SITES - 1)];
+		if(site.caller == caller) {
+			return site;
+		}
+		if(site.caller == nullptr) {
+			site.caller = caller;
+			return site;
+		}
+	}
+	return untrackedSite;
+}
+
+unsigned getBucket(size_t size)
+{
+	unsigned bucket = 31 - __builtin_clz(uint32_t(size) | 1);
+	return (bucket < histogramBuckets) ? bucket : histogramBuckets - 1;
+}
+
+void addSite(const void* caller, size_t size)
+{
+	auto& site = findSite(caller);
+	++site.count;
+	site.bytes += size;
+	++site.totalCount;
+	site.totalBytes += size;
+	++sizeHistogram[getBucket(size)];
+}
+
+void removeSite(const void* caller, size_t size)
+{
+	auto& site = findSite(caller);
+	--site.count;
+	site.bytes -= size;
+	--sizeHistogram[getBucket(size)];
+}
+
+size_t getSiteValue(const MallocCount::Site& site, MallocCount::SiteOrder order)
+{
+	switch(order) {
+	case MallocCount::SiteOrder::count:
+		return site.count;
+	case MallocCount::SiteOrder::totalBytes:
+		return site.totalBytes;
+	case MallocCount::SiteOrder::totalCount:
+		return site.totalCount;
+	case MallocCount::SiteOrder::bytes:
+	default:
+		return site.bytes;
+	}
+}
+
+#else
+
+void addSite(const void*, size_t)
+{
+}
+
+void removeSite(const void*, size_t)
+{
+}
+
+#endif // MALLOC_COUNT_SITES
+
 /* add allocation to statistics */
 void inc_count(size_t inc)
 {
@@ -198,13 +289,103 @@ void setCallback(Callback callback)
 	userCallback = std::move(callback);
 }
 
+#if defined(ENABLE_MALLOC_COUNT) && MALLOC_COUNT_SITES
+
+size_t getSites(Site* list, size_t maxSites, SiteOrder order)
+{
+	// Insertion into sorted output so no memory is allocated
+	size_t count{0};
+	auto insert = [&](const Site& site) {
+		auto value = getSiteValue(site, order);
+		if(value == 0) {
+			return;
+		}
+		size_t pos = count;
+		while(pos > 0 && getSiteValue(list[pos - 1], order) < value) {
+			--pos;
+		}
+		if(pos >= maxSites) {
+			return;
+		}
+		size_t end = (count < maxSites) ? count++ : count - 1;
+		memmove(&list[pos + 1], &list[pos], (end - pos) * sizeof(Site));
+		list[pos] = site;
+	};
+
+	for(auto& site : sites) {
+		if(site.caller != nullptr) {
+			insert(site);
+		}
+	}
+	insert(untrackedSite);
+	return count;
+}
+
+void printSites(size_t maxSites, SiteOrder order)
+{
+	constexpr size_t batchSize{10};
+	Site list[batchSize];
+	auto count = getSites(list, std::min(maxSites, batchSize), order);
+	debug_i(PPREFIX "%u sites, current %u, peak %u", count, stats.current, stats.peak);
+	for(unsigned i = 0; i < count; ++i) {
+		auto& site = list[i];
+		debug_i(PPREFIX "%p: %u bytes in %u blocks, total %u bytes in %u blocks", site.caller, site.bytes, site.count,
+				site.totalBytes, site.totalCount);
+	}
+}
+
+void resetSiteTotals()
+{
+	for(auto& site : sites) {
+		site.totalCount = site.count;
+		site.totalBytes = site.bytes;
+	}
+	untrackedSite.totalCount = untrackedSite.count;
+	untrackedSite.totalBytes = untrackedSite.bytes;
+}
+
+size_t getSizeHistogram(size_t* counts, size_t maxBuckets)
+{
+	size_t n = std::min(maxBuckets, size_t(histogramBuckets));
+	if(n == 0) {
+		return 0;
+	}
+	memcpy(counts, sizeHistogram, n * sizeof(size_t));
+	for(unsigned i = n; i < histogramBuckets; ++i) {
+		counts[n - 1] += sizeHistogram[i];
+	}
+	return n;
+}
+
+#else
+
+size_t getSites(Site*, size_t, SiteOrder)
+{
+	return 0;
+}
+
+void printSites(size_t, SiteOrder)
+{
+}
+
+void resetSiteTotals()
+{
+}
+
+size_t getSizeHistogram(size_t*, size_t)
+{
+	return 0;
+}
+
+#endif
+
 #ifdef ENABLE_MALLOC_COUNT
 
 /****************************************************/
 /* malloc_count function implementations             */
 /****************************************************/
 
-extern "C" void* mc_malloc(size_t size)
+static void* allocate(size_t size, const void* caller)
 {
 	if(size == 0) {
 		return nullptr;
@@ -225,10 +406,14 @@ extern "C" void* mc_malloc(size_t size)
 
 	/* prepend allocation size and check sentinel */
 	*(size_t*)ret = size;
+	if(MALLOC_COUNT_SITES) {
+		GET_CALLER(ret) = caller;
+	}
 	ret = (char*)ret + alignment;
 	*GET_SENTINEL(ret) = sentinel;
 
 	inc_count(size);
+	addSite(caller, size);
 	if(size >= logThreshold) {
 		log("malloc(%u) = %p (cur %u)", size, ret, stats.current);
 	}
@@ -236,15 +421,25 @@ extern "C" void* mc_malloc(size_t size)
 	return ret;
 }
 
-extern "C" void* mc_zalloc(size_t size)
+static void* zallocate(size_t size, const void* caller)
 {
-	auto ptr = mc_malloc(size);
+	auto ptr = allocate(size, caller);
 	if(ptr != nullptr) {
 		memset(ptr, 0, size);
 	}
 	return ptr;
 }
 
+extern "C" void* mc_malloc(size_t size)
+{
+	return allocate(size, __builtin_return_address(0));
+}
+
+extern "C" void* mc_zalloc(size_t size)
+{
+	return zallocate(size, __builtin_return_address(0));
+}
+
 extern "C" void mc_free(void* ptr)
 {
 	// free(nullptr) is no operation
@@ -262,6 +457,9 @@ extern "C" void mc_free(void* ptr)
 
 		size_t size = *(size_t*)ptr;
 		dec_count(size);
+		if(MALLOC_COUNT_SITES) {
+			removeSite(GET_CALLER(ptr), size);
+		}
 
 		if(size >= logThreshold) {
 			log("free(%p) -> %u (cur %u)", (char*)ptr + alignment, size, stats.current);
@@ -273,7 +471,7 @@ extern "C" void mc_free(void* ptr)
 
 extern "C" void* mc_calloc(size_t nmemb, size_t size)
 {
-	return mc_zalloc(nmemb * size);
+	return zallocate(nmemb * size, __builtin_return_address(0));
 }
 
 extern "C" void* mc_realloc(void* ptr, size_t size)
@@ -285,8 +483,9 @@ extern "C" void* mc_realloc(void* ptr, size_t size)
 	}
 
 	// special case ptr == 0 -> malloc()
+	auto caller = __builtin_return_address(0);
 	if(ptr == nullptr) {
-		return mc_malloc(size);
+		return allocate(size, caller);
 	}
 
 	if(*GET_SENTINEL(ptr) != sentinel) {
@@ -314,6 +513,11 @@ extern "C" void* mc_realloc(void* ptr, size_t size)
 
 	dec_count(oldsize);
 	inc_count(size);
+	if(MALLOC_COUNT_SITES) {
+		removeSite(GET_CALLER(newptr), oldsize);
+		GET_CALLER(newptr) = caller;
+		addSite(caller, size);
+	}
 
 	if(size >= logThreshold) {
 		if(newptr == ptr) {
@@ -364,22 +568,22 @@ using namespace MallocCount;
 
 void* operator new(size_t size)
 {
-	return mc_malloc(size);
+	return allocate(size, __builtin_return_address(0));
 }
 
 void* operator new(size_t size, const std::nothrow_t&) noexcept
 {
-	return mc_malloc(size);
+	return allocate(size, __builtin_return_address(0));
 }
 
 void* operator new[](size_t size)
 {
-	return mc_malloc(size);
+	return allocate(size, __builtin_return_address(0));
 }
 
 void* operator new[](size_t size, const std::nothrow_t&) noexcept
 {
-	return mc_malloc(size);
+	return allocate(size, __builtin_return_address(0));
 }
 
 void operator delete(void* ptr)
@@ -409,7 +613,7 @@ void operator delete[](void* ptr, size_t)
 extern "C" char* WRAP(strdup)(const char* s)
 {
 	auto len = strlen(s) + 1;
-	auto dup = (char*)malloc(len);
+	auto dup = (char*)allocate(len, __builtin_return_address(0));
 	memcpy(dup, s, len);
 	return dup;
 }
@@ -50,11 +50,6 @@ public:
 
 	size_t write(const uint8_t* data, size_t size) override;
 
-	StreamType getStreamType() const override
-	{
-		return eSST_File;
-	}
-
 	uint16_t readMemoryBlock(char* data, int bufSize) override
 	{
 		return 0;
@@ -23,6 +23,14 @@
  */
 constexpr uint8_t NO_ROM_SWITCH{0xff};
 
+/**
+ * @brief Further items are only downloaded in parallel if at least this much heap is free
+ * @see RbootHttpUpdater::setMaxParallel()
+ */
+#ifndef RBOOT_HTTP_UPDATER_MIN_HEAP
+#define RBOOT_HTTP_UPDATER_MIN_HEAP 16384
+#endif
+
 class RbootHttpUpdater;
 
 using OtaUpdateDelegate = Delegate<void(RbootHttpUpdater& client, bool result)>;
@@ -104,6 +112,17 @@ public:
 
 	void start();
 
+	/**
+	 * @brief Set how many items may be downloaded at the same time
+	 * @param count The default of 1 downloads items in order, re-using the connection for each
+	 * @note Concurrent downloads from the same host each need a connection, see `HTTP_CLIENT_MAX_HOST_CONNECTIONS`.
+	 * Additional items are started only whilst at least `RBOOT_HTTP_UPDATER_MIN_HEAP` bytes are free.
+	 */
+	void setMaxParallel(uint8_t count)
+	{
+		maxParallel = std::max(count, uint8_t(1));
+	}
+
 	/**
 	 * @brief On completion, switch to the given ROM slot
 	 * @param romSlot specify NO_ROM_SWITCH (the default) to cancel any previously set switch
@@ -150,14 +169,33 @@ protected:
 	void applyUpdate();
 	void updateFailed();
 
+	/**
+	 * @brief Called as each item finishes downloading, in whatever order that happens
+	 * @param client Connection for the item. The request `args` refers to the `Item`.
+	 * @param success
+	 * @retval int 0 on success
+	 */
 	virtual int itemComplete(HttpConnection& client, bool success);
+
+	/**
+	 * @brief Called once all items have been downloaded successfully
+	 */
 	virtual int updateComplete(HttpConnection& client, bool success);
 
+private:
+	bool sendItem(Item& it);
+	void startItems();
+	int requestComplete(HttpConnection& client, bool success);
+
 protected:
 	ItemList items;
 	OtaUpdateDelegate updateDelegate;
 	HttpRequest* baseRequest{nullptr};
 	uint8_t romSlot{NO_ROM_SWITCH};
-	uint8_t currentItem{0};
+	uint8_t maxParallel{1};
+	uint8_t nextItem{0};	   ///< Index of next item to be sent
+	uint8_t activeCount{0};	///< Number of items being downloaded
+	uint8_t completedCount{0}; ///< Number of items successfully downloaded
+	bool running{false};
 	rboot_write_status rbootWriteStatus{};
 };
@@ -17,39 +17,85 @@
 
 void RbootHttpUpdater::start()
 {
-	for(unsigned i = 0; i < items.count(); i++) {
-		auto& it = items[i];
+	nextItem = 0;
+	activeCount = 0;
+	completedCount = 0;
+	running = true;
+	startItems();
+}
+
+void RbootHttpUpdater::startItems()
+{
+	while(running && nextItem < items.count() && activeCount < maxParallel) {
+		if(activeCount != 0 && system_get_free_heap_size() < RBOOT_HTTP_UPDATER_MIN_HEAP) {
+			debug_d("Low heap, deferring download of item %u", nextItem);
+			break;
+		}
+
+		auto& it = items[nextItem];
 		debug_d("Download file:\r\n"
 				"    (%u) %s -> %X",
-				currentItem, it.url.c_str(), it.targetOffset);
-
-		HttpRequest* request;
-		if(baseRequest != nullptr) {
-			request = baseRequest->clone();
-			request->setURL(it.url);
-		} else {
-			request = new HttpRequest(it.url);
+				nextItem, it.url.c_str(), it.targetOffset);
+
+		++nextItem;
+		++activeCount;
+		if(!sendItem(it)) {
+			debug_e("ERROR: Rejected sending new request.");
+			--activeCount;
+			updateFailed();
 		}
+	}
+}
 
-		request->setMethod(HTTP_GET);
-		request->setResponseStream(it.getStream());
+bool RbootHttpUpdater::sendItem(Item& it)
+{
+	HttpRequest* request;
+	if(baseRequest != nullptr) {
+		request = baseRequest->clone();
+		request->setURL(it.url);
+	} else {
+		request = new HttpRequest(it.url);
+	}
 
-		if(i == items.count() - 1) {
-			request->onRequestComplete(RequestCompletedDelegate(&RbootHttpUpdater::updateComplete, this));
-		} else {
-			request->onRequestComplete(RequestCompletedDelegate(&RbootHttpUpdater::itemComplete, this));
-		}
+	request->setMethod(HTTP_GET);
+	request->setResponseStream(it.getStream());
+	request->args = &it;
+	request->onRequestComplete(RequestCompletedDelegate(&RbootHttpUpdater::requestComplete, this));
 
-		if(!send(request)) {
-			debug_e("ERROR: Rejected sending new request.");
-			break;
-		}
+	if(send(request)) {
+		return true;
+	}
+
+	it.stream.release(); // Deleted with the request
+	return false;
+}
+
+int RbootHttpUpdater::requestComplete(HttpConnection& client, bool success)
+{
+	if(!running) {
+		// Update already failed, items no longer valid
+		return -1;
+	}
+
+	--activeCount;
+	int hasError = itemComplete(client, success);
+	if(hasError != 0) {
+		return hasError;
 	}
+
+	++completedCount;
+	if(completedCount == items.count()) {
+		return updateComplete(client, true);
+	}
+
+	// Connection is kept alive, so the next item may re-use it
+	startItems();
+	return 0;
 }
 
 int RbootHttpUpdater::itemComplete(HttpConnection& client, bool success)
 {
-	auto& it = items[currentItem];
+	auto& it = *static_cast<Item*>(client.getRequest()->args);
 
 	if(!success) {
 		it.stream.release(); // Owned by HttpRequest
@@ -62,18 +108,12 @@ int RbootHttpUpdater::itemComplete(HttpConnection& client, bool success)
 
 	it.size = it.stream->available();
 	it.stream.release(); // the actual deletion will happen outside of this class
-	currentItem++;
 
 	return 0;
 }
 
 int RbootHttpUpdater::updateComplete(HttpConnection& client, bool success)
 {
-	int hasError = itemComplete(client, success);
-	if(hasError != 0) {
-		return hasError;
-	}
-
 	debug_d("\r\nFirmware download finished!");
 	for(unsigned i = 0; i < items.count(); i++) {
 		debug_d(" - item: %u, addr: 0x%X, url: %s", i, items[i].targetOffset, items[i].url.c_str());
@@ -91,14 +131,20 @@ int RbootHttpUpdater::updateComplete(HttpConnection& client, bool success)
 void RbootHttpUpdater::updateFailed()
 {
 	debug_e("\r\nFirmware download failed..");
+	running = false;
 	if(updateDelegate) {
 		updateDelegate(*this, false);
 	}
+	// Streams for items already sent belong to their requests
+	for(unsigned i = 0; i < nextItem; ++i) {
+		items[i].stream.release();
+	}
 	items.clear();
 }
 
 void RbootHttpUpdater::applyUpdate()
 {
+	running = false;
 	items.clear();
 	if(romSlot == NO_ROM_SWITCH) {
 		debug_d("Firmware updated.");
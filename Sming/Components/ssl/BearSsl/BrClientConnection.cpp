@@ -43,19 +43,39 @@ int BrClientConnection::init()
 {
 	br_ssl_client_zero(&clientContext);
 
-	// Use Mono-directional buffer size according to requested max. fragment size
+	// Input buffer size determines requested max. fragment size
 	size_t bufSize = maxBufferSizeToBytes(context.session.maxBufferSize);
 	if(bufSize == 0) {
 		bufSize = 4096;
 	}
-	int err = BrConnection::init(bufSize, false);
+	// Share a single buffer for both directions unless a separate output buffer is requested
+	size_t outSize = maxBufferSizeToBytes(context.session.outputBufferSize);
+	int err = BrConnection::init(bufSize, outSize);
 	if(err < 0) {
 		return err;
 	}
 
 	br_ssl_client_set_default_rsapub(&clientContext);
 	br_ssl_engine_set_x509(getEngine(), x509);
-	if(!br_ssl_client_reset(&clientContext, context.session.hostName.c_str(), 0)) {
+
+	// Offer to resume a previous session if we have its parameters
+	bool resume{false};
+	auto state = context.session.getSessionState();
+	if(state != nullptr && state->isResumable()) {
+		br_ssl_session_parameters param{};
+		if(state->id.getLength() <= sizeof(param.session_id) &&
+		   state->masterSecret.length() == sizeof(param.master_secret)) {
+			memcpy(param.session_id, state->id.getValue(), state->id.getLength());
+			param.session_id_len = state->id.getLength();
+			param.version = state->version;
+			param.cipher_suite = state->cipherSuite;
+			memcpy(param.master_secret, state->masterSecret.c_str(), sizeof(param.master_secret));
+			br_ssl_engine_set_session_parameters(getEngine(), &param);
+			resume = true;
+		}
+	}
+
+	if(!br_ssl_client_reset(&clientContext, context.session.hostName.c_str(), resume)) {
 		debug_e("br_ssl_client_reset failed");
 		return getLastError();
 	}
@@ -72,9 +92,11 @@ void BrClientConnection::startCert(uint32_t length)
 	certificate = std::make_unique<BrCertificate>();
 	x509Decoder = std::make_unique<X509Decoder>(&certificate->subject, &certificate->issuer);
 
-	auto& types = context.session.validators.fingerprintTypes;
+	auto& validators = context.session.validators;
+	auto& types = validators.fingerprintTypes;
 	resetHash(certSha1Context, types.contains(Fingerprint::Type::CertSha1));
-	resetHash(certSha256Context, types.contains(Fingerprint::Type::CertSha256));
+	// SHA256 is also the key for cached validation results
+	resetHash(certSha256Context, types.contains(Fingerprint::Type::CertSha256) || validators.getCacheId() != 0);
 }
 
 void BrClientConnection::appendCertData(const uint8_t* buf, size_t len)
@@ -16,6 +16,7 @@
 #include <Network/Ssl/Session.h>
 #include <FlashString/Array.hpp>
 #include "CipherSuites.h"
+#include <Platform/Timers.h>
 
 // Defined in ssl_engine.c
 #define MAX_OUT_OVERHEAD 85
@@ -69,7 +70,7 @@ void br_tls12_sha384_prf(void* dst, size_t len, const void* secret, size_t secre
 	br_tls_phash(dst, len, &sha384_vtable, secret, secret_len, label, seed_num, seed);
 }
 
-int BrConnection::init(size_t bufferSize, bool bidi)
+int BrConnection::init(size_t inputSize, size_t outputSize)
 {
 	auto engine = getEngine();
 	br_ssl_engine_set_versions(engine, BR_TLS10, BR_TLS12);
@@ -101,17 +102,26 @@ int BrConnection::init(size_t bufferSize, bool bidi)
 	br_ssl_engine_set_default_des_cbc(engine);
 	br_ssl_engine_set_default_chapol(engine);
 
-	bufferSize += MAX_IN_OVERHEAD;
-	if(bidi) {
-		bufferSize += MAX_OUT_OVERHEAD;
+	/*
+	 * Sizing each direction separately lets output stay small:
+	 * the engine splits outgoing data into records which fit.
+	 */
+	inputSize += MAX_IN_OVERHEAD;
+	if(outputSize != 0) {
+		outputSize += MAX_OUT_OVERHEAD;
 	}
-	debug_i("Using buffer size of %u bytes", bufferSize);
-	buffer.reset(new uint8_t[bufferSize]);
+	debug_i("Using buffer sizes of %u (in), %u (out) bytes", inputSize, outputSize);
+	// Long-lived, so keep out of the general heap where possible
+	buffer.reset(static_cast<uint8_t*>(heap_region_malloc(HEAP_REGION_SECONDARY, inputSize + outputSize)));
 	if(!buffer) {
 		debug_e("Buffer allocation failed");
 		return -BR_ERR_BAD_PARAM;
 	}
-	br_ssl_engine_set_buffer(engine, buffer.get(), bufferSize, bidi);
+	if(outputSize == 0) {
+		br_ssl_engine_set_buffer(engine, buffer.get(), inputSize, false);
+	} else {
+		br_ssl_engine_set_buffers_bidi(engine, buffer.get(), inputSize, &buffer[inputSize], outputSize);
+	}
 
 	return BR_ERR_OK;
 }
@@ -194,6 +204,7 @@ int BrConnection::write(const uint8_t* data, size_t length)
 int BrConnection::runUntil(InputBuffer& input, unsigned target)
 {
 	auto engine = getEngine();
+	OneShotFastMs sliceTimer(SSL_HANDSHAKE_SLICE_MS);
 
 	for(;;) {
 		unsigned state = br_ssl_engine_current_state(engine);
@@ -256,6 +267,15 @@ int BrConnection::runUntil(InputBuffer& input, unsigned target)
 		}
 
 		if(state & BR_SSL_RECVREC) {
+			/*
+			 * Handshake records can involve lengthy public key operations.
+			 * Any pending output has been sent, so this is a good point to let other tasks run.
+			 */
+			if(!handshakeDone && input.available() != 0 && sliceTimer.expired()) {
+				debug_d("SSL: handshake yield");
+				return 0;
+			}
+
 			size_t avail = 0;
 			auto buf = br_ssl_engine_recvrec_buf(engine, &avail);
 			auto len = input.read(buf, avail);
@@ -16,8 +16,19 @@
 #include "BrError.h"
 #include "BrCertificate.h"
 #include <bearssl.h>
+#include <heap_region.h>
 #include <memory>
 
+/**
+ * @brief Maximum time in milliseconds to spend processing handshake records in one go
+ *
+ * Once exceeded, the connection yields so other tasks can run and processing resumes
+ * from the task queue. Each record is processed in its entirety, so this is a soft limit.
+ */
+#ifndef SSL_HANDSHAKE_SLICE_MS
+#define SSL_HANDSHAKE_SLICE_MS 20
+#endif
+
 namespace Ssl
 {
 class BrConnection : public Connection
@@ -49,6 +60,22 @@ public:
 		return id;
 	}
 
+	bool getSessionState(SessionState& state) const override
+	{
+		state = SessionState{};
+		if(!handshakeDone) {
+			return false;
+		}
+		br_ssl_session_parameters param;
+		br_ssl_engine_get_session_parameters(getEngine(), &param);
+		state.id.assign(param.session_id, param.session_id_len);
+		state.masterSecret.setLength(sizeof(param.master_secret));
+		memcpy(state.masterSecret.begin(), param.master_secret, sizeof(param.master_secret));
+		state.version = param.version;
+		state.cipherSuite = param.cipher_suite;
+		return state.id.isValid();
+	}
+
 	bool isHandshakeDone() const override
 	{
 		return handshakeDone;
@@ -79,11 +106,19 @@ public:
 protected:
 	/**
 	 * Perform initialisation common to both client and server connections
-	 * @param bufferSize Buffer to allocate excluding overheads
-	 * @param bidi Whether to use bi-directional buffering (true) or mono
+	 * @param inputSize Size of input buffer excluding overheads. Also determines the maximum
+	 * fragment length requested by a client.
+	 * @param outputSize Size of separate output buffer excluding overheads.
+	 * If 0, a single buffer is used for both directions (mono).
 	 */
-	int init(size_t bufferSize, bool bidi);
+	int init(size_t inputSize, size_t outputSize);
 
+	/**
+	 * Run the engine until it reaches the target state or needs more input
+	 * @retval int Engine state, 0 if no progress can be made yet, or negative error code
+	 * @note During the handshake this returns 0 before all input has been consumed
+	 * if SSL_HANDSHAKE_SLICE_MS has elapsed.
+	 */
 	int runUntil(InputBuffer& input, unsigned target);
 
 	int startHandshake()
@@ -96,7 +131,7 @@ private:
 	void setCipherSuites(const CipherSuites::Array* cipherSuites);
 
 private:
-	std::unique_ptr<uint8_t[]> buffer;
+	std::unique_ptr<uint8_t[], HeapRegionDeleter> buffer;
 	bool handshakeDone = false;
 };
 
@@ -114,6 +114,9 @@ Alert getAlert(int error)
 		return Alert(error - BR_ERR_SEND_FATAL_ALERT);
 	} else if(error >= BR_ERR_RECV_FATAL_ALERT) {
 		return Alert(error - BR_ERR_RECV_FATAL_ALERT);
+	} else if(error == BR_ERR_TOO_LARGE) {
+		// Incoming record didn't fit our buffer
+		return Alert::RECORD_OVERFLOW;
 	} else {
 		return Alert::Invalid;
 	}
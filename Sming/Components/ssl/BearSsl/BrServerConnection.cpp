@@ -27,10 +27,12 @@ int BrServerConnection::init()
 	if(bufSize == 0) {
 		bufSize = 4096;
 	}
-	// add on minimum size for output
-	bufSize += 512U;
+	size_t outSize = maxBufferSizeToBytes(context.session.outputBufferSize);
+	if(outSize == 0) {
+		outSize = 512;
+	}
 
-	int err = BrConnection::init(bufSize, true);
+	int err = BrConnection::init(bufSize, outSize);
 	if(err < 0) {
 		return err;
 	}
@@ -60,6 +60,9 @@ public:
 	 * 		   0 : handshake is still in progress
 	 * 		 > 0 : there is decrypted data
 	 * 		 < 0 : error
+	 *
+	 * During the handshake an implementation may return 0 before all input has been consumed,
+	 * to let other tasks run. The caller should continue later with the remaining input.
 	 */
 	virtual int read(InputBuffer& input, uint8_t*& output) = 0;
 
@@ -85,6 +88,20 @@ public:
 	 */
 	virtual SessionId getSessionId() const = 0;
 
+	/**
+	 * @brief Get the state required to resume this session from another connection
+	 * @param state
+	 * @retval bool true if state contains a valid session ID
+	 * @note Adapters which cannot restore a session into a new context leave `masterSecret` empty
+	 */
+	virtual bool getSessionState(SessionState& state) const
+	{
+		state = SessionState{};
+		state.id = getSessionId();
+		state.cipherSuite = uint16_t(getCipherSuite());
+		return state.id.isValid();
+	}
+
 	/**
 	 * @brief Gets the certificate object.
 	 *        That object MUST be owned by the Connection implementation
@@ -18,11 +18,14 @@ namespace Ssl
 {
 /**
  * @brief Wraps a pbuf for reading in chunks
+ *
+ * Reads proceed sequentially through the chain, so each byte is visited once
+ * however many reads the SSL engine makes.
  */
 class InputBuffer
 {
 public:
-	InputBuffer(pbuf* buf) : buf(buf)
+	InputBuffer(pbuf* buf) : buf(buf), current(buf)
 	{
 	}
 
@@ -35,7 +38,9 @@ public:
 
 private:
 	pbuf* buf;
-	uint16_t offset = 0;
+	pbuf* current;				///< Segment containing the next byte to read
+	uint16_t offset = 0;		///< Total bytes read
+	uint16_t segmentOffset = 0; ///< Position within current segment
 };
 
 } // namespace Ssl
@@ -14,6 +14,7 @@
 #include "KeyCertPair.h"
 #include "ValidatorList.h"
 #include <Platform/System.h>
+#include <Services/Profiling/Metrics.h>
 #include <memory>
 
 class TcpConnection;
@@ -51,7 +52,7 @@ __forceinline size_t maxBufferSizeToBytes(MaxBufferSize value)
  * @brief Configurable options
  */
 struct Options {
-	bool sessionResume : 1; ///< Keep a note of session ID for later re-use
+	bool sessionResume : 1; ///< Keep a note of session ID for later re-use, and use the global session cache
 	bool clientAuthentication : 1;
 	bool verifyLater : 1; ///< Allow handshake to complete before verifying certificate
 	bool freeKeyCertAfterHandshake : 1;
@@ -96,9 +97,21 @@ public:
 
 	/**
 	 * @brief Controls SSL RAM usage
+	 *
+	 * For a client, this is the maximum fragment length requested from the server.
+	 * If the server does not honour a reduced size and the handshake fails as a result,
+	 * a larger size is noted in `sessionCache` for use on the next connection to that server.
 	 */
 	MaxBufferSize maxBufferSize = MaxBufferSize::Default;
 
+	/**
+	 * @brief Size of separate output buffer, if supported by SSL implementation
+	 *
+	 * Outgoing data is split into records of this size. Default for a server is 512 bytes.
+	 * A client shares one buffer for both directions by default.
+	 */
+	MaxBufferSize outputBufferSize = MaxBufferSize::Default;
+
 	/**
 	 * Configure supported cipher suites. Default is basic.
 	 */
@@ -130,7 +143,40 @@ public:
 	 */
 	const SessionId* getSessionId() const
 	{
-		return sessionId.get();
+		return sessionState ? &sessionState->id : nullptr;
+	}
+
+	/**
+	 * @brief Set the session ID to offer for resumption when next connecting
+	 * @param id Obtained from a previous session with the same server
+	 * @note Use with `options.sessionResume` to allow connections to share a session
+	 */
+	void setSessionId(const SessionId& id)
+	{
+		SessionState state;
+		state.id = id;
+		setSessionState(state);
+	}
+
+	/**
+	 * @brief Get the full state required to resume this session
+	 * @retval SessionState* May be null if no session has been established
+	 */
+	const SessionState* getSessionState() const
+	{
+		return sessionState.get();
+	}
+
+	/**
+	 * @brief Set the session state to use for resumption when next connecting
+	 * @param state Obtained from a previous session with the same server
+	 */
+	void setSessionState(const SessionState& state)
+	{
+		if(!sessionState) {
+			sessionState = std::make_unique<SessionState>();
+		}
+		*sessionState = state;
 	}
 
 	/**
@@ -221,12 +267,15 @@ public:
 private:
 	void beginHandshake();
 	void endHandshake();
+	void adaptBufferSize(Alert alert);
 
 private:
 	std::unique_ptr<Context> context;
 	std::unique_ptr<Connection> connection;
-	std::unique_ptr<SessionId> sessionId;
+	std::unique_ptr<SessionState> sessionState;
+	String cacheKey; ///< Identifies server in sessionCache
 	CpuFrequency curFreq = CpuFrequency(0);
+	Profiling::Metrics::Stopwatch handshakeTimer;
 };
 
 }; // namespace Ssl
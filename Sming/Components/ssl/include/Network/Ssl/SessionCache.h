@@ -0,0 +1,154 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * SessionCache.h
+ *
+ ****/
+
+#pragma once
+
+#include "Session.h"
+#include <Storage/Partition.h>
+
+/**
+ * @brief Number of servers for which resumption state is kept
+ */
+#ifndef SSL_SESSION_CACHE_SIZE
+#define SSL_SESSION_CACHE_SIZE 4
+#endif
+
+namespace Ssl
+{
+/**
+ * @brief Keeps session state for recently used servers so new connections can resume them
+ *
+ * Client sessions with `options.sessionResume` set are stored here, keyed by host name (or IP address) and port.
+ * The buffer size needed for a server which doesn't honour a reduced maximum fragment length is also kept.
+ * When full, the least recently used entry is replaced.
+ *
+ * The cache may be serialised to preserve it across restarts. For example, to use RTC memory
+ * before entering deep sleep on the ESP8266:
+ *
+ * ```
+ * uint8_t buffer[256];
+ * auto len = Ssl::sessionCache.serialize(buffer, sizeof(buffer));
+ * system_rtc_mem_write(64, buffer, ALIGNUP4(len));
+ * ```
+ *
+ * @note Stored state includes session master secrets, so should be kept somewhere secure.
+ */
+class SessionCache
+{
+public:
+	/**
+	 * @brief Build the key used to identify a server
+	 */
+	static String makeKey(const String& host, uint16_t port)
+	{
+		String key;
+		key.reserve(host.length() + 6);
+		key += host;
+		key += ':';
+		key += port;
+		return key;
+	}
+
+	/**
+	 * @brief Find resumption state for a server
+	 * @param key Identifies server, see `makeKey()`
+	 * @param state On success, contains stored state
+	 * @retval bool true if found
+	 */
+	bool get(const String& key, SessionState& state);
+
+	/**
+	 * @brief Store resumption state for a server
+	 * @param key
+	 * @param state Ignored unless it can be resumed from a new context
+	 */
+	void put(const String& key, const SessionState& state);
+
+	/**
+	 * @brief Discard resumption state for a server, e.g. because resumption failed
+	 */
+	void remove(const String& key);
+
+	/**
+	 * @brief Get the smallest buffer size known to work with a server
+	 * @retval MaxBufferSize Default if there is no information
+	 */
+	MaxBufferSize getBufferSizeHint(const String& key) const;
+
+	/**
+	 * @brief Note the buffer size required for a server
+	 */
+	void setBufferSizeHint(const String& key, MaxBufferSize size);
+
+	/**
+	 * @brief Discard all entries
+	 */
+	void clear();
+
+	/**
+	 * @brief Get number of cached entries
+	 */
+	unsigned count() const;
+
+	/**
+	 * @brief Write cache content to a buffer
+	 * @param buffer Pass nullptr to obtain the required buffer size
+	 * @param bufferSize
+	 * @retval size_t Number of bytes written. Entries which do not fit are omitted.
+	 */
+	size_t serialize(uint8_t* buffer, size_t bufferSize) const;
+
+	/**
+	 * @brief Replace cache content from a buffer previously written by `serialize()`
+	 * @param buffer
+	 * @param length
+	 * @retval bool false if data is invalid, in which case the cache is left empty
+	 */
+	bool deserialize(const uint8_t* buffer, size_t length);
+
+	/**
+	 * @brief Save cache content to the start of a partition
+	 * @param partition Data is erased first, so partition should be dedicated to this purpose
+	 * @retval bool
+	 */
+	bool save(Storage::Partition partition) const;
+
+	/**
+	 * @brief Load cache content from a partition
+	 * @param partition
+	 * @retval bool
+	 */
+	bool load(Storage::Partition partition);
+
+private:
+	struct Entry {
+		String key;
+		SessionState state;
+		uint32_t lastUsed{0};
+		MaxBufferSize bufferSize{MaxBufferSize::Default};
+	};
+
+	Entry* find(const String& key);
+	const Entry* find(const String& key) const
+	{
+		return const_cast<SessionCache*>(this)->find(key);
+	}
+	Entry* add(const String& key);
+
+	Entry entries[SSL_SESSION_CACHE_SIZE];
+	uint32_t useCount{0};
+};
+
+/**
+ * @brief Global cache shared by all client connections
+ */
+extern SessionCache sessionCache;
+
+} // namespace Ssl
@@ -62,4 +62,25 @@ __forceinline String toString(const SessionId& id)
 	return id.toString();
 }
 
+/**
+ * @brief Everything needed to resume an SSL session
+ *
+ * The master secret is only available with adapters which support restoring it,
+ * otherwise it is empty.
+ */
+struct SessionState {
+	SessionId id;
+	String masterSecret;
+	uint16_t version{0};
+	uint16_t cipherSuite{0};
+
+	/**
+	 * @brief Determine if state can be used to resume a session in a new context
+	 */
+	bool isResumable() const
+	{
+		return id.isValid() && masterSecret.length() != 0;
+	}
+};
+
 } // namespace Ssl
@@ -34,6 +34,19 @@ public:
 	}
 
 	virtual bool validate(const Certificate& certificate) = 0;
+
+	/**
+	 * @brief Identify this validator for caching of results
+	 * @retval uint32_t 0 (the default) if results must not be cached
+	 *
+	 * Only validators whose result depends solely upon the certificate content
+	 * and their own configuration should return a non-zero value.
+	 * Validators with different configurations must return different values.
+	 */
+	virtual uint32_t getCacheId() const
+	{
+		return 0;
+	}
 };
 
 /**
@@ -58,6 +71,17 @@ public:
 		return certFp.hash == fp.hash;
 	}
 
+	uint32_t getCacheId() const override
+	{
+		// FNV-1a over fingerprint type and value
+		uint32_t id{2166136261U};
+		id = (id ^ uint8_t(FP::type)) * 16777619U;
+		for(auto c : fp.hash) {
+			id = (id ^ c) * 16777619U;
+		}
+		return id ?: 1;
+	}
+
 private:
 	FP fp;
 };
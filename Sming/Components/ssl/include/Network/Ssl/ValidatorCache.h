@@ -0,0 +1,77 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * ValidatorCache.h
+ *
+ ****/
+
+#pragma once
+
+#include "Fingerprints.h"
+
+/**
+ * @brief Number of successfully validated certificates to remember
+ */
+#ifndef SSL_VALIDATOR_CACHE_SIZE
+#define SSL_VALIDATOR_CACHE_SIZE 4
+#endif
+
+namespace Ssl
+{
+/**
+ * @brief Remembers certificates which have passed validation
+ *
+ * Entries are keyed by the SHA256 fingerprint of the certificate plus an identifier for the validators
+ * which accepted it (see `ValidatorList::getCacheId()`), so a certificate accepted by one set of
+ * validators is never assumed valid by another.
+ *
+ * When full, the least recently used entry is replaced.
+ */
+class ValidatorCache
+{
+public:
+	/**
+	 * @brief Check whether a certificate has previously passed validation
+	 * @param fingerprint SHA256 of the entire certificate
+	 * @param validatorId Identifies the validators in use
+	 * @retval bool true if found
+	 */
+	bool contains(const Fingerprint::Cert::Sha256& fingerprint, uint32_t validatorId);
+
+	/**
+	 * @brief Record a successful validation
+	 */
+	void add(const Fingerprint::Cert::Sha256& fingerprint, uint32_t validatorId);
+
+	/**
+	 * @brief Discard all entries, for example if validation requirements have changed
+	 */
+	void clear();
+
+	/**
+	 * @brief Get number of cached entries
+	 */
+	unsigned count() const;
+
+private:
+	struct Entry {
+		Fingerprint::Cert::Sha256 fingerprint;
+		uint32_t validatorId{0};
+		uint32_t lastUsed{0};
+	};
+
+	Entry* find(const Fingerprint::Cert::Sha256& fingerprint, uint32_t validatorId);
+
+	Entry entries[SSL_VALIDATOR_CACHE_SIZE];
+	uint32_t useCount{0};
+};
+
+/**
+ * @brief Global cache shared by all client connections
+ */
+extern ValidatorCache validatorCache;
+
+} // namespace Ssl
@@ -14,6 +14,7 @@
 
 #include "Validator.h"
 #include "Fingerprints.h"
+#include "ValidatorCache.h"
 #include <WVector.h>
 
 namespace Ssl
@@ -28,6 +29,9 @@ namespace Ssl
  *
  * If there are no validators in the list then the certificate will not be checked
  * and the connection accepted.
+ *
+ * Where every validator supports it (e.g. pinned fingerprints), successful results are stored
+ * in the `validatorCache` so repeat connections to the same server skip the validators.
  */
 class ValidatorList : public Vector<Validator>
 {
@@ -77,6 +81,15 @@ public:
 	 */
 	bool validate(const Certificate* certificate);
 
+	/**
+	 * @brief Get identifier used to cache validation results
+	 * @retval uint32_t 0 if the list is empty or contains any validator whose result cannot be cached
+	 *
+	 * If non-zero, the implementation should provide the certificate's SHA256 fingerprint
+	 * so that results may be looked up in the `validatorCache`.
+	 */
+	uint32_t getCacheId() const;
+
 	/**
 	 * @brief Contains a list of registered fingerprint types
 	 *
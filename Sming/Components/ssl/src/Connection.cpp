@@ -11,6 +11,7 @@
 #include <SslDebug.h>
 #include <Network/Ssl/Context.h>
 #include <Print.h>
+#include <Network/NetworkMetrics.h>
 
 namespace Ssl
 {
@@ -63,6 +64,7 @@ int Connection::writeTcpData(uint8_t* data, size_t length)
 
 	if(err == ERR_OK) {
 		debug_d("writeTcpData: length %d (%d)", tcp_len, length);
+		Network::Metrics::tcpBytesSent.add(tcp_len);
 		err = tcp_output(tcp);
 		if(err != ERR_OK) {
 			debug_e("writeTcpData: tcp_output got err: %d", err);
@@ -10,20 +10,33 @@
 
 #include <SslDebug.h>
 #include <Network/Ssl/InputBuffer.h>
+#include <algorithm>
+#include <cstring>
+#include <cassert>
 
 namespace Ssl
 {
 size_t InputBuffer::read(uint8_t* buffer, size_t bufSize)
 {
-	if(buf == nullptr) {
-		return 0;
-	}
+	size_t required = bufSize;
+	bufSize = std::min(bufSize, available());
 
-	unsigned len = pbuf_copy_partial(buf, buffer, bufSize, offset);
+	size_t len = 0;
+	while(len < bufSize) {
+		assert(current != nullptr);
+		size_t segmentLength = std::min(size_t(current->len - segmentOffset), bufSize - len);
+		memcpy(&buffer[len], static_cast<const uint8_t*>(current->payload) + segmentOffset, segmentLength);
+		len += segmentLength;
+		segmentOffset += segmentLength;
+		if(segmentOffset == current->len) {
+			current = current->next;
+			segmentOffset = 0;
+		}
+	}
 	offset += len;
 
-	if(len < bufSize) {
-		debug_d("SSL read input: Bytes needed: %d, Bytes read: %u", bufSize, len);
+	if(len < required) {
+		debug_d("SSL read input: Bytes needed: %u, Bytes read: %u", required, len);
 	}
 
 	return len;
@@ -11,12 +11,18 @@
 #include <SslDebug.h>
 #include <Network/Ssl/Session.h>
 #include <Network/Ssl/Factory.h>
+#include <Network/Ssl/SessionCache.h>
 #include <Network/TcpConnection.h>
 #include <Print.h>
 #include <Platform/Clocks.h>
 
 namespace Ssl
 {
+namespace
+{
+METRIC_HISTOGRAM(handshakeTime, "sming_ssl_handshake_duration_us", "Time taken for successful SSL handshakes");
+} // namespace
+
 String Options::toString() const
 {
 	String s;
@@ -90,9 +96,26 @@ bool Session::onConnect(tcp_pcb* tcp)
 		return false;
 	}
 
-	if(sessionId && sessionId->isValid()) {
+	String host = hostName ? hostName : IpAddress(tcp->remote_ip).toString();
+	cacheKey = SessionCache::makeKey(host, tcp->remote_port);
+
+	// Use a larger buffer if a previous attempt found the requested size too small
+	auto sizeHint = sessionCache.getBufferSizeHint(cacheKey);
+	if(maxBufferSize != MaxBufferSize::Default && sizeHint > maxBufferSize) {
+		debug_i("SSL: Using %u byte buffer for %s", maxBufferSizeToBytes(sizeHint), cacheKey.c_str());
+		maxBufferSize = sizeHint;
+	}
+
+	if(options.sessionResume) {
+		SessionState state;
+		if((!sessionState || !sessionState->isResumable()) && sessionCache.get(cacheKey, state)) {
+			setSessionState(state);
+		}
+	}
+
+	if(sessionState && sessionState->id.isValid()) {
 		debug_d("-----BEGIN SSL SESSION PARAMETERS-----");
-		debug_d("SessionId: %s", toString(*sessionId).c_str());
+		debug_d("SessionId: %s", toString(sessionState->id).c_str());
 		debug_d("------END SSL SESSION PARAMETERS------");
 	}
 
@@ -110,6 +133,7 @@ bool Session::onConnect(tcp_pcb* tcp)
 void Session::beginHandshake()
 {
 	debug_d("SSL: handshake start");
+	handshakeTimer.start();
 #ifndef SSL_SLOW_CONNECT
 	curFreq = System.getCpuFrequency();
 	if(curFreq != CpuCycleClockFast::cpuFrequency()) {
@@ -138,7 +162,9 @@ void Session::close()
 	context.reset();
 
 	hostName = nullptr;
+	cacheKey = nullptr;
 	maxBufferSize = MaxBufferSize::Default;
+	outputBufferSize = MaxBufferSize::Default;
 }
 
 int Session::read(InputBuffer& input, uint8_t*& output)
@@ -154,6 +180,8 @@ int Session::read(InputBuffer& input, uint8_t*& output)
 		if(alert == Alert::CERTIFICATE_UNKNOWN) {
 			debug_w("SSL: Client didn't like certificate, continue anyway");
 			len = ERR_OK;
+		} else if(!connection->isHandshakeDone()) {
+			adaptBufferSize(alert);
 		}
 	}
 
@@ -197,15 +225,22 @@ void Session::handshakeComplete(bool success)
 	endHandshake();
 
 	if(success) {
-		// If requested, take a copy of the session ID for later re-use
+		handshakeTimer.stop(handshakeTime);
+		// If requested, take a copy of the session state for later re-use
 		if(options.sessionResume) {
-			if(!sessionId) {
-				sessionId = std::make_unique<SessionId>();
+			SessionState state;
+			connection->getSessionState(state);
+			setSessionState(state);
+			if(cacheKey) {
+				sessionCache.put(cacheKey, state);
 			}
-			*sessionId = connection->getSessionId();
 		}
 	} else {
 		debug_w("SSL Handshake failed");
+		// Don't try to resume a failed session
+		if(cacheKey) {
+			sessionCache.remove(cacheKey);
+		}
 	}
 
 	if(options.freeKeyCertAfterHandshake && connection) {
@@ -213,6 +248,25 @@ void Session::handshakeComplete(bool success)
 	}
 }
 
+void Session::adaptBufferSize(Alert alert)
+{
+	/*
+	 * A record too large for our buffer means the server ignored our max. fragment length,
+	 * and some servers reject the extension outright.
+	 */
+	if(alert != Alert::RECORD_OVERFLOW && alert != Alert::ILLEGAL_PARAMETER) {
+		return;
+	}
+	if(!cacheKey || maxBufferSize == MaxBufferSize::Default || maxBufferSize >= MaxBufferSize::K16) {
+		return;
+	}
+
+	auto newSize = MaxBufferSize(unsigned(maxBufferSize) + 1);
+	debug_w("SSL: Buffer of %u bytes too small for %s, will try %u", maxBufferSizeToBytes(maxBufferSize),
+			cacheKey.c_str(), maxBufferSizeToBytes(newSize));
+	sessionCache.setBufferSizeHint(cacheKey, newSize);
+}
+
 size_t Session::printTo(Print& p) const
 {
 	size_t n = 0;
@@ -226,6 +280,8 @@ size_t Session::printTo(Print& p) const
 	n += p.println(cacheSize);
 	n += p.print(_F("  Max Buffer Size: "));
 	n += p.println(maxBufferSizeToBytes(maxBufferSize));
+	n += p.print(_F("  Output Buffer Size: "));
+	n += p.println(maxBufferSizeToBytes(outputBufferSize));
 	n += p.print(_F("  Validators: "));
 	n += p.println(validators.count());
 	n += p.print(_F("  Cert Length: "));
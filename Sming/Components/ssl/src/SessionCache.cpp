@@ -0,0 +1,338 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * SessionCache.cpp
+ *
+ ****/
+
+#include <SslDebug.h>
+#include <Network/Ssl/SessionCache.h>
+#include <memory>
+
+namespace Ssl
+{
+SessionCache sessionCache;
+
+namespace
+{
+constexpr uint32_t CACHE_MAGIC{0x43535353}; // "SSSC"
+
+struct CacheHeader {
+	uint32_t magic;
+	uint32_t checksum;
+	uint16_t length; ///< Bytes following header
+	uint8_t count;
+	uint8_t reserved;
+};
+
+uint32_t getChecksum(const uint8_t* data, size_t length)
+{
+	// FNV-1a
+	uint32_t hash{2166136261U};
+	for(size_t i = 0; i < length; ++i) {
+		hash = (hash ^ data[i]) * 16777619U;
+	}
+	return hash;
+}
+
+class Writer
+{
+public:
+	Writer(uint8_t* buffer, size_t size) : buffer(buffer), size(size)
+	{
+	}
+
+	void write(const void* data, size_t length)
+	{
+		if(buffer != nullptr && pos + length <= size) {
+			memcpy(&buffer[pos], data, length);
+		}
+		pos += length;
+	}
+
+	void write8(uint8_t value)
+	{
+		write(&value, 1);
+	}
+
+	void write16(uint16_t value)
+	{
+		write(&value, 2);
+	}
+
+	void writeString(const String& value)
+	{
+		write8(value.length());
+		write(value.c_str(), value.length());
+	}
+
+	uint8_t* buffer;
+	size_t size;
+	size_t pos{0};
+};
+
+class Reader
+{
+public:
+	Reader(const uint8_t* buffer, size_t length) : buffer(buffer), length(length)
+	{
+	}
+
+	bool read(void* data, size_t count)
+	{
+		if(pos + count > length) {
+			return false;
+		}
+		memcpy(data, &buffer[pos], count);
+		pos += count;
+		return true;
+	}
+
+	bool readString(String& value)
+	{
+		uint8_t len;
+		if(!read(&len, 1) || pos + len > length || !value.setLength(len)) {
+			return false;
+		}
+		return read(value.begin(), len);
+	}
+
+	const uint8_t* buffer;
+	size_t length;
+	size_t pos{0};
+};
+
+} // namespace
+
+SessionCache::Entry* SessionCache::find(const String& key)
+{
+	for(auto& entry : entries) {
+		if(entry.key == key) {
+			return &entry;
+		}
+	}
+	return nullptr;
+}
+
+SessionCache::Entry* SessionCache::add(const String& key)
+{
+	auto entry = find(key);
+	if(entry != nullptr) {
+		return entry;
+	}
+
+	// Use a free entry, or replace the least recently used one
+	entry = &entries[0];
+	for(auto& e : entries) {
+		if(!e.key) {
+			entry = &e;
+			break;
+		}
+		if(e.lastUsed < entry->lastUsed) {
+			entry = &e;
+		}
+	}
+	*entry = Entry{};
+	entry->key = key;
+	return entry;
+}
+
+bool SessionCache::get(const String& key, SessionState& state)
+{
+	auto entry = find(key);
+	if(entry == nullptr || !entry->state.isResumable()) {
+		return false;
+	}
+	entry->lastUsed = ++useCount;
+	state = entry->state;
+	return true;
+}
+
+void SessionCache::put(const String& key, const SessionState& state)
+{
+	if(!key || !state.isResumable() || key.length() > 255) {
+		return;
+	}
+
+	auto entry = add(key);
+	entry->state = state;
+	entry->lastUsed = ++useCount;
+	debug_d("[SSL] Cached session for %s", key.c_str());
+}
+
+void SessionCache::remove(const String& key)
+{
+	auto entry = find(key);
+	if(entry == nullptr) {
+		return;
+	}
+	if(entry->bufferSize == MaxBufferSize::Default) {
+		*entry = Entry{};
+	} else {
+		entry->state = SessionState{};
+	}
+}
+
+MaxBufferSize SessionCache::getBufferSizeHint(const String& key) const
+{
+	auto entry = find(key);
+	return entry ? entry->bufferSize : MaxBufferSize::Default;
+}
+
+void SessionCache::setBufferSizeHint(const String& key, MaxBufferSize size)
+{
+	if(!key || key.length() > 255) {
+		return;
+	}
+	auto entry = add(key);
+	entry->bufferSize = size;
+	entry->lastUsed = ++useCount;
+}
+
+void SessionCache::clear()
+{
+	for(auto& entry : entries) {
+		entry = Entry{};
+	}
+	useCount = 0;
+}
+
+unsigned SessionCache::count() const
+{
+	unsigned n{0};
+	for(auto& entry : entries) {
+		if(entry.key) {
+			++n;
+		}
+	}
+	return n;
+}
+
+size_t SessionCache::serialize(uint8_t* buffer, size_t bufferSize) const
+{
+	if(buffer != nullptr && bufferSize < sizeof(CacheHeader)) {
+		return 0;
+	}
+
+	// Write most recently used first, so if space runs out the oldest entries are dropped
+	const Entry* sorted[SSL_SESSION_CACHE_SIZE];
+	unsigned count{0};
+	for(auto& entry : entries) {
+		if(!entry.key) {
+			continue;
+		}
+		unsigned i = count++;
+		for(; i > 0 && sorted[i - 1]->lastUsed < entry.lastUsed; --i) {
+			sorted[i] = sorted[i - 1];
+		}
+		sorted[i] = &entry;
+	}
+
+	size_t maxLength = buffer ? std::min(bufferSize - sizeof(CacheHeader), size_t(0xffff)) : 0xffff;
+	Writer writer(buffer ? buffer + sizeof(CacheHeader) : nullptr, maxLength);
+	CacheHeader header{CACHE_MAGIC, 0, 0, 0, 0};
+	for(unsigned i = 0; i < count; ++i) {
+		auto& entry = *sorted[i];
+		auto& state = entry.state;
+		auto startPos = writer.pos;
+		writer.writeString(entry.key);
+		writer.writeString(String(reinterpret_cast<const char*>(state.id.getValue()), state.id.getLength()));
+		writer.writeString(state.masterSecret);
+		writer.write16(state.version);
+		writer.write16(state.cipherSuite);
+		writer.write8(uint8_t(entry.bufferSize));
+		if(writer.pos > writer.size) {
+			writer.pos = startPos;
+			break;
+		}
+		++header.count;
+	}
+
+	if(buffer == nullptr) {
+		return sizeof(header) + writer.pos;
+	}
+
+	header.length = writer.pos;
+	header.checksum = getChecksum(writer.buffer, writer.pos);
+	memcpy(buffer, &header, sizeof(header));
+	return sizeof(header) + writer.pos;
+}
+
+bool SessionCache::deserialize(const uint8_t* buffer, size_t length)
+{
+	clear();
+
+	CacheHeader header;
+	if(length < sizeof(header)) {
+		return false;
+	}
+	memcpy(&header, buffer, sizeof(header));
+	buffer += sizeof(header);
+	if(header.magic != CACHE_MAGIC || header.length > length - sizeof(header) ||
+	   header.checksum != getChecksum(buffer, header.length)) {
+		debug_w("[SSL] Session cache data invalid");
+		return false;
+	}
+
+	Reader reader(buffer, header.length);
+	unsigned count = std::min(unsigned(header.count), unsigned(SSL_SESSION_CACHE_SIZE));
+	for(unsigned i = 0; i < count; ++i) {
+		auto& entry = entries[i];
+		auto& state = entry.state;
+		String id;
+		uint8_t bufferSize;
+		if(!reader.readString(entry.key) || !reader.readString(id) || !reader.readString(state.masterSecret) ||
+		   !reader.read(&state.version, 2) || !reader.read(&state.cipherSuite, 2) || !reader.read(&bufferSize, 1) ||
+		   (id.length() != 0 && !state.id.assign(reinterpret_cast<const uint8_t*>(id.c_str()), id.length()))) {
+			clear();
+			return false;
+		}
+		entry.bufferSize = MaxBufferSize(bufferSize);
+		// First entry is most recently used
+		entry.lastUsed = count - i;
+	}
+	useCount = count;
+
+	debug_d("[SSL] Loaded %u cached sessions", count);
+	return true;
+}
+
+bool SessionCache::save(Storage::Partition partition) const
+{
+	if(!partition) {
+		return false;
+	}
+
+	size_t size = serialize(nullptr, 0);
+	std::unique_ptr<uint8_t[]> buffer(new uint8_t[size]);
+	if(!buffer) {
+		return false;
+	}
+	size = serialize(buffer.get(), size);
+
+	auto blockSize = partition.getBlockSize();
+	auto eraseSize = (size + blockSize - 1) / blockSize * blockSize;
+	return partition.erase_range(0, eraseSize) && partition.write(0, buffer.get(), size);
+}
+
+bool SessionCache::load(Storage::Partition partition)
+{
+	CacheHeader header;
+	if(!partition || !partition.read(0, &header, sizeof(header)) || header.magic != CACHE_MAGIC) {
+		clear();
+		return false;
+	}
+
+	size_t size = sizeof(header) + header.length;
+	std::unique_ptr<uint8_t[]> buffer(new uint8_t[size]);
+	if(!buffer || !partition.read(0, buffer.get(), size)) {
+		clear();
+		return false;
+	}
+	return deserialize(buffer.get(), size);
+}
+
+} // namespace Ssl
@@ -0,0 +1,84 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * ValidatorCache.cpp
+ *
+ ****/
+
+#include <Network/Ssl/ValidatorCache.h>
+
+namespace Ssl
+{
+ValidatorCache validatorCache;
+
+ValidatorCache::Entry* ValidatorCache::find(const Fingerprint::Cert::Sha256& fingerprint, uint32_t validatorId)
+{
+	for(auto& entry : entries) {
+		if(entry.validatorId == validatorId && entry.fingerprint.hash == fingerprint.hash) {
+			return &entry;
+		}
+	}
+	return nullptr;
+}
+
+bool ValidatorCache::contains(const Fingerprint::Cert::Sha256& fingerprint, uint32_t validatorId)
+{
+	if(validatorId == 0) {
+		return false;
+	}
+	auto entry = find(fingerprint, validatorId);
+	if(entry == nullptr) {
+		return false;
+	}
+	entry->lastUsed = ++useCount;
+	return true;
+}
+
+void ValidatorCache::add(const Fingerprint::Cert::Sha256& fingerprint, uint32_t validatorId)
+{
+	if(validatorId == 0) {
+		return;
+	}
+
+	auto entry = find(fingerprint, validatorId);
+	if(entry == nullptr) {
+		// Use a free entry, or replace the least recently used one
+		entry = &entries[0];
+		for(auto& e : entries) {
+			if(e.validatorId == 0) {
+				entry = &e;
+				break;
+			}
+			if(e.lastUsed < entry->lastUsed) {
+				entry = &e;
+			}
+		}
+		entry->fingerprint = fingerprint;
+		entry->validatorId = validatorId;
+	}
+	entry->lastUsed = ++useCount;
+}
+
+void ValidatorCache::clear()
+{
+	for(auto& entry : entries) {
+		entry = Entry{};
+	}
+	useCount = 0;
+}
+
+unsigned ValidatorCache::count() const
+{
+	unsigned n{0};
+	for(auto& entry : entries) {
+		if(entry.validatorId != 0) {
+			++n;
+		}
+	}
+	return n;
+}
+
+} // namespace Ssl
@@ -27,6 +27,17 @@ bool ValidatorList::validate(const Certificate* certificate)
 		return true;
 	}
 
+	auto cacheId = getCacheId();
+	Fingerprint fp;
+	if(cacheId != 0 && !certificate->getFingerprint(Fingerprint::Type::CertSha256, fp)) {
+		cacheId = 0;
+	}
+	if(cacheId != 0 && validatorCache.contains(fp.cert.sha256, cacheId)) {
+		debug_i("SSL validator: cached");
+		removeAllElements();
+		return true;
+	}
+
 	bool success = false;
 	while(!isEmpty()) {
 		if(!success) {
@@ -37,7 +48,24 @@ bool ValidatorList::validate(const Certificate* certificate)
 
 	debug_w("SSL validator: %s", success ? _F("Success") : _F("NO match"));
 
+	if(success && cacheId != 0) {
+		validatorCache.add(fp.cert.sha256, cacheId);
+	}
+
 	return success;
 }
 
+uint32_t ValidatorList::getCacheId() const
+{
+	uint32_t id{0};
+	for(unsigned i = 0; i < count(); ++i) {
+		auto validatorId = operator[](i).getCacheId();
+		if(validatorId == 0) {
+			return 0;
+		}
+		id = (id ^ validatorId) * 16777619U;
+	}
+	return id;
+}
+
 } // namespace Ssl
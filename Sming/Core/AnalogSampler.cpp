@@ -0,0 +1,168 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * AnalogSampler.cpp - Ring buffer, decimation and threshold handling for continuous ADC sampling
+ *
+ * Architecture code calls `addSample()` from interrupt context for every conversion.
+ * Only the interrupt writes `bufferHead` and only the application writes `bufferTail`,
+ * so no locking is required to transfer samples.
+ *
+ * Architectures without DMA support use Timer1 in auto-reload mode, with one conversion per interrupt.
+ *
+ ****/
+
+#include "AnalogSampler.h"
+#include "Digital.h"
+#include <Platform/System.h>
+#include <debug_progmem.h>
+
+bool AnalogSampler::begin(const Config& config, Sample* buffer, size_t length)
+{
+	if(running || buffer == nullptr || length < 2 || config.sampleRate == 0 || config.decimation == 0) {
+		return false;
+	}
+
+	this->config = config;
+	this->buffer = buffer;
+	bufferLength = length;
+	bufferHead = 0;
+	bufferTail = 0;
+	overflowCount = 0;
+	accumulator = 0;
+	accumulated = 0;
+	triggered = false;
+
+	if(!startSampling()) {
+		this->buffer = nullptr;
+		bufferLength = 0;
+		return false;
+	}
+
+	running = true;
+	return true;
+}
+
+void AnalogSampler::end()
+{
+	if(!running) {
+		return;
+	}
+
+	stopSampling();
+	running = false;
+}
+
+size_t AnalogSampler::read(Sample* samples, size_t count)
+{
+	size_t head = bufferHead;
+	size_t tail = bufferTail;
+	size_t n = 0;
+	while(n < count && tail != head) {
+		samples[n++] = buffer[tail++];
+		if(tail == bufferLength) {
+			tail = 0;
+		}
+	}
+	bufferTail = tail;
+	return n;
+}
+
+void AnalogSampler::setThreshold(Sample high, Sample low, ThresholdDelegate callback)
+{
+	auto level = noInterrupts();
+	thresholdHigh = high;
+	thresholdLow = low;
+	thresholdCallback = callback;
+	triggered = false;
+	restoreInterrupts(level);
+}
+
+void AnalogSampler::addSample(Sample raw)
+{
+	accumulator += raw;
+	if(++accumulated < config.decimation) {
+		return;
+	}
+	Sample value = accumulator / accumulated;
+	accumulator = 0;
+	accumulated = 0;
+
+	size_t head = bufferHead;
+	size_t next = head + 1;
+	if(next == bufferLength) {
+		next = 0;
+	}
+	if(next == bufferTail) {
+		++overflowCount;
+	} else {
+		buffer[head] = value;
+		bufferHead = next;
+	}
+
+	if(!thresholdCallback) {
+		return;
+	}
+	if(triggered) {
+		triggered = (value > thresholdLow);
+		return;
+	}
+	if(value < thresholdHigh) {
+		return;
+	}
+	triggered = true;
+	triggerValue = value;
+	// Only one notification is outstanding at a time
+	if(!triggerPending) {
+		triggerPending = true;
+		System.queueCallback(thresholdHandler, this);
+	}
+}
+
+void AnalogSampler::thresholdHandler(void* param)
+{
+	auto self = static_cast<AnalogSampler*>(param);
+	self->triggerPending = false;
+	if(self->thresholdCallback) {
+		self->thresholdCallback(self->triggerValue);
+	}
+}
+
+#if !defined(ARCH_ESP32) && !defined(ARCH_RP2040)
+
+bool AnalogSampler::startSampling()
+{
+#ifdef ARCH_ESP8266
+	if(config.pin != A0) {
+		debug_e("[ADC] Pin %u not supported", config.pin);
+		return false;
+	}
+#endif
+
+	auto ticks = TimerApi::Clock::frequency() / config.sampleRate;
+	if(ticks < TimerApi::minTicks() || ticks > TimerApi::maxTicks()) {
+		debug_e("[ADC] Sample rate %u out of range", config.sampleRate);
+		return false;
+	}
+
+	TimerApi::setCallback(timerCallback, this);
+	TimerApi::setInterval(ticks);
+	TimerApi::arm(true);
+	return true;
+}
+
+void AnalogSampler::stopSampling()
+{
+	TimerApi::disarm();
+	TimerApi::setCallback(nullptr, nullptr);
+}
+
+void AnalogSampler::timerCallback(void* arg)
+{
+	auto self = static_cast<AnalogSampler*>(arg);
+	self->addSample(analogRead(self->config.pin));
+}
+
+#endif
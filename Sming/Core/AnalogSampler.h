@@ -0,0 +1,172 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * AnalogSampler.h
+ *
+ ****/
+
+#pragma once
+
+#include "HardwareTimer.h"
+#include <Delegate.h>
+#include <pins_arduino.h>
+
+/**
+ * @defgroup adc_sampler Continuous ADC sampling
+ * @brief Sample an analogue input at a fixed rate into a ring buffer
+ * @ingroup gpio
+ * @{
+ */
+
+/**
+ * @brief Number of conversions transferred by each DMA block
+ * @note Only used on architectures with DMA support (Esp32, Rp2040).
+ * Samples become available to the application one block at a time.
+ */
+#ifndef ADC_SAMPLER_DMA_BLOCK_SIZE
+#define ADC_SAMPLER_DMA_BLOCK_SIZE 64
+#endif
+
+/**
+ * @brief Continuously samples one analogue input into an application-supplied ring buffer
+ *
+ * Conversions may optionally be averaged in groups (decimation), which reduces noise and
+ * the rate at which the application must consume samples.
+ *
+ * A threshold callback may be set which is invoked when a stored sample rises to or above
+ * a given level. It is not invoked again until a sample falls to or below a lower (re-arm) level.
+ *
+ * Esp8266 and Host take one conversion per Timer1 interrupt, so `HardwareTimer` and `Waveform`
+ * cannot be used at the same time. Each conversion takes several tens of microseconds on the Esp8266,
+ * which limits the practical rate to a few kHz.
+ *
+ * Esp32 and Rp2040 convert continuously using DMA.
+ *
+ * Only one sampler may be active at a time.
+ */
+class AnalogSampler
+{
+public:
+	using Sample = uint16_t;
+
+	/**
+	 * @brief Called in task context when the threshold is crossed
+	 * @param value The sample which reached the threshold
+	 */
+	using ThresholdDelegate = Delegate<void(Sample value)>;
+
+	struct Config {
+		uint16_t pin{A0};
+		uint32_t sampleRate{1000}; ///< Conversion rate, in Hz
+		uint16_t decimation{1};	   ///< Number of conversions averaged for each stored sample
+	};
+
+	~AnalogSampler()
+	{
+		end();
+	}
+
+	/**
+	 * @brief Start sampling
+	 * @param config
+	 * @param buffer Ring buffer to receive samples, must remain valid until end() is called
+	 * @param length Number of samples in buffer, one slot is always left unused
+	 * @retval bool false if already running, or the pin or rate is not supported
+	 */
+	bool begin(const Config& config, Sample* buffer, size_t length);
+
+	/**
+	 * @brief Stop sampling
+	 * @note Unread samples remain available
+	 */
+	void end();
+
+	bool isRunning() const
+	{
+		return running;
+	}
+
+	/**
+	 * @brief Get number of samples waiting to be read
+	 */
+	size_t available() const
+	{
+		size_t head = bufferHead;
+		return (head >= bufferTail) ? head - bufferTail : bufferLength - bufferTail + head;
+	}
+
+	/**
+	 * @brief Take samples from the ring buffer
+	 * @param samples Destination
+	 * @param count Maximum number of samples to read
+	 * @retval size_t Number of samples read
+	 */
+	size_t read(Sample* samples, size_t count);
+
+	/**
+	 * @brief Set threshold notification
+	 * @param high Level at or above which callback is invoked
+	 * @param low Level at or below which notification is re-armed
+	 * @param callback Pass nullptr to cancel
+	 */
+	void setThreshold(Sample high, Sample low, ThresholdDelegate callback);
+
+	/**
+	 * @brief Get the number of stored samples discarded because the buffer was full
+	 */
+	uint32_t getOverflowCount() const
+	{
+		return overflowCount;
+	}
+
+	/**
+	 * @brief Get the rate at which samples are stored, in Hz
+	 */
+	uint32_t getOutputRate() const
+	{
+		return config.sampleRate / config.decimation;
+	}
+
+private:
+	// Architecture-specific
+	bool startSampling();
+	void stopSampling();
+
+	void IRAM_ATTR addSample(Sample raw);
+	static void thresholdHandler(void* param);
+
+#if defined(ARCH_ESP32)
+	void* handle{nullptr};
+#elif defined(ARCH_RP2040)
+	static void dmaInterruptHandler();
+	void IRAM_ATTR startDma();
+
+	Sample dmaBuffer[2][ADC_SAMPLER_DMA_BLOCK_SIZE];
+	int dmaChannel{-1};
+	uint8_t dmaIndex{0};
+#else
+	using TimerApi = Timer1Api<TIMER_CLKDIV_16, eHWT_Maskable>;
+	static void IRAM_ATTR timerCallback(void* arg);
+#endif
+
+	Config config;
+	Sample* buffer{nullptr};
+	size_t bufferLength{0};
+	volatile size_t bufferHead{0};
+	volatile size_t bufferTail{0};
+	volatile uint32_t overflowCount{0};
+	uint32_t accumulator{0};
+	uint16_t accumulated{0};
+	ThresholdDelegate thresholdCallback;
+	Sample thresholdHigh{0};
+	Sample thresholdLow{0};
+	volatile Sample triggerValue{0};
+	bool triggered{false};
+	volatile bool triggerPending{false};
+	bool running{false};
+};
+
+/** @} */
@@ -20,8 +20,8 @@
  * @{
 */
 
-using TimerCallback = void (*)(void* arg); ///< Interrupt-compatible C callback function pointer
-using TimerDelegate = Delegate<void()>;	///< Delegate callback
+using TimerCallback = void (*)(void* arg);	   ///< Interrupt-compatible C callback function pointer
+using TimerDelegate = InplaceDelegate<void()>; ///< Delegate callback
 
 /**
  * @brief Callback timer API class template
@@ -0,0 +1,260 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * Coroutine.h
+ *
+ *	Stackless coroutines, in the style of protothreads, which run via the task queue.
+ *
+ *	The body of a coroutine is written as straight-line code in the `run()` method,
+ *	between `CO_BEGIN()` and `CO_END()`. It may suspend at any point using the `CO_xxx` macros,
+ *	so the system continues normally whilst it waits for time to pass or for an event to occur.
+ *	When resumed, execution continues from the statement following the suspension point.
+ *
+ *	Because coroutines do not have their own stack, local variables are NOT preserved
+ *	when suspended: use class members instead. Suspension macros must appear directly
+ *	within `run()`, not in called functions, and `switch` statements must not be used
+ *	in the coroutine body.
+ *
+ ****/
+
+#pragma once
+
+#include <SimpleTimer.h>
+#include <Platform/System.h>
+
+/**
+ * @defgroup coroutine Coroutines
+ * @brief Stackless cooperative coroutines
+ * @ingroup system
+ * @{
+ */
+
+/**
+ * @brief Start of the coroutine body
+ */
+#define CO_BEGIN()                                                                                                     \
+	switch(resumePoint) {                                                                                              \
+	case 0:
+
+/**
+ * @brief End of the coroutine body
+ */
+#define CO_END()                                                                                                       \
+	}                                                                                                                  \
+	coFinish();
+
+/*
+ * Suspend execution, resuming at the following statement
+ */
+#define CO_SUSPEND_(action)                                                                                            \
+	do {                                                                                                               \
+		resumePoint = __LINE__;                                                                                        \
+		action;                                                                                                        \
+		return;                                                                                                        \
+	case __LINE__:;                                                                                                    \
+	} while(0)
+
+/**
+ * @brief Allow other tasks to run, continuing via the task queue
+ */
+#define CO_YIELD() CO_SUSPEND_(coYield())
+
+/**
+ * @brief Suspend for a period of time
+ * @param ms Time in milliseconds
+ * @note Calling `wake()` ends the delay early
+ */
+#define CO_DELAY(ms) CO_SUSPEND_(coSleep(ms))
+
+/**
+ * @brief Suspend until `wake()` is called
+ */
+#define CO_WAIT() CO_SUSPEND_(coWait())
+
+/**
+ * @brief Suspend until a condition becomes true
+ * @param condition Evaluated immediately, then again each time `wake()` is called
+ *
+ * For example, an event handler such as a TcpClient delegate or DNS callback records
+ * the result and calls `wake()`.
+ */
+#define CO_AWAIT(condition)                                                                                            \
+	do {                                                                                                               \
+		resumePoint = __LINE__;                                                                                        \
+	case __LINE__:                                                                                                     \
+		if(!(condition)) {                                                                                             \
+			coWait();                                                                                                  \
+			return;                                                                                                    \
+		}                                                                                                              \
+	} while(0)
+
+/**
+ * @brief Finish the coroutine early
+ */
+#define CO_RETURN()                                                                                                    \
+	do {                                                                                                               \
+		coFinish();                                                                                                    \
+		return;                                                                                                        \
+	} while(0)
+
+/**
+ * @brief Base class for a stackless coroutine
+ * @note A coroutine must not be destroyed whilst it is queued for execution.
+ */
+class Coroutine
+{
+public:
+	/**
+	 * @brief State of a coroutine
+	 */
+	enum class State {
+		Idle,	  ///< Not yet started
+		Ready,	  ///< Queued to run
+		Sleeping, ///< Suspended by CO_DELAY
+		Waiting,  ///< Suspended by CO_WAIT or CO_AWAIT
+		Finished, ///< Completed or stopped
+	};
+
+	/**
+	 * @brief Constructor
+	 * @param priority Task queue priority used when the coroutine runs
+	 */
+	Coroutine(TaskPriority priority = TaskPriority::Normal) : priority(priority)
+	{
+	}
+
+	virtual ~Coroutine()
+	{
+		sleepTimer.stop();
+	}
+
+	/**
+	 * @brief Start (or restart) the coroutine from the beginning
+	 * @retval bool true on success, false if task queue is full
+	 */
+	bool start()
+	{
+		sleepTimer.stop();
+		resumePoint = 0;
+		state = State::Ready;
+		return schedule();
+	}
+
+	/**
+	 * @brief Stop the coroutine
+	 */
+	void stop()
+	{
+		sleepTimer.stop();
+		state = State::Finished;
+	}
+
+	/**
+	 * @brief Resume a suspended coroutine
+	 * @retval bool true on success, false if not running or task queue is full
+	 * @note Typically called from an event callback. May be called more than once.
+	 */
+	bool wake()
+	{
+		if(state == State::Idle || state == State::Finished) {
+			return false;
+		}
+		sleepTimer.stop();
+		state = State::Ready;
+		return schedule();
+	}
+
+	State getState() const
+	{
+		return state;
+	}
+
+	bool isFinished() const
+	{
+		return state == State::Finished;
+	}
+
+protected:
+	/**
+	 * @brief Inherited classes implement the coroutine body here
+	 */
+	virtual void run() = 0;
+
+	/**
+	 * @brief Called when the coroutine completes
+	 */
+	virtual void onFinished()
+	{
+	}
+
+	/* Used by CO_xxx macros */
+
+	void coYield()
+	{
+		schedule();
+	}
+
+	void coSleep(unsigned ms)
+	{
+		state = State::Sleeping;
+		sleepTimer.initializeMs(
+			ms,
+			[](void* param) {
+				auto co = static_cast<Coroutine*>(param);
+				co->state = State::Ready;
+				co->service();
+			},
+			this);
+		sleepTimer.startOnce();
+	}
+
+	void coWait()
+	{
+		state = State::Waiting;
+	}
+
+	void coFinish()
+	{
+		state = State::Finished;
+		onFinished();
+	}
+
+protected:
+	unsigned resumePoint{0}; ///< Where to continue execution, used by CO_xxx macros
+
+private:
+	bool schedule()
+	{
+		if(scheduled) {
+			return true;
+		}
+
+		scheduled = System.queueCallback(
+			[](void* param) {
+				auto co = static_cast<Coroutine*>(param);
+				co->scheduled = false;
+				co->service();
+			},
+			this, priority);
+
+		return scheduled;
+	}
+
+	void service()
+	{
+		if(state == State::Ready) {
+			run();
+		}
+	}
+
+private:
+	State state{State::Idle};
+	TaskPriority priority;
+	bool scheduled{false};
+	SimpleTimer sleepTimer;
+};
+
+/** @} */
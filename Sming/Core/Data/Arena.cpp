@@ -0,0 +1,73 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * Arena.cpp
+ *
+ ****/
+
+#include "Arena.h"
+#include <cstdlib>
+
+void* Arena::allocateFromBlock(size_t length, size_t align)
+{
+	auto offset = (used + align - 1) & ~(align - 1);
+	if(offset + length > size) {
+		return nullptr;
+	}
+	used = offset + length;
+	if(used > peak) {
+		peak = used;
+	}
+	return &buffer[offset];
+}
+
+void* Arena::allocate(size_t length, size_t align, Destructor destructor)
+{
+	auto savedUsed = used;
+	Record* rec{nullptr};
+	if(destructor != nullptr) {
+		rec = static_cast<Record*>(allocateFromBlock(sizeof(Record), alignof(Record)));
+	}
+	if(rec != nullptr || destructor == nullptr) {
+		auto mem = allocateFromBlock(length, align);
+		if(mem != nullptr) {
+			if(rec != nullptr) {
+				*rec = Record{records, destructor, mem, false};
+				records = rec;
+			}
+			return mem;
+		}
+	}
+	used = savedUsed;
+
+	// Block exhausted, use heap with record header
+	auto offset = (sizeof(Record) + align - 1) & ~(align - 1);
+	auto mem = static_cast<uint8_t*>(malloc(offset + length));
+	if(mem == nullptr) {
+		return nullptr;
+	}
+	rec = reinterpret_cast<Record*>(mem);
+	*rec = Record{records, destructor, mem + offset, true};
+	records = rec;
+	++heapCount;
+	return rec->object;
+}
+
+void Arena::reset()
+{
+	while(records != nullptr) {
+		auto rec = records;
+		records = rec->next;
+		if(rec->destructor != nullptr) {
+			rec->destructor(rec->object);
+		}
+		if(rec->isHeap) {
+			free(rec);
+		}
+	}
+	used = 0;
+	heapCount = 0;
+}
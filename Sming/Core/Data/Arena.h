@@ -0,0 +1,132 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * Arena.h - Bump allocator for objects sharing a common lifetime
+ *
+ ****/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+
+/**
+ * @brief Allocates objects sequentially from a single block, releasing them all together
+ *
+ * Suited to temporary data which lives for a well-defined period, such as handling a network request.
+ * The block is allocated once on construction, so in steady state use no further heap activity occurs.
+ *
+ * If the block is exhausted, allocations fall back to the heap and are freed on the next `reset()`.
+ * Destructors for objects created using `create()` are called, most recent first, on `reset()`.
+ *
+ * ```
+ * Arena arena(1024);
+ *
+ * auto state = arena.create<ParserState>();
+ * ...
+ * arena.reset();	// Destroys state
+ * ```
+ */
+class Arena
+{
+public:
+	/**
+	 * @brief Constructor
+	 * @param size Size of block. If 0, all allocations use the heap.
+	 */
+	Arena(size_t size) : buffer(size ? new uint8_t[size] : nullptr), size(buffer ? size : 0)
+	{
+	}
+
+	~Arena()
+	{
+		reset();
+	}
+
+	Arena(const Arena&) = delete;
+	Arena& operator=(const Arena&) = delete;
+
+	/**
+	 * @brief Obtain uninitialised memory
+	 * @param length Number of bytes required
+	 * @param align Required alignment, a power of 2
+	 * @retval void* nullptr if out of memory
+	 */
+	void* allocate(size_t length, size_t align = alignof(std::max_align_t))
+	{
+		return allocate(length, align, nullptr);
+	}
+
+	/**
+	 * @brief Allocate and construct an object, to be destroyed on `reset()`
+	 */
+	template <typename T, typename... Args> T* create(Args&&... args)
+	{
+		auto mem = allocate(sizeof(T), alignof(T), [](void* object) { static_cast<T*>(object)->~T(); });
+		return mem ? new(mem) T(std::forward<Args>(args)...) : nullptr;
+	}
+
+	/**
+	 * @brief Destroy all objects and release memory
+	 */
+	void reset();
+
+	/**
+	 * @brief Get size of arena block
+	 */
+	size_t getSize() const
+	{
+		return size;
+	}
+
+	/**
+	 * @brief Get number of bytes of arena block in use
+	 */
+	size_t getUsed() const
+	{
+		return used;
+	}
+
+	/**
+	 * @brief Get highest value of `getUsed()` since construction
+	 */
+	size_t getPeak() const
+	{
+		return peak;
+	}
+
+	/**
+	 * @brief Get number of allocations which have used the heap since the last reset
+	 */
+	unsigned getHeapCount() const
+	{
+		return heapCount;
+	}
+
+private:
+	using Destructor = void (*)(void* object);
+
+	// Precedes each allocation which requires cleanup
+	struct Record {
+		Record* next;
+		Destructor destructor;
+		void* object;
+		bool isHeap;
+	};
+
+	void* allocate(size_t length, size_t align, Destructor destructor);
+	void* allocateFromBlock(size_t length, size_t align);
+
+	std::unique_ptr<uint8_t[]> buffer;
+	size_t size;
+	size_t used{0};
+	size_t peak{0};
+	Record* records{nullptr};
+	unsigned heapCount{0};
+};
@@ -0,0 +1,227 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * RingBuffer.h - Lock-free single-producer, single-consumer ring buffer
+ *
+ ****/
+
+#pragma once
+
+#include <esp_systemapi.h>
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * @brief Fixed-size ring buffer for passing data between one producer and one consumer without locking
+ * @tparam T Element type, must be trivially copyable
+ * @tparam size Number of elements, must be a power of 2
+ *
+ * Typically the producer is an interrupt handler and the consumer is task code, or vice versa.
+ * No critical sections are required provided each side only calls its own methods:
+ *
+ * - Producer: `push()`, `getWriteRegion()`, `produce()`, `space()`
+ * - Consumer: `pop()`, `peek()`, `getReadRegion()`, `consume()`, `available()`, `clear()`
+ *
+ * Read and write positions are free-running counters, each written by only one side
+ * using acquire/release ordering, so this is also safe between cores on multi-core devices.
+ * All `size` elements are usable.
+ *
+ * Region access allows data to be written or read in place, for example by DMA or a peripheral FIFO:
+ *
+ * ```
+ * // Consumer
+ * const int16_t* samples;
+ * while(auto count = ring.getReadRegion(samples)) {
+ *     process(samples, count);
+ *     ring.consume(count);
+ * }
+ * ```
+ */
+template <typename T, size_t size> class RingBuffer
+{
+public:
+	static_assert(size != 0 && (size & (size - 1)) == 0, "RingBuffer size must be a power of 2");
+	static_assert(std::is_trivially_copyable<T>::value, "RingBuffer element type must be trivially copyable");
+
+	static constexpr size_t capacity()
+	{
+		return size;
+	}
+
+	/**
+	 * @name Producer methods
+	 * @{
+	 */
+
+	/**
+	 * @brief Get number of elements which may be written
+	 */
+	__forceinline size_t IRAM_ATTR space() const
+	{
+		return size - (writePos.load(std::memory_order_relaxed) - readPos.load(std::memory_order_acquire));
+	}
+
+	bool IRAM_ATTR push(const T& item)
+	{
+		auto pos = writePos.load(std::memory_order_relaxed);
+		if(pos - readPos.load(std::memory_order_acquire) == size) {
+			return false;
+		}
+		buffer[pos & mask] = item;
+		writePos.store(pos + 1, std::memory_order_release);
+		return true;
+	}
+
+	/**
+	 * @brief Write as many elements as will fit
+	 * @retval size_t Number of elements written
+	 */
+	size_t IRAM_ATTR push(const T* items, size_t count)
+	{
+		auto pos = writePos.load(std::memory_order_relaxed);
+		count = std::min(count, size - (pos - readPos.load(std::memory_order_acquire)));
+		copy(&buffer[0], pos & mask, items, count);
+		writePos.store(pos + count, std::memory_order_release);
+		return count;
+	}
+
+	/**
+	 * @brief Get contiguous free space for writing in place
+	 * @param data On return, points to start of free space
+	 * @retval size_t Number of elements which may be written at `data`
+	 * @note Call `produce()` to make written elements available to the consumer.
+	 * Where free space wraps around the end of the buffer, this returns the first part only.
+	 */
+	size_t IRAM_ATTR getWriteRegion(T*& data)
+	{
+		auto pos = writePos.load(std::memory_order_relaxed);
+		auto offset = pos & mask;
+		data = &buffer[offset];
+		return std::min(size - (pos - readPos.load(std::memory_order_acquire)), size - offset);
+	}
+
+	/**
+	 * @brief Publish elements written via `getWriteRegion()`
+	 */
+	__forceinline void IRAM_ATTR produce(size_t count)
+	{
+		writePos.store(writePos.load(std::memory_order_relaxed) + count, std::memory_order_release);
+	}
+
+	/** @} */
+
+	/**
+	 * @name Consumer methods
+	 * @{
+	 */
+
+	/**
+	 * @brief Get number of elements which may be read
+	 */
+	__forceinline size_t IRAM_ATTR available() const
+	{
+		return writePos.load(std::memory_order_acquire) - readPos.load(std::memory_order_relaxed);
+	}
+
+	__forceinline bool IRAM_ATTR isEmpty() const
+	{
+		return available() == 0;
+	}
+
+	bool IRAM_ATTR pop(T& item)
+	{
+		auto pos = readPos.load(std::memory_order_relaxed);
+		if(pos == writePos.load(std::memory_order_acquire)) {
+			return false;
+		}
+		item = buffer[pos & mask];
+		readPos.store(pos + 1, std::memory_order_release);
+		return true;
+	}
+
+	/**
+	 * @brief Read up to the requested number of elements
+	 * @retval size_t Number of elements read
+	 */
+	size_t IRAM_ATTR pop(T* items, size_t count)
+	{
+		auto pos = readPos.load(std::memory_order_relaxed);
+		count = std::min(count, size_t(writePos.load(std::memory_order_acquire) - pos));
+		copy(items, &buffer[0], pos & mask, count);
+		readPos.store(pos + count, std::memory_order_release);
+		return count;
+	}
+
+	/**
+	 * @brief Read next element without removing it
+	 */
+	bool IRAM_ATTR peek(T& item) const
+	{
+		auto pos = readPos.load(std::memory_order_relaxed);
+		if(pos == writePos.load(std::memory_order_acquire)) {
+			return false;
+		}
+		item = buffer[pos & mask];
+		return true;
+	}
+
+	/**
+	 * @brief Get contiguous data for reading in place
+	 * @param data On return, points to first available element
+	 * @retval size_t Number of elements which may be read from `data`
+	 * @note Call `consume()` to release elements when finished.
+	 * Where data wraps around the end of the buffer, this returns the first part only.
+	 */
+	size_t IRAM_ATTR getReadRegion(const T*& data) const
+	{
+		auto pos = readPos.load(std::memory_order_relaxed);
+		auto offset = pos & mask;
+		data = &buffer[offset];
+		return std::min(size_t(writePos.load(std::memory_order_acquire) - pos), size - offset);
+	}
+
+	/**
+	 * @brief Release elements read via `getReadRegion()`
+	 */
+	__forceinline void IRAM_ATTR consume(size_t count)
+	{
+		readPos.store(readPos.load(std::memory_order_relaxed) + count, std::memory_order_release);
+	}
+
+	/**
+	 * @brief Discard all available data
+	 */
+	void clear()
+	{
+		readPos.store(writePos.load(std::memory_order_acquire), std::memory_order_release);
+	}
+
+	/** @} */
+
+private:
+	static constexpr size_t mask{size - 1};
+
+	// Copy into ring at offset, wrapping as required
+	static void IRAM_ATTR copy(T* ring, size_t offset, const T* items, size_t count)
+	{
+		auto n = std::min(count, size - offset);
+		memcpy(&ring[offset], items, n * sizeof(T));
+		memcpy(ring, &items[n], (count - n) * sizeof(T));
+	}
+
+	// Copy from ring at offset, wrapping as required
+	static void IRAM_ATTR copy(T* items, const T* ring, size_t offset, size_t count)
+	{
+		auto n = std::min(count, size - offset);
+		memcpy(items, &ring[offset], n * sizeof(T));
+		memcpy(&items[n], ring, (count - n) * sizeof(T));
+	}
+
+	T buffer[size];
+	std::atomic<uint32_t> writePos{0}; ///< Modified only by producer
+	std::atomic<uint32_t> readPos{0};  ///< Modified only by consumer
+};
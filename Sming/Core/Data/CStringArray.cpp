@@ -66,6 +66,18 @@ int CStringArray::indexOf(const char* str, bool ignoreCase) const
 	return -1;
 }
 
+int CStringArray::indexOf(const StringView& str, bool ignoreCase) const
+{
+	for(auto it = begin(); it != end(); ++it) {
+		StringView value(*it);
+		if(ignoreCase ? value.equalsIgnoreCase(str) : value.equals(str)) {
+			return it.index();
+		}
+	}
+
+	return -1;
+}
+
 const char* CStringArray::getValue(unsigned index) const
 {
 	if(index >= count()) {
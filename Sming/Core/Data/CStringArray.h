@@ -13,6 +13,7 @@
 #pragma once
 
 #include "WString.h"
+#include "StringView.h"
 #include "stringutil.h"
 
 /**
@@ -153,6 +154,13 @@ public:
 		return indexOf(str.c_str(), ignoreCase);
 	}
 
+	/** @brief Find the given string and return its index
+	 * 	@param str Content to find, need not be NUL-terminated
+	 * 	@param ignoreCase Whether search is case-sensitive or not
+	 * 	@retval int index of given string, -1 if not found
+	 */
+	int indexOf(const StringView& str, bool ignoreCase = true) const;
+
 	/** @brief  Check if array contains a string
 	 *  @param  str String to search for
 	 * 	@param ignoreCase Whether search is case-sensitive or not
@@ -175,6 +183,11 @@ public:
 		return indexOf(str, ignoreCase) >= 0;
 	}
 
+	bool contains(const StringView& str, bool ignoreCase = true) const
+	{
+		return indexOf(str, ignoreCase) >= 0;
+	}
+
 	/** @brief Get string at the given position
 	 *  @param index 0-based index of string to obtain
 	 *  @retval const char* nullptr if index is not valid
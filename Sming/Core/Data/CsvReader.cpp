@@ -13,14 +13,112 @@
 #include "CsvReader.h"
 #include <debug_progmem.h>
 
+namespace
+{
+uint32_t getHash(const char* str)
+{
+	// FNV-1a
+	uint32_t hash{2166136261U};
+	while(*str != '\0') {
+		hash = (hash ^ uint8_t(*str++)) * 16777619U;
+	}
+	return hash;
+}
+
+} // namespace
+
+bool CsvReader::FieldIndex::add(uint16_t offset)
+{
+	if(count == capacity) {
+		uint16_t newCapacity = capacity + 8;
+		auto newOffsets = new uint16_t[newCapacity];
+		if(newOffsets == nullptr) {
+			return false;
+		}
+		if(count != 0) {
+			memcpy(newOffsets, offsets.get(), count * sizeof(uint16_t));
+		}
+		offsets.reset(newOffsets);
+		capacity = newCapacity;
+	}
+	offsets[count++] = offset;
+	return true;
+}
+
+void CsvReader::FieldIndex::build(const char* text, unsigned length)
+{
+	count = 0;
+	if(length == 0) {
+		return;
+	}
+	add(0);
+	for(unsigned i = 0; i < length; ++i) {
+		if(text[i] == '\0') {
+			add(i + 1);
+		}
+	}
+}
+
+void CsvReader::indexHeadings()
+{
+	headingFields.build(headings.c_str(), headings.length());
+	headingHashes.reset(new uint32_t[headingFields.count]);
+	for(unsigned i = 0; i < headingFields.count; ++i) {
+		headingHashes[i] = getHash(headings.c_str() + headingFields.offsets[i]);
+	}
+}
+
+int CsvReader::getColumn(const char* name) const
+{
+	if(name == nullptr) {
+		return -1;
+	}
+	auto hash = getHash(name);
+	for(unsigned i = 0; i < headingFields.count; ++i) {
+		if(headingHashes[i] == hash && strcmp(headings.c_str() + headingFields.offsets[i], name) == 0) {
+			return i;
+		}
+	}
+	return -1;
+}
+
 void CsvReader::reset()
 {
 	source->seekFrom(0, SeekOrigin::Start);
 	if(!userHeadingsProvided) {
 		readRow();
 		headings = row;
+		indexHeadings();
 	}
 	row = nullptr;
+	rowFields.count = 0;
+}
+
+int CsvReader::writeIndex(Print& index)
+{
+	reset();
+	int count{0};
+	while(readRow()) {
+		uint32_t offset = rowOffset;
+		if(index.write(reinterpret_cast<const uint8_t*>(&offset), sizeof(offset)) != sizeof(offset)) {
+			count = -1;
+			break;
+		}
+		++count;
+	}
+	reset();
+	return count;
+}
+
+bool CsvReader::seekRow(IDataSourceStream& index, unsigned rowIndex)
+{
+	uint32_t offset;
+	int pos = rowIndex * sizeof(offset);
+	if(index.seekFrom(pos, SeekOrigin::Start) != pos ||
+	   index.readBytes(reinterpret_cast<char*>(&offset), sizeof(offset)) != sizeof(offset)) {
+		return false;
+	}
+	return seek(offset) && readRow();
 }
 
 bool CsvReader::readRow()
@@ -40,19 +138,26 @@ bool CsvReader::readRow()
 	char lc{'\0'};
 	unsigned writepos{0};
 
+	rowOffset = source->seekFrom(0, SeekOrigin::Current);
+	rowFields.count = 0;
+	rowFields.add(0);
+
 	while(true) {
 		if(buffer.length() == maxLineLength) {
 			debug_w("[CSV] Line buffer limit reached %u", maxLineLength);
+			rowFields.count = 0;
 			return false;
 		}
 		size_t buflen = std::min(writepos + blockSize, maxLineLength);
 		if(!buffer.setLength(buflen)) {
 			debug_e("[CSV] Out of memory %u", buflen);
+			rowFields.count = 0;
 			return false;
 		}
 		auto len = source->readBytes(buffer.begin() + writepos, buflen - writepos);
 		if(len == 0) {
 			if(writepos == 0) {
+				rowFields.count = 0;
 				return false;
 			}
 			buffer.setLength(writepos);
@@ -107,6 +212,7 @@ bool CsvReader::readRow()
 					if(c == fieldSeparator) {
 						c = '\0';
 						fieldKind = FieldKind::unknown;
+						rowFields.add(writepos + 1);
 					} else if(c == '\r') {
 						continue;
 					} else if(c == '\n') {
@@ -34,6 +34,11 @@
  * - Line breaks can be \n or \r\n
  * - Escapes codes within fields will be converted: \n \r \t \", \\
  * - Field separator can be changed in constructor
+ *
+ * Values are returned as pointers into a line buffer which is re-used for each row, and located using
+ * a table of field offsets so access by index does not require searching.
+ * Column names are hashed when the headings are read, so lookup by name is also fast.
+ * Obtain a column index once using `getColumn()` for best performance.
  */
 class CsvReader
 {
@@ -47,9 +52,12 @@ public:
 	 */
 	CsvReader(IDataSourceStream* source, char fieldSeparator = ',', const CStringArray& headings = nullptr,
 			  size_t maxLineLength = 2048)
-		: source(source), fieldSeparator(fieldSeparator), userHeadingsProvided(headings), maxLineLength(maxLineLength),
-		  headings(headings)
+		: source(source), fieldSeparator(fieldSeparator), userHeadingsProvided(headings),
+		  maxLineLength(std::min(maxLineLength, size_t(UINT16_MAX))), headings(headings)
 	{
+		if(userHeadingsProvided) {
+			indexHeadings();
+		}
 		reset();
 	}
 
@@ -82,9 +90,39 @@ public:
 	 * @param index Column index, starts at 0
 	 * @retval const char* nullptr if index is not valid
 	 */
-	const char* getValue(unsigned index)
+	const char* getValue(unsigned index) const
+	{
+		return (index < rowFields.count) ? row.c_str() + rowFields.offsets[index] : nullptr;
+	}
+
+	/**
+	 * @brief Get length of a value from the current row
+	 * @param index Column index, starts at 0
+	 * @retval unsigned 0 if index is not valid
+	 */
+	unsigned getValueLength(unsigned index) const
 	{
-		return row[index];
+		if(index >= rowFields.count) {
+			return 0;
+		}
+		unsigned start = rowFields.offsets[index];
+		if(index + 1 < rowFields.count) {
+			return rowFields.offsets[index + 1] - 1 - start;
+		}
+		// Row has a trailing NUL
+		unsigned end = row.length();
+		if(end > start && row.c_str()[end - 1] == '\0') {
+			--end;
+		}
+		return end - start;
+	}
+
+	/**
+	 * @brief Get number of fields in the current row
+	 */
+	unsigned getFieldCount() const
+	{
+		return rowFields.count;
 	}
 
 	/**
@@ -92,7 +130,7 @@ public:
 	 * @param index Column name
 	 * @retval const char* nullptr if name is not found
 	 */
-	const char* getValue(const char* name)
+	const char* getValue(const char* name) const
 	{
 		return getValue(getColumn(name));
 	}
@@ -102,10 +140,7 @@ public:
 	 * @param name Column name to find
 	 * @retval int -1 if name is not found
 	 */
-	int getColumn(const char* name)
-	{
-		return headings.indexOf(name);
-	}
+	int getColumn(const char* name) const;
 
 	/**
 	 * @brief Determine if row is valid
@@ -131,8 +166,64 @@ public:
 		return row;
 	}
 
+	/**
+	 * @name Random access to rows
+	 *
+	 * Offsets for each row may be stored in a separate index stream, such as a file alongside the CSV data.
+	 * Build the index once using `writeIndex()`, then use `seekRow()` to go straight to a specific row.
+	 * @{
+	 */
+
+	/**
+	 * @brief Get offset of the current row within the source stream
+	 * @retval int Negative if there is no current row
+	 */
+	int getRowOffset() const
+	{
+		return row ? rowOffset : -1;
+	}
+
+	/**
+	 * @brief Position reader so the next call to `next()` reads the row at the given offset
+	 * @param offset Value obtained from `getRowOffset()`
+	 */
+	bool seek(int offset)
+	{
+		row = nullptr;
+		rowFields.count = 0;
+		return source->seekFrom(offset, SeekOrigin::Start) == offset;
+	}
+
+	/**
+	 * @brief Scan all rows and write their offsets to an index stream
+	 * @param index Receives one `uint32_t` offset per row
+	 * @retval int Number of rows indexed, negative on error
+	 * @note Reader is reset afterwards
+	 */
+	int writeIndex(Print& index);
+
+	/**
+	 * @brief Read a specific row using an index created by `writeIndex()`
+	 * @param index Stream containing row offsets
+	 * @param rowIndex Row to read, starting at 0
+	 */
+	bool seekRow(IDataSourceStream& index, unsigned rowIndex);
+
+	/** @} */
+
 private:
+	// Offsets of each field within row text
+	struct FieldIndex {
+		std::unique_ptr<uint16_t[]> offsets;
+		uint16_t count{0};
+		uint16_t capacity{0};
+
+		bool add(uint16_t offset);
+		void build(const char* text, unsigned length);
+	};
+
 	bool readRow();
+	void indexHeadings();
 
 	std::unique_ptr<IDataSourceStream> source;
 	char fieldSeparator;
@@ -140,4 +231,8 @@ private:
 	size_t maxLineLength;
 	CStringArray headings;
 	CStringArray row;
+	FieldIndex headingFields;
+	FieldIndex rowFields;
+	std::unique_ptr<uint32_t[]> headingHashes;
+	int rowOffset{0};
 };
@@ -0,0 +1,124 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * FlashMapIndex.h - Hashed lookup for FlashString maps with String keys
+ *
+ ****/
+
+#pragma once
+
+#include <WString.h>
+#include <FlashString/Map.hpp>
+#include <algorithm>
+#include <memory>
+#include <cctype>
+
+/**
+ * @brief Index for a `FSTR::Map` keyed by strings
+ *
+ * `FSTR::Map::operator[]` compares the key against each entry in turn, reading each from flash.
+ * For large maps, such as the content of an embedded web UI, that becomes the dominant cost.
+ *
+ * This index hashes each key once, on first lookup, and keeps a table sorted by hash in RAM
+ * (4 bytes per entry). A lookup is then a hash, a binary search and normally a single flash compare.
+ *
+ * Keys are matched without case-sensitivity, as for `FSTR::Map`.
+ *
+ * Example:
+ *
+ * ```
+ * DEFINE_FSTR_MAP(fileMap, FlashString, FlashString, ...);
+ * FlashMapIndex<decltype(fileMap)> fileIndex(fileMap);
+ *
+ * auto file = fileIndex["index.html"];
+ * if(file) {
+ *    ...
+ * }
+ * ```
+ *
+ * @tparam MapType `FSTR::Map` with `FSTR::String` keys
+ */
+template <class MapType> class FlashMapIndex
+{
+public:
+	using Pair = decltype(std::declval<MapType>().valueAt(0));
+
+	FlashMapIndex(const MapType& map) : map(map)
+	{
+	}
+
+	/**
+	 * @brief Locate an entry
+	 * @param key
+	 * @param length
+	 * @retval Pair The map entry, invalid (false) if not found
+	 */
+	Pair find(const char* key, size_t length) const
+	{
+		if(!entries) {
+			build();
+		}
+		auto hashValue = hash(key, length);
+		auto end = &entries[count];
+		auto it = std::lower_bound(&entries[0], end, hashValue,
+								   [](const Entry& e, uint16_t value) { return e.hash < value; });
+		for(; it != end && it->hash == hashValue; ++it) {
+			auto pair = map.valueAt(it->index);
+			if(pair.key().equals(key, length, true)) {
+				return pair;
+			}
+		}
+		// Out of range index gives an invalid pair
+		return map.valueAt(map.length());
+	}
+
+	Pair operator[](const String& key) const
+	{
+		return find(key.c_str(), key.length());
+	}
+
+	Pair operator[](const char* key) const
+	{
+		return find(key, key ? strlen(key) : 0);
+	}
+
+	const MapType& getMap() const
+	{
+		return map;
+	}
+
+private:
+	struct Entry {
+		uint16_t hash;
+		uint16_t index;
+	};
+
+	// FNV-1a folded to 16 bits, ignoring case
+	static uint16_t hash(const char* key, size_t length)
+	{
+		uint32_t h{2166136261U};
+		for(size_t i = 0; i < length; ++i) {
+			h ^= uint8_t(tolower(key[i]));
+			h *= 16777619U;
+		}
+		return (h >> 16) ^ h;
+	}
+
+	void build() const
+	{
+		count = map.length();
+		entries.reset(new Entry[count]);
+		for(unsigned i = 0; i < count; ++i) {
+			String key(map.valueAt(i).key());
+			entries[i] = Entry{hash(key.c_str(), key.length()), uint16_t(i)};
+		}
+		std::sort(&entries[0], &entries[count], [](const Entry& a, const Entry& b) { return a.hash < b.hash; });
+	}
+
+	const MapType& map;
+	mutable std::unique_ptr<Entry[]> entries;
+	mutable unsigned count{0};
+};
@@ -0,0 +1,206 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * JsonWriter.cpp
+ *
+ ****/
+
+#include "JsonWriter.h"
+#include <stringconversion.h>
+#include <stringutil.h>
+#include <cmath>
+
+namespace Format
+{
+void JsonWriter::separate()
+{
+	if(afterKey) {
+		afterKey = false;
+		return;
+	}
+	if(depth == 0) {
+		return;
+	}
+	if(hasItems[depth]) {
+		out.write(',');
+	} else {
+		hasItems.set(depth);
+	}
+}
+
+JsonWriter& JsonWriter::begin(char c, bool isArray)
+{
+	if(depth >= maxDepth) {
+		error = true;
+		return *this;
+	}
+	separate();
+	out.write(c);
+	++depth;
+	arrays.set(depth, isArray);
+	hasItems.set(depth, false);
+	return *this;
+}
+
+JsonWriter& JsonWriter::end()
+{
+	if(depth == 0 || afterKey) {
+		error = true;
+		return *this;
+	}
+	out.write(arrays[depth] ? ']' : '}');
+	--depth;
+	return *this;
+}
+
+JsonWriter& JsonWriter::key(const char* name, size_t length)
+{
+	if(depth == 0 || arrays[depth] || afterKey) {
+		error = true;
+	}
+	separate();
+	out.write('"');
+	writeEscaped(name, length);
+	out.write("\":", 2);
+	afterKey = true;
+	return *this;
+}
+
+JsonWriter& JsonWriter::value(const char* str, size_t length)
+{
+	separate();
+	out.write('"');
+	writeEscaped(str, length);
+	out.write('"');
+	return *this;
+}
+
+JsonWriter& JsonWriter::value(const FlashString& str)
+{
+	separate();
+	out.write('"');
+	char buf[64];
+	for(size_t offset = 0; offset < str.length();) {
+		auto len = str.read(offset, buf, sizeof(buf));
+		if(len == 0) {
+			break;
+		}
+		writeEscaped(buf, len);
+		offset += len;
+	}
+	out.write('"');
+	return *this;
+}
+
+JsonWriter& JsonWriter::value(double num)
+{
+	if(!std::isfinite(num)) {
+		return value(nullptr);
+	}
+
+	separate();
+	char buf[DTOSTR_SHORTEST_BUFSIZE];
+	out.write(dtostr_shortest(num, buf));
+	return *this;
+}
+
+JsonWriter& JsonWriter::value(float num)
+{
+	if(!std::isfinite(num)) {
+		return value(nullptr);
+	}
+
+	separate();
+	char buf[DTOSTR_SHORTEST_BUFSIZE];
+	out.write(ftostr_shortest(num, buf));
+	return *this;
+}
+
+JsonWriter& JsonWriter::value(double num, uint8_t decimals)
+{
+	if(!std::isfinite(num)) {
+		return value(nullptr);
+	}
+
+	separate();
+	if(std::fabs(num) > 4294967040.0) {
+		// Beyond range of dtostrf
+		if(std::fabs(num) >= 9.2e18) {
+			out.write("null", 4);
+		} else {
+			out.print(int64_t(num));
+		}
+		return *this;
+	}
+
+	char buf[40];
+	dtostrf(num, 0, decimals, buf);
+	auto len = strlen(buf);
+	if(strchr(buf, '.') != nullptr) {
+		while(buf[len - 1] == '0') {
+			--len;
+		}
+		if(buf[len - 1] == '.') {
+			--len;
+		}
+	}
+	out.write(buf, len);
+	return *this;
+}
+
+void JsonWriter::writeEscaped(const char* str, size_t length)
+{
+	if(str == nullptr) {
+		return;
+	}
+
+	// Write runs of plain characters directly
+	auto run = str;
+	auto end = str + length;
+	for(auto p = str; p < end; ++p) {
+		uint8_t c = *p;
+		if(c >= 0x20 && c != '"' && c != '\\') {
+			continue;
+		}
+		out.write(run, p - run);
+		run = p + 1;
+
+		char esc[6]{'\\'};
+		size_t escLen{2};
+		switch(c) {
+		case '"':
+		case '\\':
+			esc[1] = c;
+			break;
+		case '\b':
+			esc[1] = 'b';
+			break;
+		case '\f':
+			esc[1] = 'f';
+			break;
+		case '\n':
+			esc[1] = 'n';
+			break;
+		case '\r':
+			esc[1] = 'r';
+			break;
+		case '\t':
+			esc[1] = 't';
+			break;
+		default:
+			esc[1] = 'u';
+			esc[2] = '0';
+			esc[3] = '0';
+			esc[4] = hexchar(c >> 4);
+			esc[5] = hexchar(c & 0x0f);
+			escLen = 6;
+		}
+		out.write(esc, escLen);
+	}
+	out.write(run, end - run);
+}
+
+} // namespace Format
@@ -0,0 +1,220 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * JsonWriter.h
+ *
+ ****/
+
+#pragma once
+
+#include <Print.h>
+#include <WString.h>
+#include "../BitSet.h"
+
+namespace Format
+{
+/**
+ * @brief Writes JSON text directly to a Print destination, escaping strings as they are written
+ *
+ * No document is built in memory, so output size is only limited by the destination.
+ * Separators are inserted automatically. For example:
+ *
+ * ```
+ * Format::JsonWriter json(Serial);
+ * json.beginObject();
+ * json.add("uptime", millis());
+ * json.beginArray("readings");
+ * for(auto& r : readings) {
+ *     json.value(r);
+ * }
+ * json.end();
+ * json.end();
+ * ```
+ *
+ * produces `{"uptime":1234,"readings":[1.5,2.25]}`.
+ *
+ * Misuse, such as closing too many containers or nesting too deeply, sets an error flag.
+ */
+class JsonWriter
+{
+public:
+	/**
+	 * @brief Maximum nesting depth for objects and arrays
+	 */
+	static constexpr unsigned maxDepth{31};
+
+	JsonWriter(Print& out) : out(out)
+	{
+	}
+
+	/**
+	 * @name Start an object or array
+	 * @param name Key for the new container, if within an object
+	 * @{
+	 */
+	JsonWriter& beginObject()
+	{
+		return begin('{', false);
+	}
+
+	JsonWriter& beginObject(const String& name)
+	{
+		return key(name).beginObject();
+	}
+
+	JsonWriter& beginArray()
+	{
+		return begin('[', true);
+	}
+
+	JsonWriter& beginArray(const String& name)
+	{
+		return key(name).beginArray();
+	}
+	/** @} */
+
+	/**
+	 * @brief Close the innermost object or array
+	 */
+	JsonWriter& end();
+
+	/**
+	 * @brief Close all open objects and arrays
+	 */
+	JsonWriter& endAll()
+	{
+		while(depth != 0 && !error) {
+			end();
+		}
+		return *this;
+	}
+
+	/**
+	 * @name Write the key for the next value within an object
+	 * @{
+	 */
+	JsonWriter& key(const char* name, size_t length);
+
+	JsonWriter& key(const char* name)
+	{
+		return key(name, name ? strlen(name) : 0);
+	}
+
+	JsonWriter& key(const String& name)
+	{
+		return key(name.c_str(), name.length());
+	}
+	/** @} */
+
+	/**
+	 * @name Write a value
+	 * @{
+	 */
+	JsonWriter& value(const char* str, size_t length);
+
+	JsonWriter& value(const char* str)
+	{
+		return str ? value(str, strlen(str)) : value(nullptr);
+	}
+
+	JsonWriter& value(const String& str)
+	{
+		return str ? value(str.c_str(), str.length()) : value(nullptr);
+	}
+
+	JsonWriter& value(const FlashString& str);
+
+	JsonWriter& value(std::nullptr_t)
+	{
+		return raw("null", 4);
+	}
+
+	JsonWriter& value(bool b)
+	{
+		return b ? raw("true", 4) : raw("false", 5);
+	}
+
+	template <typename T>
+	typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value, JsonWriter&>::type
+	value(T num)
+	{
+		separate();
+		out.print(num);
+		return *this;
+	}
+
+	/**
+	 * @brief Write a floating-point value using the fewest digits which read back as the same value
+	 * @param num
+	 * @note Non-finite values are written as `null`
+	 */
+	JsonWriter& value(double num);
+
+	/**
+	 * @brief Write a single-precision value
+	 *
+	 * Digits are produced to single precision, so 0.1f is written as `0.1`.
+	 */
+	JsonWriter& value(float num);
+
+	/**
+	 * @brief Write a floating-point value
+	 * @param num
+	 * @param decimals Maximum number of digits after decimal point, trailing zeroes are omitted
+	 * @note Non-finite values are written as `null`
+	 */
+	JsonWriter& value(double num, uint8_t decimals);
+	/** @} */
+
+	/**
+	 * @brief Write a key and value
+	 */
+	template <typename T> JsonWriter& add(const String& name, const T& val)
+	{
+		return key(name).value(val);
+	}
+
+	/**
+	 * @brief Write pre-formatted JSON as a value
+	 * @note Content is not checked
+	 */
+	JsonWriter& raw(const char* json, size_t length)
+	{
+		separate();
+		out.write(json, length);
+		return *this;
+	}
+
+	/**
+	 * @brief Get number of open objects and arrays
+	 */
+	unsigned getDepth() const
+	{
+		return depth;
+	}
+
+	/**
+	 * @brief Determine if the writer has been used incorrectly
+	 */
+	bool hasError() const
+	{
+		return error;
+	}
+
+private:
+	JsonWriter& begin(char c, bool isArray);
+	void separate();
+	void writeEscaped(const char* str, size_t length);
+
+	Print& out;
+	BitSet32 arrays;   ///< Set for levels which are arrays
+	BitSet32 hasItems; ///< Set for levels which need a separator before the next item
+	uint8_t depth{0};
+	bool afterKey{false};
+	bool error{false};
+};
+
+} // namespace Format
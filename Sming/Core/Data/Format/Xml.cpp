@@ -16,13 +16,62 @@ namespace Format
 {
 Xml xml;
 
+namespace
+{
+const char* getEntity(char c)
+{
+	switch(c) {
+	case '&':
+		return "&amp;";
+	case '<':
+		return "&lt;";
+	case '>':
+		return "&gt;";
+	case '\'':
+		return "&apos;";
+	case '"':
+		return "&quot;";
+	default:
+		return nullptr;
+	}
+}
+
+} // namespace
+
+/*
+ * Values are usually free of special characters so check first, then escape
+ * in-place working backwards so only one re-allocation is required.
+ */
 void Xml::escape(String& value) const
 {
-	value.replace("&", "&amp;");
-	value.replace("<", "&lt;");
-	value.replace(">", "&gt;");
-	value.replace("'", "&apos;");
-	value.replace("\"", "&quot;");
+	auto len = value.length();
+	size_t extra{0};
+	for(size_t i = 0; i < len; ++i) {
+		auto entity = getEntity(value[i]);
+		if(entity != nullptr) {
+			extra += strlen(entity) - 1;
+		}
+	}
+	if(extra == 0) {
+		return;
+	}
+
+	if(!value.setLength(len + extra)) {
+		return;
+	}
+	auto buf = value.begin();
+	auto out = buf + len + extra;
+	for(auto in = buf + len; in != buf;) {
+		char c = *--in;
+		auto entity = getEntity(c);
+		if(entity == nullptr) {
+			*--out = c;
+			continue;
+		}
+		auto entityLen = strlen(entity);
+		out -= entityLen;
+		memcpy(out, entity, entityLen);
+	}
 }
 
 } // namespace Format
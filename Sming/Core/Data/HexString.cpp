@@ -27,14 +27,24 @@ String makeHexString(const void* data, unsigned length, char separator)
 		return nullptr;
 	}
 
+	static constexpr char hexDigits[] = "0123456789abcdef";
 	auto inptr = static_cast<const uint8_t*>(data);
 	char* outptr = result.begin();
-	for(unsigned i = 0; i < length; ++i, ++inptr) {
-		if(i != 0 && separator != '\0') {
+	auto writeByte = [&outptr](uint8_t c) {
+		outptr[0] = hexDigits[c >> 4];
+		outptr[1] = hexDigits[c & 0x0F];
+		outptr += 2;
+	};
+	writeByte(*inptr++);
+	if(separator == '\0') {
+		for(unsigned i = 1; i < length; ++i) {
+			writeByte(*inptr++);
+		}
+	} else {
+		for(unsigned i = 1; i < length; ++i) {
 			*outptr++ = separator;
+			writeByte(*inptr++);
 		}
-		*outptr++ = hexchar(*inptr >> 4);
-		*outptr++ = hexchar(*inptr & 0x0F);
 	}
 
 	return result;
@@ -0,0 +1,291 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * IntrusiveList.h - Doubly-linked list of objects which carry their own links
+ *
+ ****/
+
+#pragma once
+
+#include <iterator>
+#include <cstddef>
+
+/**
+ * @brief Links for membership of an IntrusiveList
+ * @tparam Tag Identifies the list, so an object may inherit several hooks and be in several lists
+ *
+ * An object is removed from its list automatically when destroyed.
+ * Copies of an object are not linked.
+ */
+template <typename Tag = void> class IntrusiveListHook
+{
+public:
+	IntrusiveListHook() = default;
+
+	IntrusiveListHook(const IntrusiveListHook&)
+	{
+	}
+
+	IntrusiveListHook& operator=(const IntrusiveListHook&)
+	{
+		return *this;
+	}
+
+	~IntrusiveListHook()
+	{
+		unlink();
+	}
+
+	/**
+	 * @brief Determine if this object is currently in a list
+	 */
+	bool isLinked() const
+	{
+		return mNext != nullptr;
+	}
+
+	/**
+	 * @brief Remove from whichever list this object is in
+	 * @note Takes constant time, the list need not be known
+	 */
+	void unlink()
+	{
+		if(mNext != nullptr) {
+			mPrev->mNext = mNext;
+			mNext->mPrev = mPrev;
+			mNext = mPrev = nullptr;
+		}
+	}
+
+private:
+	template <typename, typename> friend class IntrusiveList;
+
+	// Used by list to initialise its sentinel
+	void makeEmpty()
+	{
+		mNext = mPrev = this;
+	}
+
+	void linkBefore(IntrusiveListHook* pos)
+	{
+		unlink();
+		mNext = pos;
+		mPrev = pos->mPrev;
+		mPrev->mNext = this;
+		pos->mPrev = this;
+	}
+
+	IntrusiveListHook* mPrev{nullptr};
+	IntrusiveListHook* mNext{nullptr};
+};
+
+/**
+ * @brief Doubly-linked list of objects deriving from IntrusiveListHook
+ * @tparam ObjectType
+ * @tparam Tag Must match that of the hook
+ *
+ * Nothing is allocated: adding and removing objects only updates their links, in constant time.
+ * The list does not own its objects.
+ *
+ * Iteration is safe against removal, or destruction, of the current object.
+ * For example:
+ *
+ * ```
+ * for(auto& conn : list) {
+ *    if(conn.isIdle()) {
+ *        delete &conn;
+ *    }
+ * }
+ * ```
+ */
+template <typename ObjectType, typename Tag = void> class IntrusiveList
+{
+public:
+	using Hook = IntrusiveListHook<Tag>;
+
+	template <typename T> class IteratorTemplate
+	{
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = T;
+		using difference_type = std::ptrdiff_t;
+		using pointer = T*;
+		using reference = T&;
+
+		IteratorTemplate(Hook* node) : mNode(node), mNext(node->mNext)
+		{
+		}
+
+		IteratorTemplate& operator++()
+		{
+			// Next pointer was read in advance, in case the current object has been removed
+			mNode = mNext;
+			mNext = mNode->mNext;
+			return *this;
+		}
+
+		IteratorTemplate operator++(int)
+		{
+			IteratorTemplate tmp(*this);
+			operator++();
+			return tmp;
+		}
+
+		bool operator==(const IteratorTemplate& rhs) const
+		{
+			return mNode == rhs.mNode;
+		}
+
+		bool operator!=(const IteratorTemplate& rhs) const
+		{
+			return mNode != rhs.mNode;
+		}
+
+		T& operator*() const
+		{
+			return *static_cast<T*>(mNode);
+		}
+
+		T* operator->() const
+		{
+			return static_cast<T*>(mNode);
+		}
+
+	private:
+		Hook* mNode;
+		Hook* mNext;
+	};
+
+	using Iterator = IteratorTemplate<ObjectType>;
+	using ConstIterator = IteratorTemplate<const ObjectType>;
+
+	IntrusiveList()
+	{
+		mHead.makeEmpty();
+	}
+
+	IntrusiveList(const IntrusiveList&) = delete;
+	IntrusiveList& operator=(const IntrusiveList&) = delete;
+
+	~IntrusiveList()
+	{
+		clear();
+	}
+
+	/**
+	 * @brief Append object to end of list, moving it from any list it is already in
+	 */
+	void add(ObjectType& object)
+	{
+		hook(object).linkBefore(&mHead);
+	}
+
+	/**
+	 * @brief Insert object at start of list
+	 */
+	void insert(ObjectType& object)
+	{
+		hook(object).linkBefore(mHead.mNext);
+	}
+
+	/**
+	 * @brief Remove an object, which must be in this list or in none
+	 */
+	void remove(ObjectType& object)
+	{
+		hook(object).unlink();
+	}
+
+	/**
+	 * @brief Remove and return the first object
+	 * @retval ObjectType* nullptr if list is empty
+	 */
+	ObjectType* pop()
+	{
+		if(isEmpty()) {
+			return nullptr;
+		}
+		auto obj = head();
+		remove(*obj);
+		return obj;
+	}
+
+	/**
+	 * @brief Unlink all objects
+	 */
+	void clear()
+	{
+		while(!isEmpty()) {
+			mHead.mNext->unlink();
+		}
+	}
+
+	bool isEmpty() const
+	{
+		return mHead.mNext == &mHead;
+	}
+
+	ObjectType* head() const
+	{
+		return isEmpty() ? nullptr : static_cast<ObjectType*>(mHead.mNext);
+	}
+
+	ObjectType* tail() const
+	{
+		return isEmpty() ? nullptr : static_cast<ObjectType*>(mHead.mPrev);
+	}
+
+	/**
+	 * @brief Number of objects in list
+	 * @note The list doesn't keep a count as objects can unlink themselves, so this walks the list
+	 */
+	size_t count() const
+	{
+		size_t n{0};
+		for(auto node = mHead.mNext; node != &mHead; node = node->mNext) {
+			++n;
+		}
+		return n;
+	}
+
+	bool contains(const ObjectType& object) const
+	{
+		for(auto& obj : *this) {
+			if(&obj == &object) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	Iterator begin()
+	{
+		return Iterator(mHead.mNext);
+	}
+
+	Iterator end()
+	{
+		return Iterator(&mHead);
+	}
+
+	ConstIterator begin() const
+	{
+		return ConstIterator(mHead.mNext);
+	}
+
+	ConstIterator end() const
+	{
+		return ConstIterator(const_cast<Hook*>(&mHead));
+	}
+
+private:
+	static Hook& hook(ObjectType& object)
+	{
+		return object;
+	}
+
+	Hook mHead; ///< Sentinel: next is the first object, prev the last
+};
@@ -0,0 +1,496 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * JsonReader.cpp
+ *
+ ****/
+
+#include "JsonReader.h"
+#include <stringutil.h>
+#include <debug_progmem.h>
+
+namespace
+{
+bool isWhitespace(char c)
+{
+	return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+bool isDigit(char c)
+{
+	return c >= '0' && c <= '9';
+}
+
+// -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+bool isNumber(const char* s)
+{
+	if(*s == '-') {
+		++s;
+	}
+	if(*s == '0') {
+		++s;
+	} else if(isDigit(*s)) {
+		while(isDigit(*s)) {
+			++s;
+		}
+	} else {
+		return false;
+	}
+	if(*s == '.') {
+		++s;
+		if(!isDigit(*s)) {
+			return false;
+		}
+		while(isDigit(*s)) {
+			++s;
+		}
+	}
+	if(*s == 'e' || *s == 'E') {
+		++s;
+		if(*s == '+' || *s == '-') {
+			++s;
+		}
+		if(!isDigit(*s)) {
+			return false;
+		}
+		while(isDigit(*s)) {
+			++s;
+		}
+	}
+	return *s == '\0';
+}
+
+} // namespace
+
+JsonReader::Match JsonReader::match(const char* path, const char* pattern)
+{
+	if(*path == '\0') {
+		return *pattern == '\0' ? Match::Exact : Match::Ancestor;
+	}
+
+	auto p = path;
+	auto q = pattern;
+	for(;;) {
+		if(*q == '\0') {
+			return (*p == '\0' || *p == '.' || *p == '[') ? Match::Exact : Match::None;
+		}
+		if(*p == '\0') {
+			return (*q == '.' || *q == '[') ? Match::Ancestor : Match::None;
+		}
+		if(*p == '[' && q[0] == '[' && q[1] == '*' && q[2] == ']') {
+			auto end = strchr(p, ']');
+			if(end == nullptr) {
+				return Match::None;
+			}
+			p = end + 1;
+			q += 3;
+			continue;
+		}
+		if(*p != *q) {
+			return Match::None;
+		}
+		++p;
+		++q;
+	}
+}
+
+void JsonReader::reset()
+{
+	path.setLength(0);
+	position = 0;
+	highSurrogate = 0;
+	bufferLength = 0;
+	keyOffset = -1;
+	depth = 0;
+	state = State::Value;
+	status = Status::Parsing;
+}
+
+bool JsonReader::parse(const char* data, size_t length)
+{
+	size_t i = 0;
+	while(i < length && status == Status::Parsing) {
+		bool consumed = processChar(data[i]);
+		if(status != Status::Parsing) {
+			break;
+		}
+		if(consumed) {
+			++i;
+			++position;
+		}
+	}
+	return status == Status::Parsing || status == Status::Done;
+}
+
+bool JsonReader::end()
+{
+	if(status == Status::Parsing && state == State::Literal && depth == 0) {
+		endLiteral();
+	}
+	if(status == Status::Parsing) {
+		if(state == State::Done) {
+			status = Status::Done;
+		} else {
+			setError();
+		}
+	}
+	return status == Status::Done;
+}
+
+void JsonReader::setError()
+{
+	debug_w("[JSON] Parse error at offset %u", position);
+	status = Status::Error;
+}
+
+bool JsonReader::processChar(char c)
+{
+	switch(state) {
+	case State::String:
+		if(c == '"') {
+			endString();
+		} else if(c == '\\') {
+			state = State::Escape;
+		} else if(uint8_t(c) < 0x20) {
+			setError();
+		} else {
+			appendChar(c);
+		}
+		return true;
+
+	case State::Escape:
+		state = State::String;
+		switch(c) {
+		case '"':
+		case '\\':
+		case '/':
+			appendChar(c);
+			break;
+		case 'b':
+			appendChar('\b');
+			break;
+		case 'f':
+			appendChar('\f');
+			break;
+		case 'n':
+			appendChar('\n');
+			break;
+		case 'r':
+			appendChar('\r');
+			break;
+		case 't':
+			appendChar('\t');
+			break;
+		case 'u':
+			state = State::Unicode;
+			codepoint = 0;
+			hexCount = 0;
+			break;
+		default:
+			setError();
+		}
+		return true;
+
+	case State::Unicode: {
+		auto n = unhex(c);
+		if(n < 0) {
+			setError();
+			return true;
+		}
+		codepoint = (codepoint << 4) | n;
+		if(++hexCount == 4) {
+			appendCodepoint(codepoint);
+			state = State::String;
+		}
+		return true;
+	}
+
+	case State::Literal:
+		if(isalnum(c) || c == '+' || c == '-' || c == '.') {
+			appendChar(c);
+			return true;
+		}
+		// Re-process terminating character
+		endLiteral();
+		return false;
+
+	default:
+		break;
+	}
+
+	if(isWhitespace(c)) {
+		return true;
+	}
+
+	switch(state) {
+	case State::FirstValueOrEnd:
+		if(c == ']') {
+			endContainer(true);
+			return true;
+		}
+		// fall-through
+
+	case State::Value:
+		beginValue();
+		if(c == '{' || c == '[') {
+			beginContainer(c == '[');
+			return true;
+		}
+		buffering = valueSelected;
+		bufferLength = 0;
+		truncated = false;
+		if(c == '"') {
+			isKey = false;
+			highSurrogate = 0;
+			state = State::String;
+		} else if(c == '-' || isDigit(c) || c == 't' || c == 'f' || c == 'n') {
+			appendChar(c);
+			state = State::Literal;
+		} else {
+			setError();
+		}
+		return true;
+
+	case State::FirstKeyOrEnd:
+		if(c == '}') {
+			endContainer(false);
+			return true;
+		}
+		// fall-through
+
+	case State::Key:
+		if(c != '"') {
+			setError();
+			return true;
+		}
+		isKey = true;
+		buffering = !levels[depth - 1].skip;
+		bufferLength = 0;
+		truncated = false;
+		highSurrogate = 0;
+		state = State::String;
+		return true;
+
+	case State::Colon:
+		if(c == ':') {
+			state = State::Value;
+		} else {
+			setError();
+		}
+		return true;
+
+	case State::CommaOrEnd:
+		if(c == ',') {
+			state = levels[depth - 1].isArray ? State::Value : State::Key;
+		} else if(c == ']' || c == '}') {
+			endContainer(c == ']');
+		} else {
+			setError();
+		}
+		return true;
+
+	default:
+		// Only whitespace permitted after root element
+		setError();
+		return true;
+	}
+}
+
+void JsonReader::beginValue()
+{
+	valueSelected = false;
+	valueSkip = false;
+
+	if(depth == 0) {
+		path.setLength(0);
+		keyOffset = -1;
+		valueSelected = (filter.count() == 0);
+		return;
+	}
+
+	auto& level = levels[depth - 1];
+	if(level.skip) {
+		valueSkip = true;
+		return;
+	}
+
+	if(level.isArray) {
+		path.setLength(level.pathLength);
+		path += '[';
+		path += level.count;
+		path += ']';
+		keyOffset = -1;
+	}
+
+	if(level.selected) {
+		valueSelected = true;
+		return;
+	}
+
+	auto m = Match::None;
+	for(auto pattern : filter) {
+		auto n = match(path.c_str(), pattern);
+		if(n > m) {
+			m = n;
+			if(m == Match::Exact) {
+				break;
+			}
+		}
+	}
+	valueSelected = (m == Match::Exact);
+	valueSkip = (m == Match::None);
+}
+
+void JsonReader::beginContainer(bool isArray)
+{
+	if(depth >= JSON_READER_MAX_DEPTH) {
+		setError();
+		return;
+	}
+
+	if(valueSelected) {
+		bufferLength = 0;
+		emit(isArray ? Type::Array : Type::Object, false);
+		if(status != Status::Parsing) {
+			return;
+		}
+	}
+
+	levels[depth++] = Level{uint16_t(path.length()), keyOffset, 0, isArray, valueSelected, valueSkip};
+	state = isArray ? State::FirstValueOrEnd : State::FirstKeyOrEnd;
+}
+
+void JsonReader::endContainer(bool isArray)
+{
+	auto& level = levels[depth - 1];
+	if(level.isArray != isArray) {
+		setError();
+		return;
+	}
+
+	--depth;
+	if(level.selected) {
+		path.setLength(level.pathLength);
+		keyOffset = level.keyOffset;
+		bufferLength = 0;
+		emit(isArray ? Type::ArrayEnd : Type::ObjectEnd, false);
+	}
+	endValue();
+}
+
+void JsonReader::endValue()
+{
+	if(status != Status::Parsing) {
+		return;
+	}
+	if(depth == 0) {
+		state = State::Done;
+		return;
+	}
+	++levels[depth - 1].count;
+	state = State::CommaOrEnd;
+}
+
+void JsonReader::endString()
+{
+	if(!isKey) {
+		if(valueSelected) {
+			emit(Type::String, true);
+		}
+		endValue();
+		return;
+	}
+
+	auto& level = levels[depth - 1];
+	if(!level.skip) {
+		path.setLength(level.pathLength);
+		if(level.pathLength != 0) {
+			path += '.';
+		}
+		keyOffset = path.length();
+		path.concat(buffer.get(), bufferLength);
+	}
+	state = State::Colon;
+}
+
+void JsonReader::endLiteral()
+{
+	if(valueSelected) {
+		buffer[bufferLength] = '\0';
+		auto s = buffer.get();
+		Type type;
+		if(strcmp(s, "true") == 0 || strcmp(s, "false") == 0) {
+			type = Type::Boolean;
+		} else if(strcmp(s, "null") == 0) {
+			type = Type::Null;
+		} else if(!truncated && isNumber(s)) {
+			type = Type::Number;
+		} else {
+			setError();
+			return;
+		}
+		emit(type, true);
+	}
+	endValue();
+}
+
+void JsonReader::appendChar(char c)
+{
+	if(!buffering) {
+		return;
+	}
+	if(bufferLength < maxValueLength) {
+		buffer[bufferLength++] = c;
+	} else {
+		truncated = true;
+	}
+}
+
+void JsonReader::appendCodepoint(uint32_t cp)
+{
+	if(cp >= 0xD800 && cp < 0xDC00) {
+		highSurrogate = cp;
+		return;
+	}
+	if(cp >= 0xDC00 && cp < 0xE000) {
+		cp = highSurrogate ? 0x10000 + ((highSurrogate - 0xD800) << 10) + (cp - 0xDC00) : 0xFFFD;
+	}
+	highSurrogate = 0;
+
+	if(cp < 0x80) {
+		appendChar(cp);
+	} else if(cp < 0x800) {
+		appendChar(0xC0 | (cp >> 6));
+		appendChar(0x80 | (cp & 0x3F));
+	} else if(cp < 0x10000) {
+		appendChar(0xE0 | (cp >> 12));
+		appendChar(0x80 | ((cp >> 6) & 0x3F));
+		appendChar(0x80 | (cp & 0x3F));
+	} else {
+		appendChar(0xF0 | (cp >> 18));
+		appendChar(0x80 | ((cp >> 12) & 0x3F));
+		appendChar(0x80 | ((cp >> 6) & 0x3F));
+		appendChar(0x80 | (cp & 0x3F));
+	}
+}
+
+void JsonReader::emit(Type type, bool hasValue)
+{
+	buffer[bufferLength] = '\0';
+	Element element{
+		type,
+		depth,
+		hasValue && truncated,
+		depth ? levels[depth - 1].count : 0U,
+		(keyOffset >= 0) ? path.c_str() + keyOffset : nullptr,
+		path.c_str(),
+		buffer.get(),
+		bufferLength,
+	};
+	if(callback && !callback(element)) {
+		status = Status::Aborted;
+	}
+}
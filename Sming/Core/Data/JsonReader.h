@@ -0,0 +1,247 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * JsonReader.h
+ *
+ ****/
+
+#pragma once
+
+#include "CStringArray.h"
+#include <Delegate.h>
+#include <memory>
+
+/**
+ * @brief Maximum nesting depth of objects and arrays accepted by JsonReader
+ */
+#ifndef JSON_READER_MAX_DEPTH
+#define JSON_READER_MAX_DEPTH 16
+#endif
+
+/**
+ * @brief Default size of the JsonReader value buffer
+ */
+#ifndef JSON_READER_MAX_VALUE_LENGTH
+#define JSON_READER_MAX_VALUE_LENGTH 256
+#endif
+
+/**
+ * @brief Incremental JSON tokenizer
+ *
+ * Input is passed to `parse()` in chunks of any size, as it arrives from a network connection or file.
+ * A callback is invoked for each element as it is completed. Only the current key and value are held
+ * in memory, so documents much larger than available heap may be processed.
+ *
+ * Each element has a path built from its keys and array indices, such as `network.hosts[2].name`.
+ * Set a filter to select elements of interest; anything else is scanned but not buffered or reported.
+ * A filter path selects the matching element and everything within it. `[*]` matches any array index.
+ *
+ * ```
+ * JsonReader reader([](const JsonReader::Element& element) -> bool {
+ *     if(element.match("wifi.ssid")) {
+ *         ssid = element.toString();
+ *     } else if(element.type == JsonReader::Type::Number) {
+ *         config.setValue(element.path, element.toInt());
+ *     }
+ *     return true;
+ * });
+ * reader.setFilter(F("wifi.ssid\0" "channels[*].level"));
+ * ```
+ *
+ * Values longer than the buffer are truncated and the `truncated` flag is set.
+ */
+class JsonReader
+{
+public:
+	enum class Type : uint8_t {
+		Object,	///< Start of object
+		Array,	 ///< Start of array
+		ObjectEnd, ///< End of object
+		ArrayEnd,  ///< End of array
+		String,
+		Number,
+		Boolean,
+		Null,
+	};
+
+	enum class Status : uint8_t {
+		Parsing, ///< Waiting for more input
+		Done,	///< Document complete, see `end()`
+		Error,   ///< Malformed input
+		Aborted, ///< Callback returned false
+	};
+
+	/**
+	 * @brief Information passed to callback
+	 * @note Content is only valid for the duration of the callback
+	 */
+	struct Element {
+		Type type;
+		uint8_t level;	///< Nesting depth, 0 for the root element
+		bool truncated;   ///< Value was too long for the buffer
+		unsigned index;   ///< Position within containing object or array
+		const char* key;  ///< Key within containing object, nullptr for array elements
+		const char* path; ///< Full path to element
+		const char* value;
+		uint16_t valueLength;
+
+		bool isContainer() const
+		{
+			return type <= Type::ArrayEnd;
+		}
+
+		/**
+		 * @brief Compare element path against a pattern, which may contain `[*]` wildcards
+		 */
+		bool match(const char* pattern) const
+		{
+			return JsonReader::match(path, pattern) == Match::Exact;
+		}
+
+		String toString() const
+		{
+			return String(value, valueLength);
+		}
+
+		int toInt() const
+		{
+			return strtol(value, nullptr, 0);
+		}
+
+		double toFloat() const
+		{
+			return strtod(value, nullptr);
+		}
+
+		bool toBool() const
+		{
+			return type == Type::Boolean && value[0] == 't';
+		}
+	};
+
+	/**
+	 * @brief Callback invoked for each selected element
+	 * @retval bool Return false to stop parsing
+	 */
+	using Callback = Delegate<bool(const Element& element)>;
+
+	/**
+	 * @brief Constructor
+	 * @param callback
+	 * @param maxValueLength Size of buffer for keys and values
+	 */
+	JsonReader(Callback callback, uint16_t maxValueLength = JSON_READER_MAX_VALUE_LENGTH)
+		: callback(callback), buffer(new char[maxValueLength + 1]), maxValueLength(maxValueLength)
+	{
+	}
+
+	/**
+	 * @brief Set paths of elements to report
+	 * @param paths List of paths, empty to report everything
+	 */
+	void setFilter(const CStringArray& paths)
+	{
+		filter = paths;
+	}
+
+	/**
+	 * @brief Process a block of input
+	 * @retval bool false on error or if callback aborted
+	 */
+	bool parse(const char* data, size_t length);
+
+	/**
+	 * @brief Signal end of input
+	 * @retval bool true if a complete document was parsed
+	 */
+	bool end();
+
+	/**
+	 * @brief Prepare to start a new document
+	 * @note Filter is retained
+	 */
+	void reset();
+
+	Status getStatus() const
+	{
+		return status;
+	}
+
+	/**
+	 * @brief Get number of characters processed
+	 *
+	 * On error, this is the offset of the offending character.
+	 */
+	size_t getPosition() const
+	{
+		return position;
+	}
+
+private:
+	enum class State : uint8_t {
+		Value,
+		FirstValueOrEnd,
+		FirstKeyOrEnd,
+		Key,
+		Colon,
+		CommaOrEnd,
+		String,
+		Escape,
+		Unicode,
+		Literal,
+		Done,
+	};
+
+	enum class Match {
+		None,	 ///< Path and its children cannot match
+		Ancestor, ///< Children of path may match
+		Exact,	///< Path or its parents match
+	};
+
+	struct Level {
+		uint16_t pathLength;
+		int16_t keyOffset;
+		uint16_t count;
+		bool isArray;
+		bool selected;
+		bool skip;
+	};
+
+	static Match match(const char* path, const char* pattern);
+
+	bool processChar(char c);
+	void beginValue();
+	void beginContainer(bool isArray);
+	void endContainer(bool isArray);
+	void endValue();
+	void endString();
+	void endLiteral();
+	void appendChar(char c);
+	void appendCodepoint(uint32_t cp);
+	void emit(Type type, bool hasValue);
+	void setError();
+
+	Callback callback;
+	CStringArray filter;
+	std::unique_ptr<char[]> buffer;
+	String path;
+	Level levels[JSON_READER_MAX_DEPTH];
+	size_t position{0};
+	uint32_t codepoint{0};
+	uint16_t highSurrogate{0};
+	uint16_t maxValueLength;
+	uint16_t bufferLength{0};
+	int16_t keyOffset{-1};
+	uint8_t depth{0};
+	uint8_t hexCount{0};
+	State state{State::Value};
+	Status status{Status::Parsing};
+	bool isKey{false};
+	bool buffering{false};
+	bool truncated{false};
+	bool valueSelected{false};
+	bool valueSkip{false};
+};
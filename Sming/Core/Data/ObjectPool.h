@@ -0,0 +1,244 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * ObjectPool.h - Fixed-block allocator for objects of a single type
+ *
+ ****/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <algorithm>
+
+/**
+ * @brief Manages a set of equal-sized memory blocks using a free list
+ *
+ * When all blocks are in use, allocations fall back to the heap so callers need not handle exhaustion.
+ * Blocks are not locked, so a pool must only be used from task context.
+ */
+class ObjectPoolBase
+{
+public:
+	/**
+	 * @brief Constructor
+	 * @param storage Memory for blocks
+	 * @param blockSize Size of each block, a multiple of pointer alignment
+	 * @param blockCount Number of blocks in storage
+	 */
+	ObjectPoolBase(void* storage, size_t blockSize, uint16_t blockCount)
+		: storage(static_cast<uint8_t*>(storage)), blockSize(blockSize), capacity(blockCount)
+	{
+		for(unsigned i = blockCount; i > 0; --i) {
+			auto block = reinterpret_cast<FreeBlock*>(this->storage + (i - 1) * blockSize);
+			block->next = freeList;
+			freeList = block;
+		}
+	}
+
+	ObjectPoolBase(const ObjectPoolBase&) = delete;
+	ObjectPoolBase& operator=(const ObjectPoolBase&) = delete;
+
+	/**
+	 * @brief Obtain a block
+	 * @retval void* nullptr if pool is exhausted and heap allocation fails
+	 */
+	void* allocate()
+	{
+		if(freeList == nullptr) {
+			++heapCount;
+			return malloc(blockSize);
+		}
+		auto block = freeList;
+		freeList = block->next;
+		++usedCount;
+		if(usedCount > peakCount) {
+			peakCount = usedCount;
+		}
+		return block;
+	}
+
+	/**
+	 * @brief Return a block obtained from `allocate()`
+	 */
+	void release(void* ptr)
+	{
+		if(ptr == nullptr) {
+			return;
+		}
+		if(!owns(ptr)) {
+			--heapCount;
+			free(ptr);
+			return;
+		}
+		auto block = static_cast<FreeBlock*>(ptr);
+		block->next = freeList;
+		freeList = block;
+		--usedCount;
+	}
+
+	/**
+	 * @brief Determine if a block belongs to this pool's storage
+	 */
+	bool owns(const void* ptr) const
+	{
+		auto p = static_cast<const uint8_t*>(ptr);
+		return p >= storage && p < storage + capacity * blockSize;
+	}
+
+	uint16_t getCapacity() const
+	{
+		return capacity;
+	}
+
+	/**
+	 * @brief Get number of pool blocks in use
+	 */
+	uint16_t getUsedCount() const
+	{
+		return usedCount;
+	}
+
+	/**
+	 * @brief Get highest number of pool blocks in use at any one time
+	 */
+	uint16_t getPeakCount() const
+	{
+		return peakCount;
+	}
+
+	/**
+	 * @brief Get number of blocks currently allocated from heap because pool was exhausted
+	 */
+	uint16_t getHeapCount() const
+	{
+		return heapCount;
+	}
+
+private:
+	struct FreeBlock {
+		FreeBlock* next;
+	};
+
+	uint8_t* storage;
+	FreeBlock* freeList{nullptr};
+	size_t blockSize;
+	uint16_t capacity;
+	uint16_t usedCount{0};
+	uint16_t peakCount{0};
+	uint16_t heapCount{0};
+};
+
+/**
+ * @brief Alignment of blocks used to pool objects of a given type
+ */
+template <typename T> constexpr size_t objectPoolBlockAlign()
+{
+	return std::max(alignof(T), alignof(void*));
+}
+
+/**
+ * @brief Block size required to pool objects of a given type
+ */
+template <typename T> constexpr size_t objectPoolBlockSize()
+{
+	return (std::max(sizeof(T), sizeof(void*)) + objectPoolBlockAlign<T>() - 1) & ~(objectPoolBlockAlign<T>() - 1);
+}
+
+/**
+ * @brief Pool with embedded storage for a fixed number of objects
+ * @tparam T Object type
+ * @tparam count Number of objects in pool
+ *
+ * Declare as a global or static to use static backing storage:
+ *
+ * ```
+ * ObjectPool<Sample, 32> samplePool;
+ *
+ * auto sample = samplePool.create(args...);
+ * ...
+ * samplePool.destroy(sample);
+ * ```
+ *
+ * Alternatively, classes may use `PoolAllocated` so that `new` and `delete` use a pool.
+ */
+template <typename T, uint16_t count> class ObjectPool : public ObjectPoolBase
+{
+public:
+	ObjectPool() : ObjectPoolBase(storage, blockSize, count)
+	{
+	}
+
+	/**
+	 * @brief Allocate and construct an object
+	 */
+	template <typename... Args> T* create(Args&&... args)
+	{
+		auto mem = allocate();
+		return mem ? new(mem) T(std::forward<Args>(args)...) : nullptr;
+	}
+
+	/**
+	 * @brief Destroy an object and return its memory to the pool
+	 */
+	void destroy(T* object)
+	{
+		if(object != nullptr) {
+			object->~T();
+			release(object);
+		}
+	}
+
+private:
+	static constexpr size_t blockSize{objectPoolBlockSize<T>()};
+	alignas(objectPoolBlockAlign<T>()) uint8_t storage[count * blockSize];
+};
+
+/**
+ * @brief Base class which makes `new` and `delete` use a pool shared by all instances
+ * @tparam T The class being pooled
+ * @tparam count Number of objects in pool. If 0, the regular heap is used.
+ *
+ * ```
+ * class Sample : public PoolAllocated<Sample, 32>
+ * {
+ *     ...
+ * };
+ * ```
+ *
+ * The pool is created on first use. Derived classes which are larger than `T` are allocated from the heap.
+ */
+template <typename T, uint16_t count> class PoolAllocated
+{
+public:
+	using Pool = ObjectPoolBase;
+
+	static void* operator new(size_t size)
+	{
+		return (size > objectPoolBlockSize<T>()) ? ::operator new(size) : getPool().allocate();
+	}
+
+	static void operator delete(void* ptr, size_t size)
+	{
+		if(size > objectPoolBlockSize<T>()) {
+			::operator delete(ptr);
+		} else {
+			getPool().release(ptr);
+		}
+	}
+
+	static Pool& getPool()
+	{
+		static ObjectPool<T, count> pool;
+		return pool;
+	}
+};
+
+template <typename T> class PoolAllocated<T, 0>
+{
+};
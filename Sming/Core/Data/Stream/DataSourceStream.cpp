@@ -39,6 +39,31 @@ size_t IDataSourceStream::readBytes(char* buffer, size_t length)
 	return count;
 }
 
+size_t IDataSourceStream::copyTo(Print& dest, size_t size)
+{
+	size_t total{0};
+	char buffer[256];
+	while(total < size && !isFinished()) {
+		const char* data;
+		size_t len = peekRegion(data);
+		if(len == 0) {
+			len = readMemoryBlock(buffer, std::min(sizeof(buffer), size - total));
+			data = buffer;
+		}
+		len = std::min(len, size - total);
+		if(len == 0) {
+			break;
+		}
+		auto written = dest.write(reinterpret_cast<const uint8_t*>(data), len);
+		seek(written);
+		total += written;
+		if(written != len) {
+			break;
+		}
+	}
+	return total;
+}
+
 String IDataSourceStream::readString(size_t maxLen)
 {
 	String s;
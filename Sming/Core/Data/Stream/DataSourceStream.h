@@ -75,6 +75,30 @@ public:
      */
 	virtual uint16_t readMemoryBlock(char* data, int bufSize) = 0;
 
+	/**
+	 * @brief Get direct access to stream content at the current read position
+	 * @param data On success, set to start of contiguous block of data
+	 * @retval size_t Number of bytes available at `data`, 0 if not supported
+	 * @note Stream position is not updated by this call: use `seek()` to consume data.
+	 * The returned memory is only guaranteed valid until the stream is next modified or destroyed.
+	 *
+	 * Memory-based streams implement this so callers such as TcpConnection can avoid
+	 * copying data into an intermediate buffer.
+	 */
+	virtual size_t peekRegion(const char*& data)
+	{
+		(void)data;
+		return 0;
+	}
+
+	/**
+	 * @brief Copy data to another output
+	 *
+	 * Uses `peekRegion()` where supported to avoid an intermediate copy.
+	 * The read position only advances by the amount `dest` accepts.
+	 */
+	size_t copyTo(Print& dest, size_t size = SIZE_MAX) override;
+
 	/**
 	 * @brief Read one character and moves the stream pointer
 	 * @retval The character that was read or -1 if none is available
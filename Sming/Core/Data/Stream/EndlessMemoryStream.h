@@ -35,6 +35,11 @@ public:
 		return stream ? stream->readMemoryBlock(data, bufSize) : 0;
 	}
 
+	size_t peekRegion(const char*& data) override
+	{
+		return stream ? stream->peekRegion(data) : 0;
+	}
+
 	bool seek(int len) override;
 
 	/** @brief  Write chars to stream
@@ -12,6 +12,11 @@
 
 namespace IFS
 {
+namespace
+{
+constexpr size_t bufferSize{FILE_STREAM_BUFFER_SIZE};
+}
+
 void FileStream::attach(FileHandle file, size_t size)
 {
 	close();
@@ -25,6 +30,7 @@ void FileStream::attach(FileHandle file, size_t size)
 	this->size = size;
 	fs->lseek(handle, 0, SeekOrigin::Start);
 	pos = 0;
+	filePos = 0;
 
 	debug_d("attached file: '%s' (%u bytes) #0x%08X", fileName().c_str(), size, this);
 }
@@ -57,14 +63,109 @@ void FileStream::close()
 	if(handle >= 0) {
 		auto fs = getFileSystem();
 		assert(fs != nullptr);
+		(void)flushBuffer();
 		fs->close(handle);
 		handle = -1;
 	}
+	buffer.reset();
+	bufferLength = 0;
+	bufferDirty = false;
 	size = 0;
 	pos = 0;
+	filePos = 0;
 	lastError = FS_OK;
 }
 
+bool FileStream::seekFile(size_t offset)
+{
+	if(offset == filePos) {
+		return true;
+	}
+
+	GET_FS(false)
+
+	int res = fs->lseek(handle, offset, SeekOrigin::Start);
+	if(!check(res)) {
+		return false;
+	}
+	filePos = size_t(res);
+	return filePos == offset;
+}
+
+bool FileStream::flushBuffer()
+{
+	if(!bufferDirty) {
+		return true;
+	}
+	bufferDirty = false;
+
+	GET_FS(false)
+
+	int written{0};
+	if(seekFile(bufferPos)) {
+		written = fs->write(handle, buffer.get(), bufferLength);
+		if(check(written)) {
+			filePos += size_t(written);
+		}
+	}
+	if(written == bufferLength) {
+		return true;
+	}
+
+	// Content beyond this point has been lost
+	bufferLength = std::max(written, 0);
+	size = bufferPos + bufferLength;
+	if(pos > size) {
+		pos = size;
+	}
+	return false;
+}
+
+bool FileStream::fillBuffer()
+{
+	if(!flushBuffer()) {
+		return false;
+	}
+
+	GET_FS(false)
+
+	if(!buffer) {
+		buffer.reset(new char[bufferSize]);
+		if(!buffer) {
+			return false;
+		}
+	}
+
+	size_t blockPos = pos - (pos % bufferSize);
+	bufferLength = 0;
+	if(!seekFile(blockPos)) {
+		return false;
+	}
+	int count = fs->read(handle, buffer.get(), std::min(bufferSize, size - blockPos));
+	if(!check(count)) {
+		return false;
+	}
+	filePos += size_t(count);
+	bufferPos = blockPos;
+	bufferLength = count;
+	return isBuffered(pos);
+}
+
+size_t FileStream::peekRegion(const char*& data)
+{
+	if(bufferSize == 0 || handle < 0 || pos >= size) {
+		return 0;
+	}
+
+	if(!isBuffered(pos) && !fillBuffer()) {
+		return 0;
+	}
+
+	auto offset = pos - bufferPos;
+	data = &buffer[offset];
+	return bufferLength - offset;
+}
+
 size_t FileStream::readBytes(char* buffer, size_t length)
 {
 	if(buffer == nullptr || length == 0 || pos >= size) {
@@ -73,67 +174,191 @@ size_t FileStream::readBytes(char* buffer, size_t length)
 
 	GET_FS(0)
 
-	int available = fs->read(handle, buffer, std::min(size - pos, length));
-	if(!check(available)) {
-		return 0;
-	}
+	length = std::min(size - pos, length);
+	size_t count{0};
+	while(length != 0) {
+		// Serve from buffer unless reading whole blocks
+		if(bufferSize != 0 && (isBuffered(pos) || pos % bufferSize != 0 || length < bufferSize)) {
+			const char* data;
+			size_t len = peekRegion(data);
+			if(len == 0) {
+				break;
+			}
+			len = std::min(len, length);
+			memcpy(buffer, data, len);
+			buffer += len;
+			pos += len;
+			count += len;
+			length -= len;
+			continue;
+		}
 
-	pos += size_t(available);
+		size_t len = (bufferSize == 0) ? length : length - (length % bufferSize);
+		if(!flushBuffer() || !seekFile(pos)) {
+			break;
+		}
+		int available = fs->read(handle, buffer, len);
+		if(!check(available)) {
+			break;
+		}
+		filePos += size_t(available);
+		pos += size_t(available);
+		count += size_t(available);
+		if(size_t(available) < len) {
+			break;
+		}
+		buffer += len;
+		length -= len;
+	}
 
-	return available;
+	return count;
 }
 
 uint16_t FileStream::readMemoryBlock(char* data, int bufSize)
 {
-	GET_FS(0)
-
 	assert(bufSize >= 0);
-	size_t startPos = pos;
-	size_t count = readBytes(data, bufSize);
 
-	// Move cursor back to start position
-	(void)fs->lseek(handle, startPos, SeekOrigin::Start);
+	const char* ptr;
+	size_t count = peekRegion(ptr);
+	if(count != 0) {
+		count = std::min(count, size_t(bufSize));
+		memcpy(data, ptr, count);
+		return count;
+	}
+
+	size_t startPos = pos;
+	count = readBytes(data, bufSize);
 	pos = startPos;
 
 	return count;
 }
 
+size_t FileStream::writeDirect(const uint8_t* data, size_t length)
+{
+	GET_FS(0)
+
+	if(!seekFile(pos)) {
+		return 0;
+	}
+
+	int written = fs->write(handle, data, length);
+	if(!check(written)) {
+		return 0;
+	}
+
+	filePos += size_t(written);
+	pos += size_t(written);
+	this->size = pos;
+	return written;
+}
+
 size_t FileStream::write(const uint8_t* buffer, size_t size)
 {
 	GET_FS(0)
 
-	if(pos != this->size) {
-		int writePos = fs->lseek(handle, 0, SeekOrigin::End);
-		if(!check(writePos)) {
-			return 0;
-		}
+	// Writes always append
+	pos = this->size;
+
+	if(bufferSize == 0) {
+		return writeDirect(buffer, size);
+	}
 
-		pos = size_t(writePos);
+	// Discard any read-ahead data
+	if(!bufferDirty) {
+		bufferLength = 0;
 	}
 
-	int written = fs->write(handle, buffer, size);
-	if(check(written)) {
-		pos += size_t(written);
+	size_t startPos = pos;
+	size_t count{0};
+	while(size != 0) {
+		if(!bufferDirty) {
+			// Write whole blocks directly
+			if(pos % bufferSize == 0 && size >= bufferSize) {
+				size_t len = size - (size % bufferSize);
+				size_t written = writeDirect(buffer, len);
+				count += written;
+				if(written < len) {
+					break;
+				}
+				buffer += len;
+				size -= len;
+				continue;
+			}
+
+			if(!this->buffer) {
+				this->buffer.reset(new char[bufferSize]);
+				if(!this->buffer) {
+					count += writeDirect(buffer, size);
+					break;
+				}
+			}
+			bufferPos = pos;
+			bufferLength = 0;
+			bufferDirty = true;
+		}
+
+		// Buffer content ends on a block boundary
+		size_t space = bufferSize - (bufferPos % bufferSize) - bufferLength;
+		size_t len = std::min(space, size);
+		memcpy(&this->buffer[bufferLength], buffer, len);
+		bufferLength += len;
+		buffer += len;
+		size -= len;
+		pos += len;
 		this->size = pos;
+		count += len;
+
+		if(len == space && !flushBuffer()) {
+			// Report only what reached the file
+			count = (this->size > startPos) ? this->size - startPos : 0;
+			break;
+		}
 	}
 
-	return written > 0 ? written : 0;
+	return count;
 }
 
 int FileStream::seekFrom(int offset, SeekOrigin origin)
 {
+	size_t newPos;
+	switch(origin) {
+	case SeekOrigin::Start:
+		newPos = offset;
+		break;
+	case SeekOrigin::Current:
+		newPos = pos + offset;
+		break;
+	case SeekOrigin::End:
+		newPos = size + offset;
+		break;
+	default:
+		return lastError = Error::BadParam;
+	}
+
+	// Moving within existing content requires no filesystem access
+	if(handle >= 0 && newPos <= size) {
+		pos = newPos;
+		return pos;
+	}
+
 	GET_FS(lastError)
 
+	if(!flushBuffer()) {
+		return lastError;
+	}
+
 	// Cannot rely on return value from fileSeek - failure does not mean position hasn't changed
-	fs->lseek(handle, offset, origin);
-	int newpos = fs->tell(handle);
-	if(check(newpos)) {
-		pos = size_t(newpos);
+	fs->lseek(handle, newPos, SeekOrigin::Start);
+	int res = fs->tell(handle);
+	if(check(res)) {
+		filePos = pos = size_t(res);
 		if(pos > size) {
 			size = pos;
 		}
+		// Extended region reads as zeroes
+		bufferLength = 0;
 	}
-	return newpos;
+	return res;
 }
 
 String FileStream::fileName() const
@@ -200,8 +425,15 @@ bool FileStream::truncate(size_t newSize)
 		return 0;
 	}
 
+	if(!flushBuffer()) {
+		return false;
+	}
+
 	bool res = check(fs->ftruncate(handle, newSize));
 	if(res) {
+		if(bufferPos + bufferLength > newSize) {
+			bufferLength = 0;
+		}
 		size = newSize;
 		if(pos > size) {
 			pos = size;
@@ -12,11 +12,32 @@
 
 #include "../ReadWriteStream.h"
 #include <IFS/FsBase.h>
+#include <memory>
+
+/**
+ * @brief Size of FileStream read-ahead and write-behind buffer
+ *
+ * Filesystem access is then performed in blocks of this size aligned to file offsets,
+ * regardless of how callers access the stream.
+ * Use a multiple of the filesystem page or sector size. Set to 0 to disable buffering.
+ */
+#ifndef FILE_STREAM_BUFFER_SIZE
+#define FILE_STREAM_BUFFER_SIZE 512
+#endif
 
 namespace IFS
 {
 /**
  * @brief    File stream class
+ *
+ * Reads are serviced from an internal buffer filled in aligned blocks of `FILE_STREAM_BUFFER_SIZE`,
+ * which `peekRegion()` makes available to callers such as TcpConnection without further copying.
+ * Writes are collected into aligned blocks before being passed to the filesystem.
+ * Transfers of whole aligned blocks bypass the buffer.
+ *
+ * @note Buffered data is written when the stream is closed, seeked or flushed.
+ * Errors may therefore be reported by those operations rather than by `write()`.
+ *
  * @ingroup  stream data
  */
 class FileStream : public FsBase, public ReadWriteStream
@@ -66,12 +87,33 @@ public:
 
 	uint16_t readMemoryBlock(char* data, int bufSize) override;
 
+	size_t peekRegion(const char*& data) override;
+
 	int seekFrom(int offset, SeekOrigin origin) override;
 
 	bool isFinished() override
 	{
 		auto fs = getFileSystem();
-		return fs == nullptr || lastError != FS_OK || fs->eof(handle) != 0;
+		return fs == nullptr || lastError != FS_OK || pos >= size;
+	}
+
+	/**
+	 * @brief Write any buffered data to the file
+	 */
+	void flush() override
+	{
+		(void)flushBuffer();
+	}
+
+	/**
+	 * @brief Get preferred transfer size
+	 *
+	 * Reads or writes of multiples of this size, at file positions which are also multiples,
+	 * are passed directly to the filesystem.
+	 */
+	static constexpr size_t getIoSize()
+	{
+		return FILE_STREAM_BUFFER_SIZE;
 	}
 
 	/** @brief Filename of file stream is attached to
@@ -143,13 +185,32 @@ public:
 	{
 		GET_FS(false)
 
+		if(!flushBuffer()) {
+			return false;
+		}
+
 		return check(fs->fstat(handle, &s));
 	}
 
 private:
+	bool isBuffered(size_t offset) const
+	{
+		return offset >= bufferPos && offset < bufferPos + bufferLength;
+	}
+
+	bool fillBuffer();
+	bool flushBuffer();
+	bool seekFile(size_t offset);
+	size_t writeDirect(const uint8_t* data, size_t length);
+
 	FileHandle handle{-1};
 	size_t pos{0};
 	size_t size{0};
+	size_t filePos{0}; ///< Actual position of file handle
+	std::unique_ptr<char[]> buffer;
+	size_t bufferPos{0}; ///< File offset corresponding to start of buffer
+	uint16_t bufferLength{0};
+	bool bufferDirty{false}; ///< Buffer contains data yet to be written
 };
 
 } // namespace IFS
@@ -0,0 +1,45 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * JsonWriterStream.cpp
+ *
+ ****/
+
+#include "JsonWriterStream.h"
+
+void JsonWriterStream::fill()
+{
+	if(done || !buffer.isFinished()) {
+		return;
+	}
+
+	position += buffer.getSize();
+	buffer.clear();
+	while(!done && buffer.getSize() < JSON_WRITER_STREAM_BUFFER_SIZE) {
+		auto size = buffer.getSize();
+		if(!generator || !generator(writer)) {
+			writer.endAll();
+			done = true;
+		} else if(buffer.getSize() == size) {
+			// Nothing available yet
+			break;
+		}
+	}
+}
+
+int JsonWriterStream::seekFrom(int offset, SeekOrigin origin)
+{
+	// Forward-only seeks
+	if(origin != SeekOrigin::Current || offset < 0) {
+		return -1;
+	}
+
+	int pos = buffer.seekFrom(offset, SeekOrigin::Current);
+	if(pos < 0) {
+		return -1;
+	}
+	return position + pos;
+}
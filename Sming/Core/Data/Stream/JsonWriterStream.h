@@ -0,0 +1,116 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * JsonWriterStream.h
+ *
+ ****/
+
+#pragma once
+
+#include "MemoryDataStream.h"
+#include "../Format/JsonWriter.h"
+#include <Delegate.h>
+
+/**
+ * @brief Generator output is buffered until it reaches at least this many bytes
+ */
+#ifndef JSON_WRITER_STREAM_BUFFER_SIZE
+#define JSON_WRITER_STREAM_BUFFER_SIZE 256
+#endif
+
+/**
+ * @brief Stream which produces JSON content on demand
+ *
+ * A generator callback is invoked whenever more output is required, for example as a TcpConnection
+ * drains. Each call should write a small part of the document, such as one record, using the
+ * provided JsonWriter. Only the current part needs to be held in memory.
+ *
+ * ```
+ * unsigned index{0};
+ * auto stream = new JsonWriterStream([index](Format::JsonWriter& json) mutable -> bool {
+ *     if(index == 0) {
+ *         json.beginArray();
+ *     }
+ *     if(index == logCount) {
+ *         return false; // Done: any open containers get closed
+ *     }
+ *     json.beginObject().add("time", log[index].time).add("value", log[index].value).end();
+ *     ++index;
+ *     return true;
+ * });
+ * response.sendDataStream(stream, MIME_JSON);
+ * ```
+ *
+ * If the generator returns true without producing output (e.g. data is not yet available),
+ * the stream will try again on the next read.
+ *
+ * @ingroup stream
+ */
+class JsonWriterStream : public IDataSourceStream
+{
+public:
+	/**
+	 * @brief Callback to write the next part of the document
+	 * @param writer
+	 * @retval bool Return false when the document is complete
+	 */
+	using Generator = Delegate<bool(Format::JsonWriter& writer)>;
+
+	JsonWriterStream(Generator generator) : generator(generator)
+	{
+	}
+
+	StreamType getStreamType() const override
+	{
+		return eSST_JsonObject;
+	}
+
+	MimeType getMimeType() const override
+	{
+		return MIME_JSON;
+	}
+
+	int available() override
+	{
+		return done ? buffer.available() : -1;
+	}
+
+	uint16_t readMemoryBlock(char* data, int bufSize) override
+	{
+		fill();
+		return buffer.readMemoryBlock(data, bufSize);
+	}
+
+	size_t peekRegion(const char*& data) override
+	{
+		fill();
+		return buffer.peekRegion(data);
+	}
+
+	int seekFrom(int offset, SeekOrigin origin) override;
+
+	bool isFinished() override
+	{
+		return done && buffer.isFinished();
+	}
+
+	/**
+	 * @brief Determine if the generator produced invalid JSON structure
+	 */
+	bool hasError() const
+	{
+		return writer.hasError();
+	}
+
+private:
+	void fill();
+
+	Generator generator;
+	MemoryDataStream buffer;
+	Format::JsonWriter writer{buffer};
+	size_t position{0}; ///< Offset of buffer content in output
+	bool done{false};
+};
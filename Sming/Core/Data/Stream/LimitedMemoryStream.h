@@ -73,6 +73,12 @@ public:
 
 	uint16_t readMemoryBlock(char* data, int bufSize) override;
 
+	size_t peekRegion(const char*& data) override
+	{
+		data = getStreamPointer();
+		return data ? writePos - readPos : 0;
+	}
+
 	int seekFrom(int offset, SeekOrigin origin) override;
 
 	size_t write(const uint8_t* buffer, size_t size) override;
@@ -10,6 +10,7 @@
 
 #include "MemoryDataStream.h"
 #include <debug_progmem.h>
+#include <heap_info.h>
 
 MemoryDataStream::MemoryDataStream(String&& string) noexcept
 {
@@ -31,6 +32,17 @@ bool MemoryDataStream::ensureCapacity(size_t minCapacity)
 			// If expanding stream, increase buffer capacity in anticipation of further writes
 			newCapacity += (minCapacity < 256) ? 128 : 64;
 		}
+		if(newCapacity >= MEMORY_STREAM_HEAP_CHECK_SIZE) {
+			// Check heap can satisfy a large request, dropping the spare capacity if necessary
+			auto maxBlockSize = system_get_max_free_block_size();
+			if(newCapacity > maxBlockSize) {
+				if(minCapacity > maxBlockSize) {
+					debug_e("MemoryDataStream: heap too fragmented for %u, largest block %u", minCapacity, maxBlockSize);
+					return false;
+				}
+				newCapacity = minCapacity;
+			}
+		}
 		debug_d("MemoryDataStream::realloc %u -> %u", capacity, newCapacity);
 		// realloc can fail, store the result in temporary pointer
 		auto newBuffer = (char*)realloc(buffer, newCapacity);
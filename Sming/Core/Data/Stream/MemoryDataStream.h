@@ -13,6 +13,14 @@
 #include "ReadWriteStream.h"
 #include <WString.h>
 
+/**
+ * @brief Buffer size above which the largest free heap block is checked before reallocation
+ * @see `system_get_heap_info()`
+ */
+#ifndef MEMORY_STREAM_HEAP_CHECK_SIZE
+#define MEMORY_STREAM_HEAP_CHECK_SIZE 4096
+#endif
+
 /**
  * @brief Read/write stream using expandable memory buffer
  *
@@ -73,6 +81,12 @@ public:
 
 	uint16_t readMemoryBlock(char* data, int bufSize) override;
 
+	size_t peekRegion(const char*& data) override
+	{
+		data = getStreamPointer();
+		return data ? size - readPos : 0;
+	}
+
 	int seekFrom(int offset, SeekOrigin origin) override;
 
 	bool isFinished() override
@@ -92,6 +106,8 @@ public:
 	 * size is known in advance. Provided subsequent write operations do
 	 * not exceed the total capacity they are guaranteed to succeed, so return
 	 * value checking may be skipped.
+	 * @note Requests of MEMORY_STREAM_HEAP_CHECK_SIZE bytes or more fail if the heap
+	 * has no single free block large enough, rather than exhausting it.
 	 */
 	bool ensureCapacity(size_t minCapacity);
 
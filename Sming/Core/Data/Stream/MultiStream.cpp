@@ -12,21 +12,28 @@
 
 #include "MultiStream.h"
 
-uint16_t MultiStream::readMemoryBlock(char* data, int bufSize)
+bool MultiStream::selectStream()
 {
-	if(stream && stream->isFinished()) {
-		stream.reset();
-	}
-
-	if(!stream) {
+	// Skip over any streams with nothing left to read
+	while(!stream || stream->isFinished()) {
 		stream.reset(getNextStream());
 		if(!stream) {
 			finished = true;
-			return 0;
+			return false;
 		}
 	}
 
-	return stream->readMemoryBlock(data, bufSize);
+	return true;
+}
+
+uint16_t MultiStream::readMemoryBlock(char* data, int bufSize)
+{
+	return selectStream() ? stream->readMemoryBlock(data, bufSize) : 0;
+}
+
+size_t MultiStream::peekRegion(const char*& data)
+{
+	return selectStream() ? stream->peekRegion(data) : 0;
 }
 
 bool MultiStream::seek(int len)
@@ -25,6 +25,12 @@ class MultiStream : public IDataSourceStream
 public:
 	uint16_t readMemoryBlock(char* data, int bufSize) override;
 
+	/**
+	 * @brief Content of the current source stream, if it is memory-based
+	 * @note Allows connections to send each memory-resident part of the output directly
+	 */
+	size_t peekRegion(const char*& data) override;
+
 	bool seek(int len) override;
 
 	bool isFinished() override
@@ -41,6 +47,8 @@ protected:
 	virtual IDataSourceStream* getNextStream() = 0;
 
 private:
+	bool selectStream();
+
 	std::unique_ptr<IDataSourceStream> stream;
 	bool finished{false};
 };
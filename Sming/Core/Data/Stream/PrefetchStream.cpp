@@ -0,0 +1,160 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * PrefetchStream.cpp
+ *
+ ****/
+
+#include "PrefetchStream.h"
+#include <Platform/System.h>
+
+struct PrefetchStream::Request {
+	PrefetchStream* stream; ///< nullptr if stream has gone
+};
+
+bool PrefetchStream::fill(Buffer& buffer)
+{
+	buffer.length = 0;
+	buffer.pos = 0;
+
+	if(!source || source->isFinished()) {
+		return false;
+	}
+
+	if(!buffer.data) {
+		buffer.data.reset(new char[bufferSize]);
+		if(!buffer.data) {
+			return false;
+		}
+	}
+
+	auto len = source->readMemoryBlock(buffer.data.get(), bufferSize);
+	if(len == 0 || !source->seek(len)) {
+		return false;
+	}
+
+	buffer.length = len;
+	return true;
+}
+
+void PrefetchStream::scheduleFill()
+{
+	if(request != nullptr || !source || source->isFinished() || next().remaining() != 0) {
+		return;
+	}
+
+	request = new Request{this};
+	if(request == nullptr) {
+		return;
+	}
+	if(!System.queueCallback(staticFill, request)) {
+		// Will be filled on demand instead
+		delete request;
+		request = nullptr;
+	}
+}
+
+void PrefetchStream::cancelFill()
+{
+	if(request != nullptr) {
+		// Request is freed by the callback
+		request->stream = nullptr;
+		request = nullptr;
+	}
+}
+
+void PrefetchStream::staticFill(void* param)
+{
+	auto req = static_cast<Request*>(param);
+	auto stream = req->stream;
+	delete req;
+	if(stream == nullptr) {
+		return;
+	}
+
+	stream->request = nullptr;
+	auto& buffer = stream->next();
+	if(buffer.remaining() == 0) {
+		stream->fill(buffer);
+	}
+}
+
+bool PrefetchStream::advance()
+{
+	current().length = 0;
+	current().pos = 0;
+
+	if(next().remaining() != 0) {
+		index ^= 1;
+	} else if(!fill(current())) {
+		return false;
+	}
+
+	// Read ahead into the buffer just emptied
+	scheduleFill();
+	return true;
+}
+
+size_t PrefetchStream::peekRegion(const char*& data)
+{
+	if(current().remaining() == 0 && !advance()) {
+		return 0;
+	}
+
+	data = &current().data[current().pos];
+	return current().remaining();
+}
+
+uint16_t PrefetchStream::readMemoryBlock(char* data, int bufSize)
+{
+	const char* ptr;
+	size_t count = peekRegion(ptr);
+	if(count == 0) {
+		return 0;
+	}
+	count = std::min(count, size_t(bufSize));
+	memcpy(data, ptr, count);
+	return count;
+}
+
+bool PrefetchStream::seek(int len)
+{
+	if(len < 0) {
+		return false;
+	}
+
+	for(auto buffer : {&current(), &next()}) {
+		auto count = std::min(size_t(len), size_t(buffer->remaining()));
+		buffer->pos += count;
+		len -= count;
+	}
+
+	if(current().remaining() == 0 && next().remaining() != 0) {
+		// Switch now so the emptied buffer starts filling
+		advance();
+	}
+
+	return len == 0 || (source && source->seek(len));
+}
+
+int PrefetchStream::available()
+{
+	if(!source) {
+		return 0;
+	}
+
+	int avail = source->available();
+	if(avail < 0) {
+		return avail;
+	}
+
+	return avail + current().remaining() + next().remaining();
+}
+
+bool PrefetchStream::isFinished()
+{
+	return current().remaining() == 0 && next().remaining() == 0 && (!source || source->isFinished());
+}
@@ -0,0 +1,136 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * PrefetchStream.h
+ *
+ ****/
+
+#pragma once
+
+#include <Data/Stream/DataSourceStream.h>
+#include <memory>
+
+/**
+ * @brief Default size for each of the two PrefetchStream buffers
+ */
+#ifndef PREFETCH_STREAM_BUFFER_SIZE
+#define PREFETCH_STREAM_BUFFER_SIZE 1024
+#endif
+
+/**
+ * @brief Reads ahead from a slow source stream, such as a file on SD card
+ *
+ * Data is held in two buffers. Whilst one is being consumed, the other is filled from
+ * the task queue, so source reads take place between network callbacks rather than
+ * whilst TcpConnection is waiting for data. If the consumer catches up the buffer is
+ * filled immediately instead.
+ *
+ * Content is available via `peekRegion()`, so is not copied again when sent.
+ *
+ * @code
+ * auto file = new FileStream;
+ * file->open(filename);
+ * response.sendDataStream(new PrefetchStream(file), file->getMimeType());
+ * @endcode
+ *
+ * @note Only forward seeks are supported
+ * @ingroup stream
+ */
+class PrefetchStream : public IDataSourceStream
+{
+public:
+	/**
+	 * @brief Constructor
+	 * @param source Stream to read from. Will be deleted after use.
+	 * @param bufferSize Size of each buffer
+	 */
+	PrefetchStream(IDataSourceStream* source, uint16_t bufferSize = PREFETCH_STREAM_BUFFER_SIZE)
+		: source(source), bufferSize(bufferSize)
+	{
+	}
+
+	~PrefetchStream()
+	{
+		cancelFill();
+	}
+
+	StreamType getStreamType() const override
+	{
+		return source ? eSST_Wrapper : eSST_Invalid;
+	}
+
+	bool isValid() const override
+	{
+		return source && source->isValid();
+	}
+
+	int available() override;
+
+	uint16_t readMemoryBlock(char* data, int bufSize) override;
+
+	size_t peekRegion(const char*& data) override;
+
+	bool seek(int len) override;
+
+	bool isFinished() override;
+
+	String id() const override
+	{
+		return source ? source->id() : nullptr;
+	}
+
+	String getName() const override
+	{
+		return source ? source->getName() : nullptr;
+	}
+
+	MimeType getMimeType() const override
+	{
+		return source ? source->getMimeType() : MIME_UNKNOWN;
+	}
+
+	IDataSourceStream* getSource() const
+	{
+		return source.get();
+	}
+
+private:
+	struct Buffer {
+		std::unique_ptr<char[]> data;
+		uint16_t length;
+		uint16_t pos;
+
+		uint16_t remaining() const
+		{
+			return length - pos;
+		}
+	};
+
+	struct Request;
+
+	bool fill(Buffer& buffer);
+	void scheduleFill();
+	void cancelFill();
+	static void staticFill(void* param);
+
+	Buffer& current()
+	{
+		return buffers[index];
+	}
+
+	Buffer& next()
+	{
+		return buffers[index ^ 1];
+	}
+
+	bool advance();
+
+	std::unique_ptr<IDataSourceStream> source;
+	Buffer buffers[2]{};
+	Request* request{nullptr}; ///< Pending task queue fill
+	uint16_t bufferSize;
+	uint8_t index{0};
+};
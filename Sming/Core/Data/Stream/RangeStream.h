@@ -0,0 +1,119 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * RangeStream.h
+ *
+ ****/
+
+#pragma once
+
+#include <Data/Stream/DataSourceStream.h>
+#include <algorithm>
+#include <memory>
+
+/**
+ * @brief Presents a contiguous block of bytes from a seekable source stream
+ *
+ * Used for serving partial content, such as a byte range from a file.
+ * @ingroup stream
+ */
+class RangeStream : public IDataSourceStream
+{
+public:
+	/**
+	 * @brief Constructor
+	 * @param source Stream which supports random seeking. Will be deleted after use.
+	 * @param start Offset of first byte within source
+	 * @param length Number of bytes to present
+	 */
+	RangeStream(IDataSourceStream* source, size_t start, size_t length)
+		: source(source), start(start), length(length)
+	{
+		valid = (source != nullptr && source->seekFrom(start, SeekOrigin::Start) == int(start));
+	}
+
+	StreamType getStreamType() const override
+	{
+		return valid ? eSST_Wrapper : eSST_Invalid;
+	}
+
+	int available() override
+	{
+		return valid ? length - readPos : 0;
+	}
+
+	uint16_t readMemoryBlock(char* data, int bufSize) override
+	{
+		if(!valid) {
+			return 0;
+		}
+		return source->readMemoryBlock(data, std::min(size_t(bufSize), length - readPos));
+	}
+
+	size_t peekRegion(const char*& data) override
+	{
+		if(!valid) {
+			return 0;
+		}
+		return std::min(source->peekRegion(data), length - readPos);
+	}
+
+	int seekFrom(int offset, SeekOrigin origin) override
+	{
+		if(!valid) {
+			return -1;
+		}
+
+		size_t newPos;
+		switch(origin) {
+		case SeekOrigin::Start:
+			newPos = offset;
+			break;
+		case SeekOrigin::Current:
+			newPos = readPos + offset;
+			break;
+		case SeekOrigin::End:
+			newPos = length + offset;
+			break;
+		default:
+			return -1;
+		}
+
+		if(newPos > length || source->seekFrom(start + newPos, SeekOrigin::Start) != int(start + newPos)) {
+			return -1;
+		}
+
+		readPos = newPos;
+		return readPos;
+	}
+
+	bool isFinished() override
+	{
+		return !valid || readPos >= length;
+	}
+
+	String id() const override
+	{
+		return source ? source->id() : nullptr;
+	}
+
+	String getName() const override
+	{
+		return source ? source->getName() : nullptr;
+	}
+
+	MimeType getMimeType() const override
+	{
+		return source ? source->getMimeType() : MIME_UNKNOWN;
+	}
+
+private:
+	std::unique_ptr<IDataSourceStream> source;
+	size_t start;
+	size_t length;
+	size_t readPos{0};
+	bool valid;
+};
@@ -13,6 +13,38 @@
 #include "SectionStream.h"
 #include <debug_progmem.h>
 
+namespace
+{
+constexpr uint32_t indexMagic{0x58444953}; // "SIDX"
+
+/*
+ * Index layout, all values little-endian:
+ *
+ * 	IndexHeader
+ * 	IndexEntry, followed by name characters, for each section
+ */
+struct __attribute__((packed)) IndexHeader {
+	uint32_t magic;
+	uint32_t sourceSize; ///< Index is invalid if source size doesn't match
+	uint8_t sectionCount;
+	uint8_t reserved[3];
+};
+
+struct __attribute__((packed)) IndexEntry {
+	uint32_t start;
+	uint32_t size;
+	uint8_t nameLength;
+};
+
+} // namespace
+
+int SectionStream::getSourceSize()
+{
+	int size = stream->seekFrom(0, SeekOrigin::End);
+	stream->seekFrom(0, SeekOrigin::Start);
+	return size;
+}
+
 /*
  * Scan through entire source stream to map location and size of sections.
  * Called once by constructor.
@@ -23,25 +55,58 @@ void SectionStream::scanSource(uint8_t maxSections)
 	char buffer[bufSize];
 
 	sections = std::make_unique<Section[]>(maxSections);
+	names.clear();
+	sourceSize = std::max(getSourceSize(), 0);
+
+	// Start tag may include a name, e.g. "{SECTION:name}", so search for "{SECTION" then check what follows
+	auto prefixLength = startTag.length() - 1;
+	char tagEnd = startTag[prefixLength];
 
 	size_t offset{0};
+	bool inSection{false};
 	while(sectionCount < maxSections && !stream->isFinished()) {
 		auto& sect = sections[sectionCount];
 		stream->seekFrom(offset, SeekOrigin::Start);
 		size_t bytesRead = stream->readMemoryBlock(buffer, bufSize);
-		if(sect.start == 0) {
-			auto tag = (char*)memmem(buffer, bytesRead, startTag.c_str(), startTag.length());
+		if(!inSection) {
+			auto tag = (char*)memmem(buffer, bytesRead, startTag.c_str(), prefixLength);
 			if(tag == nullptr) {
 				if(bytesRead < bufSize) {
 					break;
 				}
 				// If tag starts near end of buffer, this ensures it'll be contained in next read
-				offset += bytesRead - startTag.length();
+				offset += bytesRead - prefixLength;
 				continue;
 			}
 
-			offset += (tag - buffer) + startTag.length();
+			size_t tagPos = tag - buffer;
+			size_t avail = bytesRead - tagPos - prefixLength;
+			if(avail < SECTION_NAME_MAX + 2 && bytesRead == bufSize && tagPos != 0) {
+				// Read again so the whole tag is in buffer
+				offset += tagPos;
+				continue;
+			}
+
+			auto ptr = tag + prefixLength;
+			String name;
+			if(avail != 0 && *ptr == ':') {
+				auto end = (char*)memchr(ptr, tagEnd, std::min(avail, size_t(SECTION_NAME_MAX + 2)));
+				if(end == nullptr) {
+					// Not a valid tag
+					offset += tagPos + 1;
+					continue;
+				}
+				name.setString(ptr + 1, end - ptr - 1);
+				ptr = end;
+			} else if(avail == 0 || *ptr != tagEnd) {
+				offset += tagPos + 1;
+				continue;
+			}
+
+			offset += (ptr + 1 - buffer);
 			sect.start = offset;
+			names.add(name);
+			inSection = true;
 			continue;
 		}
 
@@ -57,19 +122,83 @@ void SectionStream::scanSource(uint8_t maxSections)
 		sect.size = offset - sect.start;
 		offset += endTag.length();
 		++sectionCount;
+		inSection = false;
+	}
+
+	// Discard any unterminated section
+	while(names.count() > sectionCount) {
+		names.popBack();
 	}
 
 	// No sections? Then consider the entire stream as a single section
 	if(sectionCount == 0) {
 		sections[0].start = 0;
-		sections[0].size = stream->seekFrom(0, SeekOrigin::End);
+		sections[0].size = sourceSize;
 		sectionCount = 1;
+		names.add("");
 	}
 
 	stream->seekFrom(0, SeekOrigin::Start);
 }
 
-bool SectionStream::gotoSection(uint8_t index)
+bool SectionStream::loadIndex(IDataSourceStream& index)
+{
+	IndexHeader header;
+	if(index.readBytes(reinterpret_cast<char*>(&header), sizeof(header)) != sizeof(header) ||
+	   header.magic != indexMagic || header.sectionCount == 0) {
+		debug_w("[SECT] Invalid index");
+		return false;
+	}
+
+	int size = getSourceSize();
+	if(size < 0 || uint32_t(size) != header.sourceSize) {
+		debug_w("[SECT] Index out of date");
+		return false;
+	}
+
+	auto newSections = std::make_unique<Section[]>(header.sectionCount);
+	CStringArray newNames;
+	for(unsigned i = 0; i < header.sectionCount; ++i) {
+		IndexEntry entry;
+		char name[SECTION_NAME_MAX];
+		if(index.readBytes(reinterpret_cast<char*>(&entry), sizeof(entry)) != sizeof(entry) ||
+		   entry.nameLength > SECTION_NAME_MAX || entry.start + entry.size > header.sourceSize ||
+		   index.readBytes(name, entry.nameLength) != entry.nameLength) {
+			debug_w("[SECT] Invalid index");
+			return false;
+		}
+		newSections[i].start = entry.start;
+		newSections[i].size = entry.size;
+		newNames.add(String(name, entry.nameLength));
+	}
+
+	sections = std::move(newSections);
+	names = std::move(newNames);
+	sectionCount = header.sectionCount;
+	sourceSize = header.sourceSize;
+	return true;
+}
+
+bool SectionStream::saveIndex(Print& out) const
+{
+	IndexHeader header{indexMagic, sourceSize, sectionCount, {}};
+	if(out.write(reinterpret_cast<const uint8_t*>(&header), sizeof(header)) != sizeof(header)) {
+		return false;
+	}
+
+	for(unsigned i = 0; i < sectionCount; ++i) {
+		auto name = names[i];
+		IndexEntry entry{sections[i].start, sections[i].size, uint8_t(strlen(name))};
+		if(out.write(reinterpret_cast<const uint8_t*>(&entry), sizeof(entry)) != sizeof(entry) ||
+		   out.write(reinterpret_cast<const uint8_t*>(name), entry.nameLength) != entry.nameLength) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool SectionStream::startSection(uint8_t index, uint8_t last)
 {
 	if(index >= sectionCount) {
 		debug_e("gotoSection: %u out of range", index);
@@ -86,6 +215,7 @@ bool SectionStream::gotoSection(uint8_t index)
 	sectionOffset = 0;
 	sect.recordIndex = -1;
 	currentSectionIndex = int(index) - 1;
+	lastSection = last;
 	finished = false;
 	sections[index].recordCount = 0;
 
@@ -98,7 +228,7 @@ void SectionStream::nextSection()
 {
 	do {
 		++currentSectionIndex;
-		if(currentSectionIndex >= sectionCount) {
+		if(currentSectionIndex >= sectionCount || currentSectionIndex > lastSection) {
 			finished = true;
 			return;
 		}
@@ -195,7 +325,7 @@ int SectionStream::seekFrom(int offset, SeekOrigin origin)
 		// Prevent recursion
 		auto n = newSection;
 		newSection = -1;
-		gotoSection(n);
+		startSection(n, lastSection);
 	}
 
 	return sectionOffset;
@@ -13,14 +13,27 @@
 #pragma once
 
 #include "DataSourceStream.h"
+#include "../CStringArray.h"
 #include <memory>
 
+/**
+ * @brief Maximum length of a section name
+ */
+#define SECTION_NAME_MAX 31
+
 /**
  * @brief Presents each section within a source stream as a separate stream
  *
- * Sections are (by default) marked {!SECTION} ... {/SECTION}
+ * Sections are (by default) marked {SECTION} ... {/SECTION}
  * This is typically used with templating but can be used with any stream type provided
  * the tags do not conflict with content.
+ *
+ * Sections may be named by adding a colon and the name within the start tag, e.g. {SECTION:rows},
+ * and then located using `findSection()`.
+ *
+ * The source is scanned on construction to locate the sections. For large sources this can be
+ * avoided by providing an index created previously by `saveIndex()`, or at build time using
+ * `Tools/section-index.py`.
  */
 class SectionStream : public IDataSourceStream
 {
@@ -69,6 +82,21 @@ public:
 		scanSource(maxSections);
 	}
 
+	/**
+	 * @brief Construct a section stream using a pre-built index
+	 * @param source Contains all section data, must support random seeking
+	 * @param index Section index created by `saveIndex()` or `section-index.py`
+	 * @param maxSections Used if index is invalid or out of date, when the source is scanned using default tags
+	 */
+	SectionStream(IDataSourceStream* source, IDataSourceStream& index, uint8_t maxSections = 5)
+		: startTag(F("{SECTION}")), endTag(F("{/SECTION}"))
+	{
+		stream.reset(source);
+		if(!loadIndex(index)) {
+			scanSource(maxSections);
+		}
+	}
+
 	int available() override
 	{
 		return -1;
@@ -124,6 +152,30 @@ public:
 		}
 	}
 
+	/**
+	 * @brief Get name of a section
+	 * @retval const char* Empty string if section has no name, nullptr if index is invalid
+	 */
+	const char* getSectionName(unsigned index) const
+	{
+		return (index < sectionCount) ? names[index] : nullptr;
+	}
+
+	/**
+	 * @brief Find a section given its name
+	 * @retval int Index of section, -1 if not found
+	 */
+	int findSection(const String& name) const
+	{
+		return name.length() ? names.indexOf(name, false) : -1;
+	}
+
+	/**
+	 * @brief Write the section index so it may be used again without scanning the source
+	 * @retval bool false if output is incomplete
+	 */
+	bool saveIndex(Print& out) const;
+
 	/**
 	 * @brief Register a callback to be invoked when moving to a new section
 	 */
@@ -142,8 +194,23 @@ public:
 
 	/**
 	 * @brief Goto a new section immediately
+	 * @note Output continues with subsequent sections
+	 */
+	bool gotoSection(uint8_t index)
+	{
+		return startSection(index, UINT8_MAX);
+	}
+
+	/**
+	 * @brief Output only the given section
+	 *
+	 * Used for partial rendering, such as updating a page fragment.
+	 * The stream finishes at the end of this section.
 	 */
-	bool gotoSection(uint8_t index);
+	bool selectSection(uint8_t index)
+	{
+		return startSection(index, index);
+	}
 
 	/**
 	 * @brief Goto a new section after current tag has been processed
@@ -179,6 +246,9 @@ protected:
 
 private:
 	void scanSource(uint8_t maxSections);
+	bool loadIndex(IDataSourceStream& index);
+	bool startSection(uint8_t index, uint8_t last);
+	int getSourceSize();
 
 	std::unique_ptr<IDataSourceStream> stream;
 	NextSection nextSectionCallback;
@@ -186,10 +256,13 @@ private:
 	String startTag;
 	String endTag;
 	std::unique_ptr<Section[]> sections;
+	CStringArray names;
+	uint32_t sourceSize{0};
 	uint32_t readOffset{0};
 	uint32_t sectionOffset{0};
 	uint8_t sectionCount{0};
 	int8_t currentSectionIndex{-1};
 	int8_t newSection{-1};
+	uint8_t lastSection{UINT8_MAX}; ///< Stop after this section
 	bool finished{false};
 };
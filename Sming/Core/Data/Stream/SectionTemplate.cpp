@@ -247,6 +247,17 @@ private:
 
 SectionTemplate::SectionTemplate(IDataSourceStream* source, uint8_t maxSections)
 	: TemplateStream(&sectionStream, false), sectionStream(source, maxSections)
+{
+	init();
+}
+
+SectionTemplate::SectionTemplate(IDataSourceStream* source, IDataSourceStream& index, uint8_t maxSections)
+	: TemplateStream(&sectionStream, false), sectionStream(source, index, maxSections)
+{
+	init();
+}
+
+void SectionTemplate::init()
 {
 	sectionStream.onNextSection([this]() { seekFrom(0, SeekOrigin::Start); });
 	sectionStream.onNextRecord(SectionStream::NextRecord(&SectionTemplate::nextRecord, this));
@@ -453,7 +464,7 @@ String SectionTemplate::evaluate(char*& expr)
 
 	case Command::Qgoto:
 		if(isOutputEnabled()) {
-			int n = args[0].toInt();
+			int n = getSectionIndex(args[0]);
 			if(unsigned(n) >= sectionStream.count()) {
 				return nullptr;
 			}
@@ -463,7 +474,7 @@ String SectionTemplate::evaluate(char*& expr)
 		return "";
 
 	case Command::Qcount: {
-		auto section = sectionStream.getSection(args[0].toInt());
+		auto section = sectionStream.getSection(getSectionIndex(args[0]));
 		if(section == nullptr) {
 			return nullptr;
 		}
@@ -471,7 +482,7 @@ String SectionTemplate::evaluate(char*& expr)
 	}
 
 	case Command::Qindex: {
-		auto section = sectionStream.getSection(args[0].toInt());
+		auto section = sectionStream.getSection(getSectionIndex(args[0]));
 		if(section == nullptr) {
 			return nullptr;
 		}
@@ -530,3 +541,20 @@ bool SectionTemplate::gotoSection(uint8_t index)
 	conditionalLevel = 0;
 	return true;
 }
+
+bool SectionTemplate::selectSection(uint8_t index)
+{
+	if(!sectionStream.selectSection(index)) {
+		return false;
+	}
+	if(seekFrom(0, SeekOrigin::Start) != 0) {
+		return false;
+	}
+	conditionalLevel = 0;
+	return true;
+}
+
+int SectionTemplate::getSectionIndex(const String& arg) const
+{
+	return isNumber(arg) ? arg.toInt() : sectionStream.findSection(arg);
+}
@@ -59,8 +59,8 @@
 	XX(Qendif, "{!endif}")                                                                                             \
 	XX(Qadd, "{!add:A:B} A + B")                                                                                       \
 	XX(Qsub, "{!sub:A:B} A - B")                                                                                       \
-	XX(Qgoto, "{!goto:A} move to section A")                                                                           \
-	XX(Qcount, "{!count:A} emit number of records in section A")                                                       \
+	XX(Qgoto, "{!goto:A} move to section A, given its index or name")                                                   \
+	XX(Qcount, "{!count:A} emit number of records in section A")                                                        \
 	XX(Qindex, "{!index:A} emit current record index for section A")
 
 #define SECTION_TEMPLATE_FIELD_MAP(XX)                                                                                 \
@@ -89,6 +89,12 @@ public:
 
 	SectionTemplate(IDataSourceStream* source, uint8_t maxSections = 5);
 
+	/**
+	 * @brief Construct a template using a pre-built section index
+	 * @see SectionStream
+	 */
+	SectionTemplate(IDataSourceStream* source, IDataSourceStream& index, uint8_t maxSections = 5);
+
 	/**
 	 * @brief Application callback to process additional fields
 	 * @param templateStream
@@ -183,6 +189,31 @@ public:
 	 */
 	bool gotoSection(uint8_t index);
 
+	/**
+	 * @brief Discard current output and change current section
+	 * @param name Name of section to move to
+	 * @retval bool true on success, false if section not found
+	 */
+	bool gotoSection(const String& name)
+	{
+		int index = sectionStream.findSection(name);
+		return index >= 0 && gotoSection(index);
+	}
+
+	/**
+	 * @brief Discard current output and render only the given section
+	 * @param index
+	 * @retval bool true on success, false if section index invalid
+	 * @note Used for partial rendering, such as page fragments
+	 */
+	bool selectSection(uint8_t index);
+
+	bool selectSection(const String& name)
+	{
+		int index = sectionStream.findSection(name);
+		return index >= 0 && selectSection(index);
+	}
+
 	/**
 	 * @brief Set a callback to be invoked when a new record is required
 	 *
@@ -212,6 +243,8 @@ protected:
 	}
 
 private:
+	void init();
+	int getSectionIndex(const String& arg) const;
 	String openTag(bool enable);
 	String closeTag();
 	String elseTag();
@@ -0,0 +1,156 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * SegmentedMemoryStream.cpp
+ *
+ ****/
+
+#include "SegmentedMemoryStream.h"
+#include <debug_progmem.h>
+
+void SegmentedMemoryStream::reset()
+{
+	while(head != nullptr) {
+		auto next = head->next;
+		free(head);
+		head = next;
+	}
+	tail = nullptr;
+	readBlock = nullptr;
+	readBlockPos = 0;
+	readPos = 0;
+	size = 0;
+	blockCount = 0;
+}
+
+SegmentedMemoryStream::Block* SegmentedMemoryStream::getReadBlock(size_t& offset)
+{
+	if(readBlock == nullptr || readPos < readBlockPos) {
+		readBlock = head;
+		readBlockPos = 0;
+	}
+	if(readBlock == nullptr) {
+		offset = 0;
+		return nullptr;
+	}
+
+	while(readPos - readBlockPos >= blockSize && readBlock->next != nullptr) {
+		readBlock = readBlock->next;
+		readBlockPos += blockSize;
+	}
+
+	offset = readPos - readBlockPos;
+	return readBlock;
+}
+
+size_t SegmentedMemoryStream::write(const uint8_t* data, size_t len)
+{
+	if(data == nullptr || len == 0) {
+		return 0;
+	}
+
+	if(size + len > maxCapacity) {
+		debug_e("SegmentedMemoryStream too large, requested %u limit is %u", size + len, maxCapacity);
+		len = maxCapacity - size;
+	}
+
+	size_t written{0};
+	while(written < len) {
+		size_t offset = size % blockSize;
+		if(offset == 0 && size == getCapacity()) {
+			auto block = static_cast<Block*>(malloc(sizeof(Block) + blockSize));
+			if(block == nullptr) {
+				debug_e("SegmentedMemoryStream malloc(%u) failed", blockSize);
+				break;
+			}
+			block->next = nullptr;
+			if(tail == nullptr) {
+				head = block;
+			} else {
+				tail->next = block;
+			}
+			tail = block;
+			++blockCount;
+		}
+
+		size_t count = std::min(len - written, size_t(blockSize - offset));
+		memcpy(tail->data() + offset, data + written, count);
+		written += count;
+		size += count;
+	}
+
+	return written;
+}
+
+uint16_t SegmentedMemoryStream::readMemoryBlock(char* data, int bufSize)
+{
+	size_t offset;
+	auto block = getReadBlock(offset);
+	size_t count = std::min(size - readPos, size_t(std::max(bufSize, 0)));
+	size_t copied{0};
+	while(copied < count && block != nullptr) {
+		size_t n = std::min(count - copied, size_t(blockSize - offset));
+		memcpy(data + copied, block->data() + offset, n);
+		copied += n;
+		block = block->next;
+		offset = 0;
+	}
+	return copied;
+}
+
+size_t SegmentedMemoryStream::peekRegion(const char*& data)
+{
+	size_t offset;
+	auto block = getReadBlock(offset);
+	if(block == nullptr || readPos >= size) {
+		data = nullptr;
+		return 0;
+	}
+	data = block->data() + offset;
+	return std::min(size - readPos, size_t(blockSize - offset));
+}
+
+int SegmentedMemoryStream::seekFrom(int offset, SeekOrigin origin)
+{
+	size_t newPos;
+	switch(origin) {
+	case SeekOrigin::Start:
+		newPos = offset;
+		break;
+	case SeekOrigin::Current:
+		newPos = readPos + offset;
+		break;
+	case SeekOrigin::End:
+		newPos = size + offset;
+		break;
+	default:
+		return -1;
+	}
+
+	if(newPos > size) {
+		return -1;
+	}
+
+	readPos = newPos;
+	return readPos;
+}
+
+bool SegmentedMemoryStream::moveString(String& s)
+{
+	if(!s.setLength(size)) {
+		s = nullptr;
+		return false;
+	}
+
+	auto dst = s.begin();
+	for(auto block = head; block != nullptr; block = block->next) {
+		size_t count = std::min(size_t(s.end() - dst), size_t(blockSize));
+		memcpy(dst, block->data(), count);
+		dst += count;
+	}
+	reset();
+	return true;
+}
@@ -0,0 +1,135 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * SegmentedMemoryStream.h
+ *
+ ****/
+
+#pragma once
+
+#include "ReadWriteStream.h"
+#include <WString.h>
+
+/**
+ * @brief Default size of each block allocated by a SegmentedMemoryStream
+ */
+#ifndef SEGMENTED_STREAM_BLOCK_SIZE
+#define SEGMENTED_STREAM_BLOCK_SIZE 512
+#endif
+
+/**
+ * @brief Read/write memory stream which stores content in a list of fixed-size blocks
+ *
+ * Works like MemoryDataStream, but grows by allocating another block instead of reallocating the whole buffer.
+ * Large content can therefore be built without needing a single contiguous region of heap,
+ * and without the temporary doubling in memory use which `realloc` requires.
+ * As all blocks are the same size, those freed by one stream are easily re-used by the next.
+ *
+ * `peekRegion()` returns data up to the end of the current block, so TcpConnection can still
+ * send directly from the stream content.
+ *
+ * @ingroup stream
+ */
+class SegmentedMemoryStream : public ReadWriteStream
+{
+public:
+	/**
+	 * @brief Constructor
+	 * @param blockSize Size of each memory block
+	 * @param maxCapacity Limit size of stream
+	 */
+	SegmentedMemoryStream(uint16_t blockSize = SEGMENTED_STREAM_BLOCK_SIZE, size_t maxCapacity = UINT16_MAX)
+		: maxCapacity(maxCapacity), blockSize(blockSize ?: SEGMENTED_STREAM_BLOCK_SIZE)
+	{
+	}
+
+	~SegmentedMemoryStream()
+	{
+		reset();
+	}
+
+	StreamType getStreamType() const override
+	{
+		return eSST_MemoryWritable;
+	}
+
+	int available() override
+	{
+		return size - readPos;
+	}
+
+	using ReadWriteStream::write;
+
+	size_t write(const uint8_t* buffer, size_t size) override;
+
+	uint16_t readMemoryBlock(char* data, int bufSize) override;
+
+	size_t peekRegion(const char*& data) override;
+
+	int seekFrom(int offset, SeekOrigin origin) override;
+
+	bool isFinished() override
+	{
+		return readPos >= size;
+	}
+
+	/**
+	 * @brief Copy stream content into a String
+	 * @note Requires a contiguous allocation for the entire content
+	 */
+	bool moveString(String& s) override;
+
+	/**
+	 * @brief Clear stream and release allocated memory
+	 */
+	void reset();
+
+	size_t getSize() const
+	{
+		return size;
+	}
+
+	/**
+	 * @brief Get number of bytes allocated for content
+	 */
+	size_t getCapacity() const
+	{
+		return blockCount * blockSize;
+	}
+
+	uint16_t getBlockSize() const
+	{
+		return blockSize;
+	}
+
+private:
+	// Content follows header
+	struct Block {
+		Block* next;
+
+		char* data()
+		{
+			return reinterpret_cast<char*>(this + 1);
+		}
+	};
+
+	/**
+	 * @brief Find block containing the read position
+	 * @param offset On return, offset of read position within block
+	 * @retval Block* nullptr if stream is empty
+	 */
+	Block* getReadBlock(size_t& offset);
+
+	Block* head{nullptr};
+	Block* tail{nullptr};
+	Block* readBlock{nullptr}; ///< Block containing read position
+	size_t readBlockPos{0};	///< Stream position of start of `readBlock`
+	size_t readPos{0};
+	size_t size{0};
+	size_t maxCapacity;
+	size_t blockCount{0};
+	uint16_t blockSize;
+};
@@ -56,6 +56,12 @@ public:
 		return written;
 	}
 
+	size_t peekRegion(const char*& data) override
+	{
+		data = reinterpret_cast<const char*>(buffer.get()) + readPos;
+		return available();
+	}
+
 	bool seek(int len) override
 	{
 		if(readPos + len > capacity) {
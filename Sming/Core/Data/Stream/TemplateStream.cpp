@@ -36,22 +36,185 @@ String TemplateStream::getValue(const char* name)
 	return s;
 }
 
+char* TemplateStream::findStartTag(char* buf) const
+{
+	if(doubleBraces) {
+		return strstr(buf, "{{");
+	}
+
+	char* p = buf;
+	while((p = strchr(p, '{')) != nullptr && (p[1] <= ' ' || p[1] == '"')) {
+		++p;
+	}
+	return p;
+}
+
+bool TemplateStream::Index::add(uint32_t offset, uint16_t length, int16_t var)
+{
+	if(count == capacity) {
+		auto newCapacity = capacity + 16;
+		auto newTags = static_cast<Tag*>(realloc(tags, newCapacity * sizeof(Tag)));
+		if(newTags == nullptr) {
+			return false;
+		}
+		tags = newTags;
+		capacity = newCapacity;
+	}
+	tags[count++] = Tag{offset, length, var};
+	return true;
+}
+
+bool TemplateStream::buildIndex(const CStringArray* schema)
+{
+	index.reset();
+	if(stream == nullptr || stream->available() < 0 || stream->seekFrom(0, SeekOrigin::Start) != 0) {
+		return false;
+	}
+
+	const size_t tagDelimiterLength = 1 + doubleBraces;
+	const size_t maxTagLength = TEMPLATE_MAX_VAR_NAME_LEN + (2 * tagDelimiterLength);
+	constexpr size_t bufSize{256};
+	static_assert(bufSize > TEMPLATE_MAX_VAR_NAME_LEN + 4, "Buffer too small");
+	char buffer[bufSize];
+
+	std::unique_ptr<Index> newIndex(new Index);
+	newIndex->doubleBraces = doubleBraces;
+
+	uint32_t offset{0};
+	bool ok{true};
+	while(ok) {
+		if(stream->seekFrom(offset, SeekOrigin::Start) != int(offset)) {
+			ok = false;
+			break;
+		}
+		size_t len = stream->readMemoryBlock(buffer, bufSize - 1);
+		if(len == 0) {
+			break;
+		}
+		buffer[len] = '\0';
+		bool atEnd = (len < bufSize - 1);
+
+		// Position from which next read should start
+		auto next = buffer + len - (atEnd ? 0 : tagDelimiterLength);
+		auto tagStart = findStartTag(buffer);
+		while(tagStart != nullptr) {
+			auto name = tagStart + tagDelimiterLength;
+			auto end = strchr(name, '}');
+			auto nameEnd = end;
+			if(end != nullptr && doubleBraces && end[1] == '}') {
+				++end;
+			}
+			if(end == nullptr || (end + 1 == buffer + len && !atEnd)) {
+				if(tagStart != buffer) {
+					// Tag may continue into next block
+					next = std::min(next, tagStart);
+					break;
+				}
+				// Too long to be a tag
+				tagStart = findStartTag(tagStart + 1);
+				continue;
+			}
+			size_t tagLength = end + 1 - tagStart;
+			if(tagLength <= maxTagLength) {
+				int var{-1};
+				if(schema != nullptr) {
+					*nameEnd = '\0';
+					var = schema->indexOf(name, false);
+					*nameEnd = '}';
+				}
+				if(!newIndex->add(offset + (tagStart - buffer), tagLength, var)) {
+					ok = false;
+					break;
+				}
+			}
+			if(end + 1 >= next) {
+				next = end + 1;
+			}
+			tagStart = findStartTag(end + 1);
+		}
+
+		if(atEnd) {
+			break;
+		}
+		offset += next - buffer;
+	}
+
+	stream->seekFrom(0, SeekOrigin::Start);
+	reset();
+
+	if(!ok) {
+		debug_e("[TMPL] Index failed");
+		return false;
+	}
+
+	debug_d("[TMPL] Indexed %u tags", newIndex->count);
+	index.reset(newIndex.release());
+	return true;
+}
+
+uint16_t TemplateStream::readIndexed(char* data, int bufSize)
+{
+	const size_t tagDelimiterLength = 1 + doubleBraces;
+
+	for(;;) {
+		auto tag = index->getTag(tagIndex);
+		if(tag == nullptr || sourcePos < tag->offset) {
+			// Literal text
+			size_t len = bufSize;
+			if(tag != nullptr) {
+				len = std::min(len, size_t(tag->offset - sourcePos));
+			}
+			len = stream->readMemoryBlock(data, len);
+			if(outputEnabled || len == 0) {
+				return len;
+			}
+			stream->seek(len);
+			sourcePos += len;
+			continue;
+		}
+
+		size_t len = tag->length;
+		if(tag->var >= 0 && getIndexedValueCallback) {
+			// Tag content isn't required
+			value = getIndexedValueCallback(tag->var);
+		} else {
+			if(size_t(bufSize) <= len || stream->readMemoryBlock(data, len) != len) {
+				return 0;
+			}
+			data[len] = '\0';
+			char* curPos = data + tagDelimiterLength;
+			value = evaluate(curPos);
+		}
+		++tagIndex;
+		if(!value) {
+			// Not handled, emit unchanged
+			continue;
+		}
+
+		stream->seek(len);
+		sourcePos += len;
+		bool emit = outputEnabled && value.length() != 0;
+		outputEnabled = enableNextState;
+		if(emit) {
+			valuePos = 0;
+			return sendValue(data, bufSize);
+		}
+		value = nullptr;
+	}
+}
+
 uint16_t TemplateStream::readMemoryBlock(char* data, int bufSize)
 {
 	if(data == nullptr || bufSize <= 0) {
 		return 0;
 	}
 
-	auto sendValue = [&]() {
-		assert(value.length() != 0);
-		auto len = std::min(size_t(bufSize), value.length() - valuePos);
-		memcpy(data, value.c_str() + valuePos, len);
-		sendingValue = true;
-		return len;
-	};
-
 	if(sendingValue) {
-		return sendValue();
+		return sendValue(data, bufSize);
+	}
+
+	if(index && index->doubleBraces == doubleBraces) {
+		return readIndexed(data, bufSize);
 	}
 
 	if(valueWaitSize != 0) {
@@ -67,18 +230,6 @@ uint16_t TemplateStream::readMemoryBlock(char* data, int bufSize)
 		return 0;
 	}
 
-	auto findStartTag = [this](char* buf) -> char* {
-		if(doubleBraces) {
-			return strstr(buf, "{{");
-		}
-
-		char* p = buf;
-		while((p = strchr(p, '{')) != nullptr && (p[1] <= ' ' || p[1] == '"')) {
-			++p;
-		}
-		return p;
-	};
-
 	auto start = data;
 	size_t datalen = stream->readMemoryBlock(data, bufSize - 1);
 	if(datalen != 0) {
@@ -131,7 +282,7 @@ uint16_t TemplateStream::readMemoryBlock(char* data, int bufSize)
 
 			if(outputEnabled && valueWaitSize == 0 && value.length() != 0) {
 				valuePos = 0;
-				return sendValue();
+				return sendValue(data, bufSize);
 			}
 
 			outputEnabled = enableNextState;
@@ -200,6 +351,7 @@ int TemplateStream::seekFrom(int offset, SeekOrigin origin)
 		return -1;
 	}
 
+	sourcePos += offset;
 	streamPos += offset;
 	return streamPos;
 }
@@ -13,6 +13,8 @@
 #include "DataSourceStream.h"
 #include "WHashMap.h"
 #include "WString.h"
+#include "../CStringArray.h"
+#include <memory>
 
 #ifndef TEMPLATE_MAX_VAR_NAME_LEN
 /**
@@ -36,6 +38,9 @@
  * 
  * Invalid tags, such as `{"abc"}` will be ignored, so JSON templates do not require special treatment.
  *
+ * By default the source is searched for tags as it is read. Where a template is rendered frequently,
+ * call `compile()` to locate all the tags once and share the resulting `Index` with subsequent streams.
+ *
  * @ingroup stream
  */
 class TemplateStream : public IDataSourceStream
@@ -51,6 +56,63 @@ public:
 	 */
 	using GetValueDelegate = Delegate<String(const char* name)>;
 
+	/**
+	 * @brief Callback type to return the value of a variable listed in a compiled schema
+	 * @param index Position of the variable name within the schema passed to `compile()`
+	 */
+	using GetIndexedValueDelegate = Delegate<String(unsigned index)>;
+
+	/**
+	 * @brief Table of tag locations within a template source
+	 *
+	 * Built by `TemplateStream::compile()`. Rendering then copies literal text straight up to
+	 * the next tag and reads each tag in one piece, so the source is never searched.
+	 */
+	class Index
+	{
+	public:
+		struct Tag {
+			uint32_t offset; ///< Position of opening brace in source
+			uint16_t length; ///< Includes braces
+			int16_t var;	 ///< Position of name in schema, -1 if not listed
+		};
+
+		~Index()
+		{
+			free(tags);
+		}
+
+		/**
+		 * @brief Get a tag
+		 * @param index
+		 * @retval Tag* nullptr if index is out of range
+		 */
+		const Tag* getTag(unsigned index) const
+		{
+			return (index < count) ? &tags[index] : nullptr;
+		}
+
+		unsigned getCount() const
+		{
+			return count;
+		}
+
+		bool usesDoubleBraces() const
+		{
+			return doubleBraces;
+		}
+
+	private:
+		friend class TemplateStream;
+
+		bool add(uint32_t offset, uint16_t length, int16_t var);
+
+		Tag* tags{nullptr};
+		unsigned count{0};
+		unsigned capacity{0};
+		bool doubleBraces{false};
+	};
+
 	/** @brief Create a template stream
      *  @param stream source of template data
      *  @param owned If true (default) then stream will be destroyed when complete
@@ -80,7 +142,82 @@ public:
 
 	bool isFinished() override
 	{
-		return stream ? stream->isFinished() : true;
+		return (stream == nullptr) || (!sendingValue && stream->isFinished());
+	}
+
+	/**
+	 * @brief Scan the source and build an index of tag locations
+	 * @retval bool false if the source cannot be indexed, in which case it is processed as normal
+	 *
+	 * The source must be seekable with a known length. Call after `setDoubleBraces()`.
+	 * Tags longer than TEMPLATE_MAX_VAR_NAME_LEN are emitted as-is.
+	 *
+	 * @note Not supported by SectionTemplate, as section content is re-read for each record
+	 */
+	bool compile()
+	{
+		return buildIndex(nullptr);
+	}
+
+	/**
+	 * @brief Build an index of tag locations, resolving variable names against a schema
+	 * @param schema List of variable names
+	 * @retval bool
+	 *
+	 * Tags matching a schema entry are resolved by `onGetIndexedValue()` using the entry's position,
+	 * so no name lookup or parsing is required when rendering.
+	 * For example:
+	 *
+	 * ```
+	 * DEFINE_FSTR_LOCAL(statusVars, "title\0uptime\0heap")
+	 * enum class Var { title, uptime, heap };
+	 *
+	 * tmpl->compile(statusVars);
+	 * tmpl->onGetIndexedValue([](unsigned index) -> String {
+	 *     switch(Var(index)) {
+	 *     case Var::title:
+	 *         return F("Status");
+	 *     ...
+	 *     }
+	 * });
+	 * ```
+	 *
+	 * Values are only fetched when the tag is reached, and other tags are evaluated by name as usual.
+	 */
+	bool compile(const CStringArray& schema)
+	{
+		return buildIndex(&schema);
+	}
+
+	/**
+	 * @brief Use an index built previously for the same source content
+	 * @param index Pass nullptr to search the source as it is read
+	 *
+	 * For example, to compile a page template once and share it between requests:
+	 *
+	 * ```
+	 * static std::shared_ptr<const TemplateStream::Index> index;
+	 * auto tmpl = new TemplateFileStream("status.html");
+	 * if(index) {
+	 *     tmpl->setIndex(index);
+	 * } else if(tmpl->compile()) {
+	 *     index = tmpl->getIndex();
+	 * }
+	 * ```
+	 *
+	 * @note Call before reading from the stream
+	 */
+	void setIndex(std::shared_ptr<const Index> index)
+	{
+		this->index = index;
+	}
+
+	/**
+	 * @brief Get the index in use, if any
+	 */
+	std::shared_ptr<const Index> getIndex() const
+	{
+		return index;
 	}
 
 	/** @brief  Set value of a variable in the template file
@@ -123,6 +260,15 @@ public:
 		getValueCallback = callback;
 	}
 
+	/**
+	 * @brief Set a callback to obtain values for variables listed in a compiled schema
+	 * @see See `compile(const CStringArray&)`
+	 */
+	void onGetIndexedValue(GetIndexedValueDelegate callback)
+	{
+		getIndexedValueCallback = callback;
+	}
+
 	/**
 	 * @brief During processing applications may suppress output of certain sections
 	 * by calling this method from within the getValue callback
@@ -184,10 +330,25 @@ public:
 	virtual String getValue(const char* name);
 
 private:
+	char* findStartTag(char* buf) const;
+	bool buildIndex(const CStringArray* schema);
+	uint16_t readIndexed(char* data, int bufSize);
+
+	uint16_t sendValue(char* data, int bufSize)
+	{
+		assert(value.length() != 0);
+		auto len = std::min(size_t(bufSize), value.length() - valuePos);
+		memcpy(data, value.c_str() + valuePos, len);
+		sendingValue = true;
+		return len;
+	}
+
 	void reset()
 	{
 		value = nullptr;
 		streamPos = 0;
+		sourcePos = 0;
+		tagIndex = 0;
 		valuePos = 0;
 		valueWaitSize = 0;
 		tagLength = 0;
@@ -199,8 +360,12 @@ private:
 	IDataSourceStream* stream;
 	Variables templateData;
 	GetValueDelegate getValueCallback;
+	GetIndexedValueDelegate getIndexedValueCallback;
+	std::shared_ptr<const Index> index;
 	String value;
 	uint32_t streamPos;		///< Position in output stream
+	uint32_t sourcePos;		///< Position in source stream, when indexed
+	unsigned tagIndex;		///< Next tag to process, when indexed
 	uint16_t valuePos;		///< How much of variable value has been sent
 	uint16_t valueWaitSize; ///< Chars to send before variable value
 	uint8_t tagLength;
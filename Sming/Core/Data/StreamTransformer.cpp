@@ -55,7 +55,13 @@ void StreamTransformer::fillTempStream(char* buffer, size_t bufSize)
 	}
 
 	if(sourceStream->isFinished()) {
+		saveState();
 		auto outLength = transform(nullptr, 0, result.get(), resultSize);
+		if(outLength > tempStream->room()) {
+			// Try again once there's more room
+			restoreState();
+			return;
+		}
 		auto written = tempStream->write(result.get(), outLength);
 		(void)written;
 		assert(written == outLength);
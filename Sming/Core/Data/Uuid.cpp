@@ -14,13 +14,61 @@
 
 #include "Uuid.h"
 #include <SystemClock.h>
-#include <stringconversion.h>
+#include <debug_progmem.h>
+#include <algorithm>
 
 extern "C" {
-uint32_t os_random();
 void os_get_random(void* buf, size_t n);
 }
 
+namespace
+{
+/*
+ * Hardware RNG reads are comparatively slow, so fetch entropy in batches
+ */
+class EntropyPool
+{
+public:
+	template <typename T> T get()
+	{
+		T value;
+		read(&value, sizeof(value));
+		return value;
+	}
+
+	void read(void* buf, size_t n)
+	{
+		auto p = static_cast<uint8_t*>(buf);
+		while(n != 0) {
+			if(pos == sizeof(pool)) {
+				os_get_random(pool, sizeof(pool));
+				pos = 0;
+			}
+			auto count = std::min(n, sizeof(pool) - pos);
+			memcpy(p, &pool[pos], count);
+			pos += count;
+			p += count;
+			n -= count;
+		}
+	}
+
+private:
+	uint8_t pool[64];
+	size_t pos{sizeof(pool)};
+};
+
+EntropyPool entropy;
+
+/*
+ * Branch-free conversion of nibble to lower-case hex digit
+ */
+__forceinline char hexDigit(unsigned n)
+{
+	return '0' + n + (((9 - int(n)) >> 8) & ('a' - '0' - 10));
+}
+
+} // namespace
+
 bool Uuid::operator==(const Uuid& other) const
 {
 	// Ensure these are strictly compared as a set of words to avoid PROGMEM issues
@@ -36,17 +84,17 @@ bool Uuid::generate(MacAddress mac)
 {
 	const uint8_t version = 1; // DCE version
 	const uint8_t variant = 2; // DCE variant
-	uint16_t clock_seq = os_random();
+	auto clock_seq = entropy.get<uint16_t>();
 	uint32_t time;
 	if(SystemClock.isSet()) {
 		time = SystemClock.now(eTZ_UTC);
 	} else {
-		time = os_random();
+		time = entropy.get<uint32_t>();
 	}
 	// Time only provides 32 bits, we need 60
-	time_low = (os_random() & 0xFFFFFFFC) | (time & 0x00000003);
+	time_low = (entropy.get<uint32_t>() & 0xFFFFFFFC) | (time & 0x00000003);
 	time_mid = (time >> 2) & 0xFFFF;
-	time_hi_and_version = (version << 12) | ((time >> 18) << 2);
+	time_hi_and_version = (version << 12) | (((time >> 18) << 2) & 0x0FFF);
 	clock_seq_hi_and_reserved = (variant << 6) | ((clock_seq >> 8) & 0x3F);
 	clock_seq_low = clock_seq & 0xFF;
 	mac.getOctets(node);
@@ -57,52 +105,16 @@ bool Uuid::generate(MacAddress mac)
 bool Uuid::generate()
 {
 	MacAddress::Octets mac;
-	os_get_random(mac, sizeof(mac));
+	entropy.read(mac, sizeof(mac));
 	// RFC4122 requires LSB of first octet to be 1
 	mac[0] |= 0x01;
 	return generate(mac);
 }
 
-bool Uuid::decompose(const char* s, size_t len)
+Uuid Uuid::invalidLiteral()
 {
-	if(len != stringSize) {
-		return false;
-	}
-
-	char* p;
-	time_low = strtoul(s, &p, 16);
-	if(*p != '-' || p - s != 8) {
-		return false;
-	}
-	s = ++p;
-
-	time_mid = strtoul(s, &p, 16);
-	if(*p != '-' || p - s != 4) {
-		return false;
-	}
-	s = ++p;
-
-	time_hi_and_version = strtoul(s, &p, 16);
-	if(*p != '-' || p - s != 4) {
-		return false;
-	}
-	s = ++p;
-
-	uint16_t x = strtoul(s, &p, 16);
-	if(*p != '-' || p - s != 4) {
-		return false;
-	}
-	clock_seq_hi_and_reserved = x >> 8;
-	clock_seq_low = x & 0xff;
-	s = ++p;
-
-	for(unsigned i = 0; i < sizeof(node); ++i) {
-		uint8_t c = unhex(*s++) << 4;
-		c |= unhex(*s++);
-		node[i] = c;
-	}
-
-	return true;
+	debug_e("[UUID] Invalid literal");
+	return Uuid{};
 }
 
 size_t Uuid::toString(char* buffer, size_t bufSize) const
@@ -115,27 +127,30 @@ size_t Uuid::toString(char* buffer, size_t bufSize) const
 		return 0;
 	}
 
-	auto set = [&](unsigned offset, uint32_t value, unsigned digits) {
-		ultoa_wp(value, &buffer[offset], 16, digits, '0');
+	// Fields are big-endian
+	uint8_t b[16]{
+		uint8_t(time_low >> 24),
+		uint8_t(time_low >> 16),
+		uint8_t(time_low >> 8),
+		uint8_t(time_low),
+		uint8_t(time_mid >> 8),
+		uint8_t(time_mid),
+		uint8_t(time_hi_and_version >> 8),
+		uint8_t(time_hi_and_version),
+		clock_seq_hi_and_reserved,
+		clock_seq_low,
 	};
+	memcpy(&b[10], node, sizeof(node));
 
 	// 2fac1234-31f8-11b4-a222-08002b34c003
 	// 0        9    14   19   24          36
-
-	set(0, time_low, 8);
-	buffer[8] = '-';
-	set(9, time_mid, 4);
-	buffer[13] = '-';
-	set(14, time_hi_and_version, 4);
-	buffer[18] = '-';
-	set(19, clock_seq_hi_and_reserved, 2);
-	set(21, clock_seq_low, 2);
-	buffer[23] = '-';
-
-	unsigned pos = 24;
-	for(unsigned i = 0; i < 6; ++i) {
-		buffer[pos++] = hexchar(node[i] >> 4);
-		buffer[pos++] = hexchar(node[i] & 0x0f);
+	auto p = buffer;
+	for(unsigned i = 0; i < 16; ++i) {
+		*p++ = hexDigit(b[i] >> 4);
+		*p++ = hexDigit(b[i] & 0x0f);
+		if(i == 3 || i == 5 || i == 7 || i == 9) {
+			*p++ = '-';
+		}
 	}
 
 	return stringSize;
@@ -94,11 +94,44 @@ struct Uuid {
 	 */
 	bool generate();
 
+	/**
+	 * @brief Parse a UUID string
+	 * @param s String of the form `2fac1234-31f8-11b4-a222-08002b34c003`, either case
+	 * @param len Length of string, must be `stringSize`
+	 * @param uuid On success, set to the parsed value, otherwise left unchanged
+	 * @retval bool false if string is not a valid UUID
+	 * @note May be evaluated at compile time. See `operator""_uuid`.
+	 */
+	static constexpr bool parse(const char* s, size_t len, Uuid& uuid)
+	{
+		if(len != stringSize) {
+			return false;
+		}
+
+		// 2fac1234-31f8-11b4-a222-08002b34c003
+		unsigned invalid = (s[8] ^ '-') | (s[13] ^ '-') | (s[18] ^ '-') | (s[23] ^ '-');
+		uint8_t b[16]{};
+		for(unsigned i = 0; i < 16; ++i) {
+			auto pos = 2 * i + (i >= 4) + (i >= 6) + (i >= 8) + (i >= 10);
+			b[i] = (unhexDigit(s[pos], invalid) << 4) | unhexDigit(s[pos + 1], invalid);
+		}
+		if(invalid) {
+			return false;
+		}
+
+		uuid = Uuid(uint32_t(b[0]) << 24 | uint32_t(b[1]) << 16 | uint32_t(b[2]) << 8 | b[3], b[4] << 8 | b[5],
+					b[6] << 8 | b[7], b[8], b[9], b[10], b[11], b[12], b[13], b[14], b[15]);
+		return true;
+	}
+
 	/**
 	 * @name Decompose string into UUID
 	 * @{
 	 */
-	bool decompose(const char* s, size_t len);
+	bool decompose(const char* s, size_t len)
+	{
+		return parse(s, len, *this);
+	}
 
 	bool decompose(const char* s)
 	{
@@ -137,6 +170,26 @@ struct Uuid {
 	}
 
 	/** @} */
+
+	/**
+	 * @brief Called at runtime for an invalid `_uuid` literal; at compile time this gives an error
+	 * @retval Uuid null value
+	 */
+	static Uuid invalidLiteral();
+
+private:
+	/*
+	 * Branch-free conversion of a hex digit, flagging bad characters in `invalid`
+	 */
+	static constexpr uint8_t unhexDigit(char c, unsigned& invalid)
+	{
+		uint8_t digit = uint8_t(c - '0');
+		uint8_t alpha = uint8_t((c | 0x20) - 'a');
+		uint8_t digitMask = -uint8_t(digit < 10);
+		uint8_t alphaMask = -uint8_t(alpha < 6);
+		invalid |= uint8_t(~(digitMask | alphaMask));
+		return (digit & digitMask) | ((alpha + 10) & alphaMask);
+	}
 };
 
 static_assert(sizeof(Uuid) == 16, "Bad Uuid");
@@ -156,6 +209,23 @@ inline bool fromString(const String& s, Uuid& uuid)
 	return uuid.decompose(s);
 }
 
+/**
+ * @brief Define a UUID from a string literal, parsed at compile time
+ *
+ * Convenient for SSDP/UPnP device types or BLE service tables:
+ *
+ * @code
+ * static constexpr Uuid batteryService PROGMEM = "0000180f-0000-1000-8000-00805f9b34fb"_uuid;
+ * @endcode
+ *
+ * An invalid string in a constant expression fails to compile.
+ */
+constexpr Uuid operator""_uuid(const char* s, size_t len)
+{
+	Uuid uuid;
+	return Uuid::parse(s, len, uuid) ? uuid : Uuid::invalidLiteral();
+}
+
 /**
  * @deprecated Use `Uuid` instead.
  */
@@ -29,40 +29,39 @@ static uint8_t unhex(const char code[2])
 	return (unhex(code[0]) << 4) | unhex(code[1]);
 }
 
+namespace
+{
 // These characters are escaped
-static bool must_escape(char c)
+constexpr char escapeChars[] = "\r\n+~!#$%^&(){}[]=:,;?'\"\\";
+
+constexpr uint32_t escapeMapWord(unsigned word)
 {
-	switch(c) {
-	case '\r':
-	case '\n':
-	case '+':
-	case '~':
-	case '!':
-	case '#':
-	case '$':
-	case '%':
-	case '^':
-	case '&':
-	case '(':
-	case ')':
-	case '{':
-	case '}':
-	case '[':
-	case ']':
-	case '=':
-	case ':':
-	case ',':
-	case ';':
-	case '?':
-	case '\'':
-	case '"':
-	case '\\':
-		return true;
-	default:
-		return false;
+	uint32_t bits = 0;
+	for(auto c : escapeChars) {
+		if(c != '\0' && unsigned(c) / 32 == word) {
+			bits |= 1U << (c % 32);
+		}
 	}
+	return bits;
 }
 
+// One bit per 7-bit ASCII character, so a test costs a single lookup instead of a chain of compares
+constexpr uint32_t escapeMap[]{escapeMapWord(0), escapeMapWord(1), escapeMapWord(2), escapeMapWord(3)};
+
+bool must_escape(char c)
+{
+	auto i = uint8_t(c);
+	return i < 128 && (escapeMap[i / 32] & (1U << (i % 32))) != 0;
+}
+
+// Characters requiring any change: escaped ones plus space, which becomes '+'
+bool must_change(char c)
+{
+	return c == ' ' || must_escape(c);
+}
+
+} // namespace
+
 unsigned uri_escape_len(const char* s, size_t len)
 {
 	unsigned ret;
@@ -105,7 +104,18 @@ char* uri_escape(char* dest, size_t dest_len, const char* src, int src_len)
 	 * make sure there is room in dest for a '\0' */
 	for(; src_len > 0 && dest_len > 1; src++, src_len--) {
 		char c = *src;
-		if(must_escape(c)) {
+		if(!must_change(c)) {
+			// Copy run of unchanged characters in one go
+			size_t run = 1;
+			while(run < size_t(src_len) && run < dest_len - 1 && !must_change(src[run])) {
+				++run;
+			}
+			memcpy(dest, src, run);
+			dest += run;
+			dest_len -= run;
+			src += run - 1;
+			src_len -= run - 1;
+		} else if(must_escape(c)) {
 			/* check that there is room for "%XX\0" in dest */
 			if(dest_len <= 3) {
 				if(ret_is_allocated)
@@ -117,11 +127,8 @@ char* uri_escape(char* dest, size_t dest_len, const char* src, int src_len)
 			dest[2] = hexchar(*src & 0x0f);
 			dest += 3;
 			dest_len -= 3;
-		} else if(c == ' ') {
-			*dest++ = '+';
-			dest_len--;
 		} else {
-			*(dest++) = *src;
+			*dest++ = '+';
 			dest_len--;
 		}
 	}
@@ -170,8 +177,16 @@ char* uri_unescape(char* dest, size_t dest_len, const char* src, int src_len)
 			src++;
 			src_len--;
 		} else {
-			*dest = *(src++);
-			src_len--;
+			// Copy run of unchanged characters in one go. May be in-place so regions can overlap.
+			size_t run = 1;
+			while(run < size_t(src_len) && run < dest_len - 1 && src[run] != '%' && src[run] != '+') {
+				++run;
+			}
+			memmove(dest, src, run);
+			dest += run - 1;
+			dest_len -= run - 1;
+			src += run;
+			src_len -= run;
 		}
 	}
 	/* check for errors - src was not fully consumed */
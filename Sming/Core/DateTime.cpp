@@ -74,44 +74,41 @@ bool matchName(const char*& ptr, uint8_t& value, const FourDigitName isoNames[],
 	return false;
 }
 
-bool isLeapCentury(uint16_t year)
+// Write value as two decimal digits
+char* putDigits(char* ptr, unsigned value)
 {
-	return year % 100 != 0 || year % 400 == 0;
+	*ptr++ = '0' + value / 10;
+	*ptr++ = '0' + value % 10;
+	return ptr;
 }
 
 } // namespace
 
-bool DateTime::isLeapYear(uint16_t year)
-{
-	return year % 4 == 0 && isLeapCentury(year);
-}
-
-/** @brief Get the number of days in a month, taking leap years into account
- *  @param month 0=jan
- *  @param year
- *  @retval uint8_t number of days in the month
- */
-uint8_t DateTime::getMonthDays(uint8_t month, uint16_t year)
-{
-	if(month == dtFebruary) {
-		return isLeapYear(year) ? 29 : 28;
-	}
-	const uint32_t monthDays = 0b101011010101;
-	return 30 + ((monthDays >> month) & 0x01);
-}
-
 void DateTime::setTime(time_t time)
 {
-	struct tm t;
-	gmtime_r(&time, &t);
-	Year = t.tm_year + 1900;
-	Month = t.tm_mon;
-	Day = t.tm_mday;
-	DayofWeek = t.tm_wday;
-	Hour = t.tm_hour;
-	Minute = t.tm_min;
-	Second = t.tm_sec;
+	// Round towards negative infinity so times before 1970 give the preceding day
+	constexpr time_t secsPerDay{SECS_PER_DAY};
+	int days = time / secsPerDay;
+	if(time % secsPerDay < 0) {
+		--days;
+	}
+	unsigned secs = time - time_t(days) * secsPerDay;
+	Hour = secs / SECS_PER_HOUR;
+	Minute = (secs / SECS_PER_MIN) % 60;
+	Second = secs % 60;
 	Milliseconds = 0;
+	DayofWeek = (days % 7 + 11) % 7; // 1970-01-01 was a Thursday
+
+	// Inverse of daysFromCivil(), with years starting in March
+	int z = days + 719468;
+	int era = ((z >= 0) ? z : z - 146096) / 146097;
+	unsigned dayOfEra = z - era * 146097;
+	unsigned yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+	unsigned dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+	unsigned mp = (5 * dayOfYear + 2) / 153;
+	Day = dayOfYear - (153 * mp + 2) / 5 + 1;
+	Month = (mp < 10) ? mp + 2 : mp - 10;
+	Year = yearOfEra + era * 400 + (Month < dtMarch);
 	calcDayOfYear();
 }
 
@@ -315,7 +312,30 @@ String DateTime::toISO8601() const
 
 String DateTime::toHTTPDate() const
 {
-	return format(_F("%a, %d %b %Y %T GMT"));
+	// Fixed layout, always in English: "Sun, 06 Nov 1994 08:49:37 GMT"
+	char buf[29];
+	FourDigitName day = isoDayNames[DayofWeek % 7];
+	FourDigitName month = isoMonthNames[Month % 12];
+	auto ptr = buf;
+	memcpy(ptr, day.c, 3);
+	ptr += 3;
+	*ptr++ = ',';
+	*ptr++ = ' ';
+	ptr = putDigits(ptr, Day % 100);
+	*ptr++ = ' ';
+	memcpy(ptr, month.c, 3);
+	ptr += 3;
+	*ptr++ = ' ';
+	ptr = putDigits(ptr, (Year / 100) % 100);
+	ptr = putDigits(ptr, Year % 100);
+	*ptr++ = ' ';
+	ptr = putDigits(ptr, Hour % 100);
+	*ptr++ = ':';
+	ptr = putDigits(ptr, Minute % 100);
+	*ptr++ = ':';
+	ptr = putDigits(ptr, Second % 100);
+	memcpy(ptr, " GMT", 4);
+	return String(buf, sizeof(buf));
 }
 
 void DateTime::addMilliseconds(long add)
@@ -332,64 +352,29 @@ void DateTime::addMilliseconds(long add)
 void DateTime::fromUnixTime(time_t timep, uint8_t* psec, uint8_t* pmin, uint8_t* phour, uint8_t* pday, uint8_t* pwday,
 							uint8_t* pmonth, uint16_t* pyear)
 {
-	struct tm t;
-	gmtime_r(&timep, &t);
+	DateTime dt(timep);
 
 	if(psec) {
-		*psec = t.tm_sec;
+		*psec = dt.Second;
 	}
 	if(pmin) {
-		*pmin = t.tm_min;
+		*pmin = dt.Minute;
 	}
 	if(phour) {
-		*phour = t.tm_hour;
+		*phour = dt.Hour;
 	}
 	if(pwday) {
-		*pwday = t.tm_wday;
+		*pwday = dt.DayofWeek;
 	}
 	if(pyear) {
-		*pyear = t.tm_year + 1900;
+		*pyear = dt.Year;
 	}
 	if(pmonth) {
-		*pmonth = t.tm_mon;
+		*pmonth = dt.Month;
 	}
 	if(pday) {
-		*pday = t.tm_mday;
-	}
-}
-
-time_t DateTime::toUnixTime(int sec, int min, int hour, int day, uint8_t month, uint16_t year)
-{
-	if(year < 69) {
-		year += 2000;
-	}
-
-	// seconds from 1970 till 1 jan 00:00:00 this year
-	auto seconds = time_t(year - 1970) * (SECS_PER_DAY * 365);
-
-	// add extra days for leap years
-	for(unsigned y = 1972; y < year; y += 4) {
-		if(isLeapCentury(y)) {
-			seconds += SECS_PER_DAY;
-		}
-	}
-	for(unsigned y = 1968; y >= year; y -= 4) {
-		if(isLeapCentury(y)) {
-			seconds -= SECS_PER_DAY;
-		}
-	}
-
-	// add days for this year
-	for(unsigned m = dtJanuary; m < month; ++m) {
-		seconds += SECS_PER_DAY * getMonthDays(m, year);
+		*pday = dt.Day;
 	}
-
-	seconds += time_t(day - 1) * SECS_PER_DAY;
-	seconds += time_t(hour) * SECS_PER_HOUR;
-	seconds += time_t(min) * SECS_PER_MIN;
-	seconds += sec;
-
-	return seconds;
 }
 
 String DateTime::format(const char* sFormat) const
@@ -533,11 +518,7 @@ String DateTime::format(const char* sFormat) const
 
 void DateTime::calcDayOfYear()
 {
-	uint16_t prevMonthDays{0};
-	for(unsigned m = dtJanuary; m < Month; ++m) {
-		prevMonthDays += getMonthDays(m, Year);
-	}
-	DayofYear = prevMonthDays + Day;
+	DayofYear = daysFromCivil(Year, Month, Day) - daysFromCivil(Year, dtJanuary, 1) + 1;
 }
 
 uint8_t DateTime::calcWeek(uint8_t firstDay) const
@@ -577,8 +558,3 @@ String DateTime::getIsoMonthName(uint8_t month)
 	auto name = isoMonthNames[month];
 	return String(name);
 }
-
-uint16_t DateTime::getDaysInYear(uint16_t year)
-{
-	return isLeapYear(year) ? 366 : 365;
-}
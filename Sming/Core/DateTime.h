@@ -289,7 +289,34 @@ public:
 	 *  @note   This static function  may be used without instantiating a DateTime object, e.g. `time_t unixTime = DateTime::toUnixTime(...);`
 	 *  @note   Unix time does not account for leap seconds.
 	 */
-	static time_t toUnixTime(int sec, int min, int hour, int day, uint8_t month, uint16_t year);
+	static constexpr time_t toUnixTime(int sec, int min, int hour, int day, uint8_t month, uint16_t year)
+	{
+		return time_t(daysFromCivil((year < 69) ? year + 2000 : year, month, day)) * time_t(SECS_PER_DAY) +
+			   time_t(hour) * time_t(SECS_PER_HOUR) + time_t(min) * time_t(SECS_PER_MIN) + sec;
+	}
+
+	/**
+	 * @brief Get number of days between 1970-01-01 and a given date
+	 * @param year Full year
+	 * @param month Month (0-11), larger values carry into the year
+	 * @param day Day of month, may be any value as for `toUnixTime()`
+	 * @retval int Days since epoch, negative for earlier dates
+	 * @note Computed directly (Howard Hinnant's days_from_civil) rather than by counting years or months
+	 */
+	static constexpr int daysFromCivil(int year, unsigned month, int day)
+	{
+		year += month / 12;
+		month %= 12;
+		// Count years from March so the leap day comes last
+		if(month < dtMarch) {
+			--year;
+		}
+		int era = ((year >= 0) ? year : year - 399) / 400;
+		int yearOfEra = year - era * 400;
+		int dayOfYear = (153 * ((month + 10) % 12) + 2) / 5 + day - 1;
+		int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+		return era * 146097 + dayOfEra - 719468;
+	}
 
 	/** @brief  Create string formatted with time and date placeholders
 	 *  @param  formatString String including date and time formatting
@@ -346,13 +373,30 @@ public:
 		return format(formatString.c_str());
 	}
 
-	static bool isLeapYear(uint16_t year);
-	static uint8_t getMonthDays(uint8_t month, uint16_t year);
+	static constexpr bool isLeapYear(uint16_t year)
+	{
+		return year % 4 == 0 && (year % 100 != 0 || year % 400 == 0);
+	}
+
+	/** @brief Get the number of days in a month, taking leap years into account
+	 *  @param month 0=jan
+	 *  @param year
+	 *  @retval uint8_t number of days in the month
+	 */
+	static constexpr uint8_t getMonthDays(uint8_t month, uint16_t year)
+	{
+		return (month == dtFebruary) ? (isLeapYear(year) ? 29 : 28) : 30 + ((0b101011010101 >> month) & 0x01);
+	}
+
 	static String getLocaleDayName(uint8_t day);
 	static String getLocaleMonthName(uint8_t month);
 	static String getIsoDayName(uint8_t day);
 	static String getIsoMonthName(uint8_t month);
-	static uint16_t getDaysInYear(uint16_t year);
+
+	static constexpr uint16_t getDaysInYear(uint16_t year)
+	{
+		return isLeapYear(year) ? 366 : 365;
+	}
 
 private:
 	// Helper methods
@@ -15,6 +15,12 @@
 #pragma once
 
 #include <functional>
+#include <type_traits>
+#include <utility>
+#include <new>
+#include <cstdint>
+#include <cstring>
+#include <cassert>
 using namespace std::placeholders;
 
 template <typename> class Delegate; /* undefined */
@@ -42,4 +48,219 @@ public:
 	}
 };
 
+template <typename, size_t capacity = 4 * sizeof(void*)> class InplaceDelegate; /* undefined */
+
+/**
+ * @brief Delegate with inline storage
+ * @tparam capacity Bytes of storage available for the bound callable
+ *
+ * Behaves like `Delegate` but stores the callable inside the object instead of
+ * (potentially) on the heap. The default capacity holds a member function binding,
+ * a `std::bind` of a method with an object pointer, a lambda capturing up to four
+ * pointers, or a regular `Delegate`.
+ *
+ * Trivially copyable callables (which includes function pointers and member function
+ * bindings) are copied with `memcpy`. Larger or over-aligned callables fall back to a heap copy,
+ * so any callable accepted by `Delegate` may be used.
+ */
+template <typename ReturnType, typename... ParamTypes, size_t capacity>
+class InplaceDelegate<ReturnType(ParamTypes...), capacity>
+{
+public:
+	InplaceDelegate() = default;
+
+	InplaceDelegate(std::nullptr_t)
+	{
+	}
+
+	/** @brief  Delegate a class method
+	 *  @param m Method declaration to delegate
+	 *  @param  c Pointer to the class type
+	 */
+	template <class ClassType> InplaceDelegate(ReturnType (ClassType::*m)(ParamTypes...), ClassType* c)
+	{
+		struct Binding {
+			ReturnType (ClassType::*method)(ParamTypes...);
+			ClassType* object;
+
+			ReturnType operator()(ParamTypes... params) const
+			{
+				return (object->*method)(std::forward<ParamTypes>(params)...);
+			}
+		};
+		assign(Binding{m, c});
+	}
+
+	template <typename Func, typename F = std::decay_t<Func>,
+			  typename = std::enable_if_t<!std::is_same<F, InplaceDelegate>::value &&
+										  std::is_invocable_r<ReturnType, F&, ParamTypes...>::value>>
+	InplaceDelegate(Func&& func)
+	{
+		F f(std::forward<Func>(func));
+		if constexpr(std::is_pointer<F>::value || std::is_member_pointer<F>::value) {
+			if(f == nullptr) {
+				return;
+			}
+		}
+		assign(std::move(f));
+	}
+
+	InplaceDelegate(const InplaceDelegate& other) : invoker(other.invoker), manager(other.manager)
+	{
+		if(manager == nullptr) {
+			memcpy(storage, other.storage, capacity);
+		} else {
+			manager(Operation::copy, storage, other.storage);
+		}
+	}
+
+	InplaceDelegate(InplaceDelegate&& other) noexcept
+	{
+		moveFrom(other);
+	}
+
+	~InplaceDelegate()
+	{
+		reset();
+	}
+
+	InplaceDelegate& operator=(const InplaceDelegate& other)
+	{
+		if(this != &other) {
+			InplaceDelegate tmp(other);
+			*this = std::move(tmp);
+		}
+		return *this;
+	}
+
+	InplaceDelegate& operator=(InplaceDelegate&& other) noexcept
+	{
+		if(this != &other) {
+			reset();
+			moveFrom(other);
+		}
+		return *this;
+	}
+
+	InplaceDelegate& operator=(std::nullptr_t)
+	{
+		reset();
+		return *this;
+	}
+
+	ReturnType operator()(ParamTypes... params) const
+	{
+		assert(invoker != nullptr);
+		return invoker(storage, std::forward<ParamTypes>(params)...);
+	}
+
+	explicit operator bool() const
+	{
+		return invoker != nullptr;
+	}
+
+	friend bool operator==(const InplaceDelegate& d, std::nullptr_t)
+	{
+		return !d;
+	}
+
+	friend bool operator!=(const InplaceDelegate& d, std::nullptr_t)
+	{
+		return bool(d);
+	}
+
+	void swap(InplaceDelegate& other)
+	{
+		InplaceDelegate tmp(std::move(other));
+		other = std::move(*this);
+		*this = std::move(tmp);
+	}
+
+private:
+	enum class Operation { copy, move, destroy };
+
+	using Invoker = ReturnType (*)(void* storage, ParamTypes&&... params);
+	using Manager = void (*)(Operation op, void* dst, void* src);
+
+	static constexpr size_t alignment{alignof(uint64_t) > alignof(void*) ? alignof(uint64_t) : alignof(void*)};
+
+	template <typename F>
+	static constexpr bool fitsInline = sizeof(F) <= capacity && alignof(F) <= alignment &&
+									   std::is_nothrow_move_constructible<F>::value;
+
+	template <typename F> void assign(F&& func)
+	{
+		using T = std::decay_t<F>;
+		if constexpr(fitsInline<T>) {
+			new(storage) T(std::move(func));
+			invoker = [](void* storage, ParamTypes&&... params) -> ReturnType {
+				return std::invoke(*static_cast<T*>(storage), std::forward<ParamTypes>(params)...);
+			};
+			if constexpr(!std::is_trivially_copyable<T>::value || !std::is_trivially_destructible<T>::value) {
+				manager = [](Operation op, void* dst, void* src) {
+					auto obj = static_cast<T*>(src);
+					switch(op) {
+					case Operation::copy:
+						new(dst) T(*obj);
+						break;
+					case Operation::move:
+						new(dst) T(std::move(*obj));
+						obj->~T();
+						break;
+					case Operation::destroy:
+						obj->~T();
+						break;
+					}
+				};
+			}
+		} else {
+			*reinterpret_cast<T**>(storage) = new T(std::move(func));
+			invoker = [](void* storage, ParamTypes&&... params) -> ReturnType {
+				return std::invoke(**static_cast<T**>(storage), std::forward<ParamTypes>(params)...);
+			};
+			manager = [](Operation op, void* dst, void* src) {
+				auto obj = *static_cast<T**>(src);
+				switch(op) {
+				case Operation::copy:
+					*static_cast<T**>(dst) = new T(*obj);
+					break;
+				case Operation::move:
+					*static_cast<T**>(dst) = obj;
+					*static_cast<T**>(src) = nullptr;
+					break;
+				case Operation::destroy:
+					delete obj;
+					break;
+				}
+			};
+		}
+	}
+
+	void moveFrom(InplaceDelegate& other)
+	{
+		invoker = other.invoker;
+		manager = other.manager;
+		if(manager == nullptr) {
+			memcpy(storage, other.storage, capacity);
+		} else {
+			manager(Operation::move, storage, other.storage);
+		}
+		other.invoker = nullptr;
+		other.manager = nullptr;
+	}
+
+	void reset()
+	{
+		if(manager != nullptr) {
+			manager(Operation::destroy, nullptr, storage);
+		}
+		invoker = nullptr;
+		manager = nullptr;
+	}
+
+	alignas(alignment) mutable uint8_t storage[capacity]{};
+	Invoker invoker{nullptr};
+	Manager manager{nullptr};
+};
+
 /** @} */
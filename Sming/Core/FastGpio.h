@@ -0,0 +1,153 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * FastGpio.h - Compile-time GPIO access
+ *
+ ****/
+
+#pragma once
+
+#include "Digital.h"
+#include <sming_attr.h>
+#include <gpio_arch.h>
+
+/** @addtogroup gpio
+ *  @{
+ */
+
+/**
+ * @brief GPIO access resolved at compile time into direct register operations
+ *
+ * Unlike `digitalWrite()` and `digitalRead()` there are no run-time range checks
+ * and no function calls, so an operation becomes a single register access.
+ * Intended for bit-banged protocols and other timing-sensitive code.
+ *
+ * Pins must first be configured with `pinMode()` (or `output()`).
+ * Unsupported pins fail to compile.
+ *
+ * Example:
+ *
+ * 		using Led = FastGpio::Pin<2>;
+ * 		Led::output();
+ * 		Led::write(true);
+ *
+ * 		using Bus = FastGpio::PinGroup<BIT(4) | BIT(5) | BIT(12)>;
+ * 		Bus::write(BIT(4) | BIT(12)); // Sets pins 4 and 12 and clears 5
+ */
+namespace FastGpio
+{
+/**
+ * @brief Operations on a group of pins within a single register bank
+ * @tparam pinMask Bit N corresponds to GPIO `32 * bank + N`
+ * @tparam bank Register bank
+ *
+ * Pins are changed together by a single register write: where both levels are required
+ * (`write()`) they are changed in two consecutive writes, set then clear.
+ */
+template <uint32_t pinMask, unsigned bank = 0> struct PinGroup {
+	static_assert(pinMask != 0, "PinGroup requires at least one pin");
+	static_assert(bank * 32 + (31 - __builtin_clz(pinMask)) < maxPins, "Unsupported GPIO");
+
+	using Port = FastGpio::Port<bank>;
+
+	static constexpr uint32_t mask{pinMask};
+
+	/**
+	 * @brief Set all pins in the group high
+	 */
+	__forceinline static void IRAM_ATTR set()
+	{
+		Port::set(mask);
+	}
+
+	/**
+	 * @brief Set all pins in the group low
+	 */
+	__forceinline static void IRAM_ATTR clear()
+	{
+		Port::clear(mask);
+	}
+
+	/**
+	 * @brief Set the pins in the group to the given levels
+	 * @param levels Bit N gives the level for pin N, bits not in the group are ignored
+	 */
+	__forceinline static void IRAM_ATTR write(uint32_t levels)
+	{
+		Port::set(levels & mask);
+		Port::clear(~levels & mask);
+	}
+
+	/**
+	 * @brief Invert the current output levels
+	 */
+	__forceinline static void IRAM_ATTR toggle()
+	{
+		write(~Port::readOutput());
+	}
+
+	/**
+	 * @brief Read input levels
+	 * @retval uint32_t Only bits within the group are returned
+	 */
+	__forceinline static uint32_t IRAM_ATTR read()
+	{
+		return Port::read(mask);
+	}
+
+	/**
+	 * @brief Enable output drivers for all pins in the group
+	 */
+	__forceinline static void output()
+	{
+		Port::enableOutput(mask);
+	}
+
+	/**
+	 * @brief Disable output drivers for all pins in the group
+	 */
+	__forceinline static void input()
+	{
+		Port::disableOutput(mask);
+	}
+};
+
+/**
+ * @brief Operations on a single pin
+ * @tparam pin GPIO number
+ */
+template <uint8_t pin> struct Pin : public PinGroup<BIT(pin % 32), pin / 32> {
+	using Group = PinGroup<BIT(pin % 32), pin / 32>;
+
+	static constexpr uint8_t number{pin};
+
+	__forceinline static void IRAM_ATTR write(bool level)
+	{
+		if(level) {
+			Group::set();
+		} else {
+			Group::clear();
+		}
+	}
+
+	__forceinline static bool IRAM_ATTR read()
+	{
+		return Group::read() != 0;
+	}
+
+	/**
+	 * @brief Configure pin mode
+	 * @see `pinMode()`
+	 */
+	static void mode(uint8_t mode)
+	{
+		pinMode(pin, mode);
+	}
+};
+
+} // namespace FastGpio
+
+/** @} */
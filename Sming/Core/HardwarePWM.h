@@ -36,6 +36,14 @@
 class HardwarePWM
 {
 public:
+	/**
+	 * @brief Staged values for updating all channels together
+	 */
+	struct Batch {
+		uint32_t duty[PWM_CHANNEL_NUM_MAX]{}; ///< Duty for each channel, in channel order
+		uint32_t period{0};					  ///< New period, or 0 to leave unchanged
+	};
+
 	/** @brief  Instantiate hardware PWM object
      *  @param  pins Pointer to array of pins to control
      *  @param  no_of_pins Quantity of elements in array of pins
@@ -122,6 +130,15 @@ public:
 	 */
 	void update();
 
+	/** @brief  Set duty for all channels, and optionally the period, in a single update
+	 *  @param  batch New values
+	 *  @retval bool false if any duty is out of range for the period, in which case nothing is changed
+	 *  @note   Output timing is calculated once, in task context, and takes effect for all channels
+	 *          at the next period boundary. Use this in preference to multiple calls to setDutyChan()
+	 *          when changing several channels at once, such as for colour fades.
+	 */
+	bool apply(const Batch& batch);
+
 	/** @brief Get PWM Frequency
 	 *  @param pin GPIO to get frequency for
 	 *  @retval uint32_t Value of Frequency 
@@ -50,6 +50,9 @@ void HardwareSerial::end()
 
 	smg_uart_uninit(uart);
 	uart = nullptr;
+
+	delete txStream;
+	txStream = nullptr;
 }
 
 size_t HardwareSerial::setRxBufferSize(size_t size)
@@ -66,12 +69,59 @@ size_t HardwareSerial::setTxBufferSize(size_t size)
 {
 	if(uart) {
 		txSize = smg_uart_resize_tx_buffer(uart, size);
+		// Default threshold depends on buffer size
+		updateUartCallback();
 	} else {
 		txSize = size;
 	}
 	return txSize;
 }
 
+bool HardwareSerial::sendDataStream(IDataSourceStream* stream)
+{
+	if(stream == nullptr) {
+		return false;
+	}
+
+	if(txStream != nullptr || !smg_uart_tx_enabled(uart)) {
+		delete stream;
+		return false;
+	}
+
+	txStream = stream;
+	updateUartCallback();
+	fillFromStream();
+	return true;
+}
+
+void HardwareSerial::fillFromStream()
+{
+	while(txStream != nullptr) {
+		auto space = smg_uart_tx_free(uart);
+		if(space == 0) {
+			break;
+		}
+
+		// Read in FIFO-sized chunks
+		char buffer[UART_TX_FIFO_SIZE];
+		auto len = txStream->readMemoryBlock(buffer, std::min(space, sizeof(buffer)));
+		// Won't wait as there's enough space
+		auto written = smg_uart_write(uart, buffer, len);
+		txStream->seek(written);
+
+		if(txStream->isFinished()) {
+			delete txStream;
+			txStream = nullptr;
+			updateUartCallback();
+			break;
+		}
+
+		if(len == 0 || written < len) {
+			break;
+		}
+	}
+}
+
 void HardwareSerial::systemDebugOutput(bool enabled)
 {
 	if(!uart) {
@@ -101,8 +151,18 @@ void HardwareSerial::invokeCallbacks()
 	callbackQueued = false;
 	smg_uart_restore_interrupts();
 
+	if((status & (UART_STATUS_TX_THRESHOLD | UART_STATUS_TXFIFO_EMPTY)) != 0) {
+		fillFromStream();
+		if(transmitReady) {
+			auto space = smg_uart_tx_free(uart);
+			if(space != 0) {
+				transmitReady(*this, space);
+			}
+		}
+	}
+
 	// Transmit complete ?
-	if((status & UART_STATUS_TXFIFO_EMPTY) != 0 && transmitComplete) {
+	if((status & UART_STATUS_TXFIFO_EMPTY) != 0 && transmitComplete && txStream == nullptr) {
 		transmitComplete(*this);
 	}
 
@@ -113,6 +173,11 @@ void HardwareSerial::invokeCallbacks()
 			HWSDelegate(*this, receivedChar, smg_uart_rx_available(uart));
 		}
 	}
+
+	// Receive line idle ?
+	if((status & UART_STATUS_RXFIFO_TOUT) != 0 && frameReceived) {
+		frameReceived(*this, smg_uart_rx_available(uart));
+	}
 }
 
 unsigned HardwareSerial::getStatus()
@@ -175,10 +240,23 @@ bool HardwareSerial::updateUartCallback()
 		mask |= UART_STATUS_RXFIFO_FULL | UART_STATUS_RXFIFO_TOUT | UART_STATUS_RXFIFO_OVF;
 	}
 
+	if(frameReceived) {
+		mask |= UART_STATUS_RXFIFO_TOUT;
+	}
+
 	if(transmitComplete) {
 		mask |= UART_STATUS_TXFIFO_EMPTY;
 	}
 
+	if(transmitReady || txStream != nullptr) {
+		// Without a transmit buffer, notification comes only when the FIFO has emptied
+		mask |= UART_STATUS_TX_THRESHOLD | UART_STATUS_TXFIFO_EMPTY;
+		auto threshold = txThreshold ?: std::max(txSize / 2, size_t(1));
+		smg_uart_set_tx_threshold(uart, std::min(threshold, size_t(UINT16_MAX)));
+	} else {
+		smg_uart_set_tx_threshold(uart, 0);
+	}
+
 	statusMask = mask;
 
 	setUartCallback(mask == 0 ? nullptr : staticCallbackHandler, this);
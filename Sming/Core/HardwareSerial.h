@@ -20,6 +20,7 @@
 #include <Data/Stream/ReadWriteStream.h>
 #include <BitManipulations.h>
 #include <driver/uart.h>
+#include <algorithm>
 
 #define UART_ID_0 0 ///< ID of UART 0
 #define UART_ID_1 1 ///< ID of UART 1
@@ -50,6 +51,21 @@ using StreamDataReceivedDelegate = Delegate<void(Stream& source, char arrivedCha
  */
 using TransmitCompleteDelegate = Delegate<void(HardwareSerial& serial)>;
 
+/** @brief Delegate callback type for transmit buffer space notification
+ *  @param serial
+ *  @param space Free space in transmit buffer
+ */
+using TransmitReadyDelegate = Delegate<void(HardwareSerial& serial, size_t space)>;
+
+/** @brief Delegate callback type for receive frame completion
+ *  @param serial
+ *  @param available Quantity of data in receive buffer
+ *  @note Invoked when the receive line has been idle for the hardware timeout period,
+ *  which on most devices defaults to a few character times. This makes it suitable for
+ *  detecting the end of packets in protocols such as Modbus RTU.
+ */
+using FrameReceivedDelegate = Delegate<void(HardwareSerial& serial, size_t available)>;
+
 // clang-format off
 #define SERIAL_CONFIG_MAP(XX) \
 	XX(5N1) XX(6N1) XX(7N1) XX(8N1) XX(5N2) XX(6N2) XX(7N2) XX(8N2) XX(5E1) XX(6E1) XX(7E1) XX(8E1) \
@@ -283,11 +299,61 @@ public:
 		return false;
 	}
 
+	/**
+	 * @brief Copy received data directly from the receive buffer
+	 *
+	 * Data is only removed once `dest` has accepted it, so bridging to a slower
+	 * output loses nothing: call again when there is space.
+	 */
+	size_t copyTo(Print& dest, size_t size = SIZE_MAX) override
+	{
+		size_t total{0};
+		while(total < size) {
+			const uint8_t* data;
+			size_t len = std::min(peekRegion(data), size - total);
+			if(len == 0) {
+				break;
+			}
+			auto written = dest.write(data, len);
+			consume(written);
+			total += written;
+			if(written != len) {
+				break;
+			}
+		}
+		return total;
+	}
+
 	bool isFinished() override
 	{
 		return false;
 	}
 
+	/**
+	 * @brief Get direct access to received data without copying
+	 * @param data OUT: start of readable data
+	 * @retval size_t Number of contiguous bytes available at `data`
+	 * @note Call `consume()` to remove data once processed.
+	 * The receive buffer is circular so if `available()` is greater than the returned value,
+	 * the remainder may be obtained by calling again after `consume()`.
+	 */
+	size_t peekRegion(const uint8_t*& data)
+	{
+		const void* buf;
+		auto len = smg_uart_rx_peek_region(uart, buf);
+		data = static_cast<const uint8_t*>(buf);
+		return len;
+	}
+
+	/**
+	 * @brief Remove data obtained by `peekRegion()` from the receive buffer
+	 * @param length Must not exceed value returned by `peekRegion()`
+	 */
+	void consume(size_t length)
+	{
+		smg_uart_rx_consume(uart, length);
+	}
+
 	/** @brief  Read a character from serial port without removing from input buffer
      *  @retval int Character read from serial port or -1 if buffer empty
      *  @note   The character remains in serial port input buffer
@@ -363,6 +429,53 @@ public:
 		return updateUartCallback();
 	}
 
+	/** @brief  Set handler for notification of free transmit buffer space
+	 *  @param  transmitReadyDelegate Function to write more data
+	 *  @param  threshold Invoke handler when at least this much space is free.
+	 *  Specify 0 to use half the transmit buffer size.
+	 *  @retval bool Returns true if the callback was set correctly
+	 *  @note Requires a transmit buffer, see `setTxBufferSize()`.
+	 *  Avoids polling `availableForWrite()` when producing large amounts of output.
+	 */
+	bool onTransmitReady(TransmitReadyDelegate transmitReadyDelegate, size_t threshold = 0)
+	{
+		this->transmitReady = transmitReadyDelegate;
+		txThreshold = threshold;
+		return updateUartCallback();
+	}
+
+	/**
+	 * @brief Send content of a stream in the background
+	 * @param stream Serial takes ownership and deletes the stream when all data has been queued
+	 * @retval bool false if a stream is already being sent or port cannot transmit
+	 *
+	 * Data is copied into the transmit buffer in task context as space becomes available,
+	 * so a transmit buffer should be allocated to keep the line busy.
+	 * Other writes may be interleaved with stream content so should be avoided until
+	 * `isSendingStream()` returns false.
+	 */
+	bool sendDataStream(IDataSourceStream* stream);
+
+	/**
+	 * @brief Determine if a stream passed to `sendDataStream()` is still being sent
+	 */
+	bool isSendingStream() const
+	{
+		return txStream != nullptr;
+	}
+
+	/** @brief  Set handler for notification of idle receive line
+	 *  @param  frameReceivedDelegate Function to handle frame completion
+	 *  @retval bool Returns true if the callback was set correctly
+	 *  @note Use in place of `onDataReceived()` to avoid repeated callbacks whilst
+	 *  a frame is still arriving. Ensure the receive buffer is large enough for a complete frame.
+	 */
+	bool onFrameReceived(FrameReceivedDelegate frameReceivedDelegate)
+	{
+		this->frameReceived = frameReceivedDelegate;
+		return updateUartCallback();
+	}
+
 	/**
 	 * @brief  Set callback ISR for received data
 	 * @param  callback Function to handle received data
@@ -449,6 +562,10 @@ private:
 	int uartNr = UART_NO;
 	TransmitCompleteDelegate transmitComplete = nullptr; ///< Callback for transmit completion
 	StreamDataReceivedDelegate HWSDelegate = nullptr;	///< Callback for received data
+	FrameReceivedDelegate frameReceived = nullptr;		///< Callback for idle receive line
+	TransmitReadyDelegate transmitReady = nullptr;		///< Callback for transmit buffer space
+	IDataSourceStream* txStream = nullptr;				///< Stream being sent in background
+	size_t txThreshold = 0;
 	smg_uart_t* uart = nullptr;
 	uart_options_t options = _BV(UART_OPT_TXWAIT);
 	size_t txSize = DEFAULT_TX_BUFFER_SIZE;
@@ -465,6 +582,7 @@ private:
 	static void IRAM_ATTR staticCallbackHandler(smg_uart_t* uart, uint32_t status);
 	static void staticOnStatusChange(void* param);
 	void invokeCallbacks();
+	void fillFromStream();
 
 	/**
 	 * @brief Called whenever one of the user callbacks change
@@ -0,0 +1,118 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * InterruptDispatcher.cpp
+ *
+ * Raw interrupt callbacks do not identify the pin, so a small trampoline is generated for each one.
+ *
+ * Only the ISR writes `eventHead` and only the dispatch task writes `eventTail`.
+ * One slot is left unused to distinguish a full buffer from an empty one.
+ *
+ ****/
+
+#include "InterruptDispatcher.h"
+#include "Digital.h"
+#include <Platform/System.h>
+
+namespace
+{
+constexpr uint16_t bufferMask{INTERRUPT_DISPATCH_BUFFER_SIZE - 1};
+
+InterruptDispatcher* owners[InterruptDispatcher::maxPins];
+
+} // namespace
+
+template <uint8_t pin> void InterruptDispatcher::isr()
+{
+	auto owner = owners[pin];
+	if(owner != nullptr) {
+		owner->handleEdge(pin);
+	}
+}
+
+template <size_t... pinNumbers>
+constexpr std::array<InterruptCallback, InterruptDispatcher::maxPins>
+InterruptDispatcher::makeIsrTable(std::index_sequence<pinNumbers...>)
+{
+	return {isr<pinNumbers>...};
+}
+
+InterruptDispatcher::~InterruptDispatcher()
+{
+	for(unsigned pin = 0; pin < maxPins; ++pin) {
+		detach(pin);
+	}
+}
+
+bool InterruptDispatcher::attach(uint8_t pin, GPIO_INT_TYPE type, uint32_t debounceTime)
+{
+	static constexpr auto isrs = makeIsrTable(std::make_index_sequence<maxPins>());
+
+	if(pin >= maxPins || (owners[pin] != nullptr && owners[pin] != this)) {
+		return false;
+	}
+
+	auto& state = pins[pin];
+	state.debounceTicks = Clock::timeToTicks<NanoTime::Microseconds>(debounceTime);
+	state.lastEdge = Clock::ticks() - state.debounceTicks;
+	state.edgeCount = 0;
+	owners[pin] = this;
+	attachInterrupt(pin, isrs[pin], type);
+	return true;
+}
+
+void InterruptDispatcher::detach(uint8_t pin)
+{
+	if(pin >= maxPins || owners[pin] != this) {
+		return;
+	}
+
+	detachInterrupt(pin);
+	owners[pin] = nullptr;
+}
+
+void InterruptDispatcher::handleEdge(uint8_t pin)
+{
+	auto now = Clock::ticks();
+	auto& state = pins[pin];
+	if(now - state.lastEdge < state.debounceTicks) {
+		return;
+	}
+	state.lastEdge = now;
+	++state.edgeCount;
+
+	uint16_t head = eventHead;
+	uint16_t next = (head + 1) & bufferMask;
+	if(next == eventTail) {
+		++droppedCount;
+	} else {
+		events[head] = Event{now, pin, digitalRead(pin)};
+		eventHead = next;
+	}
+
+	if(!dispatchPending) {
+		dispatchPending = true;
+		System.queueCallback(dispatch, this);
+	}
+}
+
+void InterruptDispatcher::dispatch(void* param)
+{
+	auto self = static_cast<InterruptDispatcher*>(param);
+	// Clear first so edges occurring during the callback queue another dispatch
+	self->dispatchPending = false;
+
+	uint16_t head = self->eventHead;
+	uint16_t tail = self->eventTail;
+	while(tail != head) {
+		uint16_t end = (head > tail) ? head : INTERRUPT_DISPATCH_BUFFER_SIZE;
+		if(self->callback) {
+			self->callback(&self->events[tail], end - tail);
+		}
+		tail = end & bufferMask;
+		self->eventTail = tail;
+	}
+}
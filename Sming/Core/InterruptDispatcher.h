@@ -0,0 +1,148 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * InterruptDispatcher.h
+ *
+ ****/
+
+#pragma once
+
+#include "Interrupts.h"
+#include <Platform/Clocks.h>
+#include <array>
+#include <utility>
+
+/** @addtogroup interrupts
+ *  @{
+ */
+
+/**
+ * @brief Number of events which may be buffered for each dispatcher
+ * @note Must be a power of 2
+ */
+#ifndef INTERRUPT_DISPATCH_BUFFER_SIZE
+#define INTERRUPT_DISPATCH_BUFFER_SIZE 32
+#endif
+
+/**
+ * @brief Collects GPIO edges in interrupt context and delivers them to the application in batches
+ *
+ * Each edge is timestamped in the ISR and placed in a lock-free buffer. Edges occurring within the
+ * debounce window of the previous accepted edge for the same pin are discarded.
+ *
+ * At most one task callback is queued at any time, however many edges occur, so noisy inputs
+ * cannot flood the system task queue. If the buffer fills, further events are dropped but
+ * the per-pin edge counts remain accurate.
+ */
+class InterruptDispatcher
+{
+public:
+	/**
+	 * @brief Clock used for timestamps and debounce intervals
+	 */
+	using Clock = CpuCycleClockNormal;
+
+	struct Event {
+		uint32_t timestamp; ///< Clock ticks
+		uint8_t pin;
+		uint8_t level; ///< Pin level read in the ISR
+	};
+
+	/**
+	 * @brief Called in task context with buffered events, oldest first
+	 * @param events
+	 * @param count Number of events, always at least 1
+	 * @note A batch may be split into two calls where it wraps around the internal buffer
+	 */
+	using Callback = Delegate<void(const Event* events, size_t count)>;
+
+	static constexpr unsigned maxPins{
+#if defined(ARCH_ESP8266)
+		16
+#elif defined(ARCH_ESP32)
+		40
+#else
+		32
+#endif
+	};
+
+	static_assert((INTERRUPT_DISPATCH_BUFFER_SIZE & (INTERRUPT_DISPATCH_BUFFER_SIZE - 1)) == 0,
+				  "INTERRUPT_DISPATCH_BUFFER_SIZE must be a power of 2");
+
+	InterruptDispatcher(Callback callback) : callback(callback)
+	{
+	}
+
+	~InterruptDispatcher();
+
+	/**
+	 * @brief Start handling interrupts for a pin
+	 * @param pin
+	 * @param type Edge type
+	 * @param debounceTime Edges within this time of the previous accepted edge are ignored, in microseconds
+	 * @retval bool false if pin is out of range or handled by another dispatcher
+	 * @note Replaces any existing interrupt handler for the pin
+	 */
+	bool attach(uint8_t pin, GPIO_INT_TYPE type, uint32_t debounceTime = 0);
+
+	/**
+	 * @brief Start handling interrupts for a pin
+	 * @param pin
+	 * @param mode Arduino type interrupt mode (CHANGE, RISING, FALLING)
+	 * @param debounceTime In microseconds
+	 */
+	bool attach(uint8_t pin, uint8_t mode, uint32_t debounceTime = 0)
+	{
+		return attach(pin, ConvertArduinoInterruptMode(mode), debounceTime);
+	}
+
+	/**
+	 * @brief Stop handling interrupts for a pin
+	 * @note Any buffered events for the pin are still delivered
+	 */
+	void detach(uint8_t pin);
+
+	/**
+	 * @brief Get the number of edges accepted for a pin since attach()
+	 * @note Includes edges whose events were dropped
+	 */
+	uint32_t getEdgeCount(uint8_t pin) const
+	{
+		return (pin < maxPins) ? pins[pin].edgeCount : 0;
+	}
+
+	/**
+	 * @brief Get the number of events discarded because the buffer was full
+	 */
+	uint32_t getDroppedCount() const
+	{
+		return droppedCount;
+	}
+
+private:
+	struct PinState {
+		uint32_t debounceTicks;
+		uint32_t lastEdge;
+		volatile uint32_t edgeCount;
+	};
+
+	template <uint8_t pin> static void IRAM_ATTR isr();
+	template <size_t... pinNumbers>
+	static constexpr std::array<InterruptCallback, maxPins> makeIsrTable(std::index_sequence<pinNumbers...>);
+
+	void IRAM_ATTR handleEdge(uint8_t pin);
+	static void dispatch(void* param);
+
+	Callback callback;
+	PinState pins[maxPins]{};
+	Event events[INTERRUPT_DISPATCH_BUFFER_SIZE];
+	volatile uint16_t eventHead{0};
+	volatile uint16_t eventTail{0};
+	volatile uint32_t droppedCount{0};
+	volatile bool dispatchPending{false};
+};
+
+/** @} */
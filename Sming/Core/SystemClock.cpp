@@ -11,12 +11,18 @@
 #include "SystemClock.h"
 #include <Platform/RTC.h>
 #include <debug_progmem.h>
+#include <algorithm>
 
 SystemClockClass SystemClock;
 
+namespace
+{
+constexpr uint64_t NS_PER_SECOND{1000000000ULL};
+}
+
 time_t SystemClockClass::now(TimeZone timeType) const
 {
-	uint32_t systemTime = RTC.getRtcSeconds();
+	time_t systemTime = getTimeNs() / NS_PER_SECOND;
 
 	if(timeType == eTZ_Local) {
 		systemTime += timeZoneOffsetSecs;
@@ -32,12 +38,84 @@ bool SystemClockClass::setTime(time_t time, TimeZone timeType)
 	}
 
 	timeSet = RTC.setRtcSeconds(time);
+	// Setting the RTC may restart its count, so read it afterwards
+	baseRtc = RTC.getRtcNanoseconds();
+	baseTime = uint64_t(time) * NS_PER_SECOND;
+	slewRemaining = 0;
 
 	debugf("time updated? %d", timeSet);
 
 	return timeSet;
 }
 
+uint64_t SystemClockClass::correctedTime(uint64_t rtc, int64_t& slewApplied) const
+{
+	int64_t elapsed = rtc - baseRtc;
+	if(elapsed < 0) {
+		elapsed = 0;
+	}
+	// Work in microseconds to avoid overflow over long intervals
+	int64_t elapsedUs = elapsed / 1000;
+	int64_t drift = elapsedUs * driftPpb / 1000000;
+	int64_t maxSlew = elapsedUs * SYSTEM_CLOCK_SLEW_RATE_PPM / 1000;
+	slewApplied = std::max(-maxSlew, std::min(slewRemaining, maxSlew));
+	return baseTime + elapsed + drift + slewApplied;
+}
+
+uint64_t SystemClockClass::getTimeNs() const
+{
+	if(!timeSet) {
+		return uint64_t(RTC.getRtcSeconds()) * NS_PER_SECOND;
+	}
+	int64_t slewApplied;
+	return correctedTime(RTC.getRtcNanoseconds(), slewApplied);
+}
+
+void SystemClockClass::rebase()
+{
+	auto rtc = RTC.getRtcNanoseconds();
+	int64_t slewApplied;
+	baseTime = correctedTime(rtc, slewApplied);
+	baseRtc = rtc;
+	slewRemaining -= slewApplied;
+}
+
+bool SystemClockClass::adjustTime(int64_t offset)
+{
+	if(!timeSet || offset >= SYSTEM_CLOCK_STEP_THRESHOLD_MS * 1000000LL ||
+	   offset <= -SYSTEM_CLOCK_STEP_THRESHOLD_MS * 1000000LL) {
+		auto time = int64_t(getTimeNs()) + offset;
+		auto fraction = time % NS_PER_SECOND;
+		setTime(time / NS_PER_SECOND, eTZ_UTC);
+		baseTime += fraction;
+		return false;
+	}
+
+	// Any offset not yet applied is already included in the new measurement
+	rebase();
+	slewRemaining = offset;
+	return true;
+}
+
+bool SystemClockClass::isSlewing() const
+{
+	if(!timeSet || slewRemaining == 0) {
+		return false;
+	}
+	int64_t slewApplied;
+	correctedTime(RTC.getRtcNanoseconds(), slewApplied);
+	return slewApplied != slewRemaining;
+}
+
+void SystemClockClass::setDriftCorrection(int32_t ppb)
+{
+	if(timeSet) {
+		rebase();
+	}
+	constexpr int32_t maxDrift{SYSTEM_CLOCK_MAX_DRIFT_PPB};
+	driftPpb = std::max(-maxDrift, std::min(ppb, maxDrift));
+}
+
 String SystemClockClass::getSystemTimeString(TimeZone timeType) const
 {
 	DateTime dt(now(timeType));
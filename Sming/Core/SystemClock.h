@@ -27,6 +27,27 @@ enum TimeZone {
 };
 /** @} */
 
+/**
+ * @brief Offsets smaller than this are slewed by adjustTime(), larger ones step the clock
+ */
+#ifndef SYSTEM_CLOCK_STEP_THRESHOLD_MS
+#define SYSTEM_CLOCK_STEP_THRESHOLD_MS 1000
+#endif
+
+/**
+ * @brief Maximum rate at which adjustTime() slews the clock, in parts per million
+ */
+#ifndef SYSTEM_CLOCK_SLEW_RATE_PPM
+#define SYSTEM_CLOCK_SLEW_RATE_PPM 500
+#endif
+
+/**
+ * @brief Largest drift correction accepted, in parts per billion
+ */
+#ifndef SYSTEM_CLOCK_MAX_DRIFT_PPB
+#define SYSTEM_CLOCK_MAX_DRIFT_PPB 500000
+#endif
+
 /** @brief  System clock class
  *  @addtogroup systemclock
  *  @{
@@ -50,6 +71,40 @@ public:
      */
 	bool setTime(time_t time, TimeZone timeType);
 
+	/** @brief Get the current UTC time with drift and slew corrections applied
+	 *  @retval uint64_t Nanoseconds since 00:00:00 1970-01-01
+	 *  @note Resolution is whole seconds until the clock has been set
+	 */
+	uint64_t getTimeNs() const;
+
+	/** @brief Correct the clock by a measured offset
+	 *  @param offset Nanoseconds to add to the current time
+	 *  @retval bool true if the offset is being slewed, false if the clock was stepped
+	 *
+	 *  Small offsets are applied gradually, at up to SYSTEM_CLOCK_SLEW_RATE_PPM,
+	 *  so the time never jumps or runs backwards. Offsets of SYSTEM_CLOCK_STEP_THRESHOLD_MS or more,
+	 *  or any offset if the clock has not yet been set, are applied immediately.
+	 */
+	bool adjustTime(int64_t offset);
+
+	/** @brief Determine if an offset given to adjustTime() is still being applied
+	 */
+	bool isSlewing() const;
+
+	/** @brief Set a frequency correction for the crystal
+	 *  @param ppb Parts per billion; positive values make the clock run faster
+	 *  @note Value is limited to +/- SYSTEM_CLOCK_MAX_DRIFT_PPB
+	 */
+	void setDriftCorrection(int32_t ppb);
+
+	/** @brief Get the current frequency correction
+	 *  @retval int32_t Parts per billion
+	 */
+	int32_t getDriftCorrection() const
+	{
+		return driftPpb;
+	}
+
 	/** @brief  Get current time as a string
      *  @param  timeType Time zone to present time as, i.e. return local or UTC time
      *  @retval String Current time in format: `dd.mm.yy hh:mm:ss`
@@ -89,6 +144,14 @@ public:
 	}
 
 private:
+	uint64_t correctedTime(uint64_t rtc, int64_t& slewApplied) const;
+	void rebase();
+
+	// Time is measured from a base, so corrections apply to the elapsed RTC time only
+	uint64_t baseTime = 0;	 ///< UTC nanoseconds at baseRtc
+	uint64_t baseRtc = 0;	  ///< RTC nanoseconds when base was taken
+	int64_t slewRemaining = 0; ///< Offset in nanoseconds still to be applied from base
+	int32_t driftPpb = 0;
 	int timeZoneOffsetSecs = 0;
 	bool timeSet = false;
 };
@@ -0,0 +1,209 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * Waveform.cpp - Buffer queue management for the waveform generator
+ *
+ * Architecture code plays the head buffer, calling `bufferComplete()` from interrupt context
+ * when it has been consumed, then continues with the next buffer if the generator is still active.
+ *
+ * Architectures without a hardware backend use Timer1 in one-shot mode, re-arming it from
+ * the interrupt for each step. The timer is re-armed before the outputs are updated so that
+ * interrupt latency does not accumulate over a sequence.
+ *
+ ****/
+
+#include "Waveform.h"
+#include "Digital.h"
+#include <algorithm>
+
+#if defined(ARCH_ESP8266)
+#include <espinc/eagle_soc.h>
+#include <espinc/gpio_register.h>
+#elif defined(ARCH_ESP32)
+#include <soc/gpio_reg.h>
+#endif
+
+namespace
+{
+#if defined(ARCH_ESP8266)
+// GPIO16 is in the RTC domain and cannot be set with the other pins
+constexpr uint32_t supportedPins{0x0000ffff};
+#elif defined(ARCH_HOST)
+constexpr uint32_t supportedPins{0x0001ffff};
+#elif defined(ARCH_RP2040)
+constexpr uint32_t supportedPins{0x3fffffff};
+#else
+constexpr uint32_t supportedPins{0xffffffff};
+#endif
+
+} // namespace
+
+bool Waveform::begin(uint32_t pinMask, Callback callback, void* param)
+{
+	if(this->pinMask != 0 || pinMask == 0 || (pinMask & ~supportedPins) != 0) {
+		return false;
+	}
+
+	for(unsigned pin = 0; pin < 32; ++pin) {
+		if(pinMask & BIT(pin)) {
+			pinMode(pin, OUTPUT);
+		}
+	}
+
+	this->pinMask = pinMask;
+	this->callback = callback;
+	this->param = param;
+	return true;
+}
+
+void Waveform::end()
+{
+	if(pinMask == 0) {
+		return;
+	}
+
+	stop();
+	releaseHardware();
+	pinMask = 0;
+}
+
+bool Waveform::queue(const Step* steps, size_t count)
+{
+	if(pinMask == 0 || steps == nullptr || count == 0) {
+		return false;
+	}
+
+	auto level = noInterrupts();
+	if(bufferCount == 2) {
+		restoreInterrupts(level);
+		return false;
+	}
+	buffers[(bufferHead + bufferCount) % 2] = Buffer{steps, count};
+	++bufferCount;
+	// If called from the completion callback the generator is still active, and continues by itself
+	bool start = !active;
+	active = true;
+	restoreInterrupts(level);
+
+	if(start && !startPlayback()) {
+		level = noInterrupts();
+		bufferCount = 0;
+		active = false;
+		restoreInterrupts(level);
+		return false;
+	}
+
+	return true;
+}
+
+void Waveform::stop()
+{
+	stopPlayback();
+	auto level = noInterrupts();
+	bufferCount = 0;
+	active = false;
+	restoreInterrupts(level);
+}
+
+void Waveform::bufferComplete()
+{
+	auto steps = buffers[bufferHead].steps;
+	bufferHead = (bufferHead + 1) % 2;
+	--bufferCount;
+
+	if(callback != nullptr) {
+		callback(param, steps);
+	}
+
+	if(bufferCount == 0) {
+		active = false;
+	}
+}
+
+#ifndef ARCH_RP2040
+
+namespace
+{
+// Timer1 is a single resource
+Waveform* timerOwner;
+
+} // namespace
+
+bool Waveform::startPlayback()
+{
+	if(timerOwner != this) {
+		if(timerOwner != nullptr) {
+			return false;
+		}
+		TimerApi::setCallback(timerCallback, this);
+		timerOwner = this;
+	}
+
+	stepIndex = 0;
+	auto level = noInterrupts();
+	nextStep();
+	restoreInterrupts(level);
+	return true;
+}
+
+void Waveform::stopPlayback()
+{
+	if(timerOwner == this) {
+		TimerApi::disarm();
+	}
+}
+
+void Waveform::releaseHardware()
+{
+	if(timerOwner == this) {
+		TimerApi::setCallback(nullptr, nullptr);
+		timerOwner = nullptr;
+	}
+}
+
+void Waveform::timerCallback(void* arg)
+{
+	static_cast<Waveform*>(arg)->nextStep();
+}
+
+void Waveform::nextStep()
+{
+	if(stepIndex == buffers[bufferHead].count) {
+		bufferComplete();
+		if(!active) {
+			TimerApi::disarm();
+			return;
+		}
+		stepIndex = 0;
+	}
+
+	auto& step = buffers[bufferHead].steps[stepIndex++];
+	TimerApi::setInterval(std::max(step.ticks, TimerApi::minTicks()));
+	TimerApi::arm(false);
+	writePins(step.levels);
+}
+
+void Waveform::writePins(uint32_t levels)
+{
+	uint32_t set = levels & pinMask;
+	uint32_t clear = ~levels & pinMask;
+#if defined(ARCH_ESP8266)
+	GPIO_REG_WRITE(GPIO_OUT_W1TS_ADDRESS, set);
+	GPIO_REG_WRITE(GPIO_OUT_W1TC_ADDRESS, clear);
+#elif defined(ARCH_ESP32)
+	REG_WRITE(GPIO_OUT_W1TS_REG, set);
+	REG_WRITE(GPIO_OUT_W1TC_REG, clear);
+#else
+	for(unsigned pin = 0; pin < 32; ++pin) {
+		if(pinMask & BIT(pin)) {
+			digitalWrite(pin, (set & BIT(pin)) ? HIGH : LOW);
+		}
+	}
+	(void)clear;
+#endif
+}
+
+#endif
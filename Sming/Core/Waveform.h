@@ -0,0 +1,149 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * Waveform.h
+ *
+ ****/
+
+#pragma once
+
+#include "HardwareTimer.h"
+
+/**
+ * @defgroup waveform Waveform generator
+ * @brief Play back precomputed GPIO timing sequences
+ * @ingroup timers
+ * @{
+ */
+
+/**
+ * @brief Plays buffers of GPIO output levels with precise timing
+ *
+ * Each step sets the outputs for a group of pins then holds them for a given time.
+ * Two buffers may be queued: whilst one is playing the application can refill the other,
+ * so sequences of any length can be output without gaps. Suitable for IR protocols,
+ * stepper motor ramps and similar applications which would otherwise need busy-wait loops.
+ *
+ * Esp8266, Esp32 and Host use Timer1 with one interrupt per step, so `HardwareTimer`
+ * (and `HardwarePWM` on Esp8266) cannot be used at the same time.
+ * Steps shorter than `TimerApi::minTicks()` are extended to that value.
+ *
+ * Rp2040 uses a PIO state machine fed by DMA, so there is no CPU involvement per step.
+ * See `WAVEFORM_PIO`.
+ */
+class Waveform
+{
+public:
+	using TimerApi = Timer1Api<TIMER_CLKDIV_16, eHWT_Maskable>;
+
+	/**
+	 * @brief Clock used for step timing on all architectures
+	 */
+	using Clock = TimerApi::Clock;
+
+	struct Step {
+		uint32_t levels; ///< Bit N gives the output level for GPIO N; pins not in the group are ignored
+		uint32_t ticks;	 ///< Time to hold the levels, in Clock ticks (must be non-zero)
+	};
+
+	/**
+	 * @brief Called from interrupt context when a buffer has been consumed
+	 * @param param User parameter passed to begin()
+	 * @param steps The buffer, which may now be re-used
+	 * @note Place in IRAM and keep it brief. A further buffer may be queued from here.
+	 */
+	using Callback = void (*)(void* param, const Step* steps);
+
+	~Waveform()
+	{
+		end();
+	}
+
+	/**
+	 * @brief Prepare pins for output
+	 * @param pinMask Pins to drive, bit N corresponds to GPIO N
+	 * @param callback Optional buffer completion callback
+	 * @param param Parameter passed to callback
+	 * @retval bool false if already started or pins are not supported
+	 */
+	bool begin(uint32_t pinMask, Callback callback = nullptr, void* param = nullptr);
+
+	/**
+	 * @brief Stop playback and release hardware
+	 * @note Pins are left as outputs at their current levels
+	 */
+	void end();
+
+	/**
+	 * @brief Add a buffer to the playback queue
+	 * @param steps Must remain valid until passed to the callback (or stop() is called)
+	 * @param count Number of steps in buffer
+	 * @retval bool false if both buffer slots are in use
+	 * @note Playback starts immediately if idle. May be called from interrupt context.
+	 */
+	bool queue(const Step* steps, size_t count);
+
+	/**
+	 * @brief Abandon playback, discarding any queued buffers
+	 * @note Callbacks are not invoked for discarded buffers
+	 */
+	void stop();
+
+	bool isPlaying() const
+	{
+		return active;
+	}
+
+	/**
+	 * @brief Determine if a buffer slot is available
+	 */
+	bool canQueue() const
+	{
+		return bufferCount < 2;
+	}
+
+	uint32_t getPinMask() const
+	{
+		return pinMask;
+	}
+
+private:
+	struct Buffer {
+		const Step* steps;
+		size_t count;
+	};
+
+	// Architecture-specific
+	bool startPlayback();
+	void stopPlayback();
+	void releaseHardware();
+
+	void IRAM_ATTR bufferComplete();
+
+#ifdef ARCH_RP2040
+	static void dmaInterruptHandler();
+	void IRAM_ATTR startDma();
+
+	int dmaChannel{-1};
+	int stateMachine{-1};
+#else
+	static void IRAM_ATTR timerCallback(void* arg);
+	void IRAM_ATTR nextStep();
+	void IRAM_ATTR writePins(uint32_t levels);
+
+	size_t stepIndex{0};
+#endif
+
+	Buffer buffers[2]{};
+	uint32_t pinMask{0};
+	Callback callback{nullptr};
+	void* param{nullptr};
+	volatile uint8_t bufferHead{0};
+	volatile uint8_t bufferCount{0};
+	volatile bool active{false};
+};
+
+/** @} */
@@ -0,0 +1,120 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * WheelTimer.cpp
+ *
+ ****/
+
+#include "WheelTimer.h"
+
+namespace
+{
+constexpr uint32_t slotMask{WHEEL_TIMER_SLOTS - 1};
+
+SimpleTimer& tickTimer()
+{
+	static SimpleTimer timer;
+	return timer;
+}
+
+} // namespace
+
+WheelTimerApi* WheelTimerApi::slots[WHEEL_TIMER_SLOTS];
+WheelTimerApi* WheelTimerApi::pending;
+uint32_t WheelTimerApi::currentTick;
+unsigned WheelTimerApi::activeCount;
+
+uint32_t WheelTimerClock::ticks()
+{
+	return WheelTimerApi::currentTick;
+}
+
+void WheelTimerApi::link(WheelTimerApi** head)
+{
+	next = *head;
+	if(next != nullptr) {
+		next->pprev = &next;
+	}
+	pprev = head;
+	*head = this;
+}
+
+void WheelTimerApi::unlink()
+{
+	*pprev = next;
+	if(next != nullptr) {
+		next->pprev = pprev;
+	}
+	next = nullptr;
+	pprev = nullptr;
+}
+
+void WheelTimerApi::arm(bool repeating)
+{
+	disarm();
+	this->repeating = repeating;
+	expiry = currentTick + interval;
+	link(&slots[expiry & slotMask]);
+	++activeCount;
+
+	auto& timer = tickTimer();
+	if(!timer.isStarted()) {
+		timer.initializeMs<WHEEL_TIMER_TICK_MS>(tick).start();
+	}
+}
+
+void WheelTimerApi::disarm()
+{
+	if(isArmed()) {
+		unlink();
+		--activeCount;
+	}
+}
+
+void WheelTimerApi::fire()
+{
+	if(repeating) {
+		expiry += interval;
+		link(&slots[expiry & slotMask]);
+	} else {
+		--activeCount;
+	}
+
+	// Callback may stop, restart or delete this timer
+	if(callback.func != nullptr) {
+		callback.func(callback.arg);
+	} else if(delegate) {
+		delegate();
+	}
+}
+
+void WheelTimerApi::tick()
+{
+	++currentTick;
+
+	// Move slot contents to pending list so callbacks may freely arm and disarm timers
+	auto& slot = slots[currentTick & slotMask];
+	pending = slot;
+	if(pending != nullptr) {
+		pending->pprev = &pending;
+	}
+	slot = nullptr;
+
+	while(pending != nullptr) {
+		auto timer = pending;
+		timer->unlink();
+		if(timer->expiry == currentTick) {
+			timer->fire();
+		} else {
+			// Due on a later revolution
+			timer->link(&slot);
+		}
+	}
+
+	if(activeCount == 0) {
+		tickTimer().stop();
+	}
+}
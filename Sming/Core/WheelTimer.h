@@ -0,0 +1,174 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * WheelTimer.h - Software timers driven by a single OS timer tick
+ *
+ ****/
+
+#pragma once
+
+#include "Timer.h"
+
+/**
+ * @defgroup wheel_timer WheelTimer
+ * @brief Timer wheel for large numbers of software timers
+ * @ingroup timers
+ * @{
+ */
+
+/**
+ * @brief Tick period for WheelTimer, in milliseconds
+ * @note This is the resolution of all WheelTimer intervals
+ */
+#ifndef WHEEL_TIMER_TICK_MS
+#define WHEEL_TIMER_TICK_MS 10
+#endif
+
+/**
+ * @brief Number of slots in the timer wheel, must be a power of 2
+ *
+ * Timers whose expiry time is more than one revolution away remain in their slot
+ * and are skipped until the wheel comes round to them.
+ */
+#ifndef WHEEL_TIMER_SLOTS
+#define WHEEL_TIMER_SLOTS 256
+#endif
+
+static_assert(1000 % WHEEL_TIMER_TICK_MS == 0, "WHEEL_TIMER_TICK_MS must divide into 1000");
+static_assert((WHEEL_TIMER_SLOTS & (WHEEL_TIMER_SLOTS - 1)) == 0, "WHEEL_TIMER_SLOTS must be a power of 2");
+
+/**
+ * @brief Clock counting timer wheel ticks
+ * @note The wheel only advances while timers are armed
+ */
+struct WheelTimerClock
+	: public NanoTime::Clock<WheelTimerClock, 1000 / WHEEL_TIMER_TICK_MS, uint32_t, 0xFFFFFFFFU> {
+	static constexpr const char* typeName()
+	{
+		return "WheelTimerClock";
+	}
+
+	static uint32_t ticks();
+};
+
+/**
+ * @brief Callback timer API using a hashed timer wheel
+ *
+ * All timers share a single repeating OS timer, which only runs whilst timers are armed.
+ * Starting and stopping a timer takes constant time regardless of how many are active,
+ * so this suits applications with hundreds of timeouts (e.g. per-connection).
+ *
+ * Timers are held in doubly-linked lists, one per wheel slot. On each tick only the
+ * timers in the current slot are examined.
+ *
+ * @note Must not be used from interrupt context
+ */
+class WheelTimerApi : public CallbackTimerApi<WheelTimerApi>
+{
+public:
+	using Clock = WheelTimerClock;
+	using TickType = uint32_t;
+	using TimeType = uint32_t;
+
+	static constexpr const char* typeName()
+	{
+		return "WheelTimerApi";
+	}
+
+	static constexpr TickType minTicks()
+	{
+		return 1;
+	}
+
+	static constexpr TickType maxTicks()
+	{
+		return 0x7FFFFFFF;
+	}
+
+	~WheelTimerApi()
+	{
+		disarm();
+	}
+
+	bool isArmed() const
+	{
+		return pprev != nullptr;
+	}
+
+	TickType ticks() const
+	{
+		if(!isArmed()) {
+			return 0;
+		}
+		int remain = expiry - Clock::ticks();
+		return (remain > 0) ? remain : 0;
+	}
+
+	void setCallback(TimerCallback callback, void* arg)
+	{
+		this->callback.func = callback;
+		this->callback.arg = arg;
+	}
+
+	void setCallback(TimerDelegate delegateFunction)
+	{
+		delegate = delegateFunction;
+		callback.func = nullptr;
+	}
+
+	void setInterval(TickType interval)
+	{
+		this->interval = interval;
+	}
+
+	TickType getInterval() const
+	{
+		return interval;
+	}
+
+	void arm(bool repeating);
+
+	void disarm();
+
+	/**
+	 * @brief Get number of armed timers
+	 */
+	static unsigned getActiveCount()
+	{
+		return activeCount;
+	}
+
+private:
+	friend WheelTimerClock;
+
+	void link(WheelTimerApi** head);
+	void unlink();
+	void fire();
+	static void tick();
+
+	static WheelTimerApi* slots[WHEEL_TIMER_SLOTS];
+	static WheelTimerApi* pending; ///< Timers from the slot being serviced
+	static uint32_t currentTick;
+	static unsigned activeCount;
+
+	WheelTimerApi* next{nullptr};
+	WheelTimerApi** pprev{nullptr}; ///< Points to previous entry's `next`, or list head
+	uint32_t expiry{0};
+	TickType interval{0};
+	struct {
+		TimerCallback func = nullptr;
+		void* arg = nullptr;
+	} callback;
+	TimerDelegate delegate;
+	bool repeating{false};
+};
+
+/**
+ * @brief Callback timer using the timer wheel, with delegate support
+ */
+using WheelTimer = DelegateCallbackTimer<WheelTimerApi>;
+
+/** @} */
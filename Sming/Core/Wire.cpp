@@ -105,6 +105,7 @@ TwoWire::Status TwoWire::status()
 
 void TwoWire::setClock(uint32_t freq)
 {
+	clockFrequency = freq;
 	auto sys = System.getCpuFrequency();
 	if(sys == eCF_80MHz) {
 		if(freq <= 100000) {
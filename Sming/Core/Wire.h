@@ -49,6 +49,33 @@ public:
 	using UserRequest = void (*)();
 	using UserReceive = void (*)(int len);
 
+	/**
+	 * @brief Describes an asynchronous transaction
+	 *
+	 * Any data in `txData` is written first. If `rxLength` is non-zero, a repeated start
+	 * follows and `rxLength` bytes are read into `rxData`. The transaction ends with a stop condition.
+	 *
+	 * @note The transaction and its buffers must remain valid until the callback has been invoked.
+	 */
+	struct Transaction {
+		/**
+		 * @brief Invoked in task context when the transaction has completed
+		 * @note Check `error` for the outcome
+		 */
+		using Callback = void (*)(Transaction& transaction);
+
+		uint8_t address{0};
+		const uint8_t* txData{nullptr};
+		size_t txLength{0};
+		uint8_t* rxData{nullptr};
+		size_t rxLength{0};
+		Callback callback{nullptr};
+		void* param{nullptr};		  ///< Application-defined value
+		Error error{I2C_ERR_SUCCESS}; ///< Result of transaction
+		Transaction* next{nullptr};	  ///< Used internally to link queued transactions
+		volatile bool busy{false};	  ///< Set whilst queued or in progress
+	};
+
 	TwoWire() : Stream()
 	{
 	}
@@ -108,6 +135,29 @@ public:
 	 */
 	uint8_t requestFrom(uint8_t address, uint8_t size, bool sendStop = true);
 
+	/**
+	 * @brief Queue a transaction for execution in the background
+	 * @param transaction At least one of `txLength` or `rxLength` must be non-zero
+	 * @retval bool false if transaction is already queued or empty
+	 *
+	 * Transactions are executed in the order queued.
+	 * Blocking methods such as `endTransmission()` must not be used whilst `isBusy()` returns true.
+	 *
+	 * On Esp32 and Rp2040 the hardware I2C controller is used, with the pins assigned
+	 * to it for the duration of each transaction.
+	 * Other architectures use the software implementation, advancing one byte per task callback
+	 * so that other tasks (such as the network stack) can run between bytes.
+	 */
+	bool queueTransaction(Transaction& transaction);
+
+	/**
+	 * @brief Determine if any asynchronous transactions are queued or in progress
+	 */
+	bool isBusy() const
+	{
+		return queueHead != nullptr;
+	}
+
 	/**
 	 * @brief Query bus status
 	 * @retval Status Indicates whether bus is available
@@ -142,6 +192,7 @@ private:
 	uint8_t twi_scl{DEFAULT_SCL_PIN};
 	uint8_t twi_dcount{18};
 	unsigned twi_clockStretchLimit{0};
+	uint32_t clockFrequency{100000};
 
 	uint8_t rxBuffer[BUFFER_LENGTH]{};
 	uint8_t rxBufferIndex{0};
@@ -167,6 +218,39 @@ private:
 	uint8_t twi_read_byte(bool nack);
 	Error twi_writeTo(uint8_t address, const uint8_t* buf, size_t len, bool sendStop);
 	Error twi_readFrom(uint8_t address, uint8_t* buf, size_t len, bool sendStop);
+
+	// Asynchronous transactions
+	void startNextTransaction();
+	void transactionComplete(Error error);
+	void serviceCompletion();
+	// Implemented for each architecture
+	bool startTransaction(Transaction& transaction);
+	void endTransaction(Transaction& transaction);
+#if defined(ARCH_ESP32)
+	static void asyncTask(void* param);
+	void* asyncHandle{nullptr}; ///< Task servicing the driver
+	uint32_t asyncFrequency{0};
+#elif defined(ARCH_RP2040)
+	static void asyncInterruptHandler();
+	void* asyncHandle{nullptr}; ///< Hardware instance in use
+	uint32_t asyncFrequency{0};
+#else
+	enum class AsyncState : uint8_t {
+		start,
+		write,
+		restart,
+		read,
+		stop,
+	};
+	void stepTransaction();
+	AsyncState asyncState{};
+#endif
+	size_t asyncTxOffset{0};
+	size_t asyncRxOffset{0};
+	size_t asyncCmdOffset{0};
+	Transaction* queueHead{nullptr};
+	Transaction* queueTail{nullptr};
+	bool asyncActive{false};
 };
 
 #if !defined(NO_GLOBAL_INSTANCES) && !defined(NO_GLOBAL_TWOWIRE)
@@ -0,0 +1,172 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * WireAsync.cpp - Queue management for asynchronous I2C transactions
+ *
+ * Transactions are started and completed in task context.
+ * Architecture code performs a single transaction, calling `transactionComplete()`
+ * (from interrupt context if required) when finished.
+ *
+ * Architectures without a hardware backend use the bit-banging primitives, performing
+ * one byte per task callback. A byte takes about 90us at 100kHz, so other tasks are
+ * delayed by no more than this instead of for the whole transaction.
+ *
+ ****/
+
+#include "Wire.h"
+#include <Platform/System.h>
+#include <debug_progmem.h>
+
+bool TwoWire::queueTransaction(Transaction& transaction)
+{
+	if(transaction.busy || (transaction.txLength == 0 && transaction.rxLength == 0)) {
+		return false;
+	}
+
+	transaction.next = nullptr;
+	transaction.error = I2C_ERR_SUCCESS;
+	transaction.busy = true;
+	if(queueHead == nullptr) {
+		queueHead = &transaction;
+	} else {
+		queueTail->next = &transaction;
+	}
+	queueTail = &transaction;
+
+	if(!asyncActive) {
+		startNextTransaction();
+	}
+	return true;
+}
+
+void TwoWire::startNextTransaction()
+{
+	while(!asyncActive && queueHead != nullptr) {
+		auto& trans = *queueHead;
+		asyncTxOffset = 0;
+		asyncRxOffset = 0;
+		asyncCmdOffset = 0;
+		asyncActive = true;
+		if(startTransaction(trans)) {
+			break;
+		}
+
+		debug_e("[TWI] Async transaction failed");
+		asyncActive = false;
+		queueHead = trans.next;
+		trans.error = I2C_ERR_LINE_BUSY;
+		trans.busy = false;
+		if(trans.callback != nullptr) {
+			trans.callback(trans);
+		}
+	}
+}
+
+void IRAM_ATTR TwoWire::transactionComplete(Error error)
+{
+	queueHead->error = error;
+	System.queueCallback([](void* param) { static_cast<TwoWire*>(param)->serviceCompletion(); }, this);
+}
+
+void TwoWire::serviceCompletion()
+{
+	if(!asyncActive || queueHead == nullptr) {
+		return;
+	}
+
+	auto& trans = *queueHead;
+	endTransaction(trans);
+	asyncActive = false;
+	queueHead = trans.next;
+	trans.next = nullptr;
+	trans.busy = false;
+
+	// Callback may queue further transactions
+	if(trans.callback != nullptr) {
+		trans.callback(trans);
+	}
+
+	startNextTransaction();
+}
+
+#if !defined(ARCH_ESP32) && !defined(ARCH_RP2040)
+
+bool TwoWire::startTransaction(Transaction&)
+{
+	asyncState = AsyncState::start;
+	stepTransaction();
+	return true;
+}
+
+void TwoWire::endTransaction(Transaction&)
+{
+}
+
+void TwoWire::stepTransaction()
+{
+	auto& trans = *queueHead;
+	Error error{I2C_ERR_SUCCESS};
+
+	switch(asyncState) {
+	case AsyncState::start:
+	case AsyncState::restart: {
+		if(!twi_write_start()) {
+			transactionComplete(I2C_ERR_LINE_BUSY);
+			return;
+		}
+		bool read = (asyncState == AsyncState::restart) || trans.txLength == 0;
+		if(!twi_write_byte((trans.address << 1) | (read ? 1 : 0))) {
+			error = I2C_ERR_ADDR_NACK;
+			asyncState = AsyncState::stop;
+		} else {
+			asyncState = read ? AsyncState::read : AsyncState::write;
+		}
+		break;
+	}
+
+	case AsyncState::write:
+		if(!twi_write_byte(trans.txData[asyncTxOffset++])) {
+			error = I2C_ERR_DATA_NACK;
+			asyncState = AsyncState::stop;
+		} else if(asyncTxOffset == trans.txLength) {
+			asyncState = (trans.rxLength == 0) ? AsyncState::stop : AsyncState::restart;
+		}
+		break;
+
+	case AsyncState::read: {
+		bool last = (asyncRxOffset + 1 == trans.rxLength);
+		trans.rxData[asyncRxOffset++] = twi_read_byte(last);
+		if(last) {
+			asyncState = AsyncState::stop;
+		}
+		break;
+	}
+
+	case AsyncState::stop:
+		twi_write_stop();
+		for(unsigned i = 0; SDA_READ() == 0 && i++ < 10;) {
+			SCL_LOW();
+			twi_delay(twi_dcount);
+			SCL_HIGH();
+			twi_delay(twi_dcount);
+		}
+		transactionComplete(trans.error);
+		return;
+	}
+
+	if(error != I2C_ERR_SUCCESS) {
+		// Reported once stop condition has been sent
+		trans.error = error;
+	}
+
+	auto callback = [](void* param) { static_cast<TwoWire*>(param)->stepTransaction(); };
+	if(!System.queueCallback(callback, this)) {
+		// Task queue is full: completing synchronously is better than stalling the bus
+		stepTransaction();
+	}
+}
+
+#endif
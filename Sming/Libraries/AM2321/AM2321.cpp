@@ -26,6 +26,7 @@
 
 #include "AM2321.h"
 #include <Wire.h>
+#include <Crypto/Crc.h>
 
 #define I2C_ADDR_AM2321                 (0xB8 >> 1)          //AM2321温湿度计I2C地址
 #define PARAM_AM2321_READ                0x03                //读寄存器命令
@@ -107,21 +108,7 @@ protected:
 
 private:
     unsigned short crc16(unsigned char *ptr, unsigned char len) {
-        unsigned short crc = 0xFFFF; 
-        unsigned char  i   = 0;
-        while(len--) {
-            crc ^= *ptr++; 
-            for(i = 0 ; i < 8 ; i++) {
-                if(crc & 0x01) {
-                    crc >>= 1;
-                    crc  ^= 0xA001; 
-                }
-                else {
-                    crc >>= 1;
-                } 
-            }
-        }
-        return crc; 
+        return Crypto::crc16Modbus(ptr, len);
     }
 };
 
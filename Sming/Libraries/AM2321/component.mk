@@ -0,0 +1 @@
+COMPONENT_DEPENDS := crypto
@@ -17,28 +17,67 @@
 
 #include "AnimatedGifTask.h"
 
-void draw(GIFDRAW* pDraw)
+AnimatedGifTask::AnimatedGifTask(Graphics::Surface& surface, const void* data, size_t length, bool inFlash)
+	: surface(surface)
+{
+	auto ptr = static_cast<uint8_t*>(const_cast<void*>(data));
+	if(inFlash) {
+		valid = gif.openFLASH(ptr, length, staticDraw);
+	} else {
+		valid = gif.open(ptr, length, staticDraw);
+	}
+}
+
+AnimatedGifTask::AnimatedGifTask(Graphics::Surface& surface, Storage::Partition partition, size_t length)
+	: surface(surface), partition(partition)
 {
-	auto surface = static_cast<Graphics::Surface*>(pDraw->pUser);
-	if(surface == nullptr) {
+	if(length == 0) {
+		length = partition.size();
+	}
+	mappedData = partition.map(0, length);
+	if(mappedData == nullptr) {
+		debug_e("[GIF] Cannot map partition '%s'", partition.name().c_str());
 		return;
 	}
+	// Mapped flash requires aligned reads so is handled as for PROGMEM data
+	valid = gif.openFLASH(static_cast<uint8_t*>(const_cast<void*>(mappedData)), length, staticDraw);
+}
 
-	const auto& tftSize = surface->getSize();
-	const int DISPLAY_WIDTH = tftSize.w;
-	const int DISPLAY_HEIGHT = tftSize.h;
+void AnimatedGifTask::staticDraw(GIFDRAW* pDraw)
+{
+	auto self = static_cast<AnimatedGifTask*>(pDraw->pUser);
+	if(self != nullptr) {
+		self->draw(pDraw);
+	}
+}
 
-	auto pixelFormat = surface->getPixelFormat();
-	auto bytesPerPixel = Graphics::getBytesPerPixel(pixelFormat);
+void AnimatedGifTask::flush()
+{
+	if(sliceRect.h == 0) {
+		return;
+	}
 
-	uint16_t usTemp[DISPLAY_WIDTH];
-	Graphics::SharedBuffer buffer(bytesPerPixel * DISPLAY_WIDTH);
+	auto bytesPerPixel = Graphics::getBytesPerPixel(surface.getPixelFormat());
+	surface.reset();
+	surface.setAddrWindow(sliceRect);
+	surface.writeDataBuffer(slice, 0, sliceRect.w * sliceRect.h * bytesPerPixel);
+	surface.present();
+
+	// Surface keeps a reference until sent, so start a new buffer
+	slice = Graphics::SharedBuffer{};
+	sliceRect = Graphics::Rect{};
+}
+
+void AnimatedGifTask::draw(GIFDRAW* pDraw)
+{
+	const auto& tftSize = surface.getSize();
+	const int DISPLAY_WIDTH = tftSize.w;
+	const int DISPLAY_HEIGHT = tftSize.h;
 
 	int iWidth = pDraw->iWidth;
 	if(iWidth + pDraw->iX > DISPLAY_WIDTH) {
 		iWidth = DISPLAY_WIDTH - pDraw->iX;
 	}
-	const uint16_t* usPalette = pDraw->pPalette;
 	int y = pDraw->iY + pDraw->y; // current line
 	if(y >= DISPLAY_HEIGHT || pDraw->iX >= DISPLAY_WIDTH || iWidth < 1) {
 		return;
@@ -55,84 +94,101 @@ void draw(GIFDRAW* pDraw)
 		pDraw->ucHasTransparency = 0;
 	}
 
-	// Apply the new pixels to the main image
-	if(pDraw->ucHasTransparency) // if transparency used
-	{
-		uint8_t ucTransparent = pDraw->ucTransparent;
-		uint8_t* pEnd = s + iWidth;
-		int x = 0;
-		int iCount = 0; // count non-transparent pixels
-		while(x < iWidth) {
-			uint8_t c = ucTransparent - 1;
-			uint16_t* d = usTemp;
-			while(c != ucTransparent && s < pEnd) {
-				c = *s++;
-				if(c == ucTransparent) {
-					// done, stop: back up to treat it like transparent
-					s--;
-				} else {
-					// opaque
-					*d++ = __builtin_bswap16(usPalette[c]);
-					iCount++;
-				}
-			}				// while looking for opaque pixels
-			if(iCount != 0) // any opaque pixels?
-			{
-				Graphics::convert(usTemp, Graphics::PixelFormat::RGB565, buffer.get(), pixelFormat, iCount);
-				Graphics::Rect r(pDraw->iX + x, y, iCount, 1);
-				surface->reset();
-				surface->setAddrWindow(r);
-				surface->writeDataBuffer(buffer, 0, iCount * bytesPerPixel);
-				surface->present();
-				x += iCount;
-				iCount = 0;
-			}
-			// no, look for a run of transparent pixels
-			c = ucTransparent;
-			while(c == ucTransparent && s < pEnd) {
-				c = *s++;
-				if(c == ucTransparent) {
-					iCount++;
-				} else {
-					s--;
-				}
-			}
-			if(iCount != 0) {
-				// skip these
-				x += iCount;
-				iCount = 0;
-			}
-		}
-	} else {
-		// No transparency
-		s = pDraw->pPixels;
-		// Translate the 8-bit pixels through the RGB565 palette (already byte reversed)
-		for(int x = 0; x < iWidth; x++) {
-			usTemp[x] = __builtin_bswap16(usPalette[*s++]);
-		}
-		Graphics::convert(usTemp, Graphics::PixelFormat::RGB565, buffer.get(), surface->getPixelFormat(), iWidth);
-		Graphics::Rect r(pDraw->iX, y, iWidth, 1);
-		surface->reset();
-		surface->setAddrWindow(r);
-		surface->writeDataBuffer(buffer, 0, iWidth * bytesPerPixel);
-		surface->present();
+	if(pDraw->ucHasTransparency) {
+		flush();
+		drawTransparent(pDraw, y, iWidth);
+		return;
+	}
+
+	// Append line to slice if it follows on from the previous one
+	if(sliceRect.h != 0 &&
+	   (sliceRect.x != pDraw->iX || sliceRect.w != iWidth || sliceRect.y + sliceRect.h != y)) {
+		flush();
+	}
+
+	auto pixelFormat = surface.getPixelFormat();
+	auto bytesPerPixel = Graphics::getBytesPerPixel(pixelFormat);
+	if(sliceRect.h == 0) {
+		slice = Graphics::SharedBuffer(bytesPerPixel * iWidth * linesPerSlice);
+		sliceRect = Graphics::Rect(pDraw->iX, y, iWidth, 0);
+	}
+
+	// Translate the 8-bit pixels through the RGB565 palette (already byte reversed)
+	uint16_t usTemp[iWidth];
+	const uint16_t* usPalette = pDraw->pPalette;
+	for(int x = 0; x < iWidth; x++) {
+		usTemp[x] = __builtin_bswap16(usPalette[*s++]);
+	}
+	auto dst = slice.get() + sliceRect.h * iWidth * bytesPerPixel;
+	Graphics::convert(usTemp, Graphics::PixelFormat::RGB565, dst, pixelFormat, iWidth);
+	++sliceRect.h;
+
+	if(sliceRect.h >= linesPerSlice) {
+		flush();
 	}
 }
 
-AnimatedGifTask::AnimatedGifTask(Graphics::Surface& surface, const void* data, size_t length, bool inFlash)
-	: surface(surface)
+void AnimatedGifTask::drawTransparent(GIFDRAW* pDraw, int y, int iWidth)
 {
-	auto ptr = static_cast<uint8_t*>(const_cast<void*>(data));
-	if(inFlash) {
-		gif.openFLASH(ptr, length, draw);
-	} else {
-		gif.open(ptr, length, draw);
+	auto pixelFormat = surface.getPixelFormat();
+	auto bytesPerPixel = Graphics::getBytesPerPixel(pixelFormat);
+
+	uint16_t usTemp[iWidth];
+	Graphics::SharedBuffer buffer(bytesPerPixel * iWidth);
+
+	const uint16_t* usPalette = pDraw->pPalette;
+	auto s = pDraw->pPixels;
+	uint8_t ucTransparent = pDraw->ucTransparent;
+	uint8_t* pEnd = s + iWidth;
+	int x = 0;
+	int iCount = 0; // count non-transparent pixels
+	while(x < iWidth) {
+		uint8_t c = ucTransparent - 1;
+		uint16_t* d = usTemp;
+		while(c != ucTransparent && s < pEnd) {
+			c = *s++;
+			if(c == ucTransparent) {
+				// done, stop: back up to treat it like transparent
+				s--;
+			} else {
+				// opaque
+				*d++ = __builtin_bswap16(usPalette[c]);
+				iCount++;
+			}
+		}				// while looking for opaque pixels
+		if(iCount != 0) // any opaque pixels?
+		{
+			Graphics::convert(usTemp, Graphics::PixelFormat::RGB565, buffer.get(), pixelFormat, iCount);
+			Graphics::Rect r(pDraw->iX + x, y, iCount, 1);
+			surface.reset();
+			surface.setAddrWindow(r);
+			surface.writeDataBuffer(buffer, 0, iCount * bytesPerPixel);
+			surface.present();
+			x += iCount;
+			iCount = 0;
+		}
+		// no, look for a run of transparent pixels
+		c = ucTransparent;
+		while(c == ucTransparent && s < pEnd) {
+			c = *s++;
+			if(c == ucTransparent) {
+				iCount++;
+			} else {
+				s--;
+			}
+		}
+		if(iCount != 0) {
+			// skip these
+			x += iCount;
+			iCount = 0;
+		}
 	}
 }
 
 void AnimatedGifTask::loop()
 {
-	gif.playFrame(true, nullptr, &surface);
+	gif.playFrame(true, nullptr, this);
+	flush();
 	// To slow frames down or reduce load...
 	// sleep(100);
 }
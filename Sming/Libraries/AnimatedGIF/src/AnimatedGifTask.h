@@ -20,10 +20,20 @@
 #include <Task.h>
 #include <AnimatedGIF.h>
 #include <Graphics/Surface.h>
+#include <Storage/Partition.h>
 
+/**
+ * @brief Plays an animated GIF to a display surface, one frame per task cycle
+ *
+ * Opaque lines are converted into a buffer holding several lines, which is sent to the display
+ * as a single transfer when full. A new buffer is then used for the following lines, so
+ * decoding continues whilst the display transfer is in progress.
+ */
 class AnimatedGifTask : public Task
 {
 public:
+	static constexpr uint8_t defaultLinesPerSlice{8};
+
 	AnimatedGifTask(Graphics::Surface& surface, const void* data, size_t length, bool inFlash);
 
 	AnimatedGifTask(Graphics::Surface& surface, const FSTR::ObjectBase& data)
@@ -31,15 +41,52 @@ public:
 	{
 	}
 
+	/**
+	 * @brief Play GIF stored in a partition, read directly via memory-mapped flash
+	 * @param surface
+	 * @param partition Partition content is the GIF file
+	 * @param length Size of GIF, 0 to use the partition size
+	 * @note Check `isValid()` as mapping may not be supported by the device
+	 */
+	AnimatedGifTask(Graphics::Surface& surface, Storage::Partition partition, size_t length = 0);
+
 	~AnimatedGifTask()
 	{
 		gif.close();
+		partition.unmap(mappedData);
+	}
+
+	bool isValid() const
+	{
+		return valid;
+	}
+
+	/**
+	 * @brief Set maximum number of lines to combine into one display transfer
+	 * @param lines Larger values reduce display overhead at the cost of RAM (lines * width * bytes per pixel)
+	 */
+	void setLinesPerSlice(uint8_t lines)
+	{
+		linesPerSlice = std::max(lines, uint8_t(1));
 	}
 
 protected:
 	void loop() override;
 
 private:
+	static void staticDraw(GIFDRAW* pDraw);
+	void draw(GIFDRAW* pDraw);
+	void drawTransparent(GIFDRAW* pDraw, int y, int width);
+	void flush();
+
 	AnimatedGIF gif;
 	Graphics::Surface& surface;
+	Storage::Partition partition;
+	const void* mappedData{nullptr};
+	bool valid{false};
+
+	// Current slice
+	Graphics::SharedBuffer slice;
+	Graphics::Rect sliceRect;
+	uint8_t linesPerSlice{defaultLinesPerSlice};
 };
@@ -0,0 +1,128 @@
+#!/usr/bin/env python3
+#
+# Build an ArchiveFS image
+#
+# Layout is described in src/include/IFS/ArchiveFS/Format.h.
+# Entries are sorted by path so the filesystem can locate files using a binary search.
+#
+
+import argparse
+import gzip
+import hashlib
+import os
+import struct
+import sys
+import time
+
+IMAGE_MAGIC = 0x53465241  # "ARFS"
+IMAGE_VERSION = 1
+HEADER_FORMAT = '<IHHIIIIII'
+ENTRY_FORMAT = '<IHBBIIII'
+MAX_PATH_LENGTH = 255
+
+COMPRESSION_NONE = 0
+COMPRESSION_GZIP = 1
+
+# Content which does not benefit from further compression
+COMPRESSED_TYPES = ('.gz', '.zip', '.png', '.jpg', '.jpeg', '.gif', '.webp', '.woff', '.woff2', '.mp3', '.bin')
+
+# Compressed content must be at least this much smaller to be used
+MIN_COMPRESSION_RATIO = 0.9
+
+
+def align_up(value, alignment):
+    return (value + alignment - 1) & ~(alignment - 1)
+
+
+def scan(source_dir):
+    files = []
+    for root, dirs, names in os.walk(source_dir):
+        for name in names:
+            if name.startswith('.'):
+                continue
+            path = os.path.join(root, name)
+            files.append((os.path.relpath(path, source_dir).replace(os.sep, '/'), path))
+    # Byte-wise order, as used by the filesystem
+    files.sort(key=lambda f: f[0].encode())
+    return files
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Build ArchiveFS image')
+    parser.add_argument('--align', type=int, default=16, help='Alignment for file content, power of 2')
+    parser.add_argument('--compress', action='store_true', help='Store files gzip-compressed where worthwhile')
+    parser.add_argument('--size', type=lambda s: int(s, 0), help='Fail if image exceeds this size')
+    parser.add_argument('source', help='Directory containing files, may be empty')
+    parser.add_argument('output', help='Image file to write')
+    args = parser.parse_args()
+
+    if args.align < 4 or args.align & (args.align - 1):
+        sys.exit("Alignment must be a power of 2, at least 4")
+
+    files = scan(args.source) if args.source else []
+
+    entries = []
+    names = b''
+    for name, path in files:
+        encoded = name.encode()
+        if len(encoded) > MAX_PATH_LENGTH:
+            sys.exit("Path too long: '%s'" % name)
+        with open(path, 'rb') as f:
+            data = f.read()
+        original_size = len(data)
+        compression = COMPRESSION_NONE
+        if args.compress and not name.lower().endswith(COMPRESSED_TYPES):
+            compressed = gzip.compress(data, 9, mtime=0)
+            if len(compressed) < original_size * MIN_COMPRESSION_RATIO:
+                data = compressed
+                compression = COMPRESSION_GZIP
+        entries.append({
+            'name_offset': len(names),
+            'name_length': len(encoded),
+            'compression': compression,
+            'data': data,
+            'original_size': original_size,
+            'mtime': int(os.path.getmtime(path)),
+        })
+        names += encoded
+
+    header_size = struct.calcsize(HEADER_FORMAT)
+    names_offset = header_size + len(entries) * struct.calcsize(ENTRY_FORMAT)
+    data_offset = align_up(names_offset + len(names), args.align)
+
+    offset = data_offset
+    content = b''
+    for e in entries:
+        e['data_offset'] = offset
+        padded = align_up(len(e['data']), args.align)
+        content += e['data'] + b'\xff' * (padded - len(e['data']))
+        offset += padded
+    image_size = offset
+
+    table = b''
+    for e in entries:
+        table += struct.pack(ENTRY_FORMAT, names_offset + e['name_offset'], e['name_length'], e['compression'], 0,
+                             e['data_offset'], len(e['data']), e['original_size'], e['mtime'])
+
+    body = table + names
+    body += b'\xff' * (data_offset - header_size - len(body)) + content
+    volume_id = struct.unpack('<I', hashlib.sha1(body).digest()[:4])[0]
+    header = struct.pack(HEADER_FORMAT, IMAGE_MAGIC, IMAGE_VERSION, args.align, len(entries), names_offset,
+                         data_offset, image_size, volume_id, int(time.time()))
+    image = header + body
+    assert len(image) == image_size
+
+    if args.size is not None and image_size > args.size:
+        sys.exit("Image size %u exceeds partition size %u" % (image_size, args.size))
+
+    os.makedirs(os.path.dirname(os.path.abspath(args.output)), exist_ok=True)
+    with open(args.output, 'wb') as f:
+        f.write(image)
+
+    stored = sum(len(e['data']) for e in entries)
+    original = sum(e['original_size'] for e in entries)
+    print("ArchiveFS: %u files, %u -> %u bytes, image %u bytes" % (len(entries), original, stored, image_size))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,29 @@
+## ArchiveFS library
+COMPONENT_DEPENDS		:= IFS
+COMPONENT_SRCDIRS		:= src
+COMPONENT_INCDIRS		:= src/include
+COMPONENT_DOXYGEN_INPUT	:= src/include
+
+COMPONENT_RELINK_VARS	+= ARCHIVEFS_MAX_OPEN_FILES
+ARCHIVEFS_MAX_OPEN_FILES	?= 8
+COMPONENT_CXXFLAGS		+= -DARCHIVEFS_MAX_OPEN_FILES=$(ARCHIVEFS_MAX_OPEN_FILES)
+
+##@Building
+
+# Image generation tool
+ARCHIVEFS_GEN := $(PYTHON) $(COMPONENT_PATH)/archivefs.py
+
+HWCONFIG_BUILDSPECS += $(COMPONENT_PATH)/build.json
+
+# Target invoked via partition table
+ifneq (,$(filter archivefs,$(MAKECMDGOALS)))
+PART_TARGET := $(PARTITION_$(PART)_FILENAME)
+$(eval PART_FILES := $(call HwExpr,part.build['files']))
+$(eval PART_COMPRESS := $(call HwExpr,part.build.get('compress', False)))
+.PHONY: archivefs
+archivefs:
+ifneq (,$(PART_TARGET))
+	@echo "Creating ArchiveFS image '$(PART_TARGET)'"
+	$(Q) $(ARCHIVEFS_GEN) $(if $(filter True,$(PART_COMPRESS)),--compress) --size=$(PARTITION_$(PART)_SIZE_BYTES) "$(or $(PART_FILES),)" $(PART_TARGET)
+endif
+endif
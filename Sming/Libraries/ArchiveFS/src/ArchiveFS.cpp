@@ -0,0 +1,36 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * ArchiveFS.cpp
+ *
+ ****/
+
+#include "include/ArchiveFS.h"
+#include "include/IFS/ArchiveFS/FileSystem.h"
+#include <FileSystem.h>
+#include <Storage.h>
+
+namespace IFS
+{
+FileSystem* createArchiveFilesystem(Storage::Partition partition)
+{
+	auto fs = new ArchiveFS::FileSystem(partition);
+	return FileSystem::cast(fs);
+}
+
+} // namespace IFS
+
+bool archivefs_mount()
+{
+	auto part = Storage::findDefaultPartition(Storage::Partition::SubType::Data::archivefs);
+	return part ? archivefs_mount(part) : false;
+}
+
+bool archivefs_mount(Storage::Partition partition)
+{
+	auto fs = IFS::createArchiveFilesystem(partition);
+	return fileMountFileSystem(fs);
+}
@@ -0,0 +1,625 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * FileSystem.cpp
+ *
+ ****/
+
+#include "include/IFS/ArchiveFS/FileSystem.h"
+#include <IFS/Util.h>
+#include <FakePgmSpace.h>
+
+namespace IFS
+{
+namespace ArchiveFS
+{
+#define CHECK_MOUNTED()                                                                                                \
+	if(!mounted) {                                                                                                     \
+		return Error::NotMounted;                                                                                      \
+	}
+
+#define GET_OPENFILE()                                                                                                 \
+	CHECK_MOUNTED()                                                                                                    \
+	auto f = getFile(file);                                                                                            \
+	if(f == nullptr) {                                                                                                 \
+		return Error::InvalidHandle;                                                                                   \
+	}
+
+#define GET_FILEDIR()                                                                                                  \
+	CHECK_MOUNTED()                                                                                                    \
+	auto d = reinterpret_cast<FileDir*>(dir);                                                                          \
+	if(d == nullptr) {                                                                                                 \
+		return Error::InvalidHandle;                                                                                   \
+	}
+
+struct FileDir {
+	uint16_t prefixLength; ///< Includes trailing '/', 0 for root
+	uint32_t start;		   ///< First entry with prefix
+	uint32_t next;		   ///< Next entry to read
+	char prefix[maxPathLength + 1];
+};
+
+namespace
+{
+bool isPowerOfTwo(uint32_t value)
+{
+	return value != 0 && (value & (value - 1)) == 0;
+}
+
+// Trailing separator is not significant
+size_t pathLength(const char* path)
+{
+	auto len = strlen(path);
+	while(len != 0 && path[len - 1] == '/') {
+		--len;
+	}
+	return len;
+}
+
+} // namespace
+
+FileSystem::~FileSystem()
+{
+	partition.unmap(mapped);
+}
+
+int FileSystem::mount()
+{
+	if(!partition) {
+		return Error::NoPartition;
+	}
+
+	if(!partition.verify(Storage::Partition::SubType::Data::archivefs)) {
+		return Error::BadPartition;
+	}
+
+	partition.unmap(mapped);
+	mapped = nullptr;
+	mounted = false;
+
+	if(!partition.read(0, &header, sizeof(header))) {
+		return Error::ReadFailure;
+	}
+
+	uint64_t tableEnd = sizeof(header) + uint64_t(header.entryCount) * sizeof(Entry);
+	if(header.magic != imageMagic || header.version != imageVersion || !isPowerOfTwo(header.alignment) ||
+	   tableEnd > header.namesOffset || header.namesOffset > header.dataOffset ||
+	   header.dataOffset > header.imageSize || header.imageSize > partition.size()) {
+		debug_e("[ARFS] Bad image in '%s'", partition.name().c_str());
+		header = ImageHeader{};
+		return Error::BadFileSystem;
+	}
+
+	// Optional: reads fall back to partition access
+	mapped = static_cast<const uint8_t*>(partition.map(0, header.imageSize));
+
+	memset(files, 0, sizeof(files));
+	mounted = true;
+	debug_i("[ARFS] %u files, %smapped", header.entryCount, mapped ? "" : "not ");
+	return FS_OK;
+}
+
+bool FileSystem::readImage(uint32_t offset, void* buffer, size_t size)
+{
+	if(uint64_t(offset) + size > header.imageSize) {
+		return false;
+	}
+
+	if(mapped != nullptr) {
+		memcpy_P(buffer, &mapped[offset], size);
+	} else if(!partition.read(offset, buffer, size)) {
+		return false;
+	}
+
+	if(profiler != nullptr) {
+		profiler->read(offset, buffer, size);
+	}
+	return true;
+}
+
+bool FileSystem::readEntry(uint32_t index, Entry& entry)
+{
+	if(index >= header.entryCount) {
+		return false;
+	}
+	if(!readImage(sizeof(header) + index * sizeof(Entry), &entry, sizeof(entry))) {
+		return false;
+	}
+	return entry.nameLength <= maxPathLength && entry.nameOffset >= header.namesOffset &&
+		   uint64_t(entry.dataOffset) + entry.size <= header.imageSize;
+}
+
+int FileSystem::readName(const Entry& entry, char* buffer)
+{
+	return readImage(entry.nameOffset, buffer, entry.nameLength) ? entry.nameLength : Error::ReadFailure;
+}
+
+int FileSystem::compare(const Entry& entry, const char* path, size_t length)
+{
+	char name[maxPathLength];
+	int len = readName(entry, name);
+	if(len < 0) {
+		return 1;
+	}
+	int cmp = memcmp(name, path, std::min(size_t(len), length));
+	return (cmp != 0) ? cmp : len - int(length);
+}
+
+uint32_t FileSystem::lowerBound(const char* path, size_t length)
+{
+	uint32_t lo{0};
+	uint32_t hi{header.entryCount};
+	while(lo < hi) {
+		uint32_t mid = lo + (hi - lo) / 2;
+		Entry entry;
+		if(!readEntry(mid, entry)) {
+			return header.entryCount;
+		}
+		if(compare(entry, path, length) < 0) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	return lo;
+}
+
+int FileSystem::find(const char* path, Entry& entry)
+{
+	auto len = strlen(path);
+	if(len > maxPathLength) {
+		return Error::NameTooLong;
+	}
+	auto index = lowerBound(path, len);
+	if(!readEntry(index, entry) || compare(entry, path, len) != 0) {
+		return Error::NotFound;
+	}
+	return index;
+}
+
+bool FileSystem::isDirectory(const char* path)
+{
+	char key[maxPathLength + 1];
+	auto len = pathLength(path);
+	if(len >= maxPathLength) {
+		return false;
+	}
+	memcpy(key, path, len);
+	key[len++] = '/';
+
+	Entry entry;
+	char name[maxPathLength];
+	if(!readEntry(lowerBound(key, len), entry) || readName(entry, name) < int(len)) {
+		return false;
+	}
+	return memcmp(name, key, len) == 0;
+}
+
+void FileSystem::fillStat(Stat& stat, uint32_t index, const Entry& entry, const char* name, size_t nameLength)
+{
+	stat = Stat{};
+	stat.fs = this;
+	stat.name.copy(name, nameLength);
+	stat.id = index + 1;
+	stat.size = entry.size;
+	stat.mtime = entry.mtime;
+	stat.attr += FileAttribute::ReadOnly;
+	if(entry.compression == EntryCompression::gzip) {
+		stat.compression.type = Compression::Type::GZip;
+		stat.compression.originalSize = entry.originalSize;
+	}
+	checkStat(stat);
+}
+
+FileSystem::OpenFile* FileSystem::getFile(FileHandle file)
+{
+	unsigned i = unsigned(file - handleMin);
+	if(i >= ARCHIVEFS_MAX_OPEN_FILES || !files[i].inUse) {
+		return nullptr;
+	}
+	return &files[i];
+}
+
+int FileSystem::getinfo(Info& info)
+{
+	info.clear();
+	info.partition = partition;
+	// No IFS type code is assigned for this format
+	info.type = Type::Unknown;
+	info.maxNameLength = maxPathLength;
+	info.maxPathLength = maxPathLength;
+	info.attr |= Attribute::ReadOnly;
+
+	if(mounted) {
+		info.volumeID = header.volumeId;
+		info.volumeSize = header.imageSize;
+		info.attr |= Attribute::Mounted;
+	}
+
+	return FS_OK;
+}
+
+int FileSystem::setProfiler(IProfiler* profiler)
+{
+	this->profiler = profiler;
+	return FS_OK;
+}
+
+int FileSystem::opendir(const char* path, DirHandle& dir)
+{
+	CHECK_MOUNTED()
+
+	auto d = new FileDir{};
+	if(d == nullptr) {
+		return Error::NoMem;
+	}
+
+	if(!isRootPath(path)) {
+		auto len = pathLength(path);
+		if(len >= maxPathLength) {
+			delete d;
+			return Error::NameTooLong;
+		}
+		if(!isDirectory(path)) {
+			delete d;
+			return Error::NotFound;
+		}
+		memcpy(d->prefix, path, len);
+		d->prefix[len++] = '/';
+		d->prefixLength = len;
+		d->start = lowerBound(d->prefix, len);
+	}
+
+	d->next = d->start;
+	dir = DirHandle(d);
+	return FS_OK;
+}
+
+int FileSystem::rewinddir(DirHandle dir)
+{
+	GET_FILEDIR()
+
+	d->next = d->start;
+	return FS_OK;
+}
+
+int FileSystem::readdir(DirHandle dir, Stat& stat)
+{
+	GET_FILEDIR()
+
+	if(d->next >= header.entryCount) {
+		return Error::NoMoreFiles;
+	}
+
+	Entry entry;
+	char name[maxPathLength + 1];
+	if(!readEntry(d->next, entry) || readName(entry, name) < 0) {
+		return Error::ReadFailure;
+	}
+
+	// Entries sharing a prefix are contiguous
+	if(entry.nameLength <= d->prefixLength || memcmp(name, d->prefix, d->prefixLength) != 0) {
+		d->next = header.entryCount;
+		return Error::NoMoreFiles;
+	}
+
+	auto child = &name[d->prefixLength];
+	size_t childLength = entry.nameLength - d->prefixLength;
+	auto sep = static_cast<char*>(memchr(child, '/', childLength));
+	if(sep == nullptr) {
+		fillStat(stat, d->next, entry, child, childLength);
+		++d->next;
+		return FS_OK;
+	}
+
+	// Sub-directory: its entries end where the name followed by '0' (after '/') would be
+	childLength = sep - child;
+	*sep = '/' + 1;
+	d->next = lowerBound(name, d->prefixLength + childLength + 1);
+
+	stat = Stat{};
+	stat.fs = this;
+	stat.name.copy(child, childLength);
+	stat.attr += FileAttribute::Directory;
+	stat.attr += FileAttribute::ReadOnly;
+	return FS_OK;
+}
+
+int FileSystem::closedir(DirHandle dir)
+{
+	GET_FILEDIR()
+
+	delete d;
+	return FS_OK;
+}
+
+int FileSystem::mkdir(const char*)
+{
+	return Error::ReadOnly;
+}
+
+int FileSystem::stat(const char* path, Stat* stat)
+{
+	CHECK_MOUNTED()
+
+	if(isRootPath(path)) {
+		if(stat != nullptr) {
+			*stat = Stat{};
+			stat->fs = this;
+			stat->attr += FileAttribute::Directory;
+			stat->attr += FileAttribute::ReadOnly;
+		}
+		return FS_OK;
+	}
+
+	auto name = strrchr(path, '/');
+	name = (name == nullptr) ? path : name + 1;
+
+	Entry entry;
+	int index = find(path, entry);
+	if(index >= 0) {
+		if(stat != nullptr) {
+			fillStat(*stat, index, entry, name, strlen(name));
+		}
+		return FS_OK;
+	}
+
+	if(index != Error::NotFound || !isDirectory(path)) {
+		return index;
+	}
+
+	if(stat != nullptr) {
+		*stat = Stat{};
+		stat->fs = this;
+		stat->name.copy(name);
+		stat->attr += FileAttribute::Directory;
+		stat->attr += FileAttribute::ReadOnly;
+	}
+	return FS_OK;
+}
+
+int FileSystem::fstat(FileHandle file, Stat* stat)
+{
+	GET_OPENFILE()
+
+	if(stat != nullptr) {
+		char name[maxPathLength];
+		int len = readName(f->entry, name);
+		if(len < 0) {
+			return len;
+		}
+		int start = len;
+		while(start > 0 && name[start - 1] != '/') {
+			--start;
+		}
+		fillStat(*stat, f->index, f->entry, &name[start], len - start);
+	}
+	return FS_OK;
+}
+
+int FileSystem::fsetxattr(FileHandle, AttributeTag, const void*, size_t)
+{
+	return Error::ReadOnly;
+}
+
+int FileSystem::fgetxattr(FileHandle, AttributeTag, void*, size_t)
+{
+	return Error::NotSupported;
+}
+
+int FileSystem::fenumxattr(FileHandle file, AttributeEnumCallback, void*, size_t)
+{
+	CHECK_MOUNTED()
+
+	// No attributes are stored
+	return getFile(file) ? 0 : Error::InvalidHandle;
+}
+
+int FileSystem::setxattr(const char*, AttributeTag, const void*, size_t)
+{
+	return Error::ReadOnly;
+}
+
+int FileSystem::getxattr(const char*, AttributeTag, void*, size_t)
+{
+	return Error::NotSupported;
+}
+
+FileHandle FileSystem::open(const char* path, OpenFlags flags)
+{
+	CHECK_MOUNTED()
+
+	if(isRootPath(path)) {
+		return Error::BadParam;
+	}
+
+	if(flags[OpenFlag::Write] || flags[OpenFlag::Create] || flags[OpenFlag::Truncate] || flags[OpenFlag::Append]) {
+		return Error::ReadOnly;
+	}
+
+	unsigned slot;
+	for(slot = 0; slot < ARCHIVEFS_MAX_OPEN_FILES; ++slot) {
+		if(!files[slot].inUse) {
+			break;
+		}
+	}
+	if(slot == ARCHIVEFS_MAX_OPEN_FILES) {
+		return Error::OutOfFileDescs;
+	}
+
+	auto& f = files[slot];
+	int index = find(path, f.entry);
+	if(index < 0) {
+		debug_ifserr(index, "open('%s')", path);
+		return index;
+	}
+
+	f.index = index;
+	f.pos = 0;
+	f.inUse = true;
+	return handleMin + slot;
+}
+
+int FileSystem::close(FileHandle file)
+{
+	GET_OPENFILE()
+
+	f->inUse = false;
+	return FS_OK;
+}
+
+int FileSystem::read(FileHandle file, void* data, size_t size)
+{
+	GET_OPENFILE()
+
+	size = std::min(size, size_t(f->entry.size - f->pos));
+	if(size == 0) {
+		return 0;
+	}
+	if(!readImage(f->entry.dataOffset + f->pos, data, size)) {
+		return Error::ReadFailure;
+	}
+	f->pos += size;
+	return size;
+}
+
+int FileSystem::write(FileHandle, const void*, size_t)
+{
+	return Error::ReadOnly;
+}
+
+file_offset_t FileSystem::lseek(FileHandle file, file_offset_t offset, SeekOrigin origin)
+{
+	GET_OPENFILE()
+
+	int64_t pos{offset};
+	switch(origin) {
+	case SeekOrigin::Start:
+		break;
+	case SeekOrigin::Current:
+		pos += f->pos;
+		break;
+	case SeekOrigin::End:
+		pos += f->entry.size;
+		break;
+	default:
+		return Error::BadParam;
+	}
+
+	if(pos < 0 || pos > f->entry.size) {
+		return Error::SeekBounds;
+	}
+
+	f->pos = pos;
+	return pos;
+}
+
+int FileSystem::eof(FileHandle file)
+{
+	GET_OPENFILE()
+
+	return (f->pos >= f->entry.size) ? 1 : 0;
+}
+
+file_offset_t FileSystem::tell(FileHandle file)
+{
+	GET_OPENFILE()
+
+	return f->pos;
+}
+
+int FileSystem::ftruncate(FileHandle, file_size_t)
+{
+	return Error::ReadOnly;
+}
+
+int FileSystem::flush(FileHandle file)
+{
+	GET_OPENFILE()
+
+	// Nothing to write
+	(void)f;
+	return FS_OK;
+}
+
+int FileSystem::fgetextents(FileHandle file, Storage::Partition* part, Extent* list, uint16_t extcount)
+{
+	GET_OPENFILE()
+
+	if(part != nullptr) {
+		*part = partition;
+	}
+
+	if(f->entry.size == 0) {
+		return 0;
+	}
+
+	if(list != nullptr && extcount != 0) {
+		list[0] = Extent{
+			.offset = f->entry.dataOffset,
+			.length = f->entry.size,
+			.skip = 0,
+		};
+	}
+	return 1;
+}
+
+const void* FileSystem::map(FileHandle file)
+{
+	auto f = getFile(file);
+	if(f == nullptr || mapped == nullptr) {
+		return nullptr;
+	}
+	return &mapped[f->entry.dataOffset];
+}
+
+int FileSystem::rename(const char*, const char*)
+{
+	return Error::ReadOnly;
+}
+
+int FileSystem::remove(const char*)
+{
+	return Error::ReadOnly;
+}
+
+int FileSystem::fremove(FileHandle)
+{
+	return Error::ReadOnly;
+}
+
+int FileSystem::format()
+{
+	return Error::ReadOnly;
+}
+
+int FileSystem::check()
+{
+	CHECK_MOUNTED()
+
+	// Entries must be sorted and all content within image
+	char prev[maxPathLength];
+	int prevLength{-1};
+	for(uint32_t i = 0; i < header.entryCount; ++i) {
+		Entry entry;
+		char name[maxPathLength];
+		if(!readEntry(i, entry) || readName(entry, name) < 0) {
+			return Error::BadFileSystem;
+		}
+		if(prevLength >= 0) {
+			int cmp = memcmp(prev, name, std::min(prevLength, int(entry.nameLength)));
+			if(cmp > 0 || (cmp == 0 && prevLength >= entry.nameLength)) {
+				return Error::BadFileSystem;
+			}
+		}
+		memcpy(prev, name, entry.nameLength);
+		prevLength = entry.nameLength;
+	}
+	return FS_OK;
+}
+
+} // namespace ArchiveFS
+} // namespace IFS
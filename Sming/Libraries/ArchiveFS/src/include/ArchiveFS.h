@@ -0,0 +1,34 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * ArchiveFS.h
+ *
+ ****/
+#pragma once
+
+#include <IFS/FileSystem.h>
+
+namespace IFS
+{
+/**
+ * @brief Create a read-only ArchiveFS filesystem
+ * @param partition
+ * @retval FileSystem* constructed filesystem object
+ */
+FileSystem* createArchiveFilesystem(Storage::Partition partition);
+
+} // namespace IFS
+
+/**
+ * @brief Mount the first available ArchiveFS volume
+ * @retval bool true on success
+ */
+bool archivefs_mount();
+
+/**
+ * @brief Mount ArchiveFS volume from a specific partition
+ */
+bool archivefs_mount(Storage::Partition partition);
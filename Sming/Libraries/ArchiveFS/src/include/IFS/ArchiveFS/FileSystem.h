@@ -0,0 +1,143 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * FileSystem.h - Read-only IFS implementation for ArchiveFS images
+ *
+ * The volume consists of a sorted table of entries followed by contiguous file data,
+ * so no scanning is required:
+ *
+ *	Lookups
+ *
+ *		File open and stat perform a binary search of the entry table.
+ *		Directories are implied by paths so are found the same way.
+ *		Only the image header is held in RAM.
+ *
+ *	Reads
+ *
+ *		Each file is stored in a single extent, so reads are a single partition access.
+ *		If the partition can be memory-mapped this is a straight copy, and `map()` provides
+ *		a pointer to file content for zero-copy access.
+ *
+ *	Compression
+ *
+ *		Files may be stored gzip-compressed. As with FWFS, content is returned as stored
+ *		and `Stat::compression` describes it, so for example HttpResponse::sendFile()
+ *		can serve it directly with the appropriate `Content-Encoding`.
+ *
+ ****/
+
+#pragma once
+
+#include <IFS/IFileSystem.h>
+#include "Format.h"
+
+/**
+ * @brief Maximum number of files which may be open at once
+ */
+#ifndef ARCHIVEFS_MAX_OPEN_FILES
+#define ARCHIVEFS_MAX_OPEN_FILES 8
+#endif
+
+namespace IFS
+{
+namespace ArchiveFS
+{
+class FileSystem : public IFileSystem
+{
+public:
+	FileSystem(Storage::Partition partition) : partition(partition)
+	{
+	}
+
+	~FileSystem();
+
+	int mount() override;
+	int getinfo(Info& info) override;
+	int setProfiler(IProfiler* profiler) override;
+	int opendir(const char* path, DirHandle& dir) override;
+	int readdir(DirHandle dir, Stat& stat) override;
+	int rewinddir(DirHandle dir) override;
+	int closedir(DirHandle dir) override;
+	int mkdir(const char* path) override;
+	int stat(const char* path, Stat* stat) override;
+	int fstat(FileHandle file, Stat* stat) override;
+	int fsetxattr(FileHandle file, AttributeTag tag, const void* data, size_t size) override;
+	int fgetxattr(FileHandle file, AttributeTag tag, void* buffer, size_t size) override;
+	int fenumxattr(FileHandle file, AttributeEnumCallback callback, void* buffer, size_t bufsize) override;
+	int setxattr(const char* path, AttributeTag tag, const void* data, size_t size) override;
+	int getxattr(const char* path, AttributeTag tag, void* buffer, size_t size) override;
+	FileHandle open(const char* path, OpenFlags flags) override;
+	int close(FileHandle file) override;
+	int read(FileHandle file, void* data, size_t size) override;
+	int write(FileHandle file, const void* data, size_t size) override;
+	file_offset_t lseek(FileHandle file, file_offset_t offset, SeekOrigin origin) override;
+	int eof(FileHandle file) override;
+	file_offset_t tell(FileHandle file) override;
+	int ftruncate(FileHandle file, file_size_t new_size) override;
+	int flush(FileHandle file) override;
+	int fgetextents(FileHandle file, Storage::Partition* part, Extent* list, uint16_t extcount) override;
+	int rename(const char* oldpath, const char* newpath) override;
+	int remove(const char* path) override;
+	int fremove(FileHandle file) override;
+	int format() override;
+	int check() override;
+
+	/**
+	 * @brief Get pointer to file content, as stored
+	 * @param file
+	 * @retval const void* nullptr if partition cannot be memory-mapped
+	 * @note The pointer remains valid until the filesystem is destroyed.
+	 * Content size is given by `fstat()`.
+	 * On Esp8266 mapped flash must be read using aligned 32-bit accesses, e.g. `memcpy_P`.
+	 */
+	const void* map(FileHandle file);
+
+	/**
+	 * @brief Determine if file content is accessed via memory mapping
+	 */
+	bool isMapped() const
+	{
+		return mapped != nullptr;
+	}
+
+	/**
+	 * @brief Get number of files in the volume
+	 */
+	uint32_t getFileCount() const
+	{
+		return header.entryCount;
+	}
+
+private:
+	struct OpenFile {
+		Entry entry;
+		uint32_t index;
+		uint32_t pos;
+		bool inUse;
+	};
+
+	bool readImage(uint32_t offset, void* buffer, size_t size);
+	bool readEntry(uint32_t index, Entry& entry);
+	int readName(const Entry& entry, char* buffer);
+	int compare(const Entry& entry, const char* path, size_t length);
+	uint32_t lowerBound(const char* path, size_t length);
+	int find(const char* path, Entry& entry);
+	bool isDirectory(const char* path);
+	void fillStat(Stat& stat, uint32_t index, const Entry& entry, const char* name, size_t nameLength);
+	OpenFile* getFile(FileHandle file);
+
+	static constexpr FileHandle handleMin{200};
+
+	Storage::Partition partition;
+	IProfiler* profiler{nullptr};
+	const uint8_t* mapped{nullptr};
+	ImageHeader header{};
+	OpenFile files[ARCHIVEFS_MAX_OPEN_FILES]{};
+	bool mounted{false};
+};
+
+} // namespace ArchiveFS
+} // namespace IFS
@@ -0,0 +1,67 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * Format.h - ArchiveFS image layout, as written by archivefs.py
+ *
+ * All values are little-endian.
+ *
+ *   Header
+ *   Entry[entryCount]   Sorted by path, byte-wise
+ *   Names               Paths, not NUL-terminated
+ *   File data           Each file starts on an `alignment` boundary
+ *
+ ****/
+
+#pragma once
+
+#include <cstdint>
+
+namespace IFS
+{
+namespace ArchiveFS
+{
+constexpr uint32_t imageMagic{0x53465241}; // "ARFS"
+constexpr uint16_t imageVersion{1};
+
+/**
+ * @brief Longest path which may be stored
+ */
+constexpr uint16_t maxPathLength{255};
+
+struct ImageHeader {
+	uint32_t magic;
+	uint16_t version;
+	uint16_t alignment;   ///< File data alignment
+	uint32_t entryCount;  ///< Number of files
+	uint32_t namesOffset; ///< Offset of path strings from start of image
+	uint32_t dataOffset;  ///< Offset of first file content
+	uint32_t imageSize;	  ///< Total size of image
+	uint32_t volumeId;	  ///< Derived from content
+	uint32_t mtime;		  ///< When image was built
+};
+
+static_assert(sizeof(ImageHeader) == 32, "Bad ImageHeader size");
+
+enum class EntryCompression : uint8_t {
+	none,
+	gzip,
+};
+
+struct Entry {
+	uint32_t nameOffset; ///< Offset of path from start of image
+	uint16_t nameLength;
+	EntryCompression compression;
+	uint8_t reserved;
+	uint32_t dataOffset;   ///< Offset of content from start of image
+	uint32_t size;		   ///< Size of content as stored
+	uint32_t originalSize; ///< Size before compression
+	uint32_t mtime;
+};
+
+static_assert(sizeof(Entry) == 24, "Bad Entry size");
+
+} // namespace ArchiveFS
+} // namespace IFS
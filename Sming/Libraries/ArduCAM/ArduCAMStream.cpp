@@ -6,132 +6,255 @@
  */
 
 #include "ArduCAMStream.h"
+#include <debug_progmem.h>
 
-// Set generic spiffs debug output call.
 #ifndef ACAM_DEBUG
-#define ACAM_DEBUG(...)  // Serial.printf(__VA_ARGS__)
+#define ACAM_DEBUG(...) // Serial.printf(__VA_ARGS__)
 #endif
-#define ACAM_HDUMP
 
 #define BMPIMAGEOFFSET 66
 
-const uint8_t bmp_header[BMPIMAGEOFFSET] =
+namespace
 {
-  0x42, 0x4D, 0x36, 0x58, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x42, 0x00, 0x00, 0x00, 0x28, 0x00,
-  0x00, 0x00, 0x40, 0x01, 0x00, 0x00, 0xF0, 0x00, 0x00, 0x00, 0x01, 0x00, 0x10, 0x00, 0x03, 0x00,
-  0x00, 0x00, 0x00, 0x58, 0x02, 0x00, 0xC4, 0x0E, 0x00, 0x00, 0xC4, 0x0E, 0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF8, 0x00, 0x00, 0xE0, 0x07, 0x00, 0x00, 0x1F, 0x00,
-  0x00, 0x00
+const uint8_t bmp_header[BMPIMAGEOFFSET] PROGMEM = {
+	0x42, 0x4D, 0x36, 0x58, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x42, 0x00, 0x00, 0x00, 0x28, 0x00, 0x00,
+	0x00, 0x40, 0x01, 0x00, 0x00, 0xF0, 0x00, 0x00, 0x00, 0x01, 0x00, 0x10, 0x00, 0x03, 0x00, 0x00, 0x00,
+	0x00, 0x58, 0x02, 0x00, 0xC4, 0x0E, 0x00, 0x00, 0xC4, 0x0E, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0xF8, 0x00, 0x00, 0xE0, 0x07, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00,
 };
 
+} // namespace
 
-ArduCAMStream::ArduCAMStream(ArduCAM *myCam) {
-	ACAM_DEBUG("ArduCAMStream::ArduCAMStream()\n");
-	myCAM = myCam;
-	transfer = false;
-	len = 0;
-	bcount = 0;
-}
+/*
+ * Buffers are allocated separately from the stream as a transfer may still be
+ * in progress when the stream is destroyed. The completion callback frees them.
+ */
+struct ArduCAMStream::Buffer {
+	SPIClass::Request request;
+	ArduCAMStream* stream; ///< nullptr if stream destroyed whilst transfer in progress
+	ArduCAM* cam;
+	uint16_t length{0};
+	uint16_t pos{0};
+	bool last{false}; ///< Final block of FIFO
+	uint8_t data[ACAM_STREAM_BUFFER_SIZE];
+
+	Buffer(ArduCAMStream* stream, ArduCAM* cam) : stream(stream), cam(cam)
+	{
+	}
+
+	size_t remaining() const
+	{
+		return length - pos;
+	}
+
+	bool isEmpty() const
+	{
+		return !request.busy && pos == length;
+	}
+};
 
-ArduCAMStream::~ArduCAMStream() {
-	ACAM_DEBUG("ArduCAMStream::~ArduCAMStream()\n");
+ArduCAMStream::~ArduCAMStream()
+{
+	bool transferPending{false};
+	for(auto buf : buffers) {
+		if(buf == nullptr) {
+			continue;
+		}
+		if(buf->request.busy) {
+			buf->stream = nullptr;
+			transferPending = true;
+		} else {
+			delete buf;
+		}
+	}
+
+	// Abandoned part-way through burst
+	if(state == State::reading && !transferPending) {
+		myCAM->CS_HIGH();
+	}
 }
 
+bool ArduCAMStream::isCaptureDone()
+{
+	if(state != State::capturing) {
+		return true;
+	}
+
+	// Register access is synchronous so must wait for other queued transfers
+	if(SPI.isBusy() || !myCAM->get_bit(ARDUCHIP_TRIG, CAP_DONE_MASK)) {
+		return false;
+	}
 
-int ArduCAMStream::available() {
-//	int len = myCAM.read_fifo_length();
-//	ACAM_DEBUG("Stream available (%d bytes)\n", len);
-	return len;
+	start();
+	return true;
 }
 
 bool ArduCAMStream::dataReady()
 {
-	// wait for available data
-	for (int i=0; i<100; i++) {
-		if (myCAM->get_bit(ARDUCHIP_TRIG, CAP_DONE_MASK)) {
-
-			len = myCAM->read_fifo_length();
-//			if (myCAM.get_format() == BMP)
-//				len += BMPIMAGEOFFSET;
-			ACAM_DEBUG("ArduCAMStream::dataReady() -> (%d bytes Ready)\n", len);
-#ifdef ACAM_HDUMP
-			hdump.resetAddr();
-#endif
+	for(unsigned i = 0; i < 100; ++i) {
+		if(isCaptureDone()) {
 			return true;
 		}
 		delay(10);
-	};
-	Serial.printf("ArduCAMStream::dataReady() -> no Data Available\n");
+	}
+
+	debug_w("[ACAM] Capture timed out");
 	return false;
 }
 
+void ArduCAMStream::start()
+{
+	fifoRemaining = myCAM->read_fifo_length();
+	ACAM_DEBUG("ArduCAMStream::start() -> (%u bytes Ready)\n", fifoRemaining);
 
-bool ArduCAMStream::isFinished() {
-	if (available() > 0) {
-//		Serial.println("isFinished: Stream has more data!\n");
-		return false;
-	} else {
-		ACAM_DEBUG("isFinished: available()=0 -> Stream isFinished!\n");
-		return true;
+	for(auto& buf : buffers) {
+		buf = new Buffer(this, myCAM);
 	}
-}
+	index = 0;
+	state = State::reading;
 
+	myCAM->CS_LOW();
+	myCAM->set_fifo_burst();
+	// clear dummy byte -> send out LO and ignore MISO
+	SPI.transfer(0x0);
 
-uint16_t ArduCAMStream::readMemoryBlock(char* data, int bufSize) {
-	if(!dataReady()) {
-		return 0;
+	if(myCAM->get_format() == BMP) {
+		auto& buf = current();
+		memcpy_P(buf.data, bmp_header, BMPIMAGEOFFSET);
+		buf.length = BMPIMAGEOFFSET;
 	}
 
-	if (!transfer) {
-		transfer = true;
+	fill(*buffers[0]);
+	fill(*buffers[1]);
 
-		myCAM->CS_LOW();
-		myCAM->set_fifo_burst();
-		// clear dummy byte -> send out LO and ignore MISO
-		SPI.transfer(0x0);
+	if(fifoRemaining == 0 && buffers[0]->isEmpty() && buffers[1]->isEmpty()) {
+		// Nothing captured
+		myCAM->CS_HIGH();
+		state = State::done;
+	}
+}
 
-		// send a BMP header for BMP files
-		if (myCAM->get_format() == BMP) {
-			hdump.print((unsigned char *)bmp_header, BMPIMAGEOFFSET);
-			memcpy(data, (unsigned char *)bmp_header, BMPIMAGEOFFSET);
-			return BMPIMAGEOFFSET;
-		}
+/*
+ * Buffers are always filled in stream order: the current one first, then the other.
+ * Called again from `peekRegion()` if the transfer couldn't be started.
+ */
+void ArduCAMStream::fill(Buffer& buf)
+{
+	if(!buf.isEmpty() || fifoRemaining == 0) {
+		return;
+	}
+
+	auto len = std::min(fifoRemaining, sizeof(buf.data));
+	buf.length = len;
+	buf.pos = 0;
+	buf.last = (len == fifoRemaining);
 
+	auto& req = buf.request;
+	req.out = nullptr;
+	req.in = buf.data;
+	req.length = len;
+	req.chipSelect = SPIClass::Request::noChipSelect;
+	req.callback = transferComplete;
+	req.param = &buf;
+	if(SPI.transferAsync(req)) {
+		fifoRemaining -= len;
+		return;
 	}
 
-	int bytesread = min(len, (unsigned int)bufSize);
+	if(SPI.isBusy()) {
+		// Try again later
+		buf.length = 0;
+		return;
+	}
 
-	ACAM_DEBUG("ArduCAMStream::readMemoryBlock [%d] (%d bytes) remaining (%d bytes)\n", bcount++, bytesread, len);
+	SPI.transfer(buf.data, len);
+	fifoRemaining -= len;
+	if(buf.last) {
+		myCAM->CS_HIGH();
+	}
+}
 
-	// block read does overload the cam
-//	HwSPI.recv((uint8_t *)data, bytesread);
-//	SPI.transfer((unsigned char*)data, bytesread);
+void ArduCAMStream::transferComplete(SPIClass::Request& request)
+{
+	auto buf = static_cast<Buffer*>(request.param);
+	if(buf->last || buf->stream == nullptr) {
+		buf->cam->CS_HIGH();
+	}
+	if(buf->stream == nullptr) {
+		delete buf;
+	}
+}
 
-	// so we have to read single bytes
-	for (int i=0; i< bytesread; i++) {
-		data[i] = SPI.read8();
+int ArduCAMStream::available()
+{
+	switch(state) {
+	case State::capturing:
+		return -1;
+	case State::reading:
+		return fifoRemaining + buffers[0]->remaining() + buffers[1]->remaining();
+	case State::done:
+	default:
+		return 0;
 	}
-	len = len - bytesread;
+}
 
-	if (len == 0) {
-		ACAM_DEBUG("ArduCAMStream::readMemoryBlock -> eof");
-		transfer = false;
-		SPI.endTransaction();
-		myCAM->CS_HIGH();
+bool ArduCAMStream::isFinished()
+{
+	return state == State::done;
+}
+
+size_t ArduCAMStream::peekRegion(const char*& data)
+{
+	if(!isCaptureDone() || state != State::reading) {
+		return 0;
+	}
+
+	fill(current());
+	fill(*buffers[index ^ 1]);
+
+	auto& buf = current();
+	if(buf.request.busy) {
+		return 0;
 	}
 
-	return bytesread;
+	data = reinterpret_cast<const char*>(&buf.data[buf.pos]);
+	return buf.remaining();
+}
 
+uint16_t ArduCAMStream::readMemoryBlock(char* data, int bufSize)
+{
+	const char* ptr{nullptr};
+	auto len = std::min(peekRegion(ptr), size_t(bufSize));
+	memcpy(data, ptr, len);
+	return len;
 }
 
-bool ArduCAMStream::seek(int dist) {
-//	ACAM_DEBUG("ArduCAMStream::seek (%d)\n", dist);
-	// we do not allow negative seeks
-	if (dist < 0)
+bool ArduCAMStream::seek(int len)
+{
+	if(len < 0 || state != State::reading) {
+		return len == 0;
+	}
+
+	auto& buf = current();
+	if(buf.request.busy || size_t(len) > buf.remaining()) {
 		return false;
-	// end we ignore forward seeks
-	else
+	}
+
+	buf.pos += len;
+	if(buf.remaining() != 0) {
 		return true;
-};
+	}
 
+	// Buffer drained: move on to next and refill this one behind it
+	if(!buffers[index ^ 1]->isEmpty()) {
+		index ^= 1;
+	}
+	fill(buf);
+
+	if(fifoRemaining == 0 && buffers[0]->isEmpty() && buffers[1]->isEmpty()) {
+		ACAM_DEBUG("ArduCAMStream -> eof\n");
+		state = State::done;
+	}
 
+	return true;
+}
@@ -5,36 +5,90 @@
  *      Author: harry
  */
 
-#ifndef SAMPLES_ARDUCAM_APP_ARDUCAMSTREAM_H_
-#define SAMPLES_ARDUCAM_APP_ARDUCAMSTREAM_H_
+#pragma once
 
 #include "ArduCAM.h"
+#include <Data/Stream/DataSourceStream.h>
+#include <SPI.h>
 
-#include <Services/HexDump/HexDump.h>
-
+/**
+ * @brief Size of each FIFO read buffer. Two are allocated per stream.
+ */
+#ifndef ACAM_STREAM_BUFFER_SIZE
+#define ACAM_STREAM_BUFFER_SIZE 1024
+#endif
 
-class ArduCAMStream: public IDataSourceStream {
+/**
+ * @brief Image data read from the ArduCAM FIFO
+ *
+ * Create the stream after starting a capture. Until the capture completes the stream
+ * reports unknown length and supplies no data, so a connection can send its headers
+ * then pick up the image on a later poll instead of blocking.
+ *
+ * The FIFO is read in burst mode using two buffers: whilst one is being sent, the other
+ * is filled using a queued SPI transfer. Data is handed to the connection in place via
+ * `peekRegion()`. Where a transfer can't be queued, a blocking bulk read is used instead.
+ *
+ * The camera chip select is held low from start of burst until the FIFO has been read,
+ * so other devices on the bus must not be accessed during that time.
+ */
+class ArduCAMStream : public IDataSourceStream
+{
 public:
-	ArduCAMStream(ArduCAM *cam);
-	virtual ~ArduCAMStream();
+	ArduCAMStream(ArduCAM* cam) : myCAM(cam)
+	{
+	}
+
+	~ArduCAMStream();
 
-	virtual StreamType getStreamType() const { return eSST_User; }
+	StreamType getStreamType() const override
+	{
+		return eSST_User;
+	}
 
-	virtual uint16_t readMemoryBlock(char* data, int bufSize);
-	virtual bool seek(int len);
-	virtual bool isFinished();
+	uint16_t readMemoryBlock(char* data, int bufSize) override;
+	size_t peekRegion(const char*& data) override;
+	bool seek(int len) override;
+	bool isFinished() override;
 
+	/**
+	 * @brief Length of image, -1 if capture is still in progress
+	 */
+	int available() override;
+
+	/**
+	 * @brief Check for end of capture without blocking
+	 * @retval bool true when FIFO has data to read
+	 */
+	bool isCaptureDone();
+
+	/**
+	 * @brief Wait up to one second for end of capture
+	 * @retval bool true when FIFO has data to read
+	 */
 	bool dataReady();
-	int available();
 
 private:
+	struct Buffer;
 
-	ArduCAM *myCAM;
-	bool transfer = false;
-	bool sendHeader = false;
-	size_t len;
-	int bcount;
-	HexDump hdump;
-};
+	enum class State {
+		capturing,
+		reading,
+		done,
+	};
 
-#endif /* SAMPLES_ARDUCAM_APP_ARDUCAMSTREAM_H_ */
+	void start();
+	void fill(Buffer& buffer);
+	static void transferComplete(SPIClass::Request& request);
+
+	Buffer& current()
+	{
+		return *buffers[index];
+	}
+
+	ArduCAM* myCAM;
+	Buffer* buffers[2]{};
+	size_t fifoRemaining{0};
+	uint8_t index{0};
+	State state{State::capturing};
+};
@@ -19,6 +19,8 @@
  * 		bool Json::deserialize(doc, input, size, format)
  * 		bool Json::loadFromFile(doc, filename, format)
  * 		bool Json::saveToFile(doc, filename, format)
+ * 		bool Json::deserializeInPlace(doc, memoryStream, format)
+ * 	- Block-based stream adapters, see Json::StreamReader and Json::StreamWriter
  * 	- Support functions to simplify usage
  * 		bool Json::getValue(source&, dest&)
  *
@@ -38,7 +40,10 @@
 #include "../ArduinoJson/src/ArduinoJson.h"
 #include "FlashStringRefAdapter.hpp"
 #include "FlashStringReader.hpp"
+#include "StreamReader.hpp"
+#include "StreamWriter.hpp"
 #include <Data/Stream/FileStream.h>
+#include <Data/Stream/MemoryDataStream.h>
 #include <Data/CString.h>
 
 #ifndef JSON_ENABLE_COMPACT
@@ -261,7 +266,8 @@ bool saveToFile(const TSource& source, const String& filename, SerializationForm
 		return false;
 	}
 
-	if(serialize(source, stream, format) == 0) {
+	StreamWriter writer(stream);
+	if(serialize(source, writer, format) == 0 || !writer.flush()) {
 		return false;
 	}
 
@@ -389,6 +395,25 @@ template <> inline bool deserialize(JsonDocument& doc, CString& input, Serializa
 	return Json::deserialize(doc, input.c_str(), input.length(), format);
 }
 
+/**
+ * @brief Parse the unread content of a memory stream in-situ, without copying strings
+ * @param doc Document to store the decoded data
+ * @param input Stream content is modified, and referenced by `doc`
+ * @param format Format of the data
+ * @retval bool true on success, false on error
+ * @note The document needs only enough capacity for its structure, as keys and string values
+ * remain in the stream buffer. Keep `input` in scope, and don't write to it, until finished with `doc`.
+ */
+inline bool deserializeInPlace(JsonDocument& doc, MemoryDataStream& input,
+							   SerializationFormat format = JSON_FORMAT_DEFAULT)
+{
+	auto data = const_cast<char*>(input.getStreamPointer());
+	if(data == nullptr) {
+		return false;
+	}
+	return Json::deserialize(doc, data, size_t(input.available()), format);
+}
+
 /**
  * @brief Parses the contents of a serialized file into a JsonDocument object
  * @param doc Document to store the decoded file
@@ -399,7 +424,11 @@ template <> inline bool deserialize(JsonDocument& doc, CString& input, Serializa
 inline bool loadFromFile(JsonDocument& doc, const String& filename, SerializationFormat format = JSON_FORMAT_DEFAULT)
 {
 	FileStream stream(filename);
-	return stream.isValid() ? deserialize(doc, stream, format) : false;
+	if(!stream.isValid()) {
+		return false;
+	}
+	StreamReader reader(stream);
+	return deserialize(doc, reader, format);
 }
 
 } // namespace Json
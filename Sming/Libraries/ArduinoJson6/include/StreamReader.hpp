@@ -0,0 +1,115 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2019
+// MIT License
+//
+// Sming IDataSourceStream reader
+
+#pragma once
+
+#include <Data/Stream/DataSourceStream.h>
+
+namespace Json
+{
+/**
+ * @brief Read JSON or MessagePack from an IDataSourceStream in blocks
+ *
+ * ArduinoJson reads `Stream` input one character at a time, which for a `FileStream`
+ * means a filesystem read per character. This reader takes data in blocks instead:
+ * directly from the stream's own buffer where `peekRegion()` is available (e.g. MemoryDataStream),
+ * otherwise via a small window.
+ *
+ * The stream is advanced by the amount actually consumed when the reader is destroyed,
+ * so any data following the document remains available.
+ *
+ * Example:
+ *
+ * ```
+ * FileStream file("config.json");
+ * Json::StreamReader reader(file);
+ * Json::deserialize(doc, reader);
+ * ```
+ */
+class StreamReader
+{
+public:
+	static constexpr size_t windowSize{64};
+
+	explicit StreamReader(IDataSourceStream& stream) : stream(stream)
+	{
+	}
+
+	StreamReader(const StreamReader&) = delete;
+
+	~StreamReader()
+	{
+		stream.seek(pos);
+	}
+
+	int read()
+	{
+		if(pos == length && !fill()) {
+			return -1;
+		}
+		return uint8_t(data[pos++]);
+	}
+
+	size_t readBytes(char* buffer, size_t count)
+	{
+		size_t total{0};
+		while(total < count) {
+			if(pos == length && !fill()) {
+				break;
+			}
+			auto n = std::min(count - total, length - pos);
+			memcpy(&buffer[total], &data[pos], n);
+			pos += n;
+			total += n;
+		}
+		return total;
+	}
+
+private:
+	bool fill()
+	{
+		stream.seek(pos);
+		pos = 0;
+		length = stream.peekRegion(data);
+		if(length == 0) {
+			length = stream.readMemoryBlock(window, windowSize);
+			data = window;
+		}
+		return length != 0;
+	}
+
+	IDataSourceStream& stream;
+	const char* data{nullptr};
+	size_t length{0}; ///< Bytes available at `data`
+	size_t pos{0};	///< Bytes consumed from `data`, not yet released from stream
+	char window[windowSize];
+};
+
+} // namespace Json
+
+namespace ARDUINOJSON_NAMESPACE
+{
+// The deserializer copies its reader, so this just refers to the state kept by Json::StreamReader
+template <> struct Reader<Json::StreamReader, void> {
+	explicit Reader(const Json::StreamReader& reader) : reader(const_cast<Json::StreamReader&>(reader))
+	{
+	}
+
+	int read()
+	{
+		return reader.read();
+	}
+
+	size_t readBytes(char* buffer, size_t length)
+	{
+		return reader.readBytes(buffer, length);
+	}
+
+private:
+	Json::StreamReader& reader;
+};
+
+} // namespace ARDUINOJSON_NAMESPACE
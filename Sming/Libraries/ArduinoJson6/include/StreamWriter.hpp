@@ -0,0 +1,85 @@
+// Sming buffered stream writer for ArduinoJson serialization
+
+#pragma once
+
+#include <Print.h>
+
+namespace Json
+{
+/**
+ * @brief Collects serialized output into blocks before writing to a stream
+ *
+ * The serializer writes escaped strings one character at a time, which for a `FileStream`
+ * means a filesystem write per character. Output is passed on when the buffer fills,
+ * and any remainder on `flush()` or destruction.
+ *
+ * Example:
+ *
+ * ```
+ * FileStream file("config.json", File::WriteOnly | File::CreateNewAlways);
+ * Json::StreamWriter writer(file);
+ * Json::serialize(doc, writer);
+ * ```
+ */
+class StreamWriter : public Print
+{
+public:
+	static constexpr size_t bufferSize{64};
+
+	explicit StreamWriter(Print& output) : output(output)
+	{
+	}
+
+	StreamWriter(const StreamWriter&) = delete;
+
+	~StreamWriter()
+	{
+		flush();
+	}
+
+	size_t write(uint8_t c) override
+	{
+		if(length == bufferSize && !flush()) {
+			return 0;
+		}
+		buffer[length++] = c;
+		return 1;
+	}
+
+	size_t write(const uint8_t* data, size_t size) override
+	{
+		if(length + size > bufferSize) {
+			if(!flush()) {
+				return 0;
+			}
+			if(size >= bufferSize) {
+				return output.write(data, size);
+			}
+		}
+		memcpy(&buffer[length], data, size);
+		length += size;
+		return size;
+	}
+
+	/**
+	 * @brief Write any buffered data to the output
+	 * @retval bool false if the output did not accept all of it
+	 */
+	bool flush()
+	{
+		if(length == 0) {
+			return true;
+		}
+		auto written = output.write(buffer, length);
+		bool ok = (written == length);
+		length = 0;
+		return ok;
+	}
+
+private:
+	Print& output;
+	uint8_t buffer[bufferSize];
+	size_t length{0};
+};
+
+} // namespace Json
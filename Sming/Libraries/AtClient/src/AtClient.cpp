@@ -23,55 +23,142 @@ AtClient::AtClient(HardwareSerial& stream) : stream(stream)
 
 void AtClient::processor(Stream& source, char arrivedChar, uint16_t availableCharsCount)
 {
-	if(!currentCommand.text.length()) {
+	if(currentCommand.text.length() && currentCommand.onReceive) {
+		if(state != State::Error && currentCommand.onReceive(*this, source)) {
+			next();
+		}
 		return;
 	}
 
-	if(state == State::Error) {
-		// discard input at error state
-		return;
-	}
+	// Work directly on the serial receive buffer
+	const uint8_t* data;
+	size_t len;
+	while((len = stream.peekRegion(data)) != 0) {
+		if(dataRemaining != 0) {
+			len = std::min(len, dataRemaining);
+			dataRemaining -= len;
+			if(dataCallback) {
+				dataCallback(*this, data, len);
+			}
+			stream.consume(len);
+			continue;
+		}
 
-	if(currentCommand.onReceive) {
-		if(currentCommand.onReceive(*this, source)) {
-			next();
+		// Stop at any request for binary data, which follows the line announcing it
+		size_t i = 0;
+		while(i < len && dataRemaining == 0) {
+			parse(char(data[i++]));
 		}
-		return;
+		stream.consume(i);
 	}
+}
 
-	if(arrivedChar != '\n') {
+void AtClient::parse(char c)
+{
+	switch(c) {
+	case '\r':
 		return;
-	}
 
-	commandTimer.stop();
-	debug_d("Processing: %d ms, %s", millis(), currentCommand.text.substring(0, 20).c_str());
+	case '\n':
+		if(lineLength != 0) {
+			line[lineLength] = '\0';
+			processLine();
+			lineLength = 0;
+		}
+		return;
 
-	char response[availableCharsCount];
-	for(int i = 0; i < availableCharsCount; i++) {
-		response[i] = stream.read();
-		if(response[i] == '\r' || response[i] == '\n') {
-			response[i] = '\0';
+	case ' ':
+		// Skip leading spaces, such as the one after a data prompt
+		if(lineLength == 0) {
+			return;
 		}
+		break;
+
+	case '>':
+		// Data prompt is not terminated by a line ending
+		if(lineLength == 0 && currentCommand.data != nullptr && !dataSent) {
+			stream.write(static_cast<const uint8_t*>(currentCommand.data), currentCommand.dataLength);
+			dataSent = true;
+			return;
+		}
+		break;
 	}
 
-	debug_d("Got response: %s", response);
+	if(lineLength < AT_LINE_MAX) {
+		line[lineLength++] = c;
+	}
+}
+
+bool AtClient::lineEquals(const char* text) const
+{
+	return strcmp(line, text) == 0;
+}
+
+bool AtClient::lineStartsWith(const char* text, size_t length) const
+{
+	return length != 0 && lineLength >= length && memcmp(line, text, length) == 0;
+}
+
+bool AtClient::isEcho() const
+{
+	auto& text = currentCommand.text;
+	if(lineLength > text.length() || memcmp(text.c_str(), line, lineLength) != 0) {
+		return false;
+	}
+	return lineLength == text.length() || text[lineLength] == '\r' || text[lineLength] == '\n';
+}
 
-	String reply(response);
-	if(reply.indexOf(AT_REPLY_OK) + reply.indexOf(currentCommand.response2) == -2) {
-		// we did not get what we wanted. Check if we should repeat.
-		if(--currentCommand.retries > 0) {
-			sendDirect(currentCommand);
+void AtClient::processLine()
+{
+	for(unsigned i = 0; i < urcs.count(); ++i) {
+		auto& urc = urcs[i];
+		if(lineStartsWith(urc.prefix.c_str(), urc.prefix.length())) {
+			urc.callback(*this, line, lineLength);
 			return;
 		}
+	}
 
-		if(currentCommand.breakOnError) {
-			state = State::Error;
-			return;
+	if(!currentCommand.text.length() || state == State::Error) {
+		debug_d("Discarded: %s", line);
+		return;
+	}
+
+	if(isEcho()) {
+		return;
+	}
+
+	debug_d("Got response: %s", line);
+
+	if(lineEquals(AT_REPLY_OK) ||
+	   lineStartsWith(currentCommand.response2.c_str(), currentCommand.response2.length())) {
+		complete();
+		return;
+	}
+
+	if(lineEquals("ERROR") || lineStartsWith(_F("+CME ERROR"), 10) || lineStartsWith(_F("+CMS ERROR"), 10)) {
+		failed();
+		return;
+	}
+
+	// Intermediate response
+	if(currentCommand.onLine) {
+		currentCommand.onLine(*this, line, lineLength);
+	}
+	if(currentCommand.onComplete) {
+		if(reply) {
+			reply += '\n';
 		}
+		reply.concat(line, lineLength);
 	}
+}
+
+void AtClient::complete()
+{
+	debug_d("Processing: %d ms, %s", millis(), currentCommand.text.substring(0, 20).c_str());
 
 	if(currentCommand.onComplete) {
 		if(!currentCommand.onComplete(*this, reply)) {
+			// Keep waiting for further response lines
 			return;
 		}
 	}
@@ -79,6 +166,64 @@ void AtClient::processor(Stream& source, char arrivedChar, uint16_t availableCha
 	next();
 }
 
+void AtClient::failed()
+{
+	commandTimer.stop();
+
+	if(currentCommand.retries > 0) {
+		--currentCommand.retries;
+		retry();
+		return;
+	}
+
+	if(currentCommand.breakOnError) {
+		state = State::Error;
+		requeueInFlight();
+		return;
+	}
+
+	complete();
+}
+
+void AtClient::retry()
+{
+	if(inFlight.empty()) {
+		sendDirect(currentCommand);
+		return;
+	}
+
+	// Responses arrive in the order sent, so this now goes after those already in flight
+	transmit(currentCommand);
+	inFlight.enqueue(currentCommand);
+	setCurrent(inFlight.dequeue());
+}
+
+void AtClient::requeueInFlight()
+{
+	if(inFlight.empty()) {
+		return;
+	}
+
+	// These have been sent, but will be sent again on resend() as their responses are now discarded
+	Queue pending;
+	while(!inFlight.empty()) {
+		pending.enqueue(inFlight.dequeue());
+	}
+	while(!queue.empty()) {
+		if(!pending.enqueue(queue.dequeue())) {
+			debug_w("Queue full, dropping command");
+		}
+	}
+	while(!pending.empty()) {
+		queue.enqueue(pending.dequeue());
+	}
+}
+
+void AtClient::onUrc(const String& prefix, LineCallback callback)
+{
+	urcs.add(Urc{prefix, callback});
+}
+
 void AtClient::send(const String& text, const String& altResponse, uint32_t timeoutMs, unsigned retries)
 {
 	Command atCommand;
@@ -118,6 +263,7 @@ void AtClient::send(Command command)
 {
 	if(currentCommand.text.length()) {
 		queue.enqueue(command);
+		fillPipeline();
 		return;
 	}
 
@@ -126,15 +272,41 @@ void AtClient::send(Command command)
 
 void AtClient::sendDirect(Command command)
 {
-	state = State::Running;
-	commandTimer.stop();
-	currentCommand = command;
+	setCurrent(command);
+	transmit(command);
+	fillPipeline();
+}
+
+void AtClient::transmit(const Command& command)
+{
 	stream.print(command.text);
-	debug_d("Sent: timeout: %d, current %d ms, name: %s", currentCommand.timeout, millis(),
+	lastSentPipelined = command.pipeline && command.data == nullptr;
+	debug_d("Sent: timeout: %d, current %d ms, name: %s", command.timeout, millis(),
 			command.text.substring(0, 20).c_str());
+}
+
+void AtClient::setCurrent(const Command& command)
+{
+	state = State::Running;
+	currentCommand = command;
+	reply = nullptr;
+	dataSent = false;
 	commandTimer.initializeMs(currentCommand.timeout, TimerDelegate(&AtClient::ticker, this)).startOnce();
 }
 
+void AtClient::fillPipeline()
+{
+	// Send ahead whilst both the last command sent and the next one allow it
+	while(lastSentPipelined && state == State::Running && inFlight.count() < AT_PIPELINE_DEPTH && !queue.empty()) {
+		const Command& command = queue.peek();
+		if(!command.pipeline || command.data != nullptr) {
+			break;
+		}
+		inFlight.enqueue(queue.dequeue());
+		transmit(command);
+	}
+}
+
 // Low Level Queue Functions
 void AtClient::resend()
 {
@@ -155,6 +327,15 @@ void AtClient::next()
 	}
 
 	state = State::OK;
+	commandTimer.stop();
+
+	if(!inFlight.empty()) {
+		// Already sent, now awaiting its response
+		setCurrent(inFlight.dequeue());
+		fillPipeline();
+		return;
+	}
+
 	currentCommand.text = "";
 	if(queue.count() > 0) {
 		send(queue.dequeue());
@@ -170,15 +351,15 @@ void AtClient::ticker()
 		return;
 	}
 
-	currentCommand.retries--;
 	debug_d("Retries: %d", currentCommand.retries);
 	if(currentCommand.retries > 0) {
-		commandTimer.restart();
-		sendDirect(currentCommand);
+		--currentCommand.retries;
+		retry();
 		return;
 	}
 
 	state = State::Error;
+	requeueInFlight();
 
 	debug_d("Timeout: %d ms, %s", millis(), currentCommand.text.c_str());
 }
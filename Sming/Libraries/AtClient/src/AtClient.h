@@ -18,12 +18,27 @@
 #include <HardwareSerial.h>
 #include <FIFO.h>
 #include <Timer.h>
+#include <WVector.h>
 
 #define AT_REPLY_OK "OK"
 #ifndef AT_TIMEOUT
 #define AT_TIMEOUT 2000
 #endif
 
+/**
+ * @brief Maximum number of pipelined commands awaiting a response, after the current one
+ */
+#ifndef AT_PIPELINE_DEPTH
+#define AT_PIPELINE_DEPTH 4
+#endif
+
+/**
+ * @brief Longest response line, anything beyond this is discarded
+ */
+#ifndef AT_LINE_MAX
+#define AT_LINE_MAX 128
+#endif
+
 /**
  * @brief Class that facilitates the communication with an AT device.
  */
@@ -42,14 +57,31 @@ public:
 	 */
 	using CompleteCallback = Delegate<bool(AtClient& atClient, String& reply)>;
 
+	/**
+	 * @brief Called for a single response line, without line ending
+	 * @note `line` is only valid for the duration of the call
+	 */
+	using LineCallback = Delegate<void(AtClient& atClient, const char* line, size_t length)>;
+
+	/**
+	 * @brief Called with binary data requested via `receiveData()`
+	 * @param data Points directly into the serial receive buffer, only valid for the duration of the call
+	 * @param length May be less than requested, the callback is invoked until all data has arrived
+	 */
+	using DataCallback = Delegate<void(AtClient& atClient, const uint8_t* data, size_t length)>;
+
 	struct Command {
 		String text;				 ///< the actual AT command
-		String response2;			 ///< alternative successful response
+		String response2;			 ///< alternative successful response, matched at start of line
 		unsigned timeout;			 ///< timeout in milliseconds
 		unsigned retries;			 ///< number of retries before giving up
 		bool breakOnError = true;	///< stop executing next command if that one has failed
+		bool pipeline = false;		 ///< may be sent without waiting for the previous pipelined command to complete
 		ReceiveCallback onReceive;   ///< if set you can process manually all incoming data in a callback
 		CompleteCallback onComplete; ///< if set then you can process the complete response manually
+		LineCallback onLine;		 ///< if set, called for each intermediate response line
+		const void* data = nullptr;  ///< binary payload sent on '>' prompt, must remain valid until complete
+		size_t dataLength = 0;		 ///< size of payload
 	};
 
 	enum class State {
@@ -128,6 +160,29 @@ public:
 	 */
 	void next();
 
+	/**
+	 * @brief Register a handler for unsolicited result codes
+	 * @param prefix Start of line identifying the URC, e.g. "+CREG:"
+	 * @param callback Invoked with the complete line
+	 * @note Matching lines are never treated as part of a command response,
+	 * so avoid prefixes which commands are expected to return.
+	 */
+	void onUrc(const String& prefix, LineCallback callback);
+
+	/**
+	 * @brief Take the next bytes from the device as binary data, bypassing line processing
+	 * @param length Number of bytes expected
+	 * @param callback Receives data in place, straight from the serial receive buffer
+	 *
+	 * Typically called from an `onLine` or URC callback on the line announcing the data,
+	 * such as `+CIPRXGET: 2,<length>`.
+	 */
+	void receiveData(size_t length, DataCallback callback)
+	{
+		dataRemaining = length;
+		dataCallback = callback;
+	}
+
 	Command currentCommand; ///< The current command
 
 protected:
@@ -137,10 +192,39 @@ protected:
 	virtual void processor(Stream& source, char arrivedChar, uint16_t availableCharsCount);
 
 private:
-	FIFO<Command, 10> queue; ///< Queue for the commands to be executed
-	HardwareSerial& stream;  ///< The main communication stream
-	Timer commandTimer;		 ///< timer used for commands with timeout
+	struct Urc {
+		String prefix;
+		LineCallback callback;
+	};
+
+	using Queue = FIFO<Command, 10>;
+
+	Queue queue;								///< Queue for the commands to be executed
+	FIFO<Command, AT_PIPELINE_DEPTH + 1> inFlight; ///< Sent after currentCommand, one spare for a retry
+	HardwareSerial& stream;						///< The main communication stream
+	Timer commandTimer;							///< timer used for commands with timeout
 	State state = State::OK;
+	Vector<Urc> urcs;
+	String reply; ///< Intermediate lines for onComplete
+	DataCallback dataCallback;
+	size_t dataRemaining{0};
+	char line[AT_LINE_MAX + 1];
+	uint16_t lineLength{0};
+	bool lastSentPipelined{false};
+	bool dataSent{false};
+
+	void transmit(const Command& command);
+	void setCurrent(const Command& command);
+	void fillPipeline();
+	void parse(char c);
+	void processLine();
+	bool lineEquals(const char* text) const;
+	bool lineStartsWith(const char* text, size_t length) const;
+	bool isEcho() const;
+	void complete();
+	void failed();
+	void retry();
+	void requeueInFlight();
 
 	/**
 	 * @brief Timeout checker method
@@ -183,6 +183,9 @@ void onCapture(HttpRequest& request, HttpResponse& response)
 	if(stream->dataReady()) {
 		response.headers[HTTP_HEADER_CONTENT_LENGTH] = String(stream->available());
 		response.sendDataStream(stream, contentType);
+	} else {
+		delete stream;
+		response.code = HTTP_STATUS_GATEWAY_TIMEOUT;
 	}
 
 	Serial << _F("onCapture() process Stream ") << timer.elapsedTime() << endl;
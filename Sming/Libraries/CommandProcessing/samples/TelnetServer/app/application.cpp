@@ -1,5 +1,6 @@
 #include <SmingCore.h>
 #include <CommandProcessing/Utils.h>
+#include <CommandProcessing/TelnetServer.h>
 
 // If you want, you can define WiFi settings globally in Eclipse Environment Variables
 #ifndef WIFI_SSID
@@ -11,41 +12,6 @@ namespace
 {
 CommandProcessing::Handler commandHandler;
 
-void clientConnected(TcpClient* client)
-{
-	Serial << _F("Client ") << client->getRemoteIp() << _F(" connected") << endl;
-	if(commandHandler.isVerbose()) {
-		client->sendString(commandHandler.getCommandWelcomeMessage());
-		client->sendString(commandHandler.getCommandPrompt());
-	}
-}
-
-void clientComplete(TcpClient& client, bool successful)
-{
-	Serial << _F("Client disconnected") << endl;
-}
-
-bool processTelnetInput(TcpClient& client, char* data, int size)
-{
-	// Ignore TELNET escape sequences
-	constexpr char TC_ESC{'\xff'};
-	uint8_t skip{};
-	while(size-- > 0) {
-		char c = *data++;
-		if(skip) {
-			--skip;
-		} else if(c == TC_ESC) {
-			skip = 2;
-		} else {
-			commandHandler.process(c);
-		}
-	}
-
-	String s;
-	commandHandler.getOutputStream().moveString(s);
-	return s ? client.sendString(s) : true;
-}
-
 void processExampleCommand(String commandLine, ReadWriteStream& commandOutput)
 {
 	Vector<String> commandToken;
@@ -65,7 +31,7 @@ void initCommands()
 	commandHandler.registerCommand({CMDP_STRINGS("example", "Example Command", "Application"), processExampleCommand});
 }
 
-TcpServer telnetServer(clientConnected, processTelnetInput, clientComplete);
+CommandProcessing::TelnetServer telnetServer(commandHandler);
 
 // Will be called when station is fully operational
 void gotIP(IpAddress ip, IpAddress netmask, IpAddress gateway)
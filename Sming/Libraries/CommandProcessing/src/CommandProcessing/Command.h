@@ -54,7 +54,27 @@ struct CommandDef {
 
 	bool operator==(const String& name) const
 	{
-		return name == get(StringIndex::name);
+		return nameEquals(name.c_str(), name.length());
+	}
+
+	/**
+	 * @brief Compare command name without constructing a String
+	 * @param name Need not be nul-terminated
+	 * @param length Number of characters in name
+	 */
+	bool nameEquals(const char* name, size_t length) const
+	{
+#ifdef CMDPROC_FLASHSTRINGS
+		if(strings == nullptr || strings->length() <= length) {
+			return false;
+		}
+		// Name is followed by nul separator
+		auto data = reinterpret_cast<const char*>(strings->data());
+		return pgm_read_byte(&data[length]) == '\0' && memcmp_P(name, data, length) == 0;
+#else
+		auto s = strings.c_str();
+		return s && strlen(s) == length && memcmp(s, name, length) == 0;
+#endif
 	}
 
 	String get(StringIndex index) const
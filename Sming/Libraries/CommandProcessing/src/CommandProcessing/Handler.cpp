@@ -13,6 +13,21 @@
 
 namespace CommandProcessing
 {
+namespace
+{
+// FNV-1a folded to 16 bits
+uint16_t nameHash(const char* name, size_t length)
+{
+	uint32_t h{2166136261U};
+	for(size_t i = 0; i < length; ++i) {
+		h ^= uint8_t(name[i]);
+		h *= 16777619U;
+	}
+	return (h >> 16) ^ h;
+}
+
+} // namespace
+
 String Handler::getCommandPrompt() const
 {
 	return prompt ?: F("Sming>");
@@ -23,12 +38,10 @@ String Handler::getCommandWelcomeMessage() const
 	return welcomeMessage ?: F("Welcome to Sming Command Processing\r\n");
 }
 
-size_t Handler::process(char recvChar)
+size_t Handler::process(LineBufferBase& lineBuffer, ReadWriteStream& output, char recvChar)
 {
-	auto& output = getOutputStream();
-
 	using Action = LineBufferBase::Action;
-	switch(commandBuf.processKey(recvChar)) {
+	switch(lineBuffer.processKey(recvChar)) {
 	case Action::clear:
 		if(isVerbose()) {
 			output.println();
@@ -39,10 +52,10 @@ size_t Handler::process(char recvChar)
 		if(isVerbose()) {
 			output.println();
 		}
-		processCommandLine(String(commandBuf));
-		commandBuf.clear();
+		processCommandLine(lineBuffer.getBuffer(), lineBuffer.getLength(), output);
+		lineBuffer.clear();
 		if(isVerbose()) {
-			outputStream->print(getCommandPrompt());
+			output.print(getCommandPrompt());
 		}
 		break;
 	case Action::backspace:
@@ -78,30 +91,34 @@ String Handler::processNow(const char* buffer, size_t size)
 	return nullptr;
 }
 
-void Handler::processCommandLine(const String& cmdString)
+void Handler::processCommandLine(const char* line, size_t length, ReadWriteStream& output)
 {
-	if(cmdString.length() == 0) {
+	if(length == 0) {
 		return;
 	}
 
-	debug_d("Received full Command line, size = %u, cmd = '%s'", cmdString.length(), cmdString.c_str());
-	String name;
-	int cmdLen = cmdString.indexOf(' ');
-	if(cmdLen < 0) {
-		name = cmdString;
-	} else {
-		name = cmdString.substring(0, cmdLen);
-	}
+	debug_d("Received full Command line, size = %u, cmd = '%s'", length, line);
 
-	debug_d("CommandExecutor : executing command '%s'", name.c_str());
+	// Command name is a view into the line buffer
+	auto sep = static_cast<const char*>(memchr(line, ' ', length));
+	size_t nameLength = sep ? sep - line : length;
 
-	Command cmd = getCommand(name);
-	if(!cmd) {
-		*outputStream << _F("Command '") << name << _F("' not found.") << endl;
-	} else if(cmd.callback) {
-		cmd.callback(cmdString, *outputStream);
+	int i = findCommand(line, nameLength);
+	if(i < 0) {
+		output << _F("Command '");
+		output.write(line, nameLength);
+		output << _F("' not found.") << endl;
+		return;
+	}
+
+	// Take a copy as callback may change registrations
+	auto callback = registeredCommands[i].callback;
+	if(callback) {
+		callback(String(line, length), output);
 	} else {
-		*outputStream << _F("Command '") << name << _F("' has no callback.") << endl;
+		output << _F("Command '");
+		output.write(line, nameLength);
+		output << _F("' has no callback.") << endl;
 	}
 }
 
@@ -120,42 +137,96 @@ void Handler::registerSystemCommands()
 					 {&Handler::processCommandOptions, this}});
 }
 
-Command Handler::getCommand(const String& name) const
+int Handler::findCommand(const char* name, size_t length) const
+{
+	uint32_t key = uint32_t(nameHash(name, length)) << 16;
+
+	// Binary search for first entry with matching hash
+	unsigned lo{0};
+	unsigned hi = commandIndex.count();
+	while(lo < hi) {
+		unsigned mid = (lo + hi) / 2;
+		if(commandIndex[mid] < key) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+
+	for(; lo < commandIndex.count() && (commandIndex[lo] & 0xffff0000) == key; ++lo) {
+		unsigned i = commandIndex[lo] & 0xffff;
+		if(registeredCommands[i].nameEquals(name, length)) {
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+void Handler::addIndexEntry(const String& name, unsigned index)
 {
-	int i = registeredCommands.indexOf(name);
+	// Insert after any entries with same hash
+	uint32_t entry = (uint32_t(nameHash(name.c_str(), name.length())) << 16) | index;
+	unsigned pos = commandIndex.count();
+	while(pos > 0 && commandIndex[pos - 1] > entry) {
+		--pos;
+	}
+	commandIndex.insertElementAt(entry, pos);
+}
+
+void Handler::rebuildIndex()
+{
+	commandIndex.clear();
+	commandIndex.ensureCapacity(registeredCommands.count());
+	for(unsigned i = 0; i < registeredCommands.count(); ++i) {
+		addIndexEntry(registeredCommands[i].get(StringIndex::name), i);
+	}
+}
+
+Command Handler::getCommand(const char* name, size_t length) const
+{
+	int i = findCommand(name, length);
 	if(i >= 0) {
-		debug_d("[CH] Returning Delegate for '%s'", name.c_str());
+		debug_d("[CH] Returning Delegate for '%s'", String(name, length).c_str());
 		return registeredCommands[i];
 	}
 
-	debug_d("[CH] Command %s not recognized", name.c_str());
+	debug_d("[CH] Command %s not recognized", String(name, length).c_str());
 	return CommandDef{};
 }
 
 bool Handler::registerCommand(const Command& command)
 {
 	String name = command.name;
-	int i = registeredCommands.indexOf(name);
-	if(i >= 0) {
+	if(findCommand(name.c_str(), name.length()) >= 0) {
 		// Command already registered, don't allow  duplicates
 		debug_d("[CH] Duplicate command %s", name.c_str());
 		return false;
 	}
 
-	registeredCommands.add(command);
+	unsigned index = registeredCommands.count();
+	if(!registeredCommands.add(command)) {
+		return false;
+	}
+
+	addIndexEntry(name, index);
+
 	debug_d("[CH] Command '%s' registered", name.c_str());
 	return true;
 }
 
 bool Handler::unregisterCommand(const Command& command)
 {
-	int i = registeredCommands.indexOf(command.name);
+	String name = command.name;
+	int i = findCommand(name.c_str(), name.length());
 	if(i < 0) {
 		// Command not registered, cannot remove
 		return false;
 	}
 
 	registeredCommands.remove(i);
+	// Indices of subsequent commands have changed
+	rebuildIndex();
 	return true;
 }
 
@@ -74,7 +74,10 @@ public:
 		return *outputStream;
 	}
 
-	size_t process(char charToWrite);
+	size_t process(char charToWrite)
+	{
+		return process(commandBuf, getOutputStream(), charToWrite);
+	}
 
 	/** @brief  Write chars to stream
      *  @param  buffer Pointer to buffer to write to the stream
@@ -82,16 +85,35 @@ public:
      *  @retval size_t Quantity of chars processed
      */
 	size_t process(const char* buffer, size_t size)
+	{
+		return process(commandBuf, getOutputStream(), buffer, size);
+	}
+
+	/**
+	 * @name Process input for a separate session
+	 *
+	 * Allows several clients, such as network connections, to share one handler.
+	 * Each session provides its own line buffer and output stream, whilst registered commands,
+	 * prompt and verbose mode are common to all.
+	 *
+	 * @param lineBuffer Holds partial command line for the session
+	 * @param output Receives echoed input and command responses for the session
+	 * @{
+	 */
+	size_t process(LineBufferBase& lineBuffer, ReadWriteStream& output, char charToWrite);
+
+	size_t process(LineBufferBase& lineBuffer, ReadWriteStream& output, const char* buffer, size_t size)
 	{
 		size_t retval = 0;
 		for(size_t i = 0; i < size; i++) {
-			if(process(buffer[i]) != 1) {
+			if(process(lineBuffer, output, buffer[i]) != 1) {
 				break;
 			}
 			retval++;
 		}
 		return retval;
 	}
+	/** @} */
 
 	/**
 	 * @brief Process command input and return response text
@@ -132,7 +154,17 @@ public:
 	 *  @param  name Command to query
 	 *  @retval Command The command object matching the command
 	 */
-	Command getCommand(const String& name) const;
+	Command getCommand(const String& name) const
+	{
+		return getCommand(name.c_str(), name.length());
+	}
+
+	/** @brief  Find command object
+	 *  @param  name Command to query, need not be nul-terminated
+	 *  @param  length Number of characters in name
+	 *  @retval Command The command object matching the command
+	 */
+	Command getCommand(const char* name, size_t length) const;
 
 	/** @brief  Get the verbose mode
 	 *  @retval bool Verbose mode
@@ -205,6 +237,11 @@ public:
 
 private:
 	Vector<CommandDef> registeredCommands;
+	/*
+	 * Lookup table sorted by name hash, in registration order for duplicate hashes.
+	 * Each entry is (hash << 16) | index into registeredCommands.
+	 */
+	Vector<uint32_t> commandIndex;
 	String prompt;
 	bool verboseMode{false};
 	String welcomeMessage;
@@ -220,7 +257,10 @@ private:
 	void processDebugOffCommand(String commandLine, ReadWriteStream& outputStream);
 	void processCommandOptions(String commandLine, ReadWriteStream& outputStream);
 
-	void processCommandLine(const String& cmdString);
+	void processCommandLine(const char* line, size_t length, ReadWriteStream& output);
+	int findCommand(const char* name, size_t length) const;
+	void addIndexEntry(const String& name, unsigned index);
+	void rebuildIndex();
 };
 
 } // namespace CommandProcessing
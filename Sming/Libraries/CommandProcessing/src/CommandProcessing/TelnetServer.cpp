@@ -0,0 +1,104 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * TelnetServer.cpp
+ *
+ ****/
+
+#ifndef DISABLE_NETWORK
+
+#include "TelnetServer.h"
+#include <debug_progmem.h>
+
+namespace CommandProcessing
+{
+class TelnetServer::Session : public TcpClient
+{
+public:
+	using TcpClient::TcpClient;
+
+	void receive(Handler& handler, const char* data, size_t size)
+	{
+		// Ignore TELNET escape sequences
+		constexpr char TC_ESC{'\xff'};
+		while(size-- > 0) {
+			char c = *data++;
+			if(skip) {
+				--skip;
+			} else if(c == TC_ESC) {
+				skip = 2;
+			} else {
+				handler.process(lineBuffer, output, c);
+			}
+		}
+	}
+
+	void print(const String& s)
+	{
+		output.print(s);
+	}
+
+	/*
+	 * Queue everything written since the last call as one send.
+	 * Actual transmission happens when receive processing returns to TcpConnection.
+	 */
+	bool flushOutput()
+	{
+		String s;
+		if(!output.moveString(s) || s.length() == 0) {
+			return true;
+		}
+		if(isSending()) {
+			return sendString(s);
+		}
+		return send(new MemoryDataStream(std::move(s)));
+	}
+
+private:
+	LineBuffer<MAX_COMMANDSIZE> lineBuffer;
+	MemoryDataStream output;
+	uint8_t skip{0};
+};
+
+TcpConnection* TelnetServer::createClient(tcp_pcb* clientTcp)
+{
+	if(!active) {
+		debug_w("Refusing new connections. The server is shutting down");
+		return nullptr;
+	}
+
+	return new Session(clientTcp, TcpClientDataDelegate(&TelnetServer::onClientReceive, this),
+					   TcpClientCompleteDelegate(&TelnetServer::onClientComplete, this));
+}
+
+void TelnetServer::onClient(TcpClient* client)
+{
+	TcpServer::onClient(client);
+
+	if(handler.isVerbose()) {
+		auto session = static_cast<Session*>(client);
+		session->print(handler.getCommandWelcomeMessage());
+		session->print(handler.getCommandPrompt());
+		// Nothing has been received, so send now rather than waiting for a poll
+		if(session->flushOutput()) {
+			session->commit();
+		}
+	}
+}
+
+bool TelnetServer::onClientReceive(TcpClient& client, char* data, int size)
+{
+	auto& session = static_cast<Session&>(client);
+	session.receive(handler, data, size);
+	if(!session.flushOutput()) {
+		debug_e("[CMDP] Output dropped for %s", client.getRemoteIp().toString().c_str());
+	}
+	return TcpServer::onClientReceive(client, data, size);
+}
+
+} // namespace CommandProcessing
+
+#endif // DISABLE_NETWORK
@@ -0,0 +1,59 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * TelnetServer.h - Command line interface for network clients
+ *
+ ****/
+
+#pragma once
+
+#include "Handler.h"
+#include <Network/TcpServer.h>
+
+namespace CommandProcessing
+{
+/**
+ * @brief Serve a command handler to telnet clients
+ * @ingroup commandhandler
+ *
+ * Each connection has its own line buffer and output, so several sessions may be in use at once.
+ * All share the command table, prompt and verbose setting of the handler.
+ *
+ * Output is gathered whilst received data is processed and queued as a single send,
+ * so a command printing many lines goes out in full segments rather than one per line.
+ * Socket options such as `setNoDelay()` and `cork()` apply as usual.
+ *
+ * @code
+ * CommandProcessing::Handler commandHandler;
+ * CommandProcessing::TelnetServer telnetServer(commandHandler);
+ *
+ * telnetServer.listen(23);
+ * @endcode
+ */
+class TelnetServer : public TcpServer
+{
+public:
+	TelnetServer(Handler& handler) : handler(handler)
+	{
+	}
+
+	Handler& getHandler()
+	{
+		return handler;
+	}
+
+protected:
+	TcpConnection* createClient(tcp_pcb* clientTcp) override;
+	void onClient(TcpClient* client) override;
+	bool onClientReceive(TcpClient& client, char* data, int size) override;
+
+private:
+	class Session;
+
+	Handler& handler;
+};
+
+} // namespace CommandProcessing
@@ -5,9 +5,15 @@ namespace CommandProcessing
 void enable(Handler& commandHandler, HardwareSerial& serial)
 {
 	commandHandler.setOutputStream(&serial, false);
-	Serial.onDataReceived([&commandHandler](Stream& source, char arrivedChar, uint16_t availableCharsCount) {
-		while(availableCharsCount--) {
-			commandHandler.process(source.read());
+	serial.onDataReceived([&commandHandler](Stream& source, char arrivedChar, uint16_t availableCharsCount) {
+		char buffer[32];
+		while(availableCharsCount != 0) {
+			size_t n = source.readBytes(buffer, std::min(size_t(availableCharsCount), sizeof(buffer)));
+			if(n == 0) {
+				break;
+			}
+			commandHandler.process(buffer, n);
+			availableCharsCount -= n;
 		}
 	});
 }
@@ -1 +1,6 @@
 COMPONENT_DEPENDS := OneWire
+
+# Maximum number of sensors on each bus
+COMPONENT_VARS := DS18S20_MAX_SENSORS
+DS18S20_MAX_SENSORS ?= 4
+GLOBAL_CFLAGS += -DDS18S20_MAX_SENSORS=$(DS18S20_MAX_SENSORS)
@@ -124,7 +124,10 @@ void DS18S20::DoSearch(void)
       debugx("  DBG: %d DS1820 sensors found",numberOf);
 
       numberOfread=0;
-      StartReadNext();
+      if (parallelMode)
+        StartConvertAll();
+      else
+        StartReadNext();
 	}
 
 
@@ -150,24 +153,63 @@ void DS18S20::StartReadNext()
    }
    else
    {
-	   debugx("  DBG: DS18S20 reading task end");
-	   InProgress=false;
-	   if(readEndCallback) //If callback set, execute function
-	   {
-		   readEndCallback();
-	   }
+	   MeasureComplete();
    }
 }
 
+void DS18S20::MeasureComplete()
+{
+	debugx("  DBG: DS18S20 reading task end");
+	InProgress=false;
+	if(readEndCallback) //If callback set, execute function
+	{
+		readEndCallback();
+	}
+}
+
 void DS18S20::DoMeasure()
 {
+	ReadSensor(numberOfread);
+
+	numberOfread++;
+	DelaysTimer.initializeMs<100>(TimerDelegate(&DS18S20::StartReadNext, this)).start(false);
+}
+
+void DS18S20::StartConvertAll()
+{
+	ds->reset();
+	ds->skip();
+	ds->write(STARTCONVO, 1);        // all sensors start conversion, with parasite power on at the end
+
+	DelaysTimer.initializeMs<DS1820_CONVERSION_TIME>(TimerDelegate(&DS18S20::DoReadAll, this)).start(false);
+}
+
+void DS18S20::DoReadAll()
+{
+	for (numberOfread = 0; numberOfread < numberOf; numberOfread++)
+	{
+		ReadSensor(numberOfread);
+	}
+
+	MeasureComplete();
+}
 
+void DS18S20::ReadSensor(uint8_t index)
+{
 	uint8_t present,i;
+
+	uint64_t tmp=addresses[index];
+	for (uint8_t a=0;a<8;a++)
+	{
+		addr[7-a]=(uint8_t)tmp;
+		tmp=tmp>>8;
+	}
+
 	present = ds->reset();
 	ds->select(addr);
 	ds->write(READSCRATCH);         // Read Scratchpad
 
-	debugx("  DBG: T%d",numberOfread+1);
+	debugx("  DBG: T%d",index+1);
 
 	for ( i = 0; i < 9; i++)
 	{
@@ -176,12 +218,19 @@ void DS18S20::DoMeasure()
 	}
 	debugx("  DBG: Data = %x %x %x %x %x %x %x %x %x %x  CRC=%x",present,data[0],data[1],data[2],data[3],data[4],data[5],data[6],data[7],data[8],OneWire::crc8(data, 8));
 
+	ValidTemperature[index] = present && OneWire::crc8(data, 8) == data[8];
+	if (!ValidTemperature[index])
+	{
+		debugx("  DBG: T%d scratchpad CRC is not valid", index+1);
+		return;
+	}
+
 	// Convert the data to actual temperature
 	// because the result is a 16 bit signed integer, it should
 	// be stored to an "int16_t" type, which is always 16 bits
 	// even when compiled on a 32 bit processor.
 	unsigned int raw = (data[1] << 8) | data[0];
-	if (type_s[numberOfread])
+	if (type_s[index])
 	{
 		raw = raw << 3; // 9 bit resolution default
 		if (data[7] == 0x10)
@@ -198,19 +247,14 @@ void DS18S20::DoMeasure()
 		//// default is 12 bit resolution, 750 ms conversion time
 	}
 
-	ValidTemperature[numberOfread]=true;
-	
     if (raw & 0x8000)   //is minus ?
-	  celsius[numberOfread] = 0 - ((float) ((raw ^ 0xffff) + 1) / 16.0); // 2's comp
+	  celsius[index] = 0 - ((float) ((raw ^ 0xffff) + 1) / 16.0); // 2's comp
 	else
-	  celsius[numberOfread] = (float)raw / 16.0;	
+	  celsius[index] = (float)raw / 16.0;	
 
-	fahrenheit[numberOfread] = celsius[numberOfread] * 1.8 + 32.0;
+	fahrenheit[index] = celsius[index] * 1.8 + 32.0;
 
-	debugx("  DBG: Temperature = %f Celsius, %f Fahrenheit",celsius[numberOfread],fahrenheit[numberOfread]);
-
-	numberOfread++;
-	DelaysTimer.initializeMs<100>(TimerDelegate(&DS18S20::StartReadNext, this)).start(false);
+	debugx("  DBG: Temperature = %f Celsius, %f Fahrenheit",celsius[index],fahrenheit[index]);
 
 }
 
@@ -225,7 +269,7 @@ float DS18S20::GetCelsius(uint8_t index)
 
 float DS18S20::GetFahrenheit(uint8_t index)
 {
-	  if (index <= numberOf)
+	  if (index < numberOf)
 	     return fahrenheit[index];
 	  else
 		 return 0;
@@ -235,7 +279,7 @@ float DS18S20::GetFahrenheit(uint8_t index)
 
 bool DS18S20::IsValidTemperature(uint8_t index)
 {
-	  if (index <= numberOf)
+	  if (index < numberOf)
 		  return ValidTemperature[index];
 	  else
 		  return false;
@@ -248,7 +292,7 @@ bool DS18S20::MeasureStatus()
 
 uint64_t DS18S20::GetSensorID(uint8_t index)
 {
-	  if (index <= numberOf)
+	  if (index < numberOf)
 		  return addresses[index];
 	  else
 		  return 0;
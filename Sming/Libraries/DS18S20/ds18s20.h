@@ -12,12 +12,18 @@
  *  @brief  This library provides access to DS18S20 temperature sensors connected via 1-Wire bus to a single GPIO
  *          The DS18S20 can run in several modes, with varying degrees of resolution. The highest resolution is 12-bit which provides 0.0625C resolution.
             12-bit measurement takes 750ms. With 4 sensors connected, measurement will take 3s.
+            In parallel mode all sensors on the bus convert together, so a measurement takes under a second
+            regardless of sensor count. Sensors on separate buses (one DS18S20 instance each) are measured concurrently.
  *  @ingroup    libraries
  *  @{
 */
 #include <Wire.h>
 
-#define MAX_SENSORS 4         ///< Maximum quantity of sensors to read
+#ifndef DS18S20_MAX_SENSORS
+#define DS18S20_MAX_SENSORS 4
+#endif
+
+#define MAX_SENSORS DS18S20_MAX_SENSORS ///< Maximum quantity of sensors to read
 
 // OneWire commands
 
@@ -31,6 +37,8 @@
 
 #define DS1820_WORK_PIN 2	// default DS1820 on GPIO2, can be changed by Init
 
+#define DS1820_CONVERSION_TIME 750 // Maximum time for 12-bit conversion, in milliseconds
+
 /** @brief  Definition of callback function called on completion of measurement of all DS18S20 sensors
     @note   Example: void onMeasurment() { ... };
 */
@@ -57,6 +65,17 @@ public:
     */
 	void StartMeasure();
 
+    /** @brief  Select how sensors are measured
+    *   @param  enable true to convert all sensors at once, false (default) to measure each in turn
+    *   @note   In parallel mode a single 'Convert T' command is broadcast (skip ROM) to the bus,
+    *           then all scratchpads are read in one pass once the conversion time has elapsed.
+    *           Parasite-powered sensors then draw current together, so the bus needs a strong pull-up.
+    */
+	void SetParallelMode(bool enable)
+	{
+		parallelMode = enable;
+	}
+
     /** @brief  Register the callback function that is run when measurement is complete
     *   @param  Name of the callback function
     *   @note   Callback function must be a DS18S20CommpleteDelegate type
@@ -113,11 +132,16 @@ private:
 	void DoMeasure();
 	void DoSearch();
 	void StartReadNext();
+	void StartConvertAll();
+	void DoReadAll();
+	void ReadSensor(uint8_t index);
+	void MeasureComplete();
 	uint8_t FindAlladdresses();
 
 private:
 	bool InProgress = false;
-	bool ValidTemperature[MAX_SENSORS];
+	bool parallelMode = false;
+	bool ValidTemperature[MAX_SENSORS]{};
 	uint8_t addr[8];
 	uint8_t type_s[MAX_SENSORS];
 	uint8_t data[12];
@@ -88,6 +88,51 @@ void MCP23017::writeRegister(uint8_t regAddr, uint8_t regValue){
 }
 
 
+/**
+ * Reads a register pair, A then B, in one transaction
+ */
+uint16_t MCP23017::readRegisterPair(uint8_t addr){
+	Wire.beginTransmission(MCP23017_ADDRESS | i2caddr);
+	wiresend(addr);
+	Wire.endTransmission();
+	Wire.requestFrom(MCP23017_ADDRESS | i2caddr, 2);
+	uint16_t value = wirerecv();
+	value |= wirerecv() << 8;
+	return value;
+}
+
+/**
+ * Writes a register pair, A then B, in one transaction
+ */
+void MCP23017::writeRegisterPair(uint8_t regAddr, uint16_t value){
+	Wire.beginTransmission(MCP23017_ADDRESS | i2caddr);
+	wiresend(regAddr);
+	wiresend(value & 0xFF);
+	wiresend(value >> 8);
+	Wire.endTransmission();
+}
+
+/**
+ * Helper to update a single bit of a cached A/B register.
+ * - Updates the cached value
+ * - Writes the register for that port, or marks it for commit() if batching
+ */
+void MCP23017::updateCache(uint16_t& cache, uint8_t pin, uint8_t value, uint8_t portAaddr, uint8_t flag) {
+	if (pin > 15) {
+		return;
+	}
+
+	bitWrite(cache,pin,value);
+
+	if (batching) {
+		dirty |= flag;
+		return;
+	}
+
+	uint8_t regAddr=regForPin(pin,portAaddr,portAaddr+1);
+	writeRegister(regAddr,(pin<8) ? (cache & 0xFF) : (cache >> 8));
+}
+
 /**
  * Helper to update a single bit of an A/B register.
  * - Reads the current register value
@@ -120,8 +165,14 @@ void MCP23017::begin(uint8_t addr) {
 
 	// set defaults!
 	// all inputs on port A and B
-	writeRegister(MCP23017_IODIRA,0xff);
-	writeRegister(MCP23017_IODIRB,0xff);
+	iodir = 0xffff;
+	writeRegisterPair(MCP23017_IODIRA,iodir);
+
+	// Existing latch and pull-up states are kept
+	gppu = readRegisterPair(MCP23017_GPPUA);
+	olat = readRegisterPair(MCP23017_OLATA);
+	dirty = 0;
+	batching = false;
 }
 
 /**
@@ -135,7 +186,7 @@ void MCP23017::begin(void) {
  * Sets the pin mode to either INPUT or OUTPUT
  */
 void MCP23017::pinMode(uint8_t p, uint8_t d) {
-	updateRegisterBit(p,(d==INPUT),MCP23017_IODIRA,MCP23017_IODIRB);
+	updateCache(iodir,p,(d==INPUT),MCP23017_IODIRA,dirtyIodir);
 }
 
 /**
@@ -182,32 +233,53 @@ uint8_t MCP23017::readGPIO(uint8_t b) {
  * Writes all the pins in one go. This method is very useful if you are implementing a multiplexed matrix and want to get a decent refresh rate.
  */
 void MCP23017::writeGPIOAB(uint16_t ba) {
-	Wire.beginTransmission(MCP23017_ADDRESS | i2caddr);
-	wiresend(MCP23017_GPIOA);
-	wiresend(ba & 0xFF);
-	wiresend(ba >> 8);
-	Wire.endTransmission();
+	olat = ba;
+	if (batching) {
+		dirty |= dirtyOlat;
+		return;
+	}
+	writeRegisterPair(MCP23017_OLATA,ba);
 }
 
-void MCP23017::digitalWrite(uint8_t pin, uint8_t d) {
-	uint8_t gpio;
-	uint8_t bit=bitForPin(pin);
-
-
-	// read the current GPIO output latches
-	uint8_t regAddr=regForPin(pin,MCP23017_OLATA,MCP23017_OLATB);
-	gpio = readRegister(regAddr);
+void MCP23017::writePort(uint8_t b, uint8_t value) {
+	if (b == 0) {
+		olat = (olat & 0xFF00) | value;
+	} else {
+		olat = (olat & 0x00FF) | (value << 8);
+	}
 
-	// set the pin and direction
-	bitWrite(gpio,bit,d);
+	if (batching) {
+		dirty |= dirtyOlat;
+		return;
+	}
+	writeRegister((b == 0) ? MCP23017_OLATA : MCP23017_OLATB,value);
+}
 
-	// write the new GPIO
-	regAddr=regForPin(pin,MCP23017_GPIOA,MCP23017_GPIOB);
-	writeRegister(regAddr,gpio);
+void MCP23017::digitalWrite(uint8_t pin, uint8_t d) {
+	// Output latches are cached, so no need to read them first
+	updateCache(olat,pin,d,MCP23017_OLATA,dirtyOlat);
 }
 
 void MCP23017::pullUp(uint8_t p, uint8_t d) {
-	updateRegisterBit(p,d,MCP23017_GPPUA,MCP23017_GPPUB);
+	updateCache(gppu,p,d,MCP23017_GPPUA,dirtyGppu);
+}
+
+/**
+ * Writes each register pair changed since beginBatch() in a single transaction
+ */
+void MCP23017::commit() {
+	batching = false;
+
+	if (dirty & dirtyIodir) {
+		writeRegisterPair(MCP23017_IODIRA,iodir);
+	}
+	if (dirty & dirtyGppu) {
+		writeRegisterPair(MCP23017_GPPUA,gppu);
+	}
+	if (dirty & dirtyOlat) {
+		writeRegisterPair(MCP23017_OLATA,olat);
+	}
+	dirty = 0;
 }
 
 uint8_t MCP23017::digitalRead(uint8_t pin) {
@@ -288,4 +360,38 @@ uint8_t MCP23017::getLastInterruptPinValue(){
 	return MCP23017_INT_ERR;
 }
 
+/**
+ * INTFA, INTFB, INTCAPA and INTCAPB are consecutive, so can be read together.
+ * Reading INTCAP clears the interrupt.
+ */
+void MCP23017::readInterrupt(uint16_t& flags, uint16_t& captured){
+	Wire.beginTransmission(MCP23017_ADDRESS | i2caddr);
+	wiresend(MCP23017_INTFA);
+	Wire.endTransmission();
+
+	Wire.requestFrom(MCP23017_ADDRESS | i2caddr, 4);
+	flags = wirerecv();
+	flags |= wirerecv() << 8;
+	captured = wirerecv();
+	captured |= wirerecv() << 8;
+}
+
+void MCP23017::onInterrupt(uint8_t pin, MCP23017InterruptDelegate callback, uint8_t mode){
+	interruptCallback = callback;
+	if (!callback) {
+		detachInterrupt(pin);
+		return;
+	}
 
+	// Delegate is invoked in task context, so I2C is safe to use
+	attachInterrupt(pin, InterruptDelegate(&MCP23017::handleInterrupt, this), mode);
+}
+
+void MCP23017::handleInterrupt(){
+	uint16_t flags;
+	uint16_t captured;
+	readInterrupt(flags, captured);
+	if (flags != 0 && interruptCallback) {
+		interruptCallback(flags, captured);
+	}
+}
@@ -20,7 +20,23 @@
 #else
 #include <Wire.h>
 #endif
-
+#include <Interrupts.h>
+
+/**
+ * Called in task context when the MCP23017 signals an interrupt.
+ * @param flags Pins which caused the interrupt (INTFB:INTFA)
+ * @param captured Port values at the time of the interrupt (INTCAPB:INTCAPA)
+ */
+typedef Delegate<void(uint16_t flags, uint16_t captured)> MCP23017InterruptDelegate;
+
+/**
+ * Direction, pull-up and output latch registers are cached so pin changes
+ * are a single register write, with no read-modify-write over the bus.
+ *
+ * Between beginBatch() and commit() changes only update the cache. commit() then
+ * writes each modified register pair in a single transaction, so all 16 outputs
+ * can be updated at once.
+ */
 class MCP23017 {
 public:
   void begin(uint8_t addr);
@@ -35,13 +51,64 @@ public:
   uint16_t readGPIOAB();
   uint8_t readGPIO(uint8_t b);
 
+  /**
+   * Set all outputs on one port. Parameter b should be 0 for port A, and 1 for port B.
+   */
+  void writePort(uint8_t b, uint8_t value);
+
+  /**
+   * Get the cached output latch values (OLATB:OLATA)
+   */
+  uint16_t getOutputs() const { return olat; }
+
+  /**
+   * Defer register writes until commit()
+   */
+  void beginBatch() { batching = true; }
+
+  /**
+   * Write all registers changed since beginBatch()
+   */
+  void commit();
+
   void setupInterrupts(uint8_t mirroring, uint8_t open, uint8_t polarity);
   void setupInterruptPin(uint8_t p, uint8_t mode);
   uint8_t getLastInterruptPin();
   uint8_t getLastInterruptPinValue();
 
+  /**
+   * Read interrupt flags and captured values for both ports in one transaction.
+   * This clears the interrupt condition.
+   */
+  void readInterrupt(uint16_t& flags, uint16_t& captured);
+
+  /**
+   * Handle interrupts from the INTA pin, connected to the given GPIO.
+   * Enable mirroring with setupInterrupts() so INTA also reports port B changes.
+   * Pass a null callback to detach.
+   * @param mode FALLING for the default active-low INT output
+   */
+  void onInterrupt(uint8_t pin, MCP23017InterruptDelegate callback, uint8_t mode = FALLING);
+
  private:
+  enum {
+    dirtyIodir = 0x01,
+    dirtyGppu = 0x02,
+    dirtyOlat = 0x04,
+  };
+
   uint8_t i2caddr;
+  uint16_t iodir = 0xffff;
+  uint16_t gppu = 0;
+  uint16_t olat = 0;
+  uint8_t dirty = 0;
+  bool batching = false;
+  MCP23017InterruptDelegate interruptCallback;
+
+  void handleInterrupt();
+  void updateCache(uint16_t& cache, uint8_t pin, uint8_t value, uint8_t portAaddr, uint8_t flag);
+  uint16_t readRegisterPair(uint8_t addr);
+  void writeRegisterPair(uint8_t addr, uint16_t value);
 
   uint8_t bitForPin(uint8_t pin);
   uint8_t regForPin(uint8_t pin, uint8_t portAaddr, uint8_t portBaddr);
@@ -11,8 +11,11 @@
  Output write
  Input read
 
- Interrupt features are not implemented in this version
- byte based (portA, portB) functions are not implemented in this version
+ Batched writes: between beginBatch() and commit() changes only update the caches,
+ then each modified register pair is written in a single transaction.
+ Port write: writePort()
+ Interrupt on change: onInterrupt() reads flags and captured values in one transaction.
+ Configure GPINTEN, DEFVAL and INTCON using wordWrite().
 
  NOTE:  Addresses below are only valid when IOCON.BANK=0 (register addressing mode)
  This means one of the control register values can change register addresses!
@@ -50,6 +53,8 @@ MCP::MCP(uint8_t address, uint8_t cs)
 	_outputCache = 0x0000;            // Default output state is all off, 0x0000
 	_pullupCache = 0x0000;           // Default pull-up state is all off, 0x0000
 	_invertCache = 0x0000; // Default input inversion state is not inverted, 0x0000
+	_dirty = 0;
+	_batching = false;
 }
 
 void MCP::begin()
@@ -64,18 +69,16 @@ void MCP::begin()
 	byteWrite(IOCON, ADDR_ENABLE);
 }
 
-// GENERIC BYTE WRITE - will write a byte to a register, arguments are register address and the value to write
+// SINGLE TRANSACTION - opcode, register and data are sent with CS held low throughout
 
-void MCP::byteWrite(uint8_t reg, uint8_t value)
-{      // Accept the register and byte
+void MCP::transfer(uint8_t* buffer, size_t length)
+{
 #ifdef CS_PIN_16
 	::digitalWrite(_cs, LOW);
 #else
 	GPIO_REG_WRITE(GPIO_OUT_W1TC_ADDRESS, _csBitmask);
 #endif
-	SPI.transfer(_wcmd); // Send the MCP23S17 opcode, chip address, and write bit
-	SPI.transfer(reg);                     // Send the register we want to write
-	SPI.transfer(value);                                 // Send the byte
+	SPI.transfer(buffer, length);
 #ifdef CS_PIN_16
 	::digitalWrite(_cs, HIGH);
 #else
@@ -83,24 +86,56 @@ void MCP::byteWrite(uint8_t reg, uint8_t value)
 #endif
 }
 
+// GENERIC BYTE WRITE - will write a byte to a register, arguments are register address and the value to write
+
+void MCP::byteWrite(uint8_t reg, uint8_t value)
+{
+	uint8_t buffer[]{_wcmd, reg, value}; // Opcode with chip address and write bit, register, then the byte
+	transfer(buffer, sizeof(buffer));
+}
+
 // GENERIC WORD WRITE - will write a word to a register pair, LSB to first register, MSB to next higher value register 
 
 void MCP::wordWrite(uint8_t reg, unsigned int word)
-{  // Accept the start register and word
-#ifdef CS_PIN_16
-	::digitalWrite(_cs, LOW);
-#else
-	GPIO_REG_WRITE(GPIO_OUT_W1TC_ADDRESS, _csBitmask);
-#endif
-	SPI.transfer(_wcmd); // Send the MCP23S17 opcode, chip address, and write bit
-	SPI.transfer(reg);                    // Send the register we want to write
-	SPI.transfer((uint8_t) (word)); // Send the low byte (register address pointer will auto-increment after write)
-	SPI.transfer((uint8_t) (word >> 8)); // Shift the high byte down to the low byte location and send
-#ifdef CS_PIN_16
-	::digitalWrite(_cs, HIGH);
-#else
-	GPIO_REG_WRITE(GPIO_OUT_W1TS_ADDRESS, _csBitmask);
-#endif
+{
+	// Register address pointer auto-increments after the low byte
+	uint8_t buffer[]{_wcmd, reg, uint8_t(word), uint8_t(word >> 8)};
+	transfer(buffer, sizeof(buffer));
+}
+
+// CACHED WRITE - all setting functions update their cache then write the register pair, unless batching
+
+void MCP::store(unsigned int& cache, unsigned int value, uint8_t reg, uint8_t flag)
+{
+	cache = value;
+	if (_batching) {
+		_dirty |= flag;
+		return;
+	}
+	wordWrite(reg, value);
+}
+
+void MCP::beginBatch()
+{
+	_batching = true;
+}
+
+void MCP::commit()
+{
+	_batching = false;
+	if (_dirty & dirtyMode) {
+		wordWrite(IODIRA, _modeCache);
+	}
+	if (_dirty & dirtyPullup) {
+		wordWrite(GPPUA, _pullupCache);
+	}
+	if (_dirty & dirtyInvert) {
+		wordWrite(IPOLA, _invertCache);
+	}
+	if (_dirty & dirtyOutput) {
+		wordWrite(GPIOA, _outputCache);
+	}
+	_dirty = 0;
 }
 
 // MODE SETTING FUNCTIONS - BY PIN AND BY WORD
@@ -111,21 +146,14 @@ void MCP::pinMode(uint8_t pin, uint8_t mode)
 		return; // If the pin value is not valid (0-15) return, do nothing and return
 	}
 
-	if (mode == INPUT)
-	{      // Determine the mode before changing the bit state in the mode cache
-		_modeCache |= 1 << pin; // Since input = "HIGH", OR in a 1 in the appropriate place
-	}
-	else
-	{
-		_modeCache &= ~(1 << pin); // If not, the mode must be output, so and in a 0 in the appropriate place
-	}
-	wordWrite(IODIRA, _modeCache); // Call the generic word writer with start register and the mode cache
+	// Since input = "HIGH", OR in a 1 in the appropriate place, otherwise AND in a 0
+	auto value = (mode == INPUT) ? (_modeCache | (1 << pin)) : (_modeCache & ~(1 << pin));
+	store(_modeCache, value, IODIRA, dirtyMode);
 }
 
 void MCP::pinMode(unsigned int mode)
-{    // Accept the word�
-	wordWrite(IODIRA, mode); // Call the the generic word writer with start register and the mode cache
-	_modeCache = mode;
+{
+	store(_modeCache, mode, IODIRA, dirtyMode);
 }
 
 // THE FOLLOWING WRITE FUNCTIONS ARE NEARLY IDENTICAL TO THE FIRST AND ARE NOT INDIVIDUALLY COMMENTED
@@ -138,21 +166,13 @@ void MCP::pullupMode(uint8_t pin, uint8_t mode)
 		return;
 	}
 
-	if (mode == ON)
-	{
-		_pullupCache |= 1 << pin;
-	}
-	else
-	{
-		_pullupCache &= ~(1 << pin);
-	}
-	wordWrite(GPPUA, _pullupCache);
+	auto value = (mode == ON) ? (_pullupCache | (1 << pin)) : (_pullupCache & ~(1 << pin));
+	store(_pullupCache, value, GPPUA, dirtyPullup);
 }
 
 void MCP::pullupMode(unsigned int mode)
 {
-	wordWrite(GPPUA, mode);
-	_pullupCache = mode;
+	store(_pullupCache, mode, GPPUA, dirtyPullup);
 }
 
 // INPUT INVERSION SETTING FUNCTIONS - BY WORD AND BY PIN
@@ -163,24 +183,16 @@ void MCP::inputInvert(uint8_t pin, uint8_t mode)
 		return;
 	}
 
-	if (mode == ON)
-	{
-		_invertCache |= 1 << pin;
-	}
-	else
-	{
-		_invertCache &= ~(1 << pin);
-	}
-	wordWrite(IPOLA, _invertCache);
+	auto value = (mode == ON) ? (_invertCache | (1 << pin)) : (_invertCache & ~(1 << pin));
+	store(_invertCache, value, IPOLA, dirtyInvert);
 }
 
 void MCP::inputInvert(unsigned int mode)
 {
-	wordWrite(IPOLA, mode);
-	_invertCache = mode;
+	store(_invertCache, mode, IPOLA, dirtyInvert);
 }
 
-// WRITE FUNCTIONS - BY WORD AND BY PIN
+// WRITE FUNCTIONS - BY WORD, BYTE AND BY PIN
 
 void MCP::digitalWrite(uint8_t pin, uint8_t value)
 {
@@ -188,62 +200,45 @@ void MCP::digitalWrite(uint8_t pin, uint8_t value)
 		return;
 	}
 
-	if (value)
-	{
-		_outputCache |= 1 << pin;
-	}
-	else
-	{
-		_outputCache &= ~(1 << pin);
-	}
-	wordWrite(GPIOA, _outputCache);
+	auto output = value ? (_outputCache | (1 << pin)) : (_outputCache & ~(1 << pin));
+	store(_outputCache, output, GPIOA, dirtyOutput);
 }
 
 void MCP::digitalWrite(unsigned int value)
 {
-	wordWrite(GPIOA, value);
-	_outputCache = value;
+	store(_outputCache, value, GPIOA, dirtyOutput);
+}
+
+void MCP::writePort(uint8_t port, uint8_t value)
+{
+	if (port > 1) {
+		return;
+	}
+
+	auto output = port ? ((_outputCache & 0x00FF) | (value << 8)) : ((_outputCache & 0xFF00) | value);
+	_outputCache = output;
+	if (_batching) {
+		_dirty |= dirtyOutput;
+		return;
+	}
+	byteWrite(GPIOA + port, value);
 }
 
 // READ FUNCTIONS - BY WORD, BYTE AND BY PIN
 
 unsigned int MCP::digitalRead(void)
 { // This function will read all 16 bits of I/O, and return them as a word in the format 0x(portB)(portA)
-	unsigned int value = 0; // Initialize a variable to hold the read values to be returned
-#ifdef CS_PIN_16
-	::digitalWrite(_cs, LOW);
-#else
-	GPIO_REG_WRITE(GPIO_OUT_W1TC_ADDRESS, _csBitmask);
-#endif
-	SPI.transfer(_rcmd); // Send the MCP23S17 opcode, chip address, and read bit
-	SPI.transfer(GPIOA);                    // Send the register we want to read
-	value = SPI.transfer(0x00); // Send any byte, the function will return the read value (register address pointer will auto-increment after write)
-	value |= (SPI.transfer(0x00) << 8); // Read in the "high byte" (portB) and shift it up to the high location and merge with the "low byte"
-#ifdef CS_PIN_16
-	::digitalWrite(_cs, HIGH);
-#else
-	GPIO_REG_WRITE(GPIO_OUT_W1TS_ADDRESS, _csBitmask);
-#endif
-	return value; // Return the constructed word, the format is 0x(portB)(portA)
+	// Register address pointer auto-increments, so portA then portB are returned
+	uint8_t buffer[]{_rcmd, GPIOA, 0, 0};
+	transfer(buffer, sizeof(buffer));
+	return buffer[2] | (buffer[3] << 8);
 }
 
 uint8_t MCP::byteRead(uint8_t reg)
 {        // This function will read a single register, and return it
-	uint8_t value = 0; // Initialize a variable to hold the read values to be returned
-#ifdef CS_PIN_16
-	::digitalWrite(_cs, LOW);
-#else
-	GPIO_REG_WRITE(GPIO_OUT_W1TC_ADDRESS, _csBitmask);
-#endif
-	SPI.transfer(_rcmd); // Send the MCP23S17 opcode, chip address, and read bit
-	SPI.transfer(reg);                      // Send the register we want to read
-	value = SPI.transfer(0x00); // Send any byte, the function will return the read value
-#ifdef CS_PIN_16
-	::digitalWrite(_cs, HIGH);
-#else
-	GPIO_REG_WRITE(GPIO_OUT_W1TS_ADDRESS, _csBitmask);
-#endif
-	return value; // Return the constructed word, the format is 0x(register value)
+	uint8_t buffer[]{_rcmd, reg, 0};
+	transfer(buffer, sizeof(buffer));
+	return buffer[2];
 }
 
 uint8_t MCP::digitalRead(uint8_t pin)
@@ -254,3 +249,36 @@ uint8_t MCP::digitalRead(uint8_t pin)
 
 	return digitalRead() & (1 << pin) ? HIGH : LOW; // Call the word reading function, extract HIGH/LOW information from the requested pin
 }
+
+// INTERRUPT FUNCTIONS
+
+void MCP::readInterrupt(unsigned int& flags, unsigned int& captured)
+{
+	// INTFA, INTFB, INTCAPA and INTCAPB are consecutive. Reading INTCAP clears the interrupt.
+	uint8_t buffer[]{_rcmd, INTFA, 0, 0, 0, 0};
+	transfer(buffer, sizeof(buffer));
+	flags = buffer[2] | (buffer[3] << 8);
+	captured = buffer[4] | (buffer[5] << 8);
+}
+
+void MCP::onInterrupt(uint8_t pin, MCPInterruptDelegate callback, uint8_t mode)
+{
+	_interruptCallback = callback;
+	if (!callback) {
+		detachInterrupt(pin);
+		return;
+	}
+
+	// Delegate is invoked in task context, so SPI is safe to use
+	attachInterrupt(pin, InterruptDelegate(&MCP::handleInterrupt, this), mode);
+}
+
+void MCP::handleInterrupt()
+{
+	unsigned int flags;
+	unsigned int captured;
+	readInterrupt(flags, captured);
+	if (flags != 0 && _interruptCallback) {
+		_interruptCallback(flags, captured);
+	}
+}
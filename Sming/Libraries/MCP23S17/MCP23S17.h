@@ -11,8 +11,11 @@
  Output write
  Input read
 
- Interrupt features are not implemented in this version
- byte based (portA, portB) functions are not implemented in this version
+ Batched writes: between beginBatch() and commit() changes only update the caches,
+ then each modified register pair is written in a single transaction.
+ Port write: writePort()
+ Interrupt on change: onInterrupt() reads flags and captured values in one transaction.
+ Configure GPINTEN, DEFVAL and INTCON using wordWrite().
 
  NOTE:  Addresses below are only valid when IOCON.BANK=0 (register addressing mode)
  This means one of the control register values can change register addresses!
@@ -91,6 +94,9 @@ namespace MCP23S17Constants {
 #include "WProgram.h"
 #endif
 
+// Called in task context, flags and captured values are 0x(portB)(portA)
+typedef Delegate<void(unsigned int flags, unsigned int captured)> MCPInterruptDelegate;
+
 class MCP
 {
 public:
@@ -109,7 +115,23 @@ public:
 	uint8_t digitalRead(uint8_t);            // Reads an individual input pin
 	uint8_t byteRead(uint8_t); // Reads an individual register and returns the byte. Argument is the register address
 	unsigned int digitalRead(void); // Reads all input  pins at once. Be sure it ignore the value of pins configured as output!
+	void writePort(uint8_t, uint8_t); // Sets all output pins on one port (0 for portA, 1 for portB)
+	void beginBatch(); // Defer writes: changes made until commit() only update the caches
+	void commit(); // Write each register pair changed since beginBatch() in one transaction
+	void readInterrupt(unsigned int& flags, unsigned int& captured); // Reads INTF and INTCAP registers, clears interrupt
+	void onInterrupt(uint8_t, MCPInterruptDelegate, uint8_t mode = FALLING); // Handle INT output connected to given GPIO, null callback to detach
 private:
+	enum {
+		dirtyMode = 0x01,
+		dirtyPullup = 0x02,
+		dirtyInvert = 0x04,
+		dirtyOutput = 0x08,
+	};
+
+	void transfer(uint8_t* buffer, size_t length); // One SPI transaction, buffer is overwritten with received data
+	void store(unsigned int& cache, unsigned int value, uint8_t reg, uint8_t flag); // Update cache then write register pair, or defer if batching
+	void handleInterrupt();
+
 	uint8_t _address; // Address of the MCP23S17 in use
 	uint8_t _cs; // CS pin number for MCP23S17
 	uint32_t _csBitmask; //CS bitmask for FAST GPIO
@@ -119,6 +141,9 @@ private:
 	unsigned int _pullupCache; // Caches the internal pull-up configuration of input pins (values persist across mode changes)
 	unsigned int _invertCache; // Caches the input pin inversion selection (values persist across mode changes)
 	unsigned int _outputCache;            // Caches the output pin state of pins
+	uint8_t _dirty;                       // Caches modified since beginBatch()
+	bool _batching;
+	MCPInterruptDelegate _interruptCallback;
 };
 
 #endif //MCP23S17
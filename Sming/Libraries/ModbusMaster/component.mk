@@ -1,8 +1,14 @@
 COMPONENT_SUBMODULES := ModbusMaster
-COMPONENT_SRCDIRS := ModbusMaster/src
-COMPONENT_INCDIRS := ModbusMaster/src
+COMPONENT_SRCDIRS := ModbusMaster/src src/Modbus
+COMPONENT_INCDIRS := ModbusMaster/src src
+COMPONENT_DEPENDS := crypto
 
 # Configurable Modbus response timeout
 COMPONENT_VARS += MB_RESPONSE_TIMEOUT
 MB_RESPONSE_TIMEOUT ?= 300
 COMPONENT_CXXFLAGS := -DMB_RESPONSE_TIMEOUT=$(MB_RESPONSE_TIMEOUT)
+
+# Request queue length for Modbus::AsyncMaster
+COMPONENT_VARS += MB_QUEUE_SIZE
+MB_QUEUE_SIZE ?= 8
+GLOBAL_CFLAGS += -DMB_QUEUE_SIZE=$(MB_QUEUE_SIZE)
@@ -0,0 +1,315 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * AsyncMaster.cpp
+ *
+ ****/
+
+#include "AsyncMaster.h"
+#include "Crc.h"
+#include <debug_progmem.h>
+
+#ifndef MB_RESPONSE_TIMEOUT
+#define MB_RESPONSE_TIMEOUT 300
+#endif
+
+namespace Modbus
+{
+namespace
+{
+bool isRead(Function function)
+{
+	return uint8_t(function) <= uint8_t(Function::readInputRegisters);
+}
+
+// Read requests must have responses fitting in a single ADU
+uint16_t maxReadQuantity(Function function)
+{
+	return (function <= Function::readDiscreteInputs) ? 2000 : 125;
+}
+
+} // namespace
+
+AsyncMaster::AsyncMaster(HardwareSerial& serial) : serial(serial), responseTimeout(MB_RESPONSE_TIMEOUT)
+{
+}
+
+bool AsyncMaster::begin()
+{
+	if(!serial.onFrameReceived(FrameReceivedDelegate(&AsyncMaster::frameReceived, this)) ||
+	   !serial.onTransmitComplete(TransmitCompleteDelegate(&AsyncMaster::transmitComplete, this))) {
+		return false;
+	}
+
+	active = true;
+	if(state == State::idle) {
+		next();
+	}
+	return true;
+}
+
+void AsyncMaster::end()
+{
+	if(!active) {
+		cancel();
+		return;
+	}
+
+	active = false;
+	timer.stop();
+	serial.onFrameReceived(nullptr);
+	serial.onTransmitComplete(nullptr);
+	if(state == State::transmitting && postTx) {
+		postTx();
+	}
+	state = State::idle;
+	cancel();
+}
+
+bool AsyncMaster::enqueue(uint8_t slave, Function function, uint16_t address, uint16_t value,
+						  const uint16_t* values, uint8_t valueCount, Callback callback)
+{
+	if(cancelling || count >= MB_QUEUE_SIZE) {
+		return false;
+	}
+
+	if(isRead(function) && (value == 0 || value > maxReadQuantity(function))) {
+		return false;
+	}
+
+	auto& req = queue[(head + count) % MB_QUEUE_SIZE];
+	req.address = address;
+	req.quantity = isRead(function) ? value : 1;
+
+	auto adu = req.adu;
+	*adu++ = slave;
+	*adu++ = uint8_t(function);
+	*adu++ = address >> 8;
+	*adu++ = address;
+	*adu++ = value >> 8;
+	*adu++ = value;
+	if(values != nullptr) {
+		*adu++ = valueCount * 2;
+		for(unsigned i = 0; i < valueCount; ++i) {
+			*adu++ = values[i] >> 8;
+			*adu++ = values[i];
+		}
+		req.quantity = valueCount;
+	}
+	uint16_t crc = crc16(req.adu, adu - req.adu);
+	*adu++ = crc;
+	*adu++ = crc >> 8;
+	req.length = adu - req.adu;
+	req.callback = callback;
+
+	++count;
+	if(state == State::idle) {
+		next();
+	}
+	return true;
+}
+
+bool AsyncMaster::writeMultipleRegisters(uint8_t slave, uint16_t address, const uint16_t* values, uint8_t count,
+										 Callback callback)
+{
+	if(values == nullptr || count == 0 || count > maxWriteCount) {
+		return false;
+	}
+	return enqueue(slave, Function::writeMultipleRegisters, address, count, values, count, callback);
+}
+
+void AsyncMaster::cancel()
+{
+	// Request on the wire must wait for its response
+	unsigned keep = (state == State::transmitting || state == State::waiting) ? 1 : 0;
+
+	// Callbacks cannot add requests whilst the queue is being emptied
+	cancelling = true;
+	while(count > keep) {
+		auto& req = queue[(head + count - 1) % MB_QUEUE_SIZE];
+		Response response{Status::cancelled, req.adu[0], Function(req.adu[1]), req.address, req.quantity, nullptr, 0};
+		auto callback = std::move(req.callback);
+		req.callback = nullptr;
+		--count;
+		if(callback) {
+			callback(response);
+		}
+	}
+	cancelling = false;
+}
+
+void AsyncMaster::next()
+{
+	if(!active || count == 0) {
+		state = State::idle;
+		return;
+	}
+
+	transmit();
+}
+
+void AsyncMaster::transmit()
+{
+	auto& req = current();
+
+	serial.clear(SERIAL_RX_ONLY);
+	rxLength = 0;
+
+	if(preTx) {
+		preTx();
+	}
+	state = State::transmitting;
+	serial.write(req.adu, req.length);
+
+	// Guard against missing transmit complete notification
+	auto txTime = 1 + (req.length * 11000U) / serial.baudRate();
+	timer.initializeMs(txTime + responseTimeout, timerCallback, this).startOnce();
+}
+
+void AsyncMaster::transmitComplete(HardwareSerial&)
+{
+	if(state != State::transmitting) {
+		return;
+	}
+
+	if(postTx) {
+		postTx();
+	}
+
+	// Discard any local echo
+	serial.clear(SERIAL_RX_ONLY);
+	rxLength = 0;
+
+	if(current().adu[0] == 0) {
+		// Broadcast, no response expected
+		complete(Status::success);
+		return;
+	}
+
+	state = State::waiting;
+	timer.initializeMs(responseTimeout, timerCallback, this).startOnce();
+}
+
+void AsyncMaster::frameReceived(HardwareSerial&, size_t)
+{
+	if(state != State::waiting) {
+		serial.clear(SERIAL_RX_ONLY);
+		return;
+	}
+
+	while(rxLength < sizeof(rxBuffer)) {
+		int c = serial.read();
+		if(c < 0) {
+			break;
+		}
+		rxBuffer[rxLength++] = c;
+	}
+
+	checkResponse();
+}
+
+void AsyncMaster::checkResponse()
+{
+	if(rxLength < 5) {
+		return;
+	}
+
+	// Response length can be determined from its header
+	auto& req = current();
+	uint8_t function = rxBuffer[1];
+	unsigned length;
+	if(function & 0x80) {
+		length = 5;
+	} else if(isRead(Function(function))) {
+		length = 5 + rxBuffer[2];
+	} else {
+		length = 8;
+	}
+	if(rxLength < length) {
+		// Wait for rest of frame
+		return;
+	}
+
+	uint16_t crc = rxBuffer[length - 2] | (rxBuffer[length - 1] << 8);
+	Status status;
+	if(crc16(rxBuffer, length - 2) != crc) {
+		status = Status::invalidCrc;
+	} else if(rxBuffer[0] != req.adu[0]) {
+		status = Status::invalidSlaveId;
+	} else if((function & 0x7F) != req.adu[1]) {
+		status = Status::invalidFunction;
+	} else if(function & 0x80) {
+		status = Status(rxBuffer[2]);
+	} else {
+		status = Status::success;
+	}
+
+	complete(status);
+}
+
+void AsyncMaster::complete(Status status)
+{
+	timer.stop();
+
+	auto& req = current();
+	Response response{status, req.adu[0], Function(req.adu[1]), req.address, req.quantity, nullptr, 0};
+	if(status == Status::success && isRead(response.function)) {
+		response.data = &rxBuffer[3];
+		response.size = rxBuffer[2];
+	}
+
+	if(status == Status::responseTimedOut) {
+		++stats.timeouts;
+	} else if(status != Status::success) {
+		++stats.errors;
+	}
+	++stats.transactions;
+
+	auto callback = std::move(req.callback);
+	req.callback = nullptr;
+	head = (head + 1) % MB_QUEUE_SIZE;
+	--count;
+
+	// Any requests queued by callback wait for the gap to expire
+	startGap();
+
+	if(callback) {
+		callback(response);
+	}
+}
+
+void AsyncMaster::startGap()
+{
+	// 3.5 character times, fixed above 19200 baud
+	auto baudRate = serial.baudRate();
+	uint32_t gap = (baudRate > 19200) ? 1750 : 38500000U / baudRate;
+
+	state = State::gap;
+	timer.initializeUs(gap, timerCallback, this).startOnce();
+}
+
+void AsyncMaster::timerCallback(void* param)
+{
+	auto master = static_cast<AsyncMaster*>(param);
+	switch(master->state) {
+	case State::transmitting:
+		if(master->postTx) {
+			master->postTx();
+		}
+		[[fallthrough]];
+	case State::waiting:
+		debug_w("[MB] Slave %u timeout", master->current().adu[0]);
+		master->complete(Status::responseTimedOut);
+		break;
+	case State::gap:
+		master->next();
+		break;
+	case State::idle:
+		break;
+	}
+}
+
+} // namespace Modbus
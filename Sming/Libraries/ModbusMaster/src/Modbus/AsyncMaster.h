@@ -0,0 +1,285 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * AsyncMaster.h - Non-blocking Modbus RTU master
+ *
+ ****/
+
+#pragma once
+
+#include <HardwareSerial.h>
+#include <SimpleTimer.h>
+#include <Delegate.h>
+
+/**
+ * @brief Number of requests which may be queued
+ */
+#ifndef MB_QUEUE_SIZE
+#define MB_QUEUE_SIZE 8
+#endif
+
+namespace Modbus
+{
+enum class Function : uint8_t {
+	readCoils = 0x01,
+	readDiscreteInputs = 0x02,
+	readHoldingRegisters = 0x03,
+	readInputRegisters = 0x04,
+	writeSingleCoil = 0x05,
+	writeSingleRegister = 0x06,
+	writeMultipleRegisters = 0x10,
+};
+
+/**
+ * @brief Transaction result
+ * @note Values are as used by ModbusMaster where it has an equivalent
+ */
+enum class Status : uint8_t {
+	success = 0x00,
+	// Exception codes returned by slave
+	illegalFunction = 0x01,
+	illegalDataAddress = 0x02,
+	illegalDataValue = 0x03,
+	slaveDeviceFailure = 0x04,
+	// Detected by master
+	invalidSlaveId = 0xE0,
+	invalidFunction = 0xE1,
+	responseTimedOut = 0xE2,
+	invalidCrc = 0xE3,
+	cancelled = 0xF0, ///< Request removed from queue by `cancel()`
+};
+
+/**
+ * @brief Event-driven Modbus RTU master
+ *
+ * Requests are queued and sent in turn, for any mix of slave addresses, with completion
+ * reported via callback. Nothing blocks: responses are collected using the serial
+ * frame received callback and a timer provides response timeouts and the
+ * inter-frame gap required before the next request.
+ *
+ * @code
+ * HardwareSerial modbusPort(UART_ID_0);
+ * Modbus::AsyncMaster master(modbusPort);
+ *
+ * void pollSlave(uint8_t slave)
+ * {
+ * 	master.readHoldingRegisters(slave, 100, 4, [](const Modbus::AsyncMaster::Response& response) {
+ * 		if(response.status == Modbus::Status::success) {
+ * 			debug_i("Slave %u: %u", response.slave, response.getRegister(0));
+ * 		}
+ * 	});
+ * }
+ * @endcode
+ *
+ * The serial port must be configured for full duplex with a receive buffer large enough
+ * for the longest response (256 bytes maximum).
+ * The master takes over its receive and transmit complete callbacks.
+ */
+class AsyncMaster
+{
+public:
+	/**
+	 * @brief Maximum number of registers in a single write request
+	 */
+	static constexpr uint8_t maxWriteCount{16};
+
+	/**
+	 * @brief Completed transaction information passed to callback
+	 */
+	struct Response {
+		Status status;
+		uint8_t slave;
+		Function function;
+		uint16_t address;
+		uint16_t quantity;
+		const uint8_t* data; ///< For read requests, data following the byte count
+		uint8_t size;		 ///< Number of bytes in data
+
+		uint16_t getRegister(unsigned index) const
+		{
+			return (2 * index + 1 < size) ? (data[2 * index] << 8) | data[2 * index + 1] : 0;
+		}
+
+		bool getBit(unsigned index) const
+		{
+			return (index / 8 < size) && (data[index / 8] & (1 << (index % 8)));
+		}
+	};
+
+	using Callback = Delegate<void(const Response& response)>;
+	using TransmissionCallback = Delegate<void()>;
+
+	struct Stats {
+		uint32_t transactions;
+		uint32_t errors;   ///< Exception, CRC or address errors
+		uint32_t timeouts; ///< No complete response received
+	};
+
+	AsyncMaster(HardwareSerial& serial);
+
+	~AsyncMaster()
+	{
+		end();
+	}
+
+	/**
+	 * @brief Register serial callbacks and start processing requests
+	 */
+	bool begin();
+
+	/**
+	 * @brief Cancel all requests and release serial port
+	 */
+	void end();
+
+	/**
+	 * @brief Set time allowed for a slave to respond, from end of transmission
+	 */
+	void setResponseTimeout(uint16_t milliseconds)
+	{
+		responseTimeout = milliseconds;
+	}
+
+	/**
+	 * @brief Called before sending a request, e.g. to enable RS485 driver
+	 */
+	void preTransmission(TransmissionCallback callback)
+	{
+		preTx = callback;
+	}
+
+	/**
+	 * @brief Called when the last byte of a request has been sent
+	 */
+	void postTransmission(TransmissionCallback callback)
+	{
+		postTx = callback;
+	}
+
+	/**
+	 * @name Queue requests
+	 * @param slave Address of slave, 0 to broadcast a write request
+	 * @param address First register or coil
+	 * @param callback Invoked on completion
+	 * @retval bool false if queue is full or arguments are invalid
+	 * @{
+	 */
+	bool readCoils(uint8_t slave, uint16_t address, uint16_t quantity, Callback callback)
+	{
+		return read(slave, Function::readCoils, address, quantity, callback);
+	}
+
+	bool readDiscreteInputs(uint8_t slave, uint16_t address, uint16_t quantity, Callback callback)
+	{
+		return read(slave, Function::readDiscreteInputs, address, quantity, callback);
+	}
+
+	bool readHoldingRegisters(uint8_t slave, uint16_t address, uint16_t quantity, Callback callback)
+	{
+		return read(slave, Function::readHoldingRegisters, address, quantity, callback);
+	}
+
+	bool readInputRegisters(uint8_t slave, uint16_t address, uint16_t quantity, Callback callback)
+	{
+		return read(slave, Function::readInputRegisters, address, quantity, callback);
+	}
+
+	bool writeSingleCoil(uint8_t slave, uint16_t address, bool state, Callback callback = nullptr)
+	{
+		return enqueue(slave, Function::writeSingleCoil, address, state ? 0xFF00 : 0x0000, nullptr, 0, callback);
+	}
+
+	bool writeSingleRegister(uint8_t slave, uint16_t address, uint16_t value, Callback callback = nullptr)
+	{
+		return enqueue(slave, Function::writeSingleRegister, address, value, nullptr, 0, callback);
+	}
+
+	/**
+	 * @param values Register values, copied into the request
+	 * @param count Number of registers, at most `maxWriteCount`
+	 */
+	bool writeMultipleRegisters(uint8_t slave, uint16_t address, const uint16_t* values, uint8_t count,
+								Callback callback = nullptr);
+	/** @} */
+
+	/**
+	 * @brief Remove all queued requests, completing them with `Status::cancelled`
+	 * @note A request already sent still waits for its response or timeout
+	 */
+	void cancel();
+
+	/**
+	 * @brief Get number of requests outstanding, including any in progress
+	 */
+	unsigned getQueueLength() const
+	{
+		return count;
+	}
+
+	bool isBusy() const
+	{
+		return state != State::idle;
+	}
+
+	const Stats& getStats() const
+	{
+		return stats;
+	}
+
+private:
+	enum class State : uint8_t {
+		idle,
+		transmitting, ///< Sending request
+		waiting,	  ///< Waiting for response
+		gap,		  ///< Inter-frame delay before next request
+	};
+
+	struct Request {
+		Callback callback;
+		uint16_t address;
+		uint16_t quantity;
+		uint8_t length;
+		uint8_t adu[9 + 2 * maxWriteCount]; // Largest is write multiple registers
+	};
+
+	bool read(uint8_t slave, Function function, uint16_t address, uint16_t quantity, Callback callback)
+	{
+		return slave != 0 && enqueue(slave, function, address, quantity, nullptr, 0, callback);
+	}
+
+	bool enqueue(uint8_t slave, Function function, uint16_t address, uint16_t value, const uint16_t* values,
+				 uint8_t count, Callback callback);
+	void next();
+	void transmit();
+	void checkResponse();
+	void complete(Status status);
+	void startGap();
+	void transmitComplete(HardwareSerial& serial);
+	void frameReceived(HardwareSerial& serial, size_t available);
+	static void timerCallback(void* param);
+
+	Request& current()
+	{
+		return queue[head];
+	}
+
+	HardwareSerial& serial;
+	SimpleTimer timer;
+	TransmissionCallback preTx;
+	TransmissionCallback postTx;
+	Request queue[MB_QUEUE_SIZE];
+	uint8_t rxBuffer[256];
+	uint16_t rxLength{0};
+	uint16_t responseTimeout;
+	uint8_t head{0};
+	uint8_t count{0};
+	State state{State::idle};
+	bool active{false};
+	bool cancelling{false};
+	Stats stats{};
+};
+
+} // namespace Modbus
@@ -0,0 +1,29 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * Crc.h - Modbus RTU CRC
+ *
+ ****/
+
+#pragma once
+
+#include <Crypto/Crc.h>
+
+namespace Modbus
+{
+/**
+ * @brief Compute CRC-16/MODBUS
+ * @param data
+ * @param length
+ * @param crc Initial value, or result from a previous call to continue a calculation
+ * @retval uint16_t CRC value, transmitted low byte first
+ */
+inline uint16_t crc16(const void* data, size_t length, uint16_t crc = 0xFFFF)
+{
+	return Crypto::crc16Modbus(data, length, crc);
+}
+
+} // namespace Modbus
@@ -20,7 +20,7 @@ int HttpMultipartResource::setFileMap(HttpServerConnection& connection, HttpRequ
 		return 0;
 	}
 
-	mapper(request.files);
+	mapper(request, request.files);
 
 	return 0;
 }
@@ -18,6 +18,14 @@
 
 using HttpFilesMapper = Delegate<void(HttpFiles&)>;
 
+/**
+ * @brief Variant of mapper which also receives the request
+ *
+ * Use this to inspect request headers before choosing streams, for example to obtain
+ * `Content-Length` and call `Storage::PartitionStream::reserve()`.
+ */
+using HttpRequestFilesMapper = Delegate<void(HttpRequest& request, HttpFiles& files)>;
+
 /** 
  * @brief HttpResource that allows handling of HTTP file upload.
  */
@@ -38,6 +46,17 @@ public:
 	 * @param complete callback that will be called after the request has completed.
 	 */
 	HttpMultipartResource(const HttpFilesMapper& mapper, HttpResourceDelegate complete)
+		: HttpMultipartResource(
+			  HttpRequestFilesMapper([mapper](HttpRequest&, HttpFiles& files) { mapper(files); }), complete)
+	{
+	}
+
+	/**
+	 * @brief Create a HttpResource for handling file upload, with access to the request
+	 * @param mapper callback that provides information where the desired upload fields will be stored.
+	 * @param complete callback that will be called after the request has completed.
+	 */
+	HttpMultipartResource(const HttpRequestFilesMapper& mapper, HttpResourceDelegate complete)
 	{
 		onHeadersComplete = HttpResourceDelegate(&HttpMultipartResource::setFileMap, this);
 		onRequestComplete = complete;
@@ -53,5 +72,5 @@ public:
 	void shutdown(HttpServerConnection& connection) override;
 
 private:
-	HttpFilesMapper mapper;
+	HttpRequestFilesMapper mapper;
 };
@@ -173,6 +173,7 @@ int MultipartParser::partHeadersComplete(multipart_parser_t* p)
 		stream = wrapper->getSource();
 	}
 
+	// Only IFS::FileStream reports this type, so may be opened using the uploaded file name
 	if(stream->getStreamType() == eSST_File) {
 		auto fileStream = static_cast<IFS::FileStream*>(stream);
 		if(fileStream->fileName().length() == 0) {
@@ -21,7 +21,8 @@ bool IdfUpgrader::begin(Partition partition, size_t size)
 	writtenSoFar = 0;
 	maxSize = size ?: partition.size();
 
-	esp_err_t result = esp_ota_begin(convertToIdfPartition(partition), maxSize, &handle);
+	// Erase sectors as they are written, rather than the entire image region up front
+	esp_err_t result = esp_ota_begin(convertToIdfPartition(partition), OTA_WITH_SEQUENTIAL_WRITES, &handle);
 
 	return result == ESP_OK;
 }
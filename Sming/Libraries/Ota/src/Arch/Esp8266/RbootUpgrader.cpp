@@ -29,6 +29,21 @@ bool RbootUpgrader::begin(Partition partition, size_t size)
 	return true;
 }
 
+bool RbootUpgrader::resume(Partition partition, size_t offset, size_t size)
+{
+	maxSize = size ?: partition.size();
+	if(partition.size() < maxSize || offset > maxSize || offset % partition.getBlockSize() != 0) {
+		return false;
+	}
+
+	// rBoot erases each sector as writing reaches it
+	status = rboot_write_init(partition.address() + offset);
+
+	writtenSoFar = offset;
+
+	return true;
+}
+
 size_t RbootUpgrader::write(const uint8_t* buffer, size_t size)
 {
 	if(writtenSoFar + size > maxSize) {
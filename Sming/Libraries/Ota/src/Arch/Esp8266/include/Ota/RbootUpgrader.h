@@ -26,6 +26,7 @@ public:
 	 * @brief Prepare the partition for
 	 */
 	bool begin(Partition partition, size_t size = 0) override;
+	bool resume(Partition partition, size_t offset, size_t size = 0) override;
 	size_t write(const uint8_t* buffer, size_t size) override;
 
 	bool end() override
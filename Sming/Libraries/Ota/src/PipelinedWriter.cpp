@@ -0,0 +1,130 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * PipelinedWriter.cpp
+ *
+ ****/
+
+#include "include/Ota/PipelinedWriter.h"
+#include <Platform/System.h>
+#include <debug_progmem.h>
+
+namespace Ota
+{
+namespace
+{
+constexpr size_t bufferSize{OTA_PIPELINE_BUFFER_SIZE};
+}
+
+PipelinedWriter::List PipelinedWriter::scheduledList;
+
+bool PipelinedWriter::writeBuffer(Buffer& buffer)
+{
+	if(buffer.length == 0) {
+		return true;
+	}
+	if(upgrader.write(buffer.data.get(), buffer.length) != buffer.length) {
+		debug_e("[OTA] Write of %u bytes failed", buffer.length);
+		failed = true;
+	}
+	buffer.length = 0;
+	return !failed;
+}
+
+bool PipelinedWriter::writePending()
+{
+	if(!pending) {
+		return true;
+	}
+	pending = false;
+	return writeBuffer(buffers[fillIndex ^ 1]);
+}
+
+void PipelinedWriter::schedule()
+{
+	if(scheduled) {
+		return;
+	}
+
+	auto callback = [](void* param) {
+		// Writer may have been destroyed since
+		auto writer = static_cast<PipelinedWriter*>(param);
+		if(scheduledList.remove(writer)) {
+			writer->scheduled = false;
+			writer->writePending();
+		}
+	};
+	// If task queue is full, pending buffer gets written on next write
+	scheduled = System.queueCallback(callback, this);
+	if(scheduled) {
+		scheduledList.add(this);
+	}
+}
+
+size_t PipelinedWriter::write(const uint8_t* data, size_t size)
+{
+	if(failed) {
+		return 0;
+	}
+
+	if(bufferSize == 0) {
+		if(upgrader.write(data, size) != size) {
+			failed = true;
+			return 0;
+		}
+		return size;
+	}
+
+	size_t count{0};
+	while(count < size) {
+		auto& buffer = buffers[fillIndex];
+		if(!buffer.data) {
+			buffer.data.reset(new uint8_t[bufferSize]);
+			if(!buffer.data) {
+				// Fall back to writing directly
+				if(!writePending() || upgrader.write(data + count, size - count) != size - count) {
+					failed = true;
+					return 0;
+				}
+				return size;
+			}
+		}
+
+		auto len = std::min(bufferSize - buffer.length, size - count);
+		memcpy(&buffer.data[buffer.length], data + count, len);
+		buffer.length += len;
+		count += len;
+
+		if(buffer.length < bufferSize) {
+			break;
+		}
+
+		// Previous buffer hasn't been written yet, so do it now
+		if(!writePending()) {
+			return 0;
+		}
+		pending = true;
+		fillIndex ^= 1;
+		schedule();
+	}
+
+	return size;
+}
+
+bool PipelinedWriter::flush()
+{
+	if(scheduled) {
+		scheduledList.remove(this);
+		scheduled = false;
+	}
+	writePending();
+	writeBuffer(buffers[fillIndex]);
+	buffers[0].data.reset();
+	buffers[1].data.reset();
+	return !failed;
+}
+
+} // namespace Ota
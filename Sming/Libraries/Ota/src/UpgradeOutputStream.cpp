@@ -22,6 +22,23 @@ bool UpgradeOutputStream::init()
 	return success;
 }
 
+bool UpgradeOutputStream::resume(size_t offset)
+{
+	if(initialized || offset > maxLength) {
+		return false;
+	}
+
+	if(!ota.resume(partition, offset, maxLength)) {
+		debug_w("Upgrader cannot resume, start again");
+		return false;
+	}
+
+	initialized = true;
+	written = offset;
+
+	return true;
+}
+
 size_t UpgradeOutputStream::write(const uint8_t* data, size_t size)
 {
 	if(!initialized && size > 0) {
@@ -37,7 +54,7 @@ size_t UpgradeOutputStream::write(const uint8_t* data, size_t size)
 		return 0;
 	}
 
-	if(!ota.write(data, size)) {
+	if(writer.write(data, size) != size) {
 		debug_e("ota_write_flash: Failed. Size: %d", size);
 		return 0;
 	}
@@ -52,7 +69,8 @@ size_t UpgradeOutputStream::write(const uint8_t* data, size_t size)
 bool UpgradeOutputStream::close()
 {
 	if(initialized) {
-		return ota.end();
+		bool ok = writer.flush();
+		return ota.end() && ok;
 	}
 
 	return true;
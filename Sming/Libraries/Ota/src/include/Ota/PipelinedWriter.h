@@ -0,0 +1,93 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * PipelinedWriter.h - Decouple reception of upgrade data from flash programming
+ *
+ ****/
+
+#pragma once
+
+#include <Ota/UpgraderBase.h>
+#include <Data/LinkedObjectList.h>
+#include <memory>
+
+/**
+ * @brief Size of each buffer used by Ota::PipelinedWriter
+ *
+ * Two buffers are allocated for the duration of an upgrade.
+ * Use a multiple of the flash sector size. Set to 0 to write directly.
+ */
+#ifndef OTA_PIPELINE_BUFFER_SIZE
+#define OTA_PIPELINE_BUFFER_SIZE 4096
+#endif
+
+namespace Ota
+{
+/**
+ * @brief Passes upgrade data to an upgrader from task context
+ *
+ * Data is collected into one of two buffers. When a buffer is full it is written to flash from
+ * a task callback, so the caller (typically a TCP receive callback) returns immediately and
+ * can verify and hash the next chunk whilst the previous one is programmed.
+ *
+ * If both buffers are full then the older one is written immediately, so `write()` always accepts all data.
+ * Write errors are therefore reported by a subsequent `write()` or by `flush()`.
+ */
+class PipelinedWriter : public LinkedObjectTemplate<PipelinedWriter>
+{
+public:
+	using List = LinkedObjectListTemplate<PipelinedWriter>;
+
+	PipelinedWriter(UpgraderBase& upgrader) : upgrader(upgrader)
+	{
+	}
+
+	~PipelinedWriter()
+	{
+		flush();
+	}
+
+	/**
+	 * @brief Queue data for writing
+	 * @retval size_t Number of bytes accepted, 0 if a write has failed
+	 */
+	size_t write(const uint8_t* data, size_t size);
+
+	/**
+	 * @brief Write all outstanding data and release buffers
+	 * @retval bool true if all data was written successfully
+	 * @note Call before `UpgraderBase::end()`
+	 */
+	bool flush();
+
+	/**
+	 * @brief Determine if any writes have failed
+	 */
+	bool hasFailed() const
+	{
+		return failed;
+	}
+
+private:
+	struct Buffer {
+		std::unique_ptr<uint8_t[]> data;
+		size_t length{0};
+	};
+
+	bool writeBuffer(Buffer& buffer);
+	bool writePending();
+	void schedule();
+
+	static List scheduledList;
+	UpgraderBase& upgrader;
+	Buffer buffers[2];
+	uint8_t fillIndex{0}; ///< Buffer receiving data, the other is pending
+	bool pending{false};
+	bool scheduled{false};
+	bool failed{false};
+};
+
+} // namespace Ota
@@ -12,6 +12,7 @@
 #pragma once
 
 #include <Ota/Upgrader.h>
+#include <Ota/PipelinedWriter.h>
 #include <Storage/Partition.h>
 #include <Data/Stream/ReadWriteStream.h>
 
@@ -19,6 +20,8 @@ namespace Ota
 {
 /**
  * @brief Write-only stream type used during firmware upgrade
+ *
+ * Flash programming is deferred to task context using a `PipelinedWriter`.
  */
 class UpgradeOutputStream : public ReadWriteStream
 {
@@ -41,11 +44,6 @@ public:
 
 	size_t write(const uint8_t* data, size_t size) override;
 
-	StreamType getStreamType() const override
-	{
-		return eSST_File;
-	}
-
 	uint16_t readMemoryBlock(char* data, int bufSize) override
 	{
 		return 0;
@@ -66,6 +64,32 @@ public:
 		return true;
 	}
 
+	/**
+	 * @brief Write outstanding data to flash without completing the upgrade
+	 *
+	 * Use `hasError()` to check the result.
+	 */
+	void flush() override
+	{
+		if(initialized && !writer.flush()) {
+			failed = true;
+		}
+	}
+
+	/**
+	 * @brief Continue an interrupted upgrade
+	 * @param offset Amount of data already written, a multiple of the flash sector size
+	 * @retval bool false if the upgrader doesn't support this, or data has already been written
+	 *
+	 * Call instead of writing from the beginning. Data before `offset` is left intact.
+	 */
+	bool resume(size_t offset);
+
+	bool hasError() const
+	{
+		return failed || writer.hasFailed();
+	}
+
 	virtual bool close();
 
 	size_t getStartAddress() const
@@ -80,8 +104,10 @@ public:
 
 protected:
 	OtaUpgrader ota;
+	PipelinedWriter writer{ota};
 	Partition partition;
 	bool initialized{false};
+	bool failed{false};
 	size_t written{0};   // << the number of written bytes
 	size_t maxLength{0}; // << maximum allowed length
 
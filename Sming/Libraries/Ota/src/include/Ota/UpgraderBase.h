@@ -37,6 +37,19 @@ public:
 	 */
 	virtual bool begin(Partition partition, size_t size = 0) = 0;
 
+	/**
+	 * @brief Continues an interrupted upgrade without erasing data already written.
+	 * @param partition
+	 * @param offset Amount of data already written. Must be a multiple of the flash sector size.
+	 * @param size
+	 *
+	 * @retval bool false if not supported, in which case call ``begin()`` to start again
+	 */
+	virtual bool resume(Partition partition, size_t offset, size_t size = 0)
+	{
+		return false;
+	}
+
 	/**
 	 * @brief Writes chunk of data to the partition set in ``begin()``.
 	 * @param buffer
@@ -13,6 +13,10 @@
 #include <Data/HexString.h>
 #include <FlashString/Array.hpp>
 #include <debug_progmem.h>
+#ifdef ENABLE_OTA_DELTA
+#include <Platform/WDT.h>
+#include <Crypto/Md5.h>
+#endif
 
 namespace OtaUpgrade
 {
@@ -45,6 +49,11 @@ bool BasicStream::consume(const uint8_t*& data, size_t& size)
 		destinationPtr += chunkSize;
 	}
 	remainingBytes -= chunkSize;
+#ifdef ENABLE_OTA_DELTA
+	if(isDeltaState()) {
+		deltaRemaining -= chunkSize;
+	}
+#endif
 	data += chunkSize;
 	size -= chunkSize;
 	if(remainingBytes == 0) {
@@ -77,6 +86,17 @@ void BasicStream::processRomHeader()
 {
 	bool addressMatch = (slot.partition.address() & 0xFFFFF) == (romHeader.address & 0xFFFFF);
 	if(!slot.updated && addressMatch) {
+#ifdef ENABLE_OTA_DELTA
+		if(isDelta) {
+			if(romHeader.size < sizeof(deltaHeader)) {
+				setError(Error::InvalidFormat);
+				return;
+			}
+			deltaRemaining = romHeader.size;
+			setupChunk(State::DeltaHeader, deltaHeader);
+			return;
+		}
+#endif
 		if(romHeader.size <= slot.partition.size()) {
 			debug_i("Update slot %s [0x%08X..0x%08X)", slot.partition.name().c_str(), slot.partition.address(),
 					slot.partition.address() + romHeader.size);
@@ -92,6 +112,120 @@ void BasicStream::processRomHeader()
 	setupChunk(State::SkipRom, romHeader.size);
 }
 
+#ifdef ENABLE_OTA_DELTA
+
+bool BasicStream::checkMd5(Storage::Partition part, uint32_t size, const uint8_t expected[16])
+{
+	Crypto::Md5 ctx;
+	uint8_t buffer[256];
+	for(uint32_t offset = 0; offset < size;) {
+		auto len = std::min(size - offset, uint32_t(sizeof(buffer)));
+		if(!part.read(offset, buffer, len)) {
+			return false;
+		}
+		ctx.update(buffer, len);
+		offset += len;
+		WDT.alive();
+	}
+	auto hash = ctx.getHash();
+	return memcmp(hash.data(), expected, hash.size()) == 0;
+}
+
+void BasicStream::processDeltaHeader()
+{
+	if(deltaHeader.targetSize > slot.partition.size()) {
+		setError(Error::RomTooLarge);
+		return;
+	}
+
+	if(deltaHeader.sourceSize != 0) {
+		deltaSource = ota.getRunningPartition();
+		if(!deltaSource || deltaHeader.sourceSize > deltaSource.size() ||
+		   !checkMd5(deltaSource, deltaHeader.sourceSize, deltaHeader.sourceMd5)) {
+			setError(Error::DeltaSourceMismatch);
+			return;
+		}
+	}
+
+	debug_i("Update slot %s [0x%08X..0x%08X) from %u delta bytes", slot.partition.name().c_str(),
+			slot.partition.address(), slot.partition.address() + deltaHeader.targetSize, romHeader.size);
+	ota.begin(slot.partition);
+	deltaOutputPos = 0;
+	nextDeltaRecord();
+}
+
+void BasicStream::nextDeltaRecord()
+{
+	if(deltaRemaining != 0) {
+		if(deltaRemaining < sizeof(deltaRecord)) {
+			setError(Error::InvalidFormat);
+			return;
+		}
+		setupChunk(State::DeltaRecord, deltaRecord);
+		return;
+	}
+
+	// ROM image complete
+	bool ok = writer.flush();
+	if(!(ota.end() && ok)) {
+		setError(Error::FlashWriteFailed);
+		return;
+	}
+
+	if(deltaOutputPos != deltaHeader.targetSize ||
+	   !checkMd5(slot.partition, deltaHeader.targetSize, deltaHeader.targetMd5)) {
+		// Don't leave a corrupted image bootable
+		Storage::spiFlash->erase_range(slot.partition.address(), Storage::spiFlash->getBlockSize());
+		setError(Error::VerificationFailed);
+		return;
+	}
+
+	slot.updated = true;
+	nextRom();
+}
+
+void BasicStream::processDeltaRecord()
+{
+	auto length = deltaRecord.length;
+	if(length > deltaHeader.targetSize - deltaOutputPos) {
+		setError(Error::RomTooLarge);
+		return;
+	}
+
+	if(deltaRecord.source == OTA_DELTA_LITERAL) {
+		if(length > deltaRemaining) {
+			setError(Error::InvalidFormat);
+		} else if(length == 0) {
+			nextDeltaRecord();
+		} else {
+			setupChunk(State::DeltaLiteral, length);
+		}
+		return;
+	}
+
+	auto source = deltaRecord.source;
+	if(source > deltaHeader.sourceSize || length > deltaHeader.sourceSize - source) {
+		setError(Error::InvalidFormat);
+		return;
+	}
+
+	// Copy from running slot
+	uint8_t buffer[256];
+	for(uint32_t offset = 0; offset < length;) {
+		auto len = std::min(length - offset, uint32_t(sizeof(buffer)));
+		if(!deltaSource.read(source + offset, buffer, len) || writer.write(buffer, len) != len) {
+			setError(Error::FlashWriteFailed);
+			return;
+		}
+		offset += len;
+		WDT.alive();
+	}
+	deltaOutputPos += length;
+	nextDeltaRecord();
+}
+
+#endif // ENABLE_OTA_DELTA
+
 void BasicStream::verifyRoms()
 {
 	state = State::RomsComplete;
@@ -133,7 +267,12 @@ size_t BasicStream::write(const uint8_t* data, size_t size)
 		switch(state) {
 		case State::Header:
 			if(consume(data, size)) {
-				if(fileHeader.magic == expectedHeaderMagic) {
+				bool magicOk = (fileHeader.magic == expectedHeaderMagic);
+#ifdef ENABLE_OTA_DELTA
+				isDelta = (fileHeader.magic == expectedDeltaHeaderMagic);
+				magicOk = magicOk || isDelta;
+#endif
+				if(magicOk) {
 #ifndef ENABLE_OTA_DOWNGRADE
 					const auto buildTimestampFirmware = FSTR::readValue(&BuildTimestamp);
 					debug_i("Build timestamp of current firmware: %ull", buildTimestampFirmware);
@@ -160,10 +299,12 @@ size_t BasicStream::write(const uint8_t* data, size_t size)
 			break;
 
 		case State::WriteRom: {
-			bool ok = ota.write(data, std::min(remainingBytes, size));
+			auto len = std::min(remainingBytes, size);
+			bool ok = writer.write(data, len) == len;
 			if(ok) {
 				if(consume(data, size)) {
-					ok = slot.updated = ota.end();
+					ok = writer.flush();
+					ok = slot.updated = ota.end() && ok;
 					nextRom();
 				}
 			}
@@ -172,6 +313,32 @@ size_t BasicStream::write(const uint8_t* data, size_t size)
 			}
 		} break;
 
+#ifdef ENABLE_OTA_DELTA
+		case State::DeltaHeader:
+			if(consume(data, size)) {
+				processDeltaHeader();
+			}
+			break;
+
+		case State::DeltaRecord:
+			if(consume(data, size)) {
+				processDeltaRecord();
+			}
+			break;
+
+		case State::DeltaLiteral: {
+			auto len = std::min(remainingBytes, size);
+			if(writer.write(data, len) != len) {
+				setError(Error::FlashWriteFailed);
+				break;
+			}
+			deltaOutputPos += len;
+			if(consume(data, size)) {
+				nextDeltaRecord();
+			}
+		} break;
+#endif
+
 		case State::SkipRom:
 			if(consume(data, size)) {
 				nextRom();
@@ -227,6 +394,8 @@ String toString(OtaUpgrade::BasicStream::Error code)
 		return F("Could not activate updated ROM");
 	case Error::OutOfMemory:
 		return F("Out of memory. Allocation failed.");
+	case Error::DeltaSourceMismatch:
+		return F("Delta image does not match running firmware");
 	case Error::Internal:
 		return F("Internal error");
 	default:
@@ -13,6 +13,7 @@
 #include <Data/Stream/ReadWriteStream.h>
 #include <Storage/Partition.h>
 #include <Ota/Manager.h>
+#include <Ota/PipelinedWriter.h>
 #include "FileFormat.h"
 #ifdef ENABLE_OTA_SIGNING
 #include "SignatureVerifier.h"
@@ -33,6 +34,8 @@ namespace OtaUpgrade
  * application rom) are updated on the fly as data arrives. When the file is complete
  * and signature validation (if enabled) was successful, the updated slot is activated
  * in the rBoot configuration.
+ * Delta images (see ENABLE_OTA_DELTA) are expanded on the fly, using the currently running
+ * firmware as the base image.
  * Call `hasError()` and/or check the public \c #errorCode member to determine if
  * everything went smoothly.
  *
@@ -61,6 +64,7 @@ public:
 		FlashWriteFailed,	///< Error while writing to Flash memory.
 		RomActivationFailed, ///< Error while activating updated ROM slot.
 		OutOfMemory,		 ///< Dynamic memory allocation failed
+		DeltaSourceMismatch, ///< Delta image was generated from a different base than the running firmware
 		Internal,			 ///< An unexpected error occurred.
 	};
 
@@ -115,6 +119,7 @@ private:
 
 	// Instead of RbootOutputStream, the rboot write API is used directly because in a future extension the OTA file may contain data for multiple FLASH regions.
 	OtaUpgrader ota;
+	Ota::PipelinedWriter writer{ota};
 
 	enum class State {
 		Error,
@@ -122,6 +127,11 @@ private:
 		RomHeader,
 		SkipRom,
 		WriteRom,
+#ifdef ENABLE_OTA_DELTA
+		DeltaHeader,
+		DeltaRecord,
+		DeltaLiteral,
+#endif
 		VerifyRoms,
 		RomsComplete,
 	};
@@ -130,14 +140,24 @@ private:
 #ifdef ENABLE_OTA_SIGNING
 	using Verifier = SignatureVerifier;
 	static const uint32_t expectedHeaderMagic{OTA_HEADER_MAGIC_SIGNED};
+	static const uint32_t expectedDeltaHeaderMagic{OTA_HEADER_MAGIC_SIGNED_DELTA};
 #else
 	using Verifier = ChecksumVerifier;
 	static const uint32_t expectedHeaderMagic{OTA_HEADER_MAGIC_NOT_SIGNED};
+	static const uint32_t expectedDeltaHeaderMagic{OTA_HEADER_MAGIC_NOT_SIGNED_DELTA};
 #endif
 	Verifier verifier;
 
 	OtaFileHeader fileHeader;
 	OtaRomHeader romHeader;
+#ifdef ENABLE_OTA_DELTA
+	OtaDeltaHeader deltaHeader;
+	OtaDeltaRecord deltaRecord;
+	uint32_t deltaRemaining{0}; ///< Encoded bytes of current ROM image still to be received
+	uint32_t deltaOutputPos{0}; ///< Number of bytes of the resulting ROM image produced so far
+	Storage::Partition deltaSource; ///< Running slot containing the base image
+	bool isDelta{false};
+#endif
 
 	Verifier::VerificationData verificationData;
 
@@ -177,6 +197,27 @@ private:
 	 * If successful, the upgraded slot is set as active ROM using the rBoot API.
 	 */
 	void verifyRoms();
+
+#ifdef ENABLE_OTA_DELTA
+	bool isDeltaState() const
+	{
+		return state == State::DeltaHeader || state == State::DeltaRecord || state == State::DeltaLiteral;
+	}
+	/** Called after reception of an #OtaDeltaHeader.
+	 * Checks that the running firmware matches the base image and starts writing.
+	 */
+	void processDeltaHeader();
+	/** Sets up reception of the next #OtaDeltaRecord, or completes the ROM image.
+	 */
+	void nextDeltaRecord();
+	/** Called after reception of an #OtaDeltaRecord.
+	 * Copy records are applied immediately from the running slot.
+	 */
+	void processDeltaRecord();
+	/** Calculate MD5 hash over the start of a partition and compare with expected value.
+	 */
+	static bool checkMd5(Storage::Partition part, uint32_t size, const uint8_t expected[16]);
+#endif
 };
 
 } // namespace OtaUpgrade
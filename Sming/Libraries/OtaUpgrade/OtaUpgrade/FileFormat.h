@@ -40,6 +40,30 @@ struct OtaRomHeader {
 #define OTA_HEADER_MAGIC_SIGNED 0xf01af02a
 /** Expected value for OTA_FileHeader::magic when signing is disabled. */
 #define OTA_HEADER_MAGIC_NOT_SIGNED 0xf01af020
+/** Expected value for OTA_FileHeader::magic for digitally signed upgrade file containing delta images. */
+#define OTA_HEADER_MAGIC_SIGNED_DELTA 0xf01af03a
+/** Expected value for OTA_FileHeader::magic for delta upgrade file when signing is disabled. */
+#define OTA_HEADER_MAGIC_NOT_SIGNED_DELTA 0xf01af030
+
+/** In delta upgrade files, the content of each ROM image starts with this header.
+ * It is followed by a sequence of #OtaDeltaRecord entries, which together produce the new ROM image.
+ */
+struct OtaDeltaHeader {
+	uint32_t sourceSize;   ///< Size of the base image in the running slot, 0 if image contains only literal data
+	uint32_t targetSize;   ///< Size of the ROM image produced
+	uint8_t sourceMd5[16]; ///< MD5 hash of the base image, checked before applying the delta
+	uint8_t targetMd5[16]; ///< MD5 hash of the resulting ROM image, checked after writing
+};
+
+/** Delta record, either followed by literal data or copying data from the running slot.
+ */
+struct OtaDeltaRecord {
+	uint32_t length; ///< Number of bytes produced by this record
+	uint32_t source; ///< Offset in base image to copy from, or #OTA_DELTA_LITERAL if literal data follows
+};
+
+/** Value for OtaDeltaRecord::source indicating that #OtaDeltaRecord::length bytes of literal data follow. */
+#define OTA_DELTA_LITERAL 0xffffffff
 
 #ifdef __cplusplus
 }
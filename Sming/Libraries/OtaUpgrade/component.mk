@@ -103,6 +103,17 @@ App-build: _ota-make-build-timestamp
 
 endif
 
+# Delta upgrades
+COMPONENT_VARS += ENABLE_OTA_DELTA
+ENABLE_OTA_DELTA ?= 1
+
+ifeq ($(ENABLE_OTA_DELTA),1)
+# has to be global, because it is used in a public header file
+GLOBAL_CFLAGS += -DENABLE_OTA_DELTA
+# MD5 is used to check base and resulting images
+COMPONENT_DEPENDS += crypto
+endif
+
 
 OTA_CRYPTO_FEATURES_IMAGE := $(OTA_CRYPTO_FEATURES)
 OTA_KEY_IMAGE := $(OTA_KEY)
@@ -171,6 +182,30 @@ ifdef OTA_ROLLOVER_IN_PROGRESS
 	@echo
 endif
 
+# Build delta upgrade file against ROM images of the firmware currently installed on devices
+CACHE_VARS += OTA_DELTA_BASE
+OTA_DELTA_BASE ?=
+OTA_DELTA_FILE = $(FW_BASE)/firmware-delta.ota
+
+# $1 -> ROM image, $2 -> ROM image of other slot which will be running when this one is updated
+_ota-delta-base = $(OTA_DELTA_BASE)/$(notdir $(if $2,$2,$1))
+
+.PHONY: ota-delta-file
+ota-delta-file: $(PARTITION_factory_FILENAME) $(PARTITION_rom0_FILENAME) $(PARTITION_rom1_FILENAME) $(OTA_KEY_IMAGE) ##Generate delta OTA upgrade file (set OTA_DELTA_BASE first!)
+ifeq ($(OTA_DELTA_BASE),)
+	@echo Please set OTA_DELTA_BASE to use this target.
+else ifneq ($(ENABLE_OTA_DELTA),1)
+	$(error ENABLE_OTA_DELTA must be set to generate delta upgrade files)
+else
+	$(Q) $(OTATOOL) mkfile \
+		$(OTA_CRYPTO_FEATURES_IMAGE) \
+		$(if $(OTA_CRYPTO_FEATURES_IMAGE),--key=$(OTA_KEY_IMAGE)) \
+		$(if $(PARTITION_factory_FILENAME),--rom=$(PARTITION_factory_FILENAME)@$(PARTITION_factory_ADDRESS)@$(call _ota-delta-base,$(PARTITION_factory_FILENAME))) \
+		$(if $(PARTITION_rom0_FILENAME),--rom=$(PARTITION_rom0_FILENAME)@$(PARTITION_rom0_ADDRESS)@$(call _ota-delta-base,$(PARTITION_rom0_FILENAME),$(PARTITION_rom1_FILENAME))) \
+		$(if $(PARTITION_rom1_FILENAME),--rom=$(PARTITION_rom1_FILENAME)@$(PARTITION_rom1_ADDRESS)@$(call _ota-delta-base,$(PARTITION_rom1_FILENAME),$(PARTITION_rom0_FILENAME))) \
+		--output=$(OTA_DELTA_FILE)
+endif
+
 # Apply sanity checks to image security settings
 define _ota-verify-boolean-setting
 ifneq ($$(filter-out 1 0,$($1)),)
@@ -180,6 +215,7 @@ endef
 $(eval $(call _ota-verify-boolean-setting,ENABLE_OTA_SIGNING))
 $(eval $(call _ota-verify-boolean-setting,ENABLE_OTA_ENCRYPTION))
 $(eval $(call _ota-verify-boolean-setting,ENABLE_OTA_DOWNGRADE))
+$(eval $(call _ota-verify-boolean-setting,ENABLE_OTA_DELTA))
 
 # Convenience target for uploading file via HTTP POST
 CACHE_VARS += OTA_UPLOAD_URL OTA_UPLOAD_NAME
@@ -22,6 +22,12 @@ def import_nacl():
 
 MAGIC_UNSIGNED = 0xf01af020
 MAGIC_SIGNED = 0xf01af02a
+MAGIC_UNSIGNED_DELTA = 0xf01af030
+MAGIC_SIGNED_DELTA = 0xf01af03a
+
+# Delta images: minimum length of data copied from the base image
+DELTA_BLOCK_SIZE = 32
+DELTA_LITERAL = 0xffffffff
 
 def load_keys(keyfilepath):
     try:
@@ -66,14 +72,63 @@ def make_bin_keys(args):
     with open(os.path.join(args.output, 'verify.key.bin'), 'wb') as keyfile:
         keyfile.write(pk)
 
-def make_rom_image(address, filepath):
+def read_image(filepath):
     try:
         with open(filepath, 'rb') as f:
-            image_content = f.read()
+            return f.read()
     except:
         sys.stderr.write('Failed to read %s\n' % filepath)
         raise
 
+def make_delta_records(base, image):
+    """Encode image as a sequence of literal and copy-from-base records.
+    Matching blocks are located via a hash table on word-aligned base offsets then extended in both directions.
+    """
+    index = {}
+    for offset in range(0, len(base) - DELTA_BLOCK_SIZE + 1, 4):
+        index.setdefault(base[offset:offset + DELTA_BLOCK_SIZE], offset)
+
+    records = b''
+    def add_literal(start, end):
+        return struct.pack('<II', end - start, DELTA_LITERAL) + image[start:end] if end > start else b''
+
+    literal_start = 0
+    pos = 0
+    while pos + DELTA_BLOCK_SIZE <= len(image):
+        src = index.get(image[pos:pos + DELTA_BLOCK_SIZE])
+        if src is None:
+            pos += 1
+            continue
+        while pos > literal_start and src > 0 and image[pos - 1] == base[src - 1]:
+            pos -= 1
+            src -= 1
+        length = DELTA_BLOCK_SIZE
+        while pos + length < len(image) and src + length < len(base) and image[pos + length] == base[src + length]:
+            length += 1
+        records += add_literal(literal_start, pos)
+        records += struct.pack('<II', length, src)
+        pos += length
+        literal_start = pos
+
+    return records + add_literal(literal_start, len(image))
+
+def make_delta_image(image, basefile):
+    import hashlib
+    if basefile is None:
+        header = struct.pack('<II16s16s', 0, len(image), bytes(16), hashlib.md5(image).digest())
+        return header + struct.pack('<II', len(image), DELTA_LITERAL) + image
+
+    base = read_image(basefile)
+    header = struct.pack('<II16s16s', len(base), len(image), hashlib.md5(base).digest(), hashlib.md5(image).digest())
+    content = header + make_delta_records(base, image)
+    print('Delta image %u bytes (%u%% of %u)' % (len(content), 100 * len(content) // max(len(image), 1), len(image)))
+    return content
+
+def make_rom_image(address, filepath, delta=False, basefile=None):
+    image_content = read_image(filepath)
+    if delta:
+        image_content = make_delta_image(image_content, basefile)
+
     image_header = struct.pack('<II', address, len(image_content))
     return image_header + image_content
 
@@ -91,12 +146,17 @@ def make_ota_file(args):
 
     assert len(args.roms) < 256
 
-    magic = MAGIC_SIGNED if args.signed else MAGIC_UNSIGNED
+    # Any base image makes this a delta file, which older firmware will reject
+    delta = any(basefile is not None for (_, _, basefile) in args.roms)
+    if delta:
+        magic = MAGIC_SIGNED_DELTA if args.signed else MAGIC_UNSIGNED_DELTA
+    else:
+        magic = MAGIC_SIGNED if args.signed else MAGIC_UNSIGNED
     timestamp = int((datetime.now() - datetime(1900, 1, 1)).total_seconds() * 1000)
     ota = struct.pack('<IQBxxx', magic, timestamp, len(args.roms))
 
-    for (address, filepath) in args.roms:
-        ota += make_rom_image(address, filepath)
+    for (address, filepath, basefile) in args.roms:
+        ota += make_rom_image(address, filepath, delta, basefile)
 
     if args.signed:
         # calculate and append signature over whole file, including header, such that even the build timestamp cannot be forged
@@ -222,15 +282,18 @@ def make_parser():
 
     def romspec(spec):
         parts = spec.split('@')
-        if len(parts) == 2:
-            file, address = parts
+        if len(parts) in (2, 3):
+            file, address = parts[0:2]
+            basefile = parts[2] if len(parts) == 3 and len(parts[2]) > 0 else None
             if len(file) > 0:
                 address = get_address(address)
-                return (address, file)
-        raise argparse.ArgumentTypeError('Invalid romspec. Expected format: FILE@ADDRESS')
+                return (address, file, basefile)
+        raise argparse.ArgumentTypeError('Invalid romspec. Expected format: FILE@ADDRESS[@BASEFILE]')
 
-    mkota_parser.add_argument('--rom', action='append', dest='roms', required=True, type=romspec, metavar='FILE@ADDRESS',
-        help="Image file and flash offset address of ROM to include in the OTA upgrade file, e.g. 'rom0.bin@0x2000'")
+    mkota_parser.add_argument('--rom', action='append', dest='roms', required=True, type=romspec,
+        metavar='FILE@ADDRESS[@BASEFILE]',
+        help="Image file and flash offset address of ROM to include in the OTA upgrade file, e.g. 'rom0.bin@0x2000'. \
+        If BASEFILE is given, a delta image is created which is applied to that image running on the device.")
     mkota_parser.set_defaults(func=make_ota_file)
 
     upload_parser = subparsers.add_parser('upload', help='HTTP POST upload of OTA upgrade image (encoded as multipart/form-data)')
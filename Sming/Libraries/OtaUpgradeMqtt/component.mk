@@ -17,8 +17,13 @@ endif
 COMPONENT_VARS += ENABLE_OTA_VARINT_VERSION 
 ENABLE_OTA_VARINT_VERSION ?= 1
 
+# If enabled (set to 1) then firmware is sent as a series of messages, each starting at a given offset
+COMPONENT_VARS += ENABLE_OTA_CHUNKED
+ENABLE_OTA_CHUNKED ?= 0
+
 COMPONENT_CXXFLAGS := -DENABLE_OTA_ADVANCED=$(ENABLE_OTA_ADVANCED) \
-					  -DENABLE_OTA_VARINT_VERSION=$(ENABLE_OTA_VARINT_VERSION)
+					  -DENABLE_OTA_VARINT_VERSION=$(ENABLE_OTA_VARINT_VERSION) \
+					  -DENABLE_OTA_CHUNKED=$(ENABLE_OTA_CHUNKED)
 				
 ##@Firmware Upgrade
 					  
@@ -34,6 +39,14 @@ OTA_PACKAGE_EXT =.sdp
 
 OTA_PATCH_VERSION ?= $(shell date +%s)
 
+# Size of firmware data in each message when ENABLE_OTA_CHUNKED=1
+OTA_CHUNK_SIZE ?= 16384
+ifeq ($(ENABLE_OTA_CHUNKED),0)
+OTA_DEPLOY_CHUNK_SIZE := 0
+else
+OTA_DEPLOY_CHUNK_SIZE := $(OTA_CHUNK_SIZE)
+endif
+
 PACKAGE_IN = $(RBOOT_ROM_0_BIN)
 ifneq ($(ENABLE_OTA_ADVANCED), 0)
 	PACKAGE_IN = $(OTA_UPGRADE_FILE)
@@ -48,4 +61,4 @@ $(PACKAGE_OUT): $(PACKAGE_IN) $(OTA_DEPLOYMENT_TOOL)
 
 .PHONY: ota-deploy
 ota-deploy: $(PACKAGE_OUT) ##Uploads new firmware version of the current application (use MQTT_FIRMWARE_URL to specify the MQTT URL)
-	$(Q) $(OTA_DEPLOYMENT_TOOL) deploy --debug=0 -- $(PACKAGE_OUT) $(MQTT_FIRMWARE_URL)
+	$(Q) $(OTA_DEPLOYMENT_TOOL) deploy --debug=0 -- $(PACKAGE_OUT) $(MQTT_FIRMWARE_URL) $(OTA_DEPLOY_CHUNK_SIZE) $(ENABLE_OTA_VARINT_VERSION)
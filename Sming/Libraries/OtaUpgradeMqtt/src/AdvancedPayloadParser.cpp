@@ -18,7 +18,7 @@ namespace Mqtt
 {
 bool AdvancedPayloadParser::switchRom(const UpdateState& updateState)
 {
-	auto otaStream = static_cast<OtaUpgradeStream*>(updateState.stream);
+	auto otaStream = static_cast<OtaUpgradeStream*>(updateState.stream.get());
 	if(otaStream == nullptr) {
 		return false;
 	}
@@ -12,10 +12,24 @@
 
 #include "include/OtaUpgrade/Mqtt/PayloadParser.h"
 
+#ifndef ENABLE_OTA_CHUNKED
+#define ENABLE_OTA_CHUNKED 0
+#endif
+
 namespace OtaUpgrade
 {
 namespace Mqtt
 {
+namespace
+{
+// Patch version, then for chunked messages the chunk offset and total firmware size
+constexpr uint8_t headerFields = ENABLE_OTA_CHUNKED ? 3 : 1;
+
+// Offset and size fit in 32 bits
+constexpr uint8_t maxSizeBytes = 5;
+
+} // namespace
+
 int PayloadParser::parse(MqttPayloadParserState& state, mqtt_message_t* message, const char* buffer, int length)
 {
 	if(message == nullptr) {
@@ -24,28 +38,19 @@ int PayloadParser::parse(MqttPayloadParserState& state, mqtt_message_t* message,
 	}
 
 	if(length == MQTT_PAYLOAD_PARSER_START) {
-		state = MqttPayloadParserState{new UpdateState};
+		state = MqttPayloadParserState{new MessageState};
 		return 0;
 	}
 
-	auto updateState = static_cast<UpdateState*>(state.userData);
-	if(updateState == nullptr) {
+	auto msg = static_cast<MessageState*>(state.userData);
+	if(msg == nullptr) {
 		debug_e("Update failed for unknown reason!");
 		return ERROR_UNKNOWN_REASON;
 	}
 
 	if(length == MQTT_PAYLOAD_PARSER_END) {
-		bool skip = !updateState->stream;
-		if(!skip) {
-			bool success = switchRom(*updateState);
-			if(success) {
-				debug_d("Switching was successful. Restarting...");
-				System.restart(1000);
-			} else {
-				debug_e("Switching failed!");
-			}
-		}
-		delete updateState;
+		endMessage(*msg);
+		delete msg;
 		state.userData = nullptr;
 		return 0;
 	}
@@ -55,66 +60,221 @@ int PayloadParser::parse(MqttPayloadParserState& state, mqtt_message_t* message,
 		return ERROR_INVALID_MQTT_MESSAGE;
 	}
 
-	if(!updateState->started) {
-		size_t offset = 0;
-		int patchVersion = getPatchVersion(buffer, length, offset, updateState->version);
-		state.offset += offset;
-#if ENABLE_OTA_VARINT_VERSION
-		if(patchVersion < 0) {
-			if(state.offset > allowedVersionBytes) {
+	if(!msg->started) {
+		auto start = buffer;
+		int res = readHeader(*msg, buffer, length);
+		state.offset += buffer - start;
+		if(res <= 0) {
+			return res;
+		}
+
+		msg->started = true;
+		if(msg->version < currentPatchVersion) {
+			// The update is not newer than our current patch version
+			return 0;
+		}
+
+#if ENABLE_OTA_CHUNKED
+		msg->accepted = startChunk(*msg);
+#else
+		msg->stream.reset(getStorageStream(message->common.length - state.offset));
+#endif
+	}
+
+	return writeMessage(*msg, buffer, length);
+}
+
+/*
+ * Decode header fields, consuming bytes from the buffer.
+ * Returns 1 when the header is complete, 0 if more data is required.
+ */
+int PayloadParser::readHeader(MessageState& msg, const char*& buffer, int& length)
+{
+	size_t* fields[] = {&msg.version, &msg.offset, &msg.totalSize};
+
+	while(length > 0) {
+		uint8_t c = *buffer++;
+		--length;
+		auto& value = *fields[msg.field];
+
+#if !ENABLE_OTA_VARINT_VERSION
+		if(msg.field == 0) {
+			value = c;
+			if(++msg.field == headerFields) {
+				return 1;
+			}
+			continue;
+		}
+#endif
+
+		// Varint: 7 bits per byte, least significant first
+		if(msg.shift < sizeof(size_t) * 8) {
+			value |= size_t(c & 0x7f) << msg.shift;
+		}
+		msg.shift += 7;
+		++msg.fieldBytes;
+
+		if(c & 0x80) {
+			auto maxBytes = (msg.field == 0) ? allowedVersionBytes : maxSizeBytes;
+			if(msg.fieldBytes >= maxBytes) {
 				debug_e("Invalid patch version.");
 				return ERROR_INVALID_PATCH_VERSION;
 			}
-			return 0;
+			continue;
+		}
+
+		msg.shift = 0;
+		msg.fieldBytes = 0;
+		if(++msg.field == headerFields) {
+			return 1;
 		}
+	}
+
+	return 0;
+}
+
+int PayloadParser::writeMessage(MessageState& msg, const char* buffer, int length)
+{
+#if ENABLE_OTA_CHUNKED
+	return msg.accepted ? writeChunk(msg, buffer, length) : 0;
+#else
+	auto& stream = msg.stream;
+	if(!stream) {
+		return 0;
+	}
+
+	auto written = stream->write(reinterpret_cast<const uint8_t*>(buffer), length);
+	return (written - length);
 #endif
+}
 
-		updateState->started = true;
-		if(size_t(patchVersion) < currentPatchVersion) {
-			// The update is not newer than our current patch version
-			return 0;
+void PayloadParser::endMessage(MessageState& msg)
+{
+#if ENABLE_OTA_CHUNKED
+	endChunk(msg);
+#else
+	if(msg.stream) {
+		finish(msg);
+	}
+#endif
+}
+
+void PayloadParser::finish(const UpdateState& updateState)
+{
+	bool success = switchRom(updateState);
+	if(success) {
+		debug_d("Switching was successful. Restarting...");
+		System.restart(1000);
+	} else {
+		debug_e("Switching failed!");
+	}
+}
+
+/*
+ * Determine whether a chunk can be stored, creating or resuming the storage stream as required.
+ * Chunks which start beyond the data stored so far are ignored: the publisher must send them again.
+ */
+bool PayloadParser::startChunk(MessageState& msg)
+{
+	if(msg.totalSize == 0 || msg.offset >= msg.totalSize) {
+		debug_e("Invalid chunk at %u, size %u", msg.offset, msg.totalSize);
+		return false;
+	}
+
+	if(transfer.stream && (msg.version != transfer.version || msg.totalSize != transfer.totalSize)) {
+		if(msg.version < transfer.version) {
+			return false;
 		}
+		debug_w("Abandoning upgrade to patch version %u", transfer.version);
+		transfer.stream.reset();
+	}
 
-		length -= offset;
-		buffer += offset;
+	if(!transfer.stream) {
+		transfer.version = msg.version;
+		transfer.totalSize = msg.totalSize;
+		transfer.offset = 0;
 
-		updateState->stream.reset(getStorageStream(message->common.length - offset));
+		ReadWriteStream* stream{nullptr};
+		ResumeState resume;
+		if(loadResumeState(resume) && resume.version == msg.version && resume.totalSize == msg.totalSize &&
+		   resume.offset < msg.totalSize) {
+			size_t offset = resume.offset;
+			stream = resumeStorageStream(msg.totalSize, offset);
+			if(stream != nullptr) {
+				debug_i("Resuming upgrade to patch version %u at %u", msg.version, offset);
+				transfer.offset = offset;
+			}
+		}
+		if(stream == nullptr) {
+			stream = getStorageStream(msg.totalSize);
+		}
+		transfer.stream.reset(stream);
+		if(stream == nullptr) {
+			return false;
+		}
 	}
 
-	auto& stream = updateState->stream;
-	if(!stream) {
+	if(msg.offset > transfer.offset) {
+		debug_w("Missing data at %u, ignoring chunk at %u", transfer.offset, msg.offset);
+		return false;
+	}
+
+	return true;
+}
+
+int PayloadParser::writeChunk(MessageState& msg, const char* buffer, int length)
+{
+	if(!transfer.stream) {
+		return 0;
+	}
+
+	// Skip any data which has already been stored
+	if(msg.offset < transfer.offset) {
+		auto skip = std::min(size_t(length), transfer.offset - msg.offset);
+		msg.offset += skip;
+		buffer += skip;
+		length -= skip;
+	}
+
+	if(length == 0) {
 		return 0;
 	}
 
-	auto written = stream->write(buffer, length);
+	if(transfer.offset + length > transfer.totalSize) {
+		debug_e("Chunk data exceeds firmware size");
+		transfer.stream.reset();
+		return ERROR_INVALID_MQTT_MESSAGE;
+	}
+
+	auto written = transfer.stream->write(reinterpret_cast<const uint8_t*>(buffer), length);
+	if(written != size_t(length)) {
+		transfer.stream.reset();
+	}
+	msg.offset += written;
+	transfer.offset += written;
 	return (written - length);
 }
 
-int PayloadParser::getPatchVersion(const char* buffer, int length, size_t& offset, size_t versionStart)
+void PayloadParser::endChunk(MessageState& msg)
 {
-	if(buffer == nullptr || length < 1) {
-		return ERROR_INVALID_PATCH_VERSION;
+	if(!msg.accepted || !transfer.stream) {
+		return;
 	}
 
-	size_t version = versionStart;
-#if ENABLE_OTA_VARINT_VERSION
-	offset = 0;
-	int useNextByte = 0;
-	do {
-		version += (buffer[offset] & 0x7f);
-		useNextByte = (buffer[offset++] & 0x80);
-	} while(useNextByte && (offset < size_t(length)));
+	if(!commitStorage(*transfer.stream)) {
+		debug_e("Failed to store firmware data");
+		transfer.stream.reset();
+		return;
+	}
 
-	if(useNextByte) {
-		// all the data is consumed and we still don't have a version number?!
-		return VERSION_NOT_READY;
+	if(transfer.offset < transfer.totalSize) {
+		saveResumeState(ResumeState{transfer.version, transfer.totalSize, transfer.offset});
+		return;
 	}
-#else
-	offset = 1;
-	version += buffer[0];
-#endif
 
-	return version;
+	clearResumeState();
+	finish(transfer);
+	transfer.stream.reset();
 }
 
 } // namespace Mqtt
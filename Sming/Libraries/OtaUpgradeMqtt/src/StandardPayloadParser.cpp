@@ -40,5 +40,30 @@ ReadWriteStream* StandardPayloadParser::getStorageStream(size_t storageSize)
 	return new Ota::UpgradeOutputStream(part, storageSize);
 }
 
+ReadWriteStream* StandardPayloadParser::resumeStorageStream(size_t storageSize, size_t& offset)
+{
+	if(storageSize > part.size()) {
+		return nullptr;
+	}
+
+	// A partly written sector will be erased and written again
+	offset -= offset % part.getBlockSize();
+
+	auto stream = new Ota::UpgradeOutputStream(part, storageSize);
+	if(!stream->resume(offset)) {
+		delete stream;
+		return nullptr;
+	}
+
+	return stream;
+}
+
+bool StandardPayloadParser::commitStorage(ReadWriteStream& stream)
+{
+	auto& otaStream = static_cast<Ota::UpgradeOutputStream&>(stream);
+	otaStream.flush();
+	return !otaStream.hasError();
+}
+
 } // namespace Mqtt
 } // namespace OtaUpgrade
@@ -34,6 +34,20 @@ public:
 		std::unique_ptr<ReadWriteStream> stream;
 		bool started{false};
 		size_t version{0};
+		size_t offset{0};	///< Chunked upgrades: position within firmware image
+		size_t totalSize{0}; ///< Chunked upgrades: size of firmware image
+	};
+
+	/**
+	 * @brief Progress of a chunked upgrade
+	 *
+	 * Saved after each chunk has been stored so an interrupted upgrade can continue
+	 * from where it left off, e.g. after a restart.
+	 */
+	struct ResumeState {
+		size_t version;
+		size_t totalSize;
+		size_t offset; ///< Amount of firmware data stored
 	};
 
 	/**
@@ -65,6 +79,51 @@ public:
 	 */
 	virtual ReadWriteStream* getStorageStream(size_t storageSize) = 0;
 
+	/**
+	 * @brief Creates a stream to continue storing an interrupted chunked upgrade
+	 * @param storageSize Size of the complete firmware image
+	 * @param offset Amount of data already stored. On return, where writing will resume from (may be adjusted down).
+	 * @retval ReadWriteStream* nullptr if resuming is not supported, in which case the upgrade starts again
+	 */
+	virtual ReadWriteStream* resumeStorageStream(size_t storageSize, size_t& offset)
+	{
+		return nullptr;
+	}
+
+	/**
+	 * @brief Ensure all data written to a storage stream has been stored
+	 * @retval bool false on failure, in which case the upgrade is abandoned
+	 *
+	 * Chunked upgrades call this at the end of each message, before progress is saved.
+	 */
+	virtual bool commitStorage(ReadWriteStream& stream)
+	{
+		stream.flush();
+		return true;
+	}
+
+	/**
+	 * @name Persist state of a chunked upgrade
+	 *
+	 * Override these to store progress, for example in a file or a dedicated flash sector.
+	 * By default nothing is saved and an interrupted upgrade starts again from the beginning.
+	 *
+	 * @{
+	 */
+	virtual bool loadResumeState(ResumeState& state)
+	{
+		return false;
+	}
+
+	virtual void saveResumeState(const ResumeState& state)
+	{
+	}
+
+	virtual void clearResumeState()
+	{
+	}
+	/** @} */
+
 	/**
 	 * @brief This method takes care to read the incoming MQTT message and pass it to the stream that
 	 * 		  is responsoble for storing the data.
@@ -76,10 +135,27 @@ public:
 	int parse(MqttPayloadParserState& state, mqtt_message_t* message, const char* buffer, int length);
 
 private:
-	int getPatchVersion(const char* buffer, int length, size_t& offset, size_t versionStart = 0);
+	/*
+	 * Per-message state. The header may be split over several calls.
+	 */
+	struct MessageState : public UpdateState {
+		uint8_t field{0};	  ///< Header field being decoded
+		uint8_t shift{0};	  ///< Bit position within field
+		uint8_t fieldBytes{0}; ///< Bytes decoded for field
+		bool accepted{false};  ///< Chunk follows on from data already stored
+	};
+
+	int readHeader(MessageState& msg, const char*& buffer, int& length);
+	int writeMessage(MessageState& msg, const char* buffer, int length);
+	void endMessage(MessageState& msg);
+	bool startChunk(MessageState& msg);
+	int writeChunk(MessageState& msg, const char* buffer, int length);
+	void endChunk(MessageState& msg);
+	void finish(const UpdateState& updateState);
 
 	size_t currentPatchVersion;
 	size_t allowedVersionBytes;
+	UpdateState transfer; ///< Chunked upgrade in progress
 };
 
 } // namespace Mqtt
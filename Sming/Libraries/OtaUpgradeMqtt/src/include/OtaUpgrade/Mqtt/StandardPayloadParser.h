@@ -22,6 +22,9 @@ namespace Mqtt
 /**
  * @brief This parser allows the processing of firmware data that is directly stored
  * 		  to the flash memory using RbootOutputStream.
+ *
+ * Chunked upgrades can be resumed, provided the application persists progress
+ * by overriding the `loadResumeState()`, `saveResumeState()` and `clearResumeState()` methods.
  */
 class StandardPayloadParser : public PayloadParser
 {
@@ -35,6 +38,10 @@ public:
 
 	ReadWriteStream* getStorageStream(size_t storageSize) override;
 
+	ReadWriteStream* resumeStorageStream(size_t storageSize, size_t& offset) override;
+
+	bool commitStorage(ReadWriteStream& stream) override;
+
 private:
 	Storage::Partition part;
 };
@@ -110,7 +110,81 @@ bool pack(const String& inputFileName, const String& outputFileName, size_t patc
 	return true;
 }
 
-bool deploy(const String& outputFileName, const String& url)
+/*
+ * Chunked deployment: each message contains the package patch version, then the offset
+ * and total size of the firmware as varints, followed by the firmware data.
+ * Chunks are published one at a time as each is acknowledged.
+ */
+struct Chunker {
+	HostFileStream* input{nullptr};
+	String topic;
+	String version; ///< Patch version bytes from package
+	size_t offset{0};
+	size_t size{0};
+	size_t chunkSize{0};
+};
+
+Chunker chunker;
+
+void appendVarInt(String& s, size_t value)
+{
+	while(value > 0x7f) {
+		s += char(value | 0x80);
+		value >>= 7;
+	}
+	s += char(value);
+}
+
+bool readPatchVersion(HostFileStream& input, bool useVarInt, String& version)
+{
+	int c;
+	do {
+		c = input.read();
+		if(c < 0) {
+			return false;
+		}
+		version += char(c);
+	} while(useVarInt && (c & 0x80));
+
+	return true;
+}
+
+/*
+ * Return false when there are no more chunks to send
+ */
+bool publishChunk()
+{
+	if(chunker.offset >= chunker.size) {
+		return false;
+	}
+
+	auto len = std::min(chunker.chunkSize, chunker.size - chunker.offset);
+	String message = chunker.version;
+	appendVarInt(message, chunker.offset);
+	appendVarInt(message, chunker.size);
+	auto headerLength = message.length();
+	if(!message.setLength(headerLength + len) ||
+	   chunker.input->readBytes(message.begin() + headerLength, len) != len) {
+		print(F("ERROR: Failed to read chunk at offset "));
+		println(chunker.offset);
+		return false;
+	}
+
+	uint8_t QoS = 2;
+	if(!mqtt.publish(chunker.topic, message, QoS << 1)) {
+		println(F("ERROR: Failed to publish chunk"));
+		return false;
+	}
+
+	chunker.offset += len;
+	print(F("Published "));
+	print(chunker.offset);
+	print('/');
+	println(chunker.size);
+	return true;
+}
+
+bool deploy(const String& outputFileName, const String& url, size_t chunkSize, bool useVarInt)
 {
 	HostFileStream* output = new HostFileStream();
 	if(!output->open(outputFileName)) {
@@ -118,6 +192,16 @@ bool deploy(const String& outputFileName, const String& url)
 		return false;
 	}
 
+	if(chunkSize != 0) {
+		chunker.input = output;
+		chunker.chunkSize = chunkSize;
+		if(!readPatchVersion(*output, useVarInt, chunker.version)) {
+			fileError(*output, outputFileName, F("read from"));
+			return false;
+		}
+		chunker.size = output->available();
+	}
+
 	WifiStation.enable(true, false);
 	WifiStation.config(WIFI_SSID, WIFI_PWD);
 	WifiAccessPoint.enable(false, false);
@@ -141,10 +225,29 @@ bool deploy(const String& outputFileName, const String& url)
 				return 0;
 			}
 
+			String topic = mqttUrl.Path.substring(1);
+			if(chunker.input != nullptr) {
+				// Chunks are not retained: the device must be subscribed during deployment
+				chunker.topic = topic;
+				mqtt.setPublishedHandler([](MqttClient& client, mqtt_message_t* message) -> int {
+					if(!publishChunk()) {
+						if(chunker.offset >= chunker.size) {
+							println(F("Firmware uploaded successfully."));
+						}
+						System.restart(1000);
+					}
+					return 0;
+				});
+				if(!publishChunk()) {
+					System.restart(1000);
+				}
+				return 0;
+			}
+
 			uint8_t retained = 1;
 			uint8_t QoS = 2;
 			uint8_t flags = uint8_t(retained + (QoS << 1));
-			mqtt.publish(mqttUrl.Path.substring(1), output, flags);
+			mqtt.publish(topic, output, flags);
 			mqtt.setPublishedHandler([](MqttClient& client, mqtt_message_t* message) -> int {
 				println(F("Firmware uploaded successfully."));
 				System.restart(1000);
@@ -169,8 +272,8 @@ void help()
 	println(F("Available commands:"));
 	println(F("  pack   fileName.in fileName.out patchVersion <use-varint=1|0>    Creates a package to be deployed on "
 			  "firmware upgrade server."));
-	println(F("  deploy fileName.out mqttUrl                                      Deploys a deployment package to "
-			  "firmware upgrade server."));
+	println(F("  deploy fileName.out mqttUrl <chunk-size=0> <use-varint=1|0>     Deploys a deployment package to "
+			  "firmware upgrade server, optionally as a series of chunks."));
 	println();
 }
 
@@ -227,8 +330,13 @@ bool parseCommands()
 			return false; // after packaging the application can be terminated
 		}
 	} else if(cmd == "deploy") {
-		if(checkParameterCount(3, 3)) {
-			return deploy(parameters[1].text, parameters[2].text);
+		if(checkParameterCount(3, 5)) {
+			size_t chunkSize = 0;
+			if(parameters.count() > 3) {
+				chunkSize = strtoul(parameters[3].text, nullptr, 0);
+			}
+			bool useVarInt = (parameters.count() < 5) || String(parameters[4].text) != "0";
+			return deploy(parameters[1].text, parameters[2].text, chunkSize, useVarInt);
 		}
 	} else {
 		print(F("ERROR: Unknown command '"));
@@ -232,7 +232,8 @@ void RF24::print_address_register(const char* name, uint8_t reg, uint8_t qty)
 RF24::RF24(uint8_t _cepin, uint8_t _cspin):
   ce_pin(_cepin), csn_pin(_cspin), wide_band(true), p_variant(false), 
   payload_size(32), ack_payload_available(false), dynamic_payloads_enabled(false),
-  pipe0_reading_address(0)
+  pipe0_reading_address(0), irq_pin(0xff), irq_state(irq_idle), irq_pending(false),
+  irq_events(false), irq_rx_pipe(0), irq_stats(), rx_head(0), rx_count(0), tx_fifo_count(0)
 {
 }
 
@@ -979,3 +980,290 @@ void RF24::setRetries(uint8_t delay, uint8_t count)
 
 // vim:ai:cin:sts=2 sw=2 ft=cpp
 
+/****************************************************************************/
+
+bool RF24::beginInterrupt(uint8_t _irq_pin, EventDelegate callback)
+{
+  if ( _irq_pin == 0xff || irq_pin != 0xff )
+    return false;
+
+  event_callback = callback;
+  irq_state = irq_idle;
+  irq_pending = false;
+  irq_events = false;
+  rx_head = 0;
+  rx_count = 0;
+  tx_fifo_count = 0;
+
+  irq_request.chipSelect = csn_pin;
+  irq_request.out = irq_out;
+  irq_request.in = irq_in;
+  irq_request.callback = irq_transfer_complete;
+  irq_request.param = this;
+
+  irq_pin = _irq_pin;
+  pinMode(irq_pin,INPUT);
+  attachInterrupt(irq_pin,InterruptDelegate(&RF24::irq_handler,this),FALLING);
+
+  // Pick up anything which arrived before the interrupt was attached
+  irq_handler();
+
+  return true;
+}
+
+/****************************************************************************/
+
+void RF24::endInterrupt(void)
+{
+  if ( irq_pin == 0xff )
+    return;
+
+  detachInterrupt(irq_pin);
+  irq_pin = 0xff;
+  irq_pending = false;
+}
+
+/****************************************************************************/
+
+bool RF24::readPacket(Packet& packet)
+{
+  if ( rx_count == 0 )
+    return false;
+
+  packet = rx_queue[rx_head];
+  rx_head = ( rx_head + 1 ) % RF24_RX_QUEUE_SIZE;
+  --rx_count;
+
+  return true;
+}
+
+/****************************************************************************/
+
+void RF24::startTransmitting(void)
+{
+  write_register(CONFIG, ( read_register(CONFIG) | _BV(PWR_UP) ) & ~_BV(PRIM_RX) );
+  delayMicroseconds(150);
+  ce(HIGH);
+}
+
+/****************************************************************************/
+
+bool RF24::writeAsync(const void* buf, uint8_t len)
+{
+  return load_tx_fifo(W_TX_PAYLOAD, buf, len, dynamic_payloads_enabled ? 0 : payload_size);
+}
+
+/****************************************************************************/
+
+bool RF24::writeAckPayloadAsync(uint8_t pipe, const void* buf, uint8_t len)
+{
+  return load_tx_fifo(W_ACK_PAYLOAD | ( pipe & B111 ), buf, len, 0);
+}
+
+/****************************************************************************/
+
+bool RF24::load_tx_fifo(uint8_t command, const void* buf, uint8_t len, uint8_t size)
+{
+  if ( tx_fifo_count >= 3 )
+    return false;
+
+  TxSlot* slot = NULL;
+  for ( uint8_t i = 0; i < 3; ++i )
+  {
+    if ( ! tx_slots[i].request.busy )
+    {
+      slot = &tx_slots[i];
+      break;
+    }
+  }
+  if ( ! slot )
+    return false;
+
+  const uint8_t max_payload_size = 32;
+  uint8_t data_len = min(len,max_payload_size);
+  if ( size < data_len )
+    size = data_len;
+
+  slot->data[0] = command;
+  memcpy(&slot->data[1], buf, data_len);
+  memset(&slot->data[1 + data_len], 0, size - data_len);
+
+  SPIClass::Request& req = slot->request;
+  req.out = slot->data;
+  req.in = NULL;
+  req.length = 1 + size;
+  req.chipSelect = csn_pin;
+  if ( ! SPI.transferAsync(req) )
+    return false;
+
+  ++tx_fifo_count;
+  return true;
+}
+
+/****************************************************************************/
+
+void RF24::irq_handler(void)
+{
+  if ( irq_state != irq_idle )
+  {
+    irq_pending = true;
+    return;
+  }
+
+  irq_pending = false;
+
+  // Read and clear all event flags in one go.  Clearing RX_DR before draining
+  // the FIFO means a payload arriving afterwards raises the IRQ line again.
+  irq_out[0] = W_REGISTER | ( REGISTER_MASK & REG_STATUS );
+  irq_out[1] = _BV(RX_DR) | _BV(TX_DS) | _BV(MAX_RT);
+  irq_start(irq_status, 2);
+}
+
+/****************************************************************************/
+
+void RF24::irq_start(IrqState state, uint8_t len)
+{
+  irq_state = state;
+  irq_request.length = len;
+  if ( ! SPI.transferAsync(irq_request) )
+    irq_state = irq_idle;
+}
+
+/****************************************************************************/
+
+void RF24::irq_transfer_complete(SPIClass::Request& request)
+{
+  static_cast<RF24*>(request.param)->irq_continue();
+}
+
+/****************************************************************************/
+
+void RF24::irq_read_width(void)
+{
+  if ( dynamic_payloads_enabled )
+  {
+    irq_out[0] = R_RX_PL_WID;
+    irq_out[1] = 0xff;
+    irq_start(irq_width, 2);
+  }
+  else
+  {
+    irq_out[0] = NOP;
+    irq_start(irq_width, 1);
+  }
+}
+
+/****************************************************************************/
+
+void RF24::irq_continue(void)
+{
+  // First byte clocked out of the radio is always the status register
+  uint8_t status = irq_in[0];
+
+  switch ( irq_state )
+  {
+  case irq_status:
+    if ( status & ( _BV(TX_DS) | _BV(MAX_RT) ) )
+    {
+      irq_events = true;
+      if ( tx_fifo_count )
+        --tx_fifo_count;
+    }
+    if ( status & _BV(TX_DS) )
+      ++irq_stats.tx_ok;
+    if ( status & _BV(MAX_RT) )
+    {
+      // The failed payload stays in the TX FIFO, blocking anything behind it
+      ++irq_stats.tx_fail;
+      irq_out[0] = FLUSH_TX;
+      irq_start(irq_flush_tx, 1);
+      return;
+    }
+    irq_read_width();
+    return;
+
+  case irq_flush_tx:
+    tx_fifo_count = 0;
+    irq_read_width();
+    return;
+
+  case irq_width:
+  {
+    uint8_t pipe = ( status >> RX_P_NO ) & B111;
+    if ( pipe > 5 )
+    {
+      // RX FIFO empty: finish by checking how much room is left in the TX FIFO
+      irq_out[0] = R_REGISTER | ( REGISTER_MASK & FIFO_STATUS );
+      irq_out[1] = 0xff;
+      irq_start(irq_fifo, 2);
+      return;
+    }
+
+    uint8_t len = dynamic_payloads_enabled ? irq_in[1] : payload_size;
+    if ( len == 0 || len > 32 )
+    {
+      // Corrupt payload width, datasheet says the RX FIFO must be flushed
+      irq_out[0] = FLUSH_RX;
+      irq_start(irq_flush_rx, 1);
+      return;
+    }
+
+    irq_rx_pipe = pipe;
+    irq_out[0] = R_RX_PAYLOAD;
+    memset(&irq_out[1], 0xff, len);
+    irq_start(irq_payload, 1 + len);
+    return;
+  }
+
+  case irq_payload:
+    if ( rx_count == RF24_RX_QUEUE_SIZE )
+    {
+      ++irq_stats.rx_overflow;
+    }
+    else
+    {
+      Packet& packet = rx_queue[( rx_head + rx_count ) % RF24_RX_QUEUE_SIZE];
+      packet.pipe = irq_rx_pipe;
+      packet.length = irq_request.length - 1;
+      memcpy(packet.data, &irq_in[1], packet.length);
+      ++rx_count;
+    }
+    irq_events = true;
+    irq_read_width();
+    return;
+
+  case irq_flush_rx:
+    irq_events = true;
+    irq_read_width();
+    return;
+
+  case irq_fifo:
+  {
+    // TX_DS events may coalesce, so correct our estimate where the FIFO says otherwise
+    uint8_t fifo = irq_in[1];
+    if ( fifo & _BV(TX_EMPTY) )
+      tx_fifo_count = 0;
+    else if ( fifo & _BV(FIFO_FULL) )
+      tx_fifo_count = 3;
+    else if ( tx_fifo_count == 0 || tx_fifo_count == 3 )
+      tx_fifo_count = 1;
+    break;
+  }
+
+  default:
+    break;
+  }
+
+  irq_state = irq_idle;
+
+  if ( irq_events )
+  {
+    irq_events = false;
+    if ( event_callback )
+      event_callback(*this);
+  }
+
+  // Interrupt is edge-triggered, so check for events raised during the chain
+  if ( irq_pin != 0xff && ( irq_pending || digitalRead(irq_pin) == LOW ) && irq_state == irq_idle )
+    irq_handler();
+}
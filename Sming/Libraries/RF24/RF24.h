@@ -16,6 +16,7 @@
 #define __RF24_H__
 
 #include "RF24_config.h"
+#include <Delegate.h>
 
 /**
  * Power Amplifier level.
@@ -55,6 +56,60 @@ private:
   uint8_t ack_payload_length; /**< Dynamic size of pending ack payload. */
   uint64_t pipe0_reading_address; /**< Last address set on pipe 0 for reading. */
 
+public:
+  /**
+   * A payload taken from the RX FIFO by the interrupt handler
+   */
+  struct Packet
+  {
+    uint8_t pipe; /**< Pipe the payload arrived on */
+    uint8_t length; /**< Number of bytes in @p data */
+    uint8_t data[32];
+  };
+
+  /**
+   * Counters maintained by the interrupt handler
+   */
+  struct IrqStats
+  {
+    uint32_t tx_ok; /**< TX_DS events: payload sent (and acknowledged, if auto-ack enabled) */
+    uint32_t tx_fail; /**< MAX_RT events: retries exhausted, TX FIFO was flushed */
+    uint32_t rx_overflow; /**< Payloads dropped because the receive queue was full */
+  };
+
+  /**
+   * Invoked in task context after the interrupt handler has processed radio events
+   */
+  typedef Delegate<void(RF24& radio)> EventDelegate;
+
+private:
+  enum IrqState { irq_idle, irq_status, irq_flush_tx, irq_width, irq_payload, irq_flush_rx, irq_fifo };
+
+  /**
+   * Buffer for a payload being loaded into the TX FIFO asynchronously
+   */
+  struct TxSlot
+  {
+    SPIClass::Request request;
+    uint8_t data[33]; /**< Command byte followed by payload */
+  };
+
+  uint8_t irq_pin; /**< IRQ pin, 0xff if interrupt-driven operation not active */
+  IrqState irq_state; /**< Step of the SPI transfer chain in progress */
+  bool irq_pending; /**< Interrupt arrived whilst the chain was running */
+  bool irq_events; /**< Something to report via event_callback when the chain ends */
+  uint8_t irq_rx_pipe; /**< Pipe of the payload being read */
+  SPIClass::Request irq_request; /**< Used for all transfers in the chain */
+  uint8_t irq_out[33];
+  uint8_t irq_in[33];
+  EventDelegate event_callback;
+  IrqStats irq_stats;
+  Packet rx_queue[RF24_RX_QUEUE_SIZE]; /**< Ring buffer of received payloads */
+  uint8_t rx_head; /**< Index of oldest packet in @p rx_queue */
+  uint8_t rx_count; /**< Number of packets in @p rx_queue */
+  TxSlot tx_slots[3]; /**< One per TX FIFO level */
+  uint8_t tx_fifo_count; /**< Estimated number of payloads in the TX FIFO */
+
 protected:
   /**
    * @name Low-level internal interface.
@@ -216,6 +271,45 @@ protected:
    * are enabled.  See the datasheet for details.
    */
   void toggle_features(void);
+
+  /**
+   * Interrupt handler, runs in task context
+   *
+   * Starts an asynchronous SPI transfer chain which reads and clears REG_STATUS,
+   * then drains all payloads from the RX FIFO into @p rx_queue.
+   */
+  void irq_handler(void);
+
+  /**
+   * Queue the next transfer of the interrupt chain, using @p irq_out and @p irq_in
+   *
+   * @param state Step to perform when the transfer completes
+   * @param len Number of bytes to transfer
+   */
+  void irq_start(IrqState state, uint8_t len);
+
+  /**
+   * Advance the interrupt chain once a transfer has completed
+   */
+  void irq_continue(void);
+
+  /**
+   * Queue a transfer to get the pipe (and width, if dynamic) of the next RX payload
+   */
+  void irq_read_width(void);
+
+  static void irq_transfer_complete(SPIClass::Request& request);
+
+  /**
+   * Load a payload into the TX FIFO asynchronously
+   *
+   * @param command W_TX_PAYLOAD or W_ACK_PAYLOAD
+   * @param buf Where to get the data, copied before returning
+   * @param len Number of bytes to be sent
+   * @param size Number of bytes to send, the remainder after @p len is zero-filled
+   * @return True if the transfer was queued, false if the TX FIFO or all slots are in use
+   */
+  bool load_tx_fifo(uint8_t command, const void* buf, uint8_t len, uint8_t size);
   /**@}*/
 
 public:
@@ -646,6 +740,93 @@ public:
    */
   bool isValid() { return ce_pin != 0xff && csn_pin != 0xff; } 
 
+  /**@}*/
+  /**
+   * @name Interrupt-driven operation
+   *
+   *  The IRQ pin triggers a chain of asynchronous SPI transfers which clears
+   *  the event flags then drains every payload in the RX FIFO (up to three)
+   *  into a queue.  Nothing blocks, and the radio FIFO is emptied as soon as
+   *  possible so bursts from many nodes are not lost.
+   *
+   *  Whilst active, the blocking methods must not be called if SPI.isBusy()
+   *  returns true.
+   */
+  /**@{*/
+
+  /**
+   * Start handling radio events from the IRQ pin
+   *
+   * Call after configuring the radio, typically just before startListening().
+   *
+   * @param irq_pin The pin attached to IRQ on the RF module
+   * @param callback Invoked after received payloads have been queued, or a
+   * transmission has completed
+   * @return True on success
+   */
+  bool beginInterrupt(uint8_t irq_pin, EventDelegate callback = nullptr);
+
+  /**
+   * Stop handling radio events from the IRQ pin
+   *
+   * Any transfers in progress are allowed to complete.
+   */
+  void endInterrupt(void);
+
+  /**
+   * Get the number of received payloads waiting in the queue
+   */
+  uint8_t packetsAvailable(void) const { return rx_count; }
+
+  /**
+   * Take the oldest received payload from the queue
+   *
+   * @param[out] packet
+   * @return True if a packet was returned, false if the queue is empty
+   */
+  bool readPacket(Packet& packet);
+
+  /**
+   * Get counters maintained by the interrupt handler
+   */
+  const IrqStats& getIrqStats(void) const { return irq_stats; }
+
+  /**
+   * Enter transmit mode for use with writeAsync()
+   *
+   * Chip Enable is held active, so each payload is sent as soon as it has
+   * been loaded and the radio idles in standby when the TX FIFO is empty.
+   * Call startListening() or stopListening() to leave this mode.
+   */
+  void startTransmitting(void);
+
+  /**
+   * Queue a payload to the open writing pipe without blocking
+   *
+   * Up to three payloads may be outstanding, matching the TX FIFO depth.
+   * Completion is reported via getIrqStats() and the event callback, and any
+   * ACK payloads returned by the receiver are queued as received packets on pipe 0.
+   *
+   * @param buf Pointer to the data to be sent, copied before returning
+   * @param len Number of bytes to be sent
+   * @return True if queued, false if the TX FIFO is full
+   */
+  bool writeAsync(const void* buf, uint8_t len);
+
+  /**
+   * Queue an ACK payload without blocking
+   *
+   * The data is sent with the acknowledgement for the next packet received
+   * on @p pipe.  Up to three payloads may be pre-loaded, so replies can be
+   * pipelined ahead of incoming traffic, typically from the event callback.
+   *
+   * @param pipe Which pipe# (typically 1-5) will get this response.
+   * @param buf Pointer to data that is sent, copied before returning
+   * @param len Length of the data to send, up to 32 bytes max.
+   * @return True if queued, false if the TX FIFO is full
+   */
+  bool writeAckPayloadAsync(uint8_t pipe, const void* buf, uint8_t len);
+
   /**@}*/
 };
 
@@ -29,6 +29,11 @@ extern HardwareSPI SPI;
 #define _BV(x) (1<<(x))
 #endif
 
+// Number of received packets held by the interrupt-driven receiver, see RF24::beginInterrupt()
+#ifndef RF24_RX_QUEUE_SIZE
+#define RF24_RX_QUEUE_SIZE 8
+#endif
+
 #undef SERIAL_DEBUG
 #ifdef SERIAL_DEBUG
 #define IF_SERIAL_DEBUG(x) ({x;})
@@ -142,12 +142,31 @@ DSTATUS diskStatus{STA_NOINIT};
 
 BYTE CardType; /* b0:MMC, b1:SDv1, b2:SDv2, b3:Block addressing */
 
+/*
+ * FatFs writes file data one sector at a time unless the application writes whole,
+ * aligned sectors. A multiple block write is therefore left open between calls
+ * so sequential sectors can be streamed without a new command and busy period each time.
+ * It is closed by any other operation, or CTRL_SYNC.
+ */
+bool writeStreamOpen;
+DWORD writeStreamSector; /* Next sector (LBA) expected in stream */
+
+/* Number of times to poll the card before inserting delays, about 100-200us */
+constexpr unsigned fastPollCount{200};
+
 /*-----------------------------------------------------------------------*/
 /* Wait for card ready                                                   */
 /*-----------------------------------------------------------------------*/
 
 bool wait_ready() /* 1:OK, 0:Timeout */
 {
+	/* Card is usually ready again within a few hundred microseconds */
+	for(unsigned n = fastPollCount; n; n--) {
+		if(SDCardSPI->transfer(0xff) == 0xFF) {
+			return true;
+		}
+	}
+
 	for(unsigned tmr = 5000; tmr; tmr--) { /* Wait for ready in timeout of 500ms */
 		BYTE d = SDCardSPI->transfer(0xff);
 		if(d == 0xFF) {
@@ -197,12 +216,12 @@ bool rcvr_datablock(			/* 1:OK, 0:Failed */
 {
 	/* Wait for data packet in timeout of 100ms */
 	BYTE d{0xFF};
-	for(unsigned tmr = 1000; tmr; tmr--) {
+	for(unsigned n = fastPollCount; n && d == 0xFF; n--) {
 		d = SDCardSPI->transfer(0xff);
-		if(d != 0xFF) {
-			break;
-		}
+	}
+	for(unsigned tmr = 1000; tmr && d == 0xFF; tmr--) {
 		dly_us(100);
+		d = SDCardSPI->transfer(0xff);
 	}
 	if(d != 0xFE) {
 		return false; /* If not valid data token, return with error */
@@ -313,6 +332,25 @@ BYTE send_cmd(			/* Returns command response (bit7==1:Send failed)*/
 	return d; /* Return with the response value */
 }
 
+/*-----------------------------------------------------------------------*/
+/* Terminate any open multiple block write                               */
+/*-----------------------------------------------------------------------*/
+
+bool close_write_stream() /* 1:OK, 0:Failed */
+{
+	if(!writeStreamOpen) {
+		return true;
+	}
+
+	writeStreamOpen = false;
+	bool res = select() && xmit_datablock(nullptr, 0xFD); /* STOP_TRAN token */
+	deselect();
+	if(!res) {
+		debug_e("[SDCard] STOP_TRAN error");
+	}
+	return res;
+}
+
 } // namespace
 
 /*--------------------------------------------------------------------------
@@ -346,6 +384,8 @@ DSTATUS disk_initialize(BYTE drv /* Physical drive nmuber (0) */
 		return RES_NOTRDY;
 	}
 
+	writeStreamOpen = false;
+
 	SPISettings initSettings(spiInitFreq, MSBFIRST, SPI_MODE0);
 	SDCardSPI->beginTransaction(initSettings);
 
@@ -452,6 +492,9 @@ DRESULT disk_read(BYTE drv,		/* Physical drive nmuber (0) */
 	if(disk_status(drv) & STA_NOINIT) {
 		return RES_NOTRDY;
 	}
+	if(!close_write_stream()) {
+		return RES_ERROR;
+	}
 	if(!(CardType & CT_BLOCK)) {
 		sector *= 512; /* Convert LBA to byte address if needed */
 	}
@@ -487,34 +530,41 @@ DRESULT disk_write(BYTE drv,		 /* Physical drive nmuber (0) */
 	if(disk_status(drv) & STA_NOINIT) {
 		return RES_NOTRDY;
 	}
-	if(!(CardType & CT_BLOCK)) {
-		sector *= 512; /* Convert LBA to byte address if needed */
-	}
 
-	if(count == 1) {					  /* Single block write */
-		if((send_cmd(CMD24, sector) == 0) /* WRITE_BLOCK */
-		   && xmit_datablock(buff, 0xFE)) {
-			count = 0;
-		} else {
-			debug_e("[SDCard] CMD24 error");
+	if(writeStreamOpen && sector == writeStreamSector) {
+		/* Continue open multiple block write */
+		if(!select()) {
+			writeStreamOpen = false;
+			return RES_ERROR;
+		}
+	} else {
+		if(!close_write_stream()) {
+			return RES_ERROR;
 		}
-	} else { /* Multiple block write */
+		DWORD addr = (CardType & CT_BLOCK) ? sector : sector * 512; /* Convert LBA to byte address if needed */
 		if(CardType & CT_SDC) {
-			send_cmd(ACMD23, count);
+			send_cmd(ACMD23, count); /* Pre-erase hint: safe as at least this many blocks will be written */
 		}
-		if(send_cmd(CMD25, sector) == 0) { /* WRITE_MULTIPLE_BLOCK */
-			do {
-				if(!xmit_datablock(buff, 0xFC)) {
-					debug_e("[SDCard] xmit error");
-					break;
-				}
-				buff += 512;
-			} while(--count);
-			if(!xmit_datablock(0, 0xFD)) { /* STOP_TRAN token */
-				debug_e("[SDCard] STOP_TRAN error");
-				count = 1;
-			}
+		if(send_cmd(CMD25, addr) != 0) { /* WRITE_MULTIPLE_BLOCK */
+			debug_e("[SDCard] CMD25 error");
+			deselect();
+			return RES_ERROR;
+		}
+		writeStreamOpen = true;
+	}
+
+	do {
+		if(!xmit_datablock(buff, 0xFC)) {
+			debug_e("[SDCard] xmit error");
+			break;
 		}
+		buff += 512;
+		++sector;
+	} while(--count);
+
+	writeStreamSector = sector;
+	if(count != 0) {
+		close_write_stream();
 	}
 	deselect();
 
@@ -533,6 +583,9 @@ DRESULT disk_ioctl(BYTE drv,  /* Physical drive nmuber (0) */
 	if(disk_status(drv) & STA_NOINIT) {
 		return RES_NOTRDY; /* Check if card is in the socket */
 	}
+	if(!close_write_stream()) {
+		return RES_ERROR;
+	}
 
 	DRESULT res = RES_ERROR;
 	switch(ctrl) {
@@ -23,6 +23,7 @@
 #include <hal/clk_gate_ll.h>
 #include <soc/rtc.h>
 #include <Data/BitSet.h>
+#include <esp_intr_alloc.h>
 
 #if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 2, 0)
 #include <esp_clk_tree.h>
@@ -323,6 +324,10 @@ void SPIClass::end()
 {
 	GET_DEVICE();
 
+	if(asyncInterrupt != nullptr) {
+		esp_intr_free(intr_handle_t(asyncInterrupt));
+		asyncInterrupt = nullptr;
+	}
 	dev.deinit();
 	busAssigned -= busId;
 }
@@ -383,6 +388,85 @@ void SPIClass::transfer(uint8_t* buffer, size_t numberBytes)
 #endif
 }
 
+void IRAM_ATTR SPIClass::startBlock(Request& request)
+{
+	SpiDevice dev{busId};
+	auto blockLen = std::min(request.length - asyncOffset, SPI_FIFO_SIZE);
+	if(request.out == nullptr) {
+		for(unsigned i = 0; i < ALIGNUP4(blockLen) / 4; ++i) {
+			dev.info.hw->data_buf[i] = 0xffffffff;
+		}
+	} else {
+		dev.write(static_cast<const uint8_t*>(request.out) + asyncOffset, blockLen);
+	}
+	dev.send(blockLen * 8);
+}
+
+bool SPIClass::startRequest(Request& request)
+{
+	GET_DEVICE(false);
+
+	if(asyncInterrupt == nullptr) {
+		intr_handle_t handle{};
+		auto err = esp_intr_alloc(dev.info.irq, 0, asyncInterruptHandler, this, &handle);
+		if(err != ESP_OK) {
+			debug_e("[SPI] Interrupt alloc failed: %s", esp_err_to_name(err));
+			return false;
+		}
+		asyncInterrupt = handle;
+	}
+
+	// Always transfer LS byte first to match system byte order
+#if BYTE_ORDER_SUPPORTED
+	if(!lsbFirst) {
+		dev.set_byte_order(LSBFIRST);
+	}
+#endif
+
+	asyncOffset = 0;
+	spi_ll_clear_int_stat(dev.info.hw);
+	spi_ll_enable_int(dev.info.hw);
+	startBlock(request);
+	return true;
+}
+
+void SPIClass::endRequest(Request&)
+{
+	SpiDevice dev{busId};
+	spi_ll_disable_int(dev.info.hw);
+#if BYTE_ORDER_SUPPORTED
+	if(!lsbFirst) {
+		dev.set_byte_order(MSBFIRST);
+	}
+#endif
+}
+
+void IRAM_ATTR SPIClass::asyncInterruptHandler(void* arg)
+{
+	auto spi = static_cast<SPIClass*>(arg);
+	SpiDevice dev{spi->busId};
+	spi_ll_clear_int_stat(dev.info.hw);
+
+	auto req = spi->queueHead;
+	if(req == nullptr || !spi->asyncActive) {
+		spi_ll_disable_int(dev.info.hw);
+		return;
+	}
+
+	// Collect received data then refill FIFO
+	auto blockLen = std::min(req->length - spi->asyncOffset, SPI_FIFO_SIZE);
+	if(req->in != nullptr) {
+		dev.read(static_cast<uint8_t*>(req->in) + spi->asyncOffset, blockLen);
+	}
+	spi->asyncOffset += blockLen;
+	if(spi->asyncOffset < req->length) {
+		spi->startBlock(*req);
+	} else {
+		spi_ll_disable_int(dev.info.hw);
+		spi->requestComplete();
+	}
+}
+
 void SPIClass::prepare(SPISettings& settings)
 {
 #ifdef SPI_DEBUG
@@ -42,6 +42,10 @@ constexpr SpiPins defaultPins{
 };
 constexpr size_t SPI_FIFO_SIZE{64};
 
+// Shared interrupt status register for SPI0, SPI1 and I2S
+constexpr uint32_t SPI_INTR_STATUS_REG{0x3ff00020};
+constexpr uint32_t SPI_INTR_STATUS_SPI1{BIT7};
+
 bool busAssigned;
 
 // Used internally to calculate optimum SPI speed
@@ -350,6 +354,88 @@ void SPIClass::transfer(uint8_t* buffer, size_t numberBytes)
 #endif
 }
 
+void IRAM_ATTR SPIClass::startBlock(Request& request)
+{
+	SpiDevice dev;
+	auto blockLen = std::min(request.length - asyncOffset, SPI_FIFO_SIZE);
+	if(request.out == nullptr) {
+		for(unsigned i = 0; i < ALIGNUP4(blockLen) / 4; ++i) {
+			dev.hw->data_buf[i] = 0xffffffff;
+		}
+	} else {
+		dev.write(static_cast<const uint8_t*>(request.out) + asyncOffset, blockLen);
+	}
+	dev.send(blockLen * 8);
+}
+
+bool SPIClass::startRequest(Request& request)
+{
+	GET_DEVICE(false);
+
+	if(asyncInterrupt == nullptr) {
+		ETS_SPI_INTR_ATTACH(asyncInterruptHandler, this);
+		ETS_SPI_INTR_ENABLE();
+		asyncInterrupt = this;
+	}
+
+	// Always transfer LS byte first to match system byte order
+#if BYTE_ORDER_SUPPORTED
+	if(!lsbFirst) {
+		dev.set_byte_order(LSBFIRST);
+	}
+#endif
+
+	asyncOffset = 0;
+	dev.hw->slave.trans_done = false;
+	dev.hw->slave.trans_inten = true;
+	startBlock(request);
+	return true;
+}
+
+void SPIClass::endRequest(Request&)
+{
+	SpiDevice dev;
+	dev.hw->slave.trans_inten = false;
+#if BYTE_ORDER_SUPPORTED
+	if(!lsbFirst) {
+		dev.set_byte_order(MSBFIRST);
+	}
+#endif
+}
+
+void IRAM_ATTR SPIClass::asyncInterruptHandler(void* arg)
+{
+	if((READ_PERI_REG(SPI_INTR_STATUS_REG) & SPI_INTR_STATUS_SPI1) == 0) {
+		return;
+	}
+
+	SpiDevice dev;
+	if(!dev.hw->slave.trans_done) {
+		return;
+	}
+	dev.hw->slave.trans_done = false;
+
+	auto spi = static_cast<SPIClass*>(arg);
+	auto req = spi->queueHead;
+	if(req == nullptr || !spi->asyncActive) {
+		dev.hw->slave.trans_inten = false;
+		return;
+	}
+
+	// Collect received data then refill FIFO
+	auto blockLen = std::min(req->length - spi->asyncOffset, SPI_FIFO_SIZE);
+	if(req->in != nullptr) {
+		dev.read(static_cast<uint8_t*>(req->in) + spi->asyncOffset, blockLen);
+	}
+	spi->asyncOffset += blockLen;
+	if(spi->asyncOffset < req->length) {
+		spi->startBlock(*req);
+	} else {
+		dev.hw->slave.trans_inten = false;
+		spi->requestComplete();
+	}
+}
+
 void SPIClass::prepare(SPISettings& settings)
 {
 #ifdef SPI_DEBUG
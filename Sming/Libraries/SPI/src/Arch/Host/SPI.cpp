@@ -252,6 +252,35 @@ void SPIClass::transfer(uint8_t* buffer, size_t numberBytes)
 	}
 }
 
+bool SPIClass::startRequest(Request& request)
+{
+	GET_DEVICE(false);
+
+	// No hardware to wait on, so transfer immediately and complete via task queue
+	auto out = static_cast<const uint8_t*>(request.out);
+	auto in = static_cast<uint8_t*>(request.in);
+	uint8_t block[64];
+	for(size_t offset = 0; offset < request.length; offset += sizeof(block)) {
+		auto blockLen = std::min(request.length - offset, sizeof(block));
+		if(out == nullptr) {
+			memset(block, 0xff, blockLen);
+		} else {
+			memcpy(block, &out[offset], blockLen);
+		}
+		transfer(block, blockLen);
+		if(in != nullptr) {
+			memcpy(&in[offset], block, blockLen);
+		}
+	}
+
+	requestComplete();
+	return true;
+}
+
+void SPIClass::endRequest(Request&)
+{
+}
+
 void SPIClass::prepare(SPISettings& settings)
 {
 	GET_DEVICE();
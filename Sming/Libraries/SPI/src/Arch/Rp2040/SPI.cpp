@@ -14,6 +14,9 @@
 #include <hardware/address_mapped.h>
 #include <hardware/resets.h>
 #include <hardware/gpio.h>
+#include <hardware/dma.h>
+#include <hardware/irq.h>
+#include <hardware/spi.h>
 #include <Data/BitSet.h>
 #include <debug_progmem.h>
 
@@ -180,6 +183,14 @@ SpiDevice& getDevice(SpiBus busId)
 
 BitSet<uint8_t, SpiBus, SOC_SPI_PERIPH_NUM + 1> busAssigned;
 
+// Instances with DMA channels allocated, serviced by shared DMA interrupt handler
+SPIClass* asyncInstances[SOC_SPI_PERIPH_NUM];
+bool dmaIrqInstalled;
+
+// Source/sink for requests without buffers
+uint8_t dmaTxDummy{0xff};
+uint8_t dmaRxDummy;
+
 // Cortex M0+ doesn't support the rbit instruction
 // __forceinline uint32_t reverseBits(uint32_t value)
 // {
@@ -294,6 +305,13 @@ bool SPIClass::begin()
 void SPIClass::end()
 {
 	GET_DEVICE();
+	if(dmaRxChannel >= 0) {
+		asyncInstances[unsigned(busId) - 1] = nullptr;
+		dma_channel_set_irq0_enabled(dmaRxChannel, false);
+		dma_channel_unclaim(dmaTxChannel);
+		dma_channel_unclaim(dmaRxChannel);
+		dmaTxChannel = dmaRxChannel = -1;
+	}
 	dev.deinit();
 	busAssigned -= busId;
 }
@@ -384,6 +402,83 @@ void SPIClass::transfer(uint8_t* buffer, size_t numberBytes)
 	}
 }
 
+bool SPIClass::startRequest(Request& request)
+{
+	GET_DEVICE(false);
+
+	if(lsbFirst && request.out != nullptr && request.out != request.in) {
+		debug_e("[SPI] LSB-first async transfer requires out == in");
+		return false;
+	}
+
+	if(dmaRxChannel < 0) {
+		int tx = dma_claim_unused_channel(false);
+		int rx = dma_claim_unused_channel(false);
+		if(tx < 0 || rx < 0) {
+			debug_e("[SPI] No DMA channels");
+			if(tx >= 0) {
+				dma_channel_unclaim(tx);
+			}
+			return false;
+		}
+		dmaTxChannel = tx;
+		dmaRxChannel = rx;
+		asyncInstances[unsigned(busId) - 1] = this;
+		if(!dmaIrqInstalled) {
+			irq_add_shared_handler(DMA_IRQ_0, asyncInterruptHandler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+			irq_set_enabled(DMA_IRQ_0, true);
+			dmaIrqInstalled = true;
+		}
+		dma_channel_set_irq0_enabled(dmaRxChannel, true);
+	}
+
+	if(lsbFirst) {
+		reverseBits(static_cast<uint8_t*>(request.in), request.length);
+	}
+
+	dev.set_data_bits(cr0val, 8);
+	dev.hw->dmacr = SPI_SSPDMACR_TXDMAE_BITS | SPI_SSPDMACR_RXDMAE_BITS;
+	auto spi = reinterpret_cast<spi_inst_t*>(dev.hw);
+
+	auto c = dma_channel_get_default_config(dmaTxChannel);
+	channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+	channel_config_set_dreq(&c, spi_get_dreq(spi, true));
+	channel_config_set_read_increment(&c, request.out != nullptr);
+	channel_config_set_write_increment(&c, false);
+	dma_channel_configure(dmaTxChannel, &c, &dev.hw->dr, request.out ?: &dmaTxDummy, request.length, false);
+
+	c = dma_channel_get_default_config(dmaRxChannel);
+	channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+	channel_config_set_dreq(&c, spi_get_dreq(spi, false));
+	channel_config_set_read_increment(&c, false);
+	channel_config_set_write_increment(&c, request.in != nullptr);
+	dma_channel_configure(dmaRxChannel, &c, request.in ?: &dmaRxDummy, &dev.hw->dr, request.length, false);
+
+	// Start both together so RX FIFO cannot overflow
+	dma_start_channel_mask(BIT(dmaTxChannel) | BIT(dmaRxChannel));
+	return true;
+}
+
+void SPIClass::endRequest(Request& request)
+{
+	auto& dev = getDevice(busId);
+	dev.hw->dmacr = 0;
+	if(lsbFirst && request.in != nullptr) {
+		reverseBits(static_cast<uint8_t*>(request.in), request.length);
+	}
+}
+
+void __not_in_flash_func(SPIClass::asyncInterruptHandler)()
+{
+	for(auto spi : asyncInstances) {
+		if(spi == nullptr || !dma_channel_get_irq0_status(spi->dmaRxChannel)) {
+			continue;
+		}
+		dma_channel_acknowledge_irq0(spi->dmaRxChannel);
+		spi->requestComplete();
+	}
+}
+
 void SPIClass::prepare(SPISettings& settings)
 {
 	GET_DEVICE();
@@ -29,6 +29,34 @@
 class SPIClass : public SPIBase
 {
 public:
+	/**
+	 * @brief Describes an asynchronous transfer
+	 *
+	 * Requests are executed in the order queued. Each may specify its own settings
+	 * and chip select, so transfers for several devices on the same bus may be queued together.
+	 *
+	 * @note The request and its buffers must remain valid until the callback has been invoked.
+	 * Buffers must be in RAM.
+	 */
+	struct Request {
+		/**
+		 * @brief Invoked in task context when the transfer has completed
+		 */
+		using Callback = void (*)(Request& request);
+
+		static constexpr uint8_t noChipSelect{0xff};
+
+		SPISettings* settings{nullptr};		///< If set, applied before the transfer starts
+		const void* out{nullptr};			///< Data to send, nullptr to send 0xFF bytes
+		void* in{nullptr};					///< Received data, nullptr to discard. May be the same as `out`.
+		size_t length{0};					///< Number of bytes to transfer
+		uint8_t chipSelect{noChipSelect};	///< Active-low chip select pin, driven for the duration of the transfer
+		Callback callback{nullptr};			///< Optional completion callback
+		void* param{nullptr};				///< Available for use by the callback
+		Request* next{nullptr};				///< Used internally to link queued requests
+		volatile bool busy{false};			///< Set whilst queued or in progress
+	};
+
 	SPIClass();
 	SPIClass(const SPIClass&) = delete;
 	SPIClass& operator=(const SPIClass&) = delete;
@@ -57,6 +85,26 @@ public:
 
 	bool loopback(bool enable) override;
 
+	/**
+	 * @brief Queue a transfer for execution in the background
+	 * @param request
+	 * @retval bool false if request is invalid or already queued
+	 *
+	 * Data is transferred using DMA on the Rp2040. The Esp8266 and Esp32 refill the
+	 * hardware FIFO from the transfer-complete interrupt, 64 bytes at a time.
+	 *
+	 * @note Synchronous transfers must not be started whilst `isBusy()` returns true.
+	 */
+	bool transferAsync(Request& request);
+
+	/**
+	 * @brief Determine if any asynchronous transfers are queued or in progress
+	 */
+	bool isBusy() const
+	{
+		return queueHead != nullptr;
+	}
+
 #ifdef ARCH_HOST
 	/**
 	 * @brief Used for testing purposes only
@@ -79,6 +127,31 @@ protected:
 	void prepare(SPISettings& settings) override;
 
 private:
+	// Asynchronous transfers
+	void startNextRequest();
+	void requestComplete();
+	void serviceCompletion();
+	// Implemented for each architecture
+	bool startRequest(Request& request);
+	void endRequest(Request& request);
+#if defined(ARCH_ESP8266) || defined(ARCH_ESP32)
+	void startBlock(Request& request);
+	static void asyncInterruptHandler(void* arg);
+#elif defined(ARCH_RP2040)
+	static void asyncInterruptHandler();
+#endif
+
+	Request* queueHead{nullptr};
+	Request* queueTail{nullptr};
+	bool asyncActive{false};
+#if defined(ARCH_ESP8266) || defined(ARCH_ESP32)
+	size_t asyncOffset{0};
+	void* asyncInterrupt{nullptr};
+#elif defined(ARCH_RP2040)
+	int8_t dmaTxChannel{-1};
+	int8_t dmaRxChannel{-1};
+#endif
+
 #ifndef ARCH_ESP8266
 	SpiBus busId{SpiBus::DEFAULT};
 #endif
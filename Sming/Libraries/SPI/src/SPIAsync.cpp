@@ -0,0 +1,96 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * SPIAsync.cpp - Queue management for asynchronous SPI transfers
+ *
+ * Requests are started and completed in task context, so settings and chip select
+ * are applied using the regular (non-interrupt-safe) methods.
+ * Architecture code only handles moving data for a single request,
+ * calling `requestComplete()` from interrupt context when finished.
+ *
+ ****/
+
+#include "SPI.h"
+#include <Digital.h>
+#include <Platform/System.h>
+#include <debug_progmem.h>
+
+bool SPIClass::transferAsync(Request& request)
+{
+	if(request.busy || request.length == 0) {
+		return false;
+	}
+
+	request.next = nullptr;
+	request.busy = true;
+	if(queueHead == nullptr) {
+		queueHead = &request;
+	} else {
+		queueTail->next = &request;
+	}
+	queueTail = &request;
+
+	if(!asyncActive) {
+		startNextRequest();
+	}
+	return true;
+}
+
+void SPIClass::startNextRequest()
+{
+	while(!asyncActive && queueHead != nullptr) {
+		auto& req = *queueHead;
+		if(req.settings != nullptr) {
+			prepare(*req.settings);
+		}
+		if(req.chipSelect != Request::noChipSelect) {
+			pinMode(req.chipSelect, OUTPUT);
+			digitalWrite(req.chipSelect, LOW);
+		}
+
+		asyncActive = true;
+		if(startRequest(req)) {
+			break;
+		}
+
+		debug_e("[SPI] Async transfer failed");
+		asyncActive = false;
+		if(req.chipSelect != Request::noChipSelect) {
+			digitalWrite(req.chipSelect, HIGH);
+		}
+		queueHead = req.next;
+		req.busy = false;
+	}
+}
+
+void IRAM_ATTR SPIClass::requestComplete()
+{
+	System.queueCallback([](void* param) { static_cast<SPIClass*>(param)->serviceCompletion(); }, this);
+}
+
+void SPIClass::serviceCompletion()
+{
+	if(!asyncActive || queueHead == nullptr) {
+		return;
+	}
+
+	auto& req = *queueHead;
+	endRequest(req);
+	asyncActive = false;
+	if(req.chipSelect != Request::noChipSelect) {
+		digitalWrite(req.chipSelect, HIGH);
+	}
+	queueHead = req.next;
+	req.next = nullptr;
+	req.busy = false;
+
+	// Callback may queue further requests
+	if(req.callback != nullptr) {
+		req.callback(req);
+	}
+
+	startNextRequest();
+}
@@ -377,7 +377,70 @@ private:
 	bool allowFailure{false};
 };
 
+#if !SPISOFT_ENABLE
+/*
+ * Requires SpiTest to have initialised the bus, with MISO and MOSI connected
+ */
+class SpiAsyncTest : public TestGroup
+{
+public:
+	SpiAsyncTest() : TestGroup(F("SPI async"))
+	{
+	}
+
+	void execute() override
+	{
+		for(unsigned i = 0; i < sizeof(outData); ++i) {
+			outData[i] = i;
+		}
+
+		settings[1].bitOrder = LSBFIRST;
+		for(unsigned i = 0; i < 2; ++i) {
+			auto& req = requests[i];
+			req.settings = &settings[i];
+			req.out = outData;
+			req.in = inData[i];
+			req.length = sizeof(outData);
+			req.callback = [](SPIClass::Request& req) {
+				auto test = static_cast<SpiAsyncTest*>(req.param);
+				test->onComplete(req);
+			};
+			req.param = this;
+			REQUIRE(SPI.transferAsync(req));
+		}
+
+		// Already queued
+		REQUIRE(!SPI.transferAsync(requests[0]));
+		REQUIRE(SPI.isBusy());
+		pending();
+	}
+
+	void onComplete(SPIClass::Request& req)
+	{
+		REQUIRE(!req.busy);
+		unsigned index = &req - requests;
+		REQUIRE_EQ(index, completeCount);
+		REQUIRE(memcmp(inData[index], outData, sizeof(outData)) == 0);
+		++completeCount;
+		if(completeCount == 2) {
+			REQUIRE(!SPI.isBusy());
+			complete();
+		}
+	}
+
+private:
+	SPISettings settings[2];
+	SPIClass::Request requests[2];
+	uint8_t outData[200];
+	uint8_t inData[2][200]{};
+	unsigned completeCount{0};
+};
+#endif
+
 void REGISTER_TEST(SPI)
 {
 	registerGroup<SpiTest>();
+#if !SPISOFT_ENABLE
+	registerGroup<SpiAsyncTest>();
+#endif
 }
@@ -7,6 +7,8 @@
 
 #include "Servo.h"
 #include <Digital.h>
+#include <FastGpio.h>
+#include <algorithm>
 
 Servo servo;
 
@@ -17,16 +19,21 @@ void Servo::staticTimerIsr()
 
 void Servo::timerIsr()
 {
+	if(activeSlot == 0) {
+		// Start of frame, switch to any updated schedule
+		activeFrameIndex = nextFrameIndex;
+	}
 	auto& frame = frames[activeFrameIndex];
-	hardwareTimer.setInterval(frame.slots[activeSlot]);
-	if(activeSlot > 0) {
-		digitalWrite(frame.pins[activeSlot - 1], false);
+	auto& slot = frame.slots[activeSlot];
+	hardwareTimer.setInterval(slot.ticks);
+	// Direct register writes so timing isn't affected by flash cache misses
+	if(activeSlot == 0) {
+		FastGpio::Port<0>::set(slot.mask);
+	} else {
+		FastGpio::Port<0>::clear(slot.mask);
 	}
 	++activeSlot;
-	if(activeSlot < frame.slotCount) {
-		digitalWrite(frame.pins[activeSlot - 1], true);
-	} else {
-		activeFrameIndex = nextFrameIndex;
+	if(activeSlot >= frame.slotCount) {
 		activeSlot = 0;
 	}
 }
@@ -53,6 +60,11 @@ bool Servo::addChannel(ServoChannel* channel)
 		return false;
 	}
 
+	// Pins are driven together using a single GPIO register
+	if(channel->getPin() >= std::min(32U, FastGpio::maxPins)) {
+		return false;
+	}
+
 	int i = findChannel(channel);
 	if(i >= 0) {
 		return true; // Already added
@@ -129,24 +141,44 @@ void Servo::calcTiming()
 		newFrameIndex = activeFrameIndex;
 	}
 
-	auto& frame = frames[newFrameIndex];
-	unsigned slotCount = 0;
-
-	uint32_t totalTicks = 0;
+	// Sort active channels by pulse width
+	struct Pulse {
+		uint32_t ticks;
+		uint32_t mask;
+	};
+	Pulse pulses[maxChannels];
+	unsigned pulseCount = 0;
+	uint32_t setMask = 0;
 	for(unsigned i = 0; i < maxChannels; ++i) {
 		auto channel = channels[i];
 		if(channel == nullptr) {
 			continue;
 		}
+		uint32_t mask = BIT(channel->getPin());
+		pulses[pulseCount++] = {HardwareTimer::usToTicks(channel->getValue()), mask};
+		setMask |= mask;
+	}
+	std::sort(&pulses[0], &pulses[pulseCount], [](const Pulse& a, const Pulse& b) { return a.ticks < b.ticks; });
 
-		frame.pins[slotCount] = channel->getPin();
-		auto ticks = HardwareTimer::usToTicks(channel->getValue());
-		frame.slots[slotCount] = ticks;
-		totalTicks += ticks;
-		++slotCount;
+	auto& frame = frames[newFrameIndex];
+	auto slot = &frame.slots[0];
+	slot->mask = setMask;
+	uint32_t slotTime = 0; // Start time of current slot
+	for(unsigned i = 0; i < pulseCount; ++i) {
+		auto& pulse = pulses[i];
+		// Edges closer than the timer can manage are combined
+		if(i != 0 && pulse.ticks - slotTime < HardwareTimer::minTicks()) {
+			slot->mask |= pulse.mask;
+			continue;
+		}
+		slot->ticks = pulse.ticks - slotTime;
+		++slot;
+		slot->mask = pulse.mask;
+		slotTime = pulse.ticks;
 	}
-	frame.slots[slotCount++] = periodTicks - totalTicks;
-	frame.slotCount = slotCount;
+	// Remainder of frame
+	slot->ticks = periodTicks - slotTime;
+	frame.slotCount = slot - &frame.slots[0] + 1;
 
 	// ISR will switch at end of next frame
 	nextFrameIndex = newFrameIndex;
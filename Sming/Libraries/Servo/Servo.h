@@ -23,14 +23,14 @@
 class Servo
 {
 public:
-	static constexpr unsigned maxChannels = 5;	 ///< maximum number of servo channels
+	static constexpr unsigned maxChannels = 12;	///< maximum number of servo channels
 	static constexpr uint32_t framePeriod = 20000; ///< Total frame time in microseconds
 	using HardwareTimer = HardwareTimer1<TIMER_CLKDIV_16, eHWT_NonMaskable>;
 	static constexpr uint32_t periodTicks = HardwareTimer::usToTicks<framePeriod>();
 	//	static constexpr uint32_t minChannelTime = HardwareTimer::ticksToUs<HardwareTimer::minTicks()>();
 	static constexpr uint32_t minChannelTime = MIN_HW_TIMER1_INTERVAL_US;
-	//	static constexpr uint32_t maxChannelTime = HardwareTimer::ticksToUs<channelTicks - HardwareTimer::minTicks()>();
-	static constexpr uint32_t maxChannelTime = framePeriod / maxChannels;
+	/// Channels are output in parallel so the limit is not affected by number of channels
+	static constexpr uint32_t maxChannelTime = framePeriod / 2;
 
 	/** @brief  Instantiate servo object
 	 *  @note   Public global instance of Servo is available as variable servo.
@@ -57,10 +57,22 @@ public:
      */
 	void updateChannel(ServoChannel* channel);
 
-	// Frame timings
+	/**
+	 * @brief One output transition
+	 */
+	struct Slot {
+		uint32_t ticks; ///< Time until next slot
+		uint32_t mask;  ///< Pins to set (first slot) or clear (subsequent slots)
+	};
+
+	/**
+	 * @brief Precomputed schedule for one frame
+	 *
+	 * All pins are set at the start of the frame then cleared in order of increasing
+	 * pulse width. Channels with the same, or nearly the same, width share a slot.
+	 */
 	struct Frame {
-		uint32_t slots[maxChannels + 1]; ///< Transition times in timer ticks
-		uint8_t pins[maxChannels];		 ///< Active pins
+		Slot slots[maxChannels + 1];
 		uint8_t slotCount = 0;
 	};
 
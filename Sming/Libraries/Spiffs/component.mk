@@ -24,6 +24,15 @@ COMPONENT_CXXFLAGS		+= -DSPIFF_FILEDESC_COUNT=$(SPIFF_FILEDESC_COUNT)
 
 COMPONENT_CFLAGS		+= -Wno-tautological-compare
 
+COMPONENT_VARS			+= SPIFFS_CACHE_PAGES
+SPIFFS_CACHE_PAGES		?= 8
+COMPONENT_CXXFLAGS		+= -DSPIFFS_CACHE_PAGES=$(SPIFFS_CACHE_PAGES)
+
+COMPONENT_RELINK_VARS	+= SPIFFS_STATS
+SPIFFS_STATS			?= 1
+COMPONENT_CFLAGS		+= -DSPIFFS_CACHE_STATS=$(SPIFFS_STATS) -DSPIFFS_GC_STATS=$(SPIFFS_STATS)
+COMPONENT_CXXFLAGS		+= -DSPIFFS_CACHE_STATS=$(SPIFFS_STATS) -DSPIFFS_GC_STATS=$(SPIFFS_STATS)
+
 COMPONENT_RELINK_VARS	+= SPIFFS_OBJ_META_LEN
 SPIFFS_OBJ_META_LEN		?= 16
 COMPONENT_CFLAGS		+= -DSPIFFS_OBJ_META_LEN=$(SPIFFS_OBJ_META_LEN)
@@ -22,6 +22,7 @@
 #include "include/IFS/SPIFFS/FileSystem.h"
 #include "include/IFS/SPIFFS/Error.h"
 #include <IFS/Util.h>
+#include <Platform/Timers.h>
 
 namespace IFS
 {
@@ -111,7 +112,11 @@ s32_t FileSystem::f_write(struct spiffs_t* spiffs, u32_t addr, u32_t size, u8_t*
 	if(fs->profiler != nullptr) {
 		fs->profiler->write(addr, src, size);
 	}
-	return fs->partition.write(addr, src, size) ? SPIFFS_OK : SPIFFS_ERR_INTERNAL;
+	ElapseTimer timer;
+	bool ok = fs->partition.write(addr, src, size);
+	fs->writeTime += timer.elapsedTime();
+	++fs->writeCount;
+	return ok ? SPIFFS_OK : SPIFFS_ERR_INTERNAL;
 }
 
 s32_t FileSystem::f_erase(struct spiffs_t* spiffs, u32_t addr, u32_t size)
@@ -121,6 +126,7 @@ s32_t FileSystem::f_erase(struct spiffs_t* spiffs, u32_t addr, u32_t size)
 	if(fs->profiler != nullptr) {
 		fs->profiler->erase(addr, size);
 	}
+	++fs->eraseCount;
 	return fs->partition.erase_range(addr, size) ? SPIFFS_OK : SPIFFS_ERR_INTERNAL;
 }
 
@@ -159,6 +165,15 @@ int FileSystem::mount()
 
 	//  debug_i("FFS offset: 0x%08x, size: %u Kb, \n", cfg.phys_addr, cfg.phys_size / 1024);
 
+	if(cachePages != 0 && !cache) {
+		cacheSize = sizeof(spiffs_cache) + cachePages * CACHE_PAGE_SIZE;
+		cache.reset(new uint8_t[cacheSize]);
+		if(!cache) {
+			cacheSize = 0;
+			return Error::NoMem;
+		}
+	}
+
 	auto res = tryMount(cfg);
 	if(res < 0) {
 		/*
@@ -180,7 +195,7 @@ int FileSystem::mount()
 int FileSystem::tryMount(spiffs_config& cfg)
 {
 	auto err = SPIFFS_mount(handle(), &cfg, reinterpret_cast<uint8_t*>(workBuffer),
-							reinterpret_cast<uint8_t*>(fileDescriptors), sizeof(fileDescriptors), cache, sizeof(cache),
+							reinterpret_cast<uint8_t*>(fileDescriptors), sizeof(fileDescriptors), cache.get(), cacheSize,
 							nullptr);
 	if(err < 0) {
 		if(isSpiffsError(err)) {
@@ -251,6 +266,55 @@ int FileSystem::getinfo(Info& info)
 	return FS_OK;
 }
 
+FileSystem::Stats FileSystem::getStats() const
+{
+	Stats stats{};
+#if SPIFFS_CACHE && SPIFFS_CACHE_STATS
+	stats.cacheHits = fs.cache_hits;
+	stats.cacheMisses = fs.cache_misses;
+#endif
+#if SPIFFS_GC_STATS
+	stats.gcRuns = fs.stats_gc_runs;
+#endif
+	stats.eraseCount = eraseCount;
+	stats.writeCount = writeCount;
+	stats.writeTime = writeTime;
+	return stats;
+}
+
+void FileSystem::resetStats()
+{
+#if SPIFFS_CACHE && SPIFFS_CACHE_STATS
+	fs.cache_hits = 0;
+	fs.cache_misses = 0;
+#endif
+#if SPIFFS_GC_STATS
+	fs.stats_gc_runs = 0;
+#endif
+	eraseCount = 0;
+	writeCount = 0;
+	writeTime = 0;
+}
+
+int FileSystem::gc(uint32_t size)
+{
+	CHECK_MOUNTED()
+
+	int res = SPIFFS_gc(handle(), size);
+	return translateSpiffsError(res);
+}
+
+int FileSystem::gcQuick(uint16_t maxFreePages)
+{
+	CHECK_MOUNTED()
+
+	int res = SPIFFS_gc_quick(handle(), maxFreePages);
+	if(res == SPIFFS_ERR_NO_DELETED_BLOCKS) {
+		return Error::NotFound;
+	}
+	return translateSpiffsError(res);
+}
+
 int FileSystem::setProfiler(IProfiler* profiler)
 {
 	this->profiler = profiler;
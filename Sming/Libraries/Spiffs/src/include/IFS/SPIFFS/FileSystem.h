@@ -47,6 +47,16 @@
 extern "C" {
 #include "../../../../spiffs/src/spiffs_nucleus.h"
 }
+#include <memory>
+
+/**
+ * @brief Default number of pages in the SPIFFS read/write cache
+ *
+ * Each page uses a little over 256 bytes of RAM. Set to 0 to disable caching.
+ */
+#ifndef SPIFFS_CACHE_PAGES
+#define SPIFFS_CACHE_PAGES 8
+#endif
 
 namespace IFS
 {
@@ -58,7 +68,34 @@ namespace SPIFFS
 class FileSystem : public IFileSystem
 {
 public:
-	FileSystem(Storage::Partition partition) : partition(partition)
+	/**
+	 * @brief Runtime statistics
+	 * @note Cache and GC figures require SPIFFS_STATS=1
+	 */
+	struct Stats {
+		uint32_t cacheHits;
+		uint32_t cacheMisses;
+		uint32_t gcRuns;     ///< Number of garbage collection passes
+		uint32_t eraseCount; ///< Number of blocks erased
+		uint32_t writeCount; ///< Number of partition writes
+		uint32_t writeTime;  ///< Total time spent writing to partition, in microseconds
+
+		/**
+		 * @brief Get average time for a partition write, in microseconds
+		 */
+		uint32_t averageWriteTime() const
+		{
+			return writeCount ? writeTime / writeCount : 0;
+		}
+	};
+
+	/**
+	 * @brief Constructor
+	 * @param partition
+	 * @param cachePages Number of pages to allocate for the read/write cache when mounting
+	 */
+	FileSystem(Storage::Partition partition, uint8_t cachePages = SPIFFS_CACHE_PAGES)
+		: partition(partition), cachePages(std::min(cachePages, uint8_t(MAX_CACHE_PAGES)))
 	{
 	}
 
@@ -103,6 +140,50 @@ public:
 	 */
 	int getFilePath(FileID fileid, NameBuffer& buffer);
 
+	/**
+	 * @brief Get number of pages allocated for the cache
+	 */
+	uint8_t getCachePages() const
+	{
+		return cachePages;
+	}
+
+	/**
+	 * @brief Get runtime statistics
+	 */
+	Stats getStats() const;
+
+	/**
+	 * @brief Reset runtime statistics to zero
+	 */
+	void resetStats();
+
+	/**
+	 * @brief Get number of fully erased blocks available for writing
+	 */
+	uint32_t getFreeBlocks() const
+	{
+		return fs.free_blocks;
+	}
+
+	/**
+	 * @brief Run garbage collection until the requested space is available
+	 * @param size Number of bytes required
+	 * @retval int error code
+	 * @note This may take some time as pages are moved and blocks erased.
+	 */
+	int gc(uint32_t size);
+
+	/**
+	 * @brief Perform a single, bounded, garbage collection step
+	 * @param maxFreePages Only consider blocks with at most this many free pages.
+	 * With 0, only blocks containing nothing but deleted pages are erased so no data is moved.
+	 * @retval int error code, Error::NotFound if no suitable block exists
+	 *
+	 * Call during idle time to keep blocks clean so writes do not trigger garbage collection.
+	 */
+	int gcQuick(uint16_t maxFreePages = 0);
+
 private:
 	spiffs* handle()
 	{
@@ -128,11 +209,10 @@ private:
 	static s32_t f_erase(struct spiffs_t* spiffs, u32_t addr, u32_t size);
 
 	static constexpr uint32_t MAX_PARTITION_SIZE{256 * 1024 * 1024};
-	static constexpr size_t CACHE_PAGES{8};
+	static constexpr size_t MAX_CACHE_PAGES{32}; ///< Limited by size of SPIFFS cache usage map
 	static constexpr size_t LOG_PAGE_SIZE{256};
 	static constexpr size_t MIN_BLOCKSIZE{256};
 	static constexpr size_t CACHE_PAGE_SIZE{sizeof(spiffs_cache_page) + LOG_PAGE_SIZE};
-	static constexpr size_t CACHE_SIZE{sizeof(spiffs_cache) + CACHE_PAGES * CACHE_PAGE_SIZE};
 
 	Storage::Partition partition;
 	IProfiler* profiler{nullptr};
@@ -140,7 +220,12 @@ private:
 	spiffs fs{};
 	uint8_t workBuffer[LOG_PAGE_SIZE * 2];
 	spiffs_fd fileDescriptors[SPIFF_FILEDESC_COUNT];
-	uint8_t cache[CACHE_SIZE];
+	std::unique_ptr<uint8_t[]> cache;
+	size_t cacheSize{0};
+	uint8_t cachePages;
+	uint32_t eraseCount{0};
+	uint32_t writeCount{0};
+	uint32_t writeTime{0};
 };
 
 } // namespace SPIFFS
@@ -0,0 +1,130 @@
+/**
+ * GcTask.h
+ * Background garbage collection for SPIFFS
+ *
+ * Copyright 2019 mikee47 <mike@sillyhouse.net>
+ *
+ * This file is part of the SPIFFS IFS Library
+ *
+ * This library is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3 or later.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this library.
+ * If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "FileSystem.h"
+#include <Task.h>
+#include <Services/Profiling/CpuUsage.h>
+
+namespace IFS
+{
+namespace SPIFFS
+{
+/**
+ * @brief Performs SPIFFS garbage collection in the background
+ *
+ * SPIFFS runs garbage collection inside a write once fewer than four clean blocks remain,
+ * which can stall the caller for a considerable time.
+ * This task keeps a reserve of clean blocks by erasing or reclaiming one block per step,
+ * only when the system is idle.
+ *
+ * ```
+ * Profiling::CpuUsage cpuUsage;
+ * IFS::SPIFFS::GcTask gcTask(*spiffs, &cpuUsage);
+ * ...
+ * gcTask.resume();
+ * ```
+ */
+class GcTask : public Task
+{
+public:
+	/**
+	 * @brief Constructor
+	 * @param fs Mounted SPIFFS filesystem
+	 * @param cpuUsage If provided, collection is deferred whilst the CPU is busy.
+	 * The application is responsible for calibrating this and calling `reset()` periodically.
+	 */
+	GcTask(FileSystem& fs, Profiling::CpuUsage* cpuUsage = nullptr) : fs(fs), cpuUsage(cpuUsage)
+	{
+	}
+
+	/**
+	 * @brief Set number of clean blocks to maintain
+	 */
+	void setReserve(uint16_t blocks)
+	{
+		reserve = blocks;
+	}
+
+	/**
+	 * @brief Set CPU utilisation above which collection is deferred
+	 * @param utilisation In 1/100ths of a percent
+	 */
+	void setIdleThreshold(unsigned utilisation)
+	{
+		idleThreshold = utilisation;
+	}
+
+	/**
+	 * @brief Set interval between checks when there is no work to do
+	 * @param interval Time in milliseconds
+	 */
+	void setInterval(unsigned interval)
+	{
+		this->interval = interval;
+	}
+
+	/**
+	 * @brief Get number of collection steps performed
+	 */
+	unsigned getStepCount() const
+	{
+		return stepCount;
+	}
+
+protected:
+	void loop() override
+	{
+		if(fs.getFreeBlocks() >= reserve || !isIdle()) {
+			sleep(interval);
+			return;
+		}
+
+		// Erasing a block holding only deleted pages requires no data to be moved
+		int err = fs.gcQuick(UINT16_MAX);
+		if(err == Error::NotFound) {
+			// Bounded by SPIFFS_GC_MAX_RUNS
+			err = fs.gc(0);
+		}
+		++stepCount;
+
+		if(err < 0) {
+			debug_w("[SPIFFS] Background GC: %s", fs.getErrorString(err).c_str());
+			sleep(interval);
+		}
+	}
+
+private:
+	bool isIdle() const
+	{
+		return cpuUsage == nullptr || cpuUsage->getUtilisation() <= idleThreshold;
+	}
+
+	FileSystem& fs;
+	Profiling::CpuUsage* cpuUsage;
+	unsigned stepCount{0};
+	unsigned idleThreshold{5000};
+	unsigned interval{1000};
+	uint16_t reserve{4};
+};
+
+} // namespace SPIFFS
+} // namespace IFS
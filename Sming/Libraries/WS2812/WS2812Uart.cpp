@@ -0,0 +1,142 @@
+/****
+ * WS2812Uart.cpp
+ *
+ ****/
+
+#include "WS2812Uart.h"
+#include <Platform/System.h>
+#include <espinc/uart_register.h>
+#include <algorithm>
+
+namespace
+{
+constexpr uint32_t baudRate{3200000};
+
+/*
+ * UART characters for each pair of LED bits, most significant first.
+ * Values are inverted on output and sent LSB first, following the start bit.
+ */
+constexpr uint8_t encoding[4]{
+	0b110111, // 00
+	0b000111, // 01
+	0b110100, // 10
+	0b000100, // 11
+};
+
+void encodeByte(uint8_t value, uint8_t* out)
+{
+	out[0] = encoding[(value >> 6) & 3];
+	out[1] = encoding[(value >> 4) & 3];
+	out[2] = encoding[(value >> 2) & 3];
+	out[3] = encoding[value & 3];
+}
+
+} // namespace
+
+bool WS2812Uart::begin(unsigned maxPixels)
+{
+	end();
+
+	bufferSize = maxPixels * bytesPerPixel;
+
+	smg_uart_config_t cfg{
+		.uart_nr = UART1,
+		.tx_pin = 2,
+		.rx_pin = UART_PIN_DEFAULT,
+		.mode = UART_TX_ONLY,
+		.options = 0,
+		.baudrate = baudRate,
+		.format = UART_6N1,
+		.rx_size = 0,
+		.tx_size = bufferSize,
+	};
+	uart = smg_uart_init_ex(cfg);
+	if(uart == nullptr) {
+		return false;
+	}
+
+	// Idle low, start bits high
+	SET_PERI_REG_MASK(UART_CONF0(UART1), UART_TXD_INV);
+
+	smg_uart_set_callback(uart, uartCallback, this);
+	return true;
+}
+
+void WS2812Uart::end()
+{
+	if(uart == nullptr) {
+		return;
+	}
+	smg_uart_set_callback(uart, nullptr, nullptr);
+	CLEAR_PERI_REG_MASK(UART_CONF0(UART1), UART_TXD_INV);
+	smg_uart_uninit(uart);
+	uart = nullptr;
+	latchTimer.stop();
+	sending = false;
+	busy = false;
+}
+
+bool WS2812Uart::show(const uint8_t* rgb, size_t length)
+{
+	if(uart == nullptr || busy) {
+		return false;
+	}
+
+	length -= length % 3;
+	if(length * 4 > bufferSize) {
+		return false;
+	}
+
+	busy = true;
+	sending = true;
+
+	// Encode in chunks so the UART can start sending before the whole frame is done
+	uint8_t chunk[bytesPerPixel * 4];
+	for(size_t i = 0; i < length; i += 3) {
+		auto out = &chunk[(i / 3 % 4) * bytesPerPixel];
+		// Strip expects G R B
+		encodeByte(rgb[i + 1], &out[0]);
+		encodeByte(rgb[i], &out[4]);
+		encodeByte(rgb[i + 2], &out[8]);
+		auto end = out + bytesPerPixel;
+		if(end == &chunk[sizeof(chunk)] || i + 3 == length) {
+			smg_uart_write(uart, chunk, end - chunk);
+		}
+	}
+
+	if(length == 0) {
+		sending = false;
+		frameSent(this);
+	}
+
+	return true;
+}
+
+void WS2812Uart::uartCallback(smg_uart_t* uart, uint32_t status)
+{
+	// Reported only once both transmit buffer and FIFO have emptied
+	if((status & UART_STATUS_TXFIFO_EMPTY) == 0) {
+		return;
+	}
+	auto self = static_cast<WS2812Uart*>(smg_uart_get_callback_param(uart));
+	if(self->sending) {
+		self->sending = false;
+		System.queueCallback(frameSent, self);
+	}
+}
+
+void WS2812Uart::frameSent(void* param)
+{
+	auto self = static_cast<WS2812Uart*>(param);
+	// Line must stay low for the strip to latch data before another frame can start
+	self->latchTimer.initializeMs<1>([](void* param) { static_cast<WS2812Uart*>(param)->latchComplete(); }, self);
+	self->latchTimer.startOnce();
+}
+
+void WS2812Uart::latchComplete()
+{
+	busy = false;
+	if(frameDone) {
+		frameDone();
+	}
+}
@@ -0,0 +1,85 @@
+/****
+ * WS2812Uart.h - Non-blocking WS2812 output using UART1
+ *
+ * The UART generates the waveform from its transmit buffer so interrupts stay enabled
+ * throughout, and the CPU is free while a frame is being sent.
+ *
+ * The UART runs at 3.2 Mbit/s, 6N1 with its output inverted. Each character is then
+ * 8 bit-times of 312.5ns and carries two LED bits of 1.25us each:
+ *
+ * 	start(H) d0 d1 d2 | d3 d4 d5 stop(L)
+ *
+ * The start bit provides the leading high pulse of the first LED bit, the stop bit the
+ * trailing low of the second. 12 characters are therefore needed per RGB pixel.
+ *
+ * UART1 transmit is only available on GPIO2.
+ *
+ ****/
+
+#pragma once
+
+#include <Delegate.h>
+#include <driver/uart.h>
+#include <SimpleTimer.h>
+
+class WS2812Uart
+{
+public:
+	/**
+	 * @brief Called from the task queue when a frame has been sent
+	 */
+	using FrameDone = Delegate<void()>;
+
+	/// Bytes of transmit buffer needed per RGB pixel
+	static constexpr size_t bytesPerPixel{12};
+
+	~WS2812Uart()
+	{
+		end();
+	}
+
+	/**
+	 * @brief Initialise UART1 for output on GPIO2
+	 * @param maxPixels Largest frame to be sent, determines transmit buffer size
+	 * @retval bool true on success
+	 */
+	bool begin(unsigned maxPixels);
+
+	void end();
+
+	/**
+	 * @brief Start sending a frame
+	 * @param rgb Byte triples interpreted as R G B, sent to the strip as G R B
+	 * @param length Number of bytes, incomplete triples are ignored
+	 * @retval bool false if a frame is still in progress or the buffer is too small
+	 *
+	 * Data is encoded into the UART transmit buffer before returning, so the caller may
+	 * immediately start preparing the next frame in `rgb` whilst this one is sent.
+	 */
+	bool show(const uint8_t* rgb, size_t length);
+
+	/**
+	 * @brief Determine if a frame is being sent, including the latch (reset) period
+	 */
+	bool isBusy() const
+	{
+		return busy;
+	}
+
+	void onFrameDone(FrameDone callback)
+	{
+		frameDone = callback;
+	}
+
+private:
+	static void IRAM_ATTR uartCallback(smg_uart_t* uart, uint32_t status);
+	static void frameSent(void* param);
+	void latchComplete();
+
+	smg_uart_t* uart{nullptr};
+	FrameDone frameDone;
+	SimpleTimer latchTimer;
+	size_t bufferSize{0};
+	volatile bool sending{false};
+	bool busy{false};
+};
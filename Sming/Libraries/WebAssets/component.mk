@@ -0,0 +1,31 @@
+COMPONENT_SRCDIRS := src
+COMPONENT_INCDIRS := src
+COMPONENT_DOXYGEN_INPUT := src
+COMPONENT_DEPENDS := Network
+
+# Directory containing web content to bundle, relative to the project
+CONFIG_VARS += WEBASSETS_DIR
+WEBASSETS_DIR ?= web
+
+# Options passed to webassets.py, e.g. --no-minify
+CONFIG_VARS += WEBASSETS_OPTIONS
+WEBASSETS_OPTIONS ?=
+
+WEBASSETS_TOOL := $(PYTHON) $(COMPONENT_PATH)/webassets.py
+
+# Generated source and processed content, pulled in as appcode using IMPORT_FSTR
+WEBASSETS_GENCODE_DIR := out/WebAssets
+COMPONENT_APPCODE += $(abspath $(WEBASSETS_GENCODE_DIR))
+
+WEBASSETS_BUNDLE_SRC := $(WEBASSETS_GENCODE_DIR)/WebAssetsBundle.cpp
+WEBASSETS_FILES = $(call ListAllFiles,$(WEBASSETS_DIR),*)
+
+App-build: $(WEBASSETS_BUNDLE_SRC)
+$(WEBASSETS_BUNDLE_SRC): $(WEBASSETS_FILES) $(COMPONENT_PATH)/webassets.py
+	$(Q) rm -rf $(WEBASSETS_GENCODE_DIR)
+	$(Q) $(WEBASSETS_TOOL) $(WEBASSETS_OPTIONS) $(WEBASSETS_DIR) $(WEBASSETS_GENCODE_DIR)
+
+.PHONY: webassets-clean
+clean: webassets-clean
+webassets-clean:
+	-$(Q) rm -rf $(WEBASSETS_GENCODE_DIR)
@@ -0,0 +1,49 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * HttpAssetResource.cpp
+ *
+ ****/
+
+#include "HttpAssetResource.h"
+#include <Network/Http/HttpRequest.h>
+#include <Network/Http/HttpResponse.h>
+#include <Data/Stream/FlashMemoryStream.h>
+
+int HttpAssetResource::requestComplete(HttpServerConnection&, HttpRequest& request, HttpResponse& response)
+{
+	if(request.method != HTTP_GET && request.method != HTTP_HEAD) {
+		response.code = HTTP_STATUS_METHOD_NOT_ALLOWED;
+		return 0;
+	}
+
+	// When mounted with a wildcard, e.g. "/ui/*", only the trailing part is used
+	String path = request.getPathParameter("*", request.uri.Path);
+	if(path[0] == '/') {
+		path.remove(0, 1);
+	}
+	if(path.length() == 0 || path.endsWith("/")) {
+		path += indexFile;
+	}
+
+	int index = bundle.find(path);
+	if(index < 0) {
+		response.code = HTTP_STATUS_NOT_FOUND;
+		return 0;
+	}
+
+	auto asset = bundle.getAsset(index);
+	auto& headers = response.headers;
+	headers[HTTP_HEADER_ETAG] = *asset.etag;
+	headers[HTTP_HEADER_CACHE_CONTROL] = cacheControl;
+	if(asset.flags & WebAssets::ASSET_FLAG_GZIP) {
+		// All current browsers accept gzip, so there is no uncompressed fallback
+		headers[HTTP_HEADER_CONTENT_ENCODING] = F("gzip");
+		headers[HTTP_HEADER_VARY] = F("Accept-Encoding");
+	}
+	response.sendDataStream(new FSTR::Stream(bundle.getContent(index)), String(*asset.mimeType));
+	return 0;
+}
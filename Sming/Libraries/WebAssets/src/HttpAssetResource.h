@@ -0,0 +1,63 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * HttpAssetResource.h
+ *
+ ****/
+
+#pragma once
+
+#include "WebAssets.h"
+#include <Network/Http/HttpResource.h>
+
+/**
+ * @brief Serves a WebAssets::Bundle
+ * @ingroup httpserver
+ *
+ * Content is sent as stored, so compressed assets are served with `Content-Encoding: gzip`
+ * and no work is done on the device. Each response carries the ETag computed at build time,
+ * so conditional requests from a browser which already has the content get `304 Not Modified`.
+ *
+ * Example:
+ *
+ * 		server.paths.setDefault(new HttpAssetResource);
+ *
+ * or to serve from a sub-directory:
+ *
+ * 		server.paths.set("/ui/*", new HttpAssetResource);
+ */
+class HttpAssetResource : public HttpResource
+{
+public:
+	HttpAssetResource(const WebAssets::Bundle& bundle = WebAssets::bundle) : bundle(bundle)
+	{
+		onRequestComplete = HttpResourceDelegate(&HttpAssetResource::requestComplete, this);
+	}
+
+	/**
+	 * @brief Set file served for paths ending in '/'
+	 */
+	void setIndexFile(const String& name)
+	{
+		indexFile = name;
+	}
+
+	/**
+	 * @brief Set Cache-Control header value
+	 * @note The default is `no-cache`, so browsers revalidate using the ETag
+	 */
+	void setCacheControl(const String& value)
+	{
+		cacheControl = value;
+	}
+
+private:
+	int requestComplete(HttpServerConnection& connection, HttpRequest& request, HttpResponse& response);
+
+	const WebAssets::Bundle& bundle;
+	String indexFile{"index.html"};
+	String cacheControl{"no-cache"};
+};
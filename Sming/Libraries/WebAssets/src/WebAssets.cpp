@@ -0,0 +1,34 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * WebAssets.cpp
+ *
+ ****/
+
+#include "WebAssets.h"
+
+namespace WebAssets
+{
+int Bundle::find(const char* path, size_t length) const
+{
+	// FNV-1a, must match webassets.py
+	uint32_t hash{2166136261U ^ seed};
+	for(size_t i = 0; i < length; ++i) {
+		hash ^= uint8_t(path[i]);
+		hash *= 16777619U;
+	}
+
+	unsigned index = pgm_read_word(&hashTable[hash % tableSize]);
+	if(index >= count()) {
+		return -1;
+	}
+	if(!files->valueAt(index).key().equals(path, length)) {
+		return -1;
+	}
+	return index;
+}
+
+} // namespace WebAssets
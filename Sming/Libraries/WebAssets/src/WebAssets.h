@@ -0,0 +1,84 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * WebAssets.h - Web content bundled into flash at build time
+ *
+ ****/
+
+#pragma once
+
+#include <FlashString/Map.hpp>
+#include <FlashString/String.hpp>
+
+namespace WebAssets
+{
+/**
+ * @brief Content is gzip-compressed
+ */
+constexpr uint32_t ASSET_FLAG_GZIP{0x01};
+
+/**
+ * @brief Metadata for one asset, generated by `webassets.py`
+ */
+struct Asset {
+	const FSTR::String* mimeType;
+	const FSTR::String* etag; ///< Including quotes
+	uint32_t flags;
+};
+
+using FileMap = FSTR::Map<FSTR::String, FSTR::String>;
+
+/**
+ * @brief Set of assets, generated by `webassets.py`
+ *
+ * `files` is a regular FlashString map of path to content, so it may also be used with
+ * `HttpResponse::sendFile()`. Paths are relative, e.g. `index.html` or `css/app.css`.
+ *
+ * Entries are located using a perfect hash computed at build time: a lookup costs one hash
+ * of the path and a single comparison against a key in flash.
+ */
+struct Bundle {
+	const FileMap* files;
+	const Asset* assets;
+	const uint16_t* hashTable;
+	uint32_t tableSize;
+	uint32_t seed;
+
+	/**
+	 * @brief Locate an asset
+	 * @param path Relative path, case-sensitive
+	 * @param length
+	 * @retval int Index of asset, -1 if not found
+	 */
+	int find(const char* path, size_t length) const;
+
+	int find(const String& path) const
+	{
+		return find(path.c_str(), path.length());
+	}
+
+	unsigned count() const
+	{
+		return files->length();
+	}
+
+	const FSTR::String& getContent(unsigned index) const
+	{
+		return files->valueAt(index).content();
+	}
+
+	Asset getAsset(unsigned index) const
+	{
+		return assets[index];
+	}
+};
+
+/**
+ * @brief The application's web assets, from the directory given by WEBASSETS_DIR
+ */
+extern const Bundle bundle;
+
+} // namespace WebAssets
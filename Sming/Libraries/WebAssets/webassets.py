@@ -0,0 +1,226 @@
+#!/usr/bin/env python3
+#
+# Build web assets into a FlashString bundle
+#
+# Each file found in the source directory is minified (where this can be done safely),
+# compressed if worthwhile and given an ETag. The output is a C++ source file declaring
+# a single FlashString map of path -> content, per-asset metadata and a perfect hash table
+# for lookups, plus the processed content which it imports using IMPORT_FSTR.
+#
+
+import argparse
+import gzip
+import hashlib
+import json
+import os
+import re
+import sys
+
+# Text types, which may be minified and compressed
+TEXT_TYPES = {
+    '.html': 'text/html',
+    '.htm': 'text/html',
+    '.css': 'text/css',
+    '.js': 'application/javascript',
+    '.mjs': 'application/javascript',
+    '.json': 'application/json',
+    '.map': 'application/json',
+    '.svg': 'image/svg+xml',
+    '.txt': 'text/plain',
+    '.xml': 'text/xml',
+    '.csv': 'text/csv',
+    '.webmanifest': 'application/manifest+json',
+}
+
+BINARY_TYPES = {
+    '.png': 'image/png',
+    '.gif': 'image/gif',
+    '.jpg': 'image/jpeg',
+    '.jpeg': 'image/jpeg',
+    '.ico': 'image/x-icon',
+    '.webp': 'image/webp',
+    '.woff': 'font/woff',
+    '.woff2': 'font/woff2',
+    '.ttf': 'font/ttf',
+    '.wasm': 'application/wasm',
+    '.bin': 'application/octet-stream',
+}
+
+# Compressed output must be at least this much smaller to be used
+MIN_COMPRESSION_RATIO = 0.9
+
+ASSET_FLAG_GZIP = 0x01
+
+FNV_OFFSET = 2166136261
+FNV_PRIME = 16777619
+
+
+def fnv1a(seed, data):
+    h = FNV_OFFSET ^ seed
+    for c in data:
+        h ^= c
+        h = (h * FNV_PRIME) & 0xffffffff
+    return h
+
+
+def find_perfect_hash(keys):
+    """Return (seed, table) where table[fnv1a(seed, key) % len(table)] gives the key index"""
+    size = max(len(keys), 1)
+    while True:
+        for seed in range(20000):
+            table = [None] * size
+            for index, key in enumerate(keys):
+                slot = fnv1a(seed, key) % size
+                if table[slot] is not None:
+                    break
+                table[slot] = index
+            else:
+                return seed, table
+        # Grow table until a collision-free seed is found
+        size += max(size // 8, 1)
+
+
+def minify_css(text):
+    text = re.sub(r'/\*.*?\*/', '', text, flags=re.S)
+    text = re.sub(r'\s+', ' ', text)
+    # Not ':' as `a :hover` differs from `a:hover`
+    text = re.sub(r'\s*([{};,>])\s*', r'\1', text)
+    return text.replace(';}', '}').strip()
+
+
+def minify_markup(text):
+    # Whitespace is significant within these elements
+    if re.search(r'<(pre|textarea)\b', text, re.I):
+        return text
+    text = re.sub(r'<!--(?!\[if).*?-->', '', text, flags=re.S)
+    lines = [line.strip() for line in text.splitlines()]
+    return '\n'.join(line for line in lines if line)
+
+
+def minify(ext, data):
+    """Only applies transformations which cannot change meaning. JavaScript is left alone."""
+    try:
+        text = data.decode('utf-8')
+    except UnicodeDecodeError:
+        return data
+    if ext in ('.json', '.map', '.webmanifest'):
+        text = json.dumps(json.loads(text), separators=(',', ':'), ensure_ascii=False)
+    elif ext == '.css':
+        text = minify_css(text)
+    elif ext in ('.html', '.htm', '.svg', '.xml'):
+        text = minify_markup(text)
+    else:
+        return data
+    return text.encode('utf-8')
+
+
+def c_string(s):
+    return '"' + s.replace('\\', '\\\\').replace('"', '\\"') + '"'
+
+
+def scan(source_dir):
+    for root, dirs, files in os.walk(source_dir):
+        dirs.sort()
+        for name in sorted(files):
+            if name.startswith('.'):
+                continue
+            path = os.path.join(root, name)
+            yield os.path.relpath(path, source_dir).replace(os.sep, '/'), path
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Build web assets into a FlashString bundle')
+    parser.add_argument('--no-minify', action='store_true', help="Don't minify content")
+    parser.add_argument('--no-compress', action='store_true', help="Don't compress content")
+    parser.add_argument('source', help='Directory containing web content')
+    parser.add_argument('output', help='Directory to write generated source and content')
+    args = parser.parse_args()
+
+    if not os.path.isdir(args.source):
+        sys.exit("Web assets directory '%s' not found" % args.source)
+    os.makedirs(args.output, exist_ok=True)
+
+    assets = []
+    total_in = total_out = 0
+    for name, path in scan(args.source):
+        with open(path, 'rb') as f:
+            data = f.read()
+        total_in += len(data)
+        ext = os.path.splitext(name)[1].lower()
+        mime = TEXT_TYPES.get(ext) or BINARY_TYPES.get(ext) or 'application/octet-stream'
+        flags = 0
+        if ext in TEXT_TYPES:
+            if not args.no_minify and '.min.' not in name:
+                data = minify(ext, data)
+            if not args.no_compress:
+                compressed = gzip.compress(data, 9, mtime=0)
+                if len(compressed) < len(data) * MIN_COMPRESSION_RATIO:
+                    data = compressed
+                    flags |= ASSET_FLAG_GZIP
+        # Tag the representation actually served
+        etag = '"%s"' % hashlib.sha1(data).hexdigest()[:16]
+        index = len(assets)
+        blob = 'asset%u.bin' % index
+        with open(os.path.join(args.output, blob), 'wb') as f:
+            f.write(data)
+        total_out += len(data)
+        assets.append({'name': name, 'mime': mime, 'etag': etag, 'flags': flags, 'blob': blob})
+
+    if not assets:
+        sys.exit("No web assets found in '%s'" % args.source)
+
+    seed, table = find_perfect_hash([a['name'].encode() for a in assets])
+    mime_types = sorted(set(a['mime'] for a in assets))
+
+    lines = [
+        '/* Generated by webassets.py from %s - do not edit */' % args.source,
+        '',
+        '#include <WebAssets.h>',
+        '',
+        'namespace WebAssets',
+        '{',
+        'namespace',
+        '{',
+    ]
+    for i, mime in enumerate(mime_types):
+        lines.append('DEFINE_FSTR_LOCAL(mime%u, %s)' % (i, c_string(mime)))
+    for i, a in enumerate(assets):
+        blob = os.path.abspath(os.path.join(args.output, a['blob'])).replace('\\', '/')
+        lines.append('DEFINE_FSTR_LOCAL(path%u, %s)' % (i, c_string(a['name'])))
+        lines.append('DEFINE_FSTR_LOCAL(etag%u, %s)' % (i, c_string(a['etag'])))
+        lines.append('IMPORT_FSTR_LOCAL(content%u, %s)' % (i, c_string(blob)))
+    lines += [
+        '',
+        'DEFINE_FSTR_MAP_LOCAL(files, FSTR::String, FSTR::String,',
+    ]
+    lines += ['\t{&path%u, &content%u},' % (i, i) for i in range(len(assets))]
+    lines[-1] = lines[-1].rstrip(',')
+    lines += [
+        ')',
+        '',
+        'const Asset assets[] PROGMEM = {',
+    ]
+    for i, a in enumerate(assets):
+        lines.append('\t{&mime%u, &etag%u, 0x%02x}, // %s' % (mime_types.index(a['mime']), i, a['flags'], a['name']))
+    lines += [
+        '};',
+        '',
+        'const uint16_t hashTable[] PROGMEM = {',
+        '\t' + ', '.join('0xffff' if x is None else str(x) for x in table),
+        '};',
+        '',
+        '} // namespace',
+        '',
+        'const Bundle bundle PROGMEM{&files, assets, hashTable, %u, %u};' % (len(table), seed),
+        '',
+        '} // namespace WebAssets',
+        '',
+    ]
+    with open(os.path.join(args.output, 'WebAssetsBundle.cpp'), 'w') as f:
+        f.write('\n'.join(lines))
+
+    print("Web assets: %u files, %u -> %u bytes" % (len(assets), total_in, total_out))
+
+
+if __name__ == '__main__':
+    main()
@@ -12,6 +12,7 @@
 
 #pragma once
 #include <stdint.h>
+#include <WString.h>
 
 enum CameraState {
 	eWCS_NOT_READY,
@@ -0,0 +1,105 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * FramePool.cpp
+ *
+ ****/
+
+#include "FramePool.h"
+#include <debug_progmem.h>
+
+FramePool::FramePool(CameraInterface& camera, unsigned frameCount, size_t frameSize)
+	: camera(camera), frames(new Frame[frameCount]), frameCount(frameCount), frameSize(frameSize)
+{
+	for(unsigned i = 0; i < frameCount; ++i) {
+		frames[i].data.reset(new uint8_t[frameSize]);
+	}
+}
+
+bool FramePool::start(unsigned intervalMs)
+{
+	if(camera.getState() == eWCS_NOT_READY && !camera.init()) {
+		return false;
+	}
+	timer.initializeMs(intervalMs, TimerCallback([](void* param) { static_cast<FramePool*>(param)->poll(); }), this);
+	timer.start();
+	return true;
+}
+
+FramePool::Frame* FramePool::acquire(uint32_t lastSequence)
+{
+	if(latest == nullptr || latest->sequence == lastSequence) {
+		return nullptr;
+	}
+	++latest->refCount;
+	return latest;
+}
+
+void FramePool::release(Frame* frame)
+{
+	if(frame != nullptr && frame->refCount != 0) {
+		--frame->refCount;
+	}
+}
+
+FramePool::Frame* FramePool::getFreeFrame()
+{
+	for(unsigned i = 0; i < frameCount; ++i) {
+		if(frames[i].refCount == 0) {
+			return &frames[i];
+		}
+	}
+	return nullptr;
+}
+
+bool FramePool::readPicture(Frame& frame)
+{
+	size_t size = camera.getSize();
+	if(size == 0 || size > frameSize) {
+		debug_w("[CAM] Picture size %u exceeds frame size %u", size, frameSize);
+		return false;
+	}
+
+	size_t offset{0};
+	while(offset < size) {
+		auto n = camera.read(reinterpret_cast<char*>(&frame.data[offset]), size - offset, offset);
+		if(n == 0) {
+			return false;
+		}
+		offset += n;
+	}
+
+	frame.length = size;
+	return true;
+}
+
+void FramePool::poll()
+{
+	switch(camera.getState()) {
+	case eWCS_HAS_PICTURE: {
+		auto frame = getFreeFrame();
+		if(frame != nullptr && readPicture(*frame)) {
+			frame->sequence = ++sequence;
+			frame->refCount = 1;
+			release(latest);
+			latest = frame;
+		} else {
+			++droppedCount;
+		}
+		camera.next();
+		// Start next capture immediately so it overlaps transmission
+		camera.capture();
+		break;
+	}
+
+	case eWCS_READY:
+		camera.capture();
+		break;
+
+	default:
+		break;
+	}
+}
@@ -0,0 +1,99 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * FramePool.h
+ *
+ ****/
+
+#pragma once
+
+#include "Camera/CameraInterface.h"
+#include <SimpleTimer.h>
+#include <memory>
+
+/**
+ * @brief Fixed set of frame buffers shared by all viewers of a camera
+ *
+ * The camera is driven from a timer, so the next picture is captured whilst viewers
+ * are still sending earlier ones. Each completed picture is copied into a free buffer
+ * and becomes the latest frame.
+ *
+ * Viewers take a reference to the latest frame when they are ready for one, so slow
+ * clients skip frames rather than holding up capture. If every buffer is still in use
+ * the new picture is dropped.
+ */
+class FramePool
+{
+public:
+	struct Frame {
+		std::unique_ptr<uint8_t[]> data;
+		size_t length{0};
+		uint32_t sequence{0};
+		uint8_t refCount{0};
+	};
+
+	/**
+	 * @param camera
+	 * @param frameCount Number of buffers, allow one per viewer plus one for capture
+	 * @param frameSize Largest picture to be handled
+	 */
+	FramePool(CameraInterface& camera, unsigned frameCount, size_t frameSize);
+
+	~FramePool()
+	{
+		stop();
+	}
+
+	/**
+	 * @brief Start capturing in the background
+	 * @param intervalMs How often to check the camera for a new picture
+	 */
+	bool start(unsigned intervalMs = 10);
+
+	void stop()
+	{
+		timer.stop();
+	}
+
+	/**
+	 * @brief Take a reference to the latest frame
+	 * @param lastSequence Sequence number of frame previously sent to this viewer
+	 * @retval Frame* nullptr if no newer frame is available
+	 */
+	Frame* acquire(uint32_t lastSequence);
+
+	/**
+	 * @brief Release a frame obtained from `acquire()`
+	 */
+	void release(Frame* frame);
+
+	CameraInterface& getCamera()
+	{
+		return camera;
+	}
+
+	/**
+	 * @brief Number of pictures discarded as no buffer was free, or they were too large
+	 */
+	uint32_t getDroppedCount() const
+	{
+		return droppedCount;
+	}
+
+private:
+	void poll();
+	Frame* getFreeFrame();
+	bool readPicture(Frame& frame);
+
+	CameraInterface& camera;
+	std::unique_ptr<Frame[]> frames;
+	uint8_t frameCount;
+	size_t frameSize;
+	Frame* latest{nullptr}; ///< Pool holds a reference to this
+	uint32_t sequence{0};
+	uint32_t droppedCount{0};
+	SimpleTimer timer;
+};
@@ -0,0 +1,59 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * MjpegStream.cpp
+ *
+ ****/
+
+#include "MjpegStream.h"
+
+bool FrameStream::acquire()
+{
+	if(frame == nullptr) {
+		frame = pool.acquire(lastSequence);
+		if(frame != nullptr) {
+			lastSequence = frame->sequence;
+		}
+	}
+	return frame != nullptr;
+}
+
+uint16_t FrameStream::readMemoryBlock(char* data, int bufSize)
+{
+	if(bufSize <= 0 || !acquire()) {
+		return 0;
+	}
+	size_t n = std::min(size_t(bufSize), frame->length - offset);
+	memcpy(data, &frame->data[offset], n);
+	return n;
+}
+
+size_t FrameStream::peekRegion(const char*& data)
+{
+	if(!acquire()) {
+		return 0;
+	}
+	data = reinterpret_cast<const char*>(&frame->data[offset]);
+	return frame->length - offset;
+}
+
+bool FrameStream::seek(int len)
+{
+	if(frame == nullptr || len < 0 || offset + len > frame->length) {
+		return false;
+	}
+	offset += len;
+	return true;
+}
+
+MultipartStream::BodyPart MjpegStream::produce()
+{
+	BodyPart result;
+	result.headers = new HttpHeaders();
+	(*result.headers)[HTTP_HEADER_CONTENT_TYPE] = pool.getCamera().getMimeType();
+	result.stream = new FrameStream(pool, lastSequence);
+	return result;
+}
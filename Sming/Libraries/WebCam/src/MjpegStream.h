@@ -0,0 +1,97 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * MjpegStream.h
+ *
+ ****/
+
+#pragma once
+
+#include "FramePool.h"
+#include <Data/Stream/MultipartStream.h>
+
+/**
+ * @brief Read-only stream over a single frame from a FramePool
+ *
+ * Holds a reference to the frame until destroyed. Content is read in place,
+ * via `peekRegion()`, without copying.
+ *
+ * If no newer frame is available on construction then one is acquired as soon as it becomes
+ * available; until then the stream reports no data.
+ */
+class FrameStream : public IDataSourceStream
+{
+public:
+	/**
+	 * @param pool
+	 * @param lastSequence Sequence of last frame sent to viewer, updated when a frame is acquired
+	 */
+	FrameStream(FramePool& pool, uint32_t& lastSequence) : pool(pool), lastSequence(lastSequence)
+	{
+		acquire();
+	}
+
+	~FrameStream()
+	{
+		pool.release(frame);
+	}
+
+	uint16_t readMemoryBlock(char* data, int bufSize) override;
+
+	size_t peekRegion(const char*& data) override;
+
+	bool seek(int len) override;
+
+	bool isFinished() override
+	{
+		return frame != nullptr && offset >= frame->length;
+	}
+
+	int available() override
+	{
+		return frame ? int(frame->length - offset) : -1;
+	}
+
+private:
+	bool acquire();
+
+	FramePool& pool;
+	uint32_t& lastSequence;
+	FramePool::Frame* frame{nullptr};
+	size_t offset{0};
+};
+
+/**
+ * @brief MJPEG (multipart/x-mixed-replace) stream for one viewer
+ *
+ * Each part is the latest frame from the pool, so a slow viewer receives fewer frames
+ * without affecting capture or other viewers.
+ *
+ * Example:
+ *
+ * ```
+ * auto stream = new MjpegStream(framePool);
+ * response.sendDataStream(stream, stream->getContentType());
+ * ```
+ */
+class MjpegStream : public MultipartStream
+{
+public:
+	MjpegStream(FramePool& pool) : MultipartStream(Producer(&MjpegStream::produce, this)), pool(pool)
+	{
+	}
+
+	String getContentType()
+	{
+		return F("multipart/x-mixed-replace; boundary=") + getBoundary();
+	}
+
+private:
+	BodyPart produce();
+
+	FramePool& pool;
+	uint32_t lastSequence{0};
+};
@@ -9,6 +9,8 @@
  ****/
 
 #include "include/Protobuf/Stream.h"
+#include <debug_progmem.h>
+#include <algorithm>
 
 // See: https://iam777.tistory.com/538
 
@@ -25,22 +27,168 @@ bool InputStream::decode(const pb_msgdesc_t* fields, void* dest_struct)
 		auto self = static_cast<InputStream*>(stream->state);
 		assert(self != nullptr);
 		size_t read = self->stream.readBytes(reinterpret_cast<char*>(buf), count);
-		return true;
+		return read == count;
 	};
 	is.state = this;
 	is.bytes_left = size_t(avail);
 	is.errmsg = nullptr;
-	return pb_decode(&is, fields, dest_struct);
+	bool res = pb_decode(&is, fields, dest_struct);
+	errmsg = is.errmsg;
+	return res;
+}
+
+bool PbufInputStream::decode(const pb_msgdesc_t* fields, void* dest_struct, unsigned flags)
+{
+	if(buf == nullptr || offset >= buf->tot_len) {
+		return false;
+	}
+	pb_istream_t is{};
+	is.callback = [](pb_istream_t* stream, pb_byte_t* data, size_t count) -> bool {
+		auto self = static_cast<PbufInputStream*>(stream->state);
+		assert(self != nullptr);
+		auto read = pbuf_copy_partial(self->buf, data, count, self->offset);
+		self->offset += read;
+		return read == count;
+	};
+	is.state = this;
+	is.bytes_left = buf->tot_len - offset;
+	is.errmsg = nullptr;
+	bool res = pb_decode_ex(&is, fields, dest_struct, flags);
+	errmsg = is.errmsg;
+	return res;
 }
 
-size_t OutputStream::encode(const pb_msgdesc_t* fields, const void* src_struct)
+size_t OutputStream::encode(const pb_msgdesc_t* fields, const void* src_struct, unsigned flags)
 {
 	pb_ostream_t os{};
 	os.state = const_cast<OutputStream*>(this);
 	os.callback = buf_write;
 	os.max_size = SIZE_MAX;
 
-	return pb_encode(&os, fields, src_struct) ? os.bytes_written : 0;
+	return pb_encode_ex(&os, fields, src_struct, flags) ? os.bytes_written : 0;
+}
+
+size_t TcpConnectionOutputStream::encode(const pb_msgdesc_t* fields, const void* src_struct, unsigned flags)
+{
+	size_t size;
+	if(!pb_get_encoded_size(&size, fields, src_struct)) {
+		return 0;
+	}
+	if(flags & PB_ENCODE_DELIMITED) {
+		// Length prefix is a varint
+		size_t prefixSize{1};
+		for(size_t n = size >> 7; n != 0; n >>= 7) {
+			++prefixSize;
+		}
+		size += prefixSize;
+	}
+	if(size > connection.getAvailableWriteSize()) {
+		debug_w("[PB] Message size %u exceeds TCP send space", size);
+		return 0;
+	}
+
+	length = 0;
+	size_t written = OutputStream::encode(fields, src_struct, flags);
+	if(written == 0 || !flushBuffer()) {
+		return 0;
+	}
+	connection.flush();
+	return written;
+}
+
+bool TcpConnectionOutputStream::write(const pb_byte_t* buf, size_t count)
+{
+	if(length + count > sizeof(buffer)) {
+		if(!flushBuffer()) {
+			return false;
+		}
+		if(count > sizeof(buffer)) {
+			return connection.write(reinterpret_cast<const char*>(buf), count,
+									TCP_WRITE_FLAG_COPY | TCP_WRITE_FLAG_MORE) >= 0;
+		}
+	}
+	memcpy(&buffer[length], buf, count);
+	length += count;
+	return true;
+}
+
+bool TcpConnectionOutputStream::flushBuffer()
+{
+	if(length == 0) {
+		return true;
+	}
+	int err = connection.write(reinterpret_cast<const char*>(buffer), length, TCP_WRITE_FLAG_COPY | TCP_WRITE_FLAG_MORE);
+	length = 0;
+	return err >= 0;
+}
+
+size_t EncodeStream::getSize()
+{
+	if(!sizeKnown) {
+		if(!pb_get_encoded_size(&size, fields, src_struct)) {
+			size = 0;
+		}
+		sizeKnown = true;
+	}
+	return size;
+}
+
+uint16_t EncodeStream::readMemoryBlock(char* data, int bufSize)
+{
+	if(bufSize <= 0 || isFinished()) {
+		return 0;
+	}
+
+	// Capture output which falls within [start, end)
+	struct Window {
+		char* data;
+		size_t start;
+		size_t end;
+		size_t pos;
+	};
+	Window window{data, position, std::min(position + bufSize, getSize()), 0};
+
+	pb_ostream_t os{};
+	os.state = &window;
+	os.callback = [](pb_ostream_t* stream, const pb_byte_t* buf, size_t count) -> bool {
+		auto& w = *static_cast<Window*>(stream->state);
+		size_t from = std::max(w.pos, w.start);
+		size_t to = std::min(w.pos + count, w.end);
+		if(from < to) {
+			memcpy(&w.data[from - w.start], &buf[from - w.pos], to - from);
+		}
+		w.pos += count;
+		// Stop encoding once the window is filled
+		return w.pos < w.end;
+	};
+	os.max_size = SIZE_MAX;
+	pb_encode(&os, fields, src_struct);
+
+	size_t end = std::min(window.pos, window.end);
+	return (end > position) ? end - position : 0;
+}
+
+int EncodeStream::seekFrom(int offset, SeekOrigin origin)
+{
+	size_t newPos;
+	switch(origin) {
+	case SeekOrigin::Start:
+		newPos = offset;
+		break;
+	case SeekOrigin::Current:
+		newPos = position + offset;
+		break;
+	case SeekOrigin::End:
+		newPos = getSize() + offset;
+		break;
+	default:
+		return -1;
+	}
+	if(newPos > getSize()) {
+		return -1;
+	}
+	position = newPos;
+	return position;
 }
 
 } // namespace Protobuf
@@ -15,6 +15,7 @@
 #include <pb_encode.h>
 #include <pb_decode.h>
 #include <Network/TcpClient.h>
+#include <lwip/pbuf.h>
 
 namespace Protobuf
 {
@@ -45,10 +46,62 @@ private:
 	IDataSourceStream& stream;
 };
 
+/**
+ * @brief Decode directly from a chain of received pbufs, such as in a `TcpConnection::onReceive()` override
+ */
+class PbufInputStream : public Stream
+{
+public:
+	/**
+	 * @param buf Chain to read from, remains owned by caller
+	 * @param offset Starting position within the chain
+	 */
+	PbufInputStream(const pbuf* buf, size_t offset = 0) : buf(buf), offset(offset)
+	{
+	}
+
+	/**
+	 * @brief Decode a message
+	 * @param fields
+	 * @param dest_struct
+	 * @param flags Options for `pb_decode_ex()`, such as PB_DECODE_DELIMITED to read a length prefix
+	 * @retval bool
+	 *
+	 * Without PB_DECODE_DELIMITED the remainder of the chain is taken as the message.
+	 * With it, several messages may be decoded in turn from the same chain.
+	 */
+	bool decode(const pb_msgdesc_t* fields, void* dest_struct, unsigned flags = 0);
+
+	/**
+	 * @brief Get position following the last message decoded
+	 */
+	size_t getOffset() const
+	{
+		return offset;
+	}
+
+	String getErrorString() const
+	{
+		return errmsg;
+	}
+
+private:
+	const char* errmsg{nullptr};
+	const pbuf* buf;
+	size_t offset;
+};
+
 class OutputStream : public Stream
 {
 public:
-	size_t encode(const pb_msgdesc_t* fields, const void* src_struct);
+	/**
+	 * @brief Encode a message
+	 * @param fields
+	 * @param src_struct
+	 * @param flags Options for `pb_encode_ex()`, such as PB_ENCODE_DELIMITED to write a length prefix
+	 * @retval size_t Number of bytes written, 0 on error
+	 */
+	size_t encode(const pb_msgdesc_t* fields, const void* src_struct, unsigned flags = 0);
 
 protected:
 	static bool buf_write(pb_ostream_t* stream, const pb_byte_t* buf, size_t count)
@@ -87,4 +140,104 @@ protected:
 	TcpClient& client;
 };
 
+/**
+ * @brief Encode directly into a connection's TCP send buffer
+ *
+ * The encoded size is calculated first, so a message is only written if it fits completely.
+ * Small pieces of output are combined before passing to the TCP stack.
+ */
+class TcpConnectionOutputStream : public OutputStream
+{
+public:
+	TcpConnectionOutputStream(TcpConnection& connection) : connection(connection)
+	{
+	}
+
+	/**
+	 * @brief Encode a message and push it out
+	 * @retval size_t Number of bytes written, 0 on error or if there is insufficient send buffer space
+	 * @see `OutputStream::encode()`
+	 */
+	size_t encode(const pb_msgdesc_t* fields, const void* src_struct, unsigned flags = 0);
+
+protected:
+	bool write(const pb_byte_t* buf, size_t count) override;
+
+private:
+	bool flushBuffer();
+
+	TcpConnection& connection;
+	uint8_t buffer[64];
+	uint8_t length{0};
+};
+
+/**
+ * @brief Read-only stream which produces encoded message content on demand
+ *
+ * This may be passed to `MqttClient::publish()` or `TcpClient::send()`, for example,
+ * without first encoding the message into RAM.
+ *
+ * Each read encodes the message again, discarding output outside the requested range.
+ * This is normally a single pass as messages are usually smaller than the reader's buffer.
+ *
+ * @note The message structure, and any callback arguments it refers to, must remain valid
+ * until the stream has been consumed. See `MessageEncodeStream` to hold a copy of the structure.
+ */
+class EncodeStream : public IDataSourceStream
+{
+public:
+	EncodeStream(const pb_msgdesc_t* fields, const void* src_struct) : fields(fields), src_struct(src_struct)
+	{
+	}
+
+	bool isValid() const override
+	{
+		return const_cast<EncodeStream*>(this)->getSize() > 0;
+	}
+
+	uint16_t readMemoryBlock(char* data, int bufSize) override;
+
+	int seekFrom(int offset, SeekOrigin origin) override;
+
+	bool isFinished() override
+	{
+		return position >= getSize();
+	}
+
+	int available() override
+	{
+		return getSize() - position;
+	}
+
+	MimeType getMimeType() const override
+	{
+		return MIME_BINARY;
+	}
+
+private:
+	size_t getSize();
+
+	const pb_msgdesc_t* fields;
+	const void* src_struct;
+	size_t size{0};
+	size_t position{0};
+	bool sizeKnown{false};
+};
+
+/**
+ * @brief Encoding stream holding its own copy of a message structure
+ * @tparam Message Generated message type
+ */
+template <typename Message> class MessageEncodeStream : public EncodeStream
+{
+public:
+	MessageEncodeStream(const pb_msgdesc_t* fields, const Message& message)
+		: EncodeStream(fields, &this->message), message(message)
+	{
+	}
+
+private:
+	Message message;
+};
+
 } // namespace Protobuf
@@ -17,6 +17,16 @@
 
 #include <cstdint>
 
+/**
+ * @name Range of RTC memory blocks (4 bytes each) available for use with RtcClass::readMemory()
+ * @note On the Esp8266, blocks 64-70 are used by rBoot and RTC, 72-88 for Station fast connect
+ * and 90-92 for NtpClient drift correction.
+ * @{
+ */
+#define RTC_MEMORY_BLOCK_START 64
+#define RTC_MEMORY_BLOCK_END 192
+/** @} */
+
 /** @brief  Real time clock class
  *  @addtogroup rtc
  *  @{
@@ -51,6 +61,23 @@ public:
      *  @note   Updates RTC NVRAM
      */
 	bool setRtcSeconds(uint32_t seconds);
+
+	/** @brief  Read from RTC memory, which is retained through deep sleep
+	 *  @param  block First 4-byte block to read, from RTC_MEMORY_BLOCK_START
+	 *  @param  data Buffer for data
+	 *  @param  size Number of bytes to read, a multiple of 4
+	 *  @retval bool True on success, false if out of range or not supported
+	 *  @note   Content is undefined following power-on, see RtcState
+	 */
+	bool readMemory(uint8_t block, void* data, uint16_t size);
+
+	/** @brief  Write to RTC memory
+	 *  @param  block First 4-byte block to write, from RTC_MEMORY_BLOCK_START
+	 *  @param  data Data to write
+	 *  @param  size Number of bytes to write, a multiple of 4
+	 *  @retval bool True on success, false if out of range or not supported
+	 */
+	bool writeMemory(uint8_t block, const void* data, uint16_t size);
 };
 
 /**	@brief	Global instance of real time clock object
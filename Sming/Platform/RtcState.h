@@ -0,0 +1,134 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * RtcState.h - Typed, checksummed storage in RTC memory
+ *
+ ****/
+
+#pragma once
+
+#include "RTC.h"
+#include <cstring>
+#include <type_traits>
+
+/** @brief  Keep a value in RTC memory so it survives deep sleep
+ *  @tparam T Must be trivially copyable
+ *
+ *  RTC memory holds garbage after power-on, so the value is stored with a magic number,
+ *  which includes its size, and a checksum. `load()` fails if either doesn't match.
+ *
+ *  Each instance occupies `blockCount` blocks from its starting block, so ranges must not overlap.
+ *  See `RTC_MEMORY_BLOCK_START` for those used by the framework.
+ *
+ *  Example:
+ *
+ *  @code
+ *  struct SensorState {
+ *  	uint32_t readingCount;
+ *  	int16_t lastReading;
+ *  };
+ *
+ *  RtcState<SensorState> sensorRtcState(100);
+ *
+ *  void init()
+ *  {
+ *  	SensorState state{};
+ *  	sensorRtcState.load(state); // Leaves `state` unchanged on failure
+ *  	++state.readingCount;
+ *  	...
+ *  	sensorRtcState.save(state);
+ *  	System.deepSleep(60000);
+ *  }
+ *  @endcode
+ *
+ *  @ingroup rtc
+ */
+template <typename T> class RtcState
+{
+public:
+	static_assert(std::is_trivially_copyable<T>::value, "RtcState requires a trivially copyable type");
+
+	explicit constexpr RtcState(uint8_t block) : block(block)
+	{
+	}
+
+	/** @brief  Read the value from RTC memory
+	 *  @param  value On success, the stored value
+	 *  @retval bool false if nothing valid has been stored, `value` is unchanged
+	 */
+	bool load(T& value) const
+	{
+		Record rec;
+		if(!RTC.readMemory(block, &rec, sizeof(rec))) {
+			return false;
+		}
+		if(rec.magic != magicValue || rec.check != checksum(rec)) {
+			return false;
+		}
+		memcpy(&value, &rec.value, sizeof(T));
+		return true;
+	}
+
+	/** @brief  Write the value to RTC memory
+	 *  @param  value
+	 *  @retval bool true on success
+	 */
+	bool save(const T& value) const
+	{
+		Record rec;
+		// Clear any padding so checksum is repeatable
+		memset(&rec, 0, sizeof(rec));
+		rec.magic = magicValue;
+		memcpy(&rec.value, &value, sizeof(T));
+		rec.check = checksum(rec);
+		return RTC.writeMemory(block, &rec, sizeof(rec));
+	}
+
+	/** @brief  Ensure a subsequent `load()` fails
+	 *  @retval bool true on success
+	 */
+	bool invalidate() const
+	{
+		uint32_t magic{0};
+		return RTC.writeMemory(block, &magic, sizeof(magic));
+	}
+
+	uint8_t getBlock() const
+	{
+		return block;
+	}
+
+private:
+	struct Record {
+		uint32_t magic;
+		uint32_t check;
+		T value;
+	};
+
+	static_assert(sizeof(Record) % 4 == 0, "RtcState record must be a whole number of blocks");
+
+public:
+	/** @brief  Number of 4-byte RTC memory blocks used
+	 */
+	static constexpr unsigned blockCount{sizeof(Record) / 4};
+
+private:
+	static constexpr uint32_t magicValue{0x52540000 | sizeof(T)};
+
+	static uint32_t checksum(const Record& rec)
+	{
+		// Covers any trailing padding, which save() zeroes
+		auto bytes = reinterpret_cast<const uint8_t*>(&rec.value);
+		auto end = reinterpret_cast<const uint8_t*>(&rec + 1);
+		uint32_t sum{0x5a5a5a5a};
+		for(; bytes < end; ++bytes) {
+			sum = ((sum << 5) | (sum >> 27)) ^ *bytes;
+		}
+		return sum;
+	}
+
+	uint8_t block;
+};
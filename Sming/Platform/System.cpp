@@ -10,27 +10,119 @@
 
 #include "Platform/System.h"
 #include "Timer.h"
+#include <Services/Profiling/Metrics.h>
 
 SystemClass System;
 SystemState SystemClass::state = eSS_None;
+uint32_t SystemClass::bootTimes[SystemClass::bootPhaseCount];
+
+// Queue wait times are included with task statistics and metrics
+#if !defined(ENABLE_TASK_LATENCY) && (defined(ENABLE_TASK_STATS) || defined(ENABLE_METRICS))
+#define ENABLE_TASK_LATENCY 1
+#endif
 
-#ifdef ARCH_ESP32
-#undef TASK_QUEUE_LENGTH
-#define TASK_QUEUE_LENGTH 0
-#define taskQueue nullptr
-#else
 #ifdef TASK_QUEUE_LENGTH
 static_assert(TASK_QUEUE_LENGTH >= 8, "Task queue too small");
 #else
-/** @brief default number of tasks in global queue
+/** @brief default number of tasks in each priority queue
  *  @note tasks are usually short-lived and executed very promptly, so a large queue is
  *  normally un-necessry. If queue overrun is suspected, check `SystemClass::getMaxTaskCount()`.
  */
 #define TASK_QUEUE_LENGTH 10
 #endif
-os_event_t SystemClass::taskQueue[TASK_QUEUE_LENGTH];
+
+namespace
+{
+#ifdef ARCH_ESP32
+/*
+ * Callbacks may be queued from any FreeRTOS task, possibly running on the other core,
+ * so disabling interrupts is not sufficient to protect queue statistics.
+ */
+portMUX_TYPE queueLock = portMUX_INITIALIZER_UNLOCKED;
+
+__forceinline uint32_t lockQueues()
+{
+	portENTER_CRITICAL_SAFE(&queueLock);
+	return 0;
+}
+
+__forceinline void unlockQueues(uint32_t)
+{
+	portEXIT_CRITICAL_SAFE(&queueLock);
+}
+#else
+__forceinline uint32_t lockQueues()
+{
+	return noInterrupts();
+}
+
+__forceinline void unlockQueues(uint32_t level)
+{
+	restoreInterrupts(level);
+}
 #endif
 
+constexpr unsigned taskPriorityCount{unsigned(TaskPriority::High) + 1};
+static_assert(USER_TASK_PRIO_0 + taskPriorityCount <= USER_TASK_PRIO_MAX, "Insufficient OS task priorities");
+
+#ifdef ARCH_ESP32
+// Queues are allocated by FreeRTOS
+os_event_t* const taskQueues[taskPriorityCount]{};
+#else
+os_event_t taskQueues[taskPriorityCount][TASK_QUEUE_LENGTH];
+#endif
+
+#ifdef ENABLE_TASK_LATENCY
+/*
+ * Each OS queue is FIFO, so enqueue times are kept in a matching ring buffer
+ */
+struct LatencyQueue {
+	uint32_t timestamps[TASK_QUEUE_LENGTH];
+	uint8_t read;
+	uint8_t count;
+	uint32_t deadline;
+	SystemClass::TaskLatency stats;
+};
+
+LatencyQueue latencyQueues[taskPriorityCount];
+
+METRIC_HISTOGRAM(taskQueueWait, "sming_task_queue_wait_us", "Time callbacks spend in the task queue");
+#endif
+
+#ifdef ENABLE_TASK_STATS
+SystemClass::TaskStats taskStats;
+
+void recordExecution(uint32_t address, uint32_t time)
+{
+	using TaskStats = SystemClass::TaskStats;
+
+	unsigned bucket{0};
+	while(bucket + 1 < TaskStats::histogramSize && time >= TaskStats::getBucketLimit(bucket)) {
+		++bucket;
+	}
+	++taskStats.histogram[bucket];
+
+	// Keep list of slowest callbacks in descending order of time, one entry per callback
+	auto& list = taskStats.slowest;
+	int pos = TaskStats::slowestCount - 1;
+	for(int i = 0; i < int(TaskStats::slowestCount); ++i) {
+		if(list[i].address == address) {
+			pos = i;
+			break;
+		}
+	}
+	if(time <= list[pos].time) {
+		return;
+	}
+	list[pos] = {address, time};
+	for(; pos > 0 && list[pos].time > list[pos - 1].time; --pos) {
+		std::swap(list[pos], list[pos - 1]);
+	}
+}
+#endif
+
+} // namespace
+
 #ifdef ENABLE_TASK_COUNT
 volatile uint8_t SystemClass::taskCount;
 volatile uint8_t SystemClass::maxTaskCount;
@@ -39,16 +131,49 @@ volatile uint8_t SystemClass::maxTaskCount;
 /** @brief OS calls this function which invokes user-defined callback
  *  @note callback function pointer is placed in event->sig, with parameter in event->par.
  */
-void SystemClass::taskHandler(os_event_t* event)
+template <TaskPriority prio> void SystemClass::taskHandler(os_event_t* event)
 {
+#if defined(ENABLE_TASK_COUNT) || defined(ENABLE_TASK_LATENCY)
+	auto level = lockQueues();
 #ifdef ENABLE_TASK_COUNT
-	auto level = noInterrupts();
 	--taskCount;
-	restoreInterrupts(level);
 #endif
+#ifdef ENABLE_TASK_LATENCY
+	auto& queue = latencyQueues[unsigned(prio)];
+	uint32_t timestamp{0};
+	bool timed = (queue.count != 0);
+	if(timed) {
+		timestamp = queue.timestamps[queue.read];
+		queue.read = (queue.read + 1) % TASK_QUEUE_LENGTH;
+		--queue.count;
+	}
+#endif
+	unlockQueues(level);
+#endif
+
+#ifdef ENABLE_TASK_LATENCY
+	if(timed) {
+		uint32_t latency = system_get_time() - timestamp;
+		auto& stats = queue.stats;
+		++stats.count;
+		stats.total += latency;
+		stats.max = std::max(stats.max, latency);
+		if(queue.deadline != 0 && latency > queue.deadline) {
+			++stats.missed;
+		}
+		taskQueueWait.observe(latency);
+	}
+#endif
+
 	auto callback = reinterpret_cast<TaskCallback32>(event->sig);
 	if(callback != nullptr) {
+#ifdef ENABLE_TASK_STATS
+		auto startTime = system_get_time();
+		callback(event->par);
+		recordExecution(event->sig, system_get_time() - startTime);
+#else
 		callback(event->par);
+#endif
 	}
 }
 
@@ -60,39 +185,78 @@ bool SystemClass::initialize()
 
 	state = eSS_Intializing;
 
-	// Initialise the global task queue
-	if(!system_os_task(taskHandler, USER_TASK_PRIO_1, taskQueue, TASK_QUEUE_LENGTH)) {
-		return false;
+	// Initialise the global task queues
+	os_task_t handlers[taskPriorityCount]{
+		taskHandler<TaskPriority::Low>,
+		taskHandler<TaskPriority::Normal>,
+		taskHandler<TaskPriority::High>,
+	};
+	for(unsigned i = 0; i < taskPriorityCount; ++i) {
+		if(!system_os_task(handlers[i], USER_TASK_PRIO_0 + i, taskQueues[i], TASK_QUEUE_LENGTH)) {
+			return false;
+		}
 	}
 
 #ifdef ARCH_ESP8266
-	system_init_done_cb([]() { state = eSS_Ready; });
+	system_init_done_cb([]() {
+		setBootPhase(BootPhase::ready);
+		state = eSS_Ready;
+	});
 #else
+	setBootPhase(BootPhase::ready);
 	state = eSS_Ready;
 #endif
 
 	return true;
 }
 
-bool SystemClass::queueCallback(TaskCallback32 callback, uint32_t param)
+void SystemClass::setBootPhase(BootPhase phase)
+{
+	auto& time = bootTimes[unsigned(phase)];
+	if(time == 0) {
+		// Zero means 'not recorded'
+		time = std::max(system_get_time(), uint32_t(1));
+	}
+}
+
+bool SystemClass::queueCallback(TaskCallback32 callback, uint32_t param, TaskPriority prio)
 {
-	if(callback == nullptr) {
+	auto index = unsigned(prio);
+	if(callback == nullptr || index >= taskPriorityCount) {
 		return false;
 	}
 
 #ifdef ENABLE_TASK_COUNT
-	auto level = noInterrupts();
+	auto level = lockQueues();
 	++taskCount;
 	if(taskCount > maxTaskCount) {
 		maxTaskCount = taskCount;
 	}
-	restoreInterrupts(level);
+	unlockQueues(level);
 #endif
 
-	return system_os_post(USER_TASK_PRIO_1, reinterpret_cast<os_signal_t>(callback), param);
+#ifdef ENABLE_TASK_LATENCY
+	// Timestamp must be recorded in the same order as posting
+	auto irqLevel = lockQueues();
+	bool ok = system_os_post(USER_TASK_PRIO_0 + index, reinterpret_cast<os_signal_t>(callback), param);
+	auto& queue = latencyQueues[index];
+	if(ok && queue.count < TASK_QUEUE_LENGTH) {
+		queue.timestamps[(queue.read + queue.count) % TASK_QUEUE_LENGTH] = system_get_time();
+		++queue.count;
+	}
+#ifdef ENABLE_TASK_STATS
+	if(!ok) {
+		++taskStats.dropped[index];
+	}
+#endif
+	unlockQueues(irqLevel);
+	return ok;
+#else
+	return system_os_post(USER_TASK_PRIO_0 + index, reinterpret_cast<os_signal_t>(callback), param);
+#endif
 }
 
-bool SystemClass::queueCallback(TaskDelegate callback)
+bool SystemClass::queueCallback(TaskDelegate callback, TaskPriority prio)
 {
 	if(!callback) {
 		return false;
@@ -111,7 +275,7 @@ bool SystemClass::queueCallback(TaskDelegate callback)
 		delete delegate;
 	};
 
-	if(!queueCallback(delegateHandler, delegate)) {
+	if(!queueCallback(delegateHandler, delegate, prio)) {
 		delete delegate;
 		return false;
 	}
@@ -119,6 +283,75 @@ bool SystemClass::queueCallback(TaskDelegate callback)
 	return true;
 }
 
+SystemClass::TaskLatency SystemClass::getTaskLatency(TaskPriority prio)
+{
+#ifdef ENABLE_TASK_LATENCY
+	auto index = unsigned(prio);
+	if(index < taskPriorityCount) {
+		auto level = lockQueues();
+		auto stats = latencyQueues[index].stats;
+		unlockQueues(level);
+		return stats;
+	}
+#endif
+	return TaskLatency{};
+}
+
+void SystemClass::resetTaskLatency()
+{
+#ifdef ENABLE_TASK_LATENCY
+	auto level = lockQueues();
+	for(auto& queue : latencyQueues) {
+		queue.stats = TaskLatency{};
+	}
+	unlockQueues(level);
+#endif
+}
+
+void SystemClass::setTaskDeadline(TaskPriority prio, uint32_t deadline)
+{
+#ifdef ENABLE_TASK_LATENCY
+	auto index = unsigned(prio);
+	if(index < taskPriorityCount) {
+		latencyQueues[index].deadline = deadline;
+	}
+#else
+	(void)prio;
+	(void)deadline;
+#endif
+}
+
+bool SystemClass::getTaskStats(TaskStats& stats)
+{
+#ifdef ENABLE_TASK_STATS
+	auto level = lockQueues();
+	stats = taskStats;
+	unlockQueues(level);
+	return true;
+#else
+	(void)stats;
+	return false;
+#endif
+}
+
+void SystemClass::resetTaskStats()
+{
+#ifdef ENABLE_TASK_STATS
+	auto level = lockQueues();
+	taskStats = TaskStats{};
+	unlockQueues(level);
+#endif
+}
+
+uint32_t SystemClass::getIdleTime()
+{
+#ifdef ENABLE_TICKLESS_IDLE
+	return system_get_idle_time();
+#else
+	return 0;
+#endif
+}
+
 void SystemClass::restart(unsigned deferMillis)
 {
 	if(deferMillis == 0) {
@@ -43,7 +43,7 @@ using TaskCallback = void (*)(void* param);
 
 /** @brief Task Delegate callback type
  */
-using TaskDelegate = Delegate<void()>;
+using TaskDelegate = InplaceDelegate<void()>;
 
 /** @brief Handler function for system ready
  */
@@ -64,6 +64,24 @@ public:
 	virtual void onSystemReady() = 0;
 };
 
+/**
+ * @brief Task queue priority
+ *
+ * Each priority has its own queue. Queued callbacks with a higher priority are always executed first.
+ */
+enum class TaskPriority {
+	Low,	///< Background work such as logging or display updates
+	Normal, ///< Default priority
+	High,   ///< Latency-sensitive work such as network or control loop callbacks
+};
+
+/**
+ * @brief Number of slowest callbacks recorded in SystemClass::TaskStats
+ */
+#ifndef TASK_STATS_SLOWEST
+#define TASK_STATS_SLOWEST 5
+#endif
+
 /**
  * @brief Common CPU frequencies
  */
@@ -95,6 +113,17 @@ enum SystemState {
 	eSS_Ready		 ///< System ready
 };
 
+/**
+ * @brief Points during startup at which a timestamp is recorded
+ * @see SystemClass::getBootTime()
+ */
+enum class BootPhase {
+	sdkPreInit, ///< SDK requests partition layout (Esp8266 with WiFi only)
+	userInit,	///< Framework startup code entered
+	appInit,	///< Application `init()` about to be called
+	ready,		///< System ready, `onReady()` handlers about to run
+};
+
 /** @brief  System class
  */
 class SystemClass
@@ -181,32 +210,87 @@ public:
 		}
 	}
 
+	/**
+	 * @brief Queueing latency statistics for one task priority
+	 * @note Requires ENABLE_TASK_LATENCY=1
+	 */
+	struct TaskLatency {
+		uint32_t count;  ///< Number of callbacks executed
+		uint64_t total;  ///< Total time callbacks spent queued, in microseconds
+		uint32_t max;	///< Longest time a callback spent queued, in microseconds
+		uint32_t missed; ///< Number of callbacks which spent longer than the deadline queued
+
+		/**
+		 * @brief Get average queueing time, in microseconds
+		 */
+		uint32_t average() const
+		{
+			return count ? total / count : 0;
+		}
+	};
+
+	/**
+	 * @brief Task queue statistics
+	 * @note Requires ENABLE_TASK_STATS=1
+	 */
+	struct TaskStats {
+		static constexpr unsigned priorityCount{unsigned(TaskPriority::High) + 1};
+		static constexpr unsigned histogramSize{8};
+		static constexpr unsigned slowestCount{TASK_STATS_SLOWEST};
+
+		struct Callback {
+			uint32_t address; ///< Function address
+			uint32_t time;	///< Longest execution time, in microseconds
+		};
+
+		uint32_t histogram[histogramSize];  ///< Number of callbacks executed in each time range
+		uint32_t dropped[priorityCount];	///< Callbacks which could not be queued as queue was full
+		Callback slowest[slowestCount];		///< Slowest callbacks seen, longest first
+
+		/**
+		 * @brief Get upper limit of execution time for a histogram bucket
+		 * @param bucket
+		 * @retval uint32_t Time in microseconds, ranging from 16us to 65ms in powers of 4
+		 */
+		static constexpr uint32_t getBucketLimit(unsigned bucket)
+		{
+			return (bucket + 1 < histogramSize) ? 16U << (2 * bucket) : UINT32_MAX;
+		}
+	};
+
 	/**
 	 * @brief Queue a deferred callback.
 	 * @param callback The function to be called
 	 * @param param Parameter passed to the callback (optional)
+	 * @param prio Queue to use
 	 * @retval bool false if callback could not be queued
 	 * @note It is important to check the return value to avoid memory leaks and other issues,
 	 * for example if memory is allocated and relies on the callback to free it again.
 	 * Note also that this method is typically called from interrupt context so must avoid things
 	 * like heap allocation, etc.
+	 *
+	 * On Esp32 this may also be called from other FreeRTOS tasks, on either core.
+	 * The callback always runs in the Sming task.
 	 */
-	static bool IRAM_ATTR queueCallback(TaskCallback32 callback, uint32_t param = 0);
+	static bool IRAM_ATTR queueCallback(TaskCallback32 callback, uint32_t param = 0,
+										TaskPriority prio = TaskPriority::Normal);
 
 	/**
 	 * @brief Queue a deferred callback, with optional void* parameter
 	 */
-	__forceinline static bool IRAM_ATTR queueCallback(TaskCallback callback, void* param = nullptr)
+	__forceinline static bool IRAM_ATTR queueCallback(TaskCallback callback, void* param = nullptr,
+													  TaskPriority prio = TaskPriority::Normal)
 	{
-		return queueCallback(reinterpret_cast<TaskCallback32>(callback), reinterpret_cast<uint32_t>(param));
+		return queueCallback(reinterpret_cast<TaskCallback32>(callback), reinterpret_cast<uint32_t>(param), prio);
 	}
 
 	/**
 	 * @brief Queue a deferred callback with no callback parameter
 	 */
-	__forceinline static bool IRAM_ATTR queueCallback(InterruptCallback callback)
+	__forceinline static bool IRAM_ATTR queueCallback(InterruptCallback callback,
+													  TaskPriority prio = TaskPriority::Normal)
 	{
-		return queueCallback(reinterpret_cast<TaskCallback>(callback));
+		return queueCallback(reinterpret_cast<TaskCallback>(callback), nullptr, prio);
 	}
 
 	/**
@@ -217,7 +301,7 @@ public:
 	 * but requires heap allocation and not as fast as a function callback.
 	 * DO NOT use from interrupt context, use a Task/Interrupt callback.
 	 */
-	static bool queueCallback(TaskDelegate callback);
+	static bool queueCallback(TaskDelegate callback, TaskPriority prio = TaskPriority::Normal);
 
 	/** @brief Get number of tasks currently on queue
 	 *  @retval unsigned
@@ -245,12 +329,71 @@ public:
 #endif
 	}
 
+	/**
+	 * @brief Get queueing latency statistics
+	 * @param prio Queue to report on
+	 * @retval TaskLatency All zero unless ENABLE_TASK_LATENCY=1
+	 */
+	static TaskLatency getTaskLatency(TaskPriority prio);
+
+	/**
+	 * @brief Reset queueing latency statistics for all priorities
+	 */
+	static void resetTaskLatency();
+
+	/**
+	 * @brief Set maximum acceptable queueing time for a priority
+	 * @param prio
+	 * @param deadline Time in microseconds, 0 to disable
+	 * @note Callbacks which spend longer than this on the queue are counted in `TaskLatency::missed`
+	 */
+	static void setTaskDeadline(TaskPriority prio, uint32_t deadline);
+
+	/**
+	 * @brief Get task queue statistics
+	 * @param stats On success, contains a snapshot of the statistics
+	 * @retval bool false if ENABLE_TASK_STATS is not set
+	 * @note Callbacks queued as a TaskDelegate share the address of a single internal handler
+	 */
+	static bool getTaskStats(TaskStats& stats);
+
+	/**
+	 * @brief Reset task queue statistics
+	 */
+	static void resetTaskStats();
+
+	/**
+	 * @brief Record the time at which a startup phase was reached
+	 * @param phase Only the first call for each phase is kept
+	 * @note Called by framework startup code
+	 */
+	static void setBootPhase(BootPhase phase);
+
+	/**
+	 * @brief Get the time at which a startup phase was reached, for profiling
+	 * @param phase
+	 * @retval uint32_t Microseconds since reset, 0 if not recorded
+	 */
+	static uint32_t getBootTime(BootPhase phase)
+	{
+		return bootTimes[unsigned(phase)];
+	}
+
+	/**
+	 * @brief Get total time the CPU has spent sleeping whilst idle
+	 * @retval uint32_t Time in microseconds, wraps
+	 * @note Always 0 unless ENABLE_TICKLESS_IDLE is set (supported only on Rp2040)
+	 */
+	static uint32_t getIdleTime();
+
 private:
-	static void taskHandler(os_event_t* event);
+	template <TaskPriority prio> static void taskHandler(os_event_t* event);
 
 private:
+	static constexpr unsigned bootPhaseCount{unsigned(BootPhase::ready) + 1};
+
 	static SystemState state;
-	static os_event_t taskQueue[]; ///< OS task queue
+	static uint32_t bootTimes[bootPhaseCount];
 #ifdef ENABLE_TASK_COUNT
 	static volatile uint8_t taskCount;	///< Number of tasks on queue
 	static volatile uint8_t maxTaskCount; ///< Profiling to establish appropriate queue size
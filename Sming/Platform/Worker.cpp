@@ -0,0 +1,80 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * Worker.cpp
+ *
+ * Jobs are held in a ring buffer indexed by three free-running counters, each written
+ * by only one side, so no locking is required between the application and worker.
+ *
+ ****/
+
+#include "Worker.h"
+#include "System.h"
+#include <debug_progmem.h>
+
+WorkerClass Worker;
+
+WorkerClass::Job WorkerClass::jobs[WORKER_QUEUE_LENGTH];
+std::atomic<unsigned> WorkerClass::submitCount;
+std::atomic<unsigned> WorkerClass::finishCount;
+std::atomic<unsigned> WorkerClass::completeCount;
+bool WorkerClass::started;
+
+bool WorkerClass::submit(Function work, Callback done, void* param)
+{
+	if(work == nullptr) {
+		return false;
+	}
+
+	if(!started) {
+		if(!startWorker()) {
+			debug_e("[WORKER] Failed to start");
+			return false;
+		}
+		started = true;
+	}
+
+	auto index = submitCount.load();
+	if(index - completeCount.load() >= WORKER_QUEUE_LENGTH) {
+		// Completions may be waiting on a full task queue
+		serviceCompletions();
+		if(index - completeCount.load() >= WORKER_QUEUE_LENGTH) {
+			return false;
+		}
+	}
+
+	jobs[index % WORKER_QUEUE_LENGTH] = Job{work, done, param};
+	submitCount.store(index + 1);
+	kickWorker();
+	return true;
+}
+
+bool WorkerClass::runNext()
+{
+	auto index = finishCount.load();
+	if(index == submitCount.load()) {
+		return false;
+	}
+
+	auto& job = jobs[index % WORKER_QUEUE_LENGTH];
+	job.work(job.param);
+	finishCount.store(index + 1);
+	notifyComplete();
+	return true;
+}
+
+void WorkerClass::serviceCompletions()
+{
+	unsigned index;
+	while((index = completeCount.load()) != finishCount.load()) {
+		// Copy job as slot may be re-used by callback
+		auto job = jobs[index % WORKER_QUEUE_LENGTH];
+		completeCount.store(index + 1);
+		if(job.done != nullptr) {
+			job.done(job.param);
+		}
+	}
+}
@@ -0,0 +1,114 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * Worker.h
+ *
+ ****/
+
+/**	@defgroup worker Worker
+ *	@brief	Offload computation to a second CPU core
+ *  @ingroup system
+*/
+#pragma once
+
+#include <cstdint>
+#include <atomic>
+
+/**
+ * @brief Maximum number of jobs which may be submitted but not yet completed
+ */
+#ifndef WORKER_QUEUE_LENGTH
+#define WORKER_QUEUE_LENGTH 8
+#endif
+
+/** @brief  Dispatches work to a second CPU core
+ *  @addtogroup worker
+ *  @{
+ *
+ * Jobs are executed in order of submission, one at a time, and completion
+ * callbacks are invoked in the same order via the task queue.
+ *
+ * On Rp2040 jobs run on core 1. On dual-core Esp32 variants they run in a FreeRTOS task pinned
+ * to the core not used by Sming; single-core variants use a lower-priority task on the same core.
+ * Other architectures execute jobs via the task queue at low priority.
+ *
+ * @note Work functions must only perform computation on the data they are given:
+ * they must not call Sming APIs, allocate from the heap or access peripherals.
+ * On Rp2040 they must not execute from flash whilst flash is being written, so are
+ * briefly paused during erase/program operations.
+ */
+class WorkerClass
+{
+public:
+	/**
+	 * @brief Function executed by the worker
+	 */
+	using Function = void (*)(void* param);
+
+	/**
+	 * @brief Called in task context when the work has completed
+	 */
+	using Callback = void (*)(void* param);
+
+	/**
+	 * @brief Queue a job for execution
+	 * @param work Function to run on the worker
+	 * @param done Called via the task queue when `work` has returned (optional)
+	 * @param param Passed to both functions
+	 * @retval bool false if the queue is full or the worker could not be started
+	 * @note Call from task context only
+	 */
+	bool submit(Function work, Callback done, void* param);
+
+	/**
+	 * @brief Get number of jobs submitted whose completion callback has not yet been called
+	 */
+	unsigned getPendingCount() const
+	{
+		return submitCount - completeCount;
+	}
+
+	/**
+	 * @brief Determine whether jobs execute in parallel with application code
+	 */
+	static bool isParallel();
+
+private:
+	struct Job {
+		Function work;
+		Callback done;
+		void* param;
+	};
+
+	// Implemented for each architecture
+	static bool startWorker();
+	static void kickWorker();
+	static void notifyComplete();
+
+	// Called by worker to execute the next job, returns false if there are none
+	static bool runNext();
+
+	// Called in task context
+	static void serviceCompletions();
+
+	static Job jobs[WORKER_QUEUE_LENGTH];
+	static std::atomic<unsigned> submitCount;	///< Written by submit()
+	static std::atomic<unsigned> finishCount;	///< Written by worker
+	static std::atomic<unsigned> completeCount; ///< Written by serviceCompletions()
+	static bool started;
+};
+
+/**	@brief	Global instance of worker object
+ *	@code
+ *	Worker.submit(
+ *		[](void* param) { computeFft(*static_cast<Samples*>(param)); },
+ *		[](void* param) { showResults(*static_cast<Samples*>(param)); },
+ *		&samples);
+ *	@endcode
+ */
+extern WorkerClass Worker;
+
+/** @} */
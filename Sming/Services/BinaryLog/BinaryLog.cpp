@@ -0,0 +1,204 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * BinaryLog.cpp
+ *
+ ****/
+
+#include "BinaryLog.h"
+#include <Platform/System.h>
+#include <SimpleTimer.h>
+#include <Clock.h>
+#include <m_printf.h>
+#include <algorithm>
+#include <cstring>
+
+namespace BinaryLog
+{
+namespace
+{
+// Retry interval when output doesn't accept all data
+constexpr unsigned retryIntervalMs{10};
+
+uint8_t buffer[BINARY_LOG_BUFSIZE];
+size_t head;  ///< Read position
+size_t count; ///< Bytes waiting to be sent
+uint32_t dropped;
+uint32_t droppedTotal;
+bool drainQueued;
+Output output;
+SimpleTimer retryTimer;
+
+// Call with interrupts disabled
+void store(const void* data, size_t length)
+{
+	auto tail = (head + count) % BINARY_LOG_BUFSIZE;
+	auto n = std::min(length, BINARY_LOG_BUFSIZE - tail);
+	memcpy(&buffer[tail], data, n);
+	memcpy(buffer, static_cast<const uint8_t*>(data) + n, length - n);
+	count += length;
+}
+
+size_t getPending()
+{
+	auto level = noInterrupts();
+	auto n = count;
+	restoreInterrupts(level);
+	return n;
+}
+
+/*
+ * Send one contiguous block of pending data
+ * @retval bool false if output did not accept all of it
+ */
+bool sendBlock()
+{
+	auto level = noInterrupts();
+	auto pos = head;
+	auto n = std::min(count, BINARY_LOG_BUFSIZE - pos);
+	restoreInterrupts(level);
+	if(n == 0) {
+		return true;
+	}
+
+	// Writers only use free space so this block is safe to read with interrupts enabled
+	auto out = output ?: m_nputs;
+	auto written = out(reinterpret_cast<const char*>(&buffer[pos]), n);
+
+	level = noInterrupts();
+	head = (pos + written) % BINARY_LOG_BUFSIZE;
+	count -= written;
+	restoreInterrupts(level);
+
+	return written == n;
+}
+
+void drain()
+{
+	for(;;) {
+		auto level = noInterrupts();
+		bool done = (count == 0);
+		if(done) {
+			drainQueued = false;
+		}
+		restoreInterrupts(level);
+		if(done) {
+			return;
+		}
+
+		if(!sendBlock()) {
+			// Output is busy
+			retryTimer.initializeMs<retryIntervalMs>(drain).startOnce();
+			return;
+		}
+	}
+}
+
+void queueDrain(void*)
+{
+	drain();
+}
+
+} // namespace
+
+void setOutput(Output out)
+{
+	output = out;
+}
+
+void flush()
+{
+	// Give up if output makes no progress for about 100ms
+	unsigned attempts{0};
+	while(getPending() != 0 && attempts < 1000) {
+		if(!sendBlock()) {
+			++attempts;
+			delayMicroseconds(100);
+		}
+	}
+}
+
+uint32_t getDroppedCount()
+{
+	return droppedTotal;
+}
+
+Record::Record(const char* format)
+{
+	buffer[0] = BINARY_LOG_MAGIC;
+	length = 2;
+	uint32_t timestamp = system_get_time();
+	put(&timestamp, sizeof(timestamp));
+	uint32_t addr = uintptr_t(format);
+	put(&addr, sizeof(addr));
+}
+
+void Record::put(const void* data, size_t len)
+{
+	len = std::min(len, sizeof(buffer) - length);
+	memcpy(&buffer[length], data, len);
+	length += len;
+}
+
+void Record::add(const char* str)
+{
+	if(str == nullptr) {
+		str = "(null)";
+	}
+	bool isFlash = isFlashPtr(str);
+	size_t len = isFlash ? strlen_P(str) : strlen(str);
+	uint8_t n = std::min(len, maxStringLength);
+	put(&n, sizeof(n));
+	if(isFlash) {
+		n = std::min(size_t(n), sizeof(buffer) - length);
+		memcpy_P(&buffer[length], str, n);
+		length += n;
+	} else {
+		put(str, n);
+	}
+}
+
+void Record::commit()
+{
+	buffer[1] = length - 2;
+
+	auto level = noInterrupts();
+
+	if(dropped != 0) {
+		// Report lost records ahead of the next one which fits
+		struct __attribute__((packed)) {
+			uint8_t magic;
+			uint8_t length;
+			uint32_t timestamp;
+			uint32_t format;
+			uint32_t count;
+		} rec{BINARY_LOG_MAGIC, 12, system_get_time(), 0, dropped};
+		if(count + sizeof(rec) + length <= BINARY_LOG_BUFSIZE) {
+			store(&rec, sizeof(rec));
+			dropped = 0;
+		}
+	}
+
+	bool queue{false};
+	if(dropped != 0 || count + length > BINARY_LOG_BUFSIZE) {
+		++dropped;
+		++droppedTotal;
+	} else {
+		store(buffer, length);
+		queue = !drainQueued;
+		drainQueued = true;
+	}
+
+	restoreInterrupts(level);
+
+	if(queue && !System.queueCallback(queueDrain)) {
+		level = noInterrupts();
+		drainQueued = false;
+		restoreInterrupts(level);
+	}
+}
+
+} // namespace BinaryLog
@@ -0,0 +1,136 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * BinaryLog.h - Deferred logging of raw arguments for decoding on the host
+ *
+ * Enabled with DEBUG_BINARY_LOG=1, when the `debug_*` macros in C++ code write records here
+ * instead of formatting text. Use `make binlog-decode` to convert captured output.
+ *
+ * Each record contains:
+ *
+ * 	magic		uint8_t		BINARY_LOG_MAGIC
+ * 	length		uint8_t		Number of bytes which follow
+ * 	timestamp	uint32_t	system_get_time()
+ * 	format		uint32_t	Address of format string in flash, 0 for a dropped record count
+ * 	arguments...
+ *
+ * Integers up to 32 bits, pointers and characters are written as 4 bytes.
+ * 64-bit integers are written as 8 bytes, and floating-point values as an 8-byte double.
+ * Strings are written as a length byte followed by content, up to 64 characters.
+ * All values are little-endian.
+ *
+ ****/
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+
+#define BINARY_LOG_MAGIC 0xb1
+
+#ifndef BINARY_LOG_BUFSIZE
+#define BINARY_LOG_BUFSIZE 2048
+#endif
+
+namespace BinaryLog
+{
+/**
+ * @brief Function used to send completed records
+ * @note A plain function pointer, as this header is included by every user of the debug macros
+ * @retval size_t Number of bytes accepted, may be less than requested if the output is busy
+ */
+using Output = size_t (*)(const char* data, size_t length);
+
+/**
+ * @brief Set destination for log records
+ * @param output Called from the task queue, nullptr to use the default `m_nputs()`
+ *
+ * Use this to redirect output to UDP or flash storage.
+ */
+void setOutput(Output output);
+
+/**
+ * @brief Send all pending records immediately, such as before a restart
+ */
+void flush();
+
+/**
+ * @brief Get number of records discarded because the buffer was full
+ */
+uint32_t getDroppedCount();
+
+/**
+ * @brief Builds one record on the stack then commits it to the log buffer
+ */
+class Record
+{
+public:
+	static constexpr size_t maxStringLength{64};
+
+	explicit Record(const char* format);
+
+	template <typename T> typename std::enable_if<std::is_integral<T>::value && (sizeof(T) <= 4)>::type add(T value)
+	{
+		uint32_t v = std::is_signed<T>::value ? uint32_t(int32_t(value)) : uint32_t(value);
+		put(&v, sizeof(v));
+	}
+
+	template <typename T> typename std::enable_if<std::is_integral<T>::value && (sizeof(T) > 4)>::type add(T value)
+	{
+		uint64_t v = value;
+		put(&v, sizeof(v));
+	}
+
+	template <typename T> typename std::enable_if<std::is_enum<T>::value>::type add(T value)
+	{
+		add(typename std::underlying_type<T>::type(value));
+	}
+
+	template <typename T> typename std::enable_if<std::is_floating_point<T>::value>::type add(T value)
+	{
+		double v = value;
+		put(&v, sizeof(v));
+	}
+
+	void add(const char* str);
+
+	void add(char* str)
+	{
+		add(static_cast<const char*>(str));
+	}
+
+	template <typename T> void add(const T* ptr)
+	{
+		uint32_t v = uintptr_t(ptr);
+		put(&v, sizeof(v));
+	}
+
+	/**
+	 * @brief Copy record into the log buffer
+	 */
+	void commit();
+
+private:
+	void put(const void* data, size_t length);
+
+	uint8_t buffer[2 + 255];
+	uint16_t length;
+};
+
+/**
+ * @brief Write a log record
+ * @param format Format string in flash, which is not read on the device
+ * @param args Arguments as for `m_printf()`
+ */
+template <typename... Args> void log(const char* format, const Args&... args)
+{
+	Record record(format);
+	(record.add(args), ...);
+	record.commit();
+}
+
+} // namespace BinaryLog
@@ -0,0 +1,163 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * HexCapture.cpp
+ *
+ ****/
+
+#include "HexCapture.h"
+#include <stringutil.h>
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+constexpr unsigned maxBytesPerLine{32};
+
+#define is_print(c) ((c) >= ' ' && (c) <= '~')
+
+size_t printLine(Print& p, unsigned offset, const uint8_t* data, unsigned length, unsigned bytesPerLine)
+{
+	// indent + offset + ": " + hex + ' ' + ASCII + "\r\n"
+	char line[4 + 4 + 2 + (maxBytesPerLine * 3) + 1 + maxBytesPerLine + 2];
+	auto ptr = line;
+	memset(ptr, ' ', 4);
+	ptr += 4;
+	for(int shift = 12; shift >= 0; shift -= 4) {
+		*ptr++ = hexchar((offset >> shift) & 0x0f);
+	}
+	*ptr++ = ':';
+	*ptr++ = ' ';
+	for(unsigned i = 0; i < length; ++i) {
+		*ptr++ = hexchar(data[i] >> 4);
+		*ptr++ = hexchar(data[i] & 0x0f);
+		*ptr++ = ' ';
+	}
+	auto spaceCount = 1 + 3 * (bytesPerLine - length);
+	memset(ptr, ' ', spaceCount);
+	ptr += spaceCount;
+	for(unsigned i = 0; i < length; ++i) {
+		char c = data[i];
+		*ptr++ = is_print(c) ? c : '.';
+	}
+	*ptr++ = '\r';
+	*ptr++ = '\n';
+	return p.write(line, ptr - line);
+}
+
+} // namespace
+
+void IRAM_ATTR HexCapture::begin(const char* tag, size_t size)
+{
+	auto length = std::min({size, capacity - sizeof(Record), size_t(0xffff)});
+	if(snapLength != 0) {
+		length = std::min(length, snapLength);
+	}
+	auto recordSize = sizeof(Record) + length;
+	while(capacity - used < recordSize) {
+		discardOldest();
+	}
+
+	Record rec{system_get_time(), tag, uint32_t(size), uint16_t(length)};
+	write(&rec, sizeof(rec));
+	pending = length;
+	++count;
+	++total;
+}
+
+void IRAM_ATTR HexCapture::put(const void* data, size_t length)
+{
+	length = std::min(length, pending);
+	write(data, length);
+	pending -= length;
+}
+
+void IRAM_ATTR HexCapture::write(const void* data, size_t length)
+{
+	auto tail = (head + used) % capacity;
+	auto n = std::min(length, capacity - tail);
+	memcpy(&buffer[tail], data, n);
+	memcpy(buffer, static_cast<const uint8_t*>(data) + n, length - n);
+	used += length;
+}
+
+void IRAM_ATTR HexCapture::discardOldest()
+{
+	Record rec;
+	read(head, &rec, sizeof(rec));
+	auto recordSize = sizeof(rec) + rec.length;
+	head = (head + recordSize) % capacity;
+	used -= recordSize;
+	--count;
+}
+
+void IRAM_ATTR HexCapture::read(size_t pos, void* data, size_t length) const
+{
+	auto n = std::min(length, capacity - pos);
+	memcpy(data, &buffer[pos], n);
+	memcpy(static_cast<uint8_t*>(data) + n, buffer, length - n);
+}
+
+void HexCapture::clear()
+{
+	auto level = noInterrupts();
+	head = 0;
+	used = 0;
+	count = 0;
+	total = 0;
+	restoreInterrupts(level);
+}
+
+size_t HexCapture::dump(Print& p, unsigned bytesPerLine)
+{
+	bytesPerLine = std::max(1U, std::min(bytesPerLine, maxBytesPerLine));
+
+	auto wasEnabled = enabled;
+	enabled = false;
+
+	size_t n{0};
+	auto dropped = getDropped();
+	if(dropped != 0) {
+		n += p.print('(');
+		n += p.print(dropped);
+		n += p.println(_F(" records dropped)"));
+	}
+
+	auto pos = head;
+	uint32_t prevTime{0};
+	for(unsigned i = 0; i < count; ++i) {
+		Record rec;
+		read(pos, &rec, sizeof(rec));
+		pos = (pos + sizeof(rec)) % capacity;
+
+		n += p.print(rec.timestamp);
+		n += p.print(_F(" +"));
+		n += p.print((i == 0) ? 0 : rec.timestamp - prevTime);
+		n += p.print(' ');
+		if(rec.tag != nullptr) {
+			n += p.print(String(FPSTR(rec.tag)));
+			n += p.print(_F(": "));
+		}
+		if(rec.length != rec.size) {
+			n += p.print(rec.length);
+			n += p.print(_F(" of "));
+		}
+		n += p.print(rec.size);
+		n += p.println(_F(" bytes"));
+		prevTime = rec.timestamp;
+
+		for(unsigned offset = 0; offset < rec.length; offset += bytesPerLine) {
+			uint8_t data[maxBytesPerLine];
+			auto len = std::min(unsigned(rec.length) - offset, bytesPerLine);
+			read(pos, data, len);
+			pos = (pos + len) % capacity;
+			n += printLine(p, offset, data, len, bytesPerLine);
+		}
+	}
+
+	enabled = wasEnabled;
+	return n;
+}
@@ -0,0 +1,205 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * HexCapture.h
+ *
+ * Capture raw data blocks into a RAM ring buffer for hex dumping later.
+ *
+ ****/
+
+#pragma once
+
+#include <Print.h>
+#include <Platform/System.h>
+
+/**
+ * @brief Capture a block of data
+ * @param hexCapture The HexCapture to record into
+ * @param tag Record tag, a string literal which is stored in flash
+ * @param data
+ * @param length
+ */
+#define HEX_CAPTURE(hexCapture, tag, data, length) (hexCapture).capture(PSTR(tag), data, length)
+
+/**
+ * @brief Records timestamped copies of data blocks into a RAM ring buffer
+ *
+ * Capturing costs a header plus a `memcpy()` with interrupts briefly disabled, so it may be
+ * called from interrupt context and has little effect on timing.
+ * Formatting only happens when `dump()` is called.
+ * When full, the oldest records are discarded to make room.
+ *
+ * Use `setSnapLength()` to limit how much of each block is kept, so that more records fit.
+ *
+ * @code
+ * HexCaptureBuffer<2048> capture;
+ *
+ * err_t MyConnection::onReceive(pbuf* buf)
+ * {
+ * 	capture.captureChain(PSTR("rx"), buf);
+ * 	...
+ * }
+ *
+ * void onSpiComplete(const uint8_t* data, size_t length)
+ * {
+ * 	HEX_CAPTURE(capture, "spi", data, length);
+ * }
+ *
+ * // Later, from task context
+ * capture.dump(Serial);
+ * @endcode
+ *
+ * @note Data must be in RAM. On dual-core systems, capture from one core only.
+ */
+class HexCapture
+{
+public:
+	/**
+	 * @brief Header stored in front of captured data
+	 */
+	struct Record {
+		uint32_t timestamp; ///< system_get_time() at capture
+		const char* tag;	///< Tag string in flash, may be nullptr
+		uint32_t size;		///< Original size of data block
+		uint16_t length;	///< Number of bytes captured, may be less than `size`
+	};
+
+	/**
+	 * @brief Capture a block of data
+	 * @param tag Tag string in flash, may be nullptr
+	 * @param data
+	 * @param length
+	 * @retval bool false if recording is disabled
+	 */
+	bool capture(const char* tag, const void* data, size_t length)
+	{
+		if(!enabled) {
+			return false;
+		}
+		auto level = noInterrupts();
+		begin(tag, length);
+		put(data, length);
+		restoreInterrupts(level);
+		return true;
+	}
+
+	/**
+	 * @brief Capture data from a chain of segments as one record
+	 * @tparam Segment Has `payload`, `len`, `tot_len` and `next` members, such as `pbuf`
+	 * @param tag Tag string in flash, may be nullptr
+	 * @param seg First segment in chain
+	 * @retval bool false if recording is disabled
+	 */
+	template <typename Segment> bool captureChain(const char* tag, const Segment* seg)
+	{
+		if(!enabled || seg == nullptr) {
+			return false;
+		}
+		auto level = noInterrupts();
+		begin(tag, seg->tot_len);
+		for(; seg != nullptr && pending != 0; seg = seg->next) {
+			put(seg->payload, seg->len);
+		}
+		restoreInterrupts(level);
+		return true;
+	}
+
+	/**
+	 * @brief Set maximum number of bytes to keep from each block
+	 * @param length 0 to keep as much as will fit in the buffer
+	 */
+	void setSnapLength(size_t length)
+	{
+		snapLength = length;
+	}
+
+	/**
+	 * @brief Suspend or resume recording
+	 */
+	void enable(bool state)
+	{
+		enabled = state;
+	}
+
+	bool isEnabled() const
+	{
+		return enabled;
+	}
+
+	/**
+	 * @brief Discard all records
+	 */
+	void clear();
+
+	/**
+	 * @brief Get number of records currently held
+	 */
+	size_t getCount() const
+	{
+		return count;
+	}
+
+	/**
+	 * @brief Get number of records which have been discarded to make room
+	 */
+	uint32_t getDropped() const
+	{
+		return total - count;
+	}
+
+	/**
+	 * @brief Write all records in hex and ASCII, oldest first
+	 * @param p Destination
+	 * @param bytesPerLine Number of data bytes on each output line, up to 32
+	 * @retval size_t Number of characters written
+	 *
+	 * Each record is introduced by a line giving its timestamp in microseconds,
+	 * time since the previous record, tag and size.
+	 * Recording is suspended during output so the records do not change.
+	 */
+	size_t dump(Print& p, unsigned bytesPerLine = 16);
+
+protected:
+	HexCapture(uint8_t* buffer, size_t capacity) : buffer(buffer), capacity(capacity)
+	{
+	}
+
+private:
+	// Call with interrupts disabled
+	void begin(const char* tag, size_t size);
+	void put(const void* data, size_t length);
+	void write(const void* data, size_t length);
+	void discardOldest();
+
+	void read(size_t pos, void* data, size_t length) const;
+
+	uint8_t* buffer;
+	size_t capacity;
+	size_t head{0};	   ///< Position of oldest record
+	size_t used{0};	   ///< Bytes occupied by records
+	size_t pending{0}; ///< Bytes still to be written for current record
+	size_t snapLength{0};
+	size_t count{0};
+	uint32_t total{0};
+	bool enabled{true};
+};
+
+/**
+ * @brief Hex capture with statically allocated buffer
+ * @tparam size Size of buffer in bytes, including record headers
+ */
+template <size_t size> class HexCaptureBuffer : public HexCapture
+{
+public:
+	static_assert(size > sizeof(Record), "HexCaptureBuffer too small");
+
+	HexCaptureBuffer() : HexCapture(buffer, size)
+	{
+	}
+
+private:
+	uint8_t buffer[size];
+};
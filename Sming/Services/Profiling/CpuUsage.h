@@ -5,6 +5,8 @@ namespace Profiling
 {
 /**
  * @brief Class to provide a CPU usage indication based on task callback availability.
+ * @note With ENABLE_TICKLESS_IDLE the figure is instead derived from time spent sleeping,
+ * which requires no calibration and does not keep the task queue busy.
  */
 class CpuUsage
 {
@@ -17,7 +19,12 @@ public:
 	void begin(InterruptCallback ready)
 	{
 		onReady = ready;
+#ifdef ENABLE_TICKLESS_IDLE
+		reset();
+		System.queueCallback(onReady);
+#else
 		queueCalibrationLoop();
+#endif
 	}
 
 	/**
@@ -27,6 +34,9 @@ public:
 	{
 		cycleTimer.start();
 		loopIterations = 0;
+#ifdef ENABLE_TICKLESS_IDLE
+		idleStartTime = System.getIdleTime();
+#endif
 	}
 
 	/**
@@ -59,6 +69,13 @@ public:
 	unsigned getUtilisation()
 	{
 		auto elapsedCycles = getElapsedCycles();
+#ifdef ENABLE_TICKLESS_IDLE
+		uint64_t idleCycles = uint64_t(System.getIdleTime() - idleStartTime) * System.getCpuFrequency();
+		if(elapsedCycles == 0 || idleCycles >= elapsedCycles) {
+			return 0;
+		}
+		return 10000ULL * (elapsedCycles - idleCycles) / elapsedCycles;
+#else
 		if(elapsedCycles <= minLoopCycles || minLoopCycles == 0) {
 			return 0;
 		}
@@ -69,6 +86,7 @@ public:
 		}
 
 		return 10000U * (maxIterations - loopIterations) / maxIterations;
+#endif
 	}
 
 private:
@@ -110,6 +128,9 @@ private:
 	CpuCycleTimer cycleTimer;
 	unsigned loopIterations = 0;
 	uint32_t minLoopCycles = 0; // Set during calibration
+#ifdef ENABLE_TICKLESS_IDLE
+	uint32_t idleStartTime = 0;
+#endif
 	InterruptCallback onReady = nullptr;
 };
 
@@ -0,0 +1,70 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * IramProfiler.h - Function call counts to guide IRAM placement
+ *
+ ****/
+
+#pragma once
+
+#include <Print.h>
+
+/**
+ * @brief Number of distinct flash-resident functions which can be counted
+ */
+#ifndef IRAM_PROFILE_SLOTS
+#define IRAM_PROFILE_SLOTS 512
+#endif
+
+namespace Profiling
+{
+/**
+ * @brief Counts calls to each function running from flash
+ *
+ * Build with ENABLE_IRAM_PROFILE=1 (Esp8266 only) so every function is instrumented.
+ * Exercise the application, then write the result using `dump()` and pass it to
+ * `Arch/Esp8266/Tools/iram-profile.py`, which generates a linker fragment
+ * placing the most frequently called functions into spare IRAM.
+ *
+ * There is no way to count cache misses directly, so the tool ranks functions by calls per byte of code.
+ *
+ * Dump format is text, one line per function: `<address hex> <call count>`, preceded by
+ * a header line `# iram-profile <slots used> <overflow count>`.
+ */
+class IramProfiler
+{
+public:
+	/**
+	 * @brief Determine if profiling is enabled for this build
+	 */
+	static constexpr bool isEnabled()
+	{
+#ifdef ENABLE_IRAM_PROFILE
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	/**
+	 * @brief Write collected counts
+	 * @param out For example, `Serial` or a FileStream
+	 * @retval size_t Number of functions written
+	 */
+	static size_t dump(Print& out);
+
+	/**
+	 * @brief Clear all counts, e.g. to exclude startup code
+	 */
+	static void reset();
+
+	/**
+	 * @brief Get number of calls missed because all slots were in use
+	 */
+	static uint32_t getOverflowCount();
+};
+
+} // namespace Profiling
@@ -0,0 +1,66 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * IrqLatency.h - Report longest interrupts-disabled period
+ *
+ ****/
+
+#pragma once
+
+#include <irq_latency.h>
+#include <Platform/Clocks.h>
+#include <Print.h>
+
+namespace Profiling
+{
+/**
+ * @brief Snapshot of interrupt latency statistics
+ *
+ * Requires ENABLE_IRQ_LATENCY=1. Periods are measured from the `noInterrupts()` call
+ * which masks interrupts to the `interrupts()` or `restoreInterrupts()` call which unmasks them;
+ * nested calls are not counted separately.
+ */
+class IrqLatency : public irq_latency_info_t
+{
+public:
+	using Clock = CpuCycleClockNormal;
+
+	IrqLatency()
+	{
+		update();
+	}
+
+	void update()
+	{
+		irq_latency_get_info(this);
+	}
+
+	static void reset()
+	{
+		irq_latency_reset();
+	}
+
+	/**
+	 * @brief Longest period interrupts were disabled
+	 */
+	NanoTime::Time<uint32_t> getMaxTime() const
+	{
+		return Clock::ticksToTime<NanoTime::Microseconds>(max_cycles);
+	}
+
+	size_t printTo(Print& p) const
+	{
+		size_t n = p.print(_F("IRQ disabled max "));
+		n += p.print(getMaxTime().toString());
+		n += p.print(_F(" at 0x"));
+		n += p.print(uintptr_t(max_caller), HEX);
+		n += p.print(_F(", count "));
+		n += p.print(count);
+		return n;
+	}
+};
+
+} // namespace Profiling
@@ -0,0 +1,106 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * Metrics.cpp
+ *
+ ****/
+
+#include "Metrics.h"
+
+#ifdef ENABLE_METRICS
+
+#include <Clock.h>
+
+namespace Profiling::Metrics
+{
+size_t Metric::printTo(Print& p) const
+{
+	size_t n = p.print(_F("# HELP "));
+	n += p.print(name);
+	n += p.print(' ');
+	n += p.print(help);
+	n += p.print('\n');
+	n += p.print(_F("# TYPE "));
+	n += p.print(name);
+	n += p.print(' ');
+	n += p.print(getTypeName());
+	n += p.print('\n');
+	n += printValue(p);
+	return n;
+}
+
+size_t Counter::printValue(Print& p) const
+{
+	size_t n = p.print(getName());
+	n += p.print(' ');
+	n += p.print(value);
+	n += p.print('\n');
+	return n;
+}
+
+size_t Gauge::printValue(Print& p) const
+{
+	size_t n = p.print(getName());
+	n += p.print(' ');
+	n += p.print(value);
+	n += p.print('\n');
+	return n;
+}
+
+size_t Histogram::printValue(Print& p) const
+{
+	size_t n = 0;
+	uint32_t cumulative = 0;
+	for(unsigned i = 0; i < bucketCount; ++i) {
+		cumulative += buckets[i];
+		n += p.print(getName());
+		n += p.print(_F("_bucket{le=\""));
+		n += p.print((i == 32) ? 0xffffffffU : (1U << i) - 1);
+		n += p.print(_F("\"} "));
+		n += p.print(cumulative);
+		n += p.print('\n');
+	}
+	n += p.print(getName());
+	n += p.print(_F("_bucket{le=\"+Inf\"} "));
+	n += p.print(count);
+	n += p.print('\n');
+	n += p.print(getName());
+	n += p.print(_F("_sum "));
+	n += p.print(sum);
+	n += p.print('\n');
+	n += p.print(getName());
+	n += p.print(_F("_count "));
+	n += p.print(count);
+	n += p.print('\n');
+	return n;
+}
+
+void Stopwatch::start()
+{
+	startTime = micros();
+	running = true;
+}
+
+void Stopwatch::stop(Histogram& histogram)
+{
+	if(running) {
+		histogram.observe(micros() - startTime);
+		running = false;
+	}
+}
+
+size_t printAll(Print& p)
+{
+	size_t n = 0;
+	for(auto& metric : Metric::getList()) {
+		n += metric.printTo(p);
+	}
+	return n;
+}
+
+} // namespace Profiling::Metrics
+
+#endif
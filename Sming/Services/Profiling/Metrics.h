@@ -0,0 +1,289 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * Metrics.h - Named counters, gauges and histograms for export to monitoring systems
+ *
+ * Build with ENABLE_METRICS=1 to enable. Otherwise all metric types are empty
+ * so instrumentation has no code or RAM cost.
+ *
+ ****/
+
+#pragma once
+
+#include <FlashString/String.hpp>
+#include <Data/LinkedObjectList.h>
+#include <Print.h>
+
+/**
+ * @brief Define a counter
+ * @param var Variable name
+ * @param name Metric name, following Prometheus conventions, e.g. "sming_tcp_received_bytes_total"
+ * @param help Description
+ */
+#define METRIC_COUNTER(var, name, help) METRIC_DEFINE_(Counter, var, name, help)
+
+/**
+ * @brief Define a gauge
+ */
+#define METRIC_GAUGE(var, name, help) METRIC_DEFINE_(Gauge, var, name, help)
+
+/**
+ * @brief Define a histogram
+ */
+#define METRIC_HISTOGRAM(var, name, help) METRIC_DEFINE_(Histogram, var, name, help)
+
+#ifdef ENABLE_METRICS
+#define METRIC_DEFINE_(type, var, name, help)                                                                          \
+	DEFINE_FSTR_LOCAL(var##_name, name)                                                                                \
+	DEFINE_FSTR_LOCAL(var##_help, help)                                                                                \
+	Profiling::Metrics::type var(var##_name, var##_help)
+#else
+#define METRIC_DEFINE_(type, var, name, help) Profiling::Metrics::type var
+#endif
+
+namespace Profiling::Metrics
+{
+#ifdef ENABLE_METRICS
+
+/**
+ * @brief Base class for a named metric
+ *
+ * Metrics register themselves on construction so should be defined statically.
+ * Values are updated without locking, so only update metrics from task context.
+ */
+class Metric : public LinkedObjectTemplate<Metric>
+{
+public:
+	using List = LinkedObjectListTemplate<Metric>;
+
+	Metric(const FlashString& name, const FlashString& help) : name(name), help(help)
+	{
+		getList().add(this);
+	}
+
+	~Metric()
+	{
+		getList().remove(this);
+	}
+
+	const FlashString& getName() const
+	{
+		return name;
+	}
+
+	/**
+	 * @brief Output metric in Prometheus text exposition format
+	 */
+	size_t printTo(Print& p) const;
+
+	/**
+	 * @brief Registered metrics
+	 */
+	static List& getList()
+	{
+		// Defined locally so metrics may register during static initialisation
+		static List list;
+		return list;
+	}
+
+protected:
+	virtual const char* getTypeName() const = 0;
+	virtual size_t printValue(Print& p) const = 0;
+
+	const FlashString& name;
+	const FlashString& help;
+};
+
+/**
+ * @brief Value which only increases, such as a number of events or bytes
+ */
+class Counter : public Metric
+{
+public:
+	using Metric::Metric;
+
+	void add(uint32_t count = 1)
+	{
+		value += count;
+	}
+
+	uint64_t getValue() const
+	{
+		return value;
+	}
+
+protected:
+	const char* getTypeName() const override
+	{
+		return "counter";
+	}
+
+	size_t printValue(Print& p) const override;
+
+private:
+	uint64_t value{0};
+};
+
+/**
+ * @brief Value which may go up and down, such as a number of connections
+ */
+class Gauge : public Metric
+{
+public:
+	using Metric::Metric;
+
+	void set(int32_t value)
+	{
+		this->value = value;
+	}
+
+	void add(int32_t delta)
+	{
+		value += delta;
+	}
+
+	int32_t getValue() const
+	{
+		return value;
+	}
+
+protected:
+	const char* getTypeName() const override
+	{
+		return "gauge";
+	}
+
+	size_t printValue(Print& p) const override;
+
+private:
+	int32_t value{0};
+};
+
+/**
+ * @brief Distribution of values using fixed power-of-two buckets
+ *
+ * Bucket N counts values with N significant bits, so has an upper bound of 2^N - 1.
+ * This covers the full range of a uint32_t in a fixed amount of RAM, with resolution
+ * proportional to magnitude. Times are conventionally recorded in microseconds.
+ */
+class Histogram : public Metric
+{
+public:
+	static constexpr unsigned bucketCount{33};
+
+	using Metric::Metric;
+
+	void observe(uint32_t value)
+	{
+		unsigned bucket = (value == 0) ? 0 : 32 - __builtin_clz(value);
+		++buckets[bucket];
+		sum += value;
+		++count;
+	}
+
+	uint32_t getBucket(unsigned index) const
+	{
+		return (index < bucketCount) ? buckets[index] : 0;
+	}
+
+	uint32_t getCount() const
+	{
+		return count;
+	}
+
+	uint64_t getSum() const
+	{
+		return sum;
+	}
+
+protected:
+	const char* getTypeName() const override
+	{
+		return "histogram";
+	}
+
+	size_t printValue(Print& p) const override;
+
+private:
+	uint32_t buckets[bucketCount]{};
+	uint64_t sum{0};
+	uint32_t count{0};
+};
+
+/**
+ * @brief Measure elapsed time for recording in a histogram
+ */
+class Stopwatch
+{
+public:
+	void start();
+
+	/**
+	 * @brief Record time elapsed since `start()` in microseconds
+	 * @note Does nothing if not started
+	 */
+	void stop(Histogram& histogram);
+
+private:
+	uint32_t startTime{0};
+	bool running{false};
+};
+
+/**
+ * @brief Output all registered metrics in Prometheus text exposition format
+ */
+size_t printAll(Print& p);
+
+#else
+
+class Counter
+{
+public:
+	void add(uint32_t = 1)
+	{
+	}
+};
+
+class Gauge
+{
+public:
+	void set(int32_t)
+	{
+	}
+
+	void add(int32_t)
+	{
+	}
+};
+
+class Histogram
+{
+public:
+	void observe(uint32_t)
+	{
+	}
+};
+
+class Stopwatch
+{
+public:
+	void start()
+	{
+	}
+
+	void stop(Histogram&)
+	{
+	}
+};
+
+inline size_t printAll(Print&)
+{
+	return 0;
+}
+
+#endif
+
+} // namespace Profiling::Metrics
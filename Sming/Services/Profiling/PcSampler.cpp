@@ -0,0 +1,50 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * PcSampler.cpp
+ *
+ * Unsupported architectures. See Arch/Esp8266/Services/Profiling/PcSampler.cpp.
+ *
+ ****/
+
+#ifndef ARCH_ESP8266
+
+#include "PcSampler.h"
+
+namespace Profiling
+{
+bool PcSampler::start(unsigned)
+{
+	return false;
+}
+
+void PcSampler::stop()
+{
+}
+
+bool PcSampler::isRunning()
+{
+	return false;
+}
+
+size_t PcSampler::dump(Print&)
+{
+	return 0;
+}
+
+uint32_t PcSampler::getSampleCount()
+{
+	return 0;
+}
+
+uint32_t PcSampler::getDroppedCount()
+{
+	return 0;
+}
+
+} // namespace Profiling
+
+#endif
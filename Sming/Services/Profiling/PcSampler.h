@@ -0,0 +1,71 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * PcSampler.h - Statistical profiler using program counter samples
+ *
+ ****/
+
+#pragma once
+
+#include <Print.h>
+
+/**
+ * @brief Number of samples held until read by `PcSampler::dump()`, must be a power of 2
+ */
+#ifndef PC_SAMPLER_BUFFER_SIZE
+#define PC_SAMPLER_BUFFER_SIZE 1024
+#endif
+
+namespace Profiling
+{
+/**
+ * @brief Samples the interrupted program counter from a non-maskable Timer1 interrupt
+ *
+ * Samples are queued in a ring buffer and written out by `dump()`, which should be called
+ * regularly so none are dropped. Pass the output to `Arch/Esp8266/Components/esp8266/Tools/pc-sampler.py`
+ * to find where time is spent. Execution from flash includes time stalled on cache misses,
+ * so hot spots there are candidates for IRAM placement.
+ *
+ * Only available on Esp8266: uses Timer1, so cannot be run together with a HardwareTimer.
+ *
+ * Dump format is text: a header line `# pc-sampler <interval us> <samples taken> <samples dropped>`
+ * followed by lines of hex addresses.
+ */
+class PcSampler
+{
+public:
+	/**
+	 * @brief Start sampling
+	 * @param intervalUs Time between samples, minimum is MIN_HW_TIMER1_INTERVAL_US
+	 * @retval bool false if not supported or interval is out of range
+	 */
+	static bool start(unsigned intervalUs = 1000);
+
+	/**
+	 * @brief Stop sampling and release Timer1
+	 */
+	static void stop();
+
+	static bool isRunning();
+
+	/**
+	 * @brief Write out and discard all queued samples
+	 * @retval size_t Number of samples written
+	 */
+	static size_t dump(Print& out);
+
+	/**
+	 * @brief Get total number of samples taken since `start()`
+	 */
+	static uint32_t getSampleCount();
+
+	/**
+	 * @brief Get number of samples lost because the buffer was full
+	 */
+	static uint32_t getDroppedCount();
+};
+
+} // namespace Profiling
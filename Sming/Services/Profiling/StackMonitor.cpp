@@ -0,0 +1,87 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * StackMonitor.cpp
+ *
+ ****/
+
+#include "StackMonitor.h"
+
+namespace
+{
+// Space left untouched below the current frame when painting
+constexpr size_t paintMargin{256};
+
+} // namespace
+
+namespace Profiling
+{
+bool StackMonitor::painted;
+
+bool StackMonitor::paint()
+{
+	uintptr_t bottom;
+	uintptr_t top;
+	if(!getBounds(bottom, top)) {
+		return false;
+	}
+
+	auto sp = uintptr_t(__builtin_frame_address(0));
+	if(sp < bottom + paintMargin || sp > top) {
+		return false;
+	}
+
+	auto end = reinterpret_cast<volatile uint32_t*>((sp - paintMargin) & ~3U);
+	for(auto p = reinterpret_cast<volatile uint32_t*>(bottom); p < end; ++p) {
+		*p = paintValue;
+	}
+
+	painted = true;
+	return true;
+}
+
+size_t StackMonitor::getSize()
+{
+	uintptr_t bottom;
+	uintptr_t top;
+	return getBounds(bottom, top) ? (top - bottom) : 0;
+}
+
+size_t StackMonitor::getMaxUsed()
+{
+	uintptr_t bottom;
+	uintptr_t top;
+	if(!painted || !getBounds(bottom, top)) {
+		return 0;
+	}
+
+	auto p = reinterpret_cast<const volatile uint32_t*>(bottom);
+	auto end = reinterpret_cast<const volatile uint32_t*>(top);
+	while(p < end && *p == paintValue) {
+		++p;
+	}
+	return top - uintptr_t(p);
+}
+
+void StackMonitor::start(unsigned intervalMs, Callback callback)
+{
+	this->callback = callback;
+	timer.initializeMs(intervalMs, [this]() { check(); }).start();
+}
+
+void StackMonitor::check()
+{
+	auto used = getMaxUsed();
+	if(used <= lastUsed) {
+		return;
+	}
+	lastUsed = used;
+	if(callback) {
+		callback(used, getSize());
+	}
+}
+
+} // namespace Profiling
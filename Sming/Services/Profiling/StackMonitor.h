@@ -0,0 +1,98 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * StackMonitor.h - Stack high-water mark measurement
+ *
+ ****/
+
+#pragma once
+
+#include <Timer.h>
+
+namespace Profiling
+{
+/**
+ * @brief Measures maximum stack usage of the main Sming task
+ *
+ * Call `paint()` early in `init()` to fill unused stack with a known pattern.
+ * The high-water mark is then found by scanning upwards from the bottom of the
+ * stack for the first overwritten word.
+ *
+ * Use `start()` to check periodically, with a callback when usage increases.
+ */
+class StackMonitor
+{
+public:
+	static constexpr uint32_t paintValue{0xa5a5a5a5};
+
+	/**
+	 * @brief Called when stack usage has increased
+	 * @param used Maximum number of bytes used
+	 * @param size Total stack size
+	 */
+	using Callback = Delegate<void(size_t used, size_t size)>;
+
+	/**
+	 * @brief Fill the unused part of the stack with `paintValue`
+	 * @retval bool false if not supported by this architecture
+	 */
+	static __noinline bool paint();
+
+	/**
+	 * @brief Get size of the stack in bytes
+	 * @retval size_t 0 if not supported by this architecture
+	 */
+	static size_t getSize();
+
+	/**
+	 * @brief Get maximum stack usage
+	 * @retval size_t Bytes used since `paint()` was called, or 0 if it hasn't been
+	 */
+	static size_t getMaxUsed();
+
+	/**
+	 * @brief Get maximum stack usage as a percentage of the stack size
+	 */
+	static unsigned getMaxUsedPercent()
+	{
+		auto size = getSize();
+		return (size == 0) ? 0 : (100U * getMaxUsed() / size);
+	}
+
+	/**
+	 * @brief Check stack usage periodically
+	 * @param intervalMs Time between checks
+	 * @param callback Invoked from task context when maximum usage increases
+	 */
+	void start(unsigned intervalMs, Callback callback);
+
+	void stop()
+	{
+		timer.stop();
+	}
+
+	/**
+	 * @brief Check stack usage now, invoking the callback if it has increased
+	 */
+	void check();
+
+private:
+	/**
+	 * @brief Obtain extent of the main task stack
+	 * @param bottom Lowest address
+	 * @param top Highest address + 1
+	 * @retval bool false if not supported
+	 * @note Implemented for each architecture
+	 */
+	static bool getBounds(uintptr_t& bottom, uintptr_t& top);
+
+	static bool painted;
+	Timer timer;
+	Callback callback;
+	size_t lastUsed{0};
+};
+
+} // namespace Profiling
@@ -11,6 +11,7 @@
 #pragma once
 
 #include <Print.h>
+#include <Platform/System.h>
 #include <memory>
 
 namespace Profiling
@@ -26,6 +27,7 @@ namespace Profiling
  * - FREERTOS_GENERATE_RUN_TIME_STATS
  * - FREERTOS_VTASKLIST_INCLUDE_COREID (optional)
  *
+ * Other architectures report Sming task queue statistics instead, which requires ENABLE_TASK_STATS=1.
  */
 class TaskStat
 {
@@ -47,6 +49,48 @@ public:
 	 */
 	bool update();
 
+	/**
+	 * @brief Print Sming task queue statistics
+	 * @retval bool false if ENABLE_TASK_STATS is not set
+	 *
+	 * Shows queue wait times and dropped callbacks for each priority,
+	 * a histogram of callback execution times and the slowest callbacks by function address.
+	 */
+	bool printQueueStats()
+	{
+		SystemClass::TaskStats stats;
+		if(!System.getTaskStats(stats)) {
+			out.println(_F("[TaskStat] Requires ENABLE_TASK_STATS=1"));
+			return false;
+		}
+
+		out.println(_F("Queue    Count  Avg wait  Max wait  Missed  Dropped"));
+		for(unsigned i = 0; i < stats.priorityCount; ++i) {
+			auto lat = System.getTaskLatency(TaskPriority(i));
+			out.printf(_F("%u      %7u  %6uus  %6uus  %6u  %7u\r\n"), i, lat.count, lat.average(), lat.max, lat.missed,
+					   stats.dropped[i]);
+		}
+
+		out.println(_F("Execution time histogram"));
+		for(unsigned i = 0; i < stats.histogramSize; ++i) {
+			auto limit = stats.getBucketLimit(i);
+			if(limit == UINT32_MAX) {
+				out.printf(_F("  >= %6uus: %u\r\n"), stats.getBucketLimit(i - 1), stats.histogram[i]);
+			} else {
+				out.printf(_F("  <  %6uus: %u\r\n"), limit, stats.histogram[i]);
+			}
+		}
+
+		out.println(_F("Slowest callbacks"));
+		for(auto& cb : stats.slowest) {
+			if(cb.address != 0) {
+				out.printf(_F("  0x%08x %uus\r\n"), cb.address, cb.time);
+			}
+		}
+
+		return true;
+	}
+
 private:
 	Print& out;
 	static constexpr size_t maxTasks{32};
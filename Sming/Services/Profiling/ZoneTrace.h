@@ -0,0 +1,220 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * ZoneTrace.h
+ *
+ * Lightweight instrumentation of code zones using CPU cycle timestamps.
+ *
+ ****/
+
+#pragma once
+
+#include <Print.h>
+#include <Platform/Clocks.h>
+#include <Platform/System.h>
+#include <algorithm>
+
+/**
+ * @brief Record execution time of the enclosing scope
+ * @param tracer The Profiling::ZoneTracer to record into
+ * @param name Zone name, a string literal which is stored in flash
+ */
+#define PROFILE_ZONE(tracer, name)                                                                                     \
+	Profiling::ZoneTracer::Scope PROFILE_ZONE_CONCAT_(profileZone_, __LINE__)((tracer), PSTR(name))
+
+#define PROFILE_ZONE_CONCAT_(a, b) PROFILE_ZONE_CONCAT2_(a, b)
+#define PROFILE_ZONE_CONCAT2_(a, b) a##b
+
+namespace Profiling
+{
+/**
+ * @brief Records timed code zones into a RAM ring buffer
+ *
+ * Each entry holds a zone identifier plus start time and duration in CPU cycles,
+ * so recording costs little more than two reads of the cycle counter.
+ * When full, the oldest entries are overwritten.
+ *
+ * Use the `PROFILE_ZONE` macro to instrument code, and `exportChromeTrace`
+ * to produce a JSON file which can be loaded into `chrome://tracing` or https://ui.perfetto.dev.
+ *
+ * @note Not interrupt-safe: record zones from task context only.
+ * The cycle counter wraps every few tens of seconds so entries must span less than this interval.
+ */
+class ZoneTracer
+{
+public:
+	using Clock = CpuCycleClockNormal;
+
+	struct Entry {
+		const char* zone; ///< Zone name in flash, also used as identifier
+		uint32_t start;	  ///< CPU cycle count at zone entry
+		uint32_t duration;
+	};
+
+	/**
+	 * @brief Records a zone for the lifetime of this object
+	 */
+	class Scope
+	{
+	public:
+		__forceinline Scope(ZoneTracer& tracer, const char* zone) : tracer(tracer), zone(zone), start(Clock::ticks())
+		{
+		}
+
+		__forceinline ~Scope()
+		{
+			tracer.record(zone, start, Clock::ticks() - start);
+		}
+
+	private:
+		ZoneTracer& tracer;
+		const char* zone;
+		uint32_t start;
+	};
+
+	void record(const char* zone, uint32_t start, uint32_t duration)
+	{
+		if(!enabled) {
+			return;
+		}
+		entries[head] = Entry{zone, start, duration};
+		if(++head == capacity) {
+			head = 0;
+		}
+		++total;
+	}
+
+	/**
+	 * @brief Suspend or resume recording
+	 */
+	void enable(bool state)
+	{
+		enabled = state;
+	}
+
+	bool isEnabled() const
+	{
+		return enabled;
+	}
+
+	/**
+	 * @brief Discard all recorded entries
+	 */
+	void clear()
+	{
+		head = 0;
+		total = 0;
+	}
+
+	/**
+	 * @brief Get number of entries currently held
+	 */
+	size_t getCount() const
+	{
+		return std::min(total, uint32_t(capacity));
+	}
+
+	/**
+	 * @brief Get number of entries which have been overwritten
+	 */
+	uint32_t getDropped() const
+	{
+		return total - getCount();
+	}
+
+	/**
+	 * @brief Get an entry by index
+	 * @param index 0 is the oldest entry
+	 */
+	const Entry& operator[](size_t index) const
+	{
+		auto count = getCount();
+		return entries[(head + capacity - count + index) % capacity];
+	}
+
+	/**
+	 * @brief Write recorded entries in Chrome trace-event JSON format
+	 * @param p Destination, e.g. Serial or a MemoryDataStream for sending as an HTTP response
+	 * @retval size_t Number of characters written
+	 *
+	 * Timestamps are in microseconds relative to the earliest recorded zone entry.
+	 */
+	size_t exportChromeTrace(Print& p) const
+	{
+		auto count = getCount();
+		auto cpuMhz = System.getCpuFrequency();
+		// Entries are recorded on zone exit, so enclosing zones may have started earlier
+		uint32_t base = (count == 0) ? 0 : (*this)[0].start;
+		for(unsigned i = 1; i < count; ++i) {
+			auto start = (*this)[i].start;
+			if(int(start - base) < 0) {
+				base = start;
+			}
+		}
+
+		size_t n = p.print(_F("{\"traceEvents\":["));
+		for(unsigned i = 0; i < count; ++i) {
+			auto& e = (*this)[i];
+			if(i != 0) {
+				n += p.print(',');
+			}
+			n += p.print(_F("{\"name\":\""));
+			n += p.print(String(FPSTR(e.zone)));
+			n += p.print(_F("\",\"ph\":\"X\",\"pid\":0,\"tid\":0,\"ts\":"));
+			n += printMicros(p, e.start - base, cpuMhz);
+			n += p.print(_F(",\"dur\":"));
+			n += printMicros(p, e.duration, cpuMhz);
+			n += p.print('}');
+		}
+		n += p.print(_F("],\"displayTimeUnit\":\"ns\"}"));
+		return n;
+	}
+
+protected:
+	ZoneTracer(Entry* entries, size_t capacity) : entries(entries), capacity(capacity)
+	{
+	}
+
+private:
+	static size_t printMicros(Print& p, uint32_t cycles, unsigned cpuMhz)
+	{
+		uint64_t ns = uint64_t(cycles) * 1000U / cpuMhz;
+		auto frac = unsigned(ns % 1000);
+		size_t n = p.print(uint32_t(ns / 1000));
+		n += p.print('.');
+		if(frac < 100) {
+			n += p.print('0');
+		}
+		if(frac < 10) {
+			n += p.print('0');
+		}
+		n += p.print(frac);
+		return n;
+	}
+
+	Entry* entries;
+	size_t capacity;
+	size_t head{0};
+	uint32_t total{0};
+	bool enabled{true};
+};
+
+/**
+ * @brief Zone tracer with statically allocated buffer
+ * @tparam size Number of entries to hold
+ */
+template <size_t size> class ZoneTrace : public ZoneTracer
+{
+public:
+	ZoneTrace() : ZoneTracer(buffer, size)
+	{
+	}
+
+private:
+	Entry buffer[size];
+};
+
+} // namespace Profiling
@@ -18,6 +18,15 @@
 
 #include "FakePgmSpace.h"
 
+//Send records from C++ code via BinaryLog, formatted later on the host
+#ifndef DEBUG_BINARY_LOG
+#define DEBUG_BINARY_LOG 0
+#endif
+
+#if defined(__cplusplus) && DEBUG_BINARY_LOG
+#include <Services/BinaryLog/BinaryLog.h>
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -67,7 +76,26 @@ extern uint32_t system_get_time();
 //A static const char[] is defined having a unique name (log_ prefix, filename and line number)
 //This will be stored in the irom section(on flash) freeing up the RAM
 //Next special version of printf from FakePgmSpace is called to fetch and print the message
+#if defined(__cplusplus) && DEBUG_BINARY_LOG
+//Only the address of the format string is logged; m_printf is never called but checks the arguments
 #if DEBUG_PRINT_FILENAME_AND_LINE
+#define debug_e(fmt, ...)                                                                                              \
+	(__extension__({                                                                                                   \
+		PSTR_ARRAY(fmtbuf, "[" MACROQUOTE(CUST_FILE_BASE) ":%d] " fmt);                                                \
+		if(0)                                                                                                          \
+			m_printf(fmtbuf, __LINE__, ##__VA_ARGS__);                                                                 \
+		BinaryLog::log(fmtbuf, __LINE__, ##__VA_ARGS__);                                                               \
+	}))
+#else
+#define debug_e(fmt, ...)                                                                                              \
+	(__extension__({                                                                                                   \
+		PSTR_ARRAY(fmtbuf, fmt);                                                                                       \
+		if(0)                                                                                                          \
+			m_printf(fmtbuf, ##__VA_ARGS__);                                                                           \
+		BinaryLog::log(fmtbuf, ##__VA_ARGS__);                                                                         \
+	}))
+#endif
+#elif DEBUG_PRINT_FILENAME_AND_LINE
 #define debug_e(fmt, ...)                                                                                              \
 	(__extension__({                                                                                                   \
 		PSTR_ARRAY(fmtbuf, "[" MACROQUOTE(CUST_FILE_BASE) ":%d] " fmt "\r\n");                                         \
@@ -0,0 +1,65 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * heap_info.h - Heap fragmentation metrics
+ *
+ * Free heap size alone doesn't indicate whether a large allocation can succeed.
+ * These functions are implemented by the heap component for each architecture.
+ *
+ ****/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+	uint32_t free_size;			 ///< Total free bytes
+	uint32_t largest_free_block; ///< Size of the largest single allocation which can succeed
+	uint32_t free_blocks;		 ///< Number of separate free regions, 0 if unknown
+	uint8_t fragmentation;		 ///< 0 (no fragmentation) to 100 (fully fragmented)
+} heap_info_t;
+
+/**
+ * @brief Get heap fragmentation metrics
+ * @param info On return, contains heap statistics
+ * @retval bool false if the allocator doesn't provide fragmentation information.
+ * In this case `largest_free_block` is set to `free_size`.
+ * @note This typically requires a walk of the heap so avoid calling it from time-critical code
+ */
+bool system_get_heap_info(heap_info_t* info);
+
+/**
+ * @brief Get the size of the largest block which may be allocated
+ */
+static inline uint32_t system_get_max_free_block_size(void)
+{
+	heap_info_t info;
+	system_get_heap_info(&info);
+	return info.largest_free_block;
+}
+
+/**
+ * @brief Calculate fragmentation score for an allocator which doesn't provide one
+ * @param free_size Total free bytes
+ * @param largest_free_block Largest contiguous free region
+ * @retval uint8_t Percentage of free memory not available as a single allocation
+ */
+static inline uint8_t system_calc_heap_fragmentation(uint32_t free_size, uint32_t largest_free_block)
+{
+	if(free_size == 0 || largest_free_block >= free_size) {
+		return 0;
+	}
+	return 100 - (uint8_t)((100ULL * largest_free_block) / free_size);
+}
+
+#ifdef __cplusplus
+}
+#endif
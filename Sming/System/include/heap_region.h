@@ -0,0 +1,61 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * heap_region.h - Allocation from a specific heap region
+ *
+ * Moving large, long-lived buffers out of the general heap leaves more contiguous
+ * memory available for short-lived allocations.
+ * These functions are implemented by the heap component for each architecture.
+ *
+ ****/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+	HEAP_REGION_DEFAULT,   ///< General-purpose heap
+	HEAP_REGION_SECONDARY, ///< Byte-addressable memory outside the general heap, such as external SPI RAM
+	HEAP_REGION_IRAM,	   ///< Instruction RAM. Only 32-bit aligned reads and writes are permitted.
+} heap_region_t;
+
+/**
+ * @brief Allocate memory from a specific heap region
+ * @param region
+ * @param size
+ * @retval void* Free using `free()`
+ * @note If the region is unavailable or exhausted, the default heap is used.
+ * This means `HEAP_REGION_IRAM` memory must always be accessed as 32-bit words,
+ * wherever it actually resides.
+ */
+void* heap_region_malloc(heap_region_t region, size_t size);
+
+/**
+ * @brief Determine whether a region is available
+ * @retval bool false if allocations from this region come from the default heap
+ */
+bool heap_region_available(heap_region_t region);
+
+#ifdef __cplusplus
+}
+
+/**
+ * @brief Deleter for use with `std::unique_ptr` and memory from `heap_region_malloc()`
+ */
+struct HeapRegionDeleter {
+	void operator()(void* ptr) const
+	{
+		free(ptr);
+	}
+};
+
+#endif
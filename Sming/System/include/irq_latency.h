@@ -0,0 +1,55 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * irq_latency.h - Measurement of interrupts-disabled time
+ *
+ * Build with ENABLE_IRQ_LATENCY=1 to enable. The architecture `noInterrupts()`, `interrupts()`
+ * and `restoreInterrupts()` calls then record each period during which interrupts are masked,
+ * keeping the longest one and where it started.
+ *
+ ****/
+
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+	uint32_t max_cycles;	///< Longest time interrupts were disabled, in CPU cycles
+	const void* max_caller; ///< Address of `noInterrupts()` call which began the longest period
+	uint32_t count;			///< Number of periods measured
+} irq_latency_info_t;
+
+/**
+ * @brief Get interrupt latency statistics
+ * @param info On return, contains statistics gathered since startup or the last reset
+ * @note All values are zero if ENABLE_IRQ_LATENCY is not set, or the architecture doesn't support it
+ */
+void irq_latency_get_info(irq_latency_info_t* info);
+
+/**
+ * @brief Clear interrupt latency statistics
+ */
+void irq_latency_reset(void);
+
+/**
+ * @brief Called by architecture code after interrupts have been masked
+ * @param caller Address of code responsible, or NULL to use the return address
+ * @note Only call this when interrupts were previously enabled
+ */
+void irq_latency_lock(const void* caller);
+
+/**
+ * @brief Called by architecture code immediately before interrupts are unmasked
+ */
+void irq_latency_unlock(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -175,6 +175,62 @@ __forceinline uint64_t IRAM_ATTR muldiv64(const uint64_t& value, const uint64_t&
 	return muldiv(value, num, den);
 }
 
+/**
+ * @brief Unsigned division by a constant using multiply and shift
+ * @tparam divisor
+ * @note The ESP8266 has no hardware divider so division, even by a constant, requires a runtime
+ * library call. The reciprocal is computed here at compile time so each division costs a single
+ * 32 x 32 -> 64-bit multiply plus a few shifts and adds, and is exact for all 32-bit values.
+ *
+ * See Granlund & Montgomery, "Division by Invariant Integers using Multiplication".
+ */
+template <uint32_t divisor> struct ConstDivider {
+	static_assert(divisor != 0, "Division by zero");
+
+	static constexpr bool isPowerOf2()
+	{
+		return (divisor & (divisor - 1)) == 0;
+	}
+
+	/**
+	 * @brief Smallest `n` such that (1 << n) >= divisor
+	 */
+	static constexpr unsigned shift()
+	{
+		unsigned n{0};
+		while((uint64_t(1) << n) < divisor) {
+			++n;
+		}
+		return n;
+	}
+
+	static constexpr uint32_t multiplier()
+	{
+		return isPowerOf2() ? 0 : uint32_t(((uint64_t(1) << 32) * ((uint64_t(1) << shift()) - divisor)) / divisor + 1);
+	}
+
+	static __forceinline uint32_t IRAM_ATTR divide(uint32_t value)
+	{
+		if constexpr(isPowerOf2()) {
+			return value >> shift();
+		} else {
+			uint32_t t = (uint64_t(multiplier()) * value) >> 32;
+			return (t + ((value - t) >> 1)) >> (shift() - 1);
+		}
+	}
+};
+
+/**
+ * @brief Determine if a 32-bit muldiv template calculation can be done entirely using reciprocals
+ * @tparam num Minimised numerator
+ * @tparam den Minimised denominator
+ * @note Requires remainder calculations to fit into 32 bits, which is the case for all the standard clocks
+ */
+template <uint64_t num, uint64_t den> constexpr bool muldivUseReciprocal()
+{
+	return num <= 0xFFFFFFFFU && den <= 0xFFFFFFFFU && (den - 1) * num + den / 2 <= 0xFFFFFFFFU;
+}
+
 /**
  * @brief Templated muldiv version so numerator and denominator are pre-calculated
  * @tparam num
@@ -182,6 +238,8 @@ __forceinline uint64_t IRAM_ATTR muldiv64(const uint64_t& value, const uint64_t&
  * @tparam ValType
  * @param value
  * @retval ValType Returns numeric_limits<ValType>::max() on overflow (same as ValType(-1))
+ * @note Where possible the calculation avoids runtime division and 64-bit intermediate values:
+ * splitting the value as `q * den + r` gives `q * num + (r * num + den / 2) / den`.
  */
 template <uint64_t num, uint64_t den, typename ValType> __forceinline ValType IRAM_ATTR muldiv(const ValType& value)
 {
@@ -202,6 +260,28 @@ template <uint64_t num, uint64_t den, typename ValType> __forceinline ValType IR
 		return max;
 	}
 
+	if constexpr(muldivUseReciprocal<R::num, R::den>()) {
+		if constexpr(sizeof(ValType) == sizeof(uint32_t)) {
+			using Div = ConstDivider<R::den>;
+			uint32_t q = Div::divide(value);
+			uint32_t r = value - q * uint32_t(R::den);
+			if(q > max / R::num) {
+				return max; // overflow
+			}
+			uint32_t res = q * uint32_t(R::num);
+			uint32_t rem = Div::divide(r * uint32_t(R::num) + frac);
+			return (rem > max - res) ? max : res + rem;
+		} else if constexpr(sizeof(ValType) == sizeof(uint64_t)) {
+			// Most values passed to 64-bit calculations fit into 32 bits
+			if(value <= 0xFFFFFFFFU) {
+				auto res = muldiv<R::num, R::den>(uint32_t(value));
+				if(res != 0xFFFFFFFFU) {
+					return res;
+				}
+			}
+		}
+	}
+
 	/*
 	 * calculation:	result = ((value * num) + frac) / den
 	 * overflow:	((value * num) + frac) > max
@@ -212,7 +292,8 @@ template <uint64_t num, uint64_t den, typename ValType> __forceinline ValType IR
 	if(value > lim) {
 		if(sizeof(ValType) < sizeof(uint64_t)) {
 			// Try using 64-bit calculation
-			return muldiv<R::num, R::den>(uint64_t(value));
+			auto res = muldiv<R::num, R::den>(uint64_t(value));
+			return (res > max) ? max : ValType(res);
 		} else {
 			return max; // overflow
 		}
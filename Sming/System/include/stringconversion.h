@@ -88,6 +88,29 @@ static inline char *dtostrf(double floatVar, int minStringWidthIncDecimalPoint,
 	return dtostrf_p(floatVar, minStringWidthIncDecimalPoint, numDigitsAfterDecimal, outputBuffer, ' ');
 }
 
+/**
+ * @brief Buffer size sufficient for dtostr_shortest() and ftostr_shortest()
+ */
+#define DTOSTR_SHORTEST_BUFSIZE 26
+
+/**
+ * @brief Convert a value to the shortest decimal string which reads back as the same value
+ * @param value
+ * @param buffer At least DTOSTR_SHORTEST_BUFSIZE characters
+ * @retval char* buffer
+ * @note Plain decimal notation is used for magnitudes from 1e-6 up to 1e21, otherwise an exponent is included.
+ * For example, 0.1 produces "0.1", 1e21 gives "1e+21" and non-finite values give "NaN", "Inf" or "-Inf".
+ */
+extern char* dtostr_shortest(double value, char* buffer);
+
+/**
+ * @brief Convert a single-precision value to the shortest decimal string which reads back as the same value
+ * @see dtostr_shortest()
+ *
+ * Digits are produced to single precision, so 0.1f produces "0.1" rather than "0.10000000149011612".
+ */
+extern char* ftostr_shortest(float value, char* buffer);
+
 long atol(const char *nptr);
 extern long os_strtol(const char* str, char** endptr, int base);
 extern double os_strtod(const char* str, char** endptr);
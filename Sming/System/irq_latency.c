@@ -0,0 +1,54 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * irq_latency.c
+ *
+ ****/
+
+#include <irq_latency.h>
+#include <esp_attr.h>
+#include <esp_clk.h>
+#include <stdbool.h>
+
+static volatile irq_latency_info_t stats;
+static volatile uint32_t lock_start;
+static const void* volatile lock_caller;
+static volatile bool locked;
+
+void irq_latency_get_info(irq_latency_info_t* info)
+{
+	info->max_cycles = stats.max_cycles;
+	info->max_caller = stats.max_caller;
+	info->count = stats.count;
+}
+
+void irq_latency_reset(void)
+{
+	stats.max_cycles = 0;
+	stats.max_caller = NULL;
+	stats.count = 0;
+}
+
+void IRAM_ATTR irq_latency_lock(const void* caller)
+{
+	lock_start = esp_get_ccount();
+	lock_caller = caller ?: __builtin_return_address(0);
+	locked = true;
+}
+
+void IRAM_ATTR irq_latency_unlock(void)
+{
+	if(!locked) {
+		return;
+	}
+	locked = false;
+	uint32_t elapsed = esp_get_ccount() - lock_start;
+	++stats.count;
+	if(elapsed > stats.max_cycles) {
+		stats.max_cycles = elapsed;
+		stats.max_caller = lock_caller;
+	}
+}
@@ -119,11 +119,22 @@ int m_vsnprintf(char *buf, size_t maxLen, const char *fmt, va_list args)
     auto add = [&](char c) {
         if (++size < maxLen) *buf++ = c;
     };
+    // Copy as much of a block as will fit, but count it all
+    auto addBlock = [&](const char* str, size_t len) {
+        if (size + 1 < maxLen) {
+            size_t n = std::min(len, maxLen - size - 1);
+            memcpy(buf, str, n);
+            buf += n;
+        }
+        size += len;
+    };
 
     while (*fmt) {
-        //  copy verbatim text
+        //  copy verbatim text up to next conversion in one go, usually most of the format string
         if (*fmt != '%')  {
-            add(*fmt++);
+            const char* start = fmt;
+            while (*fmt != '\0' && *fmt != '%') fmt++;
+            addBlock(start, fmt - start);
             continue;
         }
         fmt++;
@@ -203,7 +214,7 @@ int m_vsnprintf(char *buf, size_t maxLen, const char *fmt, va_list args)
                 if(isFlash) {
                 	while (len--)                   add(pgm_read_byte(s++));
                 } else {
-                	while (len--)                   add(*s++);
+                	addBlock(s, len);
                 }
                 while (minus && padding-- > 0)  add(' ');
                 continue;
@@ -226,6 +237,17 @@ int m_vsnprintf(char *buf, size_t maxLen, const char *fmt, va_list args)
                 s = dtostrf_p(va_arg(args, double), width, precision, tempNum, pad);
                 break;
 
+            case 'g':
+            case 'G':
+                if (precision >= 0) {
+                    s = dtostrf_p(va_arg(args, double), width, precision, tempNum, pad);
+                    break;
+                }
+                // Shortest representation which reads back as the same value
+                s = dtostr_shortest(va_arg(args, double), tempNum);
+                for (int padding = width - int(strlen(s)); padding > 0; --padding) add(' ');
+                break;
+
             case 'o':
                 ubase = 8;
                 break;
@@ -262,9 +284,9 @@ int m_vsnprintf(char *buf, size_t maxLen, const char *fmt, va_list args)
         }
 
         //  copy string to target
-        while (*s) add(*s++);
+        addBlock(s, strlen(s));
     }
-    *buf = 0;
+    if (maxLen != 0) *buf = 0;
     return size;
 }
 
@@ -14,100 +14,158 @@
 #include <cstring>
 #include "stringconversion.h"
 #include "stringutil.h"
+#include <sys/pgmspace.h>
 
 
+namespace
+{
+/*
+ * Write digits backwards ending at `end`, returning pointer to the first digit.
+ *
+ * Decimal conversion produces two digits per division and power-of-2 bases use shifts,
+ * as division is comparatively expensive (and for 64-bit values, a library call).
+ */
+char* format_u32(uint32_t val, char* end, unsigned base)
+{
+	char* p = end;
+	if(base == 10) {
+		while(val >= 100) {
+			uint32_t q = val / 100;
+			uint32_t r = val - q * 100;
+			val = q;
+			uint32_t tens = (r * 103) >> 10; // r / 10 for r < 100
+			*--p = '0' + r - tens * 10;
+			*--p = '0' + tens;
+		}
+		if(val >= 10) {
+			uint32_t tens = (val * 103) >> 10;
+			*--p = '0' + val - tens * 10;
+			val = tens;
+		}
+		*--p = '0' + val;
+		return p;
+	}
+
+	if((base & (base - 1)) == 0) {
+		unsigned shift = __builtin_ctz(base);
+		unsigned mask = base - 1;
+		do {
+			*--p = hexchar(val & mask);
+			val >>= shift;
+		} while(val != 0);
+		return p;
+	}
+
+	do {
+		*--p = hexchar(val % base);
+		val /= base;
+	} while(val != 0);
+	return p;
+}
+
+char* format_u64(uint64_t val, char* end, unsigned base)
+{
+	char* p = end;
+	if(base == 10) {
+		// Peel off 9 digits at a time so the remainder can use 32-bit arithmetic
+		while(val > UINT32_MAX) {
+			uint64_t q = val / 1000000000U;
+			uint32_t r = val - q * 1000000000U;
+			val = q;
+			auto first = format_u32(r, p, 10);
+			while(first > p - 9) {
+				*--first = '0';
+			}
+			p = first;
+		}
+		return format_u32(val, p, 10);
+	}
+
+	if((base & (base - 1)) == 0) {
+		unsigned shift = __builtin_ctz(base);
+		unsigned mask = base - 1;
+		do {
+			*--p = hexchar(val & mask);
+			val >>= shift;
+		} while(val != 0);
+		return p;
+	}
+
+	do {
+		*--p = hexchar(val % base);
+		val /= base;
+	} while(val != 0);
+	return p;
+}
+
+/*
+ * Copy digits to buffer, left-padded to width
+ */
+char* pad_digits(const char* digits, const char* end, char* buffer, int width, char pad)
+{
+	int len = end - digits;
+	width -= len;
+	if(width > 0) {
+		memset(buffer, pad, width);
+	} else {
+		width = 0;
+	}
+	memcpy(buffer + width, digits, len + 1);
+	return buffer;
+}
+
+} // namespace
+
 char* ltoa_wp(long val, char* buffer, int base, int width, char pad)
 {
 	char* buf_ptr = buffer;
+	unsigned long uval = val;
 	if(val < 0 && base == 10) {
 		*buf_ptr++ = '-';
-		val = -val;
+		uval = 0UL - uval;
 	}
-	ultoa_wp((unsigned long)val, buf_ptr, base, width, pad);
+	ultoa_wp(uval, buf_ptr, base, width, pad);
 	return buffer;
 }
 
 char* ultoa_wp(unsigned long val, char* buffer, unsigned int base, int width, char pad)
 {
-	char buf[40];
-	constexpr int nulpos = sizeof(buf) - 1;
-	buf[nulpos] = '\0';
-
 	// prevent crash if called with base == 1
 	if(base < 2 || base > 16) {
 		base = 10;
 	}
 
-	int i = nulpos - 1;
-	int p = 0;
-	for(; val != 0 && i != 0; --i, p++, val /= base) {
-		buf[i] = hexchar(val % base);
-	}
-	if (p == 0) {
-		buf[i--] = '0'; // case for zero
-	}
-
-	if(width != 0)
-	{
-		width -= (nulpos - i - 1);
-		if(width > 0)
-		{
-			memset(buffer, pad, width);
-		}
-		else {
-			width = 0;
-		}
-	}
-	memcpy(buffer + width, &buf[i+1], nulpos - i);
-
-	return buffer;
+	char buf[40];
+	char* end = &buf[sizeof(buf) - 1];
+	*end = '\0';
+	auto digits = (sizeof(val) > sizeof(uint32_t)) ? format_u64(val, end, base) : format_u32(val, end, base);
+	return pad_digits(digits, end, buffer, width, pad);
 }
 
 char* lltoa_wp(long long val, char* buffer, int base, int width, char pad)
 {
 	char* buf_ptr = buffer;
+	unsigned long long uval = val;
 	if(val < 0 && base == 10) {
 		*buf_ptr++ = '-';
-		val = -val;
+		uval = 0ULL - uval;
 	}
-	ulltoa_wp((unsigned long long)val, buf_ptr, base, width, pad);
+	ulltoa_wp(uval, buf_ptr, base, width, pad);
 	return buffer;
 }
 
 char* ulltoa_wp(unsigned long long val, char* buffer, unsigned int base, int width, char pad)
 {
-	char buf[80];
-	constexpr int nulpos = sizeof(buf) - 1;
-	buf[nulpos] = '\0';
-
 	// prevent crash if called with base == 1
-	if(base < 2) {
+	if(base < 2 || base > 16) {
 		base = 10;
 	}
 
-	int i = nulpos - 1;
-	int p = 0;
-	for(; val != 0 && i != 0; --i, p++, val /= base) {
-		buf[i] = hexchar(val % base);
-	}
-	if (p == 0) {
-		buf[i--] = '0'; // case for zero
-	}
-
-	if(width != 0)
-	{
-		width -= (nulpos - i - 1);
-		if(width > 0)
-		{
-			memset(buffer, pad, width);
-		}
-		else {
-			width = 0;
-		}
-	}
-	memcpy(buffer + width, &buf[i+1], nulpos - i);
-
-	return buffer;
+	char buf[80];
+	char* end = &buf[sizeof(buf) - 1];
+	*end = '\0';
+	auto digits = format_u64(val, end, base);
+	return pad_digits(digits, end, buffer, width, pad);
 }
 
 // Author zitron: http://forum.arduino.cc/index.php?topic=37391#msg276209
@@ -224,3 +282,289 @@ char *dtostrf_p(double floatVar, int minStringWidthIncDecimalPoint, int numDigit
 
 	return outputBuffer;
 }
+
+/*
+ * Shortest round-trip conversion using the Grisu2 algorithm.
+ *
+ * Florian Loitsch, "Printing Floating-Point Numbers Quickly and Accurately with Integers", PLDI 2010.
+ * This follows the structure of the public domain implementation by Milo Yip.
+ *
+ * Output always reads back as the original value and is almost always the shortest such string.
+ * Only integer arithmetic is used, which is much faster than soft-float on devices without an FPU.
+ */
+namespace
+{
+struct DiyFp {
+	uint64_t f;
+	int e;
+};
+
+DiyFp multiply(const DiyFp& x, const DiyFp& y)
+{
+	constexpr uint64_t M32 = 0xffffffffU;
+	uint64_t a = x.f >> 32;
+	uint64_t b = x.f & M32;
+	uint64_t c = y.f >> 32;
+	uint64_t d = y.f & M32;
+	uint64_t ac = a * c;
+	uint64_t bc = b * c;
+	uint64_t ad = a * d;
+	uint64_t bd = b * d;
+	uint64_t tmp = (bd >> 32) + (ad & M32) + (bc & M32);
+	tmp += 1U << 31; // Round
+	return DiyFp{ac + (ad >> 32) + (bc >> 32) + (tmp >> 32), x.e + y.e + 64};
+}
+
+DiyFp normalize(const DiyFp& x)
+{
+	int shift = __builtin_clzll(x.f);
+	return DiyFp{x.f << shift, x.e - shift};
+}
+
+// Normalised significands of 10^k for k = -348, -340, ..., 340
+const uint64_t cachedPowers[] PROGMEM = {
+	0xfa8fd5a0081c0288ULL, 0xbaaee17fa23ebf76ULL, 0x8b16fb203055ac76ULL,
+	0xcf42894a5dce35eaULL, 0x9a6bb0aa55653b2dULL, 0xe61acf033d1a45dfULL,
+	0xab70fe17c79ac6caULL, 0xff77b1fcbebcdc4fULL, 0xbe5691ef416bd60cULL,
+	0x8dd01fad907ffc3cULL, 0xd3515c2831559a83ULL, 0x9d71ac8fada6c9b5ULL,
+	0xea9c227723ee8bcbULL, 0xaecc49914078536dULL, 0x823c12795db6ce57ULL,
+	0xc21094364dfb5637ULL, 0x9096ea6f3848984fULL, 0xd77485cb25823ac7ULL,
+	0xa086cfcd97bf97f4ULL, 0xef340a98172aace5ULL, 0xb23867fb2a35b28eULL,
+	0x84c8d4dfd2c63f3bULL, 0xc5dd44271ad3cdbaULL, 0x936b9fcebb25c996ULL,
+	0xdbac6c247d62a584ULL, 0xa3ab66580d5fdaf6ULL, 0xf3e2f893dec3f126ULL,
+	0xb5b5ada8aaff80b8ULL, 0x87625f056c7c4a8bULL, 0xc9bcff6034c13053ULL,
+	0x964e858c91ba2655ULL, 0xdff9772470297ebdULL, 0xa6dfbd9fb8e5b88fULL,
+	0xf8a95fcf88747d94ULL, 0xb94470938fa89bcfULL, 0x8a08f0f8bf0f156bULL,
+	0xcdb02555653131b6ULL, 0x993fe2c6d07b7facULL, 0xe45c10c42a2b3b06ULL,
+	0xaa242499697392d3ULL, 0xfd87b5f28300ca0eULL, 0xbce5086492111aebULL,
+	0x8cbccc096f5088ccULL, 0xd1b71758e219652cULL, 0x9c40000000000000ULL,
+	0xe8d4a51000000000ULL, 0xad78ebc5ac620000ULL, 0x813f3978f8940984ULL,
+	0xc097ce7bc90715b3ULL, 0x8f7e32ce7bea5c70ULL, 0xd5d238a4abe98068ULL,
+	0x9f4f2726179a2245ULL, 0xed63a231d4c4fb27ULL, 0xb0de65388cc8ada8ULL,
+	0x83c7088e1aab65dbULL, 0xc45d1df942711d9aULL, 0x924d692ca61be758ULL,
+	0xda01ee641a708deaULL, 0xa26da3999aef774aULL, 0xf209787bb47d6b85ULL,
+	0xb454e4a179dd1877ULL, 0x865b86925b9bc5c2ULL, 0xc83553c5c8965d3dULL,
+	0x952ab45cfa97a0b3ULL, 0xde469fbd99a05fe3ULL, 0xa59bc234db398c25ULL,
+	0xf6c69a72a3989f5cULL, 0xb7dcbf5354e9beceULL, 0x88fcf317f22241e2ULL,
+	0xcc20ce9bd35c78a5ULL, 0x98165af37b2153dfULL, 0xe2a0b5dc971f303aULL,
+	0xa8d9d1535ce3b396ULL, 0xfb9b7cd9a4a7443cULL, 0xbb764c4ca7a44410ULL,
+	0x8bab8eefb6409c1aULL, 0xd01fef10a657842cULL, 0x9b10a4e5e9913129ULL,
+	0xe7109bfba19c0c9dULL, 0xac2820d9623bf429ULL, 0x80444b5e7aa7cf85ULL,
+	0xbf21e44003acdd2dULL, 0x8e679c2f5e44ff8fULL, 0xd433179d9c8cb841ULL,
+	0x9e19db92b4e31ba9ULL, 0xeb96bf6ebadf77d9ULL, 0xaf87023b9bf0ee6bULL,
+};
+
+const uint32_t powersOf10[] PROGMEM = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000};
+
+// Binary exponent for cached power at given index: floor(k * log2(10)) - 63
+constexpr int cachedPowerExponent(int index)
+{
+	return (((-348 + 8 * index) * 1741647) >> 19) - 63;
+}
+
+/*
+ * Get cached power c = 10^-K such that a product with exponent `e` lands in [-60, -32].
+ * This is the range which digit generation can handle using 64-bit integers.
+ */
+DiyFp getCachedPower(int e, int& K)
+{
+	// Initial estimate: ceil((-61 - e) * log10(2)), refined below
+	int index = ((((-61 - e) * 78913) >> 18) + 348) / 8;
+	while(index > 0 && cachedPowerExponent(index) + e + 64 > -32) {
+		--index;
+	}
+	while(cachedPowerExponent(index) + e + 64 < -60) {
+		++index;
+	}
+	K = 348 - 8 * index;
+	return DiyFp{cachedPowers[index], cachedPowerExponent(index)};
+}
+
+void grisuRound(char* buffer, int len, uint64_t delta, uint64_t rest, uint64_t tenKappa, uint64_t wpw)
+{
+	while(rest < wpw && delta - rest >= tenKappa && (rest + tenKappa < wpw || wpw - rest > rest + tenKappa - wpw)) {
+		--buffer[len - 1];
+		rest += tenKappa;
+	}
+}
+
+int digitGen(const DiyFp& W, const DiyFp& Mp, uint64_t delta, char* buffer, int& K)
+{
+	const DiyFp one{uint64_t(1) << -Mp.e, Mp.e};
+	const uint64_t wpw = Mp.f - W.f;
+	uint32_t p1 = Mp.f >> -one.e;
+	uint64_t p2 = Mp.f & (one.f - 1);
+	int kappa = 1;
+	while(kappa < 10 && p1 >= powersOf10[kappa]) {
+		++kappa;
+	}
+	int len = 0;
+	while(kappa > 0) {
+		uint32_t div = powersOf10[kappa - 1];
+		uint32_t d = p1 / div;
+		p1 -= d * div;
+		if(d != 0 || len != 0) {
+			buffer[len++] = '0' + d;
+		}
+		--kappa;
+		uint64_t rest = (uint64_t(p1) << -one.e) + p2;
+		if(rest <= delta) {
+			K += kappa;
+			grisuRound(buffer, len, delta, rest, uint64_t(powersOf10[kappa]) << -one.e, wpw);
+			return len;
+		}
+	}
+
+	for(;;) {
+		p2 *= 10;
+		delta *= 10;
+		char d = p2 >> -one.e;
+		if(d != 0 || len != 0) {
+			buffer[len++] = '0' + d;
+		}
+		p2 &= one.f - 1;
+		--kappa;
+		if(p2 < delta) {
+			K += kappa;
+			unsigned index = -kappa;
+			grisuRound(buffer, len, delta, p2, one.f, (index < 10) ? wpw * powersOf10[index] : 0);
+			return len;
+		}
+	}
+}
+
+/*
+ * Generate shortest digits for value f * 2^e, returning number of digits.
+ * Value of result is digits * 10^K.
+ */
+int grisu2(uint64_t f, int e, bool lowerBoundaryCloser, char* digits, int& K)
+{
+	// Boundaries are half-way to the adjacent representable values
+	DiyFp mPlus = normalize(DiyFp{(f << 1) + 1, e - 1});
+	DiyFp mMinus = lowerBoundaryCloser ? DiyFp{(f << 2) - 1, e - 2} : DiyFp{(f << 1) - 1, e - 1};
+	mMinus.f <<= mMinus.e - mPlus.e;
+	mMinus.e = mPlus.e;
+
+	DiyFp c = getCachedPower(mPlus.e, K);
+	DiyFp W = multiply(normalize(DiyFp{f, e}), c);
+	DiyFp Wp = multiply(mPlus, c);
+	DiyFp Wm = multiply(mMinus, c);
+	++Wm.f;
+	--Wp.f;
+	return digitGen(W, Wp, Wp.f - Wm.f, digits, K);
+}
+
+/*
+ * Lay out digits * 10^K in decimal, or with exponent for very large or small values
+ */
+char* formatDecimal(const char* digits, int len, int K, char* buffer)
+{
+	int kk = len + K; // 10^(kk-1) <= value < 10^kk
+	char* p = buffer;
+	if(len <= kk && kk <= 21) {
+		// 1234e7 -> 12340000000
+		memcpy(p, digits, len);
+		p += len;
+		memset(p, '0', kk - len);
+		p += kk - len;
+	} else if(kk > 0 && kk <= 21) {
+		// 1234e-2 -> 12.34
+		memcpy(p, digits, kk);
+		p += kk;
+		*p++ = '.';
+		memcpy(p, digits + kk, len - kk);
+		p += len - kk;
+	} else if(kk > -6 && kk <= 0) {
+		// 1234e-6 -> 0.001234
+		*p++ = '0';
+		*p++ = '.';
+		memset(p, '0', -kk);
+		p += -kk;
+		memcpy(p, digits, len);
+		p += len;
+	} else {
+		// 1234e30 -> 1.234e+33
+		*p++ = digits[0];
+		if(len > 1) {
+			*p++ = '.';
+			memcpy(p, digits + 1, len - 1);
+			p += len - 1;
+		}
+		*p++ = 'e';
+		int exponent = kk - 1;
+		if(exponent < 0) {
+			*p++ = '-';
+			exponent = -exponent;
+		} else {
+			*p++ = '+';
+		}
+		char expBuf[4];
+		char* expEnd = &expBuf[sizeof(expBuf)];
+		auto expDigits = format_u32(exponent, expEnd, 10);
+		memcpy(p, expDigits, expEnd - expDigits);
+		p += expEnd - expDigits;
+	}
+	*p = '\0';
+	return buffer;
+}
+
+char* formatShortest(bool negative, uint64_t f, int e, bool lowerBoundaryCloser, char* buffer)
+{
+	char* p = buffer;
+	if(negative) {
+		*p++ = '-';
+	}
+	if(f == 0) {
+		p[0] = '0';
+		p[1] = '\0';
+		return buffer;
+	}
+	char digits[20];
+	int K;
+	int len = grisu2(f, e, lowerBoundaryCloser, digits, K);
+	formatDecimal(digits, len, K, p);
+	return buffer;
+}
+
+char* formatNonFinite(bool negative, bool nan, char* buffer)
+{
+	strcpy(buffer, nan ? "NaN" : negative ? "-Inf" : "Inf");
+	return buffer;
+}
+
+} // namespace
+
+char* dtostr_shortest(double value, char* buffer)
+{
+	uint64_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	bool negative = (bits >> 63) != 0;
+	unsigned biasedExp = (bits >> 52) & 0x7ff;
+	uint64_t mantissa = bits & ((uint64_t(1) << 52) - 1);
+	if(biasedExp == 0x7ff) {
+		return formatNonFinite(negative, mantissa != 0, buffer);
+	}
+	if(biasedExp == 0) {
+		// Zero or subnormal
+		return formatShortest(negative, mantissa, -1074, false, buffer);
+	}
+	return formatShortest(negative, mantissa | (uint64_t(1) << 52), int(biasedExp) - 1075,
+						  mantissa == 0 && biasedExp > 1, buffer);
+}
+
+char* ftostr_shortest(float value, char* buffer)
+{
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	bool negative = (bits >> 31) != 0;
+	unsigned biasedExp = (bits >> 23) & 0xff;
+	uint32_t mantissa = bits & ((1U << 23) - 1);
+	if(biasedExp == 0xff) {
+		return formatNonFinite(negative, mantissa != 0, buffer);
+	}
+	if(biasedExp == 0) {
+		return formatShortest(negative, mantissa, -149, false, buffer);
+	}
+	return formatShortest(negative, mantissa | (1U << 23), int(biasedExp) - 150, mantissa == 0 && biasedExp > 1,
+						  buffer);
+}
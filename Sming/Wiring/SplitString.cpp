@@ -56,3 +56,20 @@ unsigned splitString(String& what, char delim, Vector<String>& splits)
 
 	return splits.count();
 }
+
+unsigned splitString(const StringView& what, char delim, Vector<StringView>& splits)
+{
+	splits.removeAllElements();
+	auto s = what.trim();
+	for(;;) {
+		auto pos = s.indexOf(delim);
+		if(pos == StringView::npos) {
+			splits.addElement(s);
+			break;
+		}
+		splits.addElement(s.substring(0, pos));
+		s = s.substring(pos + 1);
+	}
+
+	return splits.count();
+}
@@ -13,6 +13,7 @@
 
 #include "WVector.h"
 #include "WString.h"
+#include "StringView.h"
 
 /** @brief split a delimited string list of integers into an array
  *  @param what
@@ -33,3 +34,12 @@ unsigned splitString(String& what, char delim, Vector<int>& splits);
  *  example: "   a,b,c,d,e" returns ["a", "b", "c", "d", "e"]
  */
 unsigned splitString(String& what, char delim, Vector<String>& splits);
+
+/** @brief split a delimited string list into views, without copying
+ *  @param what Content must remain valid whilst splits are in use
+ *  @param delim
+ *  @param splits
+ *  @retval unsigned number of items returned in splits (same as splits.count())
+ *  @note leading/trailing whitespace is excluded from the result, 'what' is not modified
+ */
+unsigned splitString(const StringView& what, char delim, Vector<StringView>& splits);
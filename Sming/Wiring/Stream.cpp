@@ -23,11 +23,12 @@
 #include "Stream.h"
 
 #include <Platform/Timers.h>
+#include <algorithm>
 
 #define PARSE_TIMEOUT 1000 // default number of milli-seconds to wait
 #define NO_SKIP_CHAR 1	 // a magic char not found in a valid ASCII numeric field
 
-int Stream::timedRead()
+int Stream::waitRead()
 {
 	OneShotFastMs timer(receiveTimeout);
 
@@ -208,6 +209,29 @@ size_t Stream::readBytesUntil(char terminator, char* buffer, size_t length)
 	return index; // length, excluding null terminator
 }
 
+size_t Stream::copyTo(Print& dest, size_t size)
+{
+	char buffer[256];
+	size_t total{0};
+	while(total < size) {
+		int avail = available();
+		if(avail <= 0) {
+			break;
+		}
+		size_t len = std::min({size_t(avail), sizeof(buffer), size - total});
+		len = readBytes(buffer, len);
+		if(len == 0) {
+			break;
+		}
+		auto written = dest.write(reinterpret_cast<const uint8_t*>(buffer), len);
+		total += written;
+		if(written != len) {
+			break;
+		}
+	}
+	return total;
+}
+
 String Stream::readString(size_t maxLen)
 {
 	String s;
@@ -128,6 +128,21 @@ public:
 
 	String readStringUntil(char terminator);
 
+	/**
+	 * @brief Copy data to another output in blocks
+	 * @param dest Where to write data
+	 * @param size Maximum number of bytes to copy
+	 * @retval size_t Number of bytes written to `dest`
+	 *
+	 * Copies whatever is immediately available, without waiting for more.
+	 * Stops early if `dest` does not accept everything offered.
+	 *
+	 * @note The default implementation reads data before writing it, so anything
+	 * `dest` refuses is lost. Inherited classes which can look ahead without consuming
+	 * (files, memory, serial ports) override this so nothing is lost.
+	 */
+	virtual size_t copyTo(Print& dest, size_t size = SIZE_MAX);
+
 	/*
 	 * @brief Returns the location of the searched character
 	 * @param c Character to search for
@@ -139,7 +154,18 @@ public:
 	}
 
 protected:
-	int timedRead();
+	/**
+	 * @brief Read a character, waiting up to `receiveTimeout` if none is available
+	 * @retval int Character or -1 on timeout
+	 */
+	int timedRead()
+	{
+		// Don't start the timer if data is already waiting
+		int c = read();
+		return (c >= 0) ? c : waitRead();
+	}
+
+	int waitRead();
 	int timedPeek();
 
 	/**
@@ -0,0 +1,287 @@
+/****
+ * Sming Framework Project - Open Source framework for high efficiency native ESP8266 development.
+ * Created 2015 by Skurydin Alexey
+ * http://github.com/SmingHub/Sming
+ * All files of the Sming Core are provided under the LGPL v3 license.
+ *
+ * StringView.h - Non-owning reference to a sequence of characters
+ *
+ ****/
+
+#pragma once
+
+#include "WString.h"
+#include <stringutil.h>
+#include <algorithm>
+#include <cctype>
+
+/**
+ * @brief Refers to characters held elsewhere, without copying them
+ *
+ * Used to pass substrings around during parsing so a String need only be constructed
+ * for values which are actually kept.
+ *
+ * The referenced content must remain valid, and unchanged, for the lifetime of the view.
+ * In particular, do not keep a view of a temporary String.
+ * Content is not necessarily NUL-terminated so use `length()` rather than `strlen()`.
+ *
+ * Views always refer to RAM. Flash strings may be compared against directly,
+ * or copied into RAM using `LOAD_FSTR` first.
+ *
+ * @ingroup string
+ */
+class StringView
+{
+public:
+	static constexpr size_t npos = size_t(-1);
+
+	constexpr StringView() = default;
+
+	constexpr StringView(const char* str, size_t length) : ptr(str), len(str ? length : 0)
+	{
+	}
+
+	StringView(const char* cstr) : StringView(cstr, cstr ? strlen(cstr) : 0)
+	{
+	}
+
+	StringView(const String& s) : StringView(s.c_str(), s.length())
+	{
+	}
+
+	/**
+	 * @brief Start of content, not necessarily NUL-terminated
+	 */
+	constexpr const char* data() const
+	{
+		return ptr;
+	}
+
+	constexpr size_t length() const
+	{
+		return len;
+	}
+
+	constexpr bool empty() const
+	{
+		return len == 0;
+	}
+
+	constexpr const char* begin() const
+	{
+		return ptr;
+	}
+
+	constexpr const char* end() const
+	{
+		return ptr + len;
+	}
+
+	/**
+	 * @brief Get a character
+	 * @retval char '\0' if index is out of range
+	 */
+	constexpr char operator[](size_t index) const
+	{
+		return (index < len) ? ptr[index] : '\0';
+	}
+
+	/**
+	 * @name Comparison
+	 * @{
+	 */
+	bool equals(const char* cstr, size_t length) const
+	{
+		return len == length && (len == 0 || memcmp(ptr, cstr, len) == 0);
+	}
+
+	bool equals(const StringView& other) const
+	{
+		return equals(other.ptr, other.len);
+	}
+
+	bool equals(const FlashString& fstr) const
+	{
+		return fstr.equals(ptr, len);
+	}
+
+	bool equalsIgnoreCase(const char* cstr, size_t length) const
+	{
+		return len == length && (len == 0 || memicmp(ptr, cstr, len) == 0);
+	}
+
+	bool equalsIgnoreCase(const StringView& other) const
+	{
+		return equalsIgnoreCase(other.ptr, other.len);
+	}
+
+	bool equalsIgnoreCase(const FlashString& fstr) const
+	{
+		return fstr.equals(ptr, len, true);
+	}
+
+	bool operator==(const StringView& other) const
+	{
+		return equals(other);
+	}
+
+	bool operator==(const FlashString& fstr) const
+	{
+		return equals(fstr);
+	}
+
+	bool operator!=(const StringView& other) const
+	{
+		return !equals(other);
+	}
+
+	bool operator!=(const FlashString& fstr) const
+	{
+		return !equals(fstr);
+	}
+
+	bool startsWith(const StringView& prefix) const
+	{
+		return prefix.len <= len && (prefix.len == 0 || memcmp(ptr, prefix.ptr, prefix.len) == 0);
+	}
+
+	bool endsWith(const StringView& suffix) const
+	{
+		return suffix.len <= len && (suffix.len == 0 || memcmp(end() - suffix.len, suffix.ptr, suffix.len) == 0);
+	}
+	/** @} */
+
+	/**
+	 * @name Search
+	 * @retval size_t Position of match, npos if not found
+	 * @{
+	 */
+	size_t indexOf(char c, size_t fromIndex = 0) const
+	{
+		if(fromIndex >= len) {
+			return npos;
+		}
+		auto p = static_cast<const char*>(memchr(ptr + fromIndex, c, len - fromIndex));
+		return p ? size_t(p - ptr) : npos;
+	}
+
+	size_t indexOf(const StringView& s, size_t fromIndex = 0) const
+	{
+		if(fromIndex > len) {
+			return npos;
+		}
+		auto p = static_cast<const char*>(memmem(ptr + fromIndex, len - fromIndex, s.ptr, s.len));
+		return p ? size_t(p - ptr) : npos;
+	}
+
+	size_t lastIndexOf(char c) const
+	{
+		for(size_t i = len; i > 0; --i) {
+			if(ptr[i - 1] == c) {
+				return i - 1;
+			}
+		}
+		return npos;
+	}
+	/** @} */
+
+	/**
+	 * @brief Get a view of part of this content
+	 * @param from Index of first character
+	 * @param count Number of characters, clipped to the end of the content
+	 */
+	StringView substring(size_t from, size_t count = npos) const
+	{
+		if(from > len) {
+			from = len;
+		}
+		return StringView(ptr + from, std::min(count, len - from));
+	}
+
+	/**
+	 * @brief Get a view with leading and trailing whitespace removed
+	 */
+	StringView trim() const
+	{
+		auto first = ptr;
+		auto last = end();
+		while(first < last && isspace(uint8_t(*first))) {
+			++first;
+		}
+		while(last > first && isspace(uint8_t(last[-1]))) {
+			--last;
+		}
+		return StringView(first, last - first);
+	}
+
+	/**
+	 * @brief Split off content up to the first separator
+	 * @param sep
+	 * @retval StringView Content before the separator, or the entire view if there isn't one
+	 *
+	 * The returned content, and the separator, are removed from this view.
+	 * Use in a loop to visit each field in turn without allocating.
+	 */
+	StringView splitFirst(char sep)
+	{
+		auto pos = indexOf(sep);
+		if(pos == npos) {
+			auto result = *this;
+			*this = StringView();
+			return result;
+		}
+		StringView result(ptr, pos);
+		ptr += pos + 1;
+		len -= pos + 1;
+		return result;
+	}
+
+	/**
+	 * @brief Copy content into a String
+	 */
+	String toString() const
+	{
+		return String(ptr, len);
+	}
+
+	explicit operator String() const
+	{
+		return toString();
+	}
+
+	/**
+	 * @brief Parse content as a decimal integer, as for String::toInt()
+	 */
+	long toInt() const
+	{
+		char buf[24];
+		auto n = std::min(len, sizeof(buf) - 1);
+		memcpy(buf, ptr, n);
+		buf[n] = '\0';
+		return atol(buf);
+	}
+
+private:
+	const char* ptr{nullptr};
+	size_t len{0};
+};
+
+inline bool operator==(const String& s, const StringView& view)
+{
+	return view.equals(s.c_str(), s.length());
+}
+
+inline bool operator==(const StringView& view, const String& s)
+{
+	return view.equals(s.c_str(), s.length());
+}
+
+inline bool operator==(const StringView& view, const char* cstr)
+{
+	return view.equals(StringView(cstr));
+}
+
+inline bool operator!=(const StringView& view, const char* cstr)
+{
+	return !(view == cstr);
+}
@@ -24,6 +24,10 @@
  * used when adding a new unspecified entry, or if a key value is not present. This should not be necessary
  * for object values as the default constructor will be used.
  *
+ * Lookups are performed by linear search unless a hash function is provided, in which case an
+ * open-addressed index is maintained alongside the key/value lists. Entries remain in insertion order
+ * so iteration and index-based access are unaffected.
+ *
  */
 
 #pragma once
@@ -31,6 +35,7 @@
 #include <cstdint>
 #include <iterator>
 #include <cstdlib>
+#include <cstring>
 #include "WiringList.h"
 #include "Print.h"
 
@@ -180,6 +185,12 @@ public:
 	 */
 	using SortCompare = bool (*)(const ElementConst& e1, const ElementConst& e2);
 
+	/**
+	 * @brief Obtain hash value for a key
+	 * @note Keys which compare equal must produce the same hash value
+	 */
+	using HashFunction = uint32_t (*)(const K&);
+
 	/*
     || @constructor
     || | Default constructor
@@ -200,6 +211,34 @@ public:
 	{
 	}
 
+	/*
+    || @constructor
+    || | Initialize this HashMap with hashed lookup enabled
+    || #
+    ||
+    || @parameter compare optional function for comparing a key against another (for complex types)
+    || @parameter hash function to obtain hash value for a key
+    */
+	HashMap(Comparator compare, HashFunction hash) : cb_comparator(compare), cb_hash(hash)
+	{
+	}
+
+	~HashMap()
+	{
+		free(hashIndex);
+	}
+
+	/**
+	 * @brief Enable hashed lookups, or revert to linear search
+	 * @param hash Hash function, nullptr to disable
+	 * @note The hash function must be consistent with the key comparator
+	 */
+	void setHashFunction(HashFunction hash)
+	{
+		cb_hash = hash;
+		rebuildIndex(count());
+	}
+
 	/*
     || @description
     || | Get the size of this HashMap
@@ -229,6 +268,9 @@ public:
 		return keys[idx];
 	}
 
+	/**
+	 * @note If hashed lookups are enabled, changing key values invalidates the index
+	 */
 	K& keyAt(unsigned int idx)
 	{
 		if(idx >= count()) {
@@ -300,7 +342,13 @@ public:
 
 	bool allocate(unsigned int newSize)
 	{
-		return keys.allocate(newSize) && values.allocate(newSize);
+		if(!keys.allocate(newSize) || !values.allocate(newSize)) {
+			return false;
+		}
+		if(cb_hash != nullptr && newSize > hashIndexSize / 2) {
+			rebuildIndex(newSize);
+		}
+		return true;
 	}
 
 	/**
@@ -319,6 +367,10 @@ public:
     */
 	int indexOf(const K& key) const
 	{
+		if(hashIndex != nullptr) {
+			return hashIndexOf(key);
+		}
+
 		for(unsigned i = 0; i < currentIndex; i++) {
 			if(cb_comparator) {
 				if(cb_comparator(key, keys[i])) {
@@ -362,6 +414,11 @@ public:
 		values.remove(index);
 
 		currentIndex--;
+
+		// Entries following the one removed have moved, so index must be rebuilt
+		if(hashIndex != nullptr) {
+			rebuildIndex(currentIndex);
+		}
 	}
 
 	/*
@@ -384,6 +441,9 @@ public:
 		keys.clear();
 		values.clear();
 		currentIndex = 0;
+		free(hashIndex);
+		hashIndex = nullptr;
+		hashIndexSize = 0;
 	}
 
 	void setMultiple(const HashMap<K, V>& map)
@@ -425,10 +485,22 @@ protected:
 	KeyList keys;
 	ValueList values;
 	Comparator cb_comparator{nullptr};
+	HashFunction cb_hash{nullptr};
+	uint16_t* hashIndex{nullptr}; ///< Open-addressed table of (entry index + 1), 0 for empty slots
+	unsigned hashIndexSize{0};	///< Number of slots in hashIndex, always a power of 2
 	unsigned currentIndex{0};
 	V nil{};
 
 private:
+	bool keyEquals(const K& key1, const K& key2) const
+	{
+		return cb_comparator ? cb_comparator(key1, key2) : (key1 == key2);
+	}
+
+	int hashIndexOf(const K& key) const;
+	void indexAdd(unsigned index);
+	bool rebuildIndex(unsigned minCount);
+
 	HashMap(const HashMap<K, V>& that);
 	HashMap& operator=(const HashMap& that);
 };
@@ -445,6 +517,9 @@ template <typename K, typename V> V& HashMap<K, V>::operator[](const K& key)
 	keys[currentIndex] = key;
 	values[currentIndex] = nil;
 	currentIndex++;
+	if(cb_hash != nullptr) {
+		indexAdd(currentIndex - 1);
+	}
 	return values[currentIndex - 1];
 }
 
@@ -461,4 +536,78 @@ template <typename K, typename V> void HashMap<K, V>::sort(SortCompare compare)
 			}
 		}
 	}
+
+	if(hashIndex != nullptr) {
+		rebuildIndex(n);
+	}
+}
+
+template <typename K, typename V> int HashMap<K, V>::hashIndexOf(const K& key) const
+{
+	auto mask = hashIndexSize - 1;
+	for(unsigned pos = cb_hash(key) & mask;; pos = (pos + 1) & mask) {
+		unsigned slot = hashIndex[pos];
+		if(slot == 0) {
+			return -1;
+		}
+		if(keyEquals(key, keys[slot - 1])) {
+			return slot - 1;
+		}
+	}
+}
+
+template <typename K, typename V> void HashMap<K, V>::indexAdd(unsigned index)
+{
+	// Keep load factor at or below 50% so probe sequences stay short and there's always an empty slot
+	if(hashIndex == nullptr || (index + 1) * 2 > hashIndexSize) {
+		rebuildIndex(index + 1);
+		return;
+	}
+
+	auto mask = hashIndexSize - 1;
+	unsigned pos = cb_hash(keys[index]) & mask;
+	while(hashIndex[pos] != 0) {
+		pos = (pos + 1) & mask;
+	}
+	hashIndex[pos] = index + 1;
+}
+
+/*
+ * If memory cannot be allocated the index is discarded and map reverts to linear search
+ */
+template <typename K, typename V> bool HashMap<K, V>::rebuildIndex(unsigned minCount)
+{
+	if(cb_hash == nullptr || minCount == 0 || minCount >= UINT16_MAX) {
+		free(hashIndex);
+		hashIndex = nullptr;
+		hashIndexSize = 0;
+		return false;
+	}
+
+	unsigned newSize = 8;
+	while(newSize < minCount * 2) {
+		newSize <<= 1;
+	}
+
+	if(newSize != hashIndexSize) {
+		free(hashIndex);
+		hashIndex = static_cast<uint16_t*>(malloc(newSize * sizeof(uint16_t)));
+		if(hashIndex == nullptr) {
+			hashIndexSize = 0;
+			return false;
+		}
+		hashIndexSize = newSize;
+	}
+
+	memset(hashIndex, 0, hashIndexSize * sizeof(uint16_t));
+	auto mask = hashIndexSize - 1;
+	for(unsigned i = 0; i < currentIndex; ++i) {
+		unsigned pos = cb_hash(keys[i]) & mask;
+		while(hashIndex[pos] != 0) {
+			pos = (pos + 1) & mask;
+		}
+		hashIndex[pos] = i + 1;
+	}
+
+	return true;
 }
@@ -409,6 +409,62 @@ bool String::concat(long long num, unsigned char base, unsigned char width, char
 	return concat(buf, strlen(buf));
 }
 
+String::Part::Part(long num) : local(true)
+{
+	ltoa_wp(num, buffer, DEC, 0, '0');
+	length = strlen(buffer);
+}
+
+String::Part::Part(unsigned long num) : local(true)
+{
+	ultoa_wp(num, buffer, DEC, 0, '0');
+	length = strlen(buffer);
+}
+
+String::Part::Part(long long num) : local(true)
+{
+	lltoa_wp(num, buffer, DEC, 0, '0');
+	length = strlen(buffer);
+}
+
+String::Part::Part(unsigned long long num) : local(true)
+{
+	ulltoa_wp(num, buffer, DEC, 0, '0');
+	length = strlen(buffer);
+}
+
+bool String::concatParts(const Part* parts, size_t count)
+{
+	auto len = length();
+	size_t total = len;
+	for(unsigned i = 0; i < count; ++i) {
+		total += parts[i].getLength();
+	}
+	if(total == len) {
+		return true;
+	}
+
+	// Parts may refer to our own content, which doesn't move relative to the buffer start
+	const char* oldBuffer = cbuffer();
+	if(!reserve(total)) {
+		return false;
+	}
+	auto buf = buffer();
+	auto dest = buf + len;
+	for(unsigned i = 0; i < count; ++i) {
+		auto& part = parts[i];
+		auto data = part.getData();
+		if(!part.isFlash() && oldBuffer != nullptr && data >= oldBuffer && data < oldBuffer + len) {
+			memcpy(dest, buf + (data - oldBuffer), part.getLength());
+		} else {
+			part.copy(dest);
+		}
+		dest += part.getLength();
+	}
+	setlen(total);
+	return true;
+}
+
 bool String::concat(unsigned long num, unsigned char base, unsigned char width, char pad)
 {
 	char buf[8 + 3 * sizeof(num)];
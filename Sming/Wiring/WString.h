@@ -349,6 +349,87 @@ public:
 	}
 	/** @} */
 
+	/**
+	 * @brief Value which may be passed to `concatAll()`
+	 *
+	 * Integers are converted to text on construction, everything else is referenced directly.
+	 */
+	class Part
+	{
+	public:
+		Part(const String& str) : data(str.cbuffer()), length(str.length())
+		{
+		}
+		Part(const char* cstr) : data(cstr), length(cstr ? strlen(cstr) : 0)
+		{
+		}
+		Part(const FlashString& fstr) : fstr(&fstr), length(fstr.length())
+		{
+		}
+		Part(char c) : length(1), local(true)
+		{
+			buffer[0] = c;
+		}
+		Part(int num) : Part(long(num))
+		{
+		}
+		Part(unsigned int num) : Part((unsigned long)(num))
+		{
+		}
+		Part(long num);
+		Part(unsigned long num);
+		Part(long long num);
+		Part(unsigned long long num);
+
+		size_t getLength() const
+		{
+			return length;
+		}
+
+		const char* getData() const
+		{
+			return local ? buffer : data;
+		}
+
+		void copy(char* dest) const
+		{
+			if(fstr != nullptr) {
+				fstr->read(0, dest, length);
+			} else {
+				memcpy(dest, getData(), length);
+			}
+		}
+
+		bool isFlash() const
+		{
+			return fstr != nullptr;
+		}
+
+	private:
+		const char* data{nullptr};
+		const FlashString* fstr{nullptr};
+		size_t length;
+		bool local{false};
+		char buffer[8 + 3 * sizeof(long long)];
+	};
+
+	/**
+	 * @brief Append several values, allocating memory only once
+	 * @retval bool true on success, false if memory allocation failed (string is unchanged)
+	 *
+	 * The total length is calculated before any content is copied:
+	 *
+	 * ```
+	 * line.concatAll(F("HTTP/1.1 "), unsigned(code), ' ', toString(code), "\r\n");
+	 * ```
+	 */
+	template <typename... Args> bool concatAll(const Args&... args)
+	{
+		static_assert(sizeof...(args) != 0, "concatAll requires arguments");
+		const Part parts[]{Part(args)...};
+		return concatParts(parts, sizeof...(args));
+	}
+
 	/**
      * @name Concatenation operators
      *
@@ -806,6 +887,9 @@ public:
 	/// Max chars. (excluding NUL terminator) we can store in SSO mode
 	static constexpr size_t SSO_CAPACITY = STRING_OBJECT_SIZE - 2;
 
+private:
+	bool concatParts(const Part* parts, size_t count);
+
 protected:
 	/// Used when contents allocated on heap
 	struct PtrBuf {
@@ -24,8 +24,23 @@
 #include <iterator>
 #include "WiringList.h"
 
+/**
+ * @brief Minimum capacity growth, as a percentage of current capacity
+ *
+ * When a Vector runs out of space its capacity grows by the larger of this and its `capacityIncrement`.
+ * Geometric growth keeps the number of re-allocations low as lists get larger.
+ * Set to 0 to grow only by the fixed increment.
+ */
+#ifndef VECTOR_GROWTH_PERCENT
+#define VECTOR_GROWTH_PERCENT 50
+#endif
+
 /**
  * @brief Vector class template
+ *
+ * Objects are each allocated separately and the vector holds pointers to them,
+ * so growing a vector never copies or moves existing elements.
+ *
  * @ingroup wiring
  */
 template <typename Element> class Vector : public Countable<Element>
@@ -103,6 +118,11 @@ public:
 		unsigned index{0};
 	};
 
+	/**
+	 * @brief Constructor
+	 * @param initialCapacity
+	 * @param capacityIncrement Minimum number of entries to add when growing, see VECTOR_GROWTH_PERCENT
+	 */
 	Vector(unsigned int initialCapacity = 10, unsigned int capacityIncrement = 10) : _increment(capacityIncrement)
 	{
 		_data.allocate(initialCapacity);
@@ -113,7 +133,12 @@ public:
 		copyFrom(rhv);
 	}
 
-	Vector(Vector&&) = delete;
+	Vector(Vector&& other) noexcept
+	{
+		std::swap(_data, other._data);
+		std::swap(_size, other._size);
+		std::swap(_increment, other._increment);
+	}
 
 	~Vector()
 	{
@@ -174,7 +199,13 @@ public:
 		return addElement(obj);
 	}
 
+	bool add(Element&& obj)
+	{
+		return addElement(std::move(obj));
+	}
+
 	bool addElement(const Element& obj);
+	bool addElement(Element&& obj);
 	bool addElement(Element* objp);
 
 	void clear()
@@ -223,6 +254,7 @@ public:
 	}
 
 	bool insertElementAt(const Element& obj, unsigned int index);
+	bool insertElementAt(Element&& obj, unsigned int index);
 
 	bool remove(unsigned int index)
 	{
@@ -367,6 +399,15 @@ template <class Element> bool Vector<Element>::addElement(const Element& obj)
 	return true;
 }
 
+template <class Element> bool Vector<Element>::addElement(Element&& obj)
+{
+	if(!ensureCapacity(_size + 1)) {
+		return false;
+	}
+	_data[_size++] = std::move(obj);
+	return true;
+}
+
 template <class Element> bool Vector<Element>::addElement(Element* objp)
 {
 	if(!ensureCapacity(_size + 1)) {
@@ -382,7 +423,8 @@ template <class Element> bool Vector<Element>::ensureCapacity(unsigned int minCa
 		return true;
 	}
 
-	auto newCapacity = std::max(minCapacity, _data.size + _increment);
+	auto growth = std::max(size_t(_increment), _data.size * VECTOR_GROWTH_PERCENT / 100);
+	auto newCapacity = std::max(size_t(minCapacity), _data.size + growth);
 	return _data.allocate(newCapacity);
 }
 
@@ -407,6 +449,27 @@ template <class Element> bool Vector<Element>::insertElementAt(const Element& ob
 	return true;
 }
 
+template <class Element> bool Vector<Element>::insertElementAt(Element&& obj, unsigned int index)
+{
+	if(index == _size) {
+		return addElement(std::move(obj));
+	}
+
+	if(index > _size) {
+		return false;
+	}
+	if(!ensureCapacity(_size + 1)) {
+		return false;
+	}
+
+	if(!_data.insert(index, std::move(obj))) {
+		return false;
+	}
+
+	_size++;
+	return true;
+}
+
 template <class Element> bool Vector<Element>::removeElementAt(unsigned int index)
 {
 	// check for valid index
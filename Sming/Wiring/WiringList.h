@@ -44,7 +44,7 @@ template <typename T> struct ScalarList {
 
 	bool insert(unsigned index, T value)
 	{
-		memmove(&values[index + 1], &values[index], size - index - 1);
+		memmove(&values[index + 1], &values[index], (size - index - 1) * sizeof(T));
 		values[index] = value;
 		return true;
 	}
@@ -102,6 +102,13 @@ template <typename T> struct ObjectList : public ScalarList<T*> {
 			return *this;
 		}
 
+		Element& operator=(T&& v)
+		{
+			delete value;
+			value = new T{std::move(v)};
+			return *this;
+		}
+
 		operator T&()
 		{
 			return *value;
@@ -138,6 +145,15 @@ template <typename T> struct ObjectList : public ScalarList<T*> {
 		return ScalarList<T*>::insert(index, el);
 	}
 
+	bool insert(unsigned index, T&& value)
+	{
+		auto el = new T(std::move(value));
+		if(el == nullptr) {
+			return false;
+		}
+		return ScalarList<T*>::insert(index, el);
+	}
+
 	void remove(unsigned index)
 	{
 		delete this->values[index];
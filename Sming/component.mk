@@ -3,7 +3,9 @@ COMPONENT_SRCDIRS := \
 	Platform \
 	System \
 	Wiring \
-	Services/HexDump
+	Services/BinaryLog \
+	Services/HexDump \
+	Services/Profiling
 
 COMPONENT_INCDIRS := \
 	Components \
@@ -75,6 +77,16 @@ CONFIG_VARS				+= DEBUG_VERBOSE_LEVEL
 DEBUG_VERBOSE_LEVEL		?= 2
 GLOBAL_CFLAGS			+= -DDEBUG_VERBOSE_LEVEL=$(DEBUG_VERBOSE_LEVEL)
 
+# Write debug_* output from C++ code as binary records, decoded with `make binlog-decode`
+CONFIG_VARS				+= DEBUG_BINARY_LOG
+DEBUG_BINARY_LOG		?= 0
+GLOBAL_CFLAGS			+= -DDEBUG_BINARY_LOG=$(DEBUG_BINARY_LOG)
+
+# Buffer for binary log records awaiting output
+COMPONENT_VARS			+= BINARY_LOG_BUFSIZE
+BINARY_LOG_BUFSIZE		?= 2048
+COMPONENT_CXXFLAGS		+= -DBINARY_LOG_BUFSIZE=$(BINARY_LOG_BUFSIZE)
+
 CONFIG_VARS			+= ENABLE_GDB
 ifeq ($(ENABLE_GDB), 1)
 	GLOBAL_CFLAGS	+= -ggdb -DENABLE_GDB=1
@@ -97,16 +109,51 @@ ifeq ($(ENABLE_TASK_COUNT),1)
 	GLOBAL_CFLAGS	+= -DENABLE_TASK_COUNT=1
 endif
 
+# Defer subsystem initialisation (e.g. partition table) until first use
+COMPONENT_VARS		+= ENABLE_FAST_BOOT
+ifeq ($(ENABLE_FAST_BOOT),1)
+	GLOBAL_CFLAGS	+= -DENABLE_FAST_BOOT=1
+endif
+
 # Task queue length
 COMPONENT_VARS		+= TASK_QUEUE_LENGTH
 TASK_QUEUE_LENGTH	?= 10
 COMPONENT_CXXFLAGS	+= -DTASK_QUEUE_LENGTH=$(TASK_QUEUE_LENGTH)
 
+# Record task queue statistics, includes latency
+COMPONENT_VARS		+= ENABLE_TASK_STATS
+ifeq ($(ENABLE_TASK_STATS),1)
+	COMPONENT_CXXFLAGS	+= -DENABLE_TASK_STATS=1
+endif
+
+# Record time callbacks spend in task queue
+COMPONENT_VARS		+= ENABLE_TASK_LATENCY
+ifeq ($(ENABLE_TASK_LATENCY),1)
+	COMPONENT_CXXFLAGS	+= -DENABLE_TASK_LATENCY=1
+endif
+
+# Named metrics registry for export to monitoring systems
+COMPONENT_VARS		+= ENABLE_METRICS
+ifeq ($(ENABLE_METRICS),1)
+	GLOBAL_CFLAGS	+= -DENABLE_METRICS=1
+endif
+
+# Measure longest period with interrupts disabled
+COMPONENT_VARS		+= ENABLE_IRQ_LATENCY
+ifeq ($(ENABLE_IRQ_LATENCY),1)
+	GLOBAL_CFLAGS	+= -DENABLE_IRQ_LATENCY=1
+endif
+
 # Size of a String object - change this to increase space for Small String Optimisation (SSO)
 COMPONENT_VARS		+= STRING_OBJECT_SIZE
 STRING_OBJECT_SIZE	?= 12
 GLOBAL_CFLAGS		+= -DSTRING_OBJECT_SIZE=$(STRING_OBJECT_SIZE) 
 
+# Geometric growth for Vector capacity
+COMPONENT_VARS		+= VECTOR_GROWTH_PERCENT
+VECTOR_GROWTH_PERCENT ?= 50
+GLOBAL_CFLAGS		+= -DVECTOR_GROWTH_PERCENT=$(VECTOR_GROWTH_PERCENT)
+
 ##@Flashing
 
 .PHONY: flashinit
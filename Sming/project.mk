@@ -541,6 +541,10 @@ decode-stacktrace: ##Open the stack trace decoder ready to paste dump text. Alte
 	fi
 	$(Q) $(PYTHON) $(ARCH_TOOLS)/decode-stacktrace.py $(TARGET_OUT_0) $(TRACE)
 
+.PHONY: binlog-decode
+binlog-decode: ##Decode output from DEBUG_BINARY_LOG=1 builds, read from stdin or use `make binlog-decode LOG=/path/to/capture.log`
+	$(Q) $(PYTHON) $(SMING_TOOLS)/binlog-decode.py $(TARGET_OUT_0) $(LOG)
+
 
 CACHE_VARS += PIP_ARGS
 PIP_ARGS ?=
@@ -0,0 +1,159 @@
+#!/usr/bin/env python
+#
+# Binary log decoder
+#
+# Converts output written with DEBUG_BINARY_LOG=1 into text, reading format strings
+# from the application ELF file. Any other output is passed through unchanged.
+#
+# See Sming/Services/BinaryLog/BinaryLog.h for a description of the record format.
+#
+# Usage: binlog-decode.py <file.elf> [<captured.log>]
+#
+# If no log file is given, reads from stdin so output can be piped through directly.
+#
+
+import re
+import struct
+import sys
+
+BINARY_LOG_MAGIC = 0xb1
+
+SHF_ALLOC = 0x02
+SHT_NOBITS = 8
+
+conversion = re.compile(r'%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d+))?(hh|h|ll|l|L|z|j|t)?([diouxXcsfFeEgGp%])')
+
+
+class Elf:
+    """Minimal ELF reader to fetch strings by address."""
+
+    def __init__(self, filename):
+        with open(filename, 'rb') as f:
+            self.data = f.read()
+        if self.data[:4] != b'\x7fELF':
+            raise ValueError("%s is not an ELF file" % filename)
+        is64 = self.data[4] == 2
+        endian = '<' if self.data[5] == 1 else '>'
+        if is64:
+            shoff, = struct.unpack_from(endian + 'Q', self.data, 0x28)
+            shentsize, shnum = struct.unpack_from(endian + 'HH', self.data, 0x3a)
+            fmt = endian + 'IIQQQQ'
+        else:
+            shoff, = struct.unpack_from(endian + 'I', self.data, 0x20)
+            shentsize, shnum = struct.unpack_from(endian + 'HH', self.data, 0x2e)
+            fmt = endian + 'IIIIII'
+        self.sections = []
+        for i in range(shnum):
+            _, sh_type, flags, addr, offset, size = struct.unpack_from(fmt, self.data, shoff + i * shentsize)
+            if (flags & SHF_ALLOC) and sh_type != SHT_NOBITS and size != 0:
+                self.sections.append((addr, offset, size))
+
+    def getString(self, addr):
+        for start, offset, size in self.sections:
+            if start <= addr < start + size:
+                pos = offset + addr - start
+                end = self.data.index(b'\0', pos, offset + size)
+                return self.data[pos:end].decode('utf-8', 'replace')
+        return None
+
+
+class Args:
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def read(self, fmt):
+        size = struct.calcsize(fmt)
+        if self.pos + size > len(self.data):
+            raise ValueError("truncated")
+        value, = struct.unpack_from(fmt, self.data, self.pos)
+        self.pos += size
+        return value
+
+    def readString(self):
+        n = self.read('<B')
+        s = self.data[self.pos:self.pos + n]
+        self.pos += n
+        return s.decode('utf-8', 'replace')
+
+
+def format(fmt, args):
+    def convert(m):
+        flags, width, precision, length, conv = m.groups()
+        if conv == '%':
+            return '%'
+        if width == '*':
+            width = str(args.read('<i'))
+        if precision == '*':
+            precision = str(args.read('<i'))
+        spec = '%' + flags + (width or '') + ('.' + precision if precision is not None else '')
+        wide = length in ('ll', 'L', 'j')
+        if conv in 'fFeEgG':
+            return (spec + conv) % args.read('<d')
+        if conv == 's':
+            return (spec + 's') % args.readString()
+        if conv == 'p':
+            return '0x%08x' % args.read('<I')
+        if conv in 'di':
+            return (spec + 'd') % args.read('<q' if wide else '<i')
+        if conv == 'c':
+            return (spec + 'c') % chr(args.read('<I') & 0xff)
+        if conv == 'u':
+            conv = 'd'
+        return (spec + conv) % args.read('<Q' if wide else '<I')
+
+    return conversion.sub(convert, fmt)
+
+
+def decodeRecord(elf, record):
+    timestamp, addr = struct.unpack_from('<II', record)
+    args = Args(record[8:])
+    if addr == 0:
+        return "%u [%u records dropped]" % (timestamp, args.read('<I'))
+    fmt = elf.getString(addr)
+    if fmt is None:
+        return "%u [unknown format 0x%08x]" % (timestamp, addr)
+    try:
+        return "%u %s" % (timestamp, format(fmt, args).rstrip('\r\n'))
+    except (ValueError, TypeError):
+        return "%u [bad arguments] %s" % (timestamp, fmt.rstrip('\r\n'))
+
+
+def decode(elf, stream, out):
+    buf = b''
+    while True:
+        data = stream.read(1)
+        if not data:
+            break
+        buf += data
+        while buf:
+            pos = buf.find(bytes([BINARY_LOG_MAGIC]))
+            if pos != 0:
+                # Pass through anything which isn't a record
+                text = buf if pos < 0 else buf[:pos]
+                out.write(text.decode('utf-8', 'replace'))
+                out.flush()
+                buf = buf[len(text):]
+                continue
+            if len(buf) < 2 or len(buf) < 2 + buf[1]:
+                break
+            length = buf[1]
+            record = buf[2:2 + length]
+            buf = buf[2 + length:]
+            if length < 8:
+                continue
+            out.write(decodeRecord(elf, record) + '\n')
+            out.flush()
+
+
+if __name__ == "__main__":
+    if len(sys.argv) not in (2, 3):
+        print("Usage: \n\t%s <file.elf> [<captured.log>]" % sys.argv[0])
+        sys.exit(1)
+
+    elf = Elf(sys.argv[1])
+    if len(sys.argv) == 3:
+        with open(sys.argv[2], 'rb') as f:
+            decode(elf, f, sys.stdout)
+    else:
+        decode(elf, sys.stdin.buffer, sys.stdout)
@@ -0,0 +1,73 @@
+#!/usr/bin/env python3
+#
+# Section index generator
+#
+# Scans a template for sections in the same way as SectionStream, and writes an index
+# which can be passed to the SectionStream or SectionTemplate constructor so the template
+# need not be scanned at runtime. Typically the index is imported alongside the template:
+#
+#   IMPORT_FSTR(page_html, PROJECT_DIR "/web/page.html")
+#   IMPORT_FSTR(page_index, PROJECT_DIR "/out/page.idx")
+#
+# See Sming/Core/Data/Stream/SectionStream.cpp for the index layout.
+#
+# Usage: section-index.py [--start-tag TAG] [--end-tag TAG] <template> <index>
+#
+
+import argparse
+import re
+import struct
+import sys
+
+INDEX_MAGIC = 0x58444953  # "SIDX"
+SECTION_NAME_MAX = 31
+
+
+def scan(data, start_tag, end_tag):
+    prefix, tag_end = re.escape(start_tag[:-1]), re.escape(start_tag[-1:])
+    expr = prefix + rb'(?::([^' + tag_end + rb']{0,%u}))?' % SECTION_NAME_MAX + tag_end
+    start_expr = re.compile(expr)
+    sections = []
+    offset = 0
+    while True:
+        m = start_expr.search(data, offset)
+        if not m:
+            break
+        start = m.end()
+        end = data.find(end_tag, start)
+        if end < 0:
+            break
+        sections.append((start, end - start, m.group(1) or b''))
+        offset = end + len(end_tag)
+    if not sections:
+        sections.append((0, len(data), b''))
+    return sections
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Create SectionStream index for a template')
+    parser.add_argument('--start-tag', default='{SECTION}', help='Marks start of section')
+    parser.add_argument('--end-tag', default='{/SECTION}', help='Marks end of section')
+    parser.add_argument('template', help='Template file to scan')
+    parser.add_argument('index', help='Index file to create')
+    args = parser.parse_args()
+
+    with open(args.template, 'rb') as f:
+        data = f.read()
+
+    sections = scan(data, args.start_tag.encode(), args.end_tag.encode())
+    if len(sections) > 255:
+        sys.exit("Too many sections in '%s'" % args.template)
+
+    index = struct.pack('<IIB3x', INDEX_MAGIC, len(data), len(sections))
+    for start, size, name in sections:
+        index += struct.pack('<IIB', start, size, len(name)) + name
+
+    with open(args.index, 'wb') as f:
+        f.write(index)
+
+    print("%s: %u sections" % (args.template, len(sections)))
+
+
+if __name__ == '__main__':
+    main()
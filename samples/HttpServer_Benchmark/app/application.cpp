@@ -0,0 +1,214 @@
+#include <SmingCore.h>
+#include <Network/Http/Websocket/WebsocketResource.h>
+#include <Network/Http/HttpMetricsResource.h>
+#include <FlashString/Stream.hpp>
+#include <FlashString/TemplateStream.hpp>
+#include <JsonObjectStream.h>
+#include <algorithm>
+
+// If you want, you can define WiFi settings globally in Eclipse Environment Variables
+#ifndef WIFI_SSID
+#define WIFI_SSID "PleaseEnterSSID" // Put your SSID and password here
+#define WIFI_PWD "PleaseEnterPass"
+#endif
+
+namespace
+{
+DEFINE_FSTR_LOCAL(staticPage, "<!DOCTYPE html><html><head><title>Sming benchmark</title></head><body>"
+							  "<h1>Static page</h1><p>This page is served directly from flash memory. "
+							  "It measures the cost of request parsing and response handling with "
+							  "minimal application work.</p></body></html>")
+
+DEFINE_FSTR_LOCAL(templatePage, "<!DOCTYPE html><html><head><title>{title}</title></head><body>"
+								"<h1>{title}</h1><p>Uptime {uptime} seconds, request #{count}.</p>"
+								"<p>Free heap {heap} bytes.</p></body></html>")
+
+constexpr unsigned statsIntervalMs{5000};
+
+HttpServer server;
+Timer statsTimer;
+
+/*
+ * Time spent in request handlers.
+ *
+ * This measures application processing only: end-to-end latency,
+ * including network and connection handling, is reported by the load generator.
+ * Where metrics are enabled, total request time is also available as a histogram via /metrics.
+ */
+class LatencyStats
+{
+public:
+	static constexpr unsigned sampleCount{256};
+
+	void add(uint32_t us)
+	{
+		samples[index] = us;
+		index = (index + 1) % sampleCount;
+		if(count < sampleCount) {
+			++count;
+		}
+	}
+
+	/**
+	 * @brief Get a percentile value from the most recent samples
+	 * @param pct 0 - 100
+	 */
+	uint32_t percentile(unsigned pct) const
+	{
+		if(count == 0) {
+			return 0;
+		}
+		uint32_t sorted[sampleCount];
+		std::copy_n(samples, count, sorted);
+		auto pos = std::min(count - 1, (count * pct) / 100);
+		std::nth_element(sorted, sorted + pos, sorted + count);
+		return sorted[pos];
+	}
+
+private:
+	uint32_t samples[sampleCount]{};
+	unsigned count{0};
+	unsigned index{0};
+};
+
+struct Stats {
+	LatencyStats latency;
+	uint32_t requests{0};
+	uint32_t lastRequests{0};
+	uint32_t requestsPerSec{0};
+	uint32_t wsMessages{0};
+	uint32_t minFreeHeap{UINT32_MAX};
+
+	void update()
+	{
+		minFreeHeap = std::min(minFreeHeap, system_get_free_heap_size());
+	}
+};
+
+Stats stats;
+
+/*
+ * Wraps a handler to record statistics
+ */
+class Measure
+{
+public:
+	Measure()
+	{
+		++stats.requests;
+	}
+
+	~Measure()
+	{
+		stats.latency.add(timer.elapsedTime());
+		stats.update();
+	}
+
+private:
+	ElapseTimer timer;
+};
+
+void onStatic(HttpRequest&, HttpResponse& response)
+{
+	Measure measure;
+	response.sendDataStream(new FSTR::Stream(staticPage), MIME_HTML);
+}
+
+void onTemplate(HttpRequest&, HttpResponse& response)
+{
+	Measure measure;
+	auto tmpl = new FSTR::TemplateStream(templatePage);
+	tmpl->setVar(F("title"), F("Template page"));
+	tmpl->setVar(F("uptime"), String(millis() / 1000));
+	tmpl->setVar(F("count"), String(stats.requests));
+	tmpl->setVar(F("heap"), String(system_get_free_heap_size()));
+	response.sendDataStream(tmpl, MIME_HTML);
+}
+
+void onJson(HttpRequest&, HttpResponse& response)
+{
+	Measure measure;
+	auto stream = new JsonObjectStream;
+	JsonObject json = stream->getRoot();
+	json["uptime"] = millis() / 1000;
+	json["requests"] = stats.requests;
+	JsonArray values = json.createNestedArray("values");
+	for(unsigned i = 0; i < 16; ++i) {
+		values.add(i * stats.requests);
+	}
+	response.sendDataStream(stream, MIME_JSON);
+}
+
+void onStats(HttpRequest&, HttpResponse& response)
+{
+	auto stream = new JsonObjectStream;
+	JsonObject json = stream->getRoot();
+	json["requests"] = stats.requests;
+	json["requests_per_sec"] = stats.requestsPerSec;
+	json["ws_messages"] = stats.wsMessages;
+	json["p50_us"] = stats.latency.percentile(50);
+	json["p99_us"] = stats.latency.percentile(99);
+	json["free_heap"] = system_get_free_heap_size();
+	json["min_free_heap"] = stats.minFreeHeap;
+	response.sendDataStream(stream, MIME_JSON);
+}
+
+void wsMessageReceived(WebsocketConnection& socket, const String& message)
+{
+	++stats.wsMessages;
+	stats.update();
+	socket.sendString(message);
+}
+
+void printStats()
+{
+	stats.requestsPerSec = (stats.requests - stats.lastRequests) * 1000 / statsIntervalMs;
+	stats.lastRequests = stats.requests;
+	stats.update();
+
+	Serial << _F("requests ") << stats.requests << _F(", ") << stats.requestsPerSec << _F("/s, p50 ")
+		   << stats.latency.percentile(50) << _F("us, p99 ") << stats.latency.percentile(99) << _F("us, ws ")
+		   << stats.wsMessages << _F(", heap ") << system_get_free_heap_size() << _F(", min ") << stats.minFreeHeap
+		   << endl;
+}
+
+void startWebServer()
+{
+	server.listen(SERVER_PORT);
+	server.paths.set("/", onStatic);
+	server.paths.set("/static", onStatic);
+	server.paths.set("/template", onTemplate);
+	server.paths.set("/json", onJson);
+	server.paths.set("/stats", onStats);
+	server.paths.set("/metrics", new HttpMetricsResource);
+
+	auto wsResource = new WebsocketResource();
+	wsResource->setMessageHandler(wsMessageReceived);
+	server.paths.set("/ws", wsResource);
+
+	statsTimer.initializeMs<statsIntervalMs>(printStats).start();
+
+	Serial.println(_F("\r\n"
+					  "=== BENCHMARK SERVER STARTED ==="));
+	Serial.println(WifiStation.getIP());
+	Serial.println(_F("================================\r\n"));
+}
+
+void gotIP(IpAddress ip, IpAddress netmask, IpAddress gateway)
+{
+	startWebServer();
+}
+
+} // namespace
+
+void init()
+{
+	Serial.begin(SERIAL_BAUD_RATE); // 115200 by default
+	Serial.systemDebugOutput(false);
+
+	WifiStation.enable(true);
+	WifiStation.config(F(WIFI_SSID), F(WIFI_PWD));
+	WifiAccessPoint.enable(false);
+
+	WifiEvents.onStationGotIP(gotIP);
+}
@@ -0,0 +1,9 @@
+ARDUINO_LIBRARIES := ArduinoJson6
+
+# Serve Prometheus metrics, including full request duration histogram, at /metrics
+ENABLE_METRICS ?= 1
+
+# Port to listen on
+CONFIG_VARS += SERVER_PORT
+SERVER_PORT ?= 80
+APP_CFLAGS += -DSERVER_PORT=$(SERVER_PORT)
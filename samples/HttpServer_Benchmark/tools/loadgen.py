@@ -0,0 +1,136 @@
+#!/usr/bin/env python3
+#
+# Load generator for the HttpServer_Benchmark sample
+#
+# Runs a number of concurrent clients against one endpoint for a fixed time,
+# then reports throughput and end-to-end latency percentiles.
+#
+# WebSocket tests require the `websockets` package.
+#
+
+import argparse
+import http.client
+import json
+import threading
+import time
+from urllib.parse import urlparse
+
+ENDPOINTS = ['/static', '/template', '/json']
+
+
+class Result:
+    def __init__(self):
+        self.latencies = []
+        self.errors = 0
+        self.lock = threading.Lock()
+
+    def add(self, latency):
+        with self.lock:
+            self.latencies.append(latency)
+
+    def error(self):
+        with self.lock:
+            self.errors += 1
+
+
+def percentile(values, pct):
+    if not values:
+        return 0
+    values = sorted(values)
+    pos = min(len(values) - 1, len(values) * pct // 100)
+    return values[pos]
+
+
+def http_client(host, port, path, keepalive, deadline, result):
+    conn = None
+    while time.time() < deadline:
+        try:
+            if conn is None:
+                conn = http.client.HTTPConnection(host, port, timeout=10)
+            start = time.perf_counter()
+            headers = {} if keepalive else {'Connection': 'close'}
+            conn.request('GET', path, headers=headers)
+            rsp = conn.getresponse()
+            rsp.read()
+            if rsp.status != 200:
+                result.error()
+                continue
+            result.add(time.perf_counter() - start)
+            if not keepalive or rsp.getheader('Connection', '').lower() == 'close':
+                conn.close()
+                conn = None
+        except (OSError, http.client.HTTPException):
+            result.error()
+            if conn:
+                conn.close()
+            conn = None
+    if conn:
+        conn.close()
+
+
+def ws_client(host, port, deadline, result):
+    from websockets.sync.client import connect
+    message = 'x' * 64
+    try:
+        with connect(f'ws://{host}:{port}/ws') as ws:
+            while time.time() < deadline:
+                start = time.perf_counter()
+                ws.send(message)
+                ws.recv()
+                result.add(time.perf_counter() - start)
+    except Exception:
+        result.error()
+
+
+def run(args, path):
+    result = Result()
+    deadline = time.time() + args.duration
+    if path == '/ws':
+        target, params = ws_client, (args.host, args.port, deadline, result)
+    else:
+        target, params = http_client, (args.host, args.port, path, args.keepalive, deadline, result)
+    threads = [threading.Thread(target=target, args=params) for _ in range(args.clients)]
+    start = time.time()
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    elapsed = time.time() - start
+
+    ms = [x * 1000 for x in result.latencies]
+    print(f'{path:10} {len(ms) / elapsed:8.1f} req/s, '
+          f'p50 {percentile(ms, 50):7.2f}ms, p90 {percentile(ms, 90):7.2f}ms, p99 {percentile(ms, 99):7.2f}ms, '
+          f'{result.errors} errors')
+
+
+def print_server_stats(host, port):
+    try:
+        conn = http.client.HTTPConnection(host, port, timeout=10)
+        conn.request('GET', '/stats')
+        stats = json.loads(conn.getresponse().read())
+        conn.close()
+        print('Server:', ', '.join(f'{k} {v}' for k, v in stats.items()))
+    except (OSError, http.client.HTTPException, ValueError) as e:
+        print('Failed to read server stats:', e)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='HttpServer_Benchmark load generator')
+    parser.add_argument('URL', help='Server address, e.g. http://192.168.13.10')
+    parser.add_argument('--clients', type=int, default=4, help='Concurrent connections')
+    parser.add_argument('--duration', type=float, default=10, help='Seconds to run each test')
+    parser.add_argument('--path', action='append', help='Endpoint to test, may be repeated. Use /ws for WebSocket.')
+    parser.add_argument('--keepalive', action='store_true', help='Re-use connections')
+    args = parser.parse_args()
+
+    url = urlparse(args.URL if '//' in args.URL else 'http://' + args.URL)
+    args.host = url.hostname
+    args.port = url.port or 80
+
+    for path in args.path or ENDPOINTS:
+        run(args, path)
+    print_server_stats(args.host, args.port)
+
+
+if __name__ == "__main__":
+    main()
@@ -1,21 +1,19 @@
-#include <Libraries/WS2812/WS2812.h>
+#include <SmingCore.h>
+#include <Libraries/WS2812/WS2812Uart.h>
 
-#define LED_PIN 2 // GPIO2
+// Output is on GPIO2
 
 namespace
 {
 SimpleTimer procTimer;
+WS2812Uart strip;
 bool state;
 
 void update()
 {
-	if(state) {
-		char buffer2[] = "\x00\x40\x40\x40\x00\x40\x40\x40\x00";
-		ws2812_writergb(LED_PIN, buffer2, sizeof(buffer2));
-	} else {
-		char buffer1[] = "\x40\x00\x00\x00\x40\x00\x00\x00\x40";
-		ws2812_writergb(LED_PIN, buffer1, sizeof(buffer1));
-	}
+	static const uint8_t buffer1[]{0x40, 0x00, 0x00, 0x00, 0x40, 0x00, 0x00, 0x00, 0x40};
+	static const uint8_t buffer2[]{0x00, 0x40, 0x40, 0x40, 0x00, 0x40, 0x40, 0x40, 0x00};
+	strip.show(state ? buffer2 : buffer1, sizeof(buffer1));
 	state = !state;
 }
 
@@ -23,5 +21,6 @@ void update()
 
 void init()
 {
+	strip.begin(3);
 	procTimer.initializeMs<500>(update).start();
 }
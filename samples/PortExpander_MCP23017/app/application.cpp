@@ -4,17 +4,13 @@
 namespace
 {
 MCP23017 mcp;
-volatile bool awakenByInterrupt;
 byte mcpPinA = 0;
 byte interruptPin = 15;
 
-void interruptDelegate()
+void onMcpInterrupt(uint16_t flags, uint16_t captured)
 {
-	awakenByInterrupt = true;
-	Serial.println(_F("Interrupt Called"));
-	while(!mcp.digitalRead(mcpPinA)) {
-		//
-	}
+	Serial << _F("Interrupt Called, pins 0x") << String(flags, HEX) << _F(", values 0x") << String(captured, HEX)
+		   << endl;
 }
 
 } // namespace
@@ -28,12 +24,15 @@ void init()
 
 	mcp.begin(0); // 0 - for default mcp address, possible values: 0..7
 
+	// Changes are written together on commit()
+	mcp.beginBatch();
 	mcp.pinMode(8, OUTPUT);
 	mcp.pinMode(9, OUTPUT);
 	mcp.pullUp(8, HIGH);
 	mcp.pullUp(9, HIGH);
 	mcp.digitalWrite(8, LOW);
 	mcp.digitalWrite(9, HIGH);
+	mcp.commit();
 
 	pinMode(interruptPin, INPUT_PULLUP);
 
@@ -41,5 +40,5 @@ void init()
 	mcp.pinMode(mcpPinA, INPUT);
 	mcp.pullUp(mcpPinA, HIGH);
 	mcp.setupInterruptPin(mcpPinA, FALLING);
-	attachInterrupt(interruptPin, InterruptDelegate(interruptDelegate), FALLING);
+	mcp.onInterrupt(interruptPin, onMcpInterrupt, FALLING);
 }
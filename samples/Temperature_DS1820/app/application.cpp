@@ -11,13 +11,14 @@ SimpleTimer procTimer;
 //**********************************************************
 // DS18S20 example, reading
 // You can connect multiple sensors to a single port
-// (At the moment 4 pcs - it depends on the definition in the library)
-// Measuring time: 1.2 seconds * number of sensors
+// (At the moment 4 pcs - change DS18S20_MAX_SENSORS to allow more)
+// Measuring time: under 1 second in parallel mode, otherwise 1.2 seconds * number of sensors
 // The main difference with the previous version of the demo:
 //  - Do not use the Delay function () which is discouraged by the manufacturer of ESP8266
 //  - We can read several sensors
 // Usage:
 //  Call Init to setup pin eg. ReadTemp.Init(2);   //pin 2 selected
+//  Call ReadTemp.SetParallelMode(true) to convert all sensors at once
 //  Call ReadTemp.StartMeasure();
 //   if ReadTemp.MeasureStatus() false read sensors
 //   You can recognize sensors by the ID or index.
@@ -48,7 +49,7 @@ void readData()
 		Serial << _F(" <Sensor id.") << String(ReadTemp.GetSensorID(a), HEX, 32) << '>' << endl;
 	}
 	Serial.println(_F("******************************************"));
-	ReadTemp.StartMeasure(); // next measure, result after 1.2 seconds * number of sensors
+	ReadTemp.StartMeasure(); // next measure
 }
 
 } // namespace
@@ -59,7 +60,8 @@ void init()
 	Serial.systemDebugOutput(true);
 
 	ReadTemp.Init(I2C_PIN);
-	ReadTemp.StartMeasure(); // first measure start,result after 1.2 seconds * number of sensors
+	ReadTemp.SetParallelMode(true);
+	ReadTemp.StartMeasure(); // first measure start
 
 	procTimer.initializeMs<10000>(readData).start();
 }
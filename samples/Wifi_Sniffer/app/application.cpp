@@ -78,12 +78,11 @@ void printSummary()
 
 void onBeacon(const BeaconInfo& beacon)
 {
-	if(knownAPs.indexOf(beacon.bssid) >= 0) {
+	if(!knownAPs.addUnique(beacon)) {
 		// Already listed
 		return;
 	}
 
-	knownAPs.add(beacon);
 	printBeacon(beacon);
 	timer.restart();
 }
@@ -8,6 +8,9 @@ endif
 
 DEBUG_VERBOSE_LEVEL = 2
 
+# Build with instrumentation so it gets exercised
+ENABLE_METRICS = 1
+
 COMPONENT_INCDIRS := include
 COMPONENT_SRCDIRS := \
 	app \
@@ -17,7 +20,8 @@ COMPONENT_SRCDIRS := \
 ARDUINO_LIBRARIES := \
 	SmingTest \
 	ArduinoJson5 \
-	ArduinoJson6
+	ArduinoJson6 \
+	ArchiveFS
 
 ifeq ($(SMING_ARCH),Host)
 	ARDUINO_LIBRARIES += Hosted
@@ -45,6 +49,11 @@ CONFIG_VARS += TEST_GROUP_INTERVAL
 TEST_GROUP_INTERVAL ?= 500
 APP_CFLAGS += -DTEST_GROUP_INTERVAL=$(TEST_GROUP_INTERVAL)
 
+# Number of calls per benchmark round
+CONFIG_VARS += BENCHMARK_ITERATIONS
+BENCHMARK_ITERATIONS ?= 1000
+APP_CFLAGS += -DBENCHMARK_ITERATIONS=$(BENCHMARK_ITERATIONS)
+
 # Time in milliseconds to wait before re-starting all tests
 # Set to 0 to perform a system restart after all tests have completed
 CONFIG_VARS += RESTART_DELAY
@@ -65,7 +74,12 @@ CUSTOM_TARGETS += $(SPIFFSGEN_BIN)
 $(SPIFFSGEN_BIN):
 	$(Q) $(SPIFFSGEN_SMING) 0x10000 spiffsgen/build $@
 
+ARCHIVEFS_BIN := out/archivefs_test.bin
+CUSTOM_TARGETS += $(ARCHIVEFS_BIN)
+$(ARCHIVEFS_BIN):
+	$(Q) $(ARCHIVEFS_GEN) --compress resource $@
+
 clean: resource-clean
 .PHONY: resource-clean
 resource-clean:
-	$(Q) rm -f $(SPIFFSGEN_BIN)
+	$(Q) rm -f $(SPIFFSGEN_BIN) $(ARCHIVEFS_BIN)
@@ -0,0 +1,83 @@
+/*
+ * Benchmark support
+ *
+ * Each benchmark runs a function repeatedly and reports time and heap activity per call.
+ * The fastest of several rounds is reported to reduce noise from interrupts and host scheduling.
+ * Each round must complete within one cycle counter period (about 26 seconds at 160MHz).
+ *
+ * Output lines have a fixed format so results may be extracted from test logs and compared
+ * between builds:
+ *
+ * 	BENCH <name>: <iterations> iterations, <ns>/op, <allocs>/op, <bytes>/op
+ *
+ * Allocation figures are multiplied by 1000 where fractional (`m` suffix).
+ */
+
+#pragma once
+
+#include <SmingTest.h>
+#include <Platform/Clocks.h>
+#include <malloc_count.h>
+
+#ifndef BENCHMARK_ITERATIONS
+#define BENCHMARK_ITERATIONS 1000
+#endif
+
+namespace Benchmark
+{
+using Clock = CpuCycleClockNormal;
+
+constexpr unsigned rounds{3};
+
+struct Result {
+	uint32_t nsPerOp;
+	uint32_t allocsPerOp; ///< x1000
+	uint32_t bytesPerOp;
+};
+
+inline void print(const String& name, unsigned iterations, const Result& result)
+{
+	Serial << _F("BENCH ") << name << ": " << iterations << _F(" iterations, ") << result.nsPerOp << _F(" ns/op, ")
+		   << result.allocsPerOp << _F("m allocs/op, ") << result.bytesPerOp << _F(" bytes/op") << endl;
+}
+
+/**
+ * @brief Measure a function
+ * @param name Identifies result in output
+ * @param iterations Calls per round. Defaults to BENCHMARK_ITERATIONS.
+ * @param func Operation to measure
+ */
+template <typename F> Result run(const String& name, unsigned iterations, F func)
+{
+	// Warm-up call so one-time allocations and cache loads don't skew the first round
+	func();
+
+	Result best{UINT32_MAX, 0, 0};
+	for(unsigned round = 0; round < rounds; ++round) {
+		auto allocCount = MallocCount::getAllocCount();
+		auto allocTotal = MallocCount::getTotal();
+		auto startTicks = Clock::ticks();
+		for(unsigned i = 0; i < iterations; ++i) {
+			func();
+		}
+		uint32_t elapsedTicks = Clock::ticks() - startTicks;
+		uint32_t ns = 1000000000ULL * elapsedTicks / Clock::frequency() / iterations;
+		if(ns < best.nsPerOp) {
+			best.nsPerOp = ns;
+			best.allocsPerOp = 1000ULL * (MallocCount::getAllocCount() - allocCount) / iterations;
+			best.bytesPerOp = (MallocCount::getTotal() - allocTotal) / iterations;
+		}
+		// Don't starve the watchdog on long runs
+		system_soft_wdt_feed();
+	}
+
+	print(name, iterations, best);
+	return best;
+}
+
+template <typename F> Result run(const String& name, F func)
+{
+	return run(name, BENCHMARK_ITERATIONS, func);
+}
+
+} // namespace Benchmark
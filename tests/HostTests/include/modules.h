@@ -24,8 +24,10 @@
 	XX(BitSet)                                                                                                         \
 	XX(String)                                                                                                         \
 	XX(ArduinoString)                                                                                                  \
+	XX(Delegate)                                                                                                       \
 	XX(Wiring)                                                                                                         \
 	XX_NET(Crypto)                                                                                                     \
+	XX(Crc)                                                                                                            \
 	XX(CStringArray)                                                                                                   \
 	XX(Stream)                                                                                                         \
 	XX(TemplateStream)                                                                                                 \
@@ -36,12 +38,24 @@
 	XX(Uuid)                                                                                                           \
 	XX_NET(Http)                                                                                                       \
 	XX_NET(Url)                                                                                                        \
+	XX_NET(Pbuf)                                                                                                       \
+	XX_NET(Mqtt)                                                                                                       \
+	XX_NET(RateLimiter)                                                                                                \
 	XX(ArduinoJson5)                                                                                                   \
 	XX(ArduinoJson6)                                                                                                   \
 	XX(Storage)                                                                                                        \
 	XX(Files)                                                                                                          \
 	XX(Spiffs)                                                                                                         \
+	XX(ArchiveFS)                                                                                                      \
 	XX(Rational)                                                                                                       \
 	XX(Clocks)                                                                                                         \
 	XX(Timers)                                                                                                         \
+	XX(I2S)                                                                                                            \
+	XX(AnalogSampler)                                                                                                  \
+	XX(FastGpio)                                                                                                       \
+	XX(Metrics)                                                                                                        \
+	XX(IrqLatency)                                                                                                     \
+	XX(HexCapture)                                                                                                     \
+	XX(Benchmark)                                                                                                      \
+	XX_NET(NetworkBenchmark)                                                                                           \
 	ARCH_TEST_MAP(XX)
@@ -0,0 +1,84 @@
+/*
+ * Continuous ADC sampling using the Host Timer1 emulation.
+ */
+
+#include <HostTests.h>
+
+#ifdef ARCH_HOST
+
+#include <AnalogSampler.h>
+#include <Digital.h>
+
+class AnalogSamplerTest : public TestGroup, private DigitalHooks
+{
+public:
+	AnalogSamplerTest() : TestGroup(_F("AnalogSampler"))
+	{
+	}
+
+	void execute() override
+	{
+		previousHooks = setDigitalHooks(this);
+
+		AnalogSampler::Config config;
+		config.sampleRate = 2000;
+		config.decimation = 2;
+
+		REQUIRE(!sampler.begin(config, buffer, 1));
+		auto cfg = config;
+		cfg.sampleRate = 1000000;
+		REQUIRE(!sampler.begin(cfg, buffer, ARRAY_SIZE(buffer)));
+
+		sampler.setThreshold(500, 100, [this](uint16_t value) { thresholdReached(value); });
+		REQUIRE(sampler.begin(config, buffer, ARRAY_SIZE(buffer)));
+		REQUIRE(sampler.isRunning());
+		REQUIRE(!sampler.begin(config, buffer, ARRAY_SIZE(buffer)));
+		REQUIRE_EQ(sampler.getOutputRate(), 1000U);
+
+		pending();
+	}
+
+private:
+	// Ramp 0, 10, 20 ... 990 then repeat
+	uint16_t analogRead(uint16_t) override
+	{
+		return (conversionCount++ % 100) * 10;
+	}
+
+	void thresholdReached(uint16_t value)
+	{
+		sampler.end();
+		setDigitalHooks(previousHooks);
+
+		CHECK(value >= 500);
+		CHECK_EQ(sampler.getOverflowCount(), 0U);
+
+		// Each stored sample is the average of two conversions
+		uint16_t samples[ARRAY_SIZE(buffer)];
+		auto count = sampler.read(samples, ARRAY_SIZE(samples));
+		debug_i("Read %u samples", count);
+		REQUIRE(count >= 26);
+		REQUIRE_EQ(sampler.available(), 0U);
+		uint16_t expected{5};
+		for(unsigned i = 0; i < count; ++i) {
+			REQUIRE_EQ(samples[i], expected);
+			expected = (expected + 20) % 1000;
+		}
+
+		complete();
+	}
+
+	AnalogSampler sampler;
+	uint16_t buffer[256];
+	DigitalHooks* previousHooks{nullptr};
+	volatile unsigned conversionCount{0};
+};
+
+#endif
+
+void REGISTER_TEST(AnalogSampler)
+{
+#ifdef ARCH_HOST
+	registerGroup<AnalogSamplerTest>();
+#endif
+}
@@ -0,0 +1,117 @@
+#include <HostTests.h>
+#include <Storage.h>
+#include <Storage/SysMem.h>
+#include <IFS/ArchiveFS/FileSystem.h>
+#include <resource.h>
+#include <memory>
+
+#ifdef ARCH_HOST
+#include <Storage/FileDevice.h>
+#endif
+
+class ArchiveFSTest : public TestGroup
+{
+public:
+	ArchiveFSTest() : TestGroup(_F("ArchiveFS"))
+	{
+	}
+
+	void execute() override
+	{
+#ifdef ARCH_HOST
+		auto& hfs = IFS::Host::getFileSystem();
+		String image = hfs.getContent("out/archivefs_test.bin");
+		REQUIRE(image.length() != 0);
+
+		auto f = hfs.open("out/archivefs_test.bin", IFS::File::ReadOnly);
+		REQUIRE(f >= 0);
+		Storage::FileDevice dev("arfs", hfs, f);
+		auto part = dev.editablePartitions().add(F("arfs"), Storage::Partition::SubType::Data::archivefs, 0,
+												 dev.getSize(), Storage::Partition::Flag::readOnly);
+
+		TEST_CASE("Read via partition")
+		{
+			IFS::ArchiveFS::FileSystem fs(part);
+			REQUIRE_EQ(fs.mount(), FS_OK);
+			REQUIRE(!fs.isMapped());
+			checkContent(fs);
+		}
+
+		TEST_CASE("Read via mapping")
+		{
+			auto memPart = Storage::sysMem.editablePartitions().add(F("arfsmap"),
+																	Storage::Partition::SubType::Data::archivefs,
+																	uint32_t(image.c_str()), image.length(),
+																	Storage::Partition::Flag::readOnly);
+			IFS::ArchiveFS::FileSystem fs(memPart);
+			REQUIRE_EQ(fs.mount(), FS_OK);
+			REQUIRE(fs.isMapped());
+			checkContent(fs);
+
+			auto file = fs.open("image.png", IFS::OpenFlag::Read);
+			REQUIRE(file >= 0);
+			auto ptr = fs.map(file);
+			REQUIRE(ptr != nullptr);
+			REQUIRE(Resource::image_png == String(static_cast<const char*>(ptr), Resource::image_png.length()));
+			fs.close(file);
+		}
+
+		TEST_CASE("Bad image")
+		{
+			image[0] = 0;
+			auto memPart = Storage::sysMem.editablePartitions().add(F("arfsbad"),
+																	Storage::Partition::SubType::Data::archivefs,
+																	uint32_t(image.c_str()), image.length(),
+																	Storage::Partition::Flag::readOnly);
+			IFS::ArchiveFS::FileSystem fs(memPart);
+			REQUIRE_EQ(fs.mount(), IFS::Error::BadFileSystem);
+		}
+
+		hfs.close(f);
+#endif
+	}
+
+	void checkContent(IFS::ArchiveFS::FileSystem& afs)
+	{
+		auto& fs = *IFS::FileSystem::cast(&afs);
+		REQUIRE_EQ(fs.check(), FS_OK);
+
+		// Uncompressed
+		REQUIRE(fs.getContent("image.png") == Resource::image_png);
+
+		// Compressed content is returned as stored
+		IFS::NameStat stat;
+		REQUIRE_EQ(fs.stat("test.json", &stat), FS_OK);
+		REQUIRE(stat.name == "test.json");
+		REQUIRE(stat.compression.type == IFS::Compression::Type::GZip);
+		REQUIRE_EQ(stat.compression.originalSize, Resource::test_json.length());
+		REQUIRE(stat.size < stat.compression.originalSize);
+
+		REQUIRE_EQ(fs.stat("missing.txt", nullptr), IFS::Error::NotFound);
+		REQUIRE_EQ(fs.open("test.json", IFS::OpenFlag::Write), IFS::Error::ReadOnly);
+
+		auto file = fs.open("image.png", IFS::OpenFlag::Read);
+		REQUIRE(file >= 0);
+		REQUIRE_EQ(fs.lseek(file, 0, SeekOrigin::End), file_offset_t(Resource::image_png.length()));
+		REQUIRE(fs.eof(file) > 0);
+		IFS::Extent ext;
+		REQUIRE_EQ(fs.fgetextents(file, nullptr, &ext, 1), 1);
+		REQUIRE_EQ(ext.length, Resource::image_png.length());
+		fs.close(file);
+
+		// Directory listing gives every file ('resource' has no sub-directories)
+		unsigned count{0};
+		IFS::DirHandle dir;
+		REQUIRE_EQ(fs.opendir(nullptr, dir), FS_OK);
+		while(fs.readdir(dir, stat) >= 0) {
+			++count;
+		}
+		fs.closedir(dir);
+		REQUIRE_EQ(count, afs.getFileCount());
+	}
+};
+
+void REGISTER_TEST(ArchiveFS)
+{
+	registerGroup<ArchiveFSTest>();
+}
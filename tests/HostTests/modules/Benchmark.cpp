@@ -0,0 +1,132 @@
+#include <HostTests.h>
+#include <Benchmark.h>
+#include <WHashMap.h>
+#include <Data/ObjectMap.h>
+#include <Data/Stream/MemoryDataStream.h>
+#include <FlashString/TemplateStream.hpp>
+
+namespace
+{
+DEFINE_FSTR_LOCAL(template1, "<html><head><title>{title}</title></head><body><p>{para1}</p><p>{para2}</p>"
+							 "<table><tr><td>{name}</td><td>{value}</td></tr></table></body></html>")
+
+constexpr unsigned mapSize{32};
+
+// Stops the compiler discarding results
+volatile uint32_t sink;
+
+class Item
+{
+public:
+	unsigned value{0};
+};
+
+} // namespace
+
+class BenchmarkTest : public TestGroup
+{
+public:
+	BenchmarkTest() : TestGroup(_F("Benchmark"))
+	{
+	}
+
+	void execute() override
+	{
+		TEST_CASE("String")
+		{
+			Benchmark::run(F("String concat"), []() {
+				String s;
+				for(unsigned i = 0; i < 8; ++i) {
+					s += _F("segment ");
+				}
+				sink = s.length();
+			});
+
+			Benchmark::run(F("String number"), []() {
+				String s(sink);
+				sink = s.length();
+			});
+
+			String text = F("The quick brown fox jumps over the lazy dog");
+			Benchmark::run(F("String indexOf"), [&]() { sink = text.indexOf("lazy"); });
+
+			Benchmark::run(F("String replace"), [&]() {
+				String s(text);
+				s.replace(" ", "_");
+				sink = s.length();
+			});
+		}
+
+		TEST_CASE("HashMap")
+		{
+			HashMap<String, unsigned> map;
+			Vector<String> keys;
+			for(unsigned i = 0; i < mapSize; ++i) {
+				String key = F("key") + String(i);
+				map[key] = i;
+				keys.add(key);
+			}
+
+			unsigned i = 0;
+			Benchmark::run(F("HashMap lookup"), [&]() {
+				sink = map[keys[i]];
+				i = (i + 1) % mapSize;
+			});
+		}
+
+		TEST_CASE("ObjectMap")
+		{
+			ObjectMap<String, Item> map;
+			Vector<String> keys;
+			for(unsigned i = 0; i < mapSize; ++i) {
+				String key = F("key") + String(i);
+				map.set(key, new Item{i});
+				keys.add(key);
+			}
+
+			unsigned i = 0;
+			Benchmark::run(F("ObjectMap lookup"), [&]() {
+				sink = map.find(keys[i])->value;
+				i = (i + 1) % mapSize;
+			});
+		}
+
+		TEST_CASE("MemoryDataStream")
+		{
+			uint8_t chunk[64];
+			memset(chunk, 0x55, sizeof(chunk));
+			Benchmark::run(F("MemoryDataStream grow 4K"), 100, [&]() {
+				MemoryDataStream stream;
+				for(unsigned i = 0; i < 4096 / sizeof(chunk); ++i) {
+					stream.write(chunk, sizeof(chunk));
+				}
+				sink = stream.available();
+			});
+		}
+
+		TEST_CASE("TemplateStream")
+		{
+			char buffer[256];
+			Benchmark::run(F("TemplateStream render"), 100, [&]() {
+				FSTR::TemplateStream tmpl(template1);
+				tmpl.setVar(F("title"), F("Document title"));
+				tmpl.setVar(F("para1"), F("First paragraph"));
+				tmpl.setVar(F("para2"), F("Second paragraph"));
+				tmpl.setVar(F("name"), F("Name"));
+				tmpl.setVar(F("value"), F("Value"));
+				size_t total{0};
+				while(!tmpl.isFinished()) {
+					auto len = tmpl.readMemoryBlock(buffer, sizeof(buffer));
+					tmpl.seek(len);
+					total += len;
+				}
+				sink = total;
+			});
+		}
+	}
+};
+
+void REGISTER_TEST(Benchmark)
+{
+	registerGroup<BenchmarkTest>();
+}
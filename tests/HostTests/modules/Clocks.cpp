@@ -7,6 +7,8 @@
 #include <HostTests.h>
 #include <Platform/Timers.h>
 #include <HardwareTimer.h>
+#include <Services/Profiling/ZoneTrace.h>
+#include <Data/Stream/MemoryDataStream.h>
 
 template <class Clock, typename TimeType> class ClockTestTemplate : public TestGroup
 {
@@ -512,12 +514,117 @@ public:
 	}
 };
 
+class ReciprocalTest : public TestGroup
+{
+public:
+	ReciprocalTest() : TestGroup(_F("Reciprocal division"))
+	{
+	}
+
+	template <uint32_t divisor> void checkDivider()
+	{
+		const uint32_t edges[]{0, 1, divisor - 1, divisor, divisor + 1, 0x7FFFFFFF, 0x80000000, 0xFFFFFFFE, 0xFFFFFFFF};
+		for(auto value : edges) {
+			REQUIRE_EQ(ConstDivider<divisor>::divide(value), value / divisor);
+		}
+		for(unsigned i = 0; i < 1000; ++i) {
+			uint32_t value = os_random();
+			REQUIRE_EQ(ConstDivider<divisor>::divide(value), value / divisor);
+		}
+	}
+
+	void execute() override
+	{
+		TEST_CASE("ConstDivider")
+		{
+			checkDivider<3>();
+			checkDivider<5>();
+			checkDivider<25>();
+			checkDivider<80>();
+			checkDivider<160>();
+			checkDivider<625>();
+			checkDivider<5000>();
+			checkDivider<1000000>();
+			checkDivider<0x80000001>();
+			checkDivider<0xFFFFFFFF>();
+		}
+
+		TEST_CASE("muldiv range")
+		{
+			REQUIRE_EQ(muldiv<5, 16>(0xFFFFFFFFU), 1342177280U);
+			REQUIRE_EQ(muldiv<16, 5>(0xFFFFFFFFU), 0xFFFFFFFFU);
+			REQUIRE_EQ(muldiv<16, 5>(uint64_t(0xFFFFFFFFU)), 13743895344ULL);
+			REQUIRE_EQ(muldiv<625, 2>(6871947U), 2147483438U);
+		}
+	}
+};
+
+class ZoneTraceTest : public TestGroup
+{
+public:
+	ZoneTraceTest() : TestGroup(_F("ZoneTrace"))
+	{
+	}
+
+	void execute() override
+	{
+		Profiling::ZoneTrace<4> trace;
+
+		TEST_CASE("Record zones")
+		{
+			for(unsigned i = 0; i < 3; ++i) {
+				PROFILE_ZONE(trace, "outer");
+				{
+					PROFILE_ZONE(trace, "inner");
+					os_delay_us(10);
+				}
+			}
+
+			REQUIRE_EQ(trace.getCount(), 4U);
+			REQUIRE_EQ(trace.getDropped(), 2U);
+			// Inner zone completes first
+			REQUIRE(strcmp_P(trace[0].zone, PSTR("inner")) == 0);
+			REQUIRE(strcmp_P(trace[1].zone, PSTR("outer")) == 0);
+			REQUIRE(trace[1].duration >= trace[0].duration);
+			REQUIRE(int(trace[3].start - trace[0].start) > 0);
+		}
+
+		TEST_CASE("Export")
+		{
+			MemoryDataStream stream;
+			auto len = trace.exportChromeTrace(stream);
+			REQUIRE_EQ(size_t(stream.available()), len);
+			String json = stream.readString(len);
+			debug_d("%s", json.c_str());
+			REQUIRE(json.startsWith(F("{\"traceEvents\":[{\"name\":\"inner\",\"ph\":\"X\"")));
+			REQUIRE(json.endsWith(F("}],\"displayTimeUnit\":\"ns\"}")));
+			REQUIRE(json.indexOf(F("\"ts\":0.000,")) > 0);
+		}
+
+		TEST_CASE("Disable and clear")
+		{
+			trace.enable(false);
+			{
+				PROFILE_ZONE(trace, "ignored");
+			}
+			REQUIRE_EQ(trace.getDropped(), 2U);
+			trace.clear();
+			trace.enable(true);
+			REQUIRE_EQ(trace.getCount(), 0U);
+		}
+	}
+};
+
 void REGISTER_TEST(Clocks)
 {
+	registerGroup<ZoneTraceTest>();
+
 	registerGroup<BenchmarkPolledTimer>();
 
 	registerGroup<TimerCalcTest>();
 
+	registerGroup<ReciprocalTest>();
+
 	registerGroup<Timer1ClockTestTemplate<TIMER_CLKDIV_16>>();
 	registerGroup<Timer1ClockTestTemplate<TIMER_CLKDIV_256>>();
 
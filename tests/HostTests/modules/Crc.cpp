@@ -0,0 +1,150 @@
+#include <HostTests.h>
+#include <Crypto/Crc.h>
+#include <memory>
+
+namespace
+{
+DEFINE_FSTR_LOCAL(checkString, "123456789")
+
+/*
+ * Bitwise reference implementations
+ */
+uint32_t refCrc32(const uint8_t* data, size_t length)
+{
+	uint32_t crc = ~0U;
+	while(length-- != 0) {
+		crc ^= *data++;
+		for(unsigned i = 0; i < 8; ++i) {
+			crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320 : crc >> 1;
+		}
+	}
+	return ~crc;
+}
+
+uint16_t refCrc16Ccitt(const uint8_t* data, size_t length)
+{
+	uint16_t crc = 0xFFFF;
+	while(length-- != 0) {
+		crc ^= uint16_t(*data++) << 8;
+		for(unsigned i = 0; i < 8; ++i) {
+			crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+		}
+	}
+	return crc;
+}
+
+uint32_t refAdler32(const uint8_t* data, size_t length)
+{
+	uint32_t a = 1;
+	uint32_t b = 0;
+	while(length-- != 0) {
+		a = (a + *data++) % 65521;
+		b = (b + a) % 65521;
+	}
+	return (b << 16) | a;
+}
+
+} // namespace
+
+class CrcTest : public TestGroup
+{
+public:
+	CrcTest() : TestGroup(_F("CRC"))
+	{
+	}
+
+	void execute() override
+	{
+		TEST_CASE("Check values")
+		{
+			LOAD_FSTR(s, checkString);
+			REQUIRE_EQ(Crypto::crc32(s, 9), 0xCBF43926U);
+			REQUIRE_EQ(Crypto::crc16Ccitt(s, 9), 0x29B1U);
+			REQUIRE_EQ(Crypto::crc16Modbus(s, 9), 0x4B37U);
+			REQUIRE_EQ(Crypto::crc16Modbus(s, 9, 0), 0xBB3DU);
+			REQUIRE_EQ(Crypto::crc8Maxim(s, 9), 0xA1U);
+			REQUIRE_EQ(Crypto::adler32(s, 9), 0x091E01DEU);
+		}
+
+		std::unique_ptr<uint8_t[]> data(new uint8_t[dataSize + 8]);
+		for(size_t i = 0; i < dataSize + 8; ++i) {
+			data[i] = uint8_t(i * 7 + (i >> 5));
+		}
+
+		TEST_CASE("Alignment and length")
+		{
+			for(unsigned offset = 0; offset < 8; ++offset) {
+				auto p = &data[offset];
+				for(auto len : lengths) {
+					REQUIRE_EQ(Crypto::crc32(p, len), refCrc32(p, len));
+					REQUIRE_EQ(Crypto::crc16Ccitt(p, len), refCrc16Ccitt(p, len));
+					REQUIRE_EQ(Crypto::adler32(p, len), refAdler32(p, len));
+				}
+			}
+		}
+
+		TEST_CASE("Chunked")
+		{
+			auto crc = Crypto::crc32(data.get(), dataSize);
+			auto adler = Crypto::adler32(data.get(), dataSize);
+			for(auto chunkSize : chunkSizes) {
+				uint32_t c{0};
+				uint32_t a{1};
+				for(size_t pos = 0; pos < dataSize; pos += chunkSize) {
+					auto len = std::min(chunkSize, dataSize - pos);
+					c = Crypto::crc32(&data[pos], len, c);
+					a = Crypto::adler32(&data[pos], len, a);
+				}
+				REQUIRE_EQ(c, crc);
+				REQUIRE_EQ(a, adler);
+			}
+		}
+
+		TEST_CASE("Flash data")
+		{
+			const FlashString& text = Resource::abstract_txt;
+			String s(text);
+			auto flashData = text.data();
+			for(unsigned offset = 0; offset < 4; ++offset) {
+				auto len = s.length() - offset;
+				REQUIRE_EQ(Crypto::crc32(flashData + offset, len), Crypto::crc32(s.c_str() + offset, len));
+				REQUIRE_EQ(Crypto::crc16Modbus(flashData + offset, len), Crypto::crc16Modbus(s.c_str() + offset, len));
+				REQUIRE_EQ(Crypto::crc8Maxim(flashData + offset, len), Crypto::crc8Maxim(s.c_str() + offset, len));
+			}
+		}
+
+		TEST_CASE("Throughput")
+		{
+			auto measure = [&](const String& name, size_t (*func)(const uint8_t*, size_t)) {
+				CpuCycleTimes times(name);
+				for(unsigned i = 0; i < 4; ++i) {
+					times.start();
+					func(data.get(), dataSize);
+					times.update();
+				}
+				Serial << name << ": " << times.getMin() << " cycles, " << double(times.getMin()) / dataSize
+					   << " per byte" << endl;
+			};
+
+			measure(F("crc32"), [](const uint8_t* p, size_t n) -> size_t { return Crypto::crc32(p, n); });
+			measure(F("reference crc32"), [](const uint8_t* p, size_t n) -> size_t { return refCrc32(p, n); });
+			measure(F("crc16Ccitt"), [](const uint8_t* p, size_t n) -> size_t { return Crypto::crc16Ccitt(p, n); });
+			measure(F("crc16Modbus"), [](const uint8_t* p, size_t n) -> size_t { return Crypto::crc16Modbus(p, n); });
+			measure(F("crc8Maxim"), [](const uint8_t* p, size_t n) -> size_t { return Crypto::crc8Maxim(p, n); });
+			measure(F("adler32"), [](const uint8_t* p, size_t n) -> size_t { return Crypto::adler32(p, n); });
+		}
+	}
+
+private:
+	static constexpr size_t dataSize{4096};
+	static constexpr size_t lengths[]{0, 1, 3, 4, 7, 130, dataSize};
+	static constexpr size_t chunkSizes[]{1, 5, 64, 1000};
+};
+
+constexpr size_t CrcTest::lengths[];
+constexpr size_t CrcTest::chunkSizes[];
+
+void REGISTER_TEST(Crc)
+{
+	registerGroup<CrcTest>();
+}
@@ -1,5 +1,6 @@
 #include <HostTests.h>
 #include <DateTime.h>
+#include <SystemClock.h>
 #include <FlashString/Array.hpp>
 
 #include "DateTimeData.h"
@@ -20,6 +21,17 @@ public:
 			checkHttpDates(VALID_HTTP_DATE);
 		}
 
+		TEST_CASE("daysFromCivil()")
+		{
+			static_assert(DateTime::toUnixTime(37, 49, 8, 6, dtNovember, 1994) == 784111777, "Bad toUnixTime()");
+			REQUIRE_EQ(DateTime::daysFromCivil(1970, dtJanuary, 1), 0);
+			REQUIRE_EQ(DateTime::daysFromCivil(1969, dtDecember, 31), -1);
+			REQUIRE_EQ(DateTime::daysFromCivil(2000, dtMarch, 1), 11017);
+			// Months beyond December carry into the year
+			REQUIRE_EQ(DateTime::daysFromCivil(1999, 14, 1), 11017);
+			REQUIRE_EQ(DateTime::daysFromCivil(2000, dtFebruary, 30), 11017);
+		}
+
 		TEST_CASE("fromISO8601 (32-bit)")
 		{
 			checkIsoTimes(VALID_ISO_DATETIME, false);
@@ -90,6 +102,32 @@ public:
 					   << DateTime::getLocaleMonthName(month) << endl;
 			}
 		}
+
+		TEST_CASE("SystemClock adjustTime")
+		{
+			constexpr int64_t nsPerMs{1000000};
+			auto time = SystemClock.now(eTZ_UTC);
+			SystemClock.setTime(time, eTZ_UTC);
+
+			// Small offsets are slewed, so time does not jump
+			auto t0 = SystemClock.getTimeNs();
+			REQUIRE(SystemClock.adjustTime(500 * nsPerMs));
+			REQUIRE(SystemClock.isSlewing());
+			auto t1 = SystemClock.getTimeNs();
+			REQUIRE(t1 >= t0 && t1 - t0 < 100 * nsPerMs);
+
+			// Large offsets step the clock
+			REQUIRE(!SystemClock.adjustTime(5000 * nsPerMs));
+			REQUIRE(!SystemClock.isSlewing());
+			auto t2 = SystemClock.getTimeNs();
+			REQUIRE(t2 - t1 >= 5000 * nsPerMs && t2 - t1 < 5100 * nsPerMs);
+
+			SystemClock.setDriftCorrection(10000000);
+			REQUIRE_EQ(SystemClock.getDriftCorrection(), SYSTEM_CLOCK_MAX_DRIFT_PPB);
+			SystemClock.setDriftCorrection(0);
+
+			SystemClock.setTime(SystemClock.now(eTZ_UTC) - 5, eTZ_UTC);
+		}
 	}
 
 	void checkHttpDates(const FSTR::Array<TestDate>& dates)
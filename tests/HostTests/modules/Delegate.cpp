@@ -0,0 +1,95 @@
+#include <HostTests.h>
+#include <Delegate.h>
+#include <malloc_count.h>
+
+namespace
+{
+int plainFunction(int a)
+{
+	return a * 2;
+}
+
+} // namespace
+
+class DelegateTest : public TestGroup
+{
+public:
+	DelegateTest() : TestGroup(_F("Delegate"))
+	{
+	}
+
+	void execute() override
+	{
+		using D = InplaceDelegate<int(int)>;
+
+		TEST_CASE("Inline storage")
+		{
+			auto allocCount = MallocCount::getAllocCount();
+
+			D method(&DelegateTest::method, this);
+			D function(plainFunction);
+			int factor = 10;
+			D lambda([this, factor](int a) { return a * factor + offset; });
+			D bound(std::bind(&DelegateTest::method, this, _1));
+			D copy(method);
+			D moved(std::move(copy));
+
+			REQUIRE_EQ(MallocCount::getAllocCount(), allocCount);
+
+			REQUIRE_EQ(method(1), 4);
+			REQUIRE_EQ(function(2), 4);
+			REQUIRE_EQ(lambda(3), 33);
+			REQUIRE_EQ(bound(4), 7);
+			REQUIRE_EQ(moved(5), 8);
+			REQUIRE(!copy);
+		}
+
+		TEST_CASE("Empty")
+		{
+			D d;
+			REQUIRE(!d);
+			REQUIRE(d == nullptr);
+			d = plainFunction;
+			REQUIRE(d != nullptr);
+			d = nullptr;
+			REQUIRE(!d);
+			D nullFunction(static_cast<int (*)(int)>(nullptr));
+			REQUIRE(!nullFunction);
+		}
+
+		TEST_CASE("Heap fallback")
+		{
+			int values[16]{};
+			values[15] = 100;
+			D d([values](int a) { return values[15] + a; });
+			D copy(d);
+			D other;
+			other = std::move(copy);
+			REQUIRE(!copy);
+			REQUIRE_EQ(d(1), 101);
+			REQUIRE_EQ(other(2), 102);
+		}
+
+		TEST_CASE("Conversion")
+		{
+			Delegate<int(int)> stdDelegate(plainFunction);
+			D d(stdDelegate);
+			REQUIRE_EQ(d(3), 6);
+			Delegate<int(int)> back(d);
+			REQUIRE_EQ(back(4), 8);
+		}
+	}
+
+private:
+	int method(int a)
+	{
+		return a + offset;
+	}
+
+	int offset{3};
+};
+
+void REGISTER_TEST(Delegate)
+{
+	registerGroup<DelegateTest>();
+}
@@ -0,0 +1,88 @@
+/*
+ * Check FastGpio templates against the Host port emulation.
+ */
+
+#include <HostTests.h>
+
+#ifdef ARCH_HOST
+
+#include <FastGpio.h>
+
+class FastGpioTest : public TestGroup, private DigitalHooks
+{
+public:
+	FastGpioTest() : TestGroup(_F("FastGpio"))
+	{
+	}
+
+	void execute() override
+	{
+		auto previousHooks = setDigitalHooks(this);
+
+		using Led = FastGpio::Pin<2>;
+		using Bus = FastGpio::PinGroup<BIT(4) | BIT(5) | BIT(12)>;
+
+		static_assert(Led::mask == BIT(2), "Bad mask");
+		static_assert(Led::number == 2, "Bad pin number");
+
+		TEST_CASE("Pin")
+		{
+			Led::output();
+			REQUIRE_EQ(modes, BIT(2));
+			Led::write(true);
+			REQUIRE_EQ(levels, BIT(2));
+			REQUIRE(Led::read());
+			Led::toggle();
+			REQUIRE_EQ(levels, 0U);
+			REQUIRE(!Led::read());
+		}
+
+		TEST_CASE("PinGroup")
+		{
+			Bus::output();
+			REQUIRE_EQ(modes, BIT(2) | Bus::mask);
+			Bus::set();
+			REQUIRE_EQ(levels, Bus::mask);
+			Bus::write(BIT(4) | BIT(12) | BIT(2));
+			REQUIRE_EQ(levels, BIT(4) | BIT(12));
+			REQUIRE_EQ(Bus::read(), BIT(4) | BIT(12));
+			Bus::toggle();
+			REQUIRE_EQ(levels, BIT(5));
+			Bus::clear();
+			REQUIRE_EQ(levels, 0U);
+			Bus::input();
+			REQUIRE_EQ(modes, BIT(2));
+		}
+
+		setDigitalHooks(previousHooks);
+	}
+
+private:
+	bool pinMode(uint16_t pin, uint8_t mode) override
+	{
+		bitWrite(modes, pin, mode == OUTPUT);
+		return true;
+	}
+
+	void digitalWrite(uint16_t pin, uint8_t val) override
+	{
+		bitWrite(levels, pin, val);
+	}
+
+	uint8_t digitalRead(uint16_t pin, uint8_t) override
+	{
+		return bitRead(levels, pin);
+	}
+
+	uint32_t modes{0};
+	uint32_t levels{0};
+};
+
+#endif
+
+void REGISTER_TEST(FastGpio)
+{
+#ifdef ARCH_HOST
+	registerGroup<FastGpioTest>();
+#endif
+}
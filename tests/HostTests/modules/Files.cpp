@@ -138,6 +138,40 @@ public:
 			debug_i("Actual file size = %d", size);
 			REQUIRE(size == 100);
 		}
+
+		TEST_CASE("Buffered file stream access")
+		{
+			const size_t ioSize = std::max(FileStream::getIoSize(), size_t(512));
+			String content;
+			{
+				FileStream fs;
+				fs.open(testFileName, File::CreateNewAlways | File::WriteOnly);
+				// Small writes of varying size, crossing buffer boundaries
+				for(unsigned i = 0; content.length() < 3 * ioSize; ++i) {
+					String s(i);
+					s += ',';
+					REQUIRE(fs.print(s) == s.length());
+					content += s;
+				}
+				REQUIRE(fs.getSize() == content.length());
+			}
+			REQUIRE(fileGetContent(testFileName) == content);
+
+			FileStream fs(testFileName);
+			String readback;
+			char buf[77];
+			while(!fs.isFinished()) {
+				size_t len = fs.readMemoryBlock(buf, sizeof(buf));
+				REQUIRE(len != 0);
+				readback.concat(buf, len);
+				fs.seek(len);
+			}
+			REQUIRE(readback == content);
+
+			fs.seekFrom(ioSize - 5, SeekOrigin::Start);
+			REQUIRE(fs.readBytes(buf, 16) == 16);
+			REQUIRE(memcmp(buf, &content[ioSize - 5], 16) == 0);
+		}
 	}
 };
 
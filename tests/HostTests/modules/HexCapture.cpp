@@ -0,0 +1,94 @@
+#include <HostTests.h>
+#include <Services/HexDump/HexCapture.h>
+
+namespace
+{
+// Mimics a pbuf chain
+struct Segment {
+	const void* payload;
+	uint16_t len;
+	uint16_t tot_len;
+	const Segment* next;
+};
+
+} // namespace
+
+class HexCaptureTest : public TestGroup
+{
+public:
+	HexCaptureTest() : TestGroup(_F("HexCapture"))
+	{
+	}
+
+	void execute() override
+	{
+		HexCaptureBuffer<sizeof(HexCapture::Record) * 4 + 64> capture;
+
+		uint8_t data[40];
+		for(unsigned i = 0; i < sizeof(data); ++i) {
+			data[i] = '0' + i;
+		}
+
+		TEST_CASE("Capture")
+		{
+			REQUIRE(HEX_CAPTURE(capture, "first", data, 4));
+			REQUIRE(HEX_CAPTURE(capture, "second", data, 16));
+			REQUIRE_EQ(capture.getCount(), 2U);
+			REQUIRE_EQ(capture.getDropped(), 0U);
+
+			MemoryDataStream stream;
+			auto len = capture.dump(stream);
+			REQUIRE_EQ(size_t(stream.available()), len);
+			String s = stream.readString(len);
+			Serial << s;
+			REQUIRE(s.indexOf(F(" +0 first: 4 bytes\r\n    0000: 30 31 32 33 ")) > 0);
+			REQUIRE(s.indexOf(F("second: 16 bytes\r\n")) > 0);
+			REQUIRE(s.endsWith(F("0123456789:;<=>?\r\n")));
+		}
+
+		TEST_CASE("Oldest records discarded")
+		{
+			for(unsigned i = 0; i < 4; ++i) {
+				HEX_CAPTURE(capture, "fill", data, 30);
+			}
+			REQUIRE(capture.getCount() < 4U);
+			REQUIRE_EQ(capture.getCount() + capture.getDropped(), 6U);
+
+			MemoryDataStream stream;
+			auto len = capture.dump(stream);
+			String s = stream.readString(len);
+			REQUIRE(s.startsWith(F("(")));
+			REQUIRE(s.indexOf(F("first")) < 0);
+		}
+
+		TEST_CASE("Chain with snap length")
+		{
+			capture.clear();
+			capture.setSnapLength(8);
+			Segment seg2{"World", 5, 5, nullptr};
+			Segment seg1{"Hello ", 6, 11, &seg2};
+			REQUIRE(capture.captureChain(PSTR("chain"), &seg1));
+			REQUIRE_EQ(capture.getCount(), 1U);
+
+			MemoryDataStream stream;
+			auto len = capture.dump(stream, 8);
+			String s = stream.readString(len);
+			Serial << s;
+			REQUIRE(s.indexOf(F("chain: 8 of 11 bytes\r\n")) > 0);
+			REQUIRE(s.endsWith(F("    0000: 48 65 6c 6c 6f 20 57 6f  Hello Wo\r\n")));
+		}
+
+		TEST_CASE("Disable")
+		{
+			capture.enable(false);
+			REQUIRE(!HEX_CAPTURE(capture, "ignored", data, 4));
+			REQUIRE_EQ(capture.getCount(), 1U);
+			capture.enable(true);
+		}
+	}
+};
+
+void REGISTER_TEST(HexCapture)
+{
+	registerGroup<HexCaptureTest>();
+}
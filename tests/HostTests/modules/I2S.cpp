@@ -0,0 +1,124 @@
+/*
+ * Exercise the I2S buffer callback API using the Host emulation with loopback.
+ */
+
+#include <HostTests.h>
+
+#ifdef ARCH_HOST
+
+#include <driver/i2s.h>
+
+class I2STest : public TestGroup
+{
+public:
+	I2STest() : TestGroup(_F("I2S"))
+	{
+	}
+
+	void execute() override
+	{
+		i2s_config_t config{};
+		config.tx.mode = I2S_MODE_MASTER;
+		config.tx.bits_per_sample = I2S_BITS_PER_SAMPLE_16BIT;
+		config.tx.channel_format = I2S_CHANNEL_FMT_RIGHT_LEFT;
+		config.tx.dma_buf_len = samplesPerBuffer;
+		config.tx.dma_buf_count = 4;
+		config.rx = config.tx;
+		config.sample_rate = 48000;
+		config.param = this;
+
+		TEST_CASE("Invalid config")
+		{
+			auto cfg = config;
+			cfg.tx.dma_buf_count = 1;
+			REQUIRE(!i2s_driver_install(&cfg));
+		}
+
+		TEST_CASE("Buffer status")
+		{
+			REQUIRE(i2s_driver_install(&config));
+			REQUIRE(!i2s_driver_install(&config));
+			i2s_buffer_stat_t stat;
+			REQUIRE(i2s_stat_tx(&stat));
+			REQUIRE_EQ(stat.size, 3 * bufferSize);
+			REQUIRE_EQ(stat.used, 0);
+			REQUIRE(i2s_zero_dma_buffer());
+			REQUIRE(i2s_stat_tx(&stat));
+			REQUIRE(stat.used >= stat.size);
+			i2s_buffer_info_t info;
+			REQUIRE(!i2s_dma_write(&info, 1));
+			REQUIRE(!i2s_dma_read(&info, 1));
+			i2s_driver_uninstall();
+		}
+
+		TEST_CASE("Loopback streaming")
+		{
+			config.auto_start = true;
+			config.tx_buffer_callback = fillBuffer;
+			config.rx_buffer_callback = checkBuffer;
+			REQUIRE(i2s_driver_install(&config));
+			REQUIRE(i2s_enable_loopback(true));
+			pending();
+		}
+	}
+
+private:
+	static constexpr unsigned samplesPerBuffer{64};
+	static constexpr unsigned bufferSize{samplesPerBuffer * sizeof(i2s_sample_t)};
+	static constexpr unsigned requiredBuffers{20};
+
+	static bool fillBuffer(void* param, const i2s_buffer_info_t* info)
+	{
+		auto self = static_cast<I2STest*>(param);
+		auto count = info->size / sizeof(i2s_sample_t);
+		for(unsigned i = 0; i < count; ++i) {
+			info->samples[i].u32 = ++self->txCount;
+		}
+		return true;
+	}
+
+	static bool checkBuffer(void* param, const i2s_buffer_info_t* info)
+	{
+		auto self = static_cast<I2STest*>(param);
+		if(self->finished) {
+			return false;
+		}
+		CHECK_EQ(info->size, bufferSize);
+		auto first = info->samples[0].u32;
+		if(first == 0) {
+			// Silence sent before first fill
+			return true;
+		}
+		// Each buffer is filled in one go, so samples must be consecutive
+		auto count = info->size / sizeof(i2s_sample_t);
+		for(unsigned i = 1; i < count; ++i) {
+			CHECK_EQ(info->samples[i].u32, first + i);
+		}
+		if(++self->rxCount == requiredBuffers) {
+			self->finished = true;
+			// Driver must not be uninstalled from its own callback
+			System.queueCallback(
+				[](void* param) {
+					auto self = static_cast<I2STest*>(param);
+					i2s_driver_uninstall();
+					debug_i("I2S sent %u samples", self->txCount);
+					self->complete();
+				},
+				self);
+		}
+		return true;
+	}
+
+	uint32_t txCount{0};
+	unsigned rxCount{0};
+	bool finished{false};
+};
+
+#endif
+
+void REGISTER_TEST(I2S)
+{
+#ifdef ARCH_HOST
+	registerGroup<I2STest>();
+#endif
+}
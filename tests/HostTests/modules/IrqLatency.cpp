@@ -0,0 +1,71 @@
+#include <HostTests.h>
+#include <Services/Profiling/IrqLatency.h>
+#include <Services/Profiling/StackMonitor.h>
+#include <Clock.h>
+
+class IrqLatencyTest : public TestGroup
+{
+public:
+	IrqLatencyTest() : TestGroup(_F("IRQ latency"))
+	{
+	}
+
+	void execute() override
+	{
+		/*
+		 * The Host has no real interrupts so call the hooks directly
+		 */
+		TEST_CASE("Measure")
+		{
+			Profiling::IrqLatency::reset();
+			auto caller = reinterpret_cast<const void*>(0x1234);
+			irq_latency_lock(caller);
+			delayMicroseconds(100);
+			irq_latency_unlock();
+
+			Profiling::IrqLatency info;
+			Serial << info << endl;
+			REQUIRE_EQ(info.count, 1U);
+			REQUIRE(info.max_caller == caller);
+			REQUIRE(info.getMaxTime().time >= 90);
+		}
+
+		TEST_CASE("Unmatched unlock")
+		{
+			irq_latency_unlock();
+			Profiling::IrqLatency info;
+			REQUIRE_EQ(info.count, 1U);
+		}
+
+		TEST_CASE("Shorter period keeps maximum")
+		{
+			Profiling::IrqLatency before;
+			irq_latency_lock(nullptr);
+			irq_latency_unlock();
+			Profiling::IrqLatency after;
+			REQUIRE_EQ(after.count, 2U);
+			REQUIRE_EQ(after.max_cycles, before.max_cycles);
+			REQUIRE(after.max_caller == before.max_caller);
+		}
+
+		TEST_CASE("Reset")
+		{
+			Profiling::IrqLatency::reset();
+			Profiling::IrqLatency info;
+			REQUIRE_EQ(info.count, 0U);
+			REQUIRE_EQ(info.max_cycles, 0U);
+		}
+
+		TEST_CASE("StackMonitor unsupported on Host")
+		{
+			REQUIRE(!Profiling::StackMonitor::paint());
+			REQUIRE_EQ(Profiling::StackMonitor::getSize(), 0U);
+			REQUIRE_EQ(Profiling::StackMonitor::getMaxUsed(), 0U);
+		}
+	}
+};
+
+void REGISTER_TEST(IrqLatency)
+{
+	registerGroup<IrqLatencyTest>();
+}
@@ -1,4 +1,6 @@
 #include <HostTests.h>
+#include <stringconversion.h>
+#include <cmath>
 
 static int num_instances;
 
@@ -79,6 +81,51 @@ public:
 			REQUIRE_EQ(String(buffer), "0x0123456789ABCDEF");
 			m_snprintf(buffer, sizeof(buffer), "%llu", 123456789123456789ULL);
 			REQUIRE_EQ(String(buffer), "123456789123456789");
+			m_snprintf(buffer, sizeof(buffer), "%lld", -9223372036854775807LL - 1);
+			REQUIRE_EQ(String(buffer), "-9223372036854775808");
+			m_snprintf(buffer, sizeof(buffer), "%d,%5d,%03u", -2147483647 - 1, 42, 7);
+			REQUIRE_EQ(String(buffer), "-2147483648,   42,007");
+			m_snprintf(buffer, sizeof(buffer), "%g,%g,%g", 0.1, -1.5e-7, 1e21);
+			REQUIRE_EQ(String(buffer), "0.1,-1.5e-7,1e+21");
+		}
+
+		TEST_CASE("Shortest float conversion")
+		{
+			char buffer[DTOSTR_SHORTEST_BUFSIZE];
+			const struct {
+				double value;
+				const char* expected;
+			} doubles[]{
+				{0, "0"},
+				{0.3, "0.3"},
+				{2.0 / 3, "0.6666666666666666"},
+				{123456.789, "123456.789"},
+				{1e20, "100000000000000000000"},
+				{0.000001, "0.000001"},
+				{5e-324, "5e-324"},
+				{1.7976931348623157e308, "1.7976931348623157e+308"},
+			};
+			for(auto& t : doubles) {
+				REQUIRE_EQ(String(dtostr_shortest(t.value, buffer)), t.expected);
+				REQUIRE_EQ(strtod(buffer, nullptr), t.value);
+			}
+
+			REQUIRE_EQ(String(ftostr_shortest(0.1f, buffer)), "0.1");
+			REQUIRE_EQ(String(ftostr_shortest(-25.5f, buffer)), "-25.5");
+			REQUIRE_EQ(String(ftostr_shortest(3.4028235e38f, buffer)), "3.4028235e+38");
+			REQUIRE_EQ(String(ftostr_shortest(NAN, buffer)), "NaN");
+			REQUIRE_EQ(String(dtostr_shortest(-INFINITY, buffer)), "-Inf");
+
+			// Every value must read back exactly
+			for(unsigned i = 0; i < 10000; ++i) {
+				uint32_t bits = os_random();
+				float f;
+				memcpy(&f, &bits, sizeof(f));
+				if(std::isfinite(f)) {
+					ftostr_shortest(f, buffer);
+					REQUIRE_EQ(strtof(buffer, nullptr), f);
+				}
+			}
 		}
 	}
 };
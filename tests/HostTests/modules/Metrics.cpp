@@ -0,0 +1,89 @@
+#include <HostTests.h>
+#include <Services/Profiling/Metrics.h>
+#include <Data/Stream/MemoryDataStream.h>
+
+#ifdef ENABLE_METRICS
+
+namespace
+{
+METRIC_COUNTER(testCounter, "test_events_total", "Test events");
+METRIC_GAUGE(testGauge, "test_level", "Test level");
+METRIC_HISTOGRAM(testHistogram, "test_duration_us", "Test durations");
+
+String print(const Profiling::Metrics::Metric& metric)
+{
+	MemoryDataStream stream;
+	metric.printTo(stream);
+	return stream.readString(stream.available());
+}
+
+} // namespace
+
+class MetricsTest : public TestGroup
+{
+public:
+	MetricsTest() : TestGroup(_F("Metrics"))
+	{
+	}
+
+	void execute() override
+	{
+		TEST_CASE("Registry")
+		{
+			unsigned found{0};
+			for(auto& metric : Profiling::Metrics::Metric::getList()) {
+				if(metric == testCounter || metric == testGauge || metric == testHistogram) {
+					++found;
+				}
+			}
+			REQUIRE_EQ(found, 3);
+		}
+
+		TEST_CASE("Counter")
+		{
+			testCounter.add();
+			testCounter.add(0xffffffff);
+			REQUIRE_EQ(testCounter.getValue(), 0x100000000ULL);
+			REQUIRE_EQ(print(testCounter), F("# HELP test_events_total Test events\n"
+											 "# TYPE test_events_total counter\n"
+											 "test_events_total 4294967296\n"));
+		}
+
+		TEST_CASE("Gauge")
+		{
+			testGauge.set(5);
+			testGauge.add(-7);
+			REQUIRE_EQ(testGauge.getValue(), -2);
+			REQUIRE(print(testGauge).endsWith(F("test_level -2\n")));
+		}
+
+		TEST_CASE("Histogram")
+		{
+			for(auto value : {0U, 1U, 2U, 3U, 4U, 1000U, 0xffffffffU}) {
+				testHistogram.observe(value);
+			}
+			REQUIRE_EQ(testHistogram.getCount(), 7);
+			REQUIRE_EQ(testHistogram.getBucket(0), 1);
+			REQUIRE_EQ(testHistogram.getBucket(1), 1);
+			REQUIRE_EQ(testHistogram.getBucket(2), 2);
+			REQUIRE_EQ(testHistogram.getBucket(3), 1);
+			REQUIRE_EQ(testHistogram.getBucket(10), 1);
+			REQUIRE_EQ(testHistogram.getBucket(32), 1);
+
+			auto s = print(testHistogram);
+			REQUIRE(s.indexOf(F("test_duration_us_bucket{le=\"3\"} 4\n")) >= 0);
+			REQUIRE(s.indexOf(F("test_duration_us_bucket{le=\"1023\"} 6\n")) >= 0);
+			REQUIRE(s.indexOf(F("test_duration_us_bucket{le=\"+Inf\"} 7\n")) >= 0);
+			REQUIRE(s.indexOf(F("test_duration_us_sum 4294968305\n")) >= 0);
+		}
+	}
+};
+
+#endif
+
+void REGISTER_TEST(Metrics)
+{
+#ifdef ENABLE_METRICS
+	registerGroup<MetricsTest>();
+#endif
+}
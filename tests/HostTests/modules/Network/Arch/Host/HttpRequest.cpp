@@ -59,32 +59,40 @@ public:
 		pending();
 	}
 
-	void requestNextFile()
+	HttpRequest* createRequest(const TestFile& file)
 	{
-		if(fileIndex >= ARRAY_SIZE(testFiles)) {
-			shutdown();
-			return;
-		}
-
-		auto& file = testFiles[fileIndex++];
 		Url url;
 		url.Host = WifiStation.getIP().toString();
 		url.Port = 80;
 		url.Path = String('/') + file.name;
+		return new HttpRequest(url);
+	}
 
-		auto req = new HttpRequest(url);
-		req->onRequestComplete([this, file](HttpConnection& connection, bool success) -> int {
-			auto response = connection.getResponse();
-			debug_i("Client received '%s'", connection.getRequest()->uri.toString().c_str());
-			Serial.print(response->toString());
+	static void checkResponse(HttpConnection& connection, const TestFile& file)
+	{
+		auto response = connection.getResponse();
+		debug_i("Client received '%s'", connection.getRequest()->uri.toString().c_str());
+		Serial.print(response->toString());
 
-			REQUIRE(response->code == HTTP_STATUS_OK);
-			REQUIRE(response->headers[HTTP_HEADER_CONTENT_TYPE] == toString(file.mimeType));
-			REQUIRE(response->headers[HTTP_HEADER_CONTENT_ENCODING] == file.contentEncoding);
-			REQUIRE(response->headers[HTTP_HEADER_CONTENT_LENGTH] == String(file.getSize()));
+		REQUIRE(response->code == HTTP_STATUS_OK);
+		REQUIRE(response->headers[HTTP_HEADER_CONTENT_TYPE] == toString(file.mimeType));
+		REQUIRE(response->headers[HTTP_HEADER_CONTENT_ENCODING] == file.contentEncoding);
+		REQUIRE(response->headers[HTTP_HEADER_CONTENT_LENGTH] == String(file.getSize()));
+
+		Serial.println();
+	}
 
-			Serial.println();
+	void requestNextFile()
+	{
+		if(fileIndex >= ARRAY_SIZE(testFiles)) {
+			requestAllFiles();
+			return;
+		}
 
+		auto& file = testFiles[fileIndex++];
+		auto req = createRequest(file);
+		req->onRequestComplete([this, file](HttpConnection& connection, bool success) -> int {
+			checkResponse(connection, file);
 			requestNextFile();
 			return 0;
 		});
@@ -92,6 +100,26 @@ public:
 		debug_i("Requested '%s': %s", file.name, ok ? "OK" : "FAIL");
 	}
 
+	/*
+	 * Connection is now known to be persistent, so these requests are pipelined.
+	 * Responses must arrive in the order requested.
+	 */
+	void requestAllFiles()
+	{
+		for(unsigned i = 0; i < ARRAY_SIZE(testFiles); ++i) {
+			auto req = createRequest(testFiles[i]);
+			req->onRequestComplete([this, i](HttpConnection& connection, bool success) -> int {
+				REQUIRE_EQ(i, completedCount);
+				checkResponse(connection, testFiles[i]);
+				if(++completedCount == ARRAY_SIZE(testFiles)) {
+					shutdown();
+				}
+				return 0;
+			});
+			REQUIRE(client.send(req));
+		}
+	}
+
 	void shutdown()
 	{
 		server->shutdown();
@@ -103,6 +131,7 @@ public:
 private:
 	HttpServer* server{nullptr};
 	unsigned fileIndex{0};
+	unsigned completedCount{0};
 	HttpClient client;
 	Timer timer;
 };
@@ -4,6 +4,7 @@
 #include <Network/TcpServer.h>
 #include <Data/Stream/MemoryDataStream.h>
 #include <Platform/Station.h>
+#include <Network/LwipStats.h>
 
 class TcpClientTest : public TestGroup
 {
@@ -26,6 +27,13 @@ public:
 		server = new TcpServer(
 			[this](TcpClient& client, char* data, int size) -> bool {
 				// on data
+				if(client.isManualReceiveAck()) {
+					// Window only re-opens once data is consumed
+					REQUIRE(client.getUnacknowledgedReceive() >= size_t(size));
+					client.acknowledgeReceive(size);
+				} else {
+					client.setManualReceiveAck(true);
+				}
 				return receivedData.concat(data, size);
 			},
 			[this, inputData](TcpClient& client, bool successful) {
@@ -35,6 +43,9 @@ public:
 				}
 				REQUIRE(successful == true);
 				REQUIRE(receivedData == inputData);
+				auto& stats = client.getStats();
+				REQUIRE_EQ(stats.bytesReceived, inputData.length());
+				REQUIRE(stats.receiveCount != 0);
 				finished = true;
 				shutdown();
 			});
@@ -50,6 +61,10 @@ public:
 		{
 			size_t offset = 0;
 
+			// Output is held until uncork()
+			client.cork();
+			REQUIRE(client.isCorked());
+
 			// Send text using bytes
 			client.send(inputData.c_str(), 5);
 			offset += 5;
@@ -74,6 +89,9 @@ public:
 			// and finally the rest of the bytes
 			String rest = inputData.substring(offset);
 			client.send(rest.c_str(), rest.length());
+			client.uncork();
+			REQUIRE(!client.isCorked());
+			REQUIRE(client.getNoDelay());
 			client.setTimeOut(1);
 
 			pending();
@@ -82,6 +100,12 @@ public:
 
 	void shutdown()
 	{
+		Network::LwipStats::Snapshot snapshot;
+		if(Network::LwipStats::getSnapshot(snapshot)) {
+			debug_i("lwIP TCP xmit %u, recv %u, drop %u", snapshot.tcp.xmit, snapshot.tcp.recv, snapshot.tcp.drop);
+			REQUIRE(snapshot.tcp.recv != 0);
+		}
+
 		server->shutdown();
 		server = nullptr;
 		timer.initializeMs<1000>([this]() { complete(); });
@@ -39,6 +39,20 @@ public:
 			REQUIRE(clear == token);
 		}
 
+		TEST_CASE("Encode with line breaks")
+		{
+			String text = F("The quick brown fox jumps over the lazy dog");
+			char buffer[64];
+			base64_encodestate state;
+			base64_init_encodestate(&state, 16);
+			// Split input so both whole-group and byte-at-a-time paths are used
+			unsigned len = base64_encode_block(text.c_str(), 5, buffer, &state);
+			len += base64_encode_block(text.c_str() + 5, text.length() - 5, &buffer[len], &state);
+			len += base64_encode_blockend(&buffer[len], &state);
+			REQUIRE_EQ(String(buffer, len), F("VGhlIHF1aWNrIGJy\nb3duIGZveCBqdW1w\ncyBvdmVyIHRoZSBs\nYXp5IGRvZw=="));
+			REQUIRE_EQ(base64_decode(buffer, len), text);
+		}
+
 		TEST_CASE("Encode lengths")
 		{
 			// Verify that actual encoded size is no larger than estimated size
@@ -0,0 +1,117 @@
+#include <HostTests.h>
+#include <Benchmark.h>
+#include <Data/Stream/MemoryDataStream.h>
+#include <Data/Stream/Base64OutputStream.h>
+#include <Data/Stream/ChunkedStream.h>
+#include <Network/Http/BasicHttpHeaders.h>
+#include <Data/WebHelpers/base64.h>
+#include <Data/WebHelpers/escape.h>
+#include <Data/HexString.h>
+
+namespace
+{
+DEFINE_FSTR_LOCAL(httpResponse, "HTTP/1.1 200 OK\r\n"
+								"Content-Type: text/html; charset=UTF-8\r\n"
+								"Content-Length: 6042\r\n"
+								"Content-Encoding: gzip\r\n"
+								"Connection: keep-alive\r\n"
+								"Cache-Control: max-age=31536000, public\r\n"
+								"ETag: \"00f-3d-179a0-0\"\r\n"
+								"Server: HttpServer/Sming\r\n"
+								"Vary: Accept-Encoding\r\n"
+								"\r\n")
+
+constexpr size_t dataSize{1024};
+
+volatile uint32_t sink;
+
+// Read stream to completion, returning number of bytes produced
+size_t drain(IDataSourceStream& stream)
+{
+	char buffer[256];
+	size_t total{0};
+	while(!stream.isFinished()) {
+		auto len = stream.readMemoryBlock(buffer, sizeof(buffer));
+		stream.seek(len);
+		total += len;
+	}
+	return total;
+}
+
+IDataSourceStream* createSource(const uint8_t* data)
+{
+	auto source = new MemoryDataStream;
+	source->write(data, dataSize);
+	return source;
+}
+
+} // namespace
+
+class NetworkBenchmarkTest : public TestGroup
+{
+public:
+	NetworkBenchmarkTest() : TestGroup(_F("Network benchmark"))
+	{
+	}
+
+	void execute() override
+	{
+		uint8_t data[dataSize];
+		os_get_random(data, sizeof(data));
+
+		TEST_CASE("Base64OutputStream")
+		{
+			Benchmark::run(F("Base64OutputStream 1K"), 100, [&]() {
+				Base64OutputStream stream(createSource(data));
+				sink = drain(stream);
+			});
+		}
+
+		TEST_CASE("Encoding kernels")
+		{
+			String encoded;
+			Benchmark::run(F("base64_encode 1K"), [&]() { encoded = base64_encode(data, dataSize); });
+			String decoded;
+			Benchmark::run(F("base64_decode 1K"), [&]() { decoded = base64_decode(encoded); });
+			REQUIRE(decoded.length() == dataSize && memcmp(decoded.c_str(), data, dataSize) == 0);
+
+			Benchmark::run(F("makeHexString 1K"), [&]() { sink = makeHexString(data, dataSize).length(); });
+
+			String query;
+			for(unsigned i = 0; i < 32; ++i) {
+				query += F("name=Some value&path=/a/b?c#d ");
+			}
+			Benchmark::run(F("uri_escape 1K"), [&]() { encoded = uri_escape(query); });
+			Benchmark::run(F("uri_unescape 1K"), [&]() { decoded = uri_unescape(encoded); });
+			REQUIRE(decoded == query);
+		}
+
+		TEST_CASE("ChunkedStream")
+		{
+			Benchmark::run(F("ChunkedStream 1K"), 100, [&]() {
+				ChunkedStream stream(createSource(data));
+				sink = drain(stream);
+			});
+		}
+
+		TEST_CASE("HTTP parser")
+		{
+			String response = httpResponse;
+			char buffer[512];
+			auto len = response.length();
+			BasicHttpHeaders headers;
+			Benchmark::run(F("HTTP parse response headers"), [&]() {
+				// Parsing is done in-place so requires a fresh copy each time
+				memcpy(buffer, response.c_str(), len);
+				headers.clear();
+				sink = unsigned(headers.parse(buffer, len, HTTP_RESPONSE));
+			});
+			REQUIRE_EQ(headers.count(), 8);
+		}
+	}
+};
+
+void REGISTER_TEST(NetworkBenchmark)
+{
+	registerGroup<NetworkBenchmarkTest>();
+}
@@ -3,6 +3,9 @@
 #include <Crypto/Sha1.h>
 #include <Crypto/Sha2.h>
 #include <Crypto/Blake2s.h>
+#include <SmingVersion.h>
+#include <Data/Stream/FlashMemoryStream.h>
+#include <memory>
 #include "Crypto/AxHash.h"
 #include "Crypto/BrHash.h"
 
@@ -67,6 +70,10 @@ class CryptoTest : public TestGroup
 {
 public:
 	static constexpr unsigned iterations = 100;
+	// Throughput measurements hash this much data, in various chunk sizes
+	static constexpr size_t throughputDataSize = 2048;
+	static constexpr unsigned throughputIterations = 10;
+	static constexpr size_t throughputChunkSizes[]{16, 64, 512, 2048};
 
 	CryptoTest() : TestGroup(_F("crypto")), hmacKey(FS_hmacKey), plainText(FS_plainText)
 	{
@@ -132,6 +139,15 @@ public:
 		Serial.print(": ");
 		Serial.println(hashText);
 		REQUIRE(hashText == expectedHash);
+
+		// Pre-computed key may be re-used
+		typename Context::Key key{String(FS_hmacKey)};
+		REQUIRE(Crypto::toString(Context(key).calculate(FS_plainText)) == expectedHash);
+		REQUIRE(Crypto::toString(Context(key).calculate(FS_plainText)) == expectedHash);
+
+		// Message from stream
+		FlashMemoryStream stream(FS_plainText);
+		REQUIRE(Crypto::toString(Context(key).calculate(stream)) == expectedHash);
 	}
 
 	template <class Context> void benchmarkHash(const String& expected)
@@ -158,6 +174,67 @@ public:
 		Serial.println(times);
 	}
 
+	/*
+	 * Measure the cost of hashing a block of data incrementally, including finalisation.
+	 * The best of several runs is reported, as this is least disturbed by interrupts and cache effects.
+	 */
+	template <class Context, typename... Args> void measureThroughput(const String& kind, Args&&... args)
+	{
+		for(auto chunkSize : throughputChunkSizes) {
+			CpuCycleTimes times(Context::Engine::name);
+			for(unsigned i = 0; i < throughputIterations; ++i) {
+				Context ctx(args...);
+				times.start();
+				for(size_t pos = 0; pos < throughputDataSize; pos += chunkSize) {
+					ctx.update(&throughputData[pos], chunkSize);
+				}
+				auto hash = ctx.getHash();
+				times.update();
+				(void)hash;
+			}
+			printThroughput(kind, Context::Engine::name, chunkSize, times.getMin());
+		}
+	}
+
+	/*
+	 * Results are written as CSV lines prefixed with `#hash,` so they can be extracted from the test log.
+	 */
+	void printThroughputHeader()
+	{
+		Serial.println(_F("#hash,arch,soc,cpu_mhz,kind,engine,chunk_size,data_size,cycles,cycles_per_byte"));
+	}
+
+	void printThroughput(const String& kind, const char* engine, size_t chunkSize, uint32_t cycles)
+	{
+		Serial.print(_F("#hash," MACROQUOTE(SMING_ARCH) "," MACROQUOTE(SMING_SOC) ","));
+		Serial.print(System.getCpuFrequency());
+		Serial.print(',');
+		Serial.print(kind);
+		Serial.print(',');
+		Serial.print(engine);
+		Serial.print(',');
+		Serial.print(chunkSize);
+		Serial.print(',');
+		Serial.print(throughputDataSize);
+		Serial.print(',');
+		Serial.print(cycles);
+		Serial.print(',');
+		Serial.println(double(cycles) / throughputDataSize, 2);
+	}
+
+	template <class Context> void benchmarkHmacKey(const String& expected)
+	{
+		typename Context::Key key(hmacKey);
+		MicroTimes times(String(Context::Engine::name) + _F(" (key)"));
+		for(unsigned i = 0; i < iterations; ++i) {
+			times.start();
+			auto hash = Context(key).calculate(plainText);
+			times.update();
+			TEST_ASSERT(Crypto::toString(hash) == expected);
+		}
+		Serial.println(times);
+	}
+
 	void benchmarkFunction(const String& title, Delegate<void()> func)
 	{
 		MicroTimes times(title);
@@ -176,14 +253,27 @@ public:
 			TEST_CASE("Crypto Hashes")
 			{
 				checkHash<Crypto::Md5>(MD5_HASH, MD5_STATE);
-				checkHash<Crypto::Sha1>(SHA1_HASH, SHA1_STATE);
-				checkHash<Crypto::Sha224>(SHA224_HASH, SHA224_STATE);
-				checkHash<Crypto::Sha256>(SHA256_HASH, SHA256_STATE);
-				checkHash<Crypto::Sha384>(SHA384_HASH, SHA384_STATE);
-				checkHash<Crypto::Sha512>(SHA512_HASH, SHA512_STATE);
+				checkHash<Crypto::HashContext<Crypto::Sha1Engine>>(SHA1_HASH, SHA1_STATE);
+				checkHash<Crypto::HashContext<Crypto::Sha224Engine>>(SHA224_HASH, SHA224_STATE);
+				checkHash<Crypto::HashContext<Crypto::Sha256Engine>>(SHA256_HASH, SHA256_STATE);
+				checkHash<Crypto::HashContext<Crypto::Sha384Engine>>(SHA384_HASH, SHA384_STATE);
+				checkHash<Crypto::HashContext<Crypto::Sha512Engine>>(SHA512_HASH, SHA512_STATE);
+				// Default contexts may be hardware-accelerated
+				checkHash<Crypto::Sha1>(SHA1_HASH);
+				checkHash<Crypto::Sha224>(SHA224_HASH);
+				checkHash<Crypto::Sha256>(SHA256_HASH);
+				checkHash<Crypto::Sha384>(SHA384_HASH);
+				checkHash<Crypto::Sha512>(SHA512_HASH);
 				checkHash<Crypto::Blake2s128>(BLAKE2S_128_HASH);
 				checkHash<Crypto::Blake2s256>(BLAKE2S_256_HASH);
 				checkHash<Crypto::Blake2s256>(BLAKE2S_256_HASH_KEYED, hmacKey);
+
+				// Aligned blocks are read in place, others copied first
+				String text(FS_plainText);
+				String tail = text.substring(1);
+				auto unaligned = Crypto::Blake2s256().calculate(text.c_str() + 1, text.length() - 1);
+				auto aligned = Crypto::Blake2s256().calculate(tail.c_str(), tail.length());
+				REQUIRE(unaligned == aligned);
 			}
 			break;
 
@@ -338,6 +428,9 @@ public:
 				benchmarkHmac<Crypto::HmacSha384>(SHA384_HMAC);
 				benchmarkHmac<Crypto::HmacSha512>(SHA512_HMAC);
 				benchmarkHmac<Crypto::HmacBlake2s256>(BLAKE2S_256_HMAC);
+				benchmarkHmacKey<Crypto::HmacMd5>(MD5_HMAC);
+				benchmarkHmacKey<Crypto::HmacSha1>(SHA1_HMAC);
+				benchmarkHmacKey<Crypto::HmacSha256>(SHA256_HMAC);
 			}
 			break;
 
@@ -367,6 +460,36 @@ public:
 			}
 			break;
 
+		case 11:
+			TEST_CASE("Hash throughput")
+			{
+				throughputData.reset(new uint8_t[throughputDataSize]);
+				for(size_t i = 0; i < throughputDataSize; ++i) {
+					throughputData[i] = uint8_t(i * 7);
+				}
+
+				printThroughputHeader();
+				String hash = F("hash");
+				measureThroughput<Crypto::Md5>(hash);
+				measureThroughput<Crypto::Sha1>(hash);
+				measureThroughput<Crypto::Sha224>(hash);
+				measureThroughput<Crypto::Sha256>(hash);
+				measureThroughput<Crypto::Sha384>(hash);
+				measureThroughput<Crypto::Sha512>(hash);
+				measureThroughput<Crypto::Blake2s128>(hash);
+				measureThroughput<Crypto::Blake2s256>(hash);
+
+				String hmac = F("hmac");
+				measureThroughput<Crypto::HmacMd5>(hmac, hmacKey);
+				measureThroughput<Crypto::HmacSha1>(hmac, hmacKey);
+				measureThroughput<Crypto::HmacSha256>(hmac, hmacKey);
+				measureThroughput<Crypto::HmacSha512>(hmac, hmacKey);
+				measureThroughput<Crypto::HmacBlake2s256>(hmac, hmacKey);
+
+				throughputData.reset();
+			}
+			break;
+
 		default:
 			complete();
 			return;
@@ -382,8 +505,11 @@ private:
 	// Pre-load this from flash so as not to skew benchmarks
 	String hmacKey;
 	String plainText;
+	std::unique_ptr<uint8_t[]> throughputData;
 };
 
+constexpr size_t CryptoTest::throughputChunkSizes[];
+
 void REGISTER_TEST(Crypto)
 {
 	registerGroup<CryptoTest>();
@@ -2,6 +2,10 @@
 
 #include "Network/Http/HttpCommon.h"
 #include "Network/Http/HttpHeaders.h"
+#include "Network/Http/HttpRequest.h"
+#include "Network/Http/HttpResourceTree.h"
+#include "Network/Http/HttpDigest.h"
+#include "Network/Http/HttpRange.h"
 #include <Data/WebConstants.h>
 #include <Platform/Timers.h>
 
@@ -17,6 +21,44 @@ public:
 		testHttpCommon();
 		testHttpHeaders();
 		profileHttpHeaders();
+		testResourceTree();
+	}
+
+	void testResourceTree()
+	{
+		HttpResourceTree tree;
+		auto devices = tree.set("/api/devices", HttpPathDelegate{});
+		auto device = tree.set("/api/devices/{id}", HttpPathDelegate{});
+		auto status = tree.set("/api/devices/{id}/status", HttpPathDelegate{});
+		auto list = tree.set("/api/devices/list", HttpPathDelegate{});
+		auto files = tree.set("/files/*", HttpPathDelegate{});
+		tree.setDefault(HttpPathDelegate{});
+
+		TEST_CASE("HttpResourceTree::route")
+		{
+			HttpParams params;
+			REQUIRE(tree.route("/api/devices") == devices);
+			REQUIRE(tree.route("/api/devices/list") == list);
+			REQUIRE(tree.route("/api/devices/12", &params) == device);
+			REQUIRE_EQ(params["id"], "12");
+			params.clear();
+			REQUIRE(tree.route("/api/devices/list/status", &params) == status);
+			REQUIRE_EQ(params["id"], "list");
+			params.clear();
+			REQUIRE(tree.route("/files/web/index.html", &params) == files);
+			REQUIRE_EQ(params["*"], "web/index.html");
+			REQUIRE(tree.route("/api/dev") == nullptr);
+			REQUIRE(tree.route("/api/devices/12/unknown") == nullptr);
+			REQUIRE(tree.route("*") == nullptr);
+		}
+
+		TEST_CASE("HttpResourceTree::route after remove")
+		{
+			tree.remove("/api/devices/list");
+			HttpParams params;
+			REQUIRE(tree.route("/api/devices/list", &params) == device);
+			REQUIRE_EQ(params["id"], "list");
+		}
 	}
 
 	void testHttpCommon()
@@ -149,6 +191,23 @@ public:
 		headers.clear();
 		REQUIRE(headers.count() == 0);
 
+		TEST_CASE("Field name lookup")
+		{
+			HttpHeaderFields fields;
+			for(unsigned i = 1; i < unsigned(HTTP_HEADER_CUSTOM); ++i) {
+				auto field = HttpHeaderFieldName(i);
+				String name = fields.toString(field);
+				REQUIRE(fields.fromString(name) == field);
+				name.toUpperCase();
+				REQUIRE(fields.fromString(name) == field);
+			}
+			REQUIRE(fields.fromString("Content-Lengthy") == HTTP_HEADER_UNKNOWN);
+			REQUIRE(fields.fromString("") == HTTP_HEADER_UNKNOWN);
+			auto custom = fields.findOrCreate("X-Custom");
+			REQUIRE(custom == HTTP_HEADER_CUSTOM);
+			REQUIRE(fields.fromString("x-custom") == custom);
+		}
+
 		TEST_CASE("Non-existent (const)")
 		{
 			const HttpHeaders& constHeaders = headers;
@@ -215,6 +274,112 @@ public:
 			// But fail on actual append
 			REQUIRE(headers2.append(HTTP_HEADER_CONTENT_LENGTH, "1234") == false);
 		}
+
+		TEST_CASE("HttpRequest::acceptsEncoding")
+		{
+			REQUIRE(HttpRequest::acceptsEncoding(F("gzip, deflate, br"), F("gzip")));
+			REQUIRE(HttpRequest::acceptsEncoding(F("deflate, GZIP;q=0.5"), F("gzip")));
+			REQUIRE(HttpRequest::acceptsEncoding(F("*"), F("gzip")));
+			REQUIRE(!HttpRequest::acceptsEncoding(F("deflate"), F("gzip")));
+			REQUIRE(!HttpRequest::acceptsEncoding(F("gzip;q=0, *"), F("gzip")));
+			REQUIRE(!HttpRequest::acceptsEncoding(nullptr, F("gzip")));
+		}
+
+		TEST_CASE("HttpRange")
+		{
+			using Result = HttpRange::Result;
+			HttpRange range;
+			auto check = [&](const char* value, Result expected, uint32_t start = 0, uint32_t end = 0) {
+				Serial << value << endl;
+				REQUIRE(range.parseRange(value, 1000) == expected);
+				if(expected == Result::Ok) {
+					REQUIRE_EQ(range.start, start);
+					REQUIRE_EQ(range.end, end);
+				}
+			};
+			check("bytes=0-499", Result::Ok, 0, 499);
+			check("bytes=500-", Result::Ok, 500, 999);
+			check("bytes=-100", Result::Ok, 900, 999);
+			check("bytes=-5000", Result::Ok, 0, 999);
+			check("Bytes=900- 5000", Result::Ignore);
+			check("Bytes=900-5000", Result::Ok, 900, 999);
+			check("bytes=1000-", Result::Unsatisfiable);
+			check("bytes=-0", Result::Unsatisfiable);
+			check("bytes=0-1,5-6", Result::Ignore);
+			check("bytes=20-10", Result::Ignore);
+			check("bytes=-", Result::Ignore);
+			check("bytes=x-", Result::Ignore);
+			check("items=0-1", Result::Ignore);
+			check("bytes=0-99999999999", Result::Ignore);
+			REQUIRE(range.parseRange("bytes=0-", 0) == Result::Unsatisfiable);
+
+			REQUIRE(range.parseRange("bytes=100-199", 1000) == Result::Ok);
+			REQUIRE_EQ(range.length(), 100U);
+			String s = range.toString(1000);
+			REQUIRE_EQ(s, "bytes 100-199/1000");
+
+			uint32_t total;
+			range = HttpRange{};
+			REQUIRE(range.parseContentRange(s, &total));
+			REQUIRE_EQ(range.start, 100U);
+			REQUIRE_EQ(range.end, 199U);
+			REQUIRE_EQ(total, 1000U);
+			REQUIRE(range.parseContentRange("bytes 0-9/*", &total));
+			REQUIRE_EQ(total, 0U);
+			REQUIRE(!range.parseContentRange("bytes */1000"));
+			REQUIRE(!range.parseContentRange("bytes 0-1000/1000"));
+			REQUIRE(!range.parseContentRange("bytes 10-0/1000"));
+		}
+
+		TEST_CASE("Digest authentication")
+		{
+			// Example from RFC 2617
+			DEFINE_FSTR_LOCAL(challenge, "Digest realm=\"testrealm@host.com\", qop=\"auth,auth-int\", "
+										 "nonce=\"dcd98b7102dd2f0e8b11d0f600bfb0c093\", "
+										 "opaque=\"5ccc069c403ebaf9f0171e9517f40e41\"")
+			HttpParams params;
+			REQUIRE(HttpDigest::parseParams(challenge, params));
+			REQUIRE_EQ(params.count(), 4);
+			REQUIRE_EQ(params["realm"], "testrealm@host.com");
+			REQUIRE(HttpDigest::hasQopAuth(params["qop"]));
+			REQUIRE(!HttpDigest::parseParams(F("Basic realm=\"x\""), params));
+
+			String ha1 = HttpDigest::calculateHa1(F("Mufasa"), params["realm"], F("Circle Of Life"));
+			REQUIRE_EQ(HttpDigest::calculateResponse(ha1, F("dcd98b7102dd2f0e8b11d0f600bfb0c093"), F("00000001"),
+													 F("0a4f113b"), F("auth"), HTTP_GET, F("/dir/index.html")),
+					   F("6629fae49393a05397450978507c4ef1"));
+
+			HttpDigestAuth auth(F("Mufasa"), F("Circle Of Life"));
+			HttpRequest request(Url(F("/dir/index.html")));
+			auth.setRequest(&request);
+			auth.prepareRequest(&request);
+			REQUIRE(!request.headers.contains(HTTP_HEADER_AUTHORIZATION));
+
+			HttpResponse response;
+			response.code = HTTP_STATUS_UNAUTHORIZED;
+			response.headers[HTTP_HEADER_WWW_AUTHENTICATE] = challenge;
+			auth.setResponse(&response);
+			REQUIRE_EQ(request.retries, 1);
+
+			auto checkAuthorization = [&](const char* nc) {
+				auth.prepareRequest(&request);
+				HttpParams authParams;
+				REQUIRE(HttpDigest::parseParams(request.headers[HTTP_HEADER_AUTHORIZATION], authParams));
+				REQUIRE_EQ(authParams["nc"], nc);
+				REQUIRE_EQ(authParams["opaque"], params["opaque"]);
+				String expected = HttpDigest::calculateResponse(ha1, authParams["nonce"], nc, authParams["cnonce"],
+																F("auth"), HTTP_GET, authParams["uri"]);
+				REQUIRE_EQ(authParams["response"], expected);
+			};
+			checkAuthorization("00000001");
+			// Subsequent requests re-use the challenge
+			checkAuthorization("00000002");
+
+			// Rejection of a nonce which has already been used is final
+			request.retries = 0;
+			auth.setResponse(&response);
+			REQUIRE_EQ(request.retries, 0);
+		}
 	}
 };
 
@@ -0,0 +1,87 @@
+#include <HostTests.h>
+
+#include <Network/Mqtt/MqttTopicTree.h>
+#include <Network/Mqtt/MqttPayloadParser.h>
+
+class MqttTest : public TestGroup
+{
+public:
+	MqttTest() : TestGroup(_F("Mqtt"))
+	{
+	}
+
+	void execute() override
+	{
+		TEST_CASE("MqttTopicTree")
+		{
+			MqttTopicTree<int> tree;
+			REQUIRE(tree.add("a/b/c", 1));
+			REQUIRE(tree.add("a/+/c", 2));
+			REQUIRE(tree.add("a/#", 3));
+			REQUIRE(tree.add("+/b/+", 4));
+			REQUIRE(tree.add("$SYS/#", 5));
+			REQUIRE(tree.add("#", 6));
+
+			REQUIRE(!tree.add("", 0));
+			REQUIRE(!tree.add("a/b#", 0));
+			REQUIRE(!tree.add("a/#/c", 0));
+			REQUIRE(!tree.add("a+/b", 0));
+
+			auto match = [&](const char* topic) {
+				String s;
+				tree.match(topic, [&](int& value) { s += value; });
+				debug_i("'%s' matches %s", topic, s.c_str());
+				return s;
+			};
+
+			REQUIRE_EQ(match("a/b/c"), "12346");
+			REQUIRE_EQ(match("a"), "36");
+			REQUIRE_EQ(match("a/x/c"), "236");
+			REQUIRE_EQ(match("z/b/z"), "46");
+			// Wildcards never match topics starting with '$'
+			REQUIRE_EQ(match("$SYS/uptime"), "5");
+
+			REQUIRE(tree.remove("#"));
+			REQUIRE(tree.remove("a/#"));
+			REQUIRE(!tree.remove("a/b"));
+			REQUIRE_EQ(match("a/b/c"), "124");
+			REQUIRE_EQ(match("a"), "");
+
+			tree.clear();
+			REQUIRE(tree.isEmpty());
+		}
+
+		TEST_CASE("streamPayloadParser")
+		{
+			String received;
+			size_t totalLength{0};
+			auto parser = streamPayloadParser([&](const mqtt_message_t&, const char* data, size_t length, size_t offset) {
+				if(data == nullptr) {
+					totalLength = offset;
+				} else {
+					REQUIRE_EQ(offset, received.length());
+					received.concat(data, length);
+				}
+				return 0;
+			});
+
+			mqtt_message_t message{};
+			MqttPayloadParserState state{};
+			const char* fragments[]{"Large ", "payloads ", "arrive ", "in pieces"};
+			REQUIRE_EQ(parser(state, &message, nullptr, MQTT_PAYLOAD_PARSER_START), 0);
+			for(auto fragment : fragments) {
+				REQUIRE_EQ(parser(state, &message, fragment, strlen(fragment)), 0);
+			}
+			REQUIRE_EQ(parser(state, &message, nullptr, MQTT_PAYLOAD_PARSER_END), 0);
+			REQUIRE_EQ(received, "Large payloads arrive in pieces");
+			REQUIRE_EQ(totalLength, received.length());
+			// Payload is never buffered
+			REQUIRE(message.publish.content.data == nullptr);
+		}
+	}
+};
+
+void REGISTER_TEST(Mqtt)
+{
+	registerGroup<MqttTest>();
+}
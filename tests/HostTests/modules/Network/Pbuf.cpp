@@ -0,0 +1,127 @@
+#include <HostTests.h>
+
+#include <Network/PbufCursor.h>
+#include <Network/NetUtils.h>
+
+namespace
+{
+/*
+ * Build a chain on the stack so no lwip heap is required.
+ * An empty segment is included to check it's skipped.
+ */
+class TestChain
+{
+public:
+	TestChain()
+	{
+		const char* parts[]{"GET /in", "dex.html HTTP/1.1\r", "", "\nHost: x\r\n", "\r\n"};
+		memset(bufs, 0, sizeof(bufs));
+		uint16_t total{0};
+		for(unsigned i = 0; i < count; ++i) {
+			total += strlen(parts[i]);
+		}
+		for(unsigned i = 0; i < count; ++i) {
+			auto& buf = bufs[i];
+			buf.payload = const_cast<char*>(parts[i]);
+			buf.len = strlen(parts[i]);
+			buf.tot_len = total;
+			total -= buf.len;
+			buf.next = (i + 1 < count) ? &bufs[i + 1] : nullptr;
+		}
+	}
+
+	operator const pbuf*() const
+	{
+		return &bufs[0];
+	}
+
+	static constexpr unsigned count{5};
+	pbuf bufs[count];
+};
+
+} // namespace
+
+class PbufTest : public TestGroup
+{
+public:
+	PbufTest() : TestGroup(_F("Pbuf"))
+	{
+	}
+
+	void execute() override
+	{
+		TestChain chain;
+		const String text = F("GET /index.html HTTP/1.1\r\nHost: x\r\n\r\n");
+
+		TEST_CASE("Search")
+		{
+			NetUtils::PbufCursor cursor(chain);
+			REQUIRE_EQ(cursor.length(), text.length());
+			REQUIRE_EQ(cursor.find(' '), text.indexOf(' '));
+			REQUIRE_EQ(cursor.find("\r\n"), text.indexOf("\r\n"));
+			REQUIRE_EQ(cursor.find("index"), text.indexOf("index"));
+			REQUIRE_EQ(cursor.find("\r\n\r\n"), text.indexOf("\r\n\r\n"));
+			REQUIRE_EQ(cursor.find("missing"), -1);
+			REQUIRE_EQ(cursor.find('H', 10), -1);
+			REQUIRE_EQ(cursor.find("index", 5, 9), -1);
+			REQUIRE_EQ(cursor.find("index", 5, 10), 5);
+			REQUIRE(cursor.startsWith("GET /index"));
+			REQUIRE_EQ(cursor.position(), 0U);
+		}
+
+		TEST_CASE("Lines")
+		{
+			NetUtils::PbufCursor cursor(chain);
+			Vector<String> lines;
+			int eol;
+			while((eol = cursor.find("\r\n")) >= 0) {
+				lines.add(cursor.readString(eol - cursor.position()));
+				REQUIRE(cursor.advance(2));
+			}
+			REQUIRE(cursor.atEnd());
+			REQUIRE_EQ(lines.count(), 3U);
+			REQUIRE_EQ(lines[0], "GET /index.html HTTP/1.1");
+			REQUIRE_EQ(lines[1], "Host: x");
+			REQUIRE_EQ(lines[2], "");
+		}
+
+		TEST_CASE("Views and positioning")
+		{
+			NetUtils::PbufCursor cursor(chain);
+			REQUIRE(cursor.view(7) != nullptr);
+			REQUIRE(cursor.view(8) == nullptr);
+			const char* data;
+			REQUIRE_EQ(cursor.view(data), 7U);
+
+			REQUIRE(cursor.seek(24));
+			REQUIRE_EQ(cursor.read(), '\r');
+			REQUIRE_EQ(cursor.read(), '\n');
+			REQUIRE(cursor.startsWith("Host"));
+
+			REQUIRE(cursor.seek(4));
+			REQUIRE_EQ(cursor.peek(), '/');
+			char buffer[12]{};
+			REQUIRE_EQ(cursor.read(buffer, 11), 11U);
+			REQUIRE_EQ(String(buffer), "/index.html");
+
+			REQUIRE(cursor.seek(text.length()));
+			REQUIRE(cursor.atEnd());
+			REQUIRE_EQ(cursor.read(), -1);
+			REQUIRE(!cursor.seek(text.length() + 1));
+			REQUIRE(!cursor.advance(1));
+		}
+
+		TEST_CASE("NetUtils helpers")
+		{
+			REQUIRE_EQ(NetUtils::pbufFindStr(chain, "\r\n", 26), text.indexOf("\r\n", 26));
+			REQUIRE_EQ(NetUtils::pbufFindChar(chain, 'x'), text.indexOf('x'));
+			REQUIRE(NetUtils::pbufIsStrEqual(chain, "HTTP/1.1\r\nHost", 16));
+			REQUIRE_EQ(NetUtils::pbufStrCopy(chain, 4, 11), "/index.html");
+		}
+	}
+};
+
+void REGISTER_TEST(Pbuf)
+{
+	registerGroup<PbufTest>();
+}
@@ -0,0 +1,67 @@
+#include <HostTests.h>
+
+#include <Network/RateLimiter.h>
+
+class RateLimiterTest : public TestGroup
+{
+public:
+	RateLimiterTest() : TestGroup(_F("RateLimiter"))
+	{
+	}
+
+	void execute() override
+	{
+		IpAddress client1(192, 168, 1, 10);
+		IpAddress client2(192, 168, 1, 11);
+
+		TEST_CASE("Burst then refill")
+		{
+			Network::RateLimiter limiter(3, 1000);
+			uint32_t now = 5000;
+			for(unsigned i = 0; i < 3; ++i) {
+				REQUIRE(limiter.allow(client1, now));
+			}
+			REQUIRE(!limiter.allow(client1, now));
+			REQUIRE_EQ(limiter.getRetryTime(client1, now), 1000U);
+			REQUIRE_EQ(limiter.getRetryTime(client1, now + 400), 600U);
+
+			// Other clients unaffected
+			REQUIRE(limiter.allow(client2, now));
+
+			REQUIRE(limiter.allow(client1, now + 1000));
+			REQUIRE(!limiter.allow(client1, now + 1500));
+			REQUIRE(limiter.allow(client1, now + 2000));
+
+			// Long idle period restores at most `burst` tokens
+			now += 60000;
+			for(unsigned i = 0; i < 3; ++i) {
+				REQUIRE(limiter.allow(client1, now));
+			}
+			REQUIRE(!limiter.allow(client1, now));
+
+			auto& stats = limiter.getStats();
+			REQUIRE_EQ(stats.allowed, 9U);
+			REQUIRE_EQ(stats.rejected, 3U);
+		}
+
+		TEST_CASE("Least recently seen client evicted")
+		{
+			Network::RateLimiter limiter(1, 10000);
+			uint32_t now = 0;
+			REQUIRE(limiter.allow(client1, now));
+			REQUIRE(!limiter.allow(client1, ++now));
+			for(unsigned i = 0; i < RATE_LIMITER_TABLE_SIZE; ++i) {
+				IpAddress ip(10, 0, 0, i + 1);
+				REQUIRE(limiter.allow(ip, ++now));
+			}
+			REQUIRE_EQ(limiter.getStats().evictions, 1U);
+			REQUIRE_EQ(limiter.getRetryTime(client1, now), 0U);
+			REQUIRE(limiter.allow(client1, ++now));
+		}
+	}
+};
+
+void REGISTER_TEST(RateLimiter)
+{
+	registerGroup<RateLimiterTest>();
+}
@@ -45,6 +45,52 @@ public:
 			testUrl(FS_URL3, "81e66a3a");
 		}
 
+		TEST_CASE("FormUrlStreamParser")
+		{
+			DEFINE_FSTR_LOCAL(FS_body, "name=Mary+had+a+little+lamb%2c&big=It%27s+fleece+was+very+red%2&empty=&last=%41%4")
+
+			// Feed body in chunks of the given size so escapes are split
+			auto parse = [this](FormUrlStreamParser& parser, HttpRequest& request, unsigned chunkSize) {
+				String body = FS_body;
+				auto delegate = parser.getDelegate();
+				delegate(request, nullptr, PARSE_DATASTART);
+				for(unsigned pos = 0; pos < body.length(); pos += chunkSize) {
+					auto len = std::min(size_t(chunkSize), body.length() - pos);
+					REQUIRE_EQ(delegate(request, body.c_str() + pos, len), len);
+				}
+				delegate(request, nullptr, PARSE_DATAEND);
+			};
+
+			for(unsigned chunkSize : {1, 2, 3, 7, 100}) {
+				FormUrlStreamParser parser;
+				HttpRequest request;
+				request.setFile(F("big"), new MemoryDataStream);
+				parse(parser, request, chunkSize);
+				printParams(request.postParams);
+				REQUIRE_EQ(request.postParams.count(), 3);
+				REQUIRE(request.getPostParameter("name") == F("Mary had a little lamb,"));
+				REQUIRE(request.getPostParameter("empty") == "");
+				REQUIRE(request.getPostParameter("last") == "A%4");
+				auto stream = request.files.find(F("big"));
+				REQUIRE(stream != nullptr);
+				REQUIRE(stream->readString(1024) == F("It's fleece was very red%2"));
+			}
+
+			String fields;
+			FormUrlStreamParser parser([&](HttpRequest&, const String& name, const char* data, size_t length,
+										   bool complete) {
+				fields.concat(data, length);
+				if(complete) {
+					fields += '|';
+				}
+				return true;
+			});
+			HttpRequest request;
+			parse(parser, request, 5);
+			REQUIRE_EQ(request.postParams.count(), 0);
+			REQUIRE(fields == F("Mary had a little lamb,|It's fleece was very red%2||A%4|"));
+		}
+
 		HttpRequest request;
 
 		TEST_CASE("HttpRequest getQueryParameter()")
@@ -54,6 +100,26 @@ public:
 			Serial << _F("cid = ") << request.getQueryParameter("cid") << endl;
 		}
 
+		TEST_CASE("Deferred query parsing")
+		{
+			DEFINE_FSTR_LOCAL(FS_query, "?a+b=Mary+had%20a&x&%63id=1&cid=2&c%=%zz")
+			HttpParams params;
+			params.setQuery(String(FS_query).c_str());
+			// Lookups scan the escaped query without parsing
+			REQUIRE_EQ(params.get("a b"), "Mary had a");
+			REQUIRE_EQ(params.get("cid"), "2");
+			REQUIRE_EQ(params.get("c%"), "%zz");
+			REQUIRE(!params.get("x"));
+			REQUIRE(!params.get("a"));
+			REQUIRE_EQ(params.toString(), FS_query);
+			HttpParams copy(params);
+			// Map access parses the query
+			REQUIRE_EQ(copy.count(), 4);
+			REQUIRE_EQ(copy["a b"], "Mary had a");
+			REQUIRE_EQ(copy.get("cid"), "2");
+			REQUIRE(params.get("c%") == copy["c%"]);
+		}
+
 		TEST_CASE("HttpRequest postParams test");
 		{
 			DEFINE_FSTR_LOCAL(FS_serializedParams,
@@ -1,6 +1,9 @@
 #include <HostTests.h>
 
 #include <Data/ObjectMap.h>
+#include <Data/ObjectPool.h>
+#include <Data/Arena.h>
+#include <Data/IntrusiveList.h>
 
 static unsigned objectCount = 0;
 
@@ -20,6 +23,18 @@ public:
 
 using TestMap = ObjectMap<String, TestClass>;
 
+class PooledTestClass : public TestClass, public PoolAllocated<PooledTestClass, 4>
+{
+};
+
+struct ListItem : public IntrusiveListHook<> {
+	ListItem(int value) : value(value)
+	{
+	}
+
+	int value;
+};
+
 class ObjectMapTest : public TestGroup
 {
 public:
@@ -89,6 +104,90 @@ public:
 			REQUIRE(map.count() == 0);
 			REQUIRE(objectCount == 0);
 		}
+
+		TEST_CASE("Pooled values")
+		{
+			auto& pool = PooledTestClass::getPool();
+			ObjectMap<String, PooledTestClass> pooledMap;
+			for(unsigned i = 0; i < 6; ++i) {
+				pooledMap[String(i)] = new PooledTestClass;
+			}
+			REQUIRE_EQ(objectCount, 6U);
+			REQUIRE_EQ(pool.getUsedCount(), 4U);
+			REQUIRE_EQ(pool.getHeapCount(), 2U);
+			REQUIRE(pool.owns(pooledMap["0"]));
+			REQUIRE(!pool.owns(pooledMap["5"]));
+
+			pooledMap.remove("1");
+			REQUIRE_EQ(pool.getUsedCount(), 3U);
+			pooledMap["6"] = new PooledTestClass;
+			REQUIRE_EQ(pool.getUsedCount(), 4U);
+
+			pooledMap.clear();
+			REQUIRE_EQ(objectCount, 0U);
+			REQUIRE_EQ(pool.getUsedCount(), 0U);
+			REQUIRE_EQ(pool.getHeapCount(), 0U);
+			REQUIRE_EQ(pool.getPeakCount(), 4U);
+		}
+
+		TEST_CASE("Arena")
+		{
+			Arena arena(64);
+			for(unsigned i = 0; i < 10; ++i) {
+				REQUIRE(arena.create<TestClass>() != nullptr);
+			}
+			REQUIRE(arena.allocate(100) != nullptr);
+			REQUIRE_EQ(objectCount, 10U);
+			REQUIRE(arena.getHeapCount() != 0);
+			REQUIRE(arena.getUsed() <= arena.getSize());
+
+			arena.reset();
+			REQUIRE_EQ(objectCount, 0U);
+			REQUIRE_EQ(arena.getUsed(), 0U);
+			REQUIRE_EQ(arena.getHeapCount(), 0U);
+		}
+
+		TEST_CASE("IntrusiveList")
+		{
+			IntrusiveList<ListItem> list;
+			REQUIRE(list.isEmpty());
+			REQUIRE(list.head() == nullptr);
+
+			ListItem a(1), b(2), c(3);
+			list.add(b);
+			list.add(c);
+			list.insert(a);
+			REQUIRE_EQ(list.count(), 3U);
+			REQUIRE_EQ(list.head()->value, 1);
+			REQUIRE_EQ(list.tail()->value, 3);
+
+			// Remove current item while iterating
+			int sum{0};
+			for(auto& item : list) {
+				sum += item.value;
+				if(item.value == 2) {
+					list.remove(item);
+				}
+			}
+			REQUIRE_EQ(sum, 6);
+			REQUIRE(!b.isLinked());
+			REQUIRE(!list.contains(b));
+			REQUIRE_EQ(list.count(), 2U);
+
+			// Objects unlink themselves when destroyed
+			{
+				ListItem d(4);
+				list.add(d);
+				REQUIRE_EQ(list.count(), 3U);
+			}
+			REQUIRE_EQ(list.count(), 2U);
+			REQUIRE_EQ(list.tail()->value, 3);
+
+			REQUIRE_EQ(list.pop()->value, 1);
+			list.clear();
+			REQUIRE(list.isEmpty());
+			REQUIRE(!c.isLinked());
+		}
 	}
 };
 
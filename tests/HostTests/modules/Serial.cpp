@@ -56,6 +56,37 @@ public:
 			REQUIRE(txbuf.available() == 0);
 			REQUIRE(compareBuffer == readBuffer);
 		}
+
+		TEST_CASE("SerialBuffer block write")
+		{
+			static constexpr size_t BUFSIZE = 64;
+			SerialBuffer buf;
+			buf.resize(BUFSIZE);
+
+			const char text[] = "The quick brown fox jumps over the lazy dog";
+			constexpr size_t textLen = sizeof(text) - 1;
+			REQUIRE_EQ(buf.write(text, textLen), textLen);
+			REQUIRE_EQ(buf.available(), textLen);
+
+			// Consume part so next write wraps around end of buffer
+			for(unsigned i = 0; i < 30; ++i) {
+				buf.readChar();
+			}
+			REQUIRE_EQ(buf.write(text, textLen), textLen);
+			REQUIRE_EQ(buf.available(), 2 * textLen - 30);
+
+			String s;
+			int c;
+			while((c = buf.readChar()) >= 0) {
+				s += char(c);
+			}
+			REQUIRE(s == String(&text[30]) + text);
+
+			// Write is limited by free space
+			REQUIRE_EQ(buf.write(text, textLen), textLen);
+			REQUIRE_EQ(buf.write(text, textLen), BUFSIZE - 1 - textLen);
+			REQUIRE(buf.isFull());
+		}
 	}
 };
 
@@ -1,6 +1,13 @@
 #include <HostTests.h>
 #include <Storage.h>
 #include <Storage/Debug.h>
+#include <Storage/CachedDevice.h>
+#include <Storage/MappedPartitionStream.h>
+#include <Storage/PartitionIndex.h>
+#include <Storage/PartitionSelector.h>
+#include <Storage/PartitionStream.h>
+#include <Storage/RecordLog.h>
+#include <Storage/SysMem.h>
 
 class TestDevice : public Storage::Device
 {
@@ -44,6 +51,55 @@ public:
 	}
 };
 
+// RAM-backed device which counts accesses
+class RamDevice : public Storage::Device
+{
+public:
+	String getName() const override
+	{
+		return F("ramDevice");
+	}
+
+	size_t getBlockSize() const override
+	{
+		return sizeof(uint32_t);
+	}
+
+	storage_size_t getSize() const override
+	{
+		return sizeof(data);
+	}
+
+	Type getType() const override
+	{
+		return Type::sysmem;
+	}
+
+	bool read(storage_size_t address, void* dst, size_t size) override
+	{
+		++readCount;
+		memcpy(dst, &data[address], size);
+		return true;
+	}
+
+	bool write(storage_size_t address, const void* src, size_t size) override
+	{
+		++writeCount;
+		memcpy(&data[address], src, size);
+		return true;
+	}
+
+	bool erase_range(storage_size_t address, storage_size_t size) override
+	{
+		memset(&data[address], 0xFF, size);
+		return true;
+	}
+
+	uint8_t data[4096]{};
+	unsigned readCount{0};
+	unsigned writeCount{0};
+};
+
 class PartitionTest : public TestGroup
 {
 public:
@@ -58,6 +114,24 @@ public:
 
 		listPartitions();
 
+		TEST_CASE("Partition index")
+		{
+			auto revision = Storage::PartitionIndex::getRevision();
+			auto part = dev->editablePartitions().add(F("indexTest"), Storage::Partition::SubType::Data::fwfs, 0, 0x1000);
+			REQUIRE(Storage::PartitionIndex::getRevision() != revision);
+			REQUIRE(Storage::findPartition(F("indexTest")) == part);
+			REQUIRE(!Storage::findPartition(F("indexTest2")));
+
+			unsigned count{0};
+			for(auto p : Storage::findPartition(Storage::Partition::SubType::Data::fwfs)) {
+				count += (p == part);
+			}
+			REQUIRE_EQ(count, 1U);
+
+			Storage::unRegisterDevice(dev);
+			REQUIRE(!Storage::findPartition(F("indexTest")));
+		}
+
 		delete dev;
 	}
 
@@ -88,7 +162,384 @@ public:
 	}
 };
 
+class CachedDeviceTest : public TestGroup
+{
+public:
+	CachedDeviceTest() : TestGroup(_F("CachedDevice"))
+	{
+	}
+
+	void execute() override
+	{
+		TEST_CASE("Read caching")
+		{
+			RamDevice ram;
+			for(unsigned i = 0; i < sizeof(ram.data); ++i) {
+				ram.data[i] = i;
+			}
+			Storage::CachedDevice cache(ram, 2);
+			uint8_t buf[16];
+			for(unsigned i = 0; i < 10; ++i) {
+				REQUIRE(cache.read(100 + i, buf, sizeof(buf)));
+			}
+			REQUIRE(buf[0] == 109);
+			REQUIRE_EQ(ram.readCount, 1U);
+			REQUIRE_EQ(cache.getMissCount(), 1U);
+			REQUIRE_EQ(cache.getHitCount(), 9U);
+
+			// Spans two sectors
+			REQUIRE(cache.read(510, buf, 4));
+			REQUIRE(buf[2] == uint8_t(512));
+			REQUIRE_EQ(ram.readCount, 2U);
+
+			// Evicts least recently used
+			REQUIRE(cache.read(1024, buf, 4));
+			REQUIRE(cache.read(0, buf, 4));
+			REQUIRE_EQ(ram.readCount, 4U);
+		}
+
+		TEST_CASE("Write back")
+		{
+			RamDevice ram;
+			Storage::CachedDevice cache(ram, 2);
+			uint8_t buf[]{1, 2, 3, 4};
+			REQUIRE(cache.write(10, buf, sizeof(buf)));
+			REQUIRE(cache.write(20, buf, sizeof(buf)));
+			REQUIRE(ram.data[10] == 0);
+			REQUIRE_EQ(ram.writeCount, 0U);
+			uint8_t tmp[4];
+			REQUIRE(cache.read(20, tmp, sizeof(tmp)));
+			REQUIRE(memcmp(tmp, buf, sizeof(buf)) == 0);
+			REQUIRE(cache.sync());
+			REQUIRE_EQ(ram.writeCount, 1U);
+			REQUIRE(ram.data[10] == 1 && ram.data[23] == 4);
+
+			// Erase discards cached data
+			REQUIRE(cache.write(100, buf, sizeof(buf)));
+			REQUIRE(cache.erase_range(0, 512));
+			REQUIRE(cache.read(100, tmp, 1));
+			REQUIRE(tmp[0] == 0xFF);
+		}
+
+		TEST_CASE("Write through")
+		{
+			RamDevice ram;
+			Storage::CachedDevice cache(ram, 2, Storage::CachedDevice::Policy::writeThrough);
+			uint8_t tmp[4];
+			REQUIRE(cache.read(10, tmp, sizeof(tmp)));
+			uint8_t buf[]{1, 2, 3, 4};
+			REQUIRE(cache.write(10, buf, sizeof(buf)));
+			REQUIRE(ram.data[10] == 1);
+			REQUIRE(cache.read(10, tmp, sizeof(tmp)));
+			REQUIRE(memcmp(tmp, buf, sizeof(buf)) == 0);
+			REQUIRE_EQ(ram.readCount, 1U);
+		}
+	}
+};
+
+class AsyncDeviceTest : public TestGroup
+{
+public:
+	AsyncDeviceTest() : TestGroup(_F("Async device operations"))
+	{
+	}
+
+	void execute() override
+	{
+		TEST_CASE("completeAsync")
+		{
+			uint8_t buf[1000];
+			memset(buf, 0xA5, sizeof(buf));
+			bool done{false};
+			REQUIRE(ram.write_async(100, buf, sizeof(buf), [&done](bool success) { done = success; }));
+			REQUIRE(ram.isBusy());
+			REQUIRE(!done);
+			REQUIRE(ram.completeAsync());
+			REQUIRE(done);
+			REQUIRE(!ram.isBusy());
+			REQUIRE_EQ(ram.writeCount, 4U);
+			REQUIRE(ram.data[99] == 0 && ram.data[100] == 0xA5 && ram.data[1099] == 0xA5 && ram.data[1100] == 0);
+		}
+
+		TEST_CASE("Misaligned erase rejected")
+		{
+			REQUIRE(!ram.erase_range_async(2, 8));
+		}
+
+		TEST_CASE("PartitionStream erase ahead")
+		{
+			RamDevice dev;
+			auto part = dev.editablePartitions().add(F("stream"), Storage::Partition::SubType::Data::fwfs, 0, 256);
+			Storage::PartitionStream stream(part, Storage::Mode::BlockErase);
+			for(unsigned i = 0; i < 10; ++i) {
+				REQUIRE_EQ(stream.write(pattern, 4), 4U);
+				REQUIRE(dev.completeAsync());
+			}
+			// Erasure stays one block ahead of the write position
+			REQUIRE(memcmp(&dev.data[36], pattern, 4) == 0);
+			REQUIRE(dev.data[40] == 0xFF && dev.data[43] == 0xFF && dev.data[44] == 0);
+		}
+
+		TEST_CASE("PartitionStream reserve")
+		{
+			RamDevice dev;
+			auto part = dev.editablePartitions().add(F("stream"), Storage::Partition::SubType::Data::fwfs, 0, 256);
+			Storage::PartitionStream readOnly(part);
+			REQUIRE(!readOnly.reserve(64));
+			Storage::PartitionStream stream(part, Storage::Mode::BlockErase);
+			REQUIRE(!stream.reserve(257));
+			REQUIRE(stream.reserve(64));
+			REQUIRE(dev.isBusy());
+			REQUIRE(dev.completeAsync());
+			REQUIRE(dev.data[0] == 0xFF && dev.data[63] == 0xFF && dev.data[64] == 0);
+			REQUIRE_EQ(stream.write(pattern, sizeof(pattern)), sizeof(pattern));
+			REQUIRE(!dev.isBusy());
+			REQUIRE(memcmp(dev.data, pattern, sizeof(pattern)) == 0);
+		}
+
+		TEST_CASE("Queued operations")
+		{
+			memset(ram.data, 0, sizeof(ram.data));
+			REQUIRE(ram.erase_range_async(0, 64));
+			REQUIRE(ram.write_async(16, pattern, sizeof(pattern), [this](bool success) {
+				REQUIRE(success);
+				REQUIRE(ram.data[0] == 0xFF && ram.data[63] == 0xFF && ram.data[64] == 0);
+				REQUIRE(memcmp(&ram.data[16], pattern, sizeof(pattern)) == 0);
+				REQUIRE(!ram.isBusy());
+				complete();
+			}));
+			REQUIRE(ram.data[0] == 0);
+			pending();
+		}
+	}
+
+private:
+	RamDevice ram;
+	const uint8_t pattern[8]{1, 2, 3, 4, 5, 6, 7, 8};
+};
+
+class MappedPartitionTest : public TestGroup
+{
+public:
+	MappedPartitionTest() : TestGroup(_F("Mapped partition"))
+	{
+	}
+
+	void execute() override
+	{
+		static const char content[]{"Memory-mapped partition content"};
+		auto part = Storage::sysMem.editablePartitions().add(F("mapTest"), Storage::Partition::SubType::Data::fwfs,
+															 uint32_t(content), sizeof(content) - 1,
+															 Storage::Partition::Flag::readOnly);
+		REQUIRE(part);
+
+		TEST_CASE("Partition::map")
+		{
+			REQUIRE(part.map(7, 6) == &content[7]);
+			REQUIRE(part.map(0, sizeof(content)) == nullptr);
+		}
+
+		TEST_CASE("MappedPartitionStream")
+		{
+			Storage::MappedPartitionStream stream(part, 7, 6);
+			REQUIRE(stream.isValid());
+			REQUIRE_EQ(stream.available(), 6);
+			const char* ptr;
+			REQUIRE_EQ(stream.peekRegion(ptr), 6U);
+			REQUIRE(ptr == &content[7]);
+			REQUIRE(stream.seek(3));
+			char buf[8]{};
+			REQUIRE_EQ(stream.readMemoryBlock(buf, sizeof(buf)), 3);
+			REQUIRE(String(buf) == F("ped"));
+			REQUIRE(stream.seek(3));
+			REQUIRE(stream.isFinished());
+		}
+
+		TEST_CASE("Unmappable device")
+		{
+			RamDevice ram;
+			auto ramPart = ram.editablePartitions().add(F("ram"), Storage::Partition::SubType::Data::fwfs, 0, 1024);
+			Storage::MappedPartitionStream stream(ramPart);
+			REQUIRE(!stream.isValid());
+			REQUIRE_EQ(stream.available(), 0);
+		}
+	}
+};
+
+class RecordLogTest : public TestGroup
+{
+public:
+	RecordLogTest() : TestGroup(_F("RecordLog"))
+	{
+	}
+
+	class SectorDevice : public RamDevice
+	{
+	public:
+		size_t getBlockSize() const override
+		{
+			return 512;
+		}
+	};
+
+	void execute() override
+	{
+		SectorDevice dev;
+		auto part = dev.editablePartitions().add(F("log"), Storage::Partition::SubType::Data::fwfs, 0, dev.getSize());
+
+		TEST_CASE("Append and read")
+		{
+			Storage::RecordLog log(part);
+			REQUIRE(log.begin());
+			REQUIRE_EQ(log.getCount(), 0U);
+			REQUIRE(log.append("hello", 5));
+			REQUIRE(log.append("world!", 6));
+			char buf[16];
+			REQUIRE_EQ(log.read(1, buf, sizeof(buf)), 6);
+			REQUIRE(memcmp(buf, "world!", 6) == 0);
+		}
+
+		TEST_CASE("Remount")
+		{
+			Storage::RecordLog log(part);
+			REQUIRE(log.begin());
+			REQUIRE_EQ(log.getFirstId(), 0U);
+			REQUIRE_EQ(log.getNextId(), 2U);
+		}
+
+		TEST_CASE("Sector rotation")
+		{
+			Storage::RecordLog log(part);
+			REQUIRE(log.begin());
+			auto writeCount = dev.writeCount;
+			uint8_t rec[100];
+			for(uint32_t i = 2; i < 100; ++i) {
+				memset(rec, i, sizeof(rec));
+				memcpy(rec, &i, sizeof(i));
+				REQUIRE(log.append(rec, sizeof(rec)));
+			}
+			REQUIRE(log.getFirstId() > 0);
+			REQUIRE_EQ(log.getNextId(), 100U);
+			// One write per record, plus sector headers (4 records per sector)
+			REQUIRE(dev.writeCount - writeCount <= 98 + 98 / 4 + 1);
+
+			uint32_t expectedId = log.getFirstId();
+			bool ok{true};
+			log.forEach([&](uint32_t id, const void* data, uint16_t length) {
+				uint32_t value;
+				memcpy(&value, data, sizeof(value));
+				ok &= (id == expectedId && value == id && length == sizeof(rec));
+				++expectedId;
+				return true;
+			});
+			REQUIRE(ok);
+			REQUIRE_EQ(expectedId, 100U);
+
+			REQUIRE_EQ(log.read(90, rec, sizeof(rec)), int(sizeof(rec)));
+			REQUIRE(rec[4] == 90);
+			REQUIRE_EQ(log.read(0, rec, sizeof(rec)), -1);
+		}
+
+		TEST_CASE("Incomplete write discarded")
+		{
+			// Corrupt content of final record
+			const uint8_t pattern[]{99, 99, 99, 99, 99, 99, 99, 99};
+			for(unsigned i = 0; i < sizeof(dev.data) - sizeof(pattern); ++i) {
+				if(memcmp(&dev.data[i], pattern, sizeof(pattern)) == 0) {
+					dev.data[i] = 0;
+					break;
+				}
+			}
+			Storage::RecordLog log(part);
+			REQUIRE(log.begin());
+			REQUIRE_EQ(log.getNextId(), 99U);
+			REQUIRE(log.append("x", 1));
+			char c;
+			REQUIRE_EQ(log.read(99, &c, 1), 1);
+			REQUIRE(c == 'x');
+		}
+
+		TEST_CASE("Format")
+		{
+			Storage::RecordLog log(part);
+			REQUIRE(log.begin());
+			REQUIRE(log.format());
+			REQUIRE_EQ(log.getCount(), 0U);
+		}
+	}
+};
+
+class PartitionSelectorTest : public TestGroup
+{
+public:
+	PartitionSelectorTest() : TestGroup(_F("PartitionSelector"))
+	{
+	}
+
+	void execute() override
+	{
+		dev.erase_range(0, dev.getSize());
+		auto& parts = dev.editablePartitions();
+		auto selector = parts.add(F("fsselect"), Storage::Partition::SubType::Data::fwfs, 0, 1024);
+		auto slot0 = parts.add(F("fs0"), Storage::Partition::SubType::Data::spiffs, 1024, 1536);
+		auto slot1 = parts.add(F("fs1"), Storage::Partition::SubType::Data::spiffs, 2560, 1536);
+
+		TEST_CASE("Default selection")
+		{
+			Storage::PartitionSelector sel(selector, slot0, slot1);
+			REQUIRE(sel.begin());
+			REQUIRE(sel.getActive() == slot0);
+			REQUIRE(sel.getSpare() == slot1);
+			REQUIRE(!Storage::PartitionSelector(selector, slot0, slot0).begin());
+		}
+
+		TEST_CASE("Update and commit")
+		{
+			Storage::PartitionSelector sel(selector, slot0, slot1);
+			REQUIRE(sel.begin());
+			REQUIRE(sel.createUpdateStream(2000) == nullptr);
+			std::unique_ptr<Storage::PartitionStream> stream(sel.createUpdateStream(600));
+			REQUIRE(stream);
+			uint8_t buf[100];
+			memset(buf, 0x5A, sizeof(buf));
+			for(unsigned i = 0; i < 6; ++i) {
+				REQUIRE_EQ(stream->write(buf, sizeof(buf)), sizeof(buf));
+			}
+			stream.reset();
+			REQUIRE(dev.data[2560] == 0x5A && dev.data[3159] == 0x5A);
+			// Active image untouched
+			REQUIRE(dev.data[1024] == 0xFF);
+			REQUIRE(sel.commit(600));
+			REQUIRE(sel.getActive() == slot1);
+		}
+
+		TEST_CASE("Selection persists")
+		{
+			Storage::PartitionSelector sel(selector, slot0, slot1);
+			REQUIRE(sel.begin());
+			REQUIRE(sel.getActive() == slot1);
+			REQUIRE_EQ(sel.getImageSize(), 600U);
+			// Log sectors are re-used
+			for(unsigned i = 0; i < 101; ++i) {
+				REQUIRE(sel.commit());
+			}
+			REQUIRE(sel.getActive() == slot0);
+			Storage::PartitionSelector sel2(selector, slot0, slot1);
+			REQUIRE(sel2.begin());
+			REQUIRE(sel2.getActive() == slot0);
+		}
+	}
+
+private:
+	RecordLogTest::SectorDevice dev;
+};
+
 void REGISTER_TEST(Storage)
 {
 	registerGroup<PartitionTest>();
+	registerGroup<CachedDeviceTest>();
+	registerGroup<AsyncDeviceTest>();
+	registerGroup<MappedPartitionTest>();
+	registerGroup<RecordLogTest>();
+	registerGroup<PartitionSelectorTest>();
 }
@@ -2,13 +2,23 @@
 #include <FlashString/TemplateStream.hpp>
 #include <Data/Stream/MemoryDataStream.h>
 #include <Data/Stream/LimitedMemoryStream.h>
+#include <Data/Stream/SegmentedMemoryStream.h>
+#include <Data/Stream/JsonWriterStream.h>
+#include <Data/JsonReader.h>
+#include <Data/Buffer/RingBuffer.h>
 #include <Data/Stream/XorOutputStream.h>
+#include <Data/Stream/RangeStream.h>
+#include <Data/Stream/PrefetchStream.h>
 #include <Data/Stream/SharedMemoryStream.h>
+#include <Data/Stream/StreamChain.h>
 #include <Data/WebHelpers/base64.h>
 #include <malloc_count.h>
+#include <cmath>
 
 #ifndef DISABLE_NETWORK
 #include <Data/Stream/ChunkedStream.h>
+#include <Data/Stream/DeflateOutputStream.h>
+#include <Data/Stream/InflateWriteStream.h>
 #endif
 
 DEFINE_FSTR_LOCAL(template1, "Stream containing {var1}, {var2} and {var3}. {} {{}} {{12345")
@@ -83,6 +93,43 @@ public:
 			REQUIRE(strlen(s.c_str()) == s.length());
 		}
 
+		TEST_CASE("copyTo")
+		{
+			String s(FS_abstract);
+			MemoryDataStream src;
+			src.print(s);
+
+			// Accepts no more than a given amount at a time
+			MemoryDataStream dest;
+			struct Throttled : public Print {
+				Print& out;
+				size_t limit;
+				Throttled(Print& out, size_t limit) : out(out), limit(limit)
+				{
+				}
+				size_t write(uint8_t c) override
+				{
+					return write(&c, 1);
+				}
+				size_t write(const uint8_t* buffer, size_t size) override
+				{
+					return out.write(buffer, std::min(size, limit));
+				}
+			} throttled(dest, 100);
+
+			size_t total{0};
+			size_t n;
+			while((n = src.copyTo(throttled, 1000)) != 0) {
+				REQUIRE(n <= 1000);
+				total += n;
+			}
+			REQUIRE_EQ(total, s.length());
+			REQUIRE(src.isFinished());
+			String copy;
+			REQUIRE(dest.moveString(copy));
+			REQUIRE(copy == s);
+		}
+
 		TEST_CASE("readString (PR #2468)")
 		{
 			FSTR::Stream stream(FS_abstract);
@@ -90,13 +137,231 @@ public:
 			REQUIRE(s == FS_abstract);
 		}
 
+		TEST_CASE("peekRegion")
+		{
+			MemoryDataStream mem;
+			const char* data;
+			REQUIRE(mem.peekRegion(data) == 0);
+			mem.print(FS_abstract);
+			REQUIRE(mem.peekRegion(data) == FS_abstract.length());
+			mem.seek(10);
+			REQUIRE(mem.peekRegion(data) == FS_abstract.length() - 10);
+			REQUIRE(memcmp(data, String(FS_abstract).c_str() + 10, 16) == 0);
+
+			LimitedMemoryStream limited(32);
+			REQUIRE(limited.peekRegion(data) == 0);
+			limited.print(_F("Some test data"));
+			REQUIRE(limited.peekRegion(data) == 14);
+			REQUIRE(memcmp(data, "Some test data", 14) == 0);
+		}
+
+		TEST_CASE("SegmentedMemoryStream")
+		{
+			String abstract(FS_abstract);
+			SegmentedMemoryStream seg(64);
+			const char* data;
+			REQUIRE(seg.peekRegion(data) == 0);
+
+			// Write in uneven pieces so writes straddle block boundaries
+			size_t pos{0};
+			for(size_t n = 1; pos < abstract.length(); n = (n * 7) % 97 + 1) {
+				n = std::min(n, abstract.length() - pos);
+				REQUIRE(seg.write(reinterpret_cast<const uint8_t*>(abstract.c_str()) + pos, n) == n);
+				pos += n;
+			}
+			REQUIRE_EQ(seg.getSize(), abstract.length());
+			REQUIRE(seg.getCapacity() - seg.getSize() < 64);
+
+			String s;
+			size_t len;
+			while((len = seg.peekRegion(data)) != 0) {
+				REQUIRE(len <= 64);
+				s.concat(data, len);
+				seg.seek(len);
+			}
+			REQUIRE(s == abstract);
+
+			REQUIRE(seg.seekFrom(100, SeekOrigin::Start) == 100);
+			char buf[200];
+			REQUIRE(seg.readMemoryBlock(buf, sizeof(buf)) == sizeof(buf));
+			REQUIRE(memcmp(buf, abstract.c_str() + 100, sizeof(buf)) == 0);
+			REQUIRE(seg.seekFrom(-10, SeekOrigin::End) == int(abstract.length() - 10));
+			REQUIRE(seg.readBytes(buf, sizeof(buf)) == 10);
+			REQUIRE(memcmp(buf, abstract.c_str() + abstract.length() - 10, 10) == 0);
+
+			REQUIRE(seg.moveString(s));
+			REQUIRE(s == abstract);
+			REQUIRE(seg.getSize() == 0);
+
+			SegmentedMemoryStream limited(16, 40);
+			REQUIRE(limited.write(reinterpret_cast<const uint8_t*>(abstract.c_str()), 100) == 40);
+		}
+
+		TEST_CASE("JsonWriter")
+		{
+			MemoryDataStream mem;
+			Format::JsonWriter json(mem);
+			json.beginObject();
+			json.add("text", "Quote\" slash\\ line\n\x01");
+			json.add("int", -12).add("big", uint64_t(1) << 40).add("float", 1.5).add("nan", NAN);
+			json.add("bool", true).add("null", nullptr);
+			json.beginArray("array").value(1).value("x").beginObject().end().beginArray().end().end();
+			json.end();
+			REQUIRE(!json.hasError());
+			REQUIRE_EQ(json.getDepth(), 0U);
+
+			String s;
+			mem.moveString(s);
+			REQUIRE_EQ(s, F("{\"text\":\"Quote\\\" slash\\\\ line\\n\\u0001\",\"int\":-12,\"big\":1099511627776,"
+							"\"float\":1.5,\"nan\":null,\"bool\":true,\"null\":null,\"array\":[1,\"x\",{},[]]}"));
+
+			json.end();
+			REQUIRE(json.hasError());
+		}
+
+		TEST_CASE("JsonWriterStream")
+		{
+			unsigned count{0};
+			JsonWriterStream stream([&count](Format::JsonWriter& json) -> bool {
+				if(count == 0) {
+					json.beginArray();
+				}
+				if(count == 100) {
+					return false;
+				}
+				json.beginObject().add("index", count).add("square", count * count).end();
+				++count;
+				return true;
+			});
+
+			String s;
+			while(!stream.isFinished()) {
+				char buf[37];
+				auto len = stream.readMemoryBlock(buf, sizeof(buf));
+				s.concat(buf, len);
+				stream.seek(len);
+			}
+			REQUIRE(!stream.hasError());
+			REQUIRE(s.startsWith(F("[{\"index\":0,\"square\":0},{\"index\":1,")));
+			REQUIRE(s.endsWith(F("{\"index\":99,\"square\":9801}]")));
+		}
+
+		TEST_CASE("JsonReader")
+		{
+			DEFINE_FSTR_LOCAL(doc, "{\"wifi\":{\"ssid\":\"My \\\"net\\\"\",\"pass\":\"\\u00e9\\ud83d\\ude00\"},"
+								   "\"list\":[1,true,null,{\"a\":[]}],\"channels\":[{\"level\":1},{\"level\":-2.5e1}]}")
+
+			auto parse = [](const String& json, const CStringArray& filter, size_t chunkSize, String& out) -> bool {
+				out = nullptr;
+				JsonReader reader([&out](const JsonReader::Element& element) -> bool {
+					out += unsigned(element.type);
+					out += ' ';
+					out += element.path;
+					out += '=';
+					out.concat(element.value, element.valueLength);
+					out += ';';
+					return true;
+				});
+				reader.setFilter(filter);
+				bool ok{true};
+				for(unsigned i = 0; i < json.length(); i += chunkSize) {
+					ok &= reader.parse(json.c_str() + i, std::min(chunkSize, json.length() - i));
+				}
+				return reader.end() && ok;
+			};
+
+			DEFINE_FSTR_LOCAL(filter, "wifi.ssid\0channels[*].level")
+
+			String ref;
+			REQUIRE(parse(doc, nullptr, 1024, ref));
+			REQUIRE_EQ(ref, F("0 =;0 wifi=;4 wifi.ssid=My \"net\";4 wifi.pass=\xc3\xa9\xf0\x9f\x98\x80;2 wifi=;1 list=;"
+							  "5 list[0]=1;6 list[1]=true;7 list[2]=null;0 list[3]=;1 list[3].a=;3 list[3].a=;2 list[3]=;"
+							  "3 list=;1 channels=;0 channels[0]=;5 channels[0].level=1;2 channels[0]=;0 channels[1]=;"
+							  "5 channels[1].level=-2.5e1;2 channels[1]=;3 channels=;2 =;"));
+
+			for(unsigned chunkSize = 1; chunkSize < 16; ++chunkSize) {
+				String s;
+				REQUIRE(parse(doc, nullptr, chunkSize, s));
+				REQUIRE_EQ(s, ref);
+			}
+
+			String s;
+			REQUIRE(parse(doc, CStringArray(filter), 3, s));
+			REQUIRE_EQ(s, F("4 wifi.ssid=My \"net\";5 channels[0].level=1;5 channels[1].level=-2.5e1;"));
+
+			for(auto bad : {"{\"a\":1,}", "[1,]", "[1 2]", "tru", "01", "[1}", "{}x", "[", "1."}) {
+				REQUIRE(!parse(bad, nullptr, 1, s));
+			}
+		}
+
+		TEST_CASE("RingBuffer")
+		{
+			RingBuffer<uint16_t, 16> ring;
+			REQUIRE_EQ(ring.space(), 16U);
+			REQUIRE(ring.isEmpty());
+
+			uint16_t input[32];
+			for(unsigned i = 0; i < ARRAY_SIZE(input); ++i) {
+				input[i] = i;
+			}
+			REQUIRE_EQ(ring.push(input, 20), 16U);
+			REQUIRE(!ring.push(input[0]));
+
+			uint16_t output[32];
+			REQUIRE_EQ(ring.pop(output, 10), 10U);
+			REQUIRE_EQ(output[9], 9);
+
+			// Wraps around end of buffer
+			REQUIRE_EQ(ring.push(&input[16], 10), 10U);
+			const uint16_t* data;
+			REQUIRE_EQ(ring.getReadRegion(data), 6U);
+			REQUIRE_EQ(data[0], 10);
+			ring.consume(6);
+			REQUIRE_EQ(ring.getReadRegion(data), 10U);
+			REQUIRE_EQ(data[0], 16);
+
+			uint16_t* space;
+			REQUIRE_EQ(ring.getWriteRegion(space), 6U);
+			space[0] = 100;
+			ring.produce(1);
+			REQUIRE_EQ(ring.pop(output, 32), 11U);
+			REQUIRE_EQ(output[9], 25);
+			REQUIRE_EQ(output[10], 100);
+			REQUIRE(ring.isEmpty());
+		}
+
+		TEST_CASE("StreamChain::peekRegion")
+		{
+			StreamChain chain;
+			auto header = new MemoryDataStream;
+			header->print(_F("header;"));
+			chain.attachStream(header);
+			chain.attachStream(new MemoryDataStream);
+			auto body = new LimitedMemoryStream(16);
+			body->print(_F("body"));
+			chain.attachStream(body);
+
+			String s;
+			const char* data;
+			size_t len;
+			while((len = chain.peekRegion(data)) != 0) {
+				s.concat(data, len);
+				chain.seek(len);
+			}
+			REQUIRE_EQ(s, "header;body");
+			REQUIRE(chain.isFinished());
+		}
+
 #ifndef DISABLE_NETWORK
 
-		TEST_CASE("ChunkedStream / StreamTransformer")
+		TEST_CASE("ChunkedStream")
 		{
 			DEFINE_FSTR_LOCAL(FS_INPUT, "Some test data");
 			DEFINE_FSTR_LOCAL(FS_OUTPUT, "E\r\nSome test data\r\n0\r\n\r\n");
 			ChunkedStream chunked(new FlashMemoryStream(FS_INPUT));
+			// Whole chunk, including last one, is a single region
+			const char* data;
+			REQUIRE_EQ(chunked.peekRegion(data), FS_OUTPUT.length());
 			MemoryDataStream output;
 			output.copyFrom(&chunked);
 			String s;
@@ -105,6 +370,85 @@ public:
 			REQUIRE(FS_OUTPUT == s);
 		}
 
+		TEST_CASE("ChunkedStream, multiple chunks")
+		{
+			// Buffer holds 19 bytes of data per chunk
+			ChunkedStream chunked(new FSTR::Stream(FS_abstract), 32);
+			String s = chunked.readString(1000000);
+			String content;
+			unsigned pos = 0;
+			unsigned chunkCount = 0;
+			for(;;) {
+				int crlf = s.indexOf("\r\n", pos);
+				REQUIRE(crlf > int(pos));
+				auto len = strtoul(s.substring(pos, crlf).c_str(), nullptr, 16);
+				pos = crlf + 2;
+				if(len == 0) {
+					break;
+				}
+				REQUIRE(len <= 19);
+				content += s.substring(pos, pos + len);
+				pos += len + 2;
+				++chunkCount;
+			}
+			REQUIRE_EQ(pos + 2, s.length());
+			REQUIRE(FS_abstract == content);
+			REQUIRE(chunkCount >= FS_abstract.length() / 19);
+		}
+
+		TEST_CASE("DeflateOutputStream")
+		{
+			DeflateOutputStream deflate(new FSTR::Stream(FS_abstract));
+			MemoryDataStream output;
+			output.copyFrom(&deflate);
+			REQUIRE(deflate.isFinished());
+			String s;
+			REQUIRE(output.moveString(s));
+			debug_i("Compressed %u -> %u bytes", FS_abstract.length(), s.length());
+			REQUIRE(s.length() < FS_abstract.length());
+			REQUIRE(memcmp(s.c_str(), "\x1f\x8b\x08", 3) == 0);
+			// Trailer ends with uncompressed size
+			uint32_t isize;
+			memcpy(&isize, s.c_str() + s.length() - 4, 4);
+			REQUIRE_EQ(isize, FS_abstract.length());
+		}
+
+		TEST_CASE("InflateWriteStream")
+		{
+			using Format = DeflateOutputStream::Format;
+			for(auto format : {Format::Gzip, Format::Zlib, Format::Raw}) {
+				DeflateOutputStream deflate(new FSTR::Stream(FS_abstract), format);
+				MemoryDataStream compressed;
+				compressed.copyFrom(&deflate);
+				String input;
+				REQUIRE(compressed.moveString(input));
+
+				// Write in slices of varying size, as from the network
+				InflateWriteStream inflate(new MemoryDataStream, InflateWriteStream::Format(format), 1024);
+				size_t pos{0};
+				for(unsigned i = 1; pos < input.length(); ++i) {
+					auto len = std::min(size_t(i * 7 % 97), input.length() - pos);
+					REQUIRE_EQ(inflate.write(reinterpret_cast<const uint8_t*>(input.c_str()) + pos, len), len);
+					pos += len;
+				}
+				REQUIRE(inflate.finish());
+				String output;
+				REQUIRE(inflate.moveString(output));
+				REQUIRE(FS_abstract == output);
+			}
+
+			// Truncated data
+			DeflateOutputStream deflate(new FSTR::Stream(FS_abstract));
+			MemoryDataStream compressed;
+			compressed.copyFrom(&deflate);
+			String input;
+			REQUIRE(compressed.moveString(input));
+			InflateWriteStream inflate(new MemoryDataStream);
+			inflate.write(reinterpret_cast<const uint8_t*>(input.c_str()), input.length() / 2);
+			REQUIRE(!inflate.finish());
+			REQUIRE(inflate.hasError());
+		}
+
 		TEST_CASE("MultipartStream / MultiStream")
 		{
 			unsigned itemIndex{0};
@@ -169,6 +513,67 @@ public:
 			debug_hex(DBG, "Text", unmaskedString.c_str(), unmaskedString.length());
 		}
 
+		TEST_CASE("RangeStream")
+		{
+			DEFINE_FSTR_LOCAL(content, "0123456789abcdefghij")
+			auto source = new MemoryDataStream;
+			source->print(content);
+
+			RangeStream stream(source, 5, 10);
+			REQUIRE(stream.isValid());
+			REQUIRE_EQ(stream.available(), 10);
+			char buffer[32];
+			REQUIRE_EQ(stream.readBytes(buffer, 4), 4U);
+			REQUIRE(memcmp(buffer, "5678", 4) == 0);
+			REQUIRE_EQ(stream.available(), 6);
+			String s = stream.readString(100);
+			REQUIRE_EQ(s, "9abcde");
+			REQUIRE(stream.isFinished());
+
+			REQUIRE_EQ(stream.seekFrom(-3, SeekOrigin::End), 7);
+			s = stream.readString(100);
+			REQUIRE_EQ(s, "cde");
+			REQUIRE_EQ(stream.seekFrom(11, SeekOrigin::Start), -1);
+
+			// Start beyond end of source
+			source = new MemoryDataStream;
+			source->print(content);
+			RangeStream invalid(source, 30, 10);
+			REQUIRE(!invalid.isValid());
+			REQUIRE_EQ(invalid.available(), 0);
+		}
+
+		TEST_CASE("PrefetchStream")
+		{
+			String abstract(FS_abstract);
+			auto source = new MemoryDataStream;
+			source->print(abstract);
+
+			// Small buffers so content spans several fills
+			PrefetchStream stream(source, 64);
+			REQUIRE(stream.isValid());
+			REQUIRE_EQ(stream.available(), int(abstract.length()));
+			const char* data;
+			REQUIRE_EQ(stream.peekRegion(data), 64U);
+			REQUIRE(stream.seek(10));
+			REQUIRE_EQ(stream.available(), int(abstract.length() - 10));
+
+			// Skip beyond buffered content
+			REQUIRE(stream.seek(200));
+			String s = stream.readString(50);
+			REQUIRE_EQ(s, abstract.substring(210, 260));
+
+			String content = abstract.substring(0, 260);
+			char buffer[100];
+			while(!stream.isFinished()) {
+				auto len = stream.readMemoryBlock(buffer, sizeof(buffer));
+				REQUIRE(len != 0);
+				content.concat(buffer, len);
+				REQUIRE(stream.seek(len));
+			}
+			REQUIRE(content == abstract);
+		}
+
 		{
 			// STL may perform one-time memory allocation for mutexes, etc.
 			std::shared_ptr<const char[]> data(new char[18]);
@@ -1,6 +1,9 @@
 #include <HostTests.h>
 
 #include <Data/HexString.h>
+#include <Data/Format/Xml.h>
+#include <SplitString.h>
+#include <Data/CStringArray.h>
 
 class StringTest : public TestGroup
 {
@@ -15,6 +18,7 @@ public:
 		nonTemplateTest();
 
 		testString();
+		testConcatAll();
 		testMakeHexString();
 	}
 
@@ -154,6 +158,77 @@ public:
 		}
 	}
 
+	void testConcatAll()
+	{
+		TEST_CASE("concatAll mixed types")
+		{
+			String s;
+			REQUIRE(s.concatAll(F("HTTP/1.1 "), 200U, ' ', "OK", -5, 12345678901LL));
+			REQUIRE(s == F("HTTP/1.1 200 OK-512345678901"));
+		}
+
+		TEST_CASE("concatAll self reference")
+		{
+			String s = "abc";
+			REQUIRE(s.concatAll(s, '-', s));
+			REQUIRE(s == F("abcabc-abc"));
+		}
+
+		TEST_CASE("concatAll SSO to heap")
+		{
+			String s = "0123456789";
+			String t = "abcdefghijklmnopqrstuvwxyz";
+			REQUIRE(s.concatAll(s, t, s));
+			REQUIRE(s.length() == 56);
+			REQUIRE(s.startsWith(F("01234567890123456789abcdef")));
+			REQUIRE(s.endsWith(F("xyz0123456789")));
+		}
+
+		TEST_CASE("StringView")
+		{
+			String line = F("  name = value, more  ");
+			StringView view(line);
+			REQUIRE(view.length() == line.length());
+			auto trimmed = view.trim();
+			REQUIRE(trimmed == F("name = value, more"));
+			REQUIRE(trimmed.startsWith("name"));
+			REQUIRE(trimmed.endsWith("more"));
+			REQUIRE(trimmed.indexOf('=') == 5);
+			REQUIRE(trimmed.indexOf(StringView("more")) == 14);
+			REQUIRE(trimmed.indexOf('x') == StringView::npos);
+			REQUIRE(trimmed.substring(7, 5) == "value");
+			REQUIRE(trimmed.substring(100).empty());
+
+			auto name = trimmed.splitFirst('=').trim();
+			REQUIRE(name == "name");
+			REQUIRE(name.equalsIgnoreCase("NAME"));
+			REQUIRE(trimmed.trim() == F("value, more"));
+			REQUIRE(StringView("123abc").toInt() == 123);
+
+			Vector<StringView> splits;
+			REQUIRE(splitString(StringView(line), ',', splits) == 2);
+			REQUIRE(splits[0] == F("name = value"));
+			REQUIRE(splits[1] == F(" more"));
+			REQUIRE(splitString(StringView("a,,b,"), ',', splits) == 4);
+			REQUIRE(splits[1].empty());
+			REQUIRE(splits[3].empty());
+
+			CStringArray csa = F("one\0two\0three");
+			REQUIRE(csa.indexOf(StringView("twofold", 3)) == 1);
+			REQUIRE(csa.indexOf(StringView("TWO"), false) == -1);
+		}
+
+		TEST_CASE("XML escape")
+		{
+			String s = F("plain text");
+			Format::xml.escape(s);
+			REQUIRE(s == F("plain text"));
+			s = F("<a href=\"x&y\">'b'</a>");
+			Format::xml.escape(s);
+			REQUIRE(s == F("&lt;a href=&quot;x&amp;y&quot;&gt;&apos;b&apos;&lt;/a&gt;"));
+		}
+	}
+
 	void testMakeHexString()
 	{
 		uint8_t hwaddr[] = {0xaa, 0xbb, 0xcc, 0xdd, 0x12, 0x55, 0x00};
@@ -1,5 +1,8 @@
 #include <HostTests.h>
 #include <esp_spi_flash.h>
+#include <Coroutine.h>
+#include <Platform/Worker.h>
+#include <Platform/RtcState.h>
 
 /*
  * Various system functions must be available for all architectures.
@@ -39,6 +42,47 @@ public:
 			system_soft_wdt_feed();
 		}
 
+#ifndef ARCH_RP2040
+		TEST_CASE("RtcState")
+		{
+			struct Data {
+				uint16_t count;
+				uint8_t flags;
+			};
+			RtcState<Data> state(RTC_MEMORY_BLOCK_END - RtcState<Data>::blockCount);
+			REQUIRE(state.save(Data{1234, 0x5a}));
+			Data data{};
+			REQUIRE(state.load(data));
+			REQUIRE_EQ(data.count, 1234);
+			REQUIRE_EQ(data.flags, 0x5a);
+			REQUIRE(state.invalidate());
+			REQUIRE(!state.load(data));
+			REQUIRE(!RtcState<Data>(RTC_MEMORY_BLOCK_END).save(data));
+		}
+#endif
+
+		TEST_CASE("Task priorities")
+		{
+			// Queued in reverse order, higher priority callbacks must run first
+			taskOrder = nullptr;
+			auto queue = [this](TaskPriority prio, char c) {
+				return System.queueCallback(
+					[this, c]() {
+						taskOrder += c;
+						if(c == 'L') {
+							debug_i("Task order '%s'", taskOrder.c_str());
+							REQUIRE_EQ(taskOrder, "HNL");
+							complete();
+						}
+					},
+					prio);
+			};
+			REQUIRE(queue(TaskPriority::Low, 'L'));
+			REQUIRE(queue(TaskPriority::Normal, 'N'));
+			REQUIRE(queue(TaskPriority::High, 'H'));
+			pending();
+		}
+
 #ifndef ARCH_HOST
 		TEST_CASE("System restart")
 		{
@@ -70,9 +114,145 @@ public:
 		}
 #endif
 	}
+
+private:
+	String taskOrder;
+};
+
+class CoroutineTest : public TestGroup
+{
+public:
+	CoroutineTest() : TestGroup(_F("Coroutines")), coroutine(*this)
+	{
+	}
+
+	void execute() override
+	{
+		REQUIRE(coroutine.start());
+		REQUIRE(coroutine.getState() == Coroutine::State::Ready);
+		pending();
+	}
+
+private:
+	class TestCoroutine : public Coroutine
+	{
+	public:
+		TestCoroutine(CoroutineTest& test) : test(test)
+		{
+		}
+
+	protected:
+		void run() override
+		{
+			CO_BEGIN();
+
+			for(count = 0; count < 3; ++count) {
+				trace += 'Y';
+				CO_YIELD();
+			}
+
+			startTime = millis();
+			CO_DELAY(50);
+			elapsed = millis() - startTime;
+			debug_i("CO_DELAY(50) took %u ms", elapsed);
+			REQUIRE(elapsed >= 50);
+			trace += 'D';
+
+			signalTimer.initializeMs<10>([this]() {
+				signalled = true;
+				wake();
+			});
+			signalTimer.startOnce();
+			CO_AWAIT(signalled);
+			trace += 'A';
+
+			CO_END();
+		}
+
+		void onFinished() override
+		{
+			debug_i("Coroutine trace '%s'", trace.c_str());
+			REQUIRE_EQ(trace, "YYYDA");
+			REQUIRE(isFinished());
+			REQUIRE(!wake());
+			test.complete();
+		}
+
+	private:
+		CoroutineTest& test;
+		String trace;
+		unsigned count{0};
+		unsigned startTime{0};
+		unsigned elapsed{0};
+		bool signalled{false};
+		SimpleTimer signalTimer;
+	};
+
+	TestCoroutine coroutine;
+};
+
+class WorkerTest : public TestGroup
+{
+public:
+	static constexpr unsigned jobCount{WORKER_QUEUE_LENGTH};
+
+	WorkerTest() : TestGroup(_F("Worker"))
+	{
+	}
+
+	void execute() override
+	{
+		debug_i("Worker is %sparallel", WorkerClass::isParallel() ? "" : "not ");
+
+		for(unsigned i = 0; i < jobCount; ++i) {
+			auto& job = jobs[i];
+			job.test = this;
+			job.count = 1000 * (i + 1);
+			REQUIRE(Worker.submit(work, done, &job));
+		}
+		REQUIRE_EQ(Worker.getPendingCount(), jobCount);
+		// Queue is full
+		REQUIRE(!Worker.submit(work, done, &jobs[0]));
+
+		pending();
+	}
+
+private:
+	struct Job {
+		WorkerTest* test;
+		unsigned count;
+		uint32_t sum;
+	};
+
+	static void work(void* param)
+	{
+		auto job = static_cast<Job*>(param);
+		job->sum = 0;
+		for(unsigned i = 1; i <= job->count; ++i) {
+			job->sum += i;
+		}
+	}
+
+	static void done(void* param)
+	{
+		auto job = static_cast<Job*>(param);
+		auto test = job->test;
+		unsigned index = job - test->jobs;
+		REQUIRE_EQ(index, test->completed);
+		REQUIRE_EQ(job->sum, job->count * (job->count + 1) / 2);
+		if(++test->completed == jobCount) {
+			REQUIRE_EQ(Worker.getPendingCount(), 0U);
+			test->complete();
+		}
+	}
+
+	Job jobs[jobCount];
+	unsigned completed{0};
 };
 
 void REGISTER_TEST(System)
 {
 	registerGroup<SystemTest>();
+	registerGroup<CoroutineTest>();
+	registerGroup<WorkerTest>();
 }
@@ -13,6 +13,7 @@
 DEFINE_FSTR_LOCAL(template1, "Stream containing {var1}, {var2} and {var3}. {} {{}} {{12345")
 DEFINE_FSTR_LOCAL(template1_1, "Stream containing value #1, value #2 and {var3}. {} {{}} {{12345")
 DEFINE_FSTR_LOCAL(template1_2, "Stream containing value #1, value #2 and [value #3]. {} {{}} {{12345")
+DEFINE_FSTR_LOCAL(template1_schema, "var2\0var1")
 
 DEFINE_FSTR_LOCAL(template2, "This text should {disable}not {var1} really {var2:hello} again {enable}be missing.")
 DEFINE_FSTR_LOCAL(template2_1, "This text should be missing.")
@@ -90,6 +91,33 @@ public:
 			check(tmpl, template2, template2_1);
 		}
 
+		TEST_CASE("template1 (indexed variables)")
+		{
+			FSTR::TemplateStream tmpl(template1);
+			unsigned lookups{0};
+			tmpl.onGetIndexedValue([&](unsigned index) -> String {
+				++lookups;
+				switch(index) {
+				case 0:
+					return F("value #2");
+				case 1:
+					return F("value #1");
+				default:
+					return nullptr;
+				}
+			});
+			tmpl.onGetValue([](const char* name) -> String {
+				// Only names missing from schema should be requested
+				TEST_ASSERT(!(FS("var1") == name) && !(FS("var2") == name));
+				return nullptr;
+			});
+
+			REQUIRE(tmpl.compile(template1_schema));
+			String s = tmpl.readString(256);
+			REQUIRE_EQ(lookups, 2U);
+			REQUIRE(template1_1 == s);
+		}
+
 		TEST_CASE("template3 (PR #2400 - HTML)")
 		{
 			FSTR::TemplateStream tmpl(template3);
@@ -141,53 +169,46 @@ public:
 			check(tmpl, Resource::ut_template1_out1_rst);
 		}
 
-		auto addChar = [](String& s, char c, size_t count) {
-			auto len = s.length();
-			s.setLength(len + count);
-			memset(&s[len], c, count);
-		};
+		TEST_CASE("SectionStream named sections")
+		{
+			DEFINE_FSTR_LOCAL(source, "header{SECTION}one{/SECTION} {SECTION:rows}two{/SECTION}{SECTIONS}"
+									  "{SECTION:foot}three{/SECTION}")
+			SectionStream stream(new FlashMemoryStream(source));
+			REQUIRE_EQ(stream.count(), 3U);
+			REQUIRE_EQ(String(stream.getSectionName(0)), "");
+			REQUIRE_EQ(stream.findSection("rows"), 1);
+			REQUIRE_EQ(stream.findSection("foot"), 2);
+			REQUIRE_EQ(stream.findSection("one"), -1);
+			REQUIRE_EQ(stream.readString(100), "onetwothree");
+
+			// Partial rendering
+			REQUIRE(stream.selectSection(1));
+			REQUIRE_EQ(stream.readString(100), "two");
+
+			MemoryDataStream index;
+			REQUIRE(stream.saveIndex(index));
+			SectionStream indexed(new FlashMemoryStream(source), index);
+			REQUIRE_EQ(indexed.count(), 3U);
+			REQUIRE_EQ(indexed.findSection("foot"), 2);
+			REQUIRE(indexed.selectSection(2));
+			REQUIRE_EQ(indexed.readString(100), "three");
+
+			// Index for a different source is ignored
+			DEFINE_FSTR_LOCAL(source2, "{SECTION:a}A{/SECTION}")
+			index.seekFrom(0, SeekOrigin::Start);
+			SectionStream other(new FlashMemoryStream(source2), index);
+			REQUIRE_EQ(other.count(), 1U);
+			REQUIRE_EQ(other.findSection("a"), 0);
+		}
 
 		TEST_CASE("Fragmented read of variable [TMPL #1, #3, #4]")
 		{
-			constexpr size_t TEMPLATE_BUFFER_SIZE{100};
-			String input;
-			addChar(input, 'a', TEMPLATE_BUFFER_SIZE - 4);
-			input += _F("{varname}");
-			addChar(input, 'a', TEMPLATE_BUFFER_SIZE);
-			auto source = new LimitedMemoryStream(input.begin(), input.length(), input.length(), false);
-			TemplateStream tmpl(source);
-			PSTR_ARRAY(someValue, "Some value or other");
-			tmpl.setVar(F("varname"), someValue);
-
-			size_t outlen{0};
-			char output[TEMPLATE_BUFFER_SIZE * 3]{};
-			while(!tmpl.isFinished()) {
-				auto ptr = output + outlen;
-				size_t read1 = tmpl.readMemoryBlock(ptr, TEMPLATE_BUFFER_SIZE);
-				char tmp[read1];
-				memcpy(tmp, ptr, read1);
-				size_t read = tmpl.readMemoryBlock(ptr, TEMPLATE_BUFFER_SIZE);
-				CHECK_EQ(read, read1);
-				CHECK(memcmp(tmp, ptr, read) == 0);
-				if(read > 10) {
-					read -= 5;
-				}
-				tmpl.seek(read);
-				outlen += read;
-			}
-
-			String expected;
-			addChar(expected, 'a', TEMPLATE_BUFFER_SIZE - 4);
-			expected += someValue;
-			addChar(expected, 'a', TEMPLATE_BUFFER_SIZE);
+			checkFragmented(false);
+		}
 
-			if(!expected.equals(output, outlen)) {
-				m_nputs(output, outlen);
-				m_puts("\r\n");
-				m_nputs(expected.c_str(), expected.length());
-				m_puts("\r\n");
-			}
-			REQUIRE(expected.equals(output, outlen));
+		TEST_CASE("Fragmented read of compiled template")
+		{
+			checkFragmented(true);
 		}
 
 		TEST_CASE("CSV Reader")
@@ -209,9 +230,101 @@ public:
 			CHECK(csv_headings == headings);
 			CHECK(csv_row1 == row1);
 		}
+
+		TEST_CASE("CSV Reader field access and row index")
+		{
+			auto csv = new MemoryDataStream;
+			csv->print("name,value,\"comment\"\r\n");
+			for(unsigned i = 0; i < 100; ++i) {
+				csv->print("\"row, ");
+				csv->print(i);
+				csv->print("\",");
+				csv->print(i * 10);
+				csv->print(",\n");
+			}
+
+			CsvReader reader(csv);
+			REQUIRE_EQ(reader.getColumn("value"), 1);
+			REQUIRE_EQ(reader.getColumn("comment"), 2);
+			REQUIRE_EQ(reader.getColumn("missing"), -1);
+
+			REQUIRE(reader.next());
+			REQUIRE_EQ(reader.getFieldCount(), 3U);
+			REQUIRE_EQ(String(reader.getValue(0U)), "row, 0");
+			REQUIRE_EQ(reader.getValueLength(0), 6U);
+			REQUIRE_EQ(String(reader.getValue("value")), "0");
+			REQUIRE_EQ(reader.getValueLength(2), 0U);
+			REQUIRE(reader.getValue(3) == nullptr);
+
+			MemoryDataStream index;
+			REQUIRE_EQ(reader.writeIndex(index), 100);
+			REQUIRE(reader.seekRow(index, 57));
+			REQUIRE_EQ(String(reader.getValue(1)), "570");
+			auto offset = reader.getRowOffset();
+			REQUIRE(reader.next());
+			REQUIRE_EQ(String(reader.getValue(1)), "580");
+			REQUIRE(reader.seek(offset));
+			REQUIRE(reader.next());
+			REQUIRE_EQ(String(reader.getValue(1)), "570");
+			REQUIRE(!reader.seekRow(index, 100));
+		}
 	}
 
 private:
+	static void addChar(String& s, char c, size_t count)
+	{
+		auto len = s.length();
+		s.setLength(len + count);
+		memset(&s[len], c, count);
+	}
+
+	void checkFragmented(bool compiled)
+	{
+		constexpr size_t TEMPLATE_BUFFER_SIZE{100};
+		String input;
+		addChar(input, 'a', TEMPLATE_BUFFER_SIZE - 4);
+		input += _F("{varname}");
+		addChar(input, 'a', TEMPLATE_BUFFER_SIZE);
+		auto source = new LimitedMemoryStream(input.begin(), input.length(), input.length(), false);
+		TemplateStream tmpl(source);
+		PSTR_ARRAY(someValue, "Some value or other");
+		tmpl.setVar(F("varname"), someValue);
+		if(compiled) {
+			REQUIRE(tmpl.compile());
+			REQUIRE_EQ(tmpl.getIndex()->getCount(), 1U);
+		}
+
+		size_t outlen{0};
+		char output[TEMPLATE_BUFFER_SIZE * 3]{};
+		while(!tmpl.isFinished()) {
+			auto ptr = output + outlen;
+			size_t read1 = tmpl.readMemoryBlock(ptr, TEMPLATE_BUFFER_SIZE);
+			char tmp[read1];
+			memcpy(tmp, ptr, read1);
+			size_t read = tmpl.readMemoryBlock(ptr, TEMPLATE_BUFFER_SIZE);
+			CHECK_EQ(read, read1);
+			CHECK(memcmp(tmp, ptr, read) == 0);
+			if(read > 10) {
+				read -= 5;
+			}
+			tmpl.seek(read);
+			outlen += read;
+		}
+
+		String expected;
+		addChar(expected, 'a', TEMPLATE_BUFFER_SIZE - 4);
+		expected += someValue;
+		addChar(expected, 'a', TEMPLATE_BUFFER_SIZE);
+
+		if(!expected.equals(output, outlen)) {
+			m_nputs(output, outlen);
+			m_puts("\r\n");
+			m_nputs(expected.c_str(), expected.length());
+			m_puts("\r\n");
+		}
+		REQUIRE(expected.equals(output, outlen));
+	}
+
 	void check(TemplateStream& stream, const FlashString& tmpl, const FlashString& ref)
 	{
 		constexpr size_t maxLen{256};
@@ -223,7 +336,18 @@ private:
 		Serial.print(_F(" ref: "));
 		Serial.println(ref);
 		REQUIRE(ref == s);
-		return;
+
+		// Output from compiled template must be identical
+		REQUIRE(stream.compile());
+		s = stream.readString(maxLen);
+		REQUIRE(ref == s);
+
+		// Index may be shared with another stream
+		auto index = stream.getIndex();
+		REQUIRE(stream.seekFrom(0, SeekOrigin::Start) == 0);
+		stream.setIndex(index);
+		s = stream.readString(maxLen);
+		REQUIRE(ref == s);
 	}
 
 	void check(TemplateStream& tmpl, const FlashString& ref)
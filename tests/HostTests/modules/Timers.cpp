@@ -7,6 +7,9 @@
 #include <HostTests.h>
 #include <HardwareTimer.h>
 #include <Platform/Timers.h>
+#include <WheelTimer.h>
+#include <Waveform.h>
+#include <Digital.h>
 #include <malloc_count.h>
 
 using Timer1TestApi = Timer1Api<TIMER_CLKDIV_16, eHWT_Maskable>;
@@ -371,15 +374,164 @@ public:
 	}
 };
 
+class WheelTimerTest : public TestGroup
+{
+public:
+	static constexpr unsigned timerCount{300};
+
+	WheelTimerTest() : TestGroup(_F("Wheel timers"))
+	{
+	}
+
+	void execute() override
+	{
+		// Intervals exceed one wheel revolution; started in reverse order of expiry
+		for(unsigned i = 0; i < timerCount; ++i) {
+			auto& timer = timers[i];
+			timer.initializeMs((timerCount - i) * WHEEL_TIMER_TICK_MS, [this, i]() { expired(i); });
+			timer.startOnce();
+		}
+		timers[0].stop();
+		REQUIRE_EQ(WheelTimerApi::getActiveCount(), timerCount - 1);
+
+		repeatTimer.initializeMs(3 * WHEEL_TIMER_TICK_MS, [this]() {
+			if(++repeatCount == 5) {
+				repeatTimer.stop();
+			}
+		});
+		repeatTimer.start();
+
+		pending();
+	}
+
+	void expired(unsigned index)
+	{
+		REQUIRE(index < lastIndex);
+		lastIndex = index;
+		++expiredCount;
+		if(index != 1) {
+			return;
+		}
+
+		debug_i("%u wheel timers expired, repeatCount %u", expiredCount, repeatCount);
+		REQUIRE_EQ(expiredCount, timerCount - 1);
+		REQUIRE_EQ(repeatCount, 5U);
+		REQUIRE_EQ(WheelTimerApi::getActiveCount(), 0U);
+		complete();
+	}
+
+private:
+	WheelTimer timers[timerCount];
+	WheelTimer repeatTimer;
+	unsigned lastIndex{timerCount};
+	unsigned expiredCount{0};
+	unsigned repeatCount{0};
+};
+
+#ifdef ARCH_HOST
+/*
+ * Pin writes are captured via digital hooks
+ */
+class WaveformTest : public TestGroup, private DigitalHooks
+{
+public:
+	WaveformTest() : TestGroup(_F("Waveform"))
+	{
+	}
+
+	void execute() override
+	{
+		previousHooks = setDigitalHooks(this);
+
+		REQUIRE(!wave.queue(steps1, ARRAY_SIZE(steps1)));
+		REQUIRE(!wave.begin(0));
+		REQUIRE(wave.begin(pinMask, bufferDone, this));
+		REQUIRE(!wave.begin(pinMask));
+
+		REQUIRE(wave.queue(steps1, ARRAY_SIZE(steps1)));
+		REQUIRE(wave.isPlaying());
+		REQUIRE(wave.queue(steps2, ARRAY_SIZE(steps2)));
+		REQUIRE(!wave.canQueue());
+		REQUIRE(!wave.queue(steps1, ARRAY_SIZE(steps1)));
+
+		pending();
+	}
+
+private:
+	static constexpr uint32_t pinMask{BIT(4) | BIT(5)};
+	static constexpr uint32_t stepTicks{Waveform::Clock::TimeConst<NanoTime::Microseconds, 200>::ticks()};
+	static constexpr unsigned stepCount{5};
+
+	bool pinMode(uint16_t, uint8_t) override
+	{
+		return true;
+	}
+
+	void digitalWrite(uint16_t pin, uint8_t val) override
+	{
+		bitWrite(levels, pin, val);
+		// Pins are written in ascending order
+		if(pin == 5 && writeCount < stepCount) {
+			written[writeCount++] = levels;
+		}
+	}
+
+	static void bufferDone(void* param, const Waveform::Step* steps)
+	{
+		auto self = static_cast<WaveformTest*>(param);
+		self->completed[self->doneCount++] = steps;
+		if(self->doneCount == 2) {
+			System.queueCallback(
+				[](void* param) {
+					auto self = static_cast<WaveformTest*>(param);
+					self->checkResult();
+				},
+				self);
+		}
+	}
+
+	void checkResult()
+	{
+		REQUIRE(!wave.isPlaying());
+		REQUIRE(completed[0] == steps1);
+		REQUIRE(completed[1] == steps2);
+		REQUIRE_EQ(writeCount, stepCount);
+		const uint32_t expected[stepCount]{0x10, 0x20, 0x30, 0x00, 0x30};
+		for(unsigned i = 0; i < stepCount; ++i) {
+			CHECK_EQ(written[i], expected[i]);
+		}
+		wave.end();
+		setDigitalHooks(previousHooks);
+		complete();
+	}
+
+	const Waveform::Step steps1[3]{{0x10, stepTicks}, {0x20, stepTicks}, {0x30, stepTicks}};
+	const Waveform::Step steps2[2]{{0x00, stepTicks}, {0xff, stepTicks}};
+	Waveform wave;
+	DigitalHooks* previousHooks{nullptr};
+	const Waveform::Step* completed[2]{};
+	volatile unsigned doneCount{0};
+	uint32_t levels{0};
+	uint32_t written[stepCount]{};
+	unsigned writeCount{0};
+};
+#endif
+
 void REGISTER_TEST(Timers)
 {
 	registerGroup<CallbackTimerApiTest<Timer1TestApi>>();
 	registerGroup<CallbackTimerApiTest<OsTimerApi>>();
 	registerGroup<CallbackTimerApiTest<OsTimer64Api<Timer>>>();
+	registerGroup<CallbackTimerApiTest<WheelTimerApi>>();
 
 	registerGroup<CallbackTimerSpeedTest<HardwareTimerTest>>();
 	registerGroup<CallbackTimerSpeedTest<SimpleTimer>>();
 	registerGroup<CallbackTimerSpeedTest<Timer>>();
+	registerGroup<CallbackTimerSpeedTest<WheelTimer>>();
 
 	registerGroup<CallbackTimerTest>();
+	registerGroup<WheelTimerTest>();
+#ifdef ARCH_HOST
+	registerGroup<WaveformTest>();
+#endif
 }
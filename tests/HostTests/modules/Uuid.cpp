@@ -42,6 +42,34 @@ public:
 			REQUIRE_EQ(String(PARTITION_SYSTEM_GUID_FSTR), Uuid(PARTITION_SYSTEM_GUID_FSTR));
 		}
 
+		TEST_CASE("Literal")
+		{
+			constexpr Uuid uuid = "c12a7328-f81f-11d2-ba4b-00a0c93ec93b"_uuid;
+			static_assert(uuid.time_low == 0xc12a7328 && uuid.node[5] == 0x3b, "Bad literal");
+			REQUIRE_EQ(uuid, Uuid(PARTITION_SYSTEM_GUID));
+		}
+
+		TEST_CASE("Invalid strings")
+		{
+			REQUIRE_EQ(Uuid("C12A7328-F81F-11D2-BA4B-00A0C93EC93B"), Uuid(PARTITION_SYSTEM_GUID));
+			Uuid uuid;
+			REQUIRE(!uuid.decompose("c12a7328-f81f-11d2-ba4b-00a0c93ec93"));
+			REQUIRE(!uuid.decompose("c12a7328-f81f-11d2-ba4b-00a0c93ec9g3"));
+			REQUIRE(!uuid.decompose("c12a7328-f81f:11d2-ba4b-00a0c93ec93b"));
+			REQUIRE(!uuid);
+		}
+
+		TEST_CASE("Generate")
+		{
+			for(unsigned i = 0; i < 10; ++i) {
+				Uuid uuid;
+				uuid.generate();
+				REQUIRE_EQ(uuid.time_hi_and_version >> 12, 1);
+				REQUIRE_EQ(uuid.clock_seq_hi_and_reserved >> 6, 2);
+				REQUIRE_EQ(Uuid(uuid.toString()), uuid);
+			}
+		}
+
 		TEST_CASE("Copy")
 		{
 			Uuid u1;
@@ -7,6 +7,8 @@
 #include <map>
 #include <vector>
 #include <malloc_count.h>
+#include <Wire.h>
+#include <Data/FlashMapIndex.h>
 
 namespace
 {
@@ -42,6 +44,15 @@ template <typename T> void fillMap(T& map)
 	Serial << "fillMap heap " << MallocCount::getCurrent() - startMem << endl;
 }
 
+DEFINE_FSTR_LOCAL(file1, "index.html")
+DEFINE_FSTR_LOCAL(file2, "style.css")
+DEFINE_FSTR_LOCAL(file3, "script.js")
+DEFINE_FSTR_LOCAL(content1, "<html></html>")
+DEFINE_FSTR_LOCAL(content2, "body {}")
+DEFINE_FSTR_LOCAL(content3, "var x;")
+DEFINE_FSTR_MAP_LOCAL(fileMap, FSTR::String, FSTR::String, {&file1, &content1}, {&file2, &content2},
+					  {&file3, &content3})
+
 } // namespace
 
 class WiringTest : public TestGroup
@@ -115,6 +126,29 @@ public:
 				 [](auto& map) { map.sort([](const auto& e1, const auto& e2) { return e1.value() < e2.value(); }); });
 		}
 
+		TEST_CASE("HashMap<MimeType, size_t> (hashed)")
+		{
+			using TestMap = HashMap<MimeType, uint16_t>;
+			TestMap map(nullptr, [](const MimeType& key) -> uint32_t { return unsigned(key); });
+			fillMap(map);
+			REQUIRE_EQ(map.count(), 13);
+			REQUIRE(map.contains(MIME_SVG));
+			REQUIRE(!map.contains(MIME_UNKNOWN));
+
+			// Removal shuffles entries, check lookups are still correct
+			auto value = map[MIME_ZIP];
+			map.remove(MIME_HTML);
+			map.remove(MIME_PNG);
+			REQUIRE_EQ(map.count(), 11);
+			REQUIRE(!map.contains(MIME_HTML));
+			REQUIRE_EQ(map[MIME_ZIP], value);
+
+			map.sort([](const auto& e1, const auto& e2) { return e1.value() < e2.value(); });
+			REQUIRE_EQ(map[MIME_ZIP], value);
+			REQUIRE_EQ(map.indexOf(map.keyAt(5)), 5);
+			print(map);
+		}
+
 		TEST_CASE("std::map<MimeType, size_t>")
 		{
 			std::map<MimeType, uint16_t> map;
@@ -229,11 +263,11 @@ public:
 			REQUIRE(!vector.insertElementAt(99, 35));
 			REQUIRE(vector.insertElementAt(99, 32));
 			REQUIRE(vector[32] == 99);
-			REQUIRE_EQ(vector.capacity(), 42);
+			REQUIRE_EQ(vector.capacity(), 32U + 32U * VECTOR_GROWTH_PERCENT / 100);
 
 			REQUIRE(vector.setSize(3));
 			REQUIRE_EQ(vector.count(), 3);
-			REQUIRE_EQ(vector.capacity(), 42);
+			REQUIRE_EQ(vector.capacity(), 32U + 32U * VECTOR_GROWTH_PERCENT / 100);
 
 			vector.trimToSize();
 			REQUIRE_EQ(vector.capacity(), 3);
@@ -245,6 +279,39 @@ public:
 			}
 		}
 
+		TEST_CASE("Vector<int> insert")
+		{
+			Vector<int> vector(4, 1);
+			for(int i = 0; i < 4; ++i) {
+				vector.add(i);
+			}
+			REQUIRE(vector.insertElementAt(100, 1));
+			REQUIRE(vector.insertElementAt(200, 0));
+			const int expected[]{200, 0, 100, 1, 2, 3};
+			REQUIRE_EQ(vector.count(), ARRAY_SIZE(expected));
+			for(unsigned i = 0; i < vector.count(); ++i) {
+				REQUIRE_EQ(vector[i], expected[i]);
+			}
+		}
+
+		TEST_CASE("Vector move")
+		{
+			Vector<String> vector;
+			String s = F("A string too long for SSO");
+			auto buf = s.c_str();
+			REQUIRE(vector.add(std::move(s)));
+			REQUIRE(vector[0].c_str() == buf);
+			s = F("Another long string for insertion");
+			buf = s.c_str();
+			REQUIRE(vector.insertElementAt(std::move(s), 0));
+			REQUIRE(vector[0].c_str() == buf);
+
+			Vector<String> moved(std::move(vector));
+			REQUIRE_EQ(moved.count(), 2);
+			REQUIRE_EQ(vector.count(), 0);
+			REQUIRE(moved[0].c_str() == buf);
+		}
+
 		TEST_CASE("std::vector<uint8_t>")
 		{
 			auto startMem = MallocCount::getCurrent();
@@ -271,6 +338,16 @@ public:
 			Serial.println();
 		}
 
+		TEST_CASE("FlashMapIndex")
+		{
+			FlashMapIndex<decltype(fileMap)> index(fileMap);
+			REQUIRE(index["style.css"].content() == content2);
+			REQUIRE(index["INDEX.HTML"].content() == content1);
+			REQUIRE(index[String("script.js")].content() == content3);
+			REQUIRE(!index["missing.txt"]);
+			REQUIRE(!index[""]);
+		}
+
 		TEST_CASE("MacAddress")
 		{
 			const uint8_t refOctets[]{0x12, 0x34, 0x56, 0x78, 0x9a, 0xbc};
@@ -288,7 +365,71 @@ public:
 	}
 };
 
+#ifdef ARCH_HOST
+/*
+ * Host I2C bus has no devices so transactions fail at start, but queueing
+ * and completion order can still be checked
+ */
+class WireAsyncTest : public TestGroup
+{
+public:
+	WireAsyncTest() : TestGroup(_F("Wire async"))
+	{
+	}
+
+	void execute() override
+	{
+		Wire.begin();
+
+		TwoWire::Transaction empty;
+		REQUIRE(!Wire.queueTransaction(empty));
+
+		for(unsigned i = 0; i < transCount; ++i) {
+			auto& t = trans[i];
+			t.address = 0x40 + i;
+			t.txData = txData;
+			t.txLength = sizeof(txData);
+			t.rxData = rxData;
+			t.rxLength = sizeof(rxData);
+			t.param = this;
+			t.callback = transactionDone;
+			REQUIRE(Wire.queueTransaction(t));
+		}
+		REQUIRE(Wire.isBusy());
+		// Already queued
+		REQUIRE(!Wire.queueTransaction(trans[0]));
+
+		pending();
+	}
+
+private:
+	static constexpr unsigned transCount{3};
+
+	static void transactionDone(TwoWire::Transaction& t)
+	{
+		auto test = static_cast<WireAsyncTest*>(t.param);
+		unsigned index = &t - test->trans;
+		REQUIRE_EQ(index, test->completed);
+		REQUIRE(!t.busy);
+		REQUIRE_EQ(t.error, TwoWire::I2C_ERR_LINE_BUSY);
+		if(++test->completed == transCount) {
+			REQUIRE(!Wire.isBusy());
+			Wire.end();
+			test->complete();
+		}
+	}
+
+	TwoWire::Transaction trans[transCount];
+	const uint8_t txData[2]{0x12, 0x34};
+	uint8_t rxData[4]{};
+	unsigned completed{0};
+};
+#endif
+
 void REGISTER_TEST(Wiring)
 {
 	registerGroup<WiringTest>();
+#ifdef ARCH_HOST
+	registerGroup<WireAsyncTest>();
+#endif
 }